@@ -29,8 +29,11 @@
 #include <include/Noriko/util.h>
 
 
-/* Only use allocation contexts in debug builds. */
-#if (!defined NK_CONFIG_DEPLOY)
+/*
+ * Only use allocation contexts in debug builds, unless allocation tracking was
+ * explicitly requested for deploy builds.
+ */
+#if (!defined NK_CONFIG_DEPLOY || defined NK_USE_ALLOCATION_TRACKING)
     /**
      * \def   NK_MAKE_ALLOCATION_CONTEXT(ns, p, s, a)
      * \brief constructs a new static allocation context for use with the general-purpose
@@ -139,7 +142,9 @@ NK_NATIVE NK_API NkVoid NK_CALL NkGPFree(NkVoid *memPtr);
  *                allocated block
  * \return  \c NkErr_Ok on success, non-zero on failure
  * \see     NkPoolReserve, NkPoolFree
- * \note    \li This function is thread-safe.
+ * \note    \li This function is thread-safe. Allocations of up to 4096 bytes in total
+ *              are rounded up to a size class and served from a per-thread cache; they
+ *              do not take a lock in the common case.
  * \note    \li \c blockSize must be non-zero and a multiple of eight.
  * \note    \li To return the memory back to the allocator after you are done with it,
  *          use the \c NkPoolFree() function.
@@ -174,7 +179,9 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPoolReserve(_In_ NkUint32 blo
 /**
  * \brief frees the allocation at the given address
  * \param [in] memPtr memory block address as returned by \c NkPoolAlloc()
- * \note  \li This function is thread-safe.
+ * \note  \li This function is thread-safe. Blocks may be freed by any thread, not only
+ *             the one that allocated them; memory freed by a different thread is
+ *             reused by the allocating thread.
  * \note  \li If \c memPtr is <tt>NULL</tt>, the function does nothing.
  */
 NK_NATIVE NK_API NkVoid NK_CALL NkPoolFree(_Inout_opt_ NkVoid *memPtr);
@@ -182,7 +189,9 @@ NK_NATIVE NK_API NkVoid NK_CALL NkPoolFree(_Inout_opt_ NkVoid *memPtr);
  * \brief  determines the size of the block at the given address
  * \param  [in] memPtr memory block address
  * \return size of the memory block, in bytes
- * \note   This function is thread-safe.
+ * \note   \li This function is thread-safe.
+ * \note   \li For allocations served by a thread cache, the entire allocation occupies a
+ *             single block of the size class the allocation was rounded up to.
  */
 NK_NATIVE NK_API NkUint32 NK_CALL NkPoolGetBlockSize(_In_ NkVoid const *memPtr);
 /**
@@ -196,5 +205,203 @@ NK_NATIVE NK_API NkUint32 NK_CALL NkPoolGetBlockSize(_In_ NkVoid const *memPtr);
  *         same allocation as the block pointed to by the given block address combined.
  */
 NK_NATIVE NK_API NkUint32 NK_CALL NkPoolGetAllocSize(_In_ NkVoid const *memPtr);
+/**
+ * \brief hands the pool allocator's cache of the calling thread back to the allocator
+ *
+ * Spans whose blocks have all been freed are made available to other threads right away.
+ * Spans that still have blocks allocated are orphaned; they are reclaimed once their last
+ * block was freed by any thread.
+ *
+ * \note \li This function is thread-safe.
+ * \note \li Threads that allocate from the pool allocator should call this function before
+ *            they exit; otherwise, their spans are not reused until shutdown. The thread
+ *            may still allocate afterwards, which creates a new cache.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkAllocReleaseThreadCache(NkVoid);
+
+/**
+ * \struct NkPoolStatistics
+ * \brief  represents the occupancy of the pool allocator
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkPoolStatistics {
+    NkSize   m_structSize;  /**< size of this structure, in bytes */
+    NkUint32 m_nPools;      /**< number of memory pools */
+    NkUint32 m_nSpans;      /**< number of spans owned by thread caches */
+    NkUint64 m_poolBlocks;  /**< number of blocks in all memory pools */
+    NkUint64 m_poolUsed;    /**< number of allocated blocks in all memory pools */
+    NkUint64 m_spanBlocks;  /**< number of blocks in all spans */
+    NkUint64 m_spanUsed;    /**< number of allocated blocks in all spans */
+    NkUint64 m_totalBytes;  /**< combined size of all blocks, in bytes */
+    NkUint64 m_usedBytes;   /**< combined size of all allocated blocks, in bytes */
+} NkPoolStatistics;
+
+/**
+ * \brief retrieves the current occupancy of the pool allocator
+ * \param [out] statPtr pointer to a variable that receives the statistics
+ * \note  \li This function is thread-safe.
+ * \note  \li The span statistics are a snapshot taken without stopping the threads that
+ *             own the spans; blocks freed by other threads count as allocated until the
+ *             owner reclaims them.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPoolQueryStatistics(_Out_ NkPoolStatistics *statPtr);
+
+/**
+ * \enum  NkPoolBacking
+ * \brief selects how the memory of new memory pools is obtained
+ */
+NK_NATIVE typedef _In_range_(0, __NkPoolBack_Count__ - 1) enum NkPoolBacking {
+    NkPoolBack_Heap,       /**< pools are allocated using the general-purpose allocator (default) */
+    NkPoolBack_Virtual,    /**< pools reserve a large address range and commit pages on demand */
+    NkPoolBack_LargePages, /**< pools are backed by large pages, committed right away */
+
+    __NkPoolBack_Count__   /**< *only used internally* */
+} NkPoolBacking;
+
+/**
+ * \brief  selects how the memory of memory pools created from now on is obtained
+ * \param  [in] poolBacking backing for new pools
+ * \return backing that is actually used; if large pages are not available,
+ *         \c NkPoolBack_Virtual is used instead of <tt>NkPoolBack_LargePages</tt>
+ *
+ * \par Remarks
+ *   Pools backed by \c NkPoolBack_Virtual reserve a large range of address space up
+ *   front, but only commit the pages for the blocks in use. When such a pool runs full, it
+ *   grows in place instead of a new pool being created, so the pool count stays low and
+ *   the addresses of existing blocks never change. \c NkPoolBack_LargePages maps pools
+ *   with large pages, which reduces TLB misses when large arrays of blocks are walked;
+ *   since large pages cannot be committed on demand, every pool occupies at least one
+ *   large page right away. On Windows, large pages need the process to hold
+ *   \c SeLockMemoryPrivilege ("Lock pages in memory"). Pools that already exist keep
+ *   their backing. If the address range of a pool cannot be reserved, the pool is
+ *   allocated using the general-purpose allocator.
+ *   The backing can be selected on start-up with the
+ *   <tt>--poolbacking=<heap|virtual|largepages></tt> option.
+ * \note   This function is thread-safe.
+ */
+NK_NATIVE NK_API NkPoolBacking NK_CALL NkPoolSetBacking(_In_ NkPoolBacking poolBacking);
+
+/**
+ * \struct NkArena
+ * \brief  forward-declaration of opaque linear arena allocator type
+ */
+NK_NATIVE typedef struct NkArena NkArena;
+
+/**
+ * \brief   creates a new linear arena allocator
+ *
+ * A linear arena (also called "bump allocator") hands out memory by advancing a pointer
+ * inside of a large block. Individual allocations cannot be freed; instead, the entire
+ * arena is reset at once. This makes it ideal for short-lived scratch memory, such as
+ * temporary strings or command lists, that all share the same lifetime.
+ *
+ * \param   [in] allocCxt (optional) allocation context for debugging and such; it is
+ *               copied, so it does not need to outlive the call
+ * \param   [in] initCap initial capacity of the arena, in bytes; pass \c 0 to use the
+ *               default capacity
+ * \param   [out] arenaPtr pointer to a variable that will receive the pointer to the
+ *                newly-created arena
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \see     NkArenaAlloc, NkArenaReset, NkArenaDestroy
+ * \note    \li If the arena runs out of memory, it allocates additional blocks on the
+ *              heap. On the next reset, these are merged into a single block that is big
+ *              enough to hold all allocations made since the previous reset.
+ * \note    \li If the function fails, then \c *arenaPtr will be set to <tt>NULL</tt>.
+ * \warning Arenas are not thread-safe. Every arena must only be used by one thread at a
+ *          time.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArenaCreate(
+    _In_opt_   NkAllocationContext const *allocCxt,
+    _In_opt_   NkSize initCap,
+    _Init_ptr_ NkArena **arenaPtr
+);
+/**
+ * \brief destroys the given arena, freeing all memory owned by it
+ * \param [in, out] arenaPtr pointer to a variable holding the pointer to the arena that
+ *                  is to be destroyed
+ * \note  <tt>*arenaPtr</tt> will be set to <tt>NULL</tt>. If <tt>*arenaPtr</tt> is
+ *        already <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkArenaDestroy(_Uninit_ptr_ NkArena **arenaPtr);
+/**
+ * \brief   allocates memory from the given arena
+ * \param   [in, out] arenaPtr arena to allocate from
+ * \param   [in] sizeInBytes size of the requested allocation, in bytes
+ * \param   [in] alignInBytes (optional) alignment requirement of the allocation; must be
+ *               a power of two; pass \c 0 to use the default alignment of 16 bytes
+ * \param   [out] memPtr pointer to a variable that will receive the pointer to the
+ *                newly-allocated memory
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    The memory stays valid until the next call to <tt>NkArenaReset()</tt> or
+ *          <tt>NkArenaDestroy()</tt> for the same arena.
+ * \warning The memory returned by this function is not guaranteed to be zeroed.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArenaAlloc(
+    _Inout_    NkArena *arenaPtr,
+    _In_       NkSize sizeInBytes,
+    _In_opt_   NkSize alignInBytes,
+    _Init_ptr_ NkVoid **memPtr
+);
+/**
+ * \brief   releases all allocations made from the given arena at once
+ * \param   [in, out] arenaPtr arena that is to be reset
+ * \warning All pointers previously returned by <tt>NkArenaAlloc()</tt> for this arena
+ *          become invalid.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkArenaReset(_Inout_ NkArena *arenaPtr);
+/**
+ * \brief  retrieves the arena for the current frame
+ *
+ * Noriko maintains two frame arenas which are swapped at the start of each iteration of
+ * the main loop. The arena that becomes current is reset in the process. Thus, memory
+ * allocated from the frame arena stays valid for the rest of the frame it was allocated
+ * in and the entire frame after it, which allows data produced during one frame to be
+ * consumed during the next.
+ *
+ * \return pointer to the frame arena
+ * \note   The frame arenas must only be used from the main thread.
+ */
+NK_NATIVE NK_API NkArena *NK_CALL NkArenaGetFrameArena(NkVoid);
+/**
+ * \brief swaps the frame arenas and resets the one that becomes current
+ * \note  This function is invoked by the main loop at the start of every frame. It
+ *        should not be called by anyone else.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkArenaBeginFrame(NkVoid);
+
+/**
+ * \brief enables or disables allocation tracking
+ *
+ * If allocation tracking is enabled, every allocation made through the general-purpose
+ * or the pool allocator is recorded, together with the call site taken from its
+ * allocation context. For each call site, the tracker aggregates the number of bytes and
+ * allocations currently alive, as well as the total number of allocations and frees.
+ * This makes it possible to find leaks and allocation hot-spots in the frame loop.
+ *
+ * \param [in] isEnabled whether or not allocations should be tracked
+ * \note  \li This function is thread-safe.
+ * \note  \li Changing the tracking state discards all data collected so far.
+ *             Allocations made before tracking was enabled are never accounted for.
+ * \note  \li Tracking can be enabled on start-up with the \c --alloctrack option.
+ * \note  \li In deploy builds, allocation contexts are only available if
+ *             \c NK_USE_ALLOCATION_TRACKING is defined; otherwise, all allocations are
+ *             attributed to the same unknown call site.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkAllocSetTracking(_In_ NkBoolean isEnabled);
+/**
+ * \brief  checks whether allocation tracking is currently enabled
+ * \return \c NK_TRUE if allocations are being tracked, \c NK_FALSE if not
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkAllocIsTracking(NkVoid);
+/**
+ * \brief prints a report of the data collected by the allocation tracker to the log
+ * \param [in] maxSites (optional) maximum number of call sites to print; pass \c 0 to
+ *             print all call sites
+ * \note  \li This function is thread-safe.
+ * \note  \li Call sites are sorted by the number of bytes they currently hold, and then
+ *             by the number of allocations they made. If tracking is enabled at shutdown,
+ *             a full report is printed automatically; call sites that still hold memory
+ *             then indicate leaks.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkAllocDumpReport(_In_opt_ NkUint32 maxSites);
 
 
@@ -0,0 +1,144 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  anim.h
+ * \brief defines the public API for sprite animation
+ *
+ * Sprite animation is split into two parts. An animation clip is a sequence of frames
+ * (source rectangles and durations) that is created once and never modified afterwards,
+ * so any number of actors can share it. An animator is a component of the entity-component
+ * storage (see <tt>ecs.h</tt>) that refers to a clip and holds the playback state of one
+ * actor. All animators are advanced together in one pass over the component's field
+ * arrays, which leaves the current source rectangle of every actor in a contiguous array
+ * that can be passed to <tt>NkIRenderer::DrawTextureBatch()</tt>.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/ecs.h>
+#include <include/Noriko/renderer.h>
+
+
+/**
+ * \struct NkAnimClip
+ * \brief  forward-declaration of opaque animation clip type
+ */
+NK_NATIVE typedef struct NkAnimClip NkAnimClip;
+
+/**
+ * \struct NkAnimClipSpecification
+ * \brief  describes the frames of an animation clip
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkAnimClipSpecification {
+    NkSize         m_structSize; /**< size of this structure, in bytes */
+    NkUint32       m_nFrames;    /**< number of frames */
+    NkRectF const *mp_rectArr;   /**< source rectangle of every frame */
+    NkFloat const *mp_durArr;    /**< duration of every frame, in seconds; \c NULL to use <tt>m_frameDur</tt> */
+    NkFloat        m_frameDur;   /**< duration of every frame if \c mp_durArr is <tt>NULL</tt> */
+    NkBoolean      m_isLooping;  /**< whether the clip starts over after the last frame */
+} NkAnimClipSpecification;
+
+/**
+ * \enum  NkAnimField
+ * \brief fields of the animator component
+ */
+NK_NATIVE typedef enum NkAnimField {
+    NkAnimFld_Clip,    /**< clip that is played (NkAnimClip const *) */
+    NkAnimFld_Time,    /**< playback position in the clip, in seconds (NkFloat) */
+    NkAnimFld_Speed,   /**< playback rate; \c 0 pauses the animator (NkFloat) */
+    NkAnimFld_Frame,   /**< index of the current frame (NkUint32) */
+    NkAnimFld_SrcRect, /**< source rectangle of the current frame (NkRectF) */
+
+    __NkAnimFld_Count__ /**< *only used internally* */
+} NkAnimField;
+
+
+/**
+ * \brief   creates a new animation clip
+ * \param   [in] clipSpec pointer to the specification of the clip
+ * \param   [out] clipPtr pointer to a variable that will receive the pointer to the
+ *                newly-created clip
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    The frame data is copied, so the arrays in \c clipSpec can be discarded once the
+ *          function returns. All frames are expected to be taken from the same texture.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkAnimClipCreate(
+    _In_       NkAnimClipSpecification const *clipSpec,
+    _Init_ptr_ NkAnimClip **clipPtr
+);
+/**
+ * \brief   destroys the given animation clip
+ * \param   [in, out] clipPtr pointer to a variable holding the pointer to the clip that
+ *                    is to be destroyed
+ * \warning No animator may refer to the clip anymore when it is destroyed.
+ * \note    <tt>*clipPtr</tt> will be set to <tt>NULL</tt>. If <tt>*clipPtr</tt> is
+ *          already <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkAnimClipDestroy(_Uninit_ptr_ NkAnimClip **clipPtr);
+/**
+ * \brief  retrieves the total duration of an animation clip
+ * \param  [in] clipPtr pointer to the animation clip
+ * \return duration of one pass through all frames, in seconds
+ */
+NK_NATIVE NK_API NkFloat NK_CALL NkAnimClipGetDuration(_In_ NkAnimClip const *clipPtr);
+
+/**
+ * \brief  registers the animator component type with an entity registry
+ * \param  [in, out] regPtr pointer to the entity registry
+ * \param  [out] typePtr pointer to a variable that receives the component type
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The fields of the component type are described by <tt>NkAnimField</tt>.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkAnimRegisterComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _Out_   NkEcsComponentType *typePtr
+);
+/**
+ * \brief  makes an animator play the given clip
+ * \param  [in, out] regPtr pointer to the entity registry
+ * \param  [in] animType animator component type
+ * \param  [in] compInd index of the animator, as returned by <tt>NkEcsFindComponent()</tt>
+ * \param  [in] clipPtr clip to play
+ * \param  [in] playSpeed playback rate; \c 1 plays the clip as specified
+ *
+ * \par Remarks
+ *   If the animator already plays \c clipPtr, only the playback rate is changed so that
+ *   calling this function every tick does not restart the clip. Otherwise, playback
+ *   starts at the first frame of the clip.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkAnimPlay(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType animType,
+    _In_    NkUint32 compInd,
+    _In_    NkAnimClip const *clipPtr,
+    _In_    NkFloat playSpeed
+);
+/**
+ * \brief advances all animators of a registry
+ * \param [in, out] regPtr pointer to the entity registry
+ * \param [in] animType animator component type
+ * \param [in] updTime time to advance the animators by, in seconds
+ * \note  Animators without a clip are skipped. Animators whose non-looping clip has ended
+ *        stay on the last frame.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkAnimUpdate(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType animType,
+    _In_    NkFloat updTime
+);
+
+
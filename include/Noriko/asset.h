@@ -25,6 +25,7 @@
 #include <include/Noriko/def.h>
 #include <include/Noriko/error.h>
 #include <include/Noriko/nkom.h>
+#include <include/Noriko/pack.h>
 #include <include/Noriko/util.h>
 
 #include <include/Noriko/dstruct/string.h>
@@ -55,6 +56,27 @@ NK_NATIVE typedef enum NkAssetState {
     __NkAsSt_Count__
 } NkAssetState;
 
+/**
+ * \struct NkAssetMemoryStatistics
+ * \brief  holds the memory accounting of the asset cache
+ * \note   All sizes are given in bytes, as reported by <tt>NkIAsset::GetMemoryUsage()</tt>.
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkAssetMemoryStatistics {
+    NkSize   m_structSize;                   /**< size of this structure, in bytes */
+    NkSize   m_memBudget;                    /**< memory budget of the cache */
+    NkSize   m_memUsage;                     /**< memory used by all cached assets */
+    NkSize   m_typeUsage[__NkAsTy_Count__];  /**< memory used by the cached assets of each type */
+    NkUint32 m_typeCount[__NkAsTy_Count__];  /**< number of cached assets of each type */
+    NkUint64 m_nEvictions;                   /**< number of assets evicted so far */
+} NkAssetMemoryStatistics;
+
+
+/**
+ * \struct NkAssetRequest
+ * \brief  forward-declaration of the opaque handle of an asynchronous asset query
+ * \see    NkIAssetManager::QueryAssetAsync()
+ */
+NK_NATIVE typedef struct NkAssetRequest NkAssetRequest;
 
 /**
  */
@@ -129,10 +151,47 @@ NKOM_DECLARE_INTERFACE(NkIAsset) {
     /**
      */
     NkAssetState (NK_CALL *GetAssetState)(_Inout_ NkIAsset *self);
+    /**
+     * \brief  retrieves the amount of memory the asset currently occupies
+     * \param  [in, out] self current \c NkIAsset instance
+     * \return size of the asset's CPU- and GPU-side data, in bytes; \c 0 if the asset is
+     *         not loaded
+     * \note   The value is used by the asset manager to enforce its memory budget. It does
+     *         not need to be exact, but it should be cheap to compute.
+     */
+    NkSize (NK_CALL *GetMemoryUsage)(_Inout_ NkIAsset *self);
 
     /**
+     * \brief  loads the device-independent data of the asset
+     * \param  [in, out] self current \c NkIAsset instance
+     * \param  [in, out] extraCxtPtr (optional) context pointer passed to the query, or
+     *                   \c NULL if the asset is reloaded
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   \li The asset manager never runs this function on the same asset on two
+     *              threads at once, nor while the asset is being finalized. If the asset is
+     *              queried multiple times while it is being loaded, it is loaded and
+     *              finalized only once, by the first of the requests that is finalized; the
+     *              function is only called again if the load or the finalization failed.
+     * \note   \li If the asset manager was started with \c --hotreload, this function is
+     *              called again on an asset that is ready when its file changed. The asset
+     *              must continue to provide its current data while the new data is loaded,
+     *              and only replace it in the following call to <tt>NkIAsset::Finalize()</tt>.
+     *              Reloads never overlap a pending load of the asset.
      */
     NkErrorCode (NK_CALL *Load)(_Inout_ NkIAsset *self, _Inout_opt_ NkVoid *extraCxtPtr);
+    /**
+     * \brief  finishes loading the asset by creating its device-dependent resources
+     * \param  [in, out] self current \c NkIAsset instance
+     * \param  [in, out] extraCxtPtr (optional) context pointer that was passed to
+     *                   <tt>NkIAsset::Load()</tt>
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   \li <tt>NkIAsset::Load()</tt> may be run on worker threads and must thus be
+     *              limited to file I/O and decoding. Everything that has to be done on the
+     *              main thread, such as creating renderer resources, is done here.
+     * \note   \li Assets that do not have device-dependent parts return
+     *              \c NkErr_Ok without doing anything.
+     */
+    NkErrorCode (NK_CALL *Finalize)(_Inout_ NkIAsset *self, _Inout_opt_ NkVoid *extraCxtPtr);
     /**
      */
     NkErrorCode (NK_CALL *Unload)(_Inout_ NkIAsset *self, _Inout_opt_ NkVoid *extraCxtPtr);
@@ -178,6 +237,179 @@ NKOM_DECLARE_INTERFACE(NkIAssetManager) {
         _In_     NkUuid const *assetId,
         _Outptr_ NkIAsset **resPtr
     );
+    /**
+     * \brief  queries multiple assets at once
+     * \param  [in, out] self current \c NkIAssetManager instance
+     * \param  [in] idArr array of UUIDs of the assets that are to be queried
+     * \param  [in] nIds number of elements in \c idArr
+     * \param  [out] resArr array of \c nIds elements that receives the assets in the
+     *               order of \c idArr; the reference count of every asset is incremented
+     * \return \c NkErr_Ok if all assets were found, \c NkErr_ItemNotFound if at least one
+     *         asset does not exist, or another non-zero value on failure
+     *
+     * \par Remarks
+     *   Assets that are cached are taken from the cache. All others are resolved with a
+     *   single query per 64 assets instead of one query per asset, and added to the cache
+     *   in bulk. Prefer this function over calling <tt>NkIAssetManager::QueryAsset()</tt>
+     *   in a loop, for example when loading everything a world chunk references.<br>
+     *   If an asset does not exist, its element in \c resArr is set to \c NULL and the
+     *   other elements are still filled. If the function fails otherwise, all elements are
+     *   set to <tt>NULL</tt>. UUIDs may appear multiple times in \c idArr.
+     */
+    NkErrorCode (NK_CALL *QueryAssets)(
+        _Inout_         NkIAssetManager *self,
+        _I_array_(nIds) NkUuid const *idArr,
+        _In_            NkSize nIds,
+        _O_array_(nIds) NkIAsset **resArr
+    );
+    /**
+     * \brief  starts loading an asset in the background
+     * \param  [in, out] self current \c NkIAssetManager instance
+     * \param  [in] assetId UUID of the asset that is to be loaded
+     * \param  [in, out] extraCxtPtr (optional) context pointer that is passed to
+     *                   <tt>NkIAsset::Load()</tt> and <tt>NkIAsset::Finalize()</tt>
+     * \param  [out] reqPtr pointer to a variable that receives the request handle
+     * \return \c NkErr_Ok if the request was issued, non-zero on failure
+     *
+     * \par Remarks
+     *   The database lookup and <tt>NkIAsset::Load()</tt> are run on a worker thread of
+     *   the job system, so this function returns immediately. While that happens, the
+     *   request is in the \c NkAsSt_Loading state. Afterwards, it enters the
+     *   \c NkAsSt_ReadyForLoading state and waits for its device-dependent finalization
+     *   which is done on the main thread by <tt>NkIAssetManager::ProcessRequests()</tt>
+     *   (called once per frame by the main loop) or by
+     *   <tt>NkIAssetManager::WaitForRequest()</tt>. Finally, the request is either
+     *   \c NkAsSt_Ready or, if any step failed, <tt>NkAsSt_Invalid</tt>.<br>
+     *   This function can be called from any thread. Every request must be released
+     *   using <tt>NkIAssetManager::ReleaseRequest()</tt>.
+     */
+    NkErrorCode (NK_CALL *QueryAssetAsync)(
+        _Inout_     NkIAssetManager *self,
+        _In_        NkUuid const *assetId,
+        _Inout_opt_ NkVoid *extraCxtPtr,
+        _Init_ptr_  NkAssetRequest **reqPtr
+    );
+    /**
+     * \brief  queries an asset together with everything it depends on asynchronously
+     * \param  [in, out] self current \c NkIAssetManager instance
+     * \param  [in] rootId UUID of the root asset, for example a world or a level
+     * \param  [in, out] extraCxtPtr (optional) context pointer that is passed to the
+     *                   load functions of all assets
+     * \param  [out] reqPtr pointer to a variable that receives the request handle of the
+     *               root asset
+     * \return \c NkErr_Ok on success, \c NkErr_ComponentState if no database is open, or
+     *         another non-zero value on failure
+     *
+     * \par Remarks
+     *   The transitive dependencies of the root are resolved on the calling thread using
+     *   a single recursive query on the \c dependencies table. The assets are then loaded
+     *   in the background in topological order: an asset is only loaded once everything
+     *   it depends on has been loaded, and independent assets are loaded in parallel. The
+     *   root is loaded last.<br>
+     *   The returned request behaves like a request returned by
+     *   <tt>NkIAssetManager::QueryAssetAsync()</tt> and refers to the root. The
+     *   dependencies are finalized by <tt>NkIAssetManager::ProcessRequests()</tt> as they
+     *   finish loading, or by <tt>NkIAssetManager::WaitForRequest()</tt> at the latest.
+     *   Failing to load a dependency is logged but does not fail the root. The
+     *   dependencies stay referenced until the request is released.
+     */
+    NkErrorCode (NK_CALL *PrefetchAsset)(
+        _Inout_     NkIAssetManager *self,
+        _In_        NkUuid const *rootId,
+        _Inout_opt_ NkVoid *extraCxtPtr,
+        _Init_ptr_  NkAssetRequest **reqPtr
+    );
+    /**
+     * \brief  retrieves the current state of an asynchronous asset query
+     * \param  [in, out] self current \c NkIAssetManager instance
+     * \param  [in] reqPtr request handle
+     * \return current state of the request
+     * \note   This function can be called from any thread and never blocks.
+     */
+    NkAssetState (NK_CALL *QueryRequestState)(_Inout_ NkIAssetManager *self, _In_ NkAssetRequest const *reqPtr);
+    /**
+     * \brief  blocks until an asynchronous asset query has completed
+     * \param  [in, out] self current \c NkIAssetManager instance
+     * \param  [in, out] reqPtr request handle
+     * \param  [out] resPtr (optional) pointer to a variable that receives the asset; its
+     *               reference count is incremented
+     * \return \c NkErr_Ok if the asset is ready, or the error code of the step that
+     *         failed
+     * \note   \li While waiting, the calling thread runs pending jobs.
+     * \note   \li If the request is waiting for its finalization, it is finalized right
+     *              away. Thus, this function must only be called from the main thread.
+     */
+    NkErrorCode (NK_CALL *WaitForRequest)(
+        _Inout_      NkIAssetManager *self,
+        _Inout_      NkAssetRequest *reqPtr,
+        _Out_opt_    NkIAsset **resPtr
+    );
+    /**
+     * \brief releases a request handle
+     * \param [in, out] self current \c NkIAssetManager instance
+     * \param [in, out] reqPtr pointer to a variable holding the request handle; will be
+     *                  set to <tt>NULL</tt>
+     * \note  \li If the request is still loading, the function waits for the worker to
+     *             finish. Requests that were not finalized yet are discarded.
+     * \note  \li This function must only be called from the main thread.
+     */
+    NkVoid (NK_CALL *ReleaseRequest)(_Inout_ NkIAssetManager *self, _Uninit_ptr_ NkAssetRequest **reqPtr);
+    /**
+     * \brief  finalizes the asynchronous asset queries that finished loading
+     * \param  [in, out] self current \c NkIAssetManager instance
+     * \param  [in] maxCount maximum number of requests to finalize
+     * \return number of requests that were finalized
+     * \note   \li Requests are finalized in the order they finished loading.
+     * \note   \li Afterwards, the memory budget is enforced; see
+     *              <tt>NkIAssetManager::SetMemoryBudget()</tt>.
+     * \note   \li If started with \c --hotreload, the asset directory is watched for
+     *              changed files. Once a file was not written to for 100 ms, the ready
+     *              assets loaded from it are reloaded on worker threads, and finalized by
+     *              this function like the queries, so that the new resources replace the
+     *              old ones in between two frames.
+     * \note   \li This function must only be called from the main thread. It is called
+     *              once per frame by the main loop.
+     */
+    NkUint32 (NK_CALL *ProcessRequests)(_Inout_ NkIAssetManager *self, _In_ NkUint32 maxCount);
+    /**
+     * \brief  retrieves the number of assets that are currently held in the asset cache
+     * \return number of cached assets; \c 0 if the asset manager is not initialized
+     * \note   This function can be called from any thread and never blocks.
+     */
+    NkSize (NK_CALL *QueryCacheCount)(_Inout_ NkIAssetManager *self);
+    /**
+     * \brief sets the amount of memory the cached assets may occupy
+     * \param [in, out] self current \c NkIAssetManager instance
+     * \param [in] nBytes new memory budget, in bytes
+     *
+     * \par Remarks
+     *   While the cached assets occupy more memory than the budget allows, the assets that
+     *   have not been queried for the longest time are unloaded and removed from the
+     *   cache. Only assets that are referenced by nothing but the cache are evicted, so
+     *   the budget can be exceeded if enough assets are in use. The budget is enforced
+     *   right away and by every call to <tt>NkIAssetManager::ProcessRequests()</tt>.<br>
+     *   The default budget is 512 MiB; it can be changed on start-up using the
+     *   \c --assetbudget=<MiB> option.
+     * \note  This function must only be called from the main thread.
+     */
+    NkVoid (NK_CALL *SetMemoryBudget)(_Inout_ NkIAssetManager *self, _In_ NkSize nBytes);
+    /**
+     * \brief retrieves the memory accounting of the asset cache
+     * \param [in, out] self current \c NkIAssetManager instance
+     * \param [out] statsPtr pointer to a structure that receives the statistics
+     * \note  This function can be called from any thread.
+     */
+    NkVoid (NK_CALL *QueryMemoryStatistics)(_Inout_ NkIAssetManager *self, _Out_ NkAssetMemoryStatistics *statsPtr);
+    /**
+     * \brief  retrieves the pack archive holding the cooked asset data
+     * \param  [in, out] self current \c NkIAssetManager instance
+     * \return pointer to the archive, or \c NULL if assets are loaded from loose files
+     * \note   \li In standalone mode, the archive \c assets.pak is mapped on start-up if
+     *              it exists. Loaders can use <tt>NkPackArchiveMapBlob()</tt> to access the
+     *              data of an asset without copying it.
+     * \note   \li The archive stays valid until the asset manager is shut down.
+     */
+    NkPackArchive const *(NK_CALL *QueryPackArchive)(_Inout_ NkIAssetManager *self);
 };
 
 
@@ -0,0 +1,134 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  asyncio.h
+ * \brief defines the public API for asynchronous file reads
+ *
+ * The asynchronous I/O service reads from files without blocking the calling thread.
+ * Requests are queued by priority and issued by a dedicated I/O thread, which keeps a
+ * limited number of reads in flight so that urgent requests submitted later do not have
+ * to wait behind a long queue at the device. Once a read finished, its completion
+ * callback is run as a job on the job system; worker threads therefore never wait for
+ * the disk.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
+#include <include/Noriko/job.h>
+
+
+/**
+ * \enum  NkAsyncIOPriority
+ * \brief priorities of asynchronous reads; requests with a higher priority (lower value)
+ *        are issued first
+ */
+NK_NATIVE typedef enum NkAsyncIOPriority {
+    NkAioPrio_Critical, /**< data needed for the current frame */
+    NkAioPrio_High,     /**< streaming data, for example map chunks */
+    NkAioPrio_Normal,   /**< regular asset loads */
+    NkAioPrio_Low,      /**< data that is nice to have, for example UI icons */
+
+    __NkAioPrio_Count__
+} NkAsyncIOPriority;
+
+
+/**
+ * \struct NkAsyncFile
+ * \brief  forward-declaration of the opaque type of a file opened for asynchronous reads
+ */
+NK_NATIVE typedef struct NkAsyncFile NkAsyncFile;
+
+/**
+ * \typedef NkAsyncReadFn
+ * \brief   completion callback of an asynchronous read
+ * \param   [in] errCode \c NkErr_Ok if the read succeeded, \c NkErr_ManuallyAborted if
+ *               the request was discarded on shutdown, or another non-zero value if the
+ *               read failed
+ * \param   [in] dataBuf part of the destination buffer that holds the bytes read
+ * \param   [in, out] extraCxt (optional) user-defined context pointer
+ * \note    The callback is run as a job, possibly on a worker thread.
+ */
+NK_NATIVE typedef NkVoid (NK_CALL *NkAsyncReadFn)(
+    _In_        NkErrorCode errCode,
+    _In_        NkBufferView dataBuf,
+    _Inout_opt_ NkVoid *extraCxt
+);
+
+/**
+ * \struct NkAsyncReadRequest
+ * \brief  describes a single asynchronous read
+ */
+NK_NATIVE typedef struct NkAsyncReadRequest {
+    NkAsyncFile      *mp_fileHnd;   /**< file to read from */
+    NkUint64          m_fileOffset; /**< offset of the first byte to read */
+    NkBufferView      m_destBuf;    /**< buffer receiving the data; its size is the number of bytes to read */
+    NkAsyncIOPriority m_prioVal;    /**< priority of the request */
+    NkAsyncReadFn     mp_complFn;   /**< (optional) completion callback */
+    NkVoid           *mp_extraCxt;  /**< context passed to <tt>mp_complFn</tt> */
+} NkAsyncReadRequest;
+
+
+/**
+ * \brief  opens a file for asynchronous reads
+ * \param  [in] pathStr path of the file
+ * \param  [out] filePtr pointer to a variable that receives the pointer to the file
+ * \param  [out] sizePtr (optional) pointer to a variable that receives the size of the
+ *               file, in bytes
+ * \return \c NkErr_Ok on success, \c NkErr_OpenFile if the file could not be opened
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkAsyncIOOpenFile(
+    _In_z_ _Utf8_ char const *pathStr,
+    _Init_ptr_    NkAsyncFile **filePtr,
+    _Out_opt_     NkUint64 *sizePtr
+);
+/**
+ * \brief   closes a file opened by <tt>NkAsyncIOOpenFile()</tt>
+ * \param   [in, out] filePtr pointer to a variable holding the pointer to the file
+ * \note    <tt>*filePtr</tt> will be set to <tt>NULL</tt>. If <tt>*filePtr</tt> is
+ *          already <tt>NULL</tt>, the function does nothing.
+ * \warning All requests referring to the file must have completed.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkAsyncIOCloseFile(_Uninit_ptr_ NkAsyncFile **filePtr);
+/**
+ * \brief  submits a batch of asynchronous reads
+ * \param  [in] reqArr array of requests; the requests are copied
+ * \param  [in] nReqs number of elements in \c reqArr
+ * \param  [in, out] jobCounter (optional) counter that is incremented by \c nReqs and
+ *                   decremented each time a completion callback has returned
+ * \return \c NkErr_Ok on success, \c NkErr_InvalidRange if a request reads more than
+ *         4 GiB at once, or another non-zero value on failure
+ *
+ * \par Remarks
+ *   This function can be called from any thread and does not wait for the disk. Within
+ *   the same priority, requests are issued in the order they were submitted. The
+ *   destination buffers must stay valid until the respective callback has been run. If
+ *   \c NK_TARGET_MULTITHREADED is not defined, the reads are carried out before this
+ *   function returns.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkAsyncIOSubmitReads(
+    _I_array_(nReqs) NkAsyncReadRequest const *reqArr,
+    _In_             NkSize nReqs,
+    _Inout_opt_      NkJobCounter *jobCounter
+);
+/**
+ * \brief  retrieves the number of requests that have not completed yet
+ * \return number of queued and in-flight requests
+ */
+NK_NATIVE NK_API NkSize NK_CALL NkAsyncIOQueryPendingCount(NkVoid);
+
+
@@ -0,0 +1,156 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  atlas.h
+ * \brief defines the public API for the texture atlas builder, that is, a packer that
+ *        combines many bitmaps into a few large textures
+ *
+ * Every texture that is drawn from requires the renderer to bind it, so drawing sprites
+ * that are spread across many small textures causes a texture switch for almost every
+ * draw call. The atlas builder takes any number of device-independent bitmaps, packs them
+ * into as few pages as possible using a skyline packer and creates one texture per page,
+ * plus a premultiplied-alpha texture for pages that hold keyed bitmaps. Every bitmap is subdivided into cells (for example, the
+ * tiles of a tile sheet) and each cell is handed back as a sub-texture: a lightweight
+ * handle that carries the page resources and the precomputed source rectangle of the
+ * cell, ready to be passed to the renderer.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/bmp.h>
+#include <include/Noriko/renderer.h>
+
+
+/**
+ * \struct NkTextureAtlas
+ * \brief  forward-declaration of opaque texture atlas type
+ */
+NK_NATIVE typedef struct NkTextureAtlas NkTextureAtlas;
+
+/**
+ * \typedef NkSubTextureId
+ * \brief   numeric identifier of a sub-texture inside a texture atlas
+ * \note    The cells of a bitmap added to the atlas are given consecutive identifiers in
+ *          row-major order.
+ */
+NK_NATIVE typedef NkUint32 NkSubTextureId;
+
+/**
+ * \struct NkSubTexture
+ * \brief  represents a region of an atlas page that can be drawn directly
+ */
+NK_NATIVE typedef struct NkSubTexture {
+    NkRendererResource const *mp_texRef;   /**< texture of the page the region is on */
+    NkRendererResource const *mp_alphaRef; /**< alpha texture of the page, or \c NULL if the region is opaque */
+    NkRectF                   m_srcRect;   /**< region inside the page, in pixels */
+} NkSubTexture;
+
+/**
+ * \struct NkTextureAtlasSpecification
+ * \brief  holds configuration properties for the texture atlas
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkTextureAtlasSpecification {
+    NkSize       m_structSize; /**< size of this structure, in bytes */
+    NkIRenderer *mp_rdRef;     /**< renderer to create the page textures with */
+    NkSize2D     m_pageDim;    /**< maximum dimensions of a page, in pixels */
+    NkUint32     m_padding;    /**< space left between packed bitmaps, in pixels */
+    NkRgbaColor  m_keyCol;     /**< color of transparent pixels in all pages */
+} NkTextureAtlasSpecification;
+
+
+/**
+ * \brief   creates a new, empty texture atlas
+ * \param   [in] atlasSpec pointer to the specification of the atlas
+ * \param   [out] atlasPtr pointer to a variable that will receive the pointer to the
+ *                newly-created atlas
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    The atlas holds a reference to the renderer until it is destroyed.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkTextureAtlasCreate(
+    _In_       NkTextureAtlasSpecification const *atlasSpec,
+    _Init_ptr_ NkTextureAtlas **atlasPtr
+);
+/**
+ * \brief destroys the given texture atlas, including all page textures
+ * \param [in, out] atlasPtr pointer to a variable holding the pointer to the atlas that
+ *                  is to be destroyed
+ * \note  <tt>*atlasPtr</tt> will be set to <tt>NULL</tt>. If <tt>*atlasPtr</tt> is
+ *        already <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkTextureAtlasDestroy(_Uninit_ptr_ NkTextureAtlas **atlasPtr);
+/**
+ * \brief   registers a bitmap with the atlas
+ * \param   [in, out] atlasPtr pointer to the texture atlas
+ * \param   [in] bmpPtr pointer to the bitmap that is to be packed
+ * \param   [in] cellDim extents of a single cell of the bitmap, in pixels; pass
+ *               <tt>(0, 0)</tt> to treat the entire bitmap as a single cell
+ * \param   [in] keyCol (optional) color that is transparent in the bitmap, or \c NULL if
+ *               the bitmap is opaque
+ * \param   [out] firstId pointer to a variable that receives the identifier of the first
+ *                cell of the bitmap
+ * \return  \c NkErr_Ok on success, \c NkErr_ObjectState if the atlas was already built,
+ *          \c NkErr_InvImageDimensions if the bitmap does not fit into a page, or
+ *          another non-zero value on failure
+ * \warning The bitmap is not copied; it must stay alive until
+ *          <tt>NkTextureAtlasBuild()</tt> returns.
+ *
+ * \par Remarks
+ *   The bitmap is packed as a whole so that all of its cells end up on the same page.
+ *   Pixels of the color \c keyCol are replaced by the key color of the atlas, which makes
+ *   it possible to pack bitmaps that use different key colors into the same page.
+ *   Sub-textures of opaque bitmaps do not reference the alpha texture of the page. Only 24- and 32-bit
+ *   bitmaps are supported; alpha channels are discarded.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkTextureAtlasAddBitmap(
+    _Inout_  NkTextureAtlas *atlasPtr,
+    _In_     NkDIBitmap const *bmpPtr,
+    _In_     NkSize2D cellDim,
+    _In_opt_ NkRgbaColor const *keyCol,
+    _Out_    NkSubTextureId *firstId
+);
+/**
+ * \brief  packs all registered bitmaps and creates the page textures
+ * \param  [in, out] atlasPtr pointer to the texture atlas
+ * \return \c NkErr_Ok on success, \c NkErr_ObjectState if the atlas was already built,
+ *         or another non-zero value on failure
+ * \note   \li After the function returns successfully, no more bitmaps can be added and
+ *             the bitmaps that were registered are not needed anymore.
+ * \note   \li Bitmaps are packed in the order of decreasing height, which leaves less
+ *             space unused than packing them in the order they were added.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkTextureAtlasBuild(_Inout_ NkTextureAtlas *atlasPtr);
+/**
+ * \brief   retrieves the sub-texture with the given identifier
+ * \param   [in] atlasPtr pointer to the texture atlas
+ * \param   [in] subId identifier of the sub-texture
+ * \return  pointer to the sub-texture; valid for as long as the atlas exists
+ * \warning The behavior is undefined if the atlas has not been built yet or if \c subId
+ *          was not returned by <tt>NkTextureAtlasAddBitmap()</tt> (or is out of the
+ *          range of cells of the respective bitmap).
+ */
+NK_NATIVE NK_API NK_INLINE NkSubTexture const *NK_CALL NkTextureAtlasQuerySubTexture(
+    _In_ NkTextureAtlas const *atlasPtr,
+    _In_ NkSubTextureId subId
+);
+/**
+ * \brief  retrieves the number of pages the registered bitmaps were packed into
+ * \param  [in] atlasPtr pointer to the texture atlas
+ * \return number of pages; \c 0 if the atlas has not been built yet
+ */
+NK_NATIVE NK_API NkSize NK_CALL NkTextureAtlasQueryPageCount(_In_ NkTextureAtlas const *atlasPtr);
+
+
@@ -28,6 +28,7 @@
 /* Noriko includes */
 #include <include/Noriko/def.h>
 #include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
 
 
 /**
@@ -67,7 +68,7 @@ NK_NATIVE typedef struct NkBitmapSpecification {
  *         format that is standardized and can be used to transfer between devices)
  */
 NK_NATIVE typedef struct NkDIBitmap {
-    alignas(NkInt64) NkByte __placeholder__[48]; /**< placeholder for internal data */
+    alignas(NkInt64) NkByte __placeholder__[56]; /**< placeholder for internal data */
 } NkDIBitmap;
 
 
@@ -131,6 +132,34 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkDIBitmapCreate(
  *   <tt>https://en.wikipedia.org/wiki/BMP_file_format</tt>.
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkDIBitmapLoad(_In_z_ char const *filePath, _Out_ NkDIBitmap *resPtr);
+/**
+ * \brief   loads a bitmap from the contents of a bitmap file that are already in memory
+ * \param   [in] fileBuf view of the entire bitmap file, for example a memory-mapped file
+ *               or a blob of a pack archive
+ * \param   [out] resPtr pointer to the \c NkDIBitmap instance that will receive the
+ *                representation of the bitmap
+ * \return  \c NkErr_Ok on success, \c NkErr_UnsupportedFileFormat if the headers are not
+ *          supported, \c NkErr_CorruptedData if the pixel array exceeds the buffer, or
+ *          another non-zero value on failure
+ * \note    If the function fails, no bitmap will be created and the contents of
+ *          \c resPtr are indeterminate.
+ * \warning \li If the pixel array is referenced (see remarks), the bitmap must not be
+ *              used after the memory of \c fileBuf has been released, and the pixels
+ *              must not be written to if the memory is read-only.
+ * \warning \li The same rules regarding reused instances as for
+ *              <tt>NkDIBitmapLoad()</tt> apply.
+ * 
+ * \par Remarks
+ *   The headers are parsed in place. If the pixel array is uncompressed and stored
+ *   bottom-up (which is the default for BMP files), the bitmap references the pixel array
+ *   inside of \c fileBuf directly; no memory is allocated and no pixels are copied.
+ *   Top-down bitmaps are converted on load, which requires a copy. The supported pixel
+ *   formats are the same as for <tt>NkDIBitmapLoad()</tt>.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkDIBitmapLoadFromMemory(
+    _In_  NkBufferView fileBuf,
+    _Out_ NkDIBitmap *resPtr
+);
 /**
  * \brief   destroys the given device-independent bitmap, freeing all its resources
  * \param   [in,out] bmpPtr pointer to the \c NkDIBitmap instance that is to be freed
@@ -156,6 +185,28 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkDIBitmapSave(
     _In_   NkDIBitmap const *bmpPtr,
     _In_z_ char const *filePath
 );
+/**
+ * \brief   creates a copy of a bitmap that is half as wide and half as high
+ * \param   [in] srcPtr pointer to the \c NkDIBitmap instance that is to be downsampled
+ * \param   [out] resPtr pointer to the \c NkDIBitmap instance that will receive the
+ *                downsampled bitmap
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    If the function fails, no bitmap will be created and the contents of
+ *          \c resPtr are indeterminate.
+ * \warning The same rules as for <tt>NkDIBitmapCreate()</tt> apply if \c resPtr already
+ *          points to a valid instance of <tt>NkDIBitmap</tt>.
+ * 
+ * \par Remarks
+ *   Every pixel of the result is the average of a 2x2 block of source pixels (box
+ *   filter). Odd widths and heights are rounded down, dropping the last column or row.
+ *   The result uses the same specification as the source bitmap, apart from its
+ *   dimensions. The source bitmap must be at least two pixels wide and high. Calling
+ *   this function repeatedly on its own results yields a mip chain.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkDIBitmapDownsample(
+    _In_  NkDIBitmap const *srcPtr,
+    _Out_ NkDIBitmap *resPtr
+);
 /**
  * \brief   retrieves the current specification of the current \c NkDIBitmap instance
  * \param   [in] bmpPtr pointer to the \c NkDIBitmap instance of which the specification
@@ -0,0 +1,112 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  capture.h
+ * \brief defines the public API for non-blocking framebuffer captures
+ *
+ * The capture service takes screenshots and records gameplay as a sequence of bitmap
+ * files. The main thread only copies the framebuffer into one of a few recycled
+ * bitmaps; writing the file is done by the job system. This way, capturing does not
+ * stall the frame on disk I/O.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
+#include <include/Noriko/renderer.h>
+
+
+/**
+ * \def   NK_CAPTURE_POOLSIZE
+ * \brief number of bitmaps that are recycled for captures
+ * \note  If all bitmaps are still being written while a new recording frame is due, the
+ *        frame is dropped.
+ */
+#define NK_CAPTURE_POOLSIZE ((NkUint32)(4))
+/**
+ * \def   NK_CAPTURE_MAXPATH
+ * \brief maximum length of the path of a capture file, in bytes, including the
+ *        terminating NUL character
+ */
+#define NK_CAPTURE_MAXPATH  ((NkSize)(260))
+
+
+/**
+ * \brief  takes a screenshot of the given renderer's framebuffer
+ * \param  [in, out] rdRef renderer whose framebuffer is to be captured
+ * \param  [in] filePath path of the bitmap file the screenshot is written to; an existing
+ *              file is overwritten
+ * \return \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   The framebuffer is copied immediately, so the screenshot shows the last frame that was
+ *   rendered. The file is written on a worker thread; this function returns before it has
+ *   been written. Errors while writing are only logged.
+ * \note   This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkCaptureScreenshot(
+    _Inout_       NkIRenderer *rdRef,
+    _In_z_ _Utf8_ char const *filePath
+);
+/**
+ * \brief  starts recording frames at a fixed rate
+ * \param  [in] pathPrefix path prefix of the frame files; the frame number and the file
+ *              extension are appended to it
+ * \param  [in] frameRate number of frames to record per second
+ * \return \c NkErr_Ok on success, \c NkErr_NoOperation if a recording is already running,
+ *         or another non-zero value on failure
+ *
+ * \par Remarks
+ *   Recorded frames are written as numbered bitmap files, for example
+ *   <tt>\<pathPrefix\>000042.bmp</tt>, which can be turned into a video with external
+ *   tools. Frames are captured in <tt>NkCaptureOnFrame()</tt> whenever at least
+ *   <tt>1 / frameRate</tt> seconds have passed since the last captured frame. If the game
+ *   renders slower than \c frameRate, every frame is captured. Recordings can also be
+ *   toggled by pressing F10 in the world layer.
+ * \note   This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkCaptureBeginRecording(
+    _In_z_ _Utf8_ char const *pathPrefix,
+    _In_          NkUint32 frameRate
+);
+/**
+ * \brief stops the current recording
+ * \note  \li Frames that have already been captured are still written.
+ * \note  \li If no recording is running, this function does nothing.
+ * \note  \li This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkCaptureEndRecording(NkVoid);
+/**
+ * \brief  checks whether a recording is running
+ * \return \c NK_TRUE if frames are being recorded, \c NK_FALSE if not
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkCaptureIsRecording(NkVoid);
+/**
+ * \brief captures the current frame if a recording is running and a frame is due
+ * \param [in, out] rdRef renderer whose framebuffer is to be captured
+ * \note  \li This function is called by the main loop after every rendered frame; it does
+ *            not need to be called manually.
+ * \note  \li This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkCaptureOnFrame(_Inout_ NkIRenderer *rdRef);
+/**
+ * \brief waits until all captured frames have been written
+ * \note  While waiting, the calling thread helps running pending jobs.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkCaptureWaitIdle(NkVoid);
+
+
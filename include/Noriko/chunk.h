@@ -0,0 +1,220 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  chunk.h
+ * \brief defines the public API for the chunk streamer, that is, the component that
+ *        keeps the parts of a world around a point of interest resident in memory
+ *
+ * Worlds are divided into equally-sized rectangular chunks of tiles. The chunk streamer
+ * keeps all chunks within a configurable radius around a center chunk (usually the one
+ * the player is in) resident. Chunks that enter the radius are loaded, and chunks that
+ * leave it are freed, on a dedicated background thread so that the update thread never
+ * blocks on I/O. By default, chunk data is read from the \c chunks table of the asset
+ * database.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
+
+
+/**
+ * \struct NkChunkStreamer
+ * \brief  forward-declaration of opaque chunk streamer type
+ */
+NK_NATIVE typedef struct NkChunkStreamer NkChunkStreamer;
+
+/**
+ * \typedef NkChunkLoadFn
+ * \brief   callback used by the chunk streamer to load the tile data of a chunk
+ * \param   [in, out] extraCxt (optional) user-defined context pointer
+ * \param   [in] chunkPos position of the chunk, in chunks
+ * \param   [in] nTiles number of tiles in a chunk
+ * \param   [out] tileArr array that receives the tiles of the chunk in row-major order
+ * \return  \c NkErr_Ok if the chunk was loaded, \c NkErr_NoOperation if there is no
+ *          chunk at the given position, or any other error code on failure
+ * \note    This function is invoked on the streaming thread.
+ */
+NK_NATIVE typedef NkErrorCode (NK_CALL *NkChunkLoadFn)(
+    _Inout_opt_       NkVoid *extraCxt,
+    _In_              NkPoint2D chunkPos,
+    _In_              NkSize nTiles,
+    _O_array_(nTiles) NkUint32 *tileArr
+);
+/**
+ * \typedef NkChunkReadyFn
+ * \brief   callback invoked when a chunk has become available
+ * \param   [in, out] extraCxt (optional) user-defined context pointer
+ * \param   [in] chunkPos position of the chunk, in chunks
+ * \note    This function is invoked from within <tt>NkChunkStreamerUpdate()</tt>, that
+ *          is, on the thread that updates the streamer.
+ */
+NK_NATIVE typedef NkVoid (NK_CALL *NkChunkReadyFn)(_Inout_opt_ NkVoid *extraCxt, _In_ NkPoint2D chunkPos);
+/**
+ * \typedef NkChunkSolidFn
+ * \brief   callback used by the chunk streamer to decide whether a tile blocks movement
+ * \param   [in, out] extraCxt (optional) user-defined context pointer
+ * \param   [in] tileVal value of the tile, as returned by the loader
+ * \return  \c NK_TRUE if the tile blocks movement, \c NK_FALSE if not
+ * \note    This function is invoked on the streaming thread, once for every tile of a
+ *          chunk that was loaded.
+ */
+NK_NATIVE typedef NkBoolean (NK_CALL *NkChunkSolidFn)(_Inout_opt_ NkVoid *extraCxt, _In_ NkUint32 tileVal);
+
+/**
+ * \struct NkChunkStreamerSpecification
+ * \brief  holds configuration properties for the chunk streamer
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkChunkStreamerSpecification {
+    NkSize          m_structSize;  /**< size of this structure, in bytes */
+    NkSize2D        m_chunkExt;    /**< extents of a chunk, in tiles */
+    NkUint32        m_resRadius;   /**< radius around the center chunk that is kept resident, in chunks */
+    NkChunkLoadFn   mp_fnLoad;     /**< (optional) chunk loader; \c NULL to load from the asset database */
+    NkChunkReadyFn  mp_fnReady;    /**< (optional) invoked whenever a chunk became available */
+    NkChunkSolidFn  mp_fnSolid;    /**< (optional) classifies tiles for collision; \c NULL if no tile blocks */
+    NkVoid         *mp_extraCxt;   /**< context passed to the callbacks */
+    char const     *mp_dbPath;     /**< path of the asset database (only if <tt>mp_fnLoad == NULL</tt>) */
+    NkUuid          m_worldUuid;   /**< world asset the chunks belong to (only if <tt>mp_fnLoad == NULL</tt>) */
+} NkChunkStreamerSpecification;
+
+
+/**
+ * \brief   creates a new chunk streamer and starts its streaming thread
+ * \param   [in] strSpec pointer to the specification of the chunk streamer
+ * \param   [out] strPtr pointer to a variable that will receive the pointer to the
+ *                newly-created chunk streamer
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    No chunk is resident until <tt>NkChunkStreamerUpdate()</tt> is called for the
+ *          first time.
+ * \warning If \c mp_fnLoad is \c NULL, \c mp_dbPath must point to a valid database; it
+ *          is opened read-only by the streaming thread using a dedicated connection.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkChunkStreamerCreate(
+    _In_       NkChunkStreamerSpecification const *strSpec,
+    _Init_ptr_ NkChunkStreamer **strPtr
+);
+/**
+ * \brief destroys the given chunk streamer, waiting for the streaming thread to finish,
+ *        and frees all resident chunks
+ * \param [in, out] strPtr pointer to a variable holding the pointer to the chunk
+ *                  streamer that is to be destroyed
+ * \note  <tt>*strPtr</tt> will be set to <tt>NULL</tt>. If <tt>*strPtr</tt> is already
+ *        <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkChunkStreamerDestroy(_Uninit_ptr_ NkChunkStreamer **strPtr);
+/**
+ * \brief  updates the set of resident chunks
+ * \param  [in, out] strPtr pointer to the chunk streamer
+ * \param  [in] centerChunk chunk the residency radius is centered around, in chunks
+ * \return \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   First, the ready callback is invoked for every chunk that finished loading since
+ *   the last update. Then, chunks that are more than one chunk outside of the radius are
+ *   handed to the streaming thread to be freed; the extra chunk prevents chunks from
+ *   being reloaded repeatedly when the center moves back and forth across a chunk
+ *   border. At last, chunks that entered the radius are queued for loading, closest
+ *   chunks first. This function never blocks on I/O.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkChunkStreamerUpdate(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D centerChunk
+);
+/**
+ * \brief  retrieves a single tile from the resident chunks
+ * \param  [in, out] strPtr pointer to the chunk streamer
+ * \param  [in] tilePos position of the tile, in tiles, in world space
+ * \param  [out] tileVal pointer to a variable that receives the value of the tile
+ * \return \c NK_TRUE if the chunk containing the tile is resident and loaded,
+ *         \c NK_FALSE if it is still loading, not resident, or does not exist
+ * \note   This function must be called from the thread that updates the streamer.
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkChunkStreamerQueryTile(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D tilePos,
+    _Out_   NkUint32 *tileVal
+);
+/**
+ * \brief  checks whether a tile blocks movement
+ * \param  [in, out] strPtr pointer to the chunk streamer
+ * \param  [in] tilePos position of the tile, in tiles, in world space
+ * \return \c NK_TRUE if the tile is solid or its chunk is not ready, \c NK_FALSE if the
+ *         tile can be entered
+ *
+ * \par Remarks
+ *   The collision state is stored as one bit per tile that is computed when the chunk is
+ *   loaded, so this function never looks at the tile data. Tiles outside of the world and
+ *   tiles in chunks that are still loading are treated as solid so that actors cannot
+ *   walk into terrain that does not exist (yet).
+ * \note   This function must be called from the thread that updates the streamer.
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkChunkStreamerIsBlocked(_Inout_ NkChunkStreamer *strPtr, _In_ NkPoint2D tilePos);
+/**
+ * \brief  determines how far an actor can move along an axis before hitting a solid tile
+ * \param  [in, out] strPtr pointer to the chunk streamer
+ * \param  [in] startPos position the movement starts at, in tiles, in world space
+ * \param  [in] stepDir direction of the movement; exactly one of the components must be
+ *              <tt>1</tt> or <tt>-1</tt>, the other one must be <tt>0</tt>
+ * \param  [in] maxSteps maximum number of tiles to move
+ * \return number of tiles that can be entered one after another, starting with the tile
+ *         next to <tt>startPos</tt>; at most <tt>maxSteps</tt>
+ *
+ * \par Remarks
+ *   The start tile itself is not checked. Horizontal sweeps test up to 64 tiles of a row
+ *   at once. Tiles are considered solid under the same rules as in
+ *   <tt>NkChunkStreamerIsBlocked()</tt>.
+ * \note   This function must be called from the thread that updates the streamer.
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkChunkStreamerSweepTiles(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D startPos,
+    _In_    NkPoint2D stepDir,
+    _In_    NkUint32 maxSteps
+);
+/**
+ * \brief copies the collision bits of a rectangular region of the world
+ * \param [in, out] strPtr pointer to the chunk streamer
+ * \param [in] regOrigin upper-left tile of the region, in tiles, in world space
+ * \param [in] regExt extents of the region, in tiles
+ * \param [in] rowWords number of 64-bit words per row of \c bitArr; must be at least
+ *             <tt>(regExt.m_width + 63) / 64</tt>
+ * \param [out] bitArr array of <tt>regExt.m_height * rowWords</tt> words that receives
+ *              the bits, row by row; bit <tt>x % 64</tt> of word <tt>x / 64</tt> of a row
+ *              is set if tile \c x of that row is solid
+ * \note  The snapshot follows the rules of <tt>NkChunkStreamerIsBlocked()</tt>. It lets
+ *        collision queries run on other threads without touching the streamer. This
+ *        function must be called from the thread that updates the streamer.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkChunkStreamerCopySolidBits(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D regOrigin,
+    _In_    NkSize2D regExt,
+    _In_    NkSize rowWords,
+    _Out_   NkUint64 *bitArr
+);
+/**
+ * \brief  calculates the position of the chunk that contains the given tile
+ * \param  [in] strPtr pointer to the chunk streamer
+ * \param  [in] tilePos position of the tile, in tiles, in world space
+ * \return position of the chunk, in chunks
+ */
+NK_NATIVE NK_API NkPoint2D NK_CALL NkChunkStreamerGetChunkPos(
+    _In_ NkChunkStreamer const *strPtr,
+    _In_ NkPoint2D tilePos
+);
+
+
@@ -25,6 +25,15 @@
 #include <include/Noriko/nkom.h>
 
 
+/**
+ * \enum  NkComponentFlags
+ * \brief lists the flags that can be set in <tt>NkComponent::m_compFlags</tt>
+ */
+NK_NATIVE typedef enum NkComponentFlags {
+    NkCompFlag_None       = 0,      /**< no flags */
+    NkCompFlag_MainThread = 1 << 0  /**< the component must be started on the main thread */
+} NkComponentFlags;
+
 /**
  * \struct NkComponent
  * \brief  represents a global Noriko component which has to be started-up and shutdown
@@ -34,7 +43,7 @@ NK_NATIVE typedef struct NkComponent {
     NkUuid              m_compUuid;  /**< UUID of the component */
     NkUuid       const *mp_clsId;    /**< CLSID of the respective NkOM class */
     NkStringView        m_compIdent; /**< textual identifier of the component */
-    NkUint32            m_compFlags; /**< additional component flags; reserved, must be 0 */
+    NkUint32            m_compFlags; /**< additional component flags (NkComponentFlags) */
     NkBoolean           m_isNkOM;    /**< whether or not \c mp_clsId and \c mp_fnQueryInst are valid */
 
     /**
@@ -45,11 +45,43 @@ NK_NATIVE typedef enum NkDatabaseMode {
     NkDbMode_ReadOnly  = 1 << 0, /**< read-only connection */
     NkDbMode_ReadWrite = 1 << 1, /**< connection for reading and writing */
     NkDbMode_Create    = 1 << 2, /**< create the database if it does not exist */
+    NkDbMode_Shared    = 1 << 3, /**< read-only connection that does not lock out other connections and can be used by any thread */
 
-    __NkDbMode_Count__ = 1 << 3  /**< *only used internally* */
+    __NkDbMode_Count__ = 1 << 4  /**< *only used internally* */
 } NkDatabaseMode;
 
 
+/**
+ * \struct NkDatabaseOptions
+ * \brief  represents the performance-related options of a database connection
+ * \note   Use <tt>NkDatabaseQueryDefaultOptions()</tt> to retrieve the options used when
+ *         none are given.
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkDatabaseOptions {
+    NkUint32  m_structSize; /**< size of this struct, in bytes */
+    NkInt64   m_mmapSize;   /**< maximum number of bytes that are memory-mapped; 0 disables memory-mapped I/O */
+    NkUint32  m_cacheSize;  /**< size of the page cache, in KiB; 0 keeps sqlite3's default */
+    NkUint32  m_pageSize;   /**< page size of newly created databases, in bytes; 0 keeps sqlite3's default */
+    NkBoolean m_isMemTemp;  /**< whether temporary tables and indices are kept in memory */
+} NkDatabaseOptions;
+
+
+/**
+ * \brief retrieves the options used for database connections opened in the given mode
+ *        when no options are specified
+ * \param [in] mode database connection mode
+ * \param [out] optsPtr pointer to a structure that receives the options
+ *
+ * \par Remarks
+ *   Read-only connections memory-map up to 256 MiB of the database so that pages are
+ *   read straight from the OS page cache. The page cache of exclusive read-only
+ *   connections is 8 MiB; shared read-only connections are meant to be used in numbers,
+ *   so their page cache is 2 MiB. Read-write connections do not use memory-mapped I/O
+ *   and have a page cache of 16 MiB. All connections keep temporary data in memory.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkDatabaseQueryDefaultOptions(_In_ NkDatabaseMode mode, _Out_ NkDatabaseOptions *optsPtr);
+
+
 /**
  * \brief  is executed once for each result row, allowing to act upon the result
  * \param  [in] colCount number of columns (= number of elements in \c colResArr and
@@ -108,6 +140,63 @@ NKOM_DECLARE_INTERFACE(NkISqlStatement) {
     NkVoid (NK_CALL *Unbind)(_Inout_ NkISqlStatement *self, _In_ NkUint32 index);
 };
 
+/**
+ * \brief  is executed once for each row of a batch, binding the parameters of the row
+ * \param  [in] rowIndex zero-based index of the current row
+ * \param  [in,out] stmtRef statement the parameters are to be bound to
+ * \param  [in,out] extraCxtPtr pointer to a user-provided data structure holding the rows
+ * \return \c NkErr_Ok on success, or non-zero to abort the batch
+ * \note   Bindings are kept between rows; parameters that are the same for all rows only
+ *         need to be bound once.
+ */
+typedef NkErrorCode (NK_CALL *NkDatabaseBatchBindFn)(
+    _In_        NkSize rowIndex,
+    _Inout_     NkISqlStatement *stmtRef,
+    _Inout_opt_ NkVoid *extraCxtPtr
+);
+
+/**
+ * \struct NkDatabaseColumnBinding
+ * \brief  describes where and as what type a result column is stored in a row structure
+ *
+ * Numeric types (\c NkVarTy_Boolean, \c NkVarTy_Char, and all integer and floating-point
+ * types) are converted as in C. \c NkVarTy_Uuid expects a blob of exactly
+ * <tt>sizeof(NkUuid)</tt> bytes; otherwise, the UUID is zeroed. \c NkVarTy_StringView and
+ * \c NkVarTy_BufferView copy the column into an inline array of \c m_dstSize bytes;
+ * strings are truncated to <tt>m_dstSize - 1</tt> bytes and are always NUL-terminated,
+ * buffers are truncated or padded with zeros. \c NULL columns yield zeroed fields.
+ */
+NK_NATIVE typedef struct NkDatabaseColumnBinding {
+    NkVariantType m_colType;   /**< type of the destination field */
+    NkSize        m_dstOffset; /**< offset of the field in the row structure, in bytes */
+    NkSize        m_dstSize;   /**< size of the field, in bytes (only used for strings and buffers) */
+} NkDatabaseColumnBinding;
+
+/**
+ * \struct NkDatabaseRowLayout
+ * \brief  describes the row structure result rows are decoded into
+ */
+NK_NATIVE typedef struct NkDatabaseRowLayout {
+    NkDatabaseColumnBinding const *mp_colArr;   /**< bindings of the first \c m_nCols result columns */
+    NkUint32                       m_nCols;     /**< number of elements in \c mp_colArr */
+    NkSize                         m_rowStride; /**< size of a row structure (including padding), in bytes */
+} NkDatabaseRowLayout;
+
+/**
+ * \brief  is executed once for each chunk of decoded result rows
+ * \param  [in] nRows number of rows in \c rowArr
+ * \param  [in] rowArr array of row structures, laid out as described by the row layout
+ * \param  [in,out] extraCxtPtr pointer to a user-provided data structure
+ * \return \c NkErr_Ok to continue, \c NkErr_ManuallyAborted to stop without an error, or
+ *         another non-zero value to stop with an error
+ * \note   The row array is reused for the next chunk once the function returns.
+ */
+typedef NkErrorCode (NK_CALL *NkDatabaseRowChunkFn)(
+    _In_        NkSize nRows,
+    _In_        NkVoid const *rowArr,
+    _Inout_opt_ NkVoid *extraCxtPtr
+);
+
 /**
  * \interface NkIDatabase 
  */
@@ -126,16 +215,26 @@ NKOM_DECLARE_INTERFACE(NkIDatabase) {
     NkOMRefCount (NK_CALL *Release)(_Inout_ NkIDatabase *self);
 
     /**
+     * \note \c optsPtr may be <tt>NULL</tt>, in which case the default options for
+     *       \c mode are used. The page size only takes effect here.
      */
     NkErrorCode (NK_CALL *Create)(
         _Inout_           NkIDatabase *self,
         _In_opt_z_ _Utf8_ char const *schemaStr,
         _In_z_ _Utf8_     char const *dbPath,
-        _In_              NkDatabaseMode mode
+        _In_              NkDatabaseMode mode,
+        _In_opt_          NkDatabaseOptions const *optsPtr
     );
     /**
+     * \note \c optsPtr may be <tt>NULL</tt>, in which case the default options for
+     *       \c mode are used.
      */
-    NkErrorCode (NK_CALL *Open)(_Inout_ NkIDatabase *self, _In_z_ _Utf8_ char const *dbPath, _In_ NkDatabaseMode mode);
+    NkErrorCode (NK_CALL *Open)(
+        _Inout_       NkIDatabase *self,
+        _In_z_ _Utf8_ char const *dbPath,
+        _In_          NkDatabaseMode mode,
+        _In_opt_      NkDatabaseOptions const *optsPtr
+    );
     /**
      */
     NkErrorCode (NK_CALL *Close)(_Inout_ NkIDatabase *self);
@@ -162,6 +261,75 @@ NKOM_DECLARE_INTERFACE(NkIDatabase) {
         _In_opt_      NkDatabaseQueryIterFn fnResIter,
         _Inout_opt_   NkVoid *extraCxtPtr
     );
+
+    /**
+     * \brief  starts a transaction
+     * \param  [in,out] self database connection
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   Transactions can be nested. Only the outermost transaction writes to the
+     *         database when it is committed; nested transactions are savepoints that can
+     *         be rolled back on their own.
+     */
+    NkErrorCode (NK_CALL *BeginTransaction)(_Inout_ NkIDatabase *self);
+    /**
+     * \brief  commits the innermost transaction
+     * \param  [in,out] self database connection
+     * \return \c NkErr_Ok on success, \c NkErr_ObjectState if there is no transaction,
+     *         or another non-zero value on failure
+     */
+    NkErrorCode (NK_CALL *Commit)(_Inout_ NkIDatabase *self);
+    /**
+     * \brief  discards all changes made by the innermost transaction
+     * \param  [in,out] self database connection
+     * \return \c NkErr_Ok on success, \c NkErr_ObjectState if there is no transaction,
+     *         or another non-zero value on failure
+     */
+    NkErrorCode (NK_CALL *Rollback)(_Inout_ NkIDatabase *self);
+    /**
+     * \brief  executes a statement once for each row of a batch inside a single
+     *         transaction
+     * \param  [in,out] self database connection
+     * \param  [in,out] stmtRef statement to execute
+     * \param  [in] nRows number of rows
+     * \param  [in] fnBind callback binding the parameters of each row
+     * \param  [in,out] extraCxtPtr (optional) context passed to \c fnBind
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   If a row fails, all rows of the batch are rolled back. Result rows produced
+     *         by the statement are discarded.
+     */
+    NkErrorCode (NK_CALL *ExecuteBatch)(
+        _Inout_     NkIDatabase *self,
+        _Inout_     NkISqlStatement *stmtRef,
+        _In_        NkSize nRows,
+        _In_        NkDatabaseBatchBindFn fnBind,
+        _Inout_opt_ NkVoid *extraCxtPtr
+    );
+    /**
+     * \brief  executes a statement, decoding the result rows straight into an array of
+     *         row structures
+     * \param  [in,out] self database connection
+     * \param  [in,out] stmtRef statement to execute
+     * \param  [in] layoutPtr layout of the row structure
+     * \param  [out] rowBuf buffer holding \c nBufRows row structures
+     * \param  [in] nBufRows number of rows decoded before \c fnChunk is invoked
+     * \param  [in] fnChunk callback receiving the decoded rows
+     * \param  [in,out] extraCxtPtr (optional) context passed to \c fnChunk
+     * \return \c NkErr_Ok on success, \c NkErr_InParameter if the layout is invalid or
+     *         refers to more columns than the statement returns, or another non-zero
+     *         value on failure
+     * \note   Unlike <tt>Execute()</tt>, no \c NkVariant is built and the column types
+     *         are not queried; the columns are converted to the types given by the
+     *         layout. Columns beyond those in the layout are ignored.
+     */
+    NkErrorCode (NK_CALL *ExecuteTyped)(
+        _Inout_     NkIDatabase *self,
+        _Inout_     NkISqlStatement *stmtRef,
+        _In_        NkDatabaseRowLayout const *layoutPtr,
+        _Out_       NkVoid *rowBuf,
+        _In_        NkSize nBufRows,
+        _In_        NkDatabaseRowChunkFn fnChunk,
+        _Inout_opt_ NkVoid *extraCxtPtr
+    );
 };
 
 
@@ -72,11 +72,13 @@
     #define _Init_ptr_maybe_  _Outptr_result_maybenull_
     #define _Init_ptr_mbnull_ _Outptr_opt_result_maybenull_
     #define _I_array_(s)      _In_reads_(s)
+    #define _I_array_opt_(s)  _In_reads_opt_(s)
     #define _O_array_(s)      _Out_writes_(s)
     #define _O_array_opt_(s)  _Out_writes_opt_(s)
     #define _I_bytes_(s)      _In_reads_bytes_(s)
     #define _O_bytes_(s)      _Out_writes_bytes_(s)
     #define _O_bytes_opt_(s)  _Out_writes_bytes_opt_(s)
+    #define _IO_bytes_(s)     _Inout_updates_bytes_(s)
     #define _Format_str_      _Printf_format_string_
     #define _Maybe_reinit_    _Init_ptr_ _Deref_pre_opt_valid_
     #define _In_to_null_      _In_reads_to_ptr_opt_(NULL)
@@ -114,11 +116,13 @@
     #define _Out_writes_(s)
     #define _Init_ptr_mbnull_
     #define _I_array_(s)
+    #define _I_array_opt_(s)
     #define _O_array_(s)
     #define _O_array_opt_(s)
     #define _I_bytes_(s)
     #define _O_bytes_(s)
     #define _O_bytes_opt_(s) 
+    #define _IO_bytes_(s)
     #define _Format_str_
     #define _Maybe_reinit_
     #define _In_to_null_
@@ -0,0 +1,198 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  array.h
+ * \brief global definitions for Noriko's value-typed dynamic array data-structure
+ *
+ * Unlike \c NkVector, which stores pointers to elements that live elsewhere, an
+ * \c NkArray stores the elements themselves, contiguously, in its internal buffer. The
+ * size of an element is fixed when the array is created. Elements are copied when they
+ * are inserted and are treated as plain data; that is, the array never invokes any
+ * destructor on them.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/util.h>
+#include <include/Noriko/error.h>
+
+#include <include/Noriko/dstruct/vector.h>
+
+
+/**
+ * \def   NK_ARRAY_AT(a, t, i)
+ * \brief retrieves a typed pointer to the element at the given index
+ * \param a pointer to the NkArray instance
+ * \param t type of the elements stored in \c a
+ * \param i index of the element
+ */
+#define NK_ARRAY_AT(a, t, i) ((t *)NkArrayAt((a), (i)))
+
+
+/**
+ * \struct NkArray
+ * \brief  forward-declaration of opaque array type
+ */
+NK_NATIVE typedef struct NkArray NkArray;
+
+
+/**
+ * \brief   creates and initializes a new array data-structure
+ * \param   [in] vecPropsPtr pointer to a NkVectorProperties structure holding config
+ *               data; capacities are given in elements
+ * \param   [in] elemSize size of a single element, in bytes
+ * \param   [out] arrPtr pointer to a variable that will receive the pointer to the
+ *                newly-created data-structure
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \see     NkArrayDestroy
+ * \note    Use \c NkVectorDefaultProperties() to obtain a set of default properties.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArrayCreate(
+    _In_       NkVectorProperties const *vecPropsPtr,
+    _In_       NkSize elemSize,
+    _Init_ptr_ NkArray **arrPtr
+);
+/**
+ * \brief deallocates all memory used by the data-structure
+ * \param [in,out] arrPtr pointer to a variable that stores the pointer of the array
+ * \note  <tt>*arrPtr</tt> will be set to <tt>NULL</tt>. If <tt>*arrPtr</tt> is already
+ *        <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkArrayDestroy(_Uninit_ptr_ NkArray **arrPtr);
+/**
+ * \brief  removes all elements and resets the array's capacity to the specified minimum
+ * \param  [in,out] arrPtr pointer to the NkArray instance that is to be cleared
+ * \return \c NkErr_Ok on success, non-zero if there was an error
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArrayClear(_Inout_ NkArray *arrPtr);
+/**
+ * \brief  makes sure that the array can hold at least the given number of elements
+ *         without reallocating its buffer
+ * \param  [in,out] arrPtr pointer to the NkArray instance
+ * \param  [in] minCap minimum capacity, in elements
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   If \c minCap exceeds the maximum capacity, the function fails with
+ *         \c NkErr_CapLimitExceeded and the array is unchanged.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArrayReserve(_Inout_ NkArray *arrPtr, _In_ NkSize minCap);
+/**
+ * \brief   makes room for \c nElems elements at \c index without initializing them
+ * \param   [in,out] arrPtr pointer to the NkArray instance
+ * \param   [in] index index where the first new element is to be located
+ * \param   [in] nElems number of elements to make room for
+ * \param   [out] elemPtr pointer to a variable that receives the pointer to the first
+ *                new element
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    The pointer written to \c elemPtr is valid until the array is modified the
+ *          next time. This allows elements to be constructed in-place.
+ * \warning If \c index is out of bounds, the behavior is undefined.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArrayEmplace(
+    _Inout_    NkArray *arrPtr,
+    _In_opt_   NkSize index,
+    _In_       NkSize nElems,
+    _Init_ptr_ NkVoid **elemPtr
+);
+/**
+ * \brief   copies \c nElems elements into the array at \c index
+ * \param   [in,out] arrPtr pointer to the NkArray instance
+ * \param   [in] index index where the first element is to be inserted
+ * \param   [in] elemArray contiguous array of elements of the array's element size
+ * \param   [in] nElems number of elements in \c elemArray
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    If the array cannot be grown to fit all elements, no elements are copied and
+ *          the array is unchanged.
+ * \warning \li If \c index is out of bounds, the behavior is undefined.
+ * \warning \li \c elemArray must not point into the array itself.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArrayInsert(
+    _Inout_           NkArray *arrPtr,
+    _In_opt_          NkSize index,
+    _I_array_(nElems) NkVoid const *elemArray,
+    _In_              NkSize nElems
+);
+/**
+ * \brief  copies \c nElems elements to the end of the array
+ * \param  [in,out] arrPtr pointer to the NkArray instance
+ * \param  [in] elemArray contiguous array of elements of the array's element size
+ * \param  [in] nElems number of elements in \c elemArray
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \see    NkArrayInsert
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkArrayAppend(
+    _Inout_           NkArray *arrPtr,
+    _I_array_(nElems) NkVoid const *elemArray,
+    _In_              NkSize nElems
+);
+/**
+ * \brief   erases up to \c maxN elements, starting at \c sInd
+ * \param   [in,out] arrPtr pointer to the NkArray instance
+ * \param   [in] sInd index of the first element that is to be erased
+ * \param   [in] maxN maximum number of elements to erase
+ * \warning If \c sInd is out of bounds, the behavior is undefined.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkArrayErase(_Inout_ NkArray *arrPtr, _In_opt_ NkSize sInd, _In_opt_ NkSize maxN);
+/**
+ * \brief   sorts the elements in <tt>[sInd, eInd]</tt> in-place
+ * \param   [in,out] arrPtr pointer to the NkArray instance that is to be sorted
+ * \param   [in] sInd first index of the sorting interval
+ * \param   [in] eInd last index of the sorting interval
+ * \param   [in] fnPred comparison predicate; receives pointers to two elements
+ * \see     NkVectorSort
+ * \note    For an example of a compliant predicate, see <tt>NkVectorSort()</tt>. The
+ *          pointers passed to \c fnPred are never \c NULL.
+ * \warning If <tt>[sInd, eInd]</tt> is out of bounds, the behavior is undefined.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkArraySort(
+    _Inout_  NkArray *arrPtr,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32 (NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+);
+/**
+ * \brief   retrieves a pointer to the element at index \c index
+ * \param   [in] arrPtr pointer to the NkArray instance
+ * \param   [in] index index of the requested element
+ * \return  pointer to the element
+ * \warning If \c index is out of bounds, the behavior is undefined.
+ */
+NK_NATIVE NK_API NK_INLINE NkVoid *NK_CALL NkArrayAt(_In_ NkArray const *arrPtr, _In_ NkSize index);
+/**
+ * \brief  retrieves the pointer to the array's internal buffer
+ * \param  [in] arrPtr pointer to the NkArray instance
+ * \return pointer to the first element
+ * \note   The pointer is invalidated by any operation that changes the capacity.
+ */
+NK_NATIVE NK_API NK_INLINE NkVoid *NK_CALL NkArrayGetBuffer(_In_ NkArray const *arrPtr);
+/**
+ * \brief  retrieves the current number of elements stored in the array
+ * \param  [in] arrPtr pointer to the NkArray instance
+ * \return current number of elements
+ */
+NK_NATIVE NK_API NK_INLINE NkSize NK_CALL NkArrayGetElementCount(_In_ NkArray const *arrPtr);
+/**
+ * \brief  retrieves the current capacity of the array, in elements
+ * \param  [in] arrPtr pointer to the NkArray instance
+ * \return current capacity
+ */
+NK_NATIVE NK_API NK_INLINE NkSize NK_CALL NkArrayGetCapacity(_In_ NkArray const *arrPtr);
+/**
+ * \brief  retrieves the size of a single element
+ * \param  [in] arrPtr pointer to the NkArray instance
+ * \return element size, in bytes
+ */
+NK_NATIVE NK_API NK_INLINE NkSize NK_CALL NkArrayGetElementSize(_In_ NkArray const *arrPtr);
+
+
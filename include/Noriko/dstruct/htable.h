@@ -52,16 +52,33 @@ NK_NATIVE typedef _In_range_(0, __NkHtKeyTy_Count__ - 1) enum NkHashtableKeyType
     NkHtKeyTy_StringView, /**< type ID for string view key */
     NkHtKeyTy_Pointer,    /**< type ID for generic pointer key */
     NkHtKeyTy_Uuid,       /**< type ID for UUID key */
+    NkHtKeyTy_StringId,   /**< type ID for interned string ID key (see <tt>intern.h</tt>) */
 
     __NkHtKeyTy_Count__   /**< *only used internally* */
 } NkHashtableKeyType;
 
+/**
+ * \enum  NkHashtableHashPolicy
+ * \brief selects the hash functions a hash table uses for its keys
+ */
+NK_NATIVE typedef _In_range_(0, __NkHtHashPol_Count__ - 1) enum NkHashtableHashPolicy {
+    NkHtHashPol_Default, /**< fast mixer for fixed-width keys, SipHash for string keys */
+    NkHtHashPol_Fast,    /**< fast non-cryptographic hash for all key types */
+    NkHtHashPol_SipHash, /**< SipHash for all key types */
+
+    __NkHtHashPol_Count__ /**< *only used internally* */
+} NkHashtableHashPolicy;
+
 /**
  * \struct NkHashtable
  * \brief  represents the type for a generic hash table implementation
  * 
- * This implementation works with pointers by default and implements Robin-Hood-Hashing.
- * Keys can be of a variety of primitive types.
+ * This implementation works with pointers by default and uses open addressing with
+ * groups of 16 slots, each described by a control byte that holds a 7-bit tag of the
+ * slot's hash. A lookup compares the tags of an entire group at once (using SSE2 where
+ * available) and only compares keys on tag matches. Keys can be of a variety of
+ * primitive types. The key-value pairs are kept in a separate, dense array, so that
+ * iterating over the table only touches the elements that are stored.
  * The hash table does not by default take ownership of the contained elements. To enable
  * this feature, the user must provide a suitable \c free() function.
  */
@@ -82,6 +99,7 @@ NK_NATIVE typedef union NkHashtableKey {
     NkStringView *mp_svKey;    /**< string view key */
     NkVoid       *mp_ptrKey;   /**< pointer value key */
     NkUuid       *mp_uuidKey;  /**< UUID key type */
+    NkUint32      m_strIdKey;  /**< interned string ID key */
 } NkHashtableKey;
 
 /**
@@ -103,14 +121,29 @@ NK_NATIVE typedef struct NkHashtablePair {
  *         and leave the key unchanged (e.g., when the keys are primitive types and thus
  *         do not require cleanup), but the values are complex (i.e., struct types with
  *         fields that do require manual cleanup).
+ * \note   SipHash is keyed with a random seed and thus resistant to hash flooding, but
+ *         comparatively slow. Use \c NkHtHashPol_Fast for string keys only if the keys
+ *         do not come from untrusted sources.
+ * \note   If \c m_isConcurrent is non-zero, all functions of the hash table API may be
+ *         called from multiple threads at once. Readers (i.e., \c NkHashtableAt(),
+ *         \c NkHashtableContains(), \c NkHashtableForEach(),
+ *         \c NkHashtableParallelForEach(), and \c NkHashtableCount()) never lock and
+ *         never wait for writers; they operate on an immutable snapshot of the table.
+ *         Writers are serialized; each one copies the current snapshot, modifies the
+ *         copy, publishes it, and then waits until no reader uses the old snapshot
+ *         anymore. Hence, writes take time linear in the capacity, so this mode is meant
+ *         for read-mostly tables. The element destructor is only invoked once no reader
+ *         can observe the element anymore.
  */
 NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkHashtableProperties {
-    NkUint32           m_structSize;  /**< size of this struct, in bytes */
-    NkUint32           m_initCap;     /**< initial capacity of hash table, in elements */
-    NkUint32           m_minCap;      /**< minimum capacity of hash table, in elements */
-    NkUint32           m_maxCap;      /**< maximum capacity of hash table, in elements */
-    NkHashtableKeyType m_keyType;     /**< type ID of key */
-    NkHashtableFreeFn  mp_fnElemFree; /**< element free function callback (may be NULL) */
+    NkUint32              m_structSize;  /**< size of this struct, in bytes */
+    NkUint32              m_initCap;     /**< initial capacity of hash table, in elements */
+    NkUint32              m_minCap;      /**< minimum capacity of hash table, in elements */
+    NkUint32              m_maxCap;      /**< maximum capacity of hash table, in elements */
+    NkHashtableKeyType    m_keyType;     /**< type ID of key */
+    NkHashtableFreeFn     mp_fnElemFree; /**< element free function callback (may be NULL) */
+    NkHashtableHashPolicy m_hashPolicy;  /**< hash functions to use; zero selects \c NkHtHashPol_Default */
+    NkBoolean             m_isConcurrent; /**< whether the table may be accessed by multiple threads at once */
 } NkHashtableProperties;
 
 
@@ -226,18 +259,44 @@ NK_NATIVE NK_API NkBoolean NK_CALL NkHashtableContains(
     _In_ NkHashtableKey const *keyPtr
 );
 /**
- * \brief  iterates over the hash table in linear (i.e., array) order
+ * \brief  iterates over the hash table in insertion order
  * \param  [in] htPtr pointer to the hash table instance that is to be iterated over
- * \param  [in] fnIter iteration callback invoked once for each occupied slot
+ * \param  [in] fnIter iteration callback invoked once for each element
  * \return \c NkErr_Ok on success, non-zero if an error occurred or the user terminated
  *         the run by returning non-zero from \c fnIter
- * \note   If \c fnIter returns non-zero, the iteration is cancelled and the returned
+ * \note   \li If \c fnIter returns non-zero, the iteration is cancelled and the returned
  *         value is propagated to the caller.
+ * \note   \li The elements are stored densely, so the time this takes only depends on
+ *         the number of elements, not on the capacity.
+ * \note   \li Erasing an element moves the most recently inserted element into its
+ *         place; the order is thus only the insertion order if no element was erased.
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkHashtableForEach(
     _In_ NkHashtable const *htPtr,
     _In_ NkHashtableIterFn fnIter
 );
+/**
+ * \brief  iterates over the hash table using the job system
+ * \param  [in] htPtr pointer to the hash table instance that is to be iterated over
+ * \param  [in] fnIter iteration callback invoked once for each element
+ * \return \c NkErr_Ok on success, \c NkErr_NoOperation if the table is empty, or the
+ *         first non-zero value returned by \c fnIter in iteration order
+ *
+ * \par Remarks
+ *   The elements are split into contiguous chunks, one per worker thread and one for the
+ *   calling thread. Small tables are not split. The calling thread runs the first chunk
+ *   and waits for the others to finish, running other jobs in the meantime. Hence,
+ *   \c fnIter is invoked concurrently and in no particular order; it must be safe to run
+ *   it on different elements at the same time. If \c fnIter returns non-zero, all chunks
+ *   stop as soon as possible, but the callback may be invoked for further elements in
+ *   the meantime. The hash table must not be modified until this function returns,
+ *   unless it is concurrent (see <tt>NkHashtableProperties</tt>); a concurrent hash
+ *   table is iterated over as it was when the function was called.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkHashtableParallelForEach(
+    _In_ NkHashtable const *htPtr,
+    _In_ NkHashtableIterFn fnIter
+);
 /**
  * \brief  retrieves the current number of elements in the hash table
  * \param  [in] htPtr pointer to the hash table instance of which the element count is to
@@ -36,6 +36,9 @@
 
 #pragma once
 
+/* stdlib includes */
+#include <stdarg.h>
+
 /* Noriko includes */
 #include <include/Noriko/def.h>
 #include <include/Noriko/error.h>
@@ -43,8 +46,33 @@
 
 
 /**
+ * \struct NkString
+ * \brief  represents a mutable UTF-8 string
+ * \note   Short strings are stored inside the string object itself and do not allocate.
+ */
+NK_DEFINE_PROTOTYPE(NkString, NK_ALIGNOF(NkInt64), 48);
+/**
+ * \struct NkStringRope
+ * \brief  represents an append-only UTF-8 string that is stored in a list of chunks
+ * \note   Appending to a rope never moves characters that have already been written, so
+ *         ropes are suited for building very large strings, such as trace dumps or
+ *         generated SQL scripts, piece by piece. The contents of a rope are not
+ *         contiguous; use <tt>NkStringRopeForEachChunk()</tt> to stream them or
+ *         <tt>NkStringRopeFlatten()</tt> to copy them into an \c NkString.
+ */
+NK_DEFINE_PROTOTYPE(NkStringRope, NK_ALIGNOF(NkInt64), 32);
+
+/**
+ * \typedef NkStringRopeChunkFn
+ * \brief   callback invoked for every chunk of a rope by <tt>NkStringRopeForEachChunk()</tt>
+ * \param   [in] chunkView view of the characters stored in the chunk
+ * \param   [in, out] extraCxt (optional) user-provided context
+ * \return  \c NkErr_Ok to continue with the next chunk, non-zero to stop
  */
-NK_DEFINE_PROTOTYPE(NkString, NK_ALIGNOF(NkInt64), 16);
+NK_NATIVE typedef NkErrorCode (NK_CALL *NkStringRopeChunkFn)(
+    _In_        NkStringView const *chunkView,
+    _Inout_opt_ NkVoid *extraCxt
+);
 
 
 /**
@@ -76,6 +104,44 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringJoin(
     _In_z_ _Utf8_ char const *elemStr,
     _In_opt_      NkUint32 strLen
 );
+/**
+ * \brief  ensures that the string can hold at least the given number of bytes
+ * \param  [in, out] strPtr pointer to the string
+ * \param  [in] capBytes number of bytes (excl. <tt>NUL</tt>) the string must be able to
+ *              hold without reallocating
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The contents of the string are not changed. If the buffer is already large
+ *         enough, the function does nothing.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringReserve(_Inout_ NkString *strPtr, _In_ NkUint32 capBytes);
+/**
+ * \brief  appends formatted text to the string
+ * \param  [in, out] strPtr pointer to the string
+ * \param  [in] fmtStr <tt>printf()</tt>-style format string
+ * \param  [in] ... arguments for the format string
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The text is formatted directly into the free space at the end of the string;
+ *         the buffer is only grown, and the text formatted a second time, if it does not
+ *         fit. On failure, the string is left unchanged.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringAppendFormat(
+    _Inout_             NkString *strPtr,
+    _In_z_ _Format_str_   char const *fmtStr,
+    ...
+);
+/**
+ * \brief  appends formatted text to the string
+ * \param  [in, out] strPtr pointer to the string
+ * \param  [in] fmtStr <tt>printf()</tt>-style format string
+ * \param  [in] vArgs arguments for the format string
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \see    NkStringAppendFormat
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringAppendFormatV(
+    _Inout_             NkString *strPtr,
+    _In_z_ _Format_str_ char const *fmtStr,
+    _In_                va_list vArgs
+);
 
 /**
  */
@@ -89,3 +155,82 @@ NK_NATIVE NK_API char const *NK_CALL NkStringAt(_In_ NkString const *strPtr, _In
 NK_NATIVE NK_API char const *NK_CALL NkStringIterate(_In_z_ _Utf8_ char const *strPtr);
 
 
+/**
+ * \brief  creates a new, empty rope
+ * \param  [in] chunkSize number of bytes stored in each chunk; \c 0 uses the default of
+ *              64 KiB
+ * \param  [out] resPtr pointer to the rope that is to be initialized
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   No memory is allocated until the first append.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringRopeCreate(
+    _In_opt_ NkUint32 chunkSize,
+    _Out_    NkStringRope *resPtr
+);
+/**
+ * \brief destroys the given rope, freeing all of its chunks
+ * \param [in, out] ropePtr pointer to the rope
+ * \note  If \c ropePtr is <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkStringRopeDestroy(_Inout_opt_ NkStringRope *ropePtr);
+/**
+ * \brief  appends a string to the rope
+ * \param  [in, out] ropePtr pointer to the rope
+ * \param  [in] elemStr pointer to the characters that are to be appended
+ * \param  [in] strLen number of bytes to append; <tt>(NkUint32)(-1)</tt> to append up to
+ *              the <tt>NUL</tt>-terminator of \c elemStr
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringRopeAppend(
+    _Inout_       NkStringRope *ropePtr,
+    _In_z_ _Utf8_ char const *elemStr,
+    _In_opt_      NkUint32 strLen
+);
+/**
+ * \brief  appends formatted text to the rope
+ * \param  [in, out] ropePtr pointer to the rope
+ * \param  [in] fmtStr <tt>printf()</tt>-style format string
+ * \param  [in] ... arguments for the format string
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The text is formatted directly into the last chunk. If it does not fit, it is
+ *         formatted into a new chunk instead; the text of a single call is never split
+ *         across chunks.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringRopeAppendFormat(
+    _Inout_             NkStringRope *ropePtr,
+    _In_z_ _Format_str_ char const *fmtStr,
+    ...
+);
+/**
+ * \brief  retrieves the length of the rope
+ * \param  [in] ropePtr pointer to the rope
+ * \return total number of bytes stored in the rope (excl. <tt>NUL</tt>)
+ */
+NK_NATIVE NK_API NkUint64 NK_CALL NkStringRopeGetLength(_In_ NkStringRope const *ropePtr);
+/**
+ * \brief  invokes a callback for every chunk of the rope, in order
+ * \param  [in] ropePtr pointer to the rope
+ * \param  [in] chunkFn callback that is to be invoked
+ * \param  [in, out] extraCxt (optional) context passed to \c chunkFn
+ * \return \c NkErr_Ok if all chunks were visited, otherwise the error code returned by
+ *         \c chunkFn
+ * \note   Use this to write a rope to a file or stream without copying it first.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringRopeForEachChunk(
+    _In_        NkStringRope const *ropePtr,
+    _In_        NkStringRopeChunkFn chunkFn,
+    _Inout_opt_ NkVoid *extraCxt
+);
+/**
+ * \brief  appends the contents of the rope to a string
+ * \param  [in] ropePtr pointer to the rope
+ * \param  [in, out] strPtr pointer to an initialized string
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The string is grown once to the final size before the chunks are copied.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringRopeFlatten(
+    _In_    NkStringRope const *ropePtr,
+    _Inout_ NkString *strPtr
+);
+
+
@@ -44,12 +44,14 @@ NK_NATIVE typedef struct NkVector NkVector;
 /**
  * \struct NkVectorProperties
  * \brief  holds configuration properties for the vector container type
- * \note   A fixed-size array can be simulated by setting, for example,
+ * \note   \li A fixed-size array can be simulated by setting, for example,
  *         <tt>m_initialCap = m_minCap = m_maxCap</tt>.
+ * \note   \li Vectors with a capacity of up to 8 elements store their elements inside the
+ *         vector object and do not allocate a separate buffer.
  */
 NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkVectorProperties {
     NkSize  m_structSize; /**< [\c x > 0] size of this structure, in bytes */
-    NkSize  m_initialCap; /**< [\c m_minCap <= \c x <= <tt>m_maxCap</tt>] initial capacity of vector [def: <tt>16</tt>] */
+    NkSize  m_initialCap; /**< [\c m_minCap <= \c x <= <tt>m_maxCap</tt>] initial capacity of vector [def: <tt>8</tt>] */
     NkSize  m_minCap;     /**< [\c < \c x <= <tt>m_maxCap</tt>] minimum capacity, in elements (cannot shrink below) [def: <tt>8</tt>] */
     NkSize  m_maxCap;     /**< [\c m_minCap <= \c x < <tt>SIZE_MAX</tt>] maximum capacity, in elements (cannot grow beyond) [def: <tt>SIZE_MAX - 1</tt>] */
     NkFloat m_growFactor; /**< [\c x > <tt>1.0</tt>] resize factor when growing array [def: <tt>1.5</tt>] */
@@ -313,6 +315,8 @@ NK_NATIVE NK_API NkVoid NK_CALL NkVectorReverse(_Inout_ NkVector *vecPtr, _In_op
  * \param   [in] fnPred pointer to the predicate function
  * \note    **0.0.1-1**: The current implementation of this function uses the
  *          \c QuickSort sorting algorithm.
+ * \note    **0.0.1-2**: The function now uses <tt>NkIntrosortPointers()</tt>, which
+ *          handles sorted and nearly-sorted intervals in linear time.
  * 
  * \warning If <tt>[sInd, eInd]</tt> is out of bounds, the behavior is undefined.
  * \warning If \c fnPred is not a valid predicate (not a function/not a function with the
@@ -445,6 +449,36 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkVectorForEach(
     _In_        NkErrorCode (NK_CALL *fnCallback)(NkVoid *, NkVoid *, NkSize),
     _Inout_opt_ NkVoid *extraParam
 );
+/**
+ * \brief   iterates through a range of the array using the job system, invoking the
+ *          given callback on each item individually
+ * \param   [in] vecPtr pointer to the NkVector instance that is to be traversed
+ * \param   [in] sInd starting index of the iteration procedure
+ * \param   [in] maxN maximum number of elements to iterate over
+ * \param   [in] fnCallback() pointer to the function that is to be called on each
+ *               element; see <tt>NkVectorForEach()</tt>
+ * \param   [in,out] extraParam extra parameter to be passed to \c fnCallback()
+ * \return  \c NkErr_Ok, or the first non-zero value returned by \c fnCallback() in
+ *          iteration order
+ * \warning If \c sInd is out of bounds, the behavior is undefined.
+ *
+ * \par Remarks
+ *   The range is split into contiguous chunks, one per worker thread and one for the
+ *   calling thread. Small ranges are not split. The calling thread runs the first chunk
+ *   and waits for the others to finish, running other jobs in the meantime. Hence,
+ *   \c fnCallback() is invoked concurrently and in no particular order, with the same
+ *   \c extraParam for every element; it must be safe to run it on different elements at
+ *   the same time. If \c fnCallback() returns non-zero, all chunks stop as soon as
+ *   possible, but the callback may be invoked for further elements in the meantime. The
+ *   vector must not be modified until this function returns.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkVectorParallelForEach(
+    _In_        NkVector const *vecPtr,
+    _In_opt_    NkSize sInd,
+    _In_opt_    NkSize maxN,
+    _In_        NkErrorCode (NK_CALL *fnCallback)(NkVoid *, NkVoid *, NkSize),
+    _Inout_opt_ NkVoid *extraParam
+);
 /**
  * \brief   retrieves the pointer to a part of the vector's internal buffer
  * \param   [in] vecPtr pointer to an NkVector data-structure of which a pointer to the
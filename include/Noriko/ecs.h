@@ -0,0 +1,229 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  ecs.h
+ * \brief defines the public API for the entity-component storage
+ *
+ * Not to be confused with the engine components of <tt>comp.h</tt>, the entity-component
+ * storage holds the state of game objects (actors, props, etc.). An entity is nothing
+ * but an identifier; its state is made up of the components that are attached to it.
+ * Every component type is stored in a pool of its own as a sparse set: the components
+ * are kept densely packed, and every field of the component type is stored in an array
+ * of its own (structure-of-arrays). Systems are then plain loops over these arrays,
+ * which the compiler can vectorize, instead of virtual calls per object.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+
+
+/**
+ * \def   NK_ECS_MAXTYPES
+ * \brief maximum number of component types that can be registered with a registry
+ */
+#define NK_ECS_MAXTYPES   ((NkUint32)(32))
+/**
+ * \def   NK_ECS_MAXFIELDS
+ * \brief maximum number of fields a component type can consist of
+ */
+#define NK_ECS_MAXFIELDS  ((NkUint32)(16))
+/**
+ * \def   NK_ECS_NULLENTITY
+ * \brief entity identifier that never identifies an entity
+ */
+#define NK_ECS_NULLENTITY ((NkEcsEntity)(0))
+/**
+ * \def   NK_ECS_NOINDEX
+ * \brief index returned if an entity does not have the requested component
+ */
+#define NK_ECS_NOINDEX    ((NkUint32)(UINT32_MAX))
+
+
+/**
+ * \struct NkEcsRegistry
+ * \brief  forward-declaration of opaque entity registry type
+ */
+NK_NATIVE typedef struct NkEcsRegistry NkEcsRegistry;
+
+/**
+ * \typedef NkEcsEntity
+ * \brief   identifies an entity
+ *
+ * The lower 32 bits are the index of the entity's slot, the upper 32 bits are the
+ * generation of the slot. Destroying an entity increments the generation of its slot,
+ * so stale identifiers held somewhere else are detected instead of silently referring
+ * to the entity that reused the slot.
+ */
+NK_NATIVE typedef NkUint64 NkEcsEntity;
+/**
+ * \typedef NkEcsComponentType
+ * \brief   identifies a component type within a registry
+ */
+NK_NATIVE typedef NkUint32 NkEcsComponentType;
+
+/**
+ * \struct NkEcsRegistrySpecification
+ * \brief  holds configuration properties for the entity registry
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkEcsRegistrySpecification {
+    NkSize   m_structSize; /**< size of this structure, in bytes */
+    NkUint32 m_initCap;    /**< number of entities to reserve memory for */
+} NkEcsRegistrySpecification;
+
+/**
+ * \struct NkEcsComponentSpecification
+ * \brief  describes the layout of a component type
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkEcsComponentSpecification {
+    NkSize   m_structSize;                   /**< size of this structure, in bytes */
+    NkUint32 m_nFields;                      /**< number of fields */
+    NkUint32 m_fieldSizes[NK_ECS_MAXFIELDS]; /**< size of every field, in bytes */
+} NkEcsComponentSpecification;
+
+
+/**
+ * \brief   creates a new, empty entity registry
+ * \param   [in] regSpec pointer to the specification of the registry
+ * \param   [out] regPtr pointer to a variable that will receive the pointer to the
+ *                newly-created registry
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkEcsCreate(
+    _In_       NkEcsRegistrySpecification const *regSpec,
+    _Init_ptr_ NkEcsRegistry **regPtr
+);
+/**
+ * \brief destroys the given entity registry, including all entities and components
+ * \param [in, out] regPtr pointer to a variable holding the pointer to the registry that
+ *                  is to be destroyed
+ * \note  <tt>*regPtr</tt> will be set to <tt>NULL</tt>. If <tt>*regPtr</tt> is already
+ *        <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkEcsDestroy(_Uninit_ptr_ NkEcsRegistry **regPtr);
+/**
+ * \brief  registers a new component type
+ * \param  [in, out] regPtr pointer to the entity registry
+ * \param  [in] compSpec pointer to the layout of the component type
+ * \param  [out] typePtr pointer to a variable that receives the identifier of the type
+ * \return \c NkErr_Ok on success, \c NkErr_CapLimitExceeded if \c NK_ECS_MAXTYPES types
+ *         have already been registered, or another non-zero value on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkEcsRegisterComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentSpecification const *compSpec,
+    _Out_   NkEcsComponentType *typePtr
+);
+/**
+ * \brief  creates a new entity without any components
+ * \param  [in, out] regPtr pointer to the entity registry
+ * \param  [out] entPtr pointer to a variable that receives the identifier of the entity
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkEcsCreateEntity(_Inout_ NkEcsRegistry *regPtr, _Out_ NkEcsEntity *entPtr);
+/**
+ * \brief destroys an entity and all of its components
+ * \param [in, out] regPtr pointer to the entity registry
+ * \param [in] entId identifier of the entity
+ * \note  If \c entId does not identify a live entity, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkEcsDestroyEntity(_Inout_ NkEcsRegistry *regPtr, _In_ NkEcsEntity entId);
+/**
+ * \brief  checks whether the given identifier refers to a live entity
+ * \param  [in] regPtr pointer to the entity registry
+ * \param  [in] entId identifier of the entity
+ * \return \c NK_TRUE if the entity is alive, \c NK_FALSE if it was destroyed or never
+ *         existed
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkEcsIsAlive(_In_ NkEcsRegistry const *regPtr, _In_ NkEcsEntity entId);
+/**
+ * \brief   attaches a component to an entity
+ * \param   [in, out] regPtr pointer to the entity registry
+ * \param   [in] entId identifier of the entity
+ * \param   [in] compType type of the component
+ * \param   [out] indPtr (optional) pointer to a variable that receives the index of the
+ *                component in the field arrays of the pool
+ * \return  \c NkErr_Ok on success, \c NkErr_NoOperation if the entity already has a
+ *          component of that type, or another non-zero value on failure
+ * \warning The behavior is undefined if \c entId does not identify a live entity.
+ * \note    All fields of the new component are zeroed. Adding a component may move the
+ *          field arrays of the pool, invalidating pointers obtained from
+ *          <tt>NkEcsQueryField()</tt>.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkEcsAddComponent(
+    _Inout_   NkEcsRegistry *regPtr,
+    _In_      NkEcsEntity entId,
+    _In_      NkEcsComponentType compType,
+    _Out_opt_ NkUint32 *indPtr
+);
+/**
+ * \brief detaches a component from an entity
+ * \param [in, out] regPtr pointer to the entity registry
+ * \param [in] entId identifier of the entity
+ * \param [in] compType type of the component
+ * \note  The last component of the pool is moved into the gap, so the index of that
+ *        component changes. If the entity does not have a component of that type, the
+ *        function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkEcsRemoveComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsEntity entId,
+    _In_    NkEcsComponentType compType
+);
+/**
+ * \brief  retrieves the index of an entity's component in the field arrays of its pool
+ * \param  [in] regPtr pointer to the entity registry
+ * \param  [in] entId identifier of the entity
+ * \param  [in] compType type of the component
+ * \return index of the component, or \c NK_ECS_NOINDEX if the entity is not alive or
+ *         does not have a component of that type
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkEcsFindComponent(
+    _In_ NkEcsRegistry const *regPtr,
+    _In_ NkEcsEntity entId,
+    _In_ NkEcsComponentType compType
+);
+/**
+ * \brief  retrieves the number of components of the given type
+ * \param  [in] regPtr pointer to the entity registry
+ * \param  [in] compType type of the component
+ * \return number of components; also the number of elements of the field arrays
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkEcsQueryCount(_In_ NkEcsRegistry const *regPtr, _In_ NkEcsComponentType compType);
+/**
+ * \brief  retrieves the densely-packed array of one field of all components of a type
+ * \param  [in] regPtr pointer to the entity registry
+ * \param  [in] compType type of the component
+ * \param  [in] fieldInd index of the field, as specified at registration
+ * \return pointer to the first element; \c NULL if there are no components of that type
+ * \note   The pointer stays valid until a component of that type is added or removed.
+ */
+NK_NATIVE NK_API NkVoid *NK_CALL NkEcsQueryField(
+    _In_ NkEcsRegistry const *regPtr,
+    _In_ NkEcsComponentType compType,
+    _In_ NkUint32 fieldInd
+);
+/**
+ * \brief  retrieves the entities owning the components of a type
+ * \param  [in] regPtr pointer to the entity registry
+ * \param  [in] compType type of the component
+ * \return pointer to an array that is parallel to the field arrays of the pool; \c NULL
+ *         if there are no components of that type
+ * \note   The pointer stays valid until a component of that type is added or removed.
+ */
+NK_NATIVE NK_API NkEcsEntity const *NK_CALL NkEcsQueryOwners(_In_ NkEcsRegistry const *regPtr, _In_ NkEcsComponentType compType);
+
+
@@ -20,6 +20,11 @@
  * lifetime of the application. Synchronization is not necessary since the command-line
  * arguments are constant.
  * 
+ * Every option is converted to all types it can be read as once, while parsing. Options
+ * that are read repeatedly should be resolved to a handle with <tt>NkEnvResolve()</tt>
+ * once; reading a typed value through a handle is then a single load that involves
+ * neither a hash table lookup nor a variant copy.
+ * 
  * \warning Due to the nature of the command-line arguments storage, it should not be
  *          accessed in functions that can be called after \c main() has returned such as
  *          functions registered in <tt>atexit()</tt>.
@@ -33,6 +38,20 @@
 #include <include/Noriko/error.h>
 
 
+/**
+ * \struct NkEnvOption
+ * \brief  forward-declaration of opaque, parsed command-line option type
+ */
+NK_NATIVE typedef struct NkEnvOption NkEnvOption;
+/**
+ * \typedef NkEnvHandle
+ * \brief   represents a resolved command-line option or environment variable
+ * \note    Handles stay valid until the component is shut down. \c NULL denotes an
+ *          option that was not passed to the application.
+ */
+NK_NATIVE typedef NkEnvOption const *NkEnvHandle;
+
+
 /**
  * \brief   queries the command-line argument with the given identifier
  * \param   [in] keyStr <tt>NUL</tt>-terminated C-string representing the key, must be
@@ -48,4 +67,44 @@
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkEnvGetValue(_In_z_ char const *keyStr, _Out_ NkVariant *valPtr);
 
+/**
+ * \brief  resolves the command-line argument with the given identifier to a handle
+ * \param  [in] keyStr <tt>NUL</tt>-terminated C-string representing the key, must be
+ *              UTF-8-encoded
+ * \return handle to the option, or \c NULL if the option was not passed
+ * \note   The same rules as for <tt>NkEnvGetValue()</tt> apply regarding threads.
+ */
+NK_NATIVE NK_API NkEnvHandle NK_CALL NkEnvResolve(_In_z_ char const *keyStr);
+/**
+ * \brief  reads an option as an integer
+ * \param  [in] envHandle (optional) handle returned by <tt>NkEnvResolve()</tt>
+ * \param  [in] defVal value returned if the option was not passed or is not a number
+ * \return value of the option, truncated towards zero, or \c defVal
+ */
+NK_NATIVE NK_API NkInt64 NK_CALL NkEnvGetInt(_In_opt_ NkEnvHandle envHandle, _In_ NkInt64 defVal);
+/**
+ * \brief  reads an option as a floating-point number
+ * \param  [in] envHandle (optional) handle returned by <tt>NkEnvResolve()</tt>
+ * \param  [in] defVal value returned if the option was not passed or is not a number
+ * \return value of the option, or \c defVal
+ */
+NK_NATIVE NK_API NkDouble NK_CALL NkEnvGetDouble(_In_opt_ NkEnvHandle envHandle, _In_ NkDouble defVal);
+/**
+ * \brief  reads an option as a boolean
+ * \param  [in] envHandle (optional) handle returned by <tt>NkEnvResolve()</tt>
+ * \param  [in] defVal value returned if the option was not passed or is not a boolean
+ * \return value of the option, or \c defVal
+ * \note   Options without value (flags) read as <tt>NK_TRUE</tt>; numbers read as
+ *         \c NK_TRUE if they are not zero.
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkEnvGetBool(_In_opt_ NkEnvHandle envHandle, _In_ NkBoolean defVal);
+/**
+ * \brief  reads an option as a string
+ * \param  [in] envHandle (optional) handle returned by <tt>NkEnvResolve()</tt>
+ * \return pointer to the value of the option, or \c NULL if the option was not passed or
+ *         is not a string
+ * \note   The returned view is not <tt>NUL</tt>-terminated.
+ */
+NK_NATIVE NK_API NkStringView const *NK_CALL NkEnvGetString(_In_opt_ NkEnvHandle envHandle);
+
 
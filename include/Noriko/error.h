@@ -177,6 +177,15 @@ NK_NATIVE typedef _In_range_(0, __NkErr_Count__ - 1) enum NkErrorCode {
     NkErr_InvSeekOrigin,         /**< invalid seek origin identifier */
     NkErr_StreamSeek,            /**< could not seek the given position */
     NkErr_StreamFlush,           /**< could not flush stream */
+    NkErr_CreateGraphicsDevice,  /**< failed to create graphics device or swap chain */
+    NkErr_CreateGpuResource,     /**< failed to create GPU resource */
+    NkErr_CompileShader,         /**< failed to compile shader */
+    NkErr_CreateThread,          /**< failed to create thread */
+    NkErr_RegisterInputDevice,   /**< failed to register input device */
+    NkErr_MapFile,               /**< could not map file into memory */
+    NkErr_CorruptedData,         /**< data is corrupted or truncated */
+    NkErr_ExecuteSqlStatement,   /**< could not execute SQL statement */
+    NkErr_OpenDirectory,         /**< could not open directory */
 
     __NkErr_Count__              /**< used internally */
 } NkErrorCode;
@@ -128,6 +128,7 @@ NK_NATIVE typedef struct NkKeyboardEvent {
 NK_NATIVE typedef struct NkMouseEvent {
     NkPoint2D      m_curPos;   /**< current (window-local) cursor position */
     NkPoint2D      m_glCurPos; /**< global (screen-wide) cursor position */
+    NkPoint2D      m_curDelta; /**< cursor movement since the previous mouse-move event (mouse-move events only) */
     NkMouseButton  m_mouseBtn; /**< mouse button */
     NkInt32        m_reserved; /**< reserved field; unused (always 0) */
 } NkMouseEvent;
@@ -139,7 +140,7 @@ NK_NATIVE typedef struct NkMouseEvent {
 NK_NATIVE typedef struct NkEvent {
     NkEventType     m_evType;    /**< numeric type ID */
     NkEventCategory m_evCat;     /**< bitfield representing the event type's categories */
-    NkUint64        m_timestamp; /**< high-precision timestamp (if available) */
+    NkUint64        m_timestamp; /**< timestamp, in fast ticks (see <tt>NkTimerGetFastTicks()</tt>) */
 
     /* additional data specifying event parameters; not used by some events */
     union {
@@ -158,6 +159,43 @@ NK_NATIVE typedef struct NkEvent {
  * \note   If the event was not handled, the function returns <tt>NkErr_NoOperation</tt>.
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkEventDispatch(_In_ NkEventType evType, ...);
+/**
+ * \brief  creates an event with the given properties and posts it to the event queue
+ * \param  [in] evType numeric type ID of the event
+ * \return \c NkErr_Ok on success, \c NkErr_CapLimitExceeded if the queue is full
+ *
+ * \par Remarks
+ *   This function can be called from any thread. It does not block and never invokes the
+ *   layer stack itself. Posted events are dispatched in order of posting by
+ *   <tt>NkEventDrainQueue()</tt>, at the latest at the start of the following frame. The
+ *   event timestamp is the time of posting.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkEventPost(_In_ NkEventType evType, ...);
+/**
+ * \brief creates an event with the given properties and posts it to the event queue
+ *        through the coalescing stage
+ * \param [in] evType numeric type ID of the event
+ *
+ * \par Remarks
+ *   Consecutive events of a coalescable type (currently \c NkEv_MouseMoved and
+ *   \c NkEv_WindowResized) are merged into a single event that carries the state of the
+ *   latest one; for mouse-move events, <tt>m_curDelta</tt> is accumulated. The merged
+ *   event is posted as soon as an event of another type is posted through this function,
+ *   or when the queue is drained. This way, a burst of platform messages only causes one
+ *   pass through the layer stack per frame while the order of events is preserved. If
+ *   the queue is full, events are dispatched immediately.
+ * \warning This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkEventPostCoalesced(_In_ NkEventType evType, ...);
+/**
+ * \brief  dispatches all events that are currently in the event queue to the layer stack
+ * \return number of events that were dispatched
+ * \note   \li This function must only be called from the main thread. The main loop calls
+ *             it once per frame, before the game is updated.
+ * \note   \li Events that are posted while the queue is being drained may be deferred to
+ *             the next call.
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkEventDrainQueue(NkVoid);
 /**
  * \brief duplicates the given event
  * \param [in] srcPtr pointer to the \c NkEvent instance that is to be duplicated
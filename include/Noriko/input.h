@@ -210,6 +210,57 @@ NK_NATIVE typedef enum NkMouseButton {
     NkBtn_Button5       /**< second side button ('DOWN') */
 } NkMouseButton;
 
+/**
+ * \def   NK_INPUT_BUFFERSIZE
+ * \brief number of input records the IAL can buffer between two reads
+ * \note  This number must be non-zero and a power of two. If the buffer is full, new
+ *        records are dropped.
+ */
+#define NK_INPUT_BUFFERSIZE ((NkSize)(256))
+/* Verify integrity. */
+static_assert(
+    NK_INPUT_BUFFERSIZE > 0 && NK_ISBITFLAG(NK_INPUT_BUFFERSIZE) == NK_TRUE,
+    "'NK_INPUT_BUFFERSIZE' is not a power of two. Check definition."
+);
+
+/**
+ * \enum  NkInputRecordType
+ * \brief types of device state transitions recorded by the IAL in buffered mode
+ */
+NK_NATIVE typedef enum NkInputRecordType {
+    NkInRec_Unknown = 0, /**< unknown/invalid record */
+
+    NkInRec_KeyDown,     /**< key was pressed (auto-repeat is not recorded) */
+    NkInRec_KeyUp,       /**< key was released */
+    NkInRec_ButtonDown,  /**< mouse button was pressed */
+    NkInRec_ButtonUp,    /**< mouse button was released */
+    NkInRec_MouseMoved   /**< mouse was moved (relative motion) */
+} NkInputRecordType;
+
+/**
+ * \struct NkInputRecord
+ * \brief  represents a single timestamped device state transition
+ */
+NK_NATIVE typedef struct NkInputRecord {
+    NkUint64          m_timestamp; /**< time of the transition, in timer ticks */
+    NkInputRecordType m_recType;   /**< type of the record */
+
+    union {
+        NkKeyboardKey m_keyCode;   /**< key (only for key records) */
+        NkMouseButton m_mouseBtn;  /**< mouse button (only for button records) */
+        NkPoint2D     m_motDelta;  /**< device motion, in device units (only for motion records) */
+    };
+} NkInputRecord;
+
+/**
+ * \typedef NkInputRecordHook
+ * \brief   callback invoked for every record that is appended to the input buffer
+ * \param   [in] recPtr pointer to the record that was appended
+ * \param   [in,out] cxtPtr context pointer that was passed when installing the hook
+ * \see     NkIInput::SetRecordHook
+ */
+typedef NkVoid (NK_CALL *NkInputRecordHook)(_In_ NkInputRecord const *recPtr, _Inout_opt_ NkVoid *cxtPtr);
+
 
 /**
  */
@@ -252,6 +303,76 @@ NKOM_DECLARE_INTERFACE(NkIInput) {
     /**
      */
     NkModifierKeys (NK_CALL *GetModifierKeyStates)(_Inout_ NkIInput *self);
+
+    /**
+     * \brief  enables or disables buffered mode for the given window
+     * \param  [in,out] self pointer to the current NkIInput instance
+     * \param  [in] ntWndHandle native handle of the window that receives the input
+     * \param  [in] isEnabled whether buffered mode is to be enabled
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   When buffered mode is disabled, all pending records are discarded.
+     *
+     * \par Remarks
+     *   In buffered mode, the IAL records every key and mouse button transition as well as
+     *   relative mouse motion as soon as the platform delivers it, timestamped with
+     *   <tt>NkTimerGetCurrentTicks()</tt>. Fixed-step updates can then consume exactly the
+     *   transitions that happened up to the end of their tick, so that even a key that is
+     *   pressed and released within the same frame is never missed.
+     */
+    NkErrorCode (NK_CALL *SetBufferedMode)(_Inout_ NkIInput *self, _In_ NkVoid *ntWndHandle, _In_ NkBoolean isEnabled);
+    /**
+     * \brief appends the records generated by the given native input message to the input
+     *        buffer
+     * \param [in,out] self pointer to the current NkIInput instance
+     * \param [in] ntInputHandle native handle of the input data (<tt>HRAWINPUT</tt> on
+     *             Windows)
+     * \note  This function is invoked by the platform window; it must be called from the
+     *        thread that owns the window. If buffered mode is disabled, the function does
+     *        nothing.
+     */
+    NkVoid (NK_CALL *OnNativeInput)(_Inout_ NkIInput *self, _In_ NkVoid *ntInputHandle);
+    /**
+     * \brief  retrieves and removes the oldest buffered records up to the given point in
+     *         time
+     * \param  [in,out] self pointer to the current NkIInput instance
+     * \param  [in] untilTime point in time (in timer ticks); only records whose timestamp
+     *              is less than or equal to this value are retrieved
+     * \param  [out] recArr array that receives the records, oldest first
+     * \param  [in] maxRecs maximum number of records to retrieve
+     * \return number of records written to \c recArr
+     * \note   This function must not be called concurrently with itself.
+     */
+    NkSize (NK_CALL *ReadBufferedInput)(
+        _Inout_            NkIInput *self,
+        _In_               NkUint64 untilTime,
+        _O_array_(maxRecs) NkInputRecord *recArr,
+        _In_               NkSize maxRecs
+    );
+    /**
+     * \brief  appends a record to the input buffer as if it had been generated by a device
+     * \param  [in,out] self pointer to the current NkIInput instance
+     * \param  [in] recPtr pointer to the record that is to be appended
+     * \return \c NkErr_Ok on success, \c NkErr_NoOperation if buffered mode is disabled, or
+     *         \c NkErr_CapLimitExceeded if the input buffer is full
+     * \note   \li The record's timestamp must not be less than the timestamp of the last
+     *             record in the buffer, or it may be consumed by a later step.
+     * \note   \li This function must be called from the thread that owns the window.
+     *
+     * \par Remarks
+     *   This is used to play back recorded input. Key records that would not change the
+     *   state of the key (such as a second <tt>NkInRec_KeyDown</tt>) are discarded, just
+     *   like auto-repeat is for device input.
+     */
+    NkErrorCode (NK_CALL *InjectRecord)(_Inout_ NkIInput *self, _In_ NkInputRecord const *recPtr);
+    /**
+     * \brief installs a hook that is invoked for every record appended to the input buffer
+     * \param [in,out] self pointer to the current NkIInput instance
+     * \param [in] fnHook hook function; pass \c NULL to remove the current hook
+     * \param [in,out] cxtPtr context pointer passed to every invocation of the hook
+     * \note  The hook is invoked on the thread that owns the window, right after the record
+     *        was appended. It replaces any previously-installed hook.
+     */
+    NkVoid (NK_CALL *SetRecordHook)(_Inout_ NkIInput *self, _In_opt_ NkInputRecordHook fnHook, _Inout_opt_ NkVoid *cxtPtr);
 };
 
 
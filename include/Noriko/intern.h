@@ -0,0 +1,75 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  intern.h
+ * \brief defines the public API for the global string interning table
+ *
+ * Interning maps every distinct UTF-8 string to a stable 32-bit ID. Identifiers, asset
+ * names and paths that are interned can be compared, hashed and stored as integers; each
+ * distinct string is only stored once for the lifetime of the engine instance. Interned
+ * strings are copied into an append-only arena and are never freed before the component
+ * is shut down, so the views returned for an ID stay valid.
+ * Hash tables can be keyed by string IDs directly using <tt>NkHtKeyTy_StringId</tt>.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
+
+
+/**
+ * \typedef NkStringId
+ * \brief   represents the ID of an interned string
+ */
+NK_NATIVE typedef NkUint32 NkStringId;
+
+/**
+ * \def   NK_INVALID_STRINGID
+ * \brief ID that is never assigned to a string
+ */
+#define NK_INVALID_STRINGID ((NkStringId)0)
+
+
+/**
+ * \brief  interns the given string
+ * \param  [in] strPtr pointer to the string that is to be interned
+ * \param  [out] idPtr pointer to a variable that receives the ID of the string
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   \li If the string has been interned before, the existing ID is returned.
+ * \note   \li The string does not need to be <tt>NUL</tt>-terminated; it is copied.
+ * \note   \li This function can be called from any thread.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkStringIntern(
+    _In_  NkStringView const *strPtr,
+    _Out_ NkStringId *idPtr
+);
+/**
+ * \brief  looks up the ID of a string without interning it
+ * \param  [in] strPtr pointer to the string that is to be looked up
+ * \return ID of the string, or \c NK_INVALID_STRINGID if it has not been interned
+ * \note   This function can be called from any thread.
+ */
+NK_NATIVE NK_API NkStringId NK_CALL NkStringFindId(_In_ NkStringView const *strPtr);
+/**
+ * \brief  retrieves the string an ID was assigned to
+ * \param  [in] strId ID returned by <tt>NkStringIntern()</tt>
+ * \return pointer to a view of the interned string; the data is <tt>NUL</tt>-terminated
+ * \note   This function does not take a lock and can be called from any thread.
+ */
+NK_NATIVE NK_API NkStringView const *NK_CALL NkStringIdGetView(_In_ NkStringId strId);
+
+
@@ -0,0 +1,133 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  interp.h
+ * \brief defines the public API for render-state interpolation
+ *
+ * The simulation runs at a fixed tick rate, while frames are rendered as often as the
+ * display allows. Drawing entities at their simulated positions makes them move in
+ * steps whenever the refresh rate is not a multiple of the tick rate. The interpolation
+ * component (see <tt>ecs.h</tt>) keeps the positions of an entity at the end of the
+ * previous and of the current fixed step. Right before rendering, all render positions
+ * are blended from these two states in one pass over the component's field arrays, using
+ * how far the frame lies between the two steps (the \c aheadBy parameter of
+ * <tt>NkILayer::OnRender()</tt>). Rendered positions therefore lag up to one step behind
+ * the simulation, but advance smoothly.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/ecs.h>
+#include <include/Noriko/renderer.h>
+
+
+/**
+ * \enum  NkInterpField
+ * \brief fields of the interpolation component
+ */
+NK_NATIVE typedef enum NkInterpField {
+    NkInterpFld_PrevX,   /**< x-coordinate at the end of the previous step (NkFloat) */
+    NkInterpFld_PrevY,   /**< y-coordinate at the end of the previous step (NkFloat) */
+    NkInterpFld_CurrX,   /**< x-coordinate at the end of the current step (NkFloat) */
+    NkInterpFld_CurrY,   /**< y-coordinate at the end of the current step (NkFloat) */
+    NkInterpFld_RenderX, /**< x-coordinate the entity is drawn at (NkFloat) */
+    NkInterpFld_RenderY, /**< y-coordinate the entity is drawn at (NkFloat) */
+    NkInterpFld_HasPrev, /**< whether the next capture may interpolate from the current state (NkByte) */
+
+    __NkInterpFld_Count__ /**< *only used internally* */
+} NkInterpField;
+
+
+/**
+ * \brief  registers the interpolation component type with an entity registry
+ * \param  [in, out] regPtr pointer to the entity registry
+ * \param  [out] typePtr pointer to a variable that receives the component type
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The fields of the component type are described by <tt>NkInterpField</tt>.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkInterpRegisterComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _Out_   NkEcsComponentType *typePtr
+);
+/**
+ * \brief  takes a snapshot of the simulated positions at the end of a fixed step
+ * \param  [in, out] regPtr pointer to the entity registry
+ * \param  [in] interpType interpolation component type
+ * \param  [in] srcType type of the component that holds the simulated positions
+ * \param  [in] xField index of the field of \c srcType that holds the x-coordinates
+ *              (NkFloat)
+ * \param  [in] yField index of the field of \c srcType that holds the y-coordinates
+ *              (NkFloat)
+ * \return \c NK_TRUE if the previous and current states of any component differ, that
+ *         is, if rendering another frame would show movement; \c NK_FALSE if not
+ *
+ * \par Remarks
+ *   Call this function once after every fixed step. The current state of every
+ *   interpolation component becomes its previous state, and the position of the same
+ *   entity's \c srcType component becomes the current state. Components whose entity has
+ *   no \c srcType component keep their state. Components that were just added or reset
+ *   with <tt>NkInterpReset()</tt> start out with both states set to the position, so
+ *   that they do not slide in from elsewhere.
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkInterpCapture(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType interpType,
+    _In_    NkEcsComponentType srcType,
+    _In_    NkUint32 xField,
+    _In_    NkUint32 yField
+);
+/**
+ * \brief makes an interpolation component skip the blend to its next position
+ * \param [in, out] regPtr pointer to the entity registry
+ * \param [in] interpType interpolation component type
+ * \param [in] compInd index of the component, as returned by <tt>NkEcsFindComponent()</tt>
+ * \note  Use this when an entity is teleported, so that it is not drawn moving across
+ *        the map during the next step.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkInterpReset(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType interpType,
+    _In_    NkUint32 compInd
+);
+/**
+ * \brief calculates the render positions of all interpolation components
+ * \param [in, out] regPtr pointer to the entity registry
+ * \param [in] interpType interpolation component type
+ * \param [in] blendFac position of the frame between the previous (\c 0) and the current
+ *             (\c 1) step; values outside of this range are clamped
+ * \note  Call this function once per frame before drawing, then read the
+ *        <tt>NkInterpFld_RenderX</tt> and <tt>NkInterpFld_RenderY</tt> fields.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkInterpUpdate(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType interpType,
+    _In_    NkFloat blendFac
+);
+/**
+ * \brief  retrieves the render position of an interpolation component
+ * \param  [in] regPtr pointer to the entity registry
+ * \param  [in] interpType interpolation component type
+ * \param  [in] compInd index of the component, as returned by <tt>NkEcsFindComponent()</tt>
+ * \return position calculated by the last call to <tt>NkInterpUpdate()</tt>
+ */
+NK_NATIVE NK_API NkVec2F NK_CALL NkInterpGetPosition(
+    _In_ NkEcsRegistry const *regPtr,
+    _In_ NkEcsComponentType interpType,
+    _In_ NkUint32 compInd
+);
+
+
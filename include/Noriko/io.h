@@ -28,9 +28,47 @@
 #include <include/Noriko/dstruct/string.h>
 
 
+/**
+ * \struct NkDirectoryEntry
+ * \brief  describes a single entry found by <tt>NkIFilesystem::TraverseParallel()</tt>
+ */
+NK_NATIVE typedef struct NkDirectoryEntry {
+    char const *mp_pathStr;  /**< path of the entry, starting with the root path */
+    NkSize      m_pathLen;   /**< length of \c mp_pathStr, in bytes */
+    NkBoolean   m_isDir;     /**< whether the entry is a directory */
+    NkUint64    m_fileSize;  /**< size of the file, in bytes; \c 0 for directories */
+    NkUint64    m_mdTime;    /**< time of the last modification, in platform-specific units */
+} NkDirectoryEntry;
+
+
 /**
  */
 typedef NkErrorCode (NK_CALL *NkDirectoryTraverseFn)(_In_z_ _Utf8_ char const *, _Inout_opt_ NkVoid *);
+/**
+ * \brief callback invoked by <tt>NkIFilesystem::TraverseParallel()</tt> for a batch of
+ *        entries of the same directory
+ * \note  The entries are only valid during the call. Return a non-zero value to stop the
+ *        traversal.
+ */
+typedef NkErrorCode (NK_CALL *NkDirectoryBatchFn)(
+    _In_reads_(nEntries) NkDirectoryEntry const *,
+    _In_                 NkSize nEntries,
+    _Inout_opt_          NkVoid *
+);
+/**
+ * \brief callback invoked by a file watch for every file that was created, modified, or
+ *        renamed
+ * \note  The callback is invoked on the watch's own thread. The path is the path of the
+ *        watched directory the file was found in, followed by the file's path relative to
+ *        it, using <tt>/</tt> as separator; it is only valid during the call.
+ */
+typedef NkVoid (NK_CALL *NkFileChangeFn)(_In_z_ _Utf8_ char const *, _Inout_opt_ NkVoid *);
+
+/**
+ * \struct NkFileWatch
+ * \brief  opaque handle of a directory that is watched for changes
+ */
+NK_NATIVE typedef struct NkFileWatch NkFileWatch;
 
 
 /**
@@ -40,6 +78,7 @@ NK_NATIVE typedef enum NkStreamType {
 
     NkStrTy_Directory,
     NkStrTy_DiskFile,
+    NkStrTy_MappedFile,
 
     __NkStrTy_Count__
 } NkStreamType;
@@ -167,6 +206,89 @@ NKOM_DECLARE_INTERFACE(NkIFile) {
     NkErrorCode (NK_CALL *Flush)(_Inout_ NkIFile *self);
 };
 
+/**
+ * \interface NkIMappedFile
+ * \brief     represents a read-only file that is mapped into memory as a whole
+ *
+ * A mapped file is opened like any other \c NkIFile. However, its contents can be
+ * accessed in place via <tt>Map()</tt> which does not copy any data. <tt>Read()</tt> and
+ * <tt>Seek()</tt> are supported as well and operate on the mapped memory, so reading
+ * does not go through the CRT buffer.
+ * 
+ * \note \li Mapped files can only be opened with the \c NkStrMd_Read mode (optionally
+ *           with \c NkStrMd_Binary); <tt>Write()</tt> always fails.
+ * \note \li Empty files cannot be mapped.
+ */
+NKOM_DECLARE_INTERFACE(NkIMappedFile) {
+    /**
+     * \brief reimplements <tt>NkIFile::QueryInterface()</tt>
+     */
+    NkErrorCode (NK_CALL *QueryInterface)(_Inout_ NkIMappedFile *self, _In_ NkUuid const *iId, _Outptr_ NkVoid **resPtr);
+    /**
+     * \brief reimplements <tt>NkIFile::AddRef()</tt> 
+     */
+    NkOMRefCount (NK_CALL *AddRef)(_Inout_ NkIMappedFile *self);
+    /**
+     * \brief reimplements <tt>NkIFile::Release()</tt> 
+     */
+    NkOMRefCount (NK_CALL *Release)(_Inout_ NkIMappedFile *self);
+
+    /**
+     * \brief reimplements <tt>NkIFile::GetStat()</tt>
+     */
+    NkErrorCode (NK_CALL *GetStat)(_Inout_ NkIMappedFile *self, _Out_ NkStreamStat *statPtr);
+
+    /**
+     * \brief reimplements <tt>NkIFile::Read()</tt>
+     */
+    NkErrorCode (NK_CALL *Read)(_Inout_ NkIMappedFile *self, _In_ NkSize s, _O_bytes_(s) NkVoid *bufPtr, _Out_ NkSize *br);
+    /**
+     * \brief reimplements <tt>NkIFile::Write()</tt>
+     */
+    NkErrorCode (NK_CALL *Write)(
+        _Inout_      NkIMappedFile *self,
+        _In_         NkSize s,
+        _I_bytes_(s) NkVoid const *bufPtr,
+        _Out_        NkSize *bw
+    );
+    
+    /**
+     * \brief reimplements <tt>NkIFile::Open()</tt>
+     */
+    NkErrorCode (NK_CALL *Open)(_Inout_ NkIMappedFile *self, _In_z_ _Utf8_ char const *pathStr, _In_ NkStreamIOMode mode);
+    /**
+     * \brief reimplements <tt>NkIFile::Close()</tt>
+     */
+    NkVoid (NK_CALL *Close)(_Inout_ NkIMappedFile *self);
+    /**
+     * \brief reimplements <tt>NkIFile::Seek()</tt>
+     */
+    NkErrorCode (NK_CALL *Seek)(_Inout_ NkIMappedFile *self, _In_ NkSeekOrigin origin, _In_ NkOffset offset);
+    /**
+     * \brief reimplements <tt>NkIFile::Flush()</tt>
+     */
+    NkErrorCode (NK_CALL *Flush)(_Inout_ NkIMappedFile *self);
+
+    /**
+     * \brief   retrieves a view into the mapped file contents
+     * \param   [in, out] self current \c NkIMappedFile instance
+     * \param   [in] offset offset of the first byte, in bytes
+     * \param   [in] s number of bytes; pass \c 0 to map everything up to the end of the
+     *              file
+     * \param   [out] viewPtr pointer to a variable that receives the view
+     * \return  \c NkErr_Ok on success, \c NkErr_ObjectState if no file is open, or
+     *          \c NkErr_InvalidRange if the range exceeds the file
+     * \note    No data is copied and the stream position is not changed.
+     * \warning The view is read-only, and it becomes invalid once the file is closed.
+     */
+    NkErrorCode (NK_CALL *Map)(
+        _Inout_ NkIMappedFile *self,
+        _In_    NkSize offset,
+        _In_    NkSize s,
+        _Out_   NkBufferView *viewPtr
+    );
+};
+
 /**
  */
 NKOM_DECLARE_INTERFACE(NkIFilesystem) {
@@ -217,6 +339,14 @@ NKOM_DECLARE_INTERFACE(NkIFilesystem) {
      */
     NkVoid (NK_CALL *Remove)(_Inout_ NkIFilesystem *self, _In_z_ _Utf8_ char const *pathStr);
     /**
+     * \brief  enumerates the entries of a directory on the calling thread
+     * \param  [in, out] self current \c NkIFilesystem instance
+     * \param  [in] rootPath path of the directory
+     * \param  [in] isRecursive whether subdirectories are entered, depth first
+     * \param  [in] fnTrav callback invoked with the path of every file and directory
+     * \param  [in, out] extraParam (optional) context passed to \c fnTrav
+     * \return \c NkErr_Ok on success, \c NkErr_OpenDirectory if a directory could not be
+     *         opened, or the first non-zero value returned by \c fnTrav
      */
     NkErrorCode (NK_CALL *Traverse)(
         _Inout_       NkIFilesystem *self,
@@ -225,6 +355,63 @@ NKOM_DECLARE_INTERFACE(NkIFilesystem) {
         _In_          NkDirectoryTraverseFn fnTrav,
         _Inout_opt_   NkVoid *extraParam
     );
+    /**
+     * \brief  enumerates the entries of a directory tree on the job system
+     * \param  [in, out] self current \c NkIFilesystem instance
+     * \param  [in] rootPath path of the directory
+     * \param  [in] isRecursive whether subdirectories are entered
+     * \param  [in] fnBatch callback invoked for batches of entries
+     * \param  [in, out] extraParam (optional) context passed to \c fnBatch
+     * \return \c NkErr_Ok on success, \c NkErr_OpenDirectory if a directory could not be
+     *         opened, or the first non-zero value returned by \c fnBatch
+     *
+     * \par Remarks
+     *   Every directory is enumerated by a job of its own, so subdirectories are scanned
+     *   in parallel, and the entries of each directory are reported in batches. Hence,
+     *   \c fnBatch is invoked from multiple worker threads at once and the order of the
+     *   batches is unspecified. The calling thread runs jobs until the traversal is done.
+     *   Use this for large trees; it must be called from a thread that may wait on jobs.
+     */
+    NkErrorCode (NK_CALL *TraverseParallel)(
+        _Inout_       NkIFilesystem *self,
+        _In_z_ _Utf8_ char const *rootPath,
+        _In_          NkBoolean isRecursive,
+        _In_          NkDirectoryBatchFn fnBatch,
+        _Inout_opt_   NkVoid *extraParam
+    );
+
+    /**
+     * \brief  starts watching a directory for changed files
+     * \param  [in, out] self current \c NkIFilesystem instance
+     * \param  [in] rootPath path of the directory that is to be watched
+     * \param  [in] isRecursive whether files in subdirectories are watched, too
+     * \param  [in] fnChange callback that is invoked for every changed file
+     * \param  [in, out] extraParam (optional) context passed to \c fnChange
+     * \param  [out] watchPtr pointer to a variable that receives the watch handle
+     * \return \c NkErr_Ok on success, non-zero on failure
+     *
+     * \par Remarks
+     *   Changes are reported by the operating system and picked up by a thread owned by
+     *   the watch, so nothing has to be polled. A program saving a file usually writes it
+     *   in multiple steps; each of them may be reported as a separate change. If a lot of
+     *   files change at once and the notifications overflow, the changes are dropped.
+     */
+    NkErrorCode (NK_CALL *Watch)(
+        _Inout_       NkIFilesystem *self,
+        _In_z_ _Utf8_ char const *rootPath,
+        _In_          NkBoolean isRecursive,
+        _In_          NkFileChangeFn fnChange,
+        _Inout_opt_   NkVoid *extraParam,
+        _Outptr_      NkFileWatch **watchPtr
+    );
+    /**
+     * \brief stops watching a directory
+     * \param [in, out] self current \c NkIFilesystem instance
+     * \param [in, out] watchPtr pointer to the watch handle; set to \c NULL afterwards
+     * \note  When the function returns, the callback of the watch is not running anymore
+     *        and is not going to be invoked again.
+     */
+    NkVoid (NK_CALL *Unwatch)(_Inout_ NkIFilesystem *self, _Uninit_ptr_ NkFileWatch **watchPtr);
 };
 
 
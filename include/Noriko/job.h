@@ -0,0 +1,119 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  job.h
+ * \brief defines the public API for Noriko's job system
+ *
+ * The job system runs small, independent units of work ("jobs") on a fixed set of worker
+ * threads, one per logical processor besides the main thread. Every worker owns a
+ * fixed-size work-stealing deque; idle workers steal jobs from the deques of busy ones.
+ * Completion of jobs is tracked using job counters. A counter can also be used as a
+ * dependency for other jobs, which are then only started once the counter reaches zero.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
+
+
+/**
+ * \typedef NkJobFn
+ * \brief   entry point of a job
+ * \param   [in, out] extraCxt (optional) user-defined context pointer
+ */
+NK_NATIVE typedef NkVoid (NK_CALL *NkJobFn)(_Inout_opt_ NkVoid *extraCxt);
+
+/**
+ * \struct NkJobCounter
+ * \brief  counts the jobs associated with it that have not yet finished
+ * \note   \li A zero-initialized counter is valid and has no pending jobs.
+ * \note   \li A counter must stay alive until all jobs associated with it and all jobs
+ *             depending on it have been started.
+ */
+NK_DEFINE_PROTOTYPE(NkJobCounter, NK_ALIGNOF(NkAlign8), 16);
+
+/**
+ * \struct NkJobDescription
+ * \brief  describes a single job
+ */
+NK_NATIVE typedef struct NkJobDescription {
+    NkJobFn  mp_jobFn;    /**< job entry point */
+    NkVoid  *mp_extraCxt; /**< context passed to <tt>mp_jobFn</tt> */
+} NkJobDescription;
+
+
+/**
+ * \brief  submits a batch of jobs to the job system
+ * \param  [in] jobArr array of jobs that are to be run
+ * \param  [in] nJobs number of elements in \c jobArr
+ * \param  [in] depCounter (optional) counter that must reach zero before any of the
+ *              jobs in \c jobArr is started
+ * \param  [in, out] jobCounter (optional) counter that is incremented by \c nJobs and
+ *                   decremented each time one of the jobs finished
+ * \return \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   This function can be called from any thread, including from within jobs. Jobs that
+ *   are submitted by a worker thread are pushed onto that worker's own deque; jobs
+ *   submitted by other threads go to a shared queue. If the queue a job is pushed to is
+ *   full, the job is run immediately on the calling thread. The order in which the jobs
+ *   are started is unspecified.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkJobSubmit(
+    _I_array_(nJobs) NkJobDescription const *jobArr,
+    _In_             NkSize nJobs,
+    _Inout_opt_      NkJobCounter *depCounter,
+    _Inout_opt_      NkJobCounter *jobCounter
+);
+/**
+ * \brief blocks until the given job counter reaches zero
+ * \param [in, out] jobCounter counter that is to be waited on
+ * \note  While waiting, the calling thread runs other pending jobs. Hence, it is safe to
+ *        call this function from within a job.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkJobWait(_Inout_ NkJobCounter *jobCounter);
+/**
+ * \brief  checks whether all jobs associated with the given counter have finished
+ * \param  [in] jobCounter counter that is to be checked
+ * \return \c NK_TRUE if the counter is zero, \c NK_FALSE otherwise
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkJobIsDone(_In_ NkJobCounter const *jobCounter);
+/**
+ * \brief adds pending work items to a job counter that are not jobs
+ * \param [in, out] jobCounter counter that is to be incremented
+ * \param [in] nItems number of work items
+ * \note  This allows work that is finished outside of the job system, for example I/O
+ *        requests, to be waited on or depended on like jobs. Every item must eventually
+ *        be finished by calling <tt>NkJobCounterSignal()</tt> exactly once.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkJobCounterAddPending(_Inout_ NkJobCounter *jobCounter, _In_ NkSize nItems);
+/**
+ * \brief marks a single work item added by <tt>NkJobCounterAddPending()</tt> as finished
+ * \param [in, out] jobCounter counter that is to be decremented
+ * \note  If the counter reaches zero, all jobs depending on it are started. This function
+ *        can be called from any thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkJobCounterSignal(_Inout_ NkJobCounter *jobCounter);
+/**
+ * \brief  retrieves the number of worker threads the job system uses
+ * \return number of worker threads, not including the main thread
+ * \note   If \c NK_TARGET_MULTITHREADED is not defined, this function always returns
+ *         <tt>0</tt> and all jobs are run on the main thread while it waits.
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkJobGetWorkerCount(NkVoid);
+
+
@@ -104,9 +104,36 @@ NKOM_DECLARE_INTERFACE(NkILayer) {
      */
     NkErrorCode (NK_CALL *OnEvent)(_Inout_ NkILayer *self, _In_ NkEvent const *evPtr);
     /**
+     * \brief  retrieves the event categories the layer wants to receive
+     * \param  [in,out] self pointer to the current \c NkILayer instance
+     * \return bitwise OR of \c NkEventCategory values
+     * \note   \li This method is optional and can be <tt>NULL</tt>, in which case the layer
+     *             receives events of all categories.
+     * \note   \li The layer receives an event if the event type shares at least one
+     *             category with the returned value.
+     * \note   \li The method is invoked whenever the layer stack changes, with the layer
+     *             stack's lock held. It must not call into the layer stack, and its return
+     *             value must not change while the layer is pushed.
+     */
+    NkEventCategory (NK_CALL *QueryEventCategories)(_Inout_ NkILayer *self);
+    /**
+     * \brief  invoked once per frame, right before the frame is rendered
+     * \param  [in,out] self pointer to the current \c NkILayer instance
+     * \param  [in] updTime time elapsed since the last frame, in seconds
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   This method is optional and can be <tt>NULL</tt>. Use it for work that must
+     *         happen once per rendered frame, such as camera or streaming updates.
      */
     NkErrorCode (NK_CALL *OnUpdate)(_Inout_ NkILayer *self, _In_ NkFloat updTime);
     /**
+     * \brief  invoked at the fixed tick rate set in the application specification
+     * \param  [in,out] self pointer to the current \c NkILayer instance
+     * \param  [in] updTime length of a fixed step, in seconds
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   \li This method is optional and can be <tt>NULL</tt>. Use it for simulation
+     *             (physics, movement, game logic) that must be deterministic.
+     * \note   \li Depending on how long a frame takes, this method may be invoked zero or
+     *             more times per frame.
      */
     NkErrorCode (NK_CALL *OnFixedUpdate)(_Inout_ NkILayer *self, _In_ NkFloat updTime);
     /**
@@ -127,6 +154,13 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkLayerstackOnEvent(_In_ NkEven
 /**
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkLayerstackOnUpdate(_In_ NkFloat updTime);
+/**
+ * \brief  invokes <tt>NkILayer::OnFixedUpdate()</tt> for all layers, from the top-most
+ *         layer to the bottom-most layer
+ * \param  [in] updTime length of a fixed step, in seconds
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkLayerstackOnFixedUpdate(_In_ NkFloat updTime);
 /**
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkLayerstackOnRender(_In_ NkFloat aheadBy);
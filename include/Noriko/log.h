@@ -42,6 +42,31 @@
         NK_MAKE_STRING_VIEW(__func__)      \
     }
 
+/**
+ * \def   NK_LOG_MINLEVEL
+ * \brief minimum log level that is compiled into the binary
+ * \note  Logging macros for levels below this level expand to an expression that is never
+ *        evaluated, so their arguments cost nothing at run-time. The value can be
+ *        overridden on the command-line, e.g. <tt>/DNK_LOG_MINLEVEL=NkLogLvl_Trace</tt>.
+ *        It is also the default global minimum level at run-time.
+ */
+#if (!defined NK_LOG_MINLEVEL)
+    #if (defined NK_CONFIG_DEBUG)
+        #define NK_LOG_MINLEVEL NkLogLvl_None
+    #else
+        #define NK_LOG_MINLEVEL NkLogLvl_Info
+    #endif
+#endif
+/**
+ * \def   NK_LOG_IMPL(cxt, lvl, msg, ...)
+ * \brief logs a message if the given level is compiled in
+ * \param cxt message context (can be <tt>NULL</tt>)
+ * \param lvl log level
+ * \param msg format template of the message
+ */
+#define NK_LOG_IMPL(cxt, lvl, msg, ...) \
+    ((lvl) >= NK_LOG_MINLEVEL ? NkLogMessage(cxt, lvl, msg, ##__VA_ARGS__) : (NkVoid)0)
+
 /**
  * \defgroup Macros
  * \brief    contains shortcuts for conveniently logging messages without having to
@@ -53,21 +78,21 @@
  *           is desirable.
  */
 /** @{ */
-#define NK_LOG_NONE(msg, ...)      NkLogMessage(NULL, NkLogLvl_None, msg, ##__VA_ARGS__)
-#define NK_LOG_TRACE(msg, ...)     NkLogMessage(NULL, NkLogLvl_Trace, msg, ##__VA_ARGS__)
-#define NK_LOG_DEBUG(msg, ...)     NkLogMessage(NULL, NkLogLvl_Debug, msg, ##__VA_ARGS__)
-#define NK_LOG_INFO(msg, ...)      NkLogMessage(NULL, NkLogLvl_Info, msg, ##__VA_ARGS__)
-#define NK_LOG_WARNING(msg, ...)   NkLogMessage(NULL, NkLogLvl_Warn, msg, ##__VA_ARGS__)
-#define NK_LOG_ERROR(msg, ...)     NkLogMessage(NULL, NkLogLvl_Error, msg, ##__VA_ARGS__)
-#define NK_LOG_CRITICAL(msg, ...)  NkLogMessage(NULL, NkLogLvl_Critical, msg, ##__VA_ARGS__)
-
-#define NK_LOG_CNONE(msg, ...)     NkLogMessage(NK_MAKE_LOG_FRAME(), NkLogLvl_None, msg, ##__VA_ARGS__)
-#define NK_LOG_CTRACE(msg, ...)    NkLogMessage(NK_MAKE_LOG_FRAME(), NkLogLvl_Trace, msg, ##__VA_ARGS__)
-#define NK_LOG_CDEBUG(msg, ...)    NkLogMessage(NK_MAKE_LOG_FRAME(), NkLogLvl_Debug, msg, ##__VA_ARGS__)
-#define NK_LOG_CINFO(msg, ...)     NkLogMessage(NK_MAKE_LOG_FRAME(), NkLogLvl_Info, msg, ##__VA_ARGS__)
-#define NK_LOG_CWARNING(msg, ...)  NkLogMessage(NK_MAKE_LOG_FRAME(), NkLogLvl_Warn, msg, ##__VA_ARGS__)
-#define NK_LOG_CERROR(msg, ...)    NkLogMessage(NK_MAKE_LOG_FRAME(), NkLogLvl_Error, msg, ##__VA_ARGS__)
-#define NK_LOG_CCRITICAL(msg, ...) NkLogMessage(NK_MAKE_LOG_FRAME(), NkLogLvl_Critical, msg, ##__VA_ARGS__)
+#define NK_LOG_NONE(msg, ...)      NK_LOG_IMPL(NULL, NkLogLvl_None, msg, ##__VA_ARGS__)
+#define NK_LOG_TRACE(msg, ...)     NK_LOG_IMPL(NULL, NkLogLvl_Trace, msg, ##__VA_ARGS__)
+#define NK_LOG_DEBUG(msg, ...)     NK_LOG_IMPL(NULL, NkLogLvl_Debug, msg, ##__VA_ARGS__)
+#define NK_LOG_INFO(msg, ...)      NK_LOG_IMPL(NULL, NkLogLvl_Info, msg, ##__VA_ARGS__)
+#define NK_LOG_WARNING(msg, ...)   NK_LOG_IMPL(NULL, NkLogLvl_Warn, msg, ##__VA_ARGS__)
+#define NK_LOG_ERROR(msg, ...)     NK_LOG_IMPL(NULL, NkLogLvl_Error, msg, ##__VA_ARGS__)
+#define NK_LOG_CRITICAL(msg, ...)  NK_LOG_IMPL(NULL, NkLogLvl_Critical, msg, ##__VA_ARGS__)
+
+#define NK_LOG_CNONE(msg, ...)     NK_LOG_IMPL(NK_MAKE_LOG_FRAME(), NkLogLvl_None, msg, ##__VA_ARGS__)
+#define NK_LOG_CTRACE(msg, ...)    NK_LOG_IMPL(NK_MAKE_LOG_FRAME(), NkLogLvl_Trace, msg, ##__VA_ARGS__)
+#define NK_LOG_CDEBUG(msg, ...)    NK_LOG_IMPL(NK_MAKE_LOG_FRAME(), NkLogLvl_Debug, msg, ##__VA_ARGS__)
+#define NK_LOG_CINFO(msg, ...)     NK_LOG_IMPL(NK_MAKE_LOG_FRAME(), NkLogLvl_Info, msg, ##__VA_ARGS__)
+#define NK_LOG_CWARNING(msg, ...)  NK_LOG_IMPL(NK_MAKE_LOG_FRAME(), NkLogLvl_Warn, msg, ##__VA_ARGS__)
+#define NK_LOG_CERROR(msg, ...)    NK_LOG_IMPL(NK_MAKE_LOG_FRAME(), NkLogLvl_Error, msg, ##__VA_ARGS__)
+#define NK_LOG_CCRITICAL(msg, ...) NK_LOG_IMPL(NK_MAKE_LOG_FRAME(), NkLogLvl_Critical, msg, ##__VA_ARGS__)
 /** @} */
 
 
@@ -152,6 +177,16 @@ NKOM_DECLARE_INTERFACE(NkILogDevice) {
         _In_         NkStringView tsStr,
         _Format_str_ NkStringView fmtMsgStr
     );
+    /**
+     * \brief  retrieves the log levels the device wants to receive
+     * \param  [in,out] self pointer to the current NkILogDevice instance
+     * \return bit-mask where bit <tt>(1 << lvlId)</tt> is set for every level the device
+     *         is interested in
+     * \note   This method is optional; if it is \c NULL, the device receives all levels.
+     *         The mask is queried once when the device is installed. Messages no device
+     *         wants are not even formatted.
+     */
+    NkUint32 (NK_CALL *QueryLevelMask)(_Inout_ NkILogDevice *self);
 };
 
 
@@ -203,5 +238,29 @@ NK_NATIVE NK_API NkVoid NK_CALL NkLogMessage(
     _Format_str_ char const *fmtStr,
     ...
 );
+/**
+ * \brief  enables or disables asynchronous logging
+ * \param  [in] isAsync whether messages are to be written asynchronously
+ * \return \c NkErr_Ok on success, \c NkErr_NoOperation if the mode is already set, or
+ *         \c NkErr_NotImplemented if the target is not multithreaded
+ * \note   Asynchronous logging is enabled by default when the logging component is
+ *         started.
+ *
+ * \par Remarks
+ *   In asynchronous mode, <tt>NkLogMessage()</tt> formats the message into a bounded queue
+ *   and returns immediately; a dedicated writer thread passes the messages to the devices
+ *   in the order they were queued. Hence, <tt>NkILogDevice::OnMessage()</tt> is invoked
+ *   on the writer thread. If the queue is full, the caller waits until the writer has
+ *   made room, so messages are never lost. Critical messages are flushed before
+ *   <tt>NkLogMessage()</tt> returns. When asynchronous mode is disabled, all pending
+ *   messages are written before the function returns.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkLogSetAsyncMode(_In_ NkBoolean isAsync);
+/**
+ * \brief blocks until all messages logged before the call have been passed to the
+ *        devices
+ * \note  If asynchronous logging is disabled, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkLogFlush(NkVoid);
 
 
@@ -41,6 +41,17 @@
  */
 NK_NATIVE typedef NkInt32 NkOMRefCount;
 
+/**
+ * \enum  NkOMRefCountMode
+ * \brief lists the ways a class can maintain its reference count
+ * \see   NkOMRefCountIncrement, NkOMRefCountDecrement
+ */
+NK_NATIVE typedef enum NkOMRefCountMode {
+    NkOMRcMd_Shared,      /**< instances may be referenced by any thread; interlocked */
+    NkOMRcMd_ThreadLocal, /**< instances are only referenced by the thread using them; not atomic */
+    NkOMRcMd_Static       /**< instances are never destroyed; the count is not maintained */
+} NkOMRefCountMode;
+
 
 /**
  * \struct NkOMImplementationInfo
@@ -576,6 +587,26 @@ NKOM_DECLARE_INTERFACE(NkIClassFactory) {
 };
 
 
+/**
+ * \struct NkOMFactoryCache
+ * \brief  caches the factory of a single class for repeated instantiation
+ *
+ * A factory cache is usually a static variable at the call site. It is re-resolved
+ * automatically whenever a factory has been installed or uninstalled since it was last
+ * used; otherwise, resolving it only costs one comparison.
+ */
+NK_NATIVE typedef struct NkOMFactoryCache {
+    NkUuid const             *mp_clsId;  /**< class whose factory is cached */
+    NkIClassFactory *volatile mp_clsFac; /**< cached factory; \c NULL if not registered */
+    NkInt32 volatile          m_regGen;  /**< registry generation the cache was resolved for */
+} NkOMFactoryCache;
+/**
+ * \def   NKOM_FACTORYCACHE_INIT(clsId)
+ * \brief initializer for an unresolved factory cache of the class <tt>clsId</tt>
+ */
+#define NKOM_FACTORYCACHE_INIT(clsId) { (clsId), NULL, 0 }
+
+
 /**
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkOMCreateInstance(
@@ -585,12 +616,42 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkOMCreateInstance(
     _Inout_opt_ NkVoid *initParam,
     _Outptr_    NkIBase **resPtr
 );
+/**
+ * \brief  creates an instance of the class of a factory cache
+ * \param  [in, out] cachePtr factory cache of the class that is to be instantiated
+ * \param  [in, out] ctrlInst (optional) controlling instance
+ * \param  [in] iId interface that is to be queried from the new instance
+ * \param  [in, out] initParam (optional) parameter for
+ *                   <tt>NkIInitializable::Initialize()</tt>
+ * \param  [out] resPtr pointer to a variable that receives the new instance
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   This behaves like <tt>NkOMCreateInstance()</tt>, but neither looks up the
+ *         factory nor touches its reference count if the cache is up-to-date.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkOMCreateInstanceCached(
+    _Inout_     NkOMFactoryCache *cachePtr,
+    _Inout_opt_ NkIBase *ctrlInst,
+    _In_        NkUuid const *iId,
+    _Inout_opt_ NkVoid *initParam,
+    _Outptr_    NkIBase **resPtr
+);
 /**
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkOMQueryFactoryForClass(
     _In_     NkUuid const *clsidPtr,
     _Outptr_ NkIClassFactory **clsFacPtr
 );
+/**
+ * \brief   retrieves the factory of the class of a factory cache
+ * \param   [in, out] cachePtr factory cache that is to be resolved
+ * \return  factory of the class, or \c NULL if the class is not registered
+ * \note    The returned pointer does not hold a reference. The factory stays valid for
+ *          as long as it is installed.
+ * \warning Factories must not be uninstalled while another thread may still use a
+ *          pointer returned by this function. Factories are only uninstalled while the
+ *          engine shuts down.
+ */
+NK_NATIVE NK_API NkIClassFactory *NK_CALL NkOMResolveFactory(_Inout_ NkOMFactoryCache *cachePtr);
 /**
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkOMInstallClassFactory(_Inout_ NkIClassFactory *clsFac);
@@ -598,6 +659,40 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkOMInstallClassFactory(_Inout_
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkOMUninstallClassFactory(_Inout_ NkIClassFactory *clsFac);
 
+/**
+ * \brief  increments a reference count
+ * \param  [in, out] rcPtr pointer to the reference count; may be \c NULL for
+ *                   <tt>NkOMRcMd_Static</tt>
+ * \param  [in] rcMode how the reference count is maintained
+ * \return new reference count; always \c 1 for <tt>NkOMRcMd_Static</tt>
+ *
+ * \par Remarks
+ *   This is meant to implement <tt>NkIBase::AddRef()</tt>, passing a constant
+ *   \c rcMode that fits how instances of the class are used. Objects that are handed to
+ *   worker threads must use <tt>NkOMRcMd_Shared</tt>. Objects that never leave the thread
+ *   that created them can use <tt>NkOMRcMd_ThreadLocal</tt>, which avoids the cost of an
+ *   interlocked operation on every reference taken. <tt>NkOMRcMd_Static</tt> is for
+ *   singletons that live in static memory.
+ */
+NK_NATIVE NK_API NkOMRefCount NK_CALL NkOMRefCountIncrement(
+    _Inout_opt_ NkOMRefCount volatile *rcPtr,
+    _In_        NkOMRefCountMode rcMode
+);
+/**
+ * \brief  decrements a reference count
+ * \param  [in, out] rcPtr pointer to the reference count; may be \c NULL for
+ *                   <tt>NkOMRcMd_Static</tt>
+ * \param  [in] rcMode how the reference count is maintained; must be the same mode the
+ *              count is incremented with
+ * \return new reference count; always \c 1 for <tt>NkOMRcMd_Static</tt>
+ * \note   If the function returns \c 0, the caller held the last reference and must
+ *         destroy the instance.
+ */
+NK_NATIVE NK_API NkOMRefCount NK_CALL NkOMRefCountDecrement(
+    _Inout_opt_ NkOMRefCount volatile *rcPtr,
+    _In_        NkOMRefCountMode rcMode
+);
+
 /**
  */
 NK_NATIVE NK_API NkBoolean NK_CALL NkOMIsPureVirtual(_In_ NkUuid const *iId);
@@ -40,12 +40,26 @@
 #include <include/Noriko/helpers.h>
 #include <include/Noriko/renderer.h>
 #include <include/Noriko/bmp.h>
+#include <include/Noriko/pixel.h>
 #include <include/Noriko/input.h>
 #include <include/Noriko/path.h>
 #include <include/Noriko/db.h>
 #include <include/Noriko/asset.h>
 #include <include/Noriko/comp.h>
 #include <include/Noriko/io.h>
+#include <include/Noriko/tilecache.h>
+#include <include/Noriko/chunk.h>
+#include <include/Noriko/atlas.h>
+#include <include/Noriko/pack.h>
+#include <include/Noriko/job.h>
+#include <include/Noriko/asyncio.h>
+#include <include/Noriko/profiler.h>
+#include <include/Noriko/capture.h>
+#include <include/Noriko/spatial.h>
+#include <include/Noriko/ecs.h>
+#include <include/Noriko/anim.h>
+#include <include/Noriko/pathfind.h>
+#include <include/Noriko/intern.h>
 
 #include <include/Noriko/dstruct/vector.h>
 #include <include/Noriko/dstruct/htable.h>
@@ -61,6 +75,9 @@ NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkApplicationSpecific
     NkBoolean              m_enableDbgTools;  /**< whether or not to enable debugging tools */
     NkRendererApi          m_rendererApi;     /**< API to use for rendering */
     NkBoolean              m_isVSync;         /**< whether or not VSync is used */
+    NkUint32               m_fixedTickRate;   /**< rate of fixed updates, in Hz (0 = default of 120 Hz) */
+    NkUint32               m_targetFps;       /**< frame rate limit, in frames per second (0 = unlimited) */
+    NkBoolean              m_isOnDemand;      /**< whether frames are only rendered after <tt>NkApplicationRequestRedraw()</tt> */
     NkViewportAlignment    m_vpAlignment;     /**< viewport alignment inside the main window */
     NkSize2D               m_vpExtents;       /**< size in tiles of the main window viewport */
     NkSize2D               m_dispTileSize;    /**< tile size used in the main window viewport */
@@ -75,6 +92,17 @@ NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkApplicationSpecific
     NkStringView           m_gameRootDir;     /**< default working directory */
 } NkApplicationSpecification;
 
+/**
+ * \typedef NkApplicationStepCallback
+ * \brief   callback invoked by the main loop right before every fixed step
+ * \param   [in] stepInd zero-based index of the fixed step that is about to be run
+ * \param   [in] stepTime point in time the step simulates up to (see
+ *               <tt>NkApplicationQueryFixedStepTime()</tt>)
+ * \param   [in,out] cxtPtr context pointer that was passed when installing the callback
+ * \see     NkApplicationSetStepCallback
+ */
+typedef NkVoid (NK_CALL *NkApplicationStepCallback)(_In_ NkUint64 stepInd, _In_ NkUint64 stepTime, _Inout_opt_ NkVoid *cxtPtr);
+
 
 /**
  */
@@ -85,6 +113,29 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkApplicationShutdown(NkVoid);
 /**
  */
 NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkApplicationRun(NkVoid);
+/**
+ * \brief  runs the main loop deterministically for the given number of fixed steps
+ * \param  [in] nSteps number of frames to run; every frame runs exactly one fixed step
+ * \param  [out] frameTimes (optional) array that receives the wall-clock time every frame
+ *               took, in milliseconds
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   If the application is quit before all steps were run, the function returns
+ *         early and the remaining elements of \c frameTimes are left untouched.
+ *
+ * \par Remarks
+ *   Unlike <tt>NkApplicationRun()</tt>, this function does not pace frames and does not
+ *   look at the wall clock to decide how many fixed steps to run. Instead, every frame
+ *   runs one fixed step, one variable update of the length of a fixed step, and renders
+ *   with an interpolation factor of zero. The simulated time advances by exactly one
+ *   fixed step per frame, so that the same input (see <tt>NkIInput::InjectRecord()</tt>
+ *   and <tt>NkApplicationSetStepCallback()</tt>) always produces the same simulation, no
+ *   matter how fast the frames are actually processed. This is used to replay recorded
+ *   sessions and to benchmark frames.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkApplicationRunSteps(
+    _In_                  NkUint32 nSteps,
+    _O_array_opt_(nSteps) NkDouble *frameTimes
+);
 /**
  * \brief quits the application at the next possible time
  * \param [in] errCode return code to propagate to the host platform
@@ -98,6 +149,37 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkApplicationRun(NkVoid);
  *   is returned to the host platform.
  */
 NK_NATIVE NK_API NkVoid NK_CALL NkApplicationExit(_Ecode_range_ NkErrorCode errCode);
+/**
+ * \brief requests that the next iteration of the main loop renders a frame
+ * \note  \li This function can be called from any thread.
+ * \note  \li If the application does not render on-demand (see
+ *             <tt>NkApplicationSpecification::m_isOnDemand</tt>), this function does
+ *             nothing as every iteration renders a frame anyway. Events dispatched to the
+ *             layer stack implicitly request a redraw.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkApplicationRequestRedraw(NkVoid);
+/**
+ * \brief  retrieves the point in time the fixed step that is currently being run
+ *         simulates up to
+ * \return point in time, in timer ticks, or \c 0 if no fixed step has been run yet
+ * \note   This function is meant to be called from within
+ *         <tt>NkILayer::OnFixedUpdate()</tt>. Input that happened before the returned
+ *         point in time belongs to the current step (see
+ *         <tt>NkIInput::ReadBufferedInput()</tt>).
+ */
+NK_NATIVE NK_API NkUint64 NK_CALL NkApplicationQueryFixedStepTime(NkVoid);
+/**
+ * \brief installs a callback that is invoked by the main loop right before every fixed
+ *        step
+ * \param [in] fnStep callback function; pass \c NULL to remove the current callback
+ * \param [in,out] cxtPtr context pointer passed to every invocation of the callback
+ * \note  \li The callback is invoked on the main thread by both <tt>NkApplicationRun()</tt>
+ *             and <tt>NkApplicationRunSteps()</tt>. It replaces any previously-installed
+ *             callback.
+ * \note  \li Input injected from within the callback with a timestamp equal to \c stepTime
+ *             is consumed by the step that is about to be run.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkApplicationSetStepCallback(_In_opt_ NkApplicationStepCallback fnStep, _Inout_opt_ NkVoid *cxtPtr);
 
 /**
  * \brief  retrieves the application specification, that is, the application settings
@@ -0,0 +1,264 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  pack.h
+ * \brief defines the public API for packed asset archives, that is, single files that
+ *        hold the data of many assets
+ *
+ * Opening thousands of small files is slow, especially on hard disk drives. A pack
+ * archive stores the data of any number of assets (called blobs) in a single file that
+ * is memory-mapped as a whole when it is opened. Blobs are identified by the UUID of the
+ * asset they belong to; uncompressed blobs can be accessed in place, without copying.
+ *
+ * The archive layout is as follows (all integers are little-endian):
+ * \code
+ *  +-------------------+ 0
+ *  | NkPackHeader      |
+ *  +-------------------+ NK_PACK_ALIGNMENT
+ *  | blob 0            |
+ *  | (padding)         |
+ *  | blob 1            |
+ *  | ...               |
+ *  +-------------------+ NkPackHeader::m_tocOffset
+ *  | NkPackEntry[]     | sorted by UUID
+ *  +-------------------+
+ * \endcode
+ * Every blob starts at a multiple of \c NK_PACK_ALIGNMENT bytes. Compressed blobs use a
+ * byte-oriented LZ77 variant which favors decompression speed over ratio.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
+
+
+/**
+ * \def   NK_PACK_MAGIC
+ * \brief magic number at the start of every pack archive ('NKPK')
+ */
+#define NK_PACK_MAGIC     ((NkUint32)(0x4b504b4e))
+/**
+ * \def   NK_PACK_VERSION
+ * \brief current version of the archive format
+ */
+#define NK_PACK_VERSION   ((NkUint32)(1))
+/**
+ * \def   NK_PACK_ALIGNMENT
+ * \brief alignment of the blobs inside the archive, in bytes
+ */
+#define NK_PACK_ALIGNMENT ((NkUint64)(64))
+/**
+ * \def   NK_PACK_TEXMAGIC
+ * \brief magic number at the start of every cooked texture blob ('NKTX')
+ */
+#define NK_PACK_TEXMAGIC  ((NkUint32)(0x58544b4e))
+
+
+/**
+ * \enum  NkPackEntryFlags
+ * \brief flags describing how a blob is stored
+ */
+NK_NATIVE typedef enum NkPackEntryFlags {
+    NkPackEnt_None       = 0,      /**< blob is stored as-is */
+    NkPackEnt_Compressed = 1 << 0, /**< blob is compressed */
+} NkPackEntryFlags;
+
+/**
+ * \enum  NkPackTextureFlags
+ * \brief flags describing the pixels of a cooked texture blob
+ */
+NK_NATIVE typedef enum NkPackTextureFlags {
+    NkPackTex_None          = 0,      /**< texture is opaque */
+    NkPackTex_Masked        = 1 << 0, /**< texture has a transparency mask */
+    NkPackTex_Premultiplied = 1 << 1, /**< color channels are premultiplied with alpha */
+} NkPackTextureFlags;
+
+/**
+ * \struct NkPackHeader
+ * \brief  represents the header at the start of a pack archive
+ */
+NK_NATIVE typedef struct NkPackHeader {
+    NkUint32 m_magicNum;  /**< must be \c NK_PACK_MAGIC */
+    NkUint32 m_formatVer; /**< must be \c NK_PACK_VERSION */
+    NkUint32 m_nEntries;  /**< number of entries in the table of contents */
+    NkUint32 m_reserved;  /**< reserved; must be zero */
+    NkUint64 m_tocOffset; /**< offset of the table of contents, in bytes */
+    NkUint64 m_fileSize;  /**< size of the entire archive, in bytes */
+} NkPackHeader;
+
+/**
+ * \struct NkPackEntry
+ * \brief  represents an entry of the table of contents
+ */
+NK_NATIVE typedef struct NkPackEntry {
+    NkUuid   m_assetUuid;  /**< UUID of the asset the blob belongs to */
+    NkUint64 m_dataOffset; /**< offset of the blob, in bytes */
+    NkUint64 m_storedSize; /**< size of the blob inside the archive, in bytes */
+    NkUint64 m_rawSize;    /**< size of the blob after decompression, in bytes */
+    NkUint32 m_entryFlags; /**< combination of \c NkPackEntryFlags values */
+    NkUint32 m_reserved;   /**< reserved; must be zero */
+} NkPackEntry;
+
+/**
+ * \struct NkPackTextureHeader
+ * \brief  represents the header at the start of a cooked texture blob
+ *
+ * Texture blobs are written by the asset cooker. The pixels are stored top-down as
+ * \c B, \c G, \c R, \c A bytes, which is the format of the renderer's back-buffer, so
+ * they can be uploaded without any conversion. Transparent pixels have an alpha value of
+ * zero. If the texture is masked, an 8-bit mask with \c 0x00 for transparent and \c 0xFF
+ * for opaque pixels follows, one byte per pixel and without any row padding. Both arrays
+ * start at a multiple of \c NK_PACK_ALIGNMENT bytes relative to the start of the blob.
+ */
+NK_NATIVE typedef struct NkPackTextureHeader {
+    NkUint32 m_magicNum;   /**< must be \c NK_PACK_TEXMAGIC */
+    NkUint32 m_texFlags;   /**< combination of \c NkPackTextureFlags values */
+    NkUint32 m_texWidth;   /**< width of the texture, in pixels */
+    NkUint32 m_texHeight;  /**< height of the texture, in pixels */
+    NkUint32 m_texStride;  /**< size of a row of pixels, in bytes */
+    NkUint32 m_keyColor;   /**< key color the mask was built from, as \c 0x00RRGGBB */
+    NkUint64 m_pxOffset;   /**< offset of the pixel array, in bytes */
+    NkUint64 m_maskOffset; /**< offset of the mask, in bytes, or \c 0 if not masked */
+} NkPackTextureHeader;
+
+/**
+ * \struct NkPackArchive
+ * \brief  forward-declaration of the opaque type of an opened pack archive
+ */
+NK_NATIVE typedef struct NkPackArchive NkPackArchive;
+/**
+ * \struct NkPackWriter
+ * \brief  forward-declaration of the opaque type of a pack archive that is being built
+ */
+NK_NATIVE typedef struct NkPackWriter NkPackWriter;
+
+
+/**
+ * \brief  opens a pack archive and maps it into memory
+ * \param  [in] filePath path of the archive
+ * \param  [out] archPtr pointer to a variable that will receive the pointer to the
+ *               opened archive
+ * \return \c NkErr_Ok on success, \c NkErr_UnsupportedFileFormat if the file is not a
+ *         pack archive of the current version, \c NkErr_CorruptedData if the table of
+ *         contents is inconsistent, or another non-zero value on failure
+ * \note   The table of contents is validated once when the archive is opened; afterwards,
+ *         all entries can be accessed without further checks.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPackArchiveOpen(
+    _In_z_     char const *filePath,
+    _Init_ptr_ NkPackArchive **archPtr
+);
+/**
+ * \brief   closes a pack archive
+ * \param   [in, out] archPtr pointer to a variable holding the pointer to the archive
+ *                    that is to be closed
+ * \note    <tt>*archPtr</tt> will be set to <tt>NULL</tt>. If <tt>*archPtr</tt> is
+ *          already <tt>NULL</tt>, the function does nothing.
+ * \warning All buffer views that were obtained from the archive become invalid.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPackArchiveClose(_Uninit_ptr_ NkPackArchive **archPtr);
+/**
+ * \brief  retrieves the table of contents entry of a blob
+ * \param  [in] archPtr pointer to the archive
+ * \param  [in] assetId UUID of the asset the blob belongs to
+ * \return pointer to the entry, or \c NULL if the archive does not contain such a blob
+ * \note   The lookup is a binary search over the memory-mapped table of contents.
+ */
+NK_NATIVE NK_API NkPackEntry const *NK_CALL NkPackArchiveFindEntry(
+    _In_ NkPackArchive const *archPtr,
+    _In_ NkUuid const *assetId
+);
+/**
+ * \brief  retrieves a view of a blob as it is stored inside the archive
+ * \param  [in] archPtr pointer to the archive
+ * \param  [in] entryPtr entry of the blob, as returned by
+ *              <tt>NkPackArchiveFindEntry()</tt>
+ * \return view of the stored bytes; valid for as long as the archive is open
+ * \note   \li No data is copied. If the blob is compressed, the view refers to the
+ *              compressed bytes; use <tt>NkPackArchiveReadBlob()</tt> to decompress them.
+ * \note   \li The view is read-only even though its pointer is not \c const qualified.
+ */
+NK_NATIVE NK_API NkBufferView NK_CALL NkPackArchiveMapBlob(
+    _In_ NkPackArchive const *archPtr,
+    _In_ NkPackEntry const *entryPtr
+);
+/**
+ * \brief  copies a blob into a buffer, decompressing it if necessary
+ * \param  [in] archPtr pointer to the archive
+ * \param  [in] entryPtr entry of the blob, as returned by
+ *              <tt>NkPackArchiveFindEntry()</tt>
+ * \param  [out] bufPtr buffer that receives the blob; must be at least
+ *               <tt>entryPtr->m_rawSize</tt> bytes large
+ * \return \c NkErr_Ok on success, \c NkErr_CorruptedData if the compressed data is
+ *         malformed
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPackArchiveReadBlob(
+    _In_  NkPackArchive const *archPtr,
+    _In_  NkPackEntry const *entryPtr,
+    _Out_ NkByte *bufPtr
+);
+/**
+ * \brief  retrieves the number of blobs in the archive
+ * \param  [in] archPtr pointer to the archive
+ * \return number of entries in the table of contents
+ */
+NK_NATIVE NK_API NkSize NK_CALL NkPackArchiveQueryEntryCount(_In_ NkPackArchive const *archPtr);
+
+/**
+ * \brief  creates a new, empty archive writer
+ * \param  [out] writerPtr pointer to a variable that will receive the pointer to the
+ *               writer
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPackWriterCreate(_Init_ptr_ NkPackWriter **writerPtr);
+/**
+ * \brief destroys an archive writer
+ * \param [in, out] writerPtr pointer to a variable holding the pointer to the writer
+ * \note  <tt>*writerPtr</tt> will be set to <tt>NULL</tt>. If <tt>*writerPtr</tt> is
+ *        already <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPackWriterDestroy(_Uninit_ptr_ NkPackWriter **writerPtr);
+/**
+ * \brief  adds a blob to the archive that is being built
+ * \param  [in, out] writerPtr pointer to the writer
+ * \param  [in] assetId UUID of the asset the blob belongs to
+ * \param  [in] dataBuf data of the blob; it is copied
+ * \param  [in] isCompress whether the blob is to be compressed
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   If compressing does not make the blob smaller, it is stored uncompressed.
+ *         Blobs that are to be accessed in place, for example through
+ *         <tt>NkPackArchiveMapBlob()</tt>, should not be compressed.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPackWriterAddBlob(
+    _Inout_ NkPackWriter *writerPtr,
+    _In_    NkUuid const *assetId,
+    _In_    NkBufferView dataBuf,
+    _In_    NkBoolean isCompress
+);
+/**
+ * \brief  writes all added blobs to an archive file
+ * \param  [in, out] writerPtr pointer to the writer
+ * \param  [in] filePath path of the archive; an existing file is overwritten
+ * \return \c NkErr_Ok on success, \c NkErr_ObjectState if multiple blobs were added for
+ *         the same UUID, or another non-zero value on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPackWriterSave(
+    _Inout_ NkPackWriter *writerPtr,
+    _In_z_  char const *filePath
+);
+
+
@@ -0,0 +1,168 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  pathfind.h
+ * \brief defines the public API for the pathfinding service
+ *
+ * The pathfinding service finds paths across the tile grid of a chunk streamer. When a
+ * search is requested, the collision bits of a bounded window around start and goal are
+ * copied from the streamer; the search itself then runs as a job on a worker thread and
+ * never touches the streamer again. Two kinds of searches are offered: A* finds a single
+ * path from a start tile to a goal tile, and a flow field stores, for every tile of the
+ * window around a goal, the direction of the next step towards the goal, which serves
+ * any number of agents heading for the same goal with a single search.
+ * Results are shared and cached. Path requests whose start lies in the same chunk and on
+ * a previously found path to the same goal reuse that path instead of searching again.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/chunk.h>
+
+
+/**
+ * \struct NkPathService
+ * \brief  forward-declaration of opaque pathfinding service type
+ */
+NK_NATIVE typedef struct NkPathService NkPathService;
+/**
+ * \struct NkPathResult
+ * \brief  forward-declaration of opaque, reference-counted search result type
+ */
+NK_NATIVE typedef struct NkPathResult NkPathResult;
+
+/**
+ * \enum  NkPathStatus
+ * \brief lists the states of a search result
+ */
+NK_NATIVE typedef enum NkPathStatus {
+    NkPathSt_Pending,  /**< the search is still running */
+    NkPathSt_Found,    /**< the goal was reached */
+    NkPathSt_NotFound  /**< the goal cannot be reached within the search window */
+} NkPathStatus;
+
+/**
+ * \struct NkPathServiceSpecification
+ * \brief  holds configuration properties for the pathfinding service
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkPathServiceSpecification {
+    NkSize           m_structSize;  /**< size of this structure, in bytes */
+    NkChunkStreamer *mp_chunkStr;   /**< chunk streamer providing the collision bits */
+    NkUint32         m_maxExt;      /**< maximum edge length of a search window, in tiles */
+    NkUint32         m_nCacheSlots; /**< number of cached results; must be a power of two */
+} NkPathServiceSpecification;
+
+
+/**
+ * \brief  creates a new pathfinding service
+ * \param  [in] svcSpec pointer to the specification of the service
+ * \param  [out] svcPtr pointer to a variable that will receive the pointer to the
+ *               newly-created service
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The chunk streamer must outlive the service.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPathServiceCreate(
+    _In_       NkPathServiceSpecification const *svcSpec,
+    _Init_ptr_ NkPathService **svcPtr
+);
+/**
+ * \brief destroys the given pathfinding service, waiting for all running searches
+ * \param [in, out] svcPtr pointer to a variable holding the pointer to the service that
+ *                  is to be destroyed
+ * \note  Results that are still referenced stay valid and must be released as usual.
+ *        <tt>*svcPtr</tt> will be set to <tt>NULL</tt>. If <tt>*svcPtr</tt> is already
+ *        <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPathServiceDestroy(_Uninit_ptr_ NkPathService **svcPtr);
+/**
+ * \brief drops all cached results
+ * \param [in, out] svcPtr pointer to the pathfinding service
+ * \note  Call this whenever the collision state of the world changes, for example when a
+ *        chunk has been loaded. Results that are still referenced are not affected.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPathServiceInvalidate(_Inout_ NkPathService *svcPtr);
+/**
+ * \brief  requests a path from one tile to another
+ * \param  [in, out] svcPtr pointer to the pathfinding service
+ * \param  [in] startPos tile the path starts at, in tiles, in world space
+ * \param  [in] goalPos tile the path ends at, in tiles, in world space
+ * \param  [out] resPtr pointer to a variable that receives a new reference to the result
+ * \param  [out] firstIndPtr (optional) pointer to a variable that receives the index of
+ *               \c startPos in the tiles of the path; this is only non-zero if a cached
+ *               path that passes through \c startPos was returned
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   This function never blocks on the search; poll the result with
+ *         <tt>NkPathResultGetStatus()</tt>. It must be called from the thread that
+ *         updates the chunk streamer.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPathFind(
+    _Inout_   NkPathService *svcPtr,
+    _In_      NkPoint2D startPos,
+    _In_      NkPoint2D goalPos,
+    _Outptr_  NkPathResult **resPtr,
+    _Out_opt_ NkUint32 *firstIndPtr
+);
+/**
+ * \brief  requests a flow field towards a goal tile
+ * \param  [in, out] svcPtr pointer to the pathfinding service
+ * \param  [in] goalPos tile all agents are heading for, in tiles, in world space
+ * \param  [out] resPtr pointer to a variable that receives a new reference to the result
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The flow field covers a square window of <tt>m_maxExt</tt> tiles centered on
+ *         the goal. This function must be called from the thread that updates the chunk
+ *         streamer.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkPathFindFlowField(
+    _Inout_  NkPathService *svcPtr,
+    _In_     NkPoint2D goalPos,
+    _Outptr_ NkPathResult **resPtr
+);
+
+/**
+ * \brief  retrieves the state of a search result
+ * \param  [in] resPtr pointer to the result
+ * \return current state of the search
+ * \note   This function can be called from any thread.
+ */
+NK_NATIVE NK_API NkPathStatus NK_CALL NkPathResultGetStatus(_In_ NkPathResult const *resPtr);
+/**
+ * \brief  retrieves the tiles of a path
+ * \param  [in] resPtr pointer to a result returned by <tt>NkPathFind()</tt>
+ * \param  [out] nTilesPtr pointer to a variable that receives the number of tiles
+ * \return pointer to the tiles of the path, from start to goal, both inclusive; \c NULL
+ *         if the status of the result is not <tt>NkPathSt_Found</tt>
+ */
+NK_NATIVE NK_API NkPoint2D const *NK_CALL NkPathResultGetTiles(_In_ NkPathResult const *resPtr, _Out_ NkUint32 *nTilesPtr);
+/**
+ * \brief  retrieves the direction of the next step from a tile of a flow field
+ * \param  [in] resPtr pointer to a result returned by <tt>NkPathFindFlowField()</tt>
+ * \param  [in] tilePos current tile of the agent, in tiles, in world space
+ * \return offset of the next tile on a shortest path to the goal; <tt>(0, 0)</tt> if
+ *         \c tilePos is the goal, cannot reach the goal, lies outside of the window, or
+ *         if the search has not finished
+ */
+NK_NATIVE NK_API NkPoint2D NK_CALL NkPathResultGetFlowDir(_In_ NkPathResult const *resPtr, _In_ NkPoint2D tilePos);
+/**
+ * \brief releases a reference to a search result
+ * \param [in, out] resPtr pointer to a variable holding the pointer to the result
+ * \note  <tt>*resPtr</tt> will be set to <tt>NULL</tt>. If <tt>*resPtr</tt> is already
+ *        <tt>NULL</tt>, the function does nothing. This function can be called from any
+ *        thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPathResultRelease(_Uninit_ptr_ NkPathResult **resPtr);
+
+
@@ -0,0 +1,176 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  pixel.h
+ * \brief defines the public API for bulk pixel operations
+ *
+ * The functions in this module operate on spans of pixels, typically one bitmap row at a
+ * time. Each operation has a scalar, an SSE2 and an AVX2 implementation; the fastest one
+ * supported by the processor is selected once at run-time.
+ *
+ * 32-bit pixels are stored as \c B, \c G, \c R, \c A bytes (in this order), which is the
+ * memory layout of 32-bit DIBs and of \c DXGI_FORMAT_B8G8R8A8_UNORM. Read as a
+ * little-endian integer, such a pixel is \c 0xAARRGGBB. 24-bit pixels are \c B, \c G,
+ * \c R bytes. None of the buffers have to be aligned.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+
+
+/**
+ * \enum  NkPixelSimdLevel
+ * \brief instruction set extensions the pixel operations can use
+ */
+NK_NATIVE typedef enum NkPixelSimdLevel {
+    NkPxSimd_Scalar, /**< plain C */
+    NkPxSimd_SSE2,   /**< 128-bit SSE2 */
+    NkPxSimd_AVX2,   /**< 256-bit AVX2 */
+
+    __NkPxSimd_Count__
+} NkPixelSimdLevel;
+
+
+/**
+ * \brief  retrieves the instruction set extension used by the pixel operations
+ * \return the level that was selected for the current processor
+ */
+NK_NATIVE NK_API NkPixelSimdLevel NK_CALL NkPixelQuerySimdLevel(NkVoid);
+
+/**
+ * \brief fills a span of 32-bit pixels with the same value
+ * \param [out] dstPtr destination pixels
+ * \param [in] nPx number of pixels
+ * \param [in] pxVal pixel value, as \c 0xAARRGGBB
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelFill32(_O_bytes_(nPx * 4) NkVoid *dstPtr, _In_ NkSize nPx, _In_ NkUint32 pxVal);
+/**
+ * \brief converts 24-bit pixels to 32-bit pixels
+ * \param [out] dstPtr destination pixels
+ * \param [in] srcPtr source pixels
+ * \param [in] nPx number of pixels
+ * \param [in] alphaVal alpha value written to all destination pixels
+ * \note  The buffers must not overlap.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelConvert24To32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 3) NkVoid const *srcPtr,
+    _In_                NkSize nPx,
+    _In_               NkByte alphaVal
+);
+/**
+ * \brief converts 32-bit pixels to 24-bit pixels, dropping the alpha channel
+ * \param [out] dstPtr destination pixels
+ * \param [in] srcPtr source pixels
+ * \param [in] nPx number of pixels
+ * \note  The buffers must not overlap.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelConvert32To24(
+    _O_bytes_(nPx * 3) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_                NkSize nPx
+);
+/**
+ * \brief copies 32-bit pixels, replacing their alpha channel
+ * \param [out] dstPtr destination pixels
+ * \param [in] srcPtr source pixels; may be equal to \c dstPtr
+ * \param [in] nPx number of pixels
+ * \param [in] alphaVal new alpha value
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelSetAlpha32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_                NkSize nPx,
+    _In_               NkByte alphaVal
+);
+/**
+ * \brief multiplies the color channels of 32-bit pixels with their alpha channel
+ * \param [out] dstPtr destination pixels
+ * \param [in] srcPtr source pixels; may be equal to \c dstPtr
+ * \param [in] nPx number of pixels
+ * \note  The result is rounded to the nearest integer; the alpha channel is kept as-is.
+ *        Premultiplied pixels are what <tt>AlphaBlend()</tt> expects with
+ *        \c AC_SRC_ALPHA.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelPremultiply32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_                NkSize nPx
+);
+/**
+ * \brief builds an 8-bit mask from 32-bit pixels and a key color
+ * \param [out] dstPtr destination mask; receives \c 0x00 for every pixel that matches the
+ *              key color and \c 0xFF for all other pixels
+ * \param [in] srcPtr source pixels
+ * \param [in] nPx number of pixels
+ * \param [in] keyPx key color as \c 0x00RRGGBB; the alpha channel is ignored
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelColorKeyMask32(
+    _O_bytes_(nPx)     NkByte *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_                NkSize nPx,
+    _In_               NkUint32 keyPx
+);
+
+
+/**
+ * \brief halves a pair of rows of 32-bit pixels using a 2x2 box filter
+ * \param [out] dstPtr destination pixels
+ * \param [in] fSrcPtr first source row; must hold at least <tt>nPx * 2</tt> pixels
+ * \param [in] sSrcPtr second source row; must hold at least <tt>nPx * 2</tt> pixels
+ * \param [in] nPx number of destination pixels
+ * \note  Every channel of destination pixel \c i, including alpha, becomes the rounded
+ *        average of the same channel of source pixels <tt>2i</tt> and <tt>2i + 1</tt> of
+ *        both rows.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelDownsample32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 8) NkVoid const *fSrcPtr,
+    _I_bytes_(nPx * 8) NkVoid const *sSrcPtr,
+    _In_               NkSize nPx
+);
+
+
+/**
+ * \brief copies 32-bit pixels wherever an 8-bit mask is set
+ * \param [in, out] dstPtr destination pixels
+ * \param [in] srcPtr source pixels
+ * \param [in] maskPtr mask; destination pixels whose mask byte is \c 0x00 are left as-is,
+ *             all others are replaced by the source pixel
+ * \param [in] nPx number of pixels
+ * \note  Masks created by <tt>NkPixelColorKeyMask32()</tt> can be passed directly.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelMaskCopy32(
+    _IO_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4)  NkVoid const *srcPtr,
+    _I_bytes_(nPx)      NkByte const *maskPtr,
+    _In_                NkSize nPx
+);
+/**
+ * \brief blends premultiplied 32-bit pixels onto 32-bit pixels
+ * \param [in, out] dstPtr destination pixels
+ * \param [in] srcPtr premultiplied source pixels
+ * \param [in] nPx number of pixels
+ * \note  Every channel of the destination, including alpha, becomes
+ *        <tt>src + dst * (255 - srcAlpha) / 255</tt>, rounded to the nearest integer.
+ *        This is the operation <tt>AlphaBlend()</tt> performs with \c AC_SRC_ALPHA.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkPixelBlendPremul32(
+    _IO_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4)  NkVoid const *srcPtr,
+    _In_                NkSize nPx
+);
@@ -43,12 +43,19 @@
     #define NK_DISABLE_WARNING(w, ...) \
             __pragma(warning (push)) __pragma(warning (disable: w)) __VA_ARGS__ __pragma(warning (pop))
 
+    /**
+     * \def   NK_THREADLOCAL
+     * \brief marks a variable with static storage duration as thread-local
+     */
+    #define NK_THREADLOCAL __declspec(thread)
+
     /* platform-dependent warning identifiers */
     #define NK_WARN_DIFFERENT_CONST_QUALIFIERS 4090
 #else
     #error Currently, Noriko only supports compilation via MSVC.
 
     #define NK_DISABLE_WARNING(w, ...) __VA_ARGS__
+    #define NK_THREADLOCAL             _Thread_local
 
     #define NK_WARN_DIFFERENT_CONST_QUALIFIERS
 #endif
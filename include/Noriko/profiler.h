@@ -0,0 +1,213 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  profiler.h
+ * \brief defines the public API for Noriko's built-in hierarchical CPU profiler
+ *
+ * The profiler measures named zones of code. Zones can be nested; a zone that is entered
+ * while another zone is active on the same thread becomes its child, so the same name
+ * can appear at multiple places of the zone tree. Every thread records the zones it
+ * leaves into its own ring buffer, so recording never contends with other threads.
+ * Once per frame, the records are collected and aggregated into per-zone statistics:
+ * the time spent in every zone during a frame, as well as the minimum, average and
+ * maximum thereof over all frames the zone was entered in.
+ *
+ * For a timeline view, a number of frames can be captured to a file. During a capture,
+ * every single zone, instant events such as dispatched input events, and the number of
+ * allocations per frame are recorded. When the capture ends, the recording is written in
+ * the Chrome trace-event JSON format which can be viewed in \c chrome://tracing or
+ * Perfetto (https://ui.perfetto.dev).
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/util.h>
+
+
+/**
+ * \def   NK_PROFILE_MAXZONES
+ * \brief maximum number of distinct zones (that is, nodes in the zone tree)
+ * \note  Zones that are entered after this limit has been reached are not recorded.
+ */
+#define NK_PROFILE_MAXZONES ((NkUint32)(256))
+/**
+ * \def   NK_PROFILE_MAXDEPTH
+ * \brief maximum nesting depth of zones
+ * \note  Zones nested deeper than this are not recorded.
+ */
+#define NK_PROFILE_MAXDEPTH ((NkUint32)(32))
+
+
+/*
+ * Profiling is compiled in unless explicitly disabled, so that timings can also be
+ * gathered from deploy builds.
+ */
+#if (!defined NK_CONFIG_NOPROFILE)
+    /** \cond INTERNAL */
+    #define __NK_PROFILE_CONCAT2(x, y) x##y
+    #define __NK_PROFILE_CONCAT(x, y)  __NK_PROFILE_CONCAT2(x, y)
+    /** \endcond */
+
+    /**
+     * \def   NK_PROFILE_BEGIN(name)
+     * \brief enters the zone with the given name on the calling thread
+     * \param name name of the zone; must be a string literal or otherwise outlive the
+     *             profiler
+     */
+    #define NK_PROFILE_BEGIN(name) NkProfileBeginZone(name)
+    /**
+     * \def   NK_PROFILE_END()
+     * \brief leaves the zone the calling thread entered last
+     */
+    #define NK_PROFILE_END()       NkProfileEndZone()
+    /**
+     * \def   NK_PROFILE_INSTANT(name)
+     * \brief records an instant event with the given name on the calling thread
+     * \param name name of the event; must be a string literal or otherwise outlive the
+     *             profiler
+     * \note  Instant events are only recorded while a capture is running.
+     */
+    #define NK_PROFILE_INSTANT(name) NkProfileMarkInstant(name)
+    /**
+     * \def   NK_PROFILE_SCOPE(name)
+     * \brief measures the statement or block that follows the macro as the zone with the
+     *        given name
+     * \param name name of the zone; must be a string literal or otherwise outlive the
+     *             profiler
+     *
+     * \par Remarks
+     *   Use like a loop header, for example:
+     *   \code
+     *   NK_PROFILE_SCOPE("Update") {
+     *       ...
+     *   }
+     *   \endcode
+     *   Do not leave the block via \c return, \c break or \c goto; the zone would not be
+     *   left. Use <tt>NK_PROFILE_BEGIN()</tt>/<tt>NK_PROFILE_END()</tt> in that case.
+     */
+    #define NK_PROFILE_SCOPE(name)                                                      \
+        for (NkBoolean __NK_PROFILE_CONCAT(__nk_prof_, __LINE__) = (NkProfileBeginZone(name), NK_TRUE); \
+             __NK_PROFILE_CONCAT(__nk_prof_, __LINE__);                                 \
+             __NK_PROFILE_CONCAT(__nk_prof_, __LINE__) = (NkProfileEndZone(), NK_FALSE)  \
+        )
+#else
+    #define NK_PROFILE_BEGIN(name)   ((NkVoid)0)
+    #define NK_PROFILE_END()         ((NkVoid)0)
+    #define NK_PROFILE_INSTANT(name) ((NkVoid)0)
+    #define NK_PROFILE_SCOPE(name)
+#endif
+
+
+/**
+ * \struct NkProfileZoneStats
+ * \brief  represents the aggregated statistics of a single zone
+ * \note   All times are given in milliseconds and refer to the time spent in the zone,
+ *         including its children, summed up over a frame.
+ */
+NK_NATIVE typedef struct NkProfileZoneStats {
+    char const *mp_zoneName; /**< name of the zone */
+    NkInt32     m_parentInd; /**< index of the parent zone, or \c -1 for top-level zones */
+    NkUint32    m_zoneDepth; /**< nesting depth of the zone (0 for top-level zones) */
+    NkUint32    m_nCalls;    /**< number of times the zone was entered last frame */
+    NkUint64    m_nFrames;   /**< number of frames the zone was entered in */
+    NkDouble    m_lastTime;  /**< time spent in the zone last frame */
+    NkDouble    m_minTime;   /**< minimum time spent in the zone per frame */
+    NkDouble    m_avgTime;   /**< average time spent in the zone per frame */
+    NkDouble    m_maxTime;   /**< maximum time spent in the zone per frame */
+} NkProfileZoneStats;
+
+
+/**
+ * \brief enters the zone with the given name on the calling thread
+ * \param [in] zoneName name of the zone; must outlive the profiler
+ * \note  \li This function can be called from any thread.
+ * \note  \li Prefer the <tt>NK_PROFILE_*</tt> macros which can be compiled out.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkProfileBeginZone(_In_z_ char const *zoneName);
+/**
+ * \brief leaves the zone the calling thread entered last
+ * \note  Every call to <tt>NkProfileBeginZone()</tt> must be balanced by a call to this
+ *        function on the same thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkProfileEndZone(NkVoid);
+/**
+ * \brief marks the boundary between two frames
+ * \note  This function is called by the main loop; it must only be called from the main
+ *        thread. All zones that were left since the last call are attributed to the
+ *        frame that ends.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkProfileMarkFrame(NkVoid);
+/**
+ * \brief  retrieves the statistics of all zones that have been recorded so far
+ * \param  [out] statArr array that receives the statistics
+ * \param  [in] maxZones maximum number of zones to retrieve
+ * \return number of zones written to \c statArr
+ * \note   \li This function must only be called from the main thread.
+ * \note   \li Zones are listed in the order they were first entered; a zone's parent
+ *              is always listed before the zone.
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkProfileQueryZones(_O_array_(maxZones) NkProfileZoneStats *statArr, _In_ NkUint32 maxZones);
+/**
+ * \brief resets the statistics of all zones
+ * \note  This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkProfileReset(NkVoid);
+/**
+ * \brief prints the statistics of all zones to the log, indented by zone depth
+ * \note  This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkProfileDumpReport(NkVoid);
+
+/**
+ * \brief  starts capturing the given number of frames to a file
+ * \param  [in] filePath path of the file the capture is written to; an existing file is
+ *              overwritten
+ * \param  [in] nFrames number of frames to capture
+ * \return \c NkErr_Ok on success, \c NkErr_NoOperation if a capture is already running,
+ *         or another non-zero value on failure
+ *
+ * \par Remarks
+ *   The capture begins with the next frame. Once \c nFrames frames have been recorded,
+ *   the capture is written to \c filePath in the Chrome trace-event JSON format from
+ *   within <tt>NkProfileMarkFrame()</tt>. Captures can also be started on start-up using
+ *   the \c --profcapture=<frames> option, or by pressing F7 in the world layer.
+ * \note   This function must only be called from the main thread.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkProfileBeginCapture(_In_z_ char const *filePath, _In_ NkUint32 nFrames);
+/**
+ * \brief  checks whether a capture is pending or running
+ * \return \c NK_TRUE if frames are being captured, \c NK_FALSE if not
+ */
+NK_NATIVE NK_API NkBoolean NK_CALL NkProfileIsCapturing(NkVoid);
+/**
+ * \brief records an instant event with the given name on the calling thread
+ * \param [in] instName name of the event; must outlive the profiler
+ * \note  \li This function can be called from any thread.
+ * \note  \li Instant events are only recorded while a capture is running.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkProfileMarkInstant(_In_z_ char const *instName);
+/**
+ * \brief counts an allocation made by the calling thread
+ * \param [in] nBytes size of the allocation, in bytes
+ * \note  \li This function is called by the allocators; it does not need to be called
+ *              manually.
+ * \note  \li Allocations are only counted while a capture is running, and only on
+ *              threads that have entered a zone before.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkProfileCountAllocation(_In_ NkSize nBytes);
+
+
@@ -44,6 +44,9 @@ NK_NATIVE typedef enum NkRendererApi {
     NkRdApi_Default,     /**< default renderer for current platform */
 
     NkRdApi_Win32GDI,    /**< GDI renderer */
+    NkRdApi_Direct3D11,  /**< Direct3D 11 renderer */
+    NkRdApi_Null,        /**< headless renderer that does not present anything (see <tt>NkINullRenderer</tt>) */
+    NkRdApi_Win32Soft,   /**< GDI renderer rasterizing in software (see <tt>NkIGdiRenderer</tt>) */
 
     __NkRdApi_Count__    /**< *only used internally* */
 } NkRendererApi;
@@ -53,12 +56,14 @@ NK_NATIVE typedef enum NkRendererApi {
  * \brief represents a renderer resource type
  */
 NK_NATIVE typedef enum NkRendererResourceType {
-    NkRdResTy_None = 0,    /**< invalid resource type */
+    NkRdResTy_None = 0,     /**< invalid resource type */
     
-    NkRdResTy_Texture,     /**< texture */
-    NkRdResTy_TextureMask, /**< monochrome texture mask */
+    NkRdResTy_Texture,      /**< texture */
+    NkRdResTy_TextureMask,  /**< monochrome texture mask */
+    NkRdResTy_Surface,      /**< off-screen surface that can be rendered to and drawn as a texture */
+    NkRdResTy_AlphaTexture, /**< texture with premultiplied per-pixel alpha */
 
-    __NkRdResTy_Count__    /**< *only used internally* */
+    __NkRdResTy_Count__     /**< *only used internally* */
 } NkRendererResourceType;
 
 /**
@@ -136,7 +141,9 @@ NK_NATIVE typedef struct NkRendererResource {
     struct NkIRenderer              *mp_rdRef;    /**< reference to the renderer that created the resource */
            NkRendererResourceType    m_resType;   /**< numeric type ID of the resource */
            NkRendererResourceHandle  m_resHandle; /**< implementation-defined resource handle (don't touch!) */
+           NkRendererResourceHandle  m_auxHandle; /**< implementation-defined auxiliary data, such as the mip chain of a texture (don't touch!) */
            NkRendererResourceFlags   m_resFlags;  /**< miscellaneous resource flags */
+           NkSize2D                  m_resDim;    /**< dimensions of the resource, in pixels */
 } NkRendererResource;
 
 /**
@@ -174,8 +181,35 @@ NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkRendererSpecificati
     NkViewportAlignment         m_vpAlignment;  /**< viewport alignment in client area of window */
     NkRgbaColor                 m_clearCol;     /**< clear color to use for background */
     NkTextureInterpolationMode  m_texInterMode; /**< texture interpolation mode */
+    NkBoolean                   m_isMipmapped;  /**< whether textures get precomputed downscaled levels for scaled draws */
 } NkRendererSpecification;
 
+/**
+ * \struct NkRendererFrameStatistics
+ * \brief  represents what the renderer did during a single frame
+ *
+ * The counters cover all draw calls issued between <tt>NkIRenderer::BeginDraw()</tt> and
+ * <tt>NkIRenderer::EndDraw()</tt>. Texture portions are counted by the way they were
+ * drawn: copied 1:1, stretched because source and destination rectangles differ in size
+ * (see <tt>NkRendererCompareRectangles()</tt>), drawn using a transparency mask, or
+ * blended from an alpha texture. On GDI, these correspond to \c BitBlt(),
+ * \c StretchBlt(), \c MaskBlt() and \c AlphaBlend() respectively.
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkRendererFrameStatistics {
+    NkSize   m_structSize;    /**< size of this structure, in bytes */
+    NkUint64 m_frameInd;      /**< number of frames the renderer has finished so far */
+    NkUint32 m_nBlits;        /**< number of texture portions copied without scaling */
+    NkUint32 m_nStretchBlits; /**< number of texture portions that had to be scaled */
+    NkUint32 m_nMaskBlits;    /**< number of texture portions drawn with a mask */
+    NkUint32 m_nAlphaBlits;   /**< number of texture portions blended from an alpha texture */
+    NkUint32 m_nTexBinds;     /**< number of times a different texture had to be bound */
+    NkUint32 m_nSubmits;      /**< number of draw commands submitted to the device */
+    NkUint64 m_nPxFilled;     /**< number of destination pixels covered by all draw calls */
+    NkDouble m_drawTime;      /**< time from the start of \c BeginDraw() until presenting, in ms */
+    NkDouble m_presentTime;   /**< time spent presenting, including waiting for VSync, in ms */
+    NkUint64 m_nPxPresented;  /**< number of back buffer pixels copied to the window when presenting */
+} NkRendererFrameStatistics;
+
 
 /**
  * \interface NkIRenderer
@@ -236,6 +270,16 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
     /**
      */
     NkSize2D (NK_CALL *QueryViewportDimensions)(_Inout_ NkIRenderer *self);
+    /**
+     * \brief retrieves the statistics of the last frame the renderer finished
+     * \param [in, out] self current \c NkIRenderer instance
+     * \param [out] statPtr pointer to a variable that receives the statistics
+     * \note  \li This function must be called from the thread that draws. If it is called
+     *             between <tt>BeginDraw()</tt> and <tt>EndDraw()</tt>, the statistics of
+     *             the previous frame are returned.
+     * \note  \li If no frame has been finished yet, all counters are zero.
+     */
+    NkVoid (NK_CALL *QueryFrameStatistics)(_Inout_ NkIRenderer *self, _Out_ NkRendererFrameStatistics *statPtr);
 
     /**
      * \brief  resizes the client area of the renderer which is usually congruent with
@@ -258,13 +302,55 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
      * \return \c NkErr_Ok on success, non-zero on failure
      */
     NkErrorCode (NK_CALL *EndDraw)(_Inout_ NkIRenderer *self);
+    /**
+     * \brief  declares regions of the viewport whose contents do not change between frames
+     * \param  [in, out] self current \c NkIRenderer instance
+     * \param  [in] count number of elements in \c rects
+     * \param  [in] rects array of \c count rectangles, in viewport space
+     * \param  [out] isPreservedPtr (optional) pointer to a variable that receives whether
+     *              the back buffer still holds the contents the regions had at the end of
+     *              the previous frame
+     * \return \c NkErr_Ok on success, \c NkErr_NotImplemented if the renderer redraws
+     *         the entire frame anyway, \c NkErr_CapLimitExceeded if \c count exceeds
+     *         the number of regions the renderer can track
+     * \note   This function must be called between <tt>BeginDraw()</tt> and
+     *         <tt>EndDraw()</tt>.
+     *
+     * \par Remarks
+     *   Renderers that present only the regions touched by draw calls (such as the GDI
+     *   renderer) clear, at the start of every frame, only what was drawn in the previous
+     *   frame. Regions declared static in a frame are excluded from that clear, so that a
+     *   layer can draw rarely-changing content (such as a static tile layer) once and then
+     *   skip drawing it in the following frames. Static regions must be declared again in
+     *   every frame; passing a \c count of <tt>0</tt> removes them.<br>
+     *   If \c isPreservedPtr receives <tt>NK_FALSE</tt> (for example, because the back
+     *   buffer was reallocated after the window was resized, or the regions were not
+     *   static in the previous frame), the caller must redraw the regions in the current
+     *   frame. If this function does not return <tt>NkErr_Ok</tt>, the caller must keep
+     *   redrawing its content every frame.
+     */
+    NkErrorCode (NK_CALL *SetStaticRegions)(
+        _Inout_          NkIRenderer *self,
+        _In_             NkSize count,
+        _I_array_(count) NkRectF const *rects,
+        _Out_opt_        NkBoolean *isPreservedPtr
+    );
+    /**
+     * \brief  requests that the next frame presents the entire back buffer
+     * \param  [in, out] self current \c NkIRenderer instance
+     * \note   Call this function when the contents of the window were lost, for example,
+     *         after it has been uncovered. The contents of the back buffer are not
+     *         affected.
+     */
+    NkVoid (NK_CALL *InvalidateFrame)(_Inout_ NkIRenderer *self);
     /**
      * \brief   draws a portion of a texture at the given viewport position
      * \param   [in, out] self current \c NkIRenderer instance
      * \param   [in] dstRect rectangle describing the destination of where the texture
      *               (-portion) is to be rendered
      * \param   [in] texPtr pointer to the \c NkRendererResource instance that represents
-     *               the texture
+     *               the texture; may also be a surface or an alpha texture, in
+     *               which case the portion is blended onto the render target
      * \param   [in] srcRect rectangle that describes the texture portion that is to be
      *               rendered; can be <tt>NULL</tt> if the entire texture is to be drawn
      *               into the destination rectangle
@@ -286,6 +372,34 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
         _In_     NkRendererResource const *texPtr,
         _In_opt_ NkRectF const *srcRect
     );
+    /**
+     * \brief   draws a contiguous span of texture portions taken from the same texture
+     * \param   [in, out] self current \c NkIRenderer instance
+     * \param   [in] texPtr pointer to the \c NkRendererResource instance that represents
+     *               the texture all portions are taken from
+     * \param   [in] count number of elements in \c dstRects and <tt>srcRects</tt>
+     * \param   [in] dstRects array of \c count destination rectangles
+     * \param   [in] srcRects array of \c count source rectangles; can be <tt>NULL</tt>
+     *               if the entire texture is to be drawn into each destination rectangle
+     * \return  \c NkErr_Ok on success, non-zero on failure
+     * \warning If \c texPtr does not identify a valid texture handle, then the behavior
+     *          is undefined.
+     *
+     * \par Remarks
+     *   This method is semantically equivalent to calling
+     *   <tt>NkIRenderer::DrawTexture()</tt> \c count times with the n-th elements of
+     *   \c dstRects and <tt>srcRects</tt>. However, the texture is validated and bound
+     *   only once for the entire span, making this the preferred way of drawing large
+     *   numbers of sprites or tiles that reside in the same texture atlas.<br>
+     *   If \c count is <tt>0</tt>, the function does nothing.
+     */
+    NkErrorCode (NK_CALL *DrawTextureBatch)(
+        _Inout_               NkIRenderer *self,
+        _In_                  NkRendererResource const *texPtr,
+        _In_                  NkSize count,
+        _I_array_(count)      NkRectF const *dstRects,
+        _I_array_opt_(count)  NkRectF const *srcRects
+    );
     /**
      * \brief   draws a portion of the given source texture into the destination
      *          rectangle, supporting transparency through a supplied monochrome bitmask
@@ -311,7 +425,10 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
      *   This function supports transparency via <tt>color-keying</tt> by first creating
      *   a monochrome bitmask from a source texture and then using it with this function.
      *   For more complex transparency effects such as alpha blending from source alpha,
-     *   use the <tt>NkIRenderer::DrawTexture()</tt> method.
+     *   create an alpha texture with <tt>NkIRenderer::CreateAlphaTexture()</tt> and draw
+     *   it with the <tt>NkIRenderer::DrawTexture()</tt> method. Since the color key can be
+     *   baked into the alpha texture, this is also the cheaper way of drawing color-keyed
+     *   sprites, taking one blit per sprite instead of a texture and a mask.
      */
     NkErrorCode (NK_CALL *DrawMaskedTexture)(
         _Inout_ NkIRenderer *self,
@@ -321,6 +438,40 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
         _In_    NkRendererResource const *maskPtr,
         _In_    NkVec2F maskOff
     );
+    /**
+     * \brief   redirects all subsequent draw calls to the given surface, or back to the
+     *          renderer's back buffer
+     * \param   [in, out] self current \c NkIRenderer instance
+     * \param   [in] surfPtr pointer to the surface that is to be rendered to; pass
+     *               \c NULL to render to the back buffer again
+     * \return  \c NkErr_Ok on success, non-zero on failure
+     * \warning Drawing a surface into itself results in undefined behavior.
+     *
+     * \par Remarks
+     *   When rendering to a surface, all destination rectangles are relative to the
+     *   upper-left corner of the surface instead of the viewport. Every call to
+     *   <tt>NkIRenderer::BeginDraw()</tt> resets the render target to the back buffer.
+     */
+    NkErrorCode (NK_CALL *SetRenderTarget)(_Inout_ NkIRenderer *self, _In_opt_ NkRendererResource const *surfPtr);
+    /**
+     * \brief  shifts the contents of the given surface by the given offset
+     * \param  [in, out] self current \c NkIRenderer instance
+     * \param  [in] surfPtr pointer to the surface that is to be scrolled
+     * \param  [in] scrollOff offset in pixels by which the contents are shifted; positive
+     *              values move the contents to the right and down, respectively
+     * \return \c NkErr_Ok on success, non-zero on failure
+     *
+     * \par Remarks
+     *   The contents of the area that is uncovered by the scroll operation are
+     *   indeterminate after the function returns and must be redrawn by the caller. This
+     *   allows scrolling layers that rarely change (such as static tile layers) to only
+     *   redraw the newly exposed edges instead of their entire contents.
+     */
+    NkErrorCode (NK_CALL *ScrollSurface)(
+        _Inout_ NkIRenderer *self,
+        _In_    NkRendererResource const *surfPtr,
+        _In_    NkPoint2D scrollOff
+    );
 
     /**
      * \brief  creates a new resource representing a texture, that is, a 2D array of
@@ -345,6 +496,35 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
         _In_           NkDIBitmap const *dibPtr,
         _Maybe_reinit_ NkRendererResource **resourcePtr
     );
+    /**
+     * \brief  creates a new texture with per-pixel alpha from an existing
+     *         <em>device-independent</em> bitmap
+     * \param  [in, out] self current \c NkIRenderer instance
+     * \param  [in] dibPtr pointer to the <em>device-independent</em> bitmap that is to
+     *              be used to create the resource
+     * \param  [in] colKey optional color key; pixels of this color become fully
+     *              transparent
+     * \param  [out] resourcePtr pointer to a variable that will receive the pointer to
+     *               the newly-created resource instance; an existing instance may be
+     *               passed which will cause the old resource to be deleted and the new
+     *               resource to be created in-place
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   If the function succeeds, the \c mp_rdRef member's reference count will be
+     *         incremented.
+     * \see    NkRendererPremultiplyBitmap
+     *
+     * \par Remarks
+     *   The pixels are premultiplied with their alpha value once when the texture is
+     *   created. Drawing the resulting texture with <tt>NkIRenderer::DrawTexture()</tt>
+     *   blends it onto the render target in a single operation, which makes it the
+     *   preferred way of drawing sprites with transparent regions.
+     */
+    NkErrorCode (NK_CALL *CreateAlphaTexture)(
+        _Inout_        NkIRenderer *self,
+        _In_           NkDIBitmap const *dibPtr,
+        _In_opt_       NkRgbaColor const *colKey,
+        _Maybe_reinit_ NkRendererResource **resourcePtr
+    );
     /**
      * \brief   creates a monochrome bitmask from a texture resource and a <em>key color</em>
      *          which is masked out, that is, treated transparently
@@ -370,6 +550,25 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
         _In_           NkRgbaColor colKey,
         _Maybe_reinit_ NkRendererResource **resourcePtr
     );
+    /**
+     * \brief  creates a new off-screen surface which can be rendered to (see
+     *         <tt>NkIRenderer::SetRenderTarget()</tt>) and later be drawn like a texture
+     * \param  [in, out] self current \c NkIRenderer instance
+     * \param  [in] surfDim dimensions of the surface, in pixels
+     * \param  [out] resourcePtr pointer to a variable that will receive the pointer to
+     *               the newly-created surface; an existing instance may be passed which
+     *               will cause the old resource to be deleted and the new resource to be
+     *               created in-place
+     * \return \c NkErr_Ok on success, non-zero on failure
+     * \note   \li If the function succeeds, the \c mp_rdRef member's reference count will
+     *             be incremented.
+     * \note   \li The initial contents of the surface are indeterminate.
+     */
+    NkErrorCode (NK_CALL *CreateSurface)(
+        _Inout_        NkIRenderer *self,
+        _In_           NkSize2D surfDim,
+        _Maybe_reinit_ NkRendererResource **resourcePtr
+    );
     /**
      * \brief   deletes the given resource and frees all memory used by it, including the
      *          memory used to store the instance itself
@@ -403,6 +602,24 @@ NKOM_DECLARE_INTERFACE(NkIRenderer) {
      * \warning The behavior is undefined if \c resPtr is <tt>NULL</tt>.
      */
     NkErrorCode (NK_CALL *GrabFramebuffer)(_Inout_ NkIRenderer *self, _Out_ NkDIBitmap *resPtr);
+    /**
+     * \brief   copies the current renderer's framebuffer into an existing
+     *          device-independent bitmap
+     * \param   [in, out] self current \c NkIRenderer instance
+     * \param   [in, out] bmpPtr pointer to an initialized 32-bit \c NkDIBitmap instance
+     *                    that will receive the current framebuffer state
+     * \return  \c NkErr_Ok on success, \c NkErr_InvImageDimensions if the bitmap does not
+     *          match the framebuffer in size or bit depth, or another non-zero value on
+     *          failure
+     * \warning The behavior is undefined if \c bmpPtr is <tt>NULL</tt>.
+     *
+     * \par Remarks
+     *   Unlike <tt>GrabFramebuffer()</tt>, this function does not allocate. It is meant for
+     *   callers that capture frequently and recycle their bitmaps, such as the capture
+     *   service (see <tt>capture.h</tt>). If the framebuffer has been resized since the
+     *   bitmap was created, destroy it and use <tt>GrabFramebuffer()</tt> instead.
+     */
+    NkErrorCode (NK_CALL *CopyFramebuffer)(_Inout_ NkIRenderer *self, _Inout_ NkDIBitmap *bmpPtr);
 };
 
 
@@ -465,7 +682,86 @@ NK_NATIVE NK_API NkUuid const *NK_CALL NkRendererQueryCLSIDFromApi(_In_ NkRender
  *          the behavior is undefined.
  */
 NK_NATIVE NK_API NkBoolean NK_CALL NkRendererCompareRectangles(_In_ NkRectF const *r1Ptr, _In_ NkRectF const *r2Ptr);
+/**
+ * \brief   calculates the area of \c rectPtr in pixels
+ * \param   [in] rectPtr pointer to the rectangle
+ * \return  area of the rectangle, rounded down
+ * \note    Negative side lengths are treated as 0.
+ * \warning If \c rectPtr is \c NULL or in some other way invalid, then the behavior is
+ *          undefined.
+ */
+NK_NATIVE NK_API NkUint64 NK_CALL NkRendererCalculateArea(_In_ NkRectF const *rectPtr);
 
+/**
+ * \brief   converts a <em>device-independent</em> bitmap into top-down premultiplied
+ *          32-bit BGRA pixels
+ * \param   [in] dibPtr pointer to the bitmap that is to be converted
+ * \param   [in] colKey optional color key; pixels of this color receive an alpha value
+ *               of 0
+ * \param   [out] pxPtr pointer to a variable that will receive the pointer to the
+ *                converted pixels
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    \li The pixel buffer is tightly packed, that is, a row is exactly
+ *              <tt>4 * width</tt> bytes in size. Free it with <tt>NkGPFree()</tt>.
+ * \note    \li 24-bit bitmaps and 32-bit bitmaps without an alpha mask are treated as
+ *              fully opaque.
+ * \warning If \c dibPtr or \c pxPtr are \c NULL, the behavior is undefined.
+ *
+ * \par Remarks
+ *   This is the conversion all renderers use to implement
+ *   <tt>NkIRenderer::CreateAlphaTexture()</tt>.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkRendererPremultiplyBitmap(
+    _In_     NkDIBitmap const *dibPtr,
+    _In_opt_ NkRgbaColor const *colKey,
+    _Outptr_ NkUint32 **pxPtr
+);
+/**
+ * \brief   wraps a renderer into a proxy that executes all frames on a dedicated render
+ *          thread
+ * \param   [in, out] rdRef renderer that is to be wrapped
+ * \param   [out] proxyPtr pointer to a variable that will receive the pointer to the
+ *                proxy renderer
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    \li The proxy takes a reference to <tt>rdRef</tt>. After the function
+ *              returns, \c rdRef must only be used through the proxy.
+ * \note    \li If \c NK_TARGET_MULTITHREADED is not defined, <tt>*proxyPtr</tt> receives
+ *              a new reference to \c rdRef itself.
+ *
+ * \par Remarks
+ *   Draw calls on the proxy are recorded into one of two command buffers.
+ *   <tt>NkIRenderer::EndDraw()</tt> hands the buffer to the render thread and returns
+ *   right away, so that the next frame can be simulated and recorded while the render
+ *   thread replays and presents the previous one; the function only blocks if the render
+ *   thread has not finished the previous frame yet. As a consequence, errors reported by
+ *   the wrapped renderer while replaying a frame are returned by the next call to
+ *   <tt>EndDraw()</tt>, and <tt>QueryFrameStatistics()</tt> lags by one more frame.<br>
+ *   Creating resources and accessing the framebuffer wait until the render thread is
+ *   idle and should therefore not be done every frame. Resources deleted between
+ *   <tt>BeginDraw()</tt> and <tt>EndDraw()</tt> are destroyed once the render thread has
+ *   replayed the frame. Static regions are not supported; <tt>SetStaticRegions()</tt>
+ *   returns <tt>NkErr_NotImplemented</tt>. The proxy must only be used by one thread.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkRendererCreateThreadProxy(
+    _Inout_  NkIRenderer *rdRef,
+    _Outptr_ NkIRenderer **proxyPtr
+);
+
+
+/**
+ * \interface NkINullRenderer
+ * \brief     represents a headless renderer that performs all CPU-side work of a frame
+ *            but never touches a device
+ *
+ * \par Remarks
+ *   Draw calls are validated, their source rectangles normalized and classified exactly
+ *   like on the GDI renderer, including the frame statistics, but no pixels are written.
+ *   Resources only carry their dimensions. This makes the renderer suitable for automated
+ *   runs and benchmarks that should measure the engine itself, independently of the
+ *   graphics driver and the display. Framebuffer grabs return an image filled with the
+ *   clear color.
+ */
+NKOM_DECLARE_INTERFACE_ALIAS(NkIRenderer, NkINullRenderer);
 
 /* Define renderers for the Windows platform. */
 #if (defined NK_TARGET_WINDOWS)
@@ -473,8 +769,36 @@ NK_NATIVE NK_API NkBoolean NK_CALL NkRendererCompareRectangles(_In_ NkRectF cons
  * \interface NkIGdiRenderer
  * \brief     represents a renderer based on Windows' GDI (**G**raphics **D**evice
  *            **I**nterface) technology
+ *
+ * \par Remarks
+ *   When instantiated with <tt>NkRdApi_Win32Soft</tt>, the renderer owns a 32-bit DIB
+ *   section as its back buffer and rasterizes all texture draw calls itself using the
+ *   SIMD kernels of the pixel module; GDI is still used for clearing and for presenting
+ *   the frame. In this mode, all resources are DIB sections and textures are always
+ *   sampled with nearest-neighbor filtering, regardless of
+ *   <tt>NkRendererSpecification::m_texInterMode</tt>.
+ * \par
+ *   If the job system has worker threads, draws into the back buffer are recorded
+ *   instead of rasterized right away. When the frame ends (or a surface that may be read
+ *   by a recorded draw is about to change), the back buffer is split into horizontal
+ *   bands which are rasterized concurrently, one job per band.
+ * \par
+ *   If <tt>NkRendererSpecification::m_isMipmapped</tt> is set, every texture created with
+ *   <tt>NkIRenderer::CreateTexture()</tt> gets a chain of downscaled levels. Draws that
+ *   shrink a texture portion to half its size or less read from the closest level
+ *   instead, which turns zooming out by a power of two into plain copies.
  */
 NKOM_DECLARE_INTERFACE_ALIAS(NkIRenderer, NkIGdiRenderer);
+/**
+ * \interface NkID3D11Renderer
+ * \brief     represents a hardware-accelerated renderer based on Direct3D 11
+ *
+ * \par Remarks
+ *   Unlike the GDI renderer, all compositing is done on the GPU. Textures live in video
+ *   memory and all texture draw calls are accumulated into instanced quad batches which
+ *   are only submitted when the bound texture changes or the frame ends.
+ */
+NKOM_DECLARE_INTERFACE_ALIAS(NkIRenderer, NkID3D11Renderer);
 #endif
 
 
@@ -26,6 +26,14 @@
 #include <include/Noriko/error.h>
 
 
+/**
+ * \def   NK_SORT_RADIXPARALLELTHRESHOLD
+ * \brief minimum number of elements for which <tt>NkRadixsortKeys64()</tt> splits its
+ *        work across the job system
+ */
+#define NK_SORT_RADIXPARALLELTHRESHOLD ((NkSize)(1 << 16))
+
+
 /**
  * \brief   sorts <tt>ptrArray[sInd : eInd]</tt> using the \c QuickSort algorithm with
  *          respect to the predicate provided by \c pred
@@ -52,5 +60,113 @@ NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkQuicksortPointers(
     _In_opt_ NkSize eInd,
     _In_     NkInt32 (NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
 );
+/**
+ * \brief   sorts the elements <tt>[sInd : eInd]</tt> of a contiguous array of values
+ *          in-place using the \c QuickSort algorithm with respect to the predicate
+ *          provided by \c pred
+ * \param   [in,out] elemArray pointer to the first element of the array
+ * \param   [in] elemSize size of a single element, in bytes
+ * \param   [in] sInd first index of the sorting range
+ * \param   [in] eInd last index of the sorting range
+ * \param   [in] fnPred callback of which the return value is used to sort the elements;
+ *               it receives pointers to the elements
+ * \return  \c NkErr_Ok on success, \c NkErr_NoOperation if the sorting range contains
+ *          less than two elements
+ * \note    \li Small ranges are finished using insertion sort. The implementation only
+ *          recurses into the smaller partition, so the recursion depth is logarithmic.
+ * \note    \li The sort is not stable.
+ * \warning The behavior is undefined if:
+ *          \li \c elemArray is \c NULL or invalid
+ *          \li <tt>[sInd, eInd]</tt> is out of bounds or invalid
+ *          \li \c fnPred() is not a valid function pointer
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkQuicksortValues(
+    _Inout_  NkVoid *elemArray,
+    _In_     NkSize elemSize,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32 (NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+);
+/**
+ * \brief   sorts <tt>ptrArray[sInd : eInd]</tt> using a pattern-defeating introsort
+ *          with respect to the predicate provided by \c pred
+ * \param   [in,out] ptrArray pointer to the array of pointers that is to be sorted
+ * \param   [in] sInd first index of the sorting range
+ * \param   [in] eInd last index of the sorting range
+ * \param   [in] fnPred callback of which the return value is used to sort the elements;
+ *               it receives the pointers stored in the array
+ * \return  \c NkErr_Ok on success, \c NkErr_NoOperation if the sorting range was already
+ *          sorted or contains less than two elements
+ * \note    \li Already sorted and reverse-sorted ranges are detected in linear time.
+ *          Nearly-sorted ranges are finished using insertion sort. If partitioning
+ *          degenerates, the implementation falls back to heapsort, so the worst case is
+ *          <tt>O(n log n)</tt>.
+ * \note    \li The sort is not stable.
+ * \warning The behavior is undefined if:
+ *          \li \c ptrArray is \c NULL or invalid
+ *          \li <tt>[sInd, eInd]</tt> is out of bounds or invalid
+ *          \li \c fnPred() is not a valid function pointer
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkIntrosortPointers(
+    _Inout_  NkVoid **ptrArray,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32 (NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+);
+/**
+ * \brief   sorts the elements <tt>[sInd : eInd]</tt> of a contiguous array of values
+ *          in-place using a pattern-defeating introsort with respect to the predicate
+ *          provided by \c pred
+ * \param   [in,out] elemArray pointer to the first element of the array
+ * \param   [in] elemSize size of a single element, in bytes
+ * \param   [in] sInd first index of the sorting range
+ * \param   [in] eInd last index of the sorting range
+ * \param   [in] fnPred callback of which the return value is used to sort the elements;
+ *               it receives pointers to the elements
+ * \return  \c NkErr_Ok on success, \c NkErr_NoOperation if the sorting range was already
+ *          sorted or contains less than two elements
+ * \note    This function shares its implementation with <tt>NkIntrosortPointers()</tt>;
+ *          see there for details.
+ * \warning The behavior is undefined if:
+ *          \li \c elemArray is \c NULL or invalid
+ *          \li <tt>[sInd, eInd]</tt> is out of bounds or invalid
+ *          \li \c fnPred() is not a valid function pointer
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkIntrosortValues(
+    _Inout_  NkVoid *elemArray,
+    _In_     NkSize elemSize,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32 (NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+);
+/**
+ * \brief   sorts an array of 64-bit keys in ascending order using LSD radix sort,
+ *          optionally permuting an array of payload indices alongside
+ * \param   [in,out] keyArray array of keys that is to be sorted
+ * \param   [in,out] idxArray (optional) array of payload indices; <tt>idxArray[i]</tt>
+ *                   is moved wherever <tt>keyArray[i]</tt> is moved
+ * \param   [in] nElems number of elements in \c keyArray and \c idxArray
+ * \param   [in] isParallel whether the passes may be split across the job system's
+ *               worker threads
+ * \return  \c NkErr_Ok on success, \c NkErr_NoOperation if no element was moved, or
+ *          non-zero on error
+ *
+ * \par Remarks
+ *   The sort is stable and does <tt>O(n)</tt> work per pass; each pass sorts by eight
+ *   bits of the key. Passes in which all keys share the same digit are skipped. The
+ *   function allocates scratch memory of the size of both arrays using the general-purpose
+ *   allocator. Parallel mode is only used for at least
+ *   <tt>NK_SORT_RADIXPARALLELTHRESHOLD</tt> elements and if the job system has worker
+ *   threads; the calling thread takes part in the work. The function can be called from
+ *   within a job.
+ * \warning The behavior is undefined if \c keyArray or \c idxArray are smaller than
+ *          \c nElems elements.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkRadixsortKeys64(
+    _Inout_     NkUint64 *keyArray,
+    _Inout_opt_ NkUint32 *idxArray,
+    _In_        NkSize nElems,
+    _In_        NkBoolean isParallel
+);
 
 
@@ -0,0 +1,172 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  spatial.h
+ * \brief defines the public API for the uniform-grid spatial index
+ *
+ * The spatial grid answers the question "which objects overlap this rectangle?" without
+ * looking at every object. The world is divided into square cells of a fixed size; every
+ * object is filed under the cell that contains the center of its bounding rectangle.
+ * Cells are not stored densely but hashed into a fixed number of buckets, so the grid
+ * covers an unbounded world (including negative coordinates) with constant memory
+ * overhead. It is used for culling objects to the viewport as well as for neighbour
+ * queries in gameplay code.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/renderer.h>
+
+
+/**
+ * \struct NkSpatialGrid
+ * \brief  forward-declaration of opaque spatial grid type
+ */
+NK_NATIVE typedef struct NkSpatialGrid NkSpatialGrid;
+
+/**
+ * \typedef NkSpatialHandle
+ * \brief   identifies an object inside a spatial grid
+ * \note    Handles of removed objects are reused for objects inserted later.
+ */
+NK_NATIVE typedef NkUint32 NkSpatialHandle;
+/**
+ * \def   NK_SPATIAL_INVHANDLE
+ * \brief handle that never identifies an object
+ */
+#define NK_SPATIAL_INVHANDLE ((NkSpatialHandle)(UINT32_MAX))
+
+/**
+ * \struct NkSpatialGridSpecification
+ * \brief  holds configuration properties for the spatial grid
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkSpatialGridSpecification {
+    NkSize   m_structSize; /**< size of this structure, in bytes */
+    NkFloat  m_cellSize;   /**< edge length of a cell, in world units */
+    NkUint32 m_nBuckets;   /**< number of cell buckets; must be a power of two */
+    NkUint32 m_initCap;    /**< number of objects to reserve memory for */
+} NkSpatialGridSpecification;
+
+
+/**
+ * \brief   creates a new, empty spatial grid
+ * \param   [in] gridSpec pointer to the specification of the grid
+ * \param   [out] gridPtr pointer to a variable that will receive the pointer to the
+ *                newly-created grid
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   The cell size should be about as large as the typical query rectangle of a
+ *   neighbour query, and a few times larger than a typical object. The number of buckets
+ *   should be in the order of the number of occupied cells; a map with thousands of
+ *   objects works well with a few thousand buckets.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkSpatialGridCreate(
+    _In_       NkSpatialGridSpecification const *gridSpec,
+    _Init_ptr_ NkSpatialGrid **gridPtr
+);
+/**
+ * \brief destroys the given spatial grid
+ * \param [in, out] gridPtr pointer to a variable holding the pointer to the grid that is
+ *                  to be destroyed
+ * \note  <tt>*gridPtr</tt> will be set to <tt>NULL</tt>. If <tt>*gridPtr</tt> is already
+ *        <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkSpatialGridDestroy(_Uninit_ptr_ NkSpatialGrid **gridPtr);
+/**
+ * \brief removes all objects from the given spatial grid
+ * \param [in, out] gridPtr pointer to the spatial grid
+ * \note  All handles become invalid; memory is kept for reuse.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkSpatialGridClear(_Inout_ NkSpatialGrid *gridPtr);
+/**
+ * \brief  inserts an object into the spatial grid
+ * \param  [in, out] gridPtr pointer to the spatial grid
+ * \param  [in] boundsPtr bounding rectangle of the object, in world units
+ * \param  [in] userData value that is associated with the object
+ * \param  [out] handlePtr pointer to a variable that receives the handle of the object
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkSpatialGridInsert(
+    _Inout_ NkSpatialGrid *gridPtr,
+    _In_    NkRectF const *boundsPtr,
+    _In_    NkUint64 userData,
+    _Out_   NkSpatialHandle *handlePtr
+);
+/**
+ * \brief   updates the bounding rectangle of an object
+ * \param   [in, out] gridPtr pointer to the spatial grid
+ * \param   [in] objHandle handle of the object
+ * \param   [in] boundsPtr new bounding rectangle of the object, in world units
+ * \warning The behavior is undefined if \c objHandle does not identify an object.
+ * \note    Moving an object within its cell only stores the new rectangle; this is the
+ *          common case for objects that move a few units per tick.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkSpatialGridMove(
+    _Inout_ NkSpatialGrid *gridPtr,
+    _In_    NkSpatialHandle objHandle,
+    _In_    NkRectF const *boundsPtr
+);
+/**
+ * \brief   removes an object from the spatial grid
+ * \param   [in, out] gridPtr pointer to the spatial grid
+ * \param   [in] objHandle handle of the object
+ * \warning The behavior is undefined if \c objHandle does not identify an object.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkSpatialGridRemove(_Inout_ NkSpatialGrid *gridPtr, _In_ NkSpatialHandle objHandle);
+/**
+ * \brief   retrieves the bounding rectangle and the user data of an object
+ * \param   [in] gridPtr pointer to the spatial grid
+ * \param   [in] objHandle handle of the object
+ * \param   [out] boundsPtr (optional) pointer to a variable that receives the bounding
+ *                rectangle
+ * \return  user data of the object
+ * \warning The behavior is undefined if \c objHandle does not identify an object.
+ */
+NK_NATIVE NK_API NkUint64 NK_CALL NkSpatialGridQueryObject(
+    _In_      NkSpatialGrid const *gridPtr,
+    _In_      NkSpatialHandle objHandle,
+    _Out_opt_ NkRectF *boundsPtr
+);
+/**
+ * \brief  finds all objects whose bounding rectangles overlap the given rectangle
+ * \param  [in] gridPtr pointer to the spatial grid
+ * \param  [in] queryRect rectangle to search, in world units
+ * \param  [out] resArr (optional) array that receives the handles of the objects found
+ * \param  [in] maxRes number of elements \c resArr can hold
+ * \return number of objects found; if this is larger than <tt>maxRes</tt>, only the first
+ *         \c maxRes handles were written
+ *
+ * \par Remarks
+ *   Rectangles that only touch at their edges do not overlap. The order of the handles is
+ *   unspecified but stable for as long as the grid is not modified. Passing \c NULL for
+ *   \c resArr can be used to count the objects first.
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkSpatialGridQuery(
+    _In_                  NkSpatialGrid const *gridPtr,
+    _In_                  NkRectF const *queryRect,
+    _O_array_opt_(maxRes) NkSpatialHandle *resArr,
+    _In_                  NkUint32 maxRes
+);
+/**
+ * \brief  retrieves the number of objects in the spatial grid
+ * \param  [in] gridPtr pointer to the spatial grid
+ * \return number of objects
+ */
+NK_NATIVE NK_API NkUint32 NK_CALL NkSpatialGridQueryCount(_In_ NkSpatialGrid const *gridPtr);
+
+
@@ -0,0 +1,132 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  tilecache.h
+ * \brief defines the public API for the tile cache, that is, an off-screen surface that
+ *        holds a pre-rendered copy of a static tile layer
+ *
+ * Static tile layers rarely change but cover the entire viewport. Instead of issuing one
+ * draw call per visible tile every frame, the tile cache renders the layer into a surface
+ * once and afterwards only redraws the tiles that were explicitly marked as dirty or that
+ * were uncovered by scrolling the camera. Each frame, the surface is then presented with
+ * a single texture draw.
+ */
+
+
+#pragma once
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/error.h>
+#include <include/Noriko/renderer.h>
+
+
+/**
+ * \struct NkTileCache
+ * \brief  forward-declaration of opaque tile cache type
+ */
+NK_NATIVE typedef struct NkTileCache NkTileCache;
+
+/**
+ * \typedef NkTileCacheFetchFn
+ * \brief   callback used by the tile cache to query the atlas region of a given tile
+ * \param   [in, out] extraCxt (optional) user-defined context pointer
+ * \param   [in] tilePos position of the tile, in tiles, in world space
+ * \param   [out] srcRect pointer to a variable that receives the region of the tile
+ *                inside the tile atlas, in pixels
+ * \return  \c NK_TRUE if there is a tile at the given position, \c NK_FALSE if the
+ *          position is to be filled with the cache's empty color
+ */
+NK_NATIVE typedef NkBoolean (NK_CALL *NkTileCacheFetchFn)(
+    _Inout_opt_ NkVoid *extraCxt,
+    _In_        NkPoint2D tilePos,
+    _Out_       NkRectF *srcRect
+);
+
+/**
+ * \struct NkTileCacheSpecification
+ * \brief  holds configuration properties for the tile cache
+ */
+NK_NATIVE typedef _Struct_size_bytes_(m_structSize) struct NkTileCacheSpecification {
+    NkSize                    m_structSize; /**< size of this structure, in bytes */
+    NkIRenderer              *mp_rdRef;     /**< renderer to create the surface with */
+    NkRendererResource const *mp_tileAtlas; /**< texture all tiles are taken from */
+    NkSize2D                  m_tileSize;   /**< size of a tile, in pixels */
+    NkSize2D                  m_cacheExt;   /**< extents of the cache, in tiles */
+    NkRgbaColor               m_emptyCol;   /**< color of positions without a tile */
+    NkTileCacheFetchFn        mp_fetchFn;   /**< tile query callback */
+    NkVoid                   *mp_extraCxt;  /**< context passed to <tt>mp_fetchFn</tt> */
+} NkTileCacheSpecification;
+
+
+/**
+ * \brief   creates a new tile cache
+ * \param   [in] cacheSpec pointer to the specification of the tile cache
+ * \param   [out] cachePtr pointer to a variable that will receive the pointer to the
+ *                newly-created tile cache
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ * \note    \li The cache holds a reference to the renderer until it is destroyed.
+ * \note    \li The tile atlas must stay alive for as long as the cache is in use.
+ * \warning The extents of the cache should be large enough to hold the viewport
+ *          plus one row and column of tiles for the sub-tile camera offset.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkTileCacheCreate(
+    _In_       NkTileCacheSpecification const *cacheSpec,
+    _Init_ptr_ NkTileCache **cachePtr
+);
+/**
+ * \brief destroys the given tile cache and releases all resources used by it
+ * \param [in, out] cachePtr pointer to a variable holding the pointer to the tile cache
+ *                  that is to be destroyed
+ * \note  <tt>*cachePtr</tt> will be set to <tt>NULL</tt>. If <tt>*cachePtr</tt> is
+ *        already <tt>NULL</tt>, the function does nothing.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkTileCacheDestroy(_Uninit_ptr_ NkTileCache **cachePtr);
+/**
+ * \brief marks the entire cache as dirty, causing all cached tiles to be redrawn on the
+ *        next call to <tt>NkTileCacheRender()</tt>
+ * \param [in, out] cachePtr pointer to the tile cache that is to be invalidated
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkTileCacheInvalidate(_Inout_ NkTileCache *cachePtr);
+/**
+ * \brief marks a single tile as dirty, causing it to be redrawn on the next call to
+ *        <tt>NkTileCacheRender()</tt>
+ * \param [in, out] cachePtr pointer to the tile cache
+ * \param [in] tilePos position of the tile, in tiles, in world space
+ * \note  If the tile is currently not inside the cached area, the function does nothing;
+ *        the tile will be queried again anyway once it scrolls into view.
+ */
+NK_NATIVE NK_API NkVoid NK_CALL NkTileCacheMarkDirty(_Inout_ NkTileCache *cachePtr, _In_ NkPoint2D tilePos);
+/**
+ * \brief  brings the cache up-to-date and draws it into the current render target
+ * \param  [in, out] cachePtr pointer to the tile cache
+ * \param  [in] camPos top-left corner of the visible area, in pixels, in world space
+ * \param  [in] dstRect area of the viewport the layer is drawn into, in pixels
+ * \return \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   If the camera moved since the last call, the contents of the cache are scrolled by
+ *   the number of whole tiles the camera moved by and only the newly-exposed tiles are
+ *   queried and drawn. The first call, calls following an invalidation, and calls where
+ *   the camera moved by at least the extents of the cache redraw the entire cache.<br>
+ *   The function must be called between <tt>NkIRenderer::BeginDraw()</tt> and
+ *   <tt>NkIRenderer::EndDraw()</tt>. When the function returns, the framebuffer is the
+ *   current render target.
+ */
+NK_NATIVE NK_API _Return_ok_ NkErrorCode NK_CALL NkTileCacheRender(
+    _Inout_ NkTileCache *cachePtr,
+    _In_    NkVec2F camPos,
+    _In_    NkRectF const *dstRect
+);
+
+
@@ -140,4 +140,44 @@ NK_NATIVE NK_API NK_INLINE NkUint64 NK_CALL NkTimerGetCurrentTicks(NkVoid);
  */
 NK_NATIVE NK_API NK_INLINE NkUint64 NK_CALL NkTimerGetFrequency(NkVoid);
 
+/**
+ * \brief  returns a timestamp that is cheaper to take than <tt>NkTimerGetCurrentTicks()</tt>
+ * \return numeric value of the timestamp, in fast ticks
+ *
+ * \par Remarks
+ *   On x86 processors with an invariant time-stamp counter, the counter is read directly
+ *   with \c rdtsc, which takes a few nanoseconds instead of the tens of nanoseconds
+ *   \c QueryPerformanceCounter() takes. Its frequency is calibrated against the
+ *   high-precision timer when the timing device context starts up. If the counter is
+ *   not invariant, that is, if its rate may change with the power state of the core,
+ *   this function falls back to <tt>NkTimerGetCurrentTicks()</tt>. Either way, fast
+ *   ticks are consistent across all threads and cores.<br>
+ *   Use this for timestamps in frequently executed code, such as profiler zones and
+ *   events. Fast ticks must only be compared with other fast ticks; they are not
+ *   guaranteed to be serializing, so they should not be used to time a handful of
+ *   instructions. Timestamps taken before the timing device context started up must not
+ *   be mixed with ones taken later.
+ */
+NK_NATIVE NK_API NK_INLINE NkUint64 NK_CALL NkTimerGetFastTicks(NkVoid);
+/**
+ * \brief  returns the number of fast ticks per second
+ * \return frequency of the timestamps returned by <tt>NkTimerGetFastTicks()</tt>
+ */
+NK_NATIVE NK_API NK_INLINE NkUint64 NK_CALL NkTimerGetFastFrequency(NkVoid);
+/**
+ * \brief  converts a number of fast ticks into a duration
+ * \param  [in] nTicks number of fast ticks, usually the difference of two timestamps
+ * \param  [in] precId unit to receive the result in
+ * \return duration, in the given unit
+ */
+NK_NATIVE NK_API NK_INLINE NkDouble NK_CALL NkTimerFastTicksToTime(_In_ NkUint64 nTicks, _In_ NkTimerPrecision precId);
+/**
+ * \brief  converts a fast timestamp into a timestamp of the high-precision timer
+ * \param  [in] fastTicks timestamp returned by <tt>NkTimerGetFastTicks()</tt>
+ * \return timestamp on the scale of <tt>NkTimerGetCurrentTicks()</tt>
+ * \note   The result is accurate to within the calibration error, which is a few ticks
+ *         per second that passed since the timing device context started up.
+ */
+NK_NATIVE NK_API NkUint64 NK_CALL NkTimerFastTicksToTicks(_In_ NkUint64 fastTicks);
+
 
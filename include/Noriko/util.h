@@ -497,9 +497,20 @@ NK_NATIVE NK_API NK_INLINE _Return_false_ NkBoolean NK_CALL NkCheckedUint64Add(
  * \param  [in] outPtr pointer to an NkUint64 variable that will receive the random
  *              number
  * \return \c NkErr_Ok on success, non-zero on failure
- * \note   This function is thread-safe.
+ * \note   This function is thread-safe. Every thread uses its own sequence, so calls from
+ *         different threads never block each other.
  */
 NK_NATIVE NK_API _Return_ok_ enum NkErrorCode NK_CALL NkPRNGNext(_Out_ NkUint64 *outPtr);
+/**
+ * \brief  fills a buffer with random numbers
+ * \param  [out] bufPtr pointer to the buffer that is to be filled
+ * \param  [in] count number of 64-bit numbers to generate
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   This function is thread-safe and considerably faster than calling
+ *         <tt>NkPRNGNext()</tt> \c count times. The numbers are drawn from different
+ *         sequences than those returned by <tt>NkPRNGNext()</tt>.
+ */
+NK_NATIVE NK_API _Return_ok_ enum NkErrorCode NK_CALL NkPRNGFill(_Out_writes_(count) NkUint64 *bufPtr, _In_ NkSize count);
 
 
 /**
@@ -76,6 +76,8 @@ NK_NATIVE typedef enum NkWindowFlags {
     NkWndFlag_MainWindow     = 1 << 2, /**< whether or not the window is the main window */
     NkWndFlag_DragResizable  = 1 << 3, /**< if the window can be resized via border dragging */
     NkWndFlag_DragMovable    = 1 << 4, /**< if the window can be moved by dragging the title bar, etc. */
+    NkWndFlag_RenderThread   = 1 << 5, /**< whether frames are presented by a dedicated render thread (see <tt>NkRendererCreateThreadProxy()</tt>) */
+    NkWndFlag_Mipmaps        = 1 << 6, /**< whether the renderer precomputes downscaled levels of textures (see <tt>NkRendererSpecification::m_isMipmapped</tt>) */
 
     __NkWndFlag_Count__                /**< *only used internally* */
 } NkWindowFlags;
@@ -24,6 +24,9 @@
 
 /* stdlib includes */
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <unordered_map>
 
 /* Qt includes */
 #include <QVariant>
@@ -31,6 +34,9 @@
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
 #include <QAbstractItemModelTester>
+#include <QThreadPool>
+#include <QHash>
+#include <QStringList>
 /* Qt forms includes */
 #include <ui_form_expl.h>
 
@@ -38,6 +44,7 @@
 #include <include/NorikoEd/common.hpp>
 #include <include/NorikoEd/project.hpp>
 #include <include/NorikoEd/session.hpp>
+#include <include/NorikoEd/thumbnail.hpp>
 
 
 /* definition of ExplorerModel */
@@ -58,16 +65,23 @@ namespace NkE {
 
             Session, /**< session item ID */
             Project, /**< project item type ID */
-            Filter   /**< filter item type ID */
+            Filter,  /**< filter item type ID */
+            Asset    /**< asset item type ID */
         };
 
-    private:
         using ExplorerItemVector = std::vector<std::unique_ptr<class ExplorerItem>>;
 
-        ExplorerItem::Type  m_itemType;    /**< item type */
-        ExplorerItemVector  m_childItems;  /**< list of direct children */
-        ExplorerItem       *mp_parentItem; /**< pointer to the parent item */
-        QVariant            m_internalVal; /**<  */
+    private:
+        ExplorerItem::Type  m_itemType;     /**< item type */
+        ExplorerItemVector  m_childItems;   /**< list of direct children */
+        ExplorerItem       *mp_parentItem;  /**< pointer to the parent item */
+        NkInt32             m_rowIndex;     /**< cached index of the item in its parent */
+        QVariant            m_internalVal;  /**<  */
+        QString             m_srcPath;      /**< asset database path the item was created from */
+        QByteArray          m_assetId;      /**< UUID of the asset, as stored in the database */
+        bool                m_isResolved;   /**< whether the children have been queried */
+        ExplorerItemVector  m_stagedItems;  /**< queried children not inserted yet */
+        NkSize              m_nextStaged;   /**< index of the next staged child */
 
     public:
         /**
@@ -83,6 +97,10 @@ namespace NkE {
         NkInt32             getItemRow()           const;
         ExplorerItem       *getChildAt(int rowPos) const;
         ExplorerItem       *getParent()            const;
+        QString const      &getSourcePath()        const;
+        QByteArray const   &getAssetId()           const;
+        bool                isResolved()           const;
+        NkSize              getStagedCount()       const;
 
         /**
          * \brief mutates the type of the current item
@@ -92,6 +110,23 @@ namespace NkE {
          */
         void setItemType(ExplorerItem::Type newType);
         bool setItemData(int colId, QVariant const &newVal);
+        /**
+         * \brief sets the asset database path the item was created from
+         * \param [in] srcPath path prefix of the assets below a filter, or the path of an
+         *             asset, using '/' as separator; empty for the root of the database
+         * \note  Filters become lazy items whose children are queried on demand. Until
+         *        <tt>setResolved()</tt> is called, they report that they can fetch more
+         *        children.
+         */
+        void setSourcePath(QString const &srcPath);
+        /**
+         * \brief hands the children that were queried for the item over to it
+         * \param [in] stagedItems queried children, in the order they are to be shown
+         * \note  The children are only added to the item by subsequent calls to
+         *        <tt>appendStagedItems()</tt>.
+         */
+        void setResolved(ExplorerItemVector &&stagedItems);
+        void setAssetId(QByteArray const &assetId);
 
         /**
          * \brief inserts a new child item at the given index
@@ -105,6 +140,18 @@ namespace NkE {
          * \note  The item, if removed, is deleted.
          */
         void removeChildItem(NkInt32 where2Remove);
+        /**
+         * \brief moves the next staged children to the end of the child list
+         * \param [in] numOfItems number of staged children to add; must not exceed
+         *             <tt>getStagedCount()</tt>
+         */
+        void appendStagedItems(NkSize numOfItems);
+        /**
+         * \brief  looks up the direct child filter with the given source path
+         * \param  [in] srcPath source path of the filter, including the trailing '/'
+         * \return pointer to the child, or \c nullptr if there is no such child
+         */
+        ExplorerItem *findChildFilter(QString const &srcPath) const;
     };
 
 
@@ -115,7 +162,23 @@ namespace NkE {
     class ExplorerModel : public QAbstractItemModel {
         Q_OBJECT
 
-        std::unique_ptr<ExplorerItem> m_rootItem; /**< root item */
+    public:
+        static constexpr int FetchBatchSize = 256; /**< maximum number of rows inserted per fetch */
+
+    private:
+
+        /**
+         * \brief queries the direct children of a lazy item from the asset database
+         * \param [in,out] itemPtr lazy item whose children are to be queried
+         * \note  Sub-directories become filter items and are placed before the assets.
+         */
+        void int_resolveItem(ExplorerItem *itemPtr);
+
+        std::unique_ptr<ExplorerItem>              m_rootItem;      /**< root item */
+        NkIDatabase                               *mp_assetDb;      /**< asset database, or \c nullptr */
+        NkISqlStatement                           *mp_childrenStmt; /**< query for the assets below a path */
+        ThumbnailService                          *mp_thumbService; /**< thumbnail service, or \c nullptr */
+        mutable QHash<QByteArray, ExplorerItem *>  m_thumbItems;    /**< items waiting for their thumbnail */
 
     public:
         /**
@@ -123,7 +186,31 @@ namespace NkE {
          * \param [in] parPtr pointer to the parent object
          */
         explicit ExplorerModel(QObject *parPtr = nullptr);
-        ~ExplorerModel() = default;
+        ~ExplorerModel();
+
+        /**
+         * \brief replaces the contents of the model with the assets of an asset database
+         * \param [in,out] dbPtr open connection to the asset database; the model keeps its
+         *                 own reference; \c nullptr to only clear the model
+         * \param [in] rootName name that is to be shown for the top-level filter
+         * \note  Only the top-level filter is created. The children of filters are queried
+         *        when a filter is expanded for the first time and are inserted in batches
+         *        of <tt>ExplorerModel::FetchBatchSize</tt> items.
+         */
+        void setAssetDatabase(NkIDatabase *dbPtr, QString const &rootName);
+        /**
+         * \brief makes sure that the item of an asset is part of the model
+         * \param [in] assetPath path of the asset, as stored in the asset database
+         * \note  Every filter on the way to the asset is resolved and fetched completely.
+         */
+        void revealPath(QString const &assetPath);
+        /**
+         * \brief sets the service that provides the icons of bitmap assets
+         * \param [in] servPtr pointer to the thumbnail service, or \c nullptr to only use
+         *             the static icons
+         * \note  The service is not owned by the model.
+         */
+        void setThumbnailService(ThumbnailService *servPtr);
 
         /**
          * \brief  retrieves the raw pointer to the underlying item
@@ -157,6 +244,25 @@ namespace NkE {
          * \see   https://doc.qt.io/qt-6/qabstractitemmodel.html#columnCount
          */
         virtual int columnCount(const QModelIndex &parIndex = QModelIndex()) const override;
+        /**
+         * \brief reimplements \c QAbstractItemModel::hasChildren()
+         * \see   https://doc.qt.io/qt-6/qabstractitemmodel.html#hasChildren
+         * \note  Filters whose children have not been queried yet are always reported to
+         *        have children so that they can be expanded.
+         */
+        virtual bool hasChildren(const QModelIndex &parIndex = QModelIndex()) const override;
+        /**
+         * \brief reimplements \c QAbstractItemModel::canFetchMore()
+         * \see   https://doc.qt.io/qt-6/qabstractitemmodel.html#canFetchMore
+         */
+        virtual bool canFetchMore(const QModelIndex &parIndex) const override;
+        /**
+         * \brief reimplements \c QAbstractItemModel::fetchMore()
+         * \see   https://doc.qt.io/qt-6/qabstractitemmodel.html#fetchMore
+         * \note  The first call for a lazy item queries its children; each call inserts at
+         *        most <tt>ExplorerModel::FetchBatchSize</tt> rows.
+         */
+        virtual void fetchMore(const QModelIndex &parIndex) override;
         /**
          * \brief reimplements \c QAbstractItemModel::data()
          * \see   https://doc.qt.io/qt-6/qabstractitemmodel.html#data
@@ -180,6 +286,109 @@ namespace NkE {
 } /* namespace NkE */
 
 
+/* definition of the explorer search index */
+namespace NkE {
+    /**
+     * \class ExplorerSearchIndex
+     * \brief represents a trigram index over the names and paths of all assets in an
+     *        asset database
+     *
+     * The index is built and queried on worker threads. Queries report the paths of
+     * matching assets in chunks, so that the explorer can show the first results while
+     * the query is still running. Starting a new query cancels the previous one.
+     */
+    class ExplorerSearchIndex : public QObject {
+        Q_OBJECT
+
+    public:
+        static constexpr int ResultChunkSize = 512; /**< maximum number of paths per result chunk */
+
+    private:
+        /**
+         * \struct IndexEntry
+         * \brief  represents a single asset in the index
+         */
+        struct IndexEntry {
+            QString m_rawText;    /**< name and path, separated by a line break */
+            QString m_foldedText; /**< case-folded version of \c m_rawText */
+            QString m_assetPath;  /**< path of the asset */
+        };
+        /**
+         * \struct IndexData
+         * \brief  represents an immutable snapshot of the index
+         */
+        struct IndexData {
+            std::vector<IndexEntry>                           m_entryArr;    /**< indexed assets */
+            std::unordered_map<quint64, std::vector<quint32>> m_trigramMap;  /**< ascending entry indices per trigram */
+        };
+
+        /**
+         * \brief builds a snapshot of the index from the given asset database
+         * \param [in] dbPath path to the asset database
+         * \param [in] buildId ID of the build; the snapshot is dropped if another build was
+         *             started in the meantime
+         * \note  This function runs on a worker thread.
+         */
+        void int_buildIndex(QString const &dbPath, quint64 buildId);
+        /**
+         * \brief runs a query against the given snapshot, reporting the results in chunks
+         * \note  This function runs on a worker thread.
+         */
+        void int_runQuery(std::shared_ptr<IndexData const> dataPtr, QString const &searchText, bool isCaseSensitive, bool isRegex, quint64 queryId);
+
+        QThreadPool                        m_workerPool;  /**< threads that build and query the index */
+        std::shared_ptr<IndexData const>   mp_indexData;  /**< current snapshot, or \c nullptr */
+        std::atomic<quint64>               m_currBuild;   /**< ID of the latest build */
+        std::atomic<quint64>               m_currQuery;   /**< ID of the latest query */
+
+    public:
+        /**
+         * \brief constructs a new, empty search index
+         * \param [in] parPtr pointer to the parent object
+         */
+        explicit ExplorerSearchIndex(QObject *parPtr = nullptr);
+        ~ExplorerSearchIndex();
+
+        /**
+         * \brief starts building the index from an asset database in the background
+         * \param [in] dbPath path to the asset database
+         * \note  The previous snapshot is kept until the new one is ready.
+         */
+        void rebuild(QString const &dbPath);
+        /**
+         * \brief  whether a snapshot of the index can be queried
+         */
+        bool isReady() const;
+        /**
+         * \brief  starts a query in the background
+         * \param  [in] searchText text or regular expression to look for
+         * \param  [in] isCaseSensitive whether the case of letters matters
+         * \param  [in] isRegex whether \c searchText is a regular expression
+         * \return ID of the query, as reported by <tt>resultsReady()</tt>
+         * \note   Fixed strings of three or more characters only test the assets that
+         *         contain every trigram of the string. Regular expressions test all assets.
+         */
+        quint64 query(QString const &searchText, bool isCaseSensitive, bool isRegex);
+        /**
+         * \brief cancels the running query, if any
+         */
+        void cancel();
+
+    signals:
+        /**
+         * \brief is emitted when a new snapshot of the index has been built
+         */
+        void indexReady();
+        /**
+         * \brief is emitted for every chunk of results of a query that was not cancelled
+         * \param [in] queryId ID returned by <tt>query()</tt>
+         * \param [in] assetPaths paths of the matching assets
+         */
+        void resultsReady(quint64 queryId, QStringList const &assetPaths);
+    };
+} /* namespace NkE */
+
+
 /* definition of the explorer widget */
 namespace NkE {
     /**
@@ -208,10 +417,25 @@ namespace NkE {
          *             (<tt>false</tt>) the tree items
          */
         void int_expandOrCollapseRecursively(QModelIndex const &rootIndex, bool isExpand);
+        /**
+         * \brief expands all items below the given index whose children have been loaded
+         * \param [in] rootIndex model index of where to start expanding
+         * \note  Unlike <tt>QTreeView::expandAll()</tt>, this does not fetch lazy filters.
+         */
+        void int_expandLoadedRecursively(QModelIndex const &rootIndex);
+
+        /**
+         * \brief  retrieves the explorer model behind the proxy model
+         * \return pointer to the model, or \c nullptr if there was an error
+         */
+        ExplorerModel *int_getSourceModel() const;
 
 #if (defined _DEBUG)
         QAbstractItemModelTester *mp_itemModelTester; /**< item model tester for debugging */
 #endif
+        ExplorerSearchIndex      *mp_searchIndex;     /**< index used by the search bar */
+        ThumbnailService         *mp_thumbService;    /**< thumbnails of the open asset database */
+        quint64                   m_currQuery;        /**< ID of the query shown in the view */
 
     public:
         /**
@@ -223,6 +447,16 @@ namespace NkE {
         ~ExplorerWidget();
 
         void createSession(QString const &name);
+        /**
+         * \brief shows the assets of an asset database in the explorer
+         * \param [in] dbPath path to the asset database
+         * \param [in] rootName name that is to be shown for the top-level filter
+         * \note  The search index is rebuilt in the background. Until it is ready, the
+         *        search bar only filters the items that have already been loaded.
+         * \note  Asset paths are relative to the directory of the database. Thumbnails are
+         *        cached in <tt>thumbcache.db</tt> in the same directory.
+         */
+        void openAssetDatabase(QString const &dbPath, QString const &rootName);
 
     private slots:
         /* main toolbar actions */
@@ -247,6 +481,8 @@ namespace NkE {
         /* miscellaneous widget slots */
         void on_customCxtMenu_requested(QPoint const &mousePos = QPoint());
         void on_leSearch_textChanged(QString const &newText = "");
+        void on_searchIndex_ready();
+        void on_searchIndex_resultsReady(quint64 queryId, QStringList const &assetPaths);
     };
 } /* namespace NkE */
 
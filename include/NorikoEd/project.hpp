@@ -22,16 +22,47 @@
 
 #pragma once
 
+/* stdlib includes */
+#include <memory>
+
 /* Qt includes */
 #include <QString>
 #include <QDir>
 #include <QList>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+#include <QThreadPool>
 
 /* NorikoEd includes */
 #include <include/NorikoEd/common.hpp>
 
 
 namespace NkE {
+    /**
+     * \struct ProjectItemState
+     * \brief  represents the persistent state of a single item of a project
+     */
+    struct ProjectItemState {
+        QByteArray m_itemId;   /**< UUID of the item */
+        QByteArray m_parentId; /**< UUID of the parent item; empty for top-level items */
+        int        m_itemType; /**< type of the item (see <tt>ExplorerItem::Type</tt>) */
+        QString    m_itemName; /**< display name of the item */
+        int        m_sortKey;  /**< position of the item among its siblings */
+        QByteArray m_itemData; /**< type-specific data */
+    };
+
+    /**
+     * \struct ProjectChangeSet
+     * \brief  represents the changes of a project since it was saved last
+     */
+    struct ProjectChangeSet {
+        bool                    m_isRootModified; /**< whether the project file has to be rewritten */
+        QList<ProjectItemState> m_changedItems;   /**< items that were added or modified */
+        QList<QByteArray>       m_removedIds;     /**< UUIDs of the items that were removed */
+    };
+
+
     /**
      * \class Project
      * \brief represents a NorikoEd project
@@ -84,12 +115,61 @@ namespace NkE {
         QString const &getWorkingTitle()       const { return m_workingTitle; }
         QString const &getAuthoringOrg()       const { return m_authoringOrg; }
         QString const &getProductDescription() const { return m_productDescription; }
+        /**
+         * \brief  retrieves the path of the database the item state is saved in
+         * \return path of the state database; it may not exist yet
+         */
+        QString getStateDbPath() const;
+
+        void setAuthoringOrg(QString const &author);
+        void setProductDescription(QString const &brDesc);
+
+        /**
+         * \brief  retrieves the state of all items of the project
+         */
+        QHash<QByteArray, ProjectItemState> const &getItemStates() const { return m_itemMap; }
+        /**
+         * \brief  whether the project has changes that have not been saved
+         */
+        bool isModified() const;
+        /**
+         * \brief adds or updates the state of an item and marks it for the next save
+         * \param [in] stateRef new state of the item
+         */
+        void setItemState(ProjectItemState const &stateRef);
+        /**
+         * \brief removes the state of an item and marks it for the next save
+         * \param [in] itemId UUID of the item
+         */
+        void removeItemState(QByteArray const &itemId);
+        /**
+         * \brief adds the state of an item that was read from the state database
+         * \param [in] stateRef state of the item
+         * \note  Unlike <tt>setItemState()</tt>, this does not mark the item as changed.
+         */
+        void loadItemState(ProjectItemState &&stateRef);
+
+        /**
+         * \brief  retrieves the changes since the last save and resets them
+         * \return changes that are to be written
+         */
+        ProjectChangeSet takeChanges();
+        /**
+         * \brief marks the changes of a save that failed as unsaved again
+         * \param [in] changeSet changes as returned by <tt>takeChanges()</tt>
+         * \note  Items that were changed again in the meantime keep their newer state.
+         */
+        void restoreChanges(ProjectChangeSet const &changeSet);
 
     private:
-        QString m_qualifiedPath;
-        QString m_workingTitle;
-        QString m_authoringOrg;
-        QString m_productDescription;
+        QString                             m_qualifiedPath;
+        QString                             m_workingTitle;
+        QString                             m_authoringOrg;
+        QString                             m_productDescription;
+        bool                                m_isRootModified; /**< whether a root property changed */
+        QHash<QByteArray, ProjectItemState> m_itemMap;        /**< state of all items, by UUID */
+        QSet<QByteArray>                    m_changedIds;     /**< items that changed since the last save */
+        QSet<QByteArray>                    m_removedIds;     /**< items removed since the last save */
     };
 
 
@@ -112,8 +192,28 @@ namespace NkE {
          *         block the main thread.
          */
         static bool int_WriteProjectFile(Project const &projRef);
+        /**
+         * \brief  reads a project file and the item state of the project
+         * \param  [in] projFilePath absolute path to the project file
+         * \param  [out] errMsg receives a description of the error, if any
+         * \return project, or \c nullptr if it could not be read
+         * \note   This function runs on the I/O thread and reports its progress through
+         *         <tt>projectLoadProgress()</tt>.
+         */
+        std::unique_ptr<Project> int_LoadProject(QString const &projFilePath, QString &errMsg);
+        /**
+         * \brief  writes the changes of a project
+         * \param  [in] projRef copy of the project's root properties
+         * \param  [in] changeSet changes that are to be written
+         * \return \c true on success, \c false on failure
+         * \note   This function runs on the I/O thread. Only the rows of changed items are
+         *         written, in a single transaction; the project file is only rewritten
+         *         if one of its properties changed.
+         */
+        static bool int_SaveChanges(Project const &projRef, ProjectChangeSet const &changeSet);
 
         QList<Project> m_projVec; /**< currently loaded projects */
+        QThreadPool    m_ioPool;  /**< thread that loads and saves projects, in order */
 
     public:
         explicit ProjectManager();
@@ -136,11 +236,27 @@ namespace NkE {
             QString const &dirRoot
         );
         /**
-         * \brief  opens an existing project from its project file
+         * \brief  starts opening an existing project from its project file
          * \param  [in] projFilePath absolute path to the project file
-         * \return \c true on success, \c false on error
+         * \return \c true if the project is being loaded, \c false on error
+         * \note   The project is read in the background. <tt>projectLoaded()</tt> or
+         *         <tt>projectLoadFailed()</tt> is emitted once it has been read.
          */
         bool openProject(QString const &projFilePath);
+        /**
+         * \brief  starts saving the changes of a project
+         * \param  [in] projIndex index of the project, in the order it was loaded
+         * \return \c true if the changes are being written, \c false if there is no such
+         *         project
+         * \note   The changes are taken from the project immediately, so that it can be
+         *         edited while they are written. <tt>projectSaved()</tt> is emitted once
+         *         they have been written.
+         */
+        bool saveProject(qsizetype projIndex);
+        /**
+         * \brief starts saving the changes of all modified projects
+         */
+        void saveAllProjects();
 
         /**
          * \brief  creates the project path based on the given parameters
@@ -167,6 +283,26 @@ namespace NkE {
          *        from an existing directory.
          */
         void projectLoaded(QString const &wkTitle, QString const &rootPath);
+        /**
+         * \brief signal that is emitted while a project is being opened
+         * \param [in] projFilePath path to the project file
+         * \param [in] numDone number of items that have been read
+         * \param [in] numTotal number of items of the project
+         */
+        void projectLoadProgress(QString const &projFilePath, qint64 numDone, qint64 numTotal);
+        /**
+         * \brief signal that is emitted if a project could not be opened
+         * \param [in] projFilePath path to the project file
+         * \param [in] errMsg description of the error
+         */
+        void projectLoadFailed(QString const &projFilePath, QString const &errMsg);
+        /**
+         * \brief signal that is emitted when the changes of a project have been written
+         * \param [in] wkTitle working title of the project
+         * \param [in] isOk whether the changes were written; if not, they stay marked as
+         *             unsaved
+         */
+        void projectSaved(QString const &wkTitle, bool isOk);
     };
 } /* namespace NkE */
 
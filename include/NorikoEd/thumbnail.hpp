@@ -0,0 +1,117 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  thumbnail.hpp
+ * \brief defines the public API for NorikoEd's thumbnail service
+ *
+ * The thumbnail service creates the small previews that views show for texture assets.
+ * Decoding and downscaling run on worker threads. Finished thumbnails are kept in memory
+ * and in a cache database next to the asset database, keyed by the UUID of the asset and
+ * a hash of the file contents, so that they survive restarts and are recreated when the
+ * file changes.
+ */
+
+
+#pragma once
+
+/* stdlib includes */
+#include <atomic>
+
+/* Qt includes */
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QPixmap>
+#include <QImage>
+#include <QCache>
+#include <QSet>
+#include <QMutex>
+#include <QThreadPool>
+
+/* NorikoEd includes */
+#include <include/NorikoEd/common.hpp>
+
+
+namespace NkE {
+    /**
+     * \class ThumbnailService
+     * \brief represents the service that creates and caches asset thumbnails
+     */
+    class ThumbnailService : public QObject {
+        Q_OBJECT
+
+    public:
+        static constexpr int ThumbnailSize = 64; /**< maximum width and height of a thumbnail, in pixels */
+
+    private:
+        /**
+         * \brief creates the thumbnail of an asset file
+         * \param [in] assetId UUID of the asset
+         * \param [in] filePath absolute path of the asset file
+         * \note  This function runs on a worker thread. The cache database is consulted
+         *        first; only files whose hash is not in it are decoded.
+         */
+        void int_createThumbnail(QByteArray const &assetId, QString const &filePath);
+        /**
+         * \brief  decodes a bitmap file and scales it down to the thumbnail size
+         * \param  [in] fileData contents of the bitmap file
+         * \return thumbnail; null if the file could not be decoded
+         */
+        static QImage int_decodeBitmap(QByteArray const &fileData);
+
+        QString                      m_assetRoot;   /**< directory asset paths are relative to */
+        QThreadPool                  m_workerPool;  /**< threads that create thumbnails */
+        QCache<QByteArray, QPixmap>  m_memCache;    /**< recently used thumbnails, cost in KiB */
+        QSet<QByteArray>             m_pendingSet;  /**< assets whose thumbnail is being created */
+        QSet<QByteArray>             m_failedSet;   /**< assets that have no thumbnail */
+        int                          m_nextPrio;    /**< priority of the next request */
+        std::atomic<bool>            m_isStopping;  /**< whether the service is shut down */
+        QMutex                       m_dbLock;      /**< guards the cache database */
+        NkIDatabase                 *mp_cacheDb;    /**< cache database, or \c nullptr */
+        NkISqlStatement             *mp_lookupStmt; /**< query for a cached thumbnail */
+        NkISqlStatement             *mp_storeStmt;  /**< statement that caches a thumbnail */
+
+    public:
+        /**
+         * \brief constructs a new thumbnail service
+         * \param [in] assetRoot directory asset paths are relative to
+         * \param [in] cacheDbPath path to the cache database; it is created if it does not
+         *             exist
+         * \param [in] parPtr pointer to the parent object
+         * \note  If the cache database cannot be opened, thumbnails are only cached in
+         *        memory.
+         */
+        explicit ThumbnailService(QString const &assetRoot, QString const &cacheDbPath, QObject *parPtr = nullptr);
+        ~ThumbnailService();
+
+        /**
+         * \brief  retrieves the thumbnail of an asset
+         * \param  [in] assetId UUID of the asset, as stored in the asset database
+         * \param  [in] assetPath path of the asset file, relative to the asset root
+         * \return thumbnail, or a null pixmap if it is not available (yet)
+         * \note   If the thumbnail is not in memory, it is created in the background and
+         *         <tt>thumbnailReady()</tt> is emitted once it is. Recent requests are
+         *         served first, so the rows that are visible after scrolling come first.
+         */
+        QPixmap getThumbnail(QByteArray const &assetId, QString const &assetPath);
+
+    signals:
+        /**
+         * \brief is emitted on the thread of the service when a thumbnail was created
+         * \param [in] assetId UUID of the asset
+         */
+        void thumbnailReady(QByteArray const &assetId);
+    };
+} /* namespace NkE */
+
+
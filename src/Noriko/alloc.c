@@ -20,6 +20,15 @@
  * specialized pool-allocators for fixed object sizes requiring frequent allocation and
  * deallocation.
  * 
+ * Pool allocations of up to 4096 bytes are rounded up to a size class and served by
+ * per-thread caches. Every thread owns a set of spans per size class; allocations by and
+ * frees to the own thread's spans do not require any synchronization, while frees by
+ * other threads are handed back to the owner using a lock-free list. Spans are carved
+ * out of segments aligned to their size, so the span owning a block is found in
+ * constant time by masking the block's address. Spans that become empty are returned to
+ * a global list from which any thread cache can adopt them again; spans of threads that
+ * exited are orphaned and returned once their last block was freed.
+ *
  * \note For the pool allocator to work properly, the block sizes (i.e., the sizes of the
  *       individual elements) must be a multiple of 8 and the alignment requirement must
  *       be <= 16.
@@ -28,6 +37,7 @@
 
 
 /* stdlib includes */
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
@@ -37,6 +47,7 @@
 #include <include/Noriko/util.h>
 #include <include/Noriko/log.h>
 #include <include/Noriko/comp.h>
+#include <include/Noriko/profiler.h>
 
 
 /** \cond INTERNAL */
@@ -45,6 +56,58 @@
  * \brief maximum number of memory pools allocatable
  */
 #define NK_ALLOC_NPOOLS ((NkSize)(8192))
+/**
+ * \def   NK_ALLOC_NSIZECLASSES
+ * \brief number of size classes served by the thread caches
+ *
+ * Size classes are spaced 8 bytes apart up to 128 bytes; beyond that, every power of
+ * two is divided into four classes, up to \c NK_ALLOC_MAXCLASSSIZE.
+ */
+#define NK_ALLOC_NSIZECLASSES ((NkUint32)(36))
+/**
+ * \def   NK_ALLOC_MAXCLASSSIZE
+ * \brief size of the largest size class, in bytes
+ */
+#define NK_ALLOC_MAXCLASSSIZE ((NkSize)(4096))
+/**
+ * \def   NK_ALLOC_SPANSIZE
+ * \brief size of a span, in bytes; spans are aligned to their size
+ */
+#define NK_ALLOC_SPANSIZE ((NkSize)(64 * 1024))
+/**
+ * \def   NK_ALLOC_SPANSPERSEG
+ * \brief number of spans per segment
+ */
+#define NK_ALLOC_SPANSPERSEG ((NkSize)(16))
+/**
+ * \def   NK_ALLOC_SEGSIZE
+ * \brief size of a segment, in bytes; segments are aligned to their size
+ */
+#define NK_ALLOC_SEGSIZE (NK_ALLOC_SPANSIZE * NK_ALLOC_SPANSPERSEG)
+/**
+ * \def   NK_ALLOC_NSEGMENTS
+ * \brief maximum number of segments allocatable
+ */
+#define NK_ALLOC_NSEGMENTS ((NkSize)(1024))
+/**
+ * \def   NK_ALLOC_SEGMAPSIZE
+ * \brief number of slots in the segment map; must be a power of two greater than
+ *        \c NK_ALLOC_NSEGMENTS
+ */
+#define NK_ALLOC_SEGMAPSIZE ((NkSize)(2048))
+/**
+ * \def   NK_ALLOC_NTRACKSITES
+ * \brief maximum number of distinct call sites the allocation tracker can record; must
+ *        be a power of two
+ */
+#define NK_ALLOC_NTRACKSITES ((NkSize)(4096))
+/**
+ * \def   NK_ALLOC_VMPOOLSIZE
+ * \brief size of the address range reserved for a memory pool backed by
+ *        \c NkPoolBack_Virtual, in bytes
+ * \note  On 32-bit targets, the address space is scarce, so less is reserved.
+ */
+#define NK_ALLOC_VMPOOLSIZE ((NkSize)(sizeof(NkVoid *) >= 8 ? 64 : 4) * 1024 * 1024)
 
 
 /**
@@ -62,11 +125,13 @@ NK_NATIVE typedef enum __NkInt_AllocType {
  * \brief  represents the metadata saved with each block
  */
 NK_NATIVE typedef struct __NkInt_PoolAllocMemoryPool {
-    NkUint32  m_blockSize;    /**< size of one block, in bytes */
-    NkUint32  m_blockCount;   /**< number of slots */
-    NkUint32  m_nAllocBlocks; /**< number of currently allocated blocks */
-    NkUint32  m_fFreeInd;     /**< index of the first free block */
-    NkVoid   *mp_blockPtr;    /**< pointer to the block memory */
+    NkUint32       m_blockSize;     /**< size of one block, in bytes */
+    NkUint32       m_blockCount;    /**< number of slots */
+    NkUint32       m_maxBlockCount; /**< number of slots the pool can grow to in place */
+    NkUint32       m_nAllocBlocks;  /**< number of currently allocated blocks */
+    NkUint32       m_fFreeInd;      /**< index of the first free block */
+    NkPoolBacking  m_poolBacking;   /**< how the pool memory was obtained */
+    NkVoid        *mp_blockPtr;     /**< pointer to the block memory */
 } __NkInt_PoolAllocMemoryPool;
 
 /**
@@ -89,6 +154,8 @@ NK_NATIVE typedef struct __NkInt_PoolAllocContext {
 
     NkUint32                    m_nAllocPools;               /**< number of currently allocated pools */
     NkUint32                    m_firstFreePool;             /**< offset of the first free block in the pool */
+    NkPoolBacking               m_poolBacking;               /**< backing of pools that are created from now on */
+    NkSize                      m_largePageSize;             /**< large page size, or \c 0 if large pages cannot be used */
     __NkInt_PoolAllocMemoryPool m_memPools[NK_ALLOC_NPOOLS]; /**< static array of memory pools */
 } __NkInt_PoolAllocContext;
 
@@ -110,9 +177,225 @@ NK_INTERNAL NkUint32 const gl_BlockAlign = 16U;
  */
 NK_INTERNAL NkUint32 const gl_DefBlockCount = 128U;
 /**
- * \brief default fixed page-size
+ * \brief page size; replaced by the page size of the system on start-up
+ */
+NK_INTERNAL NkUint32 gl_PageSize = 4096U;
+
+
+/**
+ * \struct __NkInt_PoolSpan
+ * \brief  represents the header of a span, that is, an aligned region of memory that
+ *         is carved into blocks of the same size and owned by exactly one thread cache
+ *
+ * Only the owning thread allocates from a span. Blocks freed by the owning thread go to
+ * the local free-list, which is not synchronized. Blocks freed by any other thread are
+ * pushed onto the remote free-list using atomic operations; the owner takes the entire
+ * remote list at once when its local list runs dry. Because the list is only ever
+ * pushed to or taken as a whole, it does not suffer from the ABA problem.
+ */
+NK_NATIVE typedef struct __NkInt_PoolSpan {
+    struct __NkInt_PoolThreadCache *mp_ownerCache;  /**< thread cache owning the span */
+    struct __NkInt_PoolSpan        *mp_nextSpan;    /**< next span of the same size class */
+    NkVoid                         *mp_localFree;   /**< blocks freed by the owner */
+    NkVoid *volatile                mp_remoteFree;  /**< blocks freed by other threads */
+    NkUint32                        m_blockSize;    /**< size of one block, in bytes */
+    NkUint32                        m_blockCount;   /**< total number of blocks in the span */
+    NkUint32                        m_nBumpBlocks;  /**< number of blocks that were ever handed out */
+    NkUint32                        m_nAllocBlocks; /**< number of blocks not on the local free-list */
+} __NkInt_PoolSpan;
+/* Make sure the blocks following the span header are aligned properly. */
+static_assert(sizeof(__NkInt_PoolSpan) <= 64, "Span header must not exceed 64 bytes.");
+
+/**
+ * \struct __NkInt_PoolThreadCache
+ * \brief  represents the per-thread cache for small single-block pool allocations
+ */
+NK_NATIVE typedef struct __NkInt_PoolThreadCache {
+    struct __NkInt_PoolThreadCache *mp_nextCache;                     /**< next cache in the global cache list */
+    __NkInt_PoolSpan               *mp_spans[NK_ALLOC_NSIZECLASSES]; /**< span list per size class */
+} __NkInt_PoolThreadCache;
+
+/**
+ * \struct __NkInt_PoolCacheContext
+ * \brief  holds the global state shared by all thread caches
+ * \note   All members are protected by the pool allocator lock, except for the segment
+ *         map which is read without the lock. The segment map is an insert-only
+ *         open-addressing hash set of segment addresses; every slot is written exactly
+ *         once using an atomic store.
  */
-NK_INTERNAL NkUint32 const gl_PageSize = 4096U;
+NK_NATIVE typedef struct __NkInt_PoolCacheContext {
+    __NkInt_PoolThreadCache *mp_cacheList;                   /**< thread caches of all live threads */
+    __NkInt_PoolSpan        *mp_freeSpans;                   /**< spans not owned by any cache */
+    __NkInt_PoolSpan        *mp_orphanSpans;                 /**< spans of exited threads that still have blocks allocated */
+    NkBoolean                m_isActive;                     /**< whether the thread caches are alive; cleared on shutdown */
+    NkUint32                 m_nSegments;                    /**< number of allocated segments */
+    NkVoid                  *mp_segArr[NK_ALLOC_NSEGMENTS];  /**< all allocated segments */
+    NkVoid *volatile         mp_segMap[NK_ALLOC_SEGMAPSIZE]; /**< segment map */
+} __NkInt_PoolCacheContext;
+
+
+/**
+ * \brief global state of the thread caches
+ */
+NK_INTERNAL __NkInt_PoolCacheContext gl_PoolCacheCxt;
+/**
+ * \brief thread cache of the current thread, created on first use
+ */
+NK_INTERNAL NK_THREADLOCAL __NkInt_PoolThreadCache *gl_ThreadCache = NULL;
+/**
+ * \brief owner of orphaned spans; as it is no thread's cache, all frees to orphaned spans
+ *        go to their remote free-lists
+ */
+NK_INTERNAL __NkInt_PoolThreadCache gl_OrphanCache;
+/**
+ * \brief size of the span header, in bytes
+ */
+NK_INTERNAL NkSize const gl_SpanHeadSize = 64U;
+
+
+/**
+ * \struct __NkInt_AllocTrackSite
+ * \brief  holds the statistics of a single allocating call site
+ */
+NK_NATIVE typedef struct __NkInt_AllocTrackSite {
+    char const *mp_filePath;  /**< file of the call site; \c NULL if the slot is unused */
+    char const *mp_funcName;  /**< function of the call site */
+    NkUint32    m_lineInFile; /**< line of the call site */
+    NkUint64    m_liveBytes;  /**< number of bytes currently allocated */
+    NkUint64    m_liveCount;  /**< number of allocations currently alive */
+    NkUint64    m_nAllocs;    /**< total number of allocations */
+    NkUint64    m_nFrees;     /**< total number of frees */
+    NkUint64    m_totalBytes; /**< total number of bytes ever allocated */
+} __NkInt_AllocTrackSite;
+
+/**
+ * \struct __NkInt_AllocTrackEntry
+ * \brief  represents a single live allocation known to the tracker
+ */
+NK_NATIVE typedef struct __NkInt_AllocTrackEntry {
+    NkVoid const *mp_memPtr; /**< address of the allocation; \c NULL if unused */
+    NkSize        m_memSize; /**< size of the allocation, in bytes */
+    NkUint32      m_siteInd; /**< index of the allocating call site */
+} __NkInt_AllocTrackEntry;
+
+/**
+ * \struct __NkInt_AllocTrackContext
+ * \brief  represents the state of the allocation tracker
+ * \note   The live allocation map is an open-addressing hash table that is allocated
+ *         directly from the host heap so that tracking never recurses into itself.
+ *         Deleted entries are marked using a special address.
+ */
+NK_NATIVE typedef struct __NkInt_AllocTrackContext {
+    NK_DECL_LOCK(m_mtxLock); /**< synchronization object */
+
+    CHAR volatile            m_isEnabled;                     /**< whether tracking is enabled */
+    NkUint64                 m_nFrames;                       /**< frames since tracking was enabled */
+    NkSize                   m_nSites;                        /**< number of used site slots */
+    __NkInt_AllocTrackSite   m_siteArr[NK_ALLOC_NTRACKSITES]; /**< call site table */
+    __NkInt_AllocTrackEntry *mp_entryArr;                     /**< live allocation map */
+    NkSize                   m_entryCap;                      /**< capacity of the live allocation map */
+    NkSize                   m_nEntries;                      /**< number of used or deleted entries */
+} __NkInt_AllocTrackContext;
+
+
+/**
+ * \brief state of the allocation tracker
+ */
+NK_INTERNAL __NkInt_AllocTrackContext gl_AllocTrackCxt;
+/**
+ * \brief marker for deleted entries in the live allocation map
+ */
+NK_INTERNAL NkVoid const *const gl_c_TrackTombstone = (NkVoid const *)&gl_AllocTrackCxt;
+
+
+/**
+ * \brief  maps a new, zero-initialized segment of memory aligned to its size
+ * \param  [in] segSize size of the segment, in bytes; must be a power of two
+ * \return address of the segment, or \c NULL on failure
+ */
+NK_EXTERN NK_VIRTUAL NkVoid *NK_CALL __NkVirt_Alloc_MapSegment(_In_ NkSize segSize);
+/**
+ * \brief unmaps a segment previously mapped by <tt>__NkVirt_Alloc_MapSegment()</tt>
+ * \param [in, out] segPtr address of the segment
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkVirt_Alloc_UnmapSegment(_Inout_ NkVoid *segPtr);
+/**
+ * \brief  retrieves the size of a regular page of virtual memory
+ * \return page size, in bytes
+ */
+NK_EXTERN NK_VIRTUAL NkSize NK_CALL __NkVirt_Alloc_GetPageSize(NkVoid);
+/**
+ * \brief  tries to enable the use of large pages for the current process
+ * \return size of a large page, in bytes, or \c 0 if large pages cannot be used
+ * \note   On Windows, this requires the process to hold \c SeLockMemoryPrivilege.
+ */
+NK_EXTERN NK_VIRTUAL NkSize NK_CALL __NkVirt_Alloc_EnableLargePages(NkVoid);
+/**
+ * \brief  reserves a range of address space
+ * \param  [in] rangeSize size of the range, in bytes; must be a multiple of the page size
+ * \param  [in] isLarge whether the range is to be backed by large pages
+ * \return address of the range, or \c NULL on failure
+ * \note   Large pages cannot be committed on demand, so a range backed by large pages is
+ *         committed in its entirety right away. Otherwise, no memory is committed.
+ */
+NK_EXTERN NK_VIRTUAL NkVoid *NK_CALL __NkVirt_Alloc_ReserveRange(_In_ NkSize rangeSize, _In_ NkBoolean isLarge);
+/**
+ * \brief  commits all pages of a reserved range that overlap the given part of it
+ * \param  [in, out] partPtr start of the part that is to be committed
+ * \param  [in] partSize size of the part, in bytes
+ * \return \c NK_TRUE on success, \c NK_FALSE on failure
+ * \note   Newly-committed pages are zero-initialized; already committed pages are left
+ *         unchanged.
+ */
+NK_EXTERN NK_VIRTUAL NkBoolean NK_CALL __NkVirt_Alloc_CommitRange(_Inout_ NkVoid *partPtr, _In_ NkSize partSize);
+/**
+ * \brief releases a range reserved by <tt>__NkVirt_Alloc_ReserveRange()</tt>
+ * \param [in, out] rangePtr address of the range
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkVirt_Alloc_ReleaseRange(_Inout_ NkVoid *rangePtr);
+
+
+/**
+ * \struct __NkInt_ArenaBlock
+ * \brief  represents the header of a single memory block owned by an arena
+ */
+NK_NATIVE typedef struct __NkInt_ArenaBlock {
+    struct __NkInt_ArenaBlock *mp_prevBlock; /**< previously-allocated block */
+    NkSize                     m_blockSize;  /**< usable size of the block, in bytes */
+    NkSize                     m_blockOff;   /**< offset of the first free byte */
+    NkSize                     m_padding;    /**< pads the header to 32 bytes */
+} __NkInt_ArenaBlock;
+/* Make sure the block memory following the header is suitably aligned. */
+static_assert(sizeof(__NkInt_ArenaBlock) % 16 == 0, "Arena block header size must be a multiple of 16.");
+
+/**
+ * \struct NkArena
+ * \brief  represents a linear arena allocator
+ */
+struct NkArena {
+    NkAllocationContext const *mp_allocCxt;  /**< allocation context used for block allocations; points to \c m_allocCxt or is \c NULL */
+    NkAllocationContext        m_allocCxt;   /**< copy of the context passed on creation */
+    __NkInt_ArenaBlock        *mp_currBlock; /**< block that is currently allocated from */
+    NkSize                     m_totalSize;  /**< combined usable size of all blocks */
+};
+
+
+/**
+ * \brief double-buffered per-frame arenas
+ */
+NK_INTERNAL NkArena *gl_FrameArenas[2];
+/**
+ * \brief index of the frame arena of the current frame
+ */
+NK_INTERNAL NkUint32 gl_CurrFrameArena = 0;
+/**
+ * \brief default capacity of an arena, in bytes
+ */
+NK_INTERNAL NkSize const gl_DefArenaCap = 64U * 1024U;
+/**
+ * \brief default alignment of arena allocations, in bytes
+ */
+NK_INTERNAL NkSize const gl_DefArenaAlign = 16U;
 
 
 /**
@@ -207,6 +490,189 @@ NK_INTERNAL NkVoid __NkInt_FreeMemoryUnaligned(_In_ NkVoid *ptr) {
 #endif
 }
 
+/**
+ * \brief  calculates the index of the first slot to probe for the given key
+ * \param  [in] keyVal key value
+ * \param  [in] tableCap capacity of the table; must be a power of two
+ * \return slot index
+ */
+NK_INTERNAL NK_INLINE NkSize __NkInt_AllocTrackHash(_In_ NkUint64 keyVal, _In_ NkSize tableCap) {
+    return (NkSize)((keyVal * 0x9E3779B97F4A7C15ULL) >> 24) & (tableCap - 1);
+}
+
+/**
+ * \brief  finds or creates the call site slot for the given allocation context
+ * \param  [in] allocCxt (optional) allocation context of the allocation
+ * \return index of the call site slot
+ * \note   If the site table is full, the last slot is used as a catch-all slot.
+ */
+NK_INTERNAL NkUint32 __NkInt_AllocTrackGetSite(_In_opt_ NkAllocationContext const *allocCxt) {
+    char const    *filePath = allocCxt != NULL ? allocCxt->m_filePath.mp_dataPtr : "n/a";
+    char const    *funcName = allocCxt != NULL ? allocCxt->m_functionName.mp_dataPtr : "n/a";
+    NkUint32 const lineNum  = allocCxt != NULL ? allocCxt->m_lineInFile : 0;
+
+    /*
+     * Call sites are identified by the address of their (static) file path string and
+     * their line number, so that no string comparisons are necessary.
+     */
+    NkSize const mask = NK_ALLOC_NTRACKSITES - 1;
+    for (NkSize i = __NkInt_AllocTrackHash((NkUint64)(NkSize)filePath ^ ((NkUint64)lineNum << 40), NK_ALLOC_NTRACKSITES);; i = (i + 1) & mask) {
+        __NkInt_AllocTrackSite *sitePtr = &gl_AllocTrackCxt.m_siteArr[i];
+
+        if (sitePtr->mp_filePath == filePath && sitePtr->m_lineInFile == lineNum)
+            return (NkUint32)i;
+        if (sitePtr->mp_filePath == NULL) {
+            if (gl_AllocTrackCxt.m_nSites == NK_ALLOC_NTRACKSITES - 1)
+                return (NkUint32)mask;
+
+            *sitePtr = (__NkInt_AllocTrackSite){
+                .mp_filePath  = filePath,
+                .mp_funcName  = funcName,
+                .m_lineInFile = lineNum
+            };
+            ++gl_AllocTrackCxt.m_nSites;
+            return (NkUint32)i;
+        }
+    }
+}
+
+/**
+ * \brief  grows the live allocation map and removes all deleted entries
+ * \return \c NK_TRUE on success, \c NK_FALSE if the new map could not be allocated
+ */
+NK_INTERNAL NkBoolean __NkInt_AllocTrackRehash(NkVoid) {
+    NkSize const newCap = gl_AllocTrackCxt.m_entryCap > 0 ? gl_AllocTrackCxt.m_entryCap * 2 : 4096;
+
+    __NkInt_AllocTrackEntry *newArr = __NkInt_AllocateMemoryUnaligned(NULL, newCap * sizeof *newArr, NK_TRUE);
+    if (newArr == NULL)
+        return NK_FALSE;
+
+    NkSize nEntries = 0;
+    for (NkSize i = 0; i < gl_AllocTrackCxt.m_entryCap; i++) {
+        __NkInt_AllocTrackEntry const *entryPtr = &gl_AllocTrackCxt.mp_entryArr[i];
+        if (entryPtr->mp_memPtr == NULL || entryPtr->mp_memPtr == gl_c_TrackTombstone)
+            continue;
+
+        NkSize j = __NkInt_AllocTrackHash((NkUint64)(NkSize)entryPtr->mp_memPtr, newCap);
+        while (newArr[j].mp_memPtr != NULL)
+            j = (j + 1) & (newCap - 1);
+
+        newArr[j] = *entryPtr;
+        ++nEntries;
+    }
+
+    if (gl_AllocTrackCxt.mp_entryArr != NULL)
+        __NkInt_FreeMemoryUnaligned(gl_AllocTrackCxt.mp_entryArr);
+    gl_AllocTrackCxt.mp_entryArr = newArr;
+    gl_AllocTrackCxt.m_entryCap  = newCap;
+    gl_AllocTrackCxt.m_nEntries  = nEntries;
+    return NK_TRUE;
+}
+
+/**
+ * \brief records a new allocation
+ * \param [in] allocCxt (optional) allocation context of the allocation
+ * \param [in] memPtr address of the allocation
+ * \param [in] memSize size of the allocation, in bytes
+ * \note  Does nothing if tracking is disabled, apart from counting the allocation for
+ *        profiler captures.
+ */
+NK_INTERNAL NkVoid __NkInt_AllocTrackOnAlloc(
+    _In_opt_ NkAllocationContext const *allocCxt,
+    _In_     NkVoid const *memPtr,
+    _In_     NkSize memSize
+) {
+    NkProfileCountAllocation(memSize);
+
+    if (gl_AllocTrackCxt.m_isEnabled == NK_FALSE)
+        return;
+
+    NK_LOCK(gl_AllocTrackCxt.m_mtxLock);
+    if (gl_AllocTrackCxt.m_isEnabled == NK_FALSE)
+        goto lbl_END;
+
+    /* Keep the load factor of the live allocation map below 1/2. */
+    if ((gl_AllocTrackCxt.m_nEntries + 1) * 2 > gl_AllocTrackCxt.m_entryCap && !__NkInt_AllocTrackRehash())
+        goto lbl_END;
+
+    NkUint32 const siteInd = __NkInt_AllocTrackGetSite(allocCxt);
+    __NkInt_AllocTrackSite *sitePtr = &gl_AllocTrackCxt.m_siteArr[siteInd];
+    sitePtr->m_liveBytes  += memSize;
+    sitePtr->m_totalBytes += memSize;
+    ++sitePtr->m_liveCount;
+    ++sitePtr->m_nAllocs;
+
+    /* Insert the allocation into the first unused or deleted slot. */
+    NkSize i = __NkInt_AllocTrackHash((NkUint64)(NkSize)memPtr, gl_AllocTrackCxt.m_entryCap);
+    while (gl_AllocTrackCxt.mp_entryArr[i].mp_memPtr != NULL && gl_AllocTrackCxt.mp_entryArr[i].mp_memPtr != gl_c_TrackTombstone)
+        i = (i + 1) & (gl_AllocTrackCxt.m_entryCap - 1);
+
+    if (gl_AllocTrackCxt.mp_entryArr[i].mp_memPtr == NULL)
+        ++gl_AllocTrackCxt.m_nEntries;
+    gl_AllocTrackCxt.mp_entryArr[i] = (__NkInt_AllocTrackEntry){
+        .mp_memPtr = memPtr,
+        .m_memSize = memSize,
+        .m_siteInd = siteInd
+    };
+
+lbl_END:
+    NK_UNLOCK(gl_AllocTrackCxt.m_mtxLock);
+}
+
+/**
+ * \brief records that an allocation was freed
+ * \param [in] memPtr address of the allocation
+ * \note  Does nothing if tracking is disabled or the allocation was made before tracking
+ *        was enabled.
+ */
+NK_INTERNAL NkVoid __NkInt_AllocTrackOnFree(_In_ NkVoid const *memPtr) {
+    if (gl_AllocTrackCxt.m_isEnabled == NK_FALSE)
+        return;
+
+    NK_LOCK(gl_AllocTrackCxt.m_mtxLock);
+    if (gl_AllocTrackCxt.m_isEnabled == NK_FALSE || gl_AllocTrackCxt.m_entryCap == 0)
+        goto lbl_END;
+
+    for (NkSize i = __NkInt_AllocTrackHash((NkUint64)(NkSize)memPtr, gl_AllocTrackCxt.m_entryCap);; i = (i + 1) & (gl_AllocTrackCxt.m_entryCap - 1)) {
+        __NkInt_AllocTrackEntry *entryPtr = &gl_AllocTrackCxt.mp_entryArr[i];
+
+        if (entryPtr->mp_memPtr == NULL)
+            break;
+        if (entryPtr->mp_memPtr == memPtr) {
+            __NkInt_AllocTrackSite *sitePtr = &gl_AllocTrackCxt.m_siteArr[entryPtr->m_siteInd];
+            sitePtr->m_liveBytes -= entryPtr->m_memSize;
+            --sitePtr->m_liveCount;
+            ++sitePtr->m_nFrees;
+
+            entryPtr->mp_memPtr = gl_c_TrackTombstone;
+            break;
+        }
+    }
+
+lbl_END:
+    NK_UNLOCK(gl_AllocTrackCxt.m_mtxLock);
+}
+
+/**
+ * \brief  compares two call sites for sorting the allocation report
+ * \param  [in] lhsPtr pointer to the index of the first site
+ * \param  [in] rhsPtr pointer to the index of the second site
+ * \return negative if the first site comes first, positive if the second site comes
+ *         first, or zero if both are equal
+ * \note   Sites are sorted by live bytes first and by the number of allocations second,
+ *         both in descending order.
+ */
+NK_INTERNAL int __NkInt_AllocTrackCompareSites(_In_ void const *lhsPtr, _In_ void const *rhsPtr) {
+    __NkInt_AllocTrackSite const *lhsSite = &gl_AllocTrackCxt.m_siteArr[*(NkUint32 const *)lhsPtr];
+    __NkInt_AllocTrackSite const *rhsSite = &gl_AllocTrackCxt.m_siteArr[*(NkUint32 const *)rhsPtr];
+
+    if (lhsSite->m_liveBytes != rhsSite->m_liveBytes)
+        return lhsSite->m_liveBytes > rhsSite->m_liveBytes ? -1 : 1;
+    if (lhsSite->m_nAllocs != rhsSite->m_nAllocs)
+        return lhsSite->m_nAllocs > rhsSite->m_nAllocs ? -1 : 1;
+    return 0;
+}
+
 /**
  * \brief  calculates the size of the pool block header section
  * \param  [in] blockCount number of memory blocks in the pool
@@ -296,6 +762,118 @@ NK_INTERNAL NK_INLINE NkUint32 __NkInt_PoolAllocAdjustPoolMetrics(
     return *poolSizePtr;
 }
 
+/**
+ * \brief  commits the memory of the first blocks of a pool backed by reserved address
+ *         space
+ * \param  [in,out] poolPtr pointer to the pool
+ * \param  [in] newCount number of blocks that are to be usable; must not exceed
+ *              <tt>m_maxBlockCount</tt>
+ * \return \c NK_TRUE on success, \c NK_FALSE on failure
+ * \note   The block headers of all blocks the pool can grow to precede the first block,
+ *         so both the header section and the block section are committed up to
+ *         \c newCount blocks.
+ */
+NK_INTERNAL NkBoolean __NkInt_PoolAllocCommitBlocks(
+    _Inout_ __NkInt_PoolAllocMemoryPool *poolPtr,
+    _In_    NkUint32 newCount
+) {
+    NkByte *const basePtr = (NkByte *)poolPtr->mp_blockPtr;
+    NkSize  const blStart = __NkInt_PoolAllocCalcPoolHeadSize(poolPtr->m_maxBlockCount, gl_BlockAlign);
+
+    return __NkVirt_Alloc_CommitRange(basePtr, newCount * sizeof(__NkInt_PoolAllocBlockHead))
+        && __NkVirt_Alloc_CommitRange(basePtr + blStart, (NkSize)newCount * poolPtr->m_blockSize)
+    ;
+}
+
+/**
+ * \brief  reserves the address range of a pool backed by virtual memory
+ * \param  [in,out] poolPtr pointer to the new pool; \c m_blockSize, \c m_blockCount, and
+ *                  \c m_poolBacking must be set
+ * \return \c NK_TRUE on success, \c NK_FALSE on failure
+ * \note   On success, \c mp_blockPtr and \c m_maxBlockCount are set and \c m_blockCount
+ *         blocks are committed. Pools backed by large pages are committed in their
+ *         entirety, so \c m_blockCount is raised to <tt>m_maxBlockCount</tt>.
+ */
+NK_INTERNAL NkBoolean __NkInt_PoolAllocMapPool(_Inout_ __NkInt_PoolAllocMemoryPool *poolPtr) {
+    NkBoolean const isLarge  = poolPtr->m_poolBacking == NkPoolBack_LargePages;
+    NkSize    const pageSize = isLarge ? gl_PoolAllocCxt.m_largePageSize : gl_PageSize;
+
+    /*
+     * Reserve room for at least the requested blocks and the alignment padding of the
+     * header section. Ranges backed by regular pages are cheap to reserve as long as they
+     * are not committed, so reserve a large range that the pool can grow into.
+     */
+    NkSize rangeSize = (NkSize)__NkInt_PoolAllocCalcPoolSize(poolPtr->m_blockCount, poolPtr->m_blockSize, gl_BlockAlign) + gl_BlockAlign;
+    if (!isLarge)
+        rangeSize = NK_MAX(rangeSize, NK_ALLOC_VMPOOLSIZE);
+    rangeSize = (rangeSize + pageSize - 1) / pageSize * pageSize;
+    if (rangeSize > UINT32_MAX)
+        return NK_FALSE;
+
+    if ((poolPtr->mp_blockPtr = __NkVirt_Alloc_ReserveRange(rangeSize, isLarge)) == NULL)
+        return NK_FALSE;
+    poolPtr->m_maxBlockCount = (NkUint32)((rangeSize - gl_BlockAlign) / (poolPtr->m_blockSize + sizeof(__NkInt_PoolAllocBlockHead)));
+
+    if (isLarge) {
+        poolPtr->m_blockCount = poolPtr->m_maxBlockCount;
+
+        return NK_TRUE;
+    }
+    if (__NkInt_PoolAllocCommitBlocks(poolPtr, poolPtr->m_blockCount) == NK_FALSE) {
+        __NkVirt_Alloc_ReleaseRange(poolPtr->mp_blockPtr);
+
+        return NK_FALSE;
+    }
+    return NK_TRUE;
+}
+
+/**
+ * \brief  grows a pool backed by reserved address space in place
+ * \param  [in,out] poolPtr pointer to the pool that is to be grown
+ * \param  [in] minGrowth minimum number of blocks that are to be added
+ * \return \c NK_TRUE if the pool was grown, \c NK_FALSE if not
+ * \note   The pool at least doubles in size unless it reaches its reservation, so that
+ *         pages are not committed one by one. The block addresses do not change.
+ */
+NK_INTERNAL NkBoolean __NkInt_PoolAllocGrowPool(
+    _Inout_ __NkInt_PoolAllocMemoryPool *poolPtr,
+    _In_    NkUint32 minGrowth
+) {
+    if (poolPtr->m_poolBacking != NkPoolBack_Virtual || poolPtr->m_maxBlockCount - poolPtr->m_blockCount < minGrowth)
+        return NK_FALSE;
+
+    NkUint32 const oldCount = poolPtr->m_blockCount;
+    NkUint32 const newCount = NK_MIN(poolPtr->m_maxBlockCount, NK_MAX(oldCount * 2, oldCount + minGrowth));
+    if (__NkInt_PoolAllocCommitBlocks(poolPtr, newCount) == NK_FALSE)
+        return NK_FALSE;
+
+    /* The new blocks are free; if the pool was full, they are the first free blocks. */
+    poolPtr->m_blockCount = newCount;
+    if (poolPtr->m_fFreeInd == UINT32_MAX)
+        poolPtr->m_fFreeInd = oldCount;
+
+    NK_LOG_TRACE(
+        "Grew memory pool 0x%p (s=%u) in place from %u to %u blocks (max: %u).",
+        poolPtr,
+        poolPtr->m_blockSize,
+        oldCount,
+        newCount,
+        poolPtr->m_maxBlockCount
+    );
+    return NK_TRUE;
+}
+
+/**
+ * \brief releases the memory of the given pool
+ * \param [in,out] poolPtr pointer to the pool whose memory is to be released
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_PoolAllocReleasePool(_Inout_ __NkInt_PoolAllocMemoryPool *poolPtr) {
+    if (poolPtr->m_poolBacking == NkPoolBack_Heap)
+        NkGPFree(poolPtr->mp_blockPtr);
+    else
+        __NkVirt_Alloc_ReleaseRange(poolPtr->mp_blockPtr);
+}
+
 /**
  * \brief  allocates a new memory pool with the given properties
  * \param  [in] blockCount number of blocks in the pool
@@ -303,6 +881,9 @@ NK_INTERNAL NK_INLINE NkUint32 __NkInt_PoolAllocAdjustPoolMetrics(
  * \param  [out] poolPtr pointer to a variable that will receive the pointer to the pool
  *               that just got allocated
  * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The pool memory is obtained as selected with <tt>NkPoolSetBacking()</tt>. If
+ *         the address range for the pool cannot be reserved, the pool is allocated using
+ *         the general-purpose allocator instead.
  */
 NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_PoolAllocRequestNewPool(
     _In_     NkUint32 blockCount,
@@ -316,34 +897,53 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_PoolAllocRequestNewPool(
     if (gl_PoolAllocCxt.m_firstFreePool == UINT32_MAX)
         return NkErr_MemoryAllocation;
 
-    NkVoid *blockPtr = NULL;
+    __NkInt_PoolAllocMemoryPool newPool = {
+        .m_blockSize    = blockSize,
+        .m_blockCount   = blockCount,
+        .m_fFreeInd     = 0,
+        .m_nAllocBlocks = 0,
+        .m_poolBacking  = gl_PoolAllocCxt.m_poolBacking
+    };
     NkUint32 defPoolSize = __NkInt_PoolAllocCalcPoolSize(blockCount, blockSize, gl_BlockAlign);
+
+    /* Reserve the address range of the pool, if requested. */
+    if (newPool.m_poolBacking != NkPoolBack_Heap) {
+        if (__NkInt_PoolAllocMapPool(&newPool) == NK_TRUE)
+            defPoolSize = (NkUint32)__NkInt_PoolAllocCalcPoolHeadSize(newPool.m_maxBlockCount, gl_BlockAlign) + blockSize * newPool.m_blockCount;
+        else {
+            NK_LOG_WARNING(
+                "Could not reserve address space for a memory pool (s=%u, c=%u); using the heap instead.",
+                blockSize,
+                blockCount
+            );
+
+            newPool.m_poolBacking = NkPoolBack_Heap;
+        }
+    }
     /* Allocate the new pool by using the general-purpose allocator. */
-    NkErrorCode errorCode = NkGPAlloc(
-        NK_MAKE_ALLOCATION_CONTEXT(),
-        __NkInt_PoolAllocAdjustPoolMetrics(
-            blockSize,
-            &blockCount,
-            &defPoolSize
-        ),
-        0,
-        NK_FALSE,
-        &blockPtr
-    );
-    if (errorCode ^ NkErr_Ok)
-        return NkErr_MemoryAllocation;
-    /* Zero the block headers. */
-    memset(blockPtr, 0, blockCount * sizeof(__NkInt_PoolAllocBlockHead));
+    if (newPool.m_poolBacking == NkPoolBack_Heap) {
+        NkErrorCode errorCode = NkGPAlloc(
+            NK_MAKE_ALLOCATION_CONTEXT(),
+            __NkInt_PoolAllocAdjustPoolMetrics(
+                blockSize,
+                &newPool.m_blockCount,
+                &defPoolSize
+            ),
+            0,
+            NK_FALSE,
+            &newPool.mp_blockPtr
+        );
+        if (errorCode ^ NkErr_Ok)
+            return NkErr_MemoryAllocation;
+        /* Zero the block headers. */
+        memset(newPool.mp_blockPtr, 0, newPool.m_blockCount * sizeof(__NkInt_PoolAllocBlockHead));
+
+        newPool.m_maxBlockCount = newPool.m_blockCount;
+    }
 
     /* Setup the pool header. */
      *poolPtr = &gl_PoolAllocCxt.m_memPools[gl_PoolAllocCxt.m_firstFreePool];
-    **poolPtr = (__NkInt_PoolAllocMemoryPool){
-        .m_blockCount   = blockCount,
-        .m_fFreeInd     = 0,
-        .m_blockSize    = blockSize,
-        .m_nAllocBlocks = 0,
-        .mp_blockPtr    = blockPtr
-    };
+    **poolPtr = newPool;
     ++gl_PoolAllocCxt.m_nAllocPools;
 
     /*
@@ -363,11 +963,12 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_PoolAllocRequestNewPool(
     }
 
     NK_LOG_TRACE(
-        "Allocated new pool 0x%p of %u elements with a block size of %u. [total size: %u bytes]",
+        "Allocated new pool 0x%p of %u elements with a block size of %u. [total size: %u bytes, max. elements: %u]",
         *poolPtr,
-        blockCount,
+        newPool.m_blockCount,
         blockSize,
-        defPoolSize
+        defPoolSize,
+        newPool.m_maxBlockCount
     );
     return NkErr_Ok;
 }
@@ -385,13 +986,11 @@ NK_INTERNAL NK_INLINE NkBoolean __NkInt_PoolAllocIsInsidePool(
 ) {
     /*
      * If the offset is in the range of the current pool, the memory address lies
-     * within the current pool, so return its index.
+     * within the current pool, so return its index. The header section is sized for
+     * the number of blocks the pool can grow to.
      */
-    NkSize const poolSz = __NkInt_PoolAllocCalcPoolSize(
-        poolPtr->m_blockCount,
-        poolPtr->m_blockSize,
-        gl_BlockAlign
-    );
+    NkSize const poolSz = __NkInt_PoolAllocCalcPoolHeadSize(poolPtr->m_maxBlockCount, gl_BlockAlign)
+        + (NkSize)poolPtr->m_blockSize * poolPtr->m_blockCount;
 
     return memPtr >= poolPtr->mp_blockPtr && (NkSize)((NkByte *)memPtr - (NkByte *)poolPtr->mp_blockPtr) < poolSz;
 }
@@ -442,7 +1041,7 @@ NK_INTERNAL _Return_notnull_ __NkInt_PoolAllocBlockHead *__NkInt_PoolAllocGetHea
     *poolPtr = &gl_PoolAllocCxt.m_memPools[poolInd];
 
     /* Calculate the address of the first block in the pool. */
-    NkSize const headSize = __NkInt_PoolAllocCalcPoolHeadSize((*poolPtr)->m_blockCount, gl_BlockAlign);
+    NkSize const headSize = __NkInt_PoolAllocCalcPoolHeadSize((*poolPtr)->m_maxBlockCount, gl_BlockAlign);
     NkByte const *blStart = (NkByte *)(*poolPtr)->mp_blockPtr + headSize;
     NkByte const *bytePtr = (NkByte const *)memPtr;
     NkSize const  blIndex = (bytePtr - blStart) / (*poolPtr)->m_blockSize;
@@ -510,13 +1109,355 @@ lbl_FINDBLOCK:
 
     return startIndex;
 lbl_FINDNEXT:
-    while (startIndex < poolPtr->m_blockCount && blockPtr->m_blockFlags ^ 0)
+    while (startIndex < poolPtr->m_blockCount && ((__NkInt_PoolAllocBlockHead *)poolPtr->mp_blockPtr)[startIndex].m_blockFlags ^ 0)
         ++startIndex;
 
     /* Found the next free block. Scan the range from there. */
     goto lbl_FINDBLOCK;
 }
 
+/**
+ * \brief  maps a block size to its size class
+ * \param  [in] blockSize size of the block, in bytes; must not exceed
+ *              \c NK_ALLOC_MAXCLASSSIZE
+ * \return index of the smallest size class that can hold \c blockSize bytes
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_PoolCacheGetSizeClass(_In_ NkSize blockSize) {
+    if (blockSize <= 128)
+        return (NkUint32)((blockSize + 7) / 8 - 1);
+
+    /* Determine the power of two below the block size and the quarter inside of it. */
+    NkSize const sizeM1  = blockSize - 1;
+    NkUint32     lgFloor = 7;
+    while (sizeM1 >> (lgFloor + 1))
+        ++lgFloor;
+
+    return 16 + (lgFloor - 7) * 4 + (NkUint32)(sizeM1 >> (lgFloor - 2)) - 4;
+}
+
+/**
+ * \brief  calculates the block size of the given size class
+ * \param  [in] sizeClass index of the size class
+ * \return block size, in bytes
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_PoolCacheGetClassSize(_In_ NkUint32 sizeClass) {
+    if (sizeClass < 16)
+        return (sizeClass + 1) * 8;
+
+    NkUint32 const lgOff   = (sizeClass - 16) / 4;
+    NkUint32 const quarter = (sizeClass - 16) % 4;
+    return (128U << lgOff) + (quarter + 1) * (32U << lgOff);
+}
+
+/**
+ * \brief  calculates the first slot to probe in the segment map for the given segment
+ * \param  [in] segPtr segment address
+ * \return slot index
+ */
+NK_INTERNAL NK_INLINE NkSize __NkInt_PoolCacheHashSegment(_In_ NkVoid const *segPtr) {
+    return (NkSize)((((NkUint64)(NkSize)segPtr / NK_ALLOC_SEGSIZE) * 0x9E3779B97F4A7C15ULL) >> 32) & (NK_ALLOC_SEGMAPSIZE - 1);
+}
+
+/**
+ * \brief  determines the span the given block address is located in
+ * \param  [in] memPtr memory block address
+ * \return pointer to the span header, or \c NULL if the address is not part of a span
+ * \note   Since segments and spans are aligned to their size, this only requires masking
+ *         the address and a lookup in the segment map. The pool allocator lock is not
+ *         required.
+ */
+NK_INTERNAL NK_INLINE __NkInt_PoolSpan *__NkInt_PoolCacheLocateSpan(_In_ NkVoid const *memPtr) {
+    NkVoid const *segPtr = (NkVoid const *)((NkSize)memPtr & ~(NK_ALLOC_SEGSIZE - 1));
+
+    for (NkSize i = __NkInt_PoolCacheHashSegment(segPtr);; i = (i + 1) & (NK_ALLOC_SEGMAPSIZE - 1)) {
+        NkVoid const *slotVal = gl_PoolCacheCxt.mp_segMap[i];
+
+        if (slotVal == segPtr)
+            return (__NkInt_PoolSpan *)((NkSize)memPtr & ~(NK_ALLOC_SPANSIZE - 1));
+        if (slotVal == NULL)
+            return NULL;
+    }
+}
+
+/**
+ * \brief moves all blocks freed by other threads to the local free-list of the span
+ * \param [in, out] spanPtr span to drain
+ * \note  This function must only be called by the owner of the span, or with the pool
+ *        allocator lock held if the span is orphaned.
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_PoolCacheDrainRemote(_Inout_ __NkInt_PoolSpan *spanPtr) {
+    if (spanPtr->mp_remoteFree == NULL)
+        return;
+
+    NkVoid *remList = InterlockedExchangePointer((PVOID volatile *)&spanPtr->mp_remoteFree, NULL);
+    while (remList != NULL) {
+        NkVoid *nextPtr = *(NkVoid **)remList;
+
+        *(NkVoid **)remList   = spanPtr->mp_localFree;
+        spanPtr->mp_localFree = remList;
+        remList = nextPtr;
+
+        --spanPtr->m_nAllocBlocks;
+    }
+}
+
+/**
+ * \brief returns an empty span to the global list of free spans
+ * \param [in, out] spanPtr span that is to be released; must have been removed from the
+ *                  span list of its owner
+ * \note  This function must be called with the pool allocator lock held.
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_PoolCacheReleaseSpan(_Inout_ __NkInt_PoolSpan *spanPtr) {
+    spanPtr->mp_ownerCache       = NULL;
+    spanPtr->mp_nextSpan         = gl_PoolCacheCxt.mp_freeSpans;
+    gl_PoolCacheCxt.mp_freeSpans = spanPtr;
+}
+
+/**
+ * \brief releases all orphaned spans whose blocks have all been freed
+ * \note  This function must be called with the pool allocator lock held.
+ */
+NK_INTERNAL NkVoid __NkInt_PoolCacheReclaimOrphans(NkVoid) {
+    for (__NkInt_PoolSpan **prevNext = &gl_PoolCacheCxt.mp_orphanSpans; *prevNext != NULL;) {
+        __NkInt_PoolSpan *spanPtr = *prevNext;
+
+        __NkInt_PoolCacheDrainRemote(spanPtr);
+        if (spanPtr->m_nAllocBlocks > 0) {
+            prevNext = &spanPtr->mp_nextSpan;
+
+            continue;
+        }
+
+        *prevNext = spanPtr->mp_nextSpan;
+        __NkInt_PoolCacheReleaseSpan(spanPtr);
+    }
+}
+
+/**
+ * \brief  acquires a fresh span of the given block size for the current thread cache
+ * \param  [in, out] cachePtr thread cache that will own the span
+ * \param  [in] sizeClass size class of the span
+ * \return pointer to the new span, or \c NULL if no span could be allocated
+ * \note   This function must be called with the pool allocator lock held.
+ */
+NK_INTERNAL __NkInt_PoolSpan *__NkInt_PoolCacheAcquireSpan(
+    _Inout_ __NkInt_PoolThreadCache *cachePtr,
+    _In_    NkUint32 sizeClass
+) {
+    /* Reuse the spans of exited threads before mapping more memory. */
+    if (gl_PoolCacheCxt.mp_freeSpans == NULL)
+        __NkInt_PoolCacheReclaimOrphans();
+
+    if (gl_PoolCacheCxt.mp_freeSpans == NULL) {
+        /* No spans left; map a new segment. */
+        if (gl_PoolCacheCxt.m_nSegments == NK_ALLOC_NSEGMENTS)
+            return NULL;
+
+        NkByte *segPtr = __NkVirt_Alloc_MapSegment(NK_ALLOC_SEGSIZE);
+        if (segPtr == NULL)
+            return NULL;
+
+        for (NkSize i = NK_ALLOC_SPANSPERSEG; i > 0; i--) {
+            __NkInt_PoolSpan *spanPtr = (__NkInt_PoolSpan *)(segPtr + (i - 1) * NK_ALLOC_SPANSIZE);
+
+            spanPtr->mp_nextSpan         = gl_PoolCacheCxt.mp_freeSpans;
+            gl_PoolCacheCxt.mp_freeSpans = spanPtr;
+        }
+
+        /* Publish the segment in the segment map. */
+        NkSize slotInd = __NkInt_PoolCacheHashSegment(segPtr);
+        while (gl_PoolCacheCxt.mp_segMap[slotInd] != NULL)
+            slotInd = (slotInd + 1) & (NK_ALLOC_SEGMAPSIZE - 1);
+        InterlockedExchangePointer((PVOID volatile *)&gl_PoolCacheCxt.mp_segMap[slotInd], segPtr);
+        gl_PoolCacheCxt.mp_segArr[gl_PoolCacheCxt.m_nSegments++] = segPtr;
+
+        NK_LOG_TRACE("Mapped span segment [%u] (0x%p).", gl_PoolCacheCxt.m_nSegments - 1, segPtr);
+    }
+
+    /* Take the first free span and adopt it. */
+    __NkInt_PoolSpan *spanPtr    = gl_PoolCacheCxt.mp_freeSpans;
+    gl_PoolCacheCxt.mp_freeSpans = spanPtr->mp_nextSpan;
+
+    NkUint32 const blockSize = __NkInt_PoolCacheGetClassSize(sizeClass);
+    *spanPtr = (__NkInt_PoolSpan){
+        .mp_ownerCache  = cachePtr,
+        .mp_nextSpan    = cachePtr->mp_spans[sizeClass],
+        .mp_localFree   = NULL,
+        .mp_remoteFree  = NULL,
+        .m_blockSize    = blockSize,
+        .m_blockCount   = (NkUint32)((NK_ALLOC_SPANSIZE - gl_SpanHeadSize) / blockSize),
+        .m_nBumpBlocks  = 0,
+        .m_nAllocBlocks = 0
+    };
+    return cachePtr->mp_spans[sizeClass] = spanPtr;
+}
+
+/**
+ * \brief  takes a single block from the given span
+ * \param  [in, out] spanPtr span to allocate from
+ * \return pointer to the block, or \c NULL if the span is full
+ * \note   This function must only be called by the owner of the span.
+ */
+NK_INTERNAL NK_INLINE NkVoid *__NkInt_PoolCacheTakeFromSpan(_Inout_ __NkInt_PoolSpan *spanPtr) {
+    /* If the local list is empty, take everything that other threads have freed. */
+    if (spanPtr->mp_localFree == NULL)
+        __NkInt_PoolCacheDrainRemote(spanPtr);
+
+    NkVoid *blockPtr = spanPtr->mp_localFree;
+    if (blockPtr != NULL)
+        spanPtr->mp_localFree = *(NkVoid **)blockPtr;
+    else if (spanPtr->m_nBumpBlocks < spanPtr->m_blockCount)
+        blockPtr = (NkByte *)spanPtr + gl_SpanHeadSize + (NkSize)spanPtr->m_blockSize * spanPtr->m_nBumpBlocks++;
+    else
+        return NULL;
+
+    ++spanPtr->m_nAllocBlocks;
+    return blockPtr;
+}
+
+/**
+ * \brief  allocates a single block from the current thread's cache
+ * \param  [in] allocSize size of the allocation, in bytes; must not exceed
+ *              \c NK_ALLOC_MAXCLASSSIZE
+ * \return pointer to the block, or \c NULL if the thread cache could not serve the
+ *         request
+ * \note   The lock is only taken if the thread cache or a new span needs to be
+ *         allocated.
+ */
+NK_INTERNAL NkVoid *__NkInt_PoolCacheAlloc(_In_ NkSize allocSize) {
+    NkUint32 const sizeClass = __NkInt_PoolCacheGetSizeClass(allocSize);
+    __NkInt_PoolThreadCache *cachePtr = gl_ThreadCache;
+
+    if (cachePtr != NULL) {
+        /* Fast path: the head span of the class usually has a free block. */
+        __NkInt_PoolSpan *headSpan = cachePtr->mp_spans[sizeClass];
+        if (headSpan != NULL) {
+            NkVoid *blockPtr = __NkInt_PoolCacheTakeFromSpan(headSpan);
+            if (blockPtr != NULL)
+                return blockPtr;
+
+            /*
+             * Search the other spans; move the first one with free blocks to the front.
+             * Spans that were emptied by other threads are collected on the way, as the
+             * owner does not notice remote frees otherwise.
+             */
+            __NkInt_PoolSpan *emptyList = NULL;
+            for (__NkInt_PoolSpan **prevNext = &headSpan->mp_nextSpan; *prevNext != NULL;) {
+                __NkInt_PoolSpan *spanPtr = *prevNext;
+
+                __NkInt_PoolCacheDrainRemote(spanPtr);
+                if (spanPtr->m_nAllocBlocks == 0 && blockPtr != NULL) {
+                    *prevNext            = spanPtr->mp_nextSpan;
+                    spanPtr->mp_nextSpan = emptyList;
+                    emptyList            = spanPtr;
+
+                    continue;
+                }
+                if (blockPtr == NULL && (blockPtr = __NkInt_PoolCacheTakeFromSpan(spanPtr)) != NULL) {
+                    *prevNext                     = spanPtr->mp_nextSpan;
+                    spanPtr->mp_nextSpan          = cachePtr->mp_spans[sizeClass];
+                    cachePtr->mp_spans[sizeClass] = spanPtr;
+
+                    continue;
+                }
+                prevNext = &spanPtr->mp_nextSpan;
+            }
+
+            if (emptyList != NULL) {
+                NK_LOCK(gl_PoolAllocCxt.m_mtxLock);
+                while (emptyList != NULL) {
+                    __NkInt_PoolSpan *nextSpan = emptyList->mp_nextSpan;
+
+                    __NkInt_PoolCacheReleaseSpan(emptyList);
+                    emptyList = nextSpan;
+                }
+                NK_UNLOCK(gl_PoolAllocCxt.m_mtxLock);
+            }
+            if (blockPtr != NULL)
+                return blockPtr;
+        }
+    }
+
+    /* Slow path: create the thread cache and/or acquire a new span. */
+    NkVoid *blockPtr = NULL;
+    NK_LOCK(gl_PoolAllocCxt.m_mtxLock);
+    if (cachePtr == NULL) {
+        if (NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *cachePtr, 0, NK_TRUE, (NkVoid **)&cachePtr) != NkErr_Ok)
+            goto lbl_END;
+
+        cachePtr->mp_nextCache       = gl_PoolCacheCxt.mp_cacheList;
+        gl_PoolCacheCxt.mp_cacheList = cachePtr;
+        gl_ThreadCache               = cachePtr;
+    }
+
+    __NkInt_PoolSpan *spanPtr = __NkInt_PoolCacheAcquireSpan(cachePtr, sizeClass);
+    if (spanPtr != NULL)
+        blockPtr = __NkInt_PoolCacheTakeFromSpan(spanPtr);
+
+lbl_END:
+    NK_UNLOCK(gl_PoolAllocCxt.m_mtxLock);
+    return blockPtr;
+}
+
+/**
+ * \brief returns a block to the span it was allocated from
+ * \param [in, out] spanPtr span the block belongs to
+ * \param [in] memPtr address of the block
+ * \note  If the calling thread owns the span, the block is put on the local free-list.
+ *        Otherwise, it is pushed onto the span's remote free-list without locking.
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_PoolCacheFree(_Inout_ __NkInt_PoolSpan *spanPtr, _Inout_ NkVoid *memPtr) {
+    __NkInt_PoolThreadCache *cachePtr = gl_ThreadCache;
+
+    if (spanPtr->mp_ownerCache == cachePtr && cachePtr != NULL) {
+        *(NkVoid **)memPtr    = spanPtr->mp_localFree;
+        spanPtr->mp_localFree = memPtr;
+
+        /*
+         * Empty spans are handed back so that other threads can use them; the head span
+         * is kept so that alternating allocations and frees do not take the lock.
+         */
+        if (--spanPtr->m_nAllocBlocks > 0)
+            return;
+        __NkInt_PoolSpan **prevNext = &cachePtr->mp_spans[__NkInt_PoolCacheGetSizeClass(spanPtr->m_blockSize)];
+        if (*prevNext == spanPtr)
+            return;
+        while (*prevNext != spanPtr)
+            prevNext = &(*prevNext)->mp_nextSpan;
+        *prevNext = spanPtr->mp_nextSpan;
+
+        NK_SYNCHRONIZED(gl_PoolAllocCxt.m_mtxLock, __NkInt_PoolCacheReleaseSpan(spanPtr));
+        return;
+    }
+
+    NkVoid *currHead;
+    do {
+        currHead = spanPtr->mp_remoteFree;
+
+        *(NkVoid **)memPtr = currHead;
+    } while (InterlockedCompareExchangePointer((PVOID volatile *)&spanPtr->mp_remoteFree, memPtr, currHead) != currHead);
+}
+
+/**
+ * \brief warns about blocks of a span that were never freed
+ * \param [in] spanPtr span to check
+ * \note  This function is only called on shutdown, after all other threads have exited.
+ */
+NK_INTERNAL NkVoid __NkInt_PoolCacheReportLeaks(_In_ __NkInt_PoolSpan const *spanPtr) {
+    NkUint32 nAllocBlocks = spanPtr->m_nAllocBlocks;
+    for (NkVoid *remList = spanPtr->mp_remoteFree; remList != NULL; remList = *(NkVoid **)remList)
+        --nAllocBlocks;
+
+    if (nAllocBlocks > 0)
+        NK_LOG_WARNING(
+            "Span 0x%p (s=%u, c=%u) has %u blocks still allocated.",
+            spanPtr,
+            spanPtr->m_blockSize,
+            spanPtr->m_blockCount,
+            nAllocBlocks
+        );
+}
+
 /**
  * \brief  initializes the global memory allocators
  * \return \c NkErr_Ok on success, non-zero on failure
@@ -525,9 +1466,25 @@ lbl_FINDNEXT:
  *             threads that might access the shared allocators are started.
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(Allocators)(NkVoid) {
-    /* Initialize pool allocator lock. */
+    /* Initialize pool allocator and tracker locks. */
     NK_INITLOCK(gl_PoolAllocCxt.m_mtxLock);
+    NK_INITLOCK(gl_AllocTrackCxt.m_mtxLock);
+
+    /* Round pools to the actual page size of the system. */
+    gl_PageSize = (NkUint32)__NkVirt_Alloc_GetPageSize();
+
+    /* Create the per-frame arenas. */
+    for (NkUint32 i = 0; i < NK_ARRAYSIZE(gl_FrameArenas); i++) {
+        NkErrorCode errCode = NkArenaCreate(NK_MAKE_ALLOCATION_CONTEXT(), 0, &gl_FrameArenas[i]);
+        if (errCode != NkErr_Ok) {
+            NkArenaDestroy(&gl_FrameArenas[0]);
+            NK_DESTROYLOCK(gl_AllocTrackCxt.m_mtxLock);
+            NK_DESTROYLOCK(gl_PoolAllocCxt.m_mtxLock);
 
+            return errCode;
+        }
+    }
+    gl_PoolCacheCxt.m_isActive = NK_TRUE;
     return NkErr_Ok;
 }
 
@@ -540,6 +1497,35 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(Allocators)(N
  *             threads that may access the shared allocators have been terminated.
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(Allocators)(NkVoid) {
+    /* If tracking is enabled, print the final report; live allocations are leaks. */
+    if (gl_AllocTrackCxt.m_isEnabled == NK_TRUE) {
+        NkAllocDumpReport(0);
+
+        NkAllocSetTracking(NK_FALSE);
+    }
+    NK_DESTROYLOCK(gl_AllocTrackCxt.m_mtxLock);
+
+    /* Destroy the per-frame arenas. */
+    for (NkUint32 i = 0; i < NK_ARRAYSIZE(gl_FrameArenas); i++)
+        NkArenaDestroy(&gl_FrameArenas[i]);
+
+    /* Free all thread caches and span segments. */
+    for (__NkInt_PoolThreadCache *currCache = gl_PoolCacheCxt.mp_cacheList, *nextCache; currCache != NULL; currCache = nextCache) {
+        nextCache = currCache->mp_nextCache;
+
+        for (NkUint32 i = 0; i < NK_ALLOC_NSIZECLASSES; i++)
+            for (__NkInt_PoolSpan *spanPtr = currCache->mp_spans[i]; spanPtr != NULL; spanPtr = spanPtr->mp_nextSpan)
+                __NkInt_PoolCacheReportLeaks(spanPtr);
+
+        NkGPFree(currCache);
+    }
+    for (__NkInt_PoolSpan *spanPtr = gl_PoolCacheCxt.mp_orphanSpans; spanPtr != NULL; spanPtr = spanPtr->mp_nextSpan)
+        __NkInt_PoolCacheReportLeaks(spanPtr);
+    for (NkUint32 i = 0; i < gl_PoolCacheCxt.m_nSegments; i++)
+        __NkVirt_Alloc_UnmapSegment(gl_PoolCacheCxt.mp_segArr[i]);
+    gl_PoolCacheCxt = (__NkInt_PoolCacheContext){ .mp_cacheList = NULL };
+    gl_ThreadCache  = NULL;
+
     /* Free all remaining memory pools. */
     for (NkUint32 i = 0, j = 0; i < gl_MaxPools && j < gl_PoolAllocCxt.m_nAllocPools; i++) {
         /* Skip unallocated pools. */
@@ -558,7 +1544,7 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(Allocators)(
             gl_PoolAllocCxt.m_memPools[i].m_nAllocBlocks
         );
 
-        NkGPFree(gl_PoolAllocCxt.m_memPools[i].mp_blockPtr);
+        __NkInt_PoolAllocReleasePool(&gl_PoolAllocCxt.m_memPools[i]);
         ++j;
     }
 
@@ -582,10 +1568,11 @@ _Return_ok_ NkErrorCode NK_CALL NkGPAlloc(
     NK_ASSERT(memPtr != NULL, NkErr_OutptrParameter);
 
     /* Allocate memory block. */
-    return (*memPtr = __NkInt_AllocateMemoryUnaligned(allocCxt, sizeInBytes, isZeroed)) != NULL
-        ? NkErr_Ok
-        : NkErr_MemoryAllocation
-    ;
+    if ((*memPtr = __NkInt_AllocateMemoryUnaligned(allocCxt, sizeInBytes, isZeroed)) == NULL)
+        return NkErr_MemoryAllocation;
+
+    __NkInt_AllocTrackOnAlloc(allocCxt, *memPtr, sizeInBytes);
+    return NkErr_Ok;
 };
 
 _Return_ok_ NkErrorCode NK_CALL NkGPRealloc(
@@ -600,6 +1587,8 @@ _Return_ok_ NkErrorCode NK_CALL NkGPRealloc(
     NkVoid *newMemPtr = __NkInt_ReallocateMemoryUnaligned(allocCxt, newSizeInBytes, *memPtr);
     if (newMemPtr == NULL)
         return NkErr_MemoryReallocation;
+    __NkInt_AllocTrackOnFree(*memPtr);
+    __NkInt_AllocTrackOnAlloc(allocCxt, newMemPtr, newSizeInBytes);
 
     /* Update current pointer. */
     *memPtr = newMemPtr;
@@ -610,6 +1599,7 @@ NkVoid NK_CALL NkGPFree(NkVoid *memPtr) {
     if (memPtr == NULL)
         return;
 
+    __NkInt_AllocTrackOnFree(memPtr);
     __NkInt_FreeMemoryUnaligned(memPtr);
 }
 
@@ -621,11 +1611,23 @@ _Return_ok_ NkErrorCode NK_CALL NkPoolAlloc(
     _In_opt_   NkUint32 blockCount,
     _Init_ptr_ NkVoid **memPtr
 ) {
-    NK_UNREFERENCED_PARAMETER(allocCxt);
     NK_ASSERT(blockSize != 0 && blockSize % 8 == 0, NkErr_InParameter);
     NK_ASSERT(blockCount != 0, NkErr_InParameter);
     NK_ASSERT(memPtr != NULL, NkErr_OutptrParameter);
 
+    /*
+     * Allocations of up to NK_ALLOC_MAXCLASSSIZE bytes in total are served by the thread
+     * cache without taking the lock. If the cache cannot serve the allocation, fall back
+     * to the global pools.
+     */
+    NkUint64 const allocSize = (NkUint64)blockSize * blockCount;
+    if (allocSize <= NK_ALLOC_MAXCLASSSIZE)
+        if ((*memPtr = __NkInt_PoolCacheAlloc((NkSize)allocSize)) != NULL) {
+            __NkInt_AllocTrackOnAlloc(allocCxt, *memPtr, (NkSize)allocSize);
+
+            return NkErr_Ok;
+        }
+
     NK_LOCK(gl_PoolAllocCxt.m_mtxLock);
 
     /*
@@ -633,6 +1635,7 @@ _Return_ok_ NkErrorCode NK_CALL NkPoolAlloc(
      * allocation.
      */
     __NkInt_PoolAllocMemoryPool *memPool;
+    __NkInt_PoolAllocMemoryPool *growPool = NULL;
     NkUint32 blockIndex = 0;
     for (NkUint32 i = 0, j = 0; i < gl_MaxPools && j < gl_PoolAllocCxt.m_nAllocPools; i++) {
         if ((memPool = &gl_PoolAllocCxt.m_memPools[i])->m_blockSize == 0)
@@ -640,13 +1643,22 @@ _Return_ok_ NkErrorCode NK_CALL NkPoolAlloc(
 
         /*
          * Found a block with a suitable block size; check if it contains a free range
-         * that is large enough to hold the allocation.
+         * that is large enough to hold the allocation. Remember the first pool that
+         * could grow in place in case no pool has room.
          */
-        if (memPool->m_blockSize == blockSize)
+        if (memPool->m_blockSize == blockSize) {
             if ((blockIndex = __NkInt_PoolAllocFindRangeInPool(memPool, blockCount)) ^ UINT32_MAX)
                 goto lbl_ALLOCBLOCK;
+
+            if (growPool == NULL && memPool->m_maxBlockCount - memPool->m_blockCount >= blockCount)
+                growPool = memPool;
+        }
         ++j;
     }
+    /* Growing a pool in place is cheaper than creating a new one. */
+    if (growPool != NULL && __NkInt_PoolAllocGrowPool(growPool, blockCount) == NK_TRUE)
+        if ((blockIndex = __NkInt_PoolAllocFindRangeInPool(memPool = growPool, blockCount)) ^ UINT32_MAX)
+            goto lbl_ALLOCBLOCK;
     memPool = NULL;
     
 lbl_ALLOCBLOCK:
@@ -688,9 +1700,9 @@ lbl_ALLOCBLOCK:
         }
 
 lbl_RETBLOCKPTR:
-        *memPtr = (NkByte *)(basePtr + memPool->m_blockCount)
-            + (memPool->m_blockCount * sizeof *specPtr) % gl_BlockAlign
-            + memPool->m_blockSize * (&basePtr[blockIndex] - basePtr);
+        *memPtr = (NkByte *)basePtr
+            + __NkInt_PoolAllocCalcPoolHeadSize(memPool->m_maxBlockCount, gl_BlockAlign)
+            + (NkSize)memPool->m_blockSize * blockIndex;
 
         NK_LOG_TRACE(
             "Allocated %u memory block(s) [%u - %u] (0x%p) [base: 0x%p] in pool [%u] (0x%p).",
@@ -703,14 +1715,17 @@ lbl_RETBLOCKPTR:
             memPool
         );
         NK_UNLOCK(gl_PoolAllocCxt.m_mtxLock);
+
+        __NkInt_AllocTrackOnAlloc(allocCxt, *memPtr, (NkSize)allocSize);
         return NkErr_Ok;
     }
 
     /*
      * If no such memory pool could be found, allocate a new pool if possible and
-     * allocate the new block at its first index.
+     * allocate the new block at its first index. The pool must at least be able to hold
+     * the allocation.
      */
-    NkErrorCode errorCode = __NkInt_PoolAllocRequestNewPool(gl_DefBlockCount, blockSize, &memPool);
+    NkErrorCode errorCode = __NkInt_PoolAllocRequestNewPool(NK_MAX(gl_DefBlockCount, blockCount), blockSize, &memPool);
     blockIndex = 0;
     if (errorCode != NkErr_Ok) {
         NK_UNLOCK(gl_PoolAllocCxt.m_mtxLock);
@@ -746,6 +1761,15 @@ _Return_ok_ NkErrorCode NK_CALL NkPoolReserve(_In_ NkUint32 blockSize, _In_ NkUi
 NkVoid NK_CALL NkPoolFree(_Inout_opt_ NkVoid *memPtr) {
     if (memPtr == NULL)
         return;
+    __NkInt_AllocTrackOnFree(memPtr);
+
+    /* Return blocks that were allocated by a thread cache to their span. */
+    __NkInt_PoolSpan *spanPtr = __NkInt_PoolCacheLocateSpan(memPtr);
+    if (spanPtr != NULL) {
+        __NkInt_PoolCacheFree(spanPtr, memPtr);
+
+        return;
+    }
 
     NK_LOCK(gl_PoolAllocCxt.m_mtxLock);
 
@@ -790,7 +1814,7 @@ NkVoid NK_CALL NkPoolFree(_Inout_opt_ NkVoid *memPtr) {
             if (gl_PoolAllocCxt.m_memPools[i].m_blockSize == 0)
                 gl_PoolAllocCxt.m_firstFreePool = i;
         /* Free the pool memory. */
-        NkGPFree(poolPtr->mp_blockPtr);
+        __NkInt_PoolAllocReleasePool(poolPtr);
 
         /* Lastly, reset the pool header. */
         NK_LOG_TRACE(
@@ -802,11 +1826,13 @@ NkVoid NK_CALL NkPoolFree(_Inout_opt_ NkVoid *memPtr) {
             gl_PoolAllocCxt.m_nAllocPools - 1
         );
         *poolPtr = (__NkInt_PoolAllocMemoryPool){
-            .m_blockSize    = 0,
-            .m_blockCount   = 0,
-            .m_fFreeInd     = 0,
-            .m_nAllocBlocks = 0,
-            .mp_blockPtr    = NULL
+            .m_blockSize     = 0,
+            .m_blockCount    = 0,
+            .m_maxBlockCount = 0,
+            .m_fFreeInd      = 0,
+            .m_nAllocBlocks  = 0,
+            .m_poolBacking   = NkPoolBack_Heap,
+            .mp_blockPtr     = NULL
         };
         --gl_PoolAllocCxt.m_nAllocPools;
     }
@@ -817,6 +1843,11 @@ NkVoid NK_CALL NkPoolFree(_Inout_opt_ NkVoid *memPtr) {
 NkUint32 NK_CALL NkPoolGetBlockSize(_In_ NkVoid const *memPtr) {
     NK_ASSERT(memPtr != NULL, NkErr_InParameter);
 
+    /* Allocations from thread caches always occupy exactly one block of a size class. */
+    __NkInt_PoolSpan const *spanPtr = __NkInt_PoolCacheLocateSpan(memPtr);
+    if (spanPtr != NULL)
+        return spanPtr->m_blockSize;
+
     NkUint32 res;
     NK_SYNCHRONIZED(gl_PoolAllocCxt.m_mtxLock, {
         /* Get the memory pool the memory block pointed to by *memPtr* is located in. */
@@ -833,6 +1864,11 @@ NkUint32 NK_CALL NkPoolGetBlockSize(_In_ NkVoid const *memPtr) {
 NkUint32 NK_CALL NkPoolGetAllocSize(_In_ NkVoid const *memPtr) {
     NK_ASSERT(memPtr != NULL, NkErr_InParameter);
 
+    /* Allocations from thread caches always occupy exactly one block of a size class. */
+    __NkInt_PoolSpan const *spanPtr = __NkInt_PoolCacheLocateSpan(memPtr);
+    if (spanPtr != NULL)
+        return spanPtr->m_blockSize;
+
     NkUint32 res;
     NK_SYNCHRONIZED(gl_PoolAllocCxt.m_mtxLock, {
         /*
@@ -857,6 +1893,347 @@ NkUint32 NK_CALL NkPoolGetAllocSize(_In_ NkVoid const *memPtr) {
     return res;
 }
 
+NkVoid NK_CALL NkAllocReleaseThreadCache(NkVoid) {
+    __NkInt_PoolThreadCache *cachePtr = gl_ThreadCache;
+    if (cachePtr == NULL)
+        return;
+    /*
+     * Threads of components that are shut down after the allocators, like the log writer,
+     * exit after all caches were freed.
+     */
+    if (!gl_PoolCacheCxt.m_isActive) {
+        gl_ThreadCache = NULL;
+
+        return;
+    }
+
+    NK_LOCK(gl_PoolAllocCxt.m_mtxLock);
+    for (NkUint32 i = 0; i < NK_ALLOC_NSIZECLASSES; i++)
+        for (__NkInt_PoolSpan *spanPtr = cachePtr->mp_spans[i], *nextSpan; spanPtr != NULL; spanPtr = nextSpan) {
+            nextSpan = spanPtr->mp_nextSpan;
+
+            __NkInt_PoolCacheDrainRemote(spanPtr);
+            if (spanPtr->m_nAllocBlocks == 0) {
+                __NkInt_PoolCacheReleaseSpan(spanPtr);
+
+                continue;
+            }
+
+            /* Blocks still in use keep the span alive; it is reclaimed once they are freed. */
+            spanPtr->mp_ownerCache         = &gl_OrphanCache;
+            spanPtr->mp_nextSpan           = gl_PoolCacheCxt.mp_orphanSpans;
+            gl_PoolCacheCxt.mp_orphanSpans = spanPtr;
+        }
+
+    for (__NkInt_PoolThreadCache **prevNext = &gl_PoolCacheCxt.mp_cacheList; *prevNext != NULL; prevNext = &(*prevNext)->mp_nextCache)
+        if (*prevNext == cachePtr) {
+            *prevNext = cachePtr->mp_nextCache;
+
+            break;
+        }
+    NK_UNLOCK(gl_PoolAllocCxt.m_mtxLock);
+
+    gl_ThreadCache = NULL;
+    NkGPFree(cachePtr);
+}
+
+NkVoid NK_CALL NkPoolQueryStatistics(_Out_ NkPoolStatistics *statPtr) {
+    NK_ASSERT(statPtr != NULL, NkErr_OutParameter);
+
+    *statPtr = (NkPoolStatistics){ .m_structSize = sizeof *statPtr };
+
+    NK_LOCK(gl_PoolAllocCxt.m_mtxLock);
+    for (NkUint32 i = 0; i < gl_MaxPools; i++) {
+        __NkInt_PoolAllocMemoryPool const *poolPtr = &gl_PoolAllocCxt.m_memPools[i];
+        if (poolPtr->mp_blockPtr == NULL)
+            continue;
+
+        ++statPtr->m_nPools;
+        statPtr->m_poolBlocks += poolPtr->m_blockCount;
+        statPtr->m_poolUsed   += poolPtr->m_nAllocBlocks;
+        statPtr->m_totalBytes += (NkUint64)poolPtr->m_blockCount * poolPtr->m_blockSize;
+        statPtr->m_usedBytes  += (NkUint64)poolPtr->m_nAllocBlocks * poolPtr->m_blockSize;
+    }
+
+    /*
+     * Walk the segments rather than the span lists of the thread caches; the owners
+     * reorder their lists without taking the lock. Spans that are not adopted by any
+     * cache have no owner.
+     */
+    for (NkUint32 i = 0; i < gl_PoolCacheCxt.m_nSegments; i++)
+        for (NkSize j = 0; j < NK_ALLOC_SPANSPERSEG; j++) {
+            __NkInt_PoolSpan const *spanPtr = (__NkInt_PoolSpan const *)((NkByte const *)gl_PoolCacheCxt.mp_segArr[i] + j * NK_ALLOC_SPANSIZE);
+            if (spanPtr->mp_ownerCache == NULL)
+                continue;
+
+            NkUint32 const nUsed = NK_MIN(spanPtr->m_nAllocBlocks, spanPtr->m_blockCount);
+            ++statPtr->m_nSpans;
+            statPtr->m_spanBlocks += spanPtr->m_blockCount;
+            statPtr->m_spanUsed   += nUsed;
+            statPtr->m_totalBytes += (NkUint64)spanPtr->m_blockCount * spanPtr->m_blockSize;
+            statPtr->m_usedBytes  += (NkUint64)nUsed * spanPtr->m_blockSize;
+        }
+    NK_UNLOCK(gl_PoolAllocCxt.m_mtxLock);
+}
+
+NkPoolBacking NK_CALL NkPoolSetBacking(_In_ NkPoolBacking poolBacking) {
+    NK_ASSERT(poolBacking >= 0 && poolBacking < __NkPoolBack_Count__, NkErr_InParameter);
+
+    /* Large pages need a privilege that has to be enabled first; it may not be granted. */
+    NkSize largePageSize = 0;
+    if (poolBacking == NkPoolBack_LargePages && (largePageSize = __NkVirt_Alloc_EnableLargePages()) == 0) {
+        NK_LOG_WARNING("Large pages are not available; committing pool memory on demand instead.");
+
+        poolBacking = NkPoolBack_Virtual;
+    }
+
+    NK_SYNCHRONIZED(gl_PoolAllocCxt.m_mtxLock, {
+        gl_PoolAllocCxt.m_poolBacking = poolBacking;
+        if (largePageSize != 0)
+            gl_PoolAllocCxt.m_largePageSize = largePageSize;
+    });
+    return poolBacking;
+}
+
+
+/**
+ * \brief  allocates a new block for the given arena and makes it the current block
+ * \param  [in, out] arenaPtr arena the block is for
+ * \param  [in] blockSize usable size of the new block, in bytes
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_ArenaPushBlock(_Inout_ NkArena *arenaPtr, _In_ NkSize blockSize) {
+    __NkInt_ArenaBlock *newBlock;
+
+    NkErrorCode errCode = NkGPAlloc(
+        arenaPtr->mp_allocCxt,
+        sizeof *newBlock + blockSize,
+        0,
+        NK_FALSE,
+        (NkVoid **)&newBlock
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    newBlock->mp_prevBlock = arenaPtr->mp_currBlock;
+    newBlock->m_blockSize  = blockSize;
+    newBlock->m_blockOff   = 0;
+    arenaPtr->mp_currBlock = newBlock;
+    arenaPtr->m_totalSize += blockSize;
+    return NkErr_Ok;
+}
+
+
+_Return_ok_ NkErrorCode NK_CALL NkArenaCreate(
+    _In_opt_   NkAllocationContext const *allocCxt,
+    _In_opt_   NkSize initCap,
+    _Init_ptr_ NkArena **arenaPtr
+) {
+    NK_ASSERT(arenaPtr != NULL, NkErr_OutptrParameter);
+
+    /* Allocate memory for the arena. */
+    NkErrorCode errCode = NkGPAlloc(allocCxt, sizeof **arenaPtr, 0, NK_TRUE, (NkVoid **)arenaPtr);
+    if (errCode != NkErr_Ok) {
+        *arenaPtr = NULL;
+
+        return errCode;
+    }
+    /* The context is usually a compound literal of the caller's, so it is copied. */
+    if (allocCxt != NULL) {
+        (*arenaPtr)->m_allocCxt  = *allocCxt;
+        (*arenaPtr)->mp_allocCxt = &(*arenaPtr)->m_allocCxt;
+    }
+
+    /* Allocate the initial block. */
+    errCode = __NkInt_ArenaPushBlock(*arenaPtr, initCap > 0 ? initCap : gl_DefArenaCap);
+    if (errCode != NkErr_Ok) {
+        NkGPFree(*arenaPtr);
+
+        *arenaPtr = NULL;
+    }
+    return errCode;
+}
+
+NkVoid NK_CALL NkArenaDestroy(_Uninit_ptr_ NkArena **arenaPtr) {
+    NK_ASSERT(arenaPtr != NULL, NkErr_InOutParameter);
+    if (*arenaPtr == NULL)
+        return;
+
+    /* Free all blocks. */
+    for (__NkInt_ArenaBlock *currBlock = (*arenaPtr)->mp_currBlock, *prevBlock; currBlock != NULL; currBlock = prevBlock) {
+        prevBlock = currBlock->mp_prevBlock;
+
+        NkGPFree(currBlock);
+    }
+
+    NkGPFree(*arenaPtr);
+    *arenaPtr = NULL;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkArenaAlloc(
+    _Inout_    NkArena *arenaPtr,
+    _In_       NkSize sizeInBytes,
+    _In_opt_   NkSize alignInBytes,
+    _Init_ptr_ NkVoid **memPtr
+) {
+    NK_ASSERT(arenaPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(sizeInBytes ^ 0, NkErr_InParameter);
+    NK_ASSERT((alignInBytes & (alignInBytes - 1)) == 0, NkErr_InParameter);
+    NK_ASSERT(memPtr != NULL, NkErr_OutptrParameter);
+
+    NkSize const align = alignInBytes > 0 ? alignInBytes : gl_DefArenaAlign;
+
+    /*
+     * Calculate the aligned offset inside the current block. The block memory itself is
+     * 16-byte aligned, so larger alignments are handled by aligning the actual address.
+     */
+    __NkInt_ArenaBlock *currBlock = arenaPtr->mp_currBlock;
+    NkSize blockBase = (NkSize)(currBlock + 1);
+    NkSize allocOff  = ((blockBase + currBlock->m_blockOff + align - 1) & ~(align - 1)) - blockBase;
+
+    if (allocOff + sizeInBytes > currBlock->m_blockSize) {
+        /*
+         * Current block is exhausted. Allocate a new one that is at least as big as the
+         * arena's total size so far to keep the number of blocks logarithmic.
+         */
+        NkErrorCode errCode = __NkInt_ArenaPushBlock(
+            arenaPtr,
+            NK_MAX(arenaPtr->m_totalSize, sizeInBytes + align)
+        );
+        if (errCode != NkErr_Ok) {
+            *memPtr = NULL;
+
+            return errCode;
+        }
+
+        currBlock = arenaPtr->mp_currBlock;
+        blockBase = (NkSize)(currBlock + 1);
+        allocOff  = ((blockBase + align - 1) & ~(align - 1)) - blockBase;
+    }
+
+    /* Bump the pointer. */
+    *memPtr = (NkVoid *)(blockBase + allocOff);
+    currBlock->m_blockOff = allocOff + sizeInBytes;
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkArenaReset(_Inout_ NkArena *arenaPtr) {
+    NK_ASSERT(arenaPtr != NULL, NkErr_InOutParameter);
+
+    __NkInt_ArenaBlock *currBlock = arenaPtr->mp_currBlock;
+    if (currBlock->mp_prevBlock == NULL) {
+        /* Only one block; just rewind it. */
+        currBlock->m_blockOff = 0;
+
+        return;
+    }
+
+    /*
+     * The arena grew since the last reset. Replace all blocks by a single block that is
+     * big enough to hold all of them so that the next cycle does not need to grow again.
+     */
+    NkSize const newSize = arenaPtr->m_totalSize;
+    arenaPtr->mp_currBlock = NULL;
+    arenaPtr->m_totalSize  = 0;
+
+    /* Fall back to the default capacity. If that fails too, we are out of memory. */
+    if (__NkInt_ArenaPushBlock(arenaPtr, newSize) != NkErr_Ok && __NkInt_ArenaPushBlock(arenaPtr, gl_DefArenaCap) != NkErr_Ok) {
+        NK_LOG_CRITICAL("Could not reallocate arena memory (size=%zu).", newSize);
+
+        /* Keep the old blocks so that the arena stays usable; only the current one is reused. */
+        arenaPtr->mp_currBlock = currBlock;
+        arenaPtr->m_totalSize  = newSize;
+        currBlock->m_blockOff  = 0;
+        return;
+    }
+
+    for (__NkInt_ArenaBlock *prevBlock; currBlock != NULL; currBlock = prevBlock) {
+        prevBlock = currBlock->mp_prevBlock;
+
+        NkGPFree(currBlock);
+    }
+}
+
+NkArena *NK_CALL NkArenaGetFrameArena(NkVoid) {
+    return gl_FrameArenas[gl_CurrFrameArena];
+}
+
+NkVoid NK_CALL NkArenaBeginFrame(NkVoid) {
+    gl_CurrFrameArena ^= 1;
+    if (gl_AllocTrackCxt.m_isEnabled == NK_TRUE)
+        ++gl_AllocTrackCxt.m_nFrames;
+
+    NkArenaReset(gl_FrameArenas[gl_CurrFrameArena]);
+}
+
+
+NkVoid NK_CALL NkAllocSetTracking(_In_ NkBoolean isEnabled) {
+    NK_SYNCHRONIZED(gl_AllocTrackCxt.m_mtxLock, {
+        if (gl_AllocTrackCxt.m_isEnabled == isEnabled)
+            break;
+
+        /* Discard all previously collected data. */
+        if (gl_AllocTrackCxt.mp_entryArr != NULL)
+            __NkInt_FreeMemoryUnaligned(gl_AllocTrackCxt.mp_entryArr);
+        memset(gl_AllocTrackCxt.m_siteArr, 0, sizeof gl_AllocTrackCxt.m_siteArr);
+        gl_AllocTrackCxt.mp_entryArr = NULL;
+        gl_AllocTrackCxt.m_entryCap  = 0;
+        gl_AllocTrackCxt.m_nEntries  = 0;
+        gl_AllocTrackCxt.m_nSites    = 0;
+        gl_AllocTrackCxt.m_nFrames   = 0;
+
+        InterlockedExchange8(&gl_AllocTrackCxt.m_isEnabled, (CHAR)isEnabled);
+    });
+}
+
+NkBoolean NK_CALL NkAllocIsTracking(NkVoid) {
+    return gl_AllocTrackCxt.m_isEnabled == NK_TRUE;
+}
+
+NkVoid NK_CALL NkAllocDumpReport(_In_opt_ NkUint32 maxSites) {
+    if (gl_AllocTrackCxt.m_isEnabled == NK_FALSE) {
+        NK_LOG_WARNING("Allocation tracking is disabled; no report available.");
+
+        return;
+    }
+
+    NK_SYNCHRONIZED(gl_AllocTrackCxt.m_mtxLock, {
+        /* Collect and sort all used sites. */
+        NkUint32 *indArr = __NkInt_AllocateMemoryUnaligned(NULL, NK_ALLOC_NTRACKSITES * sizeof *indArr, NK_FALSE);
+        if (indArr == NULL)
+            break;
+
+        NkUint32 nSites = 0;
+        for (NkUint32 i = 0; i < NK_ALLOC_NTRACKSITES; i++)
+            if (gl_AllocTrackCxt.m_siteArr[i].mp_filePath != NULL)
+                indArr[nSites++] = i;
+        qsort(indArr, nSites, sizeof *indArr, &__NkInt_AllocTrackCompareSites);
+
+        /* Print the report. */
+        NkUint64 const nFrames  = NK_MAX(gl_AllocTrackCxt.m_nFrames, 1ULL);
+        NkUint32 const nPrinted = maxSites > 0 ? NK_MIN(maxSites, nSites) : nSites;
+        NK_LOG_INFO("Allocation report: %u call sites over %llu frames; showing %u.", nSites, nFrames, nPrinted);
+        NK_LOG_INFO("      live bytes   live #    allocs    frees  allocs/frame  call site");
+        for (NkUint32 i = 0; i < nPrinted; i++) {
+            __NkInt_AllocTrackSite const *sitePtr = &gl_AllocTrackCxt.m_siteArr[indArr[i]];
+
+            NK_LOG_INFO(
+                "%16llu %8llu %9llu %8llu %13.2f  %s() [%s:%u]",
+                sitePtr->m_liveBytes,
+                sitePtr->m_liveCount,
+                sitePtr->m_nAllocs,
+                sitePtr->m_nFrees,
+                (NkDouble)sitePtr->m_nAllocs / (NkDouble)nFrames,
+                sitePtr->mp_funcName,
+                sitePtr->mp_filePath,
+                sitePtr->m_lineInFile
+            );
+        }
+
+        __NkInt_FreeMemoryUnaligned(indArr);
+    });
+}
+
 
 /**
  */
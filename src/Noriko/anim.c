@@ -0,0 +1,193 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  anim.c
+ * \brief implements animation clips and the batched animator update
+ */
+#define NK_NAMESPACE "nk::anim"
+
+
+/* stdlib includes */
+#include <math.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/anim.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/log.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \struct NkAnimClip
+ * \brief  internal definition of an animation clip
+ *
+ * The frame arrays are stored in the same allocation, right after the structure.
+ */
+struct NkAnimClip {
+    NkUint32   m_nFrames;   /**< number of frames */
+    NkBoolean  m_isLooping; /**< whether the clip starts over after the last frame */
+    NkFloat    m_totalDur;  /**< sum of all frame durations, in seconds */
+    NkRectF   *mp_rectArr;  /**< source rectangle of every frame */
+    NkFloat   *mp_endArr;   /**< time at which every frame ends, in seconds */
+};
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkAnimClipCreate(
+    _In_       NkAnimClipSpecification const *clipSpec,
+    _Init_ptr_ NkAnimClip **clipPtr
+) {
+    NK_ASSERT(clipSpec != NULL && clipSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(clipSpec->m_nFrames > 0 && clipSpec->mp_rectArr != NULL, NkErr_InParameter);
+    NK_ASSERT(clipSpec->mp_durArr != NULL || clipSpec->m_frameDur > 0.f, NkErr_InParameter);
+    NK_ASSERT(clipPtr != NULL, NkErr_OutptrParameter);
+
+    NkUint32 const    nFrames = clipSpec->m_nFrames;
+    NkErrorCode const errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof **clipPtr + nFrames * (sizeof(NkRectF) + sizeof(NkFloat)),
+        0,
+        NK_FALSE,
+        (NkVoid **)clipPtr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    NkAnimClip *actClip = *clipPtr;
+    actClip->m_nFrames   = nFrames;
+    actClip->m_isLooping = clipSpec->m_isLooping;
+    actClip->mp_rectArr  = (NkRectF *)(actClip + 1);
+    actClip->mp_endArr   = (NkFloat *)(actClip->mp_rectArr + nFrames);
+    memcpy(actClip->mp_rectArr, clipSpec->mp_rectArr, nFrames * sizeof(NkRectF));
+
+    /* Store the end times so that the update does not have to sum up durations. */
+    NkFloat endTime = 0.f;
+    for (NkUint32 i = 0; i < nFrames; i++) {
+        NkFloat const frameDur = clipSpec->mp_durArr != NULL ? clipSpec->mp_durArr[i] : clipSpec->m_frameDur;
+        NK_ASSERT(frameDur > 0.f, NkErr_InParameter);
+
+        actClip->mp_endArr[i] = (endTime += frameDur);
+    }
+    actClip->m_totalDur = endTime;
+
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkAnimClipDestroy(_Uninit_ptr_ NkAnimClip **clipPtr) {
+    NK_ASSERT(clipPtr != NULL, NkErr_InOutParameter);
+
+    NkGPFree(*clipPtr);
+    *clipPtr = NULL;
+}
+
+NkFloat NK_CALL NkAnimClipGetDuration(_In_ NkAnimClip const *clipPtr) {
+    NK_ASSERT(clipPtr != NULL, NkErr_InParameter);
+
+    return clipPtr->m_totalDur;
+}
+
+
+_Return_ok_ NkErrorCode NK_CALL NkAnimRegisterComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _Out_   NkEcsComponentType *typePtr
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(typePtr != NULL, NkErr_OutParameter);
+
+    return NkEcsRegisterComponent(regPtr, &(NkEcsComponentSpecification){
+        .m_structSize = sizeof(NkEcsComponentSpecification),
+        .m_nFields    = __NkAnimFld_Count__,
+        .m_fieldSizes = {
+            [NkAnimFld_Clip]    = sizeof(NkAnimClip const *),
+            [NkAnimFld_Time]    = sizeof(NkFloat),
+            [NkAnimFld_Speed]   = sizeof(NkFloat),
+            [NkAnimFld_Frame]   = sizeof(NkUint32),
+            [NkAnimFld_SrcRect] = sizeof(NkRectF)
+        }
+    }, typePtr);
+}
+
+NkVoid NK_CALL NkAnimPlay(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType animType,
+    _In_    NkUint32 compInd,
+    _In_    NkAnimClip const *clipPtr,
+    _In_    NkFloat playSpeed
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(compInd < NkEcsQueryCount(regPtr, animType), NkErr_InParameter);
+    NK_ASSERT(clipPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(playSpeed >= 0.f, NkErr_InParameter);
+
+    NkAnimClip const **clipArr = NkEcsQueryField(regPtr, animType, NkAnimFld_Clip);
+    ((NkFloat *)NkEcsQueryField(regPtr, animType, NkAnimFld_Speed))[compInd] = playSpeed;
+    if (clipArr[compInd] == clipPtr)
+        return;
+
+    /* Start the new clip from the beginning. */
+    clipArr[compInd] = clipPtr;
+    ((NkFloat *)NkEcsQueryField(regPtr, animType, NkAnimFld_Time))[compInd]    = 0.f;
+    ((NkUint32 *)NkEcsQueryField(regPtr, animType, NkAnimFld_Frame))[compInd]  = 0;
+    ((NkRectF *)NkEcsQueryField(regPtr, animType, NkAnimFld_SrcRect))[compInd] = clipPtr->mp_rectArr[0];
+}
+
+NkVoid NK_CALL NkAnimUpdate(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType animType,
+    _In_    NkFloat updTime
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+
+    NkUint32 const nComps = NkEcsQueryCount(regPtr, animType);
+    if (nComps == 0)
+        return;
+
+    NkAnimClip const **clipArr  = NkEcsQueryField(regPtr, animType, NkAnimFld_Clip);
+    NkFloat           *timeArr  = NkEcsQueryField(regPtr, animType, NkAnimFld_Time);
+    NkFloat const     *speedArr = NkEcsQueryField(regPtr, animType, NkAnimFld_Speed);
+    NkUint32          *frameArr = NkEcsQueryField(regPtr, animType, NkAnimFld_Frame);
+    NkRectF           *rectArr  = NkEcsQueryField(regPtr, animType, NkAnimFld_SrcRect);
+
+    for (NkUint32 i = 0; i < nComps; i++) {
+        NkAnimClip const *clipPtr = clipArr[i];
+        if (clipPtr == NULL)
+            continue;
+
+        /*
+         * Advance the playback position. Wrapping around restarts the frame search at the
+         * first frame; otherwise, it continues at the current one, so the search usually
+         * terminates after at most one step.
+         */
+        NkFloat  currTime = timeArr[i] + updTime * speedArr[i];
+        NkUint32 frameInd = frameArr[i];
+        if (currTime >= clipPtr->m_totalDur) {
+            if (clipPtr->m_isLooping) {
+                currTime = fmodf(currTime, clipPtr->m_totalDur);
+                frameInd = 0;
+            } else
+                currTime = clipPtr->m_totalDur;
+        }
+        while (frameInd + 1 < clipPtr->m_nFrames && currTime >= clipPtr->mp_endArr[frameInd])
+            ++frameInd;
+
+        timeArr[i]  = currTime;
+        frameArr[i] = frameInd;
+        rectArr[i]  = clipPtr->mp_rectArr[frameInd];
+    }
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -26,11 +26,16 @@
 NK_COMPONENT_IMPORT(Logging);
 NK_COMPONENT_IMPORT(Allocators);
 NK_COMPONENT_IMPORT(PRNG);
+NK_COMPONENT_IMPORT(StrIntern);
 NK_COMPONENT_IMPORT(TimingDevCxt);
+NK_COMPONENT_IMPORT(Profiler);
+NK_COMPONENT_IMPORT(JobSys);
 NK_COMPONENT_IMPORT(Env);
 NK_COMPONENT_IMPORT(NkOM);
 NK_COMPONENT_IMPORT(PathSrv);
 NK_COMPONENT_IMPORT(IoSrv);
+NK_COMPONENT_IMPORT(AsyncIO);
+NK_COMPONENT_IMPORT(Capture);
 NK_COMPONENT_IMPORT(IAL);
 NK_COMPONENT_IMPORT(RdFactory);
 NK_COMPONENT_IMPORT(Layerstack);
@@ -38,10 +43,17 @@ NK_COMPONENT_IMPORT(Window);
 NK_COMPONENT_IMPORT(DbSrv);
 NK_COMPONENT_IMPORT(AssetManager);
 NK_COMPONENT_IMPORT(WorldLayer);
+NK_COMPONENT_IMPORT(PerfOverlay);
 /** \endcond */
 
 
 /** \cond INTERNAL */
+/**
+ * \brief maximum number of background-loaded assets that are finalized per frame
+ */
+#define __NkInt_Application_MaxAssetFinalizations ((NkUint32)(4))
+
+
 /**
  */
 NK_NATIVE typedef enum __NkInt_CompCallbackIndex {
@@ -56,13 +68,54 @@ NK_NATIVE typedef enum __NkInt_CompCallbackIndex {
 } __NkInt_CompCallbackIndex;
 
 
+/**
+ * \brief identifies the entries of the component-init table
+ */
+NK_NATIVE typedef enum __NkInt_CompIndex {
+    NkCompInd_Logging,
+    NkCompInd_Allocators,
+    NkCompInd_PRNG,
+    NkCompInd_StrIntern,
+    NkCompInd_TimingDevCxt,
+    NkCompInd_Profiler,
+    NkCompInd_JobSys,
+    NkCompInd_Env,
+    NkCompInd_NkOM,
+    NkCompInd_PathSrv,
+    NkCompInd_IoSrv,
+    NkCompInd_AsyncIO,
+    NkCompInd_Capture,
+    NkCompInd_IAL,
+    NkCompInd_RdFactory,
+    NkCompInd_Layerstack,
+    NkCompInd_Window,
+    NkCompInd_DbSrv,
+    NkCompInd_AssetManager,
+    NkCompInd_WorldLayer,
+    NkCompInd_PerfOverlay,
+
+    __NkCompInd_Count__
+} __NkInt_CompIndex;
+static_assert(__NkCompInd_Count__ <= 32, "Component dependencies must fit into a 32-bit mask.");
+
+/**
+ * \brief dependency mask bit of the component-init table entry \c n
+ */
+#define __NkInt_CompDep(n) ((NkUint32)1 << NkCompInd_##n)
+/**
+ * \brief dependency mask bit of the component-init table entry at index \c i
+ */
+#define __NkInt_CompBit(i) ((NkUint32)1 << (i))
+
+
 /**
  * \struct __NkInt_StartupErrorInfo
  * \brief  represents the startup error state
  */
 NK_NATIVE typedef struct __NkInt_StartupErrorInfo {
-    NkInt64   m_compIndex;   /**< component index */
-    NkBoolean m_compSucc[3]; /**< stage success flags */
+    NkBoolean   m_compSucc[__NkCompInd_Count__][3]; /**< stage success flags of every component */
+    NkErrorCode m_compErr[__NkCompInd_Count__];     /**< result of starting every component */
+    NkUint64    m_compTicks[__NkCompInd_Count__];   /**< time it took to start every component */
 } __NkInt_StartupErrorInfo;
 
 /**
@@ -71,6 +124,7 @@ NK_NATIVE typedef struct __NkInt_StartupErrorInfo {
  */
 NK_NATIVE typedef struct __NkInt_ExtComponent {
     NkComponent const *mp_compInfo;             /**< imported component info */
+    NkUint32           m_depMask;               /**< components that must be started first */
 
     NkErrorCode (NK_CALL *mp_preStFn)(NkVoid);  /**< (optional) pre-startup callback */
     NkErrorCode (NK_CALL *mp_postStFn)(NkVoid); /**< (optional) post-startup callback */
@@ -88,6 +142,11 @@ NK_NATIVE typedef struct __NkInt_Application {
 
     NkHashtable                *mp_compReg;     /**< global NkOM component registry */
     NkBoolean                   m_isStandalone; /**< whether or not the current instance runs standalone */
+    NkBoolean volatile          m_isRedrawReq;  /**< whether a frame must be rendered in on-demand mode */
+    NkUint64                    m_fixedTime;    /**< point in time the current fixed step simulates up to */
+    NkUint64                    m_stepInd;      /**< number of fixed steps that were run so far */
+    NkApplicationStepCallback   mp_fnStep;      /**< (optional) callback invoked before every fixed step */
+    NkVoid                     *mp_stepCxt;     /**< context pointer for the step callback */
     __NkInt_StartupErrorInfo    m_initErrInfo;  /**< component initialization error info */
 } __NkInt_Application;
 /**
@@ -101,26 +160,83 @@ NK_INTERNAL __NkInt_Application gl_Application;
  *        entered
  * 
  * \par Remarks
- *   The listed components are initialized in the order they appear in the array, and are
+ *   Components are started in stages. Every stage starts all components whose
+ *   dependencies have been started by the previous stages at the same time, each as a
+ *   job of its own, except for components that have to be started on the main thread.
+ *   As every component is listed after its dependencies, the components are
  *   uninitialized in the reverse order they are specified.
  */
 NK_INTERNAL __NkInt_ExtComponent const gl_c_CompInitTable[] = {
-    { &NK_COMPONENT(Logging),      NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(Allocators),   NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(PRNG),         NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(TimingDevCxt), NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(Env),          NULL, &__NkInt_Env_PostStartup,  NULL,                      NULL },
-    { &NK_COMPONENT(NkOM),         NULL, &__NkInt_NkOM_PostStartup, &__NkInt_NkOM_PreShutdown, NULL },
-    { &NK_COMPONENT(PathSrv),      NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(IoSrv),        NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(IAL),          NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(RdFactory),    NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(Layerstack),   NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(Window),       NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(DbSrv),        NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(AssetManager), NULL, NULL,                      NULL,                      NULL },
-    { &NK_COMPONENT(WorldLayer),   NULL, NULL,                      NULL,                      NULL }
+    [NkCompInd_Logging]      = { &NK_COMPONENT(Logging),      0,
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_Allocators]   = { &NK_COMPONENT(Allocators),   __NkInt_CompDep(Logging),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_PRNG]         = { &NK_COMPONENT(PRNG),         __NkInt_CompDep(Allocators),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_StrIntern]    = { &NK_COMPONENT(StrIntern),    __NkInt_CompDep(Allocators),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_TimingDevCxt] = { &NK_COMPONENT(TimingDevCxt), __NkInt_CompDep(Allocators),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_Profiler]     = { &NK_COMPONENT(Profiler),     __NkInt_CompDep(TimingDevCxt),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_JobSys]       = { &NK_COMPONENT(JobSys),       __NkInt_CompDep(Profiler),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_Env]          = { &NK_COMPONENT(Env),          __NkInt_CompDep(Profiler),
+        NULL, &__NkInt_Env_PostStartup,  NULL,                      NULL
+    },
+    [NkCompInd_NkOM]         = { &NK_COMPONENT(NkOM),         __NkInt_CompDep(Allocators),
+        NULL, &__NkInt_NkOM_PostStartup, &__NkInt_NkOM_PreShutdown, NULL
+    },
+    [NkCompInd_PathSrv]      = { &NK_COMPONENT(PathSrv),      __NkInt_CompDep(Allocators),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_IoSrv]        = { &NK_COMPONENT(IoSrv),        __NkInt_CompDep(NkOM),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_AsyncIO]      = { &NK_COMPONENT(AsyncIO),      __NkInt_CompDep(Allocators),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_Capture]      = { &NK_COMPONENT(Capture),      __NkInt_CompDep(Allocators),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_IAL]          = { &NK_COMPONENT(IAL),          __NkInt_CompDep(NkOM),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_RdFactory]    = { &NK_COMPONENT(RdFactory),    __NkInt_CompDep(NkOM),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_Layerstack]   = { &NK_COMPONENT(Layerstack),   __NkInt_CompDep(Allocators),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_Window]       = { &NK_COMPONENT(Window),       __NkInt_CompDep(Env) | __NkInt_CompDep(IAL) | __NkInt_CompDep(RdFactory),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_DbSrv]        = { &NK_COMPONENT(DbSrv),        __NkInt_CompDep(NkOM),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_AssetManager] = { &NK_COMPONENT(AssetManager),
+          __NkInt_CompDep(JobSys) | __NkInt_CompDep(Env)     | __NkInt_CompDep(PathSrv)
+        | __NkInt_CompDep(IoSrv)  | __NkInt_CompDep(AsyncIO) | __NkInt_CompDep(DbSrv)
+        | __NkInt_CompDep(StrIntern),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_WorldLayer]   = { &NK_COMPONENT(WorldLayer),
+          __NkInt_CompDep(Capture) | __NkInt_CompDep(Layerstack) | __NkInt_CompDep(Window) | __NkInt_CompDep(AssetManager),
+        NULL, NULL,                      NULL,                      NULL
+    },
+    [NkCompInd_PerfOverlay]  = { &NK_COMPONENT(PerfOverlay),
+          __NkInt_CompDep(Layerstack) | __NkInt_CompDep(Window) | __NkInt_CompDep(AssetManager),
+        NULL, NULL,                      NULL,                      NULL
+    }
 };
+NK_VERIFY_LUT(gl_c_CompInitTable, __NkInt_CompIndex, __NkCompInd_Count__);
 /**
  * \brief number of elements in the component-init table 
  */
@@ -141,6 +257,38 @@ NK_EXTERN NK_VIRTUAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Application_Platfor
     _Out_       NkBoolean *isLeave,
     _Inout_opt_ NkVoid *extraCxt
 );
+/**
+ * \ingroup VirtFn
+ * \brief   creates the platform-dependent timer used to wait between frames
+ * \return  opaque pointer to the timer, or \c NULL if waiting is not supported, in which
+ *          case <tt>__NkInt_Application_PlatformWaitUntil()</tt> only spins
+ */
+NK_EXTERN NK_VIRTUAL NkVoid *NK_CALL __NkInt_Application_PlatformCreateFrameTimer(NkVoid);
+/**
+ * \ingroup VirtFn
+ * \brief   destroys the frame timer created by
+ *          <tt>__NkInt_Application_PlatformCreateFrameTimer()</tt>
+ * \param   [in,out] frameTimer (optional) timer that is to be destroyed
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkInt_Application_PlatformDestroyFrameTimer(_Inout_opt_ NkVoid *frameTimer);
+/**
+ * \ingroup VirtFn
+ * \brief   blocks the calling thread until the given point in time
+ * \param   [in,out] frameTimer (optional) frame timer
+ * \param   [in] targetTime point in time to wait for, in timer ticks
+ * \param   [in] isInterruptible whether the wait ends early when new platform messages
+ *               (i.e., user input) arrive
+ *
+ * \par Remarks
+ *   The implementation sleeps for the bulk of the time and spins for the last moment to
+ *   compensate for the imprecision of the sleep, so that the function returns as close
+ *   to \c targetTime as possible.
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkInt_Application_PlatformWaitUntil(
+    _Inout_opt_ NkVoid *frameTimer,
+    _In_        NkUint64 targetTime,
+    _In_        NkBoolean isInterruptible
+);
 
 
 /**
@@ -160,6 +308,13 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_ValidateAppSpecification(_In_ NkAppl
         ERROR,
         "The window must support the 'NkWndMode_Normal' window mode!"
     );
+    NK_WEAK_ASSERT(
+        errCode,
+        NkErr_InParameter,
+        specsPtr->m_fixedTickRate <= 1000,
+        ERROR,
+        "The fixed tick rate must not exceed 1000 Hz!"
+    );
     /** \todo validate app spec more */
 
     return errCode;
@@ -261,12 +416,30 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Application_InvokeCompCallback(
     }
 
 lbl_ONRETURN:
-    gl_Application.m_initErrInfo.m_compIndex         = index;
-    gl_Application.m_initErrInfo.m_compSucc[cbIndex] = errCode == NkErr_Ok;
+    gl_Application.m_initErrInfo.m_compSucc[index][cbIndex] = errCode == NkErr_Ok;
 
     return errCode;
 }
 
+/**
+ * \brief runs the startup callbacks of a component
+ * \param [in] extraCxt pointer to the entry of the component in the component-init table
+ * \note  This function is a job; it only writes the state belonging to its component.
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_Application_StartComponent(_Inout_opt_ NkVoid *extraCxt) {
+    __NkInt_ExtComponent const *currComp  = (__NkInt_ExtComponent const *)extraCxt;
+    NkInt64 const               index     = (NkInt64)(currComp - gl_c_CompInitTable);
+    NkUint64 const              startTime = NkTimerGetCurrentTicks();
+
+    NkErrorCode errCode;
+       (errCode = __NkInt_Application_InvokeCompCallback(currComp, index, NkCompCb_PreStartup))  != NkErr_Ok
+    || (errCode = __NkInt_Application_InvokeCompCallback(currComp, index, NkCompCb_Startup))     != NkErr_Ok
+    || (errCode = __NkInt_Application_InvokeCompCallback(currComp, index, NkCompCb_PostStartup)) != NkErr_Ok;
+
+    gl_Application.m_initErrInfo.m_compErr[index]   = errCode;
+    gl_Application.m_initErrInfo.m_compTicks[index] = NkTimerGetCurrentTicks() - startTime;
+}
+
 /**
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NkOM_CompRegIterFn(_Inout_ struct NkHashtablePair *pairPtr) {
@@ -307,10 +480,124 @@ NK_INTERNAL NkVoid NK_CALL __NkInt_NkOM_CompRegDestFn(
  */
 _Return_ok_ NkErrorCode NK_CALL __NkInt_Env_PostStartup(NkVoid) {
     /* Check if the application was started with the '--attached' option. */
-    NkVariant dummyVar;
-    gl_Application.m_isStandalone = NkEnvGetValue("attached", &dummyVar) != NkErr_Ok;
+    gl_Application.m_isStandalone = NkEnvResolve("attached") == NULL;
 
     NK_LOG_INFO("Running Noriko in %s mode.", gl_Application.m_isStandalone ? "standalone" : "attached");
+
+    /* Allow overriding the fixed tick rate with the '--tickrate=<Hz>' option. */
+    NkEnvHandle const tickRateOpt = NkEnvResolve("tickrate");
+    if (tickRateOpt != NULL) {
+        NkDouble const tickRate = NkEnvGetDouble(tickRateOpt, 0.);
+
+        if (tickRate >= 1. && tickRate <= 1000.)
+            gl_Application.m_appSpecs.m_fixedTickRate = (NkUint32)tickRate;
+        else
+            NK_LOG_WARNING("Ignoring invalid tick rate; must be a number between 1 and 1000.");
+    }
+    NK_LOG_INFO("Running fixed updates at %u Hz.", gl_Application.m_appSpecs.m_fixedTickRate);
+
+    /*
+     * Allow choosing the renderer with '--renderer=<gdi|gdisoft|d3d11|null>'. '--headless'
+     * is a shorthand for the null renderer and a main window that is never shown.
+     */
+    NkVariant rdVar;
+    if (NkEnvGetValue("renderer", &rdVar) == NkErr_Ok) {
+        /**
+         * \brief maps the values of the '--renderer' option to renderer APIs
+         */
+        NK_INTERNAL struct { char const *mp_optStr; NkRendererApi m_rdApi; } const gl_c_RdApiOpts[] = {
+            { "gdi",     NkRdApi_Win32GDI   },
+            { "gdisoft", NkRdApi_Win32Soft  },
+            { "d3d11",   NkRdApi_Direct3D11 },
+            { "null",    NkRdApi_Null       }
+        };
+        NkVariantType varTy;
+        NkStringView  optVal;
+        NkVariantGet(&rdVar, &varTy, &optVal);
+
+        NkSize i = 0;
+        for (; varTy == NkVarTy_StringView && i < NK_ARRAYSIZE(gl_c_RdApiOpts); i++)
+            if (   optVal.m_sizeInBytes == strlen(gl_c_RdApiOpts[i].mp_optStr)
+                && !strncmp(optVal.mp_dataPtr, gl_c_RdApiOpts[i].mp_optStr, optVal.m_sizeInBytes)
+            ) {
+                gl_Application.m_appSpecs.m_rendererApi = gl_c_RdApiOpts[i].m_rdApi;
+
+                break;
+            }
+        if (varTy != NkVarTy_StringView || i == NK_ARRAYSIZE(gl_c_RdApiOpts))
+            NK_LOG_WARNING("Ignoring invalid renderer; must be one of 'gdi', 'gdisoft', 'd3d11', or 'null'.");
+    }
+    if (NkEnvResolve("headless") != NULL) {
+        gl_Application.m_appSpecs.m_rendererApi    = NkRdApi_Null;
+        gl_Application.m_appSpecs.m_initialWndMode = NkWndMode_Hidden;
+
+        NK_LOG_INFO("Running headless.");
+    }
+
+    /* Overlap simulating and presenting frames if started with '--renderthread'. */
+    if (NkEnvResolve("renderthread") != NULL) {
+        gl_Application.m_appSpecs.m_wndFlags |= NkWndFlag_RenderThread;
+
+        NK_LOG_INFO("Presenting frames on a render thread.");
+    }
+
+    /* Precompute downscaled texture levels for zoomed-out views if started with '--mipmaps'. */
+    if (NkEnvResolve("mipmaps") != NULL) {
+        gl_Application.m_appSpecs.m_wndFlags |= NkWndFlag_Mipmaps;
+
+        NK_LOG_INFO("Creating textures with mip chains.");
+    }
+
+    /*
+     * Select how pool memory is obtained with '--poolbacking=<heap|virtual|largepages>'.
+     * Pools that were created before keep their backing.
+     */
+    NkVariant poolVar;
+    if (NkEnvGetValue("poolbacking", &poolVar) == NkErr_Ok) {
+        /**
+         * \brief maps the values of the '--poolbacking' option to pool backings
+         */
+        NK_INTERNAL struct { char const *mp_optStr; NkPoolBacking m_poolBacking; } const gl_c_PoolBackOpts[] = {
+            { "heap",       NkPoolBack_Heap       },
+            { "virtual",    NkPoolBack_Virtual    },
+            { "largepages", NkPoolBack_LargePages }
+        };
+        NkVariantType varTy;
+        NkStringView  optVal;
+        NkVariantGet(&poolVar, &varTy, &optVal);
+
+        NkSize i = 0;
+        for (; varTy == NkVarTy_StringView && i < NK_ARRAYSIZE(gl_c_PoolBackOpts); i++)
+            if (   optVal.m_sizeInBytes == strlen(gl_c_PoolBackOpts[i].mp_optStr)
+                && !strncmp(optVal.mp_dataPtr, gl_c_PoolBackOpts[i].mp_optStr, optVal.m_sizeInBytes)
+            ) {
+                NkPoolBacking const actBacking = NkPoolSetBacking(gl_c_PoolBackOpts[i].m_poolBacking);
+
+                /* The table is in the order of the enumeration. */
+                NK_LOG_INFO("Using '%s' backing for memory pools.", gl_c_PoolBackOpts[actBacking].mp_optStr);
+                break;
+            }
+        if (varTy != NkVarTy_StringView || i == NK_ARRAYSIZE(gl_c_PoolBackOpts))
+            NK_LOG_WARNING("Ignoring invalid pool backing; must be one of 'heap', 'virtual', or 'largepages'.");
+    }
+
+    /* Enable allocation tracking if the application was started with '--alloctrack'. */
+    if (NkEnvResolve("alloctrack") != NULL) {
+        NkAllocSetTracking(NK_TRUE);
+
+        NK_LOG_INFO("Allocation tracking enabled; press F9 to print a report.");
+    }
+
+    /* Capture the first frames with the profiler if started with '--profcapture=<frames>'. */
+    NkEnvHandle const captureOpt = NkEnvResolve("profcapture");
+    if (captureOpt != NULL) {
+        NkDouble const nFrames = NkEnvGetDouble(captureOpt, 0.);
+
+        if (nFrames >= 1. && nFrames <= 100000.)
+            NK_IGNORE_RETURN_VALUE(NkProfileBeginCapture("startupCapture.json", (NkUint32)nFrames));
+        else
+            NK_LOG_WARNING("Ignoring invalid profiler capture length; must be a number between 1 and 100000.");
+    }
     return NkErr_Ok;
 }
 
@@ -360,54 +647,125 @@ _Return_ok_ NkErrorCode NK_CALL NkApplicationStartup(_In_ NkApplicationSpecifica
         .m_appSpecs     = *specsPtr,
         .mp_compReg     = NULL,
         .m_isStandalone = NK_FALSE,
-        .m_initErrInfo  = { 0, 0 }
+        .m_isRedrawReq  = NK_TRUE,
+        .m_initErrInfo  = { 0 }
     };
+    if (gl_Application.m_appSpecs.m_fixedTickRate == 0)
+        gl_Application.m_appSpecs.m_fixedTickRate = 120;
 
-    /* Initialize the internal components in order. */
-    __NkInt_ExtComponent const *currComp = &gl_c_CompInitTable[0];
-    for (NkInt64 i = 0; i < gl_c_CompInitTblSize; i++, currComp = &gl_c_CompInitTable[i]) {
-        /* Run the startup callbacks in order. */
-           (errCode = __NkInt_Application_InvokeCompCallback(currComp, i, NkCompCb_PreStartup))  != NkErr_Ok
-        || (errCode = __NkInt_Application_InvokeCompCallback(currComp, i, NkCompCb_Startup))     != NkErr_Ok
-        || (errCode = __NkInt_Application_InvokeCompCallback(currComp, i, NkCompCb_PostStartup)) != NkErr_Ok;
+    /*
+     * Initialize the internal components in stages. As long as the job system is not
+     * running, the jobs of a stage simply run one after another on this thread.
+     */
+    NkDouble const tiFreq    = (NkDouble)NkTimerGetFrequency();
+    NkUint64 const startTime = NkTimerGetCurrentTicks();
+    NkUint32 const allMask   = (NkUint32)(((NkUint64)1 << gl_c_CompInitTblSize) - 1);
+    NkUint32       doneMask  = 0;
+    NkUint32       nStages   = 0;
+    while (doneMask != allMask) {
+        /* Collect all components whose dependencies have been started already. */
+        NkUint32 stageMask = 0;
+        for (NkInt64 i = 0; i < gl_c_CompInitTblSize; i++)
+            if ((doneMask & __NkInt_CompBit(i)) == 0 && (gl_c_CompInitTable[i].m_depMask & ~doneMask) == 0)
+                stageMask |= __NkInt_CompBit(i);
+        if (stageMask == 0) {
+            NK_LOG_CRITICAL("Component dependencies are cyclic; cannot start the remaining components.");
+
+            return NkErr_ComponentState;
+        }
 
         /*
-         * If we failed at one point, we exit the loop. The exact point of failure is
-         * recorded by __NkInt_Application_InvokeCompCallback().
+         * Submit the components that can run anywhere first so that they overlap with
+         * the ones that have to be started on the main thread.
          */
-        if (errCode != NkErr_Ok)
-            return errCode;
+        NkUint64 const stageStart = NkTimerGetCurrentTicks();
+        NkJobCounter   stageCtr   = { 0 };
+        for (NkInt64 i = 0; i < gl_c_CompInitTblSize; i++) {
+            __NkInt_ExtComponent const *currComp = &gl_c_CompInitTable[i];
+            if ((stageMask & __NkInt_CompBit(i)) == 0 || currComp->mp_compInfo->m_compFlags & NkCompFlag_MainThread)
+                continue;
 
-        /* If the component is an NkOM component, add it to the registry. */
-        if (currComp->mp_compInfo->m_isNkOM) {
-            char uuidBuf[NK_UUIDLEN];
-            NkComponent const *compPtr = currComp->mp_compInfo;
+            NkJobDescription const jobDesc = { &__NkInt_Application_StartComponent, (NkVoid *)currComp };
+            if (NkJobGetWorkerCount() == 0 || NkJobSubmit(&jobDesc, 1, NULL, &stageCtr) != NkErr_Ok)
+                __NkInt_Application_StartComponent((NkVoid *)currComp);
+        }
+        for (NkInt64 i = 0; i < gl_c_CompInitTblSize; i++)
+            if (stageMask & __NkInt_CompBit(i) && gl_c_CompInitTable[i].mp_compInfo->m_compFlags & NkCompFlag_MainThread)
+                __NkInt_Application_StartComponent((NkVoid *)&gl_c_CompInitTable[i]);
+        NkJobWait(&stageCtr);
+        doneMask |= stageMask;
+        ++nStages;
+
+        /*
+         * Check the results in table order. Components that started successfully are
+         * registered even if another one of the stage failed so that they are shut down
+         * properly.
+         */
+        errCode = NkErr_Ok;
+        for (NkInt64 i = 0; i < gl_c_CompInitTblSize; i++) {
+            __NkInt_ExtComponent const *currComp = &gl_c_CompInitTable[i];
+            if ((stageMask & __NkInt_CompBit(i)) == 0)
+                continue;
 
-            NkApplicationReplaceInstance(compPtr->mp_clsId, (*compPtr->mp_fnQueryInst)());
             NK_LOG_INFO(
-                "Registered NkOM component \"%s\" ({%s}).",
-                compPtr->m_compIdent.mp_dataPtr,
-                NkUuidToString(compPtr->mp_clsId, uuidBuf)
+                "stage %u: %s took %.2f ms.",
+                nStages,
+                currComp->mp_compInfo->m_compIdent.mp_dataPtr,
+                (NkDouble)gl_Application.m_initErrInfo.m_compTicks[i] * 1000. / tiFreq
             );
+            if (gl_Application.m_initErrInfo.m_compErr[i] != NkErr_Ok) {
+                if (errCode == NkErr_Ok)
+                    errCode = gl_Application.m_initErrInfo.m_compErr[i];
+
+                continue;
+            }
+
+            /* If the component is an NkOM component, add it to the registry. */
+            if (currComp->mp_compInfo->m_isNkOM) {
+                char uuidBuf[NK_UUIDLEN];
+                NkComponent const *compPtr = currComp->mp_compInfo;
+
+                NkApplicationReplaceInstance(compPtr->mp_clsId, (*compPtr->mp_fnQueryInst)());
+                NK_LOG_INFO(
+                    "Registered NkOM component \"%s\" ({%s}).",
+                    compPtr->m_compIdent.mp_dataPtr,
+                    NkUuidToString(compPtr->mp_clsId, uuidBuf)
+                );
+            }
         }
+        NK_LOG_INFO(
+            "Finished startup stage %u in %.2f ms.",
+            nStages,
+            (NkDouble)(NkTimerGetCurrentTicks() - stageStart) * 1000. / tiFreq
+        );
+
+        /* The point of failure is recorded by __NkInt_Application_InvokeCompCallback(). */
+        if (errCode != NkErr_Ok)
+            return errCode;
     }
+    NK_LOG_INFO(
+        "Started %lli components in %u stages in %.2f ms.",
+        (long long)gl_c_CompInitTblSize,
+        nStages,
+        (NkDouble)(NkTimerGetCurrentTicks() - startTime) * 1000. / tiFreq
+    );
 
     /* Startup was successful. */
     return NkErr_Ok;
 }
 
 _Return_ok_ NkErrorCode NK_CALL NkApplicationShutdown(NkVoid) {
-    /* If no component was initialized, do nothing. */
-    if (gl_Application.m_initErrInfo.m_compIndex == 0)
-        return NkErr_Ok;
-
     NkErrorCode errCode = NkErr_Ok;
     /*
-     * Shutdown all components in the reverse order they were started up. Only run
-     * callbacks of which the opposite returned NkErr_Ok.
+     * Shutdown all components in the reverse order they are listed in. Only run
+     * callbacks of which the opposite returned NkErr_Ok; components of which no stage
+     * succeeded (including those that were never started) are skipped.
      */
-    for (NkInt64 i = gl_Application.m_initErrInfo.m_compIndex; i >= 0; i--) {
+    for (NkInt64 i = gl_c_CompInitTblSize - 1; i >= 0; i--) {
         __NkInt_ExtComponent const *currComp = &gl_c_CompInitTable[i];
+        NkBoolean const            *compSucc = gl_Application.m_initErrInfo.m_compSucc[i];
+        if (!compSucc[NkCompCb_PreStartup] && !compSucc[NkCompCb_Startup] && !compSucc[NkCompCb_PostStartup])
+            continue;
 
         /* If the component is an NkOM component, unregister it first. */
         if (currComp->mp_compInfo->m_isNkOM) {
@@ -423,8 +781,8 @@ _Return_ok_ NkErrorCode NK_CALL NkApplicationShutdown(NkVoid) {
         }
 
         /* Run stages that succeeded in opposite order. */
-        for (__NkInt_CompCallbackIndex j = sizeof gl_Application.m_initErrInfo.m_compSucc - 1; j >= 0; j--) {
-            if (gl_Application.m_initErrInfo.m_compSucc[j] == NK_FALSE)
+        for (__NkInt_CompCallbackIndex j = NK_ARRAYSIZE(gl_Application.m_initErrInfo.m_compSucc[i]) - 1; j >= 0; j--) {
+            if (compSucc[j] == NK_FALSE)
                 continue;
 
             /* For every stage, run the opposite callback if it succeeded. */
@@ -442,71 +800,230 @@ _Return_ok_ NkErrorCode NK_CALL NkApplicationShutdown(NkVoid) {
     return NkErr_Ok;
 }
 
+/** \cond INTERNAL */
+/**
+ * \brief runs a single fixed step
+ * \param [in] stepTime point in time the step simulates up to
+ * \param [in] updTime length of a fixed step, in seconds
+ *
+ * \par Remarks
+ *   The step covers the time from the end of the previous step up to <tt>stepTime</tt>;
+ *   layers use this to consume exactly the input that belongs to the step. The step
+ *   callback runs first so that it can inject input for the step.
+ */
+NK_INTERNAL NkVoid __NkInt_Application_RunFixedStep(_In_ NkUint64 stepTime, _In_ NkFloat updTime) {
+    gl_Application.m_fixedTime = stepTime;
+    if (gl_Application.mp_fnStep != NULL)
+        gl_Application.mp_fnStep(gl_Application.m_stepInd, stepTime, gl_Application.mp_stepCxt);
+
+    NK_IGNORE_RETURN_VALUE(NkLayerstackOnFixedUpdate(updTime));
+    ++gl_Application.m_stepInd;
+}
+/** \endcond */
+
+
 _Return_ok_ NkErrorCode NK_CALL NkApplicationRun(NkVoid) {
     /** \cond INTERNAL */
     NkFloat const tiFreq         = (NkFloat)NkTimerGetFrequency();
     /**
-     * \brief fixed update rate of the game's physics, animation, etc.; currently 120 Hz
-     * \note  This is subject to change in the future.
+     * \brief fixed update rate of the game's physics, animation, etc., as configured by
+     *        the application specification
      */
-    NkFloat const ticksPerUpdate = (8.333f / 1000.f) * tiFreq;
+    NkFloat const ticksPerUpdate = tiFreq / (NkFloat)gl_Application.m_appSpecs.m_fixedTickRate;
     /** \endcond */
 
     /* Query main window renderer. */
     NkIWindow      *mainWnd    = (NkIWindow *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIWindow));
     NkIRenderer    *mainWndRd  = mainWnd->VT->GetRenderer(mainWnd);
+    /* Query asset manager for finalizing assets that were loaded in the background. */
+    NkIAssetManager *assetMgr  = (NkIAssetManager *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIAssetManager));
     /* Initialize miscellaneous state. */
     NkBoolean       isLeave    = NK_TRUE;
     NkErrorCode     errCode    = NkErr_Ok;
     NkUint64        prevTime   = NkTimerGetCurrentTicks();
     NkUint64        currLag    = 0;
-    NkUint64 const  maxElapsed = (NkUint64)(0.016f * tiFreq);
+    /* Initialize frame pacing. */
+    NkUint32 const  targetFps  = gl_Application.m_appSpecs.m_targetFps;
+    NkUint64 const  frameTicks = targetFps > 0 ? (NkUint64)(tiFreq / (NkFloat)targetFps) : 0;
+    NkUint64        nextFrame  = prevTime + frameTicks;
+    NkVoid         *frameTimer = frameTicks > 0 || gl_Application.m_appSpecs.m_isOnDemand
+        ? __NkInt_Application_PlatformCreateFrameTimer()
+        : NULL
+    ;
+    /* Never simulate more than two fixed steps per frame to avoid a 'spiral of death'. */
+    NkUint64 const  maxElapsed = (NkUint64)(2.f * ticksPerUpdate);
 
     for (;;) {
-        /* First, calculate timestep. */
+        /*
+         * Swap the frame arenas. Temporary memory allocated during the previous frame
+         * stays valid for this frame; the memory of the frame before is discarded.
+         */
+        NkArenaBeginFrame();
+        /* Close the profiler frame; all zones left until now belong to the last frame. */
+        NkProfileMarkFrame();
+
+        /* Then, calculate timestep. */
         NkUint64 currTime    = NkTimerGetCurrentTicks();
         NkUint64 elapsedTime = NK_MIN(currTime - prevTime, maxElapsed);
         prevTime = currTime;
         currLag += elapsedTime;
 
         /*
-         * Then, run the platform-dependent main loop portion. This, for example, invokes
+         * Next, run the platform-dependent main loop portion. This, for example, invokes
          * platform-dependent event handling facilities like the message pump on Windows,
          * etc.
          */
+        NK_PROFILE_BEGIN("PlatformLoop");
         errCode = __NkInt_Application_PlatformLoop(&isLeave, NULL);
+        NK_PROFILE_END();
         if (isLeave == NK_TRUE)
             goto lbl_CLEANUP;
 
-        /** \todo dispatch messages which are in thread-safe queue */
+        /*
+         * Dispatch the events that were posted since the last frame, including input from
+         * the message pump, before the game is updated.
+         */
+        NK_PROFILE_SCOPE("DrainEvents")
+            NK_IGNORE_RETURN_VALUE(NkEventDrainQueue());
+
+        /*
+         * Finish loading the assets that were loaded on worker threads. Only a few are
+         * finalized per frame so that opening a new area does not cause a hitch.
+         */
+        NK_PROFILE_SCOPE("FinalizeAssets")
+            NK_IGNORE_RETURN_VALUE(assetMgr->VT->ProcessRequests(assetMgr, __NkInt_Application_MaxAssetFinalizations));
 
         /*
          * Update the game's layers. If the game cannot keep up with the framerate,
          * simulate multiple frames before rendering to ensure the physics stay
          * consistent.
          */
-        while (currLag > ticksPerUpdate) {
+        NK_PROFILE_SCOPE("FixedUpdate") while (currLag > ticksPerUpdate) {
             /* Update game objects and everything. */
-            /** \todo change to OnFixedUpdate */
-            NK_IGNORE_RETURN_VALUE(NkLayerstackOnUpdate(ticksPerUpdate / tiFreq));
+            __NkInt_Application_RunFixedStep(currTime - currLag + (NkUint64)ticksPerUpdate, ticksPerUpdate / tiFreq);
 
             /* Frame was processed; go ahead and catch up more possibly. */
             currLag -= (NkUint64)ticksPerUpdate;
         }
 
-        /** \todo do per-frame update */
+        /* Run the per-frame update at the variable timestep. */
+        NK_PROFILE_SCOPE("Update")
+            NK_IGNORE_RETURN_VALUE(NkLayerstackOnUpdate((NkFloat)elapsedTime / tiFreq));
 
-        /* Run the renderer at the variable timestep. */
-        mainWndRd->VT->BeginDraw(mainWndRd);
-        NK_IGNORE_RETURN_VALUE(NkLayerstackOnRender(currLag / ticksPerUpdate));
-        mainWndRd->VT->EndDraw(mainWndRd);
+        /*
+         * Run the renderer at the variable timestep. In on-demand mode, only render if
+         * something requested it since the last frame.
+         */
+        NkBoolean const isRender = !gl_Application.m_appSpecs.m_isOnDemand
+            || InterlockedExchange8((CHAR volatile *)&gl_Application.m_isRedrawReq, NK_FALSE) == NK_TRUE
+        ;
+        if (isRender) NK_PROFILE_SCOPE("Render") {
+            NK_PROFILE_SCOPE("BeginDraw")
+                mainWndRd->VT->BeginDraw(mainWndRd);
+            NK_PROFILE_SCOPE("Layers")
+                NK_IGNORE_RETURN_VALUE(NkLayerstackOnRender(currLag / ticksPerUpdate));
+            NK_PROFILE_SCOPE("EndDraw")
+                mainWndRd->VT->EndDraw(mainWndRd);
+            NK_PROFILE_SCOPE("Capture")
+                NkCaptureOnFrame(mainWndRd);
+        }
+
+        /*
+         * Pace the frames. If the frame rate is limited, wait for the start of the next
+         * frame; if we fell behind, do not try to catch up but start over from now. If
+         * nothing was rendered in on-demand mode, sleep until the next fixed update is
+         * due, waking up early on user input.
+         */
+        if (frameTicks > 0 && isRender) {
+            NkUint64 const frameEnd = NkTimerGetCurrentTicks();
+
+            if (frameEnd >= nextFrame)
+                nextFrame = frameEnd + frameTicks;
+            else NK_PROFILE_SCOPE("Wait") {
+                __NkInt_Application_PlatformWaitUntil(frameTimer, nextFrame, NK_FALSE);
+
+                nextFrame += frameTicks;
+            }
+        } else if (!isRender) NK_PROFILE_SCOPE("Wait")
+            __NkInt_Application_PlatformWaitUntil(
+                frameTimer,
+                currTime + (NkUint64)NK_MAX(ticksPerUpdate - (NkFloat)currLag, 0.f),
+                NK_TRUE
+            );
     }
 
 lbl_CLEANUP:
+    __NkInt_Application_PlatformDestroyFrameTimer(frameTimer);
     /*
      * Release the renderer since 'GetRenderer()' acquired it; also release the window
      * itself.
      */
+    assetMgr->VT->Release(assetMgr);
+    mainWndRd->VT->Release(mainWndRd);
+    mainWnd->VT->Release(mainWnd);
+
+    return errCode;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkApplicationRunSteps(
+    _In_                  NkUint32 nSteps,
+    _O_array_opt_(nSteps) NkDouble *frameTimes
+) {
+    NkFloat const tiFreq         = (NkFloat)NkTimerGetFrequency();
+    NkFloat const ticksPerUpdate = tiFreq / (NkFloat)gl_Application.m_appSpecs.m_fixedTickRate;
+    NkFloat const updTime        = ticksPerUpdate / tiFreq;
+
+    /* Query main window renderer and asset manager just like the normal main loop does. */
+    NkIWindow       *mainWnd   = (NkIWindow *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIWindow));
+    NkIRenderer     *mainWndRd = mainWnd->VT->GetRenderer(mainWnd);
+    NkIAssetManager *assetMgr  = (NkIAssetManager *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIAssetManager));
+    NkBoolean        isLeave   = NK_FALSE;
+    NkErrorCode      errCode   = NkErr_Ok;
+    /*
+     * The simulated time starts now and advances by exactly one fixed step per frame,
+     * independently of how long the frames actually take.
+     */
+    NkUint64 const   startTime = NkTimerGetCurrentTicks();
+
+    for (NkUint32 i = 0; i < nSteps; i++) {
+        NkUint64 const frameStart = NkTimerGetCurrentTicks();
+
+        NkArenaBeginFrame();
+        NkProfileMarkFrame();
+
+        NK_PROFILE_BEGIN("PlatformLoop");
+        errCode = __NkInt_Application_PlatformLoop(&isLeave, NULL);
+        NK_PROFILE_END();
+        if (isLeave == NK_TRUE)
+            break;
+
+        NK_PROFILE_SCOPE("DrainEvents")
+            NK_IGNORE_RETURN_VALUE(NkEventDrainQueue());
+        NK_PROFILE_SCOPE("FinalizeAssets")
+            NK_IGNORE_RETURN_VALUE(assetMgr->VT->ProcessRequests(assetMgr, __NkInt_Application_MaxAssetFinalizations));
+
+        NK_PROFILE_SCOPE("FixedUpdate")
+            __NkInt_Application_RunFixedStep(startTime + (NkUint64)((NkDouble)(i + 1) * (NkDouble)ticksPerUpdate), updTime);
+        NK_PROFILE_SCOPE("Update")
+            NK_IGNORE_RETURN_VALUE(NkLayerstackOnUpdate(updTime));
+
+        /* The fixed step was just run, so there is nothing to interpolate. */
+        NK_PROFILE_SCOPE("Render") {
+            NK_PROFILE_SCOPE("BeginDraw")
+                mainWndRd->VT->BeginDraw(mainWndRd);
+            NK_PROFILE_SCOPE("Layers")
+                NK_IGNORE_RETURN_VALUE(NkLayerstackOnRender(0.f));
+            NK_PROFILE_SCOPE("EndDraw")
+                mainWndRd->VT->EndDraw(mainWndRd);
+            NK_PROFILE_SCOPE("Capture")
+                NkCaptureOnFrame(mainWndRd);
+        }
+
+        if (frameTimes != NULL)
+            frameTimes[i] = (NkDouble)(NkTimerGetCurrentTicks() - frameStart) * 1000. / (NkDouble)tiFreq;
+    }
+
+    assetMgr->VT->Release(assetMgr);
     mainWndRd->VT->Release(mainWndRd);
     mainWnd->VT->Release(mainWnd);
 
@@ -522,6 +1039,22 @@ NkVoid NK_CALL NkApplicationExit(_Ecode_range_ NkErrorCode errCode) {
 }
 
 
+NkVoid NK_CALL NkApplicationRequestRedraw(NkVoid) {
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange8((CHAR volatile *)&gl_Application.m_isRedrawReq, NK_TRUE));
+}
+
+
+NkUint64 NK_CALL NkApplicationQueryFixedStepTime(NkVoid) {
+    return gl_Application.m_fixedTime;
+}
+
+
+NkVoid NK_CALL NkApplicationSetStepCallback(_In_opt_ NkApplicationStepCallback fnStep, _Inout_opt_ NkVoid *cxtPtr) {
+    gl_Application.mp_fnStep  = fnStep;
+    gl_Application.mp_stepCxt = cxtPtr;
+}
+
+
 NkApplicationSpecification const *NK_CALL NkApplicationQuerySpecification(NkVoid) {
     /*
      * If this function is called before having called 'NkApplicationStartup()', this
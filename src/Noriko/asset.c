@@ -20,18 +20,122 @@
 #define NK_NAMESPACE "nk::asset"
 
 
+/* stdlib includes */
+#include <string.h>
+#include <ctype.h>
+
 /* Noriko includes */
 #include <include/Noriko/asset.h>
 #include <include/Noriko/alloc.h>
 #include <include/Noriko/platform.h>
 #include <include/Noriko/log.h>
 #include <include/Noriko/db.h>
+#include <include/Noriko/job.h>
+#include <include/Noriko/profiler.h>
+#include <include/Noriko/env.h>
+#include <include/Noriko/pack.h>
+#include <include/Noriko/intern.h>
+#include <include/Noriko/timer.h>
+#include <include/Noriko/path.h>
 #include <include/Noriko/noriko.h>
 
 #include <include/Noriko/dstruct/htable.h>
 
 
+/**
+ * \struct NkAssetRequest
+ * \brief  internal definition of an asynchronous asset query
+ *
+ * The request is owned by the caller. While the job is running, only the worker writes
+ * to the request; afterwards, it is only accessed by the main thread, except for the
+ * state which can be read from any thread.
+ */
+struct NkAssetRequest {
+    struct __NkInt_AssetManager *mp_mgrRef;    /**< asset manager that issued the request */
+    NkUuid                       m_assetUuid;  /**< UUID of the requested asset */
+    NkVoid                      *mp_extraCxt;  /**< context passed to the asset's load functions */
+    NkIAsset                    *mp_assetRef;  /**< asset, once the lookup succeeded */
+    NkErrorCode                  m_errCode;    /**< error code of the step that failed */
+    LONG volatile                m_reqState;   /**< current state (\c NkAssetState value) */
+    NkBoolean                    m_isQueued;   /**< whether the request waits for finalization */
+    NkJobCounter                 m_jobCounter; /**< counter of the loading job */
+    NkJobCounter                *mp_waitCtr;   /**< counter that has to be waited on before accessing the request */
+    struct NkAssetRequest       *mp_nextReq;   /**< next request in the finalization queue */
+
+    struct NkAssetRequest      **mp_depReqs;   /**< requests of the dependencies (prefetch only) */
+    NkSize                       m_nDepReqs;   /**< number of dependency requests */
+    NkJobCounter                *mp_lvlCtrs;   /**< one counter per dependency level (prefetch only) */
+    NkUint32                     m_nLevels;    /**< number of dependency levels, including the root */
+
+    NkBoolean                    m_isReload;   /**< whether the request reloads a changed asset */
+    struct NkAssetRequest       *mp_nextRel;   /**< next reload that is in progress */
+    NkJobCounter                *mp_loadCtr;   /**< load claim of the asset, released once it was reloaded */
+};
+
+
 /** \cond INTERNAL */
+/**
+ * \def   __NkInt_AssetManager_DefBudget
+ * \brief default memory budget of the asset cache, in bytes
+ */
+#define __NkInt_AssetManager_DefBudget ((NkSize)512 << 20)
+/**
+ * \def   __NkInt_AssetManager_BatchSize
+ * \brief number of UUIDs resolved by a single execution of the batch query statement
+ * \note  If this is changed, the parameter list of the statement must be changed, too.
+ */
+#define __NkInt_AssetManager_BatchSize ((NkSize)64)
+/**
+ * \def   __NkInt_AssetManager_ReloadDelay
+ * \brief time a changed file must not be written to before the assets loaded from it are
+ *        reloaded, in milliseconds
+ * \note  Programs usually save files in multiple steps; waiting until they are done avoids
+ *        loading half-written files, and reloading the same asset multiple times.
+ */
+#define __NkInt_AssetManager_ReloadDelay ((NkUint64)100)
+
+
+/**
+ * \struct __NkInt_AssetManager_CacheEntry
+ * \brief  represents an asset held in the asset cache
+ *
+ * The entries are kept in a doubly-linked list in the order they were last queried, so
+ * that the least recently used assets can be evicted first.
+ */
+NK_NATIVE typedef struct __NkInt_AssetManager_CacheEntry {
+    NkUuid                                  m_assetUuid;  /**< UUID of the asset; key of the entry */
+    NkIAsset                               *mp_assetRef;  /**< cached asset; the cache holds a reference */
+    NkAssetType                             m_assetType;  /**< type of the asset */
+    NkSize                                  m_memUsage;   /**< memory usage last reported by the asset */
+    NkJobCounter                            m_loadCtr;    /**< has a pending item while the asset is being loaded */
+    NkBoolean                               m_isLoaded;   /**< whether the asset was loaded and waits for finalization */
+    struct __NkInt_AssetManager_CacheEntry *mp_prevEntry; /**< more recently used entry */
+    struct __NkInt_AssetManager_CacheEntry *mp_nextEntry; /**< less recently used entry */
+} __NkInt_AssetManager_CacheEntry;
+
+/**
+ * \struct __NkInt_AssetManager_FileChange
+ * \brief  represents a changed file whose assets have not been reloaded yet
+ */
+NK_NATIVE typedef struct __NkInt_AssetManager_FileChange {
+    NkStringId m_pathId;    /**< interned path of the file, as reported by the watch */
+    NkUint64   m_lastTicks; /**< time of the most recent change, in ticks */
+} __NkInt_AssetManager_FileChange;
+
+/**
+ * \struct __NkInt_AssetManager_ReadConn
+ * \brief  represents a shared read-only database connection used for asset lookups
+ *
+ * Each thread looking up an asset takes a connection of its own, so lookups on different
+ * threads do not serialize on a single connection. Connections are created on demand
+ * and kept afterwards, so there are as many as there were threads querying at once.
+ */
+NK_NATIVE typedef struct __NkInt_AssetManager_ReadConn {
+    NkIDatabase                          *mp_dbConn;         /**< read-only connection */
+    NkISqlStatement                      *mp_queryAssetStmt; /**< statement to query a single asset */
+    struct __NkInt_AssetManager_ReadConn *mp_nextConn;       /**< next idle connection */
+} __NkInt_AssetManager_ReadConn;
+
 /**
  */
 NK_NATIVE typedef struct __NkInt_AssetManager {
@@ -40,7 +144,23 @@ NK_NATIVE typedef struct __NkInt_AssetManager {
     NkHashtable     *mp_assetCache;     /**< asset cache, used for querying */
     NkIDatabase     *mp_dbConn;         /**< database connection handle */
     NkString         m_dbFileName;      /**< path to the database file */
-    NkISqlStatement *mp_queryAssetStmt; /**< statement to query a single asset */
+    NkISqlStatement *mp_queryDepsStmt;  /**< statement to query the dependency closure of an asset */
+    NkISqlStatement *mp_queryBatchStmt; /**< statement to query multiple assets at once */
+    NkPackArchive   *mp_packArch;       /**< archive holding the asset data, if any */
+    NkAssetRequest  *mp_finHead;        /**< oldest request waiting for finalization */
+    NkAssetRequest  *mp_finTail;        /**< newest request waiting for finalization */
+    LONG volatile    m_nRequests;       /**< number of requests that were not released yet */
+
+    __NkInt_AssetManager_ReadConn   *mp_idleConns; /**< idle read-only connections */
+    __NkInt_AssetManager_CacheEntry *mp_lruHead;   /**< most recently used cache entry */
+    __NkInt_AssetManager_CacheEntry *mp_lruTail;   /**< least recently used cache entry */
+    NkAssetMemoryStatistics          m_memStats;   /**< memory budget and accounting */
+
+    NkFileWatch                     *mp_fileWatch; /**< watch of the asset directory (hot reload only) */
+    __NkInt_AssetManager_FileChange *mp_chgArr;    /**< changed files that were not handled yet */
+    NkSize                           m_nChanges;   /**< number of elements in \c mp_chgArr */
+    NkSize                           m_chgCap;     /**< capacity of \c mp_chgArr, in elements */
+    NkAssetRequest                  *mp_relHead;   /**< reloads that are in progress */
 
     NK_DECL_LOCK(m_mtxLock);            /**< synchronization object */
 } __NkInt_AssetManager;
@@ -60,7 +180,7 @@ NK_INTERNAL NkErrorCode NK_CALL __NkInt_AssetManager_IterPendingFn(_Inout_ struc
 
     /* Extract data from pair. */
     NkUuid   *uuidRef  = pairPtr->m_keyVal.mp_uuidKey;
-    NkIAsset *assetRef = (NkIAsset *)pairPtr->mp_valuePtr;
+    NkIAsset *assetRef = ((__NkInt_AssetManager_CacheEntry *)pairPtr->mp_valuePtr)->mp_assetRef;
 
     /* Log basic info of current asset handle. */
     char uuidStr[NK_UUIDLEN];
@@ -92,309 +212,1752 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryAssetIterF
     return NkErr_Ok;
 }
 
+/**
+ * \struct __NkInt_AssetManager_BatchCxt
+ * \brief  receives the rows of a single execution of the batch query statement
+ */
+NK_NATIVE typedef struct __NkInt_AssetManager_BatchCxt {
+    NkUuid const  *mp_idArr;  /**< UUIDs of the batch */
+    NkSize        *mp_indArr; /**< index of each UUID in the caller's arrays */
+    NkSize         m_nIds;    /**< number of UUIDs in the batch */
+    NkIAsset     **mp_resArr; /**< caller's result array */
+} __NkInt_AssetManager_BatchCxt;
 
 /**
- * \brief implements <tt>NkIAssetManager::AddRef()</tt> 
+ * \brief distributes a single row of the batch query to all slots that requested it
  */
-NK_INTERNAL NkOMRefCount NK_CALL __NkInt_AssetManager_AddRef(_Inout_ NkIAssetManager *self) {
-    NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_UNREFERENCED_PARAMETER(self);
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryBatchIterFn(
+    _In_                 NkUint32 colCount,
+    _In_reads_(colCount) NkVariant const *colResArr,
+    _Inout_opt_          NkVoid *extraCxtPtr
+) {
+    NK_ASSERT(colCount > 0, NkErr_InParameter);
+    NK_ASSERT(colResArr != NULL, NkErr_InParameter);
+    NK_ASSERT(extraCxtPtr != NULL, NkErr_InOutParameter);
 
-    /* Stub. */
-    return 1;
+    __NkInt_AssetManager_BatchCxt *cxtPtr = (__NkInt_AssetManager_BatchCxt *)extraCxtPtr;
+
+    /* Rows are returned in arbitrary order, so find out which UUID the row belongs to. */
+    NkVariantType varTy;
+    NkBufferView  uuidBuf;
+    NkVariantGet(&colResArr[0], &varTy, &uuidBuf);
+    if (varTy != NkVarTy_BufferView || uuidBuf.m_sizeInBytes != sizeof(NkUuid))
+        return NkErr_Ok;
+
+    NkIAsset *assetRef = NULL;
+    NkErrorCode errCode = __NkInt_AssetManager_QueryAssetIterFn(colCount, colResArr, (NkVoid *)&assetRef);
+    if (errCode != NkErr_Ok || assetRef == NULL)
+        return errCode;
+
+    /* The same UUID may have been requested multiple times. */
+    for (NkSize i = 0; i < cxtPtr->m_nIds; i++) {
+        if (memcmp(&cxtPtr->mp_idArr[i], uuidBuf.mp_dataPtr, sizeof(NkUuid)) != 0)
+            continue;
+
+        cxtPtr->mp_resArr[cxtPtr->mp_indArr[i]] = assetRef;
+        assetRef->VT->AddRef(assetRef);
+    }
+    assetRef->VT->Release(assetRef);
+    return NkErr_Ok;
 }
 
 /**
- * \brief implements <tt>NkIAssetManager::Release()</tt> 
+ * \struct __NkInt_AssetManager_DepEntry
+ * \brief  represents a single asset of a dependency closure
  */
-NK_INTERNAL NkOMRefCount NK_CALL __NkInt_AssetManager_Release(_Inout_ NkIAssetManager *self) {
-    NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_UNREFERENCED_PARAMETER(self);
+NK_NATIVE typedef struct __NkInt_AssetManager_DepEntry {
+    NkUuid   m_depUuid;  /**< UUID of the dependency */
+    NkUint32 m_depLevel; /**< length of the longest dependency chain from the root */
+} __NkInt_AssetManager_DepEntry;
 
-    /* Stub. */
-    return 1;
+/**
+ * \struct __NkInt_AssetManager_DepList
+ * \brief  receives the rows of the dependency closure query
+ */
+NK_NATIVE typedef struct __NkInt_AssetManager_DepList {
+    __NkInt_AssetManager_DepEntry *mp_entryArr; /**< dependencies, deepest level first */
+    NkSize                         m_nEntries;  /**< number of dependencies */
+    NkSize                         m_capacity;  /**< capacity of the array */
+} __NkInt_AssetManager_DepList;
+
+/**
+ * \brief collects a single row of the dependency closure query
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryDepsIterFn(
+    _In_                 NkUint32 colCount,
+    _In_reads_(colCount) NkVariant const *colResArr,
+    _Inout_opt_          NkVoid *extraCxtPtr
+) {
+    NK_ASSERT(colCount == 2, NkErr_InParameter);
+    NK_ASSERT(colResArr != NULL, NkErr_InParameter);
+    NK_ASSERT(extraCxtPtr != NULL, NkErr_InOutParameter);
+
+    __NkInt_AssetManager_DepList *listPtr = (__NkInt_AssetManager_DepList *)extraCxtPtr;
+
+    /* Extract UUID and level; rows with malformed UUIDs are skipped. */
+    NkVariantType varTy;
+    NkBufferView  uuidBuf;
+    NkInt64       depLevel;
+    NkVariantGet(&colResArr[0], &varTy, &uuidBuf);
+    if (varTy != NkVarTy_BufferView || uuidBuf.m_sizeInBytes != sizeof(NkUuid))
+        return NkErr_Ok;
+    NkVariantGet(&colResArr[1], NULL, &depLevel);
+
+    /* Grow the array if needed. */
+    if (listPtr->m_nEntries == listPtr->m_capacity) {
+        NkSize const newCap = NK_MAX(listPtr->m_capacity * 2, (NkSize)16);
+
+        NkErrorCode errCode = listPtr->mp_entryArr == NULL
+            ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *listPtr->mp_entryArr, 0, NK_FALSE, (NkVoid **)&listPtr->mp_entryArr)
+            : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *listPtr->mp_entryArr, (NkVoid **)&listPtr->mp_entryArr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+        listPtr->m_capacity = newCap;
+    }
+
+    __NkInt_AssetManager_DepEntry *entryPtr = &listPtr->mp_entryArr[listPtr->m_nEntries++];
+    memcpy(&entryPtr->m_depUuid, uuidBuf.mp_dataPtr, sizeof(NkUuid));
+    entryPtr->m_depLevel = (NkUint32)NK_MAX(depLevel, (NkInt64)1);
+    return NkErr_Ok;
 }
 
+
 /**
- * \brief implements <tt>NkIAssetManager::QueryInterface()</tt> 
+ * \brief refreshes the memory accounting of a cache entry
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] entryPtr cache entry
+ * \note  The asset manager lock must be held by the caller.
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryInterface(
-    _Inout_  NkIAssetManager *self,
-    _In_     NkUuid const *iId,
-    _Outptr_ NkVoid **resPtr
+NK_INTERNAL NkVoid __NkInt_AssetManager_UpdateEntryUsage(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _Inout_ __NkInt_AssetManager_CacheEntry *entryPtr
 ) {
-    NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_ASSERT(iId != NULL, NkErr_InParameter);
-    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+    NkSize const newUsage = entryPtr->mp_assetRef->VT->GetMemoryUsage(entryPtr->mp_assetRef);
 
-    /**
-     * \brief lists all interfaces implemented by the standard asset manager 
-     */
-    NK_INTERNAL NkOMImplementationInfo const gl_ImplIfaces[] = {
-        { NKOM_IIDOF(NkIBase)          },
-        { NKOM_IIDOF(NkIInitializable) },
-        { NKOM_IIDOF(NkIAssetManager)  },
-        { NULL                         }
-    };
-    if (NkOMQueryImplementationIndex(gl_ImplIfaces, iId) != SIZE_MAX) {
-        /* Interface is implemented. */
-        *resPtr = (NkVoid *)self;
+    actSelf->m_memStats.m_memUsage                         += newUsage - entryPtr->m_memUsage;
+    actSelf->m_memStats.m_typeUsage[entryPtr->m_assetType] += newUsage - entryPtr->m_memUsage;
+    entryPtr->m_memUsage = newUsage;
+}
 
-        __NkInt_AssetManager_AddRef(self);
+/**
+ * \brief removes a cache entry from the usage list
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] entryPtr cache entry
+ * \note  The asset manager lock must be held by the caller.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_UnlinkEntry(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _Inout_ __NkInt_AssetManager_CacheEntry *entryPtr
+) {
+    if (entryPtr->mp_prevEntry != NULL)
+        entryPtr->mp_prevEntry->mp_nextEntry = entryPtr->mp_nextEntry;
+    else
+        actSelf->mp_lruHead = entryPtr->mp_nextEntry;
+    if (entryPtr->mp_nextEntry != NULL)
+        entryPtr->mp_nextEntry->mp_prevEntry = entryPtr->mp_prevEntry;
+    else
+        actSelf->mp_lruTail = entryPtr->mp_prevEntry;
+
+    entryPtr->mp_prevEntry = entryPtr->mp_nextEntry = NULL;
+}
+
+/**
+ * \brief marks a cache entry as the most recently used one
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] entryPtr cache entry; must not be linked
+ * \note  The asset manager lock must be held by the caller.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_LinkEntry(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _Inout_ __NkInt_AssetManager_CacheEntry *entryPtr
+) {
+    entryPtr->mp_prevEntry = NULL;
+    entryPtr->mp_nextEntry = actSelf->mp_lruHead;
+    if (actSelf->mp_lruHead != NULL)
+        actSelf->mp_lruHead->mp_prevEntry = entryPtr;
+    else
+        actSelf->mp_lruTail = entryPtr;
+    actSelf->mp_lruHead = entryPtr;
+}
+
+/**
+ * \brief  adds an asset to the asset cache
+ * \param  [in, out] actSelf asset manager instance
+ * \param  [in, out] assetRef asset that is to be cached; its reference count is
+ *                   incremented
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The asset manager lock must be held by the caller.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_AssetManager_InsertEntry(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _Inout_ NkIAsset *assetRef
+) {
+    __NkInt_AssetManager_CacheEntry *entryPtr;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *entryPtr, 0, NK_TRUE, (NkVoid **)&entryPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    entryPtr->m_assetUuid   = *assetRef->VT->GetUuid(assetRef);
+    entryPtr->mp_assetRef   = assetRef;
+    entryPtr->m_assetType   = assetRef->VT->GetType(assetRef);
+
+    errCode = NkHashtableInsert(actSelf->mp_assetCache, &(NkHashtablePair const){
+        .m_keyVal.mp_uuidKey = &entryPtr->m_assetUuid,
+        .mp_valuePtr         = (NkVoid *)entryPtr
+    });
+    if (errCode != NkErr_Ok) {
+        NkGPFree(entryPtr);
+
+        return errCode;
+    }
+
+    assetRef->VT->AddRef(assetRef);
+    __NkInt_AssetManager_LinkEntry(actSelf, entryPtr);
+    ++actSelf->m_memStats.m_typeCount[entryPtr->m_assetType];
+    __NkInt_AssetManager_UpdateEntryUsage(actSelf, entryPtr);
+    return NkErr_Ok;
+}
+
+/**
+ * \brief refreshes the memory accounting of a cached asset
+ * \param [in, out] actSelf asset manager instance
+ * \param [in] assetId UUID of the asset
+ * \note  If the asset is not cached, the function does nothing.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_UpdateUsage(_Inout_ __NkInt_AssetManager *actSelf, _In_ NkUuid const *assetId) {
+    __NkInt_AssetManager_CacheEntry *entryPtr;
+
+    NK_LOCK(actSelf->m_mtxLock);
+    if (NkHashtableAt(actSelf->mp_assetCache, &(NkHashtableKey const){ .mp_uuidKey = (NkUuid *)assetId }, (NkVoid **)&entryPtr) == NkErr_Ok)
+        __NkInt_AssetManager_UpdateEntryUsage(actSelf, entryPtr);
+    NK_UNLOCK(actSelf->m_mtxLock);
+}
+
+/**
+ * \brief  retrieves the cache entry of an asset
+ * \param  [in, out] actSelf asset manager instance
+ * \param  [in] assetId UUID of the asset
+ * \return cache entry, or \c NULL if the asset is not cached
+ * \note   The asset manager lock must be held by the caller.
+ */
+NK_INTERNAL __NkInt_AssetManager_CacheEntry *__NkInt_AssetManager_FindEntry(_Inout_ __NkInt_AssetManager *actSelf, _In_ NkUuid const *assetId) {
+    __NkInt_AssetManager_CacheEntry *entryPtr;
+
+    if (NkHashtableAt(actSelf->mp_assetCache, &(NkHashtableKey const){ .mp_uuidKey = (NkUuid *)assetId }, (NkVoid **)&entryPtr) != NkErr_Ok)
+        return NULL;
+    return entryPtr;
+}
+
+/**
+ * \brief evicts the least recently used assets until the memory budget is met
+ * \param [in, out] actSelf asset manager instance
+ * \param [in] isEvictAll whether to evict all assets regardless of the budget
+ *
+ * \par Remarks
+ *   Only assets that are referenced by nothing but the cache are evicted. As the cache is
+ *   the only place new references can be obtained from and lookups hold the asset
+ *   manager lock, an asset that is found to be unreferenced cannot be picked up while it
+ *   is being evicted. The evicted assets are unloaded after the lock has been released.
+ * \note  This function must only be called from the main thread.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_Trim(_Inout_ __NkInt_AssetManager *actSelf, _In_ NkBoolean isEvictAll) {
+    __NkInt_AssetManager_CacheEntry *evictList = NULL;
+
+    NK_LOCK(actSelf->m_mtxLock);
+    __NkInt_AssetManager_CacheEntry *currEntry = actSelf->mp_lruTail;
+    while (currEntry != NULL && (isEvictAll || actSelf->m_memStats.m_memUsage > actSelf->m_memStats.m_memBudget)) {
+        __NkInt_AssetManager_CacheEntry *prevEntry = currEntry->mp_prevEntry;
+
+        /* Skip assets that are still in use. */
+        NkIAsset *assetRef = currEntry->mp_assetRef;
+        assetRef->VT->AddRef(assetRef);
+        if (assetRef->VT->Release(assetRef) > 1) {
+            currEntry = prevEntry;
+
+            continue;
+        }
+
+        NK_IGNORE_RETURN_VALUE(NkHashtableErase(actSelf->mp_assetCache, &(NkHashtableKey const){ .mp_uuidKey = &currEntry->m_assetUuid }));
+        __NkInt_AssetManager_UnlinkEntry(actSelf, currEntry);
+        actSelf->m_memStats.m_memUsage                          -= currEntry->m_memUsage;
+        actSelf->m_memStats.m_typeUsage[currEntry->m_assetType] -= currEntry->m_memUsage;
+        --actSelf->m_memStats.m_typeCount[currEntry->m_assetType];
+        ++actSelf->m_memStats.m_nEvictions;
+
+        currEntry->mp_nextEntry = evictList;
+        evictList = currEntry;
+        currEntry = prevEntry;
+    }
+    NK_UNLOCK(actSelf->m_mtxLock);
+
+    while (evictList != NULL) {
+        __NkInt_AssetManager_CacheEntry *nextEntry = evictList->mp_nextEntry;
+        NkIAsset *assetRef = evictList->mp_assetRef;
+
+        if (assetRef->VT->GetAssetState(assetRef) == NkAsSt_Ready)
+            NK_IGNORE_RETURN_VALUE(assetRef->VT->Unload(assetRef, NULL));
+        assetRef->VT->Release(assetRef);
+        NkGPFree(evictList);
+
+        evictList = nextEntry;
+    }
+}
+
+
+/**
+ * \brief destroys a read-only connection
+ * \param [in,out] connPtr connection; must not be in the idle list
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_DestroyReadConn(_Inout_ __NkInt_AssetManager_ReadConn *connPtr) {
+    if (connPtr->mp_queryAssetStmt != NULL)
+        connPtr->mp_queryAssetStmt->VT->Release(connPtr->mp_queryAssetStmt);
+    if (connPtr->mp_dbConn != NULL)
+        connPtr->mp_dbConn->VT->Release(connPtr->mp_dbConn);
+
+    NkGPFree((NkVoid *)connPtr);
+}
+
+/**
+ * \brief  takes an idle read-only connection, opening a new one if there is none
+ * \param  [in,out] actSelf asset manager instance
+ * \param  [out] resPtr pointer to a variable that receives the connection
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The database must be open. This function can be called from any thread.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_AssetManager_AcquireReadConn(
+    _Inout_  __NkInt_AssetManager *actSelf,
+    _Outptr_ __NkInt_AssetManager_ReadConn **resPtr
+) {
+    NK_LOCK(actSelf->m_mtxLock);
+    if ((*resPtr = actSelf->mp_idleConns) != NULL)
+        actSelf->mp_idleConns = (*resPtr)->mp_nextConn;
+    NK_UNLOCK(actSelf->m_mtxLock);
+    if (*resPtr != NULL)
+        return NkErr_Ok;
+
+    /* No connection is idle; open a new one. */
+    __NkInt_AssetManager_ReadConn *connPtr;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *connPtr, 0, NK_TRUE, (NkVoid **)&connPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    errCode = NkOMCreateInstance(NKOM_CLSIDOF(NkIDatabase), NULL, NKOM_IIDOF(NkIDatabase), NULL, (NkIBase **)&connPtr->mp_dbConn);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+    errCode = connPtr->mp_dbConn->VT->Open(
+        connPtr->mp_dbConn,
+        NkStringAt(&actSelf->m_dbFileName, 0),
+        NkDbMode_ReadOnly | NkDbMode_Shared,
+        NULL
+    );
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+    errCode = connPtr->mp_dbConn->VT->CreateStatement(
+        connPtr->mp_dbConn,
+        "SELECT * FROM assets WHERE uuid = ?",
+        &connPtr->mp_queryAssetStmt
+    );
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+
+    *resPtr = connPtr;
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    __NkInt_AssetManager_DestroyReadConn(connPtr);
+
+    return errCode;
+}
+
+/**
+ * \brief puts a read-only connection back into the idle list
+ * \param [in,out] actSelf asset manager instance
+ * \param [in,out] connPtr connection
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_ReleaseReadConn(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _Inout_ __NkInt_AssetManager_ReadConn *connPtr
+) {
+    NK_LOCK(actSelf->m_mtxLock);
+    connPtr->mp_nextConn  = actSelf->mp_idleConns;
+    actSelf->mp_idleConns = connPtr;
+    NK_UNLOCK(actSelf->m_mtxLock);
+}
+
+/**
+ * \brief  looks up an asset in the cache, or in the database if it is not cached
+ * \param  [in, out] actSelf asset manager instance
+ * \param  [in] assetId UUID of the asset
+ * \param  [out] resPtr pointer to a variable that receives the asset; its reference
+ *               count is incremented
+ * \return \c NkErr_Ok on success, \c NkErr_ItemNotFound if there is no such asset, or
+ *         another non-zero value on failure
+ * \note   This function can be called from any thread. The database is queried without
+ *         holding the asset manager lock, using a read-only connection of the calling
+ *         thread's own. In attached mode, changes that were not committed yet are not
+ *         visible to the lookup.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_AssetManager_LookupAsset(
+    _Inout_  __NkInt_AssetManager *actSelf,
+    _In_     NkUuid const *assetId,
+    _Outptr_ NkIAsset **resPtr
+) {
+    /* Check if the given asset handle is already present in the cache. */
+    __NkInt_AssetManager_CacheEntry *entryPtr;
+    NK_LOCK(actSelf->m_mtxLock);
+    NkErrorCode eCode = NkHashtableAt(
+        actSelf->mp_assetCache,
+        &(NkHashtableKey const){
+            .mp_uuidKey = (NkUuid *)assetId
+        },
+        (NkVoid **)&entryPtr
+    );
+    if (eCode == NkErr_Ok) {
+        /* Present in cache; mark as recently used, add reference and return. */
+        __NkInt_AssetManager_UnlinkEntry(actSelf, entryPtr);
+        __NkInt_AssetManager_LinkEntry(actSelf, entryPtr);
+        __NkInt_AssetManager_UpdateEntryUsage(actSelf, entryPtr);
+
+        *resPtr = entryPtr->mp_assetRef;
+        (*resPtr)->VT->AddRef(*resPtr);
+        NK_UNLOCK(actSelf->m_mtxLock);
         return NkErr_Ok;
     }
 
-    /* Interface is not implemented. */
     *resPtr = NULL;
-    return NkErr_InterfaceNotImpl;
+    if (actSelf->mp_dbConn == NULL) {
+        NK_UNLOCK(actSelf->m_mtxLock);
+
+        return NkErr_ComponentState;
+    }
+    NK_UNLOCK(actSelf->m_mtxLock);
+
+    /* Query the asset on a connection of our own. */
+    __NkInt_AssetManager_ReadConn *connPtr;
+    if ((eCode = __NkInt_AssetManager_AcquireReadConn(actSelf, &connPtr)) != NkErr_Ok)
+        return eCode;
+
+    NkVariant paramVar;
+    NkVariantSet(&paramVar, NkVarTy_Uuid, assetId);
+    connPtr->mp_queryAssetStmt->VT->Bind(connPtr->mp_queryAssetStmt, 1U, &paramVar);
+    eCode = connPtr->mp_dbConn->VT->Execute(
+        connPtr->mp_dbConn,
+        connPtr->mp_queryAssetStmt,
+        &__NkInt_AssetManager_QueryAssetIterFn,
+        (NkVoid *)resPtr
+    );
+    connPtr->mp_queryAssetStmt->VT->Unbind(connPtr->mp_queryAssetStmt, 1U);
+    __NkInt_AssetManager_ReleaseReadConn(actSelf, connPtr);
+    if (eCode != NkErr_Ok) {
+        if (*resPtr != NULL)
+            (*resPtr)->VT->Release(*resPtr);
+
+        *resPtr = NULL;
+        return eCode;
+    }
+    if (*resPtr == NULL)
+        return NkErr_ItemNotFound;
+
+    /*
+     * Add the asset to the cache. Another thread may have looked up the same asset in
+     * the meantime; in this case, use the one that is already cached.
+     */
+    NK_LOCK(actSelf->m_mtxLock);
+    if (NkHashtableAt(actSelf->mp_assetCache, &(NkHashtableKey const){ .mp_uuidKey = (NkUuid *)assetId }, (NkVoid **)&entryPtr) == NkErr_Ok) {
+        (*resPtr)->VT->Release(*resPtr);
+
+        *resPtr = entryPtr->mp_assetRef;
+        (*resPtr)->VT->AddRef(*resPtr);
+    } else if ((eCode = __NkInt_AssetManager_InsertEntry(actSelf, *resPtr)) != NkErr_Ok) {
+        (*resPtr)->VT->Release(*resPtr);
+
+        *resPtr = NULL;
+    }
+    NK_UNLOCK(actSelf->m_mtxLock);
+    return eCode;
+}
+
+/**
+ * \brief updates the state of a request
+ * \param [in, out] reqPtr request handle
+ * \param [in] newState new state of the request
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_AssetManager_SetRequestState(_Inout_ NkAssetRequest *reqPtr, _In_ NkAssetState newState) {
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange(&reqPtr->m_reqState, (LONG)newState));
+}
+
+/**
+ * \brief hands a request over to the main thread for finalization
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] reqPtr request that is to be queued
+ * \param [in] newState new state of the request
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_QueueRequest(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _Inout_ NkAssetRequest *reqPtr,
+    _In_    NkAssetState newState
+) {
+    NK_LOCK(actSelf->m_mtxLock);
+    if (actSelf->mp_finTail != NULL)
+        actSelf->mp_finTail->mp_nextReq = reqPtr;
+    else
+        actSelf->mp_finHead = reqPtr;
+    actSelf->mp_finTail = reqPtr;
+    reqPtr->m_isQueued  = NK_TRUE;
+    __NkInt_AssetManager_SetRequestState(reqPtr, newState);
+    NK_UNLOCK(actSelf->m_mtxLock);
+}
+
+/**
+ * \brief  loads the device-independent data of a requested asset, unless another request
+ *         already did
+ * \param  [in, out] actSelf asset manager instance
+ * \param  [in, out] reqPtr request whose asset has been looked up
+ * \param  [out] isLoadedPtr pointer to a variable that receives whether the asset waits for
+ *                finalization; \c NK_FALSE if it is ready already
+ * \return \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   The load is claimed under the asset manager lock by adding a pending item to the job
+ *   counter of the cache entry. Requests for an asset that is being loaded wait on that
+ *   counter, running other jobs meanwhile, and only load the asset themselves if the
+ *   other load failed. The entry cannot be evicted while waiting as the request holds a
+ *   reference to the asset.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_AssetManager_LoadOnce(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _Inout_ NkAssetRequest *reqPtr,
+    _Out_   NkBoolean *isLoadedPtr
+) {
+    NkIAsset *assetRef = reqPtr->mp_assetRef;
+
+    NK_LOCK(actSelf->m_mtxLock);
+    __NkInt_AssetManager_CacheEntry *entryPtr = __NkInt_AssetManager_FindEntry(actSelf, &reqPtr->m_assetUuid);
+    while (entryPtr != NULL && !NkJobIsDone(&entryPtr->m_loadCtr)) {
+        NK_UNLOCK(actSelf->m_mtxLock);
+        NkJobWait(&entryPtr->m_loadCtr);
+        NK_LOCK(actSelf->m_mtxLock);
+    }
+
+    /* Assets that were loaded before do not need to be loaded again. */
+    NkBoolean const isReady = assetRef->VT->GetAssetState(assetRef) == NkAsSt_Ready;
+    if (isReady || (entryPtr != NULL && entryPtr->m_isLoaded)) {
+        NK_UNLOCK(actSelf->m_mtxLock);
+
+        *isLoadedPtr = !isReady;
+        return NkErr_Ok;
+    }
+    if (entryPtr != NULL)
+        NkJobCounterAddPending(&entryPtr->m_loadCtr, 1);
+    NK_UNLOCK(actSelf->m_mtxLock);
+
+    NkErrorCode const errCode = assetRef->VT->Load(assetRef, reqPtr->mp_extraCxt);
+    if (entryPtr != NULL) {
+        if (errCode == NkErr_Ok) {
+            NK_SYNCHRONIZED(actSelf->m_mtxLock, entryPtr->m_isLoaded = NK_TRUE);
+        }
+
+        NkJobCounterSignal(&entryPtr->m_loadCtr);
+    }
+
+    *isLoadedPtr = errCode == NkErr_Ok;
+    return errCode;
+}
+
+/**
+ * \brief runs the database lookup and the device-independent loading of an asset on a
+ *        worker thread
+ * \param [in, out] extraCxt request handle
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_AssetManager_RequestJob(_Inout_opt_ NkVoid *extraCxt) {
+    NK_ASSERT(extraCxt != NULL, NkErr_InOutParameter);
+
+    NkAssetRequest       *reqPtr  = (NkAssetRequest *)extraCxt;
+    __NkInt_AssetManager *actSelf = reqPtr->mp_mgrRef;
+    NkBoolean   isLoaded = NK_FALSE;
+    NkErrorCode errCode;
+    NK_PROFILE_SCOPE("LoadAsset") {
+        errCode = __NkInt_AssetManager_LookupAsset(actSelf, &reqPtr->m_assetUuid, &reqPtr->mp_assetRef);
+
+        if (errCode == NkErr_Ok)
+            errCode = __NkInt_AssetManager_LoadOnce(actSelf, reqPtr, &isLoaded);
+    }
+    if (errCode == NkErr_Ok)
+        __NkInt_AssetManager_UpdateUsage(actSelf, &reqPtr->m_assetUuid);
+    if (errCode != NkErr_Ok) {
+        char uuidStr[NK_UUIDLEN];
+        NK_LOG_ERROR("Failed to load asset %s. Reason: %s (%i)", NkUuidToString(&reqPtr->m_assetUuid, uuidStr), NkGetErrorCodeStr(errCode)->mp_dataPtr, (int)errCode);
+
+        reqPtr->m_errCode = errCode;
+        __NkInt_AssetManager_SetRequestState(reqPtr, NkAsSt_Invalid);
+        return;
+    }
+
+    /* Assets that are ready already must not be finalized again. */
+    if (!isLoaded) {
+        __NkInt_AssetManager_SetRequestState(reqPtr, NkAsSt_Ready);
+
+        return;
+    }
+    /* Hand the request over to the main thread for finalization. */
+    __NkInt_AssetManager_QueueRequest(actSelf, reqPtr, NkAsSt_ReadyForLoading);
+}
+
+/**
+ * \brief loads the new contents of a changed asset on a worker thread
+ * \param [in, out] extraCxt reload request
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_AssetManager_ReloadJob(_Inout_opt_ NkVoid *extraCxt) {
+    NK_ASSERT(extraCxt != NULL, NkErr_InOutParameter);
+
+    NkAssetRequest *reqPtr = (NkAssetRequest *)extraCxt;
+    NK_PROFILE_SCOPE("ReloadAsset")
+        reqPtr->m_errCode = reqPtr->mp_assetRef->VT->Load(reqPtr->mp_assetRef, NULL);
+    /*
+     * The asset stays ready while it is reloaded, so new requests do not load it again and
+     * the claim can be released before the main thread swaps in the new resources.
+     */
+    NkJobCounterSignal(reqPtr->mp_loadCtr);
+    if (reqPtr->m_errCode != NkErr_Ok) {
+        char uuidStr[NK_UUIDLEN];
+        NK_LOG_ERROR("Failed to reload asset %s. Reason: %s (%i)", NkUuidToString(&reqPtr->m_assetUuid, uuidStr), NkGetErrorCodeStr(reqPtr->m_errCode)->mp_dataPtr, (int)reqPtr->m_errCode);
+    }
+
+    /* Failed reloads are queued, too, as the main thread owns the request. */
+    __NkInt_AssetManager_QueueRequest(
+        reqPtr->mp_mgrRef,
+        reqPtr,
+        reqPtr->m_errCode == NkErr_Ok ? NkAsSt_ReadyForLoading : NkAsSt_Invalid
+    );
+}
+
+/**
+ * \brief removes a request from the finalization queue
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] reqPtr request that is to be removed
+ * \note  The asset manager lock must be held by the caller.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_UnlinkRequest(_Inout_ __NkInt_AssetManager *actSelf, _Inout_ NkAssetRequest *reqPtr) {
+    NkAssetRequest *prevPtr = NULL;
+    for (NkAssetRequest *currPtr = actSelf->mp_finHead; currPtr != NULL; prevPtr = currPtr, currPtr = currPtr->mp_nextReq) {
+        if (currPtr != reqPtr)
+            continue;
+
+        if (prevPtr != NULL)
+            prevPtr->mp_nextReq = currPtr->mp_nextReq;
+        else
+            actSelf->mp_finHead = currPtr->mp_nextReq;
+        if (actSelf->mp_finTail == currPtr)
+            actSelf->mp_finTail = prevPtr;
+        break;
+    }
+
+    reqPtr->mp_nextReq = NULL;
+    reqPtr->m_isQueued = NK_FALSE;
+}
+
+/**
+ * \brief  allocates and initializes a new request
+ * \param  [in, out] actSelf asset manager instance
+ * \param  [in] assetId UUID of the requested asset
+ * \param  [in, out] extraCxtPtr (optional) context passed to the asset's load functions
+ * \param  [out] reqPtr pointer to a variable that receives the request
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The loading job is not submitted.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_AssetManager_CreateRequest(
+    _Inout_     __NkInt_AssetManager *actSelf,
+    _In_        NkUuid const *assetId,
+    _Inout_opt_ NkVoid *extraCxtPtr,
+    _Init_ptr_  NkAssetRequest **reqPtr
+) {
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **reqPtr, 0, NK_TRUE, (NkVoid **)reqPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    NkAssetRequest *actReq = *reqPtr;
+    actReq->mp_mgrRef     = actSelf;
+    actReq->m_assetUuid   = *assetId;
+    actReq->mp_extraCxt   = extraCxtPtr;
+    actReq->m_reqState    = (LONG)NkAsSt_Loading;
+    actReq->mp_waitCtr    = &actReq->m_jobCounter;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief frees a request, including the requests of its dependencies
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] reqPtr request that is to be freed
+ * \note  If the request is still loading, the function waits for the worker to finish.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_FreeRequest(_Inout_ __NkInt_AssetManager *actSelf, _Inout_ NkAssetRequest *reqPtr) {
+    /*
+     * The job counters live inside the requests and are accessed by the workers until the
+     * jobs have finished, so nothing must be freed before that.
+     */
+    for (NkUint32 i = 0; i < reqPtr->m_nLevels; i++)
+        NkJobWait(&reqPtr->mp_lvlCtrs[i]);
+    NkJobWait(reqPtr->mp_waitCtr);
+    for (NkSize i = 0; i < reqPtr->m_nDepReqs; i++)
+        __NkInt_AssetManager_FreeRequest(actSelf, reqPtr->mp_depReqs[i]);
+
+    NK_LOCK(actSelf->m_mtxLock);
+    if (reqPtr->m_isQueued)
+        __NkInt_AssetManager_UnlinkRequest(actSelf, reqPtr);
+    NK_UNLOCK(actSelf->m_mtxLock);
+
+    if (reqPtr->mp_assetRef != NULL)
+        reqPtr->mp_assetRef->VT->Release(reqPtr->mp_assetRef);
+    NkGPFree(reqPtr->mp_depReqs);
+    NkGPFree(reqPtr->mp_lvlCtrs);
+    NkGPFree(reqPtr);
+}
+
+/**
+ * \brief runs the device-dependent finalization of a request on the main thread
+ * \param [in, out] reqPtr request that is to be finalized; must have been removed from
+ *                  the finalization queue
+ * \note  If multiple requests waited for the same load, the asset is only finalized by the
+ *        first one that reaches the main thread, with its own context.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_FinalizeRequest(_Inout_ NkAssetRequest *reqPtr) {
+    __NkInt_AssetManager *actSelf  = reqPtr->mp_mgrRef;
+    NkIAsset             *assetRef = reqPtr->mp_assetRef;
+
+    NkBoolean isFinalize = reqPtr->m_isReload;
+    __NkInt_AssetManager_CacheEntry *entryPtr = NULL;
+    if (!isFinalize) {
+        NK_LOCK(actSelf->m_mtxLock);
+        if ((entryPtr = __NkInt_AssetManager_FindEntry(actSelf, &reqPtr->m_assetUuid)) != NULL)
+            isFinalize = entryPtr->m_isLoaded;
+        else
+            isFinalize = assetRef->VT->GetAssetState(assetRef) != NkAsSt_Ready;
+        NK_UNLOCK(actSelf->m_mtxLock);
+    }
+
+    NkErrorCode errCode = NkErr_Ok;
+    if (isFinalize) {
+        NK_PROFILE_SCOPE("FinalizeAsset")
+            errCode = assetRef->VT->Finalize(assetRef, reqPtr->mp_extraCxt);
+
+        /*
+         * The flag is only cleared now so that no request loads the asset again while it is
+         * being finalized.
+         */
+        if (entryPtr != NULL) {
+            NK_SYNCHRONIZED(actSelf->m_mtxLock, entryPtr->m_isLoaded = NK_FALSE);
+        }
+    } else if (assetRef->VT->GetAssetState(assetRef) != NkAsSt_Ready)
+        errCode = NkErr_ObjectState;
+    if (errCode != NkErr_Ok) {
+        char uuidStr[NK_UUIDLEN];
+        NK_LOG_ERROR("Failed to finalize asset %s. Reason: %s (%i)", NkUuidToString(&reqPtr->m_assetUuid, uuidStr), NkGetErrorCodeStr(errCode)->mp_dataPtr, (int)errCode);
+
+        reqPtr->m_errCode = errCode;
+        __NkInt_AssetManager_SetRequestState(reqPtr, NkAsSt_Invalid);
+        return;
+    }
+
+    __NkInt_AssetManager_UpdateUsage(actSelf, &reqPtr->m_assetUuid);
+    __NkInt_AssetManager_SetRequestState(reqPtr, NkAsSt_Ready);
+}
+
+
+/**
+ * \brief  checks whether two paths refer to the same file
+ * \param  [in] lhsPath first path
+ * \param  [in] rhsPath second path
+ * \return \c NK_TRUE if the paths are equal, \c NK_FALSE if not
+ * \note   Both separators are accepted, and case is ignored, as asset paths are written
+ *         by hand and the file systems the asset directory lives on are case-insensitive.
+ */
+NK_INTERNAL NkBoolean __NkInt_AssetManager_IsSamePath(_In_z_ char const *lhsPath, _In_z_ char const *rhsPath) {
+    for (;; lhsPath++, rhsPath++) {
+        char const lhsCh = *lhsPath == '\\' ? '/' : (char)tolower((unsigned char)*lhsPath);
+        char const rhsCh = *rhsPath == '\\' ? '/' : (char)tolower((unsigned char)*rhsPath);
+
+        if (lhsCh != rhsCh)
+            return NK_FALSE;
+        if (lhsCh == '\0')
+            return NK_TRUE;
+    }
+}
+
+/**
+ * \brief records a changed file; invoked on the thread of the asset directory watch
+ * \param [in] pathStr path of the changed file
+ * \param [in, out] extraParam asset manager instance
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_AssetManager_FileChangeFn(_In_z_ _Utf8_ char const *pathStr, _Inout_opt_ NkVoid *extraParam) {
+    NK_ASSERT(extraParam != NULL, NkErr_InOutParameter);
+
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)extraParam;
+
+    /* Interned paths can be compared and stored without copying them. */
+    NkStringId pathId;
+    if (NkStringIntern(&(NkStringView const){ (char *)pathStr, strlen(pathStr) }, &pathId) != NkErr_Ok)
+        return;
+    NkUint64 const currTicks = NkTimerGetCurrentTicks();
+
+    NK_LOCK(actSelf->m_mtxLock);
+    for (NkSize i = 0; i < actSelf->m_nChanges; i++) {
+        if (actSelf->mp_chgArr[i].m_pathId != pathId)
+            continue;
+
+        /* The file is still being written to; restart the delay. */
+        actSelf->mp_chgArr[i].m_lastTicks = currTicks;
+        NK_UNLOCK(actSelf->m_mtxLock);
+        return;
+    }
+    if (actSelf->m_nChanges == actSelf->m_chgCap) {
+        NkSize const newCap = NK_MAX(actSelf->m_chgCap * 2, 16);
+
+        if (NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *actSelf->mp_chgArr, (NkVoid **)&actSelf->mp_chgArr) != NkErr_Ok) {
+            NK_UNLOCK(actSelf->m_mtxLock);
+
+            return;
+        }
+        actSelf->m_chgCap = newCap;
+    }
+    actSelf->mp_chgArr[actSelf->m_nChanges++] = (__NkInt_AssetManager_FileChange){ pathId, currTicks };
+    NK_UNLOCK(actSelf->m_mtxLock);
+}
+
+/**
+ * \brief  creates reload requests for all cached assets loaded from a changed file
+ * \param  [in, out] actSelf asset manager instance
+ * \param  [in] pathStr path of the changed file
+ * \param  [in, out] subList pointer to the list of requests that are to be submitted; new
+ *                   requests are prepended, linked through their \c mp_nextReq member
+ * \return \c NK_TRUE if the change was handled, \c NK_FALSE if it has to be retried
+ *         later because one of the assets is still being reloaded
+ * \note   The asset manager lock must be held by the caller.
+ */
+NK_INTERNAL NkBoolean __NkInt_AssetManager_ReloadPath(
+    _Inout_ __NkInt_AssetManager *actSelf,
+    _In_z_  char const *pathStr,
+    _Inout_ NkAssetRequest **subList
+) {
+    /*
+     * An asset must not be loaded twice at once, so the change is retried if one of the
+     * assets is still being reloaded, or loaded or finalized for a request.
+     */
+    for (NkAssetRequest *currReq = actSelf->mp_relHead; currReq != NULL; currReq = currReq->mp_nextRel)
+        if (__NkInt_AssetManager_IsSamePath(currReq->mp_assetRef->VT->GetPath(currReq->mp_assetRef), pathStr))
+            return NK_FALSE;
+    for (__NkInt_AssetManager_CacheEntry *currEntry = actSelf->mp_lruHead; currEntry != NULL; currEntry = currEntry->mp_nextEntry) {
+        NkIAsset *assetRef = currEntry->mp_assetRef;
+
+        if ((!NkJobIsDone(&currEntry->m_loadCtr) || currEntry->m_isLoaded) && __NkInt_AssetManager_IsSamePath(assetRef->VT->GetPath(assetRef), pathStr))
+            return NK_FALSE;
+    }
+
+    /*
+     * Assets that are not loaded pick up the new contents the next time they are queried,
+     * so only the assets that are ready are reloaded.
+     */
+    for (__NkInt_AssetManager_CacheEntry *currEntry = actSelf->mp_lruHead; currEntry != NULL; currEntry = currEntry->mp_nextEntry) {
+        NkIAsset *assetRef = currEntry->mp_assetRef;
+        if (assetRef->VT->GetAssetState(assetRef) != NkAsSt_Ready || !__NkInt_AssetManager_IsSamePath(assetRef->VT->GetPath(assetRef), pathStr))
+            continue;
+
+        NkAssetRequest *reqPtr;
+        if (__NkInt_AssetManager_CreateRequest(actSelf, &currEntry->m_assetUuid, NULL, &reqPtr) != NkErr_Ok)
+            continue;
+        reqPtr->m_isReload  = NK_TRUE;
+        reqPtr->mp_assetRef = assetRef;
+        reqPtr->mp_loadCtr  = &currEntry->m_loadCtr;
+        assetRef->VT->AddRef(assetRef);
+        NkJobCounterAddPending(reqPtr->mp_loadCtr, 1);
+
+        reqPtr->mp_nextRel  = actSelf->mp_relHead;
+        actSelf->mp_relHead = reqPtr;
+        reqPtr->mp_nextReq  = *subList;
+        *subList = reqPtr;
+    }
+    return NK_TRUE;
+}
+
+/**
+ * \brief removes a reload request from the list of reloads in progress
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] reqPtr reload request
+ * \note  The asset manager lock must be held by the caller.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_UnlinkReload(_Inout_ __NkInt_AssetManager *actSelf, _Inout_ NkAssetRequest *reqPtr) {
+    for (NkAssetRequest **currPtr = &actSelf->mp_relHead; *currPtr != NULL; currPtr = &(*currPtr)->mp_nextRel) {
+        if (*currPtr != reqPtr)
+            continue;
+
+        *currPtr = reqPtr->mp_nextRel;
+        break;
+    }
+
+    reqPtr->mp_nextRel = NULL;
+}
+
+/**
+ * \brief starts reloading the assets of all files that were not changed for a while
+ * \param [in, out] actSelf asset manager instance
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_DispatchReloads(_Inout_ __NkInt_AssetManager *actSelf) {
+    NkUint64 const currTicks = NkTimerGetCurrentTicks();
+    NkUint64 const minTicks  = NkTimerGetFrequency() * __NkInt_AssetManager_ReloadDelay / 1000;
+
+    NkAssetRequest *subList = NULL;
+    NK_LOCK(actSelf->m_mtxLock);
+    NkSize nKept = 0;
+    for (NkSize i = 0; i < actSelf->m_nChanges; i++) {
+        __NkInt_AssetManager_FileChange const chgEntry = actSelf->mp_chgArr[i];
+
+        if (currTicks - chgEntry.m_lastTicks < minTicks || !__NkInt_AssetManager_ReloadPath(actSelf, NkStringIdGetView(chgEntry.m_pathId)->mp_dataPtr, &subList))
+            actSelf->mp_chgArr[nKept++] = chgEntry;
+    }
+    actSelf->m_nChanges = nKept;
+    NK_UNLOCK(actSelf->m_mtxLock);
+
+    /*
+     * Jobs may be run right away on the calling thread if the queue is full, and they
+     * take the lock when they are done, so they are submitted after it was released.
+     */
+    while (subList != NULL) {
+        NkAssetRequest *reqPtr = subList;
+        subList            = reqPtr->mp_nextReq;
+        reqPtr->mp_nextReq = NULL;
+
+        NkErrorCode const errCode = NkJobSubmit(&(NkJobDescription const){
+            .mp_jobFn    = &__NkInt_AssetManager_ReloadJob,
+            .mp_extraCxt = (NkVoid *)reqPtr
+        }, 1, NULL, &reqPtr->m_jobCounter);
+        if (errCode != NkErr_Ok) {
+            NK_SYNCHRONIZED(actSelf->m_mtxLock, __NkInt_AssetManager_UnlinkReload(actSelf, reqPtr));
+
+            NkJobCounterSignal(reqPtr->mp_loadCtr);
+            __NkInt_AssetManager_FreeRequest(actSelf, reqPtr);
+        }
+    }
+}
+
+/**
+ * \brief swaps in the reloaded resources of an asset and frees the reload request
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] reqPtr reload request; must have been removed from the finalization
+ *                  queue
+ * \note  This function must only be called from the main thread, in between two frames.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_FinishReload(_Inout_ __NkInt_AssetManager *actSelf, _Inout_ NkAssetRequest *reqPtr) {
+    if (reqPtr->m_errCode == NkErr_Ok) {
+        __NkInt_AssetManager_FinalizeRequest(reqPtr);
+
+        if (reqPtr->m_errCode == NkErr_Ok)
+            NK_LOG_INFO("Reloaded asset \"%s\".", reqPtr->mp_assetRef->VT->GetPath(reqPtr->mp_assetRef));
+    }
+
+    NK_SYNCHRONIZED(actSelf->m_mtxLock, __NkInt_AssetManager_UnlinkReload(actSelf, reqPtr));
+    __NkInt_AssetManager_FreeRequest(actSelf, reqPtr);
+}
+
+
+/**
+ * \brief implements <tt>NkIAssetManager::AddRef()</tt> 
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_AssetManager_AddRef(_Inout_ NkIAssetManager *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Stub. */
+    return 1;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::Release()</tt> 
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_AssetManager_Release(_Inout_ NkIAssetManager *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Stub. */
+    return 1;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::QueryInterface()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryInterface(
+    _Inout_  NkIAssetManager *self,
+    _In_     NkUuid const *iId,
+    _Outptr_ NkVoid **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(iId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    /**
+     * \brief lists all interfaces implemented by the standard asset manager 
+     */
+    NK_INTERNAL NkOMImplementationInfo const gl_ImplIfaces[] = {
+        { NKOM_IIDOF(NkIBase)          },
+        { NKOM_IIDOF(NkIInitializable) },
+        { NKOM_IIDOF(NkIAssetManager)  },
+        { NULL                         }
+    };
+    if (NkOMQueryImplementationIndex(gl_ImplIfaces, iId) != SIZE_MAX) {
+        /* Interface is implemented. */
+        *resPtr = (NkVoid *)self;
+
+        __NkInt_AssetManager_AddRef(self);
+        return NkErr_Ok;
+    }
+
+    /* Interface is not implemented. */
+    *resPtr = NULL;
+    return NkErr_InterfaceNotImpl;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::Initialize()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_Initialize(
+    _Inout_     NkIAssetManager *self,
+    _Inout_opt_ NkVoid *initParam
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(initParam);
+
+    /* Get pointer to actual asset manager instance. */
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
+
+    /* Initialize asset cache. */
+    NkErrorCode errCode = NkHashtableCreate(&(NkHashtableProperties const){
+        .m_structSize   = sizeof(NkHashtableProperties),
+            .m_initCap      = 64,
+            .m_keyType      = NkHtKeyTy_Uuid,
+            .m_minCap       = 16,
+            .m_maxCap       = UINT32_MAX - 2,
+            .mp_fnElemFree  = NULL,
+            .m_isConcurrent = NK_TRUE
+    }, &actSelf->mp_assetCache);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* Initialize memory accounting. */
+    actSelf->m_memStats = (NkAssetMemoryStatistics){
+        .m_structSize = sizeof(NkAssetMemoryStatistics),
+        .m_memBudget  = __NkInt_AssetManager_DefBudget
+    };
+
+    /* Initialize synchronization primitive. */
+    NK_INITLOCK(actSelf->m_mtxLock);
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::CreateDatabase()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_CreateDatabase(
+    _Inout_       NkIAssetManager *self,
+    _In_z_ _Utf8_ char const *dbPath
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dbPath != NULL, NkErr_InParameter);
+
+    /**
+     * \brief pointer to current database schema 
+     */
+    NK_INTERNAL NkStringView const gl_c_CurrDbSchema = NK_MAKE_STRING_VIEW(
+        "PRAGMA foreign_keys = OFF;\n"
+        "PRAGMA user_version = 2;\n"
+
+        "/*"
+        " * table assets"
+        " * defines the assets that are part of the game"
+        " */"
+        "CREATE TABLE assets(\n"
+            "uuid BLOB,                  -- unique identifier, saved as a literal 16-byte integer\n"
+            "type INT          NOT NULL, -- type (integral)\n"
+            "name VARCHAR(128) NOT NULL, -- name, up to 128 characters\n"
+            "path TEXT         NOT NULL, -- path string, using '/' as separator\n"
+            "docs TEXT,                  -- (optional) documentation string\n"
+            ""
+            "PRIMARY KEY (uuid)"
+        ");"
+
+        "/*"
+        " * table dependencies"
+        " * defines the dependency graph"
+        " */"
+        "CREATE TABLE dependencies(\n"
+            "depender BLOB NOT NULL, -- UUID of the asset that depends on 'dependee'\n"
+            "dependee BLOB NOT NULL, -- UUID of the asset that is being depended on\n"
+
+            "FOREIGN KEY (depender) REFERENCES assets(uuid),\n"
+            "FOREIGN KEY (dependee) REFERENCES assets(uuid),\n"
+            "UNIQUE      (depender, dependee),\n"
+            "CHECK       (depender != dependee)\n"
+        ");\n"
+
+        "/*"
+        " * table chunks"
+        " * holds the tile data of the chunks a world is made of"
+        " */"
+        "CREATE TABLE chunks(\n"
+            "world BLOB NOT NULL, -- UUID of the world asset the chunk belongs to\n"
+            "x     INT  NOT NULL, -- x-coordinate, in chunks\n"
+            "y     INT  NOT NULL, -- y-coordinate, in chunks\n"
+            "data  BLOB NOT NULL, -- tile data, as row-major array of 32-bit integers\n"
+
+            "FOREIGN KEY (world) REFERENCES assets(uuid),\n"
+            "PRIMARY KEY (world, x, y)\n"
+        ");\n"
+
+        "PRAGMA foreign_keys = ON;"
+    );
+
+    /* Create new database handle. */
+    NkIDatabase *dbHandle;
+    NkErrorCode errCode = NkOMCreateInstance(
+        NKOM_CLSIDOF(NkIDatabase),
+        NULL,
+        NKOM_IIDOF(NkIDatabase),
+        NULL,
+        (NkIBase **)&dbHandle
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* Create the database. */
+    errCode = dbHandle->VT->Create(dbHandle, gl_c_CurrDbSchema.mp_dataPtr, dbPath, NkDbMode_ReadWrite, NULL);
+    if (errCode != NkErr_Ok) {
+        dbHandle->VT->Release(dbHandle);
+
+        return errCode;
+    }
+
+    /*
+     * Close the database again. Require a subsequent call to '::OpenDatabase()' to
+     * finish the opening procedure. Releasing it will also close it if the connection
+     * handle itself is destroyed.
+     */
+    dbHandle->VT->Release(dbHandle);
+    return NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::OpenDatabase()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_OpenDatabase(
+    _Inout_       NkIAssetManager *self,
+    _In_z_ _Utf8_ char const *dbPath
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dbPath != NULL && *dbPath ^ '\0', NkErr_InParameter);
+
+    /* Get pointer to actual asset manager instance. */
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
+
+    /* Create new database handle. */
+    NkErrorCode errCode = NkOMCreateInstance(
+        NKOM_CLSIDOF(NkIDatabase),
+        NULL,
+        NKOM_IIDOF(NkIDatabase),
+        NULL,
+        (NkIBase **)&actSelf->mp_dbConn
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /*
+     * Attach the database to the handle. If the application is running in standalone
+     * mode, we assume that the application is running in a freestanding environment,
+     * that is, without the editor running. In such a case, the database is only
+     * readable; otherwise, that is, when running in 'attached' mode, the database must
+     * be opened in read-write mode. The default options of read-only connections
+     * memory-map the database, so lookups do not go through read calls.
+     */
+    errCode = actSelf->mp_dbConn->VT->Open(
+        actSelf->mp_dbConn,
+        dbPath,
+        NkApplicationIsStandalone()
+            ? NkDbMode_ReadOnly
+            : NkDbMode_ReadWrite,
+        NULL
+    );
+    if (errCode != NkErr_Ok) {
+        /* If we failed to open the database, we destroy the handle, too. */
+        actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
+
+        actSelf->mp_dbConn = NULL;
+        return errCode;
+    }
+
+    /* Remember the path; lookups open read-only connections of their own. */
+    errCode = NkStringCreate(dbPath, 1, &actSelf->m_dbFileName);
+    if (errCode != NkErr_Ok) {
+        actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
+
+        actSelf->mp_dbConn = NULL;
+        return errCode;
+    }
+
+    /*
+     * Create the 'query dependencies' statement. It resolves the transitive dependencies
+     * of an asset in a single query and labels every dependency with the length of the
+     * longest chain that leads to it from the root. Loading the dependencies in the order
+     * of decreasing level thus loads every asset after everything it depends on. The
+     * recursion is limited so that cycles in the dependency graph cannot hang the query.
+     */
+    errCode = actSelf->mp_dbConn->VT->CreateStatement(
+        actSelf->mp_dbConn,
+        "WITH RECURSIVE closure(uuid, level) AS ("
+            "SELECT dependee, 1 FROM dependencies WHERE depender = ?1 "
+            "UNION "
+            "SELECT d.dependee, c.level + 1 FROM dependencies AS d JOIN closure AS c ON d.depender = c.uuid "
+            "WHERE c.level < 64"
+        ") "
+        "SELECT uuid, MAX(level) AS level FROM closure WHERE uuid != ?1 GROUP BY uuid ORDER BY level DESC",
+        &actSelf->mp_queryDepsStmt
+    );
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+
+    /*
+     * Create the 'query batch' statement. It resolves up to 64 assets per execution;
+     * unused parameters are bound to NULL which never matches.
+     */
+#define __NkInt_AssetManager_Params8 "?, ?, ?, ?, ?, ?, ?, ?"
+    errCode = actSelf->mp_dbConn->VT->CreateStatement(
+        actSelf->mp_dbConn,
+        "SELECT * FROM assets WHERE uuid IN ("
+            __NkInt_AssetManager_Params8 ", " __NkInt_AssetManager_Params8 ", "
+            __NkInt_AssetManager_Params8 ", " __NkInt_AssetManager_Params8 ", "
+            __NkInt_AssetManager_Params8 ", " __NkInt_AssetManager_Params8 ", "
+            __NkInt_AssetManager_Params8 ", " __NkInt_AssetManager_Params8
+        ")",
+        &actSelf->mp_queryBatchStmt
+    );
+#undef __NkInt_AssetManager_Params8
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+
+    /* All good. */
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    /*
+     * If we could not create the statements, we shutdown the database since we cannot
+     * really use the asset manager without the statements being ready.
+     */
+    if (actSelf->mp_queryDepsStmt != NULL)
+        actSelf->mp_queryDepsStmt->VT->Release(actSelf->mp_queryDepsStmt);
+    actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
+    NkStringDestroy(&actSelf->m_dbFileName);
+
+    actSelf->mp_dbConn        = NULL;
+    actSelf->mp_queryDepsStmt = NULL;
+    return errCode;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::CloseDatabase()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_CloseDatabase(_Inout_ NkIAssetManager *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to actual asset manager instance. */
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
+
+    /* If no database is open, fail. */
+    if (actSelf->mp_dbConn == NULL)
+        return NkErr_ComponentState;
+
+    /*
+     * Close the database and release all database-specific resources. No lookups may be
+     * running anymore, so all read-only connections are idle.
+     */
+    while (actSelf->mp_idleConns != NULL) {
+        __NkInt_AssetManager_ReadConn *connPtr = actSelf->mp_idleConns;
+
+        actSelf->mp_idleConns = connPtr->mp_nextConn;
+        __NkInt_AssetManager_DestroyReadConn(connPtr);
+    }
+    actSelf->mp_queryBatchStmt->VT->Release(actSelf->mp_queryBatchStmt);
+    actSelf->mp_queryDepsStmt->VT->Release(actSelf->mp_queryDepsStmt);
+    actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
+    NkStringDestroy(&actSelf->m_dbFileName);
+    actSelf->mp_dbConn         = NULL;
+    actSelf->mp_queryDepsStmt  = NULL;
+    actSelf->mp_queryBatchStmt = NULL;
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::QueryAsset()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryAsset(
+    _Inout_  NkIAssetManager *self,
+    _In_     NkUuid const *assetId,
+    _Outptr_ NkIAsset **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(assetId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    return __NkInt_AssetManager_LookupAsset((__NkInt_AssetManager *)self, assetId, resPtr);
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::QueryAssets()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryAssets(
+    _Inout_         NkIAssetManager *self,
+    _I_array_(nIds) NkUuid const *idArr,
+    _In_            NkSize nIds,
+    _O_array_(nIds) NkIAsset **resArr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(idArr != NULL || nIds == 0, NkErr_InParameter);
+    NK_ASSERT(resArr != NULL || nIds == 0, NkErr_OutParameter);
+
+    /* Get pointer to actual asset manager instance. */
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
+
+    for (NkSize i = 0; i < nIds; i++)
+        resArr[i] = NULL;
+
+    NkErrorCode errCode = NkErr_Ok;
+    NK_LOCK(actSelf->m_mtxLock);
+
+    /*
+     * Serve everything we can from the cache. The remaining UUIDs are collected into
+     * batches and resolved by as few executions of the batch statement as possible.
+     */
+    NkUuid batchIds[__NkInt_AssetManager_BatchSize];
+    NkSize batchInds[__NkInt_AssetManager_BatchSize];
+    NkSize nBatchIds = 0;
+    for (NkSize i = 0; i <= nIds; i++) {
+        if (i < nIds) {
+            __NkInt_AssetManager_CacheEntry *entryPtr;
+            if (NkHashtableAt(actSelf->mp_assetCache, &(NkHashtableKey const){ .mp_uuidKey = (NkUuid *)&idArr[i] }, (NkVoid **)&entryPtr) == NkErr_Ok) {
+                __NkInt_AssetManager_UnlinkEntry(actSelf, entryPtr);
+                __NkInt_AssetManager_LinkEntry(actSelf, entryPtr);
+
+                resArr[i] = entryPtr->mp_assetRef;
+                resArr[i]->VT->AddRef(resArr[i]);
+                continue;
+            }
+
+            batchIds[nBatchIds]    = idArr[i];
+            batchInds[nBatchIds++] = i;
+        }
+        if (nBatchIds == 0 || (i < nIds && nBatchIds < __NkInt_AssetManager_BatchSize))
+            continue;
+
+        /* Run the batch. */
+        if (actSelf->mp_dbConn == NULL) {
+            errCode = NkErr_ComponentState;
+
+            break;
+        }
+        for (NkSize j = 0; j < __NkInt_AssetManager_BatchSize; j++) {
+            if (j < nBatchIds) {
+                NkVariant paramVar;
+                NkVariantSet(&paramVar, NkVarTy_Uuid, &batchIds[j]);
+
+                actSelf->mp_queryBatchStmt->VT->Bind(actSelf->mp_queryBatchStmt, (NkUint32)j + 1U, &paramVar);
+            } else
+                actSelf->mp_queryBatchStmt->VT->Unbind(actSelf->mp_queryBatchStmt, (NkUint32)j + 1U);
+        }
+        errCode = actSelf->mp_dbConn->VT->Execute(
+            actSelf->mp_dbConn,
+            actSelf->mp_queryBatchStmt,
+            &__NkInt_AssetManager_QueryBatchIterFn,
+            (NkVoid *)&(__NkInt_AssetManager_BatchCxt){
+                .mp_idArr  = batchIds,
+                .mp_indArr = batchInds,
+                .m_nIds    = nBatchIds,
+                .mp_resArr = resArr
+            }
+        );
+        if (errCode != NkErr_Ok)
+            break;
+
+        /* Add the new assets to the cache; duplicates only need to be added once. */
+        for (NkSize j = 0; j < nBatchIds; j++) {
+            NkIAsset **assetPtr = &resArr[batchInds[j]];
+            if (*assetPtr == NULL || NkHashtableContains(actSelf->mp_assetCache, &(NkHashtableKey const){ .mp_uuidKey = &batchIds[j] }))
+                continue;
+
+            if ((errCode = __NkInt_AssetManager_InsertEntry(actSelf, *assetPtr)) != NkErr_Ok)
+                break;
+        }
+        if (errCode != NkErr_Ok)
+            break;
+        nBatchIds = 0;
+    }
+    NK_UNLOCK(actSelf->m_mtxLock);
+
+    if (errCode != NkErr_Ok) {
+        /* On failure, hand out nothing. */
+        for (NkSize i = 0; i < nIds; i++)
+            if (resArr[i] != NULL) {
+                resArr[i]->VT->Release(resArr[i]);
+
+                resArr[i] = NULL;
+            }
+
+        return errCode;
+    }
+
+    for (NkSize i = 0; i < nIds; i++)
+        if (resArr[i] == NULL)
+            return NkErr_ItemNotFound;
+    return NkErr_Ok;
 }
 
 /**
- * \brief implements <tt>NkIAssetManager::Initialize()</tt> 
+ * \brief implements <tt>NkIAssetManager::QueryAssetAsync()</tt> 
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_Initialize(
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryAssetAsync(
     _Inout_     NkIAssetManager *self,
-    _Inout_opt_ NkVoid *initParam
+    _In_        NkUuid const *assetId,
+    _Inout_opt_ NkVoid *extraCxtPtr,
+    _Init_ptr_  NkAssetRequest **reqPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_UNREFERENCED_PARAMETER(initParam);
+    NK_ASSERT(assetId != NULL, NkErr_InParameter);
+    NK_ASSERT(reqPtr != NULL, NkErr_OutptrParameter);
 
     /* Get pointer to actual asset manager instance. */
     __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
 
-    /* Initialize asset cache. */
-    NkErrorCode errCode = NkHashtableCreate(&(NkHashtableProperties const){
-        .m_structSize  = sizeof(NkHashtableProperties),
-            .m_initCap     = 64,
-            .m_keyType     = NkHtKeyTy_Uuid,
-            .m_minCap      = 16,
-            .m_maxCap      = UINT32_MAX - 2,
-            .mp_fnElemFree = NULL
-    }, &actSelf->mp_assetCache);
+    /* Create the request. */
+    NkErrorCode errCode = __NkInt_AssetManager_CreateRequest(actSelf, assetId, extraCxtPtr, reqPtr);
     if (errCode != NkErr_Ok)
         return errCode;
+    NkAssetRequest *actReq = *reqPtr;
 
-    /* Initialize synchronization primitive. */
-    NK_INITLOCK(actSelf->m_mtxLock);
-    /* All good. */
+    /* Run the lookup and the loading on a worker. */
+    errCode = NkJobSubmit(&(NkJobDescription const){
+        .mp_jobFn    = &__NkInt_AssetManager_RequestJob,
+        .mp_extraCxt = (NkVoid *)actReq
+    }, 1, NULL, &actReq->m_jobCounter);
+    if (errCode != NkErr_Ok) {
+        NkGPFree(actReq);
+
+        *reqPtr = NULL;
+        return errCode;
+    }
+
+    NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&actSelf->m_nRequests));
     return NkErr_Ok;
 }
 
 /**
- * \brief implements <tt>NkIAssetManager::CreateDatabase()</tt> 
+ * \brief implements <tt>NkIAssetManager::PrefetchAsset()</tt> 
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_CreateDatabase(
-    _Inout_       NkIAssetManager *self,
-    _In_z_ _Utf8_ char const *dbPath
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_PrefetchAsset(
+    _Inout_     NkIAssetManager *self,
+    _In_        NkUuid const *rootId,
+    _Inout_opt_ NkVoid *extraCxtPtr,
+    _Init_ptr_  NkAssetRequest **reqPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_ASSERT(dbPath != NULL, NkErr_InParameter);
+    NK_ASSERT(rootId != NULL, NkErr_InParameter);
+    NK_ASSERT(reqPtr != NULL, NkErr_OutptrParameter);
 
-    /**
-     * \brief pointer to current database schema 
-     */
-    NK_INTERNAL NkStringView const gl_c_CurrDbSchema = NK_MAKE_STRING_VIEW(
-        "PRAGMA foreign_keys = OFF;\n"
-        "PRAGMA user_version = 1;\n"
+    /* Get pointer to actual asset manager instance. */
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
 
-        "/*"
-        " * table assets"
-        " * defines the assets that are part of the game"
-        " */"
-        "CREATE TABLE assets(\n"
-            "uuid BLOB,                  -- unique identifier, saved as a literal 16-byte integer\n"
-            "type INT          NOT NULL, -- type (integral)\n"
-            "name VARCHAR(128) NOT NULL, -- name, up to 128 characters\n"
-            "path TEXT         NOT NULL, -- path string, using '/' as separator\n"
-            "docs TEXT,                  -- (optional) documentation string\n"
-            ""
-            "PRIMARY KEY (uuid)"
-        ");"
+    /* Resolve the dependency closure of the root. */
+    __NkInt_AssetManager_DepList depList = { NULL, 0, 0 };
+    NkErrorCode errCode;
+    NK_PROFILE_SCOPE("ResolveDependencies") {
+        NK_LOCK(actSelf->m_mtxLock);
+        if (actSelf->mp_dbConn != NULL) {
+            NkVariant paramVar;
+            NkVariantSet(&paramVar, NkVarTy_Uuid, rootId);
+            actSelf->mp_queryDepsStmt->VT->Bind(actSelf->mp_queryDepsStmt, 1U, &paramVar);
+
+            errCode = actSelf->mp_dbConn->VT->Execute(
+                actSelf->mp_dbConn,
+                actSelf->mp_queryDepsStmt,
+                &__NkInt_AssetManager_QueryDepsIterFn,
+                (NkVoid *)&depList
+            );
+            actSelf->mp_queryDepsStmt->VT->Unbind(actSelf->mp_queryDepsStmt, 1U);
+        } else
+            errCode = NkErr_ComponentState;
+        NK_UNLOCK(actSelf->m_mtxLock);
+    }
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
 
-        "/*"
-        " * table dependencies"
-        " * defines the dependency graph"
-        " */"
-        "CREATE TABLE dependencies(\n"
-            "depender BLOB NOT NULL, -- UUID of the asset that depends on 'dependee'\n"
-            "dependee BLOB NOT NULL, -- UUID of the asset that is being depended on\n"
+    /* Create the root request and the requests of all dependencies. */
+    errCode = __NkInt_AssetManager_CreateRequest(actSelf, rootId, extraCxtPtr, reqPtr);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+    NkAssetRequest *rootReq = *reqPtr;
+    NkUint32 const nLevels = depList.m_nEntries > 0 ? depList.mp_entryArr[0].m_depLevel + 1 : 1;
 
-            "FOREIGN KEY (depender) REFERENCES assets(uuid),\n"
-            "FOREIGN KEY (dependee) REFERENCES assets(uuid),\n"
-            "UNIQUE      (depender, dependee),\n"
-            "CHECK       (depender != dependee)\n"
-        ");\n"
+    errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nLevels * sizeof *rootReq->mp_lvlCtrs, 0, NK_TRUE, (NkVoid **)&rootReq->mp_lvlCtrs);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERRREQ;
+    rootReq->m_nLevels = nLevels;
+    if (depList.m_nEntries > 0) {
+        errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), depList.m_nEntries * sizeof *rootReq->mp_depReqs, 0, NK_TRUE, (NkVoid **)&rootReq->mp_depReqs);
+        if (errCode != NkErr_Ok)
+            goto lbl_ONERRREQ;
+    }
+    for (; rootReq->m_nDepReqs < depList.m_nEntries; rootReq->m_nDepReqs++) {
+        __NkInt_AssetManager_DepEntry const *entryPtr = &depList.mp_entryArr[rootReq->m_nDepReqs];
 
-        "PRAGMA foreign_keys = ON;"
-    );
+        errCode = __NkInt_AssetManager_CreateRequest(actSelf, &entryPtr->m_depUuid, extraCxtPtr, &rootReq->mp_depReqs[rootReq->m_nDepReqs]);
+        if (errCode != NkErr_Ok)
+            goto lbl_ONERRREQ;
+        rootReq->mp_depReqs[rootReq->m_nDepReqs]->mp_waitCtr = &rootReq->mp_lvlCtrs[entryPtr->m_depLevel];
+    }
+    rootReq->mp_waitCtr = &rootReq->mp_lvlCtrs[0];
 
-    /* Create new database handle. */
-    NkIDatabase *dbHandle;
-    NkErrorCode errCode = NkOMCreateInstance(
-        NKOM_CLSIDOF(NkIDatabase),
-        NULL,
-        NKOM_IIDOF(NkIDatabase),
-        NULL,
-        (NkIBase **)&dbHandle
-    );
+    /* Describe the loading jobs; the root is loaded last. */
+    NkJobDescription *jobArr;
+    errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (depList.m_nEntries + 1) * sizeof *jobArr, 0, NK_FALSE, (NkVoid **)&jobArr);
     if (errCode != NkErr_Ok)
-        return errCode;
+        goto lbl_ONERRREQ;
+    for (NkSize i = 0; i <= depList.m_nEntries; i++)
+        jobArr[i] = (NkJobDescription){
+            .mp_jobFn    = &__NkInt_AssetManager_RequestJob,
+            .mp_extraCxt = (NkVoid *)(i < depList.m_nEntries ? rootReq->mp_depReqs[i] : rootReq)
+        };
 
-    /* Create the database. */
-    errCode = dbHandle->VT->Create(dbHandle, gl_c_CurrDbSchema.mp_dataPtr, dbPath, NkDbMode_ReadWrite);
-    if (errCode != NkErr_Ok) {
-        dbHandle->VT->Release(dbHandle);
+    /*
+     * Submit one batch per level, deepest level first. The dependencies are sorted by
+     * decreasing level, so the jobs of a level are contiguous. Every batch only starts
+     * once the previous batch has finished, so that an asset is never loaded before the
+     * assets it depends on.
+     */
+    NkJobCounter *prevCtr  = NULL;
+    NkSize        firstInd = 0;
+    for (NkUint32 currLvl = rootReq->m_nLevels; currLvl-- > 0;) {
+        NkSize lastInd = firstInd;
+        while (lastInd < depList.m_nEntries && depList.mp_entryArr[lastInd].m_depLevel == currLvl)
+            ++lastInd;
+        if (currLvl == 0)
+            lastInd = depList.m_nEntries + 1;
+        if (lastInd == firstInd)
+            continue;
 
-        return errCode;
+        /*
+         * Jobs that were already submitted cannot be recalled. Thus, if a batch cannot be
+         * submitted, its requests are marked as failed and the prefetch is handed out as
+         * usual.
+         */
+        NkErrorCode const subCode = NkJobSubmit(&jobArr[firstInd], lastInd - firstInd, prevCtr, &rootReq->mp_lvlCtrs[currLvl]);
+        if (subCode == NkErr_Ok)
+            prevCtr = &rootReq->mp_lvlCtrs[currLvl];
+        else {
+            for (NkSize i = firstInd; i < lastInd; i++) {
+                NkAssetRequest *failReq = (NkAssetRequest *)jobArr[i].mp_extraCxt;
+
+                failReq->m_errCode = subCode;
+                __NkInt_AssetManager_SetRequestState(failReq, NkAsSt_Invalid);
+            }
+        }
+        firstInd = lastInd;
     }
 
-    /*
-     * Close the database again. Require a subsequent call to '::OpenDatabase()' to
-     * finish the opening procedure. Releasing it will also close it if the connection
-     * handle itself is destroyed.
-     */
-    dbHandle->VT->Release(dbHandle);
+    NkGPFree(jobArr);
+    NkGPFree(depList.mp_entryArr);
+    NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&actSelf->m_nRequests));
     return NkErr_Ok;
+
+lbl_ONERRREQ:
+    __NkInt_AssetManager_FreeRequest(actSelf, *reqPtr);
+lbl_ONERROR:
+    NkGPFree(depList.mp_entryArr);
+
+    *reqPtr = NULL;
+    return errCode;
 }
 
 /**
- * \brief implements <tt>NkIAssetManager::OpenDatabase()</tt> 
+ * \brief implements <tt>NkIAssetManager::QueryRequestState()</tt> 
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_OpenDatabase(
-    _Inout_       NkIAssetManager *self,
-    _In_z_ _Utf8_ char const *dbPath
+NK_INTERNAL NkAssetState NK_CALL __NkInt_AssetManager_QueryRequestState(
+    _Inout_ NkIAssetManager *self,
+    _In_    NkAssetRequest const *reqPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_ASSERT(dbPath != NULL && *dbPath ^ '\0', NkErr_InParameter);
+    NK_ASSERT(reqPtr != NULL, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    return (NkAssetState)InterlockedCompareExchange((LONG volatile *)&reqPtr->m_reqState, 0, 0);
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::WaitForRequest()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_WaitForRequest(
+    _Inout_   NkIAssetManager *self,
+    _Inout_   NkAssetRequest *reqPtr,
+    _Out_opt_ NkIAsset **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(reqPtr != NULL, NkErr_InOutParameter);
 
     /* Get pointer to actual asset manager instance. */
     __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
 
-    /* Create new database handle. */
-    NkErrorCode errCode = NkOMCreateInstance(
-        NKOM_CLSIDOF(NkIDatabase),
-        NULL,
-        NKOM_IIDOF(NkIDatabase),
-        NULL,
-        (NkIBase **)&actSelf->mp_dbConn
-    );
-    if (errCode != NkErr_Ok)
-        return errCode;
-
     /*
-     * Attach the database to the handle. If the application is running in standalone
-     * mode, we assume that the application is running in a freestanding environment,
-     * that is, without the editor running. In such a case, the database is only
-     * readable; otherwise, that is, when running in 'attached' mode, the database must
-     * be opened in read-write mode.
+     * Wait for the loading job; if the asset still needs to be finalized, do it now. The
+     * root of a prefetch is loaded last, so once its job has finished, all dependencies
+     * have been loaded, too; they are finalized before the root.
      */
-    errCode = actSelf->mp_dbConn->VT->Open(
-        actSelf->mp_dbConn,
-        dbPath,
-        NkApplicationIsStandalone()
-            ? NkDbMode_ReadOnly
-            : NkDbMode_ReadWrite
-    );
-    if (errCode != NkErr_Ok) {
-        /* If we failed to open the database, we destroy the handle, too. */
-        actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
-
-        actSelf->mp_dbConn = NULL;
-        return errCode;
+    NkJobWait(reqPtr->mp_waitCtr);
+    for (NkSize i = 0; i <= reqPtr->m_nDepReqs; i++) {
+        NkAssetRequest *currReq = i < reqPtr->m_nDepReqs ? reqPtr->mp_depReqs[i] : reqPtr;
+
+        NK_LOCK(actSelf->m_mtxLock);
+        NkBoolean const isFinalize = currReq->m_isQueued;
+        if (isFinalize)
+            __NkInt_AssetManager_UnlinkRequest(actSelf, currReq);
+        NK_UNLOCK(actSelf->m_mtxLock);
+        if (isFinalize)
+            __NkInt_AssetManager_FinalizeRequest(currReq);
     }
 
-    /* Create the 'query asset' statement. */
-    errCode = actSelf->mp_dbConn->VT->CreateStatement(
-        actSelf->mp_dbConn,
-        "SELECT * FROM assets WHERE uuid = ?",
-        &actSelf->mp_queryAssetStmt
-    );
-    if (errCode != NkErr_Ok) {
-        /*
-         * If we could not create the statement, we shutdown the database since we cannot
-         * really use the asset manager without the statements being ready.
-         */
-        actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
+    if (self->VT->QueryRequestState(self, reqPtr) != NkAsSt_Ready) {
+        if (resPtr != NULL)
+            *resPtr = NULL;
 
-        actSelf->mp_dbConn = NULL;
-        return errCode;
+        return reqPtr->m_errCode;
     }
 
-    /* All good. */
+    if (resPtr != NULL) {
+        *resPtr = reqPtr->mp_assetRef;
+
+        (*resPtr)->VT->AddRef(*resPtr);
+    }
     return NkErr_Ok;
 }
 
 /**
- * \brief implements <tt>NkIAssetManager::CloseDatabase()</tt> 
+ * \brief implements <tt>NkIAssetManager::ReleaseRequest()</tt> 
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_CloseDatabase(_Inout_ NkIAssetManager *self) {
+NK_INTERNAL NkVoid NK_CALL __NkInt_AssetManager_ReleaseRequest(
+    _Inout_      NkIAssetManager *self,
+    _Uninit_ptr_ NkAssetRequest **reqPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(reqPtr != NULL, NkErr_InOutParameter);
+
+    if (*reqPtr == NULL)
+        return;
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
+
+    __NkInt_AssetManager_FreeRequest(actSelf, *reqPtr);
+    NK_IGNORE_RETURN_VALUE(InterlockedDecrement(&actSelf->m_nRequests));
+
+    *reqPtr = NULL;
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::ProcessRequests()</tt> 
+ */
+NK_INTERNAL NkUint32 NK_CALL __NkInt_AssetManager_ProcessRequests(_Inout_ NkIAssetManager *self, _In_ NkUint32 maxCount) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
     /* Get pointer to actual asset manager instance. */
     __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
 
-    /* If no database is open, fail. */
-    if (actSelf->mp_dbConn == NULL)
-        return NkErr_ComponentState;
+    /* Start reloading the assets whose files have changed. */
+    if (actSelf->mp_fileWatch != NULL)
+        __NkInt_AssetManager_DispatchReloads(actSelf);
 
-    /* Close the database and release all database-specific resources. */
-    actSelf->mp_queryAssetStmt->VT->Release(actSelf->mp_queryAssetStmt);
-    actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
-    actSelf->mp_dbConn         = NULL;
-    actSelf->mp_queryAssetStmt = NULL;
+    /*
+     * Reloaded assets swap their resources here, so the frame that was just drawn used the
+     * old ones entirely, and the next frame uses the new ones.
+     */
+    NkUint32 nFinalized = 0;
+    for (; nFinalized < maxCount; nFinalized++) {
+        NK_LOCK(actSelf->m_mtxLock);
+        NkAssetRequest *reqPtr = actSelf->mp_finHead;
+        if (reqPtr != NULL)
+            __NkInt_AssetManager_UnlinkRequest(actSelf, reqPtr);
+        NK_UNLOCK(actSelf->m_mtxLock);
+        if (reqPtr == NULL)
+            break;
+
+        if (reqPtr->m_isReload)
+            __NkInt_AssetManager_FinishReload(actSelf, reqPtr);
+        else
+            __NkInt_AssetManager_FinalizeRequest(reqPtr);
+    }
 
-    /* All good. */
-    return NkErr_Ok;
+    /* Enforce the memory budget. */
+    __NkInt_AssetManager_Trim(actSelf, NK_FALSE);
+    return nFinalized;
 }
 
+
 /**
- * \brief implements <tt>NkIAssetManager::QueryAsset()</tt> 
+ * \brief implements <tt>NkIAssetManager::QueryCacheCount()</tt> 
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryAsset(
-    _Inout_  NkIAssetManager *self,
-    _In_     NkUuid const *assetId,
-    _Outptr_ NkIAsset **resPtr
-) {
+NK_INTERNAL NkSize NK_CALL __NkInt_AssetManager_QueryCacheCount(_Inout_ NkIAssetManager *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_ASSERT(assetId != NULL, NkErr_InParameter);
-    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
 
     /* Get pointer to actual asset manager instance. */
     __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
 
-    /* Check if the given asset handle is already present in the cache. */
-    NkErrorCode eCode = NkHashtableAt(
-        actSelf->mp_assetCache,
-        &(NkHashtableKey const){
-            .mp_uuidKey = (NkUuid *)assetId
-        },
-        resPtr
-    );
-    if (eCode == NkErr_Ok) {
-        /* Present in cache; add reference and return. */
-        (*resPtr)->VT->AddRef(*resPtr);
+    /*
+     * The asset cache is concurrent, so counting does not need to take the asset manager
+     * lock.
+     */
+    return actSelf->mp_assetCache != NULL ? NkHashtableCount(actSelf->mp_assetCache) : 0U;
+}
 
-        return NkErr_Ok;
-    }
+/**
+ * \brief implements <tt>NkIAssetManager::SetMemoryBudget()</tt> 
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_AssetManager_SetMemoryBudget(_Inout_ NkIAssetManager *self, _In_ NkSize nBytes) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    /* Bind the given UUID parameter. */
-    NkVariant paramVar;
-    NkVariantSet(&paramVar, NkVarTy_Uuid, assetId);
-    actSelf->mp_queryAssetStmt->VT->Bind(actSelf->mp_queryAssetStmt, 1U, &paramVar);
+    /* Get pointer to actual asset manager instance. */
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
 
-    /* Query the asset and add it to the cache. */
-    eCode = actSelf->mp_dbConn->VT->Execute(
-        actSelf->mp_dbConn,
-        actSelf->mp_queryAssetStmt,
-        &__NkInt_AssetManager_QueryAssetIterFn,
-        (NkVoid *)resPtr
-    );
-    if (eCode != NkErr_Ok)
-        *resPtr = NULL;
+    NK_LOCK(actSelf->m_mtxLock);
+    actSelf->m_memStats.m_memBudget = nBytes;
+    NK_UNLOCK(actSelf->m_mtxLock);
 
-    /* Unbind param and return. */
-    actSelf->mp_queryAssetStmt->VT->Unbind(actSelf->mp_queryAssetStmt, 1U);
-    return eCode;
+    __NkInt_AssetManager_Trim(actSelf, NK_FALSE);
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::QueryMemoryStatistics()</tt> 
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_AssetManager_QueryMemoryStatistics(
+    _Inout_ NkIAssetManager *self,
+    _Out_   NkAssetMemoryStatistics *statsPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(statsPtr != NULL, NkErr_OutParameter);
+
+    /* Get pointer to actual asset manager instance. */
+    __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
+
+    NK_LOCK(actSelf->m_mtxLock);
+    *statsPtr = actSelf->m_memStats;
+    NK_UNLOCK(actSelf->m_mtxLock);
+}
+
+/**
+ * \brief implements <tt>NkIAssetManager::QueryPackArchive()</tt> 
+ */
+NK_INTERNAL NkPackArchive const *NK_CALL __NkInt_AssetManager_QueryPackArchive(_Inout_ NkIAssetManager *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return ((__NkInt_AssetManager *)self)->mp_packArch;
 }
 
 
@@ -403,14 +1966,25 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_AssetManager_QueryAsset(
  */
 NK_INTERNAL __NkInt_AssetManager gl_AssetManager = {
     .NkIAssetManager_Iface.VT = &(struct __NkIAssetManager_VTable__){
-        .QueryInterface = &__NkInt_AssetManager_QueryInterface,
-        .AddRef         = &__NkInt_AssetManager_AddRef,
-        .Release        = &__NkInt_AssetManager_Release,
-        .Initialize     = &__NkInt_AssetManager_Initialize,
-        .CreateDatabase = &__NkInt_AssetManager_CreateDatabase,
-        .OpenDatabase   = &__NkInt_AssetManager_OpenDatabase,
-        .CloseDatabase  = &__NkInt_AssetManager_CloseDatabase,
-        .QueryAsset     = &__NkInt_AssetManager_QueryAsset
+        .QueryInterface        = &__NkInt_AssetManager_QueryInterface,
+        .AddRef                = &__NkInt_AssetManager_AddRef,
+        .Release               = &__NkInt_AssetManager_Release,
+        .Initialize            = &__NkInt_AssetManager_Initialize,
+        .CreateDatabase        = &__NkInt_AssetManager_CreateDatabase,
+        .OpenDatabase          = &__NkInt_AssetManager_OpenDatabase,
+        .CloseDatabase         = &__NkInt_AssetManager_CloseDatabase,
+        .QueryAsset            = &__NkInt_AssetManager_QueryAsset,
+        .QueryAssets           = &__NkInt_AssetManager_QueryAssets,
+        .QueryAssetAsync       = &__NkInt_AssetManager_QueryAssetAsync,
+        .PrefetchAsset         = &__NkInt_AssetManager_PrefetchAsset,
+        .QueryRequestState     = &__NkInt_AssetManager_QueryRequestState,
+        .WaitForRequest        = &__NkInt_AssetManager_WaitForRequest,
+        .ReleaseRequest        = &__NkInt_AssetManager_ReleaseRequest,
+        .ProcessRequests       = &__NkInt_AssetManager_ProcessRequests,
+        .QueryCacheCount       = &__NkInt_AssetManager_QueryCacheCount,
+        .SetMemoryBudget       = &__NkInt_AssetManager_SetMemoryBudget,
+        .QueryMemoryStatistics = &__NkInt_AssetManager_QueryMemoryStatistics,
+        .QueryPackArchive      = &__NkInt_AssetManager_QueryPackArchive
     }
 };
 
@@ -420,6 +1994,55 @@ NK_INTERNAL NkIBase *NK_CALL __NkInt_AssetManager_QueryInstance(NkVoid) {
     return (NkIBase *)&gl_AssetManager;
 }
 
+/**
+ * \brief starts watching the asset directory so that changed assets are reloaded
+ * \param [in, out] actSelf asset manager instance
+ * \param [in, out] fileSysSrv filesystem service
+ * \note  Failing to start the watch is not an error; assets are just not reloaded.
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_StartHotReload(_Inout_ __NkInt_AssetManager *actSelf, _Inout_ NkIFilesystem *fileSysSrv) {
+    char const *rootPath = NkPathQueryGameDirectory(NkGameDir_AssetRoot)->mp_dataPtr;
+
+    NkErrorCode const errCode = fileSysSrv->VT->Watch(
+        fileSysSrv,
+        rootPath,
+        NK_TRUE,
+        &__NkInt_AssetManager_FileChangeFn,
+        (NkVoid *)actSelf,
+        &actSelf->mp_fileWatch
+    );
+    if (errCode != NkErr_Ok) {
+        NK_LOG_WARNING("Could not watch asset directory \"%s\"; assets are not reloaded. Reason: %s (%i)", rootPath, NkGetErrorCodeStr(errCode)->mp_dataPtr, (int)errCode);
+
+        return;
+    }
+    NK_LOG_INFO("Watching asset directory \"%s\"; changed assets are reloaded.", rootPath);
+}
+
+/**
+ * \brief stops watching the asset directory and cancels all reloads in progress
+ * \param [in, out] actSelf asset manager instance
+ */
+NK_INTERNAL NkVoid __NkInt_AssetManager_StopHotReload(_Inout_ __NkInt_AssetManager *actSelf) {
+    if (actSelf->mp_fileWatch == NULL)
+        return;
+
+    /* No changes are recorded anymore once the watch was stopped. */
+    NkIFilesystem *fileSysSrv = (NkIFilesystem *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIFilesystem));
+    fileSysSrv->VT->Unwatch(fileSysSrv, &actSelf->mp_fileWatch);
+    fileSysSrv->VT->Release(fileSysSrv);
+
+    while (actSelf->mp_relHead != NULL) {
+        NkAssetRequest *reqPtr = actSelf->mp_relHead;
+
+        actSelf->mp_relHead = reqPtr->mp_nextRel;
+        __NkInt_AssetManager_FreeRequest(actSelf, reqPtr);
+    }
+    NkGPFree(actSelf->mp_chgArr);
+    actSelf->mp_chgArr = NULL;
+    actSelf->m_nChanges = actSelf->m_chgCap = 0;
+}
+
 
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(AssetManager)(NkVoid) {
     NkIAssetManager *self = (NkIAssetManager *)__NkInt_AssetManager_QueryInstance();
@@ -429,6 +2052,19 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(AssetManager)
     if (errCode != NkErr_Ok)
         return errCode;
 
+    /* Override the memory budget if started with '--assetbudget=<MiB>'. */
+    NkVariant budgetVar;
+    if (NkEnvGetValue("assetbudget", &budgetVar) == NkErr_Ok) {
+        NkVariantType varTy;
+        NkDouble      nMiBytes;
+        NkVariantGet(&budgetVar, &varTy, &nMiBytes);
+
+        if (varTy == NkVarTy_Double && nMiBytes >= 1. && nMiBytes <= 1048576.)
+            self->VT->SetMemoryBudget(self, (NkSize)nMiBytes << 20);
+        else
+            NK_LOG_WARNING("Ignoring invalid asset memory budget; must be a number of MiB between 1 and 1048576.");
+    }
+
     /*
      * Try to locate the asset database, if it does not exist, create a new one. Then,
      * open the database. Only do this if we are running in standalone mode, that is,
@@ -447,10 +2083,36 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(AssetManager)
 
             NK_LOG_INFO("Successfully created asset database \"%s\".", "assets.db");
         }
-        fileSysSrv->VT->Release(fileSysSrv);
+
+        /*
+         * If the asset data was cooked into a pack archive, map it. Otherwise, assets are
+         * loaded from loose files.
+         */
+        __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)self;
+        if (fileSysSrv->VT->Exists(fileSysSrv, "assets.pak")) {
+            if ((errCode = NkPackArchiveOpen("assets.pak", &actSelf->mp_packArch)) != NkErr_Ok) {
+                fileSysSrv->VT->Release(fileSysSrv);
+
+                return errCode;
+            }
+        }
 
         /* Open the database. */
-        return self->VT->OpenDatabase(self, "assets.db");
+        if ((errCode = self->VT->OpenDatabase(self, "assets.db")) != NkErr_Ok) {
+            fileSysSrv->VT->Release(fileSysSrv);
+
+            return errCode;
+        }
+
+        /* Reload loose asset files when they change if started with '--hotreload'. */
+        if (NkEnvResolve("hotreload") != NULL) {
+            if (actSelf->mp_packArch == NULL)
+                __NkInt_AssetManager_StartHotReload(actSelf, fileSysSrv);
+            else
+                NK_LOG_WARNING("Ignoring '--hotreload'; assets are loaded from a pack archive.");
+        }
+        fileSysSrv->VT->Release(fileSysSrv);
+        return NkErr_Ok;
     }
 
     /* All good. */
@@ -460,6 +2122,19 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(AssetManager)
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(AssetManager)(NkVoid) {
     __NkInt_AssetManager *actSelf = (__NkInt_AssetManager *)__NkInt_AssetManager_QueryInstance();
 
+    /* All asynchronous queries should have been released by now. */
+    LONG const nRequests = InterlockedCompareExchange(&actSelf->m_nRequests, 0, 0);
+    if (nRequests > 0)
+        NK_LOG_CRITICAL("There are still %li asset requests that were not released.", nRequests);
+    /* Reloads hold references to the assets, so they are dropped before trimming. */
+    __NkInt_AssetManager_StopHotReload(actSelf);
+
+    /*
+     * Evict everything that is not referenced anymore. What remains after that is still
+     * held by someone else.
+     */
+    __NkInt_AssetManager_Trim(actSelf, NK_TRUE);
+
     /* Asset registry should be empty by now. If it isn't, then there is an issue. */
     NkUint32 htCount;
     if ((htCount = NkHashtableCount(actSelf->mp_assetCache)) > 0U) {
@@ -473,12 +2148,20 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(AssetManager
         NK_LOG_CRITICAL("The following asset handles are still pending:");
         NK_IGNORE_RETURN_VALUE(NkHashtableForEach(actSelf->mp_assetCache, &__NkInt_AssetManager_IterPendingFn));
     }
-    /* Destroy asset cache. */
+    /* Destroy asset cache, dropping the references the cache holds. */
+    while (actSelf->mp_lruHead != NULL) {
+        __NkInt_AssetManager_CacheEntry *entryPtr = actSelf->mp_lruHead;
+
+        __NkInt_AssetManager_UnlinkEntry(actSelf, entryPtr);
+        entryPtr->mp_assetRef->VT->Release(entryPtr->mp_assetRef);
+        NkGPFree(entryPtr);
+    }
     NkHashtableDestroy(&actSelf->mp_assetCache);
 
     /* Close the connection. */
     if (NkApplicationIsStandalone())
         actSelf->NkIAssetManager_Iface.VT->CloseDatabase((NkIAssetManager *)actSelf);
+    NkPackArchiveClose(&actSelf->mp_packArch);
     /* Destroy synchronization object. */
     NK_DESTROYLOCK(actSelf->m_mtxLock);
 
@@ -0,0 +1,547 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  asyncio.c
+ * \brief implements the platform-independent part of the asynchronous I/O service
+ *
+ * Requests are kept in one FIFO queue per priority. The I/O thread issues requests from
+ * the highest non-empty priority until \c __NkInt_AsyncIO_MaxInFlight reads are in
+ * flight, then waits for the platform to report a completion. Submitting threads wake
+ * the I/O thread through the platform's completion mechanism as well, so the thread
+ * only ever waits in one place.
+ */
+#define NK_NAMESPACE "nk::asyncio"
+
+
+/* stdlib includes */
+#include <stddef.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/asyncio.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/comp.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \brief maximum number of reads that are handed to the platform at the same time
+ *
+ * Keeping this limit low enough means that a high-priority request submitted while the
+ * device is busy only has to wait for the reads in flight, not for the entire queue.
+ */
+#define __NkInt_AsyncIO_MaxInFlight ((NkSize)(32))
+
+
+/**
+ * \struct NkAsyncFile
+ * \brief  internal definition of a file opened for asynchronous reads
+ */
+struct NkAsyncFile {
+    NkVoid   *mp_platHnd; /**< platform-dependent file handle */
+    NkUint64  m_fileSize; /**< size of the file when it was opened, in bytes */
+};
+
+/**
+ * \struct __NkInt_AsyncIORequest
+ * \brief  represents a submitted request
+ */
+NK_NATIVE typedef struct __NkInt_AsyncIORequest {
+    struct __NkInt_AsyncIORequest *mp_nextPtr;    /**< next request with the same priority */
+    NkAsyncReadRequest             m_reqDesc;     /**< copy of the request description */
+    NkJobCounter                  *mp_jobCounter; /**< (optional) counter to signal when done */
+    NkErrorCode                    m_errCode;     /**< result of the read */
+    NkSize                         m_nBytesRead;  /**< number of bytes read */
+    NkUint64                       m_platOp[];    /**< platform-dependent operation state */
+} __NkInt_AsyncIORequest;
+
+/**
+ * \struct __NkInt_AsyncIOContext
+ * \brief  represents the global state of the asynchronous I/O service
+ */
+NK_NATIVE typedef struct __NkInt_AsyncIOContext {
+    NkVoid          *mp_portHnd;  /**< platform-dependent completion port */
+    NkSize           m_opSize;    /**< size of the platform-dependent operation state */
+    NkSize           m_nQueued;   /**< number of requests that have not been issued yet */
+    NkSize           m_nInFlight; /**< number of issued requests; only used by the I/O thread */
+    NkInt64 volatile m_nPending;  /**< number of requests whose callback has not returned */
+    NkBoolean        m_isShutdown;/**< whether the I/O thread should exit */
+    NkJobCounter     m_complCtr;  /**< counts completion jobs that have not finished */
+
+    /**
+     * \struct __NkInt_AsyncIOQueue
+     * \brief  FIFO queue of the requests with the same priority
+     */
+    struct __NkInt_AsyncIOQueue {
+        __NkInt_AsyncIORequest *mp_headPtr; /**< oldest request */
+        __NkInt_AsyncIORequest *mp_tailPtr; /**< newest request */
+    } m_queueArr[__NkAioPrio_Count__];
+
+#if (defined NK_TARGET_MULTITHREADED)
+    thrd_t           m_ioThrd;    /**< I/O thread */
+#endif
+    NK_DECL_LOCK(m_mtxLock);      /**< guards the queues and the shutdown flag */
+} __NkInt_AsyncIOContext;
+/**
+ * \brief actual instance of the asynchronous I/O service context
+ */
+NK_INTERNAL __NkInt_AsyncIOContext gl_AsyncIOCxt;
+
+
+/**
+ * \ingroup VirtFn
+ * \brief   retrieves the size of the state the platform needs for every read
+ * \return  size in bytes
+ */
+NK_EXTERN NK_VIRTUAL NkSize NK_CALL __NkVirt_AsyncIO_QueryOperationSize(NkVoid);
+/**
+ * \ingroup VirtFn
+ * \brief   creates the completion port all reads are reported to
+ * \param   [out] portHnd pointer to a variable that receives the port handle
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ */
+NK_EXTERN NK_VIRTUAL _Return_ok_ NkErrorCode NK_CALL __NkVirt_AsyncIO_CreatePort(_Outptr_ NkVoid **portHnd);
+/**
+ * \ingroup VirtFn
+ * \brief   destroys the completion port
+ * \param   [in, out] portHnd port handle
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkVirt_AsyncIO_DestroyPort(_Inout_ NkVoid *portHnd);
+/**
+ * \ingroup VirtFn
+ * \brief   opens a file for asynchronous reads and associates it with the port
+ * \param   [in, out] portHnd port handle
+ * \param   [in] pathStr path of the file
+ * \param   [out] fileHnd pointer to a variable that receives the file handle
+ * \param   [out] sizePtr pointer to a variable that receives the file size, in bytes
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ */
+NK_EXTERN NK_VIRTUAL _Return_ok_ NkErrorCode NK_CALL __NkVirt_AsyncIO_OpenFile(
+    _Inout_       NkVoid *portHnd,
+    _In_z_ _Utf8_ char const *pathStr,
+    _Outptr_      NkVoid **fileHnd,
+    _Out_         NkUint64 *sizePtr
+);
+/**
+ * \ingroup VirtFn
+ * \brief   closes a file opened by <tt>__NkVirt_AsyncIO_OpenFile()</tt>
+ * \param   [in, out] fileHnd file handle
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkVirt_AsyncIO_CloseFile(_Inout_ NkVoid *fileHnd);
+/**
+ * \ingroup VirtFn
+ * \brief   starts a read
+ * \param   [in, out] fileHnd file handle
+ * \param   [in] fileOff offset of the first byte to read
+ * \param   [in] s number of bytes to read
+ * \param   [out] bufPtr destination buffer
+ * \param   [in, out] opPtr operation state of the read
+ * \return  \c NkErr_Ok if the read was started, non-zero if it failed right away; in
+ *          that case, no completion is reported
+ */
+NK_EXTERN NK_VIRTUAL _Return_ok_ NkErrorCode NK_CALL __NkVirt_AsyncIO_IssueRead(
+    _Inout_      NkVoid *fileHnd,
+    _In_         NkUint64 fileOff,
+    _In_         NkUint32 s,
+    _O_bytes_(s) NkVoid *bufPtr,
+    _Inout_      NkVoid *opPtr
+);
+/**
+ * \ingroup VirtFn
+ * \brief   waits until a read completed or the port was woken up
+ * \param   [in, out] portHnd port handle
+ * \param   [out] opPtr pointer to a variable that receives the operation state of the
+ *                completed read, or \c NULL if the port was woken up
+ * \param   [out] nBytes pointer to a variable that receives the number of bytes read
+ * \return  result of the read
+ */
+NK_EXTERN NK_VIRTUAL NkErrorCode NK_CALL __NkVirt_AsyncIO_WaitCompletion(
+    _Inout_  NkVoid *portHnd,
+    _Outptr_ NkVoid **opPtr,
+    _Out_    NkSize *nBytes
+);
+/**
+ * \ingroup VirtFn
+ * \brief   wakes up a thread waiting in <tt>__NkVirt_AsyncIO_WaitCompletion()</tt>
+ * \param   [in, out] portHnd port handle
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkVirt_AsyncIO_Wake(_Inout_ NkVoid *portHnd);
+
+
+/**
+ * \brief runs the completion callback of a request and frees it
+ * \param [in, out] extraCxt pointer to the request
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_AsyncIO_CompletionJob(_Inout_opt_ NkVoid *extraCxt) {
+    __NkInt_AsyncIORequest *reqPtr = (__NkInt_AsyncIORequest *)extraCxt;
+
+    if (reqPtr->m_reqDesc.mp_complFn != NULL)
+        (*reqPtr->m_reqDesc.mp_complFn)(
+            reqPtr->m_errCode,
+            (NkBufferView){ reqPtr->m_reqDesc.m_destBuf.mp_dataPtr, reqPtr->m_nBytesRead },
+            reqPtr->m_reqDesc.mp_extraCxt
+        );
+
+    /* The counter may be destroyed by waiters as soon as it is signaled. */
+    NkJobCounter *jobCounter = reqPtr->mp_jobCounter;
+    NkGPFree(reqPtr);
+    InterlockedDecrement64(&gl_AsyncIOCxt.m_nPending);
+
+    if (jobCounter != NULL)
+        NkJobCounterSignal(jobCounter);
+}
+
+/**
+ * \brief hands a finished request over to the job system
+ * \param [in, out] reqPtr request that finished
+ */
+NK_INTERNAL NkVoid __NkInt_AsyncIO_Deliver(_Inout_ __NkInt_AsyncIORequest *reqPtr) {
+    NkJobDescription const jobDesc = { &__NkInt_AsyncIO_CompletionJob, (NkVoid *)reqPtr };
+
+    if (NkJobSubmit(&jobDesc, 1, NULL, &gl_AsyncIOCxt.m_complCtr) != NkErr_Ok) {
+        /* Could not queue the job; run the callback on the I/O thread instead. */
+        __NkInt_AsyncIO_CompletionJob((NkVoid *)reqPtr);
+    }
+}
+
+/**
+ * \brief  removes the oldest request with the highest priority from the queues
+ * \return pointer to the request, or \c NULL if all queues are empty
+ * \note   The caller must hold the lock.
+ */
+NK_INTERNAL __NkInt_AsyncIORequest *__NkInt_AsyncIO_PopRequest(NkVoid) {
+    for (NkInt32 i = 0; i < __NkAioPrio_Count__; i++) {
+        struct __NkInt_AsyncIOQueue *queuePtr = &gl_AsyncIOCxt.m_queueArr[i];
+        __NkInt_AsyncIORequest *reqPtr = queuePtr->mp_headPtr;
+        if (reqPtr == NULL)
+            continue;
+
+        queuePtr->mp_headPtr = reqPtr->mp_nextPtr;
+        if (queuePtr->mp_headPtr == NULL)
+            queuePtr->mp_tailPtr = NULL;
+        --gl_AsyncIOCxt.m_nQueued;
+
+        reqPtr->mp_nextPtr = NULL;
+        return reqPtr;
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief issues queued requests until the in-flight limit is reached
+ * \note  On shutdown, queued requests are not issued but completed with
+ *        \c NkErr_ManuallyAborted.
+ */
+NK_INTERNAL NkVoid __NkInt_AsyncIO_IssuePending(NkVoid) {
+    while (gl_AsyncIOCxt.m_nInFlight < __NkInt_AsyncIO_MaxInFlight) {
+        NK_LOCK(gl_AsyncIOCxt.m_mtxLock);
+        __NkInt_AsyncIORequest *reqPtr = __NkInt_AsyncIO_PopRequest();
+        NkBoolean const isShutdown = gl_AsyncIOCxt.m_isShutdown;
+        NK_UNLOCK(gl_AsyncIOCxt.m_mtxLock);
+        if (reqPtr == NULL)
+            return;
+
+        if (isShutdown) {
+            reqPtr->m_errCode = NkErr_ManuallyAborted;
+
+            __NkInt_AsyncIO_Deliver(reqPtr);
+            continue;
+        }
+
+        /* Start the read. If it fails right away, report the error immediately. */
+        NkAsyncReadRequest const *descPtr = &reqPtr->m_reqDesc;
+        reqPtr->m_errCode = __NkVirt_AsyncIO_IssueRead(
+            descPtr->mp_fileHnd->mp_platHnd,
+            descPtr->m_fileOffset,
+            (NkUint32)descPtr->m_destBuf.m_sizeInBytes,
+            descPtr->m_destBuf.mp_dataPtr,
+            (NkVoid *)reqPtr->m_platOp
+        );
+        if (reqPtr->m_errCode != NkErr_Ok) {
+            __NkInt_AsyncIO_Deliver(reqPtr);
+
+            continue;
+        }
+        ++gl_AsyncIOCxt.m_nInFlight;
+    }
+}
+
+/**
+ * \brief waits for a single completion and delivers it
+ */
+NK_INTERNAL NkVoid __NkInt_AsyncIO_ProcessCompletion(NkVoid) {
+    NkVoid *opPtr;
+    NkSize  nBytes;
+
+    NkErrorCode const errCode = __NkVirt_AsyncIO_WaitCompletion(gl_AsyncIOCxt.mp_portHnd, &opPtr, &nBytes);
+    if (opPtr == NULL) {
+        /* Woken up; new requests were queued or the service is shutting down. */
+        return;
+    }
+
+    __NkInt_AsyncIORequest *reqPtr = (__NkInt_AsyncIORequest *)((NkByte *)opPtr - offsetof(__NkInt_AsyncIORequest, m_platOp));
+    --gl_AsyncIOCxt.m_nInFlight;
+
+    /* Like with disk files, reading fewer bytes than requested is an error. */
+    reqPtr->m_nBytesRead = nBytes;
+    reqPtr->m_errCode    = errCode == NkErr_Ok && nBytes != reqPtr->m_reqDesc.m_destBuf.m_sizeInBytes
+        ? NkErr_ErrorDuringDiskIO
+        : errCode
+    ;
+    __NkInt_AsyncIO_Deliver(reqPtr);
+}
+
+/**
+ * \brief  checks whether all requests have been issued and completed after shutdown was
+ *         requested
+ * \return \c NK_TRUE if the I/O thread may exit, \c NK_FALSE otherwise
+ */
+NK_INTERNAL NkBoolean __NkInt_AsyncIO_IsDrained(NkVoid) {
+    NK_LOCK(gl_AsyncIOCxt.m_mtxLock);
+    NkBoolean const isDrained = gl_AsyncIOCxt.m_isShutdown && gl_AsyncIOCxt.m_nQueued == 0;
+    NK_UNLOCK(gl_AsyncIOCxt.m_mtxLock);
+
+    return isDrained && gl_AsyncIOCxt.m_nInFlight == 0;
+}
+
+#if (defined NK_TARGET_MULTITHREADED)
+/**
+ * \brief  entry point of the I/O thread
+ * \param  [in] extraCxt unused
+ * \return always \c 0
+ */
+NK_INTERNAL int __NkInt_AsyncIO_ThreadProc(_In_ NkVoid *extraCxt) {
+    NK_UNREFERENCED_PARAMETER(extraCxt);
+
+    for (;;) {
+        __NkInt_AsyncIO_IssuePending();
+        if (__NkInt_AsyncIO_IsDrained())
+            break;
+
+        __NkInt_AsyncIO_ProcessCompletion();
+    }
+
+    NkAllocReleaseThreadCache();
+    return 0;
+}
+#endif
+
+
+/**
+ * \brief  initializes the asynchronous I/O service and starts the I/O thread
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(AsyncIO)(NkVoid) {
+    NkErrorCode errCode = __NkVirt_AsyncIO_CreatePort(&gl_AsyncIOCxt.mp_portHnd);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    gl_AsyncIOCxt.m_opSize = __NkVirt_AsyncIO_QueryOperationSize();
+    NK_INITLOCK(gl_AsyncIOCxt.m_mtxLock);
+
+#if (defined NK_TARGET_MULTITHREADED)
+    if (thrd_create(&gl_AsyncIOCxt.m_ioThrd, &__NkInt_AsyncIO_ThreadProc, NULL) != thrd_success) {
+        NK_DESTROYLOCK(gl_AsyncIOCxt.m_mtxLock);
+        __NkVirt_AsyncIO_DestroyPort(gl_AsyncIOCxt.mp_portHnd);
+
+        memset(&gl_AsyncIOCxt, 0, sizeof gl_AsyncIOCxt);
+        return NkErr_CreateThread;
+    }
+#endif
+
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  stops the I/O thread and uninitializes the asynchronous I/O service
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   Reads in flight are waited for; queued requests are completed with
+ *         \c NkErr_ManuallyAborted. All completion callbacks are run before this function
+ *         returns.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(AsyncIO)(NkVoid) {
+    NK_LOCK(gl_AsyncIOCxt.m_mtxLock);
+    gl_AsyncIOCxt.m_isShutdown = NK_TRUE;
+    NK_UNLOCK(gl_AsyncIOCxt.m_mtxLock);
+
+#if (defined NK_TARGET_MULTITHREADED)
+    __NkVirt_AsyncIO_Wake(gl_AsyncIOCxt.mp_portHnd);
+    thrd_join(gl_AsyncIOCxt.m_ioThrd, NULL);
+#endif
+    /* The job system is still running, so the completion jobs can be waited for. */
+    NkJobWait(&gl_AsyncIOCxt.m_complCtr);
+
+    NK_DESTROYLOCK(gl_AsyncIOCxt.m_mtxLock);
+    __NkVirt_AsyncIO_DestroyPort(gl_AsyncIOCxt.mp_portHnd);
+
+    memset(&gl_AsyncIOCxt, 0, sizeof gl_AsyncIOCxt);
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkAsyncIOOpenFile(
+    _In_z_ _Utf8_ char const *pathStr,
+    _Init_ptr_    NkAsyncFile **filePtr,
+    _Out_opt_     NkUint64 *sizePtr
+) {
+    NK_ASSERT(pathStr != NULL && *pathStr ^ '\0', NkErr_InParameter);
+    NK_ASSERT(filePtr != NULL, NkErr_OutptrParameter);
+
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **filePtr, 0, NK_FALSE, (NkVoid **)filePtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    errCode = __NkVirt_AsyncIO_OpenFile(gl_AsyncIOCxt.mp_portHnd, pathStr, &(*filePtr)->mp_platHnd, &(*filePtr)->m_fileSize);
+    if (errCode != NkErr_Ok) {
+        NkGPFree(*filePtr);
+
+        *filePtr = NULL;
+        return errCode;
+    }
+
+    if (sizePtr != NULL)
+        *sizePtr = (*filePtr)->m_fileSize;
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkAsyncIOCloseFile(_Uninit_ptr_ NkAsyncFile **filePtr) {
+    NK_ASSERT(filePtr != NULL, NkErr_InOutParameter);
+
+    if (*filePtr == NULL)
+        return;
+
+    __NkVirt_AsyncIO_CloseFile((*filePtr)->mp_platHnd);
+    NkGPFree(*filePtr);
+    *filePtr = NULL;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkAsyncIOSubmitReads(
+    _I_array_(nReqs) NkAsyncReadRequest const *reqArr,
+    _In_             NkSize nReqs,
+    _Inout_opt_      NkJobCounter *jobCounter
+) {
+    NK_ASSERT(reqArr != NULL, NkErr_InParameter);
+
+    if (nReqs == 0)
+        return NkErr_Ok;
+
+    /* The platform reads at most 4 GiB at once. */
+    for (NkSize i = 0; i < nReqs; i++) {
+        NK_ASSERT(reqArr[i].mp_fileHnd != NULL, NkErr_InParameter);
+        NK_ASSERT(reqArr[i].m_destBuf.mp_dataPtr != NULL && reqArr[i].m_destBuf.m_sizeInBytes > 0, NkErr_InParameter);
+        NK_ASSERT(reqArr[i].m_prioVal >= NkAioPrio_Critical && reqArr[i].m_prioVal < __NkAioPrio_Count__, NkErr_InParameter);
+
+        if ((NkUint64)reqArr[i].m_destBuf.m_sizeInBytes > UINT32_MAX)
+            return NkErr_InvalidRange;
+    }
+
+    /*
+     * Allocate all requests up-front so that the batch is either queued as a whole or not
+     * at all.
+     */
+    __NkInt_AsyncIORequest *listHead = NULL;
+    for (NkSize i = 0; i < nReqs; i++) {
+        __NkInt_AsyncIORequest *reqPtr;
+
+        NkErrorCode const errCode = NkGPAlloc(
+            NK_MAKE_ALLOCATION_CONTEXT(),
+            sizeof *reqPtr + gl_AsyncIOCxt.m_opSize,
+            0,
+            NK_FALSE,
+            (NkVoid **)&reqPtr
+        );
+        if (errCode != NkErr_Ok) {
+            while (listHead != NULL) {
+                __NkInt_AsyncIORequest *nextPtr = listHead->mp_nextPtr;
+
+                NkGPFree(listHead);
+                listHead = nextPtr;
+            }
+
+            return errCode;
+        }
+
+        reqPtr->mp_nextPtr    = listHead;
+        reqPtr->m_reqDesc     = reqArr[nReqs - 1 - i];
+        reqPtr->mp_jobCounter = jobCounter;
+        reqPtr->m_errCode     = NkErr_Ok;
+        reqPtr->m_nBytesRead  = 0;
+        listHead = reqPtr;
+    }
+
+    /* Account for the requests before any of them can complete. */
+    if (jobCounter != NULL)
+        NkJobCounterAddPending(jobCounter, nReqs);
+    InterlockedAdd64(&gl_AsyncIOCxt.m_nPending, (NkInt64)nReqs);
+
+    /* Append the requests to the queues; the list is in submission order. */
+    NK_LOCK(gl_AsyncIOCxt.m_mtxLock);
+    while (listHead != NULL) {
+        __NkInt_AsyncIORequest *reqPtr = listHead;
+        listHead = reqPtr->mp_nextPtr;
+
+        struct __NkInt_AsyncIOQueue *queuePtr = &gl_AsyncIOCxt.m_queueArr[reqPtr->m_reqDesc.m_prioVal];
+        reqPtr->mp_nextPtr = NULL;
+        if (queuePtr->mp_tailPtr != NULL)
+            queuePtr->mp_tailPtr->mp_nextPtr = reqPtr;
+        else
+            queuePtr->mp_headPtr = reqPtr;
+        queuePtr->mp_tailPtr = reqPtr;
+    }
+    gl_AsyncIOCxt.m_nQueued += nReqs;
+    NK_UNLOCK(gl_AsyncIOCxt.m_mtxLock);
+
+#if (defined NK_TARGET_MULTITHREADED)
+    __NkVirt_AsyncIO_Wake(gl_AsyncIOCxt.mp_portHnd);
+#else
+    /* Without an I/O thread, drive the requests on the calling thread. */
+    for (;;) {
+        __NkInt_AsyncIO_IssuePending();
+        if (gl_AsyncIOCxt.m_nInFlight == 0)
+            break;
+
+        __NkInt_AsyncIO_ProcessCompletion();
+    }
+#endif
+    return NkErr_Ok;
+}
+
+NkSize NK_CALL NkAsyncIOQueryPendingCount(NkVoid) {
+    return (NkSize)InterlockedCompareExchange64(&gl_AsyncIOCxt.m_nPending, 0, 0);
+}
+
+
+/** \cond INTERNAL */
+/**
+ * \brief info for the <em>asynchronous I/O</em> component
+ */
+NK_COMPONENT_DEFINE(AsyncIO) {
+    .m_compUuid     = { 0x9a5e13c7, 0x2f64, 0x4b18, 0x8d07e3b16f2ac945 },
+    .mp_clsId       = NULL,
+    .m_compIdent    = NK_MAKE_STRING_VIEW("asynchronous I/O"),
+    .m_compFlags    = 0,
+    .m_isNkOM       = NK_FALSE,
+
+    .mp_fnQueryInst = NULL,
+    .mp_fnStartup   = &NK_COMPONENT_STARTUPFN(AsyncIO),
+    .mp_fnShutdown  = &NK_COMPONENT_SHUTDOWNFN(AsyncIO)
+};
+/** \endcond */
+
+
+#undef NK_NAMESPACE
+
+
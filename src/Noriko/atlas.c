@@ -0,0 +1,586 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  atlas.c
+ * \brief implements the texture atlas builder, that is, a skyline packer that combines
+ *        many bitmaps into a few large textures
+ */
+#define NK_NAMESPACE "nk::atlas"
+
+
+/* stdlib includes */
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/atlas.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/sort.h>
+#include <include/Noriko/log.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \struct __NkInt_AtlasEntry
+ * \brief  represents a bitmap that was registered with the atlas
+ */
+NK_NATIVE typedef struct __NkInt_AtlasEntry {
+    NkDIBitmap const *mp_bmpRef;  /**< bitmap the entry's pixels are taken from */
+    NkSize2D          m_bmpDim;   /**< extents of the bitmap, in pixels */
+    NkSize2D          m_cellDim;  /**< extents of a single cell, in pixels */
+    NkRgbaColor       m_keyCol;   /**< transparent color of the bitmap */
+    NkBoolean         m_isKeyed;  /**< whether <tt>m_keyCol</tt> is valid */
+    NkSubTextureId    m_firstId;  /**< identifier of the first cell */
+    NkUint32          m_nCells;   /**< number of cells */
+    NkUint32          m_pageInd;  /**< page the bitmap was packed into */
+    NkPoint2D         m_pagePos;  /**< top-left corner of the bitmap inside the page */
+} __NkInt_AtlasEntry;
+
+/**
+ * \struct __NkInt_AtlasSkylineNode
+ * \brief  represents a horizontal segment of the skyline of a page
+ */
+NK_NATIVE typedef struct __NkInt_AtlasSkylineNode {
+    NkInt64 m_xCoord; /**< x-coordinate of the left end of the segment */
+    NkInt64 m_yCoord; /**< height of the skyline along the segment */
+    NkInt64 m_width;  /**< width of the segment */
+} __NkInt_AtlasSkylineNode;
+
+/**
+ * \struct __NkInt_AtlasPage
+ * \brief  represents a page of the atlas
+ */
+NK_NATIVE typedef struct __NkInt_AtlasPage {
+    __NkInt_AtlasSkylineNode *mp_nodeArr; /**< skyline, sorted by x-coordinate */
+    NkSize                    m_nNodes;   /**< number of nodes in <tt>mp_nodeArr</tt> */
+    NkSize2D                  m_usedDim;  /**< extents of the area that is actually used */
+    NkBoolean                 m_isKeyed;  /**< whether any bitmap on the page is keyed */
+    NkRendererResource       *mp_texRes;   /**< page texture */
+    NkRendererResource       *mp_alphaRes; /**< premultiplied-alpha page texture, or \c NULL */
+} __NkInt_AtlasPage;
+/** \endcond */
+
+
+/**
+ * \struct NkTextureAtlas
+ * \brief  internal definition of the texture atlas
+ */
+struct NkTextureAtlas {
+    NkTextureAtlasSpecification  m_atlasSpec; /**< copy of the atlas specification */
+    NkBoolean                    m_isBuilt;   /**< whether the pages have been created */
+    __NkInt_AtlasEntry          *mp_entryArr; /**< registered bitmaps */
+    NkSize                       m_nEntries;  /**< number of registered bitmaps */
+    NkSubTexture                *mp_subArr;   /**< all sub-textures, indexed by ID */
+    NkSize                       m_nSubTex;   /**< number of sub-textures */
+    __NkInt_AtlasPage           *mp_pageArr;  /**< pages */
+    NkSize                       m_nPages;    /**< number of pages */
+};
+
+
+/** \cond INTERNAL */
+/**
+ * \brief  grows a dynamically-allocated array
+ * \param  [in] newSize new size of the array, in bytes
+ * \param  [in, out] memPtr pointer to the array; may point to \c NULL if the array has
+ *                   not been allocated yet
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_TextureAtlas_Grow(_In_ NkSize newSize, _Reinit_ptr_ NkVoid **memPtr) {
+    if (*memPtr == NULL)
+        return NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newSize, 0, NK_FALSE, memPtr);
+
+    return NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newSize, memPtr);
+}
+
+/**
+ * \brief  orders two atlas entries by decreasing height, then by decreasing width
+ * \param  [in] e1Ptr pointer to the first entry
+ * \param  [in] e2Ptr pointer to the second entry
+ * \return negative if the first entry is to be packed first, positive if the second
+ *         one is, or 0 if they are interchangeable
+ */
+NK_INTERNAL NkInt32 NK_CALL __NkInt_TextureAtlas_CompareEntries(_In_ NkVoid const *e1Ptr, _In_ NkVoid const *e2Ptr) {
+    __NkInt_AtlasEntry const *e1 = (__NkInt_AtlasEntry const *)e1Ptr;
+    __NkInt_AtlasEntry const *e2 = (__NkInt_AtlasEntry const *)e2Ptr;
+
+    if (e1->m_bmpDim.m_height != e2->m_bmpDim.m_height)
+        return e1->m_bmpDim.m_height > e2->m_bmpDim.m_height ? -1 : 1;
+    if (e1->m_bmpDim.m_width != e2->m_bmpDim.m_width)
+        return e1->m_bmpDim.m_width > e2->m_bmpDim.m_width ? -1 : 1;
+    return 0;
+}
+
+/**
+ * \brief  calculates the height at which a rectangle can be placed on the skyline if its
+ *         left edge is aligned with the given node
+ * \param  [in] pagePtr page of which the skyline is searched
+ * \param  [in] pageDim maximum extents of the page
+ * \param  [in] nodeInd index of the node the rectangle is aligned with
+ * \param  [in] rectDim extents of the rectangle, including padding
+ * \return y-coordinate of the top edge of the rectangle, or \c -1 if the rectangle does
+ *         not fit at that position
+ */
+NK_INTERNAL NkInt64 __NkInt_TextureAtlas_FitSkyline(
+    _In_ __NkInt_AtlasPage const *pagePtr,
+    _In_ NkSize2D pageDim,
+    _In_ NkSize nodeInd,
+    _In_ NkSize2D rectDim
+) {
+    __NkInt_AtlasSkylineNode const *nodeArr = pagePtr->mp_nodeArr;
+    if (nodeArr[nodeInd].m_xCoord + (NkInt64)rectDim.m_width > (NkInt64)pageDim.m_width)
+        return -1;
+
+    /* The rectangle rests on the highest segment it spans. */
+    NkInt64 yCoord = 0;
+    NkInt64 remW   = (NkInt64)rectDim.m_width;
+    for (NkSize i = nodeInd; remW > 0 && i < pagePtr->m_nNodes; i++) {
+        yCoord = NK_MAX(yCoord, nodeArr[i].m_yCoord);
+        remW  -= nodeArr[i].m_width;
+    }
+    return yCoord + (NkInt64)rectDim.m_height > (NkInt64)pageDim.m_height ? -1 : yCoord;
+}
+
+/**
+ * \brief  tries to place a rectangle on the given page
+ * \param  [in, out] pagePtr page the rectangle is placed on
+ * \param  [in] pageDim maximum extents of the page
+ * \param  [in] rectDim extents of the rectangle, including padding
+ * \param  [out] posPtr pointer to a variable that receives the top-left corner of the
+ *               rectangle
+ * \return \c NK_TRUE if the rectangle was placed, \c NK_FALSE if it does not fit
+ *
+ * \par Remarks
+ *   Of all candidate positions, the one that keeps the bottom edge of the rectangle
+ *   closest to the top of the page is chosen (bottom-left heuristic, with y growing
+ *   downwards), ties being broken by the narrower segment so that wider gaps remain
+ *   free for wider bitmaps.
+ *   Afterwards, the segments covered by the rectangle are replaced by a single segment
+ *   at the height of the rectangle's bottom edge.
+ */
+NK_INTERNAL NkBoolean __NkInt_TextureAtlas_PlaceRect(
+    _Inout_ __NkInt_AtlasPage *pagePtr,
+    _In_    NkSize2D pageDim,
+    _In_    NkSize2D rectDim,
+    _Out_   NkPoint2D *posPtr
+) {
+    __NkInt_AtlasSkylineNode *nodeArr = pagePtr->mp_nodeArr;
+
+    /* Find the best position. */
+    NkSize  bestInd = SIZE_MAX;
+    NkInt64 bestBot = INT64_MAX, bestW = INT64_MAX;
+    for (NkSize i = 0; i < pagePtr->m_nNodes; i++) {
+        NkInt64 const yCoord = __NkInt_TextureAtlas_FitSkyline(pagePtr, pageDim, i, rectDim);
+        if (yCoord < 0)
+            continue;
+
+        NkInt64 const botY = yCoord + (NkInt64)rectDim.m_height;
+        if (botY < bestBot || botY == bestBot && nodeArr[i].m_width < bestW) {
+            bestInd = i;
+            bestBot = botY;
+            bestW   = nodeArr[i].m_width;
+        }
+    }
+    if (bestInd == SIZE_MAX)
+        return NK_FALSE;
+    *posPtr = (NkPoint2D){ nodeArr[bestInd].m_xCoord, bestBot - (NkInt64)rectDim.m_height };
+
+    /* Insert the new segment. */
+    memmove(&nodeArr[bestInd + 1], &nodeArr[bestInd], (pagePtr->m_nNodes - bestInd) * sizeof *nodeArr);
+    nodeArr[bestInd] = (__NkInt_AtlasSkylineNode){ posPtr->m_xCoord, bestBot, (NkInt64)rectDim.m_width };
+    ++pagePtr->m_nNodes;
+
+    /* Shrink or remove the segments that are now covered by the new one. */
+    NkInt64 const rightX = posPtr->m_xCoord + (NkInt64)rectDim.m_width;
+    for (NkSize i = bestInd + 1; i < pagePtr->m_nNodes; ) {
+        if (nodeArr[i].m_xCoord >= rightX)
+            break;
+
+        NkInt64 const shrinkBy = rightX - nodeArr[i].m_xCoord;
+        if (shrinkBy < nodeArr[i].m_width) {
+            nodeArr[i].m_xCoord += shrinkBy;
+            nodeArr[i].m_width  -= shrinkBy;
+
+            break;
+        }
+
+        memmove(&nodeArr[i], &nodeArr[i + 1], (pagePtr->m_nNodes - i - 1) * sizeof *nodeArr);
+        --pagePtr->m_nNodes;
+    }
+
+    /* Merge neighboring segments of the same height. */
+    for (NkSize i = 0; i + 1 < pagePtr->m_nNodes; ) {
+        if (nodeArr[i].m_yCoord != nodeArr[i + 1].m_yCoord) {
+            ++i;
+
+            continue;
+        }
+
+        nodeArr[i].m_width += nodeArr[i + 1].m_width;
+        memmove(&nodeArr[i + 1], &nodeArr[i + 2], (pagePtr->m_nNodes - i - 2) * sizeof *nodeArr);
+        --pagePtr->m_nNodes;
+    }
+    return NK_TRUE;
+}
+
+/**
+ * \brief  opens a new, empty page
+ * \param  [in, out] atlasPtr pointer to the texture atlas
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   A page can never hold more segments than there are entries plus one, so the
+ *         skyline is allocated with that capacity up-front.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_TextureAtlas_AddPage(_Inout_ NkTextureAtlas *atlasPtr) {
+    NkErrorCode errCode = __NkInt_TextureAtlas_Grow(
+        (atlasPtr->m_nPages + 1) * sizeof *atlasPtr->mp_pageArr,
+        (NkVoid **)&atlasPtr->mp_pageArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    __NkInt_AtlasPage *pagePtr = &atlasPtr->mp_pageArr[atlasPtr->m_nPages];
+    *pagePtr = (__NkInt_AtlasPage){ .m_nNodes = 1 };
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        (atlasPtr->m_nEntries + 1) * sizeof *pagePtr->mp_nodeArr,
+        0,
+        NK_FALSE,
+        (NkVoid **)&pagePtr->mp_nodeArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+    pagePtr->mp_nodeArr[0] = (__NkInt_AtlasSkylineNode){ 0, 0, (NkInt64)atlasPtr->m_atlasSpec.m_pageDim.m_width };
+
+    ++atlasPtr->m_nPages;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief copies the pixels of an entry into the pixel array of its page
+ * \param [in] atlasPtr pointer to the texture atlas
+ * \param [in] entryPtr entry that is to be copied
+ * \param [in] pageSpec specification of the page bitmap
+ * \param [out] pxArray pixel array of the page bitmap
+ * \note  The page is a bottom-up 24-bit BGR bitmap, just like the bitmaps created by
+ *        <tt>NkDIBitmapCreate()</tt>.
+ */
+NK_INTERNAL NkVoid __NkInt_TextureAtlas_CopyEntry(
+    _In_  NkTextureAtlas const *atlasPtr,
+    _In_  __NkInt_AtlasEntry const *entryPtr,
+    _In_  NkBitmapSpecification const *pageSpec,
+    _Out_ NkByte *pxArray
+) {
+    NkBitmapSpecification const *srcSpec = NkDIBitmapGetSpecification(entryPtr->mp_bmpRef);
+    NkByte const                *srcPx   = NkDIBitmapGetPixels(entryPtr->mp_bmpRef, NULL);
+    NkUint32 const               srcBpp  = (NkUint32)srcSpec->m_bitsPerPx >> 3;
+    NkRgbaColor const            keyCol  = entryPtr->m_keyCol;
+    NkRgbaColor const            pageKey = atlasPtr->m_atlasSpec.m_keyCol;
+
+    for (NkInt64 y = 0; y < (NkInt64)entryPtr->m_bmpDim.m_height; y++) {
+        /* Bitmaps with a positive height are stored bottom-up. */
+        NkInt64 const srcRow = srcSpec->m_bmpHeight > 0 ? (NkInt64)entryPtr->m_bmpDim.m_height - 1 - y : y;
+        NkInt64 const dstRow = (NkInt64)pageSpec->m_bmpHeight - 1 - (entryPtr->m_pagePos.m_yCoord + y);
+
+        NkByte const *srcPtr = srcPx + srcRow * (NkInt64)srcSpec->m_bmpStride;
+        NkByte       *dstPtr = pxArray + dstRow * (NkInt64)pageSpec->m_bmpStride + entryPtr->m_pagePos.m_xCoord * 3;
+        if (srcBpp == 3 && !entryPtr->m_isKeyed) {
+            memcpy(dstPtr, srcPtr, (NkSize)entryPtr->m_bmpDim.m_width * 3);
+
+            continue;
+        }
+
+        for (NkUint64 x = 0; x < entryPtr->m_bmpDim.m_width; x++, srcPtr += srcBpp, dstPtr += 3) {
+            if (entryPtr->m_isKeyed && srcPtr[0] == keyCol.m_bVal && srcPtr[1] == keyCol.m_gVal && srcPtr[2] == keyCol.m_rVal) {
+                dstPtr[0] = pageKey.m_bVal;
+                dstPtr[1] = pageKey.m_gVal;
+                dstPtr[2] = pageKey.m_rVal;
+
+                continue;
+            }
+
+            dstPtr[0] = srcPtr[0];
+            dstPtr[1] = srcPtr[1];
+            dstPtr[2] = srcPtr[2];
+        }
+    }
+}
+
+/**
+ * \brief  creates the texture and, if needed, the alpha texture of a page
+ * \param  [in, out] atlasPtr pointer to the texture atlas
+ * \param  [in] pageInd index of the page
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_TextureAtlas_CreatePage(_Inout_ NkTextureAtlas *atlasPtr, _In_ NkSize pageInd) {
+    __NkInt_AtlasPage *pagePtr = &atlasPtr->mp_pageArr[pageInd];
+    NkIRenderer       *rdRef   = atlasPtr->m_atlasSpec.mp_rdRef;
+
+    /* The page only needs to be as large as the area that is actually used. */
+    NkDIBitmap  pageBmp;
+    NkRgbaColor keyCol  = atlasPtr->m_atlasSpec.m_keyCol;
+    NkErrorCode errCode = NkDIBitmapCreate(&(NkBitmapSpecification){
+        .m_structSize = sizeof(NkBitmapSpecification),
+        .m_bmpWidth   = (NkInt32)pagePtr->m_usedDim.m_width,
+        .m_bmpHeight  = (NkInt32)pagePtr->m_usedDim.m_height,
+        .m_bitsPerPx  = 24,
+        .m_bmpFlags   = NkBmpFlag_None
+    }, &keyCol, &pageBmp);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkBitmapSpecification const *pageSpec = NkDIBitmapGetSpecification(&pageBmp);
+    NkByte                      *pxArray  = NkDIBitmapGetPixels(&pageBmp, NULL);
+
+    for (NkSize i = 0; i < atlasPtr->m_nEntries; i++)
+        if (atlasPtr->mp_entryArr[i].m_pageInd == (NkUint32)pageInd)
+            __NkInt_TextureAtlas_CopyEntry(atlasPtr, &atlasPtr->mp_entryArr[i], pageSpec, pxArray);
+
+    /*
+     * Upload the page. Keyed pages additionally get an alpha texture with the key color
+     * baked in so that their sprites can be drawn in a single blend instead of a masked
+     * blit.
+     */
+    errCode = rdRef->VT->CreateTexture(rdRef, &pageBmp, &pagePtr->mp_texRes);
+    if (errCode == NkErr_Ok && pagePtr->m_isKeyed)
+        errCode = rdRef->VT->CreateAlphaTexture(rdRef, &pageBmp, &keyCol, &pagePtr->mp_alphaRes);
+
+    NkDIBitmapDestroy(&pageBmp);
+    return errCode;
+}
+
+/**
+ * \brief frees the pages of the atlas, including their renderer resources
+ * \param [in, out] atlasPtr pointer to the texture atlas
+ */
+NK_INTERNAL NkVoid __NkInt_TextureAtlas_FreePages(_Inout_ NkTextureAtlas *atlasPtr) {
+    NkIRenderer *rdRef = atlasPtr->m_atlasSpec.mp_rdRef;
+
+    for (NkSize i = 0; i < atlasPtr->m_nPages; i++) {
+        __NkInt_AtlasPage *pagePtr = &atlasPtr->mp_pageArr[i];
+
+        if (pagePtr->mp_alphaRes != NULL)
+            NK_IGNORE_RETURN_VALUE(rdRef->VT->DeleteResource(rdRef, &pagePtr->mp_alphaRes));
+        if (pagePtr->mp_texRes != NULL)
+            NK_IGNORE_RETURN_VALUE(rdRef->VT->DeleteResource(rdRef, &pagePtr->mp_texRes));
+        NkGPFree(pagePtr->mp_nodeArr);
+    }
+
+    NkGPFree(atlasPtr->mp_pageArr);
+    atlasPtr->mp_pageArr = NULL;
+    atlasPtr->m_nPages   = 0;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkTextureAtlasCreate(
+    _In_       NkTextureAtlasSpecification const *atlasSpec,
+    _Init_ptr_ NkTextureAtlas **atlasPtr
+) {
+    NK_ASSERT(atlasSpec != NULL && atlasSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(atlasSpec->mp_rdRef != NULL, NkErr_InParameter);
+    NK_ASSERT(atlasSpec->m_pageDim.m_width > 0 && atlasSpec->m_pageDim.m_height > 0, NkErr_InParameter);
+    NK_ASSERT(atlasPtr != NULL, NkErr_OutptrParameter);
+
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **atlasPtr, 0, NK_TRUE, (NkVoid **)atlasPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    (*atlasPtr)->m_atlasSpec = *atlasSpec;
+
+    /* Keep the renderer alive for as long as the atlas exists. */
+    atlasSpec->mp_rdRef->VT->AddRef(atlasSpec->mp_rdRef);
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkTextureAtlasDestroy(_Uninit_ptr_ NkTextureAtlas **atlasPtr) {
+    NK_ASSERT(atlasPtr != NULL, NkErr_InOutParameter);
+
+    if (*atlasPtr == NULL)
+        return;
+    NkTextureAtlas *actAtlas = *atlasPtr;
+    NkIRenderer    *rdRef    = actAtlas->m_atlasSpec.mp_rdRef;
+
+    __NkInt_TextureAtlas_FreePages(actAtlas);
+    rdRef->VT->Release(rdRef);
+
+    NkGPFree(actAtlas->mp_subArr);
+    NkGPFree(actAtlas->mp_entryArr);
+    NkGPFree(actAtlas);
+    *atlasPtr = NULL;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkTextureAtlasAddBitmap(
+    _Inout_  NkTextureAtlas *atlasPtr,
+    _In_     NkDIBitmap const *bmpPtr,
+    _In_     NkSize2D cellDim,
+    _In_opt_ NkRgbaColor const *keyCol,
+    _Out_    NkSubTextureId *firstId
+) {
+    NK_ASSERT(atlasPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(bmpPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(firstId != NULL, NkErr_OutParameter);
+
+    if (atlasPtr->m_isBuilt)
+        return NkErr_ObjectState;
+
+    /* Validate the bitmap. */
+    NkBitmapSpecification const *bmpSpec = NkDIBitmapGetSpecification(bmpPtr);
+    NkSize2D const bmpDim = {
+        (NkUint64)bmpSpec->m_bmpWidth,
+        (NkUint64)(bmpSpec->m_bmpHeight < 0 ? -bmpSpec->m_bmpHeight : bmpSpec->m_bmpHeight)
+    };
+    if (bmpSpec->m_bitsPerPx != 24 && bmpSpec->m_bitsPerPx != 32)
+        return NkErr_InvBitDepth;
+    NkSize2D const pageDim = atlasPtr->m_atlasSpec.m_pageDim;
+    if (   bmpDim.m_width  == 0 || bmpDim.m_width  + atlasPtr->m_atlasSpec.m_padding > pageDim.m_width
+        || bmpDim.m_height == 0 || bmpDim.m_height + atlasPtr->m_atlasSpec.m_padding > pageDim.m_height
+    ) {
+        NK_LOG_ERROR("Bitmap of %llux%llu pixels does not fit into atlas pages of %llux%llu pixels.", bmpDim.m_width, bmpDim.m_height, pageDim.m_width, pageDim.m_height);
+
+        return NkErr_InvImageDimensions;
+    }
+    if (cellDim.m_width == 0 || cellDim.m_height == 0)
+        cellDim = bmpDim;
+    else if (cellDim.m_width > bmpDim.m_width || cellDim.m_height > bmpDim.m_height)
+        return NkErr_InvImageDimensions;
+
+    /* Reserve space for the entry and its sub-textures. */
+    NkUint32 const nCells = (NkUint32)((bmpDim.m_width / cellDim.m_width) * (bmpDim.m_height / cellDim.m_height));
+    NkErrorCode errCode = __NkInt_TextureAtlas_Grow(
+        (atlasPtr->m_nEntries + 1) * sizeof *atlasPtr->mp_entryArr,
+        (NkVoid **)&atlasPtr->mp_entryArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+    errCode = __NkInt_TextureAtlas_Grow(
+        (atlasPtr->m_nSubTex + nCells) * sizeof *atlasPtr->mp_subArr,
+        (NkVoid **)&atlasPtr->mp_subArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    atlasPtr->mp_entryArr[atlasPtr->m_nEntries++] = (__NkInt_AtlasEntry){
+        .mp_bmpRef = bmpPtr,
+        .m_bmpDim  = bmpDim,
+        .m_cellDim = cellDim,
+        .m_keyCol  = keyCol != NULL ? *keyCol : (NkRgbaColor){ 0 },
+        .m_isKeyed = keyCol != NULL,
+        .m_firstId = (NkSubTextureId)atlasPtr->m_nSubTex,
+        .m_nCells  = nCells
+    };
+    *firstId = (NkSubTextureId)atlasPtr->m_nSubTex;
+    atlasPtr->m_nSubTex += nCells;
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkTextureAtlasBuild(_Inout_ NkTextureAtlas *atlasPtr) {
+    NK_ASSERT(atlasPtr != NULL, NkErr_InOutParameter);
+
+    if (atlasPtr->m_isBuilt)
+        return NkErr_ObjectState;
+    if (atlasPtr->m_nEntries == 0) {
+        atlasPtr->m_isBuilt = NK_TRUE;
+
+        return NkErr_Ok;
+    }
+
+    /* Tall bitmaps first; shorter ones fill the gaps left on top of them. */
+    if (atlasPtr->m_nEntries > 1)
+        NK_IGNORE_RETURN_VALUE(NkQuicksortValues(
+            atlasPtr->mp_entryArr,
+            sizeof *atlasPtr->mp_entryArr,
+            0,
+            atlasPtr->m_nEntries - 1,
+            &__NkInt_TextureAtlas_CompareEntries
+        ));
+
+    /* Pack all entries, opening a new page whenever an entry does not fit anywhere. */
+    NkSize2D const pageDim = atlasPtr->m_atlasSpec.m_pageDim;
+    NkUint64 const padding = atlasPtr->m_atlasSpec.m_padding;
+    NkErrorCode    errCode = NkErr_Ok;
+    for (NkSize i = 0; i < atlasPtr->m_nEntries; i++) {
+        __NkInt_AtlasEntry *entryPtr = &atlasPtr->mp_entryArr[i];
+        NkSize2D const      rectDim  = { entryPtr->m_bmpDim.m_width + padding, entryPtr->m_bmpDim.m_height + padding };
+
+        NkSize pageInd = 0;
+        for (; pageInd < atlasPtr->m_nPages; pageInd++)
+            if (__NkInt_TextureAtlas_PlaceRect(&atlasPtr->mp_pageArr[pageInd], pageDim, rectDim, &entryPtr->m_pagePos))
+                break;
+        if (pageInd == atlasPtr->m_nPages) {
+            if ((errCode = __NkInt_TextureAtlas_AddPage(atlasPtr)) != NkErr_Ok)
+                goto lbl_ONERROR;
+
+            /* Every entry fits into an empty page; this was checked when it was added. */
+            NK_IGNORE_RETURN_VALUE(__NkInt_TextureAtlas_PlaceRect(&atlasPtr->mp_pageArr[pageInd], pageDim, rectDim, &entryPtr->m_pagePos));
+        }
+
+        __NkInt_AtlasPage *pagePtr = &atlasPtr->mp_pageArr[pageInd];
+        entryPtr->m_pageInd          = (NkUint32)pageInd;
+        pagePtr->m_isKeyed          |= entryPtr->m_isKeyed;
+        pagePtr->m_usedDim.m_width   = NK_MAX(pagePtr->m_usedDim.m_width, (NkUint64)entryPtr->m_pagePos.m_xCoord + entryPtr->m_bmpDim.m_width);
+        pagePtr->m_usedDim.m_height  = NK_MAX(pagePtr->m_usedDim.m_height, (NkUint64)entryPtr->m_pagePos.m_yCoord + entryPtr->m_bmpDim.m_height);
+    }
+
+    /* Create the page resources. */
+    for (NkSize i = 0; i < atlasPtr->m_nPages; i++)
+        if ((errCode = __NkInt_TextureAtlas_CreatePage(atlasPtr, i)) != NkErr_Ok) {
+            NK_LOG_ERROR("Failed to create atlas page %zu. Reason: %s (%i)", i, NkGetErrorCodeStr(errCode)->mp_dataPtr, (int)errCode);
+
+            goto lbl_ONERROR;
+        }
+
+    /* Precompute the source rectangles of all cells. */
+    for (NkSize i = 0; i < atlasPtr->m_nEntries; i++) {
+        __NkInt_AtlasEntry const *entryPtr = &atlasPtr->mp_entryArr[i];
+        __NkInt_AtlasPage const  *pagePtr  = &atlasPtr->mp_pageArr[entryPtr->m_pageInd];
+        NkUint64 const            nCols    = entryPtr->m_bmpDim.m_width / entryPtr->m_cellDim.m_width;
+
+        for (NkUint32 j = 0; j < entryPtr->m_nCells; j++)
+            atlasPtr->mp_subArr[entryPtr->m_firstId + j] = (NkSubTexture){
+                .mp_texRef   = pagePtr->mp_texRes,
+                .mp_alphaRef = entryPtr->m_isKeyed ? pagePtr->mp_alphaRes : NULL,
+                .m_srcRect   = {
+                    .m_xCoord = (NkFloat)(entryPtr->m_pagePos.m_xCoord + (NkInt64)((j % nCols) * entryPtr->m_cellDim.m_width)),
+                    .m_yCoord = (NkFloat)(entryPtr->m_pagePos.m_yCoord + (NkInt64)((j / nCols) * entryPtr->m_cellDim.m_height)),
+                    .m_width  = (NkFloat)entryPtr->m_cellDim.m_width,
+                    .m_height = (NkFloat)entryPtr->m_cellDim.m_height
+                }
+            };
+    }
+
+    NK_LOG_INFO("Packed %zu bitmaps (%zu sub-textures) into %zu atlas page(s).", atlasPtr->m_nEntries, atlasPtr->m_nSubTex, atlasPtr->m_nPages);
+    atlasPtr->m_isBuilt = NK_TRUE;
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    __NkInt_TextureAtlas_FreePages(atlasPtr);
+
+    return errCode;
+}
+
+NK_INLINE NkSubTexture const *NK_CALL NkTextureAtlasQuerySubTexture(
+    _In_ NkTextureAtlas const *atlasPtr,
+    _In_ NkSubTextureId subId
+) {
+    NK_ASSERT(atlasPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(atlasPtr->m_isBuilt && (NkSize)subId < atlasPtr->m_nSubTex, NkErr_ArrayElemOutOfBounds);
+
+    return &atlasPtr->mp_subArr[subId];
+}
+
+NkSize NK_CALL NkTextureAtlasQueryPageCount(_In_ NkTextureAtlas const *atlasPtr) {
+    NK_ASSERT(atlasPtr != NULL, NkErr_InParameter);
+
+    return atlasPtr->m_isBuilt ? atlasPtr->m_nPages : 0;
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -33,6 +33,7 @@
 #include <include/Noriko/alloc.h>
 #include <include/Noriko/platform.h>
 #include <include/Noriko/log.h>
+#include <include/Noriko/pixel.h>
 
 
 /** \cond INTERNAL */
@@ -41,8 +42,9 @@
  * \brief  represents the internal structure of an \c NkDIBitmap object
  */
 NK_NATIVE typedef struct __NkInt_DIBitmap {
-    NkBitmapSpecification  m_bSpec;    /**< bitmap specification */
-    NkByte                *mp_pxArray; /**< pointer to the raw pixel array */
+    NkBitmapSpecification  m_bSpec;      /**< bitmap specification */
+    NkByte                *mp_pxArray;   /**< pointer to the raw pixel array */
+    NkBoolean              m_isBorrowed; /**< whether the pixel array is owned by someone else */
 } __NkInt_DIBitmap;
 /* Verify integrity between definitions. */
 static_assert(
@@ -188,10 +190,15 @@ NK_INTERNAL NkVoid __NkInt_DIBitmap_Fill(
      * padding as the padding is never meant to be read and also, as per specification,
      * is not required to be all zeroes.
      * The way this is done is based on this post: https://stackoverflow.com/a/44251649.
+     * 32-bit rows are filled with a vectorized kernel instead.
      */
-    memcpy(pxArray, (NkVoid const *)&cvtClearCol, (NkSize)pixelWidth);
-    for (NkUint32 i = pixelWidth; i < rowSize; i += i)
-        memcpy(&pxArray[i], (NkVoid const *)pxArray, NK_MIN(rowSize - i, i));
+    if (pixelWidth == 4)
+        NkPixelFill32(pxArray, (NkSize)(rowSize / 4), cvtClearCol);
+    else {
+        memcpy(pxArray, (NkVoid const *)&cvtClearCol, (NkSize)pixelWidth);
+        for (NkUint32 i = pixelWidth; i < rowSize; i += i)
+            memcpy(&pxArray[i], (NkVoid const *)pxArray, NK_MIN(rowSize - i, i));
+    }
 
     /*
      * Now, we fill all the subsequent rows by just copying the first row into them. We
@@ -201,6 +208,71 @@ NK_INTERNAL NkVoid __NkInt_DIBitmap_Fill(
         memcpy(&pxArray[i * rowSize], (NkVoid const *)pxArray, rowSize * NK_MIN(bmpSpecs->m_bmpHeight - i, i));
 }
 
+/**
+ * \brief flips the rows of a pixel array in place
+ * \param [in, out] pxArray pixel array
+ * \param [in] rowSize size of a row including its padding, in bytes
+ * \param [in] nRows number of rows
+ */
+NK_INTERNAL NkVoid __NkInt_DIBitmap_FlipRows(_Inout_ NkByte *pxArray, _In_ NkUint32 rowSize, _In_ NkInt32 nRows) {
+    NkByte tmpBuf[256];
+
+    for (NkInt32 i = 0; i < nRows / 2; i++) {
+        NkByte *topRow = &pxArray[(NkSize)i * rowSize];
+        NkByte *btmRow = &pxArray[(NkSize)(nRows - 1 - i) * rowSize];
+
+        for (NkUint32 j = 0; j < rowSize; j += (NkUint32)sizeof tmpBuf) {
+            NkSize const chunkSize = NK_MIN(rowSize - j, (NkUint32)sizeof tmpBuf);
+
+            memcpy(tmpBuf, &topRow[j], chunkSize);
+            memcpy(&topRow[j], &btmRow[j], chunkSize);
+            memcpy(&btmRow[j], tmpBuf, chunkSize);
+        }
+    }
+}
+
+/**
+ * \brief initializes a bitmap object from parsed headers
+ * \param [in] dibHead DIB header of the bitmap; may be a \c BITMAPINFOHEADER
+ * \param [in] pxBuf pixel array of the bitmap
+ * \param [in] isBorrowed whether \c pxBuf must not be freed by the bitmap
+ * \param [out] resPtr bitmap that is to be initialized
+ */
+NK_INTERNAL NkVoid __NkInt_DIBitmap_InitFromHeaders(
+    _In_  __NkInt_BitmapV4InfoHeader const *dibHead,
+    _In_  NkByte *pxBuf,
+    _In_  NkBoolean isBorrowed,
+    _Out_ NkDIBitmap *resPtr
+) {
+    NkInt32 const absHeight = dibHead->m_biHeight < 0 ? -dibHead->m_biHeight : dibHead->m_biHeight;
+
+    *(__NkInt_DIBitmap *)resPtr = (__NkInt_DIBitmap){
+        .m_bSpec = {
+            .m_structSize = sizeof(NkBitmapSpecification),
+            .m_bmpWidth   = dibHead->m_biWidth,
+            .m_bmpHeight  = absHeight,
+            .m_bmpStride  = __NkInt_DIBitmap_CalculateStride(dibHead->m_biWidth, dibHead->m_biBitCount),
+            .m_bitsPerPx  = dibHead->m_biBitCount,
+            .m_bmpFlags   = 0
+        },
+        .mp_pxArray   = pxBuf,
+        .m_isBorrowed = isBorrowed
+    };
+    /* Set masks if we are using bitmasks. */
+    if (dibHead->m_biCompression == BI_BITFIELDS) {
+        __NkInt_DIBitmap *actResPtr = (__NkInt_DIBitmap *)resPtr;
+
+        /* Copy all three main bitmasks by default. */
+        actResPtr->m_bSpec.m_redMask   = dibHead->m_redMask;
+        actResPtr->m_bSpec.m_greenMask = dibHead->m_greenMask;
+        actResPtr->m_bSpec.m_blueMask  = dibHead->m_blueMask;
+
+        /* If the bitmap uses the BITMAPV4INFOHEADER, we copy all four bitmasks. */
+        if (dibHead->m_biSize == sizeof(__NkInt_BitmapV4InfoHeader))
+            actResPtr->m_bSpec.m_alphaMask = dibHead->m_alphaMask;
+    }
+}
+
 /**
  */
 NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_DIBitmap_ValidateSpecification(_In_ NkBitmapSpecification const *bmSpecs) {
@@ -305,9 +377,10 @@ _Return_ok_ NkErrorCode NK_CALL NkDIBitmapLoad(_In_z_ char const *filePath, _Out
 
     /* Allocate memory for the pixel buffer. */
     NkByte *pxBuf;
+    NkInt32 const  absHeight = dibHead.m_biHeight < 0 ? -dibHead.m_biHeight : dibHead.m_biHeight;
     NkUint32 const pxBufSize = dibHead.m_biSizeImage
         ? dibHead.m_biSizeImage
-        : __NkInt_DIBitmap_CalculateRawArraySize(dibHead.m_biWidth, dibHead.m_biHeight, dibHead.m_biBitCount)
+        : __NkInt_DIBitmap_CalculateRawArraySize(dibHead.m_biWidth, absHeight, dibHead.m_biBitCount)
     ;
     NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)pxBufSize, 0, NK_FALSE, &pxBuf);
     if (errCode != NkErr_Ok) {
@@ -319,34 +392,85 @@ _Return_ok_ NkErrorCode NK_CALL NkDIBitmapLoad(_In_z_ char const *filePath, _Out
     /* Read the pixel buffer directly into the allocated memory. */
     fread_s(pxBuf, pxBufSize, pxBufSize, 1, fStream);
 
+    /*
+     * The bitmap is stored bottom-up like the ones loaded from memory, as its height loses
+     * its sign below. Rows that the buffer does not hold are not flipped.
+     */
+    if (dibHead.m_biHeight < 0) {
+        NkUint32 const rowSize = __NkInt_DIBitmap_CalculateStride(dibHead.m_biWidth, dibHead.m_biBitCount);
+
+        if (rowSize > 0)
+            __NkInt_DIBitmap_FlipRows(pxBuf, rowSize, (NkInt32)NK_MIN((NkUint32)absHeight, pxBufSize / rowSize));
+    }
+
     /* Cleanup and initialize bitmap structure. */
     fclose(fStream);
-    *(__NkInt_DIBitmap *)resPtr = (__NkInt_DIBitmap){
-        .m_bSpec = {
-            .m_structSize = sizeof(NkBitmapSpecification),
-            .m_bmpWidth   = dibHead.m_biWidth,
-            .m_bmpHeight  = dibHead.m_biHeight,
-            .m_bmpStride  = __NkInt_DIBitmap_CalculateStride(dibHead.m_biWidth, dibHead.m_biBitCount),
-            .m_bitsPerPx  = dibHead.m_biBitCount,
-            .m_bmpFlags   = 0
-        },
-        .mp_pxArray = pxBuf
-    };
-    /* Set masks if we are using bitmasks. */
-    if (dibHead.m_biCompression == BI_BITFIELDS) {
-        __NkInt_DIBitmap *actResPtr = (__NkInt_DIBitmap *)resPtr;
+    __NkInt_DIBitmap_InitFromHeaders(&dibHead, pxBuf, NK_FALSE, resPtr);
 
-        /* Copy all three main bitmasks by default. */
-        actResPtr->m_bSpec.m_redMask = dibHead.m_redMask;
-        actResPtr->m_bSpec.m_redMask = dibHead.m_redMask;
-        actResPtr->m_bSpec.m_redMask = dibHead.m_redMask;
+    /* All good. */
+    return NkErr_Ok;
+}
 
-        /* If the bitmap uses the BITMAPV4INFOHEADER, we copy all four bitmasks. */
-        if (dibHead.m_biSize == sizeof(__NkInt_BitmapV4InfoHeader))
-            actResPtr->m_bSpec.m_alphaMask = dibHead.m_alphaMask;
+_Return_ok_ NkErrorCode NK_CALL NkDIBitmapLoadFromMemory(_In_ NkBufferView fileBuf, _Out_ NkDIBitmap *resPtr) {
+    NK_ASSERT(fileBuf.mp_dataPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutParameter);
+
+    /*
+     * Parse the headers in place. They are copied into local variables since the buffer
+     * does not have to be suitably aligned.
+     */
+    __NkInt_BitmapFileHeader   fileHead;
+    __NkInt_BitmapV4InfoHeader dibHead = { 0 };
+    if (fileBuf.m_sizeInBytes < sizeof fileHead + sizeof dibHead.m_biSize)
+        return NkErr_UnsupportedFileFormat;
+    memcpy(&fileHead, fileBuf.mp_dataPtr, sizeof fileHead);
+    memcpy(&dibHead.m_biSize, fileBuf.mp_dataPtr + sizeof fileHead, sizeof dibHead.m_biSize);
+    if (fileHead.m_bfType != 'MB')
+        return NkErr_UnsupportedFileFormat;
+
+    /* Check if the header is supported. */
+    if (dibHead.m_biSize != sizeof(__NkInt_BitmapInfoHeader) && dibHead.m_biSize != sizeof(__NkInt_BitmapV4InfoHeader)) {
+        NK_LOG_ERROR("DIB headers of size %u are currently not supported.", dibHead.m_biSize);
+
+        return NkErr_UnsupportedFileFormat;
     }
+    if (fileBuf.m_sizeInBytes < sizeof fileHead + dibHead.m_biSize)
+        return NkErr_CorruptedData;
+    memcpy(&dibHead, fileBuf.mp_dataPtr + sizeof fileHead, dibHead.m_biSize);
 
-    /* All good. */
+    /* Only uncompressed pixel arrays can be used as-is. */
+    if (dibHead.m_biCompression != BI_RGB && dibHead.m_biCompression != BI_BITFIELDS)
+        return NkErr_UnsupportedFileFormat;
+    if (dibHead.m_biWidth <= 0 || dibHead.m_biHeight == 0 || dibHead.m_biHeight == INT32_MIN)
+        return NkErr_InvImageDimensions;
+    if (dibHead.m_biBitCount != 24 && dibHead.m_biBitCount != 32)
+        return NkErr_InvBitDepth;
+
+    /* Make sure the pixel array lies inside of the buffer. */
+    NkBoolean const isTopDown = dibHead.m_biHeight < 0;
+    NkInt32 const   absHeight = isTopDown ? -dibHead.m_biHeight : dibHead.m_biHeight;
+    NkUint32 const  rowSize   = __NkInt_DIBitmap_CalculateStride(dibHead.m_biWidth, dibHead.m_biBitCount);
+    NkUint64 const  pxArrSize = (NkUint64)rowSize * (NkUint64)absHeight;
+    if (fileHead.m_bfOffBytes > fileBuf.m_sizeInBytes || pxArrSize > fileBuf.m_sizeInBytes - fileHead.m_bfOffBytes)
+        return NkErr_CorruptedData;
+    NkByte *srcPxArray = fileBuf.mp_dataPtr + fileHead.m_bfOffBytes;
+
+    /* Bottom-up bitmaps are referenced directly. */
+    if (!isTopDown) {
+        __NkInt_DIBitmap_InitFromHeaders(&dibHead, srcPxArray, NK_TRUE, resPtr);
+
+        return NkErr_Ok;
+    }
+
+    /* Top-down bitmaps are flipped into a new pixel array so that all bitmaps are alike. */
+    NkByte *pxBuf;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)pxArrSize, 0, NK_FALSE, &pxBuf);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    for (NkInt32 i = 0; i < absHeight; i++)
+        memcpy(&pxBuf[(NkSize)(absHeight - 1 - i) * rowSize], &srcPxArray[(NkSize)i * rowSize], rowSize);
+
+    __NkInt_DIBitmap_InitFromHeaders(&dibHead, pxBuf, NK_FALSE, resPtr);
     return NkErr_Ok;
 }
 
@@ -354,7 +478,10 @@ NkVoid NK_CALL NkDIBitmapDestroy(_Inout_ NkDIBitmap *bmpPtr) {
     if (bmpPtr == NULL)
         return;
 
-    NkGPFree(((__NkInt_DIBitmap *)bmpPtr)->mp_pxArray);
+    /* Borrowed pixel arrays belong to the buffer the bitmap was loaded from. */
+    __NkInt_DIBitmap *actBmpPtr = (__NkInt_DIBitmap *)bmpPtr;
+    if (!actBmpPtr->m_isBorrowed)
+        NkGPFree(actBmpPtr->mp_pxArray);
 }
 
 _Return_ok_ NkErrorCode NK_CALL NkDIBitmapSave(_In_ NkDIBitmap const *bmpPtr, _In_z_ char const *filePath) {
@@ -423,6 +550,63 @@ _Return_ok_ NkErrorCode NK_CALL NkDIBitmapSave(_In_ NkDIBitmap const *bmpPtr, _I
     return NkErr_Ok;
 }
 
+_Return_ok_ NkErrorCode NK_CALL NkDIBitmapDownsample(_In_ NkDIBitmap const *srcPtr, _Out_ NkDIBitmap *resPtr) {
+    NK_ASSERT(srcPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutParameter);
+
+    __NkInt_DIBitmap const *actSrcPtr = (__NkInt_DIBitmap const *)srcPtr;
+    if (actSrcPtr->m_bSpec.m_bmpWidth < 2 || actSrcPtr->m_bSpec.m_bmpHeight < 2)
+        return NkErr_InvImageDimensions;
+
+    /* Create the result with the same pixel format. */
+    NkBitmapSpecification dstSpecs = actSrcPtr->m_bSpec;
+    dstSpecs.m_bmpWidth  /= 2;
+    dstSpecs.m_bmpHeight /= 2;
+    NkErrorCode errCode = NkDIBitmapCreate(&dstSpecs, NULL, resPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    __NkInt_DIBitmap *actResPtr = (__NkInt_DIBitmap *)resPtr;
+    NkSize const      dstWidth  = (NkSize)dstSpecs.m_bmpWidth;
+
+    if (dstSpecs.m_bitsPerPx == 32) {
+        for (NkInt32 y = 0; y < dstSpecs.m_bmpHeight; y++)
+            NkPixelDownsample32(
+                actResPtr->mp_pxArray + (NkSize)y * actResPtr->m_bSpec.m_bmpStride,
+                actSrcPtr->mp_pxArray + (NkSize)y * 2 * actSrcPtr->m_bSpec.m_bmpStride,
+                actSrcPtr->mp_pxArray + ((NkSize)y * 2 + 1) * actSrcPtr->m_bSpec.m_bmpStride,
+                dstWidth
+            );
+
+        return NkErr_Ok;
+    }
+
+    /*
+     * The filter only works on 32-bit pixels, so 24-bit rows are widened into a scratch
+     * buffer first, and the result is narrowed again. The scratch buffer holds two source
+     * rows followed by one destination row.
+     */
+    NkByte *scratchBuf;
+    errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), dstWidth * 5 * 4, 0, NK_FALSE, &scratchBuf);
+    if (errCode != NkErr_Ok) {
+        NkDIBitmapDestroy(resPtr);
+
+        return errCode;
+    }
+    NkByte *const fRowBuf = scratchBuf;
+    NkByte *const sRowBuf = scratchBuf + dstWidth * 8;
+    NkByte *const dRowBuf = scratchBuf + dstWidth * 16;
+
+    for (NkInt32 y = 0; y < dstSpecs.m_bmpHeight; y++) {
+        NkPixelConvert24To32(fRowBuf, actSrcPtr->mp_pxArray + (NkSize)y * 2 * actSrcPtr->m_bSpec.m_bmpStride, dstWidth * 2, 0xFF);
+        NkPixelConvert24To32(sRowBuf, actSrcPtr->mp_pxArray + ((NkSize)y * 2 + 1) * actSrcPtr->m_bSpec.m_bmpStride, dstWidth * 2, 0xFF);
+        NkPixelDownsample32(dRowBuf, fRowBuf, sRowBuf, dstWidth);
+        NkPixelConvert32To24(actResPtr->mp_pxArray + (NkSize)y * actResPtr->m_bSpec.m_bmpStride, dRowBuf, dstWidth);
+    }
+
+    NkGPFree(scratchBuf);
+    return NkErr_Ok;
+}
+
 NkBitmapSpecification const *NK_CALL NkDIBitmapGetSpecification(_In_ NkDIBitmap const *bmpPtr) {
     NK_ASSERT(bmpPtr != NULL, NkErr_InParameter);
 
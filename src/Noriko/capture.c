@@ -0,0 +1,355 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  capture.c
+ * \brief implements the non-blocking framebuffer capture service
+ *
+ * Every capture owns one frame of the pool for as long as its file is being written.
+ * Frames are only ever acquired by the main thread and released by the job that wrote
+ * them, so a busy flag per frame is all the synchronization that is needed. The bitmaps
+ * of the frames are kept alive and refilled with <tt>CopyFramebuffer()</tt>; they are
+ * only recreated if the framebuffer has been resized in the meantime.
+ */
+#define NK_NAMESPACE "nk::capture"
+
+
+/* stdlib includes */
+#include <stdio.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/capture.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/timer.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/comp.h>
+#include <include/Noriko/job.h>
+#include <include/Noriko/bmp.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \struct __NkInt_CaptureFrame
+ * \brief  represents a captured frame that is waiting to be written
+ */
+NK_NATIVE typedef struct __NkInt_CaptureFrame {
+    NkDIBitmap    m_bmpData;                      /**< copy of the framebuffer */
+    NkBoolean     m_isInit;                       /**< whether \c m_bmpData is a valid bitmap */
+    NkBoolean     m_isPooled;                     /**< whether the frame belongs to the pool */
+    LONG volatile m_isBusy;                       /**< whether the frame is being written */
+    char          m_filePath[NK_CAPTURE_MAXPATH]; /**< path of the file to write */
+} __NkInt_CaptureFrame;
+
+/**
+ * \struct __NkInt_CaptureContext
+ * \brief  represents the global state of the capture service
+ */
+NK_NATIVE typedef struct __NkInt_CaptureContext {
+    __NkInt_CaptureFrame m_frameArr[NK_CAPTURE_POOLSIZE]; /**< recycled frames */
+    NkJobCounter         m_writeCtr;                      /**< counts the frames being written */
+
+    /**
+     * \struct __NkInt_CaptureRecording
+     * \brief  represents the state of the current recording
+     */
+    struct __NkInt_CaptureRecording {
+        NkBoolean m_isActive;                        /**< whether a recording is running */
+        char      m_pathPrefix[NK_CAPTURE_MAXPATH];  /**< path prefix of the frame files */
+        NkUint64  m_frameTicks;                      /**< ticks between two captured frames */
+        NkUint64  m_nextTicks;                       /**< time at which the next frame is due */
+        NkUint32  m_nCaptured;                       /**< number of frames captured so far */
+        NkUint32  m_nDropped;                        /**< number of frames dropped so far */
+    } m_recState;
+} __NkInt_CaptureContext;
+/**
+ * \brief actual instance of the capture service context
+ */
+NK_INTERNAL __NkInt_CaptureContext gl_CaptureCxt;
+
+
+/**
+ * \brief  acquires a frame from the pool
+ * \return pointer to the frame, or \c NULL if all frames are busy
+ */
+NK_INTERNAL __NkInt_CaptureFrame *__NkInt_Capture_AcquireFrame(NkVoid) {
+    for (NkUint32 i = 0; i < NK_CAPTURE_POOLSIZE; i++) {
+        __NkInt_CaptureFrame *framePtr = &gl_CaptureCxt.m_frameArr[i];
+
+        if (InterlockedCompareExchange(&framePtr->m_isBusy, 1, 0) == 0)
+            return framePtr;
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief releases a frame after its file has been written
+ * \param [in, out] framePtr frame that is to be released
+ * \note  Frames that do not belong to the pool are destroyed.
+ */
+NK_INTERNAL NkVoid __NkInt_Capture_ReleaseFrame(_Inout_ __NkInt_CaptureFrame *framePtr) {
+    if (!framePtr->m_isPooled) {
+        NkDIBitmapDestroy(&framePtr->m_bmpData);
+
+        NkGPFree(framePtr);
+        return;
+    }
+
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange(&framePtr->m_isBusy, 0));
+}
+
+/**
+ * \brief  copies the framebuffer into the given frame
+ * \param  [in, out] rdRef renderer whose framebuffer is to be copied
+ * \param  [in, out] framePtr frame that receives the framebuffer
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Capture_GrabFrame(
+    _Inout_ NkIRenderer *rdRef,
+    _Inout_ __NkInt_CaptureFrame *framePtr
+) {
+    NkErrorCode errCode;
+
+    if (framePtr->m_isInit) {
+        /* Reuse the bitmap unless the framebuffer has been resized. */
+        if ((errCode = rdRef->VT->CopyFramebuffer(rdRef, &framePtr->m_bmpData)) != NkErr_InvImageDimensions)
+            return errCode;
+
+        NkDIBitmapDestroy(&framePtr->m_bmpData);
+        framePtr->m_isInit = NK_FALSE;
+    }
+
+    if ((errCode = rdRef->VT->GrabFramebuffer(rdRef, &framePtr->m_bmpData)) != NkErr_Ok)
+        return errCode;
+    framePtr->m_isInit = NK_TRUE;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief writes a captured frame to its file and releases it
+ * \param [in, out] extraCxt pointer to the \c __NkInt_CaptureFrame instance
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_Capture_WriteJob(_Inout_opt_ NkVoid *extraCxt) {
+    __NkInt_CaptureFrame *framePtr = (__NkInt_CaptureFrame *)extraCxt;
+
+    NkErrorCode const errCode = NkDIBitmapSave(&framePtr->m_bmpData, framePtr->m_filePath);
+    if (errCode != NkErr_Ok)
+        NK_LOG_ERROR(
+            "Failed to write capture file \"%s\". Reason: %s (%i)",
+            framePtr->m_filePath,
+            NkGetErrorCodeStr(errCode)->mp_dataPtr,
+            (int)errCode
+        );
+
+    __NkInt_Capture_ReleaseFrame(framePtr);
+}
+
+/**
+ * \brief hands a captured frame to the job system for writing
+ * \param [in, out] framePtr frame that is to be written
+ * \note  If the job cannot be submitted, or there are no worker threads, the frame is
+ *        written on the calling thread.
+ */
+NK_INTERNAL NkVoid __NkInt_Capture_SubmitFrame(_Inout_ __NkInt_CaptureFrame *framePtr) {
+    NkJobDescription const jobDesc = { &__NkInt_Capture_WriteJob, (NkVoid *)framePtr };
+
+    if (NkJobGetWorkerCount() == 0 || NkJobSubmit(&jobDesc, 1, NULL, &gl_CaptureCxt.m_writeCtr) != NkErr_Ok)
+        __NkInt_Capture_WriteJob((NkVoid *)framePtr);
+}
+
+
+/**
+ * \brief  initializes the capture service
+ * \return always \c NkErr_Ok
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(Capture)(NkVoid) {
+    memset(&gl_CaptureCxt, 0, sizeof gl_CaptureCxt);
+
+    for (NkUint32 i = 0; i < NK_CAPTURE_POOLSIZE; i++)
+        gl_CaptureCxt.m_frameArr[i].m_isPooled = NK_TRUE;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  stops any recording, waits for all pending writes, and destroys the pool
+ * \return always \c NkErr_Ok
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(Capture)(NkVoid) {
+    NkCaptureEndRecording();
+    /* The job system is still running, so the writes can be waited for. */
+    NkJobWait(&gl_CaptureCxt.m_writeCtr);
+
+    for (NkUint32 i = 0; i < NK_CAPTURE_POOLSIZE; i++)
+        if (gl_CaptureCxt.m_frameArr[i].m_isInit)
+            NkDIBitmapDestroy(&gl_CaptureCxt.m_frameArr[i].m_bmpData);
+
+    memset(&gl_CaptureCxt, 0, sizeof gl_CaptureCxt);
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkCaptureScreenshot(
+    _Inout_       NkIRenderer *rdRef,
+    _In_z_ _Utf8_ char const *filePath
+) {
+    NK_ASSERT(rdRef != NULL, NkErr_InOutParameter);
+    NK_ASSERT(filePath != NULL && *filePath ^ '\0', NkErr_InParameter);
+
+    if (strlen(filePath) >= NK_CAPTURE_MAXPATH)
+        return NkErr_InvalidRange;
+
+    /*
+     * A screenshot is never dropped. If the pool is exhausted, e.g. because a recording
+     * is running, use a frame of its own that is destroyed once it has been written.
+     */
+    NkErrorCode           errCode;
+    __NkInt_CaptureFrame *framePtr = __NkInt_Capture_AcquireFrame();
+    if (framePtr == NULL) {
+        errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *framePtr, 0, NK_TRUE, (NkVoid **)&framePtr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+
+    if ((errCode = __NkInt_Capture_GrabFrame(rdRef, framePtr)) != NkErr_Ok) {
+        NK_LOG_ERROR(
+            "Failed to grab current framebuffer. Reason: %s (%i)",
+            NkGetErrorCodeStr(errCode)->mp_dataPtr,
+            (int)errCode
+        );
+
+        if (!framePtr->m_isPooled)
+            NkGPFree(framePtr);
+        else
+            NK_IGNORE_RETURN_VALUE(InterlockedExchange(&framePtr->m_isBusy, 0));
+        return errCode;
+    }
+    strcpy(framePtr->m_filePath, filePath);
+
+    __NkInt_Capture_SubmitFrame(framePtr);
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkCaptureBeginRecording(
+    _In_z_ _Utf8_ char const *pathPrefix,
+    _In_          NkUint32 frameRate
+) {
+    NK_ASSERT(pathPrefix != NULL, NkErr_InParameter);
+    NK_ASSERT(frameRate > 0, NkErr_InParameter);
+
+    struct __NkInt_CaptureRecording *recPtr = &gl_CaptureCxt.m_recState;
+    if (recPtr->m_isActive)
+        return NkErr_NoOperation;
+    /* Leave room for the frame number and the file extension. */
+    if (strlen(pathPrefix) + sizeof "000000.bmp" > NK_CAPTURE_MAXPATH)
+        return NkErr_InvalidRange;
+
+    strcpy(recPtr->m_pathPrefix, pathPrefix);
+    recPtr->m_frameTicks = NkTimerGetFrequency() / (NkUint64)frameRate;
+    recPtr->m_nextTicks  = NkTimerGetCurrentTicks();
+    recPtr->m_nCaptured  = 0;
+    recPtr->m_nDropped   = 0;
+    recPtr->m_isActive   = NK_TRUE;
+
+    NK_LOG_INFO("Started recording to \"%s*.bmp\" at %u frames per second.", pathPrefix, frameRate);
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkCaptureEndRecording(NkVoid) {
+    struct __NkInt_CaptureRecording *recPtr = &gl_CaptureCxt.m_recState;
+    if (!recPtr->m_isActive)
+        return;
+
+    recPtr->m_isActive = NK_FALSE;
+    NK_LOG_INFO(
+        "Stopped recording to \"%s*.bmp\". Frames captured: %u, dropped: %u",
+        recPtr->m_pathPrefix,
+        recPtr->m_nCaptured,
+        recPtr->m_nDropped
+    );
+}
+
+NkBoolean NK_CALL NkCaptureIsRecording(NkVoid) {
+    return gl_CaptureCxt.m_recState.m_isActive;
+}
+
+NkVoid NK_CALL NkCaptureOnFrame(_Inout_ NkIRenderer *rdRef) {
+    NK_ASSERT(rdRef != NULL, NkErr_InOutParameter);
+
+    struct __NkInt_CaptureRecording *recPtr = &gl_CaptureCxt.m_recState;
+    if (!recPtr->m_isActive)
+        return;
+
+    NkUint64 const currTicks = NkTimerGetCurrentTicks();
+    if (currTicks < recPtr->m_nextTicks)
+        return;
+    /* If we fell behind, do not try to catch up but start over from now. */
+    recPtr->m_nextTicks += recPtr->m_frameTicks;
+    if (recPtr->m_nextTicks <= currTicks)
+        recPtr->m_nextTicks = currTicks + recPtr->m_frameTicks;
+
+    /*
+     * Unlike screenshots, recording frames are dropped if the writes cannot keep up, so
+     * that recording never makes the game run slower.
+     */
+    __NkInt_CaptureFrame *framePtr = __NkInt_Capture_AcquireFrame();
+    if (framePtr == NULL) {
+        ++recPtr->m_nDropped;
+
+        return;
+    }
+
+    NkErrorCode const errCode = __NkInt_Capture_GrabFrame(rdRef, framePtr);
+    if (errCode != NkErr_Ok) {
+        NK_LOG_ERROR(
+            "Failed to grab framebuffer for recording; stopping. Reason: %s (%i)",
+            NkGetErrorCodeStr(errCode)->mp_dataPtr,
+            (int)errCode
+        );
+
+        NK_IGNORE_RETURN_VALUE(InterlockedExchange(&framePtr->m_isBusy, 0));
+        NkCaptureEndRecording();
+        return;
+    }
+    snprintf(framePtr->m_filePath, NK_CAPTURE_MAXPATH, "%s%06u.bmp", recPtr->m_pathPrefix, recPtr->m_nCaptured++);
+
+    __NkInt_Capture_SubmitFrame(framePtr);
+}
+
+NkVoid NK_CALL NkCaptureWaitIdle(NkVoid) {
+    NkJobWait(&gl_CaptureCxt.m_writeCtr);
+}
+
+
+/** \cond INTERNAL */
+/**
+ * \brief info for the <em>capture</em> component
+ */
+NK_COMPONENT_DEFINE(Capture) {
+    .m_compUuid     = { 0x5d83e6f0, 0x1b9c, 0x4a27, 0xb3e84f61d09a7c25 },
+    .mp_clsId       = NULL,
+    .m_compIdent    = NK_MAKE_STRING_VIEW("framebuffer capture"),
+    .m_compFlags    = 0,
+    .m_isNkOM       = NK_FALSE,
+
+    .mp_fnQueryInst = NULL,
+    .mp_fnStartup   = &NK_COMPONENT_STARTUPFN(Capture),
+    .mp_fnShutdown  = &NK_COMPONENT_SHUTDOWNFN(Capture)
+};
+/** \endcond */
+
+
+#undef NK_NAMESPACE
+
+
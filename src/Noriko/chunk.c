@@ -0,0 +1,917 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  chunk.c
+ * \brief implements the chunk streamer, that is, the component that keeps the parts of a
+ *        world around a point of interest resident in memory
+ */
+#define NK_NAMESPACE "nk::chunk"
+
+
+/* stdlib includes */
+#include <string.h>
+#if (defined _MSC_VER)
+    #include <intrin.h>
+#endif
+
+/* Noriko includes */
+#include <include/Noriko/chunk.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/db.h>
+
+#include <include/Noriko/dstruct/htable.h>
+#include <include/Noriko/dstruct/vector.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \enum  __NkInt_ChunkState
+ * \brief lists the states a chunk can be in
+ */
+NK_NATIVE typedef enum __NkInt_ChunkState {
+    __NkInt_ChSt_Queued,  /**< waiting for the streaming thread */
+    __NkInt_ChSt_Loading, /**< currently being loaded by the streaming thread */
+    __NkInt_ChSt_Loaded,  /**< loaded, but not yet picked up by the update thread */
+    __NkInt_ChSt_Ready,   /**< tile data is valid */
+    __NkInt_ChSt_Empty    /**< there is no chunk at this position, or loading failed */
+} __NkInt_ChunkState;
+
+/**
+ * \struct __NkInt_Chunk
+ * \brief  represents a single resident chunk
+ */
+NK_NATIVE typedef struct __NkInt_Chunk {
+    NkPoint2D              m_chunkPos;    /**< position of the chunk, in chunks */
+    __NkInt_ChunkState     m_chunkState;  /**< current state (guarded by the streamer lock) */
+    NkBoolean              m_isCancelled; /**< whether the chunk left the residency radius */
+    struct __NkInt_Chunk  *mp_nextPtr;    /**< next chunk in the list the chunk is part of */
+    NkUint32              *mp_tileArr;    /**< tile data, row-major */
+    NkUint64              *mp_solidArr;   /**< collision bits, row-major; \c NULL if no tile is solid */
+} __NkInt_Chunk;
+
+/**
+ * \struct __NkInt_ChunkList
+ * \brief  represents an intrusive FIFO list of chunks
+ */
+NK_NATIVE typedef struct __NkInt_ChunkList {
+    __NkInt_Chunk *mp_headPtr; /**< first chunk */
+    __NkInt_Chunk *mp_tailPtr; /**< last chunk */
+} __NkInt_ChunkList;
+/** \endcond */
+
+
+/**
+ * \struct NkChunkStreamer
+ * \brief  internal definition of the chunk streamer
+ *
+ * The hash table and the resident vector are only ever accessed by the update thread.
+ * The streaming thread only ever touches chunks that were handed to it through the load
+ * queue. Ownership of chunks that left the residency radius is transferred to the
+ * streaming thread, which frees them.
+ */
+struct NkChunkStreamer {
+    NkChunkStreamerSpecification  m_strSpec;     /**< copy of streamer specification */
+    NkHashtable                  *mp_chunkTable; /**< resident chunks, keyed by position */
+    NkVector                     *mp_resChunks;  /**< resident chunks, for iteration */
+    __NkInt_Chunk                *mp_lastChunk;  /**< chunk of the last tile query */
+    NkSize                        m_rowWords;    /**< number of words per row of collision bits */
+    NkIDatabase                  *mp_dbConn;     /**< connection of the default loader */
+    NkISqlStatement              *mp_loadStmt;   /**< 'load chunk' statement */
+    __NkInt_ChunkList             m_loadQueue;   /**< chunks to be processed by the streaming thread */
+    __NkInt_ChunkList             m_doneList;    /**< chunks that finished loading */
+    NkBoolean                     m_isShutdown;  /**< whether the streaming thread should exit */
+
+#if (defined NK_TARGET_MULTITHREADED)
+    thrd_t                        m_strThread;   /**< streaming thread */
+    cnd_t                         m_cndVar;      /**< signaled when the load queue is not empty */
+#endif
+    NK_DECL_LOCK(m_mtxLock);                     /**< guards the lists and chunk states */
+};
+
+
+/** \cond INTERNAL */
+/**
+ * \brief  combines the chunk coordinates into a single hash table key
+ * \param  [in] chunkPos position of the chunk, in chunks
+ * \return key of the chunk
+ */
+NK_INTERNAL NK_INLINE NkUint64 __NkInt_ChunkStreamer_MakeKey(_In_ NkPoint2D chunkPos) {
+    return (NkUint64)(NkUint32)chunkPos.m_xCoord << 32 | (NkUint64)(NkUint32)chunkPos.m_yCoord;
+}
+
+/**
+ * \brief  divides and rounds towards negative infinity
+ * \param  [in] dividend dividend
+ * \param  [in] divisor divisor, must be positive
+ * \return rounded quotient
+ */
+NK_INTERNAL NK_INLINE NkInt64 __NkInt_ChunkStreamer_FloorDiv(_In_ NkInt64 dividend, _In_ NkInt64 divisor) {
+    NkInt64 const quot = dividend / divisor;
+
+    return quot - (dividend % divisor != 0 && dividend < 0);
+}
+
+/**
+ * \brief  retrieves the number of tiles in a chunk
+ * \param  [in] strPtr pointer to the chunk streamer
+ * \return number of tiles
+ */
+NK_INTERNAL NK_INLINE NkSize __NkInt_ChunkStreamer_GetTileCount(_In_ NkChunkStreamer const *strPtr) {
+    return (NkSize)(strPtr->m_strSpec.m_chunkExt.m_width * strPtr->m_strSpec.m_chunkExt.m_height);
+}
+
+/**
+ * \brief  finds the lowest set bit within a range of a bit row
+ * \param  [in] rowPtr pointer to the first word of the row
+ * \param  [in] firstBit index of the first bit of the range
+ * \param  [in] lastBit index of the last bit of the range (inclusive)
+ * \return index of the lowest set bit in the range, or \c -1 if no bit is set
+ */
+NK_INTERNAL NkInt64 __NkInt_ChunkStreamer_FindLowestBit(
+    _In_ NkUint64 const *rowPtr,
+    _In_ NkInt64 firstBit,
+    _In_ NkInt64 lastBit
+) {
+    for (NkInt64 i = firstBit >> 6; i <= lastBit >> 6; i++) {
+        NkUint64 wordVal = rowPtr[i];
+        if (i == firstBit >> 6)
+            wordVal &= ~0ULL << (firstBit & 63);
+        if (i == lastBit >> 6)
+            wordVal &= ~0ULL >> (63 - (lastBit & 63));
+        if (wordVal == 0)
+            continue;
+
+#if (defined _MSC_VER)
+        unsigned long bitInd;
+        _BitScanForward64(&bitInd, wordVal);
+
+        return i * 64 + (NkInt64)bitInd;
+#else
+        return i * 64 + (NkInt64)__builtin_ctzll(wordVal);
+#endif
+    }
+
+    return -1;
+}
+
+/**
+ * \brief  finds the highest set bit within a range of a bit row
+ * \param  [in] rowPtr pointer to the first word of the row
+ * \param  [in] firstBit index of the first bit of the range
+ * \param  [in] lastBit index of the last bit of the range (inclusive)
+ * \return index of the highest set bit in the range, or \c -1 if no bit is set
+ */
+NK_INTERNAL NkInt64 __NkInt_ChunkStreamer_FindHighestBit(
+    _In_ NkUint64 const *rowPtr,
+    _In_ NkInt64 firstBit,
+    _In_ NkInt64 lastBit
+) {
+    for (NkInt64 i = lastBit >> 6; i >= firstBit >> 6; i--) {
+        NkUint64 wordVal = rowPtr[i];
+        if (i == firstBit >> 6)
+            wordVal &= ~0ULL << (firstBit & 63);
+        if (i == lastBit >> 6)
+            wordVal &= ~0ULL >> (63 - (lastBit & 63));
+        if (wordVal == 0)
+            continue;
+
+#if (defined _MSC_VER)
+        unsigned long bitInd;
+        _BitScanReverse64(&bitInd, wordVal);
+
+        return i * 64 + (NkInt64)bitInd;
+#else
+        return i * 64 + (63 - (NkInt64)__builtin_clzll(wordVal));
+#endif
+    }
+
+    return -1;
+}
+
+/**
+ * \brief  builds the collision bits of a chunk from its tile data
+ * \param  [in] strPtr pointer to the chunk streamer
+ * \param  [in, out] chunkPtr pointer to the chunk whose tile data was just loaded
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   This function is invoked on the streaming thread.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_ChunkStreamer_BuildSolidBits(
+    _In_    NkChunkStreamer const *strPtr,
+    _Inout_ __NkInt_Chunk *chunkPtr
+) {
+    NkSize const extX     = (NkSize)strPtr->m_strSpec.m_chunkExt.m_width;
+    NkSize const extY     = (NkSize)strPtr->m_strSpec.m_chunkExt.m_height;
+    NkSize const rowWords = strPtr->m_rowWords;
+
+    NkErrorCode const errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        extY * rowWords * sizeof *chunkPtr->mp_solidArr,
+        0,
+        NK_TRUE,
+        (NkVoid **)&chunkPtr->mp_solidArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    for (NkSize y = 0; y < extY; y++) {
+        NkUint32 const *tileRow  = &chunkPtr->mp_tileArr[y * extX];
+        NkUint64       *solidRow = &chunkPtr->mp_solidArr[y * rowWords];
+
+        for (NkSize x = 0; x < extX; x++)
+            solidRow[x >> 6] |= (NkUint64)((*strPtr->m_strSpec.mp_fnSolid)(strPtr->m_strSpec.mp_extraCxt, tileRow[x]) != NK_FALSE) << (x & 63);
+    }
+    return NkErr_Ok;
+}
+
+/**
+ * \brief appends a chunk to a chunk list
+ * \param [in, out] listPtr pointer to the list
+ * \param [in, out] chunkPtr pointer to the chunk that is to be appended
+ */
+NK_INTERNAL NkVoid __NkInt_ChunkList_Push(_Inout_ __NkInt_ChunkList *listPtr, _Inout_ __NkInt_Chunk *chunkPtr) {
+    chunkPtr->mp_nextPtr = NULL;
+
+    if (listPtr->mp_tailPtr != NULL)
+        listPtr->mp_tailPtr->mp_nextPtr = chunkPtr;
+    else
+        listPtr->mp_headPtr = chunkPtr;
+    listPtr->mp_tailPtr = chunkPtr;
+}
+
+/**
+ * \brief  removes the first chunk from a chunk list
+ * \param  [in, out] listPtr pointer to the list
+ * \return pointer to the removed chunk, or \c NULL if the list is empty
+ */
+NK_INTERNAL __NkInt_Chunk *__NkInt_ChunkList_Pop(_Inout_ __NkInt_ChunkList *listPtr) {
+    __NkInt_Chunk *chunkPtr = listPtr->mp_headPtr;
+    if (chunkPtr == NULL)
+        return NULL;
+
+    listPtr->mp_headPtr = chunkPtr->mp_nextPtr;
+    if (listPtr->mp_headPtr == NULL)
+        listPtr->mp_tailPtr = NULL;
+
+    chunkPtr->mp_nextPtr = NULL;
+    return chunkPtr;
+}
+
+/**
+ * \brief frees a chunk and its tile data
+ * \param [in, out] chunkPtr pointer to the chunk that is to be freed
+ */
+NK_INTERNAL NkVoid __NkInt_ChunkStreamer_FreeChunk(_Inout_ __NkInt_Chunk *chunkPtr) {
+    NkGPFree(chunkPtr->mp_solidArr);
+    NkGPFree(chunkPtr->mp_tileArr);
+    NkGPFree(chunkPtr);
+}
+
+/**
+ * \struct __NkInt_ChunkDbLoadContext
+ * \brief  context passed to the result iterator of the 'load chunk' statement
+ */
+NK_NATIVE typedef struct __NkInt_ChunkDbLoadContext {
+    NkSize      m_nTiles;   /**< number of tiles expected */
+    NkUint32   *mp_tileArr; /**< destination array */
+    NkErrorCode m_errCode;  /**< result of the load operation */
+} __NkInt_ChunkDbLoadContext;
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ChunkStreamer_DbLoadIterFn(
+    _In_                 NkUint32 colCount,
+    _In_reads_(colCount) NkVariant const *colResArr,
+    _Inout_opt_          NkVoid *extraCxtPtr
+) {
+    NK_ASSERT(colCount > 0, NkErr_InParameter);
+    NK_ASSERT(colResArr != NULL, NkErr_InParameter);
+    NK_ASSERT(extraCxtPtr != NULL, NkErr_InOutParameter);
+
+    __NkInt_ChunkDbLoadContext *loadCxt = (__NkInt_ChunkDbLoadContext *)extraCxtPtr;
+
+    /* The tile data must be a blob that holds exactly one chunk. */
+    NkVariantType varTy;
+    NkBufferView  blobView;
+    NkVariantGet(&colResArr[0], &varTy, &blobView);
+    if (varTy != NkVarTy_BufferView || blobView.m_sizeInBytes != loadCxt->m_nTiles * sizeof(NkUint32)) {
+        loadCxt->m_errCode = NkErr_UnsupportedFileFormat;
+
+        return NkErr_ManuallyAborted;
+    }
+
+    memcpy(loadCxt->mp_tileArr, blobView.mp_dataPtr, blobView.m_sizeInBytes);
+    loadCxt->m_errCode = NkErr_Ok;
+    return NkErr_ManuallyAborted;
+}
+
+/**
+ * \brief  loads a chunk from the asset database
+ * \param  [in, out] strPtr pointer to the chunk streamer
+ * \param  [in] chunkPos position of the chunk, in chunks
+ * \param  [out] tileArr array that receives the tile data
+ * \return \c NkErr_Ok if the chunk was loaded, \c NkErr_NoOperation if the chunk does
+ *         not exist, non-zero on failure
+ * \note   This function is invoked on the streaming thread.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_ChunkStreamer_LoadFromDatabase(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D chunkPos,
+    _Out_   NkUint32 *tileArr
+) {
+    __NkInt_ChunkDbLoadContext loadCxt = {
+        .m_nTiles   = __NkInt_ChunkStreamer_GetTileCount(strPtr),
+        .mp_tileArr = tileArr,
+        .m_errCode  = NkErr_NoOperation
+    };
+
+    /* Bind world UUID and chunk coordinates. */
+    NkVariant paramVar;
+    NkVariantSet(&paramVar, NkVarTy_Uuid, &strPtr->m_strSpec.m_worldUuid);
+    strPtr->mp_loadStmt->VT->Bind(strPtr->mp_loadStmt, 1U, &paramVar);
+    NkVariantSet(&paramVar, NkVarTy_Int64, chunkPos.m_xCoord);
+    strPtr->mp_loadStmt->VT->Bind(strPtr->mp_loadStmt, 2U, &paramVar);
+    NkVariantSet(&paramVar, NkVarTy_Int64, chunkPos.m_yCoord);
+    strPtr->mp_loadStmt->VT->Bind(strPtr->mp_loadStmt, 3U, &paramVar);
+
+    /* Run the query; the iterator copies the data if a row was found. */
+    NkErrorCode errCode = strPtr->mp_dbConn->VT->Execute(
+        strPtr->mp_dbConn,
+        strPtr->mp_loadStmt,
+        &__NkInt_ChunkStreamer_DbLoadIterFn,
+        (NkVoid *)&loadCxt
+    );
+    for (NkUint32 i = 1U; i <= 3U; i++)
+        strPtr->mp_loadStmt->VT->Unbind(strPtr->mp_loadStmt, i);
+
+    return errCode != NkErr_Ok && errCode != NkErr_ManuallyAborted ? errCode : loadCxt.m_errCode;
+}
+
+/**
+ * \brief loads the given chunk and hands it back to the update thread
+ * \param [in, out] strPtr pointer to the chunk streamer
+ * \param [in, out] chunkPtr pointer to the chunk that is to be loaded
+ * \note  The streamer lock must not be held by the caller.
+ */
+NK_INTERNAL NkVoid __NkInt_ChunkStreamer_ProcessChunk(_Inout_ NkChunkStreamer *strPtr, _Inout_ __NkInt_Chunk *chunkPtr) {
+    /* Load the chunk data without holding the lock. */
+    NkErrorCode errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        __NkInt_ChunkStreamer_GetTileCount(strPtr) * sizeof(NkUint32),
+        0,
+        NK_FALSE,
+        (NkVoid **)&chunkPtr->mp_tileArr
+    );
+    if (errCode == NkErr_Ok)
+        errCode = strPtr->m_strSpec.mp_fnLoad != NULL
+            ? (*strPtr->m_strSpec.mp_fnLoad)(
+                strPtr->m_strSpec.mp_extraCxt,
+                chunkPtr->m_chunkPos,
+                __NkInt_ChunkStreamer_GetTileCount(strPtr),
+                chunkPtr->mp_tileArr
+            )
+            : __NkInt_ChunkStreamer_LoadFromDatabase(strPtr, chunkPtr->m_chunkPos, chunkPtr->mp_tileArr)
+        ;
+    /* Build the collision bits while the tile data is still in the cache. */
+    if (errCode == NkErr_Ok && strPtr->m_strSpec.mp_fnSolid != NULL)
+        errCode = __NkInt_ChunkStreamer_BuildSolidBits(strPtr, chunkPtr);
+    if (errCode != NkErr_Ok && errCode != NkErr_NoOperation)
+        NK_LOG_ERROR(
+            "Failed to load chunk (%lli, %lli). Reason: %s (%i)",
+            chunkPtr->m_chunkPos.m_xCoord,
+            chunkPtr->m_chunkPos.m_yCoord,
+            NkGetErrorCodeStr(errCode)->mp_dataPtr,
+            (int)errCode
+        );
+    if (errCode != NkErr_Ok) {
+        /* Chunks that could not be loaded are kept resident as empty chunks. */
+        NkGPFree(chunkPtr->mp_solidArr);
+        NkGPFree(chunkPtr->mp_tileArr);
+
+        chunkPtr->mp_solidArr = NULL;
+        chunkPtr->mp_tileArr  = NULL;
+    }
+
+    /* Hand the chunk back, unless it was cancelled in the meantime. */
+    NK_LOCK(strPtr->m_mtxLock);
+    NkBoolean const isCancelled = chunkPtr->m_isCancelled;
+    if (!isCancelled) {
+        chunkPtr->m_chunkState = __NkInt_ChSt_Loaded;
+
+        __NkInt_ChunkList_Push(&strPtr->m_doneList, chunkPtr);
+    }
+    NK_UNLOCK(strPtr->m_mtxLock);
+
+    if (isCancelled)
+        __NkInt_ChunkStreamer_FreeChunk(chunkPtr);
+}
+
+#if (defined NK_TARGET_MULTITHREADED)
+/**
+ * \brief  entry point of the streaming thread
+ * \param  [in, out] extraCxt pointer to the chunk streamer
+ * \return always \c 0
+ */
+NK_INTERNAL int __NkInt_ChunkStreamer_ThreadProc(_Inout_ NkVoid *extraCxt) {
+    NkChunkStreamer *strPtr = (NkChunkStreamer *)extraCxt;
+
+    NK_LOCK(strPtr->m_mtxLock);
+    for (;;) {
+        while (strPtr->m_loadQueue.mp_headPtr == NULL && !strPtr->m_isShutdown)
+            cnd_wait(&strPtr->m_cndVar, &strPtr->m_mtxLock);
+        if (strPtr->m_isShutdown)
+            break;
+
+        /* Chunks that were cancelled are freed right away. */
+        __NkInt_Chunk *chunkPtr = __NkInt_ChunkList_Pop(&strPtr->m_loadQueue);
+        if (chunkPtr->m_isCancelled) {
+            NK_UNLOCK(strPtr->m_mtxLock);
+            __NkInt_ChunkStreamer_FreeChunk(chunkPtr);
+            NK_LOCK(strPtr->m_mtxLock);
+
+            continue;
+        }
+        chunkPtr->m_chunkState = __NkInt_ChSt_Loading;
+        NK_UNLOCK(strPtr->m_mtxLock);
+
+        __NkInt_ChunkStreamer_ProcessChunk(strPtr, chunkPtr);
+        NK_LOCK(strPtr->m_mtxLock);
+    }
+    NK_UNLOCK(strPtr->m_mtxLock);
+
+    NkAllocReleaseThreadCache();
+    return 0;
+}
+#endif
+
+/**
+ * \brief hands a chunk to the streaming thread for loading or freeing
+ * \param [in, out] strPtr pointer to the chunk streamer
+ * \param [in, out] chunkPtr pointer to the chunk
+ * \note  The streamer lock must be held by the caller. In single-threaded builds, the
+ *        lock is a no-op and the chunk is processed immediately.
+ */
+NK_INTERNAL NkVoid __NkInt_ChunkStreamer_Submit(_Inout_ NkChunkStreamer *strPtr, _Inout_ __NkInt_Chunk *chunkPtr) {
+#if (defined NK_TARGET_MULTITHREADED)
+    __NkInt_ChunkList_Push(&strPtr->m_loadQueue, chunkPtr);
+
+    cnd_signal(&strPtr->m_cndVar);
+#else
+    if (chunkPtr->m_isCancelled)
+        __NkInt_ChunkStreamer_FreeChunk(chunkPtr);
+    else
+        __NkInt_ChunkStreamer_ProcessChunk(strPtr, chunkPtr);
+#endif
+}
+
+/**
+ * \brief  makes the chunk at the given position resident if it is not already
+ * \param  [in, out] strPtr pointer to the chunk streamer
+ * \param  [in] chunkPos position of the chunk, in chunks
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The streamer lock must be held by the caller.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_ChunkStreamer_RequestChunk(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D chunkPos
+) {
+    NkHashtableKey const chunkKey = { .m_uint64Key = __NkInt_ChunkStreamer_MakeKey(chunkPos) };
+    if (NkHashtableContains(strPtr->mp_chunkTable, &chunkKey))
+        return NkErr_Ok;
+
+    /* Create a new chunk and queue it for loading. */
+    __NkInt_Chunk *chunkPtr;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *chunkPtr, 0, NK_TRUE, (NkVoid **)&chunkPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    chunkPtr->m_chunkPos   = chunkPos;
+    chunkPtr->m_chunkState = __NkInt_ChSt_Queued;
+
+    if ((errCode = NkHashtableInsert(strPtr->mp_chunkTable, &(NkHashtablePair const){ chunkKey, chunkPtr })) != NkErr_Ok) {
+        NkGPFree(chunkPtr);
+
+        return errCode;
+    }
+    if ((errCode = NkVectorInsert(strPtr->mp_resChunks, chunkPtr, NK_VECTOR_END(strPtr->mp_resChunks))) != NkErr_Ok) {
+        NK_IGNORE_RETURN_VALUE(NkHashtableErase(strPtr->mp_chunkTable, &chunkKey));
+        NkGPFree(chunkPtr);
+
+        return errCode;
+    }
+
+    __NkInt_ChunkStreamer_Submit(strPtr, chunkPtr);
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  retrieves a resident chunk whose tile data is ready
+ * \param  [in, out] strPtr pointer to the chunk streamer
+ * \param  [in] chunkPos position of the chunk, in chunks
+ * \return pointer to the chunk, or \c NULL if it is not resident or not ready
+ * \note   This function must be called from the thread that updates the streamer.
+ */
+NK_INTERNAL __NkInt_Chunk *__NkInt_ChunkStreamer_FindReadyChunk(_Inout_ NkChunkStreamer *strPtr, _In_ NkPoint2D chunkPos) {
+    /* Consecutive queries usually hit the same chunk. */
+    __NkInt_Chunk *chunkPtr = strPtr->mp_lastChunk;
+    if (   chunkPtr == NULL
+        || chunkPtr->m_chunkPos.m_xCoord != chunkPos.m_xCoord
+        || chunkPtr->m_chunkPos.m_yCoord != chunkPos.m_yCoord
+    ) {
+        NkErrorCode errCode = NkHashtableAt(
+            strPtr->mp_chunkTable,
+            &(NkHashtableKey const){ .m_uint64Key = __NkInt_ChunkStreamer_MakeKey(chunkPos) },
+            (NkVoid **)&chunkPtr
+        );
+        if (errCode != NkErr_Ok)
+            return NULL;
+
+        strPtr->mp_lastChunk = chunkPtr;
+    }
+
+    /*
+     * The state of resident chunks only ever becomes 'ready' on the update thread, so it
+     * can be read without locking here.
+     */
+    return chunkPtr->m_chunkState == __NkInt_ChSt_Ready ? chunkPtr : NULL;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkChunkStreamerCreate(
+    _In_       NkChunkStreamerSpecification const *strSpec,
+    _Init_ptr_ NkChunkStreamer **strPtr
+) {
+    NK_ASSERT(strSpec != NULL && strSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(strSpec->m_chunkExt.m_width > 0 && strSpec->m_chunkExt.m_height > 0, NkErr_InParameter);
+    NK_ASSERT(strSpec->mp_fnLoad != NULL || strSpec->mp_dbPath != NULL, NkErr_InParameter);
+    NK_ASSERT(strPtr != NULL, NkErr_OutptrParameter);
+
+    /* Allocate memory for the streamer. */
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **strPtr, 0, NK_TRUE, (NkVoid **)strPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkChunkStreamer *actStr = *strPtr;
+    actStr->m_strSpec  = *strSpec;
+    actStr->m_rowWords = (NkSize)(strSpec->m_chunkExt.m_width + 63) / 64;
+
+    /* Create the containers for resident chunks. */
+    errCode = NkHashtableCreate(&(NkHashtableProperties const){
+        .m_structSize  = sizeof(NkHashtableProperties),
+        .m_initCap     = 64,
+        .m_minCap      = 16,
+        .m_maxCap      = UINT32_MAX - 2,
+        .m_keyType     = NkHtKeyTy_Uint64,
+        .mp_fnElemFree = NULL
+    }, &actStr->mp_chunkTable);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+    errCode = NkVectorCreate(&(NkVectorProperties const){
+        .m_structSize = sizeof(NkVectorProperties),
+        .m_initialCap = 32,
+        .m_minCap     = 8,
+        .m_maxCap     = SIZE_MAX - 2,
+        .m_growFactor = 1.5f
+    }, NULL, &actStr->mp_resChunks);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+
+    /*
+     * The default loader uses a dedicated read-only connection that is only ever used by
+     * the streaming thread, so the queries never contend with the asset manager's.
+     */
+    if (strSpec->mp_fnLoad == NULL) {
+        errCode = NkOMCreateInstance(
+            NKOM_CLSIDOF(NkIDatabase),
+            NULL,
+            NKOM_IIDOF(NkIDatabase),
+            NULL,
+            (NkIBase **)&actStr->mp_dbConn
+        );
+        if (errCode != NkErr_Ok)
+            goto lbl_ONERROR;
+        if ((errCode = actStr->mp_dbConn->VT->Open(actStr->mp_dbConn, strSpec->mp_dbPath, NkDbMode_ReadOnly, NULL)) != NkErr_Ok)
+            goto lbl_ONERROR;
+
+        errCode = actStr->mp_dbConn->VT->CreateStatement(
+            actStr->mp_dbConn,
+            "SELECT data FROM chunks WHERE world = ? AND x = ? AND y = ?",
+            &actStr->mp_loadStmt
+        );
+        if (errCode != NkErr_Ok)
+            goto lbl_ONERROR;
+    }
+
+    /* Start the streaming thread. */
+    if (NK_INITLOCK(actStr->m_mtxLock) != thrd_success) {
+        errCode = NkErr_SynchInit;
+
+        goto lbl_ONERROR;
+    }
+#if (defined NK_TARGET_MULTITHREADED)
+    if (cnd_init(&actStr->m_cndVar) != thrd_success) {
+        NK_DESTROYLOCK(actStr->m_mtxLock);
+
+        errCode = NkErr_SynchInit;
+        goto lbl_ONERROR;
+    }
+    if (thrd_create(&actStr->m_strThread, &__NkInt_ChunkStreamer_ThreadProc, (NkVoid *)actStr) != thrd_success) {
+        cnd_destroy(&actStr->m_cndVar);
+        NK_DESTROYLOCK(actStr->m_mtxLock);
+
+        errCode = NkErr_CreateThread;
+        goto lbl_ONERROR;
+    }
+#endif
+
+    /* All good. */
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    if (actStr->mp_loadStmt != NULL)
+        actStr->mp_loadStmt->VT->Release(actStr->mp_loadStmt);
+    if (actStr->mp_dbConn != NULL)
+        actStr->mp_dbConn->VT->Release(actStr->mp_dbConn);
+    NkVectorDestroy(&actStr->mp_resChunks);
+    NkHashtableDestroy(&actStr->mp_chunkTable);
+    NkGPFree(actStr);
+
+    *strPtr = NULL;
+    return errCode;
+}
+
+NkVoid NK_CALL NkChunkStreamerDestroy(_Uninit_ptr_ NkChunkStreamer **strPtr) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+
+    if (*strPtr == NULL)
+        return;
+    NkChunkStreamer *actStr = *strPtr;
+
+#if (defined NK_TARGET_MULTITHREADED)
+    /* Wait for the streaming thread to finish the chunk it is currently loading. */
+    NK_LOCK(actStr->m_mtxLock);
+    actStr->m_isShutdown = NK_TRUE;
+    cnd_signal(&actStr->m_cndVar);
+    NK_UNLOCK(actStr->m_mtxLock);
+    thrd_join(actStr->m_strThread, NULL);
+
+    cnd_destroy(&actStr->m_cndVar);
+#endif
+    NK_DESTROYLOCK(actStr->m_mtxLock);
+
+    /*
+     * Chunks that are still queued are either resident (and freed below) or cancelled,
+     * in which case they are owned by the queue.
+     */
+    for (__NkInt_Chunk *chunkPtr; (chunkPtr = __NkInt_ChunkList_Pop(&actStr->m_loadQueue)) != NULL;)
+        if (chunkPtr->m_isCancelled)
+            __NkInt_ChunkStreamer_FreeChunk(chunkPtr);
+    /* Free all resident chunks. */
+    for (NkSize i = 0; i < NkVectorGetElementCount(actStr->mp_resChunks); i++)
+        __NkInt_ChunkStreamer_FreeChunk((__NkInt_Chunk *)NkVectorAt(actStr->mp_resChunks, i));
+    NkVectorDestroy(&actStr->mp_resChunks);
+    NkHashtableDestroy(&actStr->mp_chunkTable);
+
+    /* Close the connection of the default loader. */
+    if (actStr->mp_loadStmt != NULL)
+        actStr->mp_loadStmt->VT->Release(actStr->mp_loadStmt);
+    if (actStr->mp_dbConn != NULL)
+        actStr->mp_dbConn->VT->Release(actStr->mp_dbConn);
+
+    NkGPFree(actStr);
+    *strPtr = NULL;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkChunkStreamerUpdate(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D centerChunk
+) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+
+    NkInt64 const resRadius = (NkInt64)strPtr->m_strSpec.m_resRadius;
+    NkErrorCode   errCode   = NkErr_Ok;
+
+    NK_LOCK(strPtr->m_mtxLock);
+    /*
+     * Pick up all chunks the streaming thread finished in the meantime. This must happen
+     * before evicting chunks as evicted chunks are handed to the streaming thread.
+     */
+    for (__NkInt_Chunk *chunkPtr; (chunkPtr = __NkInt_ChunkList_Pop(&strPtr->m_doneList)) != NULL;) {
+        chunkPtr->m_chunkState = chunkPtr->mp_tileArr != NULL ? __NkInt_ChSt_Ready : __NkInt_ChSt_Empty;
+
+        if (chunkPtr->m_chunkState == __NkInt_ChSt_Ready && strPtr->m_strSpec.mp_fnReady != NULL)
+            (*strPtr->m_strSpec.mp_fnReady)(strPtr->m_strSpec.mp_extraCxt, chunkPtr->m_chunkPos);
+    }
+
+    /* Evict chunks that are too far away. */
+    for (NkSize i = NkVectorGetElementCount(strPtr->mp_resChunks); i-- > 0;) {
+        __NkInt_Chunk *chunkPtr = (__NkInt_Chunk *)NkVectorAt(strPtr->mp_resChunks, i);
+
+        NkInt64 const distX = chunkPtr->m_chunkPos.m_xCoord - centerChunk.m_xCoord;
+        NkInt64 const distY = chunkPtr->m_chunkPos.m_yCoord - centerChunk.m_yCoord;
+        if (NK_MAX(distX < 0 ? -distX : distX, distY < 0 ? -distY : distY) <= resRadius + 1)
+            continue;
+
+        NK_IGNORE_RETURN_VALUE(NkVectorErase(strPtr->mp_resChunks, i, NULL));
+        NK_IGNORE_RETURN_VALUE(NkHashtableErase(
+            strPtr->mp_chunkTable,
+            &(NkHashtableKey const){ .m_uint64Key = __NkInt_ChunkStreamer_MakeKey(chunkPtr->m_chunkPos) }
+        ));
+        if (strPtr->mp_lastChunk == chunkPtr)
+            strPtr->mp_lastChunk = NULL;
+
+        /*
+         * Chunks that are waiting for or being processed by the streaming thread will be
+         * freed by it once it gets to them. All others are handed to it for freeing.
+         */
+        chunkPtr->m_isCancelled = NK_TRUE;
+        if (chunkPtr->m_chunkState != __NkInt_ChSt_Queued && chunkPtr->m_chunkState != __NkInt_ChSt_Loading)
+            __NkInt_ChunkStreamer_Submit(strPtr, chunkPtr);
+    }
+
+    /* Request missing chunks, ring by ring so that close chunks are loaded first. */
+    for (NkInt64 ringInd = 0; ringInd <= resRadius && errCode == NkErr_Ok; ringInd++)
+        for (NkInt64 y = -ringInd; y <= ringInd && errCode == NkErr_Ok; y++)
+            for (NkInt64 x = -ringInd; x <= ringInd && errCode == NkErr_Ok; x++) {
+                if (NK_MAX(x < 0 ? -x : x, y < 0 ? -y : y) != ringInd)
+                    continue;
+
+                errCode = __NkInt_ChunkStreamer_RequestChunk(
+                    strPtr,
+                    (NkPoint2D){ centerChunk.m_xCoord + x, centerChunk.m_yCoord + y }
+                );
+            }
+    NK_UNLOCK(strPtr->m_mtxLock);
+
+    return errCode;
+}
+
+NkBoolean NK_CALL NkChunkStreamerQueryTile(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D tilePos,
+    _Out_   NkUint32 *tileVal
+) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(tileVal != NULL, NkErr_OutParameter);
+
+    NkPoint2D const chunkPos = NkChunkStreamerGetChunkPos(strPtr, tilePos);
+    __NkInt_Chunk  *chunkPtr = __NkInt_ChunkStreamer_FindReadyChunk(strPtr, chunkPos);
+    if (chunkPtr == NULL)
+        return NK_FALSE;
+
+    NkInt64 const extX  = (NkInt64)strPtr->m_strSpec.m_chunkExt.m_width;
+    NkInt64 const extY  = (NkInt64)strPtr->m_strSpec.m_chunkExt.m_height;
+    NkInt64 const localX = tilePos.m_xCoord - chunkPos.m_xCoord * extX;
+    NkInt64 const localY = tilePos.m_yCoord - chunkPos.m_yCoord * extY;
+
+    *tileVal = chunkPtr->mp_tileArr[localY * extX + localX];
+    return NK_TRUE;
+}
+
+NkBoolean NK_CALL NkChunkStreamerIsBlocked(_Inout_ NkChunkStreamer *strPtr, _In_ NkPoint2D tilePos) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+
+    NkPoint2D const chunkPos = NkChunkStreamerGetChunkPos(strPtr, tilePos);
+    __NkInt_Chunk  *chunkPtr = __NkInt_ChunkStreamer_FindReadyChunk(strPtr, chunkPos);
+    if (chunkPtr == NULL)
+        return NK_TRUE;
+    if (chunkPtr->mp_solidArr == NULL)
+        return NK_FALSE;
+
+    NkInt64 const localX = tilePos.m_xCoord - chunkPos.m_xCoord * (NkInt64)strPtr->m_strSpec.m_chunkExt.m_width;
+    NkInt64 const localY = tilePos.m_yCoord - chunkPos.m_yCoord * (NkInt64)strPtr->m_strSpec.m_chunkExt.m_height;
+    return (NkBoolean)(chunkPtr->mp_solidArr[(NkSize)localY * strPtr->m_rowWords + (NkSize)(localX >> 6)] >> (localX & 63) & 1);
+}
+
+NkUint32 NK_CALL NkChunkStreamerSweepTiles(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D startPos,
+    _In_    NkPoint2D stepDir,
+    _In_    NkUint32 maxSteps
+) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(
+        (stepDir.m_xCoord == 0) != (stepDir.m_yCoord == 0)
+            && stepDir.m_xCoord >= -1 && stepDir.m_xCoord <= 1
+            && stepDir.m_yCoord >= -1 && stepDir.m_yCoord <= 1,
+        NkErr_InParameter
+    );
+
+    NkInt64 const   extX    = (NkInt64)strPtr->m_strSpec.m_chunkExt.m_width;
+    NkInt64 const   extY    = (NkInt64)strPtr->m_strSpec.m_chunkExt.m_height;
+    NkBoolean const isHorz  = stepDir.m_xCoord != 0;
+    NkInt64 const   stepVal = isHorz ? stepDir.m_xCoord : stepDir.m_yCoord;
+
+    /* Walk chunk by chunk; every iteration handles the part of the sweep in one chunk. */
+    NkUint32 nSteps = 0;
+    while (nSteps < maxSteps) {
+        NkPoint2D const nextPos  = {
+            startPos.m_xCoord + stepDir.m_xCoord * (NkInt64)(nSteps + 1),
+            startPos.m_yCoord + stepDir.m_yCoord * (NkInt64)(nSteps + 1)
+        };
+        NkPoint2D const chunkPos = NkChunkStreamerGetChunkPos(strPtr, nextPos);
+        __NkInt_Chunk  *chunkPtr = __NkInt_ChunkStreamer_FindReadyChunk(strPtr, chunkPos);
+        if (chunkPtr == NULL)
+            break;
+
+        NkInt64 const  localX  = nextPos.m_xCoord - chunkPos.m_xCoord * extX;
+        NkInt64 const  localY  = nextPos.m_yCoord - chunkPos.m_yCoord * extY;
+        NkInt64 const  localI  = isHorz ? localX : localY;
+        NkInt64 const  toEdge  = stepVal > 0 ? (isHorz ? extX : extY) - localI : localI + 1;
+        NkUint32 const nSpan   = (NkUint32)NK_MIN((NkInt64)(maxSteps - nSteps), toEdge);
+        if (chunkPtr->mp_solidArr == NULL) {
+            nSteps += nSpan;
+
+            continue;
+        }
+
+        if (isHorz) {
+            /* Test the whole span of the row at once. */
+            NkUint64 const *rowPtr   = &chunkPtr->mp_solidArr[(NkSize)localY * strPtr->m_rowWords];
+            NkInt64 const   firstBit = stepVal > 0 ? localX : localX - (NkInt64)nSpan + 1;
+            NkInt64 const   lastBit  = firstBit + (NkInt64)nSpan - 1;
+
+            NkInt64 const bitInd = stepVal > 0
+                ? __NkInt_ChunkStreamer_FindLowestBit(rowPtr, firstBit, lastBit)
+                : __NkInt_ChunkStreamer_FindHighestBit(rowPtr, firstBit, lastBit)
+            ;
+            if (bitInd >= 0)
+                return nSteps + (NkUint32)(stepVal > 0 ? bitInd - localX : localX - bitInd);
+        } else {
+            NkUint64 const *colPtr  = &chunkPtr->mp_solidArr[(NkSize)(localX >> 6)];
+            NkUint64 const  bitMask = 1ULL << (localX & 63);
+
+            for (NkUint32 i = 0; i < nSpan; i++)
+                if (colPtr[(NkSize)(localY + stepVal * (NkInt64)i) * strPtr->m_rowWords] & bitMask)
+                    return nSteps + i;
+        }
+        nSteps += nSpan;
+    }
+
+    return nSteps;
+}
+
+NkVoid NK_CALL NkChunkStreamerCopySolidBits(
+    _Inout_ NkChunkStreamer *strPtr,
+    _In_    NkPoint2D regOrigin,
+    _In_    NkSize2D regExt,
+    _In_    NkSize rowWords,
+    _Out_   NkUint64 *bitArr
+) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(rowWords >= (regExt.m_width + 63) / 64, NkErr_InParameter);
+    NK_ASSERT(bitArr != NULL, NkErr_OutParameter);
+
+    NkInt64 const extX = (NkInt64)strPtr->m_strSpec.m_chunkExt.m_width;
+    NkInt64 const extY = (NkInt64)strPtr->m_strSpec.m_chunkExt.m_height;
+    memset(bitArr, 0, (NkSize)regExt.m_height * rowWords * sizeof *bitArr);
+
+    /* Copy row by row; every inner iteration handles the part of a row in one chunk. */
+    for (NkInt64 y = 0; y < (NkInt64)regExt.m_height; y++) {
+        NkUint64 *dstRow = &bitArr[(NkSize)y * rowWords];
+
+        for (NkInt64 x = 0; x < (NkInt64)regExt.m_width;) {
+            NkPoint2D const tilePos  = { regOrigin.m_xCoord + x, regOrigin.m_yCoord + y };
+            NkPoint2D const chunkPos = NkChunkStreamerGetChunkPos(strPtr, tilePos);
+            __NkInt_Chunk  *chunkPtr = __NkInt_ChunkStreamer_FindReadyChunk(strPtr, chunkPos);
+
+            NkInt64 const localX = tilePos.m_xCoord - chunkPos.m_xCoord * extX;
+            NkInt64 const localY = tilePos.m_yCoord - chunkPos.m_yCoord * extY;
+            NkInt64 const nSpan  = NK_MIN(extX - localX, (NkInt64)regExt.m_width - x);
+            if (chunkPtr == NULL || chunkPtr->mp_solidArr != NULL) {
+                NkUint64 const *srcRow = chunkPtr != NULL ? &chunkPtr->mp_solidArr[(NkSize)localY * strPtr->m_rowWords] : NULL;
+
+                for (NkInt64 i = 0; i < nSpan; i++) {
+                    NkUint64 const isSolid = srcRow != NULL ? srcRow[(localX + i) >> 6] >> ((localX + i) & 63) & 1 : 1;
+
+                    dstRow[(x + i) >> 6] |= isSolid << ((x + i) & 63);
+                }
+            }
+            x += nSpan;
+        }
+    }
+}
+
+NkPoint2D NK_CALL NkChunkStreamerGetChunkPos(_In_ NkChunkStreamer const *strPtr, _In_ NkPoint2D tilePos) {
+    NK_ASSERT(strPtr != NULL, NkErr_InParameter);
+
+    return (NkPoint2D){
+        __NkInt_ChunkStreamer_FloorDiv(tilePos.m_xCoord, (NkInt64)strPtr->m_strSpec.m_chunkExt.m_width),
+        __NkInt_ChunkStreamer_FloorDiv(tilePos.m_yCoord, (NkInt64)strPtr->m_strSpec.m_chunkExt.m_height)
+    };
+}
+
+
+#undef NK_NAMESPACE
+
+
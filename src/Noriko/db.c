@@ -34,12 +34,37 @@
 #include <include/Noriko/comp.h>
 
 #include <include/Noriko/dstruct/string.h>
+#include <include/Noriko/dstruct/htable.h>
 
 /* sqlite3 includes */
 #include <ext/sqlite3/sqlite3.h>
 
 
 /** cond INTERNAL */
+/**
+ * \def   __NkInt_Sqlite3DbHandle_StmtCacheCap
+ * \brief maximum number of idle prepared statements kept by a single database connection
+ */
+#define __NkInt_Sqlite3DbHandle_StmtCacheCap ((NkUint32)32)
+
+
+/**
+ * \struct __NkInt_Sqlite3CachedStmt
+ * \brief  represents a prepared sqlite3 statement together with the SQL text it was
+ *         compiled from
+ *
+ * While a statement is in use, it belongs to its user and is not part of the cache. When
+ * it is given back, it is reset and becomes idle. Idle entries are kept in a
+ * doubly-linked list in the order they were last used, so that the least recently used
+ * statements can be finalized first.
+ */
+NK_NATIVE typedef struct __NkInt_Sqlite3CachedStmt {
+    char                             *mp_sqlStr;    /**< SQL text; key of the entry */
+    sqlite3_stmt                     *mp_stmtPtr;   /**< prepared statement */
+    struct __NkInt_Sqlite3CachedStmt *mp_prevEntry; /**< more recently used entry */
+    struct __NkInt_Sqlite3CachedStmt *mp_nextEntry; /**< less recently used entry */
+} __NkInt_Sqlite3CachedStmt;
+
 /**
  * \struct __NkInt_Sqlite3Stmt
  * \brief  represents the internal state of a cacheable sqlite3 statement object
@@ -47,9 +72,10 @@
 NK_NATIVE typedef struct __NkInt_Sqlite3Stmt {
     NKOM_IMPLEMENTS(NkISqlStatement);
 
-    NkOMRefCount  m_refCount; /**< reference count */
-    NkIDatabase  *mp_dbConn;  /**< parent database connection */
-    sqlite3_stmt *mp_stmtPtr; /**< pointer to the prepared sqlite3 statement */
+    NkOMRefCount volatile      m_refCount;  /**< reference count */
+    NkIDatabase               *mp_dbConn;   /**< parent database connection */
+    sqlite3_stmt              *mp_stmtPtr;  /**< pointer to the prepared sqlite3 statement */
+    __NkInt_Sqlite3CachedStmt *mp_cacheEnt; /**< cache entry owning <tt>mp_stmtPtr</tt> */
 } __NkInt_Sqlite3Stmt;
 
 /**
@@ -59,9 +85,15 @@ NK_NATIVE typedef struct __NkInt_Sqlite3Stmt {
 NK_NATIVE typedef struct __NkInt_Sqlite3DbHandle {
     NKOM_IMPLEMENTS(NkIDatabase);
 
-    NkOMRefCount    m_refCount; /**< reference count */
-    NkDatabaseMode  m_dbMode;   /**< database access mode */
-    sqlite3        *mp_dbConn;  /**< sqlite3 database connection object */
+    NkOMRefCount volatile  m_refCount; /**< reference count */
+    NkDatabaseMode         m_dbMode;   /**< database access mode */
+    sqlite3               *mp_dbConn;  /**< sqlite3 database connection object */
+
+    NkHashtable               *mp_stmtCache; /**< idle prepared statements, keyed by SQL text */
+    __NkInt_Sqlite3CachedStmt *mp_lruHead;   /**< most recently used idle statement */
+    __NkInt_Sqlite3CachedStmt *mp_lruTail;   /**< least recently used idle statement */
+    NkUint32                   m_nCached;    /**< number of idle statements */
+    NkUint32                   m_txDepth;    /**< number of open (nested) transactions */
 } __NkInt_Sqlite3DbHandle;
 
 /**
@@ -70,7 +102,6 @@ NK_NATIVE typedef struct __NkInt_Sqlite3DbHandle {
  */
 NK_NATIVE typedef struct __NkInt_Sqlite3StmtInit {
     char        *mp_sqlStr;     /**< raw UTF-8 SQL string */
-    sqlite3     *mp_dbConn;     /**< sqlite3 database connection handle */
     NkIDatabase *mp_nkomDbConn; /**< Noriko database handle (used as parent) */
 } __NkInt_Sqlite3StmtInit;
 
@@ -108,10 +139,12 @@ NK_INTERNAL NkBoolean __NkInt_Sqlite3Stmt_IsValidParamIndex(_Inout_ sqlite3_stmt
  */
 NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Sqlite3DbHandle_SetPragmas(
     _Inout_ sqlite3 *dbConnRef,
-    _In_    NkDatabaseMode mode
+    _In_    NkDatabaseMode mode,
+    _In_    NkDatabaseOptions const *optsPtr
 ) {
     NK_ASSERT(dbConnRef != NULL, NkErr_InOutParameter);
     NK_ASSERT(mode > NkDbMode_Unknown && mode < __NkDbMode_Count__, NkErr_InParameter);
+    NK_ASSERT(optsPtr != NULL, NkErr_InParameter);
 
     /**
      * \brief pragmas to set for read-only database connections
@@ -129,15 +162,70 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Sqlite3DbHandle_SetPragmas(
         "PRAGMA query_only   = ON;"        /* disable UPDATE, DELETE, etc. write operations */
     );
     /**
-     * \brief pragmas to use when the database is opened as read-write 
+     * \brief pragmas to set for shared read-only database connections
+     *
+     * Shared connections are meant to be used in numbers, one per thread that queries
+     * the database. Thus, they must not take an exclusive lock or change the journal
+     * mode.
+     */
+    NK_INTERNAL NkStringView const gl_c_RoShPragmaSql = NK_MAKE_STRING_VIEW(
+        "PRAGMA encoding     = 'UTF-8';"   /* use UTF-8 encoding */
+        "PRAGMA query_only   = ON;"        /* disable UPDATE, DELETE, etc. write operations */
+    );
+    /**
+     * \brief pragmas to use when the database is opened as read-write
+     *
+     * Write-ahead logging lets commits append to the log instead of rewriting pages
+     * through a rollback journal. With \c synchronous set to \c NORMAL, the log is only
+     * synced on checkpoints; a committed transaction may be lost on power failure, but
+     * the database cannot become corrupted.
      */
-    NK_INTERNAL NkStringView const gl_c_WrPragmaSql = NK_MAKE_STRING_VIEW("PRAGMA encoding = 'UTF-8';");
+    NK_INTERNAL NkStringView const gl_c_WrPragmaSql = NK_MAKE_STRING_VIEW(
+        "PRAGMA encoding     = 'UTF-8';" /* use UTF-8 encoding */
+        "PRAGMA journal_mode = WAL;"     /* use write-ahead logging */
+        "PRAGMA synchronous  = NORMAL;"  /* only sync on checkpoints */
+    );
 
     int res = SQLITE_OK;
-    switch (mode) {
-        case NkDbMode_ReadOnly:  res = sqlite3_exec(dbConnRef, gl_c_RoPragmaSql.mp_dataPtr, NULL, NULL, NULL); break;
+    switch (mode & (NkDbMode_ReadOnly | NkDbMode_ReadWrite)) {
+        case NkDbMode_ReadOnly:
+            res = sqlite3_exec(
+                dbConnRef,
+                mode & NkDbMode_Shared ? gl_c_RoShPragmaSql.mp_dataPtr : gl_c_RoPragmaSql.mp_dataPtr,
+                NULL,
+                NULL,
+                NULL
+            );
+
+            break;
         case NkDbMode_ReadWrite: res = sqlite3_exec(dbConnRef, gl_c_WrPragmaSql.mp_dataPtr, NULL, NULL, NULL); break;
     }
+    if (res != SQLITE_OK)
+        return NkErr_SetDatabaseProps;
+
+    /*
+     * Apply the tuning options. A negative cache size is interpreted as KiB by sqlite3.
+     * The page size is ignored by sqlite3 once the database has content. sqlite3 clamps
+     * the memory-mapped size to the compile-time maximum by itself.
+     */
+    char optSql[256];
+    sqlite3_snprintf(
+        (int)sizeof optSql,
+        optSql,
+        "PRAGMA mmap_size = %lld;PRAGMA temp_store = %s;",
+        (long long)optsPtr->m_mmapSize,
+        optsPtr->m_isMemTemp ? "MEMORY" : "DEFAULT"
+    );
+    if ((res = sqlite3_exec(dbConnRef, optSql, NULL, NULL, NULL)) == SQLITE_OK && optsPtr->m_cacheSize > 0) {
+        sqlite3_snprintf((int)sizeof optSql, optSql, "PRAGMA cache_size = -%u;", optsPtr->m_cacheSize);
+
+        res = sqlite3_exec(dbConnRef, optSql, NULL, NULL, NULL);
+    }
+    if (res == SQLITE_OK && optsPtr->m_pageSize > 0) {
+        sqlite3_snprintf((int)sizeof optSql, optSql, "PRAGMA page_size = %u;", optsPtr->m_pageSize);
+
+        res = sqlite3_exec(dbConnRef, optSql, NULL, NULL, NULL);
+    }
     return res == SQLITE_OK ? NkErr_Ok : NkErr_SetDatabaseProps;
 }
 
@@ -148,14 +236,20 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Sqlite3DbHandle_SetPragmas(
  * \return numeric sqlite3 database open mode
  */
 NK_INTERNAL int __NkInt_Sqlite3DbHandle_MapFromDbMode(NkDatabaseMode mode) {
-    int resMode = mode & NkDbMode_Create ? SQLITE_OPEN_CREATE : 0;
+    /*
+     * Connections never share their page cache. Shared connections are only ever used by
+     * one thread at a time, so sqlite3 does not have to serialize calls on them.
+     */
+    int resMode = SQLITE_OPEN_PRIVATECACHE;
+    resMode |= mode & NkDbMode_Create ? SQLITE_OPEN_CREATE : 0;
+    resMode |= mode & NkDbMode_Shared ? SQLITE_OPEN_NOMUTEX : 0;
 
     switch (mode & (NkDbMode_ReadOnly | NkDbMode_ReadWrite)) {
         case NkDbMode_ReadOnly:  return resMode | SQLITE_OPEN_READONLY;
         case NkDbMode_ReadWrite: return resMode | SQLITE_OPEN_READWRITE;
     }
 
-    return SQLITE_OPEN_READWRITE;
+    return resMode | SQLITE_OPEN_READWRITE;
 }
 
 /**
@@ -226,6 +320,389 @@ NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_PrepareResultArray(
     }
 }
 
+/**
+ * \brief  checks whether a column binding can be decoded into
+ * \param  [in] bindPtr column binding
+ * \param  [in] rowStride size of the row structure, in bytes
+ * \return \c NK_TRUE if the binding is valid, \c NK_FALSE if it isn't
+ */
+NK_INTERNAL NkBoolean __NkInt_Sqlite3DbHandle_IsValidBinding(
+    _In_ NkDatabaseColumnBinding const *bindPtr,
+    _In_ NkSize rowStride
+) {
+    NkSize fieldSize;
+    switch (bindPtr->m_colType) {
+        case NkVarTy_Boolean:    fieldSize = sizeof(NkBoolean); break;
+        case NkVarTy_Char:
+        case NkVarTy_Int8:
+        case NkVarTy_Uint8:      fieldSize = sizeof(NkInt8);    break;
+        case NkVarTy_Int16:
+        case NkVarTy_Uint16:     fieldSize = sizeof(NkInt16);   break;
+        case NkVarTy_Int32:
+        case NkVarTy_Uint32:     fieldSize = sizeof(NkInt32);   break;
+        case NkVarTy_Int64:
+        case NkVarTy_Uint64:     fieldSize = sizeof(NkInt64);   break;
+        case NkVarTy_Float:      fieldSize = sizeof(NkFloat);   break;
+        case NkVarTy_Double:     fieldSize = sizeof(NkDouble);  break;
+        case NkVarTy_Uuid:       fieldSize = sizeof(NkUuid);    break;
+        case NkVarTy_StringView:
+        case NkVarTy_BufferView: fieldSize = bindPtr->m_dstSize; break;
+        default:
+            return NK_FALSE;
+    }
+
+    return fieldSize > 0 && bindPtr->m_dstOffset <= rowStride && fieldSize <= rowStride - bindPtr->m_dstOffset;
+}
+
+/**
+ * \brief decodes the current result row into a row structure
+ * \param [in,out] stmtRef prepared statement positioned on a result row
+ * \param [in] layoutPtr layout of the row structure; must have been validated
+ * \param [out] rowPtr row structure
+ */
+NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_DecodeRow(
+    _Inout_ sqlite3_stmt *stmtRef,
+    _In_    NkDatabaseRowLayout const *layoutPtr,
+    _Out_   NkByte *rowPtr
+) {
+    for (NkUint32 i = 0; i < layoutPtr->m_nCols; i++) {
+        NkDatabaseColumnBinding const *bindPtr = &layoutPtr->mp_colArr[i];
+        NkVoid *dstPtr = (NkVoid *)(rowPtr + bindPtr->m_dstOffset);
+
+        /*
+         * sqlite3 converts the column to the requested type itself. NULL columns are
+         * returned as zero, empty strings, or NULL blobs, respectively.
+         */
+        switch (bindPtr->m_colType) {
+            case NkVarTy_Boolean: *(NkBoolean *)dstPtr = sqlite3_column_int64(stmtRef, (int)i) != 0;      break;
+            case NkVarTy_Char:
+            case NkVarTy_Int8:
+            case NkVarTy_Uint8:   *(NkInt8 *)dstPtr    = (NkInt8)sqlite3_column_int(stmtRef, (int)i);     break;
+            case NkVarTy_Int16:
+            case NkVarTy_Uint16:  *(NkInt16 *)dstPtr   = (NkInt16)sqlite3_column_int(stmtRef, (int)i);    break;
+            case NkVarTy_Int32:
+            case NkVarTy_Uint32:  *(NkInt32 *)dstPtr   = (NkInt32)sqlite3_column_int64(stmtRef, (int)i);  break;
+            case NkVarTy_Int64:
+            case NkVarTy_Uint64:  *(NkInt64 *)dstPtr   = sqlite3_column_int64(stmtRef, (int)i);           break;
+            case NkVarTy_Float:   *(NkFloat *)dstPtr   = (NkFloat)sqlite3_column_double(stmtRef, (int)i); break;
+            case NkVarTy_Double:  *(NkDouble *)dstPtr  = sqlite3_column_double(stmtRef, (int)i);          break;
+            case NkVarTy_Uuid: {
+                NkVoid const *blobPtr = sqlite3_column_blob(stmtRef, (int)i);
+
+                if (blobPtr != NULL && sqlite3_column_bytes(stmtRef, (int)i) == sizeof(NkUuid))
+                    memcpy(dstPtr, blobPtr, sizeof(NkUuid));
+                else
+                    memset(dstPtr, 0, sizeof(NkUuid));
+
+                break;
+            }
+            case NkVarTy_StringView: {
+                char const *strPtr = (char const *)sqlite3_column_text(stmtRef, (int)i);
+                NkSize const nBytes = NK_MIN((NkSize)sqlite3_column_bytes(stmtRef, (int)i), bindPtr->m_dstSize - 1);
+
+                if (strPtr != NULL)
+                    memcpy(dstPtr, strPtr, nBytes);
+                ((char *)dstPtr)[strPtr != NULL ? nBytes : 0] = '\0';
+
+                break;
+            }
+            case NkVarTy_BufferView: {
+                NkByte const *blobPtr = (NkByte const *)sqlite3_column_blob(stmtRef, (int)i);
+                NkSize const nBytes = blobPtr != NULL
+                    ? NK_MIN((NkSize)sqlite3_column_bytes(stmtRef, (int)i), bindPtr->m_dstSize)
+                    : 0
+                ;
+
+                if (nBytes > 0)
+                    memcpy(dstPtr, blobPtr, nBytes);
+                memset((NkByte *)dstPtr + nBytes, 0, bindPtr->m_dstSize - nBytes);
+
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * \brief removes an idle statement from the usage list
+ * \param [in,out] actSelf database connection
+ * \param [in,out] entryPtr cache entry
+ */
+NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_UnlinkStmt(
+    _Inout_ __NkInt_Sqlite3DbHandle *actSelf,
+    _Inout_ __NkInt_Sqlite3CachedStmt *entryPtr
+) {
+    if (entryPtr->mp_prevEntry != NULL)
+        entryPtr->mp_prevEntry->mp_nextEntry = entryPtr->mp_nextEntry;
+    else
+        actSelf->mp_lruHead = entryPtr->mp_nextEntry;
+    if (entryPtr->mp_nextEntry != NULL)
+        entryPtr->mp_nextEntry->mp_prevEntry = entryPtr->mp_prevEntry;
+    else
+        actSelf->mp_lruTail = entryPtr->mp_prevEntry;
+
+    entryPtr->mp_prevEntry = entryPtr->mp_nextEntry = NULL;
+}
+
+/**
+ * \brief marks an idle statement as the most recently used one
+ * \param [in,out] actSelf database connection
+ * \param [in,out] entryPtr cache entry; must not be linked
+ */
+NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_LinkStmt(
+    _Inout_ __NkInt_Sqlite3DbHandle *actSelf,
+    _Inout_ __NkInt_Sqlite3CachedStmt *entryPtr
+) {
+    entryPtr->mp_prevEntry = NULL;
+    entryPtr->mp_nextEntry = actSelf->mp_lruHead;
+    if (actSelf->mp_lruHead != NULL)
+        actSelf->mp_lruHead->mp_prevEntry = entryPtr;
+    else
+        actSelf->mp_lruTail = entryPtr;
+    actSelf->mp_lruHead = entryPtr;
+}
+
+/**
+ * \brief finalizes a prepared statement and destroys its cache entry
+ * \param [in,out] entryPtr cache entry; must not be linked
+ */
+NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_DestroyStmt(_Inout_ __NkInt_Sqlite3CachedStmt *entryPtr) {
+    /* A NULL-pointer is a no-op when passed to sqlite3_finalize(). */
+    sqlite3_finalize(entryPtr->mp_stmtPtr);
+
+    NkGPFree((NkVoid *)entryPtr);
+}
+
+/**
+ * \brief  retrieves a prepared statement for the given SQL text, compiling it only if
+ *         there is no idle statement for the same text
+ * \param  [in,out] actSelf database connection
+ * \param  [in] sqlStr SQL text
+ * \param  [out] resPtr pointer to a variable that receives the cache entry
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The entry belongs to the caller until it is given back via
+ *         <tt>__NkInt_Sqlite3DbHandle_ReturnStmt()</tt>.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Sqlite3DbHandle_AcquireStmt(
+    _Inout_       __NkInt_Sqlite3DbHandle *actSelf,
+    _In_z_ _Utf8_ char const *sqlStr,
+    _Outptr_      __NkInt_Sqlite3CachedStmt **resPtr
+) {
+    NK_ASSERT(actSelf != NULL, NkErr_InOutParameter);
+    NK_ASSERT(sqlStr != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    if (actSelf->mp_dbConn == NULL)
+        return NkErr_ObjectState;
+
+    /* Reuse an idle statement if there is one. */
+    NkHashtableKey const sqlKey = { .mp_strKey = (char *)sqlStr };
+    if (actSelf->mp_stmtCache != NULL && NkHashtableExtract(actSelf->mp_stmtCache, &sqlKey, (NkVoid **)resPtr) == NkErr_Ok) {
+        __NkInt_Sqlite3DbHandle_UnlinkStmt(actSelf, *resPtr);
+
+        --actSelf->m_nCached;
+        return NkErr_Ok;
+    }
+
+    /* Allocate a new entry; the SQL text is stored right after it. */
+    NkSize const sqlLen = strlen(sqlStr);
+    __NkInt_Sqlite3CachedStmt *entryPtr;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *entryPtr + sqlLen + 1, 0, NK_TRUE, (NkVoid **)&entryPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    entryPtr->mp_sqlStr = (char *)(entryPtr + 1);
+    memcpy(entryPtr->mp_sqlStr, sqlStr, sqlLen + 1);
+
+    /*
+     * Compile the first statement; any statements after the first are ignored. As the
+     * statement is likely to be reused, tell sqlite3 that it will be long-lived.
+     */
+    int res = sqlite3_prepare_v3(
+        actSelf->mp_dbConn,
+        entryPtr->mp_sqlStr,
+        (int)(sqlLen + 1),
+        SQLITE_PREPARE_PERSISTENT,
+        &entryPtr->mp_stmtPtr,
+        NULL
+    );
+    if (res != SQLITE_OK) {
+        __NkInt_Sqlite3DbHandle_DestroyStmt(entryPtr);
+
+        return NkErr_CompileSqlStatement;
+    }
+
+    *resPtr = entryPtr;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief gives a statement obtained by <tt>__NkInt_Sqlite3DbHandle_AcquireStmt()</tt>
+ *        back to the database connection
+ * \param [in,out] actSelf database connection
+ * \param [in,out] entryPtr cache entry
+ * \note  The statement is reset and its bindings are cleared. If the cache is full, the
+ *        least recently used idle statement is finalized. If there already is an idle
+ *        statement with the same SQL text or the connection is closed, the statement is
+ *        finalized right away.
+ */
+NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_ReturnStmt(
+    _Inout_ __NkInt_Sqlite3DbHandle *actSelf,
+    _Inout_ __NkInt_Sqlite3CachedStmt *entryPtr
+) {
+    NK_ASSERT(actSelf != NULL, NkErr_InOutParameter);
+    NK_ASSERT(entryPtr != NULL, NkErr_InOutParameter);
+
+    sqlite3_reset(entryPtr->mp_stmtPtr);
+    sqlite3_clear_bindings(entryPtr->mp_stmtPtr);
+    if (actSelf->mp_dbConn == NULL || entryPtr->mp_stmtPtr == NULL)
+        goto lbl_ONDISCARD;
+
+    /* Create the cache the first time a statement is given back. */
+    if (actSelf->mp_stmtCache == NULL) {
+        NkHashtableProperties const htProps = {
+            .m_structSize  = sizeof htProps,
+            .m_keyType     = NkHtKeyTy_String,
+            .m_initCap     = 64,
+            .m_minCap      = 64,
+            .m_maxCap      = UINT32_MAX,
+            .mp_fnElemFree = NULL
+        };
+
+        if (NkHashtableCreate(&htProps, &actSelf->mp_stmtCache) != NkErr_Ok)
+            goto lbl_ONDISCARD;
+    }
+
+    /* The hash table does not replace existing keys, so keep only one idle copy. */
+    NkHashtableKey const sqlKey = { .mp_strKey = entryPtr->mp_sqlStr };
+    if (NkHashtableContains(actSelf->mp_stmtCache, &sqlKey))
+        goto lbl_ONDISCARD;
+    if (NkHashtableInsert(actSelf->mp_stmtCache, &(NkHashtablePair const){ sqlKey, (NkVoid *)entryPtr }) != NkErr_Ok)
+        goto lbl_ONDISCARD;
+    __NkInt_Sqlite3DbHandle_LinkStmt(actSelf, entryPtr);
+
+    /* Evict the least recently used statement if the cache grew too large. */
+    if (++actSelf->m_nCached > __NkInt_Sqlite3DbHandle_StmtCacheCap) {
+        __NkInt_Sqlite3CachedStmt *lruEntry = actSelf->mp_lruTail;
+
+        NK_IGNORE_RETURN_VALUE(NkHashtableErase(actSelf->mp_stmtCache, &(NkHashtableKey const){ .mp_strKey = lruEntry->mp_sqlStr }));
+        __NkInt_Sqlite3DbHandle_UnlinkStmt(actSelf, lruEntry);
+        __NkInt_Sqlite3DbHandle_DestroyStmt(lruEntry);
+        --actSelf->m_nCached;
+    }
+    return;
+
+lbl_ONDISCARD:
+    __NkInt_Sqlite3DbHandle_DestroyStmt(entryPtr);
+}
+
+/**
+ * \brief finalizes all idle statements of a database connection
+ * \param [in,out] actSelf database connection
+ * \note  This must be done before the connection can be closed.
+ */
+NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_FlushStmtCache(_Inout_ __NkInt_Sqlite3DbHandle *actSelf) {
+    NK_ASSERT(actSelf != NULL, NkErr_InOutParameter);
+
+    while (actSelf->mp_lruHead != NULL) {
+        __NkInt_Sqlite3CachedStmt *currEntry = actSelf->mp_lruHead;
+
+        __NkInt_Sqlite3DbHandle_UnlinkStmt(actSelf, currEntry);
+        __NkInt_Sqlite3DbHandle_DestroyStmt(currEntry);
+    }
+
+    /* The hash table does not own its elements. */
+    NkHashtableDestroy(&actSelf->mp_stmtCache);
+    actSelf->m_nCached = 0;
+}
+
+/**
+ * \brief  executes a statement that does not take parameters, discarding its results
+ * \param  [in,out] actSelf database connection
+ * \param  [in] sqlStr SQL text
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Sqlite3DbHandle_ExecuteSimple(
+    _Inout_       __NkInt_Sqlite3DbHandle *actSelf,
+    _In_z_ _Utf8_ char const *sqlStr
+) {
+    __NkInt_Sqlite3CachedStmt *entryPtr;
+    NkErrorCode errCode = __NkInt_Sqlite3DbHandle_AcquireStmt(actSelf, sqlStr, &entryPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    int res;
+    while ((res = sqlite3_step(entryPtr->mp_stmtPtr)) == SQLITE_ROW)
+        ;
+
+    __NkInt_Sqlite3DbHandle_ReturnStmt(actSelf, entryPtr);
+    return res == SQLITE_DONE ? NkErr_Ok : NkErr_ExecuteSqlStatement;
+}
+
+/**
+ * \brief updates the transaction depth after a transaction statement finished
+ * \param [in,out] actSelf database connection
+ * \note  sqlite3 rolls back the whole transaction on some errors; in this case, no
+ *        transaction is open anymore regardless of the depth.
+ */
+NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_SyncTxDepth(_Inout_ __NkInt_Sqlite3DbHandle *actSelf) {
+    if (sqlite3_get_autocommit(actSelf->mp_dbConn))
+        actSelf->m_txDepth = 0;
+}
+
+/**
+ * \brief  runs a prepared statement, invoking the callback once per result row
+ * \param  [in,out] actStmt prepared statement
+ * \param  [in] fnResIter (optional) result iteration callback
+ * \param  [in,out] extraCxtPtr (optional) context passed to \c fnResIter
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The statement is reset before the function returns.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Sqlite3DbHandle_RunStatement(
+    _Inout_     sqlite3_stmt *actStmt,
+    _In_opt_    NkDatabaseQueryIterFn fnResIter,
+    _Inout_opt_ NkVoid *extraCxtPtr
+) {
+    /* Iterate over all result rows, invoking the callback once per row. */
+    NkErrorCode eCode = NkErr_Ok;
+    NkVariant *resArr = NULL;
+    while (sqlite3_step(actStmt) == SQLITE_ROW) {
+        /* Allocate the column array the first time a row is processed. */
+        if (resArr == NULL) {
+            eCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *resArr, sqlite3_column_count(actStmt), &resArr);
+
+            if (eCode != NkErr_Ok)
+                goto lbl_ONFIN;
+        }
+        /* Fill the result array dynamically. */
+        __NkInt_Sqlite3DbHandle_PrepareResultArray(actStmt, sqlite3_column_count(actStmt), resArr);
+
+        /* Run the callback on the result. */
+        if (fnResIter != NULL) {
+            eCode = (*fnResIter)((NkUint32)sqlite3_column_count(actStmt), (NkVariant const *)resArr, extraCxtPtr);
+            
+            /* If the return value is not NkErr_Ok, then we stop iterating. */
+            if (eCode != NkErr_Ok) {
+                eCode = eCode == NkErr_ManuallyAborted ? NkErr_Ok : eCode;
+
+                goto lbl_ONFIN;
+            }
+        }
+    }
+
+lbl_ONFIN:
+    /*
+     * Destroy the memory used for the result array. If this is NULL, NkPoolFree() is a
+     * no-op.
+     */
+    NkPoolFree((NkVoid *)resArr);
+    /* Reset the statement so it can be reused. */
+    sqlite3_reset(actStmt);
+
+    return eCode;
+}
+
 
 /**
  * \brief implements <tt>NkISqlStatement::AddRef()</tt> 
@@ -233,7 +710,7 @@ NK_INTERNAL NkVoid __NkInt_Sqlite3DbHandle_PrepareResultArray(
 NK_INTERNAL NkOMRefCount NK_CALL __NkInt_Sqlite3Stmt_AddRef(_Inout_ NkISqlStatement *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    return ++((__NkInt_Sqlite3Stmt *)self)->m_refCount;
+    return NkOMRefCountIncrement(&((__NkInt_Sqlite3Stmt *)self)->m_refCount, NkOMRcMd_Shared);
 }
 
 /**
@@ -243,9 +720,11 @@ NK_INTERNAL NkOMRefCount NK_CALL __NkInt_Sqlite3Stmt_Release(_Inout_ NkISqlState
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
     __NkInt_Sqlite3Stmt *actSelf = (__NkInt_Sqlite3Stmt *)self;
-    if (--actSelf->m_refCount <= 0) {
-        /* Destroy db handle. */
-        sqlite3_finalize(actSelf->mp_stmtPtr);
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&actSelf->m_refCount, NkOMRcMd_Shared);
+    if (newCount <= 0) {
+        /* Give the prepared statement back to the connection so it can be reused. */
+        if (actSelf->mp_cacheEnt != NULL)
+            __NkInt_Sqlite3DbHandle_ReturnStmt((__NkInt_Sqlite3DbHandle *)actSelf->mp_dbConn, actSelf->mp_cacheEnt);
         /* Release parent database instance. */
         actSelf->mp_dbConn->VT->Release(actSelf->mp_dbConn);
 
@@ -254,7 +733,7 @@ NK_INTERNAL NkOMRefCount NK_CALL __NkInt_Sqlite3Stmt_Release(_Inout_ NkISqlState
         return 0;
     }
 
-    return actSelf->m_refCount;
+    return newCount;
 }
 
 /**
@@ -301,16 +780,15 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3Stmt_Initialize(
     /* Get pointer to SQL source code parameter. */
     __NkInt_Sqlite3StmtInit const *initStruct = (__NkInt_Sqlite3StmtInit const *)initParam;
 
-    /* Compile the first statement; any statements after the first are ignored. */
-    int res = sqlite3_prepare_v2(
-        initStruct->mp_dbConn,
+    /* Obtain the prepared statement, compiling it if none is cached. */
+    NkErrorCode errCode = __NkInt_Sqlite3DbHandle_AcquireStmt(
+        (__NkInt_Sqlite3DbHandle *)initStruct->mp_nkomDbConn,
         initStruct->mp_sqlStr,
-        -1,
-        &actSelf->mp_stmtPtr,
-        NULL
+        &actSelf->mp_cacheEnt
     );
-    if (res != SQLITE_OK)
-        return NkErr_CompileSqlStatement;
+    if (errCode != NkErr_Ok)
+        return errCode;
+    actSelf->mp_stmtPtr = actSelf->mp_cacheEnt->mp_stmtPtr;
 
     /* Set the other attributes of the statement object. */
     initStruct->mp_nkomDbConn->VT->AddRef(initStruct->mp_nkomDbConn);
@@ -463,7 +941,7 @@ NKOM_DEFINE_VTABLE(NkISqlStatement) {
 NK_INTERNAL NkOMRefCount NK_CALL __NkInt_Sqlite3DbHandle_AddRef(_Inout_ NkIDatabase *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    return ++((__NkInt_Sqlite3DbHandle *)self)->m_refCount;
+    return NkOMRefCountIncrement(&((__NkInt_Sqlite3DbHandle *)self)->m_refCount, NkOMRcMd_Shared);
 }
 
 /**
@@ -474,7 +952,8 @@ NK_INTERNAL NkOMRefCount NK_CALL __NkInt_Sqlite3DbHandle_Release(_Inout_ NkIData
 
     __NkInt_Sqlite3DbHandle *actSelf = (__NkInt_Sqlite3DbHandle *)self;
 
-    if (--actSelf->m_refCount <= 0) {
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&actSelf->m_refCount, NkOMRcMd_Shared);
+    if (newCount <= 0) {
         /* Close the database connection if it's still open. */
         self->VT->Close(self);
 
@@ -482,7 +961,7 @@ NK_INTERNAL NkOMRefCount NK_CALL __NkInt_Sqlite3DbHandle_Release(_Inout_ NkIData
         return 0;
     }
 
-    return actSelf->m_refCount;
+    return newCount;
 }
 
 /**
@@ -515,7 +994,8 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Create(
     _Inout_           NkIDatabase *self,
     _In_opt_z_ _Utf8_ char const *schemaStr,
     _In_z_ _Utf8_     char const *dbPath,
-    _In_              NkDatabaseMode mode
+    _In_              NkDatabaseMode mode,
+    _In_opt_          NkDatabaseOptions const *optsPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
     NK_ASSERT(dbPath != NULL, NkErr_InParameter);
@@ -528,7 +1008,7 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Create(
      * handle. Regardless of connection mode, this first opening must be in read-write
      * mode. If the database does not exist, this will fail.
      */
-    NkErrorCode errCode = self->VT->Open(self, dbPath, NkDbMode_ReadWrite | NkDbMode_Create);
+    NkErrorCode errCode = self->VT->Open(self, dbPath, NkDbMode_ReadWrite | NkDbMode_Create, optsPtr);
     if (errCode != NkErr_Ok)
         return errCode;
 
@@ -548,7 +1028,7 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Create(
      * time with the actual access mode.
      */
     self->VT->Close(self);
-    return self->VT->Open(self, dbPath, mode);
+    return self->VT->Open(self, dbPath, mode, optsPtr);
 }
 
 /**
@@ -557,10 +1037,12 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Create(
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Open(
     _Inout_       NkIDatabase *self,
     _In_z_ _Utf8_ char const *dbPath,
-    _In_          NkDatabaseMode mode
+    _In_          NkDatabaseMode mode,
+    _In_opt_      NkDatabaseOptions const *optsPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
     NK_ASSERT(mode > NkDbMode_Unknown && mode < __NkDbMode_Count__, NkErr_InParameter);
+    NK_ASSERT(optsPtr == NULL || optsPtr->m_structSize >= sizeof *optsPtr, NkErr_InParameter);
 
     __NkInt_Sqlite3DbHandle *actSelf = (__NkInt_Sqlite3DbHandle *)self;
 
@@ -587,7 +1069,13 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Open(
      * Connection was successfully opened. Set optimization pragmas according to the
      * connection mode, if needed.
      */
-    NkErrorCode errCode = __NkInt_Sqlite3DbHandle_SetPragmas(actSelf->mp_dbConn, mode);
+    NkDatabaseOptions defOpts;
+    if (optsPtr == NULL) {
+        NkDatabaseQueryDefaultOptions(mode, &defOpts);
+
+        optsPtr = &defOpts;
+    }
+    NkErrorCode errCode = __NkInt_Sqlite3DbHandle_SetPragmas(actSelf->mp_dbConn, mode, optsPtr);
     if (errCode != NkErr_Ok) {
         /* Could not set some pragmas. Just close DB in such a case. */
         sqlite3_close(actSelf->mp_dbConn);
@@ -603,12 +1091,27 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Open(
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Close(_Inout_ NkIDatabase *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
+    __NkInt_Sqlite3DbHandle *actSelf = (__NkInt_Sqlite3DbHandle *)self;
+
+    /* Idle statements would keep the connection from being closed. */
+    __NkInt_Sqlite3DbHandle_FlushStmtCache(actSelf);
+
+    /*
+     * Write-ahead logging is a persistent property of the database file. Switch back to
+     * a rollback journal so the log is merged into the database and read-only
+     * connections, which cannot create the log, can still open it. This fails silently
+     * if other connections are still using the database.
+     */
+    if (actSelf->mp_dbConn != NULL && actSelf->m_dbMode & NkDbMode_ReadWrite)
+        sqlite3_exec(actSelf->mp_dbConn, "PRAGMA journal_mode = DELETE;", NULL, NULL, NULL);
+
     /* Retrieve and close the database connection. This may fail. */
-    sqlite3 **dbHdPtr;
-    int res = sqlite3_close(*(dbHdPtr = &((__NkInt_Sqlite3DbHandle *)self)->mp_dbConn));
+    int res = sqlite3_close(actSelf->mp_dbConn);
 
-    if (res == SQLITE_OK)
-        *dbHdPtr = NULL;
+    if (res == SQLITE_OK) {
+        actSelf->mp_dbConn = NULL;
+        actSelf->m_txDepth = 0;
+    }
     return res == SQLITE_OK ? NkErr_Ok : NkErr_DatabaseClose;
 }
 
@@ -630,7 +1133,6 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_CreateStatem
      */
     __NkInt_Sqlite3StmtInit stmtInit = {
         .mp_sqlStr     = (char *)sqlStr,
-        .mp_dbConn     = ((__NkInt_Sqlite3DbHandle *)self)->mp_dbConn,
         .mp_nkomDbConn = self
     };
 
@@ -662,44 +1164,7 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Execute(
     if (actSelf->mp_dbConn == NULL)
         return NkErr_ObjectState;
 
-    /* Iterate over all result rows, invoking the callback once per row. */
-    NkErrorCode eCode = NkErr_Ok;
-    NkVariant *resArr = NULL;
-    sqlite3_stmt *actStmt = ((__NkInt_Sqlite3Stmt *)stmtRef)->mp_stmtPtr;
-    while (sqlite3_step(actStmt) == SQLITE_ROW) {
-        /* Allocate the column array the first time a row is processed. */
-        if (resArr == NULL) {
-            eCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *resArr, sqlite3_column_count(actStmt), &resArr);
-
-            if (eCode != NkErr_Ok)
-                goto lbl_ONFIN;
-        }
-        /* Fill the result array dynamically. */
-        __NkInt_Sqlite3DbHandle_PrepareResultArray(actStmt, sqlite3_column_count(actStmt), resArr);
-
-        /* Run the callback on the result. */
-        if (fnResIter != NULL) {
-            eCode = (*fnResIter)((NkUint32)sqlite3_column_count(actStmt), (NkVariant const *)resArr, extraCxtPtr);
-            
-            /* If the return value is not NkErr_Ok, then we stop iterating. */
-            if (eCode != NkErr_Ok) {
-                eCode = eCode == NkErr_ManuallyAborted ? NkErr_Ok : eCode;
-
-                goto lbl_ONFIN;
-            }
-        }
-    }
-
-lbl_ONFIN:
-    /*
-     * Destroy the memory used for the result array. If this is NULL, NkPoolFree() is a
-     * no-op.
-     */
-    NkPoolFree((NkVoid *)resArr);
-    /* Reset the statement so it can be reused. */
-    sqlite3_reset(actStmt);
-
-    return eCode;
+    return __NkInt_Sqlite3DbHandle_RunStatement(((__NkInt_Sqlite3Stmt *)stmtRef)->mp_stmtPtr, fnResIter, extraCxtPtr);
 }
 
 /**
@@ -717,45 +1182,219 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_ExecuteInlin
     /* Get pointer to actual database instance. */
     __NkInt_Sqlite3DbHandle *actSelf = (__NkInt_Sqlite3DbHandle *)self;
 
-    /* Create inline statement. */
-    __NkInt_Sqlite3StmtInit initStruct = {
-        .mp_sqlStr     = (char *)sqlStr,
-        .mp_dbConn     = actSelf->mp_dbConn,
-        .mp_nkomDbConn = self
-    };
-    NkISqlStatement *sqlStmt;
-    NkErrorCode errCode = NkOMCreateInstance(
-        NKOM_CLSIDOF(NkISqlStatement),
-        NULL,
-        NKOM_IIDOF(NkISqlStatement),
-        (NkVoid *)&initStruct,
-        (NkIBase **)&sqlStmt
-    );
+    /*
+     * Take the prepared statement straight from the statement cache; there is no need
+     * for a statement object as the statement has no parameters.
+     */
+    __NkInt_Sqlite3CachedStmt *entryPtr;
+    NkErrorCode errCode = __NkInt_Sqlite3DbHandle_AcquireStmt(actSelf, sqlStr, &entryPtr);
     if (errCode != NkErr_Ok)
         return errCode;
 
-    /* Execute the query. */
-    errCode = self->VT->Execute(self, sqlStmt, fnResIter, extraCxtPtr);
-    
-    /* Destroy statement and return. */
-    sqlStmt->VT->Release(sqlStmt);
+    /* Execute the query and give the statement back. */
+    errCode = __NkInt_Sqlite3DbHandle_RunStatement(entryPtr->mp_stmtPtr, fnResIter, extraCxtPtr);
+
+    __NkInt_Sqlite3DbHandle_ReturnStmt(actSelf, entryPtr);
     return errCode;
 }
 
 
+/**
+ * \brief implements <tt>NkIDatabase::BeginTransaction()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_BeginTransaction(_Inout_ NkIDatabase *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_Sqlite3DbHandle *actSelf = (__NkInt_Sqlite3DbHandle *)self;
+    if (actSelf->mp_dbConn == NULL)
+        return NkErr_ObjectState;
+
+    /*
+     * Take the write lock right away so that the transaction cannot fail later on
+     * because another connection started writing in the meantime. Nested transactions
+     * are savepoints.
+     */
+    NkErrorCode errCode = __NkInt_Sqlite3DbHandle_ExecuteSimple(
+        actSelf,
+        actSelf->m_txDepth == 0 ? "BEGIN IMMEDIATE;" : "SAVEPOINT __NkInt_Tx;"
+    );
+    if (errCode == NkErr_Ok)
+        ++actSelf->m_txDepth;
+
+    return errCode;
+}
+
+/**
+ * \brief implements <tt>NkIDatabase::Commit()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Commit(_Inout_ NkIDatabase *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_Sqlite3DbHandle *actSelf = (__NkInt_Sqlite3DbHandle *)self;
+    if (actSelf->mp_dbConn == NULL || actSelf->m_txDepth == 0)
+        return NkErr_ObjectState;
+
+    /* If the commit fails, the transaction stays open and can be retried or rolled back. */
+    NkErrorCode errCode = __NkInt_Sqlite3DbHandle_ExecuteSimple(
+        actSelf,
+        actSelf->m_txDepth == 1 ? "COMMIT;" : "RELEASE __NkInt_Tx;"
+    );
+    if (errCode == NkErr_Ok)
+        --actSelf->m_txDepth;
+
+    __NkInt_Sqlite3DbHandle_SyncTxDepth(actSelf);
+    return errCode;
+}
+
+/**
+ * \brief implements <tt>NkIDatabase::Rollback()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_Rollback(_Inout_ NkIDatabase *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_Sqlite3DbHandle *actSelf = (__NkInt_Sqlite3DbHandle *)self;
+    if (actSelf->mp_dbConn == NULL || actSelf->m_txDepth == 0)
+        return NkErr_ObjectState;
+
+    /* Rolling back to a savepoint keeps it open, so it has to be released, too. */
+    NkErrorCode errCode;
+    if (actSelf->m_txDepth == 1)
+        errCode = __NkInt_Sqlite3DbHandle_ExecuteSimple(actSelf, "ROLLBACK;");
+    else {
+        errCode = __NkInt_Sqlite3DbHandle_ExecuteSimple(actSelf, "ROLLBACK TO __NkInt_Tx;");
+
+        if (errCode == NkErr_Ok)
+            errCode = __NkInt_Sqlite3DbHandle_ExecuteSimple(actSelf, "RELEASE __NkInt_Tx;");
+    }
+    if (errCode == NkErr_Ok)
+        --actSelf->m_txDepth;
+
+    __NkInt_Sqlite3DbHandle_SyncTxDepth(actSelf);
+    return errCode;
+}
+
+/**
+ * \brief implements <tt>NkIDatabase::ExecuteBatch()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_ExecuteBatch(
+    _Inout_     NkIDatabase *self,
+    _Inout_     NkISqlStatement *stmtRef,
+    _In_        NkSize nRows,
+    _In_        NkDatabaseBatchBindFn fnBind,
+    _Inout_opt_ NkVoid *extraCxtPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(stmtRef != NULL, NkErr_InOutParameter);
+    NK_ASSERT(fnBind != NULL, NkErr_InParameter);
+
+    /*
+     * Run all rows in one transaction; this way, the changes are only synced once for
+     * the whole batch instead of once per row.
+     */
+    NkErrorCode errCode = self->VT->BeginTransaction(self);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    sqlite3_stmt *actStmt = ((__NkInt_Sqlite3Stmt *)stmtRef)->mp_stmtPtr;
+    for (NkSize i = 0; i < nRows; i++) {
+        if ((errCode = (*fnBind)(i, stmtRef, extraCxtPtr)) != NkErr_Ok)
+            break;
+
+        /* Execute the statement for the current row; bindings are kept by the reset. */
+        int res;
+        while ((res = sqlite3_step(actStmt)) == SQLITE_ROW)
+            ;
+        sqlite3_reset(actStmt);
+
+        if (res != SQLITE_DONE) {
+            errCode = NkErr_ExecuteSqlStatement;
+
+            break;
+        }
+    }
+
+    /* Discard the whole batch if a single row failed. */
+    if (errCode != NkErr_Ok) {
+        NK_IGNORE_RETURN_VALUE(self->VT->Rollback(self));
+
+        return errCode;
+    }
+    return self->VT->Commit(self);
+}
+
+
+/**
+ * \brief implements <tt>NkIDatabase::ExecuteTyped()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Sqlite3DbHandle_ExecuteTyped(
+    _Inout_     NkIDatabase *self,
+    _Inout_     NkISqlStatement *stmtRef,
+    _In_        NkDatabaseRowLayout const *layoutPtr,
+    _Out_       NkVoid *rowBuf,
+    _In_        NkSize nBufRows,
+    _In_        NkDatabaseRowChunkFn fnChunk,
+    _Inout_opt_ NkVoid *extraCxtPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(stmtRef != NULL, NkErr_InOutParameter);
+    NK_ASSERT(layoutPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(rowBuf != NULL, NkErr_OutParameter);
+    NK_ASSERT(nBufRows > 0, NkErr_InParameter);
+    NK_ASSERT(fnChunk != NULL, NkErr_InParameter);
+
+    if (((__NkInt_Sqlite3DbHandle *)self)->mp_dbConn == NULL)
+        return NkErr_ObjectState;
+
+    /* Validate the layout once so that decoding the rows does not have to. */
+    sqlite3_stmt *actStmt = ((__NkInt_Sqlite3Stmt *)stmtRef)->mp_stmtPtr;
+    if (layoutPtr->m_nCols > (NkUint32)sqlite3_column_count(actStmt))
+        return NkErr_InParameter;
+    for (NkUint32 i = 0; i < layoutPtr->m_nCols; i++)
+        if (!__NkInt_Sqlite3DbHandle_IsValidBinding(&layoutPtr->mp_colArr[i], layoutPtr->m_rowStride))
+            return NkErr_InParameter;
+
+    /* Decode the rows into the buffer, handing it to the callback whenever it is full. */
+    NkErrorCode errCode = NkErr_Ok;
+    NkSize      nRows   = 0;
+    while (sqlite3_step(actStmt) == SQLITE_ROW) {
+        __NkInt_Sqlite3DbHandle_DecodeRow(actStmt, layoutPtr, (NkByte *)rowBuf + nRows * layoutPtr->m_rowStride);
+
+        if (++nRows == nBufRows) {
+            if ((errCode = (*fnChunk)(nRows, (NkVoid const *)rowBuf, extraCxtPtr)) != NkErr_Ok)
+                goto lbl_ONFIN;
+
+            nRows = 0;
+        }
+    }
+    /* Hand over the last, partially filled chunk. */
+    if (nRows > 0)
+        errCode = (*fnChunk)(nRows, (NkVoid const *)rowBuf, extraCxtPtr);
+
+lbl_ONFIN:
+    sqlite3_reset(actStmt);
+
+    return errCode == NkErr_ManuallyAborted ? NkErr_Ok : errCode;
+}
+
+
 /**
  * \brief static NkIDatabase VTable instance 
  */
 NKOM_DEFINE_VTABLE(NkIDatabase) {
-    .QueryInterface  = &__NkInt_Sqlite3DbHandle_QueryInterface,
-    .AddRef          = &__NkInt_Sqlite3DbHandle_AddRef,
-    .Release         = &__NkInt_Sqlite3DbHandle_Release,
-    .Create          = &__NkInt_Sqlite3DbHandle_Create,
-    .Open            = &__NkInt_Sqlite3DbHandle_Open,
-    .Close           = &__NkInt_Sqlite3DbHandle_Close,
-    .CreateStatement = &__NkInt_Sqlite3DbHandle_CreateStatement,
-    .Execute         = &__NkInt_Sqlite3DbHandle_Execute,
-    .ExecuteInline   = &__NkInt_Sqlite3DbHandle_ExecuteInline
+    .QueryInterface   = &__NkInt_Sqlite3DbHandle_QueryInterface,
+    .AddRef           = &__NkInt_Sqlite3DbHandle_AddRef,
+    .Release          = &__NkInt_Sqlite3DbHandle_Release,
+    .Create           = &__NkInt_Sqlite3DbHandle_Create,
+    .Open             = &__NkInt_Sqlite3DbHandle_Open,
+    .Close            = &__NkInt_Sqlite3DbHandle_Close,
+    .CreateStatement  = &__NkInt_Sqlite3DbHandle_CreateStatement,
+    .Execute          = &__NkInt_Sqlite3DbHandle_Execute,
+    .ExecuteInline    = &__NkInt_Sqlite3DbHandle_ExecuteInline,
+    .BeginTransaction = &__NkInt_Sqlite3DbHandle_BeginTransaction,
+    .Commit           = &__NkInt_Sqlite3DbHandle_Commit,
+    .Rollback         = &__NkInt_Sqlite3DbHandle_Rollback,
+    .ExecuteBatch     = &__NkInt_Sqlite3DbHandle_ExecuteBatch,
+    .ExecuteTyped     = &__NkInt_Sqlite3DbHandle_ExecuteTyped
 };
 
 
@@ -914,6 +1553,24 @@ NK_COMPONENT_DEFINE(DbSrv) {
 /** \endcond */
 
 
+NkVoid NK_CALL NkDatabaseQueryDefaultOptions(_In_ NkDatabaseMode mode, _Out_ NkDatabaseOptions *optsPtr) {
+    NK_ASSERT(mode > NkDbMode_Unknown && mode < __NkDbMode_Count__, NkErr_InParameter);
+    NK_ASSERT(optsPtr != NULL, NkErr_OutParameter);
+
+    *optsPtr = (NkDatabaseOptions){
+        .m_structSize = sizeof *optsPtr,
+        .m_mmapSize   = 0,
+        .m_cacheSize  = 16384,
+        .m_pageSize   = 0,
+        .m_isMemTemp  = NK_TRUE
+    };
+    if (mode & NkDbMode_ReadOnly) {
+        optsPtr->m_mmapSize  = (NkInt64)256 << 20;
+        optsPtr->m_cacheSize = mode & NkDbMode_Shared ? 2048 : 8192;
+    }
+}
+
+
 #undef NK_NAMESPACE
 
 
@@ -0,0 +1,286 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  array.c
+ * \brief implementation of Noriko's value-typed dynamic array data-structure
+ */
+#define NK_NAMESPACE "nk::dstruct::arr"
+
+
+/* stdlib includes */
+#include <memory.h>
+#include <math.h>
+
+/* Noriko includes */
+#include <include/Noriko/def.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/util.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/sort.h>
+
+#include <include/Noriko/dstruct/array.h>
+
+
+/**
+ * \struct NkArray
+ * \brief  internal definition of the array data-structure
+ */
+struct NkArray {
+    NkSize             m_elemCount; /**< current number of elements stored */
+    NkSize             m_elemCap;   /**< current capacity, in elements */
+    NkSize             m_elemSize;  /**< size of a single element, in bytes */
+    NkVectorProperties m_vecProps;  /**< array properties */
+
+    NkByte *mp_dataPtr; /**< raw pointer to the internal buffer */
+};
+
+
+/** \cond INTERNAL */
+/**
+ * \brief  grows the internal buffer so that it can hold at least \c reqCap elements
+ * \param  [in,out] arrPtr pointer to the NkArray data-structure of which the internal
+ *                  buffer is to be grown
+ * \param  [in] reqCap required capacity, in elements
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The buffer is grown by at least the array's grow factor so that repeated
+ *         appends take amortized constant time.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_ArrayGrow(_Inout_ NkArray *arrPtr, _In_ NkSize reqCap) {
+    if (reqCap <= arrPtr->m_elemCap)
+        return NkErr_Ok;
+    if (reqCap > arrPtr->m_vecProps.m_maxCap)
+        return NkErr_CapLimitExceeded;
+
+    /*
+     * Calculate the capacity that the array would have if it were grown by its 'natural'
+     * grow factor, taking into account the hard limit set at initialization.
+     */
+    NkSize const capAfterGrowing = (NkSize)ceilf(arrPtr->m_elemCap * arrPtr->m_vecProps.m_growFactor);
+    NkSize const newCap          = NK_MIN(arrPtr->m_vecProps.m_maxCap, NK_MAX(reqCap, capAfterGrowing));
+
+    if (newCap > SIZE_MAX / arrPtr->m_elemSize)
+        return NkErr_UnsignedWrapAround;
+
+    NkErrorCode const errorCode = NkGPRealloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        newCap * arrPtr->m_elemSize,
+        (NkVoid **)&arrPtr->mp_dataPtr
+    );
+    if (errorCode != NkErr_Ok)
+        return errorCode;
+
+    arrPtr->m_elemCap = newCap;
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkArrayCreate(
+    _In_       NkVectorProperties const *vecPropsPtr,
+    _In_       NkSize elemSize,
+    _Init_ptr_ NkArray **arrPtr
+) {
+    NK_ASSERT(vecPropsPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(vecPropsPtr->m_minCap > 0 && vecPropsPtr->m_minCap <= vecPropsPtr->m_maxCap, NkErr_InParameter);
+    NK_ASSERT(
+        vecPropsPtr->m_initialCap >= vecPropsPtr->m_minCap && vecPropsPtr->m_initialCap <= vecPropsPtr->m_maxCap,
+        NkErr_InParameter
+    );
+    NK_ASSERT(vecPropsPtr->m_growFactor > 1.f, NkErr_InParameter);
+    NK_ASSERT(elemSize > 0, NkErr_InParameter);
+    NK_ASSERT(arrPtr != NULL, NkErr_OutptrParameter);
+
+    /* Calculate the initial buffer size. */
+    if (vecPropsPtr->m_initialCap > SIZE_MAX / elemSize)
+        return NkErr_UnsignedWrapAround;
+    NkSize const initSize = vecPropsPtr->m_initialCap * elemSize;
+
+    /* Allocate memory for parent structure. */
+    NkErrorCode errorCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **arrPtr, 1, arrPtr);
+    if (errorCode != NkErr_Ok)
+        return errorCode;
+    /* Allocate memory for internal buffer. */
+    errorCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), initSize, 0, NK_FALSE, (NkVoid **)&(*arrPtr)->mp_dataPtr);
+    if (errorCode != NkErr_Ok) {
+        NkPoolFree(*arrPtr);
+
+        *arrPtr = NULL;
+        return errorCode;
+    }
+
+    /* Copy properties. */
+    (*arrPtr)->m_vecProps  = *vecPropsPtr;
+    (*arrPtr)->m_elemSize  = elemSize;
+    (*arrPtr)->m_elemCount = 0;
+    (*arrPtr)->m_elemCap   = vecPropsPtr->m_initialCap;
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkArrayDestroy(_Uninit_ptr_ NkArray **arrPtr) {
+    if (arrPtr == NULL || *arrPtr == NULL)
+        return;
+
+    /* Free parent structure and buffer memory. */
+    NkGPFree((*arrPtr)->mp_dataPtr);
+    NkPoolFree(*arrPtr);
+    *arrPtr = NULL;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkArrayClear(_Inout_ NkArray *arrPtr) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InOutParameter);
+
+    arrPtr->m_elemCount = 0;
+    if (arrPtr->m_elemCap == arrPtr->m_vecProps.m_minCap)
+        return NkErr_Ok;
+
+    /* Shrink buffer to the specified smallest size. */
+    NkErrorCode const errorCode = NkGPRealloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        arrPtr->m_vecProps.m_minCap * arrPtr->m_elemSize,
+        (NkVoid **)&arrPtr->mp_dataPtr
+    );
+    if (errorCode != NkErr_Ok)
+        return errorCode;
+
+    arrPtr->m_elemCap = arrPtr->m_vecProps.m_minCap;
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkArrayReserve(_Inout_ NkArray *arrPtr, _In_ NkSize minCap) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InOutParameter);
+
+    return __NkInt_ArrayGrow(arrPtr, minCap);
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkArrayEmplace(
+    _Inout_    NkArray *arrPtr,
+    _In_opt_   NkSize index,
+    _In_       NkSize nElems,
+    _Init_ptr_ NkVoid **elemPtr
+) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(index <= arrPtr->m_elemCount, NkErr_ArrayElemOutOfBounds);
+    NK_ASSERT(elemPtr != NULL, NkErr_OutptrParameter);
+
+    /* Make sure that the buffer can hold all elements. */
+    if (nElems > SIZE_MAX - arrPtr->m_elemCount)
+        return NkErr_UnsignedWrapAround;
+
+    NkErrorCode const errorCode = __NkInt_ArrayGrow(arrPtr, arrPtr->m_elemCount + nElems);
+    if (errorCode != NkErr_Ok) {
+        *elemPtr = NULL;
+
+        return errorCode;
+    }
+
+    /* Shift everything after index to the right by the number of new slots. */
+    NkByte *const slotPtr = arrPtr->mp_dataPtr + index * arrPtr->m_elemSize;
+    if (index < arrPtr->m_elemCount)
+        memmove(slotPtr + nElems * arrPtr->m_elemSize, slotPtr, (arrPtr->m_elemCount - index) * arrPtr->m_elemSize);
+
+    arrPtr->m_elemCount += nElems;
+    *elemPtr = slotPtr;
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkArrayInsert(
+    _Inout_           NkArray *arrPtr,
+    _In_opt_          NkSize index,
+    _I_array_(nElems) NkVoid const *elemArray,
+    _In_              NkSize nElems
+) {
+    NK_ASSERT(elemArray != NULL || nElems == 0, NkErr_InParameter);
+
+    NkVoid *slotPtr;
+    NkErrorCode const errorCode = NkArrayEmplace(arrPtr, index, nElems, &slotPtr);
+    if (errorCode != NkErr_Ok)
+        return errorCode;
+
+    /* Copy the elements into the new slots. */
+    memcpy(slotPtr, elemArray, nElems * arrPtr->m_elemSize);
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkArrayAppend(
+    _Inout_           NkArray *arrPtr,
+    _I_array_(nElems) NkVoid const *elemArray,
+    _In_              NkSize nElems
+) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InOutParameter);
+
+    return NkArrayInsert(arrPtr, arrPtr->m_elemCount, elemArray, nElems);
+}
+
+NkVoid NK_CALL NkArrayErase(_Inout_ NkArray *arrPtr, _In_opt_ NkSize sInd, _In_opt_ NkSize maxN) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(sInd < arrPtr->m_elemCount, NkErr_ArrayElemOutOfBounds);
+
+    /* Shift everything after the erased range to the left. */
+    NkSize const lenToDel = NK_MIN(maxN, arrPtr->m_elemCount - sInd);
+    memmove(
+        arrPtr->mp_dataPtr + sInd * arrPtr->m_elemSize,
+        arrPtr->mp_dataPtr + (sInd + lenToDel) * arrPtr->m_elemSize,
+        (arrPtr->m_elemCount - sInd - lenToDel) * arrPtr->m_elemSize
+    );
+    arrPtr->m_elemCount -= lenToDel;
+}
+
+NkVoid NK_CALL NkArraySort(
+    _Inout_  NkArray *arrPtr,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32 (NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(sInd <= eInd, NkErr_InvalidRange);
+    NK_ASSERT(eInd < arrPtr->m_elemCount, NkErr_ArrayElemOutOfBounds);
+    NK_ASSERT(fnPred != NULL, NkErr_CallbackParameter);
+
+    NK_IGNORE_RETURN_VALUE(NkIntrosortValues(arrPtr->mp_dataPtr, arrPtr->m_elemSize, sInd, eInd, fnPred));
+}
+
+NkVoid *NK_CALL NkArrayAt(_In_ NkArray const *arrPtr, _In_ NkSize index) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(index < arrPtr->m_elemCount, NkErr_ArrayElemOutOfBounds);
+
+    return arrPtr->mp_dataPtr + index * arrPtr->m_elemSize;
+}
+
+NkVoid *NK_CALL NkArrayGetBuffer(_In_ NkArray const *arrPtr) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InParameter);
+
+    return arrPtr->mp_dataPtr;
+}
+
+NkSize NK_CALL NkArrayGetElementCount(_In_ NkArray const *arrPtr) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InParameter);
+
+    return arrPtr->m_elemCount;
+}
+
+NkSize NK_CALL NkArrayGetCapacity(_In_ NkArray const *arrPtr) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InParameter);
+
+    return arrPtr->m_elemCap;
+}
+
+NkSize NK_CALL NkArrayGetElementSize(_In_ NkArray const *arrPtr) {
+    NK_ASSERT(arrPtr != NULL, NkErr_InParameter);
+
+    return arrPtr->m_elemSize;
+}
+
+
+#undef NK_NAMESPACE
+
+
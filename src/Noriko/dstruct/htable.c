@@ -20,10 +20,21 @@
 /* stdlib includes */
 #include <string.h>
 
+/* Use SSE2 for probing if the target supports it. */
+#if (defined _M_X64 || defined _M_IX86 || defined __SSE2__)
+    #include <emmintrin.h>
+
+    #define NK_HT_USE_SSE2
+#endif
+#if (defined _MSC_VER)
+    #include <intrin.h>
+#endif
+
 /* Noriko includes */
 #include <include/Noriko/alloc.h>
 #include <include/Noriko/error.h>
 #include <include/Noriko/log.h>
+#include <include/Noriko/job.h>
 
 #include <include/Noriko/dstruct/htable.h>
 
@@ -66,16 +77,38 @@
 
 /** \cond INTERNAL */
 /**
- * \struct __NkInt_HashtableExtPair
- * \brief represents the hash table pair data-structure used for slots, extended with the
- *        value's offset (i.e., "richness") from its "home" slot (that is, the slot that
- *        the pair's key component originally hashed to)
+ * \def   NK_HT_GROUPSIZE
+ * \brief number of slots per group, that is, the number of control bytes that are
+ *        examined at once while probing
+ */
+#define NK_HT_GROUPSIZE ((NkUint32)(16))
+/**
+ * \def   NK_HT_CTRL_EMPTY
+ * \brief control byte value of a slot that has never been used since the last rebuild
+ */
+#define NK_HT_CTRL_EMPTY ((NkUint8)(0x80))
+/**
+ * \def   NK_HT_CTRL_DELETED
+ * \brief control byte value of a slot whose element was erased (tombstone)
+ */
+#define NK_HT_CTRL_DELETED ((NkUint8)(0xFE))
+/**
+ * \def   NK_HT_BYTESPERELEM
+ * \brief number of bytes the arrays of a hash table occupy per element of capacity
+ */
+#define NK_HT_BYTESPERELEM (sizeof(NkHashtablePair) + 3 * sizeof(NkUint32) + sizeof(NkUint8))
+/**
+ * \def   NK_HT_PARMINCHUNK
+ * \brief minimum number of pairs a single job of <tt>NkHashtableParallelForEach()</tt>
+ *        iterates over
  */
-NK_NATIVE typedef struct __NkInt_HashtableExtPair {
-    NkHashtablePair m_regPair; /**< regular pair */
-    NkUint32        m_isUsed;  /**< whether or not the slot is in use */
-    NkUint32        m_offset;  /**< offset from "home key"; as unsigned 32-bit integer */
-} __NkInt_HashtableExtPair;
+#define NK_HT_PARMINCHUNK ((NkUint32)(256))
+/**
+ * \def   NK_HT_PARMAXCHUNKS
+ * \brief maximum number of chunks <tt>NkHashtableParallelForEach()</tt> splits the
+ *        pair array into
+ */
+#define NK_HT_PARMAXCHUNKS ((NkUint32)(16))
 
 /**
  * \struct __NkInt_HashtableContext
@@ -87,15 +120,54 @@ NK_NATIVE typedef struct __NkInt_HashtableContext {
 } __NkInt_HashtableContext;
 NK_INTERNAL __NkInt_HashtableContext gl_HtContext;
 
+/**
+ * \struct __NkInt_HashtableConcContext
+ * \brief  represents the additional state of a concurrent hash table
+ *
+ * A concurrent hash table does not store any elements itself. Instead, it publishes a
+ * pointer to an ordinary hash table (the "snapshot") which is never modified once it is
+ * published. Readers announce themselves by incrementing the reader count of the
+ * current epoch's parity and then re-checking the epoch; writers publish a new snapshot,
+ * advance the epoch, and wait for the readers of the previous epoch to leave before
+ * freeing the old snapshot.
+ */
+NK_NATIVE typedef struct __NkInt_HashtableConcContext {
+    NK_DECL_LOCK(m_wrLock);               /**< serializes writers */
+    NkHashtable    *volatile mp_currSnap; /**< currently published snapshot */
+    LONG volatile            m_currEpoch; /**< current read epoch */
+    LONG volatile            m_nReaders[2]; /**< number of active readers, by epoch parity */
+} __NkInt_HashtableConcContext;
+
 /**
  * \struct NkHashtable
  * \brief  represents the implementation details of the hash table data-structure
+ *
+ * Slots are organized in groups of \c NK_HT_GROUPSIZE slots; the number of groups is
+ * always a power of two. Every slot has a control
+ * byte which is either \c NK_HT_CTRL_EMPTY, \c NK_HT_CTRL_DELETED, or, if the slot is
+ * in use, the lower 7 bits of the hash of the slot's key (the "tag"). The control bytes
+ * are stored separately from the key-value pairs, so that a lookup can compare the tags
+ * of an entire group at once and only has to touch the pair array on a tag match.
+ * Probing advances group by group and stops at the first group that contains an empty
+ * slot. A concurrent hash table leaves all of these fields except \c m_htProps unused
+ * and delegates to its current snapshot instead.
+ * The key-value pairs themselves are not stored in the slots. They are kept densely at
+ * the front of \c mp_elemArray in insertion order, and each used slot stores the index
+ * of its pair. Iteration thus only touches live pairs. Erasing a pair moves the last pair
+ * into the vacated position so that the array stays dense.
  */
 NK_NATIVE struct NkHashtable {
-    NkUint32                  m_elemCount;  /**< current number of elements stored */
-    NkUint32                  m_currCap;    /**< current capacity, in elements */
-    NkHashtableProperties     m_htProps;    /**< internal state */
-    __NkInt_HashtableExtPair *mp_elemArray; /**< raw element array */
+    NkUint32               m_elemCount;  /**< current number of elements stored */
+    NkUint32               m_nDeleted;   /**< current number of tombstones */
+    NkUint32               m_currCap;    /**< current capacity, in elements; a power of two */
+    NkHashtableProperties  m_htProps;    /**< internal state */
+    NkHashtablePair       *mp_elemArray;  /**< dense pair array; also owns all other arrays */
+    NkUint32              *mp_slotArray;  /**< index of the slot of each pair in \c mp_elemArray */
+    NkUint32              *mp_hashArray;  /**< full hash value of the key in each used slot */
+    NkUint32              *mp_indexArray; /**< index into \c mp_elemArray of the pair in each used slot */
+    NkUint8               *mp_ctrlArray;  /**< control bytes, one per slot */
+
+    __NkInt_HashtableConcContext *mp_concCxt; /**< concurrent state; \c NULL if the table is not concurrent */
 };
 
 
@@ -112,26 +184,17 @@ NK_INTERNAL NkVoid __NkInt_HashtableFreeElems(_Inout_ NkHashtable *htPtr) {
 
     /*
      * If the element destroy function is defined, destroy all remaining elements in hash
-     * table first.
-     * This loop uses two indices, one that iterates over the entire array, and one
-     * index that counts the number of elements processed. If j reaches its maximum
-     * (that is, the number of elements stored), the loop terminates as the remainder
-     * of the slots will be empty anyway.
+     * table first. All pairs are stored at the front of the pair array.
      * 
-     * It is not necessary that the \c m_isUsed field is set to \c NK_FALSE since this
-     * function is only called if the hash table is
+     * It is not necessary that the control bytes are reset since this function is only
+     * called if the hash table is
      *  (a) to be destroyed, invalidating the element array
-     *  (b) to be cleared, after which the element array will be zeroed accordingly
+     *  (b) to be cleared, after which the control bytes will be reset accordingly
      */
-    for (NkUint32 i = 0, j = 0; i < htPtr->m_currCap && j < htPtr->m_elemCount; i++) {
-        /* Retrieve pointer to entry. Skip entry if not used. */
-        __NkInt_HashtableExtPair *pairPtr = (__NkInt_HashtableExtPair *)&htPtr->mp_elemArray[i];
-        if (pairPtr->m_isUsed == NK_FALSE)
-            continue;
+    for (NkUint32 i = 0; i < htPtr->m_elemCount; i++) {
+        NkHashtablePair *pairPtr = &htPtr->mp_elemArray[i];
 
-        /* Invoke destructor. */
-        (*htPtr->m_htProps.mp_fnElemFree)(&pairPtr->m_regPair.m_keyVal, pairPtr->m_regPair.mp_valuePtr);
-        ++j;
+        (*htPtr->m_htProps.mp_fnElemFree)(&pairPtr->m_keyVal, pairPtr->mp_valuePtr);
     }
 }
 
@@ -152,6 +215,7 @@ NK_INTERNAL NK_INLINE NkSize __NkInt_HashtableGetKeySizeInBytes(
         case NkHtKeyTy_String:     return (NkSize)strlen(keyPtr->mp_strKey);
         case NkHtKeyTy_StringView: return keyPtr->mp_svKey->m_sizeInBytes;
         case NkHtKeyTy_Uuid:       return sizeof(NkUuid);
+        case NkHtKeyTy_StringId:   return sizeof(NkUint32);
         default:
             /* Should never happen. */
 #pragma warning (suppress: 4127)
@@ -162,23 +226,22 @@ NK_INTERNAL NK_INLINE NkSize __NkInt_HashtableGetKeySizeInBytes(
 }
 
 /**
- * \brief  computes the hash value for the given key
+ * \brief  computes the SipHash value for the given key
  * \param  [in] keyPtr pointer to the key data-structure
  * \param  [in] kType numeric key type ID
- * \param  [in] htCap capacity of the hash table (value to clamp raw hash value to)
- * \return hash value (clamped)
+ * \return 32-bit hash value
  * \see    https://github.com/veorq/SipHash/blob/master/halfsiphash.c
  * \note   The hash value is implemented using the \c HalfSipHash algorithm.
  */
-NK_INTERNAL NkUint32 __NkInt_HashtableHash(
+NK_INTERNAL NkUint32 __NkInt_HashtableSipHash(
     _In_ NkHashtableKey const *keyPtr,
-    _In_ NkHashtableKeyType kType,
-    _In_ NkUint32 htCap
+    _In_ NkHashtableKeyType kType
 ) {
     char const unsigned *ni = NULL;
     switch (kType) {
         case NkHtKeyTy_String:     ni = (char const unsigned *)keyPtr->mp_strKey;            break;
         case NkHtKeyTy_StringView: ni = (char const unsigned *)keyPtr->mp_svKey->mp_dataPtr; break;
+        case NkHtKeyTy_Uuid:       ni = (char const unsigned *)keyPtr->mp_uuidKey;           break;
         default:
             ni = (char const unsigned *)keyPtr;
     }
@@ -243,71 +306,240 @@ NK_INTERNAL NkUint32 __NkInt_HashtableHash(
     b = v1 ^ v3;
     U32TO8_LE((unsigned char *)&out + 4, b);
 
-    return ((out & 0xFFFFFFFF) ^ (out >> 32)) % htCap;
+    return (NkUint32)((out & 0xFFFFFFFF) ^ (out >> 32));
 }
 
 /**
- * \brief  inserts an element using Robin-Hood-Hashing
+ * \brief  scrambles the bits of a 64-bit integer
+ * \param  [in] inVal value that is to be mixed
+ * \return mixed value
+ * \note   This is the finalizer of the \c SplitMix64 generator. Every input bit affects
+ *         every output bit, so both the low bits (tag) and the high bits (group) are
+ *         usable even for keys like aligned pointers whose low bits are always zero.
+ */
+NK_INTERNAL NK_INLINE NkUint64 __NkInt_HashtableMix64(_In_ NkUint64 inVal) {
+    inVal = (inVal ^ (inVal >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    inVal = (inVal ^ (inVal >> 27)) * 0x94D049BB133111EBULL;
+
+    return inVal ^ (inVal >> 31);
+}
+
+/**
+ * \brief  computes a fast, non-cryptographic hash value for the given key
+ * \param  [in] keyPtr pointer to the key data-structure
+ * \param  [in] kType numeric key type ID
+ * \return 32-bit hash value
+ * \note   Fixed-width keys are mixed with a couple of multiply-shift steps; strings are
+ *         hashed using FNV-1a before being mixed.
+ */
+NK_INTERNAL NkUint32 __NkInt_HashtableFastHash(
+    _In_ NkHashtableKey const *keyPtr,
+    _In_ NkHashtableKeyType kType
+) {
+    NkUint64 const seedVal = gl_HtContext.m_hashSeed;
+    NkUint64       hashVal;
+
+    switch (kType) {
+        case NkHtKeyTy_Int64:
+        case NkHtKeyTy_Uint64:
+        case NkHtKeyTy_Pointer:
+            hashVal = __NkInt_HashtableMix64(keyPtr->m_uint64Key ^ seedVal);
+
+            break;
+        case NkHtKeyTy_StringId:
+            /* Only the low 32 bits of the key are defined. */
+            hashVal = __NkInt_HashtableMix64((NkUint64)keyPtr->m_strIdKey ^ seedVal);
+
+            break;
+        case NkHtKeyTy_Uuid: {
+            NkUint64 uuidHalves[2];
+            memcpy(uuidHalves, keyPtr->mp_uuidKey, sizeof uuidHalves);
+
+            hashVal = __NkInt_HashtableMix64(uuidHalves[0] ^ __NkInt_HashtableMix64(uuidHalves[1] ^ seedVal));
+            break;
+        }
+        default: {
+            char const unsigned *bytePtr = kType == NkHtKeyTy_String
+                ? (char const unsigned *)keyPtr->mp_strKey
+                : (char const unsigned *)keyPtr->mp_svKey->mp_dataPtr
+            ;
+            NkSize const byteCount = __NkInt_HashtableGetKeySizeInBytes(keyPtr, kType);
+
+            hashVal = 0xCBF29CE484222325ULL ^ seedVal;
+            for (NkSize i = 0; i < byteCount; i++)
+                hashVal = (hashVal ^ bytePtr[i]) * 0x100000001B3ULL;
+            hashVal = __NkInt_HashtableMix64(hashVal);
+        }
+    }
+
+    return (NkUint32)(hashVal ^ (hashVal >> 32));
+}
+
+/**
+ * \brief  computes the hash value for the given key according to the table's policy
+ * \param  [in] htPtr hash table the key belongs to
+ * \param  [in] keyPtr pointer to the key data-structure
+ * \return 32-bit hash value; the lower 7 bits are used as the slot's tag, the remaining
+ *         bits select the group
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_HashtableHash(
+    _In_ NkHashtable const *htPtr,
+    _In_ NkHashtableKey const *keyPtr
+) {
+    NkHashtableKeyType const kType = htPtr->m_htProps.m_keyType;
+
+    switch (htPtr->m_htProps.m_hashPolicy) {
+        case NkHtHashPol_Fast:    return __NkInt_HashtableFastHash(keyPtr, kType);
+        case NkHtHashPol_SipHash: return __NkInt_HashtableSipHash(keyPtr, kType);
+        default:
+            /* Only strings may come from untrusted sources. */
+            return kType == NkHtKeyTy_String || kType == NkHtKeyTy_StringView
+                ? __NkInt_HashtableSipHash(keyPtr, kType)
+                : __NkInt_HashtableFastHash(keyPtr, kType)
+            ;
+    }
+}
+
+/**
+ * \brief  calculates the slot count for the given requested capacity
+ * \param  [in] reqCap requested capacity, in elements
+ * \return smallest power of two that is at least \c reqCap and at least one group
+ * \note   With power-of-two capacities, the group index can be obtained by masking.
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_HashtableRoundCap(_In_ NkUint32 reqCap) {
+    NkUint32 actCap = NK_HT_GROUPSIZE;
+    while (actCap < reqCap && actCap < (UINT32_C(1) << 31))
+        actCap <<= 1;
+
+    return actCap;
+}
+
+/**
+ * \brief  finds all slots in a group whose control byte equals the given value
+ * \param  [in] grpPtr pointer to the first control byte of the group
+ * \param  [in] ctrlVal control byte value to look for
+ * \return bit mask where bit \c i is set if slot \c i of the group matches
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_HashtableMatchGroup(_In_ NkUint8 const *grpPtr, _In_ NkUint8 ctrlVal) {
+#if (defined NK_HT_USE_SSE2)
+    __m128i const grpVal = _mm_loadu_si128((__m128i const *)grpPtr);
+
+    return (NkUint32)_mm_movemask_epi8(_mm_cmpeq_epi8(grpVal, _mm_set1_epi8((char)ctrlVal)));
+#else
+    NkUint32 resMask = 0;
+    for (NkUint32 i = 0; i < NK_HT_GROUPSIZE; i++)
+        resMask |= (NkUint32)(grpPtr[i] == ctrlVal) << i;
+
+    return resMask;
+#endif
+}
+
+/**
+ * \brief  finds all slots in a group that are not in use
+ * \param  [in] grpPtr pointer to the first control byte of the group
+ * \return bit mask where bit \c i is set if slot \c i of the group is empty or deleted
+ * \note   Both \c NK_HT_CTRL_EMPTY and \c NK_HT_CTRL_DELETED have their highest bit set
+ *         while tags never do, so this only needs to extract the sign bits.
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_HashtableMatchFree(_In_ NkUint8 const *grpPtr) {
+#if (defined NK_HT_USE_SSE2)
+    return (NkUint32)_mm_movemask_epi8(_mm_loadu_si128((__m128i const *)grpPtr));
+#else
+    NkUint32 resMask = 0;
+    for (NkUint32 i = 0; i < NK_HT_GROUPSIZE; i++)
+        resMask |= (NkUint32)(grpPtr[i] >> 7) << i;
+
+    return resMask;
+#endif
+}
+
+/**
+ * \brief  determines the index of the lowest set bit
+ * \param  [in] bitMask non-zero bit mask
+ * \return index of the lowest set bit
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_HashtableLowestBit(_In_ NkUint32 bitMask) {
+#if (defined _MSC_VER)
+    unsigned long bitInd;
+    _BitScanForward(&bitInd, bitMask);
+
+    return (NkUint32)bitInd;
+#else
+    return (NkUint32)__builtin_ctz(bitMask);
+#endif
+}
+
+/**
+ * \brief  inserts an element into the first free slot of its probe sequence
  * \param  [in] htPtr pointer to the NkHashtable structure where the element is to be
  *         inserted
  * \param  [in] pairPtr pointer to the NkHashtablePair structure that is to be inserted
+ * \param  [in] hashVal hash value of the key of \c pairPtr
  * \return \c NK_TRUE if the element was inserted, \c NK_FALSE if not
+ * \note   The key must not already be in the hash table. The pair is appended to the
+ *         pair array and the element count is incremented.
  */
-NK_INTERNAL NkBoolean __NkInt_HashtableRobinHoodInsertSingle(
+NK_INTERNAL NkBoolean __NkInt_HashtableInsertSingle(
     _In_ NkHashtable *htPtr,
-    _In_ NkHashtablePair const *pairPtr
+    _In_ NkHashtablePair const *pairPtr,
+    _In_ NkUint32 hashVal
 ) {
-    /* Calculate hash value for given key. */
-    NkUint32 const initialHash = __NkInt_HashtableHash(
-        &pairPtr->m_keyVal,
-        htPtr->m_htProps.m_keyType,
-        htPtr->m_currCap
-    );
-
-    /* Use Robin-Hood-Hashing to insert elements. */
-    NkBoolean       isInserted = NK_FALSE;
-    NkHashtablePair tmpPair = *pairPtr;
-    for (NkUint32 i = initialHash, currPsa = 0, j = 0; j < htPtr->m_currCap;) {
-        /* If current slot is free, insert element. */
-        if (htPtr->mp_elemArray[i].m_isUsed == NK_FALSE) {
-            htPtr->mp_elemArray[i] = (__NkInt_HashtableExtPair){
-                .m_isUsed  = NK_TRUE,
-                .m_regPair = tmpPair,
-                .m_offset  = currPsa
-            };
-
-            isInserted = NK_TRUE;
-            break;
-        }
-
-        /*
-         * Compare PSL. If the PSA of the element that is to be inserted is smaller or
-         * equal to the PSA of the item in the current probe slot, continue. Otherwise,
-         * swap and continue with the new element.
-         */
-        if (currPsa <= htPtr->mp_elemArray[i].m_offset)
-            ++currPsa;
-        else {
-            NkHashtablePair tmpPair2 = htPtr->mp_elemArray[i].m_regPair;
-            NkUint32        oldPsa = htPtr->mp_elemArray[i].m_offset;
-
-            /* Insert element. */
-            htPtr->mp_elemArray[i] = (__NkInt_HashtableExtPair){
-                .m_isUsed  = NK_TRUE,
-                .m_offset  = currPsa,
-                .m_regPair = tmpPair
-            };
-
-            /* Update state. */
-            currPsa = oldPsa + 1;
-            tmpPair = tmpPair2;
+    NkUint32 const nGroups = htPtr->m_currCap / NK_HT_GROUPSIZE;
+
+    /* Go through the groups and take the first slot that is empty or deleted. */
+    for (NkUint32 i = (hashVal >> 7) & (nGroups - 1), j = 0; j < nGroups; j++) {
+        NkUint8 *grpPtr  = &htPtr->mp_ctrlArray[i * NK_HT_GROUPSIZE];
+        NkUint32 freeMsk = __NkInt_HashtableMatchFree(grpPtr);
+
+        if (freeMsk != 0) {
+            NkUint32 const slotInd = i * NK_HT_GROUPSIZE + __NkInt_HashtableLowestBit(freeMsk);
+            if (htPtr->mp_ctrlArray[slotInd] == NK_HT_CTRL_DELETED)
+                --htPtr->m_nDeleted;
+
+            htPtr->mp_ctrlArray[slotInd]  = (NkUint8)(hashVal & 0x7F);
+            htPtr->mp_hashArray[slotInd]  = hashVal;
+            htPtr->mp_indexArray[slotInd] = htPtr->m_elemCount;
+
+            htPtr->mp_elemArray[htPtr->m_elemCount] = *pairPtr;
+            htPtr->mp_slotArray[htPtr->m_elemCount] = slotInd;
+            ++htPtr->m_elemCount;
+            return NK_TRUE;
         }
 
-        /* Incremement i; if the capacity is reached, wrap around to 0. */
-        i = i >= htPtr->m_currCap - 1 ? 0 : ++i;
+        /* Go to the next group; if the capacity is reached, wrap around to 0. */
+        i = (i + 1) & (nGroups - 1);
     }
 
-    return isInserted;
+    return NK_FALSE;
+}
+
+/**
+ * \brief  allocates the pair, slot, hash, index, and control arrays for the given capacity
+ * \param  [in,out] htPtr hash table whose arrays are to be allocated
+ * \param  [in] newCap capacity, in elements; must be a power of two and at least
+ *              \c NK_HT_GROUPSIZE
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   All arrays share a single allocation. All control bytes are set to empty.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_HashtableAllocArrays(_Inout_ NkHashtable *htPtr, _In_ NkUint32 newCap) {
+    NkErrorCode eCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        NK_HT_BYTESPERELEM * newCap,
+        0,
+        NK_FALSE,
+        &htPtr->mp_elemArray
+    );
+    if (eCode ^ NkErr_Ok)
+        return eCode;
+
+    htPtr->mp_slotArray  = (NkUint32 *)(htPtr->mp_elemArray + newCap);
+    htPtr->mp_hashArray  = htPtr->mp_slotArray + newCap;
+    htPtr->mp_indexArray = htPtr->mp_hashArray + newCap;
+    htPtr->mp_ctrlArray  = (NkUint8 *)(htPtr->mp_indexArray + newCap);
+    htPtr->m_currCap     = newCap;
+    htPtr->m_nDeleted    = 0;
+    memset(htPtr->mp_ctrlArray, NK_HT_CTRL_EMPTY, newCap);
+    return NkErr_Ok;
 }
 
 /**
@@ -320,34 +552,31 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_HashtableAdjustCapacity(
     _Inout_ NkHashtable *htPtr,
     _In_    NkUint32 newCap
 ) {
-    /* Create a dummy hash table instance. */
-    NkHashtable hTable = { .m_currCap = newCap, .m_elemCount = htPtr->m_elemCount, .m_htProps = htPtr->m_htProps };
-    NkErrorCode eCode = NkGPAlloc(
-        NK_MAKE_ALLOCATION_CONTEXT(),
-        sizeof(__NkInt_HashtableExtPair) * newCap,
-        0,
-        NK_TRUE,
-        &hTable.mp_elemArray
-    );
+    /*
+     * Create a dummy hash table instance. The capacity is rounded up to the next power of
+     * two.
+     */
+    NkHashtable hTable = { .m_elemCount = 0, .m_htProps = htPtr->m_htProps };
+    NkErrorCode eCode  = __NkInt_HashtableAllocArrays(&hTable, __NkInt_HashtableRoundCap(newCap));
     if (eCode ^ NkErr_Ok)
         return eCode;
 
-    /* Insert all the elements of the old hash table into the new hash table. */
-    for (NkUint32 i = 0, j = 0; i < htPtr->m_currCap && j < htPtr->m_elemCount; i++) {
-        __NkInt_HashtableExtPair const *htPair = (__NkInt_HashtableExtPair const *)&htPtr->mp_elemArray[i];
-        if (htPair->m_isUsed == NK_FALSE)
-            continue;
-
+    /*
+     * Insert all the elements of the old hash table into the new hash table, in the
+     * order of the pair array so that the order is kept. The stored hash values are
+     * reused so that no key has to be rehashed. Tombstones are not carried over.
+     */
+    for (NkUint32 i = 0; i < htPtr->m_elemCount; i++) {
         /*
          * Insert element. If it fails, simply free the dummy hash table's memory as the
          * elements in the current hash table are still valid.
          */
-        if (__NkInt_HashtableRobinHoodInsertSingle(&hTable, &htPair->m_regPair) ^ NK_TRUE) {
+        NkUint32 const hashVal = htPtr->mp_hashArray[htPtr->mp_slotArray[i]];
+        if (__NkInt_HashtableInsertSingle(&hTable, &htPtr->mp_elemArray[i], hashVal) ^ NK_TRUE) {
             NkGPFree(hTable.mp_elemArray);
 
             return NkErr_CapLimitExceeded;
         }
-        ++j;
     }
     /* All elements are transferred. Delete the old element array. */
     NkGPFree(htPtr->mp_elemArray);
@@ -380,6 +609,7 @@ NK_INTERNAL NkBoolean __NkInt_HashtableCompareKeys(
         case NkHtKeyTy_StringView: return !NkStringViewCompare(fkPtr->mp_svKey, skPtr->mp_svKey);
         case NkHtKeyTy_Pointer:    return fkPtr->mp_ptrKey == skPtr->mp_ptrKey;
         case NkHtKeyTy_Uuid:       return NkUuidIsEqual(fkPtr->mp_uuidKey, skPtr->mp_uuidKey);
+        case NkHtKeyTy_StringId:   return fkPtr->m_strIdKey == skPtr->m_strIdKey;
         default:
 #pragma warning (suppress: 4127)
             NK_ASSERT_EXTRA(
@@ -399,32 +629,282 @@ NK_INTERNAL NkBoolean __NkInt_HashtableCompareKeys(
  * \brief  locates the given key in the hash table
  * \param  [in] htPtr hash table to search for the key
  * \param  [in] keyPtr pointer to the key that is to be located
- * \return index of the key in the hash table's array; or \c UINT32_MAX if the key could
- *         not be located
- */
-NK_INTERNAL NkUint32 __NkInt_HashtableLocKey(_In_ NkHashtable const *htPtr, _In_ NkHashtableKey const *keyPtr) {
-    /* Calculate hash value for given key. */
-    NkUint32 const initialHash = __NkInt_HashtableHash(keyPtr, htPtr->m_htProps.m_keyType, htPtr->m_currCap);
-
-    /* Iterate through the table and try finding the key. */
-    for (NkUint32 i = initialHash, j = 0; j < htPtr->m_currCap; j++) {
-        NkBoolean const isKeysEqual = (htPtr->mp_elemArray[i].m_isUsed
-            && __NkInt_HashtableCompareKeys(
-                keyPtr,
-                &htPtr->mp_elemArray[i].m_regPair.m_keyVal,
-                htPtr->m_htProps.m_keyType
+ * \param  [in] hashVal hash value of \c keyPtr
+ * \return index of the slot of the key; or \c UINT32_MAX if the key could not be
+ *         located
+ */
+NK_INTERNAL NkUint32 __NkInt_HashtableLocKey(
+    _In_ NkHashtable const *htPtr,
+    _In_ NkHashtableKey const *keyPtr,
+    _In_ NkUint32 hashVal
+) {
+    NkUint32 const nGroups = htPtr->m_currCap / NK_HT_GROUPSIZE;
+    NkUint8  const tagVal  = (NkUint8)(hashVal & 0x7F);
+
+    /*
+     * Go through the groups. Only compare the keys of slots whose tag and full stored
+     * hash value match. If a group has an empty slot, the key cannot be in any of the
+     * following groups.
+     */
+    for (NkUint32 i = (hashVal >> 7) & (nGroups - 1), j = 0; j < nGroups; j++) {
+        NkUint8 const *grpPtr = &htPtr->mp_ctrlArray[i * NK_HT_GROUPSIZE];
+
+        for (NkUint32 tagMsk = __NkInt_HashtableMatchGroup(grpPtr, tagVal); tagMsk != 0; tagMsk &= tagMsk - 1) {
+            NkUint32 const slotInd = i * NK_HT_GROUPSIZE + __NkInt_HashtableLowestBit(tagMsk);
+
+            /* If keys match, return index. */
+            if (htPtr->mp_hashArray[slotInd] == hashVal
+                && __NkInt_HashtableCompareKeys(
+                    keyPtr,
+                    &htPtr->mp_elemArray[htPtr->mp_indexArray[slotInd]].m_keyVal,
+                    htPtr->m_htProps.m_keyType
+                )
             )
-        );
+                return slotInd;
+        }
+        if (__NkInt_HashtableMatchGroup(grpPtr, NK_HT_CTRL_EMPTY) != 0)
+            break;
 
-        /* If keys match, return index. */
-        if (isKeysEqual == NK_TRUE)
-            return i;
-        /* If not, continue with next slot. */
-        i = i >= htPtr->m_currCap - 1 ? 0 : i + 1;
+        /* If not, continue with next group. */
+        i = (i + 1) & (nGroups - 1);
     }
 
     return UINT32_MAX;
 }
+
+/**
+ * \brief marks the given slot as unused and removes its pair from the pair array
+ * \param [in,out] htPtr hash table the slot belongs to
+ * \param [in] slotInd index of the slot
+ * \param [out] pairPtr pointer to a variable that receives the removed pair
+ * \note  \li If the group of the slot already has an empty slot, no probe sequence
+ *        continues past this group, so the slot can be made empty as well. Otherwise, it
+ *        becomes a tombstone so that lookups of keys stored in later groups do not stop
+ *        early.
+ * \note  \li The last pair of the pair array is moved into the position of the removed
+ *        pair.
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_HashtableEraseSlot(
+    _Inout_ NkHashtable *htPtr,
+    _In_    NkUint32 slotInd,
+    _Out_   NkHashtablePair *pairPtr
+) {
+    NkUint8 const *grpPtr  = &htPtr->mp_ctrlArray[slotInd / NK_HT_GROUPSIZE * NK_HT_GROUPSIZE];
+    NkUint32 const elemInd = htPtr->mp_indexArray[slotInd];
+    NkUint32 const lastInd = htPtr->m_elemCount - 1;
+
+    *pairPtr = htPtr->mp_elemArray[elemInd];
+    if (elemInd != lastInd) {
+        htPtr->mp_elemArray[elemInd] = htPtr->mp_elemArray[lastInd];
+        htPtr->mp_slotArray[elemInd] = htPtr->mp_slotArray[lastInd];
+
+        htPtr->mp_indexArray[htPtr->mp_slotArray[elemInd]] = elemInd;
+    }
+
+    if (__NkInt_HashtableMatchGroup(grpPtr, NK_HT_CTRL_EMPTY) != 0)
+        htPtr->mp_ctrlArray[slotInd] = NK_HT_CTRL_EMPTY;
+    else {
+        htPtr->mp_ctrlArray[slotInd] = NK_HT_CTRL_DELETED;
+
+        ++htPtr->m_nDeleted;
+    }
+    --htPtr->m_elemCount;
+}
+
+/**
+ * \brief invokes the element destructor of the given hash table on the given pair
+ * \param [in] htPtr hash table the pair belongs (or belonged) to
+ * \param [in,out] pairPtr pair that is to be destroyed
+ */
+NK_INTERNAL NkVoid __NkInt_HashtableDestroyPair(_In_ NkHashtable const *htPtr, _Inout_ NkHashtablePair *pairPtr) {
+    if (htPtr->m_htProps.mp_fnElemFree == NULL)
+        return;
+
+    /* Determine the key pointer that is to be passed. */
+    NkVoid *key2Pass = NK_INRANGE_INCL(htPtr->m_htProps.m_keyType, NkHtKeyTy_String, NkHtKeyTy_Uuid) 
+        ? &pairPtr->m_keyVal
+        : NULL
+    ;
+
+    /* Call the destructor. */
+    (*htPtr->m_htProps.mp_fnElemFree)(key2Pass, pairPtr->mp_valuePtr);
+}
+
+/**
+ * \brief  creates an empty snapshot for the given concurrent hash table
+ * \param  [in] htPtr concurrent hash table
+ * \param  [in] initCap initial capacity of the snapshot, in elements
+ * \param  [out] snapPtr pointer to a variable that receives the new snapshot
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   Snapshots are ordinary hash tables that never own their elements; the element
+ *         destructor is invoked by the concurrent hash table itself.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_HashtableCreateSnapshot(
+    _In_       NkHashtable const *htPtr,
+    _In_       NkUint32 initCap,
+    _Init_ptr_ NkHashtable **snapPtr
+) {
+    NkHashtableProperties snapProps = htPtr->m_htProps;
+    snapProps.m_initCap      = initCap;
+    snapProps.mp_fnElemFree  = NULL;
+    snapProps.m_isConcurrent = NK_FALSE;
+
+    return NkHashtableCreate(&snapProps, snapPtr);
+}
+
+/**
+ * \brief  creates a copy of the given snapshot
+ * \param  [in] srcPtr snapshot that is to be copied
+ * \param  [out] dstPtr pointer to a variable that receives the copy
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_HashtableCloneSnapshot(
+    _In_       NkHashtable const *srcPtr,
+    _Init_ptr_ NkHashtable **dstPtr
+) {
+    NkErrorCode eCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **dstPtr, 1, dstPtr);
+    if (eCode != NkErr_Ok)
+        return eCode;
+    **dstPtr = *srcPtr;
+
+    /* Allocate the arrays and copy them over as a whole; they share one allocation. */
+    if ((eCode = __NkInt_HashtableAllocArrays(*dstPtr, srcPtr->m_currCap)) != NkErr_Ok) {
+        NkPoolFree(*dstPtr);
+
+        *dstPtr = NULL;
+        return eCode;
+    }
+    memcpy((*dstPtr)->mp_elemArray, srcPtr->mp_elemArray, NK_HT_BYTESPERELEM * srcPtr->m_currCap);
+    (*dstPtr)->m_nDeleted = srcPtr->m_nDeleted;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  enters a read-side critical section of the given concurrent hash table
+ * \param  [in,out] cxtPtr concurrent state of the hash table
+ * \param  [out] parPtr pointer to a variable that receives the epoch parity that must
+ *                be passed to <tt>__NkInt_HashtableReadEnd()</tt>
+ * \return current snapshot; valid until <tt>__NkInt_HashtableReadEnd()</tt> is called
+ * \note   This function never blocks. It only retries if a writer advanced the epoch
+ *         between reading the epoch and announcing the reader.
+ */
+NK_INTERNAL NkHashtable const *__NkInt_HashtableReadBegin(
+    _Inout_ __NkInt_HashtableConcContext *cxtPtr,
+    _Out_   LONG *parPtr
+) {
+    for (;;) {
+        LONG const currEpoch = cxtPtr->m_currEpoch;
+
+        InterlockedIncrement(&cxtPtr->m_nReaders[currEpoch & 1]);
+        if (cxtPtr->m_currEpoch == currEpoch) {
+            *parPtr = currEpoch & 1;
+
+            return cxtPtr->mp_currSnap;
+        }
+        InterlockedDecrement(&cxtPtr->m_nReaders[currEpoch & 1]);
+    }
+}
+
+/**
+ * \brief leaves a read-side critical section of the given concurrent hash table
+ * \param [in,out] cxtPtr concurrent state of the hash table
+ * \param [in] parVal epoch parity returned by <tt>__NkInt_HashtableReadBegin()</tt>
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_HashtableReadEnd(_Inout_ __NkInt_HashtableConcContext *cxtPtr, _In_ LONG parVal) {
+    InterlockedDecrement(&cxtPtr->m_nReaders[parVal]);
+}
+
+/**
+ * \brief  publishes a new snapshot and waits until the old one is no longer in use
+ * \param  [in,out] cxtPtr concurrent state of the hash table
+ * \param  [in] newSnap snapshot that is to be published
+ * \return snapshot that was replaced; no reader uses it anymore
+ * \note   The writer lock must be held.
+ */
+NK_INTERNAL NkHashtable *__NkInt_HashtablePublish(
+    _Inout_ __NkInt_HashtableConcContext *cxtPtr,
+    _In_    NkHashtable *newSnap
+) {
+    NkHashtable *oldSnap = InterlockedExchangePointer((PVOID volatile *)&cxtPtr->mp_currSnap, newSnap);
+
+    /*
+     * Readers that may still see the old snapshot have announced themselves in the
+     * previous epoch. Readers of the epochs before that have already been waited for by
+     * the previous writer.
+     */
+    LONG const oldPar = (InterlockedIncrement(&cxtPtr->m_currEpoch) - 1) & 1;
+    while (cxtPtr->m_nReaders[oldPar] != 0)
+        YieldProcessor();
+
+    return oldSnap;
+}
+
+/**
+ * \brief  starts a write operation on the given concurrent hash table
+ * \param  [in,out] htPtr concurrent hash table
+ * \param  [out] snapPtr pointer to a variable that receives a private copy of the
+ *                current snapshot that is to be modified
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   On success, the writer lock is held until <tt>__NkInt_HashtableWriteEnd()</tt>
+ *         is called.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_HashtableWriteBegin(_Inout_ NkHashtable *htPtr, _Init_ptr_ NkHashtable **snapPtr) {
+    NK_LOCK(htPtr->mp_concCxt->m_wrLock);
+
+    NkErrorCode const eCode = __NkInt_HashtableCloneSnapshot(htPtr->mp_concCxt->mp_currSnap, snapPtr);
+    if (eCode != NkErr_Ok)
+        NK_UNLOCK(htPtr->mp_concCxt->m_wrLock);
+
+    return eCode;
+}
+
+/**
+ * \brief finishes a write operation on the given concurrent hash table
+ * \param [in,out] htPtr concurrent hash table
+ * \param [in] snapPtr snapshot obtained by <tt>__NkInt_HashtableWriteBegin()</tt>
+ * \param [in] isCommit whether \c snapPtr is to be published or discarded
+ */
+NK_INTERNAL NkVoid __NkInt_HashtableWriteEnd(
+    _Inout_ NkHashtable *htPtr,
+    _In_    NkHashtable *snapPtr,
+    _In_    NkBoolean isCommit
+) {
+    if (isCommit)
+        snapPtr = __NkInt_HashtablePublish(htPtr->mp_concCxt, snapPtr);
+
+    NkHashtableDestroy(&snapPtr);
+    NK_UNLOCK(htPtr->mp_concCxt->m_wrLock);
+}
+
+/**
+ * \struct __NkInt_HashtableChunk
+ * \brief  represents a contiguous part of the pair array that is iterated over by a
+ *         single job of <tt>NkHashtableParallelForEach()</tt>
+ */
+NK_NATIVE typedef struct __NkInt_HashtableChunk {
+    NkHashtablePair   *mp_elemArray; /**< pair array of the hash table */
+    NkUint32           m_sInd;       /**< index of the first pair of the chunk */
+    NkUint32           m_eInd;       /**< index one past the last pair of the chunk */
+    NkHashtableIterFn  mp_fnIter;    /**< iteration callback */
+    LONG volatile     *mp_isAborted; /**< set as soon as any chunk's callback returned non-zero */
+    NkErrorCode        m_errCode;    /**< return value of the callback that ended the chunk */
+} __NkInt_HashtableChunk;
+
+/**
+ * \brief runs the iteration callback on all pairs of the given chunk
+ * \param [in,out] extraCxt pointer to the <tt>__NkInt_HashtableChunk</tt> instance
+ * \note  The chunk stops early once the callback of any chunk returned non-zero.
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_HashtableRunChunk(_Inout_opt_ NkVoid *extraCxt) {
+    __NkInt_HashtableChunk *chunkPtr = (__NkInt_HashtableChunk *)extraCxt;
+
+    for (NkUint32 i = chunkPtr->m_sInd; i < chunkPtr->m_eInd && *chunkPtr->mp_isAborted == 0; i++)
+        if ((chunkPtr->m_errCode = (*chunkPtr->mp_fnIter)(&chunkPtr->mp_elemArray[i])) != NkErr_Ok) {
+            InterlockedExchange(chunkPtr->mp_isAborted, 1);
+
+            return;
+        }
+}
 /** \endcond */
 
 
@@ -445,22 +925,49 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableCreate(
     }
 
     NK_ASSERT(htPropsPtr, NkErr_InParameter);
+    NK_ASSERT(htPropsPtr->m_hashPolicy >= 0 && htPropsPtr->m_hashPolicy < __NkHtHashPol_Count__, NkErr_InParameter);
     NK_ASSERT(htPtr != NULL, NkErr_OutptrParameter);
 
     /* Allocate memory for data-structure. */
     NkErrorCode errorCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **htPtr, 1, htPtr);
     if (errorCode != NkErr_Ok)
         return errorCode;
-    /* Allocate memory for element array. */
-    errorCode = NkGPAlloc(
-        NK_MAKE_ALLOCATION_CONTEXT(),
-        sizeof *(*htPtr)->mp_elemArray * htPropsPtr->m_initCap,
-        0,
-        NK_TRUE,
-        &(*htPtr)->mp_elemArray
-    );
+    (*htPtr)->mp_concCxt = NULL;
+
+    /*
+     * A concurrent hash table only owns its concurrent state; the elements are stored in
+     * the snapshot.
+     */
+    if (htPropsPtr->m_isConcurrent) {
+        **htPtr = (NkHashtable){ .m_htProps = *htPropsPtr };
+
+        errorCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *(*htPtr)->mp_concCxt, 1, &(*htPtr)->mp_concCxt);
+        if (errorCode != NkErr_Ok)
+            goto lbl_CONCERR;
+        memset((*htPtr)->mp_concCxt, 0, sizeof *(*htPtr)->mp_concCxt);
+
+        NkHashtable *snapPtr;
+        if ((errorCode = __NkInt_HashtableCreateSnapshot(*htPtr, htPropsPtr->m_initCap, &snapPtr)) != NkErr_Ok) {
+            NkPoolFree((*htPtr)->mp_concCxt);
+
+            goto lbl_CONCERR;
+        }
+        (*htPtr)->mp_concCxt->mp_currSnap = snapPtr;
+
+        NK_INITLOCK((*htPtr)->mp_concCxt->m_wrLock);
+        return NkErr_Ok;
+
+    lbl_CONCERR:
+        NkPoolFree(*htPtr);
+
+        *htPtr = NULL;
+        return errorCode;
+    }
+
+    /* Allocate memory for element array, rounded up to the next power of two. */
+    errorCode = __NkInt_HashtableAllocArrays(*htPtr, __NkInt_HashtableRoundCap(htPropsPtr->m_initCap));
     if (errorCode != NkErr_Ok) {
-        NkGPFree(*htPtr);
+        NkPoolFree(*htPtr);
 
         *htPtr = NULL;
         return errorCode;
@@ -469,7 +976,6 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableCreate(
     /* Init state. */
     (*htPtr)->m_htProps   = *htPropsPtr;
     (*htPtr)->m_elemCount = 0;
-    (*htPtr)->m_currCap   = htPropsPtr->m_initCap;
     return NkErr_Ok;
 }
 
@@ -477,6 +983,23 @@ NkVoid NK_CALL NkHashtableDestroy(_Uninit_ptr_ NkHashtable **htPtr) {
     if (htPtr == NULL || *htPtr == NULL)
         return;
 
+    /*
+     * For concurrent hash tables, destroy the current snapshot, including the elements.
+     * No other thread may use the hash table anymore at this point.
+     */
+    if ((*htPtr)->mp_concCxt != NULL) {
+        NkHashtable *snapPtr = (*htPtr)->mp_concCxt->mp_currSnap;
+        snapPtr->m_htProps.mp_fnElemFree = (*htPtr)->m_htProps.mp_fnElemFree;
+        NkHashtableDestroy(&snapPtr);
+
+        NK_DESTROYLOCK((*htPtr)->mp_concCxt->m_wrLock);
+        NkPoolFree((*htPtr)->mp_concCxt);
+        NkPoolFree(*htPtr);
+
+        *htPtr = NULL;
+        return;
+    }
+
     /*
      * If the element destroy function is defined, destroy all remaining elements in hash
      * table first.
@@ -492,13 +1015,42 @@ NkVoid NK_CALL NkHashtableDestroy(_Uninit_ptr_ NkHashtable **htPtr) {
 NkVoid NK_CALL NkHashtableClear(_Inout_ NkHashtable *htPtr) {
     NK_ASSERT(htPtr != NULL, NkErr_InOutParameter);
 
-    /* Destroy elements if possible. */
+    /*
+     * For concurrent hash tables, publish an empty snapshot and destroy the elements of
+     * the old one once no reader uses it anymore. If no new snapshot can be created,
+     * fall back to clearing a copy of the current one.
+     */
+    if (htPtr->mp_concCxt != NULL) {
+        NkHashtable *snapPtr;
+
+        NK_LOCK(htPtr->mp_concCxt->m_wrLock);
+        if (__NkInt_HashtableCreateSnapshot(htPtr, htPtr->m_htProps.m_minCap, &snapPtr) != NkErr_Ok) {
+            if (__NkInt_HashtableCloneSnapshot(htPtr->mp_concCxt->mp_currSnap, &snapPtr) != NkErr_Ok) {
+                NK_UNLOCK(htPtr->mp_concCxt->m_wrLock);
+
+                return;
+            }
+            NkHashtableClear(snapPtr);
+        }
+
+        snapPtr = __NkInt_HashtablePublish(htPtr->mp_concCxt, snapPtr);
+        snapPtr->m_htProps.mp_fnElemFree = htPtr->m_htProps.mp_fnElemFree;
+        NkHashtableDestroy(&snapPtr);
+        NK_UNLOCK(htPtr->mp_concCxt->m_wrLock);
+        return;
+    }
+
+    /*
+     * Destroy elements if possible. The element count is reset first so that shrinking
+     * the array does not carry the destroyed elements over.
+     */
     __NkInt_HashtableFreeElems(htPtr);
+    htPtr->m_elemCount = 0;
 
     /* Shrink array. If this fails, simply use the old array and zero it. */
     NK_IGNORE_RETURN_VALUE(__NkInt_HashtableAdjustCapacity(htPtr, htPtr->m_htProps.m_minCap));
-    memset(htPtr->mp_elemArray, 0, htPtr->m_currCap * sizeof *htPtr->mp_elemArray);
-    htPtr->m_elemCount = 0;
+    memset(htPtr->mp_ctrlArray, NK_HT_CTRL_EMPTY, htPtr->m_currCap);
+    htPtr->m_nDeleted = 0;
 }
 
 _Return_ok_ NkErrorCode NK_CALL NkHashtableInsert(_Inout_ NkHashtable *htPtr, _In_ NkHashtablePair const *htPairPtr) {
@@ -516,13 +1068,29 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableInsertMulti(
     NK_ASSERT(htPtr != NULL, NkErr_InOutParameter);
     NK_ASSERT(htPairArray != NULL, NkErr_InParameter);
 
+    /* For concurrent hash tables, insert into a copy and publish it. */
+    if (htPtr->mp_concCxt != NULL) {
+        NkHashtable *snapPtr;
+
+        NkErrorCode errorCode = __NkInt_HashtableWriteBegin(htPtr, &snapPtr);
+        if (errorCode != NkErr_Ok)
+            return errorCode;
+
+        errorCode = NkHashtableInsertMulti(snapPtr, htPairArray, nElems);
+        __NkInt_HashtableWriteEnd(htPtr, snapPtr, errorCode == NkErr_Ok);
+        return errorCode;
+    }
+
     /* Check capacity constraints. */
     NkUint32 newElemCount;
     if (!NkCheckedUint32Add(htPtr->m_elemCount, nElems, &newElemCount) || newElemCount > htPtr->m_htProps.m_maxCap)
         return NkErr_CapLimitExceeded;
 
-    /* Resize and rehash array if necessary. */
-    if (newElemCount / (NkFloat)htPtr->m_currCap >= 0.75f) {
+    /*
+     * Resize and rehash array if necessary. Tombstones count towards the load-factor as
+     * they lengthen probe sequences just like elements do; rebuilding removes them.
+     */
+    if ((newElemCount + htPtr->m_nDeleted) / (NkFloat)htPtr->m_currCap >= 0.75f) {
         /** \cond INTERNAL */
         /**
          * \brief global hash table target load-factor
@@ -552,18 +1120,15 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableInsertMulti(
             return errorCode;
     }
 
-    /* Insert elements. */
-    NkUint32 actAdded = 0;
+    /* Insert elements; this updates the element count. */
     for (NkUint32 i = 0; i < nElems; i++) {
-        if (NkHashtableContains(htPtr, &htPairArray[i]->m_keyVal) == NK_TRUE)
+        NkUint32 const hashVal = __NkInt_HashtableHash(htPtr, &htPairArray[i]->m_keyVal);
+        if (__NkInt_HashtableLocKey(htPtr, &htPairArray[i]->m_keyVal, hashVal) != UINT32_MAX)
             continue;
 
-        __NkInt_HashtableRobinHoodInsertSingle(htPtr, htPairArray[i]);
-        ++actAdded;
+        NK_IGNORE_RETURN_VALUE(__NkInt_HashtableInsertSingle(htPtr, htPairArray[i], hashVal));
     }
 
-    /* Update state and return. */
-    htPtr->m_elemCount += actAdded;
     return NkErr_Ok;
 }
 
@@ -572,32 +1137,48 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableErase(_Inout_ NkHashtable *htPtr, _In
     NK_ASSERT(keyPtr != NULL, NkErr_InParameter);
 
     /*
-     * Simply set the element's "valid" flag to FALSE. That will cause the element to be
-     * considered free, so its data may be overwritten. The hash table implementation
-     * will never read a slot before having checked its "valid" flag.
+     * For concurrent hash tables, erase from a copy and publish it. The element is only
+     * destroyed once no reader can see it anymore.
+     */
+    if (htPtr->mp_concCxt != NULL) {
+        NkHashtable     *snapPtr;
+        NkHashtablePair  oldPair;
+
+        NkErrorCode const errorCode = __NkInt_HashtableWriteBegin(htPtr, &snapPtr);
+        if (errorCode != NkErr_Ok)
+            return errorCode;
+
+        NkUint32 const where2Find = __NkInt_HashtableLocKey(snapPtr, keyPtr, __NkInt_HashtableHash(snapPtr, keyPtr));
+        if (where2Find == UINT32_MAX) {
+            __NkInt_HashtableWriteEnd(htPtr, snapPtr, NK_FALSE);
+
+            return NkErr_ItemNotFound;
+        }
+        __NkInt_HashtableEraseSlot(snapPtr, where2Find, &oldPair);
+
+        __NkInt_HashtableWriteEnd(htPtr, snapPtr, NK_TRUE);
+        __NkInt_HashtableDestroyPair(htPtr, &oldPair);
+        return NkErr_Ok;
+    }
+
+    /*
+     * Simply mark the element's control byte as unused. That will cause the element to
+     * be considered free, so its data may be overwritten. The hash table implementation
+     * will never read a slot before having checked its control byte.
      */
-    NkUint32 const where2Find = __NkInt_HashtableLocKey(htPtr, keyPtr);
+    NkHashtablePair oldPair;
+
+    NkUint32 const where2Find = __NkInt_HashtableLocKey(htPtr, keyPtr, __NkInt_HashtableHash(htPtr, keyPtr));
     if (where2Find == UINT32_MAX)
         return NkErr_ItemNotFound;
-    htPtr->mp_elemArray[where2Find].m_isUsed = NK_FALSE;
+    __NkInt_HashtableEraseSlot(htPtr, where2Find, &oldPair);
 
     /*
      * If the user provided a custom key and element destructor function when the hash
      * table was created, call this destructor on the key and the element that are to be
      * erased.
      */
-    if (htPtr->m_htProps.mp_fnElemFree != NULL) {
-        /* Determine the key pointer that is to be passed. */
-        NkVoid *key2Pass = NK_INRANGE_INCL(htPtr->m_htProps.m_keyType, NkHtKeyTy_String, NkHtKeyTy_Uuid) 
-            ? &htPtr->mp_elemArray[where2Find].m_regPair.m_keyVal
-            : NULL
-        ;
-        
-        /* Call the destructor. */
-        (*htPtr->m_htProps.mp_fnElemFree)(key2Pass, htPtr->mp_elemArray[where2Find].m_regPair.mp_valuePtr);
-    }
-
-    --htPtr->m_elemCount;
+    __NkInt_HashtableDestroyPair(htPtr, &oldPair);
     return NkErr_Ok;
 }
 
@@ -610,17 +1191,24 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableAt(
     NK_ASSERT(keyPtr != NULL, NkErr_InParameter);
     NK_ASSERT(valPtr != NULL, NkErr_OutptrParameter);
 
+    /* For concurrent hash tables, look the key up in the current snapshot. */
+    if (htPtr->mp_concCxt != NULL) {
+        LONG parVal;
+
+        NkErrorCode const errorCode = NkHashtableAt(__NkInt_HashtableReadBegin(htPtr->mp_concCxt, &parVal), keyPtr, valPtr);
+        __NkInt_HashtableReadEnd(htPtr->mp_concCxt, parVal);
+        return errorCode;
+    }
+
     /* Find the key. */
-    NkUint32 const where2Find = __NkInt_HashtableLocKey(htPtr, keyPtr);
+    NkUint32 const where2Find = __NkInt_HashtableLocKey(htPtr, keyPtr, __NkInt_HashtableHash(htPtr, keyPtr));
     if (where2Find == UINT32_MAX) {
         *valPtr = NULL;
 
         return NkErr_ItemNotFound;
     }
-    __NkInt_HashtableExtPair *entryPtr = (__NkInt_HashtableExtPair *)&htPtr->mp_elemArray[where2Find];
-
     /* Get the value. */
-    *valPtr = entryPtr->m_regPair.mp_valuePtr;
+    *valPtr = htPtr->mp_elemArray[htPtr->mp_indexArray[where2Find]].mp_valuePtr;
     return NkErr_Ok;
 }
 
@@ -633,23 +1221,54 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableExtract(
     NK_ASSERT(keyPtr != NULL, NkErr_InParameter);
     NK_ASSERT(valuePtr != NULL, NkErr_OutptrParameter);
 
+    /*
+     * For concurrent hash tables, erase from a copy and publish it. The key is only
+     * destroyed once no reader can see it anymore.
+     */
+    if (htPtr->mp_concCxt != NULL) {
+        NkHashtable *snapPtr;
+
+        NkErrorCode const errorCode = __NkInt_HashtableWriteBegin(htPtr, &snapPtr);
+        if (errorCode != NkErr_Ok) {
+            *valuePtr = NULL;
+
+            return errorCode;
+        }
+
+        NkUint32 const where2Find = __NkInt_HashtableLocKey(snapPtr, keyPtr, __NkInt_HashtableHash(snapPtr, keyPtr));
+        if (where2Find == UINT32_MAX) {
+            __NkInt_HashtableWriteEnd(htPtr, snapPtr, NK_FALSE);
+
+            *valuePtr = NULL;
+            return NkErr_ItemNotFound;
+        }
+        NkHashtablePair oldPair;
+        __NkInt_HashtableEraseSlot(snapPtr, where2Find, &oldPair);
+
+        __NkInt_HashtableWriteEnd(htPtr, snapPtr, NK_TRUE);
+        if (htPtr->m_htProps.mp_fnElemFree)
+            (*htPtr->m_htProps.mp_fnElemFree)(&oldPair.m_keyVal, NULL);
+
+        *valuePtr = oldPair.mp_valuePtr;
+        return NkErr_Ok;
+    }
+
     /* Find key. */
-    NkUint32 const where2Find = __NkInt_HashtableLocKey(htPtr, keyPtr);
+    NkUint32 const where2Find = __NkInt_HashtableLocKey(htPtr, keyPtr, __NkInt_HashtableHash(htPtr, keyPtr));
     if (where2Find == UINT32_MAX) {
         *valuePtr = NULL;
 
         return NkErr_ItemNotFound;
     }
-    __NkInt_HashtableExtPair *entryPtr = (__NkInt_HashtableExtPair *)&htPtr->mp_elemArray[where2Find];
+    /* Mark the slot as unused. */
+    NkHashtablePair oldPair;
+    __NkInt_HashtableEraseSlot(htPtr, where2Find, &oldPair);
 
-    /* Let user destruct the key. */
+    /* Let user destruct the key and return stored value pointer. */
     if (htPtr->m_htProps.mp_fnElemFree)
-        (*htPtr->m_htProps.mp_fnElemFree)(&entryPtr->m_regPair.m_keyVal, NULL);
+        (*htPtr->m_htProps.mp_fnElemFree)(&oldPair.m_keyVal, NULL);
 
-    /* Set "valid" bit to 0 and return stored value pointer. */
-    entryPtr->m_isUsed = NK_FALSE;
-    *valuePtr = entryPtr->m_regPair.mp_valuePtr;
-    --htPtr->m_elemCount;
+    *valuePtr = oldPair.mp_valuePtr;
     return NkErr_Ok;
 }
 
@@ -658,7 +1277,15 @@ NkBoolean NK_CALL NkHashtableContains(_In_ NkHashtable const *htPtr, _In_ NkHash
     NK_ASSERT(htPtr != NULL, NkErr_InParameter);
     NK_ASSERT(keyPtr != NULL, NkErr_InParameter);
 
-    return __NkInt_HashtableLocKey(htPtr, keyPtr) ^ UINT32_MAX;
+    if (htPtr->mp_concCxt != NULL) {
+        LONG parVal;
+
+        NkBoolean const resVal = NkHashtableContains(__NkInt_HashtableReadBegin(htPtr->mp_concCxt, &parVal), keyPtr);
+        __NkInt_HashtableReadEnd(htPtr->mp_concCxt, parVal);
+        return resVal;
+    }
+
+    return __NkInt_HashtableLocKey(htPtr, keyPtr, __NkInt_HashtableHash(htPtr, keyPtr)) ^ UINT32_MAX;
 }
 
 _Return_ok_ NkErrorCode NK_CALL NkHashtableForEach(_In_ NkHashtable const *htPtr, _In_ NkHashtableIterFn fnIter) {
@@ -666,29 +1293,101 @@ _Return_ok_ NkErrorCode NK_CALL NkHashtableForEach(_In_ NkHashtable const *htPtr
     NK_ASSERT(fnIter != NULL, NkErr_CallbackParameter);
 
     /*
-     * Iterate over all valid slots, calling the provided iterator function on each of
-     * them.
+     * For concurrent hash tables, iterate over the current snapshot. Changes made while
+     * iterating are not visible to the iteration.
      */
-    NkErrorCode errorCode = NkErr_NoOperation;
-    for (NkUint32 i = 0, j = 0; i < htPtr->m_currCap && j < htPtr->m_elemCount; i++) {
-        __NkInt_HashtableExtPair *pairPtr = (__NkInt_HashtableExtPair *)&htPtr->mp_elemArray[i];
-        if (pairPtr->m_isUsed == NK_FALSE)
-            continue;
+    if (htPtr->mp_concCxt != NULL) {
+        LONG parVal;
 
+        NkErrorCode const errorCode = NkHashtableForEach(__NkInt_HashtableReadBegin(htPtr->mp_concCxt, &parVal), fnIter);
+        __NkInt_HashtableReadEnd(htPtr->mp_concCxt, parVal);
+        return errorCode;
+    }
+
+    /*
+     * Iterate over the pair array, calling the provided iterator function on each pair.
+     * Only live pairs are stored in it, so no slot has to be skipped.
+     */
+    NkErrorCode errorCode = NkErr_NoOperation;
+    for (NkUint32 i = 0; i < htPtr->m_elemCount; i++) {
         /*
          * If the iterator function returns non-zero, interpret this as the signal to
          * terminate iteration.
          */
-        if ((errorCode = (*fnIter)(&pairPtr->m_regPair)) != NkErr_Ok)
+        if ((errorCode = (*fnIter)(&htPtr->mp_elemArray[i])) != NkErr_Ok)
             return errorCode;
     }
 
     return errorCode;
 }
 
+_Return_ok_ NkErrorCode NK_CALL NkHashtableParallelForEach(_In_ NkHashtable const *htPtr, _In_ NkHashtableIterFn fnIter) {
+    NK_ASSERT(htPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(fnIter != NULL, NkErr_CallbackParameter);
+
+    /* For concurrent hash tables, keep the current snapshot alive until all jobs finished. */
+    if (htPtr->mp_concCxt != NULL) {
+        LONG parVal;
+
+        NkErrorCode const errorCode = NkHashtableParallelForEach(__NkInt_HashtableReadBegin(htPtr->mp_concCxt, &parVal), fnIter);
+        __NkInt_HashtableReadEnd(htPtr->mp_concCxt, parVal);
+        return errorCode;
+    }
+    if (htPtr->m_elemCount == 0)
+        return NkErr_NoOperation;
+
+    /* Determine the number of chunks; small tables are not worth splitting. */
+    NkUint32 const nElems    = htPtr->m_elemCount;
+    NkUint32 const nChunks   = NK_MIN(
+        NK_MIN(NkJobGetWorkerCount() + 1, NK_HT_PARMAXCHUNKS),
+        (nElems + NK_HT_PARMINCHUNK - 1) / NK_HT_PARMINCHUNK
+    );
+    NkUint32 const chunkSize = (nElems + nChunks - 1) / nChunks;
+
+    __NkInt_HashtableChunk chunkArr[NK_HT_PARMAXCHUNKS];
+    NkJobDescription       jobArr[NK_HT_PARMAXCHUNKS];
+    NkJobCounter           jobCnt    = { 0 };
+    LONG volatile          isAborted = 0;
+    for (NkUint32 i = 0; i < nChunks; i++) {
+        chunkArr[i] = (__NkInt_HashtableChunk){
+            .mp_elemArray = htPtr->mp_elemArray,
+            .m_sInd       = NK_MIN(i * chunkSize, nElems),
+            .m_eInd       = NK_MIN((i + 1) * chunkSize, nElems),
+            .mp_fnIter    = fnIter,
+            .mp_isAborted = &isAborted,
+            .m_errCode    = NkErr_Ok
+        };
+        jobArr[i] = (NkJobDescription){ &__NkInt_HashtableRunChunk, &chunkArr[i] };
+    }
+
+    /* The first chunk is always run on the calling thread. */
+    NkErrorCode const subCode = nChunks > 1 ? NkJobSubmit(&jobArr[1], nChunks - 1, NULL, &jobCnt) : NkErr_Ok;
+
+    __NkInt_HashtableRunChunk(&chunkArr[0]);
+    if (subCode != NkErr_Ok) {
+        for (NkUint32 i = 1; i < nChunks; i++)
+            __NkInt_HashtableRunChunk(&chunkArr[i]);
+    } else if (nChunks > 1)
+        NkJobWait(&jobCnt);
+
+    /* Propagate the first error in array order. */
+    for (NkUint32 i = 0; i < nChunks; i++)
+        if (chunkArr[i].m_errCode != NkErr_Ok)
+            return chunkArr[i].m_errCode;
+    return NkErr_Ok;
+}
+
 NkUint32 NK_CALL NkHashtableCount(_In_ NkHashtable const *htPtr) {
     NK_ASSERT(htPtr != NULL, NkErr_InParameter);
 
+    if (htPtr->mp_concCxt != NULL) {
+        LONG parVal;
+
+        NkUint32 const elemCount = __NkInt_HashtableReadBegin(htPtr->mp_concCxt, &parVal)->m_elemCount;
+        __NkInt_HashtableReadEnd(htPtr->mp_concCxt, parVal);
+        return elemCount;
+    }
+
     return htPtr->m_elemCount;
 }
 
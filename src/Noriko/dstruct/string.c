@@ -37,6 +37,7 @@
 
 /* stdlib includes */
 #include <string.h>
+#include <stdio.h>
 
 /* Noriko includes */
 #include <include/Noriko/alloc.h>
@@ -46,18 +47,110 @@
 
 
 /** \cond INTERNAL */
+/**
+ * \def   NK_STRING_INLINESIZE
+ * \brief size of the buffer embedded into every string, in bytes (incl. <tt>NUL</tt>)
+ */
+#define NK_STRING_INLINESIZE ((NkUint32)(40))
+
 /**
  * \struct __NkInt_String
  * \brief  represents the internal implementation of the public \c NkString type
+ *
+ * Strings that fit into \c NK_STRING_INLINESIZE bytes are stored directly inside the
+ * string object, so short strings do not require a heap allocation. A string uses its
+ * inline buffer if and only if \c m_currSize is not greater than
+ * <tt>NK_STRING_INLINESIZE</tt>. Since the inline buffer is not referenced by pointer,
+ * strings remain trivially relocatable.
  */
 NK_NATIVE typedef struct __NkInt_String {
     NkUint32  m_currSize; /**< current size in bytes of the string buffer */
-    NkUint32  m_currLen;  /**< current length of string, in bytes (incl. <tt>NUL</tt>) */
+    NkUint32  m_currLen;  /**< current length of string, in bytes (excl. <tt>NUL</tt>) */
 
-    char     *mp_charBuf; /**< raw string buffer (always <tt>NUL</tt>-terminated) */
+    union {
+        char *mp_charBuf;                     /**< heap string buffer (always <tt>NUL</tt>-terminated) */
+        char  m_inlBuf[NK_STRING_INLINESIZE]; /**< inline string buffer (always <tt>NUL</tt>-terminated) */
+    };
 } __NkInt_String;
 NK_VERIFY_TYPE(NkString, __NkInt_String);
 
+/**
+ * \def   NK_ROPE_DEFCHUNKSIZE
+ * \brief default number of bytes stored in a rope chunk
+ */
+#define NK_ROPE_DEFCHUNKSIZE ((NkUint32)(1 << 16))
+
+/**
+ * \struct __NkInt_RopeChunk
+ * \brief  represents a single chunk of a rope
+ * \note   The character buffer is allocated with one extra byte so that formatting
+ *         functions can always write their <tt>NUL</tt>-terminator.
+ */
+NK_NATIVE typedef struct __NkInt_RopeChunk {
+    struct __NkInt_RopeChunk *mp_nextChunk; /**< next chunk in the rope */
+    NkUint32                  m_chunkSize;  /**< capacity of the chunk, in bytes (excl. <tt>NUL</tt>) */
+    NkUint32                  m_currLen;    /**< number of bytes used */
+    char                      m_charBuf[];  /**< character buffer */
+} __NkInt_RopeChunk;
+
+/**
+ * \struct __NkInt_StringRope
+ * \brief  represents the internal implementation of the public \c NkStringRope type
+ */
+NK_NATIVE typedef struct __NkInt_StringRope {
+    __NkInt_RopeChunk *mp_firstChunk; /**< first chunk; \c NULL if nothing has been appended */
+    __NkInt_RopeChunk *mp_lastChunk;  /**< chunk that is appended to */
+    NkUint64           m_totalLen;    /**< total length of the rope, in bytes */
+    NkUint32           m_chunkSize;   /**< minimum capacity of new chunks, in bytes */
+    NkUint32           m_nChunks;     /**< number of chunks */
+} __NkInt_StringRope;
+NK_VERIFY_TYPE(NkStringRope, __NkInt_StringRope);
+
+
+/**
+ * \brief  retrieves the character buffer of the given string
+ * \param  [in] strPtr pointer to the string
+ * \return pointer to the first character of the string
+ */
+NK_INTERNAL NK_INLINE char *__NkInt_String_Data(_In_ __NkInt_String const *strPtr) {
+    return strPtr->m_currSize <= NK_STRING_INLINESIZE ? (char *)strPtr->m_inlBuf : strPtr->mp_charBuf;
+}
+
+/**
+ * \brief  makes sure the buffer of the given string is at least \c reqBufSize bytes large
+ * \param  [in, out] strPtr pointer to the string
+ * \param  [in] reqBufSize required buffer size, in bytes (incl. <tt>NUL</tt>)
+ * \param  [in] isExact whether to allocate exactly \c reqBufSize bytes; if this is
+ *              <tt>NK_FALSE</tt>, the buffer is grown geometrically so that repeated
+ *              appends run in amortized constant time
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   If the string is still stored inline, the contents are moved to the heap.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_String_Grow(
+    _Inout_ __NkInt_String *strPtr,
+    _In_    NkUint32 reqBufSize,
+    _In_    NkBoolean isExact
+) {
+    if (reqBufSize <= strPtr->m_currSize)
+        return NkErr_Ok;
+
+    NkUint32 const newSize = isExact ? reqBufSize : (NkUint32)NK_MIN(reqBufSize * 1.5, (double)UINT32_MAX);
+    char *newBuf = strPtr->m_currSize > NK_STRING_INLINESIZE ? strPtr->mp_charBuf : NULL;
+
+    NkErrorCode errCode = newBuf != NULL
+        ? NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newSize, (NkVoid **)&newBuf)
+        : NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newSize, 0, NK_FALSE, (NkVoid **)&newBuf)
+    ;
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    if (strPtr->m_currSize <= NK_STRING_INLINESIZE)
+        memcpy(newBuf, strPtr->m_inlBuf, strPtr->m_currLen + 1);
+    strPtr->mp_charBuf = newBuf;
+    strPtr->m_currSize = newSize;
+    return NkErr_Ok;
+}
+
 
 /**
  */
@@ -139,24 +232,34 @@ _Return_ok_ NkErrorCode NK_CALL NkStringCreate(
     NK_ASSERT(count > 0, NkErr_InParameter);
     NK_ASSERT(resPtr != NULL, NkErr_OutParameter);
 
-    /* Allocate memory for the string. */
-    NkSize const bufSize = (fromStr != NULL ? strlen(fromStr) : 1) * count + 1;
-    char *charBuf;
-    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), bufSize, 0, NK_TRUE, &charBuf);
-    if (errCode != NkErr_Ok)
-        return errCode;
+    /* Get pointer to internal string type. */
+    __NkInt_String *intStr = (__NkInt_String *)resPtr;
+
+    /*
+     * Allocate memory for the string. If the string fits into the inline buffer, no
+     * memory has to be allocated.
+     */
+    NkSize const elemLen = fromStr != NULL ? strlen(fromStr) : 1;
+    NkSize const bufSize = elemLen * count + 1;
+    if (bufSize > UINT32_MAX)
+        return NkErr_UnsignedWrapAround;
+
+    *intStr = (__NkInt_String){ .m_currSize = NK_STRING_INLINESIZE };
+    if (bufSize > NK_STRING_INLINESIZE) {
+        NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), bufSize, 0, NK_TRUE, &intStr->mp_charBuf);
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        intStr->m_currSize = (NkUint32)bufSize;
+    }
 
     /* Initialize the character buffer if necessary. */
+    char *charBuf = __NkInt_String_Data(intStr);
     for (NkUint32 i = 0; fromStr != NULL && i < count; i++)
-        memcpy(&charBuf[i * count], fromStr, (bufSize - 1) / count);
-    charBuf[bufSize] = '\0';
-
-    /* Initialize string. */
-    *(__NkInt_String *)resPtr = (__NkInt_String){
-        .m_currSize = (NkUint32)bufSize,
-        .m_currLen  = fromStr != NULL ? (NkUint32)bufSize : 0U,
-        .mp_charBuf = charBuf
-    };
+        memcpy(&charBuf[i * elemLen], fromStr, elemLen);
+
+    intStr->m_currLen = fromStr != NULL ? (NkUint32)(bufSize - 1) : 0U;
+    charBuf[intStr->m_currLen] = '\0';
     return NkErr_Ok;
 }
 
@@ -169,7 +272,7 @@ _Return_ok_ NkErrorCode NK_CALL NkStringCreateView(
     NK_ASSERT(srcPtr != NULL, NkErr_InParameter);
     NK_ASSERT(resPtr != NULL, NkErr_OutParameter);
 
-    *resPtr = __NkInt_String_CalcSubstr(((__NkInt_String *)srcPtr)->mp_charBuf, start, maxCount);
+    *resPtr = __NkInt_String_CalcSubstr(__NkInt_String_Data((__NkInt_String const *)srcPtr), start, maxCount);
     return NkErr_Ok;
 }
 
@@ -177,7 +280,10 @@ NkVoid NK_CALL NkStringDestroy(NkString *strPtr) {
     if (strPtr == NULL)
         return;
 
-    NkGPFree(((__NkInt_String *)strPtr)->mp_charBuf);
+    /* Only free the buffer if it is not the inline buffer. */
+    __NkInt_String *intStr = (__NkInt_String *)strPtr;
+    if (intStr->m_currSize > NK_STRING_INLINESIZE)
+        NkGPFree(intStr->mp_charBuf);
 }
 
 
@@ -187,8 +293,8 @@ NkVoid NK_CALL NkStringClear(_Inout_ NkString *strPtr) {
     /* Get pointer to internal string type. */
     __NkInt_String *intStr = (__NkInt_String *)strPtr;
 
-    intStr->mp_charBuf[0] = '\0';
-    intStr->m_currLen     = 0;
+    __NkInt_String_Data(intStr)[0] = '\0';
+    intStr->m_currLen = 0;
 }
 
 _Return_ok_ NkErrorCode NK_CALL NkStringJoin(
@@ -207,36 +313,106 @@ _Return_ok_ NkErrorCode NK_CALL NkStringJoin(
     /* Check if the current string + element string exceeds the current buffer. */
     NkUint32 reqBufSize;
     NkUint32 const elemStrlen = strLen == (NkUint32)(-1) ? (NkUint32)strlen(elemStr) : strLen;
-    if (!NkCheckedUint32Add(intStr->m_currLen, elemStrlen, &reqBufSize))
+    if (!NkCheckedUint32Add(intStr->m_currLen, elemStrlen + 1, &reqBufSize))
         return NkErr_UnsignedWrapAround;
-    if (reqBufSize > intStr->m_currSize) {
-        /* If the current buffer is exceeded, we must resize it. */
-        char *newBuf = intStr->mp_charBuf;
-        NkErrorCode errCode = NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkUint32)(reqBufSize * 1.5f), &newBuf);
+    NkErrorCode errCode = __NkInt_String_Grow(intStr, reqBufSize, NK_FALSE);
+    if (errCode != NkErr_Ok)
+        return errCode;
 
-        if (newBuf == NULL)
-            return errCode;
-        intStr->m_currSize = (NkUint32)(reqBufSize * 1.5f);
-    }
     /* Copy the new buffer. */
-    memcpy((NkVoid *)&intStr->mp_charBuf[intStr->m_currLen], (NkVoid const *)elemStr, (elemStrlen + 1) * sizeof(char));
+    char *charBuf = __NkInt_String_Data(intStr);
+    memcpy((NkVoid *)&charBuf[intStr->m_currLen], (NkVoid const *)elemStr, elemStrlen * sizeof(char));
+    charBuf[intStr->m_currLen + elemStrlen] = '\0';
 
     /* All good. */
     intStr->m_currLen += elemStrlen;
     return NkErr_Ok;
 }
 
+_Return_ok_ NkErrorCode NK_CALL NkStringReserve(_Inout_ NkString *strPtr, _In_ NkUint32 capBytes) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+
+    NkUint32 reqBufSize;
+    if (!NkCheckedUint32Add(capBytes, 1, &reqBufSize))
+        return NkErr_UnsignedWrapAround;
+
+    return __NkInt_String_Grow((__NkInt_String *)strPtr, reqBufSize, NK_TRUE);
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkStringAppendFormat(
+    _Inout_             NkString *strPtr,
+    _In_z_ _Format_str_ char const *fmtStr,
+    ...
+) {
+    va_list vArgs;
+    va_start(vArgs, fmtStr);
+    NkErrorCode const errCode = NkStringAppendFormatV(strPtr, fmtStr, vArgs);
+    va_end(vArgs);
+
+    return errCode;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkStringAppendFormatV(
+    _Inout_             NkString *strPtr,
+    _In_z_ _Format_str_ char const *fmtStr,
+    _In_                va_list vArgs
+) {
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(fmtStr != NULL, NkErr_InParameter);
+
+    /* Get pointer to internal string type. */
+    __NkInt_String *intStr = (__NkInt_String *)strPtr;
+
+    /*
+     * Try to format straight into the free space at the end of the buffer. The arguments
+     * are copied since they may have to be consumed a second time.
+     */
+    va_list argCopy;
+    va_copy(argCopy, vArgs);
+    char *charBuf = __NkInt_String_Data(intStr);
+    NkUint32 const freeSize = intStr->m_currSize - intStr->m_currLen;
+    int const fmtLen = vsnprintf(&charBuf[intStr->m_currLen], freeSize, fmtStr, argCopy);
+    va_end(argCopy);
+    if (fmtLen < 0) {
+        charBuf[intStr->m_currLen] = '\0';
+
+        return NkErr_InParameter;
+    }
+
+    if ((NkUint32)fmtLen >= freeSize) {
+        /*
+         * The text did not fit. Throw away the truncated output, grow the buffer and
+         * format again.
+         */
+        charBuf[intStr->m_currLen] = '\0';
+
+        NkUint32 reqBufSize;
+        if (!NkCheckedUint32Add(intStr->m_currLen, (NkUint32)fmtLen + 1, &reqBufSize))
+            return NkErr_UnsignedWrapAround;
+        NkErrorCode errCode = __NkInt_String_Grow(intStr, reqBufSize, NK_FALSE);
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        charBuf = __NkInt_String_Data(intStr);
+        vsnprintf(&charBuf[intStr->m_currLen], (NkSize)fmtLen + 1, fmtStr, vArgs);
+    }
+
+    /* All good. */
+    intStr->m_currLen += (NkUint32)fmtLen;
+    return NkErr_Ok;
+}
+
 
 NkUint32 NK_CALL NkStringGetLength(_In_ NkString const *strPtr) {
     NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
 
-    return __NkInt_String_Strlen(((__NkInt_String *)strPtr)->mp_charBuf);
+    return __NkInt_String_Strlen(__NkInt_String_Data((__NkInt_String const *)strPtr));
 }
 
 char const *NK_CALL NkStringAt(_In_ NkString const *strPtr, _In_ NkUint32 off) {
     NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
     
-    char const *currIter = ((__NkInt_String *)strPtr)->mp_charBuf;
+    char const *currIter = __NkInt_String_Data((__NkInt_String const *)strPtr);
     while (off != 0) {
         currIter += __NkInt_String_CharSize(currIter);
 
@@ -256,6 +432,223 @@ char const *NK_CALL NkStringIterate(_In_z_ _Utf8_ char const *strPtr) {
 }
 
 
+
+/** \cond INTERNAL */
+/**
+ * \brief  appends a new chunk to the given rope
+ * \param  [in, out] ropePtr pointer to the rope
+ * \param  [in] minSize minimum capacity of the new chunk, in bytes (excl. <tt>NUL</tt>)
+ * \param  [out] chunkPtr pointer to a variable that receives the pointer to the new chunk
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_StringRope_AddChunk(
+    _Inout_  __NkInt_StringRope *ropePtr,
+    _In_     NkUint32 minSize,
+    _Outptr_ __NkInt_RopeChunk **chunkPtr
+) {
+    NkUint32 const chunkSize = NK_MAX(minSize, ropePtr->m_chunkSize);
+
+    __NkInt_RopeChunk *newChunk;
+    NkErrorCode errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof *newChunk + (NkSize)chunkSize + 1,
+        0,
+        NK_FALSE,
+        (NkVoid **)&newChunk
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+    newChunk->mp_nextChunk = NULL;
+    newChunk->m_chunkSize  = chunkSize;
+    newChunk->m_currLen    = 0;
+
+    /* Link the chunk. */
+    if (ropePtr->mp_lastChunk != NULL)
+        ropePtr->mp_lastChunk->mp_nextChunk = newChunk;
+    else
+        ropePtr->mp_firstChunk = newChunk;
+    ropePtr->mp_lastChunk = newChunk;
+    ++ropePtr->m_nChunks;
+
+    *chunkPtr = newChunk;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  appends the characters of a chunk to the given string
+ * \param  [in] chunkView view of the chunk
+ * \param  [in, out] extraCxt pointer to the string
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL NkErrorCode NK_CALL __NkInt_StringRope_FlattenChunk(
+    _In_        NkStringView const *chunkView,
+    _Inout_opt_ NkVoid *extraCxt
+) {
+    if (chunkView->m_sizeInBytes == 0)
+        return NkErr_Ok;
+
+    return NkStringJoin((NkString *)extraCxt, chunkView->mp_dataPtr, (NkUint32)chunkView->m_sizeInBytes);
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkStringRopeCreate(
+    _In_opt_ NkUint32 chunkSize,
+    _Out_    NkStringRope *resPtr
+) {
+    NK_ASSERT(resPtr != NULL, NkErr_OutParameter);
+
+    *(__NkInt_StringRope *)resPtr = (__NkInt_StringRope){
+        .m_chunkSize = chunkSize != 0 ? chunkSize : NK_ROPE_DEFCHUNKSIZE
+    };
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkStringRopeDestroy(_Inout_opt_ NkStringRope *ropePtr) {
+    if (ropePtr == NULL)
+        return;
+
+    /* Free all chunks. */
+    __NkInt_StringRope *intRope = (__NkInt_StringRope *)ropePtr;
+    for (__NkInt_RopeChunk *currChunk = intRope->mp_firstChunk, *nextChunk; currChunk != NULL; currChunk = nextChunk) {
+        nextChunk = currChunk->mp_nextChunk;
+
+        NkGPFree(currChunk);
+    }
+
+    *intRope = (__NkInt_StringRope){ .m_chunkSize = intRope->m_chunkSize };
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkStringRopeAppend(
+    _Inout_       NkStringRope *ropePtr,
+    _In_z_ _Utf8_ char const *elemStr,
+    _In_opt_      NkUint32 strLen
+) {
+    NK_ASSERT(ropePtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(elemStr != NULL, NkErr_InParameter);
+
+    /* Get pointer to internal rope type. */
+    __NkInt_StringRope *intRope = (__NkInt_StringRope *)ropePtr;
+
+    NkUint32 remLen = strLen == (NkUint32)(-1) ? (NkUint32)strlen(elemStr) : strLen;
+    if (remLen == 0)
+        return NkErr_NoOperation;
+
+    /* Fill the free space of the last chunk first. */
+    __NkInt_RopeChunk *lastChunk = intRope->mp_lastChunk;
+    if (lastChunk != NULL) {
+        NkUint32 const copyLen = NK_MIN(remLen, lastChunk->m_chunkSize - lastChunk->m_currLen);
+
+        memcpy(&lastChunk->m_charBuf[lastChunk->m_currLen], elemStr, copyLen);
+        lastChunk->m_currLen += copyLen;
+        intRope->m_totalLen  += copyLen;
+
+        elemStr += copyLen;
+        remLen  -= copyLen;
+    }
+
+    /* Store the rest in a new chunk that is large enough to hold all of it. */
+    if (remLen > 0) {
+        NkErrorCode errCode = __NkInt_StringRope_AddChunk(intRope, remLen, &lastChunk);
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        memcpy(lastChunk->m_charBuf, elemStr, remLen);
+        lastChunk->m_currLen = remLen;
+        intRope->m_totalLen += remLen;
+    }
+
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkStringRopeAppendFormat(
+    _Inout_             NkStringRope *ropePtr,
+    _In_z_ _Format_str_ char const *fmtStr,
+    ...
+) {
+    NK_ASSERT(ropePtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(fmtStr != NULL, NkErr_InParameter);
+
+    /* Get pointer to internal rope type. */
+    __NkInt_StringRope *intRope = (__NkInt_StringRope *)ropePtr;
+
+    /* Try to format into the free space of the last chunk. */
+    va_list vArgs;
+    __NkInt_RopeChunk *lastChunk = intRope->mp_lastChunk;
+    NkUint32 const freeSize = lastChunk != NULL ? lastChunk->m_chunkSize - lastChunk->m_currLen : 0;
+    char fmtBuf[1];
+
+    va_start(vArgs, fmtStr);
+    int const fmtLen = vsnprintf(lastChunk != NULL ? &lastChunk->m_charBuf[lastChunk->m_currLen] : fmtBuf, (NkSize)freeSize + 1, fmtStr, vArgs);
+    va_end(vArgs);
+    if (fmtLen < 0)
+        return NkErr_InParameter;
+
+    if ((NkUint32)fmtLen > freeSize) {
+        /* The text did not fit; format it again into a new chunk. */
+        NkErrorCode errCode = __NkInt_StringRope_AddChunk(intRope, (NkUint32)fmtLen, &lastChunk);
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        va_start(vArgs, fmtStr);
+        vsnprintf(lastChunk->m_charBuf, (NkSize)fmtLen + 1, fmtStr, vArgs);
+        va_end(vArgs);
+    }
+
+    /* All good. */
+    lastChunk->m_currLen += (NkUint32)fmtLen;
+    intRope->m_totalLen  += (NkUint32)fmtLen;
+    return NkErr_Ok;
+}
+
+NkUint64 NK_CALL NkStringRopeGetLength(_In_ NkStringRope const *ropePtr) {
+    NK_ASSERT(ropePtr != NULL, NkErr_InParameter);
+
+    return ((__NkInt_StringRope const *)ropePtr)->m_totalLen;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkStringRopeForEachChunk(
+    _In_        NkStringRope const *ropePtr,
+    _In_        NkStringRopeChunkFn chunkFn,
+    _Inout_opt_ NkVoid *extraCxt
+) {
+    NK_ASSERT(ropePtr != NULL, NkErr_InParameter);
+    NK_ASSERT(chunkFn != NULL, NkErr_CallbackParameter);
+
+    __NkInt_StringRope const *intRope = (__NkInt_StringRope const *)ropePtr;
+    for (__NkInt_RopeChunk const *currChunk = intRope->mp_firstChunk; currChunk != NULL; currChunk = currChunk->mp_nextChunk) {
+        NkStringView const chunkView = {
+            .mp_dataPtr    = (char *)currChunk->m_charBuf,
+            .m_sizeInBytes = (NkSize)currChunk->m_currLen
+        };
+
+        NkErrorCode errCode = (*chunkFn)(&chunkView, extraCxt);
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkStringRopeFlatten(
+    _In_    NkStringRope const *ropePtr,
+    _Inout_ NkString *strPtr
+) {
+    NK_ASSERT(ropePtr != NULL, NkErr_InParameter);
+    NK_ASSERT(strPtr != NULL, NkErr_InOutParameter);
+
+    /* Grow the string once so that joining the chunks never reallocates. */
+    NkUint64 const finalLen = (NkUint64)((__NkInt_String const *)strPtr)->m_currLen + NkStringRopeGetLength(ropePtr);
+    if (finalLen >= UINT32_MAX)
+        return NkErr_UnsignedWrapAround;
+    NkErrorCode errCode = NkStringReserve(strPtr, (NkUint32)finalLen);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    return NkStringRopeForEachChunk(ropePtr, &__NkInt_StringRope_FlattenChunk, (NkVoid *)strPtr);
+}
+
+
 #undef NK_NAMESPACE
 
 
@@ -27,13 +27,34 @@
 #include <include/Noriko/util.h>
 #include <include/Noriko/platform.h>
 #include <include/Noriko/sort.h>
+#include <include/Noriko/job.h>
 
 #include <include/Noriko/dstruct/vector.h>
 
 
+/**
+ * \def   NK_VECTOR_INLINECAP
+ * \brief number of elements that can be stored without allocating a separate buffer
+ */
+#define NK_VECTOR_INLINECAP ((NkSize)(8))
+/**
+ * \def   NK_VECTOR_PARMINCHUNK
+ * \brief minimum number of elements a single job of <tt>NkVectorParallelForEach()</tt>
+ *        iterates over
+ */
+#define NK_VECTOR_PARMINCHUNK ((NkSize)(256))
+/**
+ * \def   NK_VECTOR_PARMAXCHUNKS
+ * \brief maximum number of chunks <tt>NkVectorParallelForEach()</tt> splits the range
+ *        into
+ */
+#define NK_VECTOR_PARMAXCHUNKS ((NkSize)(16))
+
 /**
  * \struct NkVector
  * \brief  internal definition of the vector data-structure 
+ * \note   As long as the capacity does not exceed <tt>NK_VECTOR_INLINECAP</tt>,
+ *         \c mp_dataPtr points to \c m_inlBuf and no separate buffer is allocated.
  */
 struct NkVector {
     NkSize             m_elemCount;                    /**< current number of elements stored */
@@ -41,7 +62,8 @@ struct NkVector {
     NkVectorProperties m_vecProps;                     /**< vector properties */
     NkVoid             (NK_CALL *mp_fnDest)(NkVoid *); /**< custom element destructor */
 
-    NkVoid **mp_dataPtr; /**< raw pointer to the internal array */
+    NkVoid **mp_dataPtr;                    /**< raw pointer to the internal array */
+    NkVoid  *m_inlBuf[NK_VECTOR_INLINECAP]; /**< inline storage for small vectors */
 };
 
 
@@ -132,8 +154,39 @@ NK_INTERNAL NkErrorCode __NkInt_VectorTryFreeRange(
  * \param  [in] newCap new capacity of the internal buffer
  * \return see return codes of NkReallocateMemory
  * \see    NkReallocateMemory
+ * \note   If \c newCap fits into the inline buffer, the elements are moved there and the
+ *         separate buffer is freed. Likewise, the elements are moved out of the inline
+ *         buffer once \c newCap exceeds it.
  */
 NK_INTERNAL NkErrorCode __NkInt_VectorResizeBuffer(_Inout_ NkVector *vecPtr, _In_ NkSize newCap) {
+    NkBoolean const isInline = vecPtr->mp_dataPtr == vecPtr->m_inlBuf;
+
+    if (newCap <= NK_VECTOR_INLINECAP) {
+        if (!isInline) {
+            memcpy(
+                (NkVoid *)vecPtr->m_inlBuf,
+                (NkVoid const *)vecPtr->mp_dataPtr,
+                NK_MIN(vecPtr->m_elemCount, newCap) * sizeof(NkVoid *)
+            );
+
+            NkGPFree(vecPtr->mp_dataPtr);
+            vecPtr->mp_dataPtr = vecPtr->m_inlBuf;
+        }
+
+        return NkErr_Ok;
+    }
+    if (isInline) {
+        NkVoid **newBuf;
+
+        NkErrorCode const errorCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof(NkVoid *), 0, NK_FALSE, &newBuf);
+        if (errorCode != NkErr_Ok)
+            return errorCode;
+
+        memcpy((NkVoid *)newBuf, (NkVoid const *)vecPtr->m_inlBuf, vecPtr->m_elemCount * sizeof(NkVoid *));
+        vecPtr->mp_dataPtr = newBuf;
+        return NkErr_Ok;
+    }
+
     return NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof(NkVoid *), (NkVoid *)&vecPtr->mp_dataPtr);
 }
 
@@ -156,6 +209,38 @@ NK_INTERNAL NkVoid __NkInt_VectorCopyBuffer(
 ) {
     memcpy((NkVoid *)&vecPtr->mp_dataPtr[index], (NkVoid const *)elemArray, nElems * sizeof(NkVoid *));
 }
+
+/**
+ * \struct __NkInt_VectorChunk
+ * \brief  represents a contiguous range of elements that is iterated over by a single job
+ *         of <tt>NkVectorParallelForEach()</tt>
+ */
+NK_NATIVE typedef struct __NkInt_VectorChunk {
+    NkVoid        **mp_dataPtr;    /**< internal array of the vector */
+    NkSize          m_sInd;        /**< index of the first element of the chunk */
+    NkSize          m_eInd;        /**< index one past the last element of the chunk */
+    NkVoid         *mp_extraParam; /**< extra parameter passed to \c mp_fnCallback */
+    LONG volatile  *mp_isAborted;  /**< set as soon as any chunk's callback returned non-zero */
+    NkErrorCode     m_errCode;     /**< return value of the callback that ended the chunk */
+
+    NkErrorCode (NK_CALL *mp_fnCallback)(NkVoid *, NkVoid *, NkSize); /**< iteration callback */
+} __NkInt_VectorChunk;
+
+/**
+ * \brief runs the iteration callback on all elements of the given chunk
+ * \param [in,out] extraCxt pointer to the <tt>__NkInt_VectorChunk</tt> instance
+ * \note  The chunk stops early once the callback of any chunk returned non-zero.
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_VectorRunChunk(_Inout_opt_ NkVoid *extraCxt) {
+    __NkInt_VectorChunk *chunkPtr = (__NkInt_VectorChunk *)extraCxt;
+
+    for (NkSize i = chunkPtr->m_sInd; i < chunkPtr->m_eInd && *chunkPtr->mp_isAborted == 0; i++)
+        if ((chunkPtr->m_errCode = (*chunkPtr->mp_fnCallback)(chunkPtr->mp_dataPtr[i], chunkPtr->mp_extraParam, i)) != NkErr_Ok) {
+            InterlockedExchange(chunkPtr->mp_isAborted, 1);
+
+            return;
+        }
+}
 /** \endcond */
 
 
@@ -172,14 +257,21 @@ _Return_ok_ NkErrorCode NK_CALL NkVectorCreate(
     NkErrorCode errorCode = NkErr_Ok;
     if ((errorCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **vecPtr, 1, vecPtr)) != NkErr_Ok)
         return errorCode;
-    /* Allocate memory for internal buffer. */
-    NkSize const initCap = sizeof *vecPtr * vecPropsPtr->m_initialCap;
-    errorCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), initCap, NK_FALSE, 0, (NkVoid **)&(*vecPtr)->mp_dataPtr);
-    if (errorCode != NkErr_Ok) {
-        NkPoolFree(*vecPtr);
+    /*
+     * Allocate memory for internal buffer. Small vectors use the inline buffer and do
+     * not need a separate allocation.
+     */
+    (*vecPtr)->mp_dataPtr = (*vecPtr)->m_inlBuf;
+    if (vecPropsPtr->m_initialCap > NK_VECTOR_INLINECAP) {
+        NkSize const initCap = sizeof *vecPtr * vecPropsPtr->m_initialCap;
 
-        *vecPtr = NULL;
-        return errorCode;
+        errorCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), initCap, 0, NK_FALSE, (NkVoid **)&(*vecPtr)->mp_dataPtr);
+        if (errorCode != NkErr_Ok) {
+            NkPoolFree(*vecPtr);
+
+            *vecPtr = NULL;
+            return errorCode;
+        }
     }
 
     /* Copy properties. */
@@ -201,7 +293,8 @@ NkVoid NK_CALL NkVectorDestroy(_Uninit_ptr_ NkVector **vecPtr) {
         __NkInt_VectorTryFreeRange(*vecPtr, NK_VECTOR_BEGIN(*vecPtr), NK_VECTOR_END(*vecPtr) - 1);
 
     /* Free parent structure and buffer memory. */
-    NkGPFree((*vecPtr)->mp_dataPtr);
+    if ((*vecPtr)->mp_dataPtr != (*vecPtr)->m_inlBuf)
+        NkGPFree((*vecPtr)->mp_dataPtr);
     NkPoolFree(*vecPtr);
     *vecPtr = NULL;
 }
@@ -261,7 +354,7 @@ _Return_ok_ NkErrorCode NK_CALL NkVectorInsertMulti(
          * Calculate possible capacity in elements, taking into account possible hard
          * limits set at initialization.
          */
-        NkSize const newCap = NK_MAX(vecPtr->m_vecProps.m_maxCap, NK_MAX(reqSize, capAfterGrowing));
+        NkSize const newCap = NK_MIN(vecPtr->m_vecProps.m_maxCap, NK_MAX(reqSize, capAfterGrowing));
         if (newCap < reqSize)
             return NkErr_CapLimitExceeded;
 
@@ -273,7 +366,7 @@ _Return_ok_ NkErrorCode NK_CALL NkVectorInsertMulti(
     /* Shift buffer right by the needed number of slots. */
     memmove(
         (NkVoid *)&vecPtr->mp_dataPtr[index + nElems],
-        (NkVoid const *)elemArray,
+        (NkVoid const *)&vecPtr->mp_dataPtr[index],
         (vecPtr->m_elemCount - index) * sizeof(NkVoid *)
     );
 
@@ -481,7 +574,7 @@ NkVoid NK_CALL NkVectorSort(
     NK_ASSERT(eInd < vecPtr->m_elemCount, NkErr_ArrayElemOutOfBounds);
     NK_ASSERT(fnPred != NULL, NkErr_CallbackParameter);
 
-    NK_IGNORE_RETURN_VALUE(NkQuicksortPointers(vecPtr->mp_dataPtr, sInd, eInd, fnPred));
+    NK_IGNORE_RETURN_VALUE(NkIntrosortPointers(vecPtr->mp_dataPtr, sInd, eInd, fnPred));
 }
 
 NkVoid *NK_CALL NkVectorAt(_In_ NkVector const *vecPtr, _In_ NkSize index) {
@@ -528,7 +621,7 @@ _Return_ok_ NkErrorCode NK_CALL NkVectorForEach(
     NK_ASSERT(fnCallback != NULL, NkErr_CallbackParameter);
 
     NkSize const realCount = NK_MIN(maxN, vecPtr->m_elemCount - sInd);
-    for (NkSize i = sInd; i <= sInd + realCount; i++) {
+    for (NkSize i = sInd; i < sInd + realCount; i++) {
         NkVoid *elemPtr = vecPtr->mp_dataPtr[i];
 
         /* Run callback on each element; return if the callback returns non-zero. */
@@ -540,6 +633,61 @@ _Return_ok_ NkErrorCode NK_CALL NkVectorForEach(
     return NkErr_Ok;
 }
 
+_Return_ok_ NkErrorCode NK_CALL NkVectorParallelForEach(
+    _In_        NkVector const *vecPtr,
+    _In_opt_    NkSize sInd,
+    _In_opt_    NkSize maxN,
+    _In_        NkErrorCode (NK_CALL *fnCallback)(NkVoid *, NkVoid *, NkSize),
+    _Inout_opt_ NkVoid *extraParam
+) {
+    NK_ASSERT(vecPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(sInd < vecPtr->m_elemCount, NkErr_InvalidRange);
+    NK_ASSERT(fnCallback != NULL, NkErr_CallbackParameter);
+
+    /* Determine the number of chunks; small ranges are not worth splitting. */
+    NkSize const realCount = NK_MIN(maxN, vecPtr->m_elemCount - sInd);
+    if (realCount == 0)
+        return NkErr_Ok;
+    NkSize const nChunks   = NK_MIN(
+        NK_MIN((NkSize)NkJobGetWorkerCount() + 1, NK_VECTOR_PARMAXCHUNKS),
+        (realCount + NK_VECTOR_PARMINCHUNK - 1) / NK_VECTOR_PARMINCHUNK
+    );
+    NkSize const chunkSize = (realCount + nChunks - 1) / nChunks;
+
+    __NkInt_VectorChunk chunkArr[NK_VECTOR_PARMAXCHUNKS];
+    NkJobDescription    jobArr[NK_VECTOR_PARMAXCHUNKS];
+    NkJobCounter        jobCnt    = { 0 };
+    LONG volatile       isAborted = 0;
+    for (NkSize i = 0; i < nChunks; i++) {
+        chunkArr[i] = (__NkInt_VectorChunk){
+            .mp_dataPtr    = vecPtr->mp_dataPtr,
+            .m_sInd        = sInd + NK_MIN(i * chunkSize, realCount),
+            .m_eInd        = sInd + NK_MIN((i + 1) * chunkSize, realCount),
+            .mp_fnCallback = fnCallback,
+            .mp_extraParam = extraParam,
+            .mp_isAborted  = &isAborted,
+            .m_errCode     = NkErr_Ok
+        };
+        jobArr[i] = (NkJobDescription){ &__NkInt_VectorRunChunk, &chunkArr[i] };
+    }
+
+    /* The first chunk is always run on the calling thread. */
+    NkErrorCode const subCode = nChunks > 1 ? NkJobSubmit(&jobArr[1], nChunks - 1, NULL, &jobCnt) : NkErr_Ok;
+
+    __NkInt_VectorRunChunk(&chunkArr[0]);
+    if (subCode != NkErr_Ok) {
+        for (NkSize i = 1; i < nChunks; i++)
+            __NkInt_VectorRunChunk(&chunkArr[i]);
+    } else if (nChunks > 1)
+        NkJobWait(&jobCnt);
+
+    /* Propagate the first error in iteration order. */
+    for (NkSize i = 0; i < nChunks; i++)
+        if (chunkArr[i].m_errCode != NkErr_Ok)
+            return chunkArr[i].m_errCode;
+    return NkErr_Ok;
+}
+
 NkVoid **NK_CALL NkVectorGetBuffer(_In_ NkVector const *vecPtr, _In_opt_ NkSize sInd) {
     NK_ASSERT(vecPtr != NULL, NkErr_InParameter);
     NK_ASSERT(sInd < vecPtr->m_elemCap, NkErr_ArrayOutOfBounds);
@@ -570,7 +718,7 @@ NkVectorProperties const *NK_CALL NkVectorDefaultProperties(NkVoid) {
     /** \endcond */
     NK_INTERNAL NkVectorProperties const gl_DefaultVectorProperties = {
         .m_structSize = sizeof gl_DefaultVectorProperties,
-        .m_initialCap = 16,
+        .m_initialCap = 8,
         .m_minCap     = 8,
         .m_maxCap     = SIZE_MAX - 1,
         .m_growFactor = 1.5f
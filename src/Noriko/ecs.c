@@ -0,0 +1,410 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  ecs.c
+ * \brief implements the entity-component storage
+ *
+ * Every pool maps entity slots to component indices through a sparse array that is
+ * indexed by slot, and back through a dense array of owners. Removing a component moves
+ * the last component of the pool into the gap so that the field arrays never have holes.
+ * Every entity slot additionally keeps a bit mask of the component types it has, which
+ * makes destroying an entity independent of the number of registered types.
+ */
+#define NK_NAMESPACE "nk::ecs"
+
+
+/* stdlib includes */
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/ecs.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/log.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \brief builds an entity identifier from a slot index and a generation
+ */
+#define __NkInt_Ecs_MakeEntity(ind, gen) ((NkEcsEntity)(gen) << 32 | (NkEcsEntity)(ind))
+/**
+ * \brief extracts the slot index of an entity identifier
+ */
+#define __NkInt_Ecs_EntityIndex(ent)     ((NkUint32)((ent) & 0xFFFFFFFF))
+/**
+ * \brief extracts the generation of an entity identifier
+ */
+#define __NkInt_Ecs_EntityGen(ent)       ((NkUint32)((ent) >> 32))
+
+
+/**
+ * \struct __NkInt_EcsPool
+ * \brief  represents the storage of all components of one type
+ */
+NK_NATIVE typedef struct __NkInt_EcsPool {
+    NkUint32     m_nFields;                      /**< number of fields */
+    NkUint32     m_fieldSizes[NK_ECS_MAXFIELDS]; /**< size of every field, in bytes */
+    NkByte      *mp_fieldArr[NK_ECS_MAXFIELDS];  /**< densely-packed array of every field */
+    NkEcsEntity *mp_ownerArr;                    /**< owner of every component */
+    NkUint32    *mp_sparseArr;                   /**< component index of every entity slot */
+    NkUint32     m_sparseCap;                    /**< number of elements of <tt>mp_sparseArr</tt> */
+    NkUint32     m_nComps;                       /**< number of components */
+    NkUint32     m_compCap;                      /**< capacity of the dense arrays */
+} __NkInt_EcsPool;
+
+
+/**
+ * \struct NkEcsRegistry
+ * \brief  internal definition of the entity registry
+ */
+struct NkEcsRegistry {
+    NkUint32        *mp_genArr;              /**< current generation of every entity slot */
+    NkUint32        *mp_maskArr;             /**< component types of every entity slot */
+    NkUint32        *mp_freeArr;             /**< stack of free entity slots */
+    NkUint32         m_nSlots;               /**< number of entity slots ever used */
+    NkUint32         m_nFree;                /**< number of elements in <tt>mp_freeArr</tt> */
+    NkUint32         m_slotCap;              /**< capacity of the slot arrays */
+    NkUint32         m_nTypes;               /**< number of registered component types */
+    __NkInt_EcsPool  m_poolArr[NK_ECS_MAXTYPES]; /**< pool of every component type */
+};
+
+
+/**
+ * \brief  grows an array to the given number of elements
+ * \param  [in, out] arrPtr pointer to the variable holding the array
+ * \param  [in] nElems new number of elements
+ * \param  [in] elemSize size of an element, in bytes
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Ecs_Grow(_Inout_ NkVoid **arrPtr, _In_ NkSize nElems, _In_ NkSize elemSize) {
+    return *arrPtr == NULL
+        ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nElems * elemSize, 0, NK_FALSE, arrPtr)
+        : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), nElems * elemSize, arrPtr)
+    ;
+}
+
+/**
+ * \brief  makes sure that the slot arrays have room for at least one more slot
+ * \param  [in, out] regPtr pointer to the entity registry
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Ecs_ReserveSlot(_Inout_ NkEcsRegistry *regPtr) {
+    if (regPtr->m_nSlots < regPtr->m_slotCap)
+        return NkErr_Ok;
+    if (regPtr->m_slotCap >= UINT32_MAX / 2)
+        return NkErr_CapLimitExceeded;
+
+    NkUint32 const newCap  = NK_MAX(regPtr->m_slotCap * 2, (NkUint32)64);
+    NkErrorCode    errCode;
+    if (   (errCode = __NkInt_Ecs_Grow((NkVoid **)&regPtr->mp_genArr, newCap, sizeof *regPtr->mp_genArr)) != NkErr_Ok
+        || (errCode = __NkInt_Ecs_Grow((NkVoid **)&regPtr->mp_maskArr, newCap, sizeof *regPtr->mp_maskArr)) != NkErr_Ok
+        || (errCode = __NkInt_Ecs_Grow((NkVoid **)&regPtr->mp_freeArr, newCap, sizeof *regPtr->mp_freeArr)) != NkErr_Ok
+    ) return errCode;
+
+    regPtr->m_slotCap = newCap;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  makes sure that the pool has room for one more component and that its sparse
+ *         array covers the given entity slot
+ * \param  [in, out] poolPtr pointer to the pool
+ * \param  [in] slotInd entity slot
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Ecs_ReservePool(_Inout_ __NkInt_EcsPool *poolPtr, _In_ NkUint32 slotInd) {
+    NkErrorCode errCode;
+
+    if (slotInd >= poolPtr->m_sparseCap) {
+        NkUint32 const newCap = NK_MAX(NK_MAX(poolPtr->m_sparseCap * 2, slotInd + 1), (NkUint32)64);
+
+        if ((errCode = __NkInt_Ecs_Grow((NkVoid **)&poolPtr->mp_sparseArr, newCap, sizeof *poolPtr->mp_sparseArr)) != NkErr_Ok)
+            return errCode;
+        /* NK_ECS_NOINDEX has all bits set, so the new slots can be initialized byte-wise. */
+        memset(&poolPtr->mp_sparseArr[poolPtr->m_sparseCap], 0xFF, (NkSize)(newCap - poolPtr->m_sparseCap) * sizeof *poolPtr->mp_sparseArr);
+        poolPtr->m_sparseCap = newCap;
+    }
+
+    if (poolPtr->m_nComps < poolPtr->m_compCap)
+        return NkErr_Ok;
+    NkUint32 const newCap = NK_MAX(poolPtr->m_compCap * 2, (NkUint32)64);
+    if ((errCode = __NkInt_Ecs_Grow((NkVoid **)&poolPtr->mp_ownerArr, newCap, sizeof *poolPtr->mp_ownerArr)) != NkErr_Ok)
+        return errCode;
+    for (NkUint32 i = 0; i < poolPtr->m_nFields; i++)
+        if ((errCode = __NkInt_Ecs_Grow((NkVoid **)&poolPtr->mp_fieldArr[i], newCap, poolPtr->m_fieldSizes[i])) != NkErr_Ok)
+            return errCode;
+
+    poolPtr->m_compCap = newCap;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief removes the component of the given entity slot from the pool
+ * \param [in, out] poolPtr pointer to the pool
+ * \param [in] slotInd entity slot that has a component in the pool
+ */
+NK_INTERNAL NkVoid __NkInt_Ecs_PoolErase(_Inout_ __NkInt_EcsPool *poolPtr, _In_ NkUint32 slotInd) {
+    NkUint32 const compInd = poolPtr->mp_sparseArr[slotInd];
+    NkUint32 const lastInd = --poolPtr->m_nComps;
+
+    /* Fill the gap with the last component. */
+    if (compInd != lastInd) {
+        for (NkUint32 i = 0; i < poolPtr->m_nFields; i++)
+            memcpy(
+                poolPtr->mp_fieldArr[i] + (NkSize)compInd * poolPtr->m_fieldSizes[i],
+                poolPtr->mp_fieldArr[i] + (NkSize)lastInd * poolPtr->m_fieldSizes[i],
+                poolPtr->m_fieldSizes[i]
+            );
+
+        NkEcsEntity const movedEnt = poolPtr->mp_ownerArr[lastInd];
+        poolPtr->mp_ownerArr[compInd] = movedEnt;
+        poolPtr->mp_sparseArr[__NkInt_Ecs_EntityIndex(movedEnt)] = compInd;
+    }
+    poolPtr->mp_sparseArr[slotInd] = NK_ECS_NOINDEX;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkEcsCreate(
+    _In_       NkEcsRegistrySpecification const *regSpec,
+    _Init_ptr_ NkEcsRegistry **regPtr
+) {
+    NK_ASSERT(regSpec != NULL && regSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(regPtr != NULL, NkErr_OutptrParameter);
+
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **regPtr, 0, NK_TRUE, (NkVoid **)regPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* Reserve memory for the slots up-front if requested. */
+    NkEcsRegistry *actReg = *regPtr;
+    if (regSpec->m_initCap > 0) {
+        NkUint32 const initCap = regSpec->m_initCap;
+
+        if (   (errCode = __NkInt_Ecs_Grow((NkVoid **)&actReg->mp_genArr, initCap, sizeof *actReg->mp_genArr)) != NkErr_Ok
+            || (errCode = __NkInt_Ecs_Grow((NkVoid **)&actReg->mp_maskArr, initCap, sizeof *actReg->mp_maskArr)) != NkErr_Ok
+            || (errCode = __NkInt_Ecs_Grow((NkVoid **)&actReg->mp_freeArr, initCap, sizeof *actReg->mp_freeArr)) != NkErr_Ok
+        ) {
+            NkEcsDestroy(regPtr);
+
+            return errCode;
+        }
+        actReg->m_slotCap = initCap;
+    }
+
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkEcsDestroy(_Uninit_ptr_ NkEcsRegistry **regPtr) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+
+    if (*regPtr == NULL)
+        return;
+    NkEcsRegistry *actReg = *regPtr;
+
+    for (NkUint32 i = 0; i < actReg->m_nTypes; i++) {
+        __NkInt_EcsPool *poolPtr = &actReg->m_poolArr[i];
+
+        for (NkUint32 j = 0; j < poolPtr->m_nFields; j++)
+            NkGPFree(poolPtr->mp_fieldArr[j]);
+        NkGPFree(poolPtr->mp_ownerArr);
+        NkGPFree(poolPtr->mp_sparseArr);
+    }
+    NkGPFree(actReg->mp_freeArr);
+    NkGPFree(actReg->mp_maskArr);
+    NkGPFree(actReg->mp_genArr);
+    NkGPFree(actReg);
+    *regPtr = NULL;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkEcsRegisterComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentSpecification const *compSpec,
+    _Out_   NkEcsComponentType *typePtr
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(compSpec != NULL && compSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(compSpec->m_nFields > 0 && compSpec->m_nFields <= NK_ECS_MAXFIELDS, NkErr_InParameter);
+    NK_ASSERT(typePtr != NULL, NkErr_OutParameter);
+
+    if (regPtr->m_nTypes == NK_ECS_MAXTYPES)
+        return NkErr_CapLimitExceeded;
+
+    __NkInt_EcsPool *poolPtr = &regPtr->m_poolArr[regPtr->m_nTypes];
+    poolPtr->m_nFields = compSpec->m_nFields;
+    for (NkUint32 i = 0; i < compSpec->m_nFields; i++) {
+        NK_ASSERT(compSpec->m_fieldSizes[i] > 0, NkErr_InParameter);
+
+        poolPtr->m_fieldSizes[i] = compSpec->m_fieldSizes[i];
+    }
+
+    *typePtr = (NkEcsComponentType)regPtr->m_nTypes++;
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkEcsCreateEntity(_Inout_ NkEcsRegistry *regPtr, _Out_ NkEcsEntity *entPtr) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(entPtr != NULL, NkErr_OutParameter);
+
+    /* Reuse the slot that was freed last; it is the most likely one to be in the cache. */
+    NkUint32 slotInd;
+    if (regPtr->m_nFree > 0)
+        slotInd = regPtr->mp_freeArr[--regPtr->m_nFree];
+    else {
+        NkErrorCode const errCode = __NkInt_Ecs_ReserveSlot(regPtr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        /* Generation 0 is never used so that no identifier equals NK_ECS_NULLENTITY. */
+        slotInd = regPtr->m_nSlots++;
+        regPtr->mp_genArr[slotInd] = 1;
+    }
+    regPtr->mp_maskArr[slotInd] = 0;
+
+    *entPtr = __NkInt_Ecs_MakeEntity(slotInd, regPtr->mp_genArr[slotInd]);
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkEcsDestroyEntity(_Inout_ NkEcsRegistry *regPtr, _In_ NkEcsEntity entId) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+
+    if (!NkEcsIsAlive(regPtr, entId))
+        return;
+    NkUint32 const slotInd = __NkInt_Ecs_EntityIndex(entId);
+
+    /* Only visit the pools the entity actually has a component in. */
+    for (NkUint32 compMask = regPtr->mp_maskArr[slotInd]; compMask != 0; compMask &= compMask - 1) {
+        NkUint32 typeInd = 0;
+        while ((compMask & (1u << typeInd)) == 0)
+            ++typeInd;
+
+        __NkInt_Ecs_PoolErase(&regPtr->m_poolArr[typeInd], slotInd);
+    }
+    regPtr->mp_maskArr[slotInd] = 0;
+
+    /* Invalidate all identifiers of the slot and put it up for reuse. */
+    if (++regPtr->mp_genArr[slotInd] == 0)
+        regPtr->mp_genArr[slotInd] = 1;
+    regPtr->mp_freeArr[regPtr->m_nFree++] = slotInd;
+}
+
+NkBoolean NK_CALL NkEcsIsAlive(_In_ NkEcsRegistry const *regPtr, _In_ NkEcsEntity entId) {
+    NK_ASSERT(regPtr != NULL, NkErr_InParameter);
+
+    NkUint32 const slotInd = __NkInt_Ecs_EntityIndex(entId);
+    return slotInd < regPtr->m_nSlots && regPtr->mp_genArr[slotInd] == __NkInt_Ecs_EntityGen(entId);
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkEcsAddComponent(
+    _Inout_   NkEcsRegistry *regPtr,
+    _In_      NkEcsEntity entId,
+    _In_      NkEcsComponentType compType,
+    _Out_opt_ NkUint32 *indPtr
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(NkEcsIsAlive(regPtr, entId), NkErr_InParameter);
+    NK_ASSERT(compType < regPtr->m_nTypes, NkErr_InParameter);
+
+    NkUint32 const   slotInd = __NkInt_Ecs_EntityIndex(entId);
+    __NkInt_EcsPool *poolPtr = &regPtr->m_poolArr[compType];
+    if (regPtr->mp_maskArr[slotInd] & 1u << compType) {
+        if (indPtr != NULL)
+            *indPtr = poolPtr->mp_sparseArr[slotInd];
+
+        return NkErr_NoOperation;
+    }
+
+    NkErrorCode const errCode = __NkInt_Ecs_ReservePool(poolPtr, slotInd);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* Append the component to the dense arrays. */
+    NkUint32 const compInd = poolPtr->m_nComps++;
+    for (NkUint32 i = 0; i < poolPtr->m_nFields; i++)
+        memset(poolPtr->mp_fieldArr[i] + (NkSize)compInd * poolPtr->m_fieldSizes[i], 0, poolPtr->m_fieldSizes[i]);
+    poolPtr->mp_ownerArr[compInd]  = entId;
+    poolPtr->mp_sparseArr[slotInd] = compInd;
+    regPtr->mp_maskArr[slotInd]   |= 1u << compType;
+
+    if (indPtr != NULL)
+        *indPtr = compInd;
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkEcsRemoveComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsEntity entId,
+    _In_    NkEcsComponentType compType
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(compType < regPtr->m_nTypes, NkErr_InParameter);
+
+    if (!NkEcsIsAlive(regPtr, entId))
+        return;
+    NkUint32 const slotInd = __NkInt_Ecs_EntityIndex(entId);
+    if ((regPtr->mp_maskArr[slotInd] & 1u << compType) == 0)
+        return;
+
+    __NkInt_Ecs_PoolErase(&regPtr->m_poolArr[compType], slotInd);
+    regPtr->mp_maskArr[slotInd] &= ~(1u << compType);
+}
+
+NkUint32 NK_CALL NkEcsFindComponent(
+    _In_ NkEcsRegistry const *regPtr,
+    _In_ NkEcsEntity entId,
+    _In_ NkEcsComponentType compType
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(compType < regPtr->m_nTypes, NkErr_InParameter);
+
+    if (!NkEcsIsAlive(regPtr, entId))
+        return NK_ECS_NOINDEX;
+
+    /* The entity may have been created after the pool's sparse array was last grown. */
+    __NkInt_EcsPool const *poolPtr = &regPtr->m_poolArr[compType];
+    NkUint32 const         slotInd = __NkInt_Ecs_EntityIndex(entId);
+    return slotInd < poolPtr->m_sparseCap ? poolPtr->mp_sparseArr[slotInd] : NK_ECS_NOINDEX;
+}
+
+NkUint32 NK_CALL NkEcsQueryCount(_In_ NkEcsRegistry const *regPtr, _In_ NkEcsComponentType compType) {
+    NK_ASSERT(regPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(compType < regPtr->m_nTypes, NkErr_InParameter);
+
+    return regPtr->m_poolArr[compType].m_nComps;
+}
+
+NkVoid *NK_CALL NkEcsQueryField(
+    _In_ NkEcsRegistry const *regPtr,
+    _In_ NkEcsComponentType compType,
+    _In_ NkUint32 fieldInd
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(compType < regPtr->m_nTypes, NkErr_InParameter);
+    NK_ASSERT(fieldInd < regPtr->m_poolArr[compType].m_nFields, NkErr_InParameter);
+
+    __NkInt_EcsPool const *poolPtr = &regPtr->m_poolArr[compType];
+    return poolPtr->m_nComps > 0 ? (NkVoid *)poolPtr->mp_fieldArr[fieldInd] : NULL;
+}
+
+NkEcsEntity const *NK_CALL NkEcsQueryOwners(_In_ NkEcsRegistry const *regPtr, _In_ NkEcsComponentType compType) {
+    NK_ASSERT(regPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(compType < regPtr->m_nTypes, NkErr_InParameter);
+
+    __NkInt_EcsPool const *poolPtr = &regPtr->m_poolArr[compType];
+    return poolPtr->m_nComps > 0 ? poolPtr->mp_ownerArr : NULL;
+}
+
+
+#undef NK_NAMESPACE
+
+
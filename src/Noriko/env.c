@@ -20,6 +20,11 @@
  * lifetime of the application. Synchronization is not necessary since the command-line
  * arguments are constant.
  *
+ * Every option is converted to all types it can be read as once, while parsing. Options
+ * that are read repeatedly should be resolved to a handle with <tt>NkEnvResolve()</tt>
+ * once; reading a typed value through a handle is then a single load that involves
+ * neither a hash table lookup nor a variant copy.
+ *
  * \warning Due to the nature of the command-line arguments storage, it should not be
  *          accessed in functions that can be called after \c main() has returned such as
  *          functions registered in <tt>atexit()</tt>.
@@ -39,6 +44,25 @@
 
 
 /** \cond INTERNAL */
+/**
+ * \struct NkEnvOption
+ * \brief  represents a parsed option along with all typed interpretations of its value
+ *
+ * The typed values are computed once when the option is parsed so that reading an option
+ * through a handle never has to inspect or copy the variant.
+ */
+struct NkEnvOption {
+    NkVariant    m_optVal;   /**< parsed value; \c NkVarTy_None for options without value */
+    NkStringView m_strVal;   /**< value as string (only valid if \c m_isString is set) */
+    NkDouble     m_dblVal;   /**< value as floating-point number */
+    NkInt64      m_intVal;   /**< value as integer */
+    NkBoolean    m_boolVal;  /**< value as boolean */
+    NkBoolean    m_isNumber; /**< whether \c m_dblVal and \c m_intVal hold the value */
+    NkBoolean    m_isBool;   /**< whether \c m_boolVal holds the value */
+    NkBoolean    m_isString; /**< whether \c m_strVal holds the value */
+};
+
+
 /**
  * \brief global hash table that holds the key-value store to the 
  */
@@ -48,12 +72,55 @@ NK_INTERNAL NkHashtable *gl_EnvStore = NULL;
 /**
  * \brief frees the key and value memory
  * \param [in] keyPtr pointer to the hashtable key
- * \param [in] varPtr pointer to the value
+ * \param [in] optPtr pointer to the value
  */
-NK_INTERNAL NkVoid NK_CALL __NkInt_EnvFreeElem(_Inout_ NkHashtableKey *keyPtr, _Inout_ NkVariant *varPtr) {
+NK_INTERNAL NkVoid NK_CALL __NkInt_EnvFreeElem(_Inout_ NkHashtableKey *keyPtr, _Inout_ NkEnvOption *optPtr) {
     /* Destroy the key. It's always a pool-allocated pointer to a string view. */
     NkPoolFree(keyPtr->mp_svKey);
-    NkPoolFree(varPtr);
+    NkPoolFree(optPtr);
+}
+
+/**
+ * \brief computes the typed interpretations of a parsed value
+ * \param [in] varPtr pointer to the parsed value
+ * \param [out] optPtr pointer to the option that is to be initialized
+ */
+NK_INTERNAL NkVoid __NkInt_EnvCompileOption(_In_ NkVariant const *varPtr, _Out_ NkEnvOption *optPtr) {
+    NkVariantCopy(varPtr, &optPtr->m_optVal);
+    optPtr->m_strVal   = (NkStringView){ .mp_dataPtr = NULL, .m_sizeInBytes = 0 };
+    optPtr->m_dblVal   = 0.;
+    optPtr->m_intVal   = 0;
+    optPtr->m_boolVal  = NK_FALSE;
+    optPtr->m_isNumber = optPtr->m_isBool = optPtr->m_isString = NK_FALSE;
+
+    NkVariantType varTy;
+    NkVariantGet(varPtr, &varTy, NULL);
+    switch (varTy) {
+        case NkVarTy_None:
+            /* Options without value are flags; passing them switches them on. */
+            optPtr->m_boolVal = optPtr->m_isBool = NK_TRUE;
+
+            break;
+        case NkVarTy_Boolean:
+            NkVariantGet(varPtr, NULL, &optPtr->m_boolVal);
+
+            optPtr->m_isBool = NK_TRUE;
+            break;
+        case NkVarTy_Double:
+            NkVariantGet(varPtr, NULL, &optPtr->m_dblVal);
+
+            optPtr->m_intVal   = (NkInt64)optPtr->m_dblVal;
+            optPtr->m_boolVal  = optPtr->m_dblVal != 0.;
+            optPtr->m_isNumber = optPtr->m_isBool = NK_TRUE;
+            break;
+        case NkVarTy_StringView:
+            NkVariantGet(varPtr, NULL, &optPtr->m_strVal);
+
+            optPtr->m_isString = NK_TRUE;
+            break;
+        default:
+            break;
+    }
 }
 
 /**
@@ -143,19 +210,18 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_EnvParseNumber(
  *              command-line options
  * \param  [out] keyPtr pointer to a variable that will receive the pointer to the
  *               newly-allocated and initialized key
- * \param  [out] valPtr pointer to a variable that will receive the pointer to the
- *               newly-allocated and initialized value (can be unmodified if there is no
- *               value)
+ * \param  [out] optPtr pointer to a variable that will receive the pointer to the
+ *               newly-allocated and initialized option
  * \return \c NkErr_Ok on success, non-zero on failure
- * \note   \li The \c valPtr parameter is not modified when there is no value to be
- *         parsed.
- * \note   \li Upon error, both \c keyPtr and \c valPtr are initialized to <tt>NULL</tt>.
+ * \note   \li If there is no value to be parsed, the option is a flag whose value is of
+ *         type <tt>NkVarTy_None</tt>.
+ * \note   \li Upon error, both \c keyPtr and \c optPtr are initialized to <tt>NULL</tt>.
  */
 NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_EnvParsePair(
     _In_z_           char const *optStr,
     _In_             NkBoolean expectPrefix,
-    _Init_ptr_       NkStringView **keyPtr,
-    _Init_ptr_maybe_ NkVariant **valPtr
+    _Init_ptr_ NkStringView **keyPtr,
+    _Init_ptr_ NkEnvOption **optPtr
 ) {
     /*
      * Skip the param identifier prefix if necessary. It can be one of the following
@@ -172,7 +238,7 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_EnvParsePair(
     }
 
     /* Get the identifier and value strings. */
-    NkVariant tmpResult;
+    NkVariant tmpResult = { 0 };
     NkStringView paramNameStr, paramValStr, trimmedNameStr, trimmedValStr, tmpSvVal;
     /* First, split them by searching for the first delimiter. */
     NkRawStringSplit(startPtr, "=:", &paramNameStr, &paramValStr);
@@ -225,7 +291,8 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_EnvParsePair(
              * Try parsing it as a boolean value first. If the value does not correspond
              * to a boolean constant, parse it as a string instead.
              */
-            for (NkUint32 i = 0; i < NK_ARRAYSIZE(gl_BoolMappings); i++)
+            NkUint32 i = 0;
+            for (; i < NK_ARRAYSIZE(gl_BoolMappings); i++)
                 if (NkStringViewCompare(&gl_BoolMappings[i].m_strVal, &trimmedValStr) == 0) {
                     NkVariantSet(&tmpResult, NkVarTy_Boolean, gl_BoolMappings[i].m_strMapping);
 
@@ -233,7 +300,8 @@ NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_EnvParsePair(
                 }
 
             /* Parse as a string instead. */
-            NkVariantSet(&tmpResult, NkVarTy_StringView, &trimmedValStr);
+            if (i == NK_ARRAYSIZE(gl_BoolMappings))
+                NkVariantSet(&tmpResult, NkVarTy_StringView, &trimmedValStr);
         }
     }
 
@@ -242,21 +310,17 @@ lbl_MAKERESULTS:
     errorCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof trimmedNameStr, 1, keyPtr);
     if (errorCode != NkErr_Ok)
         return errorCode;
-    if (trimmedValStr.m_sizeInBytes != 0) {
-        errorCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof tmpResult, 1, valPtr);
-        if (errorCode != NkErr_Ok) {
-            NkPoolFree(*keyPtr);
-
-            *(NkVoid **)keyPtr = *(NkVoid **)valPtr = NULL;
-            return errorCode;
-        }
+    errorCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **optPtr, 1, optPtr);
+    if (errorCode != NkErr_Ok) {
+        NkPoolFree(*keyPtr);
 
-        /* Copy value. */
-        NkVariantCopy(&tmpResult, *valPtr);
-    } else *valPtr = NULL;
+        *(NkVoid **)keyPtr = *(NkVoid **)optPtr = NULL;
+        return errorCode;
+    }
 
-    /* Copy key. */
+    /* Copy key and value. */
     NkStringViewCopy(&trimmedNameStr, *keyPtr);
+    __NkInt_EnvCompileOption(&tmpResult, *optPtr);
     return NkErr_Ok;
 }
 
@@ -282,11 +346,11 @@ NK_INTERNAL NkVoid __NkInt_EnvParseOptionArray(
 
     for (NkUint32 i = 0; i < optCount; i++) {
         NkStringView *keyPtr  = NULL;
-        NkVariant    *varPtr  = NULL;
+        NkEnvOption  *optPtr  = NULL;
         NkErrorCode   errCode = NkErr_Ok;
         
         /* Parse the pair. */
-        errCode = __NkInt_EnvParsePair(optArray[i], hasPrefix, &keyPtr, &varPtr);
+        errCode = __NkInt_EnvParsePair(optArray[i], hasPrefix, &keyPtr, &optPtr);
         if (errCode != NkErr_Ok)
             continue;
         /*
@@ -313,7 +377,7 @@ NK_INTERNAL NkVoid __NkInt_EnvParseOptionArray(
             gl_EnvStore,
             &(NkHashtablePair){
                 .m_keyVal    = (NkHashtableKey){ .mp_svKey = keyPtr },
-                .mp_valuePtr = varPtr
+                .mp_valuePtr = optPtr
             }
         );
         if (errCode == NkErr_Ok)
@@ -321,7 +385,7 @@ NK_INTERNAL NkVoid __NkInt_EnvParseOptionArray(
 
 lbl_DELPAIR:
         NkPoolFree(keyPtr);
-        NkPoolFree(varPtr);
+        NkPoolFree(optPtr);
     }
 }
 
@@ -401,23 +465,54 @@ _Return_ok_ NkErrorCode NK_CALL NkEnvGetValue(_In_z_ char const *keyStr, _Out_ N
     NK_ASSERT(valPtr != NULL, NkErr_OutParameter);
 
     /* Get the value associated with the parameter/environment variable. */
-    NkVariant *varPtr;
+    NkEnvOption *optPtr;
     NkStringView keyAsSv;
     NkErrorCode const errCode = NkHashtableAt(
         (NkHashtable const *)gl_EnvStore,
         &(NkHashtableKey const) {
             .mp_svKey = NkStringViewSet(keyStr, &keyAsSv)
         },
-        &varPtr
+        &optPtr
     );
     if (errCode != NkErr_Ok)
         return errCode;
 
     /* Get copy of value. */
-    NkVariantCopy(varPtr, valPtr);
+    NkVariantCopy(&optPtr->m_optVal, valPtr);
     return NkErr_Ok;
 }
 
+NkEnvHandle NK_CALL NkEnvResolve(_In_z_ char const *keyStr) {
+    NK_ASSERT(keyStr != NULL, NkErr_InParameter);
+
+    NkEnvOption *optPtr;
+    NkStringView keyAsSv;
+    NkErrorCode const errCode = NkHashtableAt(
+        (NkHashtable const *)gl_EnvStore,
+        &(NkHashtableKey const) {
+            .mp_svKey = NkStringViewSet(keyStr, &keyAsSv)
+        },
+        &optPtr
+    );
+
+    return errCode == NkErr_Ok ? optPtr : NULL;
+}
+
+NkInt64 NK_CALL NkEnvGetInt(_In_opt_ NkEnvHandle envHandle, _In_ NkInt64 defVal) {
+    return envHandle != NULL && envHandle->m_isNumber ? envHandle->m_intVal : defVal;
+}
+
+NkDouble NK_CALL NkEnvGetDouble(_In_opt_ NkEnvHandle envHandle, _In_ NkDouble defVal) {
+    return envHandle != NULL && envHandle->m_isNumber ? envHandle->m_dblVal : defVal;
+}
+
+NkBoolean NK_CALL NkEnvGetBool(_In_opt_ NkEnvHandle envHandle, _In_ NkBoolean defVal) {
+    return envHandle != NULL && envHandle->m_isBool ? envHandle->m_boolVal : defVal;
+}
+
+NkStringView const *NK_CALL NkEnvGetString(_In_opt_ NkEnvHandle envHandle) {
+    return envHandle != NULL && envHandle->m_isString ? &envHandle->m_strVal : NULL;
+}
 
 /**
  */
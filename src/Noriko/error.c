@@ -107,7 +107,16 @@ NK_INTERNAL NkStringView const gl_c_ErrorCodeStringTable[] = {
     NK_MAKE_STRING_VIEW(NK_ESC(NkErr_InvStreamMode)),
     NK_MAKE_STRING_VIEW(NK_ESC(NkErr_InvSeekOrigin)),
     NK_MAKE_STRING_VIEW(NK_ESC(NkErr_StreamSeek)),
-    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_StreamFlush))
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_StreamFlush)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_CreateGraphicsDevice)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_CreateGpuResource)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_CompileShader)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_CreateThread)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_RegisterInputDevice)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_MapFile)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_CorruptedData)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_ExecuteSqlStatement)),
+    NK_MAKE_STRING_VIEW(NK_ESC(NkErr_OpenDirectory))
 };
 static_assert(NK_ARRAYSIZE(gl_c_ErrorCodeStringTable) == __NkErr_Count__, "Error code string array mismatch!");
 
@@ -177,7 +186,16 @@ NK_INTERNAL NkStringView const gl_c_ErrorCodeDescriptionTable[] = {
     NK_MAKE_STRING_VIEW("inappropriate stream I/O mode for the requested operation"),
     NK_MAKE_STRING_VIEW("invalid seek origin identifier"),
     NK_MAKE_STRING_VIEW("could not seek the given position"),
-    NK_MAKE_STRING_VIEW("could not flush stream")
+    NK_MAKE_STRING_VIEW("could not flush stream"),
+    NK_MAKE_STRING_VIEW("could not create graphics device or swap chain (unsupported feature level? driver error?)"),
+    NK_MAKE_STRING_VIEW("failed to create GPU resource (buffer, texture, view, state object, ...)"),
+    NK_MAKE_STRING_VIEW("could not compile shader program (syntax error? unsupported shader model?)"),
+    NK_MAKE_STRING_VIEW("could not create thread (resource limit reached?)"),
+    NK_MAKE_STRING_VIEW("failed to register input device"),
+    NK_MAKE_STRING_VIEW("could not map file into memory (file locked? address space exhausted?)"),
+    NK_MAKE_STRING_VIEW("data is corrupted or truncated"),
+    NK_MAKE_STRING_VIEW("could not execute SQL statement"),
+    NK_MAKE_STRING_VIEW("could not open directory")
 };
 static_assert(NK_ARRAYSIZE(gl_c_ErrorCodeDescriptionTable) == __NkErr_Count__, "Error code desc array mismatch!");
 
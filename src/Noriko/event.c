@@ -21,6 +21,10 @@
  * is propagated through the layer stack until the entire stack has been traversed or the
  * event has been handled.
  * 
+ * Events can also be posted to a bounded, lock-free multiple-producer single-consumer
+ * queue from any thread. The queue is drained once per frame by the main loop, before the
+ * game is updated, so that posting threads never enter the layer stack themselves.
+ * 
  * \note  Note that this event system is for application- and host-system events, not for
  *        in-game events.
  */
@@ -35,6 +39,8 @@
 #include <include/Noriko/event.h>
 #include <include/Noriko/timer.h>
 #include <include/Noriko/layer.h>
+#include <include/Noriko/noriko.h>
+#include <include/Noriko/platform.h>
 
 
 /** \cond INTERNAL */
@@ -49,6 +55,7 @@ NK_NATIVE typedef struct __NkInt_EventTypeInfo {
     NkEventCategory m_evCat;      /**< numeric event categories the event type is associated to */
     NkSize          m_dataSize;   /**< size of the (optional) additional data */
     NkBoolean       m_expectData; /**< whether or not data is required for the event type */
+    NkBoolean       m_isCoalesce; /**< whether consecutive events of this type can be merged */
 } __NkInt_EventTypeInfo;
 
 
@@ -58,68 +65,276 @@ NK_NATIVE typedef struct __NkInt_EventTypeInfo {
  */
 NK_INTERNAL __NkInt_EventTypeInfo const gl_c_EvTypeTbl[] = {
     /* technical events */
-    { NkEv_None,                NkEvCat_None,                     0,                       NK_FALSE },
+    { NkEv_None,                NkEvCat_None,                     0,                       NK_FALSE, NK_FALSE },
 
     /* window events */
-    { NkEv_WindowOpened,        NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowClosed,        NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowGotFocus,      NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowLostFocus,     NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowResized,       NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowMinimized,     NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowMaximized,     NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowRestored,      NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowMoved,         NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowFullscreen,    NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowShown,         NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
-    { NkEv_WindowHidden,        NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE  },
+    { NkEv_WindowOpened,        NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowClosed,        NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowGotFocus,      NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowLostFocus,     NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowResized,       NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_TRUE  },
+    { NkEv_WindowMinimized,     NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowMaximized,     NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowRestored,      NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowMoved,         NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowFullscreen,    NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowShown,         NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
+    { NkEv_WindowHidden,        NkEvCat_Window,                   sizeof(NkWindowEvent),   NK_TRUE,  NK_FALSE },
 
     /* keyboard events */
-    { NkEv_KeyboardKeyDown,     NkEvCat_Input | NkEvCat_Keyboard, sizeof(NkKeyboardEvent), NK_TRUE  },
-    { NkEv_KeyboardKeyUp,       NkEvCat_Input | NkEvCat_Keyboard, sizeof(NkKeyboardEvent), NK_TRUE  },
-    { NkEv_KeyboardKeyRepeated, NkEvCat_Input | NkEvCat_Keyboard, sizeof(NkKeyboardEvent), NK_TRUE  },
+    { NkEv_KeyboardKeyDown,     NkEvCat_Input | NkEvCat_Keyboard, sizeof(NkKeyboardEvent), NK_TRUE,  NK_FALSE },
+    { NkEv_KeyboardKeyUp,       NkEvCat_Input | NkEvCat_Keyboard, sizeof(NkKeyboardEvent), NK_TRUE,  NK_FALSE },
+    { NkEv_KeyboardKeyRepeated, NkEvCat_Input | NkEvCat_Keyboard, sizeof(NkKeyboardEvent), NK_TRUE,  NK_FALSE },
 
     /* mouse events */
-    { NkEv_MouseButtonDown,     NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE  },
-    { NkEv_MouseButtonUp,       NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE  },
-    { NkEv_MouseMoved,          NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE  },
-    { NkEv_MouseScrollUp,       NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE  },
-    { NkEv_MouseScrollDown,     NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE  }
+    { NkEv_MouseButtonDown,     NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE,  NK_FALSE },
+    { NkEv_MouseButtonUp,       NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE,  NK_FALSE },
+    { NkEv_MouseMoved,          NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE,  NK_TRUE  },
+    { NkEv_MouseScrollUp,       NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE,  NK_FALSE },
+    { NkEv_MouseScrollDown,     NkEvCat_Input | NkEvCat_Mouse,    sizeof(NkMouseEvent),    NK_TRUE,  NK_FALSE }
 };
 /* Verify table integrity. */
 static_assert(
     NK_ARRAYSIZE(gl_c_EvTypeTbl) == __NkEv_Count__,
     "Mismatch between event type enumeration and event type info table. Check definitions."
 );
-/** \endcond */
 
 
-_Return_ok_ NkErrorCode NK_CALL NkEventDispatch(_In_ NkEventType evType, ...) {
-    NK_ASSERT(evType > NkEv_None && evType < __NkEv_Count__, NkErr_InParameter);
+/**
+ * \def   NK_EVENT_QUEUESIZE
+ * \brief number of events the event queue can hold; must be a power of two
+ */
+#define NK_EVENT_QUEUESIZE ((NkUint32)(1024))
+static_assert((NK_EVENT_QUEUESIZE & (NK_EVENT_QUEUESIZE - 1)) == 0, "Event queue size must be a power of two.");
 
-    /* Construct the event. */
-    NkEvent specEvent = (NkEvent){
+/**
+ * \struct __NkInt_EventQueueSlot
+ * \brief  represents a single slot of the event queue
+ *
+ * Every slot carries a sequence number that tells producers and the consumer whether the
+ * slot is free for the current lap. To keep the queue valid when zero-initialized, the
+ * sequence number is stored relative to the slot's index: a slot at index \c i is free
+ * for position \c p if <tt>m_seqOff + i == p</tt> and holds the event posted at position
+ * \c p if <tt>m_seqOff + i == p + 1</tt>.
+ */
+NK_NATIVE typedef struct __NkInt_EventQueueSlot {
+    LONG volatile m_seqOff;  /**< sequence number, relative to the slot's index */
+    NkEvent       m_evData;  /**< event data */
+} __NkInt_EventQueueSlot;
+
+/**
+ * \struct __NkInt_EventQueue
+ * \brief  represents the state of the event queue
+ * \note   Write and read positions are kept on separate cache lines so that producers do
+ *         not contend with the consumer.
+ */
+NK_NATIVE typedef struct __NkInt_EventQueue {
+    alignas(64) LONG volatile m_writePos;                     /**< next position to be claimed by a producer */
+    alignas(64) LONG          m_readPos;                      /**< next position to be read by the consumer */
+    __NkInt_EventQueueSlot    m_slotArr[NK_EVENT_QUEUESIZE]; /**< event slots */
+} __NkInt_EventQueue;
+
+
+/**
+ * \brief global event queue instance
+ */
+NK_INTERNAL __NkInt_EventQueue gl_EventQueue;
+/**
+ * \brief event that is currently being merged by the coalescing stage
+ * \note  Only accessed from the main thread.
+ */
+NK_INTERNAL struct __NkInt_EventCoalesceCxt {
+    NkBoolean m_isPending; /**< whether <tt>m_pendEvent</tt> holds an event */
+    NkEvent   m_pendEvent; /**< pending event */
+} gl_EventCoalesceCxt;
+
+
+/**
+ * \brief constructs an event from the given type and the optional event data
+ * \param [in] evType numeric event type ID
+ * \param [in,out] vlArgs argument list holding a pointer to the event data, if the event
+ *                 type requires any
+ * \param [out] evPtr pointer to the \c NkEvent instance that receives the event
+ */
+NK_INTERNAL NkVoid __NkInt_EventConstruct(_In_ NkEventType evType, _Inout_ va_list *vlArgs, _Out_ NkEvent *evPtr) {
+    *evPtr = (NkEvent){
         .m_evType    = evType,
         .m_evCat     = gl_c_EvTypeTbl[evType].m_evCat,
-        .m_timestamp = NkTimerGetCurrentTicks()
+        .m_timestamp = NkTimerGetFastTicks()
     };
+
     /*
      * If the event requires additional data, query the parameter after the event type.
      * Then, if no such parameter was provided, the behavior is undefined.
      */
-    if (gl_c_EvTypeTbl[evType].m_expectData == NK_TRUE) {
-        va_list vlArgs;
-        va_start(vlArgs, evType);
+    if (gl_c_EvTypeTbl[evType].m_expectData == NK_TRUE)
+        memcpy((void *)&evPtr->m_wndEvent, va_arg(*vlArgs, void const *), gl_c_EvTypeTbl[evType].m_dataSize);
+}
+
+/**
+ * \brief  pushes a copy of the given event onto the event queue
+ * \param  [in] evPtr pointer to the event
+ * \return \c NkErr_Ok on success, \c NkErr_CapLimitExceeded if the queue is full
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_EventEnqueue(_In_ NkEvent const *evPtr) {
+    /*
+     * Claim a slot. If the slot at the current write position is still occupied by an
+     * event from the previous lap, the queue is full. If another producer claimed the
+     * position in the meantime, retry with the new position.
+     */
+    __NkInt_EventQueueSlot *slotPtr;
+    NkUint32 slotInd;
+    LONG currPos = gl_EventQueue.m_writePos;
+    for (;;) {
+        slotInd = (NkUint32)currPos & (NK_EVENT_QUEUESIZE - 1);
+        slotPtr = &gl_EventQueue.m_slotArr[slotInd];
+
+        /* Compute the difference using unsigned arithmetic; positions wrap around. */
+        NkInt32 const seqDiff = (NkInt32)((NkUint32)slotPtr->m_seqOff + slotInd - (NkUint32)currPos);
+        if (seqDiff == 0) {
+            LONG const prevPos = InterlockedCompareExchange(&gl_EventQueue.m_writePos, currPos + 1, currPos);
+
+            if (prevPos == currPos)
+                break;
+            currPos = prevPos;
+        } else if (seqDiff < 0)
+            return NkErr_CapLimitExceeded;
+        else
+            currPos = gl_EventQueue.m_writePos;
+    }
+
+    /* Copy the event into the slot, then publish it. */
+    slotPtr->m_evData = *evPtr;
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange(&slotPtr->m_seqOff, (LONG)((NkUint32)currPos + 1 - slotInd)));
+    return NkErr_Ok;
+}
+
+/**
+ * \brief merges the given event into the pending event of the same type
+ * \param [in,out] pendPtr pointer to the pending event
+ * \param [in] evPtr pointer to the newer event
+ * \note  The newer event's state wins; mouse movement deltas are accumulated.
+ */
+NK_INTERNAL NkVoid __NkInt_EventMerge(_Inout_ NkEvent *pendPtr, _In_ NkEvent const *evPtr) {
+    NkPoint2D const prevDelta = pendPtr->m_mouseEvent.m_curDelta;
+
+    *pendPtr = *evPtr;
+    if (evPtr->m_evType == NkEv_MouseMoved) {
+        pendPtr->m_mouseEvent.m_curDelta.m_xCoord += prevDelta.m_xCoord;
+        pendPtr->m_mouseEvent.m_curDelta.m_yCoord += prevDelta.m_yCoord;
+    }
+}
 
-        /* Copy the event data from the provided parameter. */
-        memcpy((void *)&specEvent.m_wndEvent, va_arg(vlArgs, void const *), gl_c_EvTypeTbl[evType].m_dataSize);
-        va_end(vlArgs);
+/**
+ * \brief hands the pending event of the coalescing stage to the event queue
+ * \note  If the queue is full, the event is dispatched immediately. This is fine since
+ *        the coalescing stage is only used on the main thread.
+ */
+NK_INTERNAL NkVoid __NkInt_EventFlushCoalesced(NkVoid) {
+    if (!gl_EventCoalesceCxt.m_isPending)
+        return;
+    gl_EventCoalesceCxt.m_isPending = NK_FALSE;
+
+    if (__NkInt_EventEnqueue(&gl_EventCoalesceCxt.m_pendEvent) != NkErr_Ok) {
+        NkApplicationRequestRedraw();
+
+        NK_IGNORE_RETURN_VALUE(NkLayerstackOnEvent(&gl_EventCoalesceCxt.m_pendEvent));
     }
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkEventDispatch(_In_ NkEventType evType, ...) {
+    NK_ASSERT(evType > NkEv_None && evType < __NkEv_Count__, NkErr_InParameter);
 
-    /* Finally, dispatch the event. */
+    /* Construct the event. */
+    NkEvent specEvent;
+    va_list vlArgs;
+    va_start(vlArgs, evType);
+    __NkInt_EventConstruct(evType, &vlArgs, &specEvent);
+    va_end(vlArgs);
+
+    /* Finally, dispatch the event. Events may change what is visible, so redraw. */
+    NkApplicationRequestRedraw();
     return NkLayerstackOnEvent(&specEvent);
 }
 
+_Return_ok_ NkErrorCode NK_CALL NkEventPost(_In_ NkEventType evType, ...) {
+    NK_ASSERT(evType > NkEv_None && evType < __NkEv_Count__, NkErr_InParameter);
+
+    /* Construct the event, then push it onto the queue. */
+    NkEvent specEvent;
+    va_list vlArgs;
+    va_start(vlArgs, evType);
+    __NkInt_EventConstruct(evType, &vlArgs, &specEvent);
+    va_end(vlArgs);
+
+    return __NkInt_EventEnqueue(&specEvent);
+}
+
+NkVoid NK_CALL NkEventPostCoalesced(_In_ NkEventType evType, ...) {
+    NK_ASSERT(evType > NkEv_None && evType < __NkEv_Count__, NkErr_InParameter);
+
+    /* Construct the event. */
+    NkEvent specEvent;
+    va_list vlArgs;
+    va_start(vlArgs, evType);
+    __NkInt_EventConstruct(evType, &vlArgs, &specEvent);
+    va_end(vlArgs);
+
+    /*
+     * If the event continues a run of events of the same coalescable type, merge it into
+     * the pending event. Otherwise, the run ends; hand it to the queue first so that the
+     * order of events is preserved.
+     */
+    if (gl_EventCoalesceCxt.m_isPending && gl_EventCoalesceCxt.m_pendEvent.m_evType == evType) {
+        __NkInt_EventMerge(&gl_EventCoalesceCxt.m_pendEvent, &specEvent);
+
+        return;
+    }
+    __NkInt_EventFlushCoalesced();
+
+    if (gl_c_EvTypeTbl[evType].m_isCoalesce) {
+        gl_EventCoalesceCxt.m_pendEvent = specEvent;
+        gl_EventCoalesceCxt.m_isPending = NK_TRUE;
+    } else if (__NkInt_EventEnqueue(&specEvent) != NkErr_Ok) {
+        NkApplicationRequestRedraw();
+
+        NK_IGNORE_RETURN_VALUE(NkLayerstackOnEvent(&specEvent));
+    }
+}
+
+NkUint32 NK_CALL NkEventDrainQueue(NkVoid) {
+    /* The run of coalesced events ends with the frame. */
+    __NkInt_EventFlushCoalesced();
+
+    /*
+     * Dispatch at most one queue's worth of events so that layers posting events while
+     * handling others cannot keep the main thread in here forever.
+     */
+    NkUint32 nDispatched = 0;
+    for (; nDispatched < NK_EVENT_QUEUESIZE; nDispatched++) {
+        LONG     const currPos = gl_EventQueue.m_readPos;
+        NkUint32 const slotInd = (NkUint32)currPos & (NK_EVENT_QUEUESIZE - 1);
+
+        __NkInt_EventQueueSlot *slotPtr = &gl_EventQueue.m_slotArr[slotInd];
+        if ((NkUint32)slotPtr->m_seqOff + slotInd != (NkUint32)currPos + 1)
+            break;
+
+        /* Copy the event out so the slot can be reused while the event is handled. */
+        NkEvent const currEvent = slotPtr->m_evData;
+        NK_IGNORE_RETURN_VALUE(InterlockedExchange(&slotPtr->m_seqOff, (LONG)((NkUint32)currPos + NK_EVENT_QUEUESIZE - slotInd)));
+        gl_EventQueue.m_readPos = currPos + 1;
+
+        NK_IGNORE_RETURN_VALUE(NkLayerstackOnEvent(&currEvent));
+    }
+
+    /* Events may change what is visible, so redraw. */
+    if (nDispatched > 0)
+        NkApplicationRequestRedraw();
+    return nDispatched;
+}
+
 NkVoid NK_CALL NkEventCopy(_In_ NkEvent const *srcPtr, _Out_ NkEvent *dstPtr) {
     NK_ASSERT(srcPtr != NULL, NkErr_InParameter);
     NK_ASSERT(dstPtr != NULL, NkErr_OutParameter);
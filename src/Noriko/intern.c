@@ -0,0 +1,294 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  intern.c
+ * \brief implements the global string interning table
+ *
+ * The views of all interned strings are stored in fixed-size pages that are indexed by
+ * the string ID. Pages are never moved or freed while the component is running, which is
+ * what allows <tt>NkStringIdGetView()</tt> to work without taking the lock; the lock
+ * only protects the hash table that maps strings to IDs and the arena.
+ */
+#define NK_NAMESPACE "nk::intern"
+
+
+/* stdlib includes */
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/intern.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/comp.h>
+
+#include <include/Noriko/dstruct/htable.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \def   __NkInt_Intern_PageSize
+ * \brief number of string views stored in a single page
+ */
+#define __NkInt_Intern_PageSize  ((NkUint32)4096)
+/**
+ * \def   __NkInt_Intern_MaxPages
+ * \brief maximum number of pages; limits the number of distinct strings
+ */
+#define __NkInt_Intern_MaxPages  ((NkUint32)1024)
+/**
+ * \def   __NkInt_Intern_BlockSize
+ * \brief default size of an arena block, in bytes
+ */
+#define __NkInt_Intern_BlockSize ((NkSize)64 * 1024)
+
+
+/**
+ * \struct __NkInt_InternBlock
+ * \brief  represents a block of the string arena
+ *
+ * The string data is stored in the same allocation, right after the structure.
+ */
+NK_NATIVE typedef struct __NkInt_InternBlock {
+    struct __NkInt_InternBlock *mp_prevBlock; /**< previously filled block */
+    NkSize                      m_usedBytes;  /**< number of bytes handed out */
+    NkSize                      m_capBytes;   /**< number of bytes of string data */
+} __NkInt_InternBlock;
+
+/**
+ * \struct __NkInt_InternContext
+ * \brief  represents the global state of the string interning table
+ */
+NK_NATIVE typedef struct __NkInt_InternContext {
+    NK_DECL_LOCK(m_mtxLock);                                  /**< protects the table and the arena */
+    NkHashtable         *mp_idTable;                          /**< maps strings to their IDs */
+    __NkInt_InternBlock *mp_currBlock;                        /**< arena block that is being filled */
+    NkUint32             m_nStrings;                          /**< number of assigned IDs, including the invalid ID */
+    NkStringView        *mp_pageArr[__NkInt_Intern_MaxPages]; /**< views of all strings, by ID */
+} __NkInt_InternContext;
+
+/**
+ * \brief actual instance of the interning table
+ */
+NK_INTERNAL __NkInt_InternContext gl_InternCxt;
+
+
+/**
+ * \brief  copies a string into the arena, appending a <tt>NUL</tt>-terminator
+ * \param  [in] strPtr string that is to be copied
+ * \param  [out] resPtr pointer to a variable that receives the copy
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The lock must be held.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Intern_CopyString(_In_ NkStringView const *strPtr, _Outptr_ char **resPtr) {
+    NkSize const reqBytes = strPtr->m_sizeInBytes + 1;
+
+    __NkInt_InternBlock *currBlock = gl_InternCxt.mp_currBlock;
+    if (currBlock == NULL || currBlock->m_capBytes - currBlock->m_usedBytes < reqBytes) {
+        /* Strings that do not fit into a default-sized block get a block of their own. */
+        NkSize const capBytes = reqBytes > __NkInt_Intern_BlockSize ? reqBytes : __NkInt_Intern_BlockSize;
+
+        NkErrorCode const errCode = NkGPAlloc(
+            NK_MAKE_ALLOCATION_CONTEXT(),
+            sizeof *currBlock + capBytes,
+            0,
+            NK_FALSE,
+            (NkVoid **)&currBlock
+        );
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        currBlock->mp_prevBlock   = gl_InternCxt.mp_currBlock;
+        currBlock->m_usedBytes    = 0;
+        currBlock->m_capBytes     = capBytes;
+        gl_InternCxt.mp_currBlock = currBlock;
+    }
+
+    *resPtr = (char *)(currBlock + 1) + currBlock->m_usedBytes;
+    memcpy(*resPtr, strPtr->mp_dataPtr, strPtr->m_sizeInBytes);
+    (*resPtr)[strPtr->m_sizeInBytes] = '\0';
+
+    currBlock->m_usedBytes += reqBytes;
+    return NkErr_Ok;
+}
+
+
+/**
+ * \brief  initializes the string interning table
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(StrIntern)(NkVoid) {
+    NkHashtableProperties const htProps = {
+        .m_structSize  = sizeof htProps,
+        .m_keyType     = NkHtKeyTy_StringView,
+        .m_initCap     = 256,
+        .m_minCap      = 256,
+        .m_maxCap      = UINT32_MAX,
+        .mp_fnElemFree = NULL
+    };
+    NkErrorCode errCode = NkHashtableCreate(&htProps, &gl_InternCxt.mp_idTable);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* The first slot of the first page belongs to the invalid ID, an empty string. */
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        __NkInt_Intern_PageSize * sizeof(NkStringView),
+        0,
+        NK_TRUE,
+        (NkVoid **)&gl_InternCxt.mp_pageArr[0]
+    );
+    if (errCode != NkErr_Ok) {
+        NkHashtableDestroy(&gl_InternCxt.mp_idTable);
+
+        return errCode;
+    }
+    gl_InternCxt.mp_pageArr[0][NK_INVALID_STRINGID] = (NkStringView)NK_MAKE_STRING_VIEW("");
+    gl_InternCxt.m_nStrings = 1;
+
+    NK_INITLOCK(gl_InternCxt.m_mtxLock);
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  frees all interned strings
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   No string ID may be used after this function returns.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(StrIntern)(NkVoid) {
+    NK_DESTROYLOCK(gl_InternCxt.m_mtxLock);
+
+    NkHashtableDestroy(&gl_InternCxt.mp_idTable);
+    for (NkUint32 i = 0; i < __NkInt_Intern_MaxPages; i++) {
+        NkGPFree(gl_InternCxt.mp_pageArr[i]);
+
+        gl_InternCxt.mp_pageArr[i] = NULL;
+    }
+    while (gl_InternCxt.mp_currBlock != NULL) {
+        __NkInt_InternBlock *prevBlock = gl_InternCxt.mp_currBlock->mp_prevBlock;
+
+        NkGPFree(gl_InternCxt.mp_currBlock);
+        gl_InternCxt.mp_currBlock = prevBlock;
+    }
+    gl_InternCxt.m_nStrings = 0;
+
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkStringIntern(
+    _In_  NkStringView const *strPtr,
+    _Out_ NkStringId *idPtr
+) {
+    NK_ASSERT(strPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(strPtr->mp_dataPtr != NULL || strPtr->m_sizeInBytes == 0, NkErr_InParameter);
+    NK_ASSERT(idPtr != NULL, NkErr_OutParameter);
+
+    NkErrorCode errCode = NkErr_Ok;
+    NkVoid     *valPtr;
+
+    NK_LOCK(gl_InternCxt.m_mtxLock);
+    if (NkHashtableAt(gl_InternCxt.mp_idTable, &(NkHashtableKey const){ .mp_svKey = (NkStringView *)strPtr }, &valPtr) == NkErr_Ok) {
+        *idPtr = (NkStringId)(uintptr_t)valPtr;
+
+        goto lbl_END;
+    }
+
+    NkStringId const newId   = gl_InternCxt.m_nStrings;
+    NkUint32 const   pageInd = newId / __NkInt_Intern_PageSize;
+    if (pageInd == __NkInt_Intern_MaxPages) {
+        errCode = NkErr_CapLimitExceeded;
+
+        goto lbl_END;
+    }
+    if (gl_InternCxt.mp_pageArr[pageInd] == NULL) {
+        errCode = NkGPAlloc(
+            NK_MAKE_ALLOCATION_CONTEXT(),
+            __NkInt_Intern_PageSize * sizeof(NkStringView),
+            0,
+            NK_FALSE,
+            (NkVoid **)&gl_InternCxt.mp_pageArr[pageInd]
+        );
+        if (errCode != NkErr_Ok)
+            goto lbl_END;
+    }
+
+    /*
+     * The view in the page doubles as the key of the hash table entry, so the key stays
+     * valid for as long as the entry exists. If the insertion fails, the ID is not
+     * assigned and the copied string is simply wasted.
+     */
+    NkStringView *viewPtr = &gl_InternCxt.mp_pageArr[pageInd][newId % __NkInt_Intern_PageSize];
+    if ((errCode = __NkInt_Intern_CopyString(strPtr, &viewPtr->mp_dataPtr)) != NkErr_Ok)
+        goto lbl_END;
+    viewPtr->m_sizeInBytes = strPtr->m_sizeInBytes;
+
+    errCode = NkHashtableInsert(gl_InternCxt.mp_idTable, &(NkHashtablePair const){
+        .m_keyVal    = { .mp_svKey = viewPtr },
+        .mp_valuePtr = (NkVoid *)(uintptr_t)newId
+    });
+    if (errCode != NkErr_Ok)
+        goto lbl_END;
+
+    ++gl_InternCxt.m_nStrings;
+    *idPtr = newId;
+
+lbl_END:
+    NK_UNLOCK(gl_InternCxt.m_mtxLock);
+
+    return errCode;
+}
+
+NkStringId NK_CALL NkStringFindId(_In_ NkStringView const *strPtr) {
+    NK_ASSERT(strPtr != NULL, NkErr_InParameter);
+
+    NkVoid    *valPtr;
+    NkStringId resId = NK_INVALID_STRINGID;
+
+    NK_LOCK(gl_InternCxt.m_mtxLock);
+    if (NkHashtableAt(gl_InternCxt.mp_idTable, &(NkHashtableKey const){ .mp_svKey = (NkStringView *)strPtr }, &valPtr) == NkErr_Ok)
+        resId = (NkStringId)(uintptr_t)valPtr;
+    NK_UNLOCK(gl_InternCxt.m_mtxLock);
+
+    return resId;
+}
+
+NkStringView const *NK_CALL NkStringIdGetView(_In_ NkStringId strId) {
+    NK_ASSERT(strId / __NkInt_Intern_PageSize < __NkInt_Intern_MaxPages, NkErr_InParameter);
+    NK_ASSERT(gl_InternCxt.mp_pageArr[strId / __NkInt_Intern_PageSize] != NULL, NkErr_InParameter);
+
+    return &gl_InternCxt.mp_pageArr[strId / __NkInt_Intern_PageSize][strId % __NkInt_Intern_PageSize];
+}
+
+
+/** \cond INTERNAL */
+/**
+ * \brief info for the string interning component
+ */
+NK_COMPONENT_DEFINE(StrIntern) {
+    .m_compUuid     = { 0x3f6c2a91, 0x4b7e, 0x4d02, 0x9a51c7e8d3b4f260 },
+    .mp_clsId       = NULL,
+    .m_compIdent    = NK_MAKE_STRING_VIEW("string interning table"),
+    .m_compFlags    = 0,
+    .m_isNkOM       = NK_FALSE,
+
+    .mp_fnQueryInst = NULL,
+    .mp_fnStartup   = &NK_COMPONENT_STARTUPFN(StrIntern),
+    .mp_fnShutdown  = &NK_COMPONENT_SHUTDOWNFN(StrIntern)
+};
+/** \endcond */
+
+
+#undef NK_NAMESPACE
+
+
@@ -0,0 +1,142 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  interp.c
+ * \brief implements the interpolation component and its batched passes
+ */
+#define NK_NAMESPACE "nk::interp"
+
+
+/* Noriko includes */
+#include <include/Noriko/interp.h>
+
+
+_Return_ok_ NkErrorCode NK_CALL NkInterpRegisterComponent(
+    _Inout_ NkEcsRegistry *regPtr,
+    _Out_   NkEcsComponentType *typePtr
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(typePtr != NULL, NkErr_OutParameter);
+
+    return NkEcsRegisterComponent(regPtr, &(NkEcsComponentSpecification){
+        .m_structSize = sizeof(NkEcsComponentSpecification),
+        .m_nFields    = __NkInterpFld_Count__,
+        .m_fieldSizes = {
+            [NkInterpFld_PrevX]   = sizeof(NkFloat),
+            [NkInterpFld_PrevY]   = sizeof(NkFloat),
+            [NkInterpFld_CurrX]   = sizeof(NkFloat),
+            [NkInterpFld_CurrY]   = sizeof(NkFloat),
+            [NkInterpFld_RenderX] = sizeof(NkFloat),
+            [NkInterpFld_RenderY] = sizeof(NkFloat),
+            [NkInterpFld_HasPrev] = sizeof(NkByte)
+        }
+    }, typePtr);
+}
+
+NkBoolean NK_CALL NkInterpCapture(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType interpType,
+    _In_    NkEcsComponentType srcType,
+    _In_    NkUint32 xField,
+    _In_    NkUint32 yField
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+
+    NkUint32 const nComps = NkEcsQueryCount(regPtr, interpType);
+    if (nComps == 0 || NkEcsQueryCount(regPtr, srcType) == 0)
+        return NK_FALSE;
+
+    NkEcsEntity const *ownerArr = NkEcsQueryOwners(regPtr, interpType);
+    NkFloat const     *srcXArr  = NkEcsQueryField(regPtr, srcType, xField);
+    NkFloat const     *srcYArr  = NkEcsQueryField(regPtr, srcType, yField);
+    NkFloat           *prevXArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_PrevX);
+    NkFloat           *prevYArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_PrevY);
+    NkFloat           *currXArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_CurrX);
+    NkFloat           *currYArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_CurrY);
+    NkByte            *hasArr   = NkEcsQueryField(regPtr, interpType, NkInterpFld_HasPrev);
+
+    NkByte isMoving = 0;
+    for (NkUint32 i = 0; i < nComps; i++) {
+        NkUint32 const srcInd = NkEcsFindComponent(regPtr, ownerArr[i], srcType);
+        if (srcInd == NK_ECS_NOINDEX)
+            continue;
+
+        /* Fresh components start at rest on the captured position. */
+        NkFloat const posX = srcXArr[srcInd];
+        NkFloat const posY = srcYArr[srcInd];
+        prevXArr[i] = hasArr[i] ? currXArr[i] : posX;
+        prevYArr[i] = hasArr[i] ? currYArr[i] : posY;
+        currXArr[i] = posX;
+        currYArr[i] = posY;
+        hasArr[i]   = 1;
+
+        isMoving |= prevXArr[i] != posX || prevYArr[i] != posY;
+    }
+    return (NkBoolean)isMoving;
+}
+
+NkVoid NK_CALL NkInterpReset(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType interpType,
+    _In_    NkUint32 compInd
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(compInd < NkEcsQueryCount(regPtr, interpType), NkErr_InParameter);
+
+    ((NkByte *)NkEcsQueryField(regPtr, interpType, NkInterpFld_HasPrev))[compInd] = 0;
+}
+
+NkVoid NK_CALL NkInterpUpdate(
+    _Inout_ NkEcsRegistry *regPtr,
+    _In_    NkEcsComponentType interpType,
+    _In_    NkFloat blendFac
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InOutParameter);
+
+    NkUint32 const nComps = NkEcsQueryCount(regPtr, interpType);
+    if (nComps == 0)
+        return;
+
+    NkFloat const  alpha    = NK_MIN(NK_MAX(blendFac, 0.f), 1.f);
+    NkFloat const *prevXArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_PrevX);
+    NkFloat const *prevYArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_PrevY);
+    NkFloat const *currXArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_CurrX);
+    NkFloat const *currYArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_CurrY);
+    NkFloat       *rendXArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_RenderX);
+    NkFloat       *rendYArr = NkEcsQueryField(regPtr, interpType, NkInterpFld_RenderY);
+
+    /* Every field lives in an array of its own, so both loops vectorize. */
+    for (NkUint32 i = 0; i < nComps; i++)
+        rendXArr[i] = prevXArr[i] + (currXArr[i] - prevXArr[i]) * alpha;
+    for (NkUint32 i = 0; i < nComps; i++)
+        rendYArr[i] = prevYArr[i] + (currYArr[i] - prevYArr[i]) * alpha;
+}
+
+NkVec2F NK_CALL NkInterpGetPosition(
+    _In_ NkEcsRegistry const *regPtr,
+    _In_ NkEcsComponentType interpType,
+    _In_ NkUint32 compInd
+) {
+    NK_ASSERT(regPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(compInd < NkEcsQueryCount(regPtr, interpType), NkErr_InParameter);
+
+    return (NkVec2F){
+        ((NkFloat const *)NkEcsQueryField(regPtr, interpType, NkInterpFld_RenderX))[compInd],
+        ((NkFloat const *)NkEcsQueryField(regPtr, interpType, NkInterpFld_RenderY))[compInd]
+    };
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -34,11 +34,24 @@
 NK_NATIVE typedef struct __NkInt_File {
     NKOM_IMPLEMENTS(NkIFile);
 
-    NkOMRefCount   m_refCount; /**< reference count */
-    NkStreamIOMode m_strMode;  /**< stream mode */
-    FILE          *mp_fileDsc; /**< file descriptor */
+    NkOMRefCount volatile  m_refCount; /**< reference count */
+    NkStreamIOMode         m_strMode;  /**< stream mode */
+    FILE                  *mp_fileDsc; /**< file descriptor */
 } __NkInt_File;
 
+/**
+ */
+NK_NATIVE typedef struct __NkInt_MappedFile {
+    NKOM_IMPLEMENTS(NkIMappedFile);
+
+    NkOMRefCount volatile  m_refCount; /**< reference count */
+    NkStreamIOMode         m_strMode;  /**< stream mode */
+    NkVoid                *mp_mapHnd;  /**< platform-dependent mapping handle */
+    NkBufferView           m_fileView; /**< view of the entire mapped file */
+    NkSize                 m_currOff;  /**< current stream position */
+    struct _stat64         m_fileStat; /**< file info, retrieved when the file was opened */
+} __NkInt_MappedFile;
+
 
 /* Define IIDs and CLSIDs for the interfaces and classes implemented here. */
 // { 7268E0CB-376C-4019-964A-8550FB3D8D9C }
@@ -53,6 +66,10 @@ NKOM_DEFINE_CLSID(NkIStream, { 0x00000000, 0x0000, 0x0000, 0x0000000000000000 })
 NKOM_DEFINE_CLSID(NkIFile, { 0x5d954d25, 0x55ff, 0x4976, 0x8afaa9ddca54f573 });
 // { 7323AD44-F5F4-4D08-ACBB-EF71EF4B3695 }
 NKOM_DEFINE_CLSID(NkIFilesystem, { 0x7323ad44, 0xf5f4, 0x4d08, 0xacbbef71ef4b3695 });
+// { 3E0C5B7A-91D4-4F6E-A2C8-6B1D0E47F935 }
+NKOM_DEFINE_IID(NkIMappedFile, { 0x3e0c5b7a, 0x91d4, 0x4f6e, 0xa2c86b1d0e47f935 });
+// { C84A2F19-5E3B-4D70-9B61-F2A7D8053CE4 }
+NKOM_DEFINE_CLSID(NkIMappedFile, { 0xc84a2f19, 0x5e3b, 0x4d70, 0x9b61f2a7d8053ce4 });
 
 
 /**
@@ -63,6 +80,25 @@ NKOM_DEFINE_CLSID(NkIFilesystem, { 0x7323ad44, 0xf5f4, 0x4d08, 0xacbbef71ef4b369
  *          <tt>Release()</tt> on the returned instance after you are done with it.
  */
 NK_EXTERN NkIBase *NK_CALL __NkVirt_Filesys_QueryInstance(NkVoid);
+/**
+ * \ingroup VirtFn
+ * \brief   maps an entire file into memory for reading
+ * \param   [in] pathStr path of the file
+ * \param   [out] viewPtr pointer to a variable that receives the view of the file
+ * \param   [out] mapHandle pointer to a variable that receives the mapping handle
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ */
+NK_EXTERN NK_VIRTUAL _Return_ok_ NkErrorCode NK_CALL __NkVirt_Filesys_MapFile(
+    _In_z_ _Utf8_ char const *pathStr,
+    _Out_         NkBufferView *viewPtr,
+    _Outptr_      NkVoid **mapHandle
+);
+/**
+ * \ingroup VirtFn
+ * \brief   unmaps a file previously mapped by <tt>__NkVirt_Filesys_MapFile()</tt>
+ * \param   [in, out] mapHandle mapping handle
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkVirt_Filesys_UnmapFile(_Inout_ NkVoid *mapHandle);
 
 
 /**
@@ -119,7 +155,7 @@ NK_INTERNAL NK_INLINE int NK_CALL __NkInt_File_MapFromSeekOrigin(_In_ NkSeekOrig
 NK_INTERNAL NkOMRefCount NK_CALL __NkInt_File_AddRef(_Inout_ NkIFile *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    return ++((__NkInt_File *)self)->m_refCount;
+    return NkOMRefCountIncrement(&((__NkInt_File *)self)->m_refCount, NkOMRcMd_Shared);
 }
 
 /**
@@ -130,7 +166,8 @@ NK_INTERNAL NkOMRefCount NK_CALL __NkInt_File_Release(_Inout_ NkIFile *self) {
 
     __NkInt_File *actSelf = (__NkInt_File *)self;
 
-    if (--actSelf->m_refCount <= 0) {
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&actSelf->m_refCount, NkOMRcMd_Shared);
+    if (newCount <= 0) {
         /* Reference count is 0; destroy. Close first if needed. */
         self->VT->Close(self);
 
@@ -139,7 +176,7 @@ NK_INTERNAL NkOMRefCount NK_CALL __NkInt_File_Release(_Inout_ NkIFile *self) {
     }
 
     /* Return new reference count. */
-    return actSelf->m_refCount;
+    return newCount;
 }
 
 /**
@@ -431,6 +468,304 @@ NKOM_DEFINE_VTABLE(NkIFile) {
 };
 
 
+/**
+ * \brief implements <tt>NkIMappedFile::AddRef()</tt> 
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_MappedFile_AddRef(_Inout_ NkIMappedFile *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return NkOMRefCountIncrement(&((__NkInt_MappedFile *)self)->m_refCount, NkOMRcMd_Shared);
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Release()</tt> 
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_MappedFile_Release(_Inout_ NkIMappedFile *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_MappedFile *actSelf = (__NkInt_MappedFile *)self;
+
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&actSelf->m_refCount, NkOMRcMd_Shared);
+    if (newCount <= 0) {
+        /* Reference count is 0; destroy. Unmap first if needed. */
+        self->VT->Close(self);
+
+        NkPoolFree(self);
+        return 0;
+    }
+
+    /* Return new reference count. */
+    return newCount;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::QueryInterface()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_QueryInterface(
+    _Inout_  NkIMappedFile *self,
+    _In_     NkUuid const *iId,
+    _Outptr_ NkVoid **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(iId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    NK_INTERNAL NkOMImplementationInfo const gl_c_ImplInfos[] = {
+        { NKOM_IIDOF(NkIBase)       },
+        { NKOM_IIDOF(NkIStream)     },
+        { NKOM_IIDOF(NkIFile)       },
+        { NKOM_IIDOF(NkIMappedFile) },
+        { NULL                      }
+    };
+    if (NkOMQueryImplementationIndex(gl_c_ImplInfos, iId) != SIZE_MAX) {
+        /* Interface is implemented. */
+        *resPtr = (NkVoid *)self;
+
+        __NkInt_MappedFile_AddRef(self);
+        return NkErr_Ok;
+    }
+
+    /* Interface is not implemented. */
+    *resPtr = NULL;
+    return NkErr_InterfaceNotImpl;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::GetStat()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_GetStat(
+    _Inout_ NkIMappedFile *self,
+    _Out_   NkStreamStat *statPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(statPtr != NULL, NkErr_OutParameter);
+
+    __NkInt_MappedFile *actSelf = (__NkInt_MappedFile *)self;
+
+    if (actSelf->mp_mapHnd == NULL) {
+        memset(statPtr, 0, sizeof *statPtr);
+
+        return NkErr_ObjectState;
+    }
+
+    /*
+     * The file cannot be modified through this handle, so the info retrieved on opening
+     * is still accurate.
+     */
+    *statPtr = (NkStreamStat){
+        .m_structSize = sizeof *statPtr,
+        .m_type       = NkStrTy_MappedFile,
+        .m_ioMode     = actSelf->m_strMode,
+        .m_crTime     = (NkUint64)actSelf->m_fileStat.st_ctime,
+        .m_mdTime     = (NkUint64)actSelf->m_fileStat.st_mtime,
+        .m_aTime      = (NkUint64)actSelf->m_fileStat.st_atime,
+        .m_size       = actSelf->m_fileView.m_sizeInBytes,
+        .m_currOff    = (NkOffset)actSelf->m_currOff
+    };
+    return NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Read()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_Read(
+    _Inout_      NkIMappedFile *self,
+    _In_         NkSize s,
+    _O_bytes_(s) NkVoid *bufPtr,
+    _Out_        NkSize *br
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(s > 0, NkErr_InParameter);
+    NK_ASSERT(bufPtr != NULL, NkErr_OutParameter);
+    NK_ASSERT(br != NULL, NkErr_OutParameter);
+
+    __NkInt_MappedFile *actSelf = (__NkInt_MappedFile *)self;
+
+    *br = 0;
+    if (actSelf->mp_mapHnd == NULL)
+        return NkErr_ObjectState;
+
+    /* Copy as many bytes as are left, starting at the current position. */
+    *br = NK_MIN(s, actSelf->m_fileView.m_sizeInBytes - actSelf->m_currOff);
+    memcpy(bufPtr, actSelf->m_fileView.mp_dataPtr + actSelf->m_currOff, *br);
+    actSelf->m_currOff += *br;
+
+    /* Like with disk files, reading past the end is an error. */
+    return *br ^ s ? NkErr_ErrorDuringDiskIO : NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Write()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_Write(
+    _Inout_      NkIMappedFile *self,
+    _In_         NkSize s,
+    _I_bytes_(s) NkVoid const *bufPtr,
+    _Out_        NkSize *bw
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(bw != NULL, NkErr_OutParameter);
+    NK_UNREFERENCED_PARAMETER(s);
+    NK_UNREFERENCED_PARAMETER(bufPtr);
+
+    /* Mapped files are read-only. */
+    *bw = 0;
+    return ((__NkInt_MappedFile *)self)->mp_mapHnd == NULL ? NkErr_ObjectState : NkErr_InvStreamMode;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Open()</tt>
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_Open(
+    _Inout_       NkIMappedFile *self,
+    _In_z_ _Utf8_ char const *pathStr,
+    _In_          NkStreamIOMode mode
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(pathStr != NULL && *pathStr ^ '\0', NkErr_InParameter);
+
+    __NkInt_MappedFile *actSelf = (__NkInt_MappedFile *)self;
+
+    if (actSelf->mp_mapHnd != NULL)
+        return NkErr_ObjectState;
+    /* Only plain reading is supported. */
+    if ((mode & ~NkStrMd_Binary) != NkStrMd_Read)
+        return NkErr_InvStreamMode;
+
+    /* Retrieve file info first; the times are not available through the mapping. */
+    if (_stat64(pathStr, &actSelf->m_fileStat) != 0)
+        return NkErr_OpenFile;
+
+    /* Map the file. */
+    NkErrorCode errCode = __NkVirt_Filesys_MapFile(pathStr, &actSelf->m_fileView, &actSelf->mp_mapHnd);
+    if (errCode != NkErr_Ok) {
+        actSelf->mp_mapHnd = NULL;
+
+        return errCode;
+    }
+    actSelf->m_strMode = mode;
+    actSelf->m_currOff = 0;
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Close()</tt> 
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_MappedFile_Close(_Inout_ NkIMappedFile *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_MappedFile *actSelf = (__NkInt_MappedFile *)self;
+
+    if (actSelf->mp_mapHnd != NULL) {
+        __NkVirt_Filesys_UnmapFile(actSelf->mp_mapHnd);
+
+        actSelf->mp_mapHnd  = NULL;
+        actSelf->m_fileView = (NkBufferView){ NULL, 0 };
+        actSelf->m_currOff  = 0;
+        actSelf->m_strMode  = NkStrMd_Unknown;
+    }
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Seek()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_Seek(
+    _Inout_ NkIMappedFile *self,
+    _In_    NkSeekOrigin origin,
+    _In_    NkOffset offset
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(origin >= NkSeekOri_Set && origin < __NkSeekOri_Count__, NkErr_InParameter);
+
+    __NkInt_MappedFile *actSelf = (__NkInt_MappedFile *)self;
+
+    if (actSelf->mp_mapHnd == NULL)
+        return NkErr_ObjectState;
+
+    /* Calculate the new position. */
+    NkInt64 newOff;
+    switch (origin) {
+        case NkSeekOri_Set: newOff = 0;                                            break;
+        case NkSeekOri_Cur: newOff = (NkInt64)actSelf->m_currOff;                  break;
+        case NkSeekOri_End: newOff = (NkInt64)actSelf->m_fileView.m_sizeInBytes;   break;
+        default:
+            return NkErr_InvSeekOrigin;
+    }
+    newOff += (NkInt64)offset;
+
+    /*
+     * Unlike disk files, a mapped file cannot grow, so the position must stay inside of
+     * the file.
+     */
+    if (newOff < 0 || (NkUint64)newOff > (NkUint64)actSelf->m_fileView.m_sizeInBytes)
+        return NkErr_StreamSeek;
+
+    actSelf->m_currOff = (NkSize)newOff;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Flush()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_Flush(_Inout_ NkIMappedFile *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Nothing is ever written, so there is nothing to flush. */
+    return ((__NkInt_MappedFile *)self)->mp_mapHnd == NULL ? NkErr_ObjectState : NkErr_Ok;
+}
+
+/**
+ * \brief implements <tt>NkIMappedFile::Map()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_MappedFile_Map(
+    _Inout_ NkIMappedFile *self,
+    _In_    NkSize offset,
+    _In_    NkSize s,
+    _Out_   NkBufferView *viewPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(viewPtr != NULL, NkErr_OutParameter);
+
+    __NkInt_MappedFile *actSelf = (__NkInt_MappedFile *)self;
+
+    *viewPtr = (NkBufferView){ NULL, 0 };
+    if (actSelf->mp_mapHnd == NULL)
+        return NkErr_ObjectState;
+
+    /* Validate the range; written so that it cannot overflow. */
+    NkSize const fileSize = actSelf->m_fileView.m_sizeInBytes;
+    if (offset > fileSize || s > fileSize - offset)
+        return NkErr_InvalidRange;
+
+    *viewPtr = (NkBufferView){
+        .mp_dataPtr    = actSelf->m_fileView.mp_dataPtr + offset,
+        .m_sizeInBytes = s == 0 ? fileSize - offset : s
+    };
+    return NkErr_Ok;
+}
+
+
+/**
+ * \brief global VTable for the memory-mapped implementation of the NkIMappedFile
+ *        interface
+ */
+NKOM_DEFINE_VTABLE(NkIMappedFile) {
+    .QueryInterface = &__NkInt_MappedFile_QueryInterface,
+    .AddRef         = &__NkInt_MappedFile_AddRef,
+    .Release        = &__NkInt_MappedFile_Release,
+    .GetStat        = &__NkInt_MappedFile_GetStat,
+    .Read           = &__NkInt_MappedFile_Read,
+    .Write          = &__NkInt_MappedFile_Write,
+    .Open           = &__NkInt_MappedFile_Open,
+    .Close          = &__NkInt_MappedFile_Close,
+    .Seek           = &__NkInt_MappedFile_Seek,
+    .Flush          = &__NkInt_MappedFile_Flush,
+    .Map            = &__NkInt_MappedFile_Map
+};
+
+
 /**
  * \brief implements <tt>NkIClassFactory::AddRef()</tt> 
  */
@@ -489,6 +824,7 @@ NK_INTERNAL NkUuid const **NK_CALL __NkInt_IoFac_QueryInstantiableClasses(_Inout
      */
     NK_INTERNAL NkUuid const *gl_c_ImplCls[] = {
         NKOM_CLSIDOF(NkIFile),
+        NKOM_CLSIDOF(NkIMappedFile),
         NULL
     };
 
@@ -513,8 +849,9 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_IoFac_CreateInstance(
      */
 NK_DISABLE_WARNING(NK_WARN_DIFFERENT_CONST_QUALIFIERS,
     NK_INTERNAL NkOMImplementationInfo const gl_c_ImplInfos[] = {
-        { NKOM_CLSIDOF(NkIFile), sizeof(__NkInt_File), NK_FALSE, &NKOM_VTABLEOF(NkIFile) },
-        { NULL                                                                           }
+        { NKOM_CLSIDOF(NkIFile),       sizeof(__NkInt_File),       NK_FALSE, &NKOM_VTABLEOF(NkIFile)       },
+        { NKOM_CLSIDOF(NkIMappedFile), sizeof(__NkInt_MappedFile), NK_FALSE, &NKOM_VTABLEOF(NkIMappedFile) },
+        { NULL                                                                                             }
     };
 );
     
@@ -0,0 +1,676 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  job.c
+ * \brief implements Noriko's work-stealing job system
+ */
+#define NK_NAMESPACE "nk::job"
+
+
+/* stdlib includes */
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/job.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/comp.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \brief number of jobs a single job queue can hold; must be a power of two
+ */
+#define __NkInt_JobSys_QueueCap      ((NkInt64)4096)
+/**
+ * \brief maximum number of worker threads
+ */
+#define __NkInt_JobSys_MaxWorkers    ((NkUint32)63)
+
+
+/**
+ * \struct __NkInt_JobCounter
+ * \brief  internal definition of a job counter
+ */
+NK_NATIVE typedef struct __NkInt_JobCounter {
+    NkInt64 volatile                m_jobCount;  /**< number of unfinished jobs */
+    struct __NkInt_JobBatch        *mp_waitList; /**< batches waiting for the counter to reach zero */
+} __NkInt_JobCounter;
+NK_VERIFY_TYPE(NkJobCounter, __NkInt_JobCounter);
+
+/**
+ * \struct __NkInt_Job
+ * \brief  represents a job inside a job queue
+ */
+NK_NATIVE typedef struct __NkInt_Job {
+    NkJobFn             mp_jobFn;    /**< job entry point */
+    NkVoid             *mp_extraCxt; /**< context passed to <tt>mp_jobFn</tt> */
+    __NkInt_JobCounter *mp_counter;  /**< (optional) counter to decrement when finished */
+} __NkInt_Job;
+
+/**
+ * \struct __NkInt_JobBatch
+ * \brief  represents a batch of jobs that is waiting for a dependency
+ */
+NK_NATIVE typedef struct __NkInt_JobBatch {
+    struct __NkInt_JobBatch *mp_nextPtr; /**< next batch waiting for the same counter */
+    NkSize                   m_nJobs;    /**< number of jobs in the batch */
+    __NkInt_Job              m_jobArr[]; /**< jobs of the batch */
+} __NkInt_JobBatch;
+
+/**
+ * \struct __NkInt_JobDeque
+ * \brief  represents a fixed-size work-stealing deque
+ *
+ * Only the owning thread pushes and pops at the bottom; all other threads steal from the
+ * top. The indices never wrap; the slot of an index is obtained by masking. The indices
+ * are kept on separate cache lines so that the owner and thieves do not contend.
+ */
+NK_NATIVE typedef struct __NkInt_JobDeque {
+    NkInt64 volatile m_topInd;                          /**< index of the oldest job */
+    NkByte           __pad0__[64 - sizeof(NkInt64)];    /**< padding */
+    NkInt64 volatile m_bottomInd;                       /**< index one past the newest job */
+    NkByte           __pad1__[64 - sizeof(NkInt64)];    /**< padding */
+    __NkInt_Job      m_jobArr[__NkInt_JobSys_QueueCap]; /**< job slots */
+} __NkInt_JobDeque;
+
+/**
+ * \struct __NkInt_JobSysContext
+ * \brief  represents the global state of the job system
+ */
+NK_NATIVE typedef struct __NkInt_JobSysContext {
+    NkUint32          m_nWorkers;    /**< number of worker threads */
+    __NkInt_JobDeque *mp_dequeArr;   /**< deques; index 0 belongs to the main thread */
+    NkInt64 volatile  m_nPending;    /**< number of jobs currently in any queue */
+    NkInt32 volatile  m_nSleeping;   /**< number of workers waiting for jobs */
+    NkBoolean         m_isShutdown;  /**< whether the workers should exit */
+
+    /**
+     * \struct __NkInt_JobSharedQueue
+     * \brief  queue for jobs submitted by threads that do not own a deque
+     */
+    struct __NkInt_JobSharedQueue {
+        NkInt64     m_headInd;                          /**< index of the oldest job */
+        NkInt64     m_tailInd;                          /**< index one past the newest job */
+        __NkInt_Job m_jobArr[__NkInt_JobSys_QueueCap];  /**< job slots */
+
+        NK_DECL_LOCK(m_mtxLock);                        /**< guards the queue */
+    } *mp_sharedQueue;
+
+#if (defined NK_TARGET_MULTITHREADED)
+    thrd_t            m_thrdArr[__NkInt_JobSys_MaxWorkers]; /**< worker threads */
+    cnd_t             m_wakeCnd;                            /**< signaled when jobs were pushed */
+#endif
+    NK_DECL_LOCK(m_sleepLock);                              /**< lock for <tt>m_wakeCnd</tt> */
+    NK_DECL_LOCK(m_depLock);                                /**< guards the wait lists of all counters */
+} __NkInt_JobSysContext;
+/**
+ * \brief actual instance of the job system context
+ */
+NK_INTERNAL __NkInt_JobSysContext gl_JobSysCxt;
+/**
+ * \brief index of the deque owned by the current thread, or <tt>-1</tt> if the current
+ *        thread does not own one
+ */
+NK_INTERNAL NK_THREADLOCAL NkInt32 gl_DequeIndex = -1;
+/**
+ * \brief index of the deque the current thread tries to steal from next
+ */
+NK_INTERNAL NK_THREADLOCAL NkUint32 gl_StealIndex = 0;
+
+
+/**
+ * \brief  retrieves the number of logical processors of the current machine
+ * \return number of logical processors, at least <tt>1</tt>
+ */
+NK_EXTERN NK_VIRTUAL NkUint32 NK_CALL __NkVirt_JobSys_GetProcessorCount(NkVoid);
+
+
+/**
+ * \brief  pushes a job onto the bottom of a deque
+ * \param  [in, out] dqPtr pointer to the deque
+ * \param  [in] jobPtr pointer to the job
+ * \return \c NK_TRUE if the job was pushed, \c NK_FALSE if the deque is full
+ * \note   This function must only be called by the thread owning the deque.
+ */
+NK_INTERNAL NkBoolean __NkInt_JobDeque_Push(_Inout_ __NkInt_JobDeque *dqPtr, _In_ __NkInt_Job const *jobPtr) {
+    NkInt64 const bottomInd = dqPtr->m_bottomInd;
+    NkInt64 const topInd    = InterlockedCompareExchange64(&dqPtr->m_topInd, 0, 0);
+    if (bottomInd - topInd >= __NkInt_JobSys_QueueCap)
+        return NK_FALSE;
+
+    /* Publish the job before publishing the new bottom index. */
+    dqPtr->m_jobArr[bottomInd & (__NkInt_JobSys_QueueCap - 1)] = *jobPtr;
+    InterlockedExchange64(&dqPtr->m_bottomInd, bottomInd + 1);
+    return NK_TRUE;
+}
+
+/**
+ * \brief  pops the newest job from the bottom of a deque
+ * \param  [in, out] dqPtr pointer to the deque
+ * \param  [out] jobPtr pointer to a variable that receives the job
+ * \return \c NK_TRUE if a job was popped, \c NK_FALSE if the deque is empty
+ * \note   This function must only be called by the thread owning the deque.
+ */
+NK_INTERNAL NkBoolean __NkInt_JobDeque_Pop(_Inout_ __NkInt_JobDeque *dqPtr, _Out_ __NkInt_Job *jobPtr) {
+    NkInt64 const bottomInd = dqPtr->m_bottomInd - 1;
+
+    /*
+     * Reserve the bottom-most job before reading the top index; the full barrier of the
+     * interlocked operation makes sure thieves see the reservation.
+     */
+    InterlockedExchange64(&dqPtr->m_bottomInd, bottomInd);
+    NkInt64 const topInd = dqPtr->m_topInd;
+    if (topInd > bottomInd) {
+        /* The deque was empty. */
+        InterlockedExchange64(&dqPtr->m_bottomInd, bottomInd + 1);
+
+        return NK_FALSE;
+    }
+
+    *jobPtr = dqPtr->m_jobArr[bottomInd & (__NkInt_JobSys_QueueCap - 1)];
+    if (topInd != bottomInd)
+        return NK_TRUE;
+
+    /* This was the last job; race against thieves for it. */
+    NkBoolean const isWon = InterlockedCompareExchange64(&dqPtr->m_topInd, topInd + 1, topInd) == topInd;
+    InterlockedExchange64(&dqPtr->m_bottomInd, bottomInd + 1);
+    return isWon;
+}
+
+/**
+ * \brief  steals the oldest job from the top of a deque
+ * \param  [in, out] dqPtr pointer to the deque
+ * \param  [out] jobPtr pointer to a variable that receives the job
+ * \return \c NK_TRUE if a job was stolen, \c NK_FALSE if the deque is empty or another
+ *         thread took the job first
+ * \note   This function can be called from any thread.
+ */
+NK_INTERNAL NkBoolean __NkInt_JobDeque_Steal(_Inout_ __NkInt_JobDeque *dqPtr, _Out_ __NkInt_Job *jobPtr) {
+    NkInt64 const topInd    = InterlockedCompareExchange64(&dqPtr->m_topInd, 0, 0);
+    NkInt64 const bottomInd = InterlockedCompareExchange64(&dqPtr->m_bottomInd, 0, 0);
+    if (topInd >= bottomInd)
+        return NK_FALSE;
+
+    /*
+     * The owner never overwrites the slot at the top index before the top index was
+     * advanced, so the copy is valid if the CAS below succeeds.
+     */
+    *jobPtr = dqPtr->m_jobArr[topInd & (__NkInt_JobSys_QueueCap - 1)];
+    return InterlockedCompareExchange64(&dqPtr->m_topInd, topInd + 1, topInd) == topInd;
+}
+
+/**
+ * \brief  appends a job to the shared queue
+ * \param  [in] jobPtr pointer to the job
+ * \return \c NK_TRUE if the job was pushed, \c NK_FALSE if the queue is full
+ */
+NK_INTERNAL NkBoolean __NkInt_JobSys_PushShared(_In_ __NkInt_Job const *jobPtr) {
+    struct __NkInt_JobSharedQueue *sqPtr = gl_JobSysCxt.mp_sharedQueue;
+
+    NkBoolean isPushed = NK_FALSE;
+    NK_LOCK(sqPtr->m_mtxLock);
+    if (sqPtr->m_tailInd - sqPtr->m_headInd < __NkInt_JobSys_QueueCap) {
+        sqPtr->m_jobArr[sqPtr->m_tailInd++ & (__NkInt_JobSys_QueueCap - 1)] = *jobPtr;
+
+        isPushed = NK_TRUE;
+    }
+    NK_UNLOCK(sqPtr->m_mtxLock);
+
+    return isPushed;
+}
+
+/**
+ * \brief  removes the oldest job from the shared queue
+ * \param  [out] jobPtr pointer to a variable that receives the job
+ * \return \c NK_TRUE if a job was removed, \c NK_FALSE if the queue is empty
+ */
+NK_INTERNAL NkBoolean __NkInt_JobSys_PopShared(_Out_ __NkInt_Job *jobPtr) {
+    struct __NkInt_JobSharedQueue *sqPtr = gl_JobSysCxt.mp_sharedQueue;
+
+    NkBoolean isPopped = NK_FALSE;
+    NK_LOCK(sqPtr->m_mtxLock);
+    if (sqPtr->m_headInd != sqPtr->m_tailInd) {
+        *jobPtr = sqPtr->m_jobArr[sqPtr->m_headInd++ & (__NkInt_JobSys_QueueCap - 1)];
+
+        isPopped = NK_TRUE;
+    }
+    NK_UNLOCK(sqPtr->m_mtxLock);
+
+    return isPopped;
+}
+
+/**
+ * \brief wakes sleeping workers after jobs were pushed
+ * \param [in] nJobs number of jobs that were pushed
+ */
+NK_INTERNAL NkVoid __NkInt_JobSys_WakeWorkers(_In_ NkSize nJobs) {
+#if (defined NK_TARGET_MULTITHREADED)
+    /*
+     * Workers register as sleeping before checking the number of pending jobs, so a worker
+     * that is about to sleep either sees the new jobs or is counted here.
+     */
+    if (InterlockedCompareExchange((LONG volatile *)&gl_JobSysCxt.m_nSleeping, 0, 0) == 0)
+        return;
+
+    NK_LOCK(gl_JobSysCxt.m_sleepLock);
+    if (nJobs > 1)
+        cnd_broadcast(&gl_JobSysCxt.m_wakeCnd);
+    else
+        cnd_signal(&gl_JobSysCxt.m_wakeCnd);
+    NK_UNLOCK(gl_JobSysCxt.m_sleepLock);
+#else
+    NK_UNREFERENCED_PARAMETER(nJobs);
+#endif
+}
+
+/**
+ * \brief  makes the given jobs available to the workers
+ * \param  [in] jobArr array of jobs
+ * \param  [in] nJobs number of elements in \c jobArr
+ *
+ * Jobs that do not fit into the queue of the calling thread are run right away.
+ */
+NK_INTERNAL NkVoid __NkInt_JobSys_PushJobs(_I_array_(nJobs) __NkInt_Job const *jobArr, _In_ NkSize nJobs);
+
+/**
+ * \brief decrements a job counter, releasing the jobs waiting for it if it reaches zero
+ * \param [in, out] cntPtr pointer to the counter
+ */
+NK_INTERNAL NkVoid __NkInt_JobSys_DecrementCounter(_Inout_ __NkInt_JobCounter *cntPtr) {
+    for (;;) {
+        /*
+         * As long as this is not the last job of the counter, a plain decrement suffices.
+         * After the decrement, the counter must no longer be accessed as waiting threads
+         * may destroy it.
+         */
+        NkInt64 const currCount = InterlockedCompareExchange64(&cntPtr->m_jobCount, 0, 0);
+        if (currCount > 1) {
+            if (InterlockedCompareExchange64(&cntPtr->m_jobCount, currCount - 1, currCount) == currCount)
+                return;
+
+            continue;
+        }
+
+        /* Take the wait list and drop the count to zero atomically w.r.t. submitters. */
+        NK_LOCK(gl_JobSysCxt.m_depLock);
+        __NkInt_JobBatch *waitList = cntPtr->mp_waitList;
+        cntPtr->mp_waitList = NULL;
+        if (InterlockedCompareExchange64(&cntPtr->m_jobCount, 0, 1) != 1) {
+            /* Jobs were added concurrently; put the list back and retry. */
+            cntPtr->mp_waitList = waitList;
+            NK_UNLOCK(gl_JobSysCxt.m_depLock);
+
+            continue;
+        }
+        NK_UNLOCK(gl_JobSysCxt.m_depLock);
+
+        /* Release the jobs that were waiting for this counter. */
+        while (waitList != NULL) {
+            __NkInt_JobBatch *nextPtr = waitList->mp_nextPtr;
+
+            __NkInt_JobSys_PushJobs(waitList->m_jobArr, waitList->m_nJobs);
+            NkGPFree(waitList);
+            waitList = nextPtr;
+        }
+        return;
+    }
+}
+
+/**
+ * \brief runs a job and updates its counter
+ * \param [in] jobPtr pointer to the job that is to be run
+ */
+NK_INTERNAL NkVoid __NkInt_JobSys_RunJob(_In_ __NkInt_Job const *jobPtr) {
+    (*jobPtr->mp_jobFn)(jobPtr->mp_extraCxt);
+
+    if (jobPtr->mp_counter != NULL)
+        __NkInt_JobSys_DecrementCounter(jobPtr->mp_counter);
+}
+
+NK_INTERNAL NkVoid __NkInt_JobSys_PushJobs(_I_array_(nJobs) __NkInt_Job const *jobArr, _In_ NkSize nJobs) {
+    NkInt32 const dqInd = gl_DequeIndex;
+
+    NkSize nPushed = 0;
+    for (NkSize i = 0; i < nJobs; i++) {
+        NkBoolean const isPushed = dqInd >= 0
+            ? __NkInt_JobDeque_Push(&gl_JobSysCxt.mp_dequeArr[dqInd], &jobArr[i])
+            : __NkInt_JobSys_PushShared(&jobArr[i])
+        ;
+
+        if (!isPushed) {
+            /* Queue is full; run the job right away. */
+            __NkInt_JobSys_RunJob(&jobArr[i]);
+
+            continue;
+        }
+        InterlockedIncrement64(&gl_JobSysCxt.m_nPending);
+        ++nPushed;
+    }
+
+    if (nPushed > 0)
+        __NkInt_JobSys_WakeWorkers(nPushed);
+}
+
+/**
+ * \brief  tries to run a single pending job on the calling thread
+ * \return \c NK_TRUE if a job was run, \c NK_FALSE if no job was found
+ *
+ * The calling thread first pops from its own deque, then from the shared queue, and at
+ * last tries to steal from all other deques.
+ */
+NK_INTERNAL NkBoolean __NkInt_JobSys_TryRunOne(NkVoid) {
+    NkInt32 const  dqInd = gl_DequeIndex;
+    NkUint32 const nDq   = gl_JobSysCxt.m_nWorkers + 1;
+
+    __NkInt_Job currJob;
+    NkBoolean isFound = dqInd >= 0 && __NkInt_JobDeque_Pop(&gl_JobSysCxt.mp_dequeArr[dqInd], &currJob);
+    if (!isFound)
+        isFound = __NkInt_JobSys_PopShared(&currJob);
+    for (NkUint32 i = 0; i < nDq && !isFound; i++) {
+        NkUint32 const victInd = gl_StealIndex++ % nDq;
+        if ((NkInt32)victInd == dqInd)
+            continue;
+
+        isFound = __NkInt_JobDeque_Steal(&gl_JobSysCxt.mp_dequeArr[victInd], &currJob);
+    }
+    if (!isFound)
+        return NK_FALSE;
+
+    InterlockedDecrement64(&gl_JobSysCxt.m_nPending);
+    __NkInt_JobSys_RunJob(&currJob);
+    return NK_TRUE;
+}
+
+#if (defined NK_TARGET_MULTITHREADED)
+/**
+ * \brief  entry point of a worker thread
+ * \param  [in] extraCxt index of the deque owned by the worker
+ * \return always \c 0
+ */
+NK_INTERNAL int __NkInt_JobSys_WorkerProc(_In_ NkVoid *extraCxt) {
+    gl_DequeIndex = (NkInt32)(NkSize)extraCxt;
+    gl_StealIndex = (NkUint32)gl_DequeIndex + 1;
+
+    for (;;) {
+        if (__NkInt_JobSys_TryRunOne())
+            continue;
+
+        /* Nothing to do; sleep until jobs are pushed. */
+        NK_LOCK(gl_JobSysCxt.m_sleepLock);
+        InterlockedIncrement((LONG volatile *)&gl_JobSysCxt.m_nSleeping);
+        while (InterlockedCompareExchange64(&gl_JobSysCxt.m_nPending, 0, 0) == 0 && !gl_JobSysCxt.m_isShutdown)
+            cnd_wait(&gl_JobSysCxt.m_wakeCnd, &gl_JobSysCxt.m_sleepLock);
+        InterlockedDecrement((LONG volatile *)&gl_JobSysCxt.m_nSleeping);
+        NkBoolean const isShutdown = gl_JobSysCxt.m_isShutdown;
+        NK_UNLOCK(gl_JobSysCxt.m_sleepLock);
+
+        if (isShutdown)
+            break;
+    }
+
+    NkAllocReleaseThreadCache();
+    return 0;
+}
+#endif
+
+
+/**
+ * \brief  initializes the job system and starts the worker threads
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The calling thread becomes the owner of the first deque, that is, it is treated
+ *         like a worker while it waits for jobs.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(JobSys)(NkVoid) {
+#if (defined NK_TARGET_MULTITHREADED)
+    NkUint32 const nProcs = __NkVirt_JobSys_GetProcessorCount();
+    gl_JobSysCxt.m_nWorkers = NK_MIN(NK_MAX(nProcs, 2U) - 1U, __NkInt_JobSys_MaxWorkers);
+#else
+    gl_JobSysCxt.m_nWorkers = 0;
+#endif
+
+    /* Allocate the queues. */
+    NkErrorCode errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        (gl_JobSysCxt.m_nWorkers + 1) * sizeof *gl_JobSysCxt.mp_dequeArr,
+        0,
+        NK_TRUE,
+        (NkVoid **)&gl_JobSysCxt.mp_dequeArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof *gl_JobSysCxt.mp_sharedQueue,
+        0,
+        NK_TRUE,
+        (NkVoid **)&gl_JobSysCxt.mp_sharedQueue
+    );
+    if (errCode != NkErr_Ok) {
+        NkGPFree(gl_JobSysCxt.mp_dequeArr);
+
+        return errCode;
+    }
+    NK_INITLOCK(gl_JobSysCxt.mp_sharedQueue->m_mtxLock);
+    NK_INITLOCK(gl_JobSysCxt.m_sleepLock);
+    NK_INITLOCK(gl_JobSysCxt.m_depLock);
+    gl_DequeIndex = 0;
+
+#if (defined NK_TARGET_MULTITHREADED)
+    if (cnd_init(&gl_JobSysCxt.m_wakeCnd) != thrd_success) {
+        errCode = NkErr_SynchInit;
+
+        goto lbl_ONERROR;
+    }
+
+    /* Start the worker threads. */
+    for (NkUint32 i = 0; i < gl_JobSysCxt.m_nWorkers; i++) {
+        int const thrdRes = thrd_create(
+            &gl_JobSysCxt.m_thrdArr[i],
+            &__NkInt_JobSys_WorkerProc,
+            (NkVoid *)(NkSize)(i + 1)
+        );
+
+        if (thrdRes != thrd_success) {
+            /* Only use the workers that could be started. */
+            NK_LOG_WARNING("Could only start %u of %u job workers.", i, gl_JobSysCxt.m_nWorkers);
+
+            gl_JobSysCxt.m_nWorkers = i;
+            break;
+        }
+    }
+    if (gl_JobSysCxt.m_nWorkers == 0) {
+        cnd_destroy(&gl_JobSysCxt.m_wakeCnd);
+
+        errCode = NkErr_CreateThread;
+        goto lbl_ONERROR;
+    }
+#endif
+
+    NK_LOG_INFO("Started job system with %u worker thread(s).", gl_JobSysCxt.m_nWorkers);
+    return NkErr_Ok;
+
+#if (defined NK_TARGET_MULTITHREADED)
+lbl_ONERROR:
+    NK_DESTROYLOCK(gl_JobSysCxt.m_depLock);
+    NK_DESTROYLOCK(gl_JobSysCxt.m_sleepLock);
+    NK_DESTROYLOCK(gl_JobSysCxt.mp_sharedQueue->m_mtxLock);
+    NkGPFree(gl_JobSysCxt.mp_sharedQueue);
+    NkGPFree(gl_JobSysCxt.mp_dequeArr);
+
+    gl_DequeIndex = -1;
+    return errCode;
+#endif
+}
+
+/**
+ * \brief  stops all worker threads and uninitializes the job system
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   Jobs that are still pending are discarded.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(JobSys)(NkVoid) {
+#if (defined NK_TARGET_MULTITHREADED)
+    /* Wake up and join all workers. */
+    NK_LOCK(gl_JobSysCxt.m_sleepLock);
+    gl_JobSysCxt.m_isShutdown = NK_TRUE;
+    cnd_broadcast(&gl_JobSysCxt.m_wakeCnd);
+    NK_UNLOCK(gl_JobSysCxt.m_sleepLock);
+
+    for (NkUint32 i = 0; i < gl_JobSysCxt.m_nWorkers; i++)
+        thrd_join(gl_JobSysCxt.m_thrdArr[i], NULL);
+    cnd_destroy(&gl_JobSysCxt.m_wakeCnd);
+#endif
+
+    if (gl_JobSysCxt.m_nPending > 0)
+        NK_LOG_WARNING("Discarding %lli pending job(s).", (long long)gl_JobSysCxt.m_nPending);
+
+    /* Destroy queues and locks. */
+    NK_DESTROYLOCK(gl_JobSysCxt.m_depLock);
+    NK_DESTROYLOCK(gl_JobSysCxt.m_sleepLock);
+    NK_DESTROYLOCK(gl_JobSysCxt.mp_sharedQueue->m_mtxLock);
+    NkGPFree(gl_JobSysCxt.mp_sharedQueue);
+    NkGPFree(gl_JobSysCxt.mp_dequeArr);
+
+    memset(&gl_JobSysCxt, 0, sizeof gl_JobSysCxt);
+    gl_DequeIndex = -1;
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkJobSubmit(
+    _I_array_(nJobs) NkJobDescription const *jobArr,
+    _In_             NkSize nJobs,
+    _Inout_opt_      NkJobCounter *depCounter,
+    _Inout_opt_      NkJobCounter *jobCounter
+) {
+    NK_ASSERT(jobArr != NULL, NkErr_InParameter);
+
+    if (nJobs == 0)
+        return NkErr_Ok;
+    __NkInt_JobCounter *actDep = (__NkInt_JobCounter *)depCounter;
+    __NkInt_JobCounter *actCnt = (__NkInt_JobCounter *)jobCounter;
+
+    /* Account for the jobs before any of them can run. */
+    if (actCnt != NULL)
+        InterlockedAdd64(&actCnt->m_jobCount, (NkInt64)nJobs);
+
+    /* Jobs are pushed as a whole batch, so build it up-front. */
+    __NkInt_JobBatch *batchPtr;
+    NkErrorCode errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof *batchPtr + nJobs * sizeof *batchPtr->m_jobArr,
+        0,
+        NK_FALSE,
+        (NkVoid **)&batchPtr
+    );
+    if (errCode != NkErr_Ok) {
+        if (actCnt != NULL)
+            InterlockedAdd64(&actCnt->m_jobCount, -(NkInt64)nJobs);
+
+        return errCode;
+    }
+    batchPtr->mp_nextPtr = NULL;
+    batchPtr->m_nJobs    = nJobs;
+    for (NkSize i = 0; i < nJobs; i++) {
+        NK_ASSERT(jobArr[i].mp_jobFn != NULL, NkErr_InParameter);
+
+        batchPtr->m_jobArr[i] = (__NkInt_Job){ jobArr[i].mp_jobFn, jobArr[i].mp_extraCxt, actCnt };
+    }
+
+    /*
+     * If the dependency has not been satisfied yet, attach the batch to the dependency.
+     * The check must happen while holding the lock so that it cannot reach zero in the
+     * meantime.
+     */
+    if (actDep != NULL) {
+        NkBoolean isDeferred = NK_FALSE;
+
+        NK_LOCK(gl_JobSysCxt.m_depLock);
+        if (InterlockedCompareExchange64(&actDep->m_jobCount, 0, 0) != 0) {
+            batchPtr->mp_nextPtr = actDep->mp_waitList;
+            actDep->mp_waitList  = batchPtr;
+
+            isDeferred = NK_TRUE;
+        }
+        NK_UNLOCK(gl_JobSysCxt.m_depLock);
+
+        if (isDeferred)
+            return NkErr_Ok;
+    }
+
+    __NkInt_JobSys_PushJobs(batchPtr->m_jobArr, batchPtr->m_nJobs);
+    NkGPFree(batchPtr);
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkJobWait(_Inout_ NkJobCounter *jobCounter) {
+    NK_ASSERT(jobCounter != NULL, NkErr_InOutParameter);
+
+    /* Help out instead of blocking. */
+    while (!NkJobIsDone(jobCounter))
+        if (!__NkInt_JobSys_TryRunOne()) {
+#if (defined NK_TARGET_MULTITHREADED)
+            thrd_yield();
+#endif
+        }
+}
+
+NkBoolean NK_CALL NkJobIsDone(_In_ NkJobCounter const *jobCounter) {
+    NK_ASSERT(jobCounter != NULL, NkErr_InParameter);
+
+    __NkInt_JobCounter *actCnt = (__NkInt_JobCounter *)jobCounter;
+    return InterlockedCompareExchange64(&actCnt->m_jobCount, 0, 0) == 0;
+}
+
+NkVoid NK_CALL NkJobCounterAddPending(_Inout_ NkJobCounter *jobCounter, _In_ NkSize nItems) {
+    NK_ASSERT(jobCounter != NULL, NkErr_InOutParameter);
+
+    if (nItems > 0)
+        InterlockedAdd64(&((__NkInt_JobCounter *)jobCounter)->m_jobCount, (NkInt64)nItems);
+}
+
+NkVoid NK_CALL NkJobCounterSignal(_Inout_ NkJobCounter *jobCounter) {
+    NK_ASSERT(jobCounter != NULL, NkErr_InOutParameter);
+    NK_ASSERT(!NkJobIsDone(jobCounter), NkErr_ObjectState);
+
+    __NkInt_JobSys_DecrementCounter((__NkInt_JobCounter *)jobCounter);
+}
+
+NkUint32 NK_CALL NkJobGetWorkerCount(NkVoid) {
+    return gl_JobSysCxt.m_nWorkers;
+}
+
+
+/** \cond INTERNAL */
+/**
+ * \brief info for the <em>job system</em> component
+ */
+NK_COMPONENT_DEFINE(JobSys) {
+    .m_compUuid     = { 0x3c1f7a92, 0x5d0e, 0x4b8a, 0x9e41c7d2a06f38b5 },
+    .mp_clsId       = NULL,
+    .m_compIdent    = NK_MAKE_STRING_VIEW("job system"),
+    .m_compFlags    = 0,
+    .m_isNkOM       = NK_FALSE,
+
+    .mp_fnQueryInst = NULL,
+    .mp_fnStartup   = &NK_COMPONENT_STARTUPFN(JobSys),
+    .mp_fnShutdown  = &NK_COMPONENT_SHUTDOWNFN(JobSys)
+};
+/** \endcond */
+
+
+#undef NK_NAMESPACE
+
+
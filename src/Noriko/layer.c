@@ -24,17 +24,26 @@
  * the event. If the layer chooses to process the event, layers underneath it in the
  * stack will not receive the event. If the layer does not process the event, the event
  * is propagated through the layer stack until the entire stack has been traversed or the
- * event has been handled.
+ * event has been handled.<br>
+ * Layers can restrict the event categories they want to receive. For every event type,
+ * the layer stack keeps a precomputed dispatch list holding only the layers interested
+ * in at least one of the event type's categories, in stack order. The lists are rebuilt
+ * whenever a layer is pushed or popped.
  */
 #define NK_NAMESPACE "nk::layer"
 
 
+/* stdlib includes */
+#include <string.h>
+
 /* Noriko includes */
 #include <include/Noriko/util.h>
 #include <include/Noriko/platform.h>
 #include <include/Noriko/layer.h>
 #include <include/Noriko/log.h>
 #include <include/Noriko/comp.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/profiler.h>
 
 #include <include/Noriko/dstruct/vector.h>
 
@@ -54,7 +63,14 @@ NKOM_DEFINE_CLSID(NkILayer, { 0x00000000, 0x0000, 0x0000, 0x0000000000000000 });
 NK_NATIVE typedef struct __NkInt_LayerStack {
     NK_DECL_LOCK(m_mtxLock);  /**< synchronization primitive */
 
-    NkVector *mp_layerStack;  /**< ordered layer array */
+    NkVector  *mp_layerStack; /**< ordered layer array */
+    NkILayer **mp_dispArr;    /**< concatenated per-event-type dispatch lists */
+    NkSize     m_dispCap;     /**< capacity of <tt>mp_dispArr</tt>, in elements */
+    /**
+     * \brief offsets of the dispatch lists in <tt>mp_dispArr</tt>; the list for event
+     *        type \c t is <tt>mp_dispArr[m_dispOff[t] : m_dispOff[t + 1]]</tt>
+     */
+    NkSize     m_dispOff[__NkEv_Count__ + 1];
 } __NkInt_LayerStack;
 
 /**
@@ -63,6 +79,72 @@ NK_NATIVE typedef struct __NkInt_LayerStack {
 NK_INTERNAL __NkInt_LayerStack gl_LayerStack;
 
 
+/**
+ * \brief  retrieves the event categories the given layer wants to receive
+ * \param  [in] layerRef pointer to the layer
+ * \return event categories; all categories if the layer does not implement
+ *         <tt>NkILayer::QueryEventCategories()</tt>
+ */
+NK_INTERNAL NK_INLINE NkEventCategory __NkInt_LayerstackGetCategories(_In_ NkILayer *layerRef) {
+    return layerRef->VT->QueryEventCategories != NULL
+        ? layerRef->VT->QueryEventCategories(layerRef)
+        : (NkEventCategory)~0
+    ;
+}
+
+/**
+ * \brief  rebuilds the per-event-type dispatch lists from the current layer stack
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   \li The lock must be held by the caller.
+ * \note   \li If the function fails, the previous dispatch lists are left untouched. When
+ *             a layer was removed, the lists never grow, so the function cannot fail.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_LayerstackRebuildDispatch(NkVoid) {
+    NkSize const layerCount = NkVectorGetElementCount(gl_LayerStack.mp_layerStack);
+
+    /* Count the entries of all lists. */
+    NkSize nEntries = 0;
+    for (NkSize i = 0; i < layerCount; i++) {
+        NkEventCategory const lyCats = __NkInt_LayerstackGetCategories(NkVectorAt(gl_LayerStack.mp_layerStack, i));
+
+        for (NkEventType j = NkEv_None + 1; j < __NkEv_Count__; j++)
+            nEntries += (NkEventQueryCategories(j) & lyCats) != 0;
+    }
+
+    /* Grow the buffer if needed. */
+    if (nEntries > gl_LayerStack.m_dispCap) {
+        NkILayer **newArr;
+
+        NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nEntries * sizeof *newArr, 0, NK_FALSE, (NkVoid **)&newArr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        NkGPFree(gl_LayerStack.mp_dispArr);
+        gl_LayerStack.mp_dispArr = newArr;
+        gl_LayerStack.m_dispCap  = nEntries;
+    }
+
+    /* Fill the lists, keeping the stack order. */
+    NkSize currOff = 0;
+    for (NkEventType j = NkEv_None; j < __NkEv_Count__; j++) {
+        gl_LayerStack.m_dispOff[j] = currOff;
+        if (j == NkEv_None)
+            continue;
+
+        NkEventCategory const evCats = NkEventQueryCategories(j);
+        for (NkSize i = 0; i < layerCount; i++) {
+            NkILayer *currLayer = NkVectorAt(gl_LayerStack.mp_layerStack, i);
+
+            if ((__NkInt_LayerstackGetCategories(currLayer) & evCats) != 0)
+                gl_LayerStack.mp_dispArr[currOff++] = currLayer;
+        }
+    }
+    gl_LayerStack.m_dispOff[__NkEv_Count__] = currOff;
+
+    return NkErr_Ok;
+}
+
+
 /**
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(Layerstack)(NkVoid) {
@@ -97,6 +179,11 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(Layerstack)(
     NK_DESTROYLOCK(gl_LayerStack.m_mtxLock);
     /* Destroy the layer vector, releasing all layers still present in the stack. */
     NkVectorDestroy(&gl_LayerStack.mp_layerStack);
+    /* Destroy the dispatch lists. */
+    NkGPFree(gl_LayerStack.mp_dispArr);
+    gl_LayerStack.mp_dispArr = NULL;
+    gl_LayerStack.m_dispCap  = 0;
+    memset(gl_LayerStack.m_dispOff, 0, sizeof gl_LayerStack.m_dispOff);
 
     return NkErr_Ok;
 }
@@ -131,13 +218,17 @@ _Return_ok_ NkErrorCode NK_CALL NkLayerstackPush(_Inout_ NkILayer *layerRef, _In
      * increase the ref-count of the layer.
      */
     NK_LOCK(gl_LayerStack.m_mtxLock);
-    errCode = NkVectorInsert(
-        gl_LayerStack.mp_layerStack,
-        (NkVoid const *)layerRef,
-        whereInd != NK_AS_NORMAL
-            ? whereInd
-            : NkVectorGetElementCount(gl_LayerStack.mp_layerStack)
-    );
+    NkSize const actInd = whereInd != NK_AS_NORMAL
+        ? whereInd
+        : NkVectorGetElementCount(gl_LayerStack.mp_layerStack)
+    ;
+    errCode = NkVectorInsert(gl_LayerStack.mp_layerStack, (NkVoid const *)layerRef, actInd);
+    /* Add the layer to the dispatch lists. If that fails, undo the insertion. */
+    if (errCode == NkErr_Ok && (errCode = __NkInt_LayerstackRebuildDispatch()) != NkErr_Ok) {
+        NkVoid *remRef;
+
+        NK_IGNORE_RETURN_VALUE(NkVectorErase(gl_LayerStack.mp_layerStack, actInd, &remRef));
+    }
     NK_UNLOCK(gl_LayerStack.m_mtxLock);
     if (errCode == NkErr_Ok)
         layerRef->VT->AddRef(layerRef);
@@ -154,6 +245,9 @@ NkILayer *NK_CALL NkLayerstackPop(_In_ NkSize whereInd) {
      */
     NK_SYNCHRONIZED(gl_LayerStack.m_mtxLock, {
         NK_IGNORE_RETURN_VALUE(NkVectorErase(gl_LayerStack.mp_layerStack, whereInd, &layerRef));
+
+        /* Removing a layer never grows the dispatch lists, so this cannot fail. */
+        NK_IGNORE_RETURN_VALUE(__NkInt_LayerstackRebuildDispatch());
     });
 
     return layerRef;
@@ -163,11 +257,22 @@ _Return_ok_ NkErrorCode NK_CALL NkLayerstackOnEvent(_In_ NkEvent const *evPtr) {
     NK_ASSERT(evPtr != NULL, NkErr_InParameter);
     NK_ASSERT(gl_LayerStack.mp_layerStack != NULL, NkErr_ComponentState);
 
+    NK_ASSERT(evPtr->m_evType > NkEv_None && evPtr->m_evType < __NkEv_Count__, NkErr_InParameter);
+    /* Show the event on the timeline of profiler captures. */
+    NK_PROFILE_INSTANT(NkEventQueryTypeString(evPtr->m_evType)->mp_dataPtr);
+
+    /*
+     * Only walk the dispatch list for the event's type. Layers that are not interested
+     * in any of the event's categories are not part of it.
+     */
     NK_LOCK(gl_LayerStack.m_mtxLock);
     NkBoolean eventWasHandled = NK_FALSE;
-    NkSize const layerCount = NkVectorGetElementCount(gl_LayerStack.mp_layerStack);
-    for (NkSize i = 0; i < layerCount && !eventWasHandled; i++) {
-        NkILayer *currLayer = NkVectorAt(gl_LayerStack.mp_layerStack, i);
+    for (NkSize i = 0; !eventWasHandled; i++) {
+        NkSize const listInd = gl_LayerStack.m_dispOff[evPtr->m_evType] + i;
+        if (listInd >= gl_LayerStack.m_dispOff[evPtr->m_evType + 1])
+            break;
+
+        NkILayer *currLayer = gl_LayerStack.mp_dispArr[listInd];
         NK_ASSERT(currLayer != NULL, NkErr_ObjectState);
 
         NK_UNLOCK(gl_LayerStack.m_mtxLock);
@@ -194,7 +299,27 @@ _Return_ok_ NkErrorCode NK_CALL NkLayerstackOnUpdate(_In_ NkFloat updTime) {
         NK_ASSERT(currLayer != NULL, NkErr_ObjectState);
 
         NK_UNLOCK(gl_LayerStack.m_mtxLock);
-        currLayer->VT->OnUpdate(currLayer, updTime);
+        if (currLayer->VT->OnUpdate != NULL)
+            currLayer->VT->OnUpdate(currLayer, updTime);
+        NK_LOCK(gl_LayerStack.m_mtxLock);
+    }
+
+    NK_UNLOCK(gl_LayerStack.m_mtxLock);
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkLayerstackOnFixedUpdate(_In_ NkFloat updTime) {
+    NK_ASSERT(gl_LayerStack.mp_layerStack != NULL, NkErr_ComponentState);
+
+    NK_LOCK(gl_LayerStack.m_mtxLock);
+    NkSize const layerCount = NkVectorGetElementCount(gl_LayerStack.mp_layerStack);
+    for (NkSize i = 0; i < layerCount; i++) {
+        NkILayer *currLayer = NkVectorAt(gl_LayerStack.mp_layerStack, i);
+        NK_ASSERT(currLayer != NULL, NkErr_ObjectState);
+
+        NK_UNLOCK(gl_LayerStack.m_mtxLock);
+        if (currLayer->VT->OnFixedUpdate != NULL)
+            currLayer->VT->OnFixedUpdate(currLayer, updTime);
         NK_LOCK(gl_LayerStack.m_mtxLock);
     }
 
@@ -23,12 +23,15 @@
 
 /* stdlib includes */
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 /* Noriko includes */
 #include <include/Noriko/platform.h>
 #include <include/Noriko/log.h>
 #include <include/Noriko/comp.h>
+#include <include/Noriko/alloc.h>
 
 
 /** \cond INTERNAL */
@@ -42,11 +45,24 @@
  * \brief size of the message buffer, in bytes (incl. <tt>NUL</tt>-terminator)
  */
 #define NK_LOG_MSGSIZE    ((NkSize)(1 << 12))
+/**
+ * \def   NK_LOG_SPECSIZE
+ * \brief size of the buffer a single conversion specification of a captured message is
+ *        copied to, in bytes (incl. <tt>NUL</tt>-terminator)
+ */
+#define NK_LOG_SPECSIZE   ((NkSize)(1 << 5))
 /**
  * \def   NK_LOG_NDEV
  * \brief maximum number of devices that can be registered at a time
  */
 #define NK_LOG_NDEV       ((NkSize)(1 << 6))
+/**
+ * \def   NK_LOG_QUEUESIZE
+ * \brief number of records the queue of the asynchronous writer can hold; must be a
+ *        power of two
+ */
+#define NK_LOG_QUEUESIZE  ((NkUint32)(1 << 7))
+static_assert((NK_LOG_QUEUESIZE & (NK_LOG_QUEUESIZE - 1)) == 0, "Log queue size must be a power of two.");
 
 
 /**
@@ -56,11 +72,13 @@
 NK_NATIVE typedef struct __NkInt_LogContext {
     NK_DECL_LOCK(m_mtxLock);               /**< synchronization primitive */
 
-    NkSize        m_nOfDev;                /**< current number of registered devices */
-    NkLogLevel    m_glMinLevel;            /**< global minimum log level */
-    NkLogLevel    m_glMaxLevel;            /**< global maximum log level */
-    NkStringView  m_defTsFmt;              /**< default ts format string */
-    NkILogDevice *m_devArray[NK_LOG_NDEV]; /**< device array */
+    NkSize             m_nOfDev;                 /**< current number of registered devices */
+    NkLogLevel         m_glMinLevel;             /**< global minimum log level */
+    NkLogLevel         m_glMaxLevel;             /**< global maximum log level */
+    NkUint32 volatile  m_lvlMask;                /**< levels at least one installed device wants */
+    NkStringView       m_defTsFmt;               /**< default ts format string */
+    NkILogDevice      *m_devArray[NK_LOG_NDEV];  /**< device array */
+    NkUint32           m_devMask[NK_LOG_NDEV];   /**< levels each device wants */
 } __NkInt_LogContext;
 
 /**
@@ -68,12 +86,9 @@ NK_NATIVE typedef struct __NkInt_LogContext {
  */
 NK_INTERNAL __NkInt_LogContext gl_LogContext = {
     .m_nOfDev     = 0,
-#if (defined NK_CONFIG_DEBUG)
-    .m_glMinLevel = NkLogLvl_None,
-#else
-    .m_glMinLevel = NkLogLvl_Info,
-#endif
+    .m_glMinLevel = NK_LOG_MINLEVEL,
     .m_glMaxLevel = NkLogLvl_Critical,
+    .m_lvlMask    = 0,
     .m_defTsFmt   = NK_MAKE_STRING_VIEW("%m-%d-%y %H:%M:%S"),
     .m_devArray   = { NULL }
 };
@@ -283,6 +298,43 @@ NK_INTERNAL NkILogDevice const gl_ConoutDevice = {
 #pragma endregion
 
 
+/**
+ * \brief formats the given broken-down time as a timestamp
+ * \param [in] currTimePtr broken-down time
+ * \param [out] tsPtr pointer to the timestamp buffer
+ * \param [out] tsSzPtr variable that will receive the length of the timestamp
+ */
+NK_INTERNAL NkVoid __NkInt_LogPrintTimestamp(
+    _In_                        NkNativeTime const *currTimePtr,
+    _Out_writes_(NK_LOG_TSSIZE) char *tsPtr,
+    _Out_                       NkSize *tsSzPtr
+) {
+    *tsSzPtr = strftime(
+        tsPtr,
+        NK_LOG_TSSIZE,
+        gl_LogContext.m_defTsFmt.mp_dataPtr,
+        currTimePtr
+    );
+}
+
+/**
+ * \brief formats the given point in time as a timestamp
+ * \param [in] rawTime point in time, as returned by <tt>_time64()</tt>
+ * \param [out] tsPtr pointer to the timestamp buffer
+ * \param [out] tsSzPtr variable that will receive the length of the timestamp
+ * \param [out] currTimePtr variable that will receive the broken-down time
+ */
+NK_INTERNAL NkVoid __NkInt_LogFormatTimestamp(
+    _In_                        NkInt64 rawTime,
+    _Out_writes_(NK_LOG_TSSIZE) char *tsPtr,
+    _Out_                       NkSize *tsSzPtr,
+    _Out_                       NkNativeTime *currTimePtr
+) {
+    localtime_s(currTimePtr, &rawTime);
+
+    __NkInt_LogPrintTimestamp(currTimePtr, tsPtr, tsSzPtr);
+}
+
 /**
  * \brief formats the new log message and also updates the timestamp if necessary
  * \param [in] fmtStr pointer to the format template of the current log message
@@ -304,19 +356,14 @@ NK_INTERNAL NkVoid __NkInt_LogFormatMessageAndTimestamp(
     _Out_                        NkSize *tsSzPtr,
     _Out_                        NkNativeTime *currTimePtr
 ) {
-    /* Format string. */
-    *msgSzPtr = (NkSize)vsnprintf(msgPtr, NK_LOG_MSGSIZE, fmtStr, vlArgs);
+    /* Format string. If the message was truncated, report the truncated length. */
+    int const fmtRes = vsnprintf(msgPtr, NK_LOG_MSGSIZE, fmtStr, vlArgs);
+    *msgSzPtr = fmtRes < 0 ? 0 : NK_MIN((NkSize)fmtRes, NK_LOG_MSGSIZE - 1);
 
     /* Format timestamp. */
     NkInt64 currLTime;
     _time64(&currLTime);
-    localtime_s(currTimePtr, &currLTime);
-    *tsSzPtr = strftime(
-        tsPtr,
-        NK_LOG_TSSIZE,
-        gl_LogContext.m_defTsFmt.mp_dataPtr,
-        currTimePtr
-    );
+    __NkInt_LogFormatTimestamp(currLTime, tsPtr, tsSzPtr, currTimePtr);
 }
 
 /**
@@ -331,6 +378,604 @@ NK_INTERNAL NkSize __NkInt_LogFindDevice(_In_ NkILogDevice *devRef) {
     return SIZE_MAX;
 }
 
+/**
+ * \brief checks whether messages of the given level are currently logged
+ * \param [in] lvlId ID of the log level
+ * \return \c NK_TRUE if the level is enabled and at least one installed device wants
+ *         it, \c NK_FALSE otherwise
+ * \note  The check is done without holding the lock; the devices are checked again
+ *        when the message is propagated.
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_LogIsEnabled(_In_ NkLogLevel lvlId) {
+    return NK_INRANGE_INCL(lvlId, gl_LogContext.m_glMinLevel, gl_LogContext.m_glMaxLevel)
+        && (gl_LogContext.m_lvlMask & (1u << lvlId)) != 0
+    ;
+}
+
+/**
+ * \brief recalculates the combined level mask of all installed devices
+ * \note  This function must be called while holding the lock.
+ */
+NK_INTERNAL NkVoid __NkInt_LogUpdateLevelMask(NkVoid) {
+    NkUint32 lvlMask = 0;
+
+    for (NkSize i = 0; i < NK_ARRAYSIZE(gl_LogContext.m_devArray); i++)
+        if (gl_LogContext.m_devArray[i] != NULL)
+            lvlMask |= gl_LogContext.m_devMask[i];
+
+    gl_LogContext.m_lvlMask = lvlMask;
+}
+
+/**
+ * \brief propagates a formatted message to all installed devices
+ * \param [in] lvlId ID of the log level
+ * \param [in] msgCxtPtr pointer to the message context
+ * \param [in] tsStr formatted timestamp
+ * \param [in] msgStr formatted message
+ */
+NK_INTERNAL NkVoid __NkInt_LogDispatch(
+    _In_ NkLogLevel lvlId,
+    _In_ NkLogMessageContext const *msgCxtPtr,
+    _In_ NkStringView tsStr,
+    _In_ NkStringView msgStr
+) {
+    NK_LOCK(gl_LogContext.m_mtxLock);
+    /*
+     * Propagate formatted message and additional context data to sinks. Stop when we
+     * reach the end of the sink array or we have processed all registered sinks,
+     * whatever comes first.
+     */
+    for (NkSize i = 0, j = 0; i < NK_ARRAYSIZE(gl_LogContext.m_devArray) && j < gl_LogContext.m_nOfDev; i++) {
+        /* Get pointer to device. If the slot is empty, ignore. */
+        NkILogDevice *currDev = gl_LogContext.m_devArray[i];
+        if (currDev == NULL)
+            continue;
+        ++j;
+        if ((gl_LogContext.m_devMask[i] & (1u << lvlId)) == 0)
+            continue;
+
+        /* Call the device's 'NkILogDevice::OnMessage()' method. */
+        NK_UNLOCK(gl_LogContext.m_mtxLock);
+        currDev->VT->OnMessage(currDev, lvlId, msgCxtPtr, tsStr, msgStr);
+        NK_LOCK(gl_LogContext.m_mtxLock);
+    }
+    NK_UNLOCK(gl_LogContext.m_mtxLock);
+}
+
+
+#if (defined NK_TARGET_MULTITHREADED)
+/*
+ * implementation of the asynchronous log writer
+ *
+ * In asynchronous mode, callers format their message directly into a slot of a bounded
+ * multi-producer/single-consumer queue and return. A dedicated writer thread takes the
+ * records out of the queue in order and passes them to the devices, so that slow device
+ * I/O (e.g., console output) never blocks the caller.
+ */
+#pragma region Asynchronous Writer
+/**
+ * \struct __NkInt_LogRecord
+ * \brief  represents a single slot of the log queue
+ *
+ * The sequence number works like the one of the event queue: a slot at index \c i is
+ * free for position \c p if <tt>m_seqOff + i == p</tt> and holds the record written at
+ * position \c p if <tt>m_seqOff + i == p + 1</tt>. This keeps the zero-initialized queue
+ * valid.
+ */
+NK_NATIVE typedef struct __NkInt_LogRecord {
+    LONG volatile       m_seqOff;                 /**< sequence number, relative to the slot's index */
+    NkLogLevel          m_lvlId;                  /**< log level of the message */
+    NkBoolean           m_isDeferred;             /**< whether <tt>m_msgBuf</tt> holds captured arguments */
+    NkLogMessageContext m_msgCxt;                 /**< copy of the caller's message context */
+    NkSize              m_tsSize;                 /**< length of the timestamp, in bytes */
+    NkSize              m_msgSize;                /**< length of the message, in bytes */
+    char                m_tsBuf[NK_LOG_TSSIZE];   /**< formatted timestamp */
+    alignas(8) char     m_msgBuf[NK_LOG_MSGSIZE]; /**< formatted message, or captured format and arguments */
+} __NkInt_LogRecord;
+
+/**
+ * \struct __NkInt_LogQueue
+ * \brief  represents the state of the asynchronous writer
+ */
+NK_NATIVE typedef struct __NkInt_LogQueue {
+    alignas(64) LONG volatile m_writePos;                  /**< next position to be claimed by a producer */
+    alignas(64) LONG volatile m_readPos;                   /**< next position to be read by the writer */
+    LONG volatile             m_nProducers;                /**< number of callers currently using the queue */
+    LONG volatile             m_isSleeping;                /**< whether the writer is (about to be) waiting */
+    NkBoolean volatile        m_isAsync;                   /**< whether asynchronous mode is enabled */
+    NkBoolean                 m_isShutdown;                /**< whether the writer is to exit once idle */
+    thrd_t                    m_wrThread;                  /**< writer thread */
+    cnd_t                     m_wakeCnd;                   /**< signaled when records were written */
+    NK_DECL_LOCK(m_sleepLock);                             /**< lock for <tt>m_wakeCnd</tt> */
+    __NkInt_LogRecord         m_recArr[NK_LOG_QUEUESIZE];  /**< record slots */
+} __NkInt_LogQueue;
+
+/**
+ * \brief global log queue instance
+ */
+NK_INTERNAL __NkInt_LogQueue gl_LogQueue;
+/**
+ * \brief whether the current thread is the writer thread
+ * \note  Messages logged by devices from within the writer thread are written
+ *        synchronously; queueing them could deadlock if the queue is full.
+ */
+NK_INTERNAL NK_THREADLOCAL NkBoolean gl_IsLogWriter = NK_FALSE;
+
+
+/**
+ * \enum  __NkInt_LogArgType
+ * \brief types of the arguments that can be captured for deferred formatting
+ */
+NK_NATIVE typedef enum __NkInt_LogArgType {
+    __NkInt_LogArg_None,     /**< conversion takes no argument (<tt>%%</tt>) */
+    __NkInt_LogArg_Int,      /**< \c int (also <tt>char</tt>, <tt>short</tt>) */
+    __NkInt_LogArg_Long,     /**< \c long */
+    __NkInt_LogArg_LongLong, /**< <tt>long long</tt> */
+    __NkInt_LogArg_Size,     /**< \c size_t */
+    __NkInt_LogArg_IntMax,   /**< \c intmax_t */
+    __NkInt_LogArg_PtrDiff,  /**< \c ptrdiff_t */
+    __NkInt_LogArg_Double,   /**< \c double */
+    __NkInt_LogArg_Pointer,  /**< <tt>void *</tt> */
+    __NkInt_LogArg_String,   /**< <tt>char const *</tt> (copied) */
+    __NkInt_LogArg_Invalid   /**< conversion not supported; message is formatted eagerly */
+} __NkInt_LogArgType;
+
+/**
+ * \struct __NkInt_LogSpec
+ * \brief  represents a parsed conversion specification
+ */
+NK_NATIVE typedef struct __NkInt_LogSpec {
+    NkSize             m_specLen;   /**< length of the specification, incl. the leading <tt>%</tt> */
+    NkInt32            m_nStars;    /**< number of <tt>*</tt> width/precision arguments */
+    NkBoolean          m_isPrecArg; /**< whether the precision is passed as an argument */
+    NkInt32            m_precVal;   /**< literal precision, or \c -1 if there is none */
+    __NkInt_LogArgType m_argType;   /**< type of the converted argument */
+} __NkInt_LogSpec;
+
+
+/**
+ * \brief parses the conversion specification starting at the given <tt>%</tt>
+ * \param [in] specStr pointer to the <tt>%</tt> character
+ * \param [out] specPtr pointer to the structure that receives the parsed specification
+ */
+NK_INTERNAL NkVoid __NkInt_LogParseSpec(_In_z_ char const *specStr, _Out_ __NkInt_LogSpec *specPtr) {
+    char const *currPtr = specStr + 1;
+    *specPtr = (__NkInt_LogSpec){ .m_precVal = -1, .m_argType = __NkInt_LogArg_Invalid };
+
+    /* Skip flags and width. */
+    while (*currPtr != '\0' && strchr("-+ #0", *currPtr) != NULL)
+        ++currPtr;
+    if (*currPtr == '*')
+        ++specPtr->m_nStars, ++currPtr;
+    else
+        while (*currPtr >= '0' && *currPtr <= '9')
+            ++currPtr;
+    /* Parse precision; needed to know how much of a string argument must be copied. */
+    if (*currPtr == '.') {
+        ++currPtr;
+
+        if (*currPtr == '*') {
+            ++specPtr->m_nStars, ++currPtr;
+
+            specPtr->m_isPrecArg = NK_TRUE;
+        } else
+            for (specPtr->m_precVal = 0; *currPtr >= '0' && *currPtr <= '9'; ++currPtr)
+                specPtr->m_precVal = NK_MIN(specPtr->m_precVal * 10 + (*currPtr - '0'), (NkInt32)NK_LOG_MSGSIZE);
+    }
+
+    /* Parse length modifier. */
+    __NkInt_LogArgType intType = __NkInt_LogArg_Int;
+    NkBoolean          isLong  = NK_FALSE;
+    switch (*currPtr) {
+        case 'h': currPtr += currPtr[1] == 'h' ? 2 : 1;                                   break;
+        case 'z': intType = __NkInt_LogArg_Size;    ++currPtr;                             break;
+        case 'j': intType = __NkInt_LogArg_IntMax;  ++currPtr;                             break;
+        case 't': intType = __NkInt_LogArg_PtrDiff; ++currPtr;                             break;
+        case 'L': return;
+        case 'l':
+            if (currPtr[1] == 'l')
+                intType = __NkInt_LogArg_LongLong, currPtr += 2;
+            else
+                intType = __NkInt_LogArg_Long, isLong = NK_TRUE, ++currPtr;
+
+            break;
+        case 'I':
+            /* Microsoft-specific size prefixes. */
+            if (currPtr[1] == '6' && currPtr[2] == '4')
+                intType = __NkInt_LogArg_LongLong, currPtr += 3;
+            else if (currPtr[1] == '3' && currPtr[2] == '2')
+                currPtr += 3;
+            else
+                intType = __NkInt_LogArg_Size, ++currPtr;
+
+            break;
+    }
+
+    /* Determine argument type from the conversion specifier. */
+    switch (*currPtr) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            specPtr->m_argType = intType;
+
+            break;
+        case 'c':
+            specPtr->m_argType = isLong ? __NkInt_LogArg_Invalid : __NkInt_LogArg_Int;
+
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            specPtr->m_argType = __NkInt_LogArg_Double;
+
+            break;
+        case 's': specPtr->m_argType = intType == __NkInt_LogArg_Int && !isLong ? __NkInt_LogArg_String : __NkInt_LogArg_Invalid; break;
+        case 'p': specPtr->m_argType = __NkInt_LogArg_Pointer;                                                               break;
+        case '%': specPtr->m_argType = __NkInt_LogArg_None;                                                                  break;
+        default:
+            /* Unsupported ('%n', wide strings, etc.) or truncated specification. */
+            return;
+    }
+    specPtr->m_specLen = (NkSize)(currPtr + 1 - specStr);
+}
+
+/**
+ * \brief  captures the format template and the arguments of a message in binary form
+ * \param  [in] fmtStr format template of the message
+ * \param  [in] vlArgs extra arguments to format the message with
+ * \param  [out] bufPtr buffer that receives the captured data
+ * \return \c NK_TRUE if the message was captured, \c NK_FALSE if it uses conversions
+ *         that cannot be captured or does not fit into the buffer
+ *
+ * \par Remarks
+ *   The buffer receives a copy of the format template, followed by one 8-byte slot per
+ *   argument. Strings are copied into the buffer, prefixed by their length, so that
+ *   the caller may free them right after logging.
+ */
+NK_INTERNAL NkBoolean __NkInt_LogCaptureMessage(
+    _In_z_ _Format_str_          char const *fmtStr,
+    _In_opt_                     va_list vlArgs,
+    _Out_writes_(NK_LOG_MSGSIZE) char *bufPtr
+) {
+    NkSize const fmtLen = strlen(fmtStr) + 1;
+    NkSize       bufOff = (fmtLen + 7) & ~(NkSize)7;
+    if (bufOff > NK_LOG_MSGSIZE)
+        return NK_FALSE;
+    memcpy(bufPtr, fmtStr, fmtLen);
+
+    for (char const *currPtr = strchr(fmtStr, '%'); currPtr != NULL; ) {
+        __NkInt_LogSpec currSpec;
+        __NkInt_LogParseSpec(currPtr, &currSpec);
+        /* The writer thread formats every conversion on its own, from a copy of the spec. */
+        if (currSpec.m_argType == __NkInt_LogArg_Invalid || currSpec.m_specLen >= NK_LOG_SPECSIZE)
+            return NK_FALSE;
+
+        /* Capture the '*' arguments first; they precede the converted argument. */
+        NkInt32 starArr[2] = { 0, 0 };
+        NkSize  argSize    = 8 * (NkSize)currSpec.m_nStars + (currSpec.m_argType != __NkInt_LogArg_None ? 8 : 0);
+        if (NK_LOG_MSGSIZE - bufOff < argSize)
+            return NK_FALSE;
+        for (NkInt32 i = 0; i < currSpec.m_nStars; i++) {
+            NkInt64 const starVal = (NkInt64)(starArr[i] = va_arg(vlArgs, int));
+
+            memcpy(bufPtr + bufOff, &starVal, sizeof starVal);
+            bufOff += 8;
+        }
+
+        NkUint64 argVal = 0;
+        switch (currSpec.m_argType) {
+            case __NkInt_LogArg_Int:      argVal = (NkUint64)va_arg(vlArgs, int);       break;
+            case __NkInt_LogArg_Long:     argVal = (NkUint64)va_arg(vlArgs, long);      break;
+            case __NkInt_LogArg_LongLong: argVal = (NkUint64)va_arg(vlArgs, long long); break;
+            case __NkInt_LogArg_Size:     argVal = (NkUint64)va_arg(vlArgs, size_t);    break;
+            case __NkInt_LogArg_IntMax:   argVal = (NkUint64)va_arg(vlArgs, intmax_t);  break;
+            case __NkInt_LogArg_PtrDiff:  argVal = (NkUint64)va_arg(vlArgs, ptrdiff_t); break;
+            case __NkInt_LogArg_Pointer:  argVal = (NkUint64)(NkSize)va_arg(vlArgs, NkVoid *); break;
+            case __NkInt_LogArg_Double: {
+                double const dblVal = va_arg(vlArgs, double);
+
+                memcpy(&argVal, &dblVal, sizeof dblVal);
+                break;
+            }
+            case __NkInt_LogArg_String: {
+                char const *strPtr = va_arg(vlArgs, char const *);
+                strPtr = strPtr != NULL ? strPtr : "(null)";
+
+                /* Only copy as much of the string as the precision allows. */
+                NkInt32 const precVal = currSpec.m_isPrecArg ? starArr[currSpec.m_nStars - 1] : currSpec.m_precVal;
+                NkSize        strLen  = 0;
+                while ((precVal < 0 || strLen < (NkSize)precVal) && strPtr[strLen] != '\0')
+                    if (++strLen >= NK_LOG_MSGSIZE)
+                        return NK_FALSE;
+
+                NkSize const strSize = (8 + strLen + 1 + 7) & ~(NkSize)7;
+                if (NK_LOG_MSGSIZE - bufOff < strSize)
+                    return NK_FALSE;
+                argVal = (NkUint64)strLen;
+                memcpy(bufPtr + bufOff, &argVal, sizeof argVal);
+                memcpy(bufPtr + bufOff + 8, strPtr, strLen);
+                bufPtr[bufOff + 8 + strLen] = '\0';
+
+                bufOff += strSize;
+                break;
+            }
+            default:
+                break;
+        }
+        if (currSpec.m_argType != __NkInt_LogArg_None && currSpec.m_argType != __NkInt_LogArg_String) {
+            memcpy(bufPtr + bufOff, &argVal, sizeof argVal);
+
+            bufOff += 8;
+        }
+
+        currPtr = strchr(currPtr + currSpec.m_specLen, '%');
+    }
+
+    return NK_TRUE;
+}
+
+/**
+ * \brief  formats a message that was captured by <tt>__NkInt_LogCaptureMessage()</tt>
+ * \param  [in] bufPtr buffer holding the captured data
+ * \param  [out] msgPtr buffer that receives the formatted message
+ * \return length of the formatted message, in bytes
+ */
+NK_INTERNAL NkSize __NkInt_LogFormatCaptured(
+    _In_reads_(NK_LOG_MSGSIZE)   char const *bufPtr,
+    _Out_writes_(NK_LOG_MSGSIZE) char *msgPtr
+) {
+    char const *fmtPtr = bufPtr;
+    NkSize      bufOff = (strlen(fmtPtr) + 1 + 7) & ~(NkSize)7;
+    NkSize      msgLen = 0;
+
+    while (*fmtPtr != '\0' && msgLen < NK_LOG_MSGSIZE - 1) {
+        /* Copy literal text up to the next conversion. */
+        if (*fmtPtr != '%') {
+            msgPtr[msgLen++] = *fmtPtr++;
+
+            continue;
+        }
+
+        /*
+         * Format the single conversion with the captured argument. The specification was
+         * already validated when the message was captured, including its length.
+         */
+        __NkInt_LogSpec currSpec;
+        __NkInt_LogParseSpec(fmtPtr, &currSpec);
+        char specBuf[NK_LOG_SPECSIZE];
+        memcpy(specBuf, fmtPtr, currSpec.m_specLen);
+        specBuf[currSpec.m_specLen] = '\0';
+
+        int starArr[2] = { 0, 0 };
+        for (NkInt32 i = 0; i < currSpec.m_nStars; i++, bufOff += 8) {
+            NkInt64 starVal;
+
+            memcpy(&starVal, bufPtr + bufOff, sizeof starVal);
+            starArr[i] = (int)starVal;
+        }
+        NkUint64 argVal = 0;
+        if (currSpec.m_argType != __NkInt_LogArg_None)
+            memcpy(&argVal, bufPtr + bufOff, sizeof argVal);
+
+        char *const  outPtr = msgPtr + msgLen;
+        NkSize const outCap = NK_LOG_MSGSIZE - msgLen;
+#define __NkInt_LogFormatArg(val)                                                      \
+    (currSpec.m_nStars == 0 ? snprintf(outPtr, outCap, specBuf, val)                    \
+        : currSpec.m_nStars == 1 ? snprintf(outPtr, outCap, specBuf, starArr[0], val)   \
+        : snprintf(outPtr, outCap, specBuf, starArr[0], starArr[1], val))
+        int fmtRes = 0;
+        switch (currSpec.m_argType) {
+            case __NkInt_LogArg_None:     fmtRes = snprintf(outPtr, outCap, "%%");                 break;
+            case __NkInt_LogArg_Int:      fmtRes = __NkInt_LogFormatArg((int)argVal);              break;
+            case __NkInt_LogArg_Long:     fmtRes = __NkInt_LogFormatArg((long)argVal);             break;
+            case __NkInt_LogArg_LongLong: fmtRes = __NkInt_LogFormatArg((long long)argVal);        break;
+            case __NkInt_LogArg_Size:     fmtRes = __NkInt_LogFormatArg((size_t)argVal);           break;
+            case __NkInt_LogArg_IntMax:   fmtRes = __NkInt_LogFormatArg((intmax_t)argVal);         break;
+            case __NkInt_LogArg_PtrDiff:  fmtRes = __NkInt_LogFormatArg((ptrdiff_t)argVal);        break;
+            case __NkInt_LogArg_Pointer:  fmtRes = __NkInt_LogFormatArg((NkVoid *)(NkSize)argVal); break;
+            case __NkInt_LogArg_Double: {
+                double dblVal;
+                memcpy(&dblVal, &argVal, sizeof dblVal);
+
+                fmtRes = __NkInt_LogFormatArg(dblVal);
+                break;
+            }
+            case __NkInt_LogArg_String:
+                fmtRes  = __NkInt_LogFormatArg(bufPtr + bufOff + 8);
+                bufOff += ((8 + (NkSize)argVal + 1 + 7) & ~(NkSize)7) - 8;
+
+                break;
+            default:
+                break;
+        }
+#undef __NkInt_LogFormatArg
+        if (currSpec.m_argType != __NkInt_LogArg_None)
+            bufOff += 8;
+
+        msgLen += fmtRes < 0 ? 0 : NK_MIN((NkSize)fmtRes, outCap - 1);
+        fmtPtr += currSpec.m_specLen;
+    }
+
+    msgPtr[msgLen] = '\0';
+    return msgLen;
+}
+
+
+/**
+ * \brief wakes up the writer thread if it is waiting for records
+ */
+NK_INTERNAL NkVoid __NkInt_LogWakeWriter(NkVoid) {
+    /*
+     * The writer announces that it is about to sleep before it checks the queue a final
+     * time. As both sides use full barriers, either the writer sees the new record or we
+     * see the announcement here.
+     */
+    if (InterlockedCompareExchange(&gl_LogQueue.m_isSleeping, 0, 0) == 0)
+        return;
+
+    NK_LOCK(gl_LogQueue.m_sleepLock);
+    cnd_signal(&gl_LogQueue.m_wakeCnd);
+    NK_UNLOCK(gl_LogQueue.m_sleepLock);
+}
+
+/**
+ * \brief  retrieves the record at the current read position if it is complete
+ * \return pointer to the record, or \c NULL if the queue is empty or the producer of the
+ *         record is still formatting it
+ */
+NK_INTERNAL __NkInt_LogRecord *__NkInt_LogPeekRecord(NkVoid) {
+    LONG const     currPos = gl_LogQueue.m_readPos;
+    NkUint32 const slotInd = (NkUint32)currPos & (NK_LOG_QUEUESIZE - 1);
+
+    __NkInt_LogRecord *recPtr = &gl_LogQueue.m_recArr[slotInd];
+    return (NkUint32)recPtr->m_seqOff + slotInd == (NkUint32)currPos + 1 ? recPtr : NULL;
+}
+
+/**
+ * \brief formats a message into the log queue
+ * \param [in] msgCxtPtr pointer to the message context
+ * \param [in] lvlId ID of the log level
+ * \param [in] fmtStr format template of the message
+ * \param [in] vlArgs extra arguments to format the message with
+ * \note  If the queue is full, the function waits for the writer to free a slot. This
+ *        keeps messages from being lost while limiting the memory used for buffering.
+ */
+NK_INTERNAL NkVoid __NkInt_LogEnqueue(
+    _In_                NkLogMessageContext const *msgCxtPtr,
+    _In_                NkLogLevel lvlId,
+    _In_z_ _Format_str_ char const *fmtStr,
+    _In_opt_            va_list vlArgs
+) {
+    /* Claim a slot; see '__NkInt_EventEnqueue()' in event.c. */
+    __NkInt_LogRecord *recPtr;
+    NkUint32 slotInd;
+    LONG currPos = gl_LogQueue.m_writePos;
+    for (;;) {
+        slotInd = (NkUint32)currPos & (NK_LOG_QUEUESIZE - 1);
+        recPtr  = &gl_LogQueue.m_recArr[slotInd];
+
+        NkInt32 const seqDiff = (NkInt32)((NkUint32)recPtr->m_seqOff + slotInd - (NkUint32)currPos);
+        if (seqDiff == 0) {
+            LONG const prevPos = InterlockedCompareExchange(&gl_LogQueue.m_writePos, currPos + 1, currPos);
+
+            if (prevPos == currPos)
+                break;
+            currPos = prevPos;
+        } else if (seqDiff < 0) {
+            /* Queue is full; let the writer catch up. */
+            __NkInt_LogWakeWriter();
+            thrd_yield();
+
+            currPos = gl_LogQueue.m_writePos;
+        } else
+            currPos = gl_LogQueue.m_writePos;
+    }
+
+    /*
+     * Capture the message in binary form so that the writer thread does the formatting.
+     * If that is not possible, format the message directly into the slot.
+     */
+    recPtr->m_lvlId  = lvlId;
+    recPtr->m_msgCxt = *msgCxtPtr;
+
+    va_list vlCopy;
+    va_copy(vlCopy, vlArgs);
+    recPtr->m_isDeferred = __NkInt_LogCaptureMessage(fmtStr, vlCopy, recPtr->m_msgBuf);
+    va_end(vlCopy);
+    if (recPtr->m_isDeferred) {
+        /* Only printing the timestamp is left to the writer. */
+        NkInt64 currLTime;
+        _time64(&currLTime);
+
+        localtime_s(&recPtr->m_msgCxt.m_timestamp, &currLTime);
+    } else
+        __NkInt_LogFormatMessageAndTimestamp(
+            fmtStr,
+            vlArgs,
+            recPtr->m_msgBuf,
+            recPtr->m_tsBuf,
+            &recPtr->m_msgSize,
+            &recPtr->m_tsSize,
+            &recPtr->m_msgCxt.m_timestamp
+        );
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange(&recPtr->m_seqOff, (LONG)((NkUint32)currPos + 1 - slotInd)));
+
+    __NkInt_LogWakeWriter();
+}
+
+/**
+ * \brief  waits until all records that were queued before the call have been written
+ * \param  [in] untilPos write position up to which the records must have been written
+ */
+NK_INTERNAL NkVoid __NkInt_LogWaitWritten(_In_ LONG untilPos) {
+    while ((NkInt32)((NkUint32)InterlockedCompareExchange(&gl_LogQueue.m_readPos, 0, 0) - (NkUint32)untilPos) < 0) {
+        __NkInt_LogWakeWriter();
+
+        thrd_yield();
+    }
+}
+
+/**
+ * \brief  entry point of the writer thread
+ * \param  [in] extraCxt unused
+ * \return always \c 0
+ */
+NK_INTERNAL int __NkInt_LogWriterProc(_In_opt_ NkVoid *extraCxt) {
+    NK_UNREFERENCED_PARAMETER(extraCxt);
+
+    /* buffer for messages whose formatting was deferred to this thread */
+    char msgBuf[NK_LOG_MSGSIZE];
+
+    gl_IsLogWriter = NK_TRUE;
+    for (;;) {
+        __NkInt_LogRecord *recPtr = __NkInt_LogPeekRecord();
+
+        if (recPtr != NULL) {
+            LONG const     currPos = gl_LogQueue.m_readPos;
+            NkUint32 const slotInd = (NkUint32)currPos & (NK_LOG_QUEUESIZE - 1);
+
+            /* Format deferred messages now. */
+            char const *msgPtr = recPtr->m_msgBuf;
+            if (recPtr->m_isDeferred) {
+                recPtr->m_msgSize = __NkInt_LogFormatCaptured(recPtr->m_msgBuf, msgBuf);
+                __NkInt_LogPrintTimestamp(&recPtr->m_msgCxt.m_timestamp, recPtr->m_tsBuf, &recPtr->m_tsSize);
+
+                msgPtr = msgBuf;
+            }
+
+            __NkInt_LogDispatch(
+                recPtr->m_lvlId,
+                &recPtr->m_msgCxt,
+                (NkStringView){ recPtr->m_tsBuf, recPtr->m_tsSize  },
+                (NkStringView){ (char *)msgPtr,  recPtr->m_msgSize }
+            );
+
+            /* Free the slot for the next lap. */
+            NK_IGNORE_RETURN_VALUE(
+                InterlockedExchange(&recPtr->m_seqOff, (LONG)((NkUint32)currPos + NK_LOG_QUEUESIZE - slotInd))
+            );
+            NK_IGNORE_RETURN_VALUE(InterlockedExchange(&gl_LogQueue.m_readPos, currPos + 1));
+            continue;
+        }
+
+        /* Nothing to do; sleep until records are written. */
+        NK_LOCK(gl_LogQueue.m_sleepLock);
+        NK_IGNORE_RETURN_VALUE(InterlockedExchange(&gl_LogQueue.m_isSleeping, 1));
+        while (__NkInt_LogPeekRecord() == NULL && !gl_LogQueue.m_isShutdown)
+            cnd_wait(&gl_LogQueue.m_wakeCnd, &gl_LogQueue.m_sleepLock);
+        NK_IGNORE_RETURN_VALUE(InterlockedExchange(&gl_LogQueue.m_isSleeping, 0));
+        NkBoolean const isExit = gl_LogQueue.m_isShutdown && __NkInt_LogPeekRecord() == NULL;
+        NK_UNLOCK(gl_LogQueue.m_sleepLock);
+
+        if (isExit)
+            break;
+    }
+
+    /* Sinks may have allocated on this thread. */
+    NkAllocReleaseThreadCache();
+    gl_IsLogWriter = NK_FALSE;
+    return 0;
+}
+#pragma endregion
+#endif
+
+
 /**
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(Logging)(NkVoid) {
@@ -340,13 +985,24 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(Logging)(NkVo
 
 #if (!defined NK_CONFIG_DEPLOY)
     /* Register built-in debug logger. */
-    errCode = NkLogInstallDevice((NkILogDevice *)&gl_ConoutDevice);
+    if ((errCode = NkLogInstallDevice((NkILogDevice *)&gl_ConoutDevice)) != NkErr_Ok)
+        return errCode;
 #endif
 
-    return errCode;
+    /*
+     * Write messages asynchronously by default. If the writer thread cannot be started,
+     * messages are simply written synchronously.
+     */
+    if ((errCode = NkLogSetAsyncMode(NK_TRUE)) != NkErr_Ok && errCode != NkErr_NotImplemented)
+        NK_LOG_WARNING("Could not start the log writer thread; logging synchronously.");
+
+    return NkErr_Ok;
 }
 
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(Logging)(NkVoid) {
+    /* Write all pending messages and stop the writer thread. */
+    NK_IGNORE_RETURN_VALUE(NkLogSetAsyncMode(NK_FALSE));
+
     /*
      * Traverse the device array, run their 'NkILogDevice::OnUninstall()' method and
      * release them. 
@@ -404,6 +1060,13 @@ _Return_ok_ NkErrorCode NK_CALL NkLogInstallDevice(_Inout_ NkILogDevice *devRef)
             devArr[i] = devRef;
             devRef->VT->AddRef(devRef);
             ++gl_LogContext.m_nOfDev;
+
+            /* Update the levels that are to be formatted. */
+            gl_LogContext.m_devMask[i] = devRef->VT->QueryLevelMask != NULL
+                ? devRef->VT->QueryLevelMask(devRef)
+                : UINT32_MAX
+            ;
+            __NkInt_LogUpdateLevelMask();
             goto lbl_CLEANUP;
         }
     }
@@ -432,6 +1095,7 @@ _Return_ok_ NkErrorCode NK_CALL NkLogUninstallDevice(_Inout_ NkILogDevice *devRe
     /* Erase device from array. */
     gl_LogContext.m_devArray[devIndex] = NULL;
     --gl_LogContext.m_nOfDev;
+    __NkInt_LogUpdateLevelMask();
 
     NK_UNLOCK(gl_LogContext.m_mtxLock);
     return NkErr_Ok;
@@ -446,6 +1110,13 @@ NkVoid NK_CALL NkLogMessage(
     NK_ASSERT(0 <= lvlId && lvlId < __NkLogLvl_Count__, NkErr_InParameter);
     NK_ASSERT(fmtStr != NULL, NkErr_InParameter);
 
+    /*
+     * If the log level is globally disabled or there are currently no sinks registered,
+     * do nothing. Checking this first saves formatting messages nobody will see.
+     */
+    if (!__NkInt_LogIsEnabled(lvlId))
+        return;
+
     /*
      * If we got no message context provided, redirect our context modification efforts
      * to our statically-allocated context.
@@ -453,51 +1124,96 @@ NkVoid NK_CALL NkLogMessage(
     NkLogMessageContext msgContext = { .m_structSize = sizeof msgContext };
     msgCxtPtr = msgCxtPtr != NULL ? msgCxtPtr : &msgContext;
 
-    /* Format message and timestamp (timestamp only if needed). */
-    char msgBuf[NK_LOG_MSGSIZE], tsBuf[NK_LOG_TSSIZE];
-    NkSize tsSize, msgSize;
     va_list vlArgs;
     va_start(vlArgs, fmtStr);
+#if (defined NK_TARGET_MULTITHREADED)
+    /*
+     * In asynchronous mode, hand the message to the writer thread. Register as a producer
+     * before checking the mode so that disabling asynchronous mode can wait for us.
+     */
+    InterlockedIncrement(&gl_LogQueue.m_nProducers);
+    if (gl_LogQueue.m_isAsync && !gl_IsLogWriter) {
+        __NkInt_LogEnqueue(msgCxtPtr, lvlId, fmtStr, vlArgs);
+        InterlockedDecrement(&gl_LogQueue.m_nProducers);
+        va_end(vlArgs);
+
+        /* Make sure critical messages are out before the caller possibly terminates. */
+        if (lvlId == NkLogLvl_Critical)
+            NkLogFlush();
+        return;
+    }
+    InterlockedDecrement(&gl_LogQueue.m_nProducers);
+#endif
+
+    /* Format message and timestamp, and write them synchronously. */
+    char msgBuf[NK_LOG_MSGSIZE], tsBuf[NK_LOG_TSSIZE];
+    NkSize tsSize, msgSize;
     __NkInt_LogFormatMessageAndTimestamp(fmtStr, vlArgs, msgBuf, tsBuf, &msgSize, &tsSize, &msgCxtPtr->m_timestamp);
     va_end(vlArgs);
 
-    NK_LOCK(gl_LogContext.m_mtxLock);
-    /*
-     * If the log level is globally disabled or there are currently no sinks registered,
-     * do nothing.
-     */
-    NkBoolean const isEnabled = NK_INRANGE_INCL(lvlId, gl_LogContext.m_glMinLevel, gl_LogContext.m_glMaxLevel);
-    if (!isEnabled || gl_LogContext.m_nOfDev == 0)
-        goto lbl_CLEANUP;
+    __NkInt_LogDispatch(lvlId, msgCxtPtr, (NkStringView){ tsBuf, tsSize }, (NkStringView){ msgBuf, msgSize });
+}
 
-    /*
-     * Propagate formatted message and additional context data to sinks. Stop when we
-     * reach the end of the sink array or we have processed all registered sinks,
-     * whatever comes first.
-     */
-    for (NkSize i = 0, j = 0; i < NK_ARRAYSIZE(gl_LogContext.m_devArray) && j < gl_LogContext.m_nOfDev; i++) {
-        /* Get pointer to device. If the slot is empty, ignore. */
-        NkILogDevice *currDev = gl_LogContext.m_devArray[i];
-        if (currDev == NULL)
-            continue;
+_Return_ok_ NkErrorCode NK_CALL NkLogSetAsyncMode(_In_ NkBoolean isAsync) {
+#if (defined NK_TARGET_MULTITHREADED)
+    if (gl_LogQueue.m_isAsync == isAsync)
+        return NkErr_NoOperation;
 
-        /* Call the device's 'NkILogDevice::OnMessage()' method. */
-        NK_UNLOCK(gl_LogContext.m_mtxLock);
-        currDev->VT->OnMessage(
-            currDev,
-            lvlId,
-            msgCxtPtr,
-            (NkStringView){ tsBuf,  msgSize },
-            (NkStringView){ msgBuf, msgSize }
-        );
-        NK_LOCK(gl_LogContext.m_mtxLock);
-        ++j;
+    if (isAsync) {
+        /* Start the writer thread. */
+        if (NK_INITLOCK(gl_LogQueue.m_sleepLock) != thrd_success)
+            return NkErr_SynchInit;
+        if (cnd_init(&gl_LogQueue.m_wakeCnd) != thrd_success) {
+            NK_DESTROYLOCK(gl_LogQueue.m_sleepLock);
+
+            return NkErr_SynchInit;
+        }
+        gl_LogQueue.m_isShutdown = NK_FALSE;
+        if (thrd_create(&gl_LogQueue.m_wrThread, &__NkInt_LogWriterProc, NULL) != thrd_success) {
+            cnd_destroy(&gl_LogQueue.m_wakeCnd);
+            NK_DESTROYLOCK(gl_LogQueue.m_sleepLock);
+
+            return NkErr_CreateThread;
+        }
+
+        NK_IGNORE_RETURN_VALUE(InterlockedExchange8((CHAR volatile *)&gl_LogQueue.m_isAsync, NK_TRUE));
+        return NkErr_Ok;
     }
 
-lbl_CLEANUP:
-    NK_UNLOCK(gl_LogContext.m_mtxLock);
+    /*
+     * Route new messages to the synchronous path, then wait for callers that are still
+     * writing into the queue.
+     */
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange8((CHAR volatile *)&gl_LogQueue.m_isAsync, NK_FALSE));
+    while (InterlockedCompareExchange(&gl_LogQueue.m_nProducers, 0, 0) != 0)
+        thrd_yield();
+
+    /* Let the writer write the remaining records and exit. */
+    NK_LOCK(gl_LogQueue.m_sleepLock);
+    gl_LogQueue.m_isShutdown = NK_TRUE;
+    cnd_signal(&gl_LogQueue.m_wakeCnd);
+    NK_UNLOCK(gl_LogQueue.m_sleepLock);
+    thrd_join(gl_LogQueue.m_wrThread, NULL);
+
+    cnd_destroy(&gl_LogQueue.m_wakeCnd);
+    NK_DESTROYLOCK(gl_LogQueue.m_sleepLock);
+    return NkErr_Ok;
+#else
+    NK_UNREFERENCED_PARAMETER(isAsync);
+
+    return NkErr_NotImplemented;
+#endif
 }
 
+NkVoid NK_CALL NkLogFlush(NkVoid) {
+#if (defined NK_TARGET_MULTITHREADED)
+    /* The writer cannot wait for itself. */
+    if (!gl_LogQueue.m_isAsync || gl_IsLogWriter)
+        return;
+
+    __NkInt_LogWaitWritten(InterlockedCompareExchange(&gl_LogQueue.m_writePos, 0, 0));
+#endif
+}
 
 /**
  */
@@ -27,6 +27,10 @@
  */
 #define NK_NAMESPACE "nk::om"
 
+
+/* stdlib includes */
+#include <string.h>
+
 /* Windows includes */
 #if (defined _WIN32)
     #pragma warning (disable: 4668) /* macro not defined; replacing with '0' */
@@ -69,6 +73,31 @@ NKOM_DEFINE_CLSID(NkIClassFactory, { 0x00000000, 0x0000, 0x0000, 0x0000000000000
 
 
 /** \cond INTERNAL */
+/**
+ * \struct __NkOM_ClassEntry
+ * \brief  represents a single entry of the class registry
+ */
+NK_NATIVE typedef struct __NkOM_ClassEntry {
+    NkUuid           m_clsId;   /**< class ID */
+    NkIClassFactory *mp_clsFac; /**< factory that instantiates the class */
+} __NkOM_ClassEntry;
+
+/**
+ * \struct __NkOM_ClassRegistry
+ * \brief  represents an immutable snapshot of the class registry
+ *
+ * Snapshots are never modified once they are published; installing or uninstalling a
+ * factory publishes a new one. Since lookups do not announce themselves, replaced
+ * snapshots are only freed when the runtime shuts down. Factories are only installed
+ * during startup, so only a handful of small snapshots accumulate.
+ */
+NK_NATIVE typedef struct __NkOM_ClassRegistry {
+    struct __NkOM_ClassRegistry *mp_prevReg;  /**< snapshot that was replaced by this one */
+    LONG                         m_regGen;    /**< number of the snapshot, starting at 1 */
+    NkSize                       m_nEntries;  /**< number of registered classes */
+    __NkOM_ClassEntry           *mp_entryArr; /**< registered classes, sorted by class ID */
+} __NkOM_ClassRegistry;
+
 /**
  * \struct __NkOM_StaticContext
  * \brief  represents the global (process-wide) NkOM context
@@ -77,8 +106,8 @@ NK_NATIVE typedef struct __NkOM_StaticContext {
     NkBoolean    m_isInitialized;  /**< whether or not NkOM is initialized */
     NkBoolean    m_isDebugEnabled; /**< whether or not integrated debugging facilities are enabled */
 
-    NK_DECL_LOCK(m_clsRegLock);    /**< synchronization object for class registry */
-    NkHashtable *mp_classReg;      /**< global class registry */
+    NK_DECL_LOCK(m_clsRegLock);                  /**< serializes changes to the class registry */
+    __NkOM_ClassRegistry *volatile mp_classReg; /**< currently published class registry */
 } __NkOM_StaticContext;
 
 /**
@@ -88,19 +117,167 @@ NK_INTERNAL __NkOM_StaticContext gl_NkOMContext;
 
 
 /**
+ * \brief  establishes a total order on class IDs
+ * \param  [in] lhsPtr, rhsPtr class IDs that are to be compared
+ * \return negative, zero, or positive if \c lhsPtr is ordered before, equal to, or after
+ *         <tt>rhsPtr</tt>
+ */
+NK_INTERNAL NK_INLINE int __NkOM_CompareClsId(_In_ NkUuid const *lhsPtr, _In_ NkUuid const *rhsPtr) {
+    if (lhsPtr->m_fBlock != rhsPtr->m_fBlock)
+        return lhsPtr->m_fBlock < rhsPtr->m_fBlock ? -1 : 1;
+    if (lhsPtr->m_sBlock != rhsPtr->m_sBlock)
+        return lhsPtr->m_sBlock < rhsPtr->m_sBlock ? -1 : 1;
+    if (lhsPtr->m_tBlock != rhsPtr->m_tBlock)
+        return lhsPtr->m_tBlock < rhsPtr->m_tBlock ? -1 : 1;
+    if (lhsPtr->m_ffBlock != rhsPtr->m_ffBlock)
+        return lhsPtr->m_ffBlock < rhsPtr->m_ffBlock ? -1 : 1;
+
+    return 0;
+}
+
+/**
+ * \brief  finds the position of a class ID in a registry snapshot
+ * \param  [in] regPtr registry snapshot
+ * \param  [in] clsId class ID that is to be found
+ * \param  [out] indPtr pointer to a variable that receives the index of the entry, or
+ *               the index the entry would have to be inserted at
+ * \return \c NK_TRUE if the class is registered, \c NK_FALSE if not
+ */
+NK_INTERNAL NkBoolean __NkOM_FindClass(
+    _In_  __NkOM_ClassRegistry const *regPtr,
+    _In_  NkUuid const *clsId,
+    _Out_ NkSize *indPtr
+) {
+    NkSize lowInd  = 0;
+    NkSize highInd = regPtr->m_nEntries;
+    while (lowInd < highInd) {
+        NkSize const midInd = lowInd + (highInd - lowInd) / 2;
+        int const    cmpRes = __NkOM_CompareClsId(&regPtr->mp_entryArr[midInd].m_clsId, clsId);
+
+        if (cmpRes == 0) {
+            *indPtr = midInd;
+
+            return NK_TRUE;
+        }
+        if (cmpRes < 0)
+            lowInd = midInd + 1;
+        else
+            highInd = midInd;
+    }
+
+    *indPtr = lowInd;
+    return NK_FALSE;
+}
+
+/**
+ * \brief  allocates a new, unpublished registry snapshot
+ * \param  [in] nEntries number of entries of the snapshot
+ * \param  [out] regPtr pointer to a variable that receives the snapshot
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The entries are stored in the same allocation, right after the snapshot.
  */
-NK_INTERNAL NkVoid NK_CALL __NkOM_DestroyClsFacFn(_Inout_opt_ NkHashtableKey *keyPtr, _Inout_opt_ NkVoid *valPtr) {
-    NK_UNREFERENCED_PARAMETER(keyPtr);
+NK_INTERNAL _Return_ok_ NkErrorCode __NkOM_CreateRegistry(_In_ NkSize nEntries, _Outptr_ __NkOM_ClassRegistry **regPtr) {
+    NkErrorCode const errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof **regPtr + nEntries * sizeof *(*regPtr)->mp_entryArr,
+        0,
+        NK_TRUE,
+        (NkVoid **)regPtr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    (*regPtr)->m_nEntries   = nEntries;
+    (*regPtr)->mp_entryArr  = (__NkOM_ClassEntry *)(*regPtr + 1);
+    return NkErr_Ok;
+}
+
+/**
+ * \brief publishes a new registry snapshot
+ * \param [in, out] regPtr snapshot that is to be published
+ * \note  The class registry lock must be held.
+ */
+NK_INTERNAL NkVoid __NkOM_PublishRegistry(_Inout_ __NkOM_ClassRegistry *regPtr) {
+    __NkOM_ClassRegistry *currReg = gl_NkOMContext.mp_classReg;
+
+    regPtr->mp_prevReg = currReg;
+    regPtr->m_regGen   = currReg != NULL ? currReg->m_regGen + 1 : 1;
+    NK_IGNORE_RETURN_VALUE(InterlockedExchangePointer((PVOID volatile *)&gl_NkOMContext.mp_classReg, regPtr));
+}
+
+/**
+ * \brief  creates an instance of a class using the given factory
+ * \param  [in, out] clsFac factory that instantiates the class
+ * \param  [in] clsId class that is to be instantiated
+ * \param  [in, out] ctrlInst (optional) controlling instance
+ * \param  [in] iId interface that is to be queried from the new instance
+ * \param  [in, out] initParam (optional) parameter passed to
+ *                   <tt>NkIInitializable::Initialize()</tt>
+ * \param  [out] resPtr pointer to a variable that receives the new instance
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkOM_InstantiateClass(
+    _Inout_     NkIClassFactory *clsFac,
+    _In_        NkUuid const *clsId,
+    _Inout_opt_ NkIBase *ctrlInst,
+    _In_        NkUuid const *iId,
+    _Inout_opt_ NkVoid *initParam,
+    _Outptr_    NkIBase **resPtr
+) {
+    /*
+     * Instantiate the class. After this call, the newly-created object's ref-count must
+     * exactly one higher than the ref-count that would trigger a destroy (usually that
+     * would be 0).
+     */
+    NkIBase *tmpResPtr;
+    NkErrorCode errCode = clsFac->VT->CreateInstance(clsFac, clsId, ctrlInst, &tmpResPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /*
+     * Check if the created class implements the NkIInitializable interface, and if yes,
+     * run its initialize method. If this fails, it is not an error.
+     */
+    NkIInitializable *initRef;
+    if (tmpResPtr->VT->QueryInterface(tmpResPtr, NKOM_IIDOF(NkIInitializable), (NkVoid **)&initRef) == NkErr_Ok) {
+        /*
+         * If initialization fails, decrement the object's ref-count. It must now be one.
+         * In the next step, it will be decremented again, causing it to hit zero,
+         * thereby destroying the instance. If it does not fail, it will simply decrement
+         * the ref-count in the next step, only releasing the NkIInitializable instance.
+         */
+        if ((errCode = initRef->VT->Initialize(initRef, initParam)) != NkErr_Ok) {
+            initRef->VT->Release(initRef);
+
+            *resPtr = NULL;
+        }
+
+        /* QueryInterface() did increment ref-count. */
+        tmpResPtr->VT->Release(tmpResPtr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+
+    /* Finally, query the interface that we will use to communicate with the object. */
+    if (!errCode && (errCode = tmpResPtr->VT->QueryInterface(tmpResPtr, iId, (NkVoid **)resPtr)) != NkErr_Ok) {
+        /*
+         * Interface is not implemented or something else went wrong. Ref-count not
+         * increased; release once to destroy the object altogether.
+         */
+        tmpResPtr->VT->Release(tmpResPtr);
+    
+        *resPtr = NULL;
+        return errCode;
+    }
 
     /*
-     * No need to do anything to the key or the value itself; just decrement the
-     * ref-count of the associated factory. This is to balance the calls to the
-     * 'AddRef()' function when we installed the class factory.
-     * Keys do not have to be destroyed since they are required to be pointers to static
-     * memory as per NkOM conventions.
+     * Reference count should now be 2 after having queried the desired interface.
+     * Decrement by one to return an object that has a reference count of 1 and as such
+     * can be destroyed by a single call to 'Release()'.
      */
-    if (valPtr != NULL)
-        ((NkIClassFactory *)valPtr)->VT->Release((NkIClassFactory *)valPtr);
+#pragma warning (suppress: 6001) /* False alarm due to SAL not working properly with function pointers. */
+    (*resPtr)->VT->Release(*resPtr);
+    return errCode;
 }
 
 /**
@@ -129,23 +306,16 @@ _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(NkOM)(NkVoid) {
         /* Initialize synchronization primitive for the class registry. */
         NK_INITLOCK(gl_NkOMContext.m_clsRegLock);
 
-        /* Initialize the class registry. */
-        NkErrorCode errCode = NkHashtableCreate(
-            &(NkHashtableProperties const){
-            .m_structSize  = sizeof(NkHashtableProperties),
-                .m_initCap     = 16,
-                .m_keyType     = NkHtKeyTy_Uuid,
-                .m_minCap      = 16,
-                .m_maxCap      = UINT32_MAX,
-                .mp_fnElemFree = (NkHashtableFreeFn)&__NkOM_DestroyClsFacFn
-            },
-            &gl_NkOMContext.mp_classReg
-        );
+        /* Publish an empty class registry. */
+        __NkOM_ClassRegistry *emptyReg;
+        NkErrorCode errCode = __NkOM_CreateRegistry(0, &emptyReg);
         if (errCode != NkErr_Ok) {
-            InterlockedAnd8((CHAR volatile *)&gl_NkOMContext.m_isInitialized, NK_FALSE);
+            NK_DESTROYLOCK(gl_NkOMContext.m_clsRegLock);
+            NK_IGNORE_RETURN_VALUE(InterlockedExchange8((CHAR volatile *)&gl_NkOMContext.m_isInitialized, NK_FALSE));
 
             return errCode;
         }
+        __NkOM_PublishRegistry(emptyReg);
 
         return NkErr_Ok;
     }
@@ -160,8 +330,21 @@ _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(NkOM)(NkVoid) {
         /* Destroy synchonization primitive for the class registry. */
         NK_DESTROYLOCK(gl_NkOMContext.m_clsRegLock);
 
-        /* Destroy the class registry. */
-        NkHashtableDestroy(&gl_NkOMContext.mp_classReg);
+        /*
+         * Release the factories that are still installed, then free the current and all
+         * replaced snapshots of the class registry.
+         */
+        __NkOM_ClassRegistry *currReg = gl_NkOMContext.mp_classReg;
+        for (NkSize i = 0; currReg != NULL && i < currReg->m_nEntries; i++)
+            currReg->mp_entryArr[i].mp_clsFac->VT->Release(currReg->mp_entryArr[i].mp_clsFac);
+        while (currReg != NULL) {
+            __NkOM_ClassRegistry *prevReg = currReg->mp_prevReg;
+
+            NkGPFree(currReg);
+            currReg = prevReg;
+        }
+        gl_NkOMContext.mp_classReg = NULL;
+
         return NkErr_Ok;
     }
 
@@ -191,65 +374,34 @@ _Return_ok_ NkErrorCode NK_CALL NkOMCreateInstance(
     NkErrorCode errCode = NkOMQueryFactoryForClass(clsId, &reqClsFac);
     if (errCode != NkErr_Ok)
         return errCode;
-    /*
-     * Instantiate the class. After this call, the newly-created object's ref-count must
-     * exactly one higher than the ref-count that would trigger a destroy (usually that
-     * would be 0).
-     */
-    NkIBase *tmpResPtr;
-    errCode = reqClsFac->VT->CreateInstance(reqClsFac, clsId, ctrlInst, &tmpResPtr);
+
+    errCode = __NkOM_InstantiateClass(reqClsFac, clsId, ctrlInst, iId, initParam, resPtr);
     /*
      * Since NkOMQueryFactoryForClass() increments the factory's ref-count, we must
      * decrement it after we are done with the factory.
      */
     reqClsFac->VT->Release(reqClsFac);
-    if (errCode != NkErr_Ok)
-        return errCode;
-
-    /*
-     * Check if the created class implements the NkIInitializable interface, and if yes,
-     * run its initialize method. If this fails, it is not an error.
-     */
-    NkIInitializable *initRef;
-    if (tmpResPtr->VT->QueryInterface(tmpResPtr, NKOM_IIDOF(NkIInitializable), (NkVoid **)&initRef) == NkErr_Ok) {
-        /*
-         * If initialization fails, decrement the object's ref-count. It must now be one.
-         * In the next step, it will be decremented again, causing it to hit zero,
-         * thereby destroying the instance. If it does not fail, it will simply decrement
-         * the ref-count in the next step, only releasing the NkIInitializable instance.
-         */
-        if ((errCode = initRef->VT->Initialize(initRef, initParam)) != NkErr_Ok) {
-            initRef->VT->Release(initRef);
-
-            *resPtr = NULL;
-        }
+    return errCode;
+}
 
-        /* QueryInterface() did increment ref-count. */
-        tmpResPtr->VT->Release(tmpResPtr);
-        if (errCode != NkErr_Ok)
-            return errCode;
-    }
+_Return_ok_ NkErrorCode NK_CALL NkOMCreateInstanceCached(
+    _Inout_     NkOMFactoryCache *cachePtr,
+    _Inout_opt_ NkIBase *ctrlInst,
+    _In_        NkUuid const *iId,
+    _Inout_opt_ NkVoid *initParam,
+    _Outptr_    NkIBase **resPtr
+) {
+    NK_ASSERT(cachePtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(iId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+    *resPtr = NULL;
 
-    /* Finally, query the interface that we will use to communicate with the object. */
-    if (!errCode && (errCode = tmpResPtr->VT->QueryInterface(tmpResPtr, iId, (NkVoid **)resPtr)) != NkErr_Ok) {
-        /*
-         * Interface is not implemented or something else went wrong. Ref-count not
-         * increased; release once to destroy the object altogether.
-         */
-        tmpResPtr->VT->Release(tmpResPtr);
-    
-        *resPtr = NULL;
-        return errCode;
-    }
+    NkIClassFactory *reqClsFac = NkOMResolveFactory(cachePtr);
+    if (reqClsFac == NULL)
+        return NkErr_ClassNotReg;
 
-    /*
-     * Reference count should now be 2 after having queried the desired interface.
-     * Decrement by one to return an object that has a reference count of 1 and as such
-     * can be destroyed by a single call to 'Release()'.
-     */
-#pragma warning (suppress: 6001) /* False alarm due to SAL not working properly with function pointers. */
-    (*resPtr)->VT->Release(*resPtr);
-    return errCode;
+    /* The registry holds a reference to the factory for as long as it is installed. */
+    return __NkOM_InstantiateClass(reqClsFac, cachePtr->mp_clsId, ctrlInst, iId, initParam, resPtr);
 }
 
 _Return_ok_ NkErrorCode NK_CALL NkOMQueryFactoryForClass(
@@ -263,24 +415,50 @@ _Return_ok_ NkErrorCode NK_CALL NkOMQueryFactoryForClass(
     NK_ASSERT(clsidPtr != NULL, NkErr_InParameter);
     NK_ASSERT(clsFacPtr != NULL, NkErr_OutptrParameter);
 
-    NK_LOCK(gl_NkOMContext.m_clsRegLock);
-    NkErrorCode const errCode = NkHashtableAt(
-        gl_NkOMContext.mp_classReg,
-        &(NkHashtableKey){ .mp_ptrKey = (NkVoid *)clsidPtr },
-        clsFacPtr
-    );
-    if (errCode == NkErr_Ok) {
-        NK_UNLOCK(gl_NkOMContext.m_clsRegLock);
-
+    /*
+     * The published registry is never modified, so lookups neither take the registry
+     * lock nor write any shared memory.
+     */
+    __NkOM_ClassRegistry const *currReg = gl_NkOMContext.mp_classReg;
+    NkSize entInd;
+    if (__NkOM_FindClass(currReg, clsidPtr, &entInd)) {
         /* Add a reference to the class factory. */
+        *clsFacPtr = currReg->mp_entryArr[entInd].mp_clsFac;
+
         (*clsFacPtr)->VT->AddRef(*clsFacPtr);
         return NkErr_Ok;
     }
     
-    NK_UNLOCK(gl_NkOMContext.m_clsRegLock);
+    *clsFacPtr = NULL;
     return NkErr_ClassNotReg;
 }
 
+NkIClassFactory *NK_CALL NkOMResolveFactory(_Inout_ NkOMFactoryCache *cachePtr) {
+    NK_ASSERT(
+        InterlockedOr8((CHAR volatile *)&gl_NkOMContext.m_isInitialized, NK_FALSE) == NK_TRUE,
+        NkErr_ComponentState
+    );
+    NK_ASSERT(cachePtr != NULL && cachePtr->mp_clsId != NULL, NkErr_InOutParameter);
+
+    /*
+     * The cached factory is valid as long as the registry has not been replaced since it
+     * was resolved. Threads racing to resolve the same generation store the same factory.
+     */
+    __NkOM_ClassRegistry const *currReg = gl_NkOMContext.mp_classReg;
+    if (cachePtr->m_regGen == currReg->m_regGen)
+        return cachePtr->mp_clsFac;
+
+    NkSize entInd;
+    NkIClassFactory *clsFac = __NkOM_FindClass(currReg, cachePtr->mp_clsId, &entInd)
+        ? currReg->mp_entryArr[entInd].mp_clsFac
+        : NULL
+    ;
+    cachePtr->mp_clsFac = clsFac;
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange((LONG volatile *)&cachePtr->m_regGen, currReg->m_regGen));
+
+    return clsFac;
+}
+
 _Return_ok_ NkErrorCode NK_CALL NkOMInstallClassFactory(_Inout_ NkIClassFactory *clsFac) {
     NK_ASSERT(
         InterlockedOr8((CHAR volatile *)&gl_NkOMContext.m_isInitialized, NK_FALSE) == NK_TRUE,
@@ -288,35 +466,51 @@ _Return_ok_ NkErrorCode NK_CALL NkOMInstallClassFactory(_Inout_ NkIClassFactory
     );
     NK_ASSERT(clsFac != NULL, NkErr_InOutParameter);
 
-    NkErrorCode errCode;
+    NkUuid const **clsidArr = clsFac->VT->QueryInstantiableClasses(clsFac);
+    NkSize         nClasses = 0;
+    while (clsidArr[nClasses] != NULL)
+        ++nClasses;
+
+    NK_LOCK(gl_NkOMContext.m_clsRegLock);
     /*
-     * Go through all of the instantiable classes and add a class entry of the given
-     * class ID associated with the current factory.
+     * Build a new snapshot that contains all classes of the current one plus the ones
+     * of the given factory, keeping the entries sorted.
      */
-    NkUuid const **clsidArr = clsFac->VT->QueryInstantiableClasses(clsFac);
-    for (NkSize i = 0; clsidArr[i] != NULL; i++) {
-        /** \todo check if class already exists */
-        NK_SYNCHRONIZED(gl_NkOMContext.m_clsRegLock,
-            errCode = NkHashtableInsert(
-                gl_NkOMContext.mp_classReg,
-                &(NkHashtablePair){
-                    .m_keyVal    = { .mp_ptrKey = (NkVoid *)clsidArr[i] },
-                    .mp_valuePtr = clsFac
-                }
-            );
-        );
+    __NkOM_ClassRegistry const *currReg = gl_NkOMContext.mp_classReg;
+    __NkOM_ClassRegistry       *newReg;
+    NkErrorCode errCode = __NkOM_CreateRegistry(currReg->m_nEntries + nClasses, &newReg);
+    if (errCode != NkErr_Ok) {
+        NK_UNLOCK(gl_NkOMContext.m_clsRegLock);
 
-        if (errCode != NkErr_Ok) {
-            /* If we couldn't add all entries, roll-back the current action. */
-            if (i > 0)
-                NK_IGNORE_RETURN_VALUE(NkOMUninstallClassFactory(clsFac));
+        return errCode;
+    }
+    memcpy(newReg->mp_entryArr, currReg->mp_entryArr, currReg->m_nEntries * sizeof *newReg->mp_entryArr);
+    newReg->m_nEntries = currReg->m_nEntries;
 
-            return errCode;
+    for (NkSize i = 0; i < nClasses; i++) {
+        NkSize insInd;
+        if (__NkOM_FindClass(newReg, clsidArr[i], &insInd)) {
+            NK_UNLOCK(gl_NkOMContext.m_clsRegLock);
+
+            NkGPFree(newReg);
+            return NkErr_ClassAlreadyReg;
         }
 
-        clsFac->VT->AddRef(clsFac);
+        memmove(
+            &newReg->mp_entryArr[insInd + 1],
+            &newReg->mp_entryArr[insInd],
+            (newReg->m_nEntries - insInd) * sizeof *newReg->mp_entryArr
+        );
+        newReg->mp_entryArr[insInd] = (__NkOM_ClassEntry){ *clsidArr[i], clsFac };
+        ++newReg->m_nEntries;
     }
 
+    /* Every entry holds a reference to the factory. */
+    for (NkSize i = 0; i < nClasses; i++)
+        clsFac->VT->AddRef(clsFac);
+    __NkOM_PublishRegistry(newReg);
+    NK_UNLOCK(gl_NkOMContext.m_clsRegLock);
+
     /* All good. */
     return NkErr_Ok;
 }
@@ -328,20 +522,36 @@ _Return_ok_ NkErrorCode NK_CALL NkOMUninstallClassFactory(_Inout_ NkIClassFactor
     );
     NK_ASSERT(clsFac != NULL, NkErr_InOutParameter);
 
+    NK_LOCK(gl_NkOMContext.m_clsRegLock);
     /*
-     * Find all classes that are associated with the current class factory and erase the
-     * entries, decrementing the reference count of the factory for each one.
+     * Build a new snapshot without the classes that are associated with the given
+     * factory, decrementing the reference count of the factory for each one.
      */
-    NkUuid const **clsidArr = clsFac->VT->QueryInstantiableClasses(clsFac);
-    for (NkSize i = 0; clsidArr[i] != NULL; i++) {
-        NK_SYNCHRONIZED(gl_NkOMContext.m_clsRegLock,
-            NK_IGNORE_RETURN_VALUE(NkHashtableErase(gl_NkOMContext.mp_classReg, &(NkHashtableKey){
-                .mp_uuidKey = (NkVoid *)clsidArr[i]
-            }));
-        );
+    __NkOM_ClassRegistry const *currReg = gl_NkOMContext.mp_classReg;
+    __NkOM_ClassRegistry       *newReg;
+    NkErrorCode errCode = __NkOM_CreateRegistry(currReg->m_nEntries, &newReg);
+    if (errCode != NkErr_Ok) {
+        NK_UNLOCK(gl_NkOMContext.m_clsRegLock);
 
-        clsFac->VT->Release(clsFac);
+        return errCode;
+    }
+
+    NkSize nRemoved = 0;
+    newReg->m_nEntries = 0;
+    for (NkSize i = 0; i < currReg->m_nEntries; i++) {
+        if (currReg->mp_entryArr[i].mp_clsFac == clsFac) {
+            ++nRemoved;
+
+            continue;
+        }
+
+        newReg->mp_entryArr[newReg->m_nEntries++] = currReg->mp_entryArr[i];
     }
+    __NkOM_PublishRegistry(newReg);
+    NK_UNLOCK(gl_NkOMContext.m_clsRegLock);
+
+    for (NkSize i = 0; i < nRemoved; i++)
+        clsFac->VT->Release(clsFac);
 
     /* All good. */
     clsFac->VT->Release(clsFac);
@@ -349,6 +559,36 @@ _Return_ok_ NkErrorCode NK_CALL NkOMUninstallClassFactory(_Inout_ NkIClassFactor
 }
 
 
+NkOMRefCount NK_CALL NkOMRefCountIncrement(
+    _Inout_opt_ NkOMRefCount volatile *rcPtr,
+    _In_        NkOMRefCountMode rcMode
+) {
+    static_assert(sizeof(NkOMRefCount) == sizeof(LONG), "NkOMRefCount must match the size of LONG.");
+    NK_ASSERT(rcPtr != NULL || rcMode == NkOMRcMd_Static, NkErr_InOutParameter);
+
+    switch (rcMode) {
+        case NkOMRcMd_Shared:      return (NkOMRefCount)InterlockedIncrement((LONG volatile *)rcPtr);
+        case NkOMRcMd_ThreadLocal: return ++*rcPtr;
+    }
+
+    return 1;
+}
+
+NkOMRefCount NK_CALL NkOMRefCountDecrement(
+    _Inout_opt_ NkOMRefCount volatile *rcPtr,
+    _In_        NkOMRefCountMode rcMode
+) {
+    NK_ASSERT(rcPtr != NULL || rcMode == NkOMRcMd_Static, NkErr_InOutParameter);
+
+    switch (rcMode) {
+        case NkOMRcMd_Shared:      return (NkOMRefCount)InterlockedDecrement((LONG volatile *)rcPtr);
+        case NkOMRcMd_ThreadLocal: return --*rcPtr;
+    }
+
+    return 1;
+}
+
+
 NkBoolean NK_CALL NkOMIsPureVirtual(_In_ NkUuid const *iId) {
     NK_ASSERT(iId != NULL, NkErr_InParameter);
 
@@ -0,0 +1,593 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  pack.c
+ * \brief implements reading and writing of packed asset archives
+ */
+#define NK_NAMESPACE "nk::pack"
+
+
+/* stdlib includes */
+#include <stdio.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/pack.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/sort.h>
+#include <include/Noriko/log.h>
+
+
+/** \cond INTERNAL */
+/* The on-disk structures must not contain any padding. */
+static_assert(sizeof(NkPackHeader) == 32, "NkPackHeader must be 32 bytes large!");
+static_assert(sizeof(NkPackEntry) == 48, "NkPackEntry must be 48 bytes large!");
+
+/**
+ * \def   __NkInt_Pack_MinMatch
+ * \brief minimum length of a match in compressed blobs
+ */
+#define __NkInt_Pack_MinMatch  ((NkSize)(4))
+/**
+ * \def   __NkInt_Pack_MaxOffset
+ * \brief maximum distance of a match in compressed blobs
+ */
+#define __NkInt_Pack_MaxOffset ((NkSize)(UINT16_MAX))
+/**
+ * \def   __NkInt_Pack_HashBits
+ * \brief number of bits of the match finder's hash table index
+ */
+#define __NkInt_Pack_HashBits  ((NkUint32)(12))
+
+
+/**
+ * \struct NkPackArchive
+ * \brief  internal definition of an opened pack archive
+ */
+struct NkPackArchive {
+    NkBufferView       m_fileView;  /**< mapped archive */
+    NkVoid            *mp_mapHnd;   /**< platform-dependent mapping handle */
+    NkPackEntry const *mp_tocArr;   /**< table of contents, inside the mapped archive */
+    NkSize             m_nEntries;  /**< number of entries in the table of contents */
+};
+
+/**
+ * \struct __NkInt_PackBlob
+ * \brief  represents a blob added to an archive writer
+ */
+NK_NATIVE typedef struct __NkInt_PackBlob {
+    NkPackEntry  m_tocEntry; /**< entry of the blob; the offset is computed when saving */
+    NkByte      *mp_dataPtr; /**< stored (possibly compressed) bytes of the blob */
+} __NkInt_PackBlob;
+
+/**
+ * \struct NkPackWriter
+ * \brief  internal definition of an archive writer
+ */
+struct NkPackWriter {
+    __NkInt_PackBlob *mp_blobArr;  /**< blobs that were added */
+    NkSize            m_nBlobs;    /**< number of blobs */
+    NkSize            m_blobCap;   /**< capacity of <tt>mp_blobArr</tt> */
+};
+
+
+/**
+ * \brief  maps a file into memory for reading
+ * \param  [in] pathStr path of the file
+ * \param  [out] viewPtr pointer to a variable that receives the view of the entire file
+ * \param  [out] mapHandle pointer to a variable that receives the platform-dependent
+ *               mapping handle
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_EXTERN NK_VIRTUAL _Return_ok_ NkErrorCode NK_CALL __NkVirt_Filesys_MapFile(
+    _In_z_ _Utf8_ char const *pathStr,
+    _Out_         NkBufferView *viewPtr,
+    _Outptr_      NkVoid **mapHandle
+);
+/**
+ * \brief unmaps a file previously mapped by <tt>__NkVirt_Filesys_MapFile()</tt>
+ * \param [in, out] mapHandle mapping handle
+ */
+NK_EXTERN NK_VIRTUAL NkVoid NK_CALL __NkVirt_Filesys_UnmapFile(_Inout_ NkVoid *mapHandle);
+
+
+/**
+ * \brief  orders two UUIDs bytewise
+ * \param  [in] u1Ptr pointer to the first UUID
+ * \param  [in] u2Ptr pointer to the second UUID
+ * \return negative, zero or positive if the first UUID is less than, equal to, or greater
+ *         than the second one
+ */
+NK_INTERNAL NK_INLINE int __NkInt_Pack_CompareUuids(_In_ NkUuid const *u1Ptr, _In_ NkUuid const *u2Ptr) {
+    return memcmp(u1Ptr, u2Ptr, sizeof(NkUuid));
+}
+
+/**
+ * \brief sorting predicate ordering blobs by UUID
+ */
+NK_INTERNAL NkInt32 NK_CALL __NkInt_PackWriter_CompareBlobs(_In_ NkVoid const *b1Ptr, _In_ NkVoid const *b2Ptr) {
+    return (NkInt32)__NkInt_Pack_CompareUuids(
+        &((__NkInt_PackBlob const *)b1Ptr)->m_tocEntry.m_assetUuid,
+        &((__NkInt_PackBlob const *)b2Ptr)->m_tocEntry.m_assetUuid
+    );
+}
+
+/**
+ * \brief  writes a length extension of a compressed sequence
+ * \param  [in, out] dstPtr pointer to the current output position
+ * \param  [in] dstEnd end of the output buffer
+ * \param  [in] extLen remaining length that did not fit into the token
+ * \return \c NK_TRUE on success, \c NK_FALSE if the output buffer is too small
+ */
+NK_INTERNAL NkBoolean __NkInt_Pack_EmitLength(_Inout_ NkByte **dstPtr, _In_ NkByte const *dstEnd, _In_ NkSize extLen) {
+    for (;; extLen -= 255) {
+        if (*dstPtr >= dstEnd)
+            return NK_FALSE;
+
+        *(*dstPtr)++ = (NkByte)NK_MIN(extLen, (NkSize)255);
+        if (extLen < 255)
+            return NK_TRUE;
+    }
+}
+
+/**
+ * \brief  writes a single sequence of a compressed blob
+ * \param  [in, out] dstPtr pointer to the current output position
+ * \param  [in] dstEnd end of the output buffer
+ * \param  [in] litPtr pointer to the literals of the sequence
+ * \param  [in] nLits number of literals
+ * \param  [in] matchOff distance of the match; ignored if \c matchLen is \c 0
+ * \param  [in] matchLen length of the match, or \c 0 for the last sequence
+ * \return \c NK_TRUE on success, \c NK_FALSE if the output buffer is too small
+ *
+ * \par Remarks
+ *   A sequence starts with a token byte. Its high nibble holds the number of literals,
+ *   its low nibble the length of the match minus <tt>__NkInt_Pack_MinMatch</tt>; a
+ *   nibble of 15 is followed by bytes that are added to it until a byte is not 255. Next
+ *   come the literals and the 16-bit little-endian distance of the match. The last
+ *   sequence of a blob only consists of the token and the literals.
+ */
+NK_INTERNAL NkBoolean __NkInt_Pack_EmitSequence(
+    _Inout_             NkByte **dstPtr,
+    _In_                NkByte const *dstEnd,
+    _I_bytes_(nLits)    NkByte const *litPtr,
+    _In_                NkSize nLits,
+    _In_                NkSize matchOff,
+    _In_                NkSize matchLen
+) {
+    if (*dstPtr >= dstEnd)
+        return NK_FALSE;
+
+    NkSize const matchExt = matchLen > 0 ? matchLen - __NkInt_Pack_MinMatch : 0;
+    NkByte *tokPtr = (*dstPtr)++;
+    *tokPtr = (NkByte)((NK_MIN(nLits, (NkSize)15) << 4) | NK_MIN(matchExt, (NkSize)15));
+    if (nLits >= 15 && !__NkInt_Pack_EmitLength(dstPtr, dstEnd, nLits - 15))
+        return NK_FALSE;
+
+    if ((NkSize)(dstEnd - *dstPtr) < nLits)
+        return NK_FALSE;
+    memcpy(*dstPtr, litPtr, nLits);
+    *dstPtr += nLits;
+    if (matchLen == 0)
+        return NK_TRUE;
+
+    if (dstEnd - *dstPtr < 2)
+        return NK_FALSE;
+    *(*dstPtr)++ = (NkByte)(matchOff & 0xFF);
+    *(*dstPtr)++ = (NkByte)(matchOff >> 8);
+    return matchExt < 15 || __NkInt_Pack_EmitLength(dstPtr, dstEnd, matchExt - 15);
+}
+
+/**
+ * \brief  compresses a blob
+ * \param  [in] srcBuf data that is to be compressed
+ * \param  [out] dstPtr buffer that receives the compressed data
+ * \param  [in] dstCap size of \c dstPtr, in bytes
+ * \param  [out] dstSize pointer to a variable that receives the size of the compressed
+ *               data, in bytes
+ * \return \c NK_TRUE on success, \c NK_FALSE if the compressed data does not fit into
+ *         \c dstCap bytes
+ * \note   The match finder is a greedy single-probe hash table, trading ratio for speed.
+ */
+NK_INTERNAL NkBoolean __NkInt_Pack_Compress(
+    _In_                NkBufferView srcBuf,
+    _O_bytes_(dstCap)   NkByte *dstPtr,
+    _In_                NkSize dstCap,
+    _Out_               NkSize *dstSize
+) {
+    /* Positions are stored plus one so that zero marks an empty slot. */
+    NkUint32 hashTable[1 << __NkInt_Pack_HashBits] = { 0 };
+
+    NkByte const *srcPtr = srcBuf.mp_dataPtr;
+    NkSize const  srcLen = srcBuf.m_sizeInBytes;
+    NkByte       *outPtr = dstPtr;
+    NkByte const *outEnd = dstPtr + dstCap;
+    NkSize        litInd = 0;
+    for (NkSize currInd = 0; srcLen >= __NkInt_Pack_MinMatch && currInd <= srcLen - __NkInt_Pack_MinMatch && currInd < UINT32_MAX;) {
+        NkUint32 quadVal;
+        memcpy(&quadVal, &srcPtr[currInd], sizeof quadVal);
+
+        NkUint32 const hashInd  = (quadVal * 2654435761U) >> (32 - __NkInt_Pack_HashBits);
+        NkSize   const candInd  = (NkSize)hashTable[hashInd] - 1;
+        hashTable[hashInd]      = (NkUint32)currInd + 1;
+        if (   candInd >= currInd
+            || currInd - candInd > __NkInt_Pack_MaxOffset
+            || memcmp(&srcPtr[candInd], &srcPtr[currInd], __NkInt_Pack_MinMatch) != 0
+        ) {
+            ++currInd;
+
+            continue;
+        }
+
+        NkSize matchLen = __NkInt_Pack_MinMatch;
+        while (currInd + matchLen < srcLen && srcPtr[candInd + matchLen] == srcPtr[currInd + matchLen])
+            ++matchLen;
+        if (!__NkInt_Pack_EmitSequence(&outPtr, outEnd, &srcPtr[litInd], currInd - litInd, currInd - candInd, matchLen))
+            return NK_FALSE;
+
+        currInd += matchLen;
+        litInd   = currInd;
+    }
+    if (!__NkInt_Pack_EmitSequence(&outPtr, outEnd, &srcPtr[litInd], srcLen - litInd, 0, 0))
+        return NK_FALSE;
+
+    *dstSize = (NkSize)(outPtr - dstPtr);
+    return NK_TRUE;
+}
+
+/**
+ * \brief  reads a length extension of a compressed sequence
+ * \param  [in, out] srcPtr pointer to the current input position
+ * \param  [in] srcEnd end of the input
+ * \param  [in, out] lenPtr length that the extension is added to
+ * \return \c NK_TRUE on success, \c NK_FALSE if the input ends prematurely
+ */
+NK_INTERNAL NkBoolean __NkInt_Pack_ReadLength(_Inout_ NkByte const **srcPtr, _In_ NkByte const *srcEnd, _Inout_ NkSize *lenPtr) {
+    NkByte currByte;
+    do {
+        if (*srcPtr >= srcEnd)
+            return NK_FALSE;
+
+        currByte  = *(*srcPtr)++;
+        *lenPtr  += currByte;
+    } while (currByte == 255);
+
+    return NK_TRUE;
+}
+
+/**
+ * \brief  decompresses a blob
+ * \param  [in] srcBuf compressed data
+ * \param  [out] dstPtr buffer that receives the decompressed data
+ * \param  [in] dstLen expected size of the decompressed data, in bytes
+ * \return \c NkErr_Ok on success, \c NkErr_CorruptedData if the compressed data is
+ *         malformed or does not decompress to exactly \c dstLen bytes
+ * \note   Every length and distance is checked, so malformed data can never cause reads
+ *         or writes out of bounds.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Pack_Decompress(
+    _In_              NkBufferView srcBuf,
+    _O_bytes_(dstLen) NkByte *dstPtr,
+    _In_              NkSize dstLen
+) {
+    NkByte const *srcPtr = srcBuf.mp_dataPtr;
+    NkByte const *srcEnd = srcPtr + srcBuf.m_sizeInBytes;
+    NkByte       *outPtr = dstPtr;
+    NkByte const *outEnd = dstPtr + dstLen;
+    while (srcPtr < srcEnd) {
+        NkByte const tokVal = *srcPtr++;
+
+        /* Copy the literals. */
+        NkSize nLits = tokVal >> 4;
+        if (nLits == 15 && !__NkInt_Pack_ReadLength(&srcPtr, srcEnd, &nLits))
+            return NkErr_CorruptedData;
+        if (nLits > (NkSize)(srcEnd - srcPtr) || nLits > (NkSize)(outEnd - outPtr))
+            return NkErr_CorruptedData;
+        memcpy(outPtr, srcPtr, nLits);
+        outPtr += nLits;
+        srcPtr += nLits;
+        if (srcPtr == srcEnd)
+            break;
+
+        /* Copy the match; it may overlap the bytes it produces. */
+        if (srcEnd - srcPtr < 2)
+            return NkErr_CorruptedData;
+        NkSize const matchOff = (NkSize)srcPtr[0] | (NkSize)srcPtr[1] << 8;
+        srcPtr += 2;
+
+        NkSize matchLen = tokVal & 0x0F;
+        if (matchLen == 15 && !__NkInt_Pack_ReadLength(&srcPtr, srcEnd, &matchLen))
+            return NkErr_CorruptedData;
+        matchLen += __NkInt_Pack_MinMatch;
+        if (matchOff == 0 || matchOff > (NkSize)(outPtr - dstPtr) || matchLen > (NkSize)(outEnd - outPtr))
+            return NkErr_CorruptedData;
+
+        NkByte const *matchPtr = outPtr - matchOff;
+        for (NkSize i = 0; i < matchLen; i++)
+            *outPtr++ = *matchPtr++;
+    }
+
+    return outPtr == outEnd ? NkErr_Ok : NkErr_CorruptedData;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkPackArchiveOpen(_In_z_ char const *filePath, _Init_ptr_ NkPackArchive **archPtr) {
+    NK_ASSERT(filePath != NULL && *filePath ^ '\0', NkErr_InParameter);
+    NK_ASSERT(archPtr != NULL, NkErr_OutptrParameter);
+
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **archPtr, 0, NK_TRUE, (NkVoid **)archPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkPackArchive *actArch = *archPtr;
+
+    errCode = __NkVirt_Filesys_MapFile(filePath, &actArch->m_fileView, &actArch->mp_mapHnd);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+
+    /* Validate the header. */
+    NkPackHeader headVal;
+    if (actArch->m_fileView.m_sizeInBytes < sizeof headVal) {
+        errCode = NkErr_UnsupportedFileFormat;
+
+        goto lbl_ONERROR;
+    }
+    memcpy(&headVal, actArch->m_fileView.mp_dataPtr, sizeof headVal);
+    if (headVal.m_magicNum != NK_PACK_MAGIC || headVal.m_formatVer != NK_PACK_VERSION) {
+        errCode = NkErr_UnsupportedFileFormat;
+
+        goto lbl_ONERROR;
+    }
+    NkUint64 const fileSize = (NkUint64)actArch->m_fileView.m_sizeInBytes;
+    if (   headVal.m_fileSize != fileSize
+        || headVal.m_tocOffset % NK_PACK_ALIGNMENT != 0
+        || headVal.m_tocOffset > fileSize
+        || (fileSize - headVal.m_tocOffset) / sizeof(NkPackEntry) < headVal.m_nEntries
+    ) {
+        errCode = NkErr_CorruptedData;
+
+        goto lbl_ONERROR;
+    }
+    actArch->mp_tocArr = (NkPackEntry const *)(actArch->m_fileView.mp_dataPtr + headVal.m_tocOffset);
+    actArch->m_nEntries = headVal.m_nEntries;
+
+    /*
+     * Validate every entry once, so that lookups and reads do not have to. The entries
+     * must be sorted by UUID for the binary search to work.
+     */
+    for (NkSize i = 0; i < actArch->m_nEntries; i++) {
+        NkPackEntry const *entryPtr = &actArch->mp_tocArr[i];
+
+        NkBoolean const isCompressed = (entryPtr->m_entryFlags & NkPackEnt_Compressed) != 0;
+        if (   entryPtr->m_dataOffset > headVal.m_tocOffset
+            || entryPtr->m_storedSize > headVal.m_tocOffset - entryPtr->m_dataOffset
+            || (!isCompressed && entryPtr->m_rawSize != entryPtr->m_storedSize)
+            || entryPtr->m_rawSize > SIZE_MAX
+            || (i > 0 && __NkInt_Pack_CompareUuids(&actArch->mp_tocArr[i - 1].m_assetUuid, &entryPtr->m_assetUuid) >= 0)
+        ) {
+            errCode = NkErr_CorruptedData;
+
+            goto lbl_ONERROR;
+        }
+    }
+
+    NK_LOG_INFO("Opened pack archive \"%s\" (%zu blobs, %llu bytes).", filePath, actArch->m_nEntries, (unsigned long long)fileSize);
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    NK_LOG_ERROR("Failed to open pack archive \"%s\". Reason: %s (%i)", filePath, NkGetErrorCodeStr(errCode)->mp_dataPtr, (int)errCode);
+
+    NkPackArchiveClose(archPtr);
+    return errCode;
+}
+
+NkVoid NK_CALL NkPackArchiveClose(_Uninit_ptr_ NkPackArchive **archPtr) {
+    NK_ASSERT(archPtr != NULL, NkErr_InOutParameter);
+
+    if (*archPtr == NULL)
+        return;
+
+    __NkVirt_Filesys_UnmapFile((*archPtr)->mp_mapHnd);
+    NkGPFree(*archPtr);
+    *archPtr = NULL;
+}
+
+NkPackEntry const *NK_CALL NkPackArchiveFindEntry(_In_ NkPackArchive const *archPtr, _In_ NkUuid const *assetId) {
+    NK_ASSERT(archPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(assetId != NULL, NkErr_InParameter);
+
+    NkSize lowInd  = 0;
+    NkSize highInd = archPtr->m_nEntries;
+    while (lowInd < highInd) {
+        NkSize const midInd = lowInd + (highInd - lowInd) / 2;
+
+        int const cmpRes = __NkInt_Pack_CompareUuids(&archPtr->mp_tocArr[midInd].m_assetUuid, assetId);
+        if (cmpRes == 0)
+            return &archPtr->mp_tocArr[midInd];
+        else if (cmpRes < 0)
+            lowInd = midInd + 1;
+        else
+            highInd = midInd;
+    }
+
+    return NULL;
+}
+
+NkBufferView NK_CALL NkPackArchiveMapBlob(_In_ NkPackArchive const *archPtr, _In_ NkPackEntry const *entryPtr) {
+    NK_ASSERT(archPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(entryPtr != NULL, NkErr_InParameter);
+
+    return (NkBufferView){
+        .mp_dataPtr    = archPtr->m_fileView.mp_dataPtr + entryPtr->m_dataOffset,
+        .m_sizeInBytes = (NkSize)entryPtr->m_storedSize
+    };
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkPackArchiveReadBlob(
+    _In_  NkPackArchive const *archPtr,
+    _In_  NkPackEntry const *entryPtr,
+    _Out_ NkByte *bufPtr
+) {
+    NK_ASSERT(archPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(entryPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(bufPtr != NULL || entryPtr->m_rawSize == 0, NkErr_OutParameter);
+
+    NkBufferView const storedBuf = NkPackArchiveMapBlob(archPtr, entryPtr);
+    if (entryPtr->m_entryFlags & NkPackEnt_Compressed)
+        return __NkInt_Pack_Decompress(storedBuf, bufPtr, (NkSize)entryPtr->m_rawSize);
+
+    memcpy(bufPtr, storedBuf.mp_dataPtr, storedBuf.m_sizeInBytes);
+    return NkErr_Ok;
+}
+
+NkSize NK_CALL NkPackArchiveQueryEntryCount(_In_ NkPackArchive const *archPtr) {
+    NK_ASSERT(archPtr != NULL, NkErr_InParameter);
+
+    return archPtr->m_nEntries;
+}
+
+
+_Return_ok_ NkErrorCode NK_CALL NkPackWriterCreate(_Init_ptr_ NkPackWriter **writerPtr) {
+    NK_ASSERT(writerPtr != NULL, NkErr_OutptrParameter);
+
+    return NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **writerPtr, 0, NK_TRUE, (NkVoid **)writerPtr);
+}
+
+NkVoid NK_CALL NkPackWriterDestroy(_Uninit_ptr_ NkPackWriter **writerPtr) {
+    NK_ASSERT(writerPtr != NULL, NkErr_InOutParameter);
+
+    if (*writerPtr == NULL)
+        return;
+
+    for (NkSize i = 0; i < (*writerPtr)->m_nBlobs; i++)
+        NkGPFree((*writerPtr)->mp_blobArr[i].mp_dataPtr);
+    NkGPFree((*writerPtr)->mp_blobArr);
+    NkGPFree(*writerPtr);
+    *writerPtr = NULL;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkPackWriterAddBlob(
+    _Inout_ NkPackWriter *writerPtr,
+    _In_    NkUuid const *assetId,
+    _In_    NkBufferView dataBuf,
+    _In_    NkBoolean isCompress
+) {
+    NK_ASSERT(writerPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(assetId != NULL, NkErr_InParameter);
+    NK_ASSERT(dataBuf.mp_dataPtr != NULL || dataBuf.m_sizeInBytes == 0, NkErr_InParameter);
+
+    /* Grow the blob array if needed. */
+    if (writerPtr->m_nBlobs == writerPtr->m_blobCap) {
+        NkSize const newCap = NK_MAX(writerPtr->m_blobCap * 2, (NkSize)64);
+
+        NkErrorCode errCode = writerPtr->mp_blobArr == NULL
+            ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *writerPtr->mp_blobArr, 0, NK_FALSE, (NkVoid **)&writerPtr->mp_blobArr)
+            : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *writerPtr->mp_blobArr, (NkVoid **)&writerPtr->mp_blobArr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+        writerPtr->m_blobCap = newCap;
+    }
+
+    /*
+     * Compress into a buffer as large as the raw data; if the output does not fit, the
+     * blob does not compress and is stored as-is.
+     */
+    NkByte *storedPtr;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), NK_MAX(dataBuf.m_sizeInBytes, (NkSize)1), 0, NK_FALSE, (NkVoid **)&storedPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    NkSize storedSize;
+    NkBoolean const isCompressed = isCompress && __NkInt_Pack_Compress(dataBuf, storedPtr, dataBuf.m_sizeInBytes, &storedSize);
+    if (!isCompressed) {
+        memcpy(storedPtr, dataBuf.mp_dataPtr, dataBuf.m_sizeInBytes);
+
+        storedSize = dataBuf.m_sizeInBytes;
+    }
+
+    writerPtr->mp_blobArr[writerPtr->m_nBlobs++] = (__NkInt_PackBlob){
+        .m_tocEntry = {
+            .m_assetUuid  = *assetId,
+            .m_storedSize = (NkUint64)storedSize,
+            .m_rawSize    = (NkUint64)dataBuf.m_sizeInBytes,
+            .m_entryFlags = isCompressed ? NkPackEnt_Compressed : NkPackEnt_None
+        },
+        .mp_dataPtr = storedPtr
+    };
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkPackWriterSave(_Inout_ NkPackWriter *writerPtr, _In_z_ char const *filePath) {
+    NK_ASSERT(writerPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(filePath != NULL && *filePath ^ '\0', NkErr_InParameter);
+
+    /* Sort the blobs so that the runtime can binary-search the table of contents. */
+    if (writerPtr->m_nBlobs > 1)
+        NK_IGNORE_RETURN_VALUE(NkQuicksortValues(
+            writerPtr->mp_blobArr,
+            sizeof *writerPtr->mp_blobArr,
+            0,
+            writerPtr->m_nBlobs - 1,
+            &__NkInt_PackWriter_CompareBlobs
+        ));
+    for (NkSize i = 1; i < writerPtr->m_nBlobs; i++)
+        if (__NkInt_PackWriter_CompareBlobs(&writerPtr->mp_blobArr[i - 1], &writerPtr->mp_blobArr[i]) == 0) {
+            char uuidStr[NK_UUIDLEN];
+            NK_LOG_ERROR("Blob %s was added to the pack archive more than once.", NkUuidToString(&writerPtr->mp_blobArr[i].m_tocEntry.m_assetUuid, uuidStr));
+
+            return NkErr_ObjectState;
+        }
+
+    /* Lay out the blobs. */
+    NkUint64 currOff = NK_PACK_ALIGNMENT;
+    for (NkSize i = 0; i < writerPtr->m_nBlobs; i++) {
+        writerPtr->mp_blobArr[i].m_tocEntry.m_dataOffset = currOff;
+
+        currOff += writerPtr->mp_blobArr[i].m_tocEntry.m_storedSize;
+        currOff  = (currOff + NK_PACK_ALIGNMENT - 1) & ~(NK_PACK_ALIGNMENT - 1);
+    }
+    NkPackHeader const headVal = {
+        .m_magicNum  = NK_PACK_MAGIC,
+        .m_formatVer = NK_PACK_VERSION,
+        .m_nEntries  = (NkUint32)writerPtr->m_nBlobs,
+        .m_tocOffset = currOff,
+        .m_fileSize  = currOff + writerPtr->m_nBlobs * sizeof(NkPackEntry)
+    };
+
+    /* Write the archive. */
+    FILE *fStream;
+    if (fopen_s(&fStream, filePath, "wb") != 0)
+        return NkErr_OpenFile;
+
+    NkByte const padBytes[NK_PACK_ALIGNMENT] = { 0 };
+    NkBoolean isOk = fwrite(&headVal, sizeof headVal, 1, fStream) == 1
+        && fwrite(padBytes, (NkSize)NK_PACK_ALIGNMENT - sizeof headVal, 1, fStream) == 1;
+    for (NkSize i = 0; isOk && i < writerPtr->m_nBlobs; i++) {
+        NkPackEntry const *entryPtr = &writerPtr->mp_blobArr[i].m_tocEntry;
+        NkUint64    const  endOff   = i + 1 < writerPtr->m_nBlobs ? writerPtr->mp_blobArr[i + 1].m_tocEntry.m_dataOffset : headVal.m_tocOffset;
+
+        NkSize const padSize = (NkSize)(endOff - entryPtr->m_dataOffset - entryPtr->m_storedSize);
+        isOk = (entryPtr->m_storedSize == 0 || fwrite(writerPtr->mp_blobArr[i].mp_dataPtr, (NkSize)entryPtr->m_storedSize, 1, fStream) == 1)
+            && (padSize == 0 || fwrite(padBytes, padSize, 1, fStream) == 1);
+    }
+    for (NkSize i = 0; isOk && i < writerPtr->m_nBlobs; i++)
+        isOk = fwrite(&writerPtr->mp_blobArr[i].m_tocEntry, sizeof(NkPackEntry), 1, fStream) == 1;
+    isOk = fclose(fStream) == 0 && isOk;
+
+    return isOk ? NkErr_Ok : NkErr_ErrorDuringDiskIO;
+}
+
+
+#undef NK_NAMESPACE
+
+
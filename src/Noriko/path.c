@@ -171,31 +171,49 @@ _Return_ok_ NkErrorCode NK_CALL NkPathBuild(
         return errCode;
     sepCh = sepCh != NULL ? sepCh : __NkInt_StandardPaths_QueryNativeSeparator();
 
+    NkStringView const *tailStrs[] = {
+        fileName != NULL && stemCompArr != NULL && stemCompArr[0] != NULL ? sepCh : NULL,
+        fileName,
+        extStr != NULL && fileName == NULL && stemCompArr != NULL && stemCompArr[0] != NULL ? sepCh : NULL,
+        extStr == NULL ? NULL : NK_MAKE_STRING_VIEW_PTR("."),
+        extStr
+    };
+
+    /*
+     * Calculate the final length of the path first so that the buffer only has to be
+     * allocated once.
+     */
+    NkSize totalLen = 0;
+    for (NkSize i = 0; stemCompArr != NULL && stemCompArr[i] != NULL; i++)
+        totalLen += stemCompArr[i]->m_sizeInBytes + (stemCompArr[i + 1] != NULL ? sepCh->m_sizeInBytes : 0);
+    for (NkSize i = 0; i < NK_ARRAYSIZE(tailStrs); i++)
+        totalLen += tailStrs[i] != NULL ? tailStrs[i]->m_sizeInBytes : 0;
+    if (totalLen >= UINT32_MAX) {
+        errCode = NkErr_UnsignedWrapAround;
+
+        goto lbl_ONERROR;
+    }
+    if ((errCode = NkStringReserve(resStr, (NkUint32)totalLen)) != NkErr_Ok)
+        goto lbl_ONERROR;
+
     /*
      * Go through stem array and append all path components. Stop when we arrive at a
      * terminating NULL-pointer.
      */
     for (NkSize i = 0; stemCompArr != NULL && stemCompArr[i] != NULL; i++) {
-        if ((errCode = NkStringJoin(resStr, stemCompArr[i]->mp_dataPtr, (NkUint32)(-1))) != NkErr_Ok)
+        if ((errCode = NkStringJoin(resStr, stemCompArr[i]->mp_dataPtr, (NkUint32)stemCompArr[i]->m_sizeInBytes)) != NkErr_Ok)
             goto lbl_ONERROR;
 
         /* If we are not at the end yet, append a separator. */
         if (stemCompArr[i + 1] != NULL)
-            if ((errCode = NkStringJoin(resStr, sepCh->mp_dataPtr, (NkUint32)(-1))) != NkErr_Ok)
+            if ((errCode = NkStringJoin(resStr, sepCh->mp_dataPtr, (NkUint32)sepCh->m_sizeInBytes)) != NkErr_Ok)
                 goto lbl_ONERROR;
     }
 
     /* Append the rest. */
-    NkStringView const *tailStrs[] = {
-        fileName != NULL && stemCompArr != NULL && stemCompArr[0] != NULL ? sepCh : NULL,
-        fileName,
-        extStr != NULL && fileName == NULL && stemCompArr != NULL && stemCompArr[0] != NULL ? sepCh : NULL,
-        extStr == NULL ? NULL : NK_MAKE_STRING_VIEW_PTR("."),
-        extStr
-    };
     for (NkSize i = 0; i < NK_ARRAYSIZE(tailStrs); i++)
         if (tailStrs[i] != NULL) {
-            errCode = NkStringJoin(resStr, tailStrs[i]->mp_dataPtr, (NkUint32)(-1));
+            errCode = NkStringJoin(resStr, tailStrs[i]->mp_dataPtr, (NkUint32)tailStrs[i]->m_sizeInBytes);
 
             if (errCode != NkErr_Ok)
                 goto lbl_ONERROR;
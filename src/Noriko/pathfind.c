@@ -0,0 +1,852 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  pathfind.c
+ * \brief implements the A* and flow field pathfinding service
+ *
+ * Every search works on a private snapshot of the collision bits of its window, so the
+ * only state shared between the main thread and the jobs is the reference count and the
+ * status of a result. The bookkeeping arrays a search needs are sized for the largest
+ * window and recycled through a free list; visited nodes are tagged with a stamp that
+ * changes every search, so the arrays never have to be cleared.
+ */
+#define NK_NAMESPACE "nk::pathfind"
+
+
+/* stdlib includes */
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/pathfind.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/job.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \brief number of tiles the window of a path search extends beyond start and goal
+ */
+#define __NkInt_PathService_Margin ((NkInt64)(16))
+/**
+ * \brief direction value of tiles that have no next step
+ */
+#define __NkInt_PathService_NoDir  ((NkUint8)(4))
+/**
+ * \brief heap position of nodes that have been expanded already
+ */
+#define __NkInt_PathService_Closed ((NkUint32)(UINT32_MAX))
+
+
+/**
+ * \brief offsets of the four neighbors of a tile
+ * \note  The opposite of direction \c d is <tt>d ^ 1</tt>.
+ */
+NK_INTERNAL NkPoint2D const gl_c_PathDirs[] = {
+    {  1,  0 },
+    { -1,  0 },
+    {  0,  1 },
+    {  0, -1 }
+};
+
+
+/**
+ * \struct __NkInt_PathSearch
+ * \brief  holds the bookkeeping arrays of one search
+ *
+ * All arrays have <tt>m_maxExt * m_maxExt</tt> elements and are stored in the same
+ * allocation, right after the structure.
+ */
+NK_NATIVE typedef struct __NkInt_PathSearch {
+    struct __NkInt_PathSearch *mp_nextSearch; /**< next free search context */
+    NkUint32                   m_currStamp;   /**< stamp of the current search */
+
+    NkUint32 *mp_stampArr;   /**< stamp of the search that last visited the node */
+    NkUint32 *mp_costArr;    /**< cost of the cheapest known way to the node */
+    NkUint32 *mp_prioArr;    /**< cost plus heuristic of the node */
+    NkUint32 *mp_heapPosArr; /**< position of the node in the heap */
+    NkUint32 *mp_heapArr;    /**< open nodes (A*) or queue of nodes (flow field) */
+    NkUint8  *mp_parentArr;  /**< direction the node was reached by */
+} __NkInt_PathSearch;
+
+/**
+ * \struct NkPathResult
+ * \brief  internal definition of a search result
+ */
+struct NkPathResult {
+    LONG volatile  m_refCount;    /**< number of references */
+    LONG volatile  m_resStatus;   /**< current state (NkPathStatus) */
+    NkPathService *mp_svcRef;     /**< service running the search; only used by the job */
+    NkBoolean      m_isFlowField; /**< whether the result is a flow field */
+    NkPoint2D      m_startPos;    /**< start tile; unused for flow fields */
+    NkPoint2D      m_goalPos;     /**< goal tile */
+    NkPoint2D      m_winOrigin;   /**< upper-left tile of the search window */
+    NkUint32       m_extX;        /**< width of the search window */
+    NkUint32       m_extY;        /**< height of the search window */
+    NkSize         m_rowWords;    /**< number of words per row of <tt>mp_solidArr</tt> */
+    NkUint64      *mp_solidArr;   /**< collision bits of the window; freed after the search */
+    NkPoint2D     *mp_tileArr;    /**< tiles of the path */
+    NkUint32       m_nTiles;      /**< number of elements in <tt>mp_tileArr</tt> */
+    NkUint8       *mp_dirArr;     /**< direction of the next step of every tile of the window */
+};
+
+/**
+ * \struct NkPathService
+ * \brief  internal definition of the pathfinding service
+ *
+ * The cache is direct-mapped and only ever accessed by the thread that requests
+ * searches; the lock only guards the free list of search contexts.
+ */
+struct NkPathService {
+    NkPathServiceSpecification  m_svcSpec;      /**< copy of the specification */
+    NkPathResult              **mp_cacheArr;    /**< cached results */
+    __NkInt_PathSearch         *mp_freeSearch;  /**< free search contexts */
+    NkJobCounter                m_searchCtr;    /**< counts the running searches */
+    NK_DECL_LOCK(m_mtxLock);                    /**< guards <tt>mp_freeSearch</tt> */
+};
+
+
+/**
+ * \brief  calculates the cache slot for a search
+ * \param  [in] svcPtr pointer to the pathfinding service
+ * \param  [in] keyA, keyB, keyC, keyD values identifying the search
+ * \return index of the cache slot
+ */
+NK_INTERNAL NkUint32 __NkInt_PathService_Hash(
+    _In_ NkPathService const *svcPtr,
+    _In_ NkInt64 keyA,
+    _In_ NkInt64 keyB,
+    _In_ NkInt64 keyC,
+    _In_ NkInt64 keyD
+) {
+    NkInt64 const keyArr[] = { keyA, keyB, keyC, keyD };
+
+    NkUint64 hashVal = 0xcbf29ce484222325ULL;
+    for (NkSize i = 0; i < NK_ARRAYSIZE(keyArr); i++)
+        hashVal = (hashVal ^ (NkUint64)keyArr[i]) * 0x100000001b3ULL;
+
+    return (NkUint32)(hashVal ^ hashVal >> 32) & (svcPtr->m_svcSpec.m_nCacheSlots - 1);
+}
+
+/**
+ * \brief  fits one axis of a path search window around two coordinates
+ * \param  [in] maxExt maximum extent of the window
+ * \param  [in] coordA, coordB coordinates that must be inside the window
+ * \param  [out] origPtr pointer to a variable that receives the first coordinate of the window
+ * \param  [out] extPtr pointer to a variable that receives the extent of the window
+ * \return \c NK_TRUE if both coordinates fit into a window of \c maxExt tiles, \c NK_FALSE
+ *         if not
+ */
+NK_INTERNAL NkBoolean __NkInt_PathService_FitAxis(
+    _In_  NkUint32 maxExt,
+    _In_  NkInt64 coordA,
+    _In_  NkInt64 coordB,
+    _Out_ NkInt64 *origPtr,
+    _Out_ NkUint32 *extPtr
+) {
+    NkInt64 const minCoord = NK_MIN(coordA, coordB);
+    NkInt64 const spanExt  = NK_MAX(coordA, coordB) - minCoord + 1;
+    if (spanExt > (NkInt64)maxExt)
+        return NK_FALSE;
+
+    /* Spread the margin evenly if it has to be cut down. */
+    NkInt64 const winExt = NK_MIN(spanExt + 2 * __NkInt_PathService_Margin, (NkInt64)maxExt);
+    *origPtr = minCoord - (winExt - spanExt) / 2;
+    *extPtr  = (NkUint32)winExt;
+    return NK_TRUE;
+}
+
+/**
+ * \brief  takes a search context from the free list, or creates a new one
+ * \param  [in, out] svcPtr pointer to the pathfinding service
+ * \return pointer to the search context, or \c NULL if memory could not be allocated
+ */
+NK_INTERNAL __NkInt_PathSearch *__NkInt_PathService_AcquireSearch(_Inout_ NkPathService *svcPtr) {
+    NK_LOCK(svcPtr->m_mtxLock);
+    __NkInt_PathSearch *searchPtr = svcPtr->mp_freeSearch;
+    if (searchPtr != NULL)
+        svcPtr->mp_freeSearch = searchPtr->mp_nextSearch;
+    NK_UNLOCK(svcPtr->m_mtxLock);
+    if (searchPtr != NULL)
+        return searchPtr;
+
+    NkSize const nNodes = (NkSize)svcPtr->m_svcSpec.m_maxExt * svcPtr->m_svcSpec.m_maxExt;
+    NkErrorCode const errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof *searchPtr + nNodes * (5 * sizeof(NkUint32) + sizeof(NkUint8)),
+        0,
+        NK_TRUE,
+        (NkVoid **)&searchPtr
+    );
+    if (errCode != NkErr_Ok)
+        return NULL;
+
+    searchPtr->mp_stampArr   = (NkUint32 *)(searchPtr + 1);
+    searchPtr->mp_costArr    = searchPtr->mp_stampArr + nNodes;
+    searchPtr->mp_prioArr    = searchPtr->mp_costArr + nNodes;
+    searchPtr->mp_heapPosArr = searchPtr->mp_prioArr + nNodes;
+    searchPtr->mp_heapArr    = searchPtr->mp_heapPosArr + nNodes;
+    searchPtr->mp_parentArr  = (NkUint8 *)(searchPtr->mp_heapArr + nNodes);
+    return searchPtr;
+}
+
+/**
+ * \brief puts a search context back onto the free list
+ * \param [in, out] svcPtr pointer to the pathfinding service
+ * \param [in, out] searchPtr search context that is no longer used
+ */
+NK_INTERNAL NkVoid __NkInt_PathService_ReleaseSearch(
+    _Inout_ NkPathService *svcPtr,
+    _Inout_ __NkInt_PathSearch *searchPtr
+) {
+    NK_LOCK(svcPtr->m_mtxLock);
+    searchPtr->mp_nextSearch = svcPtr->mp_freeSearch;
+    svcPtr->mp_freeSearch    = searchPtr;
+    NK_UNLOCK(svcPtr->m_mtxLock);
+}
+
+/**
+ * \brief starts a new search on the given context, invalidating all visited nodes
+ * \param [in, out] searchPtr search context
+ * \param [in] nNodes number of nodes of the search context
+ */
+NK_INTERNAL NkVoid __NkInt_PathSearch_Begin(_Inout_ __NkInt_PathSearch *searchPtr, _In_ NkSize nNodes) {
+    if (++searchPtr->m_currStamp != 0)
+        return;
+
+    /* The stamp wrapped around; old stamps could be mistaken for the current one. */
+    memset(searchPtr->mp_stampArr, 0, nNodes * sizeof *searchPtr->mp_stampArr);
+    searchPtr->m_currStamp = 1;
+}
+
+/**
+ * \brief  checks whether a tile of the search window is solid
+ * \param  [in] resPtr result holding the collision snapshot
+ * \param  [in] localX, localY coordinates of the tile, relative to the window
+ * \return \c NK_TRUE if the tile is solid, \c NK_FALSE if not
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_PathResult_IsSolid(
+    _In_ NkPathResult const *resPtr,
+    _In_ NkInt64 localX,
+    _In_ NkInt64 localY
+) {
+    return (NkBoolean)(resPtr->mp_solidArr[(NkSize)localY * resPtr->m_rowWords + (localX >> 6)] >> (localX & 63) & 1);
+}
+
+/**
+ * \brief  calculates the Manhattan distance between two tiles
+ * \param  [in] ax, ay coordinates of the first tile
+ * \param  [in] bx, by coordinates of the second tile
+ * \return number of steps between the tiles if nothing is in the way
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_PathSearch_Dist(
+    _In_ NkInt64 ax,
+    _In_ NkInt64 ay,
+    _In_ NkInt64 bx,
+    _In_ NkInt64 by
+) {
+    return (NkUint32)((ax > bx ? ax - bx : bx - ax) + (ay > by ? ay - by : by - ay));
+}
+
+/**
+ * \brief  checks whether node \c nodeA is to be expanded before node \c nodeB
+ * \note   Among nodes of equal priority, the one that is further along is preferred,
+ *         which avoids expanding the whole plateau of equally good nodes.
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_PathSearch_IsBefore(
+    _In_ __NkInt_PathSearch const *searchPtr,
+    _In_ NkUint32 nodeA,
+    _In_ NkUint32 nodeB
+) {
+    NkUint32 const prioA = searchPtr->mp_prioArr[nodeA];
+    NkUint32 const prioB = searchPtr->mp_prioArr[nodeB];
+
+    return prioA < prioB || (prioA == prioB && searchPtr->mp_costArr[nodeA] > searchPtr->mp_costArr[nodeB]);
+}
+
+/**
+ * \brief moves a node of the heap up until the heap property holds again
+ * \param [in, out] searchPtr search context
+ * \param [in] heapPos current position of the node in the heap
+ */
+NK_INTERNAL NkVoid __NkInt_PathSearch_SiftUp(_Inout_ __NkInt_PathSearch *searchPtr, _In_ NkUint32 heapPos) {
+    NkUint32 *heapArr = searchPtr->mp_heapArr;
+    NkUint32 const nodeInd = heapArr[heapPos];
+
+    while (heapPos > 0) {
+        NkUint32 const parentPos = (heapPos - 1) / 2;
+        if (!__NkInt_PathSearch_IsBefore(searchPtr, nodeInd, heapArr[parentPos]))
+            break;
+
+        heapArr[heapPos] = heapArr[parentPos];
+        searchPtr->mp_heapPosArr[heapArr[heapPos]] = heapPos;
+        heapPos = parentPos;
+    }
+    heapArr[heapPos] = nodeInd;
+    searchPtr->mp_heapPosArr[nodeInd] = heapPos;
+}
+
+/**
+ * \brief  removes the first node from the heap
+ * \param  [in, out] searchPtr search context
+ * \param  [in, out] heapSizePtr pointer to the number of nodes in the heap
+ * \return index of the removed node
+ */
+NK_INTERNAL NkUint32 __NkInt_PathSearch_Pop(_Inout_ __NkInt_PathSearch *searchPtr, _Inout_ NkUint32 *heapSizePtr) {
+    NkUint32 *heapArr = searchPtr->mp_heapArr;
+    NkUint32 const topInd  = heapArr[0];
+    NkUint32 const heapSize = --*heapSizePtr;
+    searchPtr->mp_heapPosArr[topInd] = __NkInt_PathService_Closed;
+    if (heapSize == 0)
+        return topInd;
+
+    /* Move the last node down from the top. */
+    NkUint32 const nodeInd = heapArr[heapSize];
+    NkUint32       heapPos = 0;
+    for (;;) {
+        NkUint32 childPos = 2 * heapPos + 1;
+        if (childPos >= heapSize)
+            break;
+        if (childPos + 1 < heapSize && __NkInt_PathSearch_IsBefore(searchPtr, heapArr[childPos + 1], heapArr[childPos]))
+            ++childPos;
+        if (!__NkInt_PathSearch_IsBefore(searchPtr, heapArr[childPos], nodeInd))
+            break;
+
+        heapArr[heapPos] = heapArr[childPos];
+        searchPtr->mp_heapPosArr[heapArr[heapPos]] = heapPos;
+        heapPos = childPos;
+    }
+    heapArr[heapPos] = nodeInd;
+    searchPtr->mp_heapPosArr[nodeInd] = heapPos;
+
+    return topInd;
+}
+
+/**
+ * \brief  runs A* on the window of a path result
+ * \param  [in, out] searchPtr search context
+ * \param  [in, out] resPtr result that receives the path
+ * \return final status of the search
+ */
+NK_INTERNAL NkPathStatus __NkInt_PathSearch_RunAStar(
+    _Inout_ __NkInt_PathSearch *searchPtr,
+    _Inout_ NkPathResult *resPtr
+) {
+    NkInt64 const extX  = (NkInt64)resPtr->m_extX;
+    NkInt64 const extY  = (NkInt64)resPtr->m_extY;
+    NkInt64 const goalX = resPtr->m_goalPos.m_xCoord - resPtr->m_winOrigin.m_xCoord;
+    NkInt64 const goalY = resPtr->m_goalPos.m_yCoord - resPtr->m_winOrigin.m_yCoord;
+    if (__NkInt_PathResult_IsSolid(resPtr, goalX, goalY))
+        return NkPathSt_NotFound;
+
+    NkUint32 const goalInd  = (NkUint32)(goalY * extX + goalX);
+    NkUint32 const startInd = (NkUint32)(
+        (resPtr->m_startPos.m_yCoord - resPtr->m_winOrigin.m_yCoord) * extX
+            + resPtr->m_startPos.m_xCoord - resPtr->m_winOrigin.m_xCoord
+    );
+    __NkInt_PathSearch_Begin(searchPtr, (NkSize)extX * extY);
+
+    NkUint32 const currStamp = searchPtr->m_currStamp;
+    NkUint32       heapSize  = 1;
+    searchPtr->mp_stampArr[startInd]  = currStamp;
+    searchPtr->mp_costArr[startInd]   = 0;
+    searchPtr->mp_parentArr[startInd] = __NkInt_PathService_NoDir;
+    searchPtr->mp_prioArr[startInd]   = __NkInt_PathSearch_Dist(startInd % extX, startInd / extX, goalX, goalY);
+    searchPtr->mp_heapArr[0]          = startInd;
+    searchPtr->mp_heapPosArr[startInd] = 0;
+
+    while (heapSize > 0) {
+        NkUint32 const nodeInd = __NkInt_PathSearch_Pop(searchPtr, &heapSize);
+        if (nodeInd == goalInd)
+            break;
+
+        NkInt64 const  nodeX   = (NkInt64)(nodeInd % extX);
+        NkInt64 const  nodeY   = (NkInt64)(nodeInd / extX);
+        NkUint32 const newCost = searchPtr->mp_costArr[nodeInd] + 1;
+        for (NkUint8 d = 0; d < NK_ARRAYSIZE(gl_c_PathDirs); d++) {
+            NkInt64 const nbX = nodeX + gl_c_PathDirs[d].m_xCoord;
+            NkInt64 const nbY = nodeY + gl_c_PathDirs[d].m_yCoord;
+            if (nbX < 0 || nbY < 0 || nbX >= extX || nbY >= extY || __NkInt_PathResult_IsSolid(resPtr, nbX, nbY))
+                continue;
+
+            NkUint32 const nbInd = (NkUint32)(nbY * extX + nbX);
+            if (searchPtr->mp_stampArr[nbInd] != currStamp) {
+                searchPtr->mp_stampArr[nbInd] = currStamp;
+
+                searchPtr->mp_heapArr[heapSize] = nbInd;
+                searchPtr->mp_heapPosArr[nbInd] = heapSize++;
+            } else if (searchPtr->mp_heapPosArr[nbInd] == __NkInt_PathService_Closed || newCost >= searchPtr->mp_costArr[nbInd])
+                continue;
+
+            /* New node or cheaper way to an open node. */
+            searchPtr->mp_costArr[nbInd]   = newCost;
+            searchPtr->mp_parentArr[nbInd] = d;
+            searchPtr->mp_prioArr[nbInd]   = newCost + __NkInt_PathSearch_Dist(nbX, nbY, goalX, goalY);
+            __NkInt_PathSearch_SiftUp(searchPtr, searchPtr->mp_heapPosArr[nbInd]);
+        }
+    }
+    if (searchPtr->mp_stampArr[goalInd] != currStamp || searchPtr->mp_heapPosArr[goalInd] != __NkInt_PathService_Closed)
+        return NkPathSt_NotFound;
+
+    /* Walk back from the goal along the parent directions. */
+    NkUint32 const    nTiles  = searchPtr->mp_costArr[goalInd] + 1;
+    NkErrorCode const errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        nTiles * sizeof *resPtr->mp_tileArr,
+        0,
+        NK_FALSE,
+        (NkVoid **)&resPtr->mp_tileArr
+    );
+    if (errCode != NkErr_Ok) {
+        NK_LOG_ERROR("Failed to allocate path of %u tiles.", (unsigned)nTiles);
+
+        return NkPathSt_NotFound;
+    }
+
+    NkUint32 nodeInd = goalInd;
+    for (NkUint32 i = nTiles; i-- > 0;) {
+        NkInt64 const nodeX = (NkInt64)(nodeInd % extX);
+        NkInt64 const nodeY = (NkInt64)(nodeInd / extX);
+        resPtr->mp_tileArr[i] = (NkPoint2D){
+            resPtr->m_winOrigin.m_xCoord + nodeX,
+            resPtr->m_winOrigin.m_yCoord + nodeY
+        };
+        if (i == 0)
+            break;
+
+        NkPoint2D const *dirPtr = &gl_c_PathDirs[searchPtr->mp_parentArr[nodeInd]];
+        nodeInd = (NkUint32)((nodeY - dirPtr->m_yCoord) * extX + nodeX - dirPtr->m_xCoord);
+    }
+    resPtr->m_nTiles = nTiles;
+
+    return NkPathSt_Found;
+}
+
+/**
+ * \brief  builds the flow field of a result by a breadth-first search from the goal
+ * \param  [in, out] searchPtr search context
+ * \param  [in, out] resPtr result that receives the flow field
+ * \return final status of the search
+ */
+NK_INTERNAL NkPathStatus __NkInt_PathSearch_RunFlowField(
+    _Inout_ __NkInt_PathSearch *searchPtr,
+    _Inout_ NkPathResult *resPtr
+) {
+    NkInt64 const extX  = (NkInt64)resPtr->m_extX;
+    NkInt64 const extY  = (NkInt64)resPtr->m_extY;
+    NkInt64 const goalX = resPtr->m_goalPos.m_xCoord - resPtr->m_winOrigin.m_xCoord;
+    NkInt64 const goalY = resPtr->m_goalPos.m_yCoord - resPtr->m_winOrigin.m_yCoord;
+    if (__NkInt_PathResult_IsSolid(resPtr, goalX, goalY))
+        return NkPathSt_NotFound;
+
+    NkSize const      nNodes  = (NkSize)extX * extY;
+    NkErrorCode const errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        nNodes * sizeof *resPtr->mp_dirArr,
+        0,
+        NK_FALSE,
+        (NkVoid **)&resPtr->mp_dirArr
+    );
+    if (errCode != NkErr_Ok) {
+        NK_LOG_ERROR("Failed to allocate flow field of %zu tiles.", nNodes);
+
+        return NkPathSt_NotFound;
+    }
+    memset(resPtr->mp_dirArr, __NkInt_PathService_NoDir, nNodes * sizeof *resPtr->mp_dirArr);
+    __NkInt_PathSearch_Begin(searchPtr, nNodes);
+
+    /* Every tile that is reached points back to the tile it was reached from. */
+    NkUint32 const currStamp = searchPtr->m_currStamp;
+    NkUint32 const goalInd   = (NkUint32)(goalY * extX + goalX);
+    NkUint32      *queueArr  = searchPtr->mp_heapArr;
+    NkUint32       queueHead = 0;
+    NkUint32       queueTail = 1;
+    queueArr[0] = goalInd;
+    searchPtr->mp_stampArr[goalInd] = currStamp;
+
+    while (queueHead < queueTail) {
+        NkUint32 const nodeInd = queueArr[queueHead++];
+        NkInt64 const  nodeX   = (NkInt64)(nodeInd % extX);
+        NkInt64 const  nodeY   = (NkInt64)(nodeInd / extX);
+
+        for (NkUint8 d = 0; d < NK_ARRAYSIZE(gl_c_PathDirs); d++) {
+            NkInt64 const nbX = nodeX + gl_c_PathDirs[d].m_xCoord;
+            NkInt64 const nbY = nodeY + gl_c_PathDirs[d].m_yCoord;
+            if (nbX < 0 || nbY < 0 || nbX >= extX || nbY >= extY || __NkInt_PathResult_IsSolid(resPtr, nbX, nbY))
+                continue;
+
+            NkUint32 const nbInd = (NkUint32)(nbY * extX + nbX);
+            if (searchPtr->mp_stampArr[nbInd] == currStamp)
+                continue;
+
+            searchPtr->mp_stampArr[nbInd] = currStamp;
+            resPtr->mp_dirArr[nbInd]      = d ^ 1;
+            queueArr[queueTail++]         = nbInd;
+        }
+    }
+
+    return NkPathSt_Found;
+}
+
+/**
+ * \brief releases a reference to a result, destroying it when it was the last one
+ * \param [in, out] resPtr result that is to be released
+ */
+NK_INTERNAL NkVoid __NkInt_PathResult_Release(_Inout_ NkPathResult *resPtr) {
+    if (InterlockedDecrement(&resPtr->m_refCount) != 0)
+        return;
+
+    NkGPFree(resPtr->mp_solidArr);
+    NkGPFree(resPtr->mp_tileArr);
+    NkGPFree(resPtr->mp_dirArr);
+    NkGPFree(resPtr);
+}
+
+/**
+ * \brief runs the search of a result
+ * \param [in, out] extraCxt pointer to the result
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_PathService_SearchJob(_Inout_opt_ NkVoid *extraCxt) {
+    NkPathResult       *resPtr    = (NkPathResult *)extraCxt;
+    __NkInt_PathSearch *searchPtr = __NkInt_PathService_AcquireSearch(resPtr->mp_svcRef);
+
+    NkPathStatus resStatus = NkPathSt_NotFound;
+    if (searchPtr != NULL) {
+        resStatus = resPtr->m_isFlowField
+            ? __NkInt_PathSearch_RunFlowField(searchPtr, resPtr)
+            : __NkInt_PathSearch_RunAStar(searchPtr, resPtr)
+        ;
+
+        __NkInt_PathService_ReleaseSearch(resPtr->mp_svcRef, searchPtr);
+    } else
+        NK_LOG_ERROR("Failed to allocate search context; giving up on search.");
+
+    /* The snapshot is not needed anymore; publish the result. */
+    NkGPFree(resPtr->mp_solidArr);
+    resPtr->mp_solidArr = NULL;
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange(&resPtr->m_resStatus, (LONG)resStatus));
+
+    __NkInt_PathResult_Release(resPtr);
+}
+
+/**
+ * \brief  creates a result, snapshots its window, and starts its search
+ * \param  [in, out] svcPtr pointer to the pathfinding service
+ * \param  [in] isFlowField whether to build a flow field instead of a path
+ * \param  [in] startPos start tile; ignored for flow fields
+ * \param  [in] goalPos goal tile
+ * \param  [in] winOrigin upper-left tile of the search window
+ * \param  [in] extX, extY extents of the search window; \c 0 if the search fails at once
+ * \param  [out] resPtr pointer to a variable that receives the result
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_PathService_StartSearch(
+    _Inout_  NkPathService *svcPtr,
+    _In_     NkBoolean isFlowField,
+    _In_     NkPoint2D startPos,
+    _In_     NkPoint2D goalPos,
+    _In_     NkPoint2D winOrigin,
+    _In_     NkUint32 extX,
+    _In_     NkUint32 extY,
+    _Outptr_ NkPathResult **resPtr
+) {
+    NkPathResult *actRes;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *actRes, 0, NK_TRUE, (NkVoid **)&actRes);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    actRes->m_refCount    = 1;
+    actRes->m_resStatus   = (LONG)NkPathSt_Pending;
+    actRes->mp_svcRef     = svcPtr;
+    actRes->m_isFlowField = isFlowField;
+    actRes->m_startPos    = startPos;
+    actRes->m_goalPos     = goalPos;
+    actRes->m_winOrigin   = winOrigin;
+    actRes->m_extX        = extX;
+    actRes->m_extY        = extY;
+    actRes->m_rowWords    = (extX + 63) / 64;
+
+    *resPtr = actRes;
+    if (extX == 0 || extY == 0) {
+        /* The goal is too far away for a single window. */
+        actRes->m_resStatus = (LONG)NkPathSt_NotFound;
+
+        return NkErr_Ok;
+    }
+
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        actRes->m_rowWords * extY * sizeof *actRes->mp_solidArr,
+        0,
+        NK_FALSE,
+        (NkVoid **)&actRes->mp_solidArr
+    );
+    if (errCode != NkErr_Ok) {
+        NkGPFree(actRes);
+
+        *resPtr = NULL;
+        return errCode;
+    }
+    NkChunkStreamerCopySolidBits(
+        svcPtr->m_svcSpec.mp_chunkStr,
+        winOrigin,
+        (NkSize2D){ extX, extY },
+        actRes->m_rowWords,
+        actRes->mp_solidArr
+    );
+
+    /* The job holds a reference of its own until it has published the result. */
+    NkJobDescription const jobDesc = { &__NkInt_PathService_SearchJob, (NkVoid *)actRes };
+    NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&actRes->m_refCount));
+    if (NkJobGetWorkerCount() == 0 || NkJobSubmit(&jobDesc, 1, NULL, &svcPtr->m_searchCtr) != NkErr_Ok)
+        __NkInt_PathService_SearchJob((NkVoid *)actRes);
+
+    return NkErr_Ok;
+}
+
+/**
+ * \brief replaces the result in a cache slot
+ * \param [in, out] svcPtr pointer to the pathfinding service
+ * \param [in] slotInd index of the cache slot
+ * \param [in, out] resPtr new result of the slot; the cache adds a reference of its own
+ */
+NK_INTERNAL NkVoid __NkInt_PathService_CacheResult(
+    _Inout_ NkPathService *svcPtr,
+    _In_    NkUint32 slotInd,
+    _Inout_ NkPathResult *resPtr
+) {
+    NkPathResult **slotPtr = &svcPtr->mp_cacheArr[slotInd];
+
+    if (*slotPtr != NULL)
+        __NkInt_PathResult_Release(*slotPtr);
+    NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&resPtr->m_refCount));
+    *slotPtr = resPtr;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkPathServiceCreate(
+    _In_       NkPathServiceSpecification const *svcSpec,
+    _Init_ptr_ NkPathService **svcPtr
+) {
+    NK_ASSERT(svcSpec != NULL && svcSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(svcSpec->mp_chunkStr != NULL && svcSpec->m_maxExt > 0, NkErr_InParameter);
+    NK_ASSERT(svcSpec->m_nCacheSlots > 0 && (svcSpec->m_nCacheSlots & (svcSpec->m_nCacheSlots - 1)) == 0, NkErr_InParameter);
+    NK_ASSERT(svcPtr != NULL, NkErr_OutptrParameter);
+
+    NkErrorCode const errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof **svcPtr + svcSpec->m_nCacheSlots * sizeof *(*svcPtr)->mp_cacheArr,
+        0,
+        NK_TRUE,
+        (NkVoid **)svcPtr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    NkPathService *actSvc = *svcPtr;
+    actSvc->m_svcSpec   = *svcSpec;
+    actSvc->mp_cacheArr = (NkPathResult **)(actSvc + 1);
+    if (NK_INITLOCK(actSvc->m_mtxLock) != thrd_success) {
+        NkGPFree(actSvc);
+
+        *svcPtr = NULL;
+        return NkErr_SynchInit;
+    }
+
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkPathServiceDestroy(_Uninit_ptr_ NkPathService **svcPtr) {
+    NK_ASSERT(svcPtr != NULL, NkErr_InOutParameter);
+
+    NkPathService *actSvc = *svcPtr;
+    if (actSvc == NULL)
+        return;
+
+    /* Searches use the free list, so they have to be done before it is destroyed. */
+    NkJobWait(&actSvc->m_searchCtr);
+    NkPathServiceInvalidate(actSvc);
+    while (actSvc->mp_freeSearch != NULL) {
+        __NkInt_PathSearch *nextSearch = actSvc->mp_freeSearch->mp_nextSearch;
+
+        NkGPFree(actSvc->mp_freeSearch);
+        actSvc->mp_freeSearch = nextSearch;
+    }
+    NK_DESTROYLOCK(actSvc->m_mtxLock);
+
+    NkGPFree(actSvc);
+    *svcPtr = NULL;
+}
+
+NkVoid NK_CALL NkPathServiceInvalidate(_Inout_ NkPathService *svcPtr) {
+    NK_ASSERT(svcPtr != NULL, NkErr_InOutParameter);
+
+    for (NkUint32 i = 0; i < svcPtr->m_svcSpec.m_nCacheSlots; i++) {
+        if (svcPtr->mp_cacheArr[i] == NULL)
+            continue;
+
+        __NkInt_PathResult_Release(svcPtr->mp_cacheArr[i]);
+        svcPtr->mp_cacheArr[i] = NULL;
+    }
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkPathFind(
+    _Inout_   NkPathService *svcPtr,
+    _In_      NkPoint2D startPos,
+    _In_      NkPoint2D goalPos,
+    _Outptr_  NkPathResult **resPtr,
+    _Out_opt_ NkUint32 *firstIndPtr
+) {
+    NK_ASSERT(svcPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    NkPoint2D const startChunk = NkChunkStreamerGetChunkPos(svcPtr->m_svcSpec.mp_chunkStr, startPos);
+    NkUint32 const  slotInd    = __NkInt_PathService_Hash(
+        svcPtr,
+        startChunk.m_xCoord,
+        startChunk.m_yCoord,
+        goalPos.m_xCoord,
+        goalPos.m_yCoord
+    );
+    if (firstIndPtr != NULL)
+        *firstIndPtr = 0;
+
+    /*
+     * Agents following a path keep asking for the same goal from the next tile. As long
+     * as they stay on the cached path, hand out that path instead of searching again.
+     */
+    NkPathResult *cachedRes = svcPtr->mp_cacheArr[slotInd];
+    if (cachedRes != NULL && !cachedRes->m_isFlowField
+        && cachedRes->m_goalPos.m_xCoord == goalPos.m_xCoord && cachedRes->m_goalPos.m_yCoord == goalPos.m_yCoord
+    ) {
+        NkPoint2D const cachedChunk = NkChunkStreamerGetChunkPos(svcPtr->m_svcSpec.mp_chunkStr, cachedRes->m_startPos);
+        NkBoolean       isHit       = cachedRes->m_startPos.m_xCoord == startPos.m_xCoord
+            && cachedRes->m_startPos.m_yCoord == startPos.m_yCoord
+        ;
+
+        if (!isHit && cachedChunk.m_xCoord == startChunk.m_xCoord && cachedChunk.m_yCoord == startChunk.m_yCoord
+            && NkPathResultGetStatus(cachedRes) == NkPathSt_Found
+        ) {
+            for (NkUint32 i = 0; i < cachedRes->m_nTiles; i++) {
+                NkPoint2D const *tilePtr = &cachedRes->mp_tileArr[i];
+                if (tilePtr->m_xCoord != startPos.m_xCoord || tilePtr->m_yCoord != startPos.m_yCoord)
+                    continue;
+
+                if (firstIndPtr != NULL)
+                    *firstIndPtr = i;
+                isHit = NK_TRUE;
+                break;
+            }
+        }
+
+        if (isHit) {
+            NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&cachedRes->m_refCount));
+
+            *resPtr = cachedRes;
+            return NkErr_Ok;
+        }
+    }
+
+    /* Fit a window around start and goal; if impossible, the result fails right away. */
+    NkPoint2D winOrigin;
+    NkUint32  extX, extY;
+    if (!__NkInt_PathService_FitAxis(svcPtr->m_svcSpec.m_maxExt, startPos.m_xCoord, goalPos.m_xCoord, &winOrigin.m_xCoord, &extX)
+        || !__NkInt_PathService_FitAxis(svcPtr->m_svcSpec.m_maxExt, startPos.m_yCoord, goalPos.m_yCoord, &winOrigin.m_yCoord, &extY)
+    )
+        extX = extY = 0;
+
+    NkErrorCode const errCode = __NkInt_PathService_StartSearch(svcPtr, NK_FALSE, startPos, goalPos, winOrigin, extX, extY, resPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    __NkInt_PathService_CacheResult(svcPtr, slotInd, *resPtr);
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkPathFindFlowField(
+    _Inout_  NkPathService *svcPtr,
+    _In_     NkPoint2D goalPos,
+    _Outptr_ NkPathResult **resPtr
+) {
+    NK_ASSERT(svcPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    NkUint32 const slotInd   = __NkInt_PathService_Hash(svcPtr, goalPos.m_xCoord, goalPos.m_yCoord, 0, 1);
+    NkPathResult  *cachedRes = svcPtr->mp_cacheArr[slotInd];
+    if (cachedRes != NULL && cachedRes->m_isFlowField
+        && cachedRes->m_goalPos.m_xCoord == goalPos.m_xCoord && cachedRes->m_goalPos.m_yCoord == goalPos.m_yCoord
+    ) {
+        NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&cachedRes->m_refCount));
+
+        *resPtr = cachedRes;
+        return NkErr_Ok;
+    }
+
+    NkUint32 const  maxExt    = svcPtr->m_svcSpec.m_maxExt;
+    NkPoint2D const winOrigin = { goalPos.m_xCoord - maxExt / 2, goalPos.m_yCoord - maxExt / 2 };
+    NkErrorCode const errCode = __NkInt_PathService_StartSearch(svcPtr, NK_TRUE, goalPos, goalPos, winOrigin, maxExt, maxExt, resPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    __NkInt_PathService_CacheResult(svcPtr, slotInd, *resPtr);
+    return NkErr_Ok;
+}
+
+
+NkPathStatus NK_CALL NkPathResultGetStatus(_In_ NkPathResult const *resPtr) {
+    NK_ASSERT(resPtr != NULL, NkErr_InParameter);
+
+    return (NkPathStatus)InterlockedCompareExchange((LONG volatile *)&resPtr->m_resStatus, 0, 0);
+}
+
+NkPoint2D const *NK_CALL NkPathResultGetTiles(_In_ NkPathResult const *resPtr, _Out_ NkUint32 *nTilesPtr) {
+    NK_ASSERT(resPtr != NULL && !resPtr->m_isFlowField, NkErr_InParameter);
+    NK_ASSERT(nTilesPtr != NULL, NkErr_OutParameter);
+
+    if (NkPathResultGetStatus(resPtr) != NkPathSt_Found) {
+        *nTilesPtr = 0;
+
+        return NULL;
+    }
+
+    *nTilesPtr = resPtr->m_nTiles;
+    return resPtr->mp_tileArr;
+}
+
+NkPoint2D NK_CALL NkPathResultGetFlowDir(_In_ NkPathResult const *resPtr, _In_ NkPoint2D tilePos) {
+    NK_ASSERT(resPtr != NULL && resPtr->m_isFlowField, NkErr_InParameter);
+
+    NkInt64 const localX = tilePos.m_xCoord - resPtr->m_winOrigin.m_xCoord;
+    NkInt64 const localY = tilePos.m_yCoord - resPtr->m_winOrigin.m_yCoord;
+    if (NkPathResultGetStatus(resPtr) != NkPathSt_Found
+        || localX < 0 || localY < 0 || localX >= (NkInt64)resPtr->m_extX || localY >= (NkInt64)resPtr->m_extY
+    )
+        return (NkPoint2D){ 0, 0 };
+
+    NkUint8 const dirInd = resPtr->mp_dirArr[(NkSize)localY * resPtr->m_extX + localX];
+    return dirInd == __NkInt_PathService_NoDir ? (NkPoint2D){ 0, 0 } : gl_c_PathDirs[dirInd];
+}
+
+NkVoid NK_CALL NkPathResultRelease(_Uninit_ptr_ NkPathResult **resPtr) {
+    NK_ASSERT(resPtr != NULL, NkErr_InOutParameter);
+
+    if (*resPtr != NULL)
+        __NkInt_PathResult_Release(*resPtr);
+    *resPtr = NULL;
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -0,0 +1,809 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  perfoverlay.c
+ * \brief implements the performance overlay, that is, a debug layer that is drawn on top
+ *        of all other layers and shows frame timings and engine statistics
+ *
+ * The overlay shows a graph of the frame times of the last frames. Every bar is colored
+ * by what most likely caused the frame to take long: red bars mark frames in which the
+ * main loop had to catch up on more than one fixed update, yellow bars mark frames that
+ * took considerably longer than the target frame time otherwise. Below the graph, the
+ * number of fixed updates per frame, the times spent in the main loop phases as measured
+ * by the profiler, the occupancy of the pool allocator, the size of the asset cache, and
+ * the draw calls and timings reported by the renderer are printed. The overlay is toggled using F3.
+ *
+ * There are no text primitives in the renderer, so the overlay builds a small texture
+ * atlas with a built-in 3 x 5 pixel font and a couple of solid colors on start-up and
+ * draws everything as a single texture batch.
+ */
+#define NK_NAMESPACE "nk::perfoverlay"
+
+
+/* stdlib includes */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+/* Noriko includes */
+#include <include/Noriko/layer.h>
+#include <include/Noriko/nkom.h>
+#include <include/Noriko/renderer.h>
+#include <include/Noriko/window.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/timer.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/asset.h>
+#include <include/Noriko/profiler.h>
+#include <include/Noriko/noriko.h>
+#include <include/Noriko/comp.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \brief number of frames shown in the frame time graph
+ */
+#define __NkInt_PerfOverlay_HistSize  ((NkUint32)(120))
+/**
+ * \brief maximum number of rectangles drawn per frame
+ */
+#define __NkInt_PerfOverlay_MaxRects  ((NkSize)(512))
+/**
+ * \brief number of text rows below the graph
+ */
+#define __NkInt_PerfOverlay_NumRows   ((NkUint32)(8))
+/**
+ * \brief extents of a glyph cell in the atlas, in pixels (3 x 5 glyph plus spacing)
+ */
+#define __NkInt_PerfOverlay_CellW     ((NkUint32)(4))
+#define __NkInt_PerfOverlay_CellH     ((NkUint32)(6))
+/**
+ * \brief factor glyphs are scaled by when drawn
+ */
+#define __NkInt_PerfOverlay_TextScale (2.f)
+/**
+ * \brief height of a text row on screen, in pixels
+ */
+#define __NkInt_PerfOverlay_RowH      (14.f)
+/**
+ * \brief width of a single bar of the frame time graph, in pixels
+ */
+#define __NkInt_PerfOverlay_BarW      (2.f)
+/**
+ * \brief height of the frame time graph, in pixels; the graph covers twice the target
+ *        frame time
+ */
+#define __NkInt_PerfOverlay_GraphH    (64.f)
+/**
+ * \brief position of the overlay and padding between its contents, in pixels
+ */
+#define __NkInt_PerfOverlay_PosX      (8.f)
+#define __NkInt_PerfOverlay_PosY      (8.f)
+#define __NkInt_PerfOverlay_Padding   (6.f)
+
+/**
+ * \brief packs the five rows of a glyph into a single integer
+ *
+ * Each row is given as a number in <tt>[0, 7]</tt>, the highest bit being the left-most
+ * pixel, so it is best to read the arguments in octal.
+ */
+#define __NkInt_PerfOverlay_Glyph(r0, r1, r2, r3, r4) \
+    ((NkUint16)((r0) << 12 | (r1) << 9 | (r2) << 6 | (r3) << 3 | (r4)))
+
+
+/**
+ * \brief characters the built-in font supports, in atlas order
+ * \note  Lower-case letters are printed as upper-case ones; all other characters are
+ *        printed as spaces.
+ */
+NK_INTERNAL char const gl_c_PerfOverlayGlyphChars[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:/%-";
+/**
+ * \brief glyphs of the built-in font, in the same order as <tt>gl_c_PerfOverlayGlyphChars</tt>
+ */
+NK_INTERNAL NkUint16 const gl_c_PerfOverlayGlyphs[] = {
+    __NkInt_PerfOverlay_Glyph(0, 0, 0, 0, 0), /* ' ' */
+    __NkInt_PerfOverlay_Glyph(7, 5, 5, 5, 7), /* '0' */
+    __NkInt_PerfOverlay_Glyph(2, 6, 2, 2, 7), /* '1' */
+    __NkInt_PerfOverlay_Glyph(7, 1, 7, 4, 7), /* '2' */
+    __NkInt_PerfOverlay_Glyph(7, 1, 7, 1, 7), /* '3' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 7, 1, 1), /* '4' */
+    __NkInt_PerfOverlay_Glyph(7, 4, 7, 1, 7), /* '5' */
+    __NkInt_PerfOverlay_Glyph(7, 4, 7, 5, 7), /* '6' */
+    __NkInt_PerfOverlay_Glyph(7, 1, 1, 1, 1), /* '7' */
+    __NkInt_PerfOverlay_Glyph(7, 5, 7, 5, 7), /* '8' */
+    __NkInt_PerfOverlay_Glyph(7, 5, 7, 1, 7), /* '9' */
+    __NkInt_PerfOverlay_Glyph(2, 5, 7, 5, 5), /* 'A' */
+    __NkInt_PerfOverlay_Glyph(6, 5, 6, 5, 6), /* 'B' */
+    __NkInt_PerfOverlay_Glyph(3, 4, 4, 4, 3), /* 'C' */
+    __NkInt_PerfOverlay_Glyph(6, 5, 5, 5, 6), /* 'D' */
+    __NkInt_PerfOverlay_Glyph(7, 4, 6, 4, 7), /* 'E' */
+    __NkInt_PerfOverlay_Glyph(7, 4, 6, 4, 4), /* 'F' */
+    __NkInt_PerfOverlay_Glyph(3, 4, 5, 5, 3), /* 'G' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 7, 5, 5), /* 'H' */
+    __NkInt_PerfOverlay_Glyph(7, 2, 2, 2, 7), /* 'I' */
+    __NkInt_PerfOverlay_Glyph(1, 1, 1, 5, 2), /* 'J' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 6, 5, 5), /* 'K' */
+    __NkInt_PerfOverlay_Glyph(4, 4, 4, 4, 7), /* 'L' */
+    __NkInt_PerfOverlay_Glyph(5, 7, 7, 5, 5), /* 'M' */
+    __NkInt_PerfOverlay_Glyph(6, 5, 5, 5, 5), /* 'N' */
+    __NkInt_PerfOverlay_Glyph(2, 5, 5, 5, 2), /* 'O' */
+    __NkInt_PerfOverlay_Glyph(6, 5, 6, 4, 4), /* 'P' */
+    __NkInt_PerfOverlay_Glyph(2, 5, 5, 6, 3), /* 'Q' */
+    __NkInt_PerfOverlay_Glyph(6, 5, 6, 5, 5), /* 'R' */
+    __NkInt_PerfOverlay_Glyph(3, 4, 2, 1, 6), /* 'S' */
+    __NkInt_PerfOverlay_Glyph(7, 2, 2, 2, 2), /* 'T' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 5, 5, 7), /* 'U' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 5, 5, 2), /* 'V' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 7, 7, 5), /* 'W' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 2, 5, 5), /* 'X' */
+    __NkInt_PerfOverlay_Glyph(5, 5, 2, 2, 2), /* 'Y' */
+    __NkInt_PerfOverlay_Glyph(7, 1, 2, 4, 7), /* 'Z' */
+    __NkInt_PerfOverlay_Glyph(0, 0, 0, 0, 2), /* '.' */
+    __NkInt_PerfOverlay_Glyph(0, 2, 0, 2, 0), /* ':' */
+    __NkInt_PerfOverlay_Glyph(1, 1, 2, 4, 4), /* '/' */
+    __NkInt_PerfOverlay_Glyph(5, 1, 2, 4, 5), /* '%' */
+    __NkInt_PerfOverlay_Glyph(0, 0, 7, 0, 0)  /* '-' */
+};
+static_assert(
+    NK_ARRAYSIZE(gl_c_PerfOverlayGlyphs) == NK_ARRAYSIZE(gl_c_PerfOverlayGlyphChars) - 1,
+    "Mismatch between glyphs and glyph characters. Check definitions."
+);
+
+
+/**
+ * \enum  __NkInt_PerfOverlaySwatch
+ * \brief solid colors that are placed in the atlas behind the glyphs
+ */
+NK_NATIVE typedef enum __NkInt_PerfOverlaySwatch {
+    __NkInt_PerfOvSw_Panel, /**< panel background (also the background of the glyphs) */
+    __NkInt_PerfOvSw_Good,  /**< frame within budget */
+    __NkInt_PerfOvSw_Slow,  /**< frame took considerably longer than the target time */
+    __NkInt_PerfOvSw_Lag,   /**< frame had to catch up on multiple fixed updates */
+    __NkInt_PerfOvSw_Line,  /**< target frame time reference line */
+
+    __NkInt_PerfOvSw_Count__
+} __NkInt_PerfOverlaySwatch;
+
+/**
+ * \brief colors of the swatches, in the same order as <tt>__NkInt_PerfOverlaySwatch</tt>
+ */
+NK_INTERNAL NkRgbaColor const gl_c_PerfOverlaySwatchCols[] = {
+    NK_MAKE_RGB( 16,  16,  24),
+    NK_MAKE_RGB( 64, 200,  64),
+    NK_MAKE_RGB(230, 200,  40),
+    NK_MAKE_RGB(230,  50,  50),
+    NK_MAKE_RGB(128, 128, 160)
+};
+NK_VERIFY_LUT(gl_c_PerfOverlaySwatchCols, __NkInt_PerfOverlaySwatch, __NkInt_PerfOvSw_Count__);
+
+
+/**
+ * \struct __NkInt_PerfOverlayFrame
+ * \brief  represents a single entry in the frame history of the overlay
+ */
+NK_NATIVE typedef struct __NkInt_PerfOverlayFrame {
+    NkFloat  m_frameTime; /**< time between the start of the frame and the next one, in ms */
+    NkUint32 m_nSteps;    /**< number of fixed updates run in the frame */
+} __NkInt_PerfOverlayFrame;
+
+/**
+ * \struct __NkInt_PerfOverlay
+ * \brief  represents the performance overlay layer
+ */
+NK_NATIVE typedef struct __NkInt_PerfOverlay {
+    NKOM_IMPLEMENTS(NkILayer);
+
+    NkIWindow                *mp_rdTarget;  /**< cached reference to the render window */
+    NkIRenderer              *mp_rdRef;     /**< cached reference to the window's renderer */
+    NkIAssetManager          *mp_assetMgr;  /**< cached reference to the asset manager */
+    NkRendererResource       *mp_atlasTex;  /**< font and color atlas */
+    NkBoolean                 m_isVisible;  /**< whether the overlay is shown */
+    NkUint64                  m_prevTicks;  /**< time of the last per-frame update */
+    NkUint32                  m_currSteps;  /**< fixed updates run since the last per-frame update */
+    NkUint32                  m_histInd;    /**< index of the next history entry to write */
+    NkUint32                  m_histCount;  /**< number of valid history entries */
+    __NkInt_PerfOverlayFrame  m_frameHist[__NkInt_PerfOverlay_HistSize];
+
+    NkSize                    m_nRects;     /**< number of rectangles queued for the current frame */
+    NkRectF                   m_dstRects[__NkInt_PerfOverlay_MaxRects];
+    NkRectF                   m_srcRects[__NkInt_PerfOverlay_MaxRects];
+    NkProfileZoneStats        m_zoneStats[NK_PROFILE_MAXZONES];
+} __NkInt_PerfOverlay;
+
+
+/**
+ * \brief  looks up the atlas index of the given character
+ * \param  [in] charVal character that is to be looked up
+ * \return index of the glyph; \c 0 (space) if the character is not supported
+ */
+NK_INTERNAL NkUint32 __NkInt_PerfOverlay_GetGlyphIndex(_In_ char charVal) {
+    char const upperVal = (char)toupper((unsigned char)charVal);
+    if (upperVal == '\0')
+        return 0;
+
+    char const *posPtr = strchr(gl_c_PerfOverlayGlyphChars, upperVal);
+    return posPtr != NULL ? (NkUint32)(posPtr - gl_c_PerfOverlayGlyphChars) : 0;
+}
+
+/**
+ * \brief writes a single pixel into a 24-bit bottom-up bitmap
+ * \param [in, out] pxArray pixel array of the bitmap
+ * \param [in] bmpSpec specification of the bitmap
+ * \param [in] xPos x-coordinate of the pixel, from the left
+ * \param [in] yPos y-coordinate of the pixel, from the top
+ * \param [in] pxCol color of the pixel
+ */
+NK_INTERNAL NkVoid __NkInt_PerfOverlay_PutPixel(
+    _Inout_ NkByte *pxArray,
+    _In_    NkBitmapSpecification const *bmpSpec,
+    _In_    NkUint32 xPos,
+    _In_    NkUint32 yPos,
+    _In_    NkRgbaColor pxCol
+) {
+    NkByte *pxPtr = pxArray + (NkSize)((NkUint32)bmpSpec->m_bmpHeight - 1 - yPos) * bmpSpec->m_bmpStride + xPos * 3;
+
+    pxPtr[0] = pxCol.m_bVal;
+    pxPtr[1] = pxCol.m_gVal;
+    pxPtr[2] = pxCol.m_rVal;
+}
+
+/**
+ * \brief  builds the font and color atlas and creates a texture from it
+ * \param  [in, out] rdRef renderer that is to create the texture
+ * \param  [out] resPtr pointer to a variable that receives the texture
+ * \return \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   The atlas is a single row of glyph cells, followed by one column of pixels for each
+ *   swatch. Glyphs are drawn in white on the panel color so that no mask is needed.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_PerfOverlay_CreateAtlas(
+    _Inout_    NkIRenderer *rdRef,
+    _Init_ptr_ NkRendererResource **resPtr
+) {
+    NkUint32 const nGlyphs  = (NkUint32)NK_ARRAYSIZE(gl_c_PerfOverlayGlyphs);
+    NkRgbaColor    panelCol = gl_c_PerfOverlaySwatchCols[__NkInt_PerfOvSw_Panel];
+
+    /* Create the bitmap, filled with the panel color. */
+    NkDIBitmap atlasBmp;
+    NkErrorCode errCode = NkDIBitmapCreate(&(NkBitmapSpecification){
+        .m_structSize = sizeof(NkBitmapSpecification),
+        .m_bmpWidth   = (NkInt32)(nGlyphs * __NkInt_PerfOverlay_CellW + __NkInt_PerfOvSw_Count__),
+        .m_bmpHeight  = (NkInt32)__NkInt_PerfOverlay_CellH,
+        .m_bitsPerPx  = 24,
+        .m_bmpFlags   = NkBmpFlag_None
+    }, &panelCol, &atlasBmp);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkBitmapSpecification const *bmpSpec = NkDIBitmapGetSpecification(&atlasBmp);
+    NkByte                      *pxArray = NkDIBitmapGetPixels(&atlasBmp, NULL);
+
+    /* Rasterize the glyphs. */
+    for (NkUint32 i = 0; i < nGlyphs; i++)
+        for (NkUint32 y = 0; y < 5; y++)
+            for (NkUint32 x = 0; x < 3; x++)
+                if (gl_c_PerfOverlayGlyphs[i] >> ((4 - y) * 3 + (2 - x)) & 1)
+                    __NkInt_PerfOverlay_PutPixel(
+                        pxArray,
+                        bmpSpec,
+                        i * __NkInt_PerfOverlay_CellW + x,
+                        y,
+                        (NkRgbaColor)NK_MAKE_RGB(255, 255, 255)
+                    );
+
+    /* Add the swatches. */
+    for (NkUint32 i = 0; i < __NkInt_PerfOvSw_Count__; i++)
+        for (NkUint32 y = 0; y < __NkInt_PerfOverlay_CellH; y++)
+            __NkInt_PerfOverlay_PutPixel(pxArray, bmpSpec, nGlyphs * __NkInt_PerfOverlay_CellW + i, y, gl_c_PerfOverlaySwatchCols[i]);
+
+    /* Upload the atlas; the bitmap is not needed anymore afterwards. */
+    errCode = rdRef->VT->CreateTexture(rdRef, &atlasBmp, resPtr);
+    NkDIBitmapDestroy(&atlasBmp);
+    return errCode;
+}
+
+/**
+ * \brief queues a rectangle for drawing
+ * \param [in, out] self overlay instance
+ * \param [in] dstRect destination rectangle, in screen space
+ * \param [in] srcRect source rectangle, in atlas space
+ * \note  If the queue is full, the rectangle is dropped.
+ */
+NK_INTERNAL NkVoid __NkInt_PerfOverlay_PushRect(
+    _Inout_ __NkInt_PerfOverlay *self,
+    _In_    NkRectF dstRect,
+    _In_    NkRectF srcRect
+) {
+    if (self->m_nRects == __NkInt_PerfOverlay_MaxRects)
+        return;
+
+    self->m_dstRects[self->m_nRects] = dstRect;
+    self->m_srcRects[self->m_nRects] = srcRect;
+    ++self->m_nRects;
+}
+
+/**
+ * \brief queues a solid rectangle in the given swatch color for drawing
+ * \param [in, out] self overlay instance
+ * \param [in] dstRect destination rectangle, in screen space
+ * \param [in] swatchId color of the rectangle
+ */
+NK_INTERNAL NkVoid __NkInt_PerfOverlay_PushFill(
+    _Inout_ __NkInt_PerfOverlay *self,
+    _In_    NkRectF dstRect,
+    _In_    __NkInt_PerfOverlaySwatch swatchId
+) {
+    NkFloat const swatchX = (NkFloat)(NK_ARRAYSIZE(gl_c_PerfOverlayGlyphs) * __NkInt_PerfOverlay_CellW + swatchId);
+
+    /* Stretch the single-pixel wide swatch over the rectangle. */
+    __NkInt_PerfOverlay_PushRect(self, dstRect, (NkRectF){ swatchX, 0.f, 1.f, 1.f });
+}
+
+/**
+ * \brief formats a line of text and queues its glyphs for drawing
+ * \param [in, out] self overlay instance
+ * \param [in] rowInd index of the text row below the graph
+ * \param [in] fmtStr format string, followed by the format arguments
+ */
+NK_INTERNAL NkVoid __NkInt_PerfOverlay_PrintRow(
+    _Inout_                 __NkInt_PerfOverlay *self,
+    _In_                    NkUint32 rowInd,
+    _Printf_format_string_  char const *fmtStr,
+    ...
+) {
+    char    lineBuf[64];
+    va_list vlArgs;
+
+    va_start(vlArgs, fmtStr);
+    NK_IGNORE_RETURN_VALUE(vsnprintf(lineBuf, sizeof lineBuf, fmtStr, vlArgs));
+    va_end(vlArgs);
+
+    NkFloat const xPos = __NkInt_PerfOverlay_PosX + __NkInt_PerfOverlay_Padding;
+    NkFloat const yPos = __NkInt_PerfOverlay_PosY + 2.f * __NkInt_PerfOverlay_Padding
+        + __NkInt_PerfOverlay_GraphH + (NkFloat)rowInd * __NkInt_PerfOverlay_RowH
+    ;
+
+    /*
+     * Spaces are skipped since the panel is already drawn in the background color. Text
+     * that does not fit onto the panel is cut off.
+     */
+    NkUint32 const maxChars = (NkUint32)(
+        (NkFloat)__NkInt_PerfOverlay_HistSize * __NkInt_PerfOverlay_BarW
+            / ((NkFloat)__NkInt_PerfOverlay_CellW * __NkInt_PerfOverlay_TextScale)
+    );
+    for (NkUint32 i = 0; i < maxChars && lineBuf[i] != '\0'; i++) {
+        NkUint32 const glyphInd = __NkInt_PerfOverlay_GetGlyphIndex(lineBuf[i]);
+        if (glyphInd == 0)
+            continue;
+
+        __NkInt_PerfOverlay_PushRect(self,
+            (NkRectF){
+                xPos + (NkFloat)(i * __NkInt_PerfOverlay_CellW) * __NkInt_PerfOverlay_TextScale,
+                yPos,
+                (NkFloat)__NkInt_PerfOverlay_CellW * __NkInt_PerfOverlay_TextScale,
+                (NkFloat)__NkInt_PerfOverlay_CellH * __NkInt_PerfOverlay_TextScale
+            },
+            (NkRectF){
+                (NkFloat)(glyphInd * __NkInt_PerfOverlay_CellW),
+                0.f,
+                (NkFloat)__NkInt_PerfOverlay_CellW,
+                (NkFloat)__NkInt_PerfOverlay_CellH
+            }
+        );
+    }
+}
+
+/**
+ * \brief  retrieves the time spent in the given top-level profiler zone last frame
+ * \param  [in] self overlay instance
+ * \param  [in] nZones number of valid entries in the zone statistics
+ * \param  [in] zoneName name of the zone
+ * \return time in milliseconds; \c 0 if the zone has not been recorded
+ */
+NK_INTERNAL NkDouble __NkInt_PerfOverlay_GetZoneTime(
+    _In_   __NkInt_PerfOverlay const *self,
+    _In_   NkUint32 nZones,
+    _In_z_ char const *zoneName
+) {
+    for (NkUint32 i = 0; i < nZones; i++)
+        if (self->m_zoneStats[i].m_parentInd == -1 && strcmp(self->m_zoneStats[i].mp_zoneName, zoneName) == 0)
+            return self->m_zoneStats[i].m_lastTime;
+
+    return 0.;
+}
+
+/**
+ * \brief  retrieves the target frame time of the application
+ * \return target frame time, in milliseconds
+ * \note   If the frame rate is not limited, 60 frames per second are assumed.
+ */
+NK_INTERNAL NkFloat __NkInt_PerfOverlay_GetTargetTime(NkVoid) {
+    NkUint32 const targetFps = NkApplicationQuerySpecification()->m_targetFps;
+
+    return 1000.f / (NkFloat)(targetFps > 0 ? targetFps : 60);
+}
+
+/**
+ */
+NK_INTERNAL NkVoid __NkInt_PerfOverlay_DeleteResources(_Inout_ __NkInt_PerfOverlay *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Delete the atlas. */
+    NK_IGNORE_RETURN_VALUE(self->mp_rdRef->VT->DeleteResource(self->mp_rdRef, &self->mp_atlasTex));
+
+    /* Release asset manager, renderer, and window. */
+    if (self->mp_assetMgr != NULL)
+        self->mp_assetMgr->VT->Release(self->mp_assetMgr);
+    self->mp_rdRef->VT->Release(self->mp_rdRef);
+    self->mp_rdTarget->VT->Release(self->mp_rdTarget);
+}
+
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_PerfOverlay_AddRef(_Inout_ NkILayer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Stub. */
+    return 1;
+}
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_PerfOverlay_Release(_Inout_ NkILayer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Same as above. */
+    return 1;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_PerfOverlay_QueryInterface(
+    _Inout_  NkILayer *self,
+    _In_     NkUuid const *iId,
+    _Outptr_ NkVoid **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(iId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    /* Define interface table for this class. */
+    NK_INTERNAL NkOMImplementationInfo const gl_ImplInfos[] = {
+        { NKOM_IIDOF(NkIBase)  },
+        { NKOM_IIDOF(NkILayer) },
+        { NULL                 }
+    };
+
+    if (NkOMQueryImplementationIndex(gl_ImplInfos, iId) != SIZE_MAX) {
+        /* Interface is implemented. */
+        *resPtr = (NkVoid *)self;
+
+        __NkInt_PerfOverlay_AddRef(self);
+        return NkErr_Ok;
+    }
+
+    /* Interface not implemented. */
+    *resPtr = NULL;
+    return NkErr_InterfaceNotImpl;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_PerfOverlay_OnPush(
+    _Inout_  NkILayer *self,
+    _In_opt_ NkILayer const *beforeRef,
+    _In_opt_ NkILayer const *afterRef,
+    _In_     NkSize index
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(index);
+    NK_UNREFERENCED_PARAMETER(beforeRef);
+    NK_UNREFERENCED_PARAMETER(afterRef);
+
+    /* Get internal structure of the overlay. */
+    __NkInt_PerfOverlay *actOverlay = (__NkInt_PerfOverlay *)self;
+
+    /* Query renderer and create the atlas. */
+    NkIWindow   *mainWnd = (NkIWindow *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIWindow));
+    NkIRenderer *mainRd  = mainWnd->VT->GetRenderer(mainWnd);
+
+    NkRendererResource *atlasTex = NULL;
+    NkErrorCode errCode = __NkInt_PerfOverlay_CreateAtlas(mainRd, &atlasTex);
+    if (errCode != NkErr_Ok) {
+        NK_LOG_ERROR("Failed to create performance overlay atlas. Reason: %s (%i)", NkGetErrorCodeStr(errCode)->mp_dataPtr, (int)errCode);
+
+        mainRd->VT->Release(mainRd);
+        mainWnd->VT->Release(mainWnd);
+        return errCode;
+    }
+
+    /* Initialize instance. The overlay starts hidden. */
+    actOverlay->mp_rdTarget = mainWnd;
+    actOverlay->mp_rdRef    = mainRd;
+    actOverlay->mp_assetMgr = (NkIAssetManager *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIAssetManager));
+    actOverlay->mp_atlasTex = atlasTex;
+    actOverlay->m_isVisible = NK_FALSE;
+    actOverlay->m_prevTicks = NkTimerGetCurrentTicks();
+    actOverlay->m_currSteps = 0;
+    actOverlay->m_histInd   = 0;
+    actOverlay->m_histCount = 0;
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_PerfOverlay_OnPop(_Inout_ NkILayer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Resources are deleted by the component shutdown function. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_PerfOverlay_OnEvent(
+    _Inout_ NkILayer *self,
+    _In_    NkEvent const *evPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(evPtr != NULL, NkErr_InParameter);
+
+    /* Get internal structure of the overlay. */
+    __NkInt_PerfOverlay *actOverlay = (__NkInt_PerfOverlay *)self;
+
+    /* Toggle the overlay. */
+    if (evPtr->m_evType == NkEv_KeyboardKeyDown && evPtr->m_kbEvent.m_vKeyCode == NkKey_F3) {
+        actOverlay->m_isVisible = !actOverlay->m_isVisible;
+
+        /* Make sure the overlay appears or disappears in on-demand mode, too. */
+        NkApplicationRequestRedraw();
+        return NkErr_Ok;
+    }
+
+    /* Event was not handled; pass it on to the layers below. */
+    return NkErr_NoOperation;
+}
+
+/**
+ */
+NK_INTERNAL NkEventCategory NK_CALL __NkInt_PerfOverlay_QueryEventCategories(_Inout_ NkILayer *self) {
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* The overlay only handles its toggle key. */
+    return NkEvCat_Keyboard;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_PerfOverlay_OnUpdate(_Inout_ NkILayer *self, _In_ NkFloat updTime) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(updTime);
+
+    /* Get internal structure of the overlay. */
+    __NkInt_PerfOverlay *actOverlay = (__NkInt_PerfOverlay *)self;
+
+    /*
+     * The per-frame update runs exactly once per frame, after the fixed updates. Measure
+     * the time since the last one ourselves; *updTime* is clamped by the main loop and
+     * would hide the very stutters the overlay is meant to show.
+     */
+    NkUint64 const currTicks = NkTimerGetCurrentTicks();
+    actOverlay->m_frameHist[actOverlay->m_histInd] = (__NkInt_PerfOverlayFrame){
+        .m_frameTime = (NkFloat)((NkDouble)(currTicks - actOverlay->m_prevTicks) * 1000. / (NkDouble)NkTimerGetFrequency()),
+        .m_nSteps    = actOverlay->m_currSteps
+    };
+    actOverlay->m_histInd   = (actOverlay->m_histInd + 1) % __NkInt_PerfOverlay_HistSize;
+    actOverlay->m_histCount = NK_MIN(actOverlay->m_histCount + 1, __NkInt_PerfOverlay_HistSize);
+    actOverlay->m_prevTicks = currTicks;
+    actOverlay->m_currSteps = 0;
+
+    /* Keep the graph moving in on-demand mode. */
+    if (actOverlay->m_isVisible)
+        NkApplicationRequestRedraw();
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_PerfOverlay_OnFixedUpdate(_Inout_ NkILayer *self, _In_ NkFloat updTime) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(updTime);
+
+    /* Count the fixed updates of the current frame. */
+    ++((__NkInt_PerfOverlay *)self)->m_currSteps;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_PerfOverlay_OnRender(_Inout_ NkILayer *self, _In_ NkFloat aheadBy) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(aheadBy);
+
+    /* Get internal structure of the overlay. */
+    __NkInt_PerfOverlay *actOverlay = (__NkInt_PerfOverlay *)self;
+    if (!actOverlay->m_isVisible)
+        return NkErr_Ok;
+    actOverlay->m_nRects = 0;
+
+    NkFloat const targetTime = __NkInt_PerfOverlay_GetTargetTime();
+    NkFloat const graphX     = __NkInt_PerfOverlay_PosX + __NkInt_PerfOverlay_Padding;
+    NkFloat const graphY     = __NkInt_PerfOverlay_PosY + __NkInt_PerfOverlay_Padding;
+    NkFloat const graphW     = (NkFloat)__NkInt_PerfOverlay_HistSize * __NkInt_PerfOverlay_BarW;
+
+    /* Draw the panel. */
+    __NkInt_PerfOverlay_PushFill(actOverlay, (NkRectF){
+        __NkInt_PerfOverlay_PosX,
+        __NkInt_PerfOverlay_PosY,
+        graphW + 2.f * __NkInt_PerfOverlay_Padding,
+        3.f * __NkInt_PerfOverlay_Padding + __NkInt_PerfOverlay_GraphH + (NkFloat)__NkInt_PerfOverlay_NumRows * __NkInt_PerfOverlay_RowH
+    }, __NkInt_PerfOvSw_Panel);
+
+    /*
+     * Draw the frame time graph, oldest frame first. The graph covers twice the target
+     * frame time; longer frames are cut off.
+     */
+    NkFloat  maxTime   = 0.f;
+    NkUint32 maxSteps  = 0;
+    NkUint32 nCatchUps = 0;
+    for (NkUint32 i = 0; i < actOverlay->m_histCount; i++) {
+        NkUint32 const entInd = (actOverlay->m_histInd + __NkInt_PerfOverlay_HistSize - actOverlay->m_histCount + i) % __NkInt_PerfOverlay_HistSize;
+        __NkInt_PerfOverlayFrame const *entPtr = &actOverlay->m_frameHist[entInd];
+
+        maxTime    = NK_MAX(maxTime, entPtr->m_frameTime);
+        maxSteps   = NK_MAX(maxSteps, entPtr->m_nSteps);
+        nCatchUps += entPtr->m_nSteps > 1;
+
+        NkFloat const barH = NK_MAX(1.f, NK_MIN(entPtr->m_frameTime / (2.f * targetTime), 1.f) * __NkInt_PerfOverlay_GraphH);
+        __NkInt_PerfOverlay_PushFill(actOverlay, (NkRectF){
+            graphX + (NkFloat)(__NkInt_PerfOverlay_HistSize - actOverlay->m_histCount + i) * __NkInt_PerfOverlay_BarW,
+            graphY + __NkInt_PerfOverlay_GraphH - barH,
+            __NkInt_PerfOverlay_BarW,
+            barH
+        }, entPtr->m_nSteps > 1
+            ? __NkInt_PerfOvSw_Lag
+            : entPtr->m_frameTime > 1.5f * targetTime ? __NkInt_PerfOvSw_Slow : __NkInt_PerfOvSw_Good
+        );
+    }
+    /* Mark the target frame time. */
+    __NkInt_PerfOverlay_PushFill(actOverlay, (NkRectF){
+        graphX,
+        graphY + __NkInt_PerfOverlay_GraphH / 2.f,
+        graphW,
+        1.f
+    }, __NkInt_PerfOvSw_Line);
+
+    /* Print the statistics. */
+    __NkInt_PerfOverlayFrame const *lastFrame = &actOverlay->m_frameHist[(actOverlay->m_histInd + __NkInt_PerfOverlay_HistSize - 1) % __NkInt_PerfOverlay_HistSize];
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 0, "FRAME %5.2f MS  MAX %5.2f", lastFrame->m_frameTime, maxTime);
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 1, "STEPS %u  MAX %u  CATCHUP %u", lastFrame->m_nSteps, maxSteps, nCatchUps);
+
+    NkUint32 const nZones = NkProfileQueryZones(actOverlay->m_zoneStats, NK_PROFILE_MAXZONES);
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 2, "FIX %5.2f  UPD %5.2f",
+        __NkInt_PerfOverlay_GetZoneTime(actOverlay, nZones, "FixedUpdate"),
+        __NkInt_PerfOverlay_GetZoneTime(actOverlay, nZones, "Update")
+    );
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 3, "RND %5.2f  WAIT %5.2f",
+        __NkInt_PerfOverlay_GetZoneTime(actOverlay, nZones, "Render"),
+        __NkInt_PerfOverlay_GetZoneTime(actOverlay, nZones, "Wait")
+    );
+
+    NkPoolStatistics poolStats;
+    NkPoolQueryStatistics(&poolStats);
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 4, "POOL %.0f/%.0f KB %3.0f%%",
+        (NkDouble)poolStats.m_usedBytes / 1024.,
+        (NkDouble)poolStats.m_totalBytes / 1024.,
+        poolStats.m_totalBytes > 0 ? 100. * (NkDouble)poolStats.m_usedBytes / (NkDouble)poolStats.m_totalBytes : 0.
+    );
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 5, "ASSETS %llu",
+        actOverlay->mp_assetMgr != NULL
+            ? (unsigned long long)actOverlay->mp_assetMgr->VT->QueryCacheCount(actOverlay->mp_assetMgr)
+            : 0ULL
+    );
+
+    NkRendererFrameStatistics rdStats;
+    actOverlay->mp_rdRef->VT->QueryFrameStatistics(actOverlay->mp_rdRef, &rdStats);
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 6, "BLT %u STR %u MSK %u ALP %u BIND %u",
+        rdStats.m_nBlits,
+        rdStats.m_nStretchBlits,
+        rdStats.m_nMaskBlits,
+        rdStats.m_nAlphaBlits,
+        rdStats.m_nTexBinds
+    );
+    __NkInt_PerfOverlay_PrintRow(actOverlay, 7, "DRAW %.2f  PRES %.2f  PX %lluK/%lluK",
+        rdStats.m_drawTime,
+        rdStats.m_presentTime,
+        (unsigned long long)(rdStats.m_nPxFilled / 1000U),
+        (unsigned long long)(rdStats.m_nPxPresented / 1000U)
+    );
+
+    /* Draw everything at once. */
+    return actOverlay->mp_rdRef->VT->DrawTextureBatch(
+        actOverlay->mp_rdRef,
+        actOverlay->mp_atlasTex,
+        actOverlay->m_nRects,
+        actOverlay->m_dstRects,
+        actOverlay->m_srcRects
+    );
+}
+
+
+/**
+ * \brief actual performance overlay instance
+ */
+NK_INTERNAL __NkInt_PerfOverlay gl_PerfOverlay = {
+    .NkILayer_Iface = {
+        .VT = &(struct __NkILayer_VTable__){
+            .AddRef               = &__NkInt_PerfOverlay_AddRef,
+            .Release              = &__NkInt_PerfOverlay_Release,
+            .QueryInterface       = &__NkInt_PerfOverlay_QueryInterface,
+            .OnPush               = &__NkInt_PerfOverlay_OnPush,
+            .OnPop                = &__NkInt_PerfOverlay_OnPop,
+            .OnEvent              = &__NkInt_PerfOverlay_OnEvent,
+            .QueryEventCategories = &__NkInt_PerfOverlay_QueryEventCategories,
+            .OnUpdate             = &__NkInt_PerfOverlay_OnUpdate,
+            .OnFixedUpdate        = &__NkInt_PerfOverlay_OnFixedUpdate,
+            .OnRender             = &__NkInt_PerfOverlay_OnRender
+        }
+    },
+    .mp_rdTarget = NULL,
+    .mp_rdRef    = NULL,
+    .mp_atlasTex = NULL
+};
+
+
+_Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(PerfOverlay)(NkVoid) {
+    /*
+     * Push the overlay to the top of the layer stack so that it's drawn over everything
+     * else and sees the input first.
+     */
+    return NkLayerstackPush((NkILayer *)&gl_PerfOverlay, NK_AS_OVERLAY);
+}
+
+_Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(PerfOverlay)(NkVoid) {
+    /* Retrieve the layer index. */
+    NkSize overlayIndex = NkLayerstackQueryIndex((NkILayer *)&gl_PerfOverlay);
+    if (overlayIndex == SIZE_MAX)
+        return NkErr_ArrayElemOutOfBounds;
+
+    /* Delete all resources. */
+    __NkInt_PerfOverlay_DeleteResources((__NkInt_PerfOverlay *)NkLayerstackPop(overlayIndex));
+    return NkErr_Ok;
+}
+
+
+/**
+ */
+NK_COMPONENT_DEFINE(PerfOverlay) {
+    .m_compUuid     = { 0x2f4c8a17, 0x5be3, 0x4d90, 0x9a61c3e07d5b28f4 },
+    .mp_clsId       = NULL,
+    .m_compIdent    = NK_MAKE_STRING_VIEW("performance overlay"),
+    .m_compFlags    = NkCompFlag_MainThread,
+    .m_isNkOM       = NK_FALSE,
+
+    .mp_fnQueryInst = NULL,
+    .mp_fnStartup   = &NK_COMPONENT_STARTUPFN(PerfOverlay),
+    .mp_fnShutdown  = &NK_COMPONENT_SHUTDOWNFN(PerfOverlay)
+};
+/** \endcond */
+
+
+#undef NK_NAMESPACE
+
+
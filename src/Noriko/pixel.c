@@ -0,0 +1,908 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  pixel.c
+ * \brief implements the bulk pixel operations
+ *
+ * Every operation consists of a scalar kernel which also handles the remaining pixels of
+ * the vector kernels, and one or more vector kernels. The kernel is chosen per call
+ * based on the level detected with CPUID; since the functions usually process an entire
+ * row, the cost of the branch is negligible.
+ */
+#define NK_NAMESPACE "nk::pixel"
+
+
+/* stdlib includes */
+#include <string.h>
+
+/* Use SSE2 and AVX2 if the target is an x86 processor. */
+#if (defined _M_X64 || defined _M_IX86 || defined __x86_64__ || defined __i386__)
+    #include <immintrin.h>
+
+    #define NK_PX_USE_SIMD
+#endif
+#if (defined _MSC_VER)
+    #include <intrin.h>
+#endif
+
+/* Noriko includes */
+#include <include/Noriko/pixel.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \def   NK_PX_TARGET_AVX2
+ * \brief marks a function as using AVX2 instructions
+ *
+ * MSVC allows using AVX2 intrinsics in any function; GCC and Clang require the target
+ * to be enabled explicitly if the rest of the file is not compiled for AVX2.
+ */
+#if (defined _MSC_VER)
+    #define NK_PX_TARGET_AVX2
+#else
+    #define NK_PX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+
+/**
+ * \brief SIMD level detected for the current processor, or <tt>-1</tt> if detection has
+ *        not run yet
+ * \note  Detection always produces the same result, so concurrent initialization is
+ *        harmless.
+ */
+NK_INTERNAL NkInt32 volatile gl_PxSimdLevel = -1;
+
+
+/**
+ * \brief  checks which instruction set extensions the processor and OS support
+ * \return best usable level
+ */
+NK_INTERNAL NkPixelSimdLevel __NkInt_Pixel_DetectSimdLevel(NkVoid) {
+#if (defined NK_PX_USE_SIMD) && (defined _MSC_VER)
+    int cpuInfo[4];
+
+    __cpuid(cpuInfo, 0);
+    int const maxLeaf = cpuInfo[0];
+    __cpuid(cpuInfo, 1);
+    NkBoolean const isSse2 = (cpuInfo[3] >> 26 & 1) != 0;
+    /* AVX state must be enabled by the OS, which is signaled via OSXSAVE and XCR0. */
+    NkBoolean const isAvx = (cpuInfo[2] >> 27 & 1) != 0 && (cpuInfo[2] >> 28 & 1) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    if (isAvx && maxLeaf >= 7) {
+        __cpuidex(cpuInfo, 7, 0);
+
+        if ((cpuInfo[1] >> 5 & 1) != 0)
+            return NkPxSimd_AVX2;
+    }
+
+    return isSse2 ? NkPxSimd_SSE2 : NkPxSimd_Scalar;
+#elif (defined NK_PX_USE_SIMD)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return NkPxSimd_AVX2;
+    return __builtin_cpu_supports("sse2") ? NkPxSimd_SSE2 : NkPxSimd_Scalar;
+#else
+    return NkPxSimd_Scalar;
+#endif
+}
+
+/**
+ * \brief  retrieves the SIMD level, detecting it on first use
+ * \return SIMD level
+ */
+NK_INTERNAL NK_INLINE NkPixelSimdLevel __NkInt_Pixel_GetSimdLevel(NkVoid) {
+    if (gl_PxSimdLevel < 0)
+        gl_PxSimdLevel = (NkInt32)__NkInt_Pixel_DetectSimdLevel();
+
+    return (NkPixelSimdLevel)gl_PxSimdLevel;
+}
+
+/**
+ * \brief  loads a 32-bit pixel from a possibly unaligned address
+ * \param  [in] srcPtr address of the pixel
+ * \return pixel value
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_Pixel_Load32(_In_ NkByte const *srcPtr) {
+    NkUint32 pxVal;
+    memcpy(&pxVal, srcPtr, sizeof pxVal);
+
+    return pxVal;
+}
+
+/**
+ * \brief stores a 32-bit pixel to a possibly unaligned address
+ * \param [out] dstPtr address of the pixel
+ * \param [in] pxVal pixel value
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_Pixel_Store32(_Out_ NkByte *dstPtr, _In_ NkUint32 pxVal) {
+    memcpy(dstPtr, &pxVal, sizeof pxVal);
+}
+
+/**
+ * \brief  premultiplies a single 32-bit pixel
+ * \param  [in] pxVal pixel value
+ * \return premultiplied pixel value
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_Pixel_Premultiply(_In_ NkUint32 pxVal) {
+    NkUint32 const alphaVal = pxVal >> 24;
+
+    /* (c * a + 128 + ((c * a + 128) >> 8)) >> 8 equals round(c * a / 255). */
+    NkUint32 resVal = pxVal & 0xFF000000;
+    for (NkUint32 i = 0; i < 24; i += 8) {
+        NkUint32 const tmpVal = (pxVal >> i & 0xFF) * alphaVal + 128;
+
+        resVal |= (tmpVal + (tmpVal >> 8) >> 8) << i;
+    }
+    return resVal;
+}
+
+
+#pragma region Scalar kernels
+NK_INTERNAL NkVoid __NkInt_Pixel_Fill32_Scalar(_Out_ NkByte *dstPtr, _In_ NkSize nPx, _In_ NkUint32 pxVal) {
+    for (NkSize i = 0; i < nPx; i++)
+        __NkInt_Pixel_Store32(dstPtr + i * 4, pxVal);
+}
+
+NK_INTERNAL NkVoid __NkInt_Pixel_Convert24To32_Scalar(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkByte alphaVal
+) {
+    for (NkSize i = 0; i < nPx; i++) {
+        NkByte const *srcPx = srcPtr + i * 3;
+
+        __NkInt_Pixel_Store32(
+            dstPtr + i * 4,
+            (NkUint32)alphaVal << 24 | (NkUint32)srcPx[2] << 16 | (NkUint32)srcPx[1] << 8 | (NkUint32)srcPx[0]
+        );
+    }
+}
+
+NK_INTERNAL NkVoid __NkInt_Pixel_Convert32To24_Scalar(_Out_ NkByte *dstPtr, _In_ NkByte const *srcPtr, _In_ NkSize nPx) {
+    for (NkSize i = 0; i < nPx; i++) {
+        dstPtr[i * 3 + 0] = srcPtr[i * 4 + 0];
+        dstPtr[i * 3 + 1] = srcPtr[i * 4 + 1];
+        dstPtr[i * 3 + 2] = srcPtr[i * 4 + 2];
+    }
+}
+
+NK_INTERNAL NkVoid __NkInt_Pixel_SetAlpha32_Scalar(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkByte alphaVal
+) {
+    for (NkSize i = 0; i < nPx; i++)
+        __NkInt_Pixel_Store32(dstPtr + i * 4, __NkInt_Pixel_Load32(srcPtr + i * 4) & 0x00FFFFFF | (NkUint32)alphaVal << 24);
+}
+
+NK_INTERNAL NkVoid __NkInt_Pixel_Premultiply32_Scalar(_Out_ NkByte *dstPtr, _In_ NkByte const *srcPtr, _In_ NkSize nPx) {
+    for (NkSize i = 0; i < nPx; i++)
+        __NkInt_Pixel_Store32(dstPtr + i * 4, __NkInt_Pixel_Premultiply(__NkInt_Pixel_Load32(srcPtr + i * 4)));
+}
+
+NK_INTERNAL NkVoid __NkInt_Pixel_ColorKeyMask32_Scalar(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkUint32 keyPx
+) {
+    for (NkSize i = 0; i < nPx; i++)
+        dstPtr[i] = (__NkInt_Pixel_Load32(srcPtr + i * 4) & 0x00FFFFFF) == keyPx ? 0x00 : 0xFF;
+}
+NK_INTERNAL NkVoid __NkInt_Pixel_MaskCopy32_Scalar(
+    _Inout_ NkByte *dstPtr,
+    _In_    NkByte const *srcPtr,
+    _In_    NkByte const *maskPtr,
+    _In_    NkSize nPx
+) {
+    for (NkSize i = 0; i < nPx; i++)
+        if (maskPtr[i] != 0x00)
+            memcpy(dstPtr + i * 4, srcPtr + i * 4, 4);
+}
+
+NK_INTERNAL NkVoid __NkInt_Pixel_Downsample32_Scalar(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *fSrcPtr,
+    _In_  NkByte const *sSrcPtr,
+    _In_  NkSize nPx
+) {
+    for (NkSize i = 0; i < nPx; i++)
+        for (NkSize j = 0; j < 4; j++) {
+            NkUint32 const sumVal = fSrcPtr[i * 8 + j] + fSrcPtr[i * 8 + 4 + j] + sSrcPtr[i * 8 + j] + sSrcPtr[i * 8 + 4 + j];
+
+            dstPtr[i * 4 + j] = (NkByte)(sumVal + 2 >> 2);
+        }
+}
+
+NK_INTERNAL NkVoid __NkInt_Pixel_BlendPremul32_Scalar(_Inout_ NkByte *dstPtr, _In_ NkByte const *srcPtr, _In_ NkSize nPx) {
+    for (NkSize i = 0; i < nPx; i++) {
+        NkUint32 const srcVal = __NkInt_Pixel_Load32(srcPtr + i * 4);
+        NkUint32 const invVal = 255 - (srcVal >> 24);
+
+        /* Fully transparent pixels leave the destination untouched, opaque ones replace it. */
+        if (srcVal == 0)
+            continue;
+        if (invVal == 0) {
+            __NkInt_Pixel_Store32(dstPtr + i * 4, srcVal);
+
+            continue;
+        }
+
+        NkUint32 const dstVal = __NkInt_Pixel_Load32(dstPtr + i * 4);
+        NkUint32       resVal = 0;
+        for (NkUint32 j = 0; j < 32; j += 8) {
+            NkUint32 const tmpVal = (dstVal >> j & 0xFF) * invVal + 128;
+            NkUint32 const chVal  = (srcVal >> j & 0xFF) + (tmpVal + (tmpVal >> 8) >> 8);
+
+            resVal |= (chVal > 255 ? 255 : chVal) << j;
+        }
+        __NkInt_Pixel_Store32(dstPtr + i * 4, resVal);
+    }
+}
+#pragma endregion
+
+
+#if (defined NK_PX_USE_SIMD)
+#pragma region SSE2 kernels
+/*
+ * The SSE2 kernels process as many pixels as possible and return the number of pixels
+ * they processed; the rest is handled by the scalar kernels.
+ */
+NK_INTERNAL NkSize __NkInt_Pixel_Fill32_SSE2(_Out_ NkByte *dstPtr, _In_ NkSize nPx, _In_ NkUint32 pxVal) {
+    __m128i const pxVec = _mm_set1_epi32((int)pxVal);
+
+    NkSize i = 0;
+    for (; i + 4 <= nPx; i += 4)
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 4), pxVec);
+    return i;
+}
+
+NK_INTERNAL NkSize __NkInt_Pixel_Convert24To32_SSE2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkByte alphaVal
+) {
+    /*
+     * SSE2 cannot shuffle bytes, so the pixels are gathered with 32-bit loads at 3-byte
+     * strides. The last load of a group reads one byte past the fourth pixel, hence the
+     * extra pixel in the loop condition.
+     */
+    __m128i const rgbMask  = _mm_set1_epi32(0x00FFFFFF);
+    __m128i const alphaVec = _mm_set1_epi32((int)((NkUint32)alphaVal << 24));
+
+    NkSize i = 0;
+    for (; i + 5 <= nPx; i += 4) {
+        NkByte const *srcPx = srcPtr + i * 3;
+
+        __m128i const pxVec = _mm_setr_epi32(
+            (int)__NkInt_Pixel_Load32(srcPx + 0),
+            (int)__NkInt_Pixel_Load32(srcPx + 3),
+            (int)__NkInt_Pixel_Load32(srcPx + 6),
+            (int)__NkInt_Pixel_Load32(srcPx + 9)
+        );
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 4), _mm_or_si128(_mm_and_si128(pxVec, rgbMask), alphaVec));
+    }
+    return i;
+}
+
+NK_INTERNAL NkSize __NkInt_Pixel_SetAlpha32_SSE2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkByte alphaVal
+) {
+    __m128i const rgbMask  = _mm_set1_epi32(0x00FFFFFF);
+    __m128i const alphaVec = _mm_set1_epi32((int)((NkUint32)alphaVal << 24));
+
+    NkSize i = 0;
+    for (; i + 4 <= nPx; i += 4) {
+        __m128i const pxVec = _mm_loadu_si128((__m128i const *)(srcPtr + i * 4));
+
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 4), _mm_or_si128(_mm_and_si128(pxVec, rgbMask), alphaVec));
+    }
+    return i;
+}
+
+/**
+ * \brief  premultiplies two pixels that are expanded to 16 bits per channel
+ * \param  [in] pxVec pixels; the alpha channel is in the fourth word of each pixel
+ * \return premultiplied pixels, still expanded
+ */
+NK_INTERNAL NK_INLINE __m128i __NkInt_Pixel_PremultiplyWords_SSE2(_In_ __m128i pxVec) {
+    __m128i const alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+    __m128i const roundVec  = _mm_set1_epi16(128);
+
+    /* Broadcast the alpha word of each pixel to all of its channels. */
+    __m128i const alphaVec = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pxVec, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m128i tmpVec = _mm_add_epi16(_mm_mullo_epi16(pxVec, alphaVec), roundVec);
+    tmpVec = _mm_srli_epi16(_mm_add_epi16(tmpVec, _mm_srli_epi16(tmpVec, 8)), 8);
+
+    /* Keep the original alpha channel. */
+    return _mm_or_si128(_mm_andnot_si128(alphaMask, tmpVec), _mm_and_si128(alphaMask, pxVec));
+}
+
+NK_INTERNAL NkSize __NkInt_Pixel_Premultiply32_SSE2(_Out_ NkByte *dstPtr, _In_ NkByte const *srcPtr, _In_ NkSize nPx) {
+    __m128i const zeroVec = _mm_setzero_si128();
+
+    NkSize i = 0;
+    for (; i + 4 <= nPx; i += 4) {
+        __m128i const pxVec = _mm_loadu_si128((__m128i const *)(srcPtr + i * 4));
+
+        __m128i const loVec = __NkInt_Pixel_PremultiplyWords_SSE2(_mm_unpacklo_epi8(pxVec, zeroVec));
+        __m128i const hiVec = __NkInt_Pixel_PremultiplyWords_SSE2(_mm_unpackhi_epi8(pxVec, zeroVec));
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 4), _mm_packus_epi16(loVec, hiVec));
+    }
+    return i;
+}
+
+NK_INTERNAL NkSize __NkInt_Pixel_ColorKeyMask32_SSE2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkUint32 keyPx
+) {
+    __m128i const rgbMask = _mm_set1_epi32(0x00FFFFFF);
+    __m128i const keyVec  = _mm_set1_epi32((int)keyPx);
+    __m128i const onesVec = _mm_set1_epi32(-1);
+
+    /*
+     * Compare 16 pixels at a time. Signed saturation maps the all-ones results of the
+     * comparisons to 0xFF bytes, and zero to zero.
+     */
+    NkSize i = 0;
+    for (; i + 16 <= nPx; i += 16) {
+        __m128i cmpVec[4];
+
+        for (NkSize j = 0; j < 4; j++) {
+            __m128i const pxVec = _mm_loadu_si128((__m128i const *)(srcPtr + (i + j * 4) * 4));
+
+            cmpVec[j] = _mm_xor_si128(_mm_cmpeq_epi32(_mm_and_si128(pxVec, rgbMask), keyVec), onesVec);
+        }
+
+        __m128i const resVec = _mm_packs_epi16(_mm_packs_epi32(cmpVec[0], cmpVec[1]), _mm_packs_epi32(cmpVec[2], cmpVec[3]));
+        _mm_storeu_si128((__m128i *)(dstPtr + i), resVec);
+    }
+    return i;
+}
+NK_INTERNAL NkSize __NkInt_Pixel_MaskCopy32_SSE2(
+    _Inout_ NkByte *dstPtr,
+    _In_    NkByte const *srcPtr,
+    _In_    NkByte const *maskPtr,
+    _In_    NkSize nPx
+) {
+    __m128i const zeroVec = _mm_setzero_si128();
+
+    /*
+     * Process 16 pixels at a time. The comparison yields 0xFF for every pixel that is to
+     * be kept; unpacking the bytes with themselves widens them to per-pixel selectors.
+     */
+    NkSize i = 0;
+    for (; i + 16 <= nPx; i += 16) {
+        __m128i const keepVec = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)(maskPtr + i)), zeroVec);
+        __m128i const loWords = _mm_unpacklo_epi8(keepVec, keepVec);
+        __m128i const hiWords = _mm_unpackhi_epi8(keepVec, keepVec);
+        __m128i const selVec[4] = {
+            _mm_unpacklo_epi16(loWords, loWords),
+            _mm_unpackhi_epi16(loWords, loWords),
+            _mm_unpacklo_epi16(hiWords, hiWords),
+            _mm_unpackhi_epi16(hiWords, hiWords)
+        };
+
+        for (NkSize j = 0; j < 4; j++) {
+            __m128i *const dstVec = (__m128i *)(dstPtr + (i + j * 4) * 4);
+
+            __m128i const srcVal = _mm_loadu_si128((__m128i const *)(srcPtr + (i + j * 4) * 4));
+            __m128i const dstVal = _mm_loadu_si128(dstVec);
+            _mm_storeu_si128(dstVec, _mm_or_si128(_mm_and_si128(selVec[j], dstVal), _mm_andnot_si128(selVec[j], srcVal)));
+        }
+    }
+    return i;
+}
+
+/**
+ * \brief  averages 2x2 blocks of four adjacent pixels of two rows
+ * \param  [in] fSrcVec four pixels of the first row
+ * \param  [in] sSrcVec four pixels of the second row, below \c fSrcVec
+ * \return two averaged pixels, expanded to 16 bits per channel
+ */
+NK_INTERNAL NK_INLINE __m128i __NkInt_Pixel_BoxWords_SSE2(_In_ __m128i fSrcVec, _In_ __m128i sSrcVec) {
+    __m128i const zeroVec  = _mm_setzero_si128();
+    __m128i const roundVec = _mm_set1_epi16(2);
+
+    /* Sum the rows first, then the horizontally adjacent pixels. */
+    __m128i const loVec  = _mm_add_epi16(_mm_unpacklo_epi8(fSrcVec, zeroVec), _mm_unpacklo_epi8(sSrcVec, zeroVec));
+    __m128i const hiVec  = _mm_add_epi16(_mm_unpackhi_epi8(fSrcVec, zeroVec), _mm_unpackhi_epi8(sSrcVec, zeroVec));
+    __m128i const sumVec = _mm_add_epi16(_mm_unpacklo_epi64(loVec, hiVec), _mm_unpackhi_epi64(loVec, hiVec));
+
+    return _mm_srli_epi16(_mm_add_epi16(sumVec, roundVec), 2);
+}
+
+NK_INTERNAL NkSize __NkInt_Pixel_Downsample32_SSE2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *fSrcPtr,
+    _In_  NkByte const *sSrcPtr,
+    _In_  NkSize nPx
+) {
+    NkSize i = 0;
+    for (; i + 4 <= nPx; i += 4) {
+        __m128i const loVec = __NkInt_Pixel_BoxWords_SSE2(
+            _mm_loadu_si128((__m128i const *)(fSrcPtr + i * 8)),
+            _mm_loadu_si128((__m128i const *)(sSrcPtr + i * 8))
+        );
+        __m128i const hiVec = __NkInt_Pixel_BoxWords_SSE2(
+            _mm_loadu_si128((__m128i const *)(fSrcPtr + i * 8 + 16)),
+            _mm_loadu_si128((__m128i const *)(sSrcPtr + i * 8 + 16))
+        );
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 4), _mm_packus_epi16(loVec, hiVec));
+    }
+    return i;
+}
+
+/**
+ * \brief  blends two premultiplied pixels onto two destination pixels, all expanded to 16
+ *         bits per channel
+ * \param  [in] srcVec source pixels; the alpha channel is in the fourth word of each pixel
+ * \param  [in] dstVec destination pixels
+ * \return blended pixels, still expanded; channels may exceed 255 if the source was not
+ *         properly premultiplied, which is handled by the saturating pack
+ */
+NK_INTERNAL NK_INLINE __m128i __NkInt_Pixel_BlendWords_SSE2(_In_ __m128i srcVec, _In_ __m128i dstVec) {
+    __m128i const maxVec   = _mm_set1_epi16(255);
+    __m128i const roundVec = _mm_set1_epi16(128);
+
+    __m128i const alphaVec = _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcVec, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m128i tmpVec = _mm_add_epi16(_mm_mullo_epi16(dstVec, _mm_sub_epi16(maxVec, alphaVec)), roundVec);
+    tmpVec = _mm_srli_epi16(_mm_add_epi16(tmpVec, _mm_srli_epi16(tmpVec, 8)), 8);
+
+    return _mm_add_epi16(srcVec, tmpVec);
+}
+
+NK_INTERNAL NkSize __NkInt_Pixel_BlendPremul32_SSE2(_Inout_ NkByte *dstPtr, _In_ NkByte const *srcPtr, _In_ NkSize nPx) {
+    __m128i const zeroVec = _mm_setzero_si128();
+
+    NkSize i = 0;
+    for (; i + 4 <= nPx; i += 4) {
+        __m128i const srcVal = _mm_loadu_si128((__m128i const *)(srcPtr + i * 4));
+
+        /* Sprites usually have large transparent areas; skip blocks that change nothing. */
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(srcVal, zeroVec)) == 0xFFFF)
+            continue;
+
+        __m128i const dstVal = _mm_loadu_si128((__m128i const *)(dstPtr + i * 4));
+        __m128i const loVec  = __NkInt_Pixel_BlendWords_SSE2(_mm_unpacklo_epi8(srcVal, zeroVec), _mm_unpacklo_epi8(dstVal, zeroVec));
+        __m128i const hiVec  = __NkInt_Pixel_BlendWords_SSE2(_mm_unpackhi_epi8(srcVal, zeroVec), _mm_unpackhi_epi8(dstVal, zeroVec));
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 4), _mm_packus_epi16(loVec, hiVec));
+    }
+    return i;
+}
+#pragma endregion
+
+
+#pragma region AVX2 kernels
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_Fill32_AVX2(_Out_ NkByte *dstPtr, _In_ NkSize nPx, _In_ NkUint32 pxVal) {
+    __m256i const pxVec = _mm256_set1_epi32((int)pxVal);
+
+    NkSize i = 0;
+    for (; i + 8 <= nPx; i += 8)
+        _mm256_storeu_si256((__m256i *)(dstPtr + i * 4), pxVec);
+    return i;
+}
+
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_Convert24To32_AVX2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkByte alphaVal
+) {
+    /*
+     * Each 128-bit lane receives four 24-bit pixels (12 bytes) which are spread to four
+     * 32-bit pixels with a byte shuffle. The second load reads four bytes past the eighth
+     * pixel, hence the extra pixels in the loop condition.
+     */
+    __m256i const shufMask = _mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+    );
+    __m256i const alphaVec = _mm256_set1_epi32((int)((NkUint32)alphaVal << 24));
+
+    NkSize i = 0;
+    for (; i + 10 <= nPx; i += 8) {
+        NkByte const *srcPx = srcPtr + i * 3;
+
+        __m256i const pxVec = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i const *)srcPx)),
+            _mm_loadu_si128((__m128i const *)(srcPx + 12)),
+            1
+        );
+        _mm256_storeu_si256((__m256i *)(dstPtr + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(pxVec, shufMask), alphaVec));
+    }
+    return i;
+}
+
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_Convert32To24_AVX2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx
+) {
+    /*
+     * Each 128-bit lane packs four pixels into its lower 12 bytes. Both lanes are stored
+     * with 16-byte stores; the second store overwrites the garbage of the first one and
+     * writes four bytes past the eighth pixel, hence the extra pixels in the loop
+     * condition.
+     */
+    __m256i const shufMask = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+    );
+
+    NkSize i = 0;
+    for (; i + 10 <= nPx; i += 8) {
+        __m256i const pxVec = _mm256_shuffle_epi8(_mm256_loadu_si256((__m256i const *)(srcPtr + i * 4)), shufMask);
+
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 3), _mm256_castsi256_si128(pxVec));
+        _mm_storeu_si128((__m128i *)(dstPtr + i * 3 + 12), _mm256_extracti128_si256(pxVec, 1));
+    }
+    return i;
+}
+
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_SetAlpha32_AVX2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkByte alphaVal
+) {
+    __m256i const rgbMask  = _mm256_set1_epi32(0x00FFFFFF);
+    __m256i const alphaVec = _mm256_set1_epi32((int)((NkUint32)alphaVal << 24));
+
+    NkSize i = 0;
+    for (; i + 8 <= nPx; i += 8) {
+        __m256i const pxVec = _mm256_loadu_si256((__m256i const *)(srcPtr + i * 4));
+
+        _mm256_storeu_si256((__m256i *)(dstPtr + i * 4), _mm256_or_si256(_mm256_and_si256(pxVec, rgbMask), alphaVec));
+    }
+    return i;
+}
+
+/**
+ * \brief  premultiplies four pixels that are expanded to 16 bits per channel
+ * \param  [in] pxVec pixels; the alpha channel is in the fourth word of each pixel
+ * \return premultiplied pixels, still expanded
+ */
+NK_INTERNAL NK_PX_TARGET_AVX2 NK_INLINE __m256i __NkInt_Pixel_PremultiplyWords_AVX2(_In_ __m256i pxVec) {
+    __m256i const alphaMask = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+    __m256i const roundVec  = _mm256_set1_epi16(128);
+
+    __m256i const alphaVec = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pxVec, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m256i tmpVec = _mm256_add_epi16(_mm256_mullo_epi16(pxVec, alphaVec), roundVec);
+    tmpVec = _mm256_srli_epi16(_mm256_add_epi16(tmpVec, _mm256_srli_epi16(tmpVec, 8)), 8);
+
+    return _mm256_or_si256(_mm256_andnot_si256(alphaMask, tmpVec), _mm256_and_si256(alphaMask, pxVec));
+}
+
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_Premultiply32_AVX2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx
+) {
+    __m256i const zeroVec = _mm256_setzero_si256();
+
+    /* Unpacking and packing both work per lane, so the pixel order is preserved. */
+    NkSize i = 0;
+    for (; i + 8 <= nPx; i += 8) {
+        __m256i const pxVec = _mm256_loadu_si256((__m256i const *)(srcPtr + i * 4));
+
+        __m256i const loVec = __NkInt_Pixel_PremultiplyWords_AVX2(_mm256_unpacklo_epi8(pxVec, zeroVec));
+        __m256i const hiVec = __NkInt_Pixel_PremultiplyWords_AVX2(_mm256_unpackhi_epi8(pxVec, zeroVec));
+        _mm256_storeu_si256((__m256i *)(dstPtr + i * 4), _mm256_packus_epi16(loVec, hiVec));
+    }
+    return i;
+}
+
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_ColorKeyMask32_AVX2(
+    _Out_ NkByte *dstPtr,
+    _In_  NkByte const *srcPtr,
+    _In_  NkSize nPx,
+    _In_  NkUint32 keyPx
+) {
+    __m256i const rgbMask  = _mm256_set1_epi32(0x00FFFFFF);
+    __m256i const keyVec   = _mm256_set1_epi32((int)keyPx);
+    __m256i const onesVec  = _mm256_set1_epi32(-1);
+    /* Packing works per lane, so the dwords have to be put back in order at the end. */
+    __m256i const permMask = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    NkSize i = 0;
+    for (; i + 32 <= nPx; i += 32) {
+        __m256i cmpVec[4];
+
+        for (NkSize j = 0; j < 4; j++) {
+            __m256i const pxVec = _mm256_loadu_si256((__m256i const *)(srcPtr + (i + j * 8) * 4));
+
+            cmpVec[j] = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_and_si256(pxVec, rgbMask), keyVec), onesVec);
+        }
+
+        __m256i const resVec = _mm256_packs_epi16(
+            _mm256_packs_epi32(cmpVec[0], cmpVec[1]),
+            _mm256_packs_epi32(cmpVec[2], cmpVec[3])
+        );
+        _mm256_storeu_si256((__m256i *)(dstPtr + i), _mm256_permutevar8x32_epi32(resVec, permMask));
+    }
+    return i;
+}
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_MaskCopy32_AVX2(
+    _Inout_ NkByte *dstPtr,
+    _In_    NkByte const *srcPtr,
+    _In_    NkByte const *maskPtr,
+    _In_    NkSize nPx
+) {
+    __m256i const zeroVec = _mm256_setzero_si256();
+
+    NkSize i = 0;
+    for (; i + 8 <= nPx; i += 8) {
+        __m256i *const dstVec = (__m256i *)(dstPtr + i * 4);
+
+        /* Zero-extend eight mask bytes to one dword per pixel. */
+        __m256i const maskVec = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i const *)(maskPtr + i)));
+        __m256i const keepVec = _mm256_cmpeq_epi32(maskVec, zeroVec);
+
+        __m256i const srcVal = _mm256_loadu_si256((__m256i const *)(srcPtr + i * 4));
+        _mm256_storeu_si256(dstVec, _mm256_blendv_epi8(srcVal, _mm256_loadu_si256(dstVec), keepVec));
+    }
+    return i;
+}
+
+/**
+ * \brief  blends four premultiplied pixels onto four destination pixels, all expanded to
+ *         16 bits per channel
+ * \param  [in] srcVec source pixels; the alpha channel is in the fourth word of each pixel
+ * \param  [in] dstVec destination pixels
+ * \return blended pixels, still expanded
+ */
+NK_INTERNAL NK_PX_TARGET_AVX2 NK_INLINE __m256i __NkInt_Pixel_BlendWords_AVX2(_In_ __m256i srcVec, _In_ __m256i dstVec) {
+    __m256i const maxVec   = _mm256_set1_epi16(255);
+    __m256i const roundVec = _mm256_set1_epi16(128);
+
+    __m256i const alphaVec = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(srcVec, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m256i tmpVec = _mm256_add_epi16(_mm256_mullo_epi16(dstVec, _mm256_sub_epi16(maxVec, alphaVec)), roundVec);
+    tmpVec = _mm256_srli_epi16(_mm256_add_epi16(tmpVec, _mm256_srli_epi16(tmpVec, 8)), 8);
+
+    return _mm256_add_epi16(srcVec, tmpVec);
+}
+
+NK_INTERNAL NK_PX_TARGET_AVX2 NkSize __NkInt_Pixel_BlendPremul32_AVX2(
+    _Inout_ NkByte *dstPtr,
+    _In_    NkByte const *srcPtr,
+    _In_    NkSize nPx
+) {
+    __m256i const zeroVec = _mm256_setzero_si256();
+
+    NkSize i = 0;
+    for (; i + 8 <= nPx; i += 8) {
+        __m256i const srcVal = _mm256_loadu_si256((__m256i const *)(srcPtr + i * 4));
+
+        if (_mm256_testz_si256(srcVal, srcVal))
+            continue;
+
+        __m256i const dstVal = _mm256_loadu_si256((__m256i const *)(dstPtr + i * 4));
+        __m256i const loVec  = __NkInt_Pixel_BlendWords_AVX2(_mm256_unpacklo_epi8(srcVal, zeroVec), _mm256_unpacklo_epi8(dstVal, zeroVec));
+        __m256i const hiVec  = __NkInt_Pixel_BlendWords_AVX2(_mm256_unpackhi_epi8(srcVal, zeroVec), _mm256_unpackhi_epi8(dstVal, zeroVec));
+        _mm256_storeu_si256((__m256i *)(dstPtr + i * 4), _mm256_packus_epi16(loVec, hiVec));
+    }
+    return i;
+}
+#pragma endregion
+#endif
+/** \endcond */
+
+
+NkPixelSimdLevel NK_CALL NkPixelQuerySimdLevel(NkVoid) {
+    return __NkInt_Pixel_GetSimdLevel();
+}
+
+NkVoid NK_CALL NkPixelFill32(_O_bytes_(nPx * 4) NkVoid *dstPtr, _In_ NkSize nPx, _In_ NkUint32 pxVal) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_OutParameter);
+
+    NkByte *actDst = (NkByte *)dstPtr;
+    NkSize  nDone  = 0;
+#if (defined NK_PX_USE_SIMD)
+    switch (__NkInt_Pixel_GetSimdLevel()) {
+        case NkPxSimd_AVX2: nDone = __NkInt_Pixel_Fill32_AVX2(actDst, nPx, pxVal); break;
+        case NkPxSimd_SSE2: nDone = __NkInt_Pixel_Fill32_SSE2(actDst, nPx, pxVal); break;
+        default:            break;
+    }
+#endif
+    __NkInt_Pixel_Fill32_Scalar(actDst + nDone * 4, nPx - nDone, pxVal);
+}
+
+NkVoid NK_CALL NkPixelConvert24To32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 3) NkVoid const *srcPtr,
+    _In_               NkSize nPx,
+    _In_               NkByte alphaVal
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_OutParameter);
+    NK_ASSERT(srcPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte       *actDst = (NkByte *)dstPtr;
+    NkByte const *actSrc = (NkByte const *)srcPtr;
+    NkSize        nDone  = 0;
+#if (defined NK_PX_USE_SIMD)
+    switch (__NkInt_Pixel_GetSimdLevel()) {
+        case NkPxSimd_AVX2: nDone = __NkInt_Pixel_Convert24To32_AVX2(actDst, actSrc, nPx, alphaVal); break;
+        case NkPxSimd_SSE2: nDone = __NkInt_Pixel_Convert24To32_SSE2(actDst, actSrc, nPx, alphaVal); break;
+        default:            break;
+    }
+#endif
+    __NkInt_Pixel_Convert24To32_Scalar(actDst + nDone * 4, actSrc + nDone * 3, nPx - nDone, alphaVal);
+}
+
+NkVoid NK_CALL NkPixelConvert32To24(
+    _O_bytes_(nPx * 3) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_               NkSize nPx
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_OutParameter);
+    NK_ASSERT(srcPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte       *actDst = (NkByte *)dstPtr;
+    NkByte const *actSrc = (NkByte const *)srcPtr;
+    NkSize        nDone  = 0;
+#if (defined NK_PX_USE_SIMD)
+    /* Packing needs a byte shuffle, which SSE2 lacks. */
+    if (__NkInt_Pixel_GetSimdLevel() == NkPxSimd_AVX2)
+        nDone = __NkInt_Pixel_Convert32To24_AVX2(actDst, actSrc, nPx);
+#endif
+    __NkInt_Pixel_Convert32To24_Scalar(actDst + nDone * 3, actSrc + nDone * 4, nPx - nDone);
+}
+
+NkVoid NK_CALL NkPixelSetAlpha32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_               NkSize nPx,
+    _In_               NkByte alphaVal
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_OutParameter);
+    NK_ASSERT(srcPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte       *actDst = (NkByte *)dstPtr;
+    NkByte const *actSrc = (NkByte const *)srcPtr;
+    NkSize        nDone  = 0;
+#if (defined NK_PX_USE_SIMD)
+    switch (__NkInt_Pixel_GetSimdLevel()) {
+        case NkPxSimd_AVX2: nDone = __NkInt_Pixel_SetAlpha32_AVX2(actDst, actSrc, nPx, alphaVal); break;
+        case NkPxSimd_SSE2: nDone = __NkInt_Pixel_SetAlpha32_SSE2(actDst, actSrc, nPx, alphaVal); break;
+        default:            break;
+    }
+#endif
+    __NkInt_Pixel_SetAlpha32_Scalar(actDst + nDone * 4, actSrc + nDone * 4, nPx - nDone, alphaVal);
+}
+
+NkVoid NK_CALL NkPixelPremultiply32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_               NkSize nPx
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_OutParameter);
+    NK_ASSERT(srcPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte       *actDst = (NkByte *)dstPtr;
+    NkByte const *actSrc = (NkByte const *)srcPtr;
+    NkSize        nDone  = 0;
+#if (defined NK_PX_USE_SIMD)
+    switch (__NkInt_Pixel_GetSimdLevel()) {
+        case NkPxSimd_AVX2: nDone = __NkInt_Pixel_Premultiply32_AVX2(actDst, actSrc, nPx); break;
+        case NkPxSimd_SSE2: nDone = __NkInt_Pixel_Premultiply32_SSE2(actDst, actSrc, nPx); break;
+        default:            break;
+    }
+#endif
+    __NkInt_Pixel_Premultiply32_Scalar(actDst + nDone * 4, actSrc + nDone * 4, nPx - nDone);
+}
+
+NkVoid NK_CALL NkPixelColorKeyMask32(
+    _O_bytes_(nPx)     NkByte *dstPtr,
+    _I_bytes_(nPx * 4) NkVoid const *srcPtr,
+    _In_               NkSize nPx,
+    _In_               NkUint32 keyPx
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_OutParameter);
+    NK_ASSERT(srcPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte const *actSrc = (NkByte const *)srcPtr;
+    NkSize        nDone  = 0;
+    keyPx &= 0x00FFFFFF;
+#if (defined NK_PX_USE_SIMD)
+    switch (__NkInt_Pixel_GetSimdLevel()) {
+        case NkPxSimd_AVX2: nDone = __NkInt_Pixel_ColorKeyMask32_AVX2(dstPtr, actSrc, nPx, keyPx); break;
+        case NkPxSimd_SSE2: nDone = __NkInt_Pixel_ColorKeyMask32_SSE2(dstPtr, actSrc, nPx, keyPx); break;
+        default:            break;
+    }
+#endif
+    __NkInt_Pixel_ColorKeyMask32_Scalar(dstPtr + nDone, actSrc + nDone * 4, nPx - nDone, keyPx);
+}
+
+NkVoid NK_CALL NkPixelMaskCopy32(
+    _IO_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4)  NkVoid const *srcPtr,
+    _I_bytes_(nPx)      NkByte const *maskPtr,
+    _In_                NkSize nPx
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_InOutParameter);
+    NK_ASSERT(srcPtr != NULL || nPx == 0, NkErr_InParameter);
+    NK_ASSERT(maskPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte       *actDst = (NkByte *)dstPtr;
+    NkByte const *actSrc = (NkByte const *)srcPtr;
+    NkSize        nDone  = 0;
+#if (defined NK_PX_USE_SIMD)
+    switch (__NkInt_Pixel_GetSimdLevel()) {
+        case NkPxSimd_AVX2: nDone = __NkInt_Pixel_MaskCopy32_AVX2(actDst, actSrc, maskPtr, nPx); break;
+        case NkPxSimd_SSE2: nDone = __NkInt_Pixel_MaskCopy32_SSE2(actDst, actSrc, maskPtr, nPx); break;
+        default:            break;
+    }
+#endif
+    __NkInt_Pixel_MaskCopy32_Scalar(actDst + nDone * 4, actSrc + nDone * 4, maskPtr + nDone, nPx - nDone);
+}
+
+NkVoid NK_CALL NkPixelDownsample32(
+    _O_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 8) NkVoid const *fSrcPtr,
+    _I_bytes_(nPx * 8) NkVoid const *sSrcPtr,
+    _In_               NkSize nPx
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_OutParameter);
+    NK_ASSERT(fSrcPtr != NULL || nPx == 0, NkErr_InParameter);
+    NK_ASSERT(sSrcPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte       *actDst  = (NkByte *)dstPtr;
+    NkByte const *actFSrc = (NkByte const *)fSrcPtr;
+    NkByte const *actSSrc = (NkByte const *)sSrcPtr;
+    NkSize        nDone   = 0;
+#if (defined NK_PX_USE_SIMD)
+    /* The filter is bound by memory bandwidth; wider vectors would not gain anything. */
+    if (__NkInt_Pixel_GetSimdLevel() != NkPxSimd_Scalar)
+        nDone = __NkInt_Pixel_Downsample32_SSE2(actDst, actFSrc, actSSrc, nPx);
+#endif
+    __NkInt_Pixel_Downsample32_Scalar(actDst + nDone * 4, actFSrc + nDone * 8, actSSrc + nDone * 8, nPx - nDone);
+}
+
+NkVoid NK_CALL NkPixelBlendPremul32(
+    _IO_bytes_(nPx * 4) NkVoid *dstPtr,
+    _I_bytes_(nPx * 4)  NkVoid const *srcPtr,
+    _In_                NkSize nPx
+) {
+    NK_ASSERT(dstPtr != NULL || nPx == 0, NkErr_InOutParameter);
+    NK_ASSERT(srcPtr != NULL || nPx == 0, NkErr_InParameter);
+
+    NkByte       *actDst = (NkByte *)dstPtr;
+    NkByte const *actSrc = (NkByte const *)srcPtr;
+    NkSize        nDone  = 0;
+#if (defined NK_PX_USE_SIMD)
+    switch (__NkInt_Pixel_GetSimdLevel()) {
+        case NkPxSimd_AVX2: nDone = __NkInt_Pixel_BlendPremul32_AVX2(actDst, actSrc, nPx); break;
+        case NkPxSimd_SSE2: nDone = __NkInt_Pixel_BlendPremul32_SSE2(actDst, actSrc, nPx); break;
+        default:            break;
+    }
+#endif
+    __NkInt_Pixel_BlendPremul32_Scalar(actDst + nDone * 4, actSrc + nDone * 4, nPx - nDone);
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -0,0 +1,161 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  winaio.c
+ * \brief implements platform-dependent functionality of the asynchronous I/O service for
+ *        the Windows platform, using overlapped reads and an I/O completion port
+ */
+#define NK_NAMESPACE "nk::winaio"
+
+
+/* Noriko includes */
+#include <include/Noriko/asyncio.h>
+#include <include/Noriko/platform.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \struct __NkInt_WinAioOperation
+ * \brief  represents the state of a single overlapped read
+ * \note   The \c OVERLAPPED structure must be the first member so that the pointer
+ *         reported by the completion port can be converted back.
+ */
+NK_NATIVE typedef struct __NkInt_WinAioOperation {
+    OVERLAPPED m_ovlData; /**< overlapped state */
+} __NkInt_WinAioOperation;
+
+
+NkSize NK_CALL __NkVirt_AsyncIO_QueryOperationSize(NkVoid) {
+    return sizeof(__NkInt_WinAioOperation);
+}
+
+_Return_ok_ NkErrorCode NK_CALL __NkVirt_AsyncIO_CreatePort(_Outptr_ NkVoid **portHnd) {
+    NK_ASSERT(portHnd != NULL, NkErr_OutptrParameter);
+
+    /* Only the I/O thread dequeues completions. */
+    *portHnd = (NkVoid *)CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+
+    return *portHnd != NULL ? NkErr_Ok : NkErr_SynchInit;
+}
+
+NkVoid NK_CALL __NkVirt_AsyncIO_DestroyPort(_Inout_ NkVoid *portHnd) {
+    NK_ASSERT(portHnd != NULL, NkErr_InOutParameter);
+
+    CloseHandle((HANDLE)portHnd);
+}
+
+_Return_ok_ NkErrorCode NK_CALL __NkVirt_AsyncIO_OpenFile(
+    _Inout_       NkVoid *portHnd,
+    _In_z_ _Utf8_ char const *pathStr,
+    _Outptr_      NkVoid **fileHnd,
+    _Out_         NkUint64 *sizePtr
+) {
+    NK_ASSERT(portHnd != NULL, NkErr_InOutParameter);
+    NK_ASSERT(pathStr != NULL && *pathStr ^ '\0', NkErr_InParameter);
+    NK_ASSERT(fileHnd != NULL, NkErr_OutptrParameter);
+    NK_ASSERT(sizePtr != NULL, NkErr_OutParameter);
+
+    *fileHnd = NULL;
+    *sizePtr = 0;
+
+    HANDLE const fileHandle = CreateFileA(
+        (LPCSTR)pathStr,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
+        NULL
+    );
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return NkErr_OpenFile;
+
+    /*
+     * Associate the file with the port. Completion notifications are not skipped on
+     * synchronous success, so every started read is reported through the port.
+     */
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || CreateIoCompletionPort(fileHandle, (HANDLE)portHnd, 0, 0) == NULL) {
+        CloseHandle(fileHandle);
+
+        return NkErr_OpenFile;
+    }
+
+    *fileHnd = (NkVoid *)fileHandle;
+    *sizePtr = (NkUint64)fileSize.QuadPart;
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL __NkVirt_AsyncIO_CloseFile(_Inout_ NkVoid *fileHnd) {
+    NK_ASSERT(fileHnd != NULL, NkErr_InOutParameter);
+
+    CloseHandle((HANDLE)fileHnd);
+}
+
+_Return_ok_ NkErrorCode NK_CALL __NkVirt_AsyncIO_IssueRead(
+    _Inout_      NkVoid *fileHnd,
+    _In_         NkUint64 fileOff,
+    _In_         NkUint32 s,
+    _O_bytes_(s) NkVoid *bufPtr,
+    _Inout_      NkVoid *opPtr
+) {
+    NK_ASSERT(fileHnd != NULL, NkErr_InOutParameter);
+    NK_ASSERT(bufPtr != NULL, NkErr_OutParameter);
+    NK_ASSERT(opPtr != NULL, NkErr_InOutParameter);
+
+    __NkInt_WinAioOperation *actOp = (__NkInt_WinAioOperation *)opPtr;
+    memset(&actOp->m_ovlData, 0, sizeof actOp->m_ovlData);
+    actOp->m_ovlData.Offset     = (DWORD)(fileOff & 0xFFFFFFFF);
+    actOp->m_ovlData.OffsetHigh = (DWORD)(fileOff >> 32);
+
+    /* Both synchronous and asynchronous success are reported through the port. */
+    if (!ReadFile((HANDLE)fileHnd, bufPtr, (DWORD)s, NULL, &actOp->m_ovlData) && GetLastError() != ERROR_IO_PENDING)
+        return NkErr_ErrorDuringDiskIO;
+
+    return NkErr_Ok;
+}
+
+NkErrorCode NK_CALL __NkVirt_AsyncIO_WaitCompletion(
+    _Inout_  NkVoid *portHnd,
+    _Outptr_ NkVoid **opPtr,
+    _Out_    NkSize *nBytes
+) {
+    NK_ASSERT(portHnd != NULL, NkErr_InOutParameter);
+    NK_ASSERT(opPtr != NULL, NkErr_OutptrParameter);
+    NK_ASSERT(nBytes != NULL, NkErr_OutParameter);
+
+    DWORD        nTransferred = 0;
+    ULONG_PTR    complKey     = 0;
+    LPOVERLAPPED ovlPtr       = NULL;
+    BOOL const   res          = GetQueuedCompletionStatus((HANDLE)portHnd, &nTransferred, &complKey, &ovlPtr, INFINITE);
+
+    /*
+     * Wake-up packets do not carry an OVERLAPPED structure. If the port itself failed,
+     * there is no structure either; treat this like a wake-up.
+     */
+    *opPtr  = (NkVoid *)ovlPtr;
+    *nBytes = (NkSize)nTransferred;
+    return res ? NkErr_Ok : NkErr_ErrorDuringDiskIO;
+}
+
+NkVoid NK_CALL __NkVirt_AsyncIO_Wake(_Inout_ NkVoid *portHnd) {
+    NK_ASSERT(portHnd != NULL, NkErr_InOutParameter);
+
+    PostQueuedCompletionStatus((HANDLE)portHnd, 0, 0, NULL);
+}
+/** \endcond */
+
+
+#undef NK_NAMESPACE
+
+
@@ -0,0 +1,104 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  winalloc.c
+ * \brief implements platform-dependent functionality of the memory allocators for the
+ *        Windows platform
+ */
+#define NK_NAMESPACE "nk::winalloc"
+
+
+/* Noriko includes */
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/platform.h>
+
+
+NkVoid *NK_CALL __NkVirt_Alloc_MapSegment(_In_ NkSize segSize) {
+    /*
+     * VirtualAlloc() only guarantees an alignment of the allocation granularity (usually
+     * 64 KiB). To get an address aligned to the segment size, reserve twice the size,
+     * release the reservation again and then map the aligned part of it. Another thread
+     * may grab the range in between, so retry a few times.
+     */
+    for (int i = 0; i < 8; i++) {
+        NkByte *resPtr = VirtualAlloc(NULL, segSize * 2, MEM_RESERVE, PAGE_NOACCESS);
+        if (resPtr == NULL)
+            return NULL;
+
+        NkByte *alignedPtr = (NkByte *)(((NkSize)resPtr + segSize - 1) & ~(segSize - 1));
+        VirtualFree(resPtr, 0, MEM_RELEASE);
+
+        NkVoid *segPtr = VirtualAlloc(alignedPtr, segSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (segPtr != NULL)
+            return segPtr;
+    }
+
+    return NULL;
+}
+
+NkVoid NK_CALL __NkVirt_Alloc_UnmapSegment(_Inout_ NkVoid *segPtr) {
+    VirtualFree(segPtr, 0, MEM_RELEASE);
+}
+
+NkSize NK_CALL __NkVirt_Alloc_GetPageSize(NkVoid) {
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+
+    return (NkSize)sysInfo.dwPageSize;
+}
+
+NkSize NK_CALL __NkVirt_Alloc_EnableLargePages(NkVoid) {
+    NkSize const largePageSize = (NkSize)GetLargePageMinimum();
+    if (largePageSize == 0)
+        return 0;
+
+    /*
+     * Enable 'SeLockMemoryPrivilege' for the process token. The privilege must have been
+     * granted to the user; AdjustTokenPrivileges() succeeds even if it was not, but then
+     * reports ERROR_NOT_ALL_ASSIGNED.
+     */
+    HANDLE tokHnd;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &tokHnd))
+        return 0;
+
+    TOKEN_PRIVILEGES tokPrivs = { .PrivilegeCount = 1 };
+    tokPrivs.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    BOOL const isEnabled = LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &tokPrivs.Privileges[0].Luid)
+        && AdjustTokenPrivileges(tokHnd, FALSE, &tokPrivs, 0, NULL, NULL)
+        && GetLastError() == ERROR_SUCCESS
+    ;
+    CloseHandle(tokHnd);
+
+    return isEnabled ? largePageSize : 0;
+}
+
+NkVoid *NK_CALL __NkVirt_Alloc_ReserveRange(_In_ NkSize rangeSize, _In_ NkBoolean isLarge) {
+    if (isLarge)
+        return VirtualAlloc(NULL, rangeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+
+    return VirtualAlloc(NULL, rangeSize, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+NkBoolean NK_CALL __NkVirt_Alloc_CommitRange(_Inout_ NkVoid *partPtr, _In_ NkSize partSize) {
+    /* VirtualAlloc() commits every page that overlaps the given range. */
+    return partSize == 0 || VirtualAlloc(partPtr, partSize, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+NkVoid NK_CALL __NkVirt_Alloc_ReleaseRange(_Inout_ NkVoid *rangePtr) {
+    VirtualFree(rangePtr, 0, MEM_RELEASE);
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -0,0 +1,2079 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  wind3d11.c
+ * \brief implements a hardware-accelerated renderer based on Direct3D 11
+ *
+ * While the GDI renderer does all compositing on the CPU, this renderer keeps all
+ * textures in video memory and draws them as instanced quads. Draw calls are not sent
+ * to the GPU immediately; instead, they are accumulated into a batch that is submitted
+ * as a single instanced draw call whenever the bound texture (or mask) changes, the
+ * batch is full, or the frame ends. The frame is rendered into an off-screen render
+ * target which is copied into the swap chain's back buffer when the frame is presented.
+ * This mirrors the memory bitmap of the GDI renderer and allows the framebuffer to be
+ * grabbed at any time.
+ */
+#define NK_NAMESPACE "nk::rdd3d11"
+
+
+/* Noriko includes */
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/renderer.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/bmp.h>
+#include <include/Noriko/pixel.h>
+#include <include/Noriko/timer.h>
+
+
+/* All code is stripped from the compilation if we are not on Windows. */
+#if (defined NK_TARGET_WINDOWS)
+/* Direct3D includes */
+#define COBJMACROS
+#include <d3d11.h>
+#include <dxgi1_5.h>
+#include <d3dcompiler.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \def   __NkInt_D3D11_SafeRelease(ptr)
+ * \brief releases a COM object if it is not <tt>NULL</tt> and resets the pointer
+ */
+#define __NkInt_D3D11_SafeRelease(ptr) do { if ((ptr) != NULL) { (ptr)->lpVtbl->Release(ptr); (ptr) = NULL; } } while (0)
+/**
+ * \def   __NkInt_D3D11_MaxBatchSize
+ * \brief maximum number of quads that are accumulated before a batch is flushed
+ */
+#define __NkInt_D3D11_MaxBatchSize ((UINT)4096)
+
+
+/**
+ * \struct __NkInt_D3D11Texture
+ * \brief  represents the device-side state of a texture (or texture mask) resource
+ */
+NK_NATIVE typedef struct __NkInt_D3D11Texture {
+    ID3D11Texture2D          *mp_texPtr;     /**< texture object */
+    ID3D11ShaderResourceView *mp_srvPtr;     /**< view used for binding the texture to the PS */
+    ID3D11RenderTargetView   *mp_rtvPtr;     /**< view used for rendering to the texture (surfaces only) */
+    ID3D11Texture2D          *mp_scratchTex; /**< scratch copy used for scrolling (surfaces only) */
+    NkUint32                  m_width;       /**< width of the texture, in pixels */
+    NkUint32                  m_height;      /**< height of the texture, in pixels */
+    NkBoolean                 m_isAlpha;     /**< whether the pixels are premultiplied and must be blended */
+} __NkInt_D3D11Texture;
+
+/**
+ * \struct __NkInt_D3D11QuadInstance
+ * \brief  represents the per-instance data of a single textured quad
+ * \note   Must match the layout of <tt>VSInput</tt> in the shader source below.
+ */
+NK_NATIVE typedef struct __NkInt_D3D11QuadInstance {
+    NkFloat m_dstRect[4];  /**< destination rectangle, in back buffer pixels */
+    NkFloat m_srcRect[4];  /**< source rectangle, in normalized texture coordinates */
+    NkFloat m_maskRect[4]; /**< mask rectangle, in normalized mask coordinates */
+} __NkInt_D3D11QuadInstance;
+
+/**
+ * \struct __NkInt_D3D11FrameConstants
+ * \brief  represents the contents of the constant buffer bound to the vertex shader
+ */
+NK_NATIVE typedef struct __NkInt_D3D11FrameConstants {
+    NkFloat m_invBbDim[2]; /**< reciprocal of the back buffer dimensions */
+    NkFloat m_padding[2];  /**< pads the structure to 16 bytes */
+} __NkInt_D3D11FrameConstants;
+
+/**
+ * \class __NkInt_D3D11Renderer
+ * \brief represents the instance-specific internal state of the Direct3D 11 renderer
+ */
+NK_NATIVE typedef struct __NkInt_D3D11Renderer {
+    NKOM_IMPLEMENTS(NkID3D11Renderer);
+
+    NkOMRefCount             m_refCount; /**< reference count */
+    NkIWindow               *mp_wndRef;  /**< reference to the Noriko window */
+    NkRendererSpecification  m_initSpec; /**< initial specification */
+    NkRendererSpecification  m_currSpec; /**< current renderer settings */
+
+    /**
+     * \struct __NkInt_D3D11Resources
+     * \brief  represents the collection of basic resources used by the Direct3D 11
+     *         renderer
+     */
+    struct __NkInt_D3D11Resources {
+        ID3D11Device              *mp_devPtr;     /**< Direct3D device */
+        ID3D11DeviceContext       *mp_devCxt;     /**< immediate device context */
+        IDXGISwapChain1           *mp_swapChain;  /**< swap chain of the parent window */
+        ID3D11Texture2D           *mp_bbTex;      /**< back buffer of the swap chain */
+        ID3D11Texture2D           *mp_fbTex;      /**< off-screen framebuffer */
+        ID3D11Texture2D           *mp_stagTex;    /**< (lazily created) read-back copy of the framebuffer */
+        ID3D11RenderTargetView    *mp_fbView;     /**< render target view of the framebuffer */
+        ID3D11VertexShader        *mp_quadVS;     /**< vertex shader expanding instances to quads */
+        ID3D11PixelShader         *mp_texPS;      /**< pixel shader for opaque textures */
+        ID3D11PixelShader         *mp_maskPS;     /**< pixel shader for masked textures */
+        ID3D11PixelShader         *mp_alphaPS;    /**< pixel shader for alpha textures */
+        ID3D11InputLayout         *mp_instLayout; /**< input layout of the instance buffer */
+        ID3D11Buffer              *mp_instBuf;    /**< dynamic instance buffer */
+        ID3D11Buffer              *mp_constBuf;   /**< per-frame constant buffer */
+        ID3D11SamplerState        *mp_smpState;   /**< texture sampler */
+        ID3D11RasterizerState     *mp_rsState;    /**< rasterizer state (no culling) */
+        ID3D11BlendState          *mp_alphaBs;    /**< blend state for premultiplied alpha */
+#if (!defined NK_CONFIG_DEPLOY)
+        __NkInt_D3D11Texture       m_vpBkgndTex;  /**< 1x1 texture used for the viewport background */
+#endif /* NK_CONFIG_DEPLOY */
+        NkSize2D                   m_bbDim;       /**< dimensions of the internal back buffer */
+        NkPoint2D                  m_vpOri;       /**< viewport origin, in client space */
+        UINT                       m_swapFlags;   /**< flags the swap chain was created with; must be passed when resizing it */
+        NkBoolean                  m_isTearing;   /**< whether frames presented without VSync may tear */
+    } m_d3dRes;
+
+    /**
+     * \struct __NkInt_D3D11Batch
+     * \brief  represents the state of the quad batch that is currently being recorded
+     */
+    struct __NkInt_D3D11Batch {
+        __NkInt_D3D11QuadInstance  *mp_instArr;  /**< host-side instance array */
+        UINT                        m_nInst;     /**< number of recorded instances */
+        __NkInt_D3D11Texture const *mp_currTex;  /**< texture of the current batch */
+        __NkInt_D3D11Texture const *mp_currMask; /**< mask of the current batch (or NULL) */
+    } m_batch;
+
+    /**
+     * \struct __NkInt_D3D11Target
+     * \brief  represents the render target all draw calls currently go to
+     */
+    struct __NkInt_D3D11Target {
+        NkRendererResource const *mp_surfPtr; /**< current surface (or NULL for the framebuffer) */
+        NkPoint2D                 m_tgtOri;   /**< origin of the drawing area, in target space */
+    } m_currTgt;
+
+    /**
+     * \struct __NkInt_D3D11Statistics
+     * \brief  represents the counters of the current and the last finished frame
+     */
+    struct __NkInt_D3D11Statistics {
+        NkRendererFrameStatistics m_currStats;  /**< statistics of the frame being drawn */
+        NkRendererFrameStatistics m_lastStats;  /**< statistics of the last finished frame */
+        NkUint64                  m_beginTicks; /**< time <tt>BeginDraw()</tt> was entered */
+    } m_frameStats;
+} __NkInt_D3D11Renderer;
+/* Define IID and CLSID. */
+// { 5D3A1B7E-6F2C-4E84-9C31-7A0B2E64D5F1 }
+NKOM_DEFINE_IID(NkID3D11Renderer, { 0x5d3a1b7e, 0x6f2c, 0x4e84, 0x9c317a0b2e64d5f1 });
+// { C1E8A0D4-3B95-4F6A-8E27-D49F61B3A08C }
+NKOM_DEFINE_CLSID(NkID3D11Renderer, { 0xc1e8a0d4, 0x3b95, 0x4f6a, 0x8e27d49f61b3a08c });
+
+
+/**
+ * \brief HLSL source of the shaders used by the renderer
+ *
+ * The vertex shader does not consume any per-vertex data. Instead, it expands each
+ * instance into a quad (drawn as a 4-vertex triangle strip) using the vertex ID.
+ */
+NK_INTERNAL char const gl_c_ShaderSource[] =
+    "cbuffer FrameConstants : register(b0) {\n"
+    "    float2 g_InvBbDim;\n"
+    "    float2 g_Padding;\n"
+    "};\n"
+    "struct VSInput {\n"
+    "    float4 m_dstRect  : DSTRECT;\n"
+    "    float4 m_srcRect  : SRCRECT;\n"
+    "    float4 m_maskRect : MASKRECT;\n"
+    "    uint   m_vertId   : SV_VertexID;\n"
+    "};\n"
+    "struct PSInput {\n"
+    "    float4 m_pos    : SV_POSITION;\n"
+    "    float2 m_texUv  : TEXCOORD0;\n"
+    "    float2 m_maskUv : TEXCOORD1;\n"
+    "};\n"
+    "Texture2D    g_Texture : register(t0);\n"
+    "Texture2D    g_Mask    : register(t1);\n"
+    "SamplerState g_Sampler : register(s0);\n"
+    "PSInput VSMain(VSInput i) {\n"
+    "    float2 corner = float2(i.m_vertId & 1, i.m_vertId >> 1);\n"
+    "    float2 pxPos  = i.m_dstRect.xy + corner * i.m_dstRect.zw;\n"
+    "    PSInput o;\n"
+    "    o.m_pos    = float4(pxPos * g_InvBbDim * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);\n"
+    "    o.m_texUv  = i.m_srcRect.xy + corner * i.m_srcRect.zw;\n"
+    "    o.m_maskUv = i.m_maskRect.xy + corner * i.m_maskRect.zw;\n"
+    "    return o;\n"
+    "}\n"
+    "float4 PSTexture(PSInput i) : SV_TARGET {\n"
+    "    return float4(g_Texture.Sample(g_Sampler, i.m_texUv).rgb, 1.0);\n"
+    "}\n"
+    "float4 PSMasked(PSInput i) : SV_TARGET {\n"
+    "    clip(g_Mask.Sample(g_Sampler, i.m_maskUv).r - 0.5);\n"
+    "    return float4(g_Texture.Sample(g_Sampler, i.m_texUv).rgb, 1.0);\n"
+    "}\n"
+    "float4 PSAlpha(PSInput i) : SV_TARGET {\n"
+    "    return g_Texture.Sample(g_Sampler, i.m_texUv);\n"
+    "}\n";
+
+
+/**
+ * \brief  checks whether the given resource can be used as the source of a texture draw
+ * \param  [in] resPtr pointer to the resource to check
+ * \return \c NK_TRUE if the resource is a texture, an alpha texture or a surface,
+ *         \c NK_FALSE otherwise
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_D3D11Renderer_IsTexture(_In_ NkRendererResource const *resPtr) {
+    return resPtr->m_resType == NkRdResTy_Texture
+        || resPtr->m_resType == NkRdResTy_AlphaTexture
+        || resPtr->m_resType == NkRdResTy_Surface;
+}
+
+/**
+ */
+NK_INTERNAL D3D11_FILTER __NkInt_D3D11Renderer_MapToFilter(_In_ NkTextureInterpolationMode iMode) {
+    switch (iMode) {
+        case NkTexIMd_Default:
+        case NkTexIMd_NearestNeighbor: return D3D11_FILTER_MIN_MAG_MIP_POINT;
+        case NkTexIMd_Bilinear:        return D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    }
+
+    return D3D11_FILTER_MIN_MAG_MIP_POINT;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_D3D11Renderer_CompileShader(
+    _In_z_   char const *entryPt,
+    _In_z_   char const *shTarget,
+    _Outptr_ ID3DBlob **resPtr
+) {
+#if (defined NK_CONFIG_DEPLOY)
+    UINT const compFlags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#else
+    UINT const compFlags = D3DCOMPILE_DEBUG;
+#endif /* NK_CONFIG_DEPLOY */
+
+    ID3DBlob *errBlob = NULL;
+    HRESULT   hRes    = D3DCompile(
+        gl_c_ShaderSource,
+        sizeof gl_c_ShaderSource - 1,
+        NK_NAMESPACE,
+        NULL,
+        NULL,
+        entryPt,
+        shTarget,
+        compFlags,
+        0,
+        resPtr,
+        &errBlob
+    );
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR(
+            "Could not compile shader '%s' (%s). HRESULT: 0x%08lX. Reason: %s",
+            entryPt,
+            shTarget,
+            (unsigned long)hRes,
+            errBlob != NULL ? (char const *)ID3D10Blob_GetBufferPointer(errBlob) : "unknown"
+        );
+
+        __NkInt_D3D11_SafeRelease(errBlob);
+        return NkErr_CompileShader;
+    }
+
+    __NkInt_D3D11_SafeRelease(errBlob);
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_D3D11Renderer_CreateTextureObject(
+    _Inout_ ID3D11Device *devPtr,
+    _In_    DXGI_FORMAT texFmt,
+    _In_    NkUint32 width,
+    _In_    NkUint32 height,
+    _In_    NkVoid const *pxData,
+    _In_    NkUint32 rowPitch,
+    _Out_   __NkInt_D3D11Texture *resPtr
+) {
+    *resPtr = (__NkInt_D3D11Texture){ .m_width = width, .m_height = height };
+
+    /* Create the texture and upload the pixels. The texture is never modified afterwards. */
+    HRESULT hRes = ID3D11Device_CreateTexture2D(devPtr, &(D3D11_TEXTURE2D_DESC const){
+        .Width          = (UINT)width,
+        .Height         = (UINT)height,
+        .MipLevels      = 1,
+        .ArraySize      = 1,
+        .Format         = texFmt,
+        .SampleDesc     = { .Count = 1, .Quality = 0 },
+        .Usage          = D3D11_USAGE_IMMUTABLE,
+        .BindFlags      = D3D11_BIND_SHADER_RESOURCE,
+        .CPUAccessFlags = 0,
+        .MiscFlags      = 0
+    }, &(D3D11_SUBRESOURCE_DATA const){
+        .pSysMem          = pxData,
+        .SysMemPitch      = (UINT)rowPitch,
+        .SysMemSlicePitch = 0
+    }, &resPtr->mp_texPtr);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create texture object. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        return NkErr_CreateGpuResource;
+    }
+    /* Create the view that is used to bind the texture. */
+    hRes = ID3D11Device_CreateShaderResourceView(devPtr, (ID3D11Resource *)resPtr->mp_texPtr, NULL, &resPtr->mp_srvPtr);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create shader resource view. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        __NkInt_D3D11_SafeRelease(resPtr->mp_texPtr);
+        return NkErr_CreateGpuResource;
+    }
+
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_DestroyTextureObject(_Inout_ __NkInt_D3D11Texture *texPtr) {
+    __NkInt_D3D11_SafeRelease(texPtr->mp_scratchTex);
+    __NkInt_D3D11_SafeRelease(texPtr->mp_rtvPtr);
+    __NkInt_D3D11_SafeRelease(texPtr->mp_srvPtr);
+    __NkInt_D3D11_SafeRelease(texPtr->mp_texPtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_D3D11Renderer_CreateFramebuffer(_Inout_ struct __NkInt_D3D11Resources *resPtr) {
+    /* Retrieve the swap chain's back buffer. */
+    HRESULT hRes = IDXGISwapChain1_GetBuffer(resPtr->mp_swapChain, 0, &IID_ID3D11Texture2D, (NkVoid **)&resPtr->mp_bbTex);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not retrieve swap chain back buffer. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        return NkErr_CreateGpuResource;
+    }
+
+    /* Create the off-screen framebuffer that we actually render into. */
+    hRes = ID3D11Device_CreateTexture2D(resPtr->mp_devPtr, &(D3D11_TEXTURE2D_DESC const){
+        .Width          = (UINT)resPtr->m_bbDim.m_width,
+        .Height         = (UINT)resPtr->m_bbDim.m_height,
+        .MipLevels      = 1,
+        .ArraySize      = 1,
+        .Format         = DXGI_FORMAT_B8G8R8A8_UNORM,
+        .SampleDesc     = { .Count = 1, .Quality = 0 },
+        .Usage          = D3D11_USAGE_DEFAULT,
+        .BindFlags      = D3D11_BIND_RENDER_TARGET,
+        .CPUAccessFlags = 0,
+        .MiscFlags      = 0
+    }, NULL, &resPtr->mp_fbTex);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create framebuffer texture. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        __NkInt_D3D11_SafeRelease(resPtr->mp_bbTex);
+        return NkErr_CreateGpuResource;
+    }
+    hRes = ID3D11Device_CreateRenderTargetView(resPtr->mp_devPtr, (ID3D11Resource *)resPtr->mp_fbTex, NULL, &resPtr->mp_fbView);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create framebuffer render target view. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        __NkInt_D3D11_SafeRelease(resPtr->mp_fbTex);
+        __NkInt_D3D11_SafeRelease(resPtr->mp_bbTex);
+        return NkErr_CreateGpuResource;
+    }
+
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_DestroyFramebuffer(_Inout_ struct __NkInt_D3D11Resources *resPtr) {
+    if (resPtr->mp_devCxt != NULL)
+        ID3D11DeviceContext_OMSetRenderTargets(resPtr->mp_devCxt, 0, NULL, NULL);
+
+    __NkInt_D3D11_SafeRelease(resPtr->mp_fbView);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_stagTex);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_fbTex);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_bbTex);
+}
+
+/**
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_DestroyBasicResources(_Inout_ struct __NkInt_D3D11Resources *resPtr) {
+#if (!defined NK_CONFIG_DEPLOY)
+    __NkInt_D3D11Renderer_DestroyTextureObject(&resPtr->m_vpBkgndTex);
+#endif /* NK_CONFIG_DEPLOY */
+    __NkInt_D3D11Renderer_DestroyFramebuffer(resPtr);
+
+    __NkInt_D3D11_SafeRelease(resPtr->mp_alphaBs);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_rsState);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_smpState);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_constBuf);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_instBuf);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_instLayout);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_alphaPS);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_maskPS);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_texPS);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_quadVS);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_swapChain);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_devCxt);
+    __NkInt_D3D11_SafeRelease(resPtr->mp_devPtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_D3D11Renderer_CreatePipeline(_Inout_ struct __NkInt_D3D11Resources *resPtr) {
+    /**
+     * \brief layout of the per-instance data in the instance buffer
+     */
+    NK_INTERNAL D3D11_INPUT_ELEMENT_DESC const gl_c_InstLayout[] = {
+        { "DSTRECT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, offsetof(__NkInt_D3D11QuadInstance, m_dstRect),  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        { "SRCRECT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, offsetof(__NkInt_D3D11QuadInstance, m_srcRect),  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        { "MASKRECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, offsetof(__NkInt_D3D11QuadInstance, m_maskRect), D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+    };
+
+    NkErrorCode errCode;
+    HRESULT     hRes;
+    ID3DBlob   *vsBlob = NULL, *psBlob = NULL;
+
+    /* Compile and create the vertex shader as well as the input layout. */
+    if ((errCode = __NkInt_D3D11Renderer_CompileShader("VSMain", "vs_4_0", &vsBlob)) != NkErr_Ok)
+        return errCode;
+    hRes = ID3D11Device_CreateVertexShader(
+        resPtr->mp_devPtr,
+        ID3D10Blob_GetBufferPointer(vsBlob),
+        ID3D10Blob_GetBufferSize(vsBlob),
+        NULL,
+        &resPtr->mp_quadVS
+    );
+    if (SUCCEEDED(hRes))
+        hRes = ID3D11Device_CreateInputLayout(
+            resPtr->mp_devPtr,
+            gl_c_InstLayout,
+            (UINT)NK_ARRAYSIZE(gl_c_InstLayout),
+            ID3D10Blob_GetBufferPointer(vsBlob),
+            ID3D10Blob_GetBufferSize(vsBlob),
+            &resPtr->mp_instLayout
+        );
+    __NkInt_D3D11_SafeRelease(vsBlob);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+
+    /* Compile and create all pixel shaders. */
+    if ((errCode = __NkInt_D3D11Renderer_CompileShader("PSTexture", "ps_4_0", &psBlob)) != NkErr_Ok)
+        return errCode;
+    hRes = ID3D11Device_CreatePixelShader(
+        resPtr->mp_devPtr,
+        ID3D10Blob_GetBufferPointer(psBlob),
+        ID3D10Blob_GetBufferSize(psBlob),
+        NULL,
+        &resPtr->mp_texPS
+    );
+    __NkInt_D3D11_SafeRelease(psBlob);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+    if ((errCode = __NkInt_D3D11Renderer_CompileShader("PSMasked", "ps_4_0", &psBlob)) != NkErr_Ok)
+        return errCode;
+    hRes = ID3D11Device_CreatePixelShader(
+        resPtr->mp_devPtr,
+        ID3D10Blob_GetBufferPointer(psBlob),
+        ID3D10Blob_GetBufferSize(psBlob),
+        NULL,
+        &resPtr->mp_maskPS
+    );
+    __NkInt_D3D11_SafeRelease(psBlob);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+    if ((errCode = __NkInt_D3D11Renderer_CompileShader("PSAlpha", "ps_4_0", &psBlob)) != NkErr_Ok)
+        return errCode;
+    hRes = ID3D11Device_CreatePixelShader(
+        resPtr->mp_devPtr,
+        ID3D10Blob_GetBufferPointer(psBlob),
+        ID3D10Blob_GetBufferSize(psBlob),
+        NULL,
+        &resPtr->mp_alphaPS
+    );
+    __NkInt_D3D11_SafeRelease(psBlob);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+
+    /* Create the dynamic instance buffer and the constant buffer. */
+    hRes = ID3D11Device_CreateBuffer(resPtr->mp_devPtr, &(D3D11_BUFFER_DESC const){
+        .ByteWidth      = (UINT)(__NkInt_D3D11_MaxBatchSize * sizeof(__NkInt_D3D11QuadInstance)),
+        .Usage          = D3D11_USAGE_DYNAMIC,
+        .BindFlags      = D3D11_BIND_VERTEX_BUFFER,
+        .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE
+    }, NULL, &resPtr->mp_instBuf);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+    hRes = ID3D11Device_CreateBuffer(resPtr->mp_devPtr, &(D3D11_BUFFER_DESC const){
+        .ByteWidth = (UINT)sizeof(__NkInt_D3D11FrameConstants),
+        .Usage     = D3D11_USAGE_DEFAULT,
+        .BindFlags = D3D11_BIND_CONSTANT_BUFFER
+    }, NULL, &resPtr->mp_constBuf);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+
+    /* Create the state objects. */
+    hRes = ID3D11Device_CreateRasterizerState(resPtr->mp_devPtr, &(D3D11_RASTERIZER_DESC const){
+        .FillMode        = D3D11_FILL_SOLID,
+        .CullMode        = D3D11_CULL_NONE,
+        .DepthClipEnable = TRUE
+    }, &resPtr->mp_rsState);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+    /* Alpha textures are premultiplied, so the source only has to be added. */
+    hRes = ID3D11Device_CreateBlendState(resPtr->mp_devPtr, &(D3D11_BLEND_DESC const){
+        .RenderTarget[0] = {
+            .BlendEnable           = TRUE,
+            .SrcBlend              = D3D11_BLEND_ONE,
+            .DestBlend             = D3D11_BLEND_INV_SRC_ALPHA,
+            .BlendOp               = D3D11_BLEND_OP_ADD,
+            .SrcBlendAlpha         = D3D11_BLEND_ONE,
+            .DestBlendAlpha        = D3D11_BLEND_INV_SRC_ALPHA,
+            .BlendOpAlpha          = D3D11_BLEND_OP_ADD,
+            .RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL
+        }
+    }, &resPtr->mp_alphaBs);
+    if (FAILED(hRes))
+        goto lbl_ONERROR;
+
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    NK_LOG_ERROR("Could not create rendering pipeline objects. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+    return NkErr_CreateGpuResource;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_D3D11Renderer_CreateSampler(
+    _In_    NkTextureInterpolationMode iMode,
+    _Inout_ struct __NkInt_D3D11Resources *resPtr
+) {
+    HRESULT hRes = ID3D11Device_CreateSamplerState(resPtr->mp_devPtr, &(D3D11_SAMPLER_DESC const){
+        .Filter         = __NkInt_D3D11Renderer_MapToFilter(iMode),
+        .AddressU       = D3D11_TEXTURE_ADDRESS_CLAMP,
+        .AddressV       = D3D11_TEXTURE_ADDRESS_CLAMP,
+        .AddressW       = D3D11_TEXTURE_ADDRESS_CLAMP,
+        .ComparisonFunc = D3D11_COMPARISON_NEVER,
+        .MaxLOD         = D3D11_FLOAT32_MAX
+    }, &resPtr->mp_smpState);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create sampler state. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        return NkErr_CreateGpuResource;
+    }
+
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  creates the swap chain of the window
+ * \param  [in] wndHandle handle to the window the swap chain presents to
+ * \param  [in, out] resPtr pointer to the resources; the device must already exist
+ * \return \c NkErr_Ok on success, non-zero on failure
+ *
+ * \par Remarks
+ *   Flip-model swap chains hand their buffers to the compositor instead of having it copy
+ *   them into its own surface. If the window covers a whole monitor (see
+ *   <tt>NkWndMode_Fullscreen</tt>), the compositor is bypassed altogether. If supported,
+ *   tearing is allowed, so that presenting with VSync disabled is not held back until the
+ *   next refresh. Systems without <tt>DXGI_SWAP_EFFECT_FLIP_DISCARD</tt> get a blt-model
+ *   swap chain.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_D3D11Renderer_CreateSwapChain(
+    _In_    HWND wndHandle,
+    _Inout_ struct __NkInt_D3D11Resources *resPtr
+) {
+    NkErrorCode    errCode  = NkErr_Ok;
+    IDXGIDevice1  *dxgiDev  = NULL;
+    IDXGIAdapter  *dxgiAdap = NULL;
+    IDXGIFactory2 *dxgiFac  = NULL;
+
+    /* Retrieve the factory that created the adapter of the device. */
+    HRESULT hRes = ID3D11Device_QueryInterface(resPtr->mp_devPtr, &IID_IDXGIDevice1, (NkVoid **)&dxgiDev);
+    if (SUCCEEDED(hRes))
+        hRes = IDXGIDevice1_GetAdapter(dxgiDev, &dxgiAdap);
+    if (SUCCEEDED(hRes))
+        hRes = IDXGIAdapter_GetParent(dxgiAdap, &IID_IDXGIFactory2, (NkVoid **)&dxgiFac);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not retrieve DXGI factory. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        errCode = NkErr_CreateGraphicsDevice;
+        goto lbl_END;
+    }
+    /* Do not let the CPU run ahead of the display by more than one frame. */
+    IDXGIDevice1_SetMaximumFrameLatency(dxgiDev, 1);
+
+    /* Check whether presents may tear; this requires DXGI 1.5. */
+    BOOL           isTearing = FALSE;
+    IDXGIFactory5 *dxgiFac5  = NULL;
+    if (SUCCEEDED(IDXGIFactory2_QueryInterface(dxgiFac, &IID_IDXGIFactory5, (NkVoid **)&dxgiFac5))) {
+        if (FAILED(IDXGIFactory5_CheckFeatureSupport(dxgiFac5, DXGI_FEATURE_PRESENT_ALLOW_TEARING, &isTearing, sizeof isTearing)))
+            isTearing = FALSE;
+
+        __NkInt_D3D11_SafeRelease(dxgiFac5);
+    }
+
+    DXGI_SWAP_CHAIN_DESC1 swapDesc = {
+        .Width       = (UINT)resPtr->m_bbDim.m_width,
+        .Height      = (UINT)resPtr->m_bbDim.m_height,
+        .Format      = DXGI_FORMAT_B8G8R8A8_UNORM,
+        .SampleDesc  = { .Count = 1, .Quality = 0 },
+        .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
+        .BufferCount = 2,
+        .Scaling     = DXGI_SCALING_NONE,
+        .SwapEffect  = DXGI_SWAP_EFFECT_FLIP_DISCARD,
+        .AlphaMode   = DXGI_ALPHA_MODE_IGNORE,
+        .Flags       = isTearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0
+    };
+    hRes = IDXGIFactory2_CreateSwapChainForHwnd(dxgiFac, (IUnknown *)resPtr->mp_devPtr, wndHandle, &swapDesc, NULL, NULL, &resPtr->mp_swapChain);
+    if (FAILED(hRes)) {
+        NK_LOG_WARNING("Flip-model presentation is not supported; falling back to blt model. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        swapDesc.BufferCount = 1;
+        swapDesc.Scaling     = DXGI_SCALING_STRETCH;
+        swapDesc.SwapEffect  = DXGI_SWAP_EFFECT_DISCARD;
+        swapDesc.AlphaMode   = DXGI_ALPHA_MODE_UNSPECIFIED;
+        swapDesc.Flags       = 0;
+        hRes = IDXGIFactory2_CreateSwapChainForHwnd(dxgiFac, (IUnknown *)resPtr->mp_devPtr, wndHandle, &swapDesc, NULL, NULL, &resPtr->mp_swapChain);
+    }
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create swap chain. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        errCode = NkErr_CreateGraphicsDevice;
+        goto lbl_END;
+    }
+    /* Full-screen mode is managed by the window; keep DXGI from switching modes on Alt+Enter. */
+    IDXGIFactory2_MakeWindowAssociation(dxgiFac, wndHandle, DXGI_MWA_NO_ALT_ENTER);
+
+    resPtr->m_swapFlags = swapDesc.Flags;
+    resPtr->m_isTearing = (swapDesc.Flags & DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING) != 0;
+
+lbl_END:
+    __NkInt_D3D11_SafeRelease(dxgiFac);
+    __NkInt_D3D11_SafeRelease(dxgiAdap);
+    __NkInt_D3D11_SafeRelease(dxgiDev);
+    return errCode;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_CreateBasicResources(
+    _In_  NkRendererSpecification const *rdSpecs,
+    _Out_ struct __NkInt_D3D11Resources *resPtr
+) {
+    /**
+     * \brief feature levels we can work with; we only need shader model 4.0
+     */
+    NK_INTERNAL D3D_FEATURE_LEVEL const gl_c_FeatLevels[] = {
+        D3D_FEATURE_LEVEL_11_0,
+        D3D_FEATURE_LEVEL_10_1,
+        D3D_FEATURE_LEVEL_10_0
+    };
+
+    NkErrorCode errCode = NkErr_Ok;
+    *resPtr = (struct __NkInt_D3D11Resources){ .m_bbDim = rdSpecs->mp_wndRef->VT->GetClientDimensions(rdSpecs->mp_wndRef) };
+
+    /* Create the device and the swap chain for the window. */
+    HRESULT hRes = D3D11CreateDevice(
+        NULL,
+        D3D_DRIVER_TYPE_HARDWARE,
+        NULL,
+        D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+        gl_c_FeatLevels,
+        (UINT)NK_ARRAYSIZE(gl_c_FeatLevels),
+        D3D11_SDK_VERSION,
+        &resPtr->mp_devPtr,
+        NULL,
+        &resPtr->mp_devCxt
+    );
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create Direct3D 11 device. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        return NkErr_CreateGraphicsDevice;
+    }
+    HWND const wndHandle = (HWND)rdSpecs->mp_wndRef->VT->QueryNativeWindowHandle(rdSpecs->mp_wndRef);
+    if ((errCode = __NkInt_D3D11Renderer_CreateSwapChain(wndHandle, resPtr)) != NkErr_Ok)
+        goto lbl_ONERROR;
+
+    /* Create shaders, buffers, and state objects. */
+    if ((errCode = __NkInt_D3D11Renderer_CreatePipeline(resPtr)) != NkErr_Ok)
+        goto lbl_ONERROR;
+    if ((errCode = __NkInt_D3D11Renderer_CreateSampler(rdSpecs->m_texInterMode, resPtr)) != NkErr_Ok)
+        goto lbl_ONERROR;
+    /* Create the framebuffer. */
+    if ((errCode = __NkInt_D3D11Renderer_CreateFramebuffer(resPtr)) != NkErr_Ok)
+        goto lbl_ONERROR;
+#if (!defined NK_CONFIG_DEPLOY)
+    NkUint32 const vpBkgndCol = 0xFFFFFFFF;
+    errCode = __NkInt_D3D11Renderer_CreateTextureObject(
+        resPtr->mp_devPtr,
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        1,
+        1,
+        &vpBkgndCol,
+        sizeof vpBkgndCol,
+        &resPtr->m_vpBkgndTex
+    );
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+#endif /* NK_CONFIG_DEPLOY */
+
+    /* Calculate viewport origin. */
+    resPtr->m_vpOri = NkCalculateViewportOrigin(
+        rdSpecs->m_vpAlignment,
+        rdSpecs->m_vpExtents,
+        rdSpecs->m_dispTileSize,
+        resPtr->m_bbDim
+    );
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    __NkInt_D3D11Renderer_DestroyBasicResources(resPtr);
+
+    return errCode;
+}
+
+/**
+ * \brief submits all recorded quads of the current batch as one instanced draw call
+ * \param [in, out] rdRef pointer to the renderer instance
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_FlushBatch(_Inout_ __NkInt_D3D11Renderer *rdRef) {
+    struct __NkInt_D3D11Batch *batchPtr = &rdRef->m_batch;
+    if (batchPtr->m_nInst == 0)
+        return;
+
+    /* Upload instance data. */
+    D3D11_MAPPED_SUBRESOURCE mappedRes;
+    HRESULT hRes = ID3D11DeviceContext_Map(
+        rdRef->m_d3dRes.mp_devCxt,
+        (ID3D11Resource *)rdRef->m_d3dRes.mp_instBuf,
+        0,
+        D3D11_MAP_WRITE_DISCARD,
+        0,
+        &mappedRes
+    );
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not map instance buffer; dropping %u quads. HRESULT: 0x%08lX", batchPtr->m_nInst, (unsigned long)hRes);
+
+        batchPtr->m_nInst = 0;
+        return;
+    }
+    memcpy(mappedRes.pData, batchPtr->mp_instArr, batchPtr->m_nInst * sizeof *batchPtr->mp_instArr);
+    ID3D11DeviceContext_Unmap(rdRef->m_d3dRes.mp_devCxt, (ID3D11Resource *)rdRef->m_d3dRes.mp_instBuf, 0);
+
+    /* Bind the texture(s) and the appropriate pixel shader, then draw. */
+    ID3D11ShaderResourceView *srvArr[] = {
+        batchPtr->mp_currTex->mp_srvPtr,
+        batchPtr->mp_currMask != NULL ? batchPtr->mp_currMask->mp_srvPtr : NULL
+    };
+    ID3D11DeviceContext_PSSetShaderResources(rdRef->m_d3dRes.mp_devCxt, 0, (UINT)NK_ARRAYSIZE(srvArr), srvArr);
+    ID3D11PixelShader *pixShader = rdRef->m_d3dRes.mp_texPS;
+    if (batchPtr->mp_currMask != NULL)
+        pixShader = rdRef->m_d3dRes.mp_maskPS;
+    else if (batchPtr->mp_currTex->m_isAlpha)
+        pixShader = rdRef->m_d3dRes.mp_alphaPS;
+    ID3D11DeviceContext_PSSetShader(rdRef->m_d3dRes.mp_devCxt, pixShader, NULL, 0);
+    ID3D11DeviceContext_OMSetBlendState(
+        rdRef->m_d3dRes.mp_devCxt,
+        batchPtr->mp_currTex->m_isAlpha ? rdRef->m_d3dRes.mp_alphaBs : NULL,
+        NULL,
+        0xFFFFFFFF
+    );
+    ID3D11DeviceContext_DrawInstanced(rdRef->m_d3dRes.mp_devCxt, 4, batchPtr->m_nInst, 0, 0);
+
+    ++rdRef->m_frameStats.m_currStats.m_nSubmits;
+    batchPtr->m_nInst = 0;
+}
+
+/**
+ * \brief records a single quad into the current batch, flushing the batch if needed
+ * \param [in, out] rdRef pointer to the renderer instance
+ * \param [in] texPtr texture the quad samples from
+ * \param [in] maskPtr mask used for transparency (or <tt>NULL</tt>)
+ * \param [in] dstRect destination rectangle, in viewport space
+ * \param [in] srcRect normalized source rectangle, in texture pixels
+ * \param [in] maskOff offset into the mask bitmap, in pixels
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_PushQuad(
+    _Inout_  __NkInt_D3D11Renderer *rdRef,
+    _In_     __NkInt_D3D11Texture const *texPtr,
+    _In_opt_ __NkInt_D3D11Texture const *maskPtr,
+    _In_     NkRectF const *dstRect,
+    _In_     NkRectF const *srcRect,
+    _In_     NkVec2F maskOff
+) {
+    struct __NkInt_D3D11Batch *batchPtr = &rdRef->m_batch;
+
+    /* Start a new batch if the texture state changes or the current batch is full. */
+    if (batchPtr->mp_currTex != texPtr || batchPtr->mp_currMask != maskPtr || batchPtr->m_nInst == __NkInt_D3D11_MaxBatchSize) {
+        __NkInt_D3D11Renderer_FlushBatch(rdRef);
+
+        if (batchPtr->mp_currTex != texPtr || batchPtr->mp_currMask != maskPtr)
+            ++rdRef->m_frameStats.m_currStats.m_nTexBinds;
+        batchPtr->mp_currTex  = texPtr;
+        batchPtr->mp_currMask = maskPtr;
+    }
+
+    /*
+     * Count the quad the way the GDI renderer would have drawn it so that the statistics
+     * of both renderers can be compared. Masked quads are never scaled.
+     */
+    struct __NkInt_D3D11Statistics *statPtr = &rdRef->m_frameStats;
+    if (maskPtr != NULL)
+        ++statPtr->m_currStats.m_nMaskBlits;
+    else if (texPtr->m_isAlpha)
+        ++statPtr->m_currStats.m_nAlphaBlits;
+    else if (NkRendererCompareRectangles(srcRect, dstRect) == NK_TRUE)
+        ++statPtr->m_currStats.m_nBlits;
+    else
+        ++statPtr->m_currStats.m_nStretchBlits;
+    statPtr->m_currStats.m_nPxFilled += NkRendererCalculateArea(dstRect);
+
+    /* Record the instance. */
+    NkFloat const invTexW = 1.f / (NkFloat)texPtr->m_width;
+    NkFloat const invTexH = 1.f / (NkFloat)texPtr->m_height;
+    batchPtr->mp_instArr[batchPtr->m_nInst++] = (__NkInt_D3D11QuadInstance){
+        .m_dstRect  = {
+            dstRect->m_xCoord + (NkFloat)rdRef->m_currTgt.m_tgtOri.m_xCoord,
+            dstRect->m_yCoord + (NkFloat)rdRef->m_currTgt.m_tgtOri.m_yCoord,
+            dstRect->m_width,
+            dstRect->m_height
+        },
+        .m_srcRect  = {
+            srcRect->m_xCoord * invTexW,
+            srcRect->m_yCoord * invTexH,
+            srcRect->m_width  * invTexW,
+            srcRect->m_height * invTexH
+        },
+        .m_maskRect = {
+            maskPtr != NULL ? maskOff.m_xVal     / (NkFloat)maskPtr->m_width  : 0.f,
+            maskPtr != NULL ? maskOff.m_yVal     / (NkFloat)maskPtr->m_height : 0.f,
+            maskPtr != NULL ? srcRect->m_width  / (NkFloat)maskPtr->m_width  : 0.f,
+            maskPtr != NULL ? srcRect->m_height / (NkFloat)maskPtr->m_height : 0.f
+        }
+    };
+}
+
+/**
+ * \brief binds the given surface (or the framebuffer) as the current render target
+ * \param [in, out] rdRef pointer to the renderer instance
+ * \param [in] surfPtr surface to render to, or \c NULL for the framebuffer
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_BindTarget(
+    _Inout_  __NkInt_D3D11Renderer *rdRef,
+    _In_opt_ NkRendererResource const *surfPtr
+) {
+    /* Draw calls recorded so far belong to the old target. */
+    __NkInt_D3D11Renderer_FlushBatch(rdRef);
+
+    __NkInt_D3D11Texture const *surfObj = surfPtr != NULL ? (__NkInt_D3D11Texture const *)surfPtr->m_resHandle : NULL;
+    ID3D11RenderTargetView     *tgtView = surfObj != NULL ? surfObj->mp_rtvPtr : rdRef->m_d3dRes.mp_fbView;
+    NkSize2D const              tgtDim  = surfObj != NULL
+        ? (NkSize2D){ surfObj->m_width, surfObj->m_height }
+        : rdRef->m_d3dRes.m_bbDim
+    ;
+
+    /*
+     * Unbind all textures first; the new target may still be bound as a shader resource
+     * from an earlier batch.
+     */
+    ID3D11ShaderResourceView *nullSrvArr[2] = { NULL, NULL };
+    ID3D11DeviceContext_PSSetShaderResources(rdRef->m_d3dRes.mp_devCxt, 0, (UINT)NK_ARRAYSIZE(nullSrvArr), nullSrvArr);
+    rdRef->m_batch.mp_currTex  = NULL;
+    rdRef->m_batch.mp_currMask = NULL;
+
+    /* Bind the target and make the VS map to its extents. */
+    ID3D11DeviceContext_OMSetRenderTargets(rdRef->m_d3dRes.mp_devCxt, 1, &tgtView, NULL);
+    ID3D11DeviceContext_RSSetViewports(rdRef->m_d3dRes.mp_devCxt, 1, &(D3D11_VIEWPORT const){
+        .TopLeftX = 0.f,
+        .TopLeftY = 0.f,
+        .Width    = (FLOAT)tgtDim.m_width,
+        .Height   = (FLOAT)tgtDim.m_height,
+        .MinDepth = 0.f,
+        .MaxDepth = 1.f
+    });
+    ID3D11DeviceContext_UpdateSubresource(
+        rdRef->m_d3dRes.mp_devCxt,
+        (ID3D11Resource *)rdRef->m_d3dRes.mp_constBuf,
+        0,
+        NULL,
+        &(__NkInt_D3D11FrameConstants const){
+            .m_invBbDim = {
+                1.f / (NkFloat)NK_MAX(tgtDim.m_width, 1),
+                1.f / (NkFloat)NK_MAX(tgtDim.m_height, 1)
+            }
+        },
+        0,
+        0
+    );
+
+    rdRef->m_currTgt = (struct __NkInt_D3D11Target){
+        .mp_surfPtr = surfPtr,
+        .m_tgtOri   = surfPtr != NULL ? (NkPoint2D){ 0, 0 } : rdRef->m_d3dRes.m_vpOri
+    };
+}
+
+/**
+ */
+NK_INTERNAL NkRectF __NkInt_D3D11Renderer_NormalizeSourceRect(
+    _In_     __NkInt_D3D11Texture const *texPtr,
+    _In_opt_ NkRectF const *srcRect
+) {
+    /* Source rectangle is entirely "valid"; nothing to do. */
+    if (srcRect != NULL && srcRect->m_width != -1 && srcRect->m_height != -1)
+        return *srcRect;
+
+    /* Normalize upper-left corner. */
+    NkFloat const xCoord = srcRect ? srcRect->m_xCoord : 0.f;
+    NkFloat const yCoord = srcRect ? srcRect->m_yCoord : 0.f;
+    /* Normalize width and height. */
+    NkFloat const width  = !srcRect
+        ? (NkFloat)texPtr->m_width
+        : (srcRect->m_width < 0.f ? (NkFloat)texPtr->m_width - xCoord : srcRect->m_width)
+    ;
+    NkFloat const height = !srcRect
+        ? (NkFloat)texPtr->m_height
+        : (srcRect->m_height < 0.f ? (NkFloat)texPtr->m_height - yCoord : srcRect->m_height)
+    ;
+
+    return (NkRectF){ xCoord, yCoord, width, height };
+}
+
+/**
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_Destroy(_Inout_ __NkInt_D3D11Renderer *self) {
+    NK_LOG_INFO("shutdown: Direct3D 11 renderer");
+
+    /* Unbind everything prior to releasing it. */
+    if (self->m_d3dRes.mp_devCxt != NULL)
+        ID3D11DeviceContext_ClearState(self->m_d3dRes.mp_devCxt);
+
+    __NkInt_D3D11Renderer_DestroyBasicResources(&self->m_d3dRes);
+    NkGPFree((NkVoid *)self->m_batch.mp_instArr);
+
+    /* Release the parent window. */
+    self->mp_wndRef->VT->Release(self->mp_wndRef);
+}
+
+/**
+ */
+NK_INTERNAL NkVoid __NkInt_D3D11Renderer_InternalDeleteResource(
+    _Inout_ NkIRenderer *self,
+    _Inout_ NkRendererResource *resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to internal renderer structure. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    switch (resPtr->m_resType) {
+        case NkRdResTy_Texture:
+        case NkRdResTy_TextureMask:
+        case NkRdResTy_Surface:
+        case NkRdResTy_AlphaTexture: {
+            __NkInt_D3D11Texture *texPtr = (__NkInt_D3D11Texture *)resPtr->m_resHandle;
+
+            /* Surfaces that are currently rendered to are unbound first. */
+            if (rdRef->m_currTgt.mp_surfPtr == resPtr)
+                __NkInt_D3D11Renderer_BindTarget(rdRef, NULL);
+
+            /* If the texture is part of the pending batch, submit the batch first. */
+            if (rdRef->m_batch.mp_currTex == texPtr || rdRef->m_batch.mp_currMask == texPtr) {
+                __NkInt_D3D11Renderer_FlushBatch(rdRef);
+
+                rdRef->m_batch.mp_currTex  = NULL;
+                rdRef->m_batch.mp_currMask = NULL;
+            }
+
+            __NkInt_D3D11Renderer_DestroyTextureObject(texPtr);
+            NkGPFree((NkVoid *)texPtr);
+            break;
+        }
+        default:
+            NK_LOG_CRITICAL("Unknown resource type: %i", (int)resPtr->m_resType);
+#pragma warning (suppress: 4127)
+            NK_ASSERT_EXTRA(NK_FALSE, NkErr_InOutParameter, "Cannot delete resource of this type.");
+
+            return;
+    }
+
+    /*
+     * At last, release the reference to the renderer since the resource held a reference
+     * to it.
+     */
+    resPtr->mp_rdRef->VT->Release(resPtr->mp_rdRef);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_D3D11Renderer_AppropriateResource(
+    _Inout_        NkIRenderer *self,
+    _Maybe_reinit_ NkRendererResource **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Delete old resource if needed. */
+    if (*resPtr != NULL)
+        __NkInt_D3D11Renderer_InternalDeleteResource(self, *resPtr);
+    else {
+        /* Allocate new resource if it was NULL previously. */
+        NkErrorCode errCode = NkPoolAlloc(NULL, sizeof **resPtr, 1, resPtr);
+
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkIRenderer *__NkInt_D3D11Renderer_RefInstance(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    self->VT->AddRef(self);
+    return self;
+}
+
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_D3D11Renderer_AddRef(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return NkOMRefCountIncrement(&((__NkInt_D3D11Renderer *)self)->m_refCount, NkOMRcMd_ThreadLocal);
+}
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_D3D11Renderer_Release(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&((__NkInt_D3D11Renderer *)self)->m_refCount, NkOMRcMd_ThreadLocal);
+    if (newCount <= 0) {
+        __NkInt_D3D11Renderer_Destroy((__NkInt_D3D11Renderer *)self);
+
+        NkGPFree((NkVoid *)self);
+        return 0;
+    }
+
+    return newCount;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_QueryInterface(
+    _Inout_  NkIRenderer *self,
+    _In_     NkUuid const *iId,
+    _Outptr_ NkVoid **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(iId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    NK_INTERNAL NkOMImplementationInfo const gl_ImplInfos[] = {
+        { NKOM_IIDOF(NkIBase)          },
+        { NKOM_IIDOF(NkIInitializable) },
+        { NKOM_IIDOF(NkIRenderer)      },
+        { NKOM_IIDOF(NkID3D11Renderer) },
+        { NULL                         }
+    };
+    if (NkOMQueryImplementationIndex(gl_ImplInfos, iId) != SIZE_MAX) {
+        /* Interface is implemented. */
+        *resPtr = (NkVoid *)self;
+
+        __NkInt_D3D11Renderer_AddRef(self);
+        return NkErr_Ok;
+    }
+
+    /* Interface not implemented. */
+    *resPtr = NULL;
+    return NkErr_InterfaceNotImpl;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_Initialize(
+    _Inout_     NkIRenderer *self,
+    _Inout_opt_ NkVoid *initParam
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(initParam != NULL, NkErr_InParameter);
+
+    NK_LOG_INFO("startup: Direct3D 11 renderer");
+
+    /* Get the pointer to the renderer specification. */
+    NkRendererSpecification const *rdSpecs = (NkRendererSpecification const *)initParam;
+
+    /* Allocate the host-side instance array. */
+    NkErrorCode errCode;
+    __NkInt_D3D11QuadInstance *instArr;
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        __NkInt_D3D11_MaxBatchSize * sizeof *instArr,
+        0,
+        NK_FALSE,
+        (NkVoid **)&instArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+    /* Initialize main resources. */
+    struct __NkInt_D3D11Resources d3dRes;
+    if ((errCode = __NkInt_D3D11Renderer_CreateBasicResources(rdSpecs, &d3dRes)) != NkErr_Ok) {
+        NkGPFree((NkVoid *)instArr);
+
+        return errCode;
+    }
+    rdSpecs->mp_wndRef->VT->AddRef(rdSpecs->mp_wndRef);
+
+    /* Initialize renderer fields. */
+    *(__NkInt_D3D11Renderer *)self = (__NkInt_D3D11Renderer){
+        .NkID3D11Renderer_Iface.VT = self->VT,
+
+        .m_refCount = ((__NkInt_D3D11Renderer *)self)->m_refCount,
+        .mp_wndRef  = rdSpecs->mp_wndRef,
+        .m_initSpec = *rdSpecs,
+        .m_currSpec = *rdSpecs,
+        .m_batch    = { .mp_instArr = instArr },
+        .m_currTgt  = { NULL, d3dRes.m_vpOri }
+    };
+    memcpy(&((__NkInt_D3D11Renderer *)self)->m_d3dRes, &d3dRes, sizeof d3dRes);
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkRendererApi NK_CALL __NkInt_D3D11Renderer_QueryRendererApi(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    return NkRdApi_Direct3D11;
+}
+
+/**
+ */
+NK_INTERNAL NkRendererSpecification const *NK_CALL __NkInt_D3D11Renderer_QuerySpecification(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return &((__NkInt_D3D11Renderer *)self)->m_initSpec;
+}
+
+/**
+ */
+NK_INTERNAL NkIWindow *NK_CALL __NkInt_D3D11Renderer_QueryWindow(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    NkIWindow *wndRef = ((__NkInt_D3D11Renderer *)self)->mp_wndRef;
+
+    wndRef->VT->AddRef(wndRef);
+    return wndRef;
+}
+
+/**
+ */
+NK_INTERNAL NkSize2D NK_CALL __NkInt_D3D11Renderer_QueryViewportDimensions(_In_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to internal renderer state. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Calculate current viewport dimensions. */
+    return (NkSize2D) {
+        rdRef->m_currSpec.m_dispTileSize.m_width  * rdRef->m_currSpec.m_vpExtents.m_width,
+        rdRef->m_currSpec.m_dispTileSize.m_height * rdRef->m_currSpec.m_vpExtents.m_height
+    };
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_D3D11Renderer_QueryFrameStatistics(
+    _Inout_ NkIRenderer *self,
+    _Out_   NkRendererFrameStatistics *statPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(statPtr != NULL, NkErr_OutParameter);
+
+    *statPtr = ((__NkInt_D3D11Renderer *)self)->m_frameStats.m_lastStats;
+    statPtr->m_structSize = sizeof *statPtr;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_Resize(
+    _Inout_ NkIRenderer *self,
+    _In_    NkSize2D clAreaSize
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to internal renderer state. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Nothing to do if the window was minimized. */
+    if (clAreaSize.m_width == 0 || clAreaSize.m_height == 0)
+        return NkErr_Ok;
+
+    /* All references to the swap chain buffers must be released before resizing. */
+    __NkInt_D3D11Renderer_FlushBatch(rdRef);
+    __NkInt_D3D11Renderer_DestroyFramebuffer(&rdRef->m_d3dRes);
+
+    HRESULT hRes = IDXGISwapChain1_ResizeBuffers(
+        rdRef->m_d3dRes.mp_swapChain,
+        0,
+        (UINT)clAreaSize.m_width,
+        (UINT)clAreaSize.m_height,
+        DXGI_FORMAT_UNKNOWN,
+        rdRef->m_d3dRes.m_swapFlags
+    );
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR(
+            "Failed to resize swap chain. Requested Dimensions: (%llu, %llu). HRESULT: 0x%08lX",
+            clAreaSize.m_width,
+            clAreaSize.m_height,
+            (unsigned long)hRes
+        );
+
+        return NkErr_CreateGpuResource;
+    }
+    rdRef->m_d3dRes.m_bbDim = clAreaSize;
+
+    NkErrorCode errCode;
+    if ((errCode = __NkInt_D3D11Renderer_CreateFramebuffer(&rdRef->m_d3dRes)) != NkErr_Ok)
+        return errCode;
+
+    /* All went well. Recalculate viewport origin. */
+    rdRef->m_d3dRes.m_vpOri = NkCalculateViewportOrigin(
+        rdRef->m_currSpec.m_vpAlignment,
+        rdRef->m_currSpec.m_vpExtents,
+        rdRef->m_currSpec.m_dispTileSize,
+        rdRef->m_d3dRes.m_bbDim
+    );
+    __NkInt_D3D11Renderer_BindTarget(rdRef, NULL);
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_BeginDraw(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to renderer state. */
+    __NkInt_D3D11Renderer        *rdRef  = (__NkInt_D3D11Renderer *)self;
+    struct __NkInt_D3D11Resources *resPtr = &rdRef->m_d3dRes;
+    ID3D11DeviceContext          *devCxt = resPtr->mp_devCxt;
+
+    /* Start counting for the new frame. */
+    rdRef->m_frameStats.m_currStats  = (NkRendererFrameStatistics){
+        .m_structSize = sizeof(NkRendererFrameStatistics),
+        .m_frameInd   = rdRef->m_frameStats.m_lastStats.m_frameInd
+    };
+    rdRef->m_frameStats.m_beginTicks = NkTimerGetCurrentTicks();
+
+    /* Reset the batch. */
+    rdRef->m_batch.m_nInst      = 0;
+    rdRef->m_batch.mp_currTex   = NULL;
+    rdRef->m_batch.mp_currMask  = NULL;
+
+    /* Set up the pipeline. All draw calls share the same state except for the textures. */
+    UINT const instStride = (UINT)sizeof(__NkInt_D3D11QuadInstance);
+    UINT const instOffset = 0;
+    ID3D11DeviceContext_RSSetState(devCxt, resPtr->mp_rsState);
+    ID3D11DeviceContext_IASetPrimitiveTopology(devCxt, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    ID3D11DeviceContext_IASetInputLayout(devCxt, resPtr->mp_instLayout);
+    ID3D11DeviceContext_IASetVertexBuffers(devCxt, 0, 1, &resPtr->mp_instBuf, &instStride, &instOffset);
+    ID3D11DeviceContext_VSSetShader(devCxt, resPtr->mp_quadVS, NULL, 0);
+    ID3D11DeviceContext_VSSetConstantBuffers(devCxt, 0, 1, &resPtr->mp_constBuf);
+    ID3D11DeviceContext_PSSetSamplers(devCxt, 0, 1, &resPtr->mp_smpState);
+    /* Every frame starts out rendering to the framebuffer. */
+    __NkInt_D3D11Renderer_BindTarget(rdRef, NULL);
+
+    /* Clear the back buffer. */
+    FLOAT const clCol[] = {
+        rdRef->m_currSpec.m_clearCol.m_rVal / 255.f,
+        rdRef->m_currSpec.m_clearCol.m_gVal / 255.f,
+        rdRef->m_currSpec.m_clearCol.m_bVal / 255.f,
+        1.f
+    };
+    ID3D11DeviceContext_ClearRenderTargetView(devCxt, resPtr->mp_fbView, clCol);
+
+#if (!defined NK_CONFIG_DEPLOY)
+    /* Draw background of viewport. */
+    NkSize2D const vpDim = {
+        rdRef->m_currSpec.m_vpExtents.m_width  * rdRef->m_currSpec.m_dispTileSize.m_width,
+        rdRef->m_currSpec.m_vpExtents.m_height * rdRef->m_currSpec.m_dispTileSize.m_height
+    };
+
+    __NkInt_D3D11Renderer_PushQuad(
+        rdRef,
+        &resPtr->m_vpBkgndTex,
+        NULL,
+        &(NkRectF const){ 0.f, 0.f, (NkFloat)vpDim.m_width, (NkFloat)vpDim.m_height },
+        &(NkRectF const){ 0.f, 0.f, 1.f, 1.f },
+        (NkVec2F){ 0.f, 0.f }
+    );
+#endif /* NK_CONFIG_DEPLOY */
+
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_EndDraw(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to renderer state. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Submit the remaining quads and copy the framebuffer into the back buffer. */
+    __NkInt_D3D11Renderer_FlushBatch(rdRef);
+    NkUint64 const presTicks = NkTimerGetCurrentTicks();
+    ID3D11DeviceContext_CopyResource(
+        rdRef->m_d3dRes.mp_devCxt,
+        (ID3D11Resource *)rdRef->m_d3dRes.mp_bbTex,
+        (ID3D11Resource *)rdRef->m_d3dRes.mp_fbTex
+    );
+
+    /* Present and wait for VBlank if necessary; without VSync, do not wait at all. */
+    NkBoolean const isVSync = rdRef->m_currSpec.m_isVSync;
+    HRESULT         hRes    = IDXGISwapChain1_Present(
+        rdRef->m_d3dRes.mp_swapChain,
+        isVSync ? 1 : 0,
+        !isVSync && rdRef->m_d3dRes.m_isTearing ? DXGI_PRESENT_ALLOW_TEARING : 0
+    );
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not present frame. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        return NkErr_CreateGraphicsDevice;
+    }
+
+    /* Publish the statistics of the frame. */
+    struct __NkInt_D3D11Statistics *statPtr  = &rdRef->m_frameStats;
+    NkDouble const                  tickToMs = 1000. / (NkDouble)NkTimerGetFrequency();
+
+    statPtr->m_currStats.m_drawTime     = (NkDouble)(presTicks - statPtr->m_beginTicks) * tickToMs;
+    statPtr->m_currStats.m_presentTime  = (NkDouble)(NkTimerGetCurrentTicks() - presTicks) * tickToMs;
+    statPtr->m_currStats.m_nPxPresented = (NkUint64)rdRef->m_d3dRes.m_bbDim.m_width * (NkUint64)rdRef->m_d3dRes.m_bbDim.m_height;
+    ++statPtr->m_currStats.m_frameInd;
+    statPtr->m_lastStats = statPtr->m_currStats;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_SetStaticRegions(
+    _Inout_          NkIRenderer *self,
+    _In_             NkSize count,
+    _I_array_(count) NkRectF const *rects,
+    _Out_opt_        NkBoolean *isPreservedPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(count == 0 || rects != NULL, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(count);
+    NK_UNREFERENCED_PARAMETER(rects);
+
+    /* The swap chain always presents entire frames, so everything is redrawn anyway. */
+    if (isPreservedPtr != NULL)
+        *isPreservedPtr = NK_FALSE;
+    return NkErr_NotImplemented;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_D3D11Renderer_InvalidateFrame(_Inout_ NkIRenderer *self) {
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Every frame is presented in its entirety; nothing to do. */
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_DrawTexture(
+    _Inout_  NkIRenderer *self,
+    _In_     NkRectF const *dstRect,
+    _In_     NkRendererResource const *texPtr,
+    _In_opt_ NkRectF const *srcRect
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+    NK_ASSERT(texPtr != NULL && __NkInt_D3D11Renderer_IsTexture(texPtr), NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer      *rdRef  = (__NkInt_D3D11Renderer *)self;
+    __NkInt_D3D11Texture const *texObj = (__NkInt_D3D11Texture const *)texPtr->m_resHandle;
+
+    /* Record the quad. Scaling is done implicitly by the GPU. */
+    NkRectF const normSrcRect = __NkInt_D3D11Renderer_NormalizeSourceRect(texObj, srcRect);
+    __NkInt_D3D11Renderer_PushQuad(rdRef, texObj, NULL, dstRect, &normSrcRect, (NkVec2F){ 0.f, 0.f });
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_DrawTextureBatch(
+    _Inout_              NkIRenderer *self,
+    _In_                 NkRendererResource const *texPtr,
+    _In_                 NkSize count,
+    _I_array_(count)     NkRectF const *dstRects,
+    _I_array_opt_(count) NkRectF const *srcRects
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(texPtr != NULL && __NkInt_D3D11Renderer_IsTexture(texPtr), NkErr_InParameter);
+    NK_ASSERT(count == 0 || dstRects != NULL, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer      *rdRef  = (__NkInt_D3D11Renderer *)self;
+    __NkInt_D3D11Texture const *texObj = (__NkInt_D3D11Texture const *)texPtr->m_resHandle;
+
+    /* Record all quads; they will end up in the same instanced draw call. */
+    for (NkSize i = 0; i < count; i++) {
+        NkRectF const normSrcRect = __NkInt_D3D11Renderer_NormalizeSourceRect(
+            texObj,
+            srcRects != NULL ? &srcRects[i] : NULL
+        );
+
+        __NkInt_D3D11Renderer_PushQuad(rdRef, texObj, NULL, &dstRects[i], &normSrcRect, (NkVec2F){ 0.f, 0.f });
+    }
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_DrawMaskedTexture(
+    _Inout_ NkIRenderer *self,
+    _In_    NkRectF const *dstRect,
+    _In_    NkRendererResource const *texPtr,
+    _In_    NkVec2F srcOff,
+    _In_    NkRendererResource const *maskPtr,
+    _In_    NkVec2F maskOff
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+    NK_ASSERT(texPtr != NULL && __NkInt_D3D11Renderer_IsTexture(texPtr), NkErr_InParameter);
+    NK_ASSERT(maskPtr != NULL && maskPtr->m_resType == NkRdResTy_TextureMask, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Like with the GDI renderer, the source has the same extents as the destination. */
+    __NkInt_D3D11Renderer_PushQuad(
+        rdRef,
+        (__NkInt_D3D11Texture const *)texPtr->m_resHandle,
+        (__NkInt_D3D11Texture const *)maskPtr->m_resHandle,
+        dstRect,
+        &(NkRectF const){ srcOff.m_xVal, srcOff.m_yVal, dstRect->m_width, dstRect->m_height },
+        maskOff
+    );
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_SetRenderTarget(
+    _Inout_  NkIRenderer *self,
+    _In_opt_ NkRendererResource const *surfPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfPtr == NULL || surfPtr->m_resType == NkRdResTy_Surface, NkErr_InParameter);
+
+    __NkInt_D3D11Renderer_BindTarget((__NkInt_D3D11Renderer *)self, surfPtr);
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_ScrollSurface(
+    _Inout_ NkIRenderer *self,
+    _In_    NkRendererResource const *surfPtr,
+    _In_    NkPoint2D scrollOff
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfPtr != NULL && surfPtr->m_resType == NkRdResTy_Surface, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer *rdRef   = (__NkInt_D3D11Renderer *)self;
+    __NkInt_D3D11Texture  *surfObj = (__NkInt_D3D11Texture *)surfPtr->m_resHandle;
+
+    /* Nothing to do if the entire contents are scrolled out of the surface. */
+    NkInt64 const absX = scrollOff.m_xCoord < 0 ? -scrollOff.m_xCoord : scrollOff.m_xCoord;
+    NkInt64 const absY = scrollOff.m_yCoord < 0 ? -scrollOff.m_yCoord : scrollOff.m_yCoord;
+    if ((absX == 0 && absY == 0) || absX >= (NkInt64)surfObj->m_width || absY >= (NkInt64)surfObj->m_height)
+        return NkErr_Ok;
+
+    /*
+     * Direct3D does not support overlapping copies within the same resource. Therefore,
+     * copy the contents into the (lazily created) scratch texture first, and from there
+     * back into the surface at the new position.
+     */
+    if (surfObj->mp_scratchTex == NULL) {
+        HRESULT hRes = ID3D11Device_CreateTexture2D(rdRef->m_d3dRes.mp_devPtr, &(D3D11_TEXTURE2D_DESC const){
+            .Width          = (UINT)surfObj->m_width,
+            .Height         = (UINT)surfObj->m_height,
+            .MipLevels      = 1,
+            .ArraySize      = 1,
+            .Format         = DXGI_FORMAT_B8G8R8A8_UNORM,
+            .SampleDesc     = { .Count = 1, .Quality = 0 },
+            .Usage          = D3D11_USAGE_DEFAULT,
+            .BindFlags      = 0,
+            .CPUAccessFlags = 0,
+            .MiscFlags      = 0
+        }, NULL, &surfObj->mp_scratchTex);
+        if (FAILED(hRes)) {
+            NK_LOG_ERROR("Could not create scratch texture for scrolling. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+            return NkErr_CreateGpuResource;
+        }
+    }
+    /* Pending draw calls into the surface must land before we copy it. */
+    if (rdRef->m_currTgt.mp_surfPtr == surfPtr)
+        __NkInt_D3D11Renderer_FlushBatch(rdRef);
+    ID3D11DeviceContext_CopyResource(rdRef->m_d3dRes.mp_devCxt, (ID3D11Resource *)surfObj->mp_scratchTex, (ID3D11Resource *)surfObj->mp_texPtr);
+
+    /* Copy the part that is still visible after scrolling. */
+    UINT const srcX = (UINT)(scrollOff.m_xCoord < 0 ? absX : 0);
+    UINT const srcY = (UINT)(scrollOff.m_yCoord < 0 ? absY : 0);
+    UINT const dstX = (UINT)(scrollOff.m_xCoord > 0 ? absX : 0);
+    UINT const dstY = (UINT)(scrollOff.m_yCoord > 0 ? absY : 0);
+    ID3D11DeviceContext_CopySubresourceRegion(
+        rdRef->m_d3dRes.mp_devCxt,
+        (ID3D11Resource *)surfObj->mp_texPtr,
+        0,
+        dstX,
+        dstY,
+        0,
+        (ID3D11Resource *)surfObj->mp_scratchTex,
+        0,
+        &(D3D11_BOX const){
+            .left   = srcX,
+            .top    = srcY,
+            .front  = 0,
+            .right  = srcX + surfObj->m_width  - (UINT)absX,
+            .bottom = srcY + surfObj->m_height - (UINT)absY,
+            .back   = 1
+        }
+    );
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_CreateTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Query bitmap specification. */
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
+    if (bmSpecs->m_bitsPerPx != 24 && bmSpecs->m_bitsPerPx != 32)
+        return NkErr_InvBitDepth;
+    NkUint32 const width    = (NkUint32)bmSpecs->m_bmpWidth;
+    NkUint32 const height   = (NkUint32)(bmSpecs->m_bmpHeight < 0 ? -bmSpecs->m_bmpHeight : bmSpecs->m_bmpHeight);
+    NkUint32 const pxWidth  = bmSpecs->m_bitsPerPx >> 3;
+    /* Positive heights denote bottom-up bitmaps, just like with GDI. */
+    NkBoolean const isBtmUp = bmSpecs->m_bmpHeight > 0;
+
+    /*
+     * Convert the DIB pixels into top-down 32-bit BGRA pixels since that is the format
+     * the texture is created with. Alpha is always opaque.
+     */
+    NkUint32 *texPx;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)width * height * sizeof *texPx, 0, NK_FALSE, (NkVoid **)&texPx);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkByte const *dibPx = NkDIBitmapGetPixels(dibPtr, NULL);
+    for (NkUint32 y = 0; y < height; y++) {
+        NkByte const *srcRow = dibPx + (NkSize)(isBtmUp ? height - 1 - y : y) * bmSpecs->m_bmpStride;
+        NkUint32     *dstRow = texPx + (NkSize)y * width;
+
+        if (pxWidth == 3)
+            NkPixelConvert24To32(dstRow, srcRow, width, 0xFF);
+        else
+            NkPixelSetAlpha32(dstRow, srcRow, width, 0xFF);
+    }
+
+    /* Create device texture. */
+    __NkInt_D3D11Texture *texObj;
+    if ((errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *texObj, 0, NK_FALSE, (NkVoid **)&texObj)) != NkErr_Ok) {
+        NkGPFree((NkVoid *)texPx);
+
+        return errCode;
+    }
+    errCode = __NkInt_D3D11Renderer_CreateTextureObject(
+        rdRef->m_d3dRes.mp_devPtr,
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        width,
+        height,
+        texPx,
+        width * sizeof *texPx,
+        texObj
+    );
+    NkGPFree((NkVoid *)texPx);
+    if (errCode != NkErr_Ok) {
+        NkGPFree((NkVoid *)texObj);
+
+        return errCode;
+    }
+
+    /*
+     * Initialize the result structure. But first, we must check if the result structure
+     * is already valid. In such a case, we must first delete the old instance. This
+     * allows us to reuse instances without having to reallocate memory all the time.
+     */
+    if ((errCode = __NkInt_D3D11Renderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        __NkInt_D3D11Renderer_DestroyTextureObject(texObj);
+        NkGPFree((NkVoid *)texObj);
+
+        return errCode;
+    }
+
+    /* (Re-)initialize result structure. */
+    **resourcePtr = (NkRendererResource){
+        .mp_rdRef    = __NkInt_D3D11Renderer_RefInstance(self),
+        .m_resType   = NkRdResTy_Texture,
+        .m_resHandle = (NkRendererResourceHandle)texObj,
+        .m_resFlags  = NkRdResFlag_DeviceDependent,
+        .m_resDim    = { texObj->m_width, texObj->m_height }
+    };
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_CreateAlphaTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _In_opt_       NkRgbaColor const *colKey,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_OutptrParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Convert the bitmap into premultiplied top-down pixels. */
+    NkUint32 *alphaPx;
+    NkErrorCode errCode = NkRendererPremultiplyBitmap(dibPtr, colKey, &alphaPx);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
+    NkUint32 const width  = (NkUint32)bmSpecs->m_bmpWidth;
+    NkUint32 const height = (NkUint32)(bmSpecs->m_bmpHeight < 0 ? -bmSpecs->m_bmpHeight : bmSpecs->m_bmpHeight);
+
+    /* Create device texture. */
+    __NkInt_D3D11Texture *texObj;
+    if ((errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *texObj, 0, NK_FALSE, (NkVoid **)&texObj)) != NkErr_Ok) {
+        NkGPFree((NkVoid *)alphaPx);
+
+        return errCode;
+    }
+    errCode = __NkInt_D3D11Renderer_CreateTextureObject(
+        rdRef->m_d3dRes.mp_devPtr,
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        width,
+        height,
+        alphaPx,
+        width * sizeof *alphaPx,
+        texObj
+    );
+    NkGPFree((NkVoid *)alphaPx);
+    if (errCode != NkErr_Ok) {
+        NkGPFree((NkVoid *)texObj);
+
+        return errCode;
+    }
+    texObj->m_isAlpha = NK_TRUE;
+
+    /* Create new resource, delete old if needed. */
+    if ((errCode = __NkInt_D3D11Renderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        __NkInt_D3D11Renderer_DestroyTextureObject(texObj);
+        NkGPFree((NkVoid *)texObj);
+
+        return errCode;
+    }
+    /* (Re-)initialize new resource. */
+    **resourcePtr = (NkRendererResource){
+        .mp_rdRef    = __NkInt_D3D11Renderer_RefInstance(self),
+        .m_resType   = NkRdResTy_AlphaTexture,
+        .m_resHandle = (NkRendererResourceHandle)texObj,
+        .m_resFlags  = NkRdResFlag_DeviceDependent,
+        .m_resDim    = { texObj->m_width, texObj->m_height }
+    };
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_CreateTextureMask(
+    _Inout_        NkIRenderer *self,
+    _In_           NkRendererResource const *texPtr,
+    _In_           NkRgbaColor colKey,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(texPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_OutptrParameter);
+    NK_ASSERT(texPtr->m_resType == NkRdResTy_Texture, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer      *rdRef  = (__NkInt_D3D11Renderer *)self;
+    __NkInt_D3D11Texture const *srcTex = (__NkInt_D3D11Texture const *)texPtr->m_resHandle;
+
+    /*
+     * The source texture is immutable, so we have to read it back through a staging
+     * texture first. Mask creation is a load-time operation, so this is acceptable.
+     */
+    ID3D11Texture2D *stagTex;
+    HRESULT hRes = ID3D11Device_CreateTexture2D(rdRef->m_d3dRes.mp_devPtr, &(D3D11_TEXTURE2D_DESC const){
+        .Width          = (UINT)srcTex->m_width,
+        .Height         = (UINT)srcTex->m_height,
+        .MipLevels      = 1,
+        .ArraySize      = 1,
+        .Format         = DXGI_FORMAT_B8G8R8A8_UNORM,
+        .SampleDesc     = { .Count = 1, .Quality = 0 },
+        .Usage          = D3D11_USAGE_STAGING,
+        .BindFlags      = 0,
+        .CPUAccessFlags = D3D11_CPU_ACCESS_READ,
+        .MiscFlags      = 0
+    }, NULL, &stagTex);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create staging texture. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        return NkErr_CreateGpuResource;
+    }
+    ID3D11DeviceContext_CopyResource(rdRef->m_d3dRes.mp_devCxt, (ID3D11Resource *)stagTex, (ID3D11Resource *)srcTex->mp_texPtr);
+
+    /* Allocate the mask pixel buffer (one byte per pixel). */
+    NkByte *maskPx;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)srcTex->m_width * srcTex->m_height, 0, NK_FALSE, (NkVoid **)&maskPx);
+    if (errCode != NkErr_Ok) {
+        __NkInt_D3D11_SafeRelease(stagTex);
+
+        return errCode;
+    }
+
+    /* Map key color to 0 (transparent) and all other colors to 0xFF (opaque). */
+    D3D11_MAPPED_SUBRESOURCE mappedRes;
+    hRes = ID3D11DeviceContext_Map(rdRef->m_d3dRes.mp_devCxt, (ID3D11Resource *)stagTex, 0, D3D11_MAP_READ, 0, &mappedRes);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not map staging texture. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        NkGPFree((NkVoid *)maskPx);
+        __NkInt_D3D11_SafeRelease(stagTex);
+        return NkErr_CopyDDBPixels;
+    }
+    NkUint32 const keyPx = (NkUint32)colKey.m_rVal << 16 | (NkUint32)colKey.m_gVal << 8 | (NkUint32)colKey.m_bVal;
+    for (NkUint32 y = 0; y < srcTex->m_height; y++) {
+        NkByte const *srcRow = (NkByte const *)mappedRes.pData + (NkSize)y * mappedRes.RowPitch;
+
+        NkPixelColorKeyMask32(maskPx + (NkSize)y * srcTex->m_width, srcRow, srcTex->m_width, keyPx);
+    }
+    ID3D11DeviceContext_Unmap(rdRef->m_d3dRes.mp_devCxt, (ID3D11Resource *)stagTex, 0);
+    __NkInt_D3D11_SafeRelease(stagTex);
+
+    /* Create the mask texture. */
+    __NkInt_D3D11Texture *maskObj;
+    if ((errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *maskObj, 0, NK_FALSE, (NkVoid **)&maskObj)) != NkErr_Ok) {
+        NkGPFree((NkVoid *)maskPx);
+
+        return errCode;
+    }
+    errCode = __NkInt_D3D11Renderer_CreateTextureObject(
+        rdRef->m_d3dRes.mp_devPtr,
+        DXGI_FORMAT_R8_UNORM,
+        srcTex->m_width,
+        srcTex->m_height,
+        maskPx,
+        srcTex->m_width,
+        maskObj
+    );
+    NkGPFree((NkVoid *)maskPx);
+    if (errCode != NkErr_Ok) {
+        NkGPFree((NkVoid *)maskObj);
+
+        return errCode;
+    }
+
+    /* Create new resource, delete old if needed. */
+    if ((errCode = __NkInt_D3D11Renderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        __NkInt_D3D11Renderer_DestroyTextureObject(maskObj);
+        NkGPFree((NkVoid *)maskObj);
+
+        return errCode;
+    }
+    /* (Re-)initialize new resource. */
+    **resourcePtr = (NkRendererResource){
+        .mp_rdRef    = __NkInt_D3D11Renderer_RefInstance(self),
+        .m_resType   = NkRdResTy_TextureMask,
+        .m_resHandle = (NkRendererResourceHandle)maskObj,
+        .m_resFlags  = NkRdResFlag_DeviceDependent,
+        .m_resDim    = { maskObj->m_width, maskObj->m_height }
+    };
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_CreateSurface(
+    _Inout_        NkIRenderer *self,
+    _In_           NkSize2D surfDim,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfDim.m_width > 0 && surfDim.m_height > 0, NkErr_InParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_OutptrParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Allocate the surface object. */
+    __NkInt_D3D11Texture *surfObj;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *surfObj, 0, NK_TRUE, (NkVoid **)&surfObj);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    surfObj->m_width  = (NkUint32)surfDim.m_width;
+    surfObj->m_height = (NkUint32)surfDim.m_height;
+
+    /* Create a texture that can be both rendered to and sampled from. */
+    HRESULT hRes = ID3D11Device_CreateTexture2D(rdRef->m_d3dRes.mp_devPtr, &(D3D11_TEXTURE2D_DESC const){
+        .Width          = (UINT)surfDim.m_width,
+        .Height         = (UINT)surfDim.m_height,
+        .MipLevels      = 1,
+        .ArraySize      = 1,
+        .Format         = DXGI_FORMAT_B8G8R8A8_UNORM,
+        .SampleDesc     = { .Count = 1, .Quality = 0 },
+        .Usage          = D3D11_USAGE_DEFAULT,
+        .BindFlags      = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE,
+        .CPUAccessFlags = 0,
+        .MiscFlags      = 0
+    }, NULL, &surfObj->mp_texPtr);
+    if (SUCCEEDED(hRes))
+        hRes = ID3D11Device_CreateShaderResourceView(rdRef->m_d3dRes.mp_devPtr, (ID3D11Resource *)surfObj->mp_texPtr, NULL, &surfObj->mp_srvPtr);
+    if (SUCCEEDED(hRes))
+        hRes = ID3D11Device_CreateRenderTargetView(rdRef->m_d3dRes.mp_devPtr, (ID3D11Resource *)surfObj->mp_texPtr, NULL, &surfObj->mp_rtvPtr);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create surface. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        __NkInt_D3D11Renderer_DestroyTextureObject(surfObj);
+        NkGPFree((NkVoid *)surfObj);
+        return NkErr_CreateGpuResource;
+    }
+
+    /* Create new resource, delete old if needed. */
+    if ((errCode = __NkInt_D3D11Renderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        __NkInt_D3D11Renderer_DestroyTextureObject(surfObj);
+        NkGPFree((NkVoid *)surfObj);
+
+        return errCode;
+    }
+    /* (Re-)initialize new resource. */
+    **resourcePtr = (NkRendererResource){
+        .mp_rdRef    = __NkInt_D3D11Renderer_RefInstance(self),
+        .m_resType   = NkRdResTy_Surface,
+        .m_resHandle = (NkRendererResourceHandle)surfObj,
+        .m_resFlags  = NkRdResFlag_DeviceDependent,
+        .m_resDim    = surfDim
+    };
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_DeleteResource(
+    _Inout_      NkIRenderer *self,
+    _Uninit_ptr_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resourcePtr != NULL && *resourcePtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT((*resourcePtr)->mp_rdRef == self, NkErr_InOutParameter);
+
+    /* Delete the resource on the device first. */
+    __NkInt_D3D11Renderer_InternalDeleteResource(self, *resourcePtr);
+
+    /* Deallocate memory on host. */
+    NkPoolFree(*resourcePtr);
+    *resourcePtr = NULL;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_CopyFramebuffer(
+    _Inout_ NkIRenderer *self,
+    _Inout_ NkDIBitmap *bmpPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(bmpPtr != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer *rdRef  = (__NkInt_D3D11Renderer *)self;
+    NkUint32 const         width  = (NkUint32)rdRef->m_d3dRes.m_bbDim.m_width;
+    NkUint32 const         height = (NkUint32)rdRef->m_d3dRes.m_bbDim.m_height;
+
+    NkBitmapSpecification const *bmpSpecs = NkDIBitmapGetSpecification(bmpPtr);
+    if ((NkUint32)bmpSpecs->m_bmpWidth != width || (NkUint32)bmpSpecs->m_bmpHeight != height || bmpSpecs->m_bitsPerPx != 32)
+        return NkErr_InvImageDimensions;
+
+    /*
+     * Copy the framebuffer into a staging texture so that we can read it. The staging
+     * texture is kept until the framebuffer is recreated so that repeated captures do not
+     * allocate GPU memory each time.
+     */
+    if (rdRef->m_d3dRes.mp_stagTex == NULL) {
+        HRESULT const hRes = ID3D11Device_CreateTexture2D(rdRef->m_d3dRes.mp_devPtr, &(D3D11_TEXTURE2D_DESC const){
+            .Width          = (UINT)width,
+            .Height         = (UINT)height,
+            .MipLevels      = 1,
+            .ArraySize      = 1,
+            .Format         = DXGI_FORMAT_B8G8R8A8_UNORM,
+            .SampleDesc     = { .Count = 1, .Quality = 0 },
+            .Usage          = D3D11_USAGE_STAGING,
+            .BindFlags      = 0,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_READ,
+            .MiscFlags      = 0
+        }, NULL, &rdRef->m_d3dRes.mp_stagTex);
+        if (FAILED(hRes)) {
+            NK_LOG_ERROR("Could not create staging texture for screenshot. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+            return NkErr_CreateGpuResource;
+        }
+    }
+    __NkInt_D3D11Renderer_FlushBatch(rdRef);
+    ID3D11DeviceContext_CopyResource(
+        rdRef->m_d3dRes.mp_devCxt,
+        (ID3D11Resource *)rdRef->m_d3dRes.mp_stagTex,
+        (ID3D11Resource *)rdRef->m_d3dRes.mp_fbTex
+    );
+
+    /* Copy the pixels; the DIB is bottom-up, the texture is top-down. */
+    D3D11_MAPPED_SUBRESOURCE mappedRes;
+    HRESULT hRes = ID3D11DeviceContext_Map(
+        rdRef->m_d3dRes.mp_devCxt,
+        (ID3D11Resource *)rdRef->m_d3dRes.mp_stagTex,
+        0,
+        D3D11_MAP_READ,
+        0,
+        &mappedRes
+    );
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("There was an error copying framebuffer pixels to the DIB. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        return NkErr_CopyDDBPixels;
+    }
+    NkUint32 const dibStride = bmpSpecs->m_bmpStride;
+    NkByte        *dibPx     = NkDIBitmapGetPixels(bmpPtr, NULL);
+    for (NkUint32 y = 0; y < height; y++)
+        memcpy(
+            dibPx + (NkSize)(height - 1 - y) * dibStride,
+            (NkByte const *)mappedRes.pData + (NkSize)y * mappedRes.RowPitch,
+            (NkSize)width * 4
+        );
+    ID3D11DeviceContext_Unmap(rdRef->m_d3dRes.mp_devCxt, (ID3D11Resource *)rdRef->m_d3dRes.mp_stagTex, 0);
+
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_D3D11Renderer_GrabFramebuffer(
+    _Inout_ NkIRenderer *self,
+    _Out_   NkDIBitmap *resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_D3D11Renderer *rdRef = (__NkInt_D3D11Renderer *)self;
+
+    /* Create bitmap of the appropriate size that will hold the framebuffer. */
+    NkErrorCode errCode = NkDIBitmapCreate(&(NkBitmapSpecification){
+        .m_structSize = sizeof(NkBitmapSpecification),
+        .m_bmpWidth   = (NkInt32)rdRef->m_d3dRes.m_bbDim.m_width,
+        .m_bmpHeight  = (NkInt32)rdRef->m_d3dRes.m_bbDim.m_height,
+        .m_bitsPerPx  = 32,
+        .m_bmpFlags   = NkBmpFlag_Flipped
+    }, NULL, resPtr);
+    if (errCode != NkErr_Ok) {
+        /* Failed to create the bitmap. */
+        NK_LOG_ERROR(
+            "Could not create DIB for screenshot. Reason: %s (%i)",
+            NkGetErrorCodeStr(errCode)->mp_dataPtr,
+            errCode
+        );
+
+        return errCode;
+    }
+
+    if ((errCode = __NkInt_D3D11Renderer_CopyFramebuffer(self, resPtr)) != NkErr_Ok)
+        NkDIBitmapDestroy(resPtr);
+    return errCode;
+}
+
+
+/**
+ * \brief VTable for the NkID3D11Renderer class
+ */
+NKOM_DEFINE_VTABLE(NkIRenderer) {
+    .QueryInterface          = &__NkInt_D3D11Renderer_QueryInterface,
+    .AddRef                  = &__NkInt_D3D11Renderer_AddRef,
+    .Release                 = &__NkInt_D3D11Renderer_Release,
+    .Initialize              = &__NkInt_D3D11Renderer_Initialize,
+    .QueryRendererApi        = &__NkInt_D3D11Renderer_QueryRendererApi,
+    .QuerySpecification      = &__NkInt_D3D11Renderer_QuerySpecification,
+    .QueryWindow             = &__NkInt_D3D11Renderer_QueryWindow,
+    .QueryViewportDimensions = &__NkInt_D3D11Renderer_QueryViewportDimensions,
+    .QueryFrameStatistics    = &__NkInt_D3D11Renderer_QueryFrameStatistics,
+    .Resize                  = &__NkInt_D3D11Renderer_Resize,
+    .BeginDraw               = &__NkInt_D3D11Renderer_BeginDraw,
+    .EndDraw                 = &__NkInt_D3D11Renderer_EndDraw,
+    .SetStaticRegions        = &__NkInt_D3D11Renderer_SetStaticRegions,
+    .InvalidateFrame         = &__NkInt_D3D11Renderer_InvalidateFrame,
+    .DrawTexture             = &__NkInt_D3D11Renderer_DrawTexture,
+    .DrawTextureBatch        = &__NkInt_D3D11Renderer_DrawTextureBatch,
+    .DrawMaskedTexture       = &__NkInt_D3D11Renderer_DrawMaskedTexture,
+    .SetRenderTarget         = &__NkInt_D3D11Renderer_SetRenderTarget,
+    .ScrollSurface           = &__NkInt_D3D11Renderer_ScrollSurface,
+    .CreateTexture           = &__NkInt_D3D11Renderer_CreateTexture,
+    .CreateAlphaTexture      = &__NkInt_D3D11Renderer_CreateAlphaTexture,
+    .CreateTextureMask       = &__NkInt_D3D11Renderer_CreateTextureMask,
+    .CreateSurface           = &__NkInt_D3D11Renderer_CreateSurface,
+    .DeleteResource          = &__NkInt_D3D11Renderer_DeleteResource,
+    .GrabFramebuffer         = &__NkInt_D3D11Renderer_GrabFramebuffer,
+    .CopyFramebuffer         = &__NkInt_D3D11Renderer_CopyFramebuffer
+};
+
+/**
+ * \brief defines the implementation details of the Direct3D 11 renderer class (for
+ *        exposure to the global renderer factory)
+ */
+NkOMImplementationInfo const __gl_D3D11RdImplInfo__ = {
+    .mp_uuidRef       = NKOM_CLSIDOF(NkID3D11Renderer),
+    .m_structSize     = sizeof(__NkInt_D3D11Renderer),
+    .m_isAggSupported = NK_FALSE,
+    .mp_vtabPtr       = (NkVoid *)&NKOM_VTABLEOF(NkIRenderer)
+};
+/** \endcond */
+#endif /* NK_TARGET_WINDOWS */
+
+
+#undef NK_NAMESPACE
+
@@ -22,15 +22,97 @@
 
 /* stdlib includes */
 #include <sys/stat.h>
+#include <string.h>
 
 /* Noriko includes */
 #include <include/Noriko/io.h>
 #include <include/Noriko/platform.h>
 #include <include/Noriko/path.h>
 #include <include/Noriko/alloc.h>
+#include <include/Noriko/job.h>
 
 
 /** \cond INTERNAL */
+/**
+ * \brief factory caches for the file stream classes
+ * 
+ * Streams are opened by the worker threads all the time, so the factories are cached
+ * instead of being looked up for every stream.
+ */
+NK_INTERNAL NkOMFactoryCache gl_FileFacCache   = NKOM_FACTORYCACHE_INIT(NKOM_CLSIDOF(NkIFile));
+NK_INTERNAL NkOMFactoryCache gl_MappedFacCache = NKOM_FACTORYCACHE_INIT(NKOM_CLSIDOF(NkIMappedFile));
+
+/**
+ * \def   __NkInt_WinFilesys_NotifBufSize
+ * \brief size of the buffer receiving the change notifications of a watch, in bytes
+ * \note  Notifications for directories on network shares fail if the buffer is larger
+ *        than 64 KiB.
+ */
+#define __NkInt_WinFilesys_NotifBufSize ((NkSize)64 << 10)
+/**
+ * \def   __NkInt_WinFilesys_MaxNameBytes
+ * \brief maximum size of a relative file name reported by a watch, in UTF-8 bytes
+ */
+#define __NkInt_WinFilesys_MaxNameBytes ((NkSize)3 * 32768)
+
+/**
+ * \def   __NkInt_WinFilesys_TravBatchSize
+ * \brief maximum number of entries passed to the callback of a parallel traversal at once
+ */
+#define __NkInt_WinFilesys_TravBatchSize ((NkSize)128)
+/**
+ * \def   __NkInt_WinFilesys_TravNameSize
+ * \brief minimum size of the buffer holding the paths of a batch, in bytes
+ */
+#define __NkInt_WinFilesys_TravNameSize ((NkSize)16 << 10)
+
+
+/**
+ * \struct NkFileWatch
+ * \brief  internal definition of a directory watch
+ */
+struct NkFileWatch {
+    HANDLE          m_dirHnd;        /**< handle of the watched directory */
+    HANDLE          m_stopEvt;       /**< event signaled when the watch is stopped */
+    OVERLAPPED      m_ovlData;       /**< state of the pending notification request */
+    thrd_t          m_watchThrd;     /**< thread waiting for the notifications */
+    NkBoolean       m_isRecursive;   /**< whether subdirectories are watched */
+    NkFileChangeFn  mp_fnChange;     /**< callback invoked for every changed file */
+    NkVoid         *mp_extraParam;   /**< context passed to the callback */
+    char           *mp_pathBuf;      /**< root path, followed by the name of the current file */
+    NkSize          m_rootLen;       /**< length of the root path, in bytes */
+    DWORD          *mp_notifBuf;     /**< buffer receiving the notifications */
+};
+
+/**
+ * \struct __NkInt_WinFilesys_TravCxt
+ * \brief  represents the state shared by all directories of a traversal
+ */
+NK_NATIVE typedef struct __NkInt_WinFilesys_TravCxt {
+    NkBoolean              m_isRecursive; /**< whether subdirectories are entered */
+    NkDirectoryTraverseFn  mp_fnTrav;     /**< per-entry callback (serial traversals only) */
+    NkDirectoryBatchFn     mp_fnBatch;    /**< batch callback (parallel traversals only) */
+    NkVoid                *mp_extraParam; /**< context passed to the callback */
+    NkJobCounter           m_jobCounter;  /**< counter of all directory jobs (parallel traversals only) */
+    LONG volatile          m_errCode;     /**< first error that occurred, if any */
+} __NkInt_WinFilesys_TravCxt;
+
+/**
+ * \struct __NkInt_WinFilesys_TravDir
+ * \brief  represents a directory that is being enumerated
+ */
+NK_NATIVE typedef struct __NkInt_WinFilesys_TravDir {
+    __NkInt_WinFilesys_TravCxt *mp_travCxt;  /**< traversal the directory belongs to */
+    NkDirectoryEntry           *mp_entryArr; /**< entries of the current batch */
+    NkSize                      m_nEntries;  /**< number of entries in the current batch */
+    char                       *mp_pathBuf;  /**< directory path, followed by the current entry's name */
+    NkSize                      m_dirLen;    /**< length of the directory path, in bytes */
+    char                       *mp_nameBuf;  /**< paths of the entries of the current batch */
+    NkSize                      m_nameLen;   /**< number of bytes used in \c mp_nameBuf */
+    NkSize                      m_nameCap;   /**< capacity of \c mp_nameBuf, in bytes */
+} __NkInt_WinFilesys_TravDir;
+
+
 /**
  * \brief implements <tt>NkIFilesystem::AddRef()</tt> 
  */
@@ -170,11 +252,21 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WinFilesys_Create(
     NK_ASSERT(mode > NkStrMd_Unknown && mode < __NkStrMd_Count__, NkErr_InParameter);
 
     switch (strType) {
-        case NkStrTy_DiskFile: {
+        case NkStrTy_DiskFile:
+        case NkStrTy_MappedFile: {
             NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
 
-            /* Create the file stream object. */
-            NkErrorCode errCode = NkOMCreateInstance(NKOM_CLSIDOF(NkIFile), NULL, NKOM_IIDOF(NkIFile), NULL, resPtr);
+            /*
+             * Create the file stream object. Mapped files implement NkIFile as well, so
+             * they can be returned the same way.
+             */
+            NkErrorCode errCode = NkOMCreateInstanceCached(
+                strType == NkStrTy_MappedFile ? &gl_MappedFacCache : &gl_FileFacCache,
+                NULL,
+                NKOM_IIDOF(NkIFile),
+                NULL,
+                resPtr
+            );
             if (errCode != NkErr_Ok)
                 return errCode;
             NkIFile *fileObj = *resPtr;
@@ -232,6 +324,238 @@ NK_INTERNAL NkVoid NK_CALL __NkInt_WinFilesys_Remove(_Inout_ NkIFilesystem *self
     }
 }
 
+/**
+ * \brief  creates the state of a directory that is to be enumerated
+ * \param  [in, out] cxtPtr traversal the directory belongs to
+ * \param  [in] pathStr path of the directory
+ * \param  [in] pathLen length of \c pathStr, in bytes
+ * \param  [out] dirPtr pointer to a variable that receives the directory state
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_WinFilesys_CreateTravDir(
+    _Inout_             __NkInt_WinFilesys_TravCxt *cxtPtr,
+    _In_reads_(pathLen) char const *pathStr,
+    _In_                NkSize pathLen,
+    _Outptr_            __NkInt_WinFilesys_TravDir **dirPtr
+) {
+    /*
+     * Everything is allocated as a single block: the state itself, the batch (parallel
+     * traversals only), and the path buffer which has room for a separator, the name of
+     * an entry, and the terminator.
+     */
+    NkSize const pathCap = pathLen + 2 + MAX_PATH;
+    NkSize const nameCap = cxtPtr->mp_fnBatch != NULL ? NK_MAX(__NkInt_WinFilesys_TravNameSize, pathCap) : 0;
+    NkSize const entrySz = cxtPtr->mp_fnBatch != NULL ? __NkInt_WinFilesys_TravBatchSize * sizeof(NkDirectoryEntry) : 0;
+    NkErrorCode errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        sizeof **dirPtr + entrySz + pathCap + nameCap,
+        0,
+        NK_FALSE,
+        (NkVoid **)dirPtr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    __NkInt_WinFilesys_TravDir *actDir = *dirPtr;
+    *actDir = (__NkInt_WinFilesys_TravDir){
+        .mp_travCxt  = cxtPtr,
+        .mp_entryArr = (NkDirectoryEntry *)(actDir + 1),
+        .mp_pathBuf  = (char *)(actDir + 1) + entrySz,
+        .m_dirLen    = pathLen,
+        .mp_nameBuf  = (char *)(actDir + 1) + entrySz + pathCap,
+        .m_nameCap   = nameCap
+    };
+    memcpy(actDir->mp_pathBuf, pathStr, pathLen);
+    actDir->mp_pathBuf[pathLen] = '\0';
+    return NkErr_Ok;
+}
+
+/**
+ * \brief records the first error of a traversal; later errors are discarded
+ * \param [in, out] cxtPtr traversal
+ * \param [in] errCode error code
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_WinFilesys_SetTravError(
+    _Inout_ __NkInt_WinFilesys_TravCxt *cxtPtr,
+    _In_    NkErrorCode errCode
+) {
+    NK_IGNORE_RETURN_VALUE(InterlockedCompareExchange(&cxtPtr->m_errCode, (LONG)errCode, (LONG)NkErr_Ok));
+}
+
+/**
+ * \brief  retrieves the first error of a traversal
+ * \param  [in, out] cxtPtr traversal
+ * \return \c NkErr_Ok if no error occurred yet, otherwise the error code
+ */
+NK_INTERNAL NK_INLINE NkErrorCode __NkInt_WinFilesys_GetTravError(_Inout_ __NkInt_WinFilesys_TravCxt *cxtPtr) {
+    return (NkErrorCode)InterlockedCompareExchange(&cxtPtr->m_errCode, 0, 0);
+}
+
+/**
+ * \brief passes the batched entries of a directory to the callback
+ * \param [in, out] dirPtr directory state
+ */
+NK_INTERNAL NkVoid __NkInt_WinFilesys_FlushBatch(_Inout_ __NkInt_WinFilesys_TravDir *dirPtr) {
+    __NkInt_WinFilesys_TravCxt *cxtPtr = dirPtr->mp_travCxt;
+
+    if (dirPtr->m_nEntries > 0) {
+        NkErrorCode const errCode = cxtPtr->mp_fnBatch(dirPtr->mp_entryArr, dirPtr->m_nEntries, cxtPtr->mp_extraParam);
+        if (errCode != NkErr_Ok)
+            __NkInt_WinFilesys_SetTravError(cxtPtr, errCode);
+    }
+
+    dirPtr->m_nEntries = 0;
+    dirPtr->m_nameLen  = 0;
+}
+
+NK_INTERNAL NkVoid __NkInt_WinFilesys_VisitDirectory(_Inout_ __NkInt_WinFilesys_TravDir *dirPtr);
+
+/**
+ * \brief enumerates a directory on a worker thread and frees its state
+ * \param [in, out] extraCxt directory state
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WinFilesys_TravJob(_Inout_opt_ NkVoid *extraCxt) {
+    NK_ASSERT(extraCxt != NULL, NkErr_InOutParameter);
+
+    __NkInt_WinFilesys_VisitDirectory((__NkInt_WinFilesys_TravDir *)extraCxt);
+    NkGPFree(extraCxt);
+}
+
+/**
+ * \brief  enters a subdirectory
+ * \param  [in, out] cxtPtr traversal
+ * \param  [in] pathStr path of the subdirectory
+ * \param  [in] pathLen length of \c pathStr, in bytes
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   Serial traversals enumerate the subdirectory right away; parallel traversals
+ *         submit a job for it.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_WinFilesys_EnterDirectory(
+    _Inout_             __NkInt_WinFilesys_TravCxt *cxtPtr,
+    _In_reads_(pathLen) char const *pathStr,
+    _In_                NkSize pathLen
+) {
+    __NkInt_WinFilesys_TravDir *dirPtr;
+    NkErrorCode errCode = __NkInt_WinFilesys_CreateTravDir(cxtPtr, pathStr, pathLen, &dirPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    if (cxtPtr->mp_fnBatch == NULL) {
+        __NkInt_WinFilesys_VisitDirectory(dirPtr);
+
+        NkGPFree(dirPtr);
+        return NkErr_Ok;
+    }
+
+    errCode = NkJobSubmit(&(NkJobDescription const){
+        .mp_jobFn    = &__NkInt_WinFilesys_TravJob,
+        .mp_extraCxt = (NkVoid *)dirPtr
+    }, 1, NULL, &cxtPtr->m_jobCounter);
+    if (errCode != NkErr_Ok)
+        NkGPFree(dirPtr);
+    return errCode;
+}
+
+/**
+ * \brief enumerates the entries of a single directory
+ * \param [in, out] dirPtr directory state
+ * \note  Errors are recorded in the traversal state.
+ */
+NK_INTERNAL NkVoid __NkInt_WinFilesys_VisitDirectory(_Inout_ __NkInt_WinFilesys_TravDir *dirPtr) {
+    __NkInt_WinFilesys_TravCxt *cxtPtr = dirPtr->mp_travCxt;
+    char                       *pathBuf = dirPtr->mp_pathBuf;
+    NkSize const                dirLen  = dirPtr->m_dirLen;
+
+    /*
+     * Short names are not needed, and larger buffers make the system return more entries
+     * per call.
+     */
+    WIN32_FIND_DATAA findData;
+    memcpy(pathBuf + dirLen, "/*", 3);
+    HANDLE findHnd = FindFirstFileExA(
+        (LPCSTR)pathBuf,
+        FindExInfoBasic,
+        (LPVOID)&findData,
+        FindExSearchNameMatch,
+        NULL,
+        FIND_FIRST_EX_LARGE_FETCH
+    );
+    if (findHnd == INVALID_HANDLE_VALUE) {
+        __NkInt_WinFilesys_SetTravError(cxtPtr, NkErr_OpenDirectory);
+
+        return;
+    }
+
+    do {
+        if (__NkInt_WinFilesys_GetTravError(cxtPtr) != NkErr_Ok)
+            break;
+        char const *nameStr = findData.cFileName;
+        if (nameStr[0] == '.' && (nameStr[1] == '\0' || (nameStr[1] == '.' && nameStr[2] == '\0')))
+            continue;
+
+        NkSize const nameLen = strlen(nameStr);
+        NkSize const pathLen = dirLen + 1 + nameLen;
+        memcpy(pathBuf + dirLen + 1, nameStr, nameLen + 1);
+
+        /* Junctions and symbolic links are not entered, as they may form cycles. */
+        NkBoolean const isDir   = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        NkBoolean const isEnter = isDir && cxtPtr->m_isRecursive && !(findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT);
+
+        NkErrorCode errCode;
+        if (cxtPtr->mp_fnBatch == NULL) {
+            errCode = cxtPtr->mp_fnTrav(pathBuf, cxtPtr->mp_extraParam);
+
+            if (errCode == NkErr_Ok && isEnter)
+                errCode = __NkInt_WinFilesys_EnterDirectory(cxtPtr, pathBuf, pathLen);
+        } else {
+            if (dirPtr->m_nEntries == __NkInt_WinFilesys_TravBatchSize || dirPtr->m_nameLen + pathLen + 1 > dirPtr->m_nameCap)
+                __NkInt_WinFilesys_FlushBatch(dirPtr);
+
+            char *entryPath = dirPtr->mp_nameBuf + dirPtr->m_nameLen;
+            memcpy(entryPath, pathBuf, pathLen + 1);
+            dirPtr->m_nameLen += pathLen + 1;
+            dirPtr->mp_entryArr[dirPtr->m_nEntries++] = (NkDirectoryEntry){
+                .mp_pathStr = entryPath,
+                .m_pathLen  = pathLen,
+                .m_isDir    = isDir,
+                .m_fileSize = isDir ? 0 : (NkUint64)findData.nFileSizeHigh << 32 | findData.nFileSizeLow,
+                .m_mdTime   = (NkUint64)findData.ftLastWriteTime.dwHighDateTime << 32 | findData.ftLastWriteTime.dwLowDateTime
+            };
+
+            errCode = isEnter ? __NkInt_WinFilesys_EnterDirectory(cxtPtr, pathBuf, pathLen) : NkErr_Ok;
+        }
+        if (errCode != NkErr_Ok)
+            __NkInt_WinFilesys_SetTravError(cxtPtr, errCode);
+    } while (FindNextFileA(findHnd, &findData));
+    FindClose(findHnd);
+
+    if (cxtPtr->mp_fnBatch != NULL && __NkInt_WinFilesys_GetTravError(cxtPtr) == NkErr_Ok)
+        __NkInt_WinFilesys_FlushBatch(dirPtr);
+    pathBuf[dirLen] = '\0';
+}
+
+/**
+ * \brief  enumerates a directory tree, serially or on the job system
+ * \param  [in, out] cxtPtr traversal
+ * \param  [in] rootPath path of the root directory
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_WinFilesys_RunTraversal(
+    _Inout_       __NkInt_WinFilesys_TravCxt *cxtPtr,
+    _In_z_ _Utf8_ char const *rootPath
+) {
+    /* Trailing separators would be doubled in the paths of the entries. */
+    NkSize rootLen = strlen(rootPath);
+    while (rootLen > 1 && (rootPath[rootLen - 1] == '/' || rootPath[rootLen - 1] == '\\'))
+        --rootLen;
+
+    NkErrorCode errCode = __NkInt_WinFilesys_EnterDirectory(cxtPtr, rootPath, rootLen);
+    if (cxtPtr->mp_fnBatch != NULL)
+        NkJobWait(&cxtPtr->m_jobCounter);
+
+    return errCode != NkErr_Ok ? errCode : __NkInt_WinFilesys_GetTravError(cxtPtr);
+}
+
 /**
  * \brief implements <tt>NkIFilesystem::Traverse()</tt> 
  */
@@ -246,12 +570,262 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WinFilesys_Traverse(
     NK_ASSERT(rootPath != NULL && *rootPath ^ '\0', NkErr_InParameter);
     NK_ASSERT(fnTrav != NULL, NkErr_CallbackParameter);
     NK_UNREFERENCED_PARAMETER(self);
-    NK_UNREFERENCED_PARAMETER(rootPath);
-    NK_UNREFERENCED_PARAMETER(isRecursive);
-    NK_UNREFERENCED_PARAMETER(fnTrav);
-    NK_UNREFERENCED_PARAMETER(extraParam);
 
-    return NkErr_NotImplemented;
+    return __NkInt_WinFilesys_RunTraversal(&(__NkInt_WinFilesys_TravCxt){
+        .m_isRecursive = isRecursive,
+        .mp_fnTrav     = fnTrav,
+        .mp_extraParam = extraParam
+    }, rootPath);
+}
+
+/**
+ * \brief implements <tt>NkIFilesystem::TraverseParallel()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WinFilesys_TraverseParallel(
+    _Inout_       NkIFilesystem *self,
+    _In_z_ _Utf8_ char const *rootPath,
+    _In_          NkBoolean isRecursive,
+    _In_          NkDirectoryBatchFn fnBatch,
+    _Inout_opt_   NkVoid *extraParam
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(rootPath != NULL && *rootPath ^ '\0', NkErr_InParameter);
+    NK_ASSERT(fnBatch != NULL, NkErr_CallbackParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    return __NkInt_WinFilesys_RunTraversal(&(__NkInt_WinFilesys_TravCxt){
+        .m_isRecursive = isRecursive,
+        .mp_fnBatch    = fnBatch,
+        .mp_extraParam = extraParam
+    }, rootPath);
+}
+
+
+/**
+ * \brief  requests the next batch of change notifications of a watch
+ * \param  [in, out] watchPtr watch handle
+ * \return \c NK_TRUE if the request is pending, \c NK_FALSE if it could not be issued
+ */
+NK_INTERNAL NkBoolean __NkInt_WinFilesys_IssueWatch(_Inout_ NkFileWatch *watchPtr) {
+    return ReadDirectoryChangesW(
+        watchPtr->m_dirHnd,
+        (LPVOID)watchPtr->mp_notifBuf,
+        (DWORD)__NkInt_WinFilesys_NotifBufSize,
+        watchPtr->m_isRecursive ? TRUE : FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+        NULL,
+        &watchPtr->m_ovlData,
+        NULL
+    ) == TRUE;
+}
+
+/**
+ * \brief converts the name of a changed file to a UTF-8 path and reports it
+ * \param [in, out] watchPtr watch handle
+ * \param [in] infoPtr notification that is to be reported
+ */
+NK_INTERNAL NkVoid __NkInt_WinFilesys_ReportChange(
+    _Inout_ NkFileWatch *watchPtr,
+    _In_    FILE_NOTIFY_INFORMATION const *infoPtr
+) {
+    /* File names are not NUL-terminated. */
+    char *namePtr = watchPtr->mp_pathBuf + watchPtr->m_rootLen + 1;
+    int const nBytes = WideCharToMultiByte(
+        CP_UTF8,
+        0,
+        infoPtr->FileName,
+        (int)(infoPtr->FileNameLength / sizeof(WCHAR)),
+        (LPSTR)namePtr,
+        (int)__NkInt_WinFilesys_MaxNameBytes - 1,
+        NULL,
+        NULL
+    );
+    if (nBytes <= 0)
+        return;
+
+    namePtr[nBytes] = '\0';
+    for (char *currPtr = namePtr; *currPtr ^ '\0'; currPtr++)
+        if (*currPtr == '\\')
+            *currPtr = '/';
+    watchPtr->mp_fnChange(watchPtr->mp_pathBuf, watchPtr->mp_extraParam);
+}
+
+/**
+ * \brief  waits for change notifications and reports them until the watch is stopped
+ * \param  [in, out] paramPtr watch handle
+ * \return always \c 0
+ */
+NK_INTERNAL int __NkInt_WinFilesys_WatchThreadProc(_Inout_ NkVoid *paramPtr) {
+    NkFileWatch *watchPtr = (NkFileWatch *)paramPtr;
+
+    HANDLE const waitHnds[] = { watchPtr->m_stopEvt, watchPtr->m_ovlData.hEvent };
+    NkBoolean isPending = __NkInt_WinFilesys_IssueWatch(watchPtr);
+    while (isPending) {
+        if (WaitForMultipleObjects(2, waitHnds, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+            break;
+
+        DWORD nBytes;
+        isPending = NK_FALSE;
+        if (!GetOverlappedResult(watchPtr->m_dirHnd, &watchPtr->m_ovlData, &nBytes, FALSE))
+            break;
+
+        /* If the buffer overflowed, nothing was returned and the changes are lost. */
+        FILE_NOTIFY_INFORMATION const *infoPtr = (FILE_NOTIFY_INFORMATION const *)watchPtr->mp_notifBuf;
+        for (; nBytes > 0; infoPtr = (FILE_NOTIFY_INFORMATION const *)((NkByte const *)infoPtr + infoPtr->NextEntryOffset)) {
+            switch (infoPtr->Action) {
+                case FILE_ACTION_ADDED:
+                case FILE_ACTION_MODIFIED:
+                case FILE_ACTION_RENAMED_NEW_NAME:
+                    __NkInt_WinFilesys_ReportChange(watchPtr, infoPtr);
+
+                    break;
+            }
+
+            if (infoPtr->NextEntryOffset == 0)
+                break;
+        }
+
+        isPending = __NkInt_WinFilesys_IssueWatch(watchPtr);
+    }
+
+    /* The buffer must not be freed while the system may still write to it. */
+    if (isPending && CancelIoEx(watchPtr->m_dirHnd, &watchPtr->m_ovlData)) {
+        DWORD nBytes;
+
+        GetOverlappedResult(watchPtr->m_dirHnd, &watchPtr->m_ovlData, &nBytes, TRUE);
+    }
+
+    NkAllocReleaseThreadCache();
+    return 0;
+}
+
+/**
+ * \brief implements <tt>NkIFilesystem::Watch()</tt> 
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WinFilesys_Watch(
+    _Inout_       NkIFilesystem *self,
+    _In_z_ _Utf8_ char const *rootPath,
+    _In_          NkBoolean isRecursive,
+    _In_          NkFileChangeFn fnChange,
+    _Inout_opt_   NkVoid *extraParam,
+    _Outptr_      NkFileWatch **watchPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(rootPath != NULL && *rootPath ^ '\0', NkErr_InParameter);
+    NK_ASSERT(fnChange != NULL, NkErr_CallbackParameter);
+    NK_ASSERT(watchPtr != NULL, NkErr_OutptrParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Allocate the watch, including the buffers of the watch thread. */
+    NkFileWatch *actWatch;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *actWatch, 0, NK_TRUE, (NkVoid **)&actWatch);
+    if (errCode != NkErr_Ok)
+        goto lbl_END;
+    actWatch->m_isRecursive = isRecursive;
+    actWatch->mp_fnChange   = fnChange;
+    actWatch->mp_extraParam = extraParam;
+    actWatch->m_rootLen     = strlen(rootPath);
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        actWatch->m_rootLen + 1 + __NkInt_WinFilesys_MaxNameBytes,
+        0,
+        NK_FALSE,
+        (NkVoid **)&actWatch->mp_pathBuf
+    );
+    if (errCode != NkErr_Ok)
+        goto lbl_DELWATCH;
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        __NkInt_WinFilesys_NotifBufSize,
+        0,
+        NK_FALSE,
+        (NkVoid **)&actWatch->mp_notifBuf
+    );
+    if (errCode != NkErr_Ok)
+        goto lbl_DELPATH;
+
+    /* Reported paths start with the root path, so it is only copied once. */
+    memcpy(actWatch->mp_pathBuf, rootPath, actWatch->m_rootLen);
+    for (NkSize i = 0; i < actWatch->m_rootLen; i++)
+        if (actWatch->mp_pathBuf[i] == '\\')
+            actWatch->mp_pathBuf[i] = '/';
+    while (actWatch->m_rootLen > 1 && actWatch->mp_pathBuf[actWatch->m_rootLen - 1] == '/')
+        --actWatch->m_rootLen;
+    actWatch->mp_pathBuf[actWatch->m_rootLen] = '/';
+
+    /* Open the directory for asynchronous change notifications. */
+    actWatch->m_dirHnd = CreateFileA(
+        (LPCSTR)rootPath,
+        FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+        NULL
+    );
+    if (actWatch->m_dirHnd == INVALID_HANDLE_VALUE) {
+        errCode = NkErr_OpenFile;
+
+        goto lbl_DELBUF;
+    }
+    actWatch->m_stopEvt        = CreateEventA(NULL, TRUE, FALSE, NULL);
+    actWatch->m_ovlData.hEvent  = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (actWatch->m_stopEvt == NULL || actWatch->m_ovlData.hEvent == NULL) {
+        errCode = NkErr_SynchInit;
+
+        goto lbl_CLOSEHANDLES;
+    }
+
+    /* Start the watch thread. */
+    if (thrd_create(&actWatch->m_watchThrd, &__NkInt_WinFilesys_WatchThreadProc, (NkVoid *)actWatch) != thrd_success) {
+        errCode = NkErr_CreateThread;
+
+        goto lbl_CLOSEHANDLES;
+    }
+
+    *watchPtr = actWatch;
+    return NkErr_Ok;
+
+lbl_CLOSEHANDLES:
+    if (actWatch->m_ovlData.hEvent != NULL)
+        CloseHandle(actWatch->m_ovlData.hEvent);
+    if (actWatch->m_stopEvt != NULL)
+        CloseHandle(actWatch->m_stopEvt);
+    CloseHandle(actWatch->m_dirHnd);
+lbl_DELBUF:
+    NkGPFree(actWatch->mp_notifBuf);
+lbl_DELPATH:
+    NkGPFree(actWatch->mp_pathBuf);
+lbl_DELWATCH:
+    NkGPFree(actWatch);
+lbl_END:
+    *watchPtr = NULL;
+    return errCode;
+}
+
+/**
+ * \brief implements <tt>NkIFilesystem::Unwatch()</tt> 
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WinFilesys_Unwatch(_Inout_ NkIFilesystem *self, _Uninit_ptr_ NkFileWatch **watchPtr) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(watchPtr != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    NkFileWatch *actWatch = *watchPtr;
+    if (actWatch == NULL)
+        return;
+
+    /* Stop the thread; it cancels the pending request before it exits. */
+    SetEvent(actWatch->m_stopEvt);
+    thrd_join(actWatch->m_watchThrd, NULL);
+
+    CloseHandle(actWatch->m_ovlData.hEvent);
+    CloseHandle(actWatch->m_stopEvt);
+    CloseHandle(actWatch->m_dirHnd);
+    NkGPFree(actWatch->mp_notifBuf);
+    NkGPFree(actWatch->mp_pathBuf);
+    NkGPFree(actWatch);
+    *watchPtr = NULL;
 }
 
 
@@ -271,7 +845,10 @@ NK_INTERNAL NkIFilesystem const gl_c_WinFilesysTools = {
         .IsFile              = &__NkInt_WinFilesys_IsFile,
         .Create              = &__NkInt_WinFilesys_Create,
         .Remove              = &__NkInt_WinFilesys_Remove,
-        .Traverse            = &__NkInt_WinFilesys_Traverse
+        .Traverse            = &__NkInt_WinFilesys_Traverse,
+        .TraverseParallel    = &__NkInt_WinFilesys_TraverseParallel,
+        .Watch               = &__NkInt_WinFilesys_Watch,
+        .Unwatch             = &__NkInt_WinFilesys_Unwatch
     }
 };
 
@@ -280,6 +857,60 @@ NkIBase *NK_CALL __NkVirt_Filesys_QueryInstance(NkVoid) {
     /* Got no state, so no need to increment the instance's reference count. */
     return (NkIBase *)&gl_c_WinFilesysTools;
 }
+
+_Return_ok_ NkErrorCode NK_CALL __NkVirt_Filesys_MapFile(
+    _In_z_ _Utf8_ char const *pathStr,
+    _Out_         NkBufferView *viewPtr,
+    _Outptr_      NkVoid **mapHandle
+) {
+    NK_ASSERT(pathStr != NULL && *pathStr ^ '\0', NkErr_InParameter);
+    NK_ASSERT(viewPtr != NULL, NkErr_OutParameter);
+    NK_ASSERT(mapHandle != NULL, NkErr_OutptrParameter);
+
+    *viewPtr   = (NkBufferView){ NULL, 0 };
+    *mapHandle = NULL;
+
+    /* Open the file and query its size. Empty files cannot be mapped. */
+    HANDLE fileHandle = CreateFileA(
+        (LPCSTR)pathStr,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+        NULL
+    );
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return NkErr_OpenFile;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0 || (NkUint64)fileSize.QuadPart > SIZE_MAX) {
+        CloseHandle(fileHandle);
+
+        return NkErr_MapFile;
+    }
+
+    /*
+     * Map the entire file. The view keeps the mapping alive and the mapping keeps the
+     * file alive, so both handles can be closed right away.
+     */
+    HANDLE mapObj = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(fileHandle);
+    if (mapObj == NULL)
+        return NkErr_MapFile;
+    NkVoid *basePtr = MapViewOfFile(mapObj, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapObj);
+    if (basePtr == NULL)
+        return NkErr_MapFile;
+
+    *viewPtr   = (NkBufferView){ (NkByte *)basePtr, (NkSize)fileSize.QuadPart };
+    *mapHandle = basePtr;
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL __NkVirt_Filesys_UnmapFile(_Inout_ NkVoid *mapHandle) {
+    if (mapHandle != NULL)
+        UnmapViewOfFile(mapHandle);
+}
 /** \endcond */
 
 
@@ -20,6 +20,19 @@
  * this file is primarily intended to be (1) a fallback if all other rendering APIs are
  * unavailable, or (2) for development purposes as long as no other renderer is
  * implemented.
+ *
+ * If instantiated with <tt>NkRdApi_Win32Soft</tt>, the renderer runs in software mode:
+ * the back buffer, all textures and all surfaces are 32-bit DIB sections whose pixels
+ * are written directly using the kernels of the pixel module. GDI is then only used for
+ * clearing, scrolling and presenting.
+ *
+ * In software mode, frames are presented through a flip-model DXGI swap chain if the
+ * system supports one. Copying the back buffer into the window using \c BitBlt() makes
+ * the compositor copy it once more, which adds at least one frame of latency; the
+ * buffers of a flip-model swap chain are handed to the compositor directly and even
+ * scanned out without its involvement if the window covers the whole monitor (see
+ * <tt>NkWndMode_Fullscreen</tt>). If the swap chain cannot be created, \c BitBlt()
+ * is used as before.
  */
 #define NK_NAMESPACE "nk::rdgdi"
 
@@ -30,11 +43,118 @@
 #include <include/Noriko/platform.h>
 #include <include/Noriko/log.h>
 #include <include/Noriko/bmp.h>
+#include <include/Noriko/timer.h>
+#include <include/Noriko/pixel.h>
+#include <include/Noriko/job.h>
 
 
 /* All code is stripped from the compilation if we are not on Windows. */
 #if (defined NK_TARGET_WINDOWS)
+/* Direct3D includes */
+#define COBJMACROS
+#include <d3d11.h>
+#include <dxgi1_5.h>
+
+
 /** \cond INTERNAL */
+/**
+ * \def   __NkInt_GdiRenderer_MaxDirtyRects
+ * \brief maximum number of rectangles a dirty region is made of; further rectangles are
+ *        merged into the existing ones
+ */
+#define __NkInt_GdiRenderer_MaxDirtyRects  ((NkSize)(16))
+/**
+ * \def   __NkInt_GdiRenderer_MaxStaticRects
+ * \brief maximum number of static regions that can be declared per frame
+ */
+#define __NkInt_GdiRenderer_MaxStaticRects ((NkSize)(16))
+/**
+ * \def   __NkInt_GdiRenderer_MaxBands
+ * \brief maximum number of bands the software rasterizer splits the back buffer into
+ */
+#define __NkInt_GdiRenderer_MaxBands       ((NkSize)(32))
+/**
+ * \def   __NkInt_GdiRenderer_MinBandRows
+ * \brief minimum height of a band, in pixels; smaller bands do not amortize the cost of
+ *        dispatching a job
+ */
+#define __NkInt_GdiRenderer_MinBandRows    ((LONG)(64))
+/**
+ * \def   __NkInt_GdiRenderer_MaxMipLevels
+ * \brief maximum number of downscaled levels precomputed for a texture; the last level of
+ *        a full chain is 1/256th the size of the texture
+ */
+#define __NkInt_GdiRenderer_MaxMipLevels   ((NkSize)(8))
+/**
+ * \def   __NkInt_GdiRenderer_SafeRelease(ptr)
+ * \brief releases a COM object if it is not <tt>NULL</tt> and resets the pointer
+ */
+#define __NkInt_GdiRenderer_SafeRelease(ptr) do { if ((ptr) != NULL) { (ptr)->lpVtbl->Release(ptr); (ptr) = NULL; } } while (0)
+
+
+/**
+ * \struct __NkInt_GdiRectSet
+ * \brief  represents a region of the back buffer as a small set of (possibly overlapping)
+ *         rectangles
+ */
+NK_NATIVE typedef struct __NkInt_GdiRectSet {
+    RECT   m_rectArr[__NkInt_GdiRenderer_MaxDirtyRects]; /**< rectangles, in client space */
+    NkSize m_nRects;                                     /**< number of rectangles in \c m_rectArr */
+} __NkInt_GdiRectSet;
+
+/**
+ * \struct __NkInt_GdiPixelView
+ * \brief  represents the pixel memory of a DIB section as seen by the software
+ *         rasterizer
+ */
+NK_NATIVE typedef struct __NkInt_GdiPixelView {
+    NkByte *mp_pxPtr;  /**< first pixel of the topmost row */
+    NkInt64 m_pitch;   /**< distance between two rows, in bytes; negative for bottom-up bitmaps */
+    NkInt64 m_pxSize;  /**< size of a pixel, in bytes */
+    LONG    m_width;   /**< width, in pixels */
+    LONG    m_height;  /**< height, in pixels */
+} __NkInt_GdiPixelView;
+
+/**
+ * \struct __NkInt_GdiSoftCommand
+ * \brief  represents a single texture draw of the software rasterizer
+ */
+NK_NATIVE typedef struct __NkInt_GdiSoftCommand {
+    __NkInt_GdiPixelView m_texView;   /**< pixels of the texture */
+    __NkInt_GdiPixelView m_maskView;  /**< pixels of the mask (masked draws only) */
+    RECT                 m_dstRect;   /**< destination rectangle, in target space */
+    RECT                 m_srcRect;   /**< source rectangle, in texture space */
+    POINT                m_maskOri;   /**< upper-left corner of the mask portion (masked draws only) */
+    NkBoolean            m_isAlpha;   /**< whether the texture is blended */
+    NkBoolean            m_isStretch; /**< whether source and destination rectangles differ in size */
+    NkBoolean            m_isMasked;  /**< whether the texture is drawn through the mask */
+} __NkInt_GdiSoftCommand;
+
+/**
+ * \struct __NkInt_GdiSoftBand
+ * \brief  represents the rows of the back buffer a single rasterization job is
+ *         responsible for
+ */
+NK_NATIVE typedef struct __NkInt_GdiSoftBand {
+    __NkInt_GdiPixelView const   *mp_tgtView;  /**< pixels of the back buffer */
+    __NkInt_GdiSoftCommand const *mp_cmdArr;   /**< commands recorded this frame */
+    NkSize                        m_nCmds;     /**< number of elements in \c mp_cmdArr */
+    LONG                          m_bandTop;   /**< first row of the band */
+    LONG                          m_bandBottom; /**< row past the last row of the band */
+} __NkInt_GdiSoftBand;
+
+/**
+ * \struct __NkInt_GdiMipChain
+ * \brief  represents the precomputed downscaled levels of a texture
+ * \note   The chain is referenced by <tt>NkRendererResource::m_auxHandle</tt>. The texture
+ *         itself is level 0 and is not part of the chain.
+ */
+NK_NATIVE typedef struct __NkInt_GdiMipChain {
+    HBITMAP  m_levelArr[__NkInt_GdiRenderer_MaxMipLevels]; /**< levels 1 and up, each half the size of the previous one */
+    NkSize2D m_dimArr[__NkInt_GdiRenderer_MaxMipLevels];   /**< dimensions of the levels, in pixels */
+    NkSize   m_nLevels;                                     /**< number of elements in \c m_levelArr */
+} __NkInt_GdiMipChain;
+
 /**
  * \class __NkInt_GdiRenderer
  * \brief represents the instance-specific internal state of the GDI-based renderer
@@ -52,18 +172,98 @@ NK_NATIVE typedef struct __NkInt_GdiRenderer {
      * \brief  represents the collection of basic resources used by the GDI renderer
      */
     struct __NkInt_GdiResources {
-        HDC       mp_memDC;     /**< memory DC to render contents to */
-        HDC       mp_texDC;     /**< DC holding the currently bound texture */
-        HBITMAP   mp_memBmp;    /**< bitmap to render to */
-        HBITMAP   mp_oldBmp;    /**< initial bitmap of the memory DC */
-        HBITMAP   mp_defTexBmp; /**< default bitmap for the texture DC */
-        HBRUSH    mp_clearBr;   /**< brush used for clearing the screen */
+        HDC       mp_wndDC;      /**< private DC of the window (see \c CS_OWNDC) */
+        HDC       mp_memDC;      /**< memory DC to render contents to */
+        HDC       mp_texDC;      /**< DC holding the currently bound texture */
+        HBITMAP   mp_memBmp;     /**< bitmap to render to */
+        HBITMAP   mp_oldBmp;     /**< initial bitmap of the memory DC */
+        HBITMAP   mp_defTexBmp;  /**< default bitmap for the texture DC */
+        HBRUSH    mp_clearBr;    /**< brush used for clearing the screen */
 #if (!defined NK_CONFIG_DEPLOY)
-        HBRUSH    m_vpBkgndBr;  /**< brush used for the viewport background */
+        HBRUSH    m_vpBkgndBr;   /**< brush used for the viewport background */
 #endif /* NK_CONFIG_DEPLOY */
-        NkSize2D  m_bbDim;      /**< dimensions of the internal back buffer */
-        NkPoint2D m_vpOri;      /**< viewport origin, in client space */
+        HDC       mp_surfDC;     /**< DC holding the surface that is currently rendered to */
+        HBITMAP   mp_defSurfBmp; /**< default bitmap for the surface DC */
+        NkSize2D  m_bbDim;       /**< dimensions of the internal back buffer */
+        NkSize2D  m_reqDim;      /**< requested back buffer dimensions; applied when the next frame begins */
+        NkPoint2D m_vpOri;       /**< viewport origin, in client space */
     } m_gdiRes;
+
+    /**
+     * \struct __NkInt_GdiTarget
+     * \brief  represents the render target all draw calls currently go to
+     */
+    struct __NkInt_GdiTarget {
+        NkRendererResource const *mp_surfPtr; /**< current surface (or NULL for the back buffer) */
+        HDC                       mp_tgtDC;   /**< DC all draw calls are issued to */
+        NkPoint2D                 m_tgtOri;   /**< origin of the drawing area, in target space */
+    } m_currTgt;
+
+    /**
+     * \struct __NkInt_GdiDirtyState
+     * \brief  represents the regions of the back buffer that have to be cleared and
+     *         presented
+     */
+    struct __NkInt_GdiDirtyState {
+        __NkInt_GdiRectSet m_drawnSet;                                          /**< drawn this frame; cleared when the next frame begins */
+        __NkInt_GdiRectSet m_presSet;                                           /**< cleared or drawn this frame; presented when it ends */
+        RECT               m_staticArr[__NkInt_GdiRenderer_MaxStaticRects];     /**< static regions declared this frame, in client space */
+        NkSize             m_nStatic;                                           /**< number of static regions declared this frame */
+        RECT               m_prevStaticArr[__NkInt_GdiRenderer_MaxStaticRects]; /**< static regions of the previous frame */
+        NkSize             m_nPrevStatic;                                       /**< number of static regions of the previous frame */
+        NkBoolean          m_isClearFull;                                       /**< whether the next frame clears the whole back buffer */
+        NkBoolean          m_isPresFull;                                        /**< whether the whole back buffer is presented */
+    } m_dirtyState;
+
+    /**
+     * \struct __NkInt_GdiStatistics
+     * \brief  represents the counters of the current and the last finished frame
+     */
+    struct __NkInt_GdiStatistics {
+        NkRendererFrameStatistics m_currStats;  /**< statistics of the frame being drawn */
+        NkRendererFrameStatistics m_lastStats;  /**< statistics of the last finished frame */
+        NkUint64                  m_beginTicks; /**< time <tt>BeginDraw()</tt> was entered */
+    } m_frameStats;
+
+    /**
+     * \struct __NkInt_GdiSoftState
+     * \brief  represents the state of the software rasterizer
+     * \note   The views of the last used texture and mask are cached as querying them
+     *         requires a round-trip to GDI.
+     */
+    struct __NkInt_GdiSoftState {
+        NkBoolean            m_isEnabled; /**< whether the renderer runs in software mode */
+        __NkInt_GdiPixelView m_tgtView;   /**< pixels of the current render target */
+        HBITMAP              mp_texBmp;   /**< texture whose view is cached */
+        __NkInt_GdiPixelView m_texView;   /**< pixels of \c mp_texBmp */
+        HBITMAP              mp_maskBmp;  /**< mask whose view is cached */
+        __NkInt_GdiPixelView m_maskView;  /**< pixels of \c mp_maskBmp */
+
+        NkBoolean               m_isBanded; /**< whether draws into the back buffer are recorded and rasterized in bands */
+        __NkInt_GdiSoftCommand *mp_cmdArr;  /**< recorded draws that have not been rasterized yet */
+        NkSize                  m_nCmds;    /**< number of elements in \c mp_cmdArr */
+        NkSize                  m_cmdCap;   /**< capacity of \c mp_cmdArr, in elements */
+    } m_softState;
+
+    /**
+     * \struct __NkInt_GdiFlipState
+     * \brief  represents the flip-model swap chain the software back buffer is presented
+     *         through
+     * \note   The buffers of the swap chain do not keep their contents across presents.
+     *         Thus, the regions that changed are uploaded into \c mp_mirTex, which always
+     *         holds the whole frame and is copied into the current buffer on present.
+     */
+    struct __NkInt_GdiFlipState {
+        NkBoolean            m_isEnabled;  /**< whether frames are presented through the swap chain */
+        ID3D11Device        *mp_devPtr;    /**< Direct3D device owning the swap chain */
+        ID3D11DeviceContext *mp_devCxt;    /**< immediate context of \c mp_devPtr */
+        IDXGISwapChain1     *mp_swapChain; /**< swap chain of the window */
+        ID3D11Texture2D     *mp_bbTex;     /**< current buffer of the swap chain */
+        ID3D11Texture2D     *mp_mirTex;    /**< copy of the back buffer in video memory */
+        __NkInt_GdiPixelView m_bbView;     /**< pixels of the back buffer */
+        UINT                 m_swapFlags;  /**< flags the swap chain was created with; must be passed when resizing it */
+        NkBoolean            m_isTearing;  /**< whether frames presented without VSync may tear */
+    } m_flipState;
 } __NkInt_GdiRenderer;
 /* Define IID and CLSID. */
 // { F2CD4199-E8F2-45FF-89EC-14F8785AF2C6 }
@@ -84,6 +284,687 @@ NK_INTERNAL int __NkInt_GdiRenderer_MapToStretchBltMode(_In_ NkTextureInterpolat
     return -1;
 }
 
+/**
+ * \brief  checks whether the given resource can be used as the source of a texture draw
+ * \param  [in] resPtr pointer to the resource to check
+ * \return \c NK_TRUE if the resource is a texture, an alpha texture or a surface,
+ *         \c NK_FALSE otherwise
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_GdiRenderer_IsTexture(_In_ NkRendererResource const *resPtr) {
+    return resPtr->m_resType == NkRdResTy_Texture
+        || resPtr->m_resType == NkRdResTy_AlphaTexture
+        || resPtr->m_resType == NkRdResTy_Surface;
+}
+
+/**
+ * \brief  calculates the area of a rectangle
+ * \param  [in] rectPtr pointer to the rectangle
+ * \return area, in pixels
+ */
+NK_INTERNAL NK_INLINE LONGLONG __NkInt_GdiRenderer_RectArea(_In_ RECT const *rectPtr) {
+    return (LONGLONG)(rectPtr->right - rectPtr->left) * (LONGLONG)(rectPtr->bottom - rectPtr->top);
+}
+
+/**
+ * \brief adds a rectangle to a dirty region
+ * \param [in, out] setPtr pointer to the region
+ * \param [in] rectPtr pointer to the (non-empty) rectangle to add
+ *
+ * \par Remarks
+ *   The rectangle is merged into the existing rectangle whose bounding rectangle grows
+ *   the least. Merging is free if the bounding rectangle is no larger than both
+ *   rectangles combined, as is the case if the new rectangle lies within an existing one
+ *   or continues it along a row or column of tiles. Otherwise, the rectangle is only
+ *   merged if the region is already made of the maximum number of rectangles.
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_AddDirtyRect(_Inout_ __NkInt_GdiRectSet *setPtr, _In_ RECT const *rectPtr) {
+    LONGLONG const addArea    = __NkInt_GdiRenderer_RectArea(rectPtr);
+    NkSize         bestInd    = 0;
+    LONGLONG       bestGrowth = INT64_MAX;
+
+    for (NkSize i = 0; i < setPtr->m_nRects; i++) {
+        RECT unionRect;
+        UnionRect(&unionRect, &setPtr->m_rectArr[i], rectPtr);
+
+        LONGLONG const growth = __NkInt_GdiRenderer_RectArea(&unionRect)
+            - __NkInt_GdiRenderer_RectArea(&setPtr->m_rectArr[i])
+            - addArea;
+        if (growth <= 0) {
+            setPtr->m_rectArr[i] = unionRect;
+
+            return;
+        }
+        if (growth < bestGrowth) {
+            bestInd    = i;
+            bestGrowth = growth;
+        }
+    }
+
+    if (setPtr->m_nRects < __NkInt_GdiRenderer_MaxDirtyRects)
+        setPtr->m_rectArr[setPtr->m_nRects++] = *rectPtr;
+    else
+        UnionRect(&setPtr->m_rectArr[bestInd], &setPtr->m_rectArr[bestInd], rectPtr);
+}
+
+/**
+ * \brief  creates a top-down 32-bit DIB section
+ * \param  [in] dcHandle DC the DIB section is created for
+ * \param  [in] bmpWidth width, in pixels
+ * \param  [in] bmpHeight height, in pixels
+ * \param  [out] bitsPtr pointer to a variable that receives the address of the pixels;
+ *         may be \c NULL
+ * \return handle to the DIB section, or \c NULL on failure
+ * \note   The pixels are zero-initialized.
+ */
+NK_INTERNAL HBITMAP __NkInt_GdiRenderer_CreateDIBSection32(
+    _In_      HDC dcHandle,
+    _In_      int bmpWidth,
+    _In_      int bmpHeight,
+    _Out_opt_ NkVoid **bitsPtr
+) {
+    NkVoid *dibBits;
+    HBITMAP dibSect = CreateDIBSection(dcHandle, &(BITMAPINFO const){
+        .bmiHeader = {
+            .biSize        = sizeof(BITMAPINFOHEADER),
+            .biWidth       = bmpWidth,
+            .biHeight      = -bmpHeight,
+            .biBitCount    = 32,
+            .biPlanes      = 1,
+            .biCompression = BI_RGB
+        }
+    }, DIB_RGB_COLORS, &dibBits, NULL, 0);
+
+    if (bitsPtr != NULL)
+        *bitsPtr = dibBits;
+    return dibSect;
+}
+
+/**
+ * \brief  creates the bitmap the frame is composed in
+ * \param  [in] dcHandle DC the back buffer is created for
+ * \param  [in] bbDim dimensions of the back buffer
+ * \param  [in] isSoft whether the renderer runs in software mode
+ * \return handle to the back buffer, or \c NULL on failure
+ * \note   DIB sections cannot be empty, so the software back buffer is at least one
+ *         pixel wide and high.
+ */
+NK_INTERNAL HBITMAP __NkInt_GdiRenderer_CreateBackBuffer(_In_ HDC dcHandle, _In_ NkSize2D bbDim, _In_ NkBoolean isSoft) {
+    if (!isSoft)
+        return CreateCompatibleBitmap(dcHandle, (int)bbDim.m_width, (int)bbDim.m_height);
+
+    return __NkInt_GdiRenderer_CreateDIBSection32(
+        dcHandle,
+        (int)(bbDim.m_width  > 0 ? bbDim.m_width  : 1),
+        (int)(bbDim.m_height > 0 ? bbDim.m_height : 1),
+        NULL
+    );
+}
+
+/**
+ * \brief  retrieves the pixel memory of a DIB section
+ * \param  [in] bmpHandle handle to the DIB section
+ * \param  [out] viewPtr pointer to the view that receives the pixel memory
+ * \return \c NK_TRUE if the bitmap is a DIB section, \c NK_FALSE otherwise
+ */
+NK_INTERNAL NkBoolean __NkInt_GdiRenderer_QueryPixelView(_In_ HBITMAP bmpHandle, _Out_ __NkInt_GdiPixelView *viewPtr) {
+    DIBSECTION dibSect;
+    if (GetObject(bmpHandle, sizeof dibSect, &dibSect) != (int)sizeof dibSect || dibSect.dsBm.bmBits == NULL) {
+        *viewPtr = (__NkInt_GdiPixelView){ NULL };
+
+        return NK_FALSE;
+    }
+
+    /* Rows of bottom-up bitmaps are stored starting with the bottommost one. */
+    NkInt64 const pitchVal = (NkInt64)dibSect.dsBm.bmWidthBytes;
+    LONG const    bmHeight = dibSect.dsBm.bmHeight;
+    NkByte *const bitsPtr  = (NkByte *)dibSect.dsBm.bmBits;
+
+    NkBoolean const isBottomUp = dibSect.dsBmih.biHeight > 0;
+    *viewPtr = (__NkInt_GdiPixelView){
+        .mp_pxPtr = isBottomUp ? bitsPtr + (bmHeight - 1) * pitchVal : bitsPtr,
+        .m_pitch  = isBottomUp ? -pitchVal : pitchVal,
+        .m_pxSize = dibSect.dsBm.bmBitsPixel / 8,
+        .m_width  = dibSect.dsBm.bmWidth,
+        .m_height = bmHeight
+    };
+    return NK_TRUE;
+}
+
+/**
+ * \brief  calculates the address of a pixel in a pixel view
+ * \param  [in] viewPtr pointer to the view
+ * \param  [in] xCoord x-coordinate of the pixel
+ * \param  [in] yCoord y-coordinate of the pixel
+ * \return address of the pixel
+ */
+NK_INTERNAL NK_INLINE NkByte *__NkInt_GdiRenderer_PixelAt(
+    _In_ __NkInt_GdiPixelView const *viewPtr,
+    _In_ LONG xCoord,
+    _In_ LONG yCoord
+) {
+    return viewPtr->mp_pxPtr + (NkInt64)yCoord * viewPtr->m_pitch + (NkInt64)xCoord * viewPtr->m_pxSize;
+}
+
+/**
+ * \brief clips a span of pixels that is copied between several bitmaps along one axis
+ * \param [in, out] coordArr coordinates of the span in each bitmap
+ * \param [in] nCoords number of coordinates in \c coordArr
+ * \param [in] clipInd index of the coordinate that is to be clipped
+ * \param [in] limVal extent of the bitmap \c coordArr[clipInd] refers to
+ * \param [in, out] lenPtr length of the span; may become zero or negative if nothing is
+ *                  left to copy
+ * \note  As the span is moved alike in all bitmaps, pixels stay in correspondence.
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_GdiRenderer_ClipSpan(
+    _Inout_ LONG *coordArr,
+    _In_    NkSize nCoords,
+    _In_    NkSize clipInd,
+    _In_    LONG limVal,
+    _Inout_ LONG *lenPtr
+) {
+    LONG const leadVal = coordArr[clipInd] < 0 ? -coordArr[clipInd] : 0;
+
+    for (NkSize i = 0; i < nCoords; i++)
+        coordArr[i] += leadVal;
+    *lenPtr -= leadVal;
+    if (coordArr[clipInd] + *lenPtr > limVal)
+        *lenPtr = limVal - coordArr[clipInd];
+}
+
+/**
+ * \brief rasterizes a single command into a range of rows of the render target
+ * \param [in] tgtView pointer to the pixels of the render target
+ * \param [in] cmdPtr pointer to the command
+ * \param [in] bandTop first row that may be written
+ * \param [in] bandBottom row past the last row that may be written
+ *
+ * \par Remarks
+ *   Unscaled portions are clipped once and then copied, blended or masked row by row.
+ *   Scaled portions are sampled with nearest-neighbor filtering using 16.16 fixed-point
+ *   steps through the source; blended ones are gathered into a small buffer first so that
+ *   the blend itself can run on whole spans. Rows outside of the given range are never
+ *   touched, so disjoint ranges can be rasterized concurrently.
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_SoftExecute(
+    _In_ __NkInt_GdiPixelView const *tgtView,
+    _In_ __NkInt_GdiSoftCommand const *cmdPtr,
+    _In_ LONG bandTop,
+    _In_ LONG bandBottom
+) {
+    __NkInt_GdiPixelView const *texView  = &cmdPtr->m_texView;
+    __NkInt_GdiPixelView const *maskView = &cmdPtr->m_maskView;
+    if (tgtView->mp_pxPtr == NULL || texView->mp_pxPtr == NULL || (cmdPtr->m_isMasked && maskView->mp_pxPtr == NULL))
+        return;
+
+    LONG const dstX = cmdPtr->m_dstRect.left;
+    LONG const dstY = cmdPtr->m_dstRect.top;
+    LONG const srcX = cmdPtr->m_srcRect.left;
+    LONG const srcY = cmdPtr->m_srcRect.top;
+
+    if (!cmdPtr->m_isStretch) {
+        /* Rows are clipped relative to the band. */
+        NkSize const nCoords = cmdPtr->m_isMasked ? 3 : 2;
+        LONG         xArr[]  = { dstX, srcX, cmdPtr->m_maskOri.x };
+        LONG         yArr[]  = { dstY - bandTop, srcY, cmdPtr->m_maskOri.y };
+        LONG         width   = cmdPtr->m_dstRect.right - dstX;
+        LONG         height  = cmdPtr->m_dstRect.bottom - dstY;
+        __NkInt_GdiRenderer_ClipSpan(xArr, nCoords, 0, tgtView->m_width, &width);
+        __NkInt_GdiRenderer_ClipSpan(xArr, nCoords, 1, texView->m_width, &width);
+        __NkInt_GdiRenderer_ClipSpan(yArr, nCoords, 0, bandBottom - bandTop, &height);
+        __NkInt_GdiRenderer_ClipSpan(yArr, nCoords, 1, texView->m_height, &height);
+        if (cmdPtr->m_isMasked) {
+            __NkInt_GdiRenderer_ClipSpan(xArr, nCoords, 2, maskView->m_width, &width);
+            __NkInt_GdiRenderer_ClipSpan(yArr, nCoords, 2, maskView->m_height, &height);
+        }
+
+        for (LONG y = 0; y < height && width > 0; y++) {
+            NkByte *const       dstRow = __NkInt_GdiRenderer_PixelAt(tgtView, xArr[0], bandTop + yArr[0] + y);
+            NkByte const *const srcRow = __NkInt_GdiRenderer_PixelAt(texView, xArr[1], yArr[1] + y);
+
+            /* A surface may be drawn into itself, so the rows may overlap. */
+            if (cmdPtr->m_isMasked)
+                NkPixelMaskCopy32(dstRow, srcRow, __NkInt_GdiRenderer_PixelAt(maskView, xArr[2], yArr[2] + y), (NkSize)width);
+            else if (cmdPtr->m_isAlpha)
+                NkPixelBlendPremul32(dstRow, srcRow, (NkSize)width);
+            else
+                memmove(dstRow, srcRow, (NkSize)width * 4);
+        }
+        return;
+    }
+
+    LONG const dstWidth  = cmdPtr->m_dstRect.right - dstX;
+    LONG const dstHeight = cmdPtr->m_dstRect.bottom - dstY;
+    LONG const srcWidth  = cmdPtr->m_srcRect.right - srcX;
+    LONG const srcHeight = cmdPtr->m_srcRect.bottom - srcY;
+    if (dstWidth <= 0 || dstHeight <= 0 || srcWidth <= 0 || srcHeight <= 0)
+        return;
+    NkInt64 const xStep = ((NkInt64)srcWidth << 16) / dstWidth;
+    NkInt64 const yStep = ((NkInt64)srcHeight << 16) / dstHeight;
+#define __NkInt_GdiRenderer_SampleX(x) (srcX + (LONG)(((NkInt64)((x) - dstX) * xStep + xStep / 2) >> 16))
+#define __NkInt_GdiRenderer_SampleY(y) (srcY + (LONG)(((NkInt64)((y) - dstY) * yStep + yStep / 2) >> 16))
+
+    /*
+     * Restrict the destination to the band and to the columns that sample inside the
+     * texture. Since sampling is monotonic, the latter is a single range.
+     */
+    LONG xBeg = dstX < 0 ? 0 : dstX;
+    LONG xEnd = dstX + dstWidth > tgtView->m_width ? tgtView->m_width : dstX + dstWidth;
+    LONG yBeg = dstY < bandTop ? bandTop : dstY;
+    LONG yEnd = dstY + dstHeight > bandBottom ? bandBottom : dstY + dstHeight;
+    while (xBeg < xEnd && __NkInt_GdiRenderer_SampleX(xBeg) < 0)
+        ++xBeg;
+    while (xEnd > xBeg && __NkInt_GdiRenderer_SampleX(xEnd - 1) >= texView->m_width)
+        --xEnd;
+
+    for (LONG y = yBeg; y < yEnd; y++) {
+        LONG const texY = __NkInt_GdiRenderer_SampleY(y);
+        if (texY < 0 || texY >= texView->m_height)
+            continue;
+
+        NkUint32 *const       dstRow = (NkUint32 *)__NkInt_GdiRenderer_PixelAt(tgtView, 0, y);
+        NkUint32 const *const srcRow = (NkUint32 const *)__NkInt_GdiRenderer_PixelAt(texView, 0, texY);
+        for (LONG x = xBeg; x < xEnd; ) {
+            NkUint32   chunkArr[256];
+            LONG const nChunk = xEnd - x < (LONG)NK_ARRAYSIZE(chunkArr) ? xEnd - x : (LONG)NK_ARRAYSIZE(chunkArr);
+
+            /* Opaque pixels can be sampled straight into the target. */
+            NkUint32 *const gatherPtr = cmdPtr->m_isAlpha ? chunkArr : dstRow + x;
+            for (LONG i = 0; i < nChunk; i++)
+                gatherPtr[i] = srcRow[__NkInt_GdiRenderer_SampleX(x + i)];
+            if (cmdPtr->m_isAlpha)
+                NkPixelBlendPremul32(dstRow + x, chunkArr, (NkSize)nChunk);
+
+            x += nChunk;
+        }
+    }
+#undef __NkInt_GdiRenderer_SampleX
+#undef __NkInt_GdiRenderer_SampleY
+}
+
+/**
+ * \brief rasterizes all recorded commands that overlap a band
+ * \param [in, out] extraCxt pointer to the <tt>__NkInt_GdiSoftBand</tt> structure
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_GdiRenderer_SoftRunBand(_Inout_opt_ NkVoid *extraCxt) {
+    __NkInt_GdiSoftBand const *bandPtr = (__NkInt_GdiSoftBand const *)extraCxt;
+
+    /* Commands are replayed in recording order, so overlapping draws compose correctly. */
+    for (NkSize i = 0; i < bandPtr->m_nCmds; i++) {
+        __NkInt_GdiSoftCommand const *cmdPtr = &bandPtr->mp_cmdArr[i];
+
+        if (cmdPtr->m_dstRect.bottom > bandPtr->m_bandTop && cmdPtr->m_dstRect.top < bandPtr->m_bandBottom)
+            __NkInt_GdiRenderer_SoftExecute(bandPtr->mp_tgtView, cmdPtr, bandPtr->m_bandTop, bandPtr->m_bandBottom);
+    }
+}
+
+/**
+ * \brief rasterizes all recorded commands into the back buffer
+ * \param [in, out] rdRef pointer to the renderer state
+ *
+ * \par Remarks
+ *   The back buffer is split into horizontal bands of equal height, one per worker
+ *   thread and one for the calling thread. Each band replays the commands that overlap
+ *   it, clipped to its rows; as the bands are disjoint, no synchronization is needed
+ *   besides waiting for all of them to finish. If the jobs cannot be submitted, all
+ *   bands are rasterized on the calling thread.
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_SoftFlush(_Inout_ __NkInt_GdiRenderer *rdRef) {
+    struct __NkInt_GdiSoftState *softPtr = &rdRef->m_softState;
+    if (softPtr->m_nCmds == 0)
+        return;
+
+    /* Determine the number of bands. */
+    LONG const   tgtHeight = softPtr->m_tgtView.m_height;
+    NkSize const maxBands  = (NkSize)NK_MAX(tgtHeight / __NkInt_GdiRenderer_MinBandRows, 1);
+    NkSize const nBands    = NK_MIN(NK_MIN((NkSize)NkJobGetWorkerCount() + 1, __NkInt_GdiRenderer_MaxBands), maxBands);
+
+    __NkInt_GdiSoftBand bandArr[__NkInt_GdiRenderer_MaxBands];
+    NkJobDescription    jobArr[__NkInt_GdiRenderer_MaxBands];
+    NkJobCounter        jobCnt = { 0 };
+    for (NkSize i = 0; i < nBands; i++) {
+        bandArr[i] = (__NkInt_GdiSoftBand){
+            .mp_tgtView   = &softPtr->m_tgtView,
+            .mp_cmdArr    = softPtr->mp_cmdArr,
+            .m_nCmds      = softPtr->m_nCmds,
+            .m_bandTop    = (LONG)((NkInt64)tgtHeight * (NkInt64)i / (NkInt64)nBands),
+            .m_bandBottom = (LONG)((NkInt64)tgtHeight * (NkInt64)(i + 1) / (NkInt64)nBands)
+        };
+        jobArr[i] = (NkJobDescription){ &__NkInt_GdiRenderer_SoftRunBand, &bandArr[i] };
+    }
+
+    /* The first band is always rasterized on the calling thread. */
+    NkErrorCode errCode = nBands > 1 ? NkJobSubmit(&jobArr[1], nBands - 1, NULL, &jobCnt) : NkErr_Ok;
+
+    __NkInt_GdiRenderer_SoftRunBand(&bandArr[0]);
+    if (errCode != NkErr_Ok) {
+        for (NkSize i = 1; i < nBands; i++)
+            __NkInt_GdiRenderer_SoftRunBand(&bandArr[i]);
+    } else if (nBands > 1)
+        NkJobWait(&jobCnt);
+
+    softPtr->m_nCmds = 0;
+}
+
+/**
+ * \brief rasterizes a command, or records it if it can be rasterized later
+ * \param [in, out] rdRef pointer to the renderer state
+ * \param [in] cmdPtr pointer to the command
+ * \note  Only draws into the back buffer are recorded. Draws into surfaces are rasterized
+ *        immediately since the surface may be used as a texture right afterwards.
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_SoftSubmit(
+    _Inout_ __NkInt_GdiRenderer *rdRef,
+    _In_    __NkInt_GdiSoftCommand const *cmdPtr
+) {
+    struct __NkInt_GdiSoftState *softPtr = &rdRef->m_softState;
+
+    if (softPtr->m_isBanded && rdRef->m_currTgt.mp_surfPtr == NULL) {
+        /* Grow the command list if needed. */
+        NkErrorCode errCode = NkErr_Ok;
+        if (softPtr->m_nCmds == softPtr->m_cmdCap) {
+            NkSize const newCap = NK_MAX(softPtr->m_cmdCap * 2, (NkSize)256);
+
+            errCode = softPtr->mp_cmdArr == NULL
+                ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *softPtr->mp_cmdArr, 0, NK_FALSE, (NkVoid **)&softPtr->mp_cmdArr)
+                : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *softPtr->mp_cmdArr, (NkVoid **)&softPtr->mp_cmdArr);
+            if (errCode == NkErr_Ok)
+                softPtr->m_cmdCap = newCap;
+        }
+        if (errCode == NkErr_Ok) {
+            softPtr->mp_cmdArr[softPtr->m_nCmds++] = *cmdPtr;
+
+            return;
+        }
+
+        /* Out of memory; keep the order of draws by rasterizing what has been recorded. */
+        __NkInt_GdiRenderer_SoftFlush(rdRef);
+    }
+
+    __NkInt_GdiRenderer_SoftExecute(&softPtr->m_tgtView, cmdPtr, 0, softPtr->m_tgtView.m_height);
+}
+
+/**
+ * \brief releases the buffers of the flip-model swap chain
+ * \param [in, out] flipPtr pointer to the swap chain state
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_FlipDestroyBuffers(_Inout_ struct __NkInt_GdiFlipState *flipPtr) {
+    __NkInt_GdiRenderer_SafeRelease(flipPtr->mp_mirTex);
+    __NkInt_GdiRenderer_SafeRelease(flipPtr->mp_bbTex);
+}
+
+/**
+ * \brief  retrieves the buffer of the flip-model swap chain and creates the mirror of the
+ *         back buffer
+ * \param  [in, out] flipPtr pointer to the swap chain state
+ * \param  [in] bbDim dimensions of the back buffer
+ * \return \c NK_TRUE on success, \c NK_FALSE on failure
+ */
+NK_INTERNAL NkBoolean __NkInt_GdiRenderer_FlipCreateBuffers(_Inout_ struct __NkInt_GdiFlipState *flipPtr, _In_ NkSize2D bbDim) {
+    HRESULT hRes = IDXGISwapChain1_GetBuffer(flipPtr->mp_swapChain, 0, &IID_ID3D11Texture2D, (NkVoid **)&flipPtr->mp_bbTex);
+    if (SUCCEEDED(hRes))
+        hRes = ID3D11Device_CreateTexture2D(flipPtr->mp_devPtr, &(D3D11_TEXTURE2D_DESC const){
+            .Width      = (UINT)bbDim.m_width,
+            .Height     = (UINT)bbDim.m_height,
+            .MipLevels  = 1,
+            .ArraySize  = 1,
+            .Format     = DXGI_FORMAT_B8G8R8A8_UNORM,
+            .SampleDesc = { .Count = 1, .Quality = 0 },
+            .Usage      = D3D11_USAGE_DEFAULT
+        }, NULL, &flipPtr->mp_mirTex);
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not create swap chain buffers. HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        __NkInt_GdiRenderer_FlipDestroyBuffers(flipPtr);
+        return NK_FALSE;
+    }
+
+    return NK_TRUE;
+}
+
+/**
+ * \brief destroys the flip-model swap chain; frames are presented using \c BitBlt()
+ *        afterwards
+ * \param [in, out] flipPtr pointer to the swap chain state
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_FlipDestroy(_Inout_ struct __NkInt_GdiFlipState *flipPtr) {
+    __NkInt_GdiRenderer_FlipDestroyBuffers(flipPtr);
+    __NkInt_GdiRenderer_SafeRelease(flipPtr->mp_swapChain);
+    __NkInt_GdiRenderer_SafeRelease(flipPtr->mp_devCxt);
+    __NkInt_GdiRenderer_SafeRelease(flipPtr->mp_devPtr);
+
+    flipPtr->m_isEnabled = NK_FALSE;
+}
+
+/**
+ * \brief  creates the flip-model swap chain the back buffer is presented through
+ * \param  [in] wndHandle handle to the window the swap chain presents to
+ * \param  [in] bbDim dimensions of the back buffer
+ * \param  [out] flipPtr pointer to the swap chain state
+ * \return \c NK_TRUE if frames can be presented through the swap chain, \c NK_FALSE if
+ *         <tt>BitBlt()</tt> has to be used
+ * \note   Tearing is allowed if supported, so that presenting with VSync disabled is not
+ *         held back until the next refresh.
+ */
+NK_INTERNAL NkBoolean __NkInt_GdiRenderer_FlipCreate(
+    _In_  HWND wndHandle,
+    _In_  NkSize2D bbDim,
+    _Out_ struct __NkInt_GdiFlipState *flipPtr
+) {
+    *flipPtr = (struct __NkInt_GdiFlipState){ .m_isEnabled = NK_FALSE };
+    /* A swap chain cannot be created for an empty client area. */
+    if (bbDim.m_width == 0 || bbDim.m_height == 0)
+        return NK_FALSE;
+
+    IDXGIDevice1  *dxgiDev  = NULL;
+    IDXGIAdapter  *dxgiAdap = NULL;
+    IDXGIFactory2 *dxgiFac  = NULL;
+    HRESULT hRes = D3D11CreateDevice(
+        NULL,
+        D3D_DRIVER_TYPE_HARDWARE,
+        NULL,
+        D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+        NULL,
+        0,
+        D3D11_SDK_VERSION,
+        &flipPtr->mp_devPtr,
+        NULL,
+        &flipPtr->mp_devCxt
+    );
+    /* Retrieve the factory that created the adapter of the device. */
+    if (SUCCEEDED(hRes))
+        hRes = ID3D11Device_QueryInterface(flipPtr->mp_devPtr, &IID_IDXGIDevice1, (NkVoid **)&dxgiDev);
+    if (SUCCEEDED(hRes))
+        hRes = IDXGIDevice1_GetAdapter(dxgiDev, &dxgiAdap);
+    if (SUCCEEDED(hRes))
+        hRes = IDXGIAdapter_GetParent(dxgiAdap, &IID_IDXGIFactory2, (NkVoid **)&dxgiFac);
+    if (FAILED(hRes))
+        goto lbl_END;
+    /* Do not let the CPU run ahead of the display by more than one frame. */
+    IDXGIDevice1_SetMaximumFrameLatency(dxgiDev, 1);
+
+    /* Check whether presents may tear; this requires DXGI 1.5. */
+    BOOL           isTearing = FALSE;
+    IDXGIFactory5 *dxgiFac5  = NULL;
+    if (SUCCEEDED(IDXGIFactory2_QueryInterface(dxgiFac, &IID_IDXGIFactory5, (NkVoid **)&dxgiFac5))) {
+        if (FAILED(IDXGIFactory5_CheckFeatureSupport(dxgiFac5, DXGI_FEATURE_PRESENT_ALLOW_TEARING, &isTearing, sizeof isTearing)))
+            isTearing = FALSE;
+
+        __NkInt_GdiRenderer_SafeRelease(dxgiFac5);
+    }
+
+    flipPtr->m_swapFlags = isTearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+    flipPtr->m_isTearing = (NkBoolean)isTearing;
+    hRes = IDXGIFactory2_CreateSwapChainForHwnd(dxgiFac, (IUnknown *)flipPtr->mp_devPtr, wndHandle, &(DXGI_SWAP_CHAIN_DESC1 const){
+        .Width       = (UINT)bbDim.m_width,
+        .Height      = (UINT)bbDim.m_height,
+        .Format      = DXGI_FORMAT_B8G8R8A8_UNORM,
+        .SampleDesc  = { .Count = 1, .Quality = 0 },
+        .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
+        .BufferCount = 2,
+        .Scaling     = DXGI_SCALING_NONE,
+        .SwapEffect  = DXGI_SWAP_EFFECT_FLIP_DISCARD,
+        .AlphaMode   = DXGI_ALPHA_MODE_IGNORE,
+        .Flags       = flipPtr->m_swapFlags
+    }, NULL, NULL, &flipPtr->mp_swapChain);
+    if (FAILED(hRes))
+        goto lbl_END;
+    /* Full-screen mode is managed by the window; keep DXGI from switching modes on Alt+Enter. */
+    IDXGIFactory2_MakeWindowAssociation(dxgiFac, wndHandle, DXGI_MWA_NO_ALT_ENTER);
+
+    flipPtr->m_isEnabled = __NkInt_GdiRenderer_FlipCreateBuffers(flipPtr, bbDim);
+
+lbl_END:
+    __NkInt_GdiRenderer_SafeRelease(dxgiFac);
+    __NkInt_GdiRenderer_SafeRelease(dxgiAdap);
+    __NkInt_GdiRenderer_SafeRelease(dxgiDev);
+
+    if (!flipPtr->m_isEnabled) {
+        NK_LOG_WARNING("Could not create flip-model swap chain; presenting with BitBlt(). HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        __NkInt_GdiRenderer_FlipDestroy(flipPtr);
+    }
+    return flipPtr->m_isEnabled;
+}
+
+/**
+ * \brief  resizes the buffers of the flip-model swap chain to the dimensions of the back
+ *         buffer
+ * \param  [in, out] rdRef pointer to the renderer state
+ * \note   If the swap chain cannot be resized, it is destroyed and subsequent frames are
+ *         presented using <tt>BitBlt()</tt>.
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_FlipResize(_Inout_ __NkInt_GdiRenderer *rdRef) {
+    struct __NkInt_GdiFlipState *flipPtr = &rdRef->m_flipState;
+    NkSize2D const               bbDim   = rdRef->m_gdiRes.m_bbDim;
+
+    /* Keep the buffers while the window is minimized; nothing is presented then. */
+    __NkInt_GdiRenderer_QueryPixelView(rdRef->m_gdiRes.mp_memBmp, &flipPtr->m_bbView);
+    if (bbDim.m_width == 0 || bbDim.m_height == 0)
+        return;
+
+    /* All references to the buffers must be released before resizing. */
+    __NkInt_GdiRenderer_FlipDestroyBuffers(flipPtr);
+    HRESULT hRes = IDXGISwapChain1_ResizeBuffers(
+        flipPtr->mp_swapChain,
+        0,
+        (UINT)bbDim.m_width,
+        (UINT)bbDim.m_height,
+        DXGI_FORMAT_UNKNOWN,
+        flipPtr->m_swapFlags
+    );
+    if (FAILED(hRes) || !__NkInt_GdiRenderer_FlipCreateBuffers(flipPtr, bbDim)) {
+        NK_LOG_ERROR("Failed to resize swap chain; presenting with BitBlt(). HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        __NkInt_GdiRenderer_FlipDestroy(flipPtr);
+    }
+}
+
+/**
+ * \brief  presents the back buffer through the flip-model swap chain
+ * \param  [in, out] rdRef pointer to the renderer state
+ * \param  [out] nPxPtr pointer to a variable that receives the number of pixels that were
+ *         uploaded
+ * \return \c NK_TRUE if the frame was presented, \c NK_FALSE if it has to be presented
+ *         using <tt>BitBlt()</tt> instead
+ */
+NK_INTERNAL NkBoolean __NkInt_GdiRenderer_FlipPresent(_Inout_ __NkInt_GdiRenderer *rdRef, _Out_ NkUint64 *nPxPtr) {
+    struct __NkInt_GdiFlipState  *flipPtr  = &rdRef->m_flipState;
+    struct __NkInt_GdiDirtyState *dirtyPtr = &rdRef->m_dirtyState;
+    NkSize2D const                bbDim    = rdRef->m_gdiRes.m_bbDim;
+
+    *nPxPtr = 0;
+    if (bbDim.m_width == 0 || bbDim.m_height == 0)
+        return NK_TRUE;
+
+    /* Upload the regions that changed since the last frame into the mirror. */
+    RECT const    fullRect = { 0, 0, (LONG)bbDim.m_width, (LONG)bbDim.m_height };
+    RECT const   *rectArr  = dirtyPtr->m_isPresFull ? &fullRect : dirtyPtr->m_presSet.m_rectArr;
+    NkSize const  nRects   = dirtyPtr->m_isPresFull ? 1 : dirtyPtr->m_presSet.m_nRects;
+    for (NkSize i = 0; i < nRects; i++) {
+        RECT const *presRect = &rectArr[i];
+
+        ID3D11DeviceContext_UpdateSubresource(
+            flipPtr->mp_devCxt,
+            (ID3D11Resource *)flipPtr->mp_mirTex,
+            0,
+            &(D3D11_BOX const){ (UINT)presRect->left, (UINT)presRect->top, 0, (UINT)presRect->right, (UINT)presRect->bottom, 1 },
+            __NkInt_GdiRenderer_PixelAt(&flipPtr->m_bbView, presRect->left, presRect->top),
+            (UINT)flipPtr->m_bbView.m_pitch,
+            0
+        );
+
+        *nPxPtr += (NkUint64)__NkInt_GdiRenderer_RectArea(presRect);
+    }
+    ID3D11DeviceContext_CopyResource(flipPtr->mp_devCxt, (ID3D11Resource *)flipPtr->mp_bbTex, (ID3D11Resource *)flipPtr->mp_mirTex);
+
+    /* Present and wait for VBlank if necessary; without VSync, do not wait at all. */
+    NkBoolean const isVSync = rdRef->m_currSpec.m_isVSync;
+    HRESULT const   hRes    = IDXGISwapChain1_Present(
+        flipPtr->mp_swapChain,
+        isVSync ? 1 : 0,
+        !isVSync && flipPtr->m_isTearing ? DXGI_PRESENT_ALLOW_TEARING : 0
+    );
+    if (FAILED(hRes)) {
+        NK_LOG_ERROR("Could not present frame; presenting with BitBlt(). HRESULT: 0x%08lX", (unsigned long)hRes);
+
+        /* The window has to be filled in from scratch. */
+        __NkInt_GdiRenderer_FlipDestroy(flipPtr);
+        dirtyPtr->m_isPresFull = NK_TRUE;
+        return NK_FALSE;
+    }
+
+    dirtyPtr->m_isPresFull = NK_FALSE;
+    return NK_TRUE;
+}
+
+/**
+ * \brief  copies the regions of the back buffer that changed into the window
+ * \param  [in, out] rdRef pointer to the renderer state
+ * \return number of pixels that were copied
+ */
+NK_INTERNAL NkUint64 __NkInt_GdiRenderer_BltPresent(_Inout_ __NkInt_GdiRenderer *rdRef) {
+    struct __NkInt_GdiDirtyState *dirtyPtr = &rdRef->m_dirtyState;
+    NkUint64                      nPxPres  = 0;
+
+    HDC const windowDC = rdRef->m_gdiRes.mp_wndDC;
+    if (dirtyPtr->m_isPresFull) {
+        BitBlt(
+            windowDC,
+            0,
+            0,
+            (int)rdRef->m_gdiRes.m_bbDim.m_width,
+            (int)rdRef->m_gdiRes.m_bbDim.m_height,
+            rdRef->m_gdiRes.mp_memDC,
+            0,
+            0,
+            SRCCOPY
+        );
+
+        nPxPres                = (NkUint64)rdRef->m_gdiRes.m_bbDim.m_width * (NkUint64)rdRef->m_gdiRes.m_bbDim.m_height;
+        dirtyPtr->m_isPresFull = NK_FALSE;
+    } else {
+        for (NkSize i = 0; i < dirtyPtr->m_presSet.m_nRects; i++) {
+            RECT const *presRect = &dirtyPtr->m_presSet.m_rectArr[i];
+
+            BitBlt(
+                windowDC,
+                (int)presRect->left,
+                (int)presRect->top,
+                (int)(presRect->right - presRect->left),
+                (int)(presRect->bottom - presRect->top),
+                rdRef->m_gdiRes.mp_memDC,
+                (int)presRect->left,
+                (int)presRect->top,
+                SRCCOPY
+            );
+
+            nPxPres += (NkUint64)__NkInt_GdiRenderer_RectArea(presRect);
+        }
+    }
+
+    return nPxPres;
+}
+
 /**
  * \todo free resources properly in case of an error 
  */
@@ -93,13 +974,17 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateBasicResou
 ) {
     NkErrorCode errCode = NkErr_Ok;
 
-    /* Get some constant window properties. */
+    /*
+     * Get some constant window properties. The window class is registered with
+     * CS_OWNDC, so the window DC is private to the window and stays valid until it is
+     * destroyed. Thus, it is retrieved once and then kept for presenting.
+     */
     HWND     wndHandle = rdSpecs->mp_wndRef->VT->QueryNativeWindowHandle(rdSpecs->mp_wndRef);
     HDC      wndDC     = GetDC(wndHandle);
     NkSize2D clDim     = rdSpecs->mp_wndRef->VT->GetClientDimensions(rdSpecs->mp_wndRef);
 
     /* Create resources. */
-    HDC memDC, texDC;
+    HDC memDC, texDC, surfDC;
     if ((memDC = CreateCompatibleDC(wndDC)) == NULL) {
         NK_LOG_ERROR("Could not create memory device context from window device context.");
 
@@ -107,7 +992,7 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateBasicResou
         goto lbl_END;
     }
     HBITMAP memBmp; 
-    if ((memBmp = CreateCompatibleBitmap(wndDC, (int)clDim.m_width, (int)clDim.m_height)) == NULL) {
+    if ((memBmp = __NkInt_GdiRenderer_CreateBackBuffer(wndDC, clDim, rdSpecs->m_rendererApi == NkRdApi_Win32Soft)) == NULL) {
         NK_LOG_ERROR("Could not create memory bitmap compatible with window device context.");
 
         errCode = NkErr_CreateCompBitmap;
@@ -120,6 +1005,12 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateBasicResou
         errCode = NkErr_CreateMemDC;
         goto lbl_END;
     }
+    if ((surfDC = CreateCompatibleDC(wndDC)) == NULL) {
+        NK_LOG_ERROR("Could not create surface device context.");
+
+        errCode = NkErr_CreateMemDC;
+        goto lbl_END;
+    }
     HBRUSH clBrush = CreateSolidBrush(
         RGB(
             rdSpecs->m_clearCol.m_rVal,
@@ -146,17 +1037,21 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateBasicResou
 
     /* Initialize the fields. */
     *resPtr = (struct __NkInt_GdiResources){
-        .mp_memDC     = memDC,
-        .mp_texDC     = texDC,
-        .mp_memBmp    = memBmp,
-        .mp_oldBmp    = oldBmp,
-        .mp_defTexBmp = (HBITMAP)GetCurrentObject(texDC, OBJ_BITMAP),
-        .mp_clearBr   = clBrush,
+        .mp_wndDC      = wndDC,
+        .mp_memDC      = memDC,
+        .mp_texDC      = texDC,
+        .mp_memBmp     = memBmp,
+        .mp_oldBmp     = oldBmp,
+        .mp_defTexBmp  = (HBITMAP)GetCurrentObject(texDC, OBJ_BITMAP),
+        .mp_clearBr    = clBrush,
 #if (!defined NK_CONFIG_DEPLOY)
-        .m_vpBkgndBr  = vpBrush,
+        .m_vpBkgndBr   = vpBrush,
 #endif /* NK_CONFIG_DEPLOY */
-        .m_bbDim      = clDim,
-        .m_vpOri      = NkCalculateViewportOrigin(
+        .mp_surfDC     = surfDC,
+        .mp_defSurfBmp = (HBITMAP)GetCurrentObject(surfDC, OBJ_BITMAP),
+        .m_bbDim       = clDim,
+        .m_reqDim      = clDim,
+        .m_vpOri       = NkCalculateViewportOrigin(
             rdSpecs->m_vpAlignment,
             rdSpecs->m_vpExtents,
             rdSpecs->m_dispTileSize,
@@ -166,9 +1061,11 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateBasicResou
 
     /* Set some DC properties. */
     SetStretchBltMode(resPtr->mp_memDC, __NkInt_GdiRenderer_MapToStretchBltMode(rdSpecs->m_texInterMode));
+    SetStretchBltMode(resPtr->mp_surfDC, __NkInt_GdiRenderer_MapToStretchBltMode(rdSpecs->m_texInterMode));
 
 lbl_END:
-    ReleaseDC(wndHandle, wndDC);
+    if (errCode != NkErr_Ok)
+        ReleaseDC(wndHandle, wndDC);
     return errCode;
 }
 
@@ -183,6 +1080,7 @@ NK_INTERNAL NkVoid __NkInt_GdiRenderer_Destroy(_Inout_ __NkInt_GdiRenderer *self
      * bound texture will automatically unbind it.
      */
     SelectObject(self->m_gdiRes.mp_texDC, self->m_gdiRes.mp_defTexBmp);
+    SelectObject(self->m_gdiRes.mp_surfDC, self->m_gdiRes.mp_defSurfBmp);
     /*
      * Select the old bitmap into the DC to free it when the DC is destroyed. Our actual
      * bitmap must be freed by us since it was not indirectly created by the memory DC
@@ -200,11 +1098,36 @@ NK_INTERNAL NkVoid __NkInt_GdiRenderer_Destroy(_Inout_ __NkInt_GdiRenderer *self
 #endif /* NK_CONFIG_DEPLOY */
     DeleteDC(self->m_gdiRes.mp_memDC);
     DeleteDC(self->m_gdiRes.mp_texDC);
+    DeleteDC(self->m_gdiRes.mp_surfDC);
+    NkGPFree((NkVoid *)self->m_softState.mp_cmdArr);
+    __NkInt_GdiRenderer_FlipDestroy(&self->m_flipState);
+    ReleaseDC((HWND)self->mp_wndRef->VT->QueryNativeWindowHandle(self->mp_wndRef), self->m_gdiRes.mp_wndDC);
 
     /* Release the parent window. */
     self->mp_wndRef->VT->Release(self->mp_wndRef);
 }
 
+/**
+ * \brief deletes the downscaled levels of a texture
+ * \param [in, out] rdRef pointer to the renderer instance
+ * \param [in, out] mipPtr pointer to the mip chain; may be <tt>NULL</tt>
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_DeleteMipChain(_Inout_ __NkInt_GdiRenderer *rdRef, _Inout_opt_ __NkInt_GdiMipChain *mipPtr) {
+    if (mipPtr == NULL)
+        return;
+
+    for (NkSize i = 0; i < mipPtr->m_nLevels; i++) {
+        /* Any level may be the one that was bound last. */
+        if (GetCurrentObject(rdRef->m_gdiRes.mp_texDC, OBJ_BITMAP) == (HGDIOBJ)mipPtr->m_levelArr[i])
+            SelectObject(rdRef->m_gdiRes.mp_texDC, rdRef->m_gdiRes.mp_defTexBmp);
+        if (rdRef->m_softState.mp_texBmp == mipPtr->m_levelArr[i])
+            rdRef->m_softState.mp_texBmp = NULL;
+
+        DeleteObject((HGDIOBJ)mipPtr->m_levelArr[i]);
+    }
+    NkGPFree((NkVoid *)mipPtr);
+}
+
 /**
  */
 NK_INTERNAL NkVoid __NkInt_GdiRenderer_InternalDeleteResource(
@@ -216,14 +1139,27 @@ NK_INTERNAL NkVoid __NkInt_GdiRenderer_InternalDeleteResource(
 
     /* Get pointer to internal renderer structure. */
     __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+    /* Recorded draws may still reference the resource. */
+    __NkInt_GdiRenderer_SoftFlush(rdRef);
 
     switch (resPtr->m_resType) {
         case NkRdResTy_Texture:
         case NkRdResTy_TextureMask:
+        case NkRdResTy_Surface:
+        case NkRdResTy_AlphaTexture:
             /* If the texture is currently bound to our texture DC, unbind it first. */
             if (GetCurrentObject(rdRef->m_gdiRes.mp_texDC, OBJ_BITMAP) == (HGDIOBJ)resPtr->m_resHandle)
                 SelectObject(rdRef->m_gdiRes.mp_texDC, rdRef->m_gdiRes.mp_defTexBmp);
-
+            /* Same goes for surfaces that are currently rendered to. */
+            if (rdRef->m_currTgt.mp_surfPtr == resPtr)
+                NK_IGNORE_RETURN_VALUE(self->VT->SetRenderTarget(self, NULL));
+            /* The handle may be reused for a new bitmap, so drop the cached views. */
+            if (rdRef->m_softState.mp_texBmp == (HBITMAP)resPtr->m_resHandle)
+                rdRef->m_softState.mp_texBmp = NULL;
+            if (rdRef->m_softState.mp_maskBmp == (HBITMAP)resPtr->m_resHandle)
+                rdRef->m_softState.mp_maskBmp = NULL;
+
+            __NkInt_GdiRenderer_DeleteMipChain(rdRef, (__NkInt_GdiMipChain *)resPtr->m_auxHandle);
             DeleteObject((HGDIOBJ)resPtr->m_resHandle);
             break;
         default:
@@ -279,7 +1215,7 @@ NK_INTERNAL NkIRenderer *__NkInt_GdiRenderer_RefInstance(_Inout_ NkIRenderer *se
 NK_INTERNAL NkOMRefCount NK_CALL __NkInt_GdiRenderer_AddRef(_Inout_ NkIRenderer *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    return ++((__NkInt_GdiRenderer *)self)->m_refCount;
+    return NkOMRefCountIncrement(&((__NkInt_GdiRenderer *)self)->m_refCount, NkOMRcMd_ThreadLocal);
 }
 
 /**
@@ -287,14 +1223,15 @@ NK_INTERNAL NkOMRefCount NK_CALL __NkInt_GdiRenderer_AddRef(_Inout_ NkIRenderer
 NK_INTERNAL NkOMRefCount NK_CALL __NkInt_GdiRenderer_Release(_Inout_ NkIRenderer *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    if (--((__NkInt_GdiRenderer *)self)->m_refCount <= 0) {
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&((__NkInt_GdiRenderer *)self)->m_refCount, NkOMRcMd_ThreadLocal);
+    if (newCount <= 0) {
         __NkInt_GdiRenderer_Destroy((__NkInt_GdiRenderer *)self);
 
         NkGPFree((NkVoid *)self);
         return 0;
     }
 
-    return ((__NkInt_GdiRenderer *)self)->m_refCount;
+    return newCount;
 }
 
 /**
@@ -337,10 +1274,11 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_Initialize(
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
     NK_ASSERT(initParam != NULL, NkErr_InParameter);
 
-    NK_LOG_INFO("startup: GDI renderer");
-
     /* Get the pointer to the renderer specification. */
     NkRendererSpecification const *rdSpecs = (NkRendererSpecification const *)initParam;
+    NkBoolean const                isSoft  = rdSpecs->m_rendererApi == NkRdApi_Win32Soft;
+
+    NK_LOG_INFO(isSoft ? "startup: GDI renderer (software rasterization)" : "startup: GDI renderer");
 
     /* Initialize main resources. */
     NkErrorCode errCode;
@@ -356,9 +1294,25 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_Initialize(
         .m_refCount = ((__NkInt_GdiRenderer *)self)->m_refCount,
         .mp_wndRef  = rdSpecs->mp_wndRef,
         .m_initSpec = *rdSpecs,
-        .m_currSpec = *rdSpecs
+        .m_currSpec = *rdSpecs,
+        .m_currTgt  = { NULL, gdiRes.mp_memDC, gdiRes.m_vpOri },
+        /* The first frame has to clear and present everything. */
+        .m_dirtyState = { .m_isClearFull = NK_TRUE, .m_isPresFull = NK_TRUE },
+        .m_softState  = { .m_isEnabled = isSoft, .m_isBanded = isSoft && NkJobGetWorkerCount() > 0 }
     };
     memcpy(&((__NkInt_GdiRenderer *)self)->m_gdiRes, &gdiRes, sizeof gdiRes);
+    if (isSoft) {
+        struct __NkInt_GdiFlipState *flipPtr = &((__NkInt_GdiRenderer *)self)->m_flipState;
+
+        __NkInt_GdiRenderer_QueryPixelView(gdiRes.mp_memBmp, &((__NkInt_GdiRenderer *)self)->m_softState.m_tgtView);
+        /* The software back buffer can be uploaded as is; present it through a swap chain. */
+        HWND const wndHandle = (HWND)rdSpecs->mp_wndRef->VT->QueryNativeWindowHandle(rdSpecs->mp_wndRef);
+        if (__NkInt_GdiRenderer_FlipCreate(wndHandle, gdiRes.m_bbDim, flipPtr)) {
+            __NkInt_GdiRenderer_QueryPixelView(gdiRes.mp_memBmp, &flipPtr->m_bbView);
+
+            NK_LOG_INFO("Presenting through flip-model swap chain%s.", flipPtr->m_isTearing ? " (tearing allowed)" : "");
+        }
+    }
     
     /* All good. */
     return NkErr_Ok;
@@ -368,9 +1322,8 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_Initialize(
  */
 NK_INTERNAL NkRendererApi NK_CALL __NkInt_GdiRenderer_QueryRendererApi(_Inout_ NkIRenderer *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_UNREFERENCED_PARAMETER(self);
 
-    return NkRdApi_Win32GDI;
+    return ((__NkInt_GdiRenderer *)self)->m_softState.m_isEnabled ? NkRdApi_Win32Soft : NkRdApi_Win32GDI;
 }
 
 /**
@@ -409,22 +1362,36 @@ NK_INTERNAL NkSize2D NK_CALL __NkInt_GdiRenderer_QueryViewportDimensions(_In_ Nk
 
 /**
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_Resize(
+NK_INTERNAL NkVoid NK_CALL __NkInt_GdiRenderer_QueryFrameStatistics(
     _Inout_ NkIRenderer *self,
-    _In_    NkSize2D clAreaSize
+    _Out_   NkRendererFrameStatistics *statPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(statPtr != NULL, NkErr_OutParameter);
 
-    /* Get pointer to internal renderer state. */
-    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+    *statPtr = ((__NkInt_GdiRenderer *)self)->m_frameStats.m_lastStats;
+    statPtr->m_structSize = sizeof *statPtr;
+}
+
+/**
+ * \brief  reallocates the back buffer so that it matches the requested dimensions
+ * \param  [in,out] rdRef pointer to the renderer state
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_GdiRenderer_ApplyResize(_Inout_ __NkInt_GdiRenderer *rdRef) {
+    NkSize2D const clAreaSize = rdRef->m_gdiRes.m_reqDim;
 
     /* Delete the old bitmap first. */
+    __NkInt_GdiRenderer_SoftFlush(rdRef);
     SelectObject(rdRef->m_gdiRes.mp_memDC, rdRef->m_gdiRes.mp_oldBmp);
     DeleteObject(rdRef->m_gdiRes.mp_memBmp);
 
     /* Create new bitmap with appropriate size. */
-    HDC wndDC = GetDC((HWND)rdRef->mp_wndRef->VT->QueryNativeWindowHandle(rdRef->mp_wndRef));
-    rdRef->m_gdiRes.mp_memBmp = CreateCompatibleBitmap(wndDC, (int)clAreaSize.m_width, (int)clAreaSize.m_height);
+    rdRef->m_gdiRes.mp_memBmp = __NkInt_GdiRenderer_CreateBackBuffer(
+        rdRef->m_gdiRes.mp_wndDC,
+        clAreaSize,
+        rdRef->m_softState.m_isEnabled
+    );
     if (rdRef->m_gdiRes.mp_memBmp == NULL) {
         NK_LOG_ERROR(
             "Failed to resize window back buffer. Requested Dimensions: (%llu, %llu)",
@@ -435,58 +1402,164 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_Resize(
         return NkErr_CreateCompBitmap;
     }
     SelectObject(rdRef->m_gdiRes.mp_memDC, rdRef->m_gdiRes.mp_memBmp);
-    ReleaseDC((HWND)rdRef->mp_wndRef->VT->QueryNativeWindowHandle(rdRef->mp_wndRef), wndDC);
 
     /* All went well. Update client size and recalculate viewport origin. */
     rdRef->m_gdiRes.m_bbDim = clAreaSize;
+    rdRef->m_dirtyState.m_isClearFull = NK_TRUE;
     rdRef->m_gdiRes.m_vpOri = NkCalculateViewportOrigin(
         rdRef->m_currSpec.m_vpAlignment,
         rdRef->m_currSpec.m_vpExtents,
         rdRef->m_currSpec.m_dispTileSize,
         rdRef->m_gdiRes.m_bbDim
     );
+    if (rdRef->m_currTgt.mp_surfPtr == NULL) {
+        rdRef->m_currTgt.m_tgtOri = rdRef->m_gdiRes.m_vpOri;
+
+        if (rdRef->m_softState.m_isEnabled)
+            __NkInt_GdiRenderer_QueryPixelView(rdRef->m_gdiRes.mp_memBmp, &rdRef->m_softState.m_tgtView);
+    }
+    if (rdRef->m_flipState.m_isEnabled)
+        __NkInt_GdiRenderer_FlipResize(rdRef);
     return NkErr_Ok;
 }
 
 /**
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_BeginDraw(_Inout_ NkIRenderer *self) {
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_Resize(
+    _Inout_ NkIRenderer *self,
+    _In_    NkSize2D clAreaSize
+) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    /* Get pointer to renderer state. */
-    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+    /*
+     * Only record the new size. Reallocating the back buffer is deferred to the start of
+     * the next frame so that it happens once, no matter how many resize requests arrive
+     * in between (as it is the case during a drag-resize).
+     */
+    ((__NkInt_GdiRenderer *)self)->m_gdiRes.m_reqDim = clAreaSize;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief clears a portion of the back buffer
+ * \param [in, out] rdRef pointer to the renderer state
+ * \param [in] rectPtr pointer to the rectangle to clear, in client space
+ */
+NK_INTERNAL NkVoid __NkInt_GdiRenderer_ClearRect(_Inout_ __NkInt_GdiRenderer *rdRef, _In_ RECT const *rectPtr) {
+    FillRect(rdRef->m_gdiRes.mp_memDC, rectPtr, rdRef->m_gdiRes.mp_clearBr);
 
-    /* Clear the back buffer. */
-    FillRect(
-        rdRef->m_gdiRes.mp_memDC,
-        &(RECT const){
-            0,
-            0,
-            (LONG)rdRef->m_gdiRes.m_bbDim.m_width,
-            (LONG)rdRef->m_gdiRes.m_bbDim.m_height
-        },
-        rdRef->m_gdiRes.mp_clearBr
-    );
-    
 #if (!defined NK_CONFIG_DEPLOY)
     /* Draw background of viewport. */
     NkSize2D const vpDim = {
         rdRef->m_currSpec.m_vpExtents.m_width  * rdRef->m_currSpec.m_dispTileSize.m_width,
         rdRef->m_currSpec.m_vpExtents.m_height * rdRef->m_currSpec.m_dispTileSize.m_height
     };
+    RECT const vpRect = {
+        (LONG)rdRef->m_gdiRes.m_vpOri.m_xCoord,
+        (LONG)rdRef->m_gdiRes.m_vpOri.m_yCoord,
+        (LONG)(rdRef->m_gdiRes.m_vpOri.m_xCoord + vpDim.m_width),
+        (LONG)(rdRef->m_gdiRes.m_vpOri.m_yCoord + vpDim.m_height)
+    };
 
-    FillRect(
-        rdRef->m_gdiRes.mp_memDC,
-        &(RECT const){
-            (LONG)rdRef->m_gdiRes.m_vpOri.m_xCoord,
-            (LONG)rdRef->m_gdiRes.m_vpOri.m_yCoord,
-            (LONG)(rdRef->m_gdiRes.m_vpOri.m_xCoord + vpDim.m_width),
-            (LONG)(rdRef->m_gdiRes.m_vpOri.m_yCoord + vpDim.m_height),
-        },
-        rdRef->m_gdiRes.m_vpBkgndBr
-    );
+    RECT vpPart;
+    if (IntersectRect(&vpPart, rectPtr, &vpRect))
+        FillRect(rdRef->m_gdiRes.mp_memDC, &vpPart, rdRef->m_gdiRes.m_vpBkgndBr);
 #endif /* NK_CONFIG_DEPLOY */
+}
+
+/**
+ * \brief marks the destination rectangle of a draw call as dirty
+ * \param [in, out] rdRef pointer to the renderer state
+ * \param [in] dstRect destination rectangle, in target space
+ * \note  Draw calls into surfaces do not change the back buffer and are thus ignored.
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_GdiRenderer_MarkDirty(_Inout_ __NkInt_GdiRenderer *rdRef, _In_ NkRectF const *dstRect) {
+    if (rdRef->m_currTgt.mp_surfPtr != NULL)
+        return;
+
+    RECT const bbRect   = { 0, 0, (LONG)rdRef->m_gdiRes.m_bbDim.m_width, (LONG)rdRef->m_gdiRes.m_bbDim.m_height };
+    RECT       dirtRect = {
+        (LONG)dstRect->m_xCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_xCoord,
+        (LONG)dstRect->m_yCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_yCoord,
+        (LONG)dstRect->m_xCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_xCoord + (LONG)dstRect->m_width,
+        (LONG)dstRect->m_yCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_yCoord + (LONG)dstRect->m_height
+    };
+    if (!IntersectRect(&dirtRect, &dirtRect, &bbRect))
+        return;
+
+    __NkInt_GdiRenderer_AddDirtyRect(&rdRef->m_dirtyState.m_drawnSet, &dirtRect);
+    if (!rdRef->m_dirtyState.m_isPresFull)
+        __NkInt_GdiRenderer_AddDirtyRect(&rdRef->m_dirtyState.m_presSet, &dirtRect);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_BeginDraw(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
+    /* Get pointer to renderer state. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    /* Start counting for the new frame. */
+    rdRef->m_frameStats.m_currStats  = (NkRendererFrameStatistics){
+        .m_structSize = sizeof(NkRendererFrameStatistics),
+        .m_frameInd   = rdRef->m_frameStats.m_lastStats.m_frameInd
+    };
+    rdRef->m_frameStats.m_beginTicks = NkTimerGetCurrentTicks();
+
+    /* Every frame starts out rendering to the back buffer. */
+    if (rdRef->m_currTgt.mp_surfPtr != NULL)
+        NK_IGNORE_RETURN_VALUE(self->VT->SetRenderTarget(self, NULL));
+    /* Apply the latest resize request, if any. */
+    if (   rdRef->m_gdiRes.m_reqDim.m_width  != rdRef->m_gdiRes.m_bbDim.m_width
+        || rdRef->m_gdiRes.m_reqDim.m_height != rdRef->m_gdiRes.m_bbDim.m_height
+    ) {
+        NkErrorCode errCode = __NkInt_GdiRenderer_ApplyResize(rdRef);
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+
+    /*
+     * Clear what was drawn in the previous frame, except for the regions that were
+     * declared static. Everything else still holds the clear color.
+     */
+    struct __NkInt_GdiDirtyState *dirtyPtr = &rdRef->m_dirtyState;
+    if (dirtyPtr->m_isClearFull) {
+        __NkInt_GdiRenderer_ClearRect(
+            rdRef,
+            &(RECT const){
+                0,
+                0,
+                (LONG)rdRef->m_gdiRes.m_bbDim.m_width,
+                (LONG)rdRef->m_gdiRes.m_bbDim.m_height
+            }
+        );
+
+        dirtyPtr->m_nPrevStatic = 0;
+        dirtyPtr->m_isPresFull  = NK_TRUE;
+    } else {
+        for (NkSize i = 0; i < dirtyPtr->m_nStatic; i++) {
+            RECT const *statRect = &dirtyPtr->m_staticArr[i];
+
+            ExcludeClipRect(rdRef->m_gdiRes.mp_memDC, statRect->left, statRect->top, statRect->right, statRect->bottom);
+        }
+        for (NkSize i = 0; i < dirtyPtr->m_drawnSet.m_nRects; i++)
+            __NkInt_GdiRenderer_ClearRect(rdRef, &dirtyPtr->m_drawnSet.m_rectArr[i]);
+        SelectClipRgn(rdRef->m_gdiRes.mp_memDC, NULL);
+
+        memcpy(dirtyPtr->m_prevStaticArr, dirtyPtr->m_staticArr, dirtyPtr->m_nStatic * sizeof *dirtyPtr->m_staticArr);
+        dirtyPtr->m_nPrevStatic = dirtyPtr->m_nStatic;
+    }
+
+    /* The cleared area must be presented as well, no matter what is drawn over it. */
+    dirtyPtr->m_presSet           = dirtyPtr->m_drawnSet;
+    dirtyPtr->m_drawnSet.m_nRects = 0;
+    dirtyPtr->m_nStatic           = 0;
+    dirtyPtr->m_isClearFull       = NK_FALSE;
+
+    /* GDI batches calls; the clears must have landed before the rasterizer draws over them. */
+    if (rdRef->m_softState.m_isEnabled)
+        GdiFlush();
     return NkErr_Ok;
 }
 
@@ -495,113 +1568,376 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_BeginDraw(_Inout
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_EndDraw(_Inout_ NkIRenderer *self) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
-    /* Blit the back buffer to the window surface and wait for VBlank if necessary. */
+    /* Rasterize what has been recorded; this still counts as drawing. */
     __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+    __NkInt_GdiRenderer_SoftFlush(rdRef);
 
-    HDC windowDC = GetDC(rdRef->mp_wndRef->VT->QueryNativeWindowHandle(rdRef->mp_wndRef));
-    BitBlt(
-        windowDC,
-        0,
-        0,
-        (int)rdRef->m_gdiRes.m_bbDim.m_width,
-        (int)rdRef->m_gdiRes.m_bbDim.m_height,
-        rdRef->m_gdiRes.mp_memDC,
-        0,
-        0,
-        SRCCOPY
-    );
-    ReleaseDC(rdRef->mp_wndRef->VT->QueryNativeWindowHandle(rdRef->mp_wndRef), windowDC);
-    
-    if (rdRef->m_currSpec.m_isVSync)
-        DwmFlush();
+    /* Present the back buffer and wait for VBlank if necessary. */
+    NkUint64 const presTicks = NkTimerGetCurrentTicks();
+
+    /* GDI batches calls; the clears must have landed before the pixels are uploaded. */
+    if (rdRef->m_flipState.m_isEnabled)
+        GdiFlush();
+
+    /* Only present the regions that changed since the last frame. */
+    NkUint64 nPxPres;
+    if (!rdRef->m_flipState.m_isEnabled || !__NkInt_GdiRenderer_FlipPresent(rdRef, &nPxPres)) {
+        nPxPres = __NkInt_GdiRenderer_BltPresent(rdRef);
+
+        if (rdRef->m_currSpec.m_isVSync)
+            DwmFlush();
+    }
+
+    /* Publish the statistics of the frame. */
+    struct __NkInt_GdiStatistics *statPtr  = &rdRef->m_frameStats;
+    NkDouble const                tickToMs = 1000. / (NkDouble)NkTimerGetFrequency();
+
+    statPtr->m_currStats.m_drawTime     = (NkDouble)(presTicks - statPtr->m_beginTicks) * tickToMs;
+    statPtr->m_currStats.m_presentTime  = (NkDouble)(NkTimerGetCurrentTicks() - presTicks) * tickToMs;
+    statPtr->m_currStats.m_nPxPresented = nPxPres;
+    ++statPtr->m_currStats.m_frameInd;
+    statPtr->m_lastStats = statPtr->m_currStats;
     return NkErr_Ok;
 }
 
 /**
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_DrawTexture(
-    _Inout_  NkIRenderer *self,
-    _In_     NkRectF const *dstRect,
-    _In_     NkRendererResource const *texPtr,
-    _In_opt_ NkRectF const *srcRect
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_SetStaticRegions(
+    _Inout_          NkIRenderer *self,
+    _In_             NkSize count,
+    _I_array_(count) NkRectF const *rects,
+    _Out_opt_        NkBoolean *isPreservedPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
-    NK_ASSERT(texPtr != NULL && texPtr->m_resType == NkRdResTy_Texture, NkErr_InParameter);
+    NK_ASSERT(count == 0 || rects != NULL, NkErr_InParameter);
 
     /* Get pointer to renderer structure. */
-    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+    __NkInt_GdiRenderer          *rdRef    = (__NkInt_GdiRenderer *)self;
+    struct __NkInt_GdiDirtyState *dirtyPtr = &rdRef->m_dirtyState;
+    if (count > __NkInt_GdiRenderer_MaxStaticRects)
+        return NkErr_CapLimitExceeded;
 
     /*
-     * To know which blit function we need to use, we must first determine if scaling is
-     * needed. This may require us to first 'normalize' our source rectangle.
+     * A region kept its contents only if it lies within a region that was static in the
+     * previous frame, as everything else has been cleared when the frame began.
      */
-    NkRectF normSrcRect;
-    /* Get bitmap width and height if the source rectangle is not entirely "valid". */
-    if (srcRect == NULL || srcRect->m_width == -1 || srcRect->m_height == -1) {
-        BITMAP tInfo;
-        GetObject((HANDLE)texPtr->m_resHandle, (int)sizeof(BITMAP), (NkVoid *)&tInfo);
-
-        /* Normalize upper-left corner. */
-        NkFloat const xCoord = srcRect ? srcRect->m_xCoord : 0.f;
-        NkFloat const yCoord = srcRect ? srcRect->m_yCoord : 0.f;
-        /* Normalize width and height. */
-        NkFloat const width  = !srcRect
-            ? tInfo.bmWidth
-            : (srcRect->m_width < 0.f ? tInfo.bmWidth - srcRect->m_width : srcRect->m_width)
-        ;
-        NkFloat const height = !srcRect
-            ? tInfo.bmHeight
-            : (srcRect->m_height < 0.f ? tInfo.bmHeight - srcRect->m_height : srcRect->m_height)
-        ;
-
-        normSrcRect = (NkRectF){ xCoord, yCoord, width, height };
-    } else normSrcRect = *srcRect;
-
-    /* Bind the new bitmap. */
-    if (GetCurrentObject(rdRef->m_gdiRes.mp_texDC, OBJ_BITMAP) != (HGDIOBJ)texPtr->m_resHandle)
-        SelectObject(rdRef->m_gdiRes.mp_texDC, (HGDIOBJ)texPtr->m_resHandle);
+    NkBoolean isPreserved = NK_TRUE;
+    for (NkSize i = 0; i < count; i++) {
+        RECT const statRect = {
+            (LONG)rects[i].m_xCoord + (LONG)rdRef->m_gdiRes.m_vpOri.m_xCoord,
+            (LONG)rects[i].m_yCoord + (LONG)rdRef->m_gdiRes.m_vpOri.m_yCoord,
+            (LONG)rects[i].m_xCoord + (LONG)rdRef->m_gdiRes.m_vpOri.m_xCoord + (LONG)rects[i].m_width,
+            (LONG)rects[i].m_yCoord + (LONG)rdRef->m_gdiRes.m_vpOri.m_yCoord + (LONG)rects[i].m_height
+        };
+
+        NkBoolean wasStatic = IsRectEmpty(&statRect);
+        for (NkSize j = 0; j < dirtyPtr->m_nPrevStatic && !wasStatic; j++) {
+            RECT interRect;
+
+            wasStatic = IntersectRect(&interRect, &statRect, &dirtyPtr->m_prevStaticArr[j]) && EqualRect(&interRect, &statRect);
+        }
+        isPreserved &= wasStatic;
+
+        dirtyPtr->m_staticArr[i] = statRect;
+    }
+    dirtyPtr->m_nStatic = count;
+
+    if (isPreservedPtr != NULL)
+        *isPreservedPtr = isPreserved;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_GdiRenderer_InvalidateFrame(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    ((__NkInt_GdiRenderer *)self)->m_dirtyState.m_isPresFull = NK_TRUE;
+}
+
+/**
+ * \brief  normalizes the given source rectangle, that is, resolves a missing rectangle or
+ *         <tt>-1</tt> extents to the actual extents of the texture
+ * \param  [in] texPtr pointer to the texture resource the source rectangle refers to
+ * \param  [in] srcRect source rectangle to normalize; may be <tt>NULL</tt>
+ * \return normalized source rectangle
+ */
+NK_INTERNAL NK_INLINE NkRectF __NkInt_GdiRenderer_NormalizeSourceRect(
+    _In_     NkRendererResource const *texPtr,
+    _In_opt_ NkRectF const *srcRect
+) {
+    /* Source rectangle is entirely "valid"; nothing to do. */
+    if (srcRect != NULL && srcRect->m_width != -1 && srcRect->m_height != -1)
+        return *srcRect;
+
+    /* The bitmap dimensions are stored in the resource when it's created. */
+    NkFloat const texWidth  = (NkFloat)texPtr->m_resDim.m_width;
+    NkFloat const texHeight = (NkFloat)texPtr->m_resDim.m_height;
+
+    /* Normalize upper-left corner. */
+    NkFloat const xCoord = srcRect ? srcRect->m_xCoord : 0.f;
+    NkFloat const yCoord = srcRect ? srcRect->m_yCoord : 0.f;
+    /* Normalize width and height. */
+    NkFloat const width  = !srcRect
+        ? texWidth
+        : (srcRect->m_width < 0.f ? texWidth - srcRect->m_width : srcRect->m_width)
+    ;
+    NkFloat const height = !srcRect
+        ? texHeight
+        : (srcRect->m_height < 0.f ? texHeight - srcRect->m_height : srcRect->m_height)
+    ;
+
+    return (NkRectF){ xCoord, yCoord, width, height };
+}
+
+/**
+ * \brief binds the given texture bitmap to the texture DC if it is not already bound
+ * \param [in, out] rdRef pointer to the renderer instance
+ * \param [in] texBmp texture bitmap that is to be bound; may also be a mip level
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_GdiRenderer_BindTexture(
+    _Inout_ __NkInt_GdiRenderer *rdRef,
+    _In_    HBITMAP texBmp
+) {
+    /* The software rasterizer reads the pixels directly; nothing has to be selected. */
+    if (rdRef->m_softState.m_isEnabled) {
+        if (rdRef->m_softState.mp_texBmp != texBmp) {
+            __NkInt_GdiRenderer_QueryPixelView(texBmp, &rdRef->m_softState.m_texView);
+            rdRef->m_softState.mp_texBmp = texBmp;
+
+            ++rdRef->m_frameStats.m_currStats.m_nTexBinds;
+        }
+
+        return;
+    }
+
+    if (GetCurrentObject(rdRef->m_gdiRes.mp_texDC, OBJ_BITMAP) != (HGDIOBJ)texBmp) {
+        SelectObject(rdRef->m_gdiRes.mp_texDC, (HGDIOBJ)texBmp);
+
+        ++rdRef->m_frameStats.m_currStats.m_nTexBinds;
+    }
+}
+
+/**
+ * \brief  selects the level of a texture a scaled draw should read from
+ * \param  [in] texPtr pointer to the texture resource that is to be drawn
+ * \param  [in] dstRect destination rectangle
+ * \param  [in, out] srcRect normalized source rectangle; receives the matching
+ *                   rectangle of the selected level
+ * \return bitmap of the selected level
+ *
+ * \par Remarks
+ *   Only draws that shrink the texture portion to half its size or less use a mip
+ *   level. The smallest level that is still at least as large as the destination is
+ *   selected, so the image is never magnified again. If the portion is shrunk by a power
+ *   of two, the rectangle of the selected level has exactly the size of the destination
+ *   and the draw becomes a plain copy.
+ */
+NK_INTERNAL NK_INLINE HBITMAP __NkInt_GdiRenderer_SelectMipLevel(
+    _In_    NkRendererResource const *texPtr,
+    _In_    NkRectF const *dstRect,
+    _Inout_ NkRectF *srcRect
+) {
+    __NkInt_GdiMipChain const *mipPtr = (__NkInt_GdiMipChain const *)texPtr->m_auxHandle;
+    if (mipPtr == NULL || srcRect->m_width < dstRect->m_width * 2.f || srcRect->m_height < dstRect->m_height * 2.f)
+        return (HBITMAP)texPtr->m_resHandle;
+
+    NkSize lvlInd = 0;
+    while (lvlInd + 1 < mipPtr->m_nLevels
+        && srcRect->m_width  >= dstRect->m_width  * (NkFloat)(4 << lvlInd)
+        && srcRect->m_height >= dstRect->m_height * (NkFloat)(4 << lvlInd)
+    ) ++lvlInd;
+
+    /* Levels of odd-sized textures are rounded down, so scale by the actual ratio. */
+    NkFloat const xFac = (NkFloat)mipPtr->m_dimArr[lvlInd].m_width  / (NkFloat)texPtr->m_resDim.m_width;
+    NkFloat const yFac = (NkFloat)mipPtr->m_dimArr[lvlInd].m_height / (NkFloat)texPtr->m_resDim.m_height;
+    *srcRect = (NkRectF){
+        srcRect->m_xCoord * xFac,
+        srcRect->m_yCoord * yFac,
+        srcRect->m_width  * xFac,
+        srcRect->m_height * yFac
+    };
+    return mipPtr->m_levelArr[lvlInd];
+}
+
+/**
+ * \brief blits a portion of the currently bound texture into the back buffer
+ * \param [in, out] rdRef pointer to the renderer instance
+ * \param [in] dstRect destination rectangle, in viewport space
+ * \param [in] srcRect normalized source rectangle
+ * \param [in] isAlpha whether the bound texture is an alpha texture
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_GdiRenderer_BlitBoundTexture(
+    _Inout_ __NkInt_GdiRenderer *rdRef,
+    _In_    NkRectF const *dstRect,
+    _In_    NkRectF const *srcRect,
+    _In_    NkBoolean isAlpha
+) {
+    /* Every blit is a separate GDI call. */
+    __NkInt_GdiRenderer_MarkDirty(rdRef, dstRect);
+    ++rdRef->m_frameStats.m_currStats.m_nSubmits;
+    rdRef->m_frameStats.m_currStats.m_nPxFilled += NkRendererCalculateArea(dstRect);
+
+    if (rdRef->m_softState.m_isEnabled) {
+        NkBoolean const isStretch = !NkRendererCompareRectangles(srcRect, dstRect);
+
+        if (isAlpha)
+            ++rdRef->m_frameStats.m_currStats.m_nAlphaBlits;
+        else if (isStretch)
+            ++rdRef->m_frameStats.m_currStats.m_nStretchBlits;
+        else
+            ++rdRef->m_frameStats.m_currStats.m_nBlits;
+
+        LONG const dstX = (LONG)dstRect->m_xCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_xCoord;
+        LONG const dstY = (LONG)dstRect->m_yCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_yCoord;
+        LONG const srcX = (LONG)srcRect->m_xCoord;
+        LONG const srcY = (LONG)srcRect->m_yCoord;
+        __NkInt_GdiRenderer_SoftSubmit(rdRef, &(__NkInt_GdiSoftCommand const){
+            .m_texView   = rdRef->m_softState.m_texView,
+            .m_dstRect   = { dstX, dstY, dstX + (LONG)dstRect->m_width, dstY + (LONG)dstRect->m_height },
+            .m_srcRect   = { srcX, srcY, srcX + (LONG)srcRect->m_width, srcY + (LONG)srcRect->m_height },
+            .m_isAlpha   = isAlpha,
+            .m_isStretch = isStretch
+        });
+        return;
+    }
+
+    if (isAlpha) {
+        /*
+         * Alpha textures are premultiplied, so a single AlphaBlend() call replaces the
+         * two raster operations MaskBlt() would need. AlphaBlend() scales on its own.
+         */
+        ++rdRef->m_frameStats.m_currStats.m_nAlphaBlits;
+
+        AlphaBlend(
+            rdRef->m_currTgt.mp_tgtDC,
+            (int)dstRect->m_xCoord + (int)rdRef->m_currTgt.m_tgtOri.m_xCoord,
+            (int)dstRect->m_yCoord + (int)rdRef->m_currTgt.m_tgtOri.m_yCoord,
+            (int)dstRect->m_width,
+            (int)dstRect->m_height,
+            rdRef->m_gdiRes.mp_texDC,
+            (int)srcRect->m_xCoord,
+            (int)srcRect->m_yCoord,
+            (int)srcRect->m_width,
+            (int)srcRect->m_height,
+            (BLENDFUNCTION){ AC_SRC_OVER, 0, 0xFF, AC_SRC_ALPHA }
+        );
+        return;
+    }
+
     /*
      * Determine if scaling is needed by simply checking if the source and destination
      * rectangles are the same size, and draw the bitmap.
      */
-    if (NkRendererCompareRectangles(&normSrcRect, dstRect) == NK_TRUE) {
+    if (NkRendererCompareRectangles(srcRect, dstRect) == NK_TRUE) {
         /*
          * Both rectangles are exactly the same size. Great, no scaling is required. That
          * should be the normal case.
          */
+        ++rdRef->m_frameStats.m_currStats.m_nBlits;
+
         BitBlt(
-            rdRef->m_gdiRes.mp_memDC,
-            (int)dstRect->m_xCoord + (int)rdRef->m_gdiRes.m_vpOri.m_xCoord,
-            (int)dstRect->m_yCoord + (int)rdRef->m_gdiRes.m_vpOri.m_yCoord,
+            rdRef->m_currTgt.mp_tgtDC,
+            (int)dstRect->m_xCoord + (int)rdRef->m_currTgt.m_tgtOri.m_xCoord,
+            (int)dstRect->m_yCoord + (int)rdRef->m_currTgt.m_tgtOri.m_yCoord,
             (int)dstRect->m_width,
             (int)dstRect->m_height,
             rdRef->m_gdiRes.mp_texDC,
-            (int)normSrcRect.m_xCoord,
-            (int)normSrcRect.m_yCoord,
+            (int)srcRect->m_xCoord,
+            (int)srcRect->m_yCoord,
             SRCCOPY
         );
     } else {
         /* Fuck, scaling is required. Well, that sucks but what we gonna do? */
+        ++rdRef->m_frameStats.m_currStats.m_nStretchBlits;
+
         StretchBlt(
-            rdRef->m_gdiRes.mp_memDC,
-            (int)dstRect->m_xCoord + (int)rdRef->m_gdiRes.m_vpOri.m_xCoord,
-            (int)dstRect->m_yCoord + (int)rdRef->m_gdiRes.m_vpOri.m_yCoord,
+            rdRef->m_currTgt.mp_tgtDC,
+            (int)dstRect->m_xCoord + (int)rdRef->m_currTgt.m_tgtOri.m_xCoord,
+            (int)dstRect->m_yCoord + (int)rdRef->m_currTgt.m_tgtOri.m_yCoord,
             (int)dstRect->m_width,
             (int)dstRect->m_height,
             rdRef->m_gdiRes.mp_texDC,
-            (int)normSrcRect.m_xCoord,
-            (int)normSrcRect.m_yCoord,
-            (int)normSrcRect.m_width,
-            (int)normSrcRect.m_height,
+            (int)srcRect->m_xCoord,
+            (int)srcRect->m_yCoord,
+            (int)srcRect->m_width,
+            (int)srcRect->m_height,
             SRCCOPY
         );
     }
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_DrawTexture(
+    _Inout_  NkIRenderer *self,
+    _In_     NkRectF const *dstRect,
+    _In_     NkRendererResource const *texPtr,
+    _In_opt_ NkRectF const *srcRect
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+    NK_ASSERT(texPtr != NULL && __NkInt_GdiRenderer_IsTexture(texPtr), NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    /*
+     * To know which blit function we need to use, we must first determine if scaling is
+     * needed. This may require us to first 'normalize' our source rectangle.
+     */
+    NkRectF normSrcRect = __NkInt_GdiRenderer_NormalizeSourceRect(texPtr, srcRect);
+
+    /* Bind the new bitmap (or the best-fitting mip level) and draw it. */
+    __NkInt_GdiRenderer_BindTexture(rdRef, __NkInt_GdiRenderer_SelectMipLevel(texPtr, dstRect, &normSrcRect));
+    __NkInt_GdiRenderer_BlitBoundTexture(rdRef, dstRect, &normSrcRect, texPtr->m_resType == NkRdResTy_AlphaTexture);
     
     /* All good. */
     return NkErr_Ok;
 }
 
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_DrawTextureBatch(
+    _Inout_              NkIRenderer *self,
+    _In_                 NkRendererResource const *texPtr,
+    _In_                 NkSize count,
+    _I_array_(count)     NkRectF const *dstRects,
+    _I_array_opt_(count) NkRectF const *srcRects
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(texPtr != NULL && __NkInt_GdiRenderer_IsTexture(texPtr), NkErr_InParameter);
+    NK_ASSERT(count == 0 || dstRects != NULL, NkErr_InParameter);
+
+    /* Nothing to draw. */
+    if (count == 0)
+        return NkErr_Ok;
+
+    /* Get pointer to renderer structure. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    /*
+     * Draw all texture portions. The texture is only bound once for the entire span,
+     * unless portions are drawn from different mip levels.
+     */
+    NkBoolean const isAlpha = texPtr->m_resType == NkRdResTy_AlphaTexture;
+    HBITMAP         prevBmp = NULL;
+    for (NkSize i = 0; i < count; i++) {
+        NkRectF normSrcRect = __NkInt_GdiRenderer_NormalizeSourceRect(texPtr, srcRects != NULL ? &srcRects[i] : NULL);
+
+        HBITMAP const lvlBmp = __NkInt_GdiRenderer_SelectMipLevel(texPtr, &dstRects[i], &normSrcRect);
+        if (lvlBmp != prevBmp) {
+            __NkInt_GdiRenderer_BindTexture(rdRef, lvlBmp);
+
+            prevBmp = lvlBmp;
+        }
+        __NkInt_GdiRenderer_BlitBoundTexture(rdRef, &dstRects[i], &normSrcRect, isAlpha);
+    }
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
 /**
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_DrawMaskedTexture(
@@ -616,20 +1952,47 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_DrawMaskedTextur
     NK_ASSERT(dstRect != NULL, NkErr_InParameter);
     NK_ASSERT(texPtr != NULL, NkErr_InParameter);
     NK_ASSERT(maskPtr != NULL, NkErr_InParameter);
-    NK_ASSERT(texPtr->m_resType == NkRdResTy_Texture, NkErr_InParameter);
+    NK_ASSERT(__NkInt_GdiRenderer_IsTexture(texPtr), NkErr_InParameter);
     NK_ASSERT(maskPtr->m_resType == NkRdResTy_TextureMask, NkErr_InParameter);
 
     /* Get pointer to renderer structure. */
     __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
     /* Select the new texture into the texture slot. */
-    if (GetCurrentObject(rdRef->m_gdiRes.mp_texDC, OBJ_BITMAP) != (HGDIOBJ)texPtr->m_resHandle)
-        SelectObject(rdRef->m_gdiRes.mp_texDC, (HGDIOBJ)texPtr->m_resHandle);
+    __NkInt_GdiRenderer_BindTexture(rdRef, (HBITMAP)texPtr->m_resHandle);
+
+    __NkInt_GdiRenderer_MarkDirty(rdRef, dstRect);
+    ++rdRef->m_frameStats.m_currStats.m_nMaskBlits;
+    ++rdRef->m_frameStats.m_currStats.m_nSubmits;
+    rdRef->m_frameStats.m_currStats.m_nPxFilled += NkRendererCalculateArea(dstRect);
+
+    if (rdRef->m_softState.m_isEnabled) {
+        struct __NkInt_GdiSoftState *softPtr = &rdRef->m_softState;
+
+        if (softPtr->mp_maskBmp != (HBITMAP)maskPtr->m_resHandle) {
+            __NkInt_GdiRenderer_QueryPixelView((HBITMAP)maskPtr->m_resHandle, &softPtr->m_maskView);
+            softPtr->mp_maskBmp = (HBITMAP)maskPtr->m_resHandle;
+        }
+
+        LONG const dstX = (LONG)dstRect->m_xCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_xCoord;
+        LONG const dstY = (LONG)dstRect->m_yCoord + (LONG)rdRef->m_currTgt.m_tgtOri.m_yCoord;
+        LONG const srcX = (LONG)srcOff.m_xVal;
+        LONG const srcY = (LONG)srcOff.m_yVal;
+        __NkInt_GdiRenderer_SoftSubmit(rdRef, &(__NkInt_GdiSoftCommand const){
+            .m_texView  = softPtr->m_texView,
+            .m_maskView = softPtr->m_maskView,
+            .m_dstRect  = { dstX, dstY, dstX + (LONG)dstRect->m_width, dstY + (LONG)dstRect->m_height },
+            .m_srcRect  = { srcX, srcY, srcX + (LONG)dstRect->m_width, srcY + (LONG)dstRect->m_height },
+            .m_maskOri  = { (LONG)maskOff.m_xVal, (LONG)maskOff.m_yVal },
+            .m_isMasked = NK_TRUE
+        });
+        return NkErr_Ok;
+    }
 
     /* Draw the bitmap with the transparency information. */
     MaskBlt(
-        rdRef->m_gdiRes.mp_memDC,
-        (int)dstRect->m_xCoord + (int)rdRef->m_gdiRes.m_vpOri.m_xCoord,
-        (int)dstRect->m_yCoord + (int)rdRef->m_gdiRes.m_vpOri.m_yCoord,
+        rdRef->m_currTgt.mp_tgtDC,
+        (int)dstRect->m_xCoord + (int)rdRef->m_currTgt.m_tgtOri.m_xCoord,
+        (int)dstRect->m_yCoord + (int)rdRef->m_currTgt.m_tgtOri.m_yCoord,
         (int)dstRect->m_width,
         (int)dstRect->m_height,
         rdRef->m_gdiRes.mp_texDC,
@@ -647,21 +2010,103 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_DrawMaskedTextur
 
 /**
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateTexture(
-    _Inout_        NkIRenderer *self,
-    _In_           NkDIBitmap const *dibPtr,
-    _Maybe_reinit_ NkRendererResource **resourcePtr
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_SetRenderTarget(
+    _Inout_  NkIRenderer *self,
+    _In_opt_ NkRendererResource const *surfPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(surfPtr == NULL || surfPtr->m_resType == NkRdResTy_Surface, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    if (surfPtr == NULL) {
+        /* Go back to rendering into the back buffer. */
+        SelectObject(rdRef->m_gdiRes.mp_surfDC, rdRef->m_gdiRes.mp_defSurfBmp);
+
+        rdRef->m_currTgt = (struct __NkInt_GdiTarget){ NULL, rdRef->m_gdiRes.mp_memDC, rdRef->m_gdiRes.m_vpOri };
+        if (rdRef->m_softState.m_isEnabled)
+            __NkInt_GdiRenderer_QueryPixelView(rdRef->m_gdiRes.mp_memBmp, &rdRef->m_softState.m_tgtView);
+        return NkErr_Ok;
+    }
+
+    /* Recorded draws into the back buffer may read the surface that is about to change. */
+    __NkInt_GdiRenderer_SoftFlush(rdRef);
+
+    /*
+     * A bitmap can only ever be selected into one DC at a time. Thus, if the surface is
+     * currently bound as a texture, unbind it first.
+     */
+    if (GetCurrentObject(rdRef->m_gdiRes.mp_texDC, OBJ_BITMAP) == (HGDIOBJ)surfPtr->m_resHandle)
+        SelectObject(rdRef->m_gdiRes.mp_texDC, rdRef->m_gdiRes.mp_defTexBmp);
+    SelectObject(rdRef->m_gdiRes.mp_surfDC, (HGDIOBJ)surfPtr->m_resHandle);
+
+    rdRef->m_currTgt = (struct __NkInt_GdiTarget){ surfPtr, rdRef->m_gdiRes.mp_surfDC, { 0, 0 } };
+    if (rdRef->m_softState.m_isEnabled)
+        __NkInt_GdiRenderer_QueryPixelView((HBITMAP)surfPtr->m_resHandle, &rdRef->m_softState.m_tgtView);
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_ScrollSurface(
+    _Inout_ NkIRenderer *self,
+    _In_    NkRendererResource const *surfPtr,
+    _In_    NkPoint2D scrollOff
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfPtr != NULL && surfPtr->m_resType == NkRdResTy_Surface, NkErr_InParameter);
 
     /* Get pointer to renderer structure. */
     __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+    if (scrollOff.m_xCoord == 0 && scrollOff.m_yCoord == 0)
+        return NkErr_Ok;
+    __NkInt_GdiRenderer_SoftFlush(rdRef);
+
+    /* Temporarily select the surface into the surface DC if it's not the current target. */
+    HGDIOBJ oldBmp = NULL;
+    if (rdRef->m_currTgt.mp_surfPtr != surfPtr) {
+        if (GetCurrentObject(rdRef->m_gdiRes.mp_texDC, OBJ_BITMAP) == (HGDIOBJ)surfPtr->m_resHandle)
+            SelectObject(rdRef->m_gdiRes.mp_texDC, rdRef->m_gdiRes.mp_defTexBmp);
+
+        oldBmp = SelectObject(rdRef->m_gdiRes.mp_surfDC, (HGDIOBJ)surfPtr->m_resHandle);
+    }
+
+    /*
+     * Shift the contents. The area that is uncovered by the scroll operation is left as-is
+     * and must be redrawn by the caller.
+     */
+    ScrollDC(rdRef->m_gdiRes.mp_surfDC, (int)scrollOff.m_xCoord, (int)scrollOff.m_yCoord, NULL, NULL, NULL, NULL);
+    if (rdRef->m_softState.m_isEnabled)
+        GdiFlush();
+
+    if (oldBmp != NULL)
+        SelectObject(rdRef->m_gdiRes.mp_surfDC, oldBmp);
+    return NkErr_Ok;
+}
 
+/**
+ * \brief  creates a texture bitmap from the pixels of a device-independent bitmap
+ * \param  [in, out] rdRef pointer to the renderer instance
+ * \param  [in] dibPtr pointer to the bitmap that holds the pixels
+ * \param  [out] bmpPtr pointer to a variable that receives the texture bitmap
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_GdiRenderer_CreateBitmapFromDIB(
+    _Inout_ __NkInt_GdiRenderer *rdRef,
+    _In_    NkDIBitmap const *dibPtr,
+    _Out_   HBITMAP *bmpPtr
+) {
     /* Query bitmap specification. */
     NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
-    /* Create device-dependent texture. */
-    HBITMAP ddTex = CreateCompatibleBitmap(rdRef->m_gdiRes.mp_memDC, bmSpecs->m_bmpWidth, bmSpecs->m_bmpHeight);
+    /*
+     * Create device-dependent texture. The software rasterizer needs access to the
+     * pixels, so it gets a DIB section instead; SetDIBits() converts the pixels either
+     * way.
+     */
+    HBITMAP ddTex = rdRef->m_softState.m_isEnabled
+        ? __NkInt_GdiRenderer_CreateDIBSection32(rdRef->m_gdiRes.mp_memDC, bmSpecs->m_bmpWidth, bmSpecs->m_bmpHeight, NULL)
+        : CreateCompatibleBitmap(rdRef->m_gdiRes.mp_memDC, bmSpecs->m_bmpWidth, bmSpecs->m_bmpHeight);
     if (ddTex == NULL)
         return NkErr_CreateCompBitmap;
 
@@ -690,24 +2135,153 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateTexture(
         return NkErr_CreateDDBFromDIB;
     }
 
+    *bmpPtr = ddTex;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  precomputes the downscaled levels of a texture
+ * \param  [in, out] rdRef pointer to the renderer instance
+ * \param  [in] dibPtr pointer to the bitmap the texture was created from
+ * \return pointer to the mip chain, or \c NULL if no level could be created
+ * \note   Mip levels only speed up scaled draws, so failing to create some is not an
+ *         error; the chain simply ends early.
+ */
+NK_INTERNAL __NkInt_GdiMipChain *__NkInt_GdiRenderer_CreateMipChain(
+    _Inout_ __NkInt_GdiRenderer *rdRef,
+    _In_    NkDIBitmap const *dibPtr
+) {
+    __NkInt_GdiMipChain *mipPtr;
+    if (NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *mipPtr, 0, NK_TRUE, (NkVoid **)&mipPtr) != NkErr_Ok)
+        return NULL;
+
+    /* Every level is filtered from the previous one; only two of them are kept around. */
+    NkDIBitmap        lvlDibs[2];
+    NkDIBitmap const *prevDib = dibPtr;
+    while (mipPtr->m_nLevels < __NkInt_GdiRenderer_MaxMipLevels) {
+        NkDIBitmap *const currDib = &lvlDibs[mipPtr->m_nLevels % 2];
+        if (NkDIBitmapDownsample(prevDib, currDib) != NkErr_Ok)
+            break;
+        if (prevDib != dibPtr)
+            NkDIBitmapDestroy((NkDIBitmap *)prevDib);
+        prevDib = currDib;
+
+        NkBitmapSpecification const *lvlSpecs = NkDIBitmapGetSpecification(currDib);
+        if (__NkInt_GdiRenderer_CreateBitmapFromDIB(rdRef, currDib, &mipPtr->m_levelArr[mipPtr->m_nLevels]) != NkErr_Ok)
+            break;
+        mipPtr->m_dimArr[mipPtr->m_nLevels++] = (NkSize2D){ (NkUint64)lvlSpecs->m_bmpWidth, (NkUint64)lvlSpecs->m_bmpHeight };
+    }
+    if (prevDib != dibPtr)
+        NkDIBitmapDestroy((NkDIBitmap *)prevDib);
+
+    if (mipPtr->m_nLevels == 0) {
+        NkGPFree((NkVoid *)mipPtr);
+
+        return NULL;
+    }
+    return mipPtr;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    /* Create the texture from the DIB pixels. */
+    HBITMAP ddTex;
+    NkErrorCode errCode = __NkInt_GdiRenderer_CreateBitmapFromDIB(rdRef, dibPtr, &ddTex);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    /*
+     * If requested, precompute the downscaled levels now, so that zoomed-out draws can
+     * copy from a level of matching size instead of filtering the whole texture.
+     */
+    __NkInt_GdiMipChain *mipPtr = rdRef->m_currSpec.m_isMipmapped ? __NkInt_GdiRenderer_CreateMipChain(rdRef, dibPtr) : NULL;
+
     /*
      * Initialize the result structure. But first, we must check if the result structure
      * is already valid. In such a case, we must first delete the old instance. This
      * allows us to reuse instances without having to reallocate memory all the time.
      */
-    NkErrorCode errCode;
     if ((errCode = __NkInt_GdiRenderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        __NkInt_GdiRenderer_DeleteMipChain(rdRef, mipPtr);
         DeleteObject(ddTex);
 
         return errCode;
     }
 
     /* (Re-)initialize result structure. */
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
     **resourcePtr = (NkRendererResource){
         .mp_rdRef    = __NkInt_GdiRenderer_RefInstance(self),
         .m_resType   = NkRdResTy_Texture,
         .m_resHandle = (NkRendererResourceHandle)ddTex,
-        .m_resFlags  = 0
+        .m_auxHandle = (NkRendererResourceHandle)mipPtr,
+        .m_resFlags  = 0,
+        .m_resDim    = { (NkUint64)bmSpecs->m_bmpWidth, (NkUint64)bmSpecs->m_bmpHeight }
+    };
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateAlphaTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _In_opt_       NkRgbaColor const *colKey,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_OutptrParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    /* Convert the bitmap into premultiplied top-down pixels. */
+    NkUint32 *alphaPx;
+    NkErrorCode errCode = NkRendererPremultiplyBitmap(dibPtr, colKey, &alphaPx);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
+    int const texWidth  = (int)bmSpecs->m_bmpWidth;
+    int const texHeight = (int)(bmSpecs->m_bmpHeight < 0 ? -bmSpecs->m_bmpHeight : bmSpecs->m_bmpHeight);
+
+    /*
+     * AlphaBlend() only honors per-pixel alpha of 32-bit DIB sections; device-dependent
+     * bitmaps lose the alpha channel. Hence, create the texture as a DIB section.
+     */
+    NkVoid *dibBits;
+    HBITMAP alphaTex = __NkInt_GdiRenderer_CreateDIBSection32(rdRef->m_gdiRes.mp_memDC, texWidth, texHeight, &dibBits);
+    if (alphaTex == NULL) {
+        NkGPFree((NkVoid *)alphaPx);
+
+        return NkErr_CreateCompBitmap;
+    }
+    memcpy(dibBits, alphaPx, (NkSize)texWidth * texHeight * sizeof *alphaPx);
+    NkGPFree((NkVoid *)alphaPx);
+
+    /* Create new resource, delete old if needed. */
+    if ((errCode = __NkInt_GdiRenderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        DeleteObject(alphaTex);
+
+        return errCode;
+    }
+    /* (Re-)initialize new resource. */
+    **resourcePtr = (NkRendererResource){
+        .mp_rdRef    = __NkInt_GdiRenderer_RefInstance(self),
+        .m_resType   = NkRdResTy_AlphaTexture,
+        .m_resHandle = (NkRendererResourceHandle)alphaTex,
+        .m_resFlags  = 0,
+        .m_resDim    = { (NkUint64)texWidth, (NkUint64)texHeight }
     };
     return NkErr_Ok;
 }
@@ -728,12 +2302,51 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateTextureMas
     /* Get pointer to renderer structure. */
     __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
     /* Retrieve source bitmap properties. */
-    BITMAP tInfo;
-    GetObject((HANDLE)texPtr->m_resHandle, (int)sizeof(BITMAP), (NkVoid *)&tInfo);
+    int const texWidth  = (int)texPtr->m_resDim.m_width;
+    int const texHeight = (int)texPtr->m_resDim.m_height;
+
+    HBITMAP monoBmp;
+    if (rdRef->m_softState.m_isEnabled) {
+        /*
+         * The software rasterizer uses 8-bit masks with one byte per pixel; the palette
+         * merely makes them viewable.
+         */
+        struct { BITMAPINFOHEADER m_bmiHeader; RGBQUAD m_palArr[256]; } maskInfo = {
+            .m_bmiHeader = {
+                .biSize        = sizeof(BITMAPINFOHEADER),
+                .biWidth       = texWidth,
+                .biHeight      = -texHeight,
+                .biBitCount    = 8,
+                .biPlanes      = 1,
+                .biCompression = BI_RGB,
+                .biClrUsed     = 256
+            }
+        };
+        for (int i = 0; i < 256; i++)
+            maskInfo.m_palArr[i] = (RGBQUAD){ (BYTE)i, (BYTE)i, (BYTE)i, 0 };
+
+        NkVoid *maskBits;
+        __NkInt_GdiPixelView texView, maskView;
+        if (!__NkInt_GdiRenderer_QueryPixelView((HBITMAP)texPtr->m_resHandle, &texView))
+            return NkErr_InParameter;
+        if ((monoBmp = CreateDIBSection(rdRef->m_gdiRes.mp_memDC, (BITMAPINFO const *)&maskInfo, DIB_RGB_COLORS, &maskBits, NULL, 0)) == NULL)
+            return NkErr_CreateCompBitmap;
+        __NkInt_GdiRenderer_QueryPixelView(monoBmp, &maskView);
+
+        NkUint32 const keyPx = (NkUint32)colKey.m_rVal << 16 | (NkUint32)colKey.m_gVal << 8 | (NkUint32)colKey.m_bVal;
+        for (LONG y = 0; y < (LONG)texHeight; y++)
+            NkPixelColorKeyMask32(
+                __NkInt_GdiRenderer_PixelAt(&maskView, 0, y),
+                __NkInt_GdiRenderer_PixelAt(&texView, 0, y),
+                (NkSize)texWidth,
+                keyPx
+            );
+
+        goto lbl_CREATERES;
+    }
 
     /* Create monochrome bitmap of the required size. */
-    HBITMAP monoBmp = CreateBitmap(tInfo.bmWidth, tInfo.bmHeight, 1U, 1U, NULL);
-    if (monoBmp == NULL)
+    if ((monoBmp = CreateBitmap(texWidth, texHeight, 1U, 1U, NULL)) == NULL)
         return NkErr_CreateCompBitmap;
     /* Setup two temporary DCs that are needed for the bitmask creation. */
     COLORREF oldCol = SetBkColor(rdRef->m_gdiRes.mp_texDC, RGB(colKey.m_rVal, colKey.m_gVal, colKey.m_bVal));
@@ -747,23 +2360,67 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateTextureMas
      * expects transparent pixels to be mapped to black, we use the NOTSRCCOPY to invert
      * the colors as we write it to the mask bitmap.
      */
-    BitBlt(rdRef->m_gdiRes.mp_memDC, 0, 0, tInfo.bmWidth, tInfo.bmHeight, rdRef->m_gdiRes.mp_texDC, 0, 0, NOTSRCCOPY);
+    BitBlt(rdRef->m_gdiRes.mp_memDC, 0, 0, texWidth, texHeight, rdRef->m_gdiRes.mp_texDC, 0, 0, NOTSRCCOPY);
 
     /* Restore the old DC settings. */
     SelectObject(rdRef->m_gdiRes.mp_memDC, oldBmp);
     SelectObject(rdRef->m_gdiRes.mp_texDC, oldObj);
     SetBkColor(rdRef->m_gdiRes.mp_texDC, oldCol);
 
+lbl_CREATERES:;
     /* Create new resource, delete old if needed. */
     NkErrorCode errCode;
-    if ((errCode = __NkInt_GdiRenderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok)
+    if ((errCode = __NkInt_GdiRenderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        DeleteObject(monoBmp);
+
         return errCode;
+    }
     /* (Re-)initialize new resource. */
     **resourcePtr = (NkRendererResource){
         .mp_rdRef    = __NkInt_GdiRenderer_RefInstance(self),
         .m_resType   = NkRdResTy_TextureMask,
         .m_resHandle = (NkRendererResourceHandle)monoBmp,
-        .m_resFlags  = 0
+        .m_resFlags  = 0,
+        .m_resDim    = texPtr->m_resDim
+    };
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CreateSurface(
+    _Inout_        NkIRenderer *self,
+    _In_           NkSize2D surfDim,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfDim.m_width > 0 && surfDim.m_height > 0, NkErr_InParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_OutptrParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    /* Create a bitmap compatible with our back buffer. */
+    HBITMAP surfBmp = rdRef->m_softState.m_isEnabled
+        ? __NkInt_GdiRenderer_CreateDIBSection32(rdRef->m_gdiRes.mp_memDC, (int)surfDim.m_width, (int)surfDim.m_height, NULL)
+        : CreateCompatibleBitmap(rdRef->m_gdiRes.mp_memDC, (int)surfDim.m_width, (int)surfDim.m_height);
+    if (surfBmp == NULL)
+        return NkErr_CreateCompBitmap;
+
+    /* Create new resource, delete old if needed. */
+    NkErrorCode errCode;
+    if ((errCode = __NkInt_GdiRenderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok) {
+        DeleteObject(surfBmp);
+
+        return errCode;
+    }
+    /* (Re-)initialize new resource. */
+    **resourcePtr = (NkRendererResource){
+        .mp_rdRef    = __NkInt_GdiRenderer_RefInstance(self),
+        .m_resType   = NkRdResTy_Surface,
+        .m_resHandle = (NkRendererResourceHandle)surfBmp,
+        .m_resFlags  = 0,
+        .m_resDim    = surfDim
     };
     return NkErr_Ok;
 }
@@ -789,37 +2446,25 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_DeleteResource(
 
 /**
  */
-NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_GrabFramebuffer(
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_CopyFramebuffer(
     _Inout_ NkIRenderer *self,
-    _Out_   NkDIBitmap *resPtr
+    _Inout_ NkDIBitmap *bmpPtr
 ) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_ASSERT(resPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(bmpPtr != NULL, NkErr_InOutParameter);
 
     NkErrorCode errCode = NkErr_Ok;
     /* Get pointer to renderer structure. */
     __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
 
-    /* Create bitmap of the appropriate size that will hold the framebuffer. */
-    errCode = NkDIBitmapCreate(&(NkBitmapSpecification){
-        .m_structSize = sizeof(NkBitmapSpecification),
-        .m_bmpWidth   = (NkInt32)rdRef->m_gdiRes.m_bbDim.m_width,
-        .m_bmpHeight  = (NkInt32)rdRef->m_gdiRes.m_bbDim.m_height,
-        .m_bitsPerPx  = 32,
-        .m_bmpFlags   = NkBmpFlag_Flipped
-    }, NULL, resPtr);
-    if (errCode != NkErr_Ok) {
-        /* Failed to create the bitmap. */
-        NK_LOG_ERROR(
-            "Could not create DIB for screenshot. Reason: %s (%i)",
-            NkGetErrorCodeStr(errCode)->mp_dataPtr,
-            errCode
-        );
-
-        return errCode;
-    }
+    NkBitmapSpecification const *bmpSpecs = NkDIBitmapGetSpecification(bmpPtr);
+    if ((NkUint64)bmpSpecs->m_bmpWidth != rdRef->m_gdiRes.m_bbDim.m_width
+        || (NkUint64)bmpSpecs->m_bmpHeight != rdRef->m_gdiRes.m_bbDim.m_height
+        || bmpSpecs->m_bitsPerPx != 32
+    ) return NkErr_InvImageDimensions;
 
     /* Make sure that all pending draw commands have been written to the device. */
+    __NkInt_GdiRenderer_SoftFlush(rdRef);
     GdiFlush();
     /*
      * Before we can copy the pixels, we must unbind the framebuffer from the rendering
@@ -830,7 +2475,7 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_GrabFramebuffer(
 
     /* Get pointer to DIB pixel buffer. */
     NkUint32 pxBufSz; 
-    LPVOID pxBuf = (LPVOID)NkDIBitmapGetPixels(resPtr, &pxBufSz);
+    LPVOID pxBuf = (LPVOID)NkDIBitmapGetPixels(bmpPtr, &pxBufSz);
     /* Copy the current framebuffer state. */
     int cLinesCopied = GetDIBits(
         rdRef->m_gdiRes.mp_memDC,
@@ -859,16 +2504,52 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_GrabFramebuffer(
         /* There was an error copying the DDB pixels. */
         NK_LOG_ERROR("There was an error copying framebuffer DDB pixels to the DIB.");
 
-        goto lbl_END;
+        errCode = NkErr_CopyDDBPixels;
     }
 
-lbl_END:
     /* Reselect the framebuffer into the rendering device context. */
     SelectObject(rdRef->m_gdiRes.mp_memDC, currFB);
 
     return errCode;
 }
 
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_GdiRenderer_GrabFramebuffer(
+    _Inout_ NkIRenderer *self,
+    _Out_   NkDIBitmap *resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_InOutParameter);
+
+    NkErrorCode errCode = NkErr_Ok;
+    /* Get pointer to renderer structure. */
+    __NkInt_GdiRenderer *rdRef = (__NkInt_GdiRenderer *)self;
+
+    /* Create bitmap of the appropriate size that will hold the framebuffer. */
+    errCode = NkDIBitmapCreate(&(NkBitmapSpecification){
+        .m_structSize = sizeof(NkBitmapSpecification),
+        .m_bmpWidth   = (NkInt32)rdRef->m_gdiRes.m_bbDim.m_width,
+        .m_bmpHeight  = (NkInt32)rdRef->m_gdiRes.m_bbDim.m_height,
+        .m_bitsPerPx  = 32,
+        .m_bmpFlags   = NkBmpFlag_Flipped
+    }, NULL, resPtr);
+    if (errCode != NkErr_Ok) {
+        /* Failed to create the bitmap. */
+        NK_LOG_ERROR(
+            "Could not create DIB for screenshot. Reason: %s (%i)",
+            NkGetErrorCodeStr(errCode)->mp_dataPtr,
+            errCode
+        );
+
+        return errCode;
+    }
+
+    if ((errCode = __NkInt_GdiRenderer_CopyFramebuffer(self, resPtr)) != NkErr_Ok)
+        NkDIBitmapDestroy(resPtr);
+    return errCode;
+}
+
 
 /**
  * \brief VTable for the NkIGdiRenderer class 
@@ -882,15 +2563,24 @@ NKOM_DEFINE_VTABLE(NkIRenderer) {
     .QuerySpecification      = &__NkInt_GdiRenderer_QuerySpecification,
     .QueryWindow             = &__NkInt_GdiRenderer_QueryWindow,
     .QueryViewportDimensions = &__NkInt_GdiRenderer_QueryViewportDimensions,
+    .QueryFrameStatistics    = &__NkInt_GdiRenderer_QueryFrameStatistics,
     .Resize                  = &__NkInt_GdiRenderer_Resize,
     .BeginDraw               = &__NkInt_GdiRenderer_BeginDraw,
     .EndDraw                 = &__NkInt_GdiRenderer_EndDraw,
+    .SetStaticRegions        = &__NkInt_GdiRenderer_SetStaticRegions,
+    .InvalidateFrame         = &__NkInt_GdiRenderer_InvalidateFrame,
     .DrawTexture             = &__NkInt_GdiRenderer_DrawTexture,
+    .DrawTextureBatch        = &__NkInt_GdiRenderer_DrawTextureBatch,
     .DrawMaskedTexture       = &__NkInt_GdiRenderer_DrawMaskedTexture,
+    .SetRenderTarget         = &__NkInt_GdiRenderer_SetRenderTarget,
+    .ScrollSurface           = &__NkInt_GdiRenderer_ScrollSurface,
     .CreateTexture           = &__NkInt_GdiRenderer_CreateTexture,
+    .CreateAlphaTexture      = &__NkInt_GdiRenderer_CreateAlphaTexture,
     .CreateTextureMask       = &__NkInt_GdiRenderer_CreateTextureMask,
+    .CreateSurface           = &__NkInt_GdiRenderer_CreateSurface,
     .DeleteResource          = &__NkInt_GdiRenderer_DeleteResource,
-    .GrabFramebuffer         = &__NkInt_GdiRenderer_GrabFramebuffer
+    .GrabFramebuffer         = &__NkInt_GdiRenderer_GrabFramebuffer,
+    .CopyFramebuffer         = &__NkInt_GdiRenderer_CopyFramebuffer
 };
 
 /**
@@ -17,13 +17,85 @@
 #define NK_NAMESPACE "nk::wininput"
 
 
+/* stdlib includes */
+#include <string.h>
+
 /* Noriko includes */
 #include <include/Noriko/input.h>
 #include <include/Noriko/log.h>
 #include <include/Noriko/platform.h>
+#include <include/Noriko/timer.h>
 
 
 /** \cond INTERNAL */
+/**
+ * \struct __NkInt_WindowsInputBuffer
+ * \brief  ring buffer holding the input records generated in buffered mode
+ *
+ * \par Remarks
+ *   The buffer has exactly one producer (the window procedure of the window that
+ *   registered for raw input) and exactly one consumer (the reader of the records).
+ *   Positions are only ever incremented; a record becomes visible to the consumer once
+ *   the write position is advanced past it.
+ */
+NK_NATIVE typedef struct __NkInt_WindowsInputBuffer {
+    NkBoolean volatile m_isEnabled;                            /**< whether buffered mode is enabled */
+    LONG volatile      m_writePos;                             /**< next record to be written */
+    LONG volatile      m_readPos;                              /**< next record to be read */
+    LONG volatile      m_nDropped;                             /**< number of records dropped since enabling */
+    NkUint32           m_keyState[NK_MAX_NUM_KEY_CODES / 32];  /**< keys currently held down (filters auto-repeat) */
+    NkInputRecordHook  mp_fnHook;                              /**< (optional) hook invoked for every appended record */
+    NkVoid            *mp_hookCxt;                             /**< context pointer for the hook */
+    NkInputRecord      m_recArr[NK_INPUT_BUFFERSIZE];          /**< record storage */
+} __NkInt_WindowsInputBuffer;
+/**
+ * \brief input buffer used by the Win32 IAL in buffered mode
+ */
+NK_INTERNAL __NkInt_WindowsInputBuffer gl_InputBuf;
+
+
+/**
+ * \brief  appends a record to the input buffer
+ * \param  [in] recPtr pointer to the record that is to be appended
+ * \return \c NK_TRUE if the record was appended, \c NK_FALSE if the buffer was full
+ * \note   This function must only be called by the producer.
+ */
+NK_INTERNAL NkBoolean __NkInt_WindowsInput_PushRecord(_In_ NkInputRecord const *recPtr) {
+    LONG const writePos = gl_InputBuf.m_writePos;
+
+    if ((NkSize)(writePos - gl_InputBuf.m_readPos) >= NK_INPUT_BUFFERSIZE) {
+        /* Buffer is full; drop the record as we cannot block the window procedure. */
+        InterlockedIncrement(&gl_InputBuf.m_nDropped);
+
+        return NK_FALSE;
+    }
+
+    /* Write record, then publish it. */
+    gl_InputBuf.m_recArr[writePos & (NK_INPUT_BUFFERSIZE - 1)] = *recPtr;
+    InterlockedExchange(&gl_InputBuf.m_writePos, writePos + 1);
+
+    if (gl_InputBuf.mp_fnHook != NULL)
+        gl_InputBuf.mp_fnHook(recPtr, gl_InputBuf.mp_hookCxt);
+    return NK_TRUE;
+}
+
+/**
+ * \brief  updates the held-down state of the given key
+ * \param  [in] keyCode key whose state is to be updated
+ * \param  [in] isDown whether the key is now held down
+ * \return \c NK_TRUE if the state changed, \c NK_FALSE if it did not (auto-repeat)
+ */
+NK_INTERNAL NkBoolean __NkInt_WindowsInput_UpdateKeyState(_In_ NkKeyboardKey keyCode, _In_ NkBoolean isDown) {
+    NkUint32 *const keyWord = &gl_InputBuf.m_keyState[(keyCode & (NK_MAX_NUM_KEY_CODES - 1)) / 32];
+    NkUint32 const  keyBit  = (NkUint32)1 << (keyCode % 32);
+
+    if (((*keyWord & keyBit) != 0) == isDown)
+        return NK_FALSE;
+
+    *keyWord ^= keyBit;
+    return NK_TRUE;
+}
+
 /**
  */
 NK_INTERNAL NkOMRefCount NK_CALL __NkInt_WindowsInput_AddRef(_Inout_ NkIInput *self) {
@@ -412,6 +484,198 @@ NK_INTERNAL NkModifierKeys NK_CALL __NkInt_WindowsInput_GetModifierKeyStates(_In
     );
 }
 
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WindowsInput_SetBufferedMode(
+    _Inout_ NkIInput *self,
+    _In_    NkVoid *ntWndHandle,
+    _In_    NkBoolean isEnabled
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(ntWndHandle != NULL || !isEnabled, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    if (gl_InputBuf.m_isEnabled == isEnabled)
+        return NkErr_NoOperation;
+
+    /*
+     * Register for raw keyboard and mouse input. Legacy messages (WM_KEYDOWN, etc.) are
+     * still generated; the window continues to dispatch them as events.
+     */
+    RAWINPUTDEVICE const devArr[] = {
+        { 0x01, 0x06, isEnabled ? 0 : RIDEV_REMOVE, isEnabled ? (HWND)ntWndHandle : NULL }, /* keyboard */
+        { 0x01, 0x02, isEnabled ? 0 : RIDEV_REMOVE, isEnabled ? (HWND)ntWndHandle : NULL }  /* mouse */
+    };
+    if (!RegisterRawInputDevices(devArr, (UINT)NK_ARRAYSIZE(devArr), sizeof *devArr)) {
+        NK_LOG_ERROR("Failed to %s raw input devices. GetLastError(): %u", isEnabled ? "register" : "unregister", GetLastError());
+
+        return NkErr_RegisterInputDevice;
+    }
+
+    /*
+     * Discard all state. The producer is the window procedure which runs on the calling
+     * thread, so no record can be written concurrently.
+     */
+    memset((NkVoid *)gl_InputBuf.m_keyState, 0, sizeof gl_InputBuf.m_keyState);
+    gl_InputBuf.m_readPos  = gl_InputBuf.m_writePos;
+    gl_InputBuf.m_nDropped = 0;
+    gl_InputBuf.m_isEnabled = isEnabled;
+
+    NK_LOG_INFO("%s buffered input mode.", isEnabled ? "Enabled" : "Disabled");
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WindowsInput_OnNativeInput(_Inout_ NkIInput *self, _In_ NkVoid *ntInputHandle) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(ntInputHandle != NULL, NkErr_InParameter);
+
+    if (!gl_InputBuf.m_isEnabled)
+        return;
+
+    /* Take the timestamp first so that parsing the message does not skew it. */
+    NkUint64 const currTime = NkTimerGetCurrentTicks();
+    RAWINPUT       rawInput;
+    UINT           rawSize  = sizeof rawInput;
+    if (GetRawInputData((HRAWINPUT)ntInputHandle, RID_INPUT, &rawInput, &rawSize, sizeof(RAWINPUTHEADER)) == (UINT)-1)
+        return;
+
+    switch (rawInput.header.dwType) {
+        case RIM_TYPEKEYBOARD: {
+            RAWKEYBOARD const *kbPtr = &rawInput.data.keyboard;
+            USHORT             ntKey = kbPtr->VKey;
+
+            /* 0xFF is sent as part of escaped sequences (e.g., PAUSE); ignore it. */
+            if (ntKey == 0xFF)
+                return;
+            /*
+             * Raw input does not distinguish between left and right modifier keys by
+             * virtual key-code; do it using the scan-code and the extended-key flag.
+             */
+            switch (ntKey) {
+                case VK_SHIFT:   ntKey = (USHORT)MapVirtualKeyW(kbPtr->MakeCode, MAPVK_VSC_TO_VK_EX); break;
+                case VK_CONTROL: ntKey = kbPtr->Flags & RI_KEY_E0 ? VK_RCONTROL : VK_LCONTROL;         break;
+                case VK_MENU:    ntKey = kbPtr->Flags & RI_KEY_E0 ? VK_RMENU : VK_LMENU;               break;
+            }
+
+            NkKeyboardKey const keyCode = __NkInt_WindowsInput_MapFromNativeKey(self, (NkInt32)ntKey);
+            NkBoolean const     isDown  = !(kbPtr->Flags & RI_KEY_BREAK);
+            if (keyCode == NkKey_Unknown || !__NkInt_WindowsInput_UpdateKeyState(keyCode, isDown))
+                return;
+
+            NK_IGNORE_RETURN_VALUE(__NkInt_WindowsInput_PushRecord(&(NkInputRecord const){
+                .m_timestamp = currTime,
+                .m_recType   = isDown ? NkInRec_KeyDown : NkInRec_KeyUp,
+                .m_keyCode   = keyCode
+            }));
+            break;
+        }
+        case RIM_TYPEMOUSE: {
+            /**
+             * \brief maps raw input button transition flags to Noriko button records
+             */
+            NK_INTERNAL struct { USHORT m_ntFlag; NkMouseButton m_mouseBtn; NkInputRecordType m_recType; } const gl_c_BtnMapping[] = {
+                { RI_MOUSE_LEFT_BUTTON_DOWN,   NkBtn_LeftButton,   NkInRec_ButtonDown },
+                { RI_MOUSE_LEFT_BUTTON_UP,     NkBtn_LeftButton,   NkInRec_ButtonUp   },
+                { RI_MOUSE_RIGHT_BUTTON_DOWN,  NkBtn_RightButton,  NkInRec_ButtonDown },
+                { RI_MOUSE_RIGHT_BUTTON_UP,    NkBtn_RightButton,  NkInRec_ButtonUp   },
+                { RI_MOUSE_MIDDLE_BUTTON_DOWN, NkBtn_MiddleButton, NkInRec_ButtonDown },
+                { RI_MOUSE_MIDDLE_BUTTON_UP,   NkBtn_MiddleButton, NkInRec_ButtonUp   },
+                { RI_MOUSE_BUTTON_4_DOWN,      NkBtn_Button4,      NkInRec_ButtonDown },
+                { RI_MOUSE_BUTTON_4_UP,        NkBtn_Button4,      NkInRec_ButtonUp   },
+                { RI_MOUSE_BUTTON_5_DOWN,      NkBtn_Button5,      NkInRec_ButtonDown },
+                { RI_MOUSE_BUTTON_5_UP,        NkBtn_Button5,      NkInRec_ButtonUp   }
+            };
+            RAWMOUSE const *msPtr = &rawInput.data.mouse;
+
+            /* Record motion first so that clicks are applied at the new position. */
+            if (!(msPtr->usFlags & MOUSE_MOVE_ABSOLUTE) && (msPtr->lLastX != 0 || msPtr->lLastY != 0))
+                NK_IGNORE_RETURN_VALUE(__NkInt_WindowsInput_PushRecord(&(NkInputRecord const){
+                    .m_timestamp = currTime,
+                    .m_recType   = NkInRec_MouseMoved,
+                    .m_motDelta  = { (NkInt64)msPtr->lLastX, (NkInt64)msPtr->lLastY }
+                }));
+            for (NkSize i = 0; i < NK_ARRAYSIZE(gl_c_BtnMapping); i++)
+                if (msPtr->usButtonFlags & gl_c_BtnMapping[i].m_ntFlag)
+                    NK_IGNORE_RETURN_VALUE(__NkInt_WindowsInput_PushRecord(&(NkInputRecord const){
+                        .m_timestamp = currTime,
+                        .m_recType   = gl_c_BtnMapping[i].m_recType,
+                        .m_mouseBtn  = gl_c_BtnMapping[i].m_mouseBtn
+                    }));
+
+            break;
+        }
+    }
+}
+
+/**
+ */
+NK_INTERNAL NkSize NK_CALL __NkInt_WindowsInput_ReadBufferedInput(
+    _Inout_            NkIInput *self,
+    _In_               NkUint64 untilTime,
+    _O_array_(maxRecs) NkInputRecord *recArr,
+    _In_               NkSize maxRecs
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(recArr != NULL || maxRecs == 0, NkErr_OutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    LONG const writePos = InterlockedCompareExchange(&gl_InputBuf.m_writePos, 0, 0);
+    LONG       readPos  = gl_InputBuf.m_readPos;
+    NkSize     nRecs    = 0;
+    for (; nRecs < maxRecs && readPos != writePos; readPos++, nRecs++) {
+        NkInputRecord const *recPtr = &gl_InputBuf.m_recArr[readPos & (NK_INPUT_BUFFERSIZE - 1)];
+
+        /* Records are ordered by timestamp; everything after belongs to a later tick. */
+        if (recPtr->m_timestamp > untilTime)
+            break;
+
+        recArr[nRecs] = *recPtr;
+    }
+
+    /* Release the records that were read. */
+    InterlockedExchange(&gl_InputBuf.m_readPos, readPos);
+    return nRecs;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WindowsInput_InjectRecord(
+    _Inout_ NkIInput *self,
+    _In_    NkInputRecord const *recPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(recPtr != NULL, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    if (!gl_InputBuf.m_isEnabled)
+        return NkErr_NoOperation;
+
+    /* Keep the key state consistent with what was injected so that device input still works. */
+    if (recPtr->m_recType == NkInRec_KeyDown || recPtr->m_recType == NkInRec_KeyUp) {
+        if (!__NkInt_WindowsInput_UpdateKeyState(recPtr->m_keyCode, recPtr->m_recType == NkInRec_KeyDown))
+            return NkErr_Ok;
+    }
+
+    return __NkInt_WindowsInput_PushRecord(recPtr) ? NkErr_Ok : NkErr_CapLimitExceeded;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WindowsInput_SetRecordHook(
+    _Inout_     NkIInput *self,
+    _In_opt_    NkInputRecordHook fnHook,
+    _Inout_opt_ NkVoid *cxtPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* The hook is only ever invoked by the producer which runs on the calling thread. */
+    gl_InputBuf.mp_fnHook  = fnHook;
+    gl_InputBuf.mp_hookCxt = cxtPtr;
+}
+
 
 /**
  * \brief actual instance of the Win32 IAL 
@@ -428,7 +692,12 @@ NK_INTERNAL NkIInput const gl_Win32Ial = {
         .IsKeyPressed             = &__NkInt_WindowsInput_IsKeyPressed,
         .IsMouseButtonPressed     = &__NkInt_WindowsInput_IsMouseButtonPressed,
         .GetMousePosition         = &__NkInt_WindowsInput_GetMousePosition,
-        .GetModifierKeyStates     = &__NkInt_WindowsInput_GetModifierKeyStates
+        .GetModifierKeyStates     = &__NkInt_WindowsInput_GetModifierKeyStates,
+        .SetBufferedMode          = &__NkInt_WindowsInput_SetBufferedMode,
+        .OnNativeInput            = &__NkInt_WindowsInput_OnNativeInput,
+        .ReadBufferedInput        = &__NkInt_WindowsInput_ReadBufferedInput,
+        .InjectRecord             = &__NkInt_WindowsInput_InjectRecord,
+        .SetRecordHook            = &__NkInt_WindowsInput_SetRecordHook
     }
 };
 /** \endcond */
@@ -440,7 +709,9 @@ _Return_ok_ NkErrorCode NK_CALL __NkVirt_IAL_Startup(NkVoid) {
 }
 
 _Return_ok_ NkErrorCode NK_CALL __NkVirt_IAL_Shutdown(NkVoid) {
-    /* Stub. */
+    if (gl_InputBuf.m_nDropped > 0)
+        NK_LOG_WARNING("Dropped %li buffered input record(s) because the input buffer was full.", gl_InputBuf.m_nDropped);
+
     return NkErr_Ok;
 }
 
@@ -0,0 +1,36 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  winjob.c
+ * \brief implements platform-dependent functionality of the job system for the Windows
+ *        platform
+ */
+#define NK_NAMESPACE "nk::winjob"
+
+
+/* Noriko includes */
+#include <include/Noriko/job.h>
+#include <include/Noriko/platform.h>
+
+
+NkUint32 NK_CALL __NkVirt_JobSys_GetProcessorCount(NkVoid) {
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+
+    return sysInfo.dwNumberOfProcessors > 0 ? (NkUint32)sysInfo.dwNumberOfProcessors : 1U;
+}
+
+
+#undef NK_NAMESPACE
+
+
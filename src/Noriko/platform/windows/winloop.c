@@ -60,6 +60,116 @@ _Return_ok_ NkErrorCode NK_CALL __NkInt_Application_PlatformLoop(
 }
 
 
+
+/** \cond INTERNAL */
+/**
+ * \brief time that is spun instead of slept at the end of a wait, in seconds
+ *
+ * High-resolution waitable timers usually wake up within a few hundred microseconds of
+ * the due time; the spin tail absorbs this so that frame-time jitter stays well below a
+ * millisecond. Legacy waitable timers are bound to the system timer resolution.
+ */
+#define __NkInt_WinLoop_SpinTailHighRes ((NkDouble)0.0008)
+#define __NkInt_WinLoop_SpinTailLegacy  ((NkDouble)0.0160)
+
+/* Older SDKs do not define the flag for high-resolution timers. */
+#if (!defined CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+    #define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+/**
+ * \struct __NkInt_WinFrameTimer
+ * \brief  represents the frame timer on Windows
+ */
+NK_NATIVE typedef struct __NkInt_WinFrameTimer {
+    HANDLE   mp_timerHandle; /**< waitable timer */
+    NkUint64 m_spinTail;     /**< spin tail, in timer ticks */
+} __NkInt_WinFrameTimer;
+/** \endcond */
+
+
+NkVoid *NK_CALL __NkInt_Application_PlatformCreateFrameTimer(NkVoid) {
+    __NkInt_WinFrameTimer *frameTimer;
+    if (NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *frameTimer, 0, NK_FALSE, (NkVoid **)&frameTimer) != NkErr_Ok)
+        return NULL;
+
+    /* Prefer a high-resolution timer (Windows 10, version 1803 and later). */
+    NkDouble spinTail = __NkInt_WinLoop_SpinTailHighRes;
+    frameTimer->mp_timerHandle = CreateWaitableTimerExW(
+        NULL,
+        NULL,
+        CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+        TIMER_ALL_ACCESS
+    );
+    if (frameTimer->mp_timerHandle == NULL) {
+        frameTimer->mp_timerHandle = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+
+        spinTail = __NkInt_WinLoop_SpinTailLegacy;
+    }
+    if (frameTimer->mp_timerHandle == NULL) {
+        NK_LOG_WARNING("Could not create frame timer; frame limiter will spin.");
+
+        NkGPFree(frameTimer);
+        return NULL;
+    }
+
+    frameTimer->m_spinTail = (NkUint64)(spinTail * (NkDouble)NkTimerGetFrequency());
+    return (NkVoid *)frameTimer;
+}
+
+NkVoid NK_CALL __NkInt_Application_PlatformDestroyFrameTimer(_Inout_opt_ NkVoid *frameTimer) {
+    if (frameTimer == NULL)
+        return;
+
+    CloseHandle(((__NkInt_WinFrameTimer *)frameTimer)->mp_timerHandle);
+    NkGPFree(frameTimer);
+}
+
+NkVoid NK_CALL __NkInt_Application_PlatformWaitUntil(
+    _Inout_opt_ NkVoid *frameTimer,
+    _In_        NkUint64 targetTime,
+    _In_        NkBoolean isInterruptible
+) {
+    __NkInt_WinFrameTimer *actTimer = (__NkInt_WinFrameTimer *)frameTimer;
+
+    /*
+     * Sleep for the bulk of the time. Interruptible waits are only used while idling, so
+     * they do not need to be precise and are not followed by a spin tail.
+     */
+    NkUint64 const currTime = NkTimerGetCurrentTicks();
+    NkUint64 const spinTail = actTimer != NULL && !isInterruptible ? actTimer->m_spinTail : 0;
+    if (actTimer != NULL && targetTime > currTime + spinTail) {
+        /* Due times are given in 100 ns units; negative values are relative. */
+        NkUint64 const sleepTicks = targetTime - currTime - spinTail;
+        LARGE_INTEGER dueTime = {
+            .QuadPart = -(LONGLONG)((NkDouble)sleepTicks * 1e+7 / (NkDouble)NkTimerGetFrequency())
+        };
+
+        if (SetWaitableTimerEx(actTimer->mp_timerHandle, &dueTime, 0, NULL, NULL, NULL, 0)) {
+            DWORD const waitRes = MsgWaitForMultipleObjectsEx(
+                1,
+                &actTimer->mp_timerHandle,
+                INFINITE,
+                isInterruptible ? QS_ALLINPUT : 0,
+                MWMO_INPUTAVAILABLE
+            );
+
+            /* If messages arrived, let the main loop handle them right away. */
+            if (isInterruptible) {
+                if (waitRes == WAIT_OBJECT_0 + 1)
+                    CancelWaitableTimer(actTimer->mp_timerHandle);
+
+                return;
+            }
+        }
+    }
+
+    /* Spin for the rest of the time. */
+    while (NkTimerGetCurrentTicks() < targetTime)
+        YieldProcessor();
+}
+
+
 #undef NK_NAMESPACE
 
 
@@ -36,23 +36,28 @@
 NK_NATIVE typedef struct __NkInt_WindowsWindow {
     NKOM_IMPLEMENTS(NkIWindow);
 
-    HWND          mp_nativeHandle;   /**< native window handle */
-    POINT         m_lastMousePos;    /**< last mouse position */
-    NkWindowMode  m_allowedWndModes; /**< allowed window modes */
-    NkWindowMode  m_currWndMode;     /**< current window mode */
-    NkWindowFlags m_wndFlags;        /**< window flags */
-    NkStringView  m_wndTitle;        /**< default window title */
-    NkUuid        m_wndUuid;         /**< unique window identifier */
-    NkIRenderer  *mp_rendererRef;    /**< reference to the renderer for this window */
-    NkIInput     *mp_ialRef;         /**< reference to IAL */
+    HWND            mp_nativeHandle;   /**< native window handle */
+    POINT           m_lastMousePos;    /**< last mouse position */
+    NkWindowMode    m_allowedWndModes; /**< allowed window modes */
+    NkWindowMode    m_currWndMode;     /**< current window mode */
+    NkWindowFlags   m_wndFlags;        /**< window flags */
+    NkStringView    m_wndTitle;        /**< default window title */
+    NkUuid          m_wndUuid;         /**< unique window identifier */
+    NkIRenderer    *mp_rendererRef;    /**< reference to the renderer for this window */
+    NkIInput       *mp_ialRef;         /**< reference to IAL */
+    NkBoolean       m_isFullscreen;    /**< whether the window is a borderless window covering its monitor */
+    LONG_PTR        m_prevStyle;       /**< style of the window before it entered full-screen mode */
+    WINDOWPLACEMENT m_prevPlace;       /**< placement of the window before it entered full-screen mode */
 } __NkInt_WindowsWindow;
 
 
 /**
  */
-NK_INTERNAL NkWindowMode NK_CALL __NkInt_WindowsWindow_GetNewWindowMode(_In_ HWND wndHandle) {
-    if (IsZoomed(wndHandle)) return NkWndMode_Maximized;
-    if (IsIconic(wndHandle)) return NkWndMode_Minimized;
+NK_INTERNAL NkWindowMode NK_CALL __NkInt_WindowsWindow_GetNewWindowMode(_In_ __NkInt_WindowsWindow const *wndRef) {
+    /* Full-screen windows are restored into full-screen mode after being minimized. */
+    if (IsIconic(wndRef->mp_nativeHandle)) return NkWndMode_Minimized;
+    if (wndRef->m_isFullscreen)            return NkWndMode_Fullscreen;
+    if (IsZoomed(wndRef->mp_nativeHandle)) return NkWndMode_Maximized;
 
     return NkWndMode_Normal;
 }
@@ -78,6 +83,19 @@ NK_INTERNAL NkEventType NK_CALL __NkInt_WindowsWindow_MapFromNativeInputEvent(_I
     return NkEv_None;
 }
 
+/**
+ * \brief posts an input event to the event queue
+ * \param [in] evType numeric event type ID
+ * \param [in] evData pointer to the event data
+ * \note  Events go through the coalescing stage so that bursts of mouse-move messages
+ *        are merged. If the queue is full, the event is dispatched immediately instead,
+ *        so no input is lost. This is fine since the window procedure runs on the main
+ *        thread.
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WindowsWindow_PostInputEvent(_In_ NkEventType evType, _In_ NkVoid const *evData) {
+    NkEventPostCoalesced(evType, evData);
+}
+
 /**
  */
 NK_INTERNAL LRESULT CALLBACK __NkInt_WindowsWindow_WndProc(HWND wndHandle, UINT msgId, WPARAM wParam, LPARAM lParam) {
@@ -96,17 +114,16 @@ NK_INTERNAL LRESULT CALLBACK __NkInt_WindowsWindow_WndProc(HWND wndHandle, UINT
             ;
 
             /*
-             * Dispatch the event to the layer-stack. The return value is ignored since
-             * Windows mandates that the window procedure return 0 if one of the WM_KEY*
-             * messages was handled.
+             * Post the event to the event queue; it is dispatched to the layer-stack at the
+             * start of the next update. The return value is ignored since Windows mandates
+             * that the window procedure return 0 if one of the WM_KEY* messages was
+             * handled.
              */
-            NK_IGNORE_RETURN_VALUE(
-                NkEventDispatch(evType, &(NkKeyboardEvent const){
-                    .m_pKeyCode   = (NkInt32)(lParam & 0x00FF0000),
-                    .m_vNtKeyCode = (NkInt32)wParam,
-                    .m_vKeyCode   = wndRef->mp_ialRef->VT->MapFromNativeKey(wndRef->mp_ialRef, (int)wParam)
-                })
-            );
+            __NkInt_WindowsWindow_PostInputEvent(evType, &(NkKeyboardEvent const){
+                .m_pKeyCode   = (NkInt32)(lParam & 0x00FF0000),
+                .m_vNtKeyCode = (NkInt32)wParam,
+                .m_vKeyCode   = wndRef->mp_ialRef->VT->MapFromNativeKey(wndRef->mp_ialRef, (int)wParam)
+            });
             return 0;
         }
         case WM_LBUTTONDOWN:
@@ -124,14 +141,12 @@ NK_INTERNAL LRESULT CALLBACK __NkInt_WindowsWindow_WndProc(HWND wndHandle, UINT
             POINT glPos = { GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
             ClientToScreen(wndHandle, &glPos);
 
-            /* Dispatch event. */
-            NK_IGNORE_RETURN_VALUE(
-                NkEventDispatch(evType, &(NkMouseEvent const){
-                    .m_curPos   = (NkPoint2D){ (NkInt64)GET_X_LPARAM(lParam), (NkInt64)GET_Y_LPARAM(lParam) },
-                    .m_glCurPos = (NkPoint2D){ (NkInt64)glPos.x, (NkInt64)glPos.y },
-                    .m_mouseBtn = wndRef->mp_ialRef->VT->MapFromNativeMouseButton(wndRef->mp_ialRef, (int)ntBtn)
-                })
-            );
+            /* Post event. */
+            __NkInt_WindowsWindow_PostInputEvent(evType, &(NkMouseEvent const){
+                .m_curPos   = (NkPoint2D){ (NkInt64)GET_X_LPARAM(lParam), (NkInt64)GET_Y_LPARAM(lParam) },
+                .m_glCurPos = (NkPoint2D){ (NkInt64)glPos.x, (NkInt64)glPos.y },
+                .m_mouseBtn = wndRef->mp_ialRef->VT->MapFromNativeMouseButton(wndRef->mp_ialRef, (int)ntBtn)
+            });
             return 0;
         }
         case WM_MOUSEMOVE: {
@@ -145,20 +160,20 @@ NK_INTERNAL LRESULT CALLBACK __NkInt_WindowsWindow_WndProc(HWND wndHandle, UINT
             if (wndRef->m_lastMousePos.x == GET_X_LPARAM(lParam) && wndRef->m_lastMousePos.y == GET_Y_LPARAM(lParam))
                 return 0;
             /* Update the mouse position. */
+            POINT const prevPos = wndRef->m_lastMousePos;
             wndRef->m_lastMousePos = (POINT){ GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
 
             /* Determine global mouse position. */
             POINT glPos = { GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
             ClientToScreen(wndHandle, &glPos);
 
-            /* Dispatch event. */
-            NK_IGNORE_RETURN_VALUE(
-                NkEventDispatch(NkEv_MouseMoved, &(NkMouseEvent const){
-                    .m_curPos   = (NkPoint2D){ (NkInt64)GET_X_LPARAM(lParam), (NkInt64)GET_Y_LPARAM(lParam) },
-                    .m_glCurPos = (NkPoint2D){ (NkInt64)glPos.x, (NkInt64)glPos.y },
-                    .m_mouseBtn = NkBtn_Unknown
-                })
-            );
+            /* Post event. */
+            __NkInt_WindowsWindow_PostInputEvent(NkEv_MouseMoved, &(NkMouseEvent const){
+                .m_curPos   = (NkPoint2D){ (NkInt64)GET_X_LPARAM(lParam), (NkInt64)GET_Y_LPARAM(lParam) },
+                .m_glCurPos = (NkPoint2D){ (NkInt64)glPos.x, (NkInt64)glPos.y },
+                .m_curDelta = (NkPoint2D){ (NkInt64)(GET_X_LPARAM(lParam) - prevPos.x), (NkInt64)(GET_Y_LPARAM(lParam) - prevPos.y) },
+                .m_mouseBtn = NkBtn_Unknown
+            });
             return 0;
         }
         case WM_MOUSEWHEEL: {
@@ -174,16 +189,24 @@ NK_INTERNAL LRESULT CALLBACK __NkInt_WindowsWindow_WndProc(HWND wndHandle, UINT
             POINT glPos = { GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
             ClientToScreen(wndHandle, &glPos);
 
-            /* Dispatch the event. */
-            NK_IGNORE_RETURN_VALUE(
-                NkEventDispatch(evType, &(NkMouseEvent const){
-                    .m_curPos   = (NkPoint2D){ (NkInt64)GET_X_LPARAM(lParam), (NkInt64)GET_Y_LPARAM(lParam) },
-                    .m_glCurPos = (NkPoint2D){ (NkInt64)glPos.x, (NkInt64)glPos.y },
-                    .m_mouseBtn = NkBtn_Unknown
-                })
-            );
+            /* Post the event. */
+            __NkInt_WindowsWindow_PostInputEvent(evType, &(NkMouseEvent const){
+                .m_curPos   = (NkPoint2D){ (NkInt64)GET_X_LPARAM(lParam), (NkInt64)GET_Y_LPARAM(lParam) },
+                .m_glCurPos = (NkPoint2D){ (NkInt64)glPos.x, (NkInt64)glPos.y },
+                .m_mouseBtn = NkBtn_Unknown
+            });
             return 0;
         };
+        case WM_INPUT:
+            /*
+             * Raw input is only received while the IAL is in buffered mode. Let the IAL
+             * record it; the message must still be passed to the default window procedure
+             * so that the system can clean up.
+             */
+            if (wndRef != NULL && GET_RAWINPUT_CODE_WPARAM(wParam) == RIM_INPUT)
+                wndRef->mp_ialRef->VT->OnNativeInput(wndRef->mp_ialRef, (NkVoid *)lParam);
+
+            break;
         case WM_INITMENU:
         case WM_INITMENUPOPUP: {
             /*
@@ -206,16 +229,27 @@ NK_INTERNAL LRESULT CALLBACK __NkInt_WindowsWindow_WndProc(HWND wndHandle, UINT
 
             break;
         case WM_SIZE:
-            /* Window size has changed; do nothing but resize the renderer. */
-            if (wndRef != NULL && wndRef->mp_rendererRef != NULL)
-                wndRef->mp_rendererRef->VT->Resize(
-                    wndRef->mp_rendererRef,
-                    wndRef->NkIWindow_Iface.VT->GetClientDimensions((NkIWindow *)wndRef)
-                );
+            /*
+             * Window size has changed; resize the renderer and let the layers know. During
+             * a drag-resize, many WM_SIZE messages arrive per frame; the resize events are
+             * coalesced and renderers are expected to defer expensive work to the next
+             * frame.
+             */
+            if (wndRef != NULL && wndRef->mp_rendererRef != NULL) {
+                NkSize2D const clDim = wndRef->NkIWindow_Iface.VT->GetClientDimensions((NkIWindow *)wndRef);
+
+                NK_IGNORE_RETURN_VALUE(wndRef->mp_rendererRef->VT->Resize(wndRef->mp_rendererRef, clDim));
+                NkEventPostCoalesced(NkEv_WindowResized, &(NkWindowEvent const){
+                    .mp_wndRef = (NkIWindow *)wndRef,
+                    .m_wndSize = clDim,
+                    .m_wndMode = wndRef->m_currWndMode
+                });
+            }
+            NkApplicationRequestRedraw();
 
             break;
         case WM_WINDOWPOSCHANGED: {
-            NkWindowMode const newWndMode = __NkInt_WindowsWindow_GetNewWindowMode(wndHandle);
+            NkWindowMode const newWndMode = __NkInt_WindowsWindow_GetNewWindowMode(wndRef);
 
             /* If the window mode has changed, update it. */
             if (wndRef->m_currWndMode ^ newWndMode)
@@ -256,9 +290,13 @@ NK_INTERNAL LRESULT CALLBACK __NkInt_WindowsWindow_WndProc(HWND wndHandle, UINT
             /*
              * We paint manually in the main loop, so we ignore all WM_PAINT messages. We
              * need to validate the update region or else the system keeps sending
-             * WM_PAINT messages until it's painted.
+             * WM_PAINT messages until it's painted. As the window contents are gone,
+             * the renderer must present the whole back buffer, not just what changed.
              */
             ValidateRect(wndHandle, NULL);
+            if (wndRef != NULL && wndRef->mp_rendererRef != NULL)
+                wndRef->mp_rendererRef->VT->InvalidateFrame(wndRef->mp_rendererRef);
+            NkApplicationRequestRedraw();
 
             return 0;
         case WM_CLOSE:
@@ -315,15 +353,75 @@ NK_INTERNAL NK_INLINE DWORD NK_CALL __NkInt_WindowsWindow_MapFromWindowModes(
 NK_INTERNAL NK_INLINE int NK_CALL __NkInt_WindowsWindow_TranslateWindowModeToShowCommand(_In_ NkWindowMode wndMode) {
     switch (wndMode) {
         case NkWndMode_Hidden:     return SW_HIDE;
-        case NkWndMode_Fullscreen: 
         case NkWndMode_Maximized:  return SW_SHOWMAXIMIZED;
         case NkWndMode_Minimized:  return SW_SHOWMINIMIZED;
+        case NkWndMode_Fullscreen: 
         case NkWndMode_Normal:     return SW_SHOWNORMAL;
     }
 
     return INT_MAX;
 }
 
+/**
+ * \brief turns the window into a borderless window covering the monitor it is on
+ * \param [in, out] wndRef pointer to the window
+ *
+ * \par Remarks
+ *   The display mode is not changed. A window that covers the whole monitor and presents
+ *   through a flip-model swap chain is scanned out directly, which is as fast as
+ *   exclusive full-screen mode. Unlike exclusive mode, switching is instant and tearing
+ *   can still be allowed. Renderers that present using GDI are still composited.
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WindowsWindow_EnterFullscreen(_Inout_ __NkInt_WindowsWindow *wndRef) {
+    HWND const wndHandle = wndRef->mp_nativeHandle;
+
+    /* Remember where the window was so that leaving full-screen mode can restore it. */
+    if (!wndRef->m_isFullscreen) {
+        wndRef->m_prevStyle = GetWindowLongPtr(wndHandle, GWL_STYLE);
+        wndRef->m_prevPlace = (WINDOWPLACEMENT){ .length = sizeof(WINDOWPLACEMENT) };
+        GetWindowPlacement(wndHandle, &wndRef->m_prevPlace);
+
+        wndRef->m_isFullscreen = NK_TRUE;
+        SetWindowLongPtr(wndHandle, GWL_STYLE, wndRef->m_prevStyle & ~WS_OVERLAPPEDWINDOW | WS_POPUP);
+    }
+    /* A maximized window would be restored into its maximized size later on. */
+    if (IsZoomed(wndHandle) || IsIconic(wndHandle))
+        ShowWindow(wndHandle, SW_RESTORE);
+
+    MONITORINFO monInfo = { .cbSize = sizeof(MONITORINFO) };
+    GetMonitorInfo(MonitorFromWindow(wndHandle, MONITOR_DEFAULTTONEAREST), &monInfo);
+    SetWindowPos(
+        wndHandle,
+        HWND_TOP,
+        monInfo.rcMonitor.left,
+        monInfo.rcMonitor.top,
+        monInfo.rcMonitor.right - monInfo.rcMonitor.left,
+        monInfo.rcMonitor.bottom - monInfo.rcMonitor.top,
+        SWP_NOOWNERZORDER | SWP_FRAMECHANGED | SWP_SHOWWINDOW
+    );
+}
+
+/**
+ * \brief restores the style and placement the window had before it entered full-screen
+ *        mode
+ * \param [in, out] wndRef pointer to the window
+ * \param [in] showCmd show command the window is restored with
+ * \note  Does nothing if the window is not in full-screen mode.
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WindowsWindow_LeaveFullscreen(_Inout_ __NkInt_WindowsWindow *wndRef, _In_ int showCmd) {
+    if (!wndRef->m_isFullscreen)
+        return;
+    HWND const wndHandle = wndRef->mp_nativeHandle;
+
+    wndRef->m_isFullscreen = NK_FALSE;
+    SetWindowLongPtr(wndHandle, GWL_STYLE, wndRef->m_prevStyle);
+    SetWindowPos(wndHandle, NULL, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
+
+    /* Restore directly into the requested mode so that no intermediate mode is reported. */
+    wndRef->m_prevPlace.showCmd = (UINT)showCmd;
+    SetWindowPlacement(wndHandle, &wndRef->m_prevPlace);
+}
+
 /**
  */
 NK_INTERNAL NK_INLINE NkSize2D NK_CALL __NkInt_WindowsWindow_AdjustViewportExtents(
@@ -366,7 +464,8 @@ NK_INTERNAL NK_INLINE NkSize2D NK_CALL __NkInt_WindowsWindow_GetWindowSize(
 NK_INTERNAL NK_INLINE NkBoolean NK_CALL __NkInt_WindowsWindow_IsWindowFlagMutable(_In_ NkWindowFlags const wndFlag) {
     switch (wndFlag) {
         case NkWndFlag_MessageOnlyWnd:
-        case NkWndFlag_MainWindow:     return NK_FALSE;
+        case NkWndFlag_MainWindow:
+        case NkWndFlag_RenderThread:   return NK_FALSE;
         case NkWndFlag_AlwaysOnTop:
         case NkWndFlag_DragMovable:
         case NkWndFlag_DragResizable:  return NK_TRUE;
@@ -541,17 +640,30 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WindowsWindow_Initialize(
             .m_dispTileSize = wndSpecs->m_dispTileSize,
             .m_vpAlignment  = wndSpecs->m_vpAlignment,
             .m_clearCol     = NK_MAKE_RGB(0, 0, 0),
-            .m_texInterMode = NkTexIMd_NearestNeighbor
+            .m_texInterMode = NkTexIMd_NearestNeighbor,
+            .m_isMipmapped  = (wndSpecs->m_wndFlags & NkWndFlag_Mipmaps) != 0
         }, (NkIBase **)&wndPtr->mp_rendererRef);
         if (errCode != NkErr_Ok) {
             /** \todo change to release() and destroy window */
 
             return errCode;
         }
+        /* If requested, present frames on a render thread instead of the window's thread. */
+        if (wndSpecs->m_wndFlags & NkWndFlag_RenderThread) {
+            NkIRenderer *realRd = wndPtr->mp_rendererRef;
+
+            errCode = NkRendererCreateThreadProxy(realRd, &wndPtr->mp_rendererRef);
+            realRd->VT->Release(realRd);
+            if (errCode != NkErr_Ok) {
+                /** \todo change to release() and destroy window */
+
+                return errCode;
+            }
+        }
 
         /* Set properties. */
         NkUuidCopy(&wndSpecs->m_wndUuid, &wndPtr->m_wndUuid);
-        wndPtr->m_allowedWndModes = wndSpecs->m_allowedWndModes & (NkWndMode_All & ~NkWndMode_Fullscreen);
+        wndPtr->m_allowedWndModes = wndSpecs->m_allowedWndModes & NkWndMode_All;
         wndPtr->m_wndFlags        = wndSpecs->m_wndFlags;
         wndPtr->mp_ialRef         = (NkIInput *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIInput));
         wndPtr->m_lastMousePos    = (POINT){ 0, 0 };
@@ -633,8 +745,16 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WindowsWindow_SetWindowMode(
         /* Update the internal flag. */
         wndRef->m_currWndMode = newMode;
 
-        /* Do the native window mode changing. */
-        ShowWindow(wndRef->mp_nativeHandle, newShowCmd);
+        /*
+         * Do the native window mode changing. Minimizing or hiding a full-screen window
+         * keeps it in full-screen mode.
+         */
+        if (newMode == NkWndMode_Normal || newMode == NkWndMode_Maximized)
+            __NkInt_WindowsWindow_LeaveFullscreen(wndRef, newShowCmd);
+        if (newMode == NkWndMode_Fullscreen)
+            __NkInt_WindowsWindow_EnterFullscreen(wndRef);
+        else
+            ShowWindow(wndRef->mp_nativeHandle, newShowCmd);
 
         /* Lastly, dispatch an event to let the layers know. */
         return NkEventDispatch(NkWindowMapEventTypeFromWindowMode(newMode), &(NkWindowEvent){
@@ -0,0 +1,917 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  profiler.c
+ * \brief implements Noriko's built-in hierarchical CPU profiler
+ */
+#define NK_NAMESPACE "nk::profiler"
+
+
+/* stdlib includes */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/profiler.h>
+#include <include/Noriko/platform.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/timer.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/comp.h>
+#include <include/Noriko/io.h>
+#include <include/Noriko/noriko.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \def   NK_PROFILE_RINGSIZE
+ * \brief number of records the ring buffer of a thread can hold; must be a power of two
+ * \note  Records that do not fit because the main thread did not collect them in time are
+ *        dropped.
+ */
+#define NK_PROFILE_RINGSIZE   ((NkUint32)(1 << 12))
+static_assert((NK_PROFILE_RINGSIZE & (NK_PROFILE_RINGSIZE - 1)) == 0, "Profiler ring size must be a power of two.");
+/**
+ * \def   NK_PROFILE_MAXTHREADS
+ * \brief maximum number of threads that can record zones
+ */
+#define NK_PROFILE_MAXTHREADS ((NkUint32)(64))
+/**
+ * \def   NK_PROFILE_HASHSIZE
+ * \brief number of slots in the zone lookup table; must be a power of two
+ */
+#define NK_PROFILE_HASHSIZE   ((NkUint32)(NK_PROFILE_MAXZONES * 2))
+/**
+ * \def   NK_PROFILE_NOZONE
+ * \brief index representing "no zone" (i.e., the root, or a zone that is not recorded)
+ */
+#define NK_PROFILE_NOZONE     UINT32_MAX
+/**
+ * \def   NK_PROFILE_MAXPATH
+ * \brief maximum length of the path of a capture file, in bytes, including the
+ *        <tt>NUL</tt>-terminator
+ */
+#define NK_PROFILE_MAXPATH    ((NkSize)(260))
+/**
+ * \def   NK_PROFILE_CAPGROW
+ * \brief number of capture events the capture buffer grows by
+ */
+#define NK_PROFILE_CAPGROW    ((NkSize)(1 << 14))
+
+
+/**
+ * \enum  __NkInt_ProfileEventType
+ * \brief types of recorded events
+ */
+NK_NATIVE typedef enum __NkInt_ProfileEventType {
+    __NkInt_ProfEv_Zone,    /**< zone that was left */
+    __NkInt_ProfEv_Instant, /**< instant event */
+    __NkInt_ProfEv_Frame,   /**< frame boundary (capture only) */
+    __NkInt_ProfEv_Counter  /**< allocation counter sample (capture only) */
+} __NkInt_ProfileEventType;
+
+/**
+ * \struct __NkInt_ProfileRecord
+ * \brief  represents a single zone that was left, or an instant event
+ */
+NK_NATIVE typedef struct __NkInt_ProfileRecord {
+    NkUint32    m_recType;    /**< type of the record (zone or instant) */
+    NkUint32    m_zoneInd;    /**< index of the zone (zones only) */
+    char const *mp_instName;  /**< name of the event (instant events only) */
+    NkUint64    m_startTime;  /**< time the zone was entered, in fast ticks */
+    NkUint64    m_endTime;    /**< time the zone was left, in fast ticks */
+} __NkInt_ProfileRecord;
+
+/**
+ * \struct __NkInt_ProfileCaptureEvent
+ * \brief  represents a single event of a capture
+ */
+NK_NATIVE typedef struct __NkInt_ProfileCaptureEvent {
+    NkUint32    m_evType;    /**< type of the event */
+    NkUint32    m_thrdInd;   /**< index of the recording thread */
+    char const *mp_evName;   /**< name of the event */
+    NkUint64    m_evTime;    /**< time the event occurred, in fast ticks */
+    NkUint64    m_evDur;     /**< duration of the event, in fast ticks (zones only) */
+    NkUint64    m_evArgs[2]; /**< number of allocations and bytes (counters only) */
+} __NkInt_ProfileCaptureEvent;
+
+/**
+ * \struct __NkInt_ProfileThread
+ * \brief  represents the recording state of a single thread
+ * \note   The ring buffer has exactly one producer (the owning thread) and one consumer
+ *         (the main thread in <tt>NkProfileMarkFrame()</tt>).
+ */
+NK_NATIVE typedef struct __NkInt_ProfileThread {
+    alignas(64) LONG volatile m_writePos;                          /**< next record to be written */
+    alignas(64) LONG volatile m_readPos;                           /**< next record to be collected */
+    LONG64 volatile           m_nAllocs;                           /**< allocations made during captures */
+    LONG64 volatile           m_nAllocBytes;                       /**< bytes allocated during captures */
+    NkUint32                  m_stackDepth;                        /**< current nesting depth */
+    NkUint32                  m_zoneStack[NK_PROFILE_MAXDEPTH];    /**< zones that are currently entered */
+    NkUint64                  m_startStack[NK_PROFILE_MAXDEPTH];   /**< times the zones were entered */
+    __NkInt_ProfileRecord     m_recArr[NK_PROFILE_RINGSIZE];       /**< record storage */
+} __NkInt_ProfileThread;
+
+/**
+ * \struct __NkInt_ProfileZone
+ * \brief  represents a node in the zone tree
+ * \note   The identity of a zone (name and parent) is written before the zone is
+ *         published in the lookup table and never changes; the statistics are only
+ *         accessed by the main thread.
+ */
+NK_NATIVE typedef struct __NkInt_ProfileZone {
+    char const *mp_zoneName; /**< name of the zone */
+    NkUint32    m_nameHash;  /**< hash of the name */
+    NkUint32    m_parentInd; /**< index of the parent zone, or \c NK_PROFILE_NOZONE */
+    NkUint32    m_zoneDepth; /**< nesting depth */
+
+    NkUint32    m_nCurrCalls; /**< number of calls in the current frame */
+    NkUint32    m_nLastCalls; /**< number of calls in the last frame */
+    NkUint64    m_currTicks;  /**< ticks spent in the current frame */
+    NkUint64    m_lastTicks;  /**< ticks spent in the last frame */
+    NkUint64    m_minTicks;   /**< minimum ticks spent per frame */
+    NkUint64    m_maxTicks;   /**< maximum ticks spent per frame */
+    NkUint64    m_sumTicks;   /**< ticks spent over all frames */
+    NkUint64    m_nFrames;    /**< number of frames the zone was entered in */
+} __NkInt_ProfileZone;
+
+/**
+ * \struct __NkInt_ProfileContext
+ * \brief  represents the global state of the profiler
+ */
+NK_NATIVE typedef struct __NkInt_ProfileContext {
+    NK_DECL_LOCK(m_mtxLock);                                  /**< guards creation of zones and threads */
+
+    NkBoolean volatile     m_isInit;                          /**< whether the profiler is running */
+    LONG volatile          m_nZones;                          /**< number of zones */
+    LONG volatile          m_nThreads;                        /**< number of registered threads */
+    LONG volatile          m_nDropped;                        /**< number of records dropped */
+    LONG volatile          m_zoneTable[NK_PROFILE_HASHSIZE];  /**< lookup table (zone index + 1, or 0) */
+    __NkInt_ProfileThread *mp_thrdArr[NK_PROFILE_MAXTHREADS]; /**< registered threads */
+    __NkInt_ProfileZone    m_zoneArr[NK_PROFILE_MAXZONES];    /**< zone tree */
+
+    /* capture state; only accessed by the main thread, except for 'm_isCapture' */
+    NkBoolean volatile           m_isCapture;                  /**< whether a capture is running */
+    NkUint32                     m_nCapPending;                /**< frames to capture once the next frame begins */
+    NkUint32                     m_nCapFrames;                 /**< frames left to capture */
+    NkUint64                     m_capStart;                   /**< time the capture began, in fast ticks */
+    NkUint64                     m_capFrameStart;              /**< time the current frame began, in fast ticks */
+    NkUint64                     m_capAllocs[2];               /**< allocations and bytes at the beginning of the frame */
+    __NkInt_ProfileCaptureEvent *mp_capArr;                    /**< captured events */
+    NkSize                       m_capSize;                    /**< number of captured events */
+    NkSize                       m_capCap;                     /**< capacity of the capture buffer */
+    NkBoolean                    m_isCapTrunc;                 /**< whether events were lost because the buffer could not grow */
+    char                         m_capPath[NK_PROFILE_MAXPATH];/**< path of the capture file */
+} __NkInt_ProfileContext;
+
+/**
+ * \brief global profiler instance
+ */
+NK_INTERNAL __NkInt_ProfileContext gl_ProfCxt;
+/**
+ * \brief recording state of the current thread, or \c NULL if the thread has not entered
+ *        a zone yet
+ */
+NK_INTERNAL NK_THREADLOCAL __NkInt_ProfileThread *gl_ProfThread = NULL;
+
+
+/**
+ * \brief  calculates the hash of a zone identity
+ * \param  [in] zoneName name of the zone
+ * \param  [in] parentInd index of the parent zone
+ * \return hash value
+ */
+NK_INTERNAL NkUint32 __NkInt_ProfileHashZone(_In_z_ char const *zoneName, _In_ NkUint32 parentInd) {
+    /* FNV-1a over the name, mixed with the parent. */
+    NkUint32 hashVal = 2166136261u;
+    for (; *zoneName != '\0'; zoneName++)
+        hashVal = (hashVal ^ (NkUint8)*zoneName) * 16777619u;
+
+    return hashVal ^ (parentInd * 0x9E3779B9u);
+}
+
+/**
+ * \brief  looks up the slot of the given zone in the lookup table
+ * \param  [in] zoneName name of the zone
+ * \param  [in] nameHash hash of the zone identity
+ * \param  [in] parentInd index of the parent zone
+ * \param  [out] slotInd variable that receives the slot index
+ * \return index of the zone, or \c NK_PROFILE_NOZONE if it does not exist yet, in which
+ *         case \c slotInd receives the first free slot
+ */
+NK_INTERNAL NkUint32 __NkInt_ProfileFindZone(
+    _In_z_ char const *zoneName,
+    _In_   NkUint32 nameHash,
+    _In_   NkUint32 parentInd,
+    _Out_  NkUint32 *slotInd
+) {
+    for (NkUint32 i = 0; i < NK_PROFILE_HASHSIZE; i++) {
+        *slotInd = (nameHash + i) & (NK_PROFILE_HASHSIZE - 1);
+
+        LONG const tblVal = InterlockedCompareExchange(&gl_ProfCxt.m_zoneTable[*slotInd], 0, 0);
+        if (tblVal == 0)
+            return NK_PROFILE_NOZONE;
+
+        __NkInt_ProfileZone const *zonePtr = &gl_ProfCxt.m_zoneArr[tblVal - 1];
+        if (zonePtr->m_nameHash == nameHash
+            && zonePtr->m_parentInd == parentInd
+            && (zonePtr->mp_zoneName == zoneName || strcmp(zonePtr->mp_zoneName, zoneName) == 0)
+        ) return (NkUint32)(tblVal - 1);
+    }
+
+    *slotInd = NK_PROFILE_NOZONE;
+    return NK_PROFILE_NOZONE;
+}
+
+/**
+ * \brief  retrieves the zone with the given name and parent, creating it if necessary
+ * \param  [in] zoneName name of the zone
+ * \param  [in] parentInd index of the parent zone
+ * \param  [in] zoneDepth nesting depth of the zone
+ * \return index of the zone, or \c NK_PROFILE_NOZONE if the zone limit was reached
+ */
+NK_INTERNAL NkUint32 __NkInt_ProfileGetZone(
+    _In_z_ char const *zoneName,
+    _In_   NkUint32 parentInd,
+    _In_   NkUint32 zoneDepth
+) {
+    NkUint32 const nameHash = __NkInt_ProfileHashZone(zoneName, parentInd);
+    NkUint32       slotInd;
+
+    /* Fast path: the zone exists already. This needs no lock. */
+    NkUint32 zoneInd = __NkInt_ProfileFindZone(zoneName, nameHash, parentInd, &slotInd);
+    if (zoneInd != NK_PROFILE_NOZONE)
+        return zoneInd;
+
+    /* Create the zone, unless another thread did so in the meantime. */
+    NK_LOCK(gl_ProfCxt.m_mtxLock);
+    zoneInd = __NkInt_ProfileFindZone(zoneName, nameHash, parentInd, &slotInd);
+    if (zoneInd == NK_PROFILE_NOZONE && slotInd != NK_PROFILE_NOZONE && gl_ProfCxt.m_nZones < (LONG)NK_PROFILE_MAXZONES) {
+        zoneInd = (NkUint32)gl_ProfCxt.m_nZones;
+
+        gl_ProfCxt.m_zoneArr[zoneInd] = (__NkInt_ProfileZone){
+            .mp_zoneName = zoneName,
+            .m_nameHash  = nameHash,
+            .m_parentInd = parentInd,
+            .m_zoneDepth = zoneDepth,
+            .m_minTicks  = UINT64_MAX
+        };
+        /* Publish the zone. */
+        NK_IGNORE_RETURN_VALUE(InterlockedExchange(&gl_ProfCxt.m_zoneTable[slotInd], (LONG)zoneInd + 1));
+        NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&gl_ProfCxt.m_nZones));
+    }
+    NK_UNLOCK(gl_ProfCxt.m_mtxLock);
+
+    return zoneInd;
+}
+
+/**
+ * \brief  creates the recording state for the calling thread
+ * \return pointer to the recording state, or \c NULL if the thread cannot record
+ */
+NK_INTERNAL __NkInt_ProfileThread *__NkInt_ProfileRegisterThread(NkVoid) {
+    __NkInt_ProfileThread *thrdPtr = NULL;
+
+    NK_LOCK(gl_ProfCxt.m_mtxLock);
+    if (gl_ProfCxt.m_nThreads < (LONG)NK_PROFILE_MAXTHREADS) {
+        NkErrorCode const errCode = NkGPAlloc(
+            NK_MAKE_ALLOCATION_CONTEXT(),
+            sizeof *thrdPtr,
+            0,
+            NK_TRUE,
+            (NkVoid **)&thrdPtr
+        );
+
+        if (errCode == NkErr_Ok) {
+            gl_ProfCxt.mp_thrdArr[gl_ProfCxt.m_nThreads] = thrdPtr;
+
+            NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&gl_ProfCxt.m_nThreads));
+        }
+    }
+    NK_UNLOCK(gl_ProfCxt.m_mtxLock);
+
+    return gl_ProfThread = thrdPtr;
+}
+
+/**
+ * \brief appends a record to the ring buffer of the given thread
+ * \param [in, out] thrdPtr recording state of the calling thread
+ * \param [in] recPtr record that is to be appended
+ * \note  If the main thread has not collected the buffer in time, the record is dropped.
+ */
+NK_INTERNAL NkVoid __NkInt_ProfilePushRecord(_Inout_ __NkInt_ProfileThread *thrdPtr, _In_ __NkInt_ProfileRecord const *recPtr) {
+    LONG const writePos = thrdPtr->m_writePos;
+    if ((NkUint32)(writePos - thrdPtr->m_readPos) >= NK_PROFILE_RINGSIZE) {
+        NK_IGNORE_RETURN_VALUE(InterlockedIncrement(&gl_ProfCxt.m_nDropped));
+
+        return;
+    }
+
+    thrdPtr->m_recArr[(NkUint32)writePos & (NK_PROFILE_RINGSIZE - 1)] = *recPtr;
+    NK_IGNORE_RETURN_VALUE(InterlockedExchange(&thrdPtr->m_writePos, writePos + 1));
+}
+
+/**
+ * \brief  converts fast ticks to milliseconds
+ * \param  [in] nTicks number of ticks
+ * \return milliseconds
+ */
+NK_INTERNAL NK_INLINE NkDouble __NkInt_ProfileTicksToMs(_In_ NkUint64 nTicks) {
+    return (NkDouble)nTicks * 1000.0 / (NkDouble)NkTimerGetFastFrequency();
+}
+
+/**
+ * \brief appends an event to the capture buffer, growing it if necessary
+ * \param [in] evPtr event that is to be appended
+ * \note  If the buffer cannot grow, the event is dropped and the capture is marked as
+ *        truncated.
+ */
+NK_INTERNAL NkVoid __NkInt_ProfileAppendCapture(_In_ __NkInt_ProfileCaptureEvent const *evPtr) {
+    if (gl_ProfCxt.m_capSize == gl_ProfCxt.m_capCap) {
+        NkSize const newCap = gl_ProfCxt.m_capCap + NK_PROFILE_CAPGROW;
+
+        NkErrorCode const errCode = gl_ProfCxt.mp_capArr == NULL
+            ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *gl_ProfCxt.mp_capArr, 0, NK_FALSE, (NkVoid **)&gl_ProfCxt.mp_capArr)
+            : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *gl_ProfCxt.mp_capArr, (NkVoid **)&gl_ProfCxt.mp_capArr)
+        ;
+        if (errCode != NkErr_Ok) {
+            gl_ProfCxt.m_isCapTrunc = NK_TRUE;
+
+            return;
+        }
+        gl_ProfCxt.m_capCap = newCap;
+
+        /* Do not count the capture buffer itself as an allocation of the frame. */
+        if (gl_ProfThread != NULL) {
+            ++gl_ProfCxt.m_capAllocs[0];
+            gl_ProfCxt.m_capAllocs[1] += newCap * sizeof *gl_ProfCxt.mp_capArr;
+        }
+    }
+
+    gl_ProfCxt.mp_capArr[gl_ProfCxt.m_capSize++] = *evPtr;
+}
+
+/**
+ * \brief  sums up the allocation counters of all threads
+ * \param  [out] resArr array that receives the number of allocations and bytes
+ */
+NK_INTERNAL NkVoid __NkInt_ProfileSumAllocations(_O_array_(2) NkUint64 *resArr) {
+    resArr[0] = resArr[1] = 0;
+
+    LONG const nThreads = InterlockedCompareExchange(&gl_ProfCxt.m_nThreads, 0, 0);
+    for (LONG i = 0; i < nThreads; i++) {
+        resArr[0] += (NkUint64)InterlockedCompareExchange64(&gl_ProfCxt.mp_thrdArr[i]->m_nAllocs, 0, 0);
+        resArr[1] += (NkUint64)InterlockedCompareExchange64(&gl_ProfCxt.mp_thrdArr[i]->m_nAllocBytes, 0, 0);
+    }
+}
+
+
+/**
+ * \struct __NkInt_ProfileWriter
+ * \brief  buffers the output of the capture writer
+ */
+NK_NATIVE typedef struct __NkInt_ProfileWriter {
+    NkIFile     *mp_fileObj;    /**< file the capture is written to */
+    NkErrorCode  m_errCode;     /**< first error that occurred while writing */
+    NkSize       m_bufOff;      /**< number of bytes in the buffer */
+    NkBoolean    m_isFirst;     /**< whether no event has been written yet */
+    char         m_bufArr[8192]; /**< write buffer */
+} __NkInt_ProfileWriter;
+
+/**
+ * \brief writes the contents of the buffer to the file
+ * \param [in, out] wrPtr pointer to the writer
+ */
+NK_INTERNAL NkVoid __NkInt_ProfileWriterFlush(_Inout_ __NkInt_ProfileWriter *wrPtr) {
+    if (wrPtr->m_errCode == NkErr_Ok && wrPtr->m_bufOff > 0) {
+        NkSize nWritten;
+
+        wrPtr->m_errCode = wrPtr->mp_fileObj->VT->Write(wrPtr->mp_fileObj, wrPtr->m_bufOff, wrPtr->m_bufArr, &nWritten);
+        if (wrPtr->m_errCode == NkErr_Ok && nWritten != wrPtr->m_bufOff)
+            wrPtr->m_errCode = NkErr_ErrorDuringDiskIO;
+    }
+
+    wrPtr->m_bufOff = 0;
+}
+
+/**
+ * \brief writes formatted text to the given writer
+ * \param [in, out] wrPtr pointer to the writer
+ * \param [in] fmtStr format string
+ * \param [in] ... format arguments
+ * \note  The formatted text must not exceed the size of the buffer.
+ */
+NK_INTERNAL NkVoid __NkInt_ProfileWriterPrint(_Inout_ __NkInt_ProfileWriter *wrPtr, _Printf_format_string_ char const *fmtStr, ...) {
+    for (NkUint32 i = 0; i < 2; i++) {
+        NkSize const bufLeft = sizeof wrPtr->m_bufArr - wrPtr->m_bufOff;
+
+        va_list vlArgs;
+        va_start(vlArgs, fmtStr);
+        int const nChars = vsnprintf(wrPtr->m_bufArr + wrPtr->m_bufOff, bufLeft, fmtStr, vlArgs);
+        va_end(vlArgs);
+
+        if (nChars >= 0 && (NkSize)nChars < bufLeft) {
+            wrPtr->m_bufOff += (NkSize)nChars;
+
+            return;
+        }
+        /* Text did not fit; flush and try again. */
+        __NkInt_ProfileWriterFlush(wrPtr);
+    }
+}
+
+/**
+ * \brief writes the given string as a JSON string literal
+ * \param [in, out] wrPtr pointer to the writer
+ * \param [in] strPtr string that is to be written
+ */
+NK_INTERNAL NkVoid __NkInt_ProfileWriterString(_Inout_ __NkInt_ProfileWriter *wrPtr, _In_z_ char const *strPtr) {
+    __NkInt_ProfileWriterPrint(wrPtr, "\"");
+
+    for (; *strPtr != '\0'; strPtr++) {
+        /* Leave room for the longest escape sequence. */
+        if (wrPtr->m_bufOff + 8 > sizeof wrPtr->m_bufArr)
+            __NkInt_ProfileWriterFlush(wrPtr);
+
+        NkUint8 const currChar = (NkUint8)*strPtr;
+        if (currChar == '"' || currChar == '\\') {
+            wrPtr->m_bufArr[wrPtr->m_bufOff++] = '\\';
+            wrPtr->m_bufArr[wrPtr->m_bufOff++] = (char)currChar;
+        } else if (currChar < 0x20)
+            __NkInt_ProfileWriterPrint(wrPtr, "\\u%04x", currChar);
+        else
+            wrPtr->m_bufArr[wrPtr->m_bufOff++] = (char)currChar;
+    }
+
+    __NkInt_ProfileWriterPrint(wrPtr, "\"");
+}
+
+/**
+ * \brief writes the header of a single trace event
+ * \param [in, out] wrPtr pointer to the writer
+ * \param [in] phStr phase of the event
+ * \param [in] evName name of the event
+ * \param [in] thrdInd index of the thread the event belongs to
+ */
+NK_INTERNAL NkVoid __NkInt_ProfileWriterEvent(
+    _Inout_ __NkInt_ProfileWriter *wrPtr,
+    _In_z_  char const *phStr,
+    _In_z_  char const *evName,
+    _In_    NkUint32 thrdInd
+) {
+    __NkInt_ProfileWriterPrint(wrPtr, "%s\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"name\":", wrPtr->m_isFirst ? "" : ",", phStr, thrdInd);
+    __NkInt_ProfileWriterString(wrPtr, evName);
+
+    wrPtr->m_isFirst = NK_FALSE;
+}
+
+/**
+ * \brief  writes the current capture to the capture file
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_ProfileWriteCapture(NkVoid) {
+    /* Create the file. */
+    NkIFilesystem *fileSysSrv = (NkIFilesystem *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIFilesystem));
+    NkIFile       *fileObj;
+    NkErrorCode    errCode    = fileSysSrv->VT->Create(
+        fileSysSrv,
+        NkStrTy_DiskFile,
+        gl_ProfCxt.m_capPath,
+        NkStrMd_Write | NkStrMd_Binary,
+        &fileObj
+    );
+    fileSysSrv->VT->Release(fileSysSrv);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    __NkInt_ProfileWriter  fileWr = { .mp_fileObj = fileObj, .m_errCode = NkErr_Ok, .m_isFirst = NK_TRUE };
+    __NkInt_ProfileWriter *wrPtr  = &fileWr;
+
+    /* Name the process and the threads. Thread IDs start at 1; 0 is used for counters. */
+    __NkInt_ProfileWriterPrint(wrPtr, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    __NkInt_ProfileWriterEvent(wrPtr, "M", "process_name", 0);
+    __NkInt_ProfileWriterPrint(wrPtr, ",\"args\":{\"name\":\"Noriko\"}}");
+
+    LONG const nThreads = InterlockedCompareExchange(&gl_ProfCxt.m_nThreads, 0, 0);
+    for (LONG i = 0; i < nThreads; i++) {
+        char thrdName[32];
+        if (gl_ProfCxt.mp_thrdArr[i] == gl_ProfThread)
+            NK_IGNORE_RETURN_VALUE(snprintf(thrdName, sizeof thrdName, "Main thread"));
+        else
+            NK_IGNORE_RETURN_VALUE(snprintf(thrdName, sizeof thrdName, "Thread %li", i + 1));
+
+        __NkInt_ProfileWriterEvent(wrPtr, "M", "thread_name", (NkUint32)i + 1);
+        __NkInt_ProfileWriterPrint(wrPtr, ",\"args\":{\"name\":");
+        __NkInt_ProfileWriterString(wrPtr, thrdName);
+        __NkInt_ProfileWriterPrint(wrPtr, "}}");
+    }
+
+    /* Write the events; timestamps are given in microseconds since the capture began. */
+    NkDouble const usPerTick = 1000000.0 / (NkDouble)NkTimerGetFastFrequency();
+    for (NkSize i = 0; i < gl_ProfCxt.m_capSize; i++) {
+        __NkInt_ProfileCaptureEvent const *evPtr = &gl_ProfCxt.mp_capArr[i];
+        NkDouble const                     evTime = (NkDouble)(evPtr->m_evTime - gl_ProfCxt.m_capStart) * usPerTick;
+
+        switch (evPtr->m_evType) {
+            case __NkInt_ProfEv_Zone:
+                __NkInt_ProfileWriterEvent(wrPtr, "X", evPtr->mp_evName, evPtr->m_thrdInd + 1);
+                __NkInt_ProfileWriterPrint(wrPtr, ",\"ts\":%.3f,\"dur\":%.3f}", evTime, (NkDouble)evPtr->m_evDur * usPerTick);
+                break;
+            case __NkInt_ProfEv_Instant:
+                __NkInt_ProfileWriterEvent(wrPtr, "i", evPtr->mp_evName, evPtr->m_thrdInd + 1);
+                __NkInt_ProfileWriterPrint(wrPtr, ",\"s\":\"t\",\"ts\":%.3f}", evTime);
+                break;
+            case __NkInt_ProfEv_Frame:
+                __NkInt_ProfileWriterEvent(wrPtr, "i", evPtr->mp_evName, 0);
+                __NkInt_ProfileWriterPrint(wrPtr, ",\"s\":\"g\",\"ts\":%.3f}", evTime);
+                break;
+            case __NkInt_ProfEv_Counter:
+                __NkInt_ProfileWriterEvent(wrPtr, "C", evPtr->mp_evName, 0);
+                __NkInt_ProfileWriterPrint(
+                    wrPtr,
+                    ",\"ts\":%.3f,\"args\":{\"count\":%llu,\"bytes\":%llu}}",
+                    evTime,
+                    (unsigned long long)evPtr->m_evArgs[0],
+                    (unsigned long long)evPtr->m_evArgs[1]
+                );
+                break;
+        }
+    }
+    __NkInt_ProfileWriterPrint(wrPtr, "\n]}\n");
+    __NkInt_ProfileWriterFlush(wrPtr);
+
+    errCode = wrPtr->m_errCode == NkErr_Ok ? fileObj->VT->Flush(fileObj) : wrPtr->m_errCode;
+    /* Releasing the file object closes the file. */
+    fileObj->VT->Release(fileObj);
+
+    return errCode;
+}
+
+/**
+ * \brief ends the current capture, writes it to the capture file, and frees the capture
+ *        buffer
+ */
+NK_INTERNAL NkVoid __NkInt_ProfileEndCapture(NkVoid) {
+    gl_ProfCxt.m_isCapture = NK_FALSE;
+
+    if (gl_ProfCxt.m_isCapTrunc)
+        NK_LOG_WARNING("Profiler capture is incomplete; the capture buffer could not grow.");
+
+    NkErrorCode const errCode = __NkInt_ProfileWriteCapture();
+    if (errCode == NkErr_Ok)
+        NK_LOG_INFO("Wrote profiler capture with %zu event(s) to \"%s\".", gl_ProfCxt.m_capSize, gl_ProfCxt.m_capPath);
+    else
+        NK_LOG_ERROR("Could not write profiler capture to \"%s\". Reason: %s", gl_ProfCxt.m_capPath, NkGetErrorCodeStr(errCode)->mp_dataPtr);
+
+    NkGPFree(gl_ProfCxt.mp_capArr);
+    gl_ProfCxt.mp_capArr  = NULL;
+    gl_ProfCxt.m_capSize  = gl_ProfCxt.m_capCap = 0;
+    gl_ProfCxt.m_isCapTrunc = NK_FALSE;
+}
+
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_STARTUPFN(Profiler)(NkVoid) {
+    if (NK_INITLOCK(gl_ProfCxt.m_mtxLock) != thrd_success)
+        return NkErr_SynchInit;
+
+    gl_ProfCxt.m_isInit = NK_TRUE;
+    return NkErr_Ok;
+}
+
+/**
+ * \note Threads that are still alive must not enter zones anymore after the profiler
+ *       was shut down.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL NK_COMPONENT_SHUTDOWNFN(Profiler)(NkVoid) {
+    gl_ProfCxt.m_isInit = NK_FALSE;
+
+    if (gl_ProfCxt.m_nDropped > 0)
+        NK_LOG_WARNING("Profiler dropped %li record(s); the frame time was too long for the ring buffers.", gl_ProfCxt.m_nDropped);
+
+    if (gl_ProfCxt.m_isCapture || gl_ProfCxt.m_nCapPending > 0)
+        NK_LOG_WARNING("Profiler capture to \"%s\" was still running and is discarded.", gl_ProfCxt.m_capPath);
+    /*
+     * Other threads still point to their recording states, and components that are shut
+     * down later still allocate, so recording must be stopped before the states are freed.
+     */
+    gl_ProfCxt.m_isCapture   = NK_FALSE;
+    gl_ProfCxt.m_nCapPending = 0;
+    NkGPFree(gl_ProfCxt.mp_capArr);
+    gl_ProfCxt.mp_capArr = NULL;
+    gl_ProfCxt.m_capSize = gl_ProfCxt.m_capCap = 0;
+
+    for (LONG i = 0; i < gl_ProfCxt.m_nThreads; i++)
+        NkGPFree(gl_ProfCxt.mp_thrdArr[i]);
+    gl_ProfThread = NULL;
+
+    NK_DESTROYLOCK(gl_ProfCxt.m_mtxLock);
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+NkVoid NK_CALL NkProfileBeginZone(_In_z_ char const *zoneName) {
+    NK_ASSERT(zoneName != NULL, NkErr_InParameter);
+
+    if (!gl_ProfCxt.m_isInit)
+        return;
+    __NkInt_ProfileThread *thrdPtr = gl_ProfThread != NULL ? gl_ProfThread : __NkInt_ProfileRegisterThread();
+    if (thrdPtr == NULL)
+        return;
+
+    /* Zones that are nested too deep are only counted so that the stack stays balanced. */
+    NkUint32 const zoneDepth = thrdPtr->m_stackDepth++;
+    if (zoneDepth >= NK_PROFILE_MAXDEPTH)
+        return;
+
+    /* If the parent is not recorded, neither are its children. */
+    NkUint32 const parentInd = zoneDepth > 0 ? thrdPtr->m_zoneStack[zoneDepth - 1] : NK_PROFILE_NOZONE;
+    thrdPtr->m_zoneStack[zoneDepth] = zoneDepth > 0 && parentInd == NK_PROFILE_NOZONE
+        ? NK_PROFILE_NOZONE
+        : __NkInt_ProfileGetZone(zoneName, parentInd, zoneDepth)
+    ;
+    /* Take the time last so that the lookup is not measured. */
+    thrdPtr->m_startStack[zoneDepth] = NkTimerGetFastTicks();
+}
+
+NkVoid NK_CALL NkProfileEndZone(NkVoid) {
+    /* Take the time first so that the bookkeeping is not measured. */
+    NkUint64 const endTime = NkTimerGetFastTicks();
+
+    __NkInt_ProfileThread *thrdPtr = gl_ProfThread;
+    if (!gl_ProfCxt.m_isInit || thrdPtr == NULL || thrdPtr->m_stackDepth == 0)
+        return;
+
+    NkUint32 const zoneDepth = --thrdPtr->m_stackDepth;
+    if (zoneDepth >= NK_PROFILE_MAXDEPTH || thrdPtr->m_zoneStack[zoneDepth] == NK_PROFILE_NOZONE)
+        return;
+
+    __NkInt_ProfilePushRecord(thrdPtr, &(__NkInt_ProfileRecord const){
+        .m_recType   = __NkInt_ProfEv_Zone,
+        .m_zoneInd   = thrdPtr->m_zoneStack[zoneDepth],
+        .m_startTime = thrdPtr->m_startStack[zoneDepth],
+        .m_endTime   = endTime
+    });
+}
+
+NkVoid NK_CALL NkProfileMarkFrame(NkVoid) {
+    if (!gl_ProfCxt.m_isInit)
+        return;
+    NkUint64 const frameTime = NkTimerGetFastTicks();
+    NkBoolean const isCapture = gl_ProfCxt.m_isCapture;
+
+    /* Collect the records of all threads. */
+    LONG const nThreads = InterlockedCompareExchange(&gl_ProfCxt.m_nThreads, 0, 0);
+    for (LONG i = 0; i < nThreads; i++) {
+        __NkInt_ProfileThread *thrdPtr = gl_ProfCxt.mp_thrdArr[i];
+
+        LONG const writePos = InterlockedCompareExchange(&thrdPtr->m_writePos, 0, 0);
+        LONG       readPos  = thrdPtr->m_readPos;
+        for (; readPos != writePos; readPos++) {
+            __NkInt_ProfileRecord const *recPtr = &thrdPtr->m_recArr[(NkUint32)readPos & (NK_PROFILE_RINGSIZE - 1)];
+
+            if (recPtr->m_recType == __NkInt_ProfEv_Zone) {
+                __NkInt_ProfileZone *zonePtr = &gl_ProfCxt.m_zoneArr[recPtr->m_zoneInd];
+
+                zonePtr->m_currTicks += recPtr->m_endTime - recPtr->m_startTime;
+                ++zonePtr->m_nCurrCalls;
+            }
+
+            /* Only capture what happened after the capture began. */
+            if (isCapture && recPtr->m_startTime >= gl_ProfCxt.m_capStart)
+                __NkInt_ProfileAppendCapture(&(__NkInt_ProfileCaptureEvent const){
+                    .m_evType  = recPtr->m_recType,
+                    .m_thrdInd = (NkUint32)i,
+                    .mp_evName = recPtr->m_recType == __NkInt_ProfEv_Zone
+                        ? gl_ProfCxt.m_zoneArr[recPtr->m_zoneInd].mp_zoneName
+                        : recPtr->mp_instName,
+                    .m_evTime  = recPtr->m_startTime,
+                    .m_evDur   = recPtr->m_endTime - recPtr->m_startTime
+                });
+        }
+        NK_IGNORE_RETURN_VALUE(InterlockedExchange(&thrdPtr->m_readPos, readPos));
+    }
+
+    /* Close the frame for every zone. */
+    LONG const nZones = InterlockedCompareExchange(&gl_ProfCxt.m_nZones, 0, 0);
+    for (LONG i = 0; i < nZones; i++) {
+        __NkInt_ProfileZone *zonePtr = &gl_ProfCxt.m_zoneArr[i];
+
+        zonePtr->m_nLastCalls = zonePtr->m_nCurrCalls;
+        zonePtr->m_lastTicks  = zonePtr->m_currTicks;
+        if (zonePtr->m_nCurrCalls > 0) {
+            zonePtr->m_minTicks  = NK_MIN(zonePtr->m_minTicks, zonePtr->m_currTicks);
+            zonePtr->m_maxTicks  = NK_MAX(zonePtr->m_maxTicks, zonePtr->m_currTicks);
+            zonePtr->m_sumTicks += zonePtr->m_currTicks;
+            ++zonePtr->m_nFrames;
+        }
+
+        zonePtr->m_nCurrCalls = 0;
+        zonePtr->m_currTicks  = 0;
+    }
+
+    /*
+     * Record the frame boundary and the allocations made during the frame that ended.
+     * Then, end the capture if enough frames were captured, or begin a pending one.
+     */
+    NkUint64 currAllocs[2];
+    if (isCapture) {
+        __NkInt_ProfileSumAllocations(currAllocs);
+
+        __NkInt_ProfileAppendCapture(&(__NkInt_ProfileCaptureEvent const){
+            .m_evType  = __NkInt_ProfEv_Counter,
+            .mp_evName = "Allocations",
+            .m_evTime  = gl_ProfCxt.m_capFrameStart,
+            .m_evArgs  = { currAllocs[0] - gl_ProfCxt.m_capAllocs[0], currAllocs[1] - gl_ProfCxt.m_capAllocs[1] }
+        });
+        __NkInt_ProfileAppendCapture(&(__NkInt_ProfileCaptureEvent const){
+            .m_evType  = __NkInt_ProfEv_Frame,
+            .mp_evName = "Frame",
+            .m_evTime  = frameTime
+        });
+        gl_ProfCxt.m_capFrameStart = frameTime;
+        gl_ProfCxt.m_capAllocs[0]  = currAllocs[0];
+        gl_ProfCxt.m_capAllocs[1]  = currAllocs[1];
+
+        if (--gl_ProfCxt.m_nCapFrames == 0)
+            __NkInt_ProfileEndCapture();
+    } else if (gl_ProfCxt.m_nCapPending > 0) {
+        __NkInt_ProfileSumAllocations(gl_ProfCxt.m_capAllocs);
+
+        gl_ProfCxt.m_nCapFrames    = gl_ProfCxt.m_nCapPending;
+        gl_ProfCxt.m_nCapPending   = 0;
+        gl_ProfCxt.m_capStart      = frameTime;
+        gl_ProfCxt.m_capFrameStart = frameTime;
+        gl_ProfCxt.m_isCapture     = NK_TRUE;
+
+        NK_LOG_INFO("Capturing %u frame(s) to \"%s\".", gl_ProfCxt.m_nCapFrames, gl_ProfCxt.m_capPath);
+    }
+}
+
+NkUint32 NK_CALL NkProfileQueryZones(_O_array_(maxZones) NkProfileZoneStats *statArr, _In_ NkUint32 maxZones) {
+    NK_ASSERT(statArr != NULL || maxZones == 0, NkErr_OutParameter);
+
+    NkUint32 const nZones = NK_MIN((NkUint32)InterlockedCompareExchange(&gl_ProfCxt.m_nZones, 0, 0), maxZones);
+    for (NkUint32 i = 0; i < nZones; i++) {
+        __NkInt_ProfileZone const *zonePtr = &gl_ProfCxt.m_zoneArr[i];
+
+        statArr[i] = (NkProfileZoneStats){
+            .mp_zoneName = zonePtr->mp_zoneName,
+            .m_parentInd = zonePtr->m_parentInd == NK_PROFILE_NOZONE ? -1 : (NkInt32)zonePtr->m_parentInd,
+            .m_zoneDepth = zonePtr->m_zoneDepth,
+            .m_nCalls    = zonePtr->m_nLastCalls,
+            .m_nFrames   = zonePtr->m_nFrames,
+            .m_lastTime  = __NkInt_ProfileTicksToMs(zonePtr->m_lastTicks),
+            .m_minTime   = zonePtr->m_nFrames > 0 ? __NkInt_ProfileTicksToMs(zonePtr->m_minTicks) : 0.0,
+            .m_avgTime   = zonePtr->m_nFrames > 0
+                ? __NkInt_ProfileTicksToMs(zonePtr->m_sumTicks) / (NkDouble)zonePtr->m_nFrames
+                : 0.0,
+            .m_maxTime   = __NkInt_ProfileTicksToMs(zonePtr->m_maxTicks)
+        };
+    }
+
+    return nZones;
+}
+
+NkVoid NK_CALL NkProfileReset(NkVoid) {
+    LONG const nZones = InterlockedCompareExchange(&gl_ProfCxt.m_nZones, 0, 0);
+
+    for (LONG i = 0; i < nZones; i++) {
+        __NkInt_ProfileZone *zonePtr = &gl_ProfCxt.m_zoneArr[i];
+
+        zonePtr->m_nLastCalls = 0;
+        zonePtr->m_lastTicks  = 0;
+        zonePtr->m_minTicks   = UINT64_MAX;
+        zonePtr->m_maxTicks   = 0;
+        zonePtr->m_sumTicks   = 0;
+        zonePtr->m_nFrames    = 0;
+    }
+}
+
+NkVoid NK_CALL NkProfileDumpReport(NkVoid) {
+    NkProfileZoneStats statArr[NK_PROFILE_MAXZONES];
+    NkUint32 const     nZones = NkProfileQueryZones(statArr, NK_PROFILE_MAXZONES);
+
+    NK_LOG_INFO("Profiler report: %u zone(s); times per frame in ms.", nZones);
+    NK_LOG_INFO("    last      min      avg      max   calls    frames  zone");
+    /*
+     * Print the zones depth-first so that children appear right below their parent.
+     * Parents are always listed before their children, so a simple stack suffices. All
+     * siblings are pushed at once, but every zone is pushed at most once.
+     */
+    NkUint32 stackArr[NK_PROFILE_MAXZONES];
+    NkUint32 stackSize = 0;
+    for (NkUint32 i = 0; i < nZones; i++) {
+        if (statArr[i].m_parentInd != -1)
+            continue;
+
+        for (stackArr[stackSize++] = i; stackSize > 0; ) {
+            NkUint32 const            currInd = stackArr[--stackSize];
+            NkProfileZoneStats const *statPtr = &statArr[currInd];
+
+            NK_LOG_INFO(
+                "%8.3f %8.3f %8.3f %8.3f %7u %9llu  %*s%s",
+                statPtr->m_lastTime,
+                statPtr->m_minTime,
+                statPtr->m_avgTime,
+                statPtr->m_maxTime,
+                statPtr->m_nCalls,
+                (unsigned long long)statPtr->m_nFrames,
+                (int)(2 * statPtr->m_zoneDepth),
+                "",
+                statPtr->mp_zoneName
+            );
+
+            /* Push children in reverse so that they are printed in creation order. */
+            for (NkUint32 j = nZones; j > currInd + 1 && stackSize < NK_ARRAYSIZE(stackArr); j--)
+                if (statArr[j - 1].m_parentInd == (NkInt32)currInd)
+                    stackArr[stackSize++] = j - 1;
+        }
+    }
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkProfileBeginCapture(_In_z_ char const *filePath, _In_ NkUint32 nFrames) {
+    NK_ASSERT(filePath != NULL && *filePath != '\0', NkErr_InParameter);
+    NK_ASSERT(nFrames > 0, NkErr_InParameter);
+
+    if (!gl_ProfCxt.m_isInit)
+        return NkErr_ComponentState;
+    if (NkProfileIsCapturing())
+        return NkErr_NoOperation;
+    if (strlen(filePath) >= NK_PROFILE_MAXPATH)
+        return NkErr_InParameter;
+
+    /* The capture begins with the next frame. */
+    strcpy(gl_ProfCxt.m_capPath, filePath);
+    gl_ProfCxt.m_nCapPending = nFrames;
+    return NkErr_Ok;
+}
+
+NkBoolean NK_CALL NkProfileIsCapturing(NkVoid) {
+    return gl_ProfCxt.m_isCapture || gl_ProfCxt.m_nCapPending > 0;
+}
+
+NkVoid NK_CALL NkProfileMarkInstant(_In_z_ char const *instName) {
+    NK_ASSERT(instName != NULL, NkErr_InParameter);
+
+    if (!gl_ProfCxt.m_isInit || !gl_ProfCxt.m_isCapture)
+        return;
+    __NkInt_ProfileThread *thrdPtr = gl_ProfThread != NULL ? gl_ProfThread : __NkInt_ProfileRegisterThread();
+    if (thrdPtr == NULL)
+        return;
+
+    NkUint64 const currTime = NkTimerGetFastTicks();
+    __NkInt_ProfilePushRecord(thrdPtr, &(__NkInt_ProfileRecord const){
+        .m_recType   = __NkInt_ProfEv_Instant,
+        .m_zoneInd   = NK_PROFILE_NOZONE,
+        .mp_instName = instName,
+        .m_startTime = currTime,
+        .m_endTime   = currTime
+    });
+}
+
+NkVoid NK_CALL NkProfileCountAllocation(_In_ NkSize nBytes) {
+    /*
+     * Never register the thread here; registering allocates the recording state which
+     * would recurse into this function.
+     */
+    __NkInt_ProfileThread *thrdPtr = gl_ProfThread;
+    if (!gl_ProfCxt.m_isInit || !gl_ProfCxt.m_isCapture || thrdPtr == NULL)
+        return;
+
+    NK_IGNORE_RETURN_VALUE(InterlockedIncrement64(&thrdPtr->m_nAllocs));
+    NK_IGNORE_RETURN_VALUE(InterlockedExchangeAdd64(&thrdPtr->m_nAllocBytes, (LONG64)nBytes));
+}
+
+
+/**
+ */
+NK_COMPONENT_DEFINE(Profiler) {
+    .m_compUuid     = { 0x6e2b9d41, 0x83a7, 0x4f1c, 0xb5d8240c7e91a3f6 },
+    .mp_clsId       = NULL,
+    .m_compIdent    = NK_MAKE_STRING_VIEW("profiler"),
+    .m_compFlags    = 0,
+    .m_isNkOM       = NK_FALSE,
+
+    .mp_fnQueryInst = NULL,
+    .mp_fnStartup   = &NK_COMPONENT_STARTUPFN(Profiler),
+    .mp_fnShutdown  = &NK_COMPONENT_SHUTDOWNFN(Profiler)
+};
+
+
+#undef NK_NAMESPACE
+
+
@@ -0,0 +1,819 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  rdnull.c
+ * \brief implements the headless (null) renderer
+ *
+ * The null renderer does everything a real renderer does on the CPU (validating draw
+ * calls, normalizing source rectangles, tracking the bound texture and the render target,
+ * counting frame statistics), but does not write a single pixel. It is available on all
+ * platforms and is used for automated runs and benchmarks where the cost of the graphics
+ * driver and of presenting would only add noise.
+ *
+ * Resources do not own any memory besides their \c NkRendererResource instance; the
+ * resource handle encodes the dimensions of the resource (see
+ * <tt>__NkInt_NullRenderer_MakeHandle()</tt>).
+ */
+#define NK_NAMESPACE "nk::rdnull"
+
+
+/* Noriko includes */
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/renderer.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/bmp.h>
+#include <include/Noriko/pixel.h>
+#include <include/Noriko/timer.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \class __NkInt_NullRenderer
+ * \brief represents the instance-specific internal state of the null renderer
+ */
+NK_NATIVE typedef struct __NkInt_NullRenderer {
+    NKOM_IMPLEMENTS(NkINullRenderer);
+
+    NkOMRefCount             m_refCount; /**< reference count */
+    NkIWindow               *mp_wndRef;  /**< reference to the Noriko window */
+    NkRendererSpecification  m_initSpec; /**< initial specification */
+    NkRendererSpecification  m_currSpec; /**< current renderer settings */
+    NkSize2D                 m_bbDim;    /**< dimensions of the (virtual) back buffer */
+    NkSize2D                 m_reqDim;   /**< requested back buffer dimensions; applied when the next frame begins */
+
+    /**
+     * \struct __NkInt_NullState
+     * \brief  represents the device state the null renderer keeps track of
+     */
+    struct __NkInt_NullState {
+        NkRendererResource const *mp_boundTex; /**< texture that is currently bound */
+        NkRendererResource const *mp_surfPtr;  /**< current render target (or NULL for the back buffer) */
+    } m_currState;
+
+    /**
+     * \struct __NkInt_NullStatistics
+     * \brief  represents the counters of the current and the last finished frame
+     */
+    struct __NkInt_NullStatistics {
+        NkRendererFrameStatistics m_currStats;  /**< statistics of the frame being drawn */
+        NkRendererFrameStatistics m_lastStats;  /**< statistics of the last finished frame */
+        NkUint64                  m_beginTicks; /**< time <tt>BeginDraw()</tt> was entered */
+    } m_frameStats;
+} __NkInt_NullRenderer;
+/* Define IID and CLSID. */
+// { 6F0B3C2E-91D4-4A57-B8E3-2D5C7A14F960 }
+NKOM_DEFINE_IID(NkINullRenderer, { 0x6f0b3c2e, 0x91d4, 0x4a57, 0xb8e32d5c7a14f960 });
+// { C43E8A71-5B02-4D9F-A6C1-8E7F209B3D45 }
+NKOM_DEFINE_CLSID(NkINullRenderer, { 0xc43e8a71, 0x5b02, 0x4d9f, 0xa6c18e7f209b3d45 });
+
+
+/**
+ * \brief  packs the dimensions of a resource into a resource handle
+ * \param  [in] resDim dimensions of the resource, in pixels
+ * \return resource handle
+ */
+NK_INTERNAL NK_INLINE NkRendererResourceHandle __NkInt_NullRenderer_MakeHandle(_In_ NkSize2D resDim) {
+    return (NkRendererResourceHandle)(((NkUint64)(NkUint32)resDim.m_width << 32) | (NkUint64)(NkUint32)resDim.m_height);
+}
+
+/**
+ * \brief  retrieves the dimensions of a resource from its handle
+ * \param  [in] resPtr pointer to the resource
+ * \return dimensions of the resource, in pixels
+ */
+NK_INTERNAL NK_INLINE NkSize2D __NkInt_NullRenderer_GetDimensions(_In_ NkRendererResource const *resPtr) {
+    return (NkSize2D){
+        (NkUint64)((NkUint64)resPtr->m_resHandle >> 32),
+        (NkUint64)((NkUint64)resPtr->m_resHandle & 0xFFFFFFFF)
+    };
+}
+
+/**
+ * \brief  checks whether the given resource can be used as the source of a texture draw
+ * \param  [in] resPtr pointer to the resource to check
+ * \return \c NK_TRUE if the resource is a texture, an alpha texture or a surface,
+ *         \c NK_FALSE otherwise
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_NullRenderer_IsTexture(_In_ NkRendererResource const *resPtr) {
+    return resPtr->m_resType == NkRdResTy_Texture
+        || resPtr->m_resType == NkRdResTy_AlphaTexture
+        || resPtr->m_resType == NkRdResTy_Surface;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid __NkInt_NullRenderer_InternalDeleteResource(
+    _Inout_ NkIRenderer *self,
+    _Inout_ NkRendererResource *resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to internal renderer structure. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+
+    switch (resPtr->m_resType) {
+        case NkRdResTy_Texture:
+        case NkRdResTy_TextureMask:
+        case NkRdResTy_Surface:
+        case NkRdResTy_AlphaTexture:
+            /* Unbind the resource if it is bound in any way. */
+            if (rdRef->m_currState.mp_boundTex == resPtr)
+                rdRef->m_currState.mp_boundTex = NULL;
+            if (rdRef->m_currState.mp_surfPtr == resPtr)
+                NK_IGNORE_RETURN_VALUE(self->VT->SetRenderTarget(self, NULL));
+
+            break;
+        default:
+            NK_LOG_CRITICAL("Unknown resource type: %i", (int)resPtr->m_resType);
+#pragma warning (suppress: 4127)
+            NK_ASSERT_EXTRA(NK_FALSE, NkErr_InOutParameter, "Cannot delete resource of this type.");
+
+            return;
+    }
+
+    /* The resource held a reference to the renderer; release it. */
+    resPtr->mp_rdRef->VT->Release(resPtr->mp_rdRef);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_NullRenderer_AppropriateResource(
+    _Inout_        NkIRenderer *self,
+    _Maybe_reinit_ NkRendererResource **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Delete old resource if needed. */
+    if (*resPtr != NULL)
+        __NkInt_NullRenderer_InternalDeleteResource(self, *resPtr);
+    else {
+        /* Allocate new resource if it was NULL previously. */
+        NkErrorCode errCode = NkPoolAlloc(NULL, sizeof **resPtr, 1, resPtr);
+
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  creates a resource of the given type and dimensions
+ * \param  [in, out] self current \c NkIRenderer instance
+ * \param  [in] resType type of the resource
+ * \param  [in] resDim dimensions of the resource, in pixels
+ * \param  [out] resourcePtr pointer to a variable that receives the resource; an existing
+ *               resource is re-initialized in-place
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_NullRenderer_CreateResource(
+    _Inout_        NkIRenderer *self,
+    _In_           NkRendererResourceType resType,
+    _In_           NkSize2D resDim,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    if (resDim.m_width > UINT32_MAX || resDim.m_height > UINT32_MAX)
+        return NkErr_InParameter;
+
+    /* Create new resource, delete old if needed. */
+    NkErrorCode errCode;
+    if ((errCode = __NkInt_NullRenderer_AppropriateResource(self, resourcePtr)) != NkErr_Ok)
+        return errCode;
+
+    /* (Re-)initialize new resource. */
+    self->VT->AddRef(self);
+    **resourcePtr = (NkRendererResource){
+        .mp_rdRef    = self,
+        .m_resType   = resType,
+        .m_resHandle = __NkInt_NullRenderer_MakeHandle(resDim),
+        .m_resFlags  = 0,
+        .m_resDim    = resDim
+    };
+    return NkErr_Ok;
+}
+
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_NullRenderer_AddRef(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return NkOMRefCountIncrement(&((__NkInt_NullRenderer *)self)->m_refCount, NkOMRcMd_ThreadLocal);
+}
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_NullRenderer_Release(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&((__NkInt_NullRenderer *)self)->m_refCount, NkOMRcMd_ThreadLocal);
+    if (newCount <= 0) {
+        NK_LOG_INFO("shutdown: null renderer");
+
+        /* Release the parent window. */
+        ((__NkInt_NullRenderer *)self)->mp_wndRef->VT->Release(((__NkInt_NullRenderer *)self)->mp_wndRef);
+
+        NkGPFree((NkVoid *)self);
+        return 0;
+    }
+
+    return newCount;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_QueryInterface(
+    _Inout_  NkIRenderer *self,
+    _In_     NkUuid const *iId,
+    _Outptr_ NkVoid **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(iId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    NK_INTERNAL NkOMImplementationInfo const gl_ImplInfos[] = {
+        { NKOM_IIDOF(NkIBase)          },
+        { NKOM_IIDOF(NkIInitializable) },
+        { NKOM_IIDOF(NkIRenderer)      },
+        { NKOM_IIDOF(NkINullRenderer)  },
+        { NULL                         }
+    };
+    if (NkOMQueryImplementationIndex(gl_ImplInfos, iId) != SIZE_MAX) {
+        /* Interface is implemented. */
+        *resPtr = (NkVoid *)self;
+
+        __NkInt_NullRenderer_AddRef(self);
+        return NkErr_Ok;
+    }
+
+    /* Interface not implemented. */
+    *resPtr = NULL;
+    return NkErr_InterfaceNotImpl;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_Initialize(
+    _Inout_     NkIRenderer *self,
+    _Inout_opt_ NkVoid *initParam
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(initParam != NULL, NkErr_InParameter);
+
+    NK_LOG_INFO("startup: null renderer");
+
+    /* Get the pointer to the renderer specification. */
+    NkRendererSpecification const *rdSpecs = (NkRendererSpecification const *)initParam;
+    NkSize2D const                 clDim   = rdSpecs->mp_wndRef->VT->GetClientDimensions(rdSpecs->mp_wndRef);
+    rdSpecs->mp_wndRef->VT->AddRef(rdSpecs->mp_wndRef);
+
+    /* Initialize renderer fields. */
+    *(__NkInt_NullRenderer *)self = (__NkInt_NullRenderer){
+        .NkINullRenderer_Iface.VT = self->VT,
+
+        .m_refCount = ((__NkInt_NullRenderer *)self)->m_refCount,
+        .mp_wndRef  = rdSpecs->mp_wndRef,
+        .m_initSpec = *rdSpecs,
+        .m_currSpec = *rdSpecs,
+        .m_bbDim    = clDim,
+        .m_reqDim   = clDim
+    };
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkRendererApi NK_CALL __NkInt_NullRenderer_QueryRendererApi(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+
+    return NkRdApi_Null;
+}
+
+/**
+ */
+NK_INTERNAL NkRendererSpecification const *NK_CALL __NkInt_NullRenderer_QuerySpecification(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return &((__NkInt_NullRenderer *)self)->m_initSpec;
+}
+
+/**
+ */
+NK_INTERNAL NkIWindow *NK_CALL __NkInt_NullRenderer_QueryWindow(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    NkIWindow *wndRef = ((__NkInt_NullRenderer *)self)->mp_wndRef;
+
+    wndRef->VT->AddRef(wndRef);
+    return wndRef;
+}
+
+/**
+ */
+NK_INTERNAL NkSize2D NK_CALL __NkInt_NullRenderer_QueryViewportDimensions(_In_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to internal renderer state. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+
+    /* Calculate current viewport dimensions. */
+    return (NkSize2D) {
+        rdRef->m_currSpec.m_dispTileSize.m_width  * rdRef->m_currSpec.m_vpExtents.m_width,
+        rdRef->m_currSpec.m_dispTileSize.m_height * rdRef->m_currSpec.m_vpExtents.m_height
+    };
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_NullRenderer_QueryFrameStatistics(
+    _Inout_ NkIRenderer *self,
+    _Out_   NkRendererFrameStatistics *statPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(statPtr != NULL, NkErr_OutParameter);
+
+    *statPtr = ((__NkInt_NullRenderer *)self)->m_frameStats.m_lastStats;
+    statPtr->m_structSize = sizeof *statPtr;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_Resize(
+    _Inout_ NkIRenderer *self,
+    _In_    NkSize2D clAreaSize
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Like with the GDI renderer, the new size is only applied when the next frame begins. */
+    ((__NkInt_NullRenderer *)self)->m_reqDim = clAreaSize;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_BeginDraw(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to renderer state. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+
+    /* Start counting for the new frame. */
+    rdRef->m_frameStats.m_currStats  = (NkRendererFrameStatistics){
+        .m_structSize = sizeof(NkRendererFrameStatistics),
+        .m_frameInd   = rdRef->m_frameStats.m_lastStats.m_frameInd
+    };
+    rdRef->m_frameStats.m_beginTicks = NkTimerGetCurrentTicks();
+
+    /* Every frame starts out rendering to the back buffer at its latest size. */
+    rdRef->m_currState.mp_surfPtr = NULL;
+    rdRef->m_bbDim                = rdRef->m_reqDim;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_EndDraw(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    /* There is nothing to present; just publish the statistics of the frame. */
+    struct __NkInt_NullStatistics *statPtr  = &((__NkInt_NullRenderer *)self)->m_frameStats;
+    NkDouble const                 tickToMs = 1000. / (NkDouble)NkTimerGetFrequency();
+
+    statPtr->m_currStats.m_drawTime    = (NkDouble)(NkTimerGetCurrentTicks() - statPtr->m_beginTicks) * tickToMs;
+    statPtr->m_currStats.m_presentTime = 0.;
+    ++statPtr->m_currStats.m_frameInd;
+    statPtr->m_lastStats = statPtr->m_currStats;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_SetStaticRegions(
+    _Inout_          NkIRenderer *self,
+    _In_             NkSize count,
+    _I_array_(count) NkRectF const *rects,
+    _Out_opt_        NkBoolean *isPreservedPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(count == 0 || rects != NULL, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(count);
+    NK_UNREFERENCED_PARAMETER(rects);
+
+    /* The null renderer keeps no pixels, so there is nothing that could be preserved. */
+    if (isPreservedPtr != NULL)
+        *isPreservedPtr = NK_FALSE;
+    return NkErr_NotImplemented;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_NullRenderer_InvalidateFrame(_Inout_ NkIRenderer *self) {
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* Nothing is ever presented; nothing to do. */
+}
+
+/**
+ * \brief  normalizes the given source rectangle, that is, resolves a missing rectangle or
+ *         <tt>-1</tt> extents to the actual extents of the texture
+ * \param  [in] texPtr pointer to the texture resource the source rectangle refers to
+ * \param  [in] srcRect source rectangle to normalize; may be <tt>NULL</tt>
+ * \return normalized source rectangle
+ */
+NK_INTERNAL NkRectF __NkInt_NullRenderer_NormalizeSourceRect(
+    _In_     NkRendererResource const *texPtr,
+    _In_opt_ NkRectF const *srcRect
+) {
+    /* Source rectangle is entirely "valid"; nothing to do. */
+    if (srcRect != NULL && srcRect->m_width != -1 && srcRect->m_height != -1)
+        return *srcRect;
+
+    NkSize2D const texDim = __NkInt_NullRenderer_GetDimensions(texPtr);
+    /* Normalize upper-left corner. */
+    NkFloat const xCoord = srcRect ? srcRect->m_xCoord : 0.f;
+    NkFloat const yCoord = srcRect ? srcRect->m_yCoord : 0.f;
+    /* Normalize width and height. */
+    NkFloat const width  = !srcRect
+        ? (NkFloat)texDim.m_width
+        : (srcRect->m_width < 0.f ? (NkFloat)texDim.m_width - srcRect->m_width : srcRect->m_width)
+    ;
+    NkFloat const height = !srcRect
+        ? (NkFloat)texDim.m_height
+        : (srcRect->m_height < 0.f ? (NkFloat)texDim.m_height - srcRect->m_height : srcRect->m_height)
+    ;
+
+    return (NkRectF){ xCoord, yCoord, width, height };
+}
+
+/**
+ * \brief binds the given texture if it is not already bound
+ * \param [in, out] rdRef pointer to the renderer instance
+ * \param [in] texPtr pointer to the texture resource that is to be bound
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_NullRenderer_BindTexture(
+    _Inout_ __NkInt_NullRenderer *rdRef,
+    _In_    NkRendererResource const *texPtr
+) {
+    if (rdRef->m_currState.mp_boundTex != texPtr) {
+        rdRef->m_currState.mp_boundTex = texPtr;
+
+        ++rdRef->m_frameStats.m_currStats.m_nTexBinds;
+    }
+}
+
+/**
+ * \brief accounts for a single blit of the currently bound texture
+ * \param [in, out] rdRef pointer to the renderer instance
+ * \param [in] dstRect destination rectangle, in viewport space
+ * \param [in] srcRect normalized source rectangle
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_NullRenderer_BlitBoundTexture(
+    _Inout_ __NkInt_NullRenderer *rdRef,
+    _In_    NkRectF const *dstRect,
+    _In_    NkRectF const *srcRect
+) {
+    /* Count the blit the same way the GDI renderer would issue it. */
+    ++rdRef->m_frameStats.m_currStats.m_nSubmits;
+    rdRef->m_frameStats.m_currStats.m_nPxFilled += NkRendererCalculateArea(dstRect);
+
+    if (rdRef->m_currState.mp_boundTex->m_resType == NkRdResTy_AlphaTexture)
+        ++rdRef->m_frameStats.m_currStats.m_nAlphaBlits;
+    else if (NkRendererCompareRectangles(srcRect, dstRect) == NK_TRUE)
+        ++rdRef->m_frameStats.m_currStats.m_nBlits;
+    else
+        ++rdRef->m_frameStats.m_currStats.m_nStretchBlits;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_DrawTexture(
+    _Inout_  NkIRenderer *self,
+    _In_     NkRectF const *dstRect,
+    _In_     NkRendererResource const *texPtr,
+    _In_opt_ NkRectF const *srcRect
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+    NK_ASSERT(texPtr != NULL && __NkInt_NullRenderer_IsTexture(texPtr), NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_NullRenderer *rdRef       = (__NkInt_NullRenderer *)self;
+    NkRectF               normSrcRect = __NkInt_NullRenderer_NormalizeSourceRect(texPtr, srcRect);
+
+    __NkInt_NullRenderer_BindTexture(rdRef, texPtr);
+    __NkInt_NullRenderer_BlitBoundTexture(rdRef, dstRect, &normSrcRect);
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_DrawTextureBatch(
+    _Inout_              NkIRenderer *self,
+    _In_                 NkRendererResource const *texPtr,
+    _In_                 NkSize count,
+    _I_array_(count)     NkRectF const *dstRects,
+    _I_array_opt_(count) NkRectF const *srcRects
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(texPtr != NULL && __NkInt_NullRenderer_IsTexture(texPtr), NkErr_InParameter);
+    NK_ASSERT(count == 0 || dstRects != NULL, NkErr_InParameter);
+
+    /* Nothing to draw. */
+    if (count == 0)
+        return NkErr_Ok;
+
+    /* Get pointer to renderer structure. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+
+    /* Bind the texture only once for the entire span, then account for all portions. */
+    __NkInt_NullRenderer_BindTexture(rdRef, texPtr);
+    for (NkSize i = 0; i < count; i++) {
+        NkRectF normSrcRect = __NkInt_NullRenderer_NormalizeSourceRect(texPtr, srcRects != NULL ? &srcRects[i] : NULL);
+
+        __NkInt_NullRenderer_BlitBoundTexture(rdRef, &dstRects[i], &normSrcRect);
+    }
+
+    /* All good. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_DrawMaskedTexture(
+    _Inout_ NkIRenderer *self,
+    _In_    NkRectF const *dstRect,
+    _In_    NkRendererResource const *texPtr,
+    _In_    NkVec2F srcOff,
+    _In_    NkRendererResource const *maskPtr,
+    _In_    NkVec2F maskOff
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+    NK_ASSERT(texPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(maskPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(__NkInt_NullRenderer_IsTexture(texPtr), NkErr_InParameter);
+    NK_ASSERT(maskPtr->m_resType == NkRdResTy_TextureMask, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(srcOff);
+    NK_UNREFERENCED_PARAMETER(maskOff);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+    __NkInt_NullRenderer_BindTexture(rdRef, texPtr);
+
+    ++rdRef->m_frameStats.m_currStats.m_nMaskBlits;
+    ++rdRef->m_frameStats.m_currStats.m_nSubmits;
+    rdRef->m_frameStats.m_currStats.m_nPxFilled += NkRendererCalculateArea(dstRect);
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_SetRenderTarget(
+    _Inout_  NkIRenderer *self,
+    _In_opt_ NkRendererResource const *surfPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfPtr == NULL || surfPtr->m_resType == NkRdResTy_Surface, NkErr_InParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+
+    /* A surface that becomes the render target cannot stay bound as a texture. */
+    if (surfPtr != NULL && rdRef->m_currState.mp_boundTex == surfPtr)
+        rdRef->m_currState.mp_boundTex = NULL;
+
+    rdRef->m_currState.mp_surfPtr = surfPtr;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_ScrollSurface(
+    _Inout_ NkIRenderer *self,
+    _In_    NkRendererResource const *surfPtr,
+    _In_    NkPoint2D scrollOff
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfPtr != NULL && surfPtr->m_resType == NkRdResTy_Surface, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(self);
+    NK_UNREFERENCED_PARAMETER(surfPtr);
+    NK_UNREFERENCED_PARAMETER(scrollOff);
+
+    /* Surfaces have no contents; the uncovered area is indeterminate anyway. */
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_CreateTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
+    if (bmSpecs->m_bmpWidth <= 0 || bmSpecs->m_bmpHeight <= 0)
+        return NkErr_InParameter;
+
+    return __NkInt_NullRenderer_CreateResource(
+        self,
+        NkRdResTy_Texture,
+        (NkSize2D){ (NkUint64)bmSpecs->m_bmpWidth, (NkUint64)bmSpecs->m_bmpHeight },
+        resourcePtr
+    );
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_CreateAlphaTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _In_opt_       NkRgbaColor const *colKey,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(colKey);
+
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
+    if (bmSpecs->m_bitsPerPx != 24 && bmSpecs->m_bitsPerPx != 32)
+        return NkErr_InvBitDepth;
+    if (bmSpecs->m_bmpWidth <= 0 || bmSpecs->m_bmpHeight <= 0)
+        return NkErr_InParameter;
+
+    return __NkInt_NullRenderer_CreateResource(
+        self,
+        NkRdResTy_AlphaTexture,
+        (NkSize2D){ (NkUint64)bmSpecs->m_bmpWidth, (NkUint64)bmSpecs->m_bmpHeight },
+        resourcePtr
+    );
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_CreateTextureMask(
+    _Inout_        NkIRenderer *self,
+    _In_           NkRendererResource const *texPtr,
+    _In_           NkRgbaColor colKey,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(texPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_OutptrParameter);
+    NK_ASSERT(texPtr->m_resType == NkRdResTy_Texture, NkErr_InParameter);
+    NK_UNREFERENCED_PARAMETER(colKey);
+
+    /* The mask has the same dimensions as the texture it was created from. */
+    return __NkInt_NullRenderer_CreateResource(
+        self,
+        NkRdResTy_TextureMask,
+        __NkInt_NullRenderer_GetDimensions(texPtr),
+        resourcePtr
+    );
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_CreateSurface(
+    _Inout_        NkIRenderer *self,
+    _In_           NkSize2D surfDim,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfDim.m_width > 0 && surfDim.m_height > 0, NkErr_InParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_OutptrParameter);
+
+    return __NkInt_NullRenderer_CreateResource(self, NkRdResTy_Surface, surfDim, resourcePtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_DeleteResource(
+    _Inout_      NkIRenderer *self,
+    _Uninit_ptr_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resourcePtr != NULL && *resourcePtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT((*resourcePtr)->mp_rdRef == self, NkErr_InOutParameter);
+
+    __NkInt_NullRenderer_InternalDeleteResource(self, *resourcePtr);
+
+    NkPoolFree(*resourcePtr);
+    *resourcePtr = NULL;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_GrabFramebuffer(
+    _Inout_ NkIRenderer *self,
+    _Out_   NkDIBitmap *resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+
+    /* Nothing was ever drawn, so the framebuffer only consists of the clear color. */
+    return NkDIBitmapCreate(&(NkBitmapSpecification){
+        .m_structSize = sizeof(NkBitmapSpecification),
+        .m_bmpWidth   = (NkInt32)rdRef->m_bbDim.m_width,
+        .m_bmpHeight  = (NkInt32)rdRef->m_bbDim.m_height,
+        .m_bitsPerPx  = 32,
+        .m_bmpFlags   = NkBmpFlag_Flipped
+    }, &rdRef->m_currSpec.m_clearCol, resPtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_NullRenderer_CopyFramebuffer(
+    _Inout_ NkIRenderer *self,
+    _Inout_ NkDIBitmap *bmpPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(bmpPtr != NULL, NkErr_InOutParameter);
+
+    /* Get pointer to renderer structure. */
+    __NkInt_NullRenderer *rdRef = (__NkInt_NullRenderer *)self;
+
+    NkBitmapSpecification const *bmpSpecs = NkDIBitmapGetSpecification(bmpPtr);
+    if ((NkUint64)bmpSpecs->m_bmpWidth != rdRef->m_bbDim.m_width
+        || (NkUint64)bmpSpecs->m_bmpHeight != rdRef->m_bbDim.m_height
+        || bmpSpecs->m_bitsPerPx != 32
+    ) return NkErr_InvImageDimensions;
+
+    /* Same as above; the whole pixel array is filled with the clear color. */
+    NkRgbaColor const clearCol = rdRef->m_currSpec.m_clearCol;
+    NkPixelFill32(
+        NkDIBitmapGetPixels(bmpPtr, NULL),
+        (NkSize)bmpSpecs->m_bmpStride / 4 * (NkSize)bmpSpecs->m_bmpHeight,
+        0xFF000000 | (NkUint32)clearCol.m_rVal << 16 | (NkUint32)clearCol.m_gVal << 8 | (NkUint32)clearCol.m_bVal
+    );
+    return NkErr_Ok;
+}
+
+
+/**
+ * \brief VTable for the NkINullRenderer class
+ */
+NKOM_DEFINE_VTABLE(NkIRenderer) {
+    .QueryInterface          = &__NkInt_NullRenderer_QueryInterface,
+    .AddRef                  = &__NkInt_NullRenderer_AddRef,
+    .Release                 = &__NkInt_NullRenderer_Release,
+    .Initialize              = &__NkInt_NullRenderer_Initialize,
+    .QueryRendererApi        = &__NkInt_NullRenderer_QueryRendererApi,
+    .QuerySpecification      = &__NkInt_NullRenderer_QuerySpecification,
+    .QueryWindow             = &__NkInt_NullRenderer_QueryWindow,
+    .QueryViewportDimensions = &__NkInt_NullRenderer_QueryViewportDimensions,
+    .QueryFrameStatistics    = &__NkInt_NullRenderer_QueryFrameStatistics,
+    .Resize                  = &__NkInt_NullRenderer_Resize,
+    .BeginDraw               = &__NkInt_NullRenderer_BeginDraw,
+    .EndDraw                 = &__NkInt_NullRenderer_EndDraw,
+    .SetStaticRegions        = &__NkInt_NullRenderer_SetStaticRegions,
+    .InvalidateFrame         = &__NkInt_NullRenderer_InvalidateFrame,
+    .DrawTexture             = &__NkInt_NullRenderer_DrawTexture,
+    .DrawTextureBatch        = &__NkInt_NullRenderer_DrawTextureBatch,
+    .DrawMaskedTexture       = &__NkInt_NullRenderer_DrawMaskedTexture,
+    .SetRenderTarget         = &__NkInt_NullRenderer_SetRenderTarget,
+    .ScrollSurface           = &__NkInt_NullRenderer_ScrollSurface,
+    .CreateTexture           = &__NkInt_NullRenderer_CreateTexture,
+    .CreateAlphaTexture      = &__NkInt_NullRenderer_CreateAlphaTexture,
+    .CreateTextureMask       = &__NkInt_NullRenderer_CreateTextureMask,
+    .CreateSurface           = &__NkInt_NullRenderer_CreateSurface,
+    .DeleteResource          = &__NkInt_NullRenderer_DeleteResource,
+    .GrabFramebuffer         = &__NkInt_NullRenderer_GrabFramebuffer,
+    .CopyFramebuffer         = &__NkInt_NullRenderer_CopyFramebuffer
+};
+
+/**
+ * \brief defines the implementation details of the null renderer class (for exposure
+ *        to the global renderer factory)
+ */
+NkOMImplementationInfo const __gl_NullRdImplInfo__ = {
+    .mp_uuidRef       = NKOM_CLSIDOF(NkINullRenderer),
+    .m_structSize     = sizeof(__NkInt_NullRenderer),
+    .m_isAggSupported = NK_FALSE,
+    .mp_vtabPtr       = (NkVoid *)&NKOM_VTABLEOF(NkIRenderer)
+};
+/** \endcond */
+
+
+#undef NK_NAMESPACE
+
+
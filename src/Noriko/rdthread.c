@@ -0,0 +1,958 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  rdthread.c
+ * \brief implements the render-thread proxy renderer
+ *
+ * The proxy implements \c NkIRenderer on top of an existing renderer. Draw calls issued
+ * between <tt>BeginDraw()</tt> and <tt>EndDraw()</tt> are not executed right away but
+ * recorded into one of two command buffers. <tt>EndDraw()</tt> hands the buffer to the
+ * render thread, which replays it on the wrapped renderer (including presenting), while
+ * the calling thread returns and starts simulating and recording the next frame into the
+ * other buffer. The calling thread only waits if the render thread has not finished the
+ * previous frame yet.
+ *
+ * All other methods touch the wrapped renderer directly from the calling thread, but
+ * only after the render thread has become idle (see <tt>__NkInt_RdThread_Drain()</tt>).
+ * Consequently, the wrapped renderer is never used by two threads at the same time, and
+ * all references to it are still taken and released by the calling thread. Resources
+ * that are deleted while a frame is recorded are kept alive until the render thread has
+ * replayed every draw that may use them.
+ */
+#define NK_NAMESPACE "nk::rdthread"
+
+
+/* stdlib includes */
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/renderer.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/log.h>
+#include <include/Noriko/profiler.h>
+
+
+#if (defined NK_TARGET_MULTITHREADED)
+/** \cond INTERNAL */
+/**
+ * \enum  __NkInt_RdCommandType
+ * \brief lists the draw calls that can be recorded
+ */
+NK_NATIVE typedef enum __NkInt_RdCommandType {
+    __NkInt_RdCmd_DrawTexture,       /**< <tt>NkIRenderer::DrawTexture()</tt> */
+    __NkInt_RdCmd_DrawTextureBatch,  /**< <tt>NkIRenderer::DrawTextureBatch()</tt> */
+    __NkInt_RdCmd_DrawMaskedTexture, /**< <tt>NkIRenderer::DrawMaskedTexture()</tt> */
+    __NkInt_RdCmd_SetRenderTarget,   /**< <tt>NkIRenderer::SetRenderTarget()</tt> */
+    __NkInt_RdCmd_ScrollSurface      /**< <tt>NkIRenderer::ScrollSurface()</tt> */
+} __NkInt_RdCommandType;
+
+/**
+ * \struct __NkInt_RdCommand
+ * \brief  represents a single recorded draw call
+ *
+ * Rectangles of batched draws are stored in the rectangle array of the command buffer,
+ * all destination rectangles first, followed by all source rectangles, if any.
+ */
+NK_NATIVE typedef struct __NkInt_RdCommand {
+    __NkInt_RdCommandType     m_cmdType; /**< type of the draw call */
+    NkRendererResource const *mp_resPtr; /**< texture, surface or render target (may be NULL) */
+
+    union {
+        struct {
+            NkRectF   m_dstRect;   /**< destination rectangle */
+            NkRectF   m_srcRect;   /**< source rectangle */
+            NkBoolean m_hasSrc;    /**< whether \c m_srcRect is used */
+        } m_drawTex;
+        struct {
+            NkSize    m_firstRect; /**< index of the first destination rectangle */
+            NkSize    m_count;     /**< number of texture portions */
+            NkBoolean m_hasSrc;    /**< whether source rectangles follow the destination rectangles */
+        } m_drawBatch;
+        struct {
+            NkRectF                   m_dstRect; /**< destination rectangle */
+            NkVec2F                   m_srcOff;  /**< offset in the texture */
+            NkRendererResource const *mp_maskPtr; /**< transparency mask */
+            NkVec2F                   m_maskOff; /**< offset in the mask */
+        } m_drawMasked;
+        NkPoint2D m_scrollOff; /**< scroll offset of <tt>ScrollSurface()</tt> */
+    };
+} __NkInt_RdCommand;
+
+/**
+ * \struct __NkInt_RdCommandBuffer
+ * \brief  represents the draw calls recorded for a single frame
+ */
+NK_NATIVE typedef struct __NkInt_RdCommandBuffer {
+    __NkInt_RdCommand   *mp_cmdArr;  /**< recorded draw calls */
+    NkSize               m_nCmds;    /**< number of elements in \c mp_cmdArr */
+    NkSize               m_cmdCap;   /**< capacity of \c mp_cmdArr, in elements */
+    NkRectF             *mp_rectArr; /**< rectangles of batched draws */
+    NkSize               m_nRects;   /**< number of elements in \c mp_rectArr */
+    NkSize               m_rectCap;  /**< capacity of \c mp_rectArr, in elements */
+    NkRendererResource **mp_delArr;  /**< resources deleted while the frame was recorded */
+    NkSize               m_nDels;    /**< number of elements in \c mp_delArr */
+    NkSize               m_delCap;   /**< capacity of \c mp_delArr, in elements */
+} __NkInt_RdCommandBuffer;
+
+/**
+ * \class __NkInt_ThreadedRenderer
+ * \brief represents the instance-specific internal state of the render-thread proxy
+ */
+NK_NATIVE typedef struct __NkInt_ThreadedRenderer {
+    NKOM_IMPLEMENTS(NkIRenderer);
+
+    NkOMRefCount             m_refCount;  /**< reference count */
+    NkIRenderer             *mp_rdRef;    /**< wrapped renderer */
+    __NkInt_RdCommandBuffer  m_bufArr[2]; /**< command buffers */
+    NkUint32                 m_recInd;    /**< index of the buffer the calling thread records into */
+    NkBoolean                m_isInFrame; /**< whether the calling thread is between BeginDraw() and EndDraw() */
+
+    /* The following fields are guarded by 'm_mtxLock'. */
+    NkBoolean                 m_isPending;   /**< whether a buffer has been submitted, but not taken yet */
+    NkBoolean                 m_isBusy;      /**< whether the render thread is replaying a buffer */
+    NkBoolean                 m_isShutdown;  /**< whether the render thread should exit */
+    NkUint32                  m_pendInd;     /**< index of the submitted buffer */
+    NkBoolean                 m_isResized;   /**< whether \c m_reqDim must be applied before the next frame */
+    NkSize2D                  m_reqDim;      /**< requested client area dimensions */
+    NkBoolean                 m_isInvalid;   /**< whether the next frame must present the entire back buffer */
+    NkErrorCode               m_lastErr;     /**< first error reported while replaying the last frame */
+    NkSize2D                  m_vpDim;       /**< viewport dimensions after the last frame */
+    NkRendererFrameStatistics m_lastStats;   /**< statistics of the last replayed frame */
+
+    thrd_t      m_rdThrd;  /**< render thread */
+    cnd_t       m_workCnd; /**< signaled when a buffer was submitted or on shutdown */
+    cnd_t       m_doneCnd; /**< signaled when the render thread has replayed a buffer */
+    NK_DECL_LOCK(m_mtxLock);
+} __NkInt_ThreadedRenderer;
+
+
+/**
+ * \brief  grows an array of a command buffer so that it can hold at least the given
+ *         number of elements
+ * \param  [in, out] arrPtr pointer to the array
+ * \param  [in, out] capPtr pointer to the capacity of the array, in elements
+ * \param  [in] elemSize size of one element, in bytes
+ * \param  [in] minCap required capacity, in elements
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_RdThread_Reserve(
+    _Inout_ NkVoid **arrPtr,
+    _Inout_ NkSize *capPtr,
+    _In_    NkSize elemSize,
+    _In_    NkSize minCap
+) {
+    if (minCap <= *capPtr)
+        return NkErr_Ok;
+
+    NkSize newCap = NK_MAX(*capPtr * 2, (NkSize)256);
+    while (newCap < minCap)
+        newCap *= 2;
+
+    NkErrorCode const errCode = *arrPtr == NULL
+        ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * elemSize, 0, NK_FALSE, arrPtr)
+        : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * elemSize, arrPtr);
+    if (errCode == NkErr_Ok)
+        *capPtr = newCap;
+    return errCode;
+}
+
+/**
+ * \brief  appends a command to the buffer that is currently recorded
+ * \param  [in, out] rdRef pointer to the proxy
+ * \param  [in] cmdPtr pointer to the command
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_RdThread_Record(
+    _Inout_ __NkInt_ThreadedRenderer *rdRef,
+    _In_    __NkInt_RdCommand const *cmdPtr
+) {
+    NK_ASSERT(rdRef->m_isInFrame, NkErr_ObjectState);
+
+    __NkInt_RdCommandBuffer *bufPtr = &rdRef->m_bufArr[rdRef->m_recInd];
+    NkErrorCode const errCode = __NkInt_RdThread_Reserve(
+        (NkVoid **)&bufPtr->mp_cmdArr,
+        &bufPtr->m_cmdCap,
+        sizeof *bufPtr->mp_cmdArr,
+        bufPtr->m_nCmds + 1
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    bufPtr->mp_cmdArr[bufPtr->m_nCmds++] = *cmdPtr;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  replays the commands of a buffer on the wrapped renderer
+ * \param  [in, out] rdRef pointer to the proxy
+ * \param  [in] bufPtr pointer to the buffer that is to be replayed
+ * \return first error reported by the wrapped renderer, or \c NkErr_Ok
+ */
+NK_INTERNAL NkErrorCode __NkInt_RdThread_Replay(
+    _Inout_ __NkInt_ThreadedRenderer *rdRef,
+    _In_    __NkInt_RdCommandBuffer const *bufPtr
+) {
+    NkIRenderer *realRd = rdRef->mp_rdRef;
+    NkErrorCode  resErr = realRd->VT->BeginDraw(realRd);
+    if (resErr != NkErr_Ok)
+        return resErr;
+
+    for (NkSize i = 0; i < bufPtr->m_nCmds; i++) {
+        __NkInt_RdCommand const *cmdPtr = &bufPtr->mp_cmdArr[i];
+
+        NkErrorCode errCode = NkErr_Ok;
+        switch (cmdPtr->m_cmdType) {
+            case __NkInt_RdCmd_DrawTexture:
+                errCode = realRd->VT->DrawTexture(
+                    realRd,
+                    &cmdPtr->m_drawTex.m_dstRect,
+                    cmdPtr->mp_resPtr,
+                    cmdPtr->m_drawTex.m_hasSrc ? &cmdPtr->m_drawTex.m_srcRect : NULL
+                );
+
+                break;
+            case __NkInt_RdCmd_DrawTextureBatch: {
+                NkRectF const *dstRects = &bufPtr->mp_rectArr[cmdPtr->m_drawBatch.m_firstRect];
+
+                errCode = realRd->VT->DrawTextureBatch(
+                    realRd,
+                    cmdPtr->mp_resPtr,
+                    cmdPtr->m_drawBatch.m_count,
+                    dstRects,
+                    cmdPtr->m_drawBatch.m_hasSrc ? dstRects + cmdPtr->m_drawBatch.m_count : NULL
+                );
+
+                break;
+            }
+            case __NkInt_RdCmd_DrawMaskedTexture:
+                errCode = realRd->VT->DrawMaskedTexture(
+                    realRd,
+                    &cmdPtr->m_drawMasked.m_dstRect,
+                    cmdPtr->mp_resPtr,
+                    cmdPtr->m_drawMasked.m_srcOff,
+                    cmdPtr->m_drawMasked.mp_maskPtr,
+                    cmdPtr->m_drawMasked.m_maskOff
+                );
+
+                break;
+            case __NkInt_RdCmd_SetRenderTarget:
+                errCode = realRd->VT->SetRenderTarget(realRd, cmdPtr->mp_resPtr);
+
+                break;
+            case __NkInt_RdCmd_ScrollSurface:
+                errCode = realRd->VT->ScrollSurface(realRd, cmdPtr->mp_resPtr, cmdPtr->m_scrollOff);
+
+                break;
+        }
+        if (resErr == NkErr_Ok)
+            resErr = errCode;
+    }
+
+    NkErrorCode const errCode = realRd->VT->EndDraw(realRd);
+    return resErr == NkErr_Ok ? errCode : resErr;
+}
+
+/**
+ * \brief  entry point of the render thread
+ * \param  [in, out] paramPtr pointer to the proxy
+ * \return always \c 0
+ */
+NK_INTERNAL int __NkInt_RdThread_ThreadProc(_Inout_ NkVoid *paramPtr) {
+    __NkInt_ThreadedRenderer *rdRef  = (__NkInt_ThreadedRenderer *)paramPtr;
+    NkIRenderer              *realRd = rdRef->mp_rdRef;
+
+    for (;;) {
+        NK_LOCK(rdRef->m_mtxLock);
+        while (!rdRef->m_isPending && !rdRef->m_isShutdown)
+            cnd_wait(&rdRef->m_workCnd, &rdRef->m_mtxLock);
+        if (!rdRef->m_isPending) {
+            NK_UNLOCK(rdRef->m_mtxLock);
+
+            break;
+        }
+
+        /* Take the submitted buffer along with the state changes requested since. */
+        __NkInt_RdCommandBuffer const *bufPtr = &rdRef->m_bufArr[rdRef->m_pendInd];
+        NkBoolean const isResized = rdRef->m_isResized;
+        NkBoolean const isInvalid = rdRef->m_isInvalid;
+        NkSize2D const  reqDim    = rdRef->m_reqDim;
+        rdRef->m_isPending = NK_FALSE;
+        rdRef->m_isBusy    = NK_TRUE;
+        rdRef->m_isResized = NK_FALSE;
+        rdRef->m_isInvalid = NK_FALSE;
+        NK_UNLOCK(rdRef->m_mtxLock);
+
+        NkErrorCode errCode = NkErr_Ok;
+        NkRendererFrameStatistics frameStats = { .m_structSize = sizeof frameStats };
+        NK_PROFILE_SCOPE("RenderThread") {
+            if (isResized)
+                errCode = realRd->VT->Resize(realRd, reqDim);
+            if (isInvalid)
+                realRd->VT->InvalidateFrame(realRd);
+
+            NkErrorCode const drawErr = __NkInt_RdThread_Replay(rdRef, bufPtr);
+            if (errCode == NkErr_Ok)
+                errCode = drawErr;
+            realRd->VT->QueryFrameStatistics(realRd, &frameStats);
+        }
+        NkSize2D const vpDim = realRd->VT->QueryViewportDimensions(realRd);
+
+        NK_LOCK(rdRef->m_mtxLock);
+        rdRef->m_lastStats = frameStats;
+        rdRef->m_vpDim     = vpDim;
+        rdRef->m_isBusy    = NK_FALSE;
+        if (rdRef->m_lastErr == NkErr_Ok)
+            rdRef->m_lastErr = errCode;
+        cnd_broadcast(&rdRef->m_doneCnd);
+        NK_UNLOCK(rdRef->m_mtxLock);
+    }
+
+    NkAllocReleaseThreadCache();
+    return 0;
+}
+
+/**
+ * \brief  waits until the render thread has replayed every submitted buffer
+ * \param  [in, out] rdRef pointer to the proxy
+ * \return first error reported while replaying the last frame, or \c NkErr_Ok
+ * \note   Once this function returns, the render thread stays idle until the calling
+ *         thread submits the next buffer, so the wrapped renderer can be used directly.
+ */
+NK_INTERNAL NkErrorCode __NkInt_RdThread_Drain(_Inout_ __NkInt_ThreadedRenderer *rdRef) {
+    NK_LOCK(rdRef->m_mtxLock);
+    while (rdRef->m_isPending || rdRef->m_isBusy)
+        cnd_wait(&rdRef->m_doneCnd, &rdRef->m_mtxLock);
+
+    NkErrorCode const errCode = rdRef->m_lastErr;
+    rdRef->m_lastErr = NkErr_Ok;
+    NK_UNLOCK(rdRef->m_mtxLock);
+
+    return errCode;
+}
+
+/**
+ * \brief deletes the resources that were deleted while the given buffer was recorded
+ * \param [in, out] rdRef pointer to the proxy
+ * \param [in, out] bufPtr pointer to a buffer that is not used by the render thread
+ */
+NK_INTERNAL NkVoid __NkInt_RdThread_FlushDeletes(
+    _Inout_ __NkInt_ThreadedRenderer *rdRef,
+    _Inout_ __NkInt_RdCommandBuffer *bufPtr
+) {
+    for (NkSize i = 0; i < bufPtr->m_nDels; i++)
+        NK_IGNORE_RETURN_VALUE(rdRef->mp_rdRef->VT->DeleteResource(rdRef->mp_rdRef, &bufPtr->mp_delArr[i]));
+
+    bufPtr->m_nDels = 0;
+}
+
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_ThreadedRenderer_AddRef(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return NkOMRefCountIncrement(&((__NkInt_ThreadedRenderer *)self)->m_refCount, NkOMRcMd_ThreadLocal);
+}
+
+/**
+ */
+NK_INTERNAL NkOMRefCount NK_CALL __NkInt_ThreadedRenderer_Release(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NkOMRefCount const newCount = NkOMRefCountDecrement(&rdRef->m_refCount, NkOMRcMd_ThreadLocal);
+    if (newCount <= 0) {
+        NK_LOG_INFO("shutdown: render thread");
+
+        /* Let the render thread finish the last frame, then stop it. */
+        NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+        NK_SYNCHRONIZED(rdRef->m_mtxLock, {
+            rdRef->m_isShutdown = NK_TRUE;
+
+            cnd_signal(&rdRef->m_workCnd);
+        });
+        thrd_join(rdRef->m_rdThrd, NULL);
+
+        for (NkSize i = 0; i < NK_ARRAYSIZE(rdRef->m_bufArr); i++) {
+            __NkInt_RdThread_FlushDeletes(rdRef, &rdRef->m_bufArr[i]);
+
+            NkGPFree(rdRef->m_bufArr[i].mp_cmdArr);
+            NkGPFree(rdRef->m_bufArr[i].mp_rectArr);
+            NkGPFree(rdRef->m_bufArr[i].mp_delArr);
+        }
+        cnd_destroy(&rdRef->m_doneCnd);
+        cnd_destroy(&rdRef->m_workCnd);
+        NK_DESTROYLOCK(rdRef->m_mtxLock);
+
+        rdRef->mp_rdRef->VT->Release(rdRef->mp_rdRef);
+        NkGPFree((NkVoid *)rdRef);
+        return 0;
+    }
+
+    return newCount;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_QueryInterface(
+    _Inout_  NkIRenderer *self,
+    _In_     NkUuid const *iId,
+    _Outptr_ NkVoid **resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(iId != NULL, NkErr_InParameter);
+    NK_ASSERT(resPtr != NULL, NkErr_OutptrParameter);
+
+    /*
+     * Interfaces of the wrapped renderer are not handed out; calling it directly would
+     * race against the render thread.
+     */
+    NK_INTERNAL NkOMImplementationInfo const gl_ImplInfos[] = {
+        { NKOM_IIDOF(NkIBase)     },
+        { NKOM_IIDOF(NkIRenderer) },
+        { NULL                    }
+    };
+    if (NkOMQueryImplementationIndex(gl_ImplInfos, iId) != SIZE_MAX) {
+        *resPtr = (NkVoid *)self;
+
+        __NkInt_ThreadedRenderer_AddRef(self);
+        return NkErr_Ok;
+    }
+
+    *resPtr = NULL;
+    return NkErr_InterfaceNotImpl;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_Initialize(
+    _Inout_     NkIRenderer *self,
+    _Inout_opt_ NkVoid *initParam
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(initParam);
+
+    /* The proxy is initialized by NkRendererCreateThreadProxy(). */
+    return NkErr_ObjectState;
+}
+
+/**
+ */
+NK_INTERNAL NkRendererApi NK_CALL __NkInt_ThreadedRenderer_QueryRendererApi(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    NkIRenderer *realRd = ((__NkInt_ThreadedRenderer *)self)->mp_rdRef;
+    return realRd->VT->QueryRendererApi(realRd);
+}
+
+/**
+ */
+NK_INTERNAL NkRendererSpecification const *NK_CALL __NkInt_ThreadedRenderer_QuerySpecification(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    NkIRenderer *realRd = ((__NkInt_ThreadedRenderer *)self)->mp_rdRef;
+    return realRd->VT->QuerySpecification(realRd);
+}
+
+/**
+ */
+NK_INTERNAL NkIWindow *NK_CALL __NkInt_ThreadedRenderer_QueryWindow(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    NkIRenderer *realRd = ((__NkInt_ThreadedRenderer *)self)->mp_rdRef;
+    return realRd->VT->QueryWindow(realRd);
+}
+
+/**
+ */
+NK_INTERNAL NkSize2D NK_CALL __NkInt_ThreadedRenderer_QueryViewportDimensions(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NkSize2D vpDim;
+    NK_SYNCHRONIZED(rdRef->m_mtxLock, vpDim = rdRef->m_vpDim);
+    return vpDim;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_ThreadedRenderer_QueryFrameStatistics(
+    _Inout_ NkIRenderer *self,
+    _Out_   NkRendererFrameStatistics *statPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(statPtr != NULL, NkErr_OutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_SYNCHRONIZED(rdRef->m_mtxLock, *statPtr = rdRef->m_lastStats);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_Resize(
+    _Inout_ NkIRenderer *self,
+    _In_    NkSize2D clAreaSize
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    /* Applied by the render thread before it replays the next frame. */
+    NK_SYNCHRONIZED(rdRef->m_mtxLock, {
+        rdRef->m_reqDim    = clAreaSize;
+        rdRef->m_isResized = NK_TRUE;
+    });
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_BeginDraw(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+    if (rdRef->m_isInFrame)
+        return NkErr_ObjectState;
+
+    /*
+     * The buffer was replayed two frames ago and its deferred deletions were carried out
+     * in the last EndDraw(), so it can simply be reset.
+     */
+    __NkInt_RdCommandBuffer *bufPtr = &rdRef->m_bufArr[rdRef->m_recInd];
+    bufPtr->m_nCmds  = 0;
+    bufPtr->m_nRects = 0;
+
+    rdRef->m_isInFrame = NK_TRUE;
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_EndDraw(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+    if (!rdRef->m_isInFrame)
+        return NkErr_ObjectState;
+
+    /* Wait for the previous frame; this is where a slow GPU or VSync throttles the game. */
+    NkErrorCode errCode = NkErr_Ok;
+    NK_PROFILE_SCOPE("WaitRenderThread")
+        errCode = __NkInt_RdThread_Drain(rdRef);
+
+    /* The previous frame has been replayed, so its deleted resources are unused now. */
+    NkUint32 const recInd = rdRef->m_recInd;
+    __NkInt_RdThread_FlushDeletes(rdRef, &rdRef->m_bufArr[recInd ^ 1]);
+
+    NK_SYNCHRONIZED(rdRef->m_mtxLock, {
+        rdRef->m_pendInd   = recInd;
+        rdRef->m_isPending = NK_TRUE;
+
+        cnd_signal(&rdRef->m_workCnd);
+    });
+    rdRef->m_recInd    = recInd ^ 1;
+    rdRef->m_isInFrame = NK_FALSE;
+    return errCode;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_SetStaticRegions(
+    _Inout_          NkIRenderer *self,
+    _In_             NkSize count,
+    _I_array_(count) NkRectF const *rects,
+    _Out_opt_        NkBoolean *isPreservedPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(count);
+    NK_UNREFERENCED_PARAMETER(rects);
+
+    /*
+     * Whether the regions are preserved is only known once the render thread begins the
+     * frame, long after the caller had to decide whether to draw them. Hence, callers are
+     * told to redraw every frame.
+     */
+    if (isPreservedPtr != NULL)
+        *isPreservedPtr = NK_FALSE;
+    return NkErr_NotImplemented;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_ThreadedRenderer_InvalidateFrame(_Inout_ NkIRenderer *self) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_SYNCHRONIZED(rdRef->m_mtxLock, rdRef->m_isInvalid = NK_TRUE);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_DrawTexture(
+    _Inout_  NkIRenderer *self,
+    _In_     NkRectF const *dstRect,
+    _In_     NkRendererResource const *texPtr,
+    _In_opt_ NkRectF const *srcRect
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+    NK_ASSERT(texPtr != NULL, NkErr_InParameter);
+
+    return __NkInt_RdThread_Record((__NkInt_ThreadedRenderer *)self, &(__NkInt_RdCommand const){
+        .m_cmdType = __NkInt_RdCmd_DrawTexture,
+        .mp_resPtr = texPtr,
+        .m_drawTex = {
+            .m_dstRect = *dstRect,
+            .m_srcRect = srcRect != NULL ? *srcRect : (NkRectF){ 0.f },
+            .m_hasSrc  = srcRect != NULL
+        }
+    });
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_DrawTextureBatch(
+    _Inout_              NkIRenderer *self,
+    _In_                 NkRendererResource const *texPtr,
+    _In_                 NkSize count,
+    _I_array_(count)     NkRectF const *dstRects,
+    _I_array_opt_(count) NkRectF const *srcRects
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(texPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(count == 0 || dstRects != NULL, NkErr_InParameter);
+
+    __NkInt_ThreadedRenderer *rdRef  = (__NkInt_ThreadedRenderer *)self;
+    __NkInt_RdCommandBuffer  *bufPtr = &rdRef->m_bufArr[rdRef->m_recInd];
+    if (count == 0)
+        return NkErr_Ok;
+
+    /* Copy the rectangles; the caller may reuse its arrays as soon as we return. */
+    NkSize const nRects  = srcRects != NULL ? 2 * count : count;
+    NkErrorCode  errCode = __NkInt_RdThread_Reserve(
+        (NkVoid **)&bufPtr->mp_rectArr,
+        &bufPtr->m_rectCap,
+        sizeof *bufPtr->mp_rectArr,
+        bufPtr->m_nRects + nRects
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkSize const firstRect = bufPtr->m_nRects;
+    memcpy(&bufPtr->mp_rectArr[firstRect], dstRects, count * sizeof *dstRects);
+    if (srcRects != NULL)
+        memcpy(&bufPtr->mp_rectArr[firstRect + count], srcRects, count * sizeof *srcRects);
+
+    errCode = __NkInt_RdThread_Record(rdRef, &(__NkInt_RdCommand const){
+        .m_cmdType   = __NkInt_RdCmd_DrawTextureBatch,
+        .mp_resPtr   = texPtr,
+        .m_drawBatch = {
+            .m_firstRect = firstRect,
+            .m_count     = count,
+            .m_hasSrc    = srcRects != NULL
+        }
+    });
+    if (errCode == NkErr_Ok)
+        bufPtr->m_nRects += nRects;
+    return errCode;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_DrawMaskedTexture(
+    _Inout_ NkIRenderer *self,
+    _In_    NkRectF const *dstRect,
+    _In_    NkRendererResource const *texPtr,
+    _In_    NkVec2F srcOff,
+    _In_    NkRendererResource const *maskPtr,
+    _In_    NkVec2F maskOff
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+    NK_ASSERT(texPtr != NULL && maskPtr != NULL, NkErr_InParameter);
+
+    return __NkInt_RdThread_Record((__NkInt_ThreadedRenderer *)self, &(__NkInt_RdCommand const){
+        .m_cmdType    = __NkInt_RdCmd_DrawMaskedTexture,
+        .mp_resPtr    = texPtr,
+        .m_drawMasked = {
+            .m_dstRect  = *dstRect,
+            .m_srcOff   = srcOff,
+            .mp_maskPtr = maskPtr,
+            .m_maskOff  = maskOff
+        }
+    });
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_SetRenderTarget(
+    _Inout_  NkIRenderer *self,
+    _In_opt_ NkRendererResource const *surfPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    return __NkInt_RdThread_Record((__NkInt_ThreadedRenderer *)self, &(__NkInt_RdCommand const){
+        .m_cmdType = __NkInt_RdCmd_SetRenderTarget,
+        .mp_resPtr = surfPtr
+    });
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_ScrollSurface(
+    _Inout_ NkIRenderer *self,
+    _In_    NkRendererResource const *surfPtr,
+    _In_    NkPoint2D scrollOff
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(surfPtr != NULL, NkErr_InParameter);
+
+    return __NkInt_RdThread_Record((__NkInt_ThreadedRenderer *)self, &(__NkInt_RdCommand const){
+        .m_cmdType   = __NkInt_RdCmd_ScrollSurface,
+        .mp_resPtr   = surfPtr,
+        .m_scrollOff = scrollOff
+    });
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_CreateTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+    return rdRef->mp_rdRef->VT->CreateTexture(rdRef->mp_rdRef, dibPtr, resourcePtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_CreateAlphaTexture(
+    _Inout_        NkIRenderer *self,
+    _In_           NkDIBitmap const *dibPtr,
+    _In_opt_       NkRgbaColor const *colKey,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+    return rdRef->mp_rdRef->VT->CreateAlphaTexture(rdRef->mp_rdRef, dibPtr, colKey, resourcePtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_CreateTextureMask(
+    _Inout_        NkIRenderer *self,
+    _In_           NkRendererResource const *texPtr,
+    _In_           NkRgbaColor colKey,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+    return rdRef->mp_rdRef->VT->CreateTextureMask(rdRef->mp_rdRef, texPtr, colKey, resourcePtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_CreateSurface(
+    _Inout_        NkIRenderer *self,
+    _In_           NkSize2D surfDim,
+    _Maybe_reinit_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+    return rdRef->mp_rdRef->VT->CreateSurface(rdRef->mp_rdRef, surfDim, resourcePtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_DeleteResource(
+    _Inout_      NkIRenderer *self,
+    _Uninit_ptr_ NkRendererResource **resourcePtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_ASSERT(resourcePtr != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+    if (*resourcePtr == NULL)
+        return NkErr_Ok;
+
+    if (rdRef->m_isInFrame) {
+        /* Draws recorded this frame may still use the resource; delete it later. */
+        __NkInt_RdCommandBuffer *bufPtr = &rdRef->m_bufArr[rdRef->m_recInd];
+
+        NkErrorCode const errCode = __NkInt_RdThread_Reserve(
+            (NkVoid **)&bufPtr->mp_delArr,
+            &bufPtr->m_delCap,
+            sizeof *bufPtr->mp_delArr,
+            bufPtr->m_nDels + 1
+        );
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        bufPtr->mp_delArr[bufPtr->m_nDels++] = *resourcePtr;
+        *resourcePtr = NULL;
+        return NkErr_Ok;
+    }
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+    return rdRef->mp_rdRef->VT->DeleteResource(rdRef->mp_rdRef, resourcePtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_GrabFramebuffer(
+    _Inout_ NkIRenderer *self,
+    _Out_   NkDIBitmap *resPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+    return rdRef->mp_rdRef->VT->GrabFramebuffer(rdRef->mp_rdRef, resPtr);
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_ThreadedRenderer_CopyFramebuffer(
+    _Inout_ NkIRenderer *self,
+    _Inout_ NkDIBitmap *bmpPtr
+) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
+
+    __NkInt_ThreadedRenderer *rdRef = (__NkInt_ThreadedRenderer *)self;
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_RdThread_Drain(rdRef));
+    return rdRef->mp_rdRef->VT->CopyFramebuffer(rdRef->mp_rdRef, bmpPtr);
+}
+
+
+/**
+ * \brief virtual function table of the render-thread proxy
+ */
+NKOM_DEFINE_VTABLE(NkIRenderer) {
+    .QueryInterface          = &__NkInt_ThreadedRenderer_QueryInterface,
+    .AddRef                  = &__NkInt_ThreadedRenderer_AddRef,
+    .Release                 = &__NkInt_ThreadedRenderer_Release,
+    .Initialize              = &__NkInt_ThreadedRenderer_Initialize,
+    .QueryRendererApi        = &__NkInt_ThreadedRenderer_QueryRendererApi,
+    .QuerySpecification      = &__NkInt_ThreadedRenderer_QuerySpecification,
+    .QueryWindow             = &__NkInt_ThreadedRenderer_QueryWindow,
+    .QueryViewportDimensions = &__NkInt_ThreadedRenderer_QueryViewportDimensions,
+    .QueryFrameStatistics    = &__NkInt_ThreadedRenderer_QueryFrameStatistics,
+    .Resize                  = &__NkInt_ThreadedRenderer_Resize,
+    .BeginDraw               = &__NkInt_ThreadedRenderer_BeginDraw,
+    .EndDraw                 = &__NkInt_ThreadedRenderer_EndDraw,
+    .SetStaticRegions        = &__NkInt_ThreadedRenderer_SetStaticRegions,
+    .InvalidateFrame         = &__NkInt_ThreadedRenderer_InvalidateFrame,
+    .DrawTexture             = &__NkInt_ThreadedRenderer_DrawTexture,
+    .DrawTextureBatch        = &__NkInt_ThreadedRenderer_DrawTextureBatch,
+    .DrawMaskedTexture       = &__NkInt_ThreadedRenderer_DrawMaskedTexture,
+    .SetRenderTarget         = &__NkInt_ThreadedRenderer_SetRenderTarget,
+    .ScrollSurface           = &__NkInt_ThreadedRenderer_ScrollSurface,
+    .CreateTexture           = &__NkInt_ThreadedRenderer_CreateTexture,
+    .CreateAlphaTexture      = &__NkInt_ThreadedRenderer_CreateAlphaTexture,
+    .CreateTextureMask       = &__NkInt_ThreadedRenderer_CreateTextureMask,
+    .CreateSurface           = &__NkInt_ThreadedRenderer_CreateSurface,
+    .DeleteResource          = &__NkInt_ThreadedRenderer_DeleteResource,
+    .GrabFramebuffer         = &__NkInt_ThreadedRenderer_GrabFramebuffer,
+    .CopyFramebuffer         = &__NkInt_ThreadedRenderer_CopyFramebuffer
+};
+/** \endcond */
+#endif
+
+
+_Return_ok_ NkErrorCode NK_CALL NkRendererCreateThreadProxy(
+    _Inout_  NkIRenderer *rdRef,
+    _Outptr_ NkIRenderer **proxyPtr
+) {
+    NK_ASSERT(rdRef != NULL, NkErr_InOutParameter);
+    NK_ASSERT(proxyPtr != NULL, NkErr_OutptrParameter);
+
+#if (defined NK_TARGET_MULTITHREADED)
+    __NkInt_ThreadedRenderer *actProxy;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *actProxy, 0, NK_TRUE, (NkVoid **)&actProxy);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    actProxy->NkIRenderer_Iface.VT = &NKOM_VTABLEOF(NkIRenderer);
+    actProxy->m_refCount           = 1;
+    actProxy->mp_rdRef             = rdRef;
+    actProxy->m_vpDim              = rdRef->VT->QueryViewportDimensions(rdRef);
+    actProxy->m_lastStats          = (NkRendererFrameStatistics){ .m_structSize = sizeof actProxy->m_lastStats };
+    if (NK_INITLOCK(actProxy->m_mtxLock) != thrd_success) {
+        errCode = NkErr_SynchInit;
+
+        goto lbl_ONERRFREE;
+    }
+    if (cnd_init(&actProxy->m_workCnd) != thrd_success) {
+        errCode = NkErr_SynchInit;
+
+        goto lbl_ONERRLOCK;
+    }
+    if (cnd_init(&actProxy->m_doneCnd) != thrd_success) {
+        errCode = NkErr_SynchInit;
+
+        goto lbl_ONERRWORKCND;
+    }
+    if (thrd_create(&actProxy->m_rdThrd, &__NkInt_RdThread_ThreadProc, (NkVoid *)actProxy) != thrd_success) {
+        errCode = NkErr_CreateThread;
+
+        goto lbl_ONERRDONECND;
+    }
+
+    NK_LOG_INFO("startup: render thread");
+    rdRef->VT->AddRef(rdRef);
+    *proxyPtr = (NkIRenderer *)actProxy;
+    return NkErr_Ok;
+
+lbl_ONERRDONECND:
+    cnd_destroy(&actProxy->m_doneCnd);
+lbl_ONERRWORKCND:
+    cnd_destroy(&actProxy->m_workCnd);
+lbl_ONERRLOCK:
+    NK_DESTROYLOCK(actProxy->m_mtxLock);
+lbl_ONERRFREE:
+    NkGPFree(actProxy);
+
+    *proxyPtr = NULL;
+    return errCode;
+#else
+    /* Without threads, the renderer is used directly. */
+    rdRef->VT->AddRef(rdRef);
+
+    *proxyPtr = rdRef;
+    return NkErr_Ok;
+#endif
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -22,10 +22,14 @@
 #define NK_NAMESPACE "nk::renderer"
 
 
+/* stdlib includes */
+#include <string.h>
+
 /* Noriko includes */
 #include <include/Noriko/renderer.h>
 #include <include/Noriko/alloc.h>
 #include <include/Noriko/comp.h>
+#include <include/Noriko/pixel.h>
 
 
 /** \cond INTERNAL */
@@ -101,7 +105,13 @@ NK_INTERNAL NkUuid const **NK_CALL __NkInt_RendererFactory_QueryInstantiableClas
     /**
      * \brief lists all classes instantiable by the current factory
      */
-    NK_INTERNAL NkUuid const *gl_c_InstClasses[] = { NKOM_CLSIDOF(NkIGdiRenderer), NULL };
+    NK_INTERNAL NkUuid const *gl_c_InstClasses[] = {
+        NKOM_CLSIDOF(NkINullRenderer),
+        NKOM_CLSIDOF(NkIGdiRenderer),
+        NKOM_CLSIDOF(NkID3D11Renderer),
+
+        NULL
+    };
 
     return gl_c_InstClasses;
 }
@@ -120,18 +130,28 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_RendererFactory_CreateInstan
     NK_UNREFERENCED_PARAMETER(self);
     NK_UNREFERENCED_PARAMETER(ctrlInst);
 
+    /**
+     * \brief implementation details for the headless renderer
+     */
+    NK_EXTERN NkOMImplementationInfo const __gl_NullRdImplInfo__;
 #if (defined NK_TARGET_WINDOWS)
     /**
      * \brief implementation details for the GDI-based renderer
      */
     NK_EXTERN NkOMImplementationInfo const __gl_GdiRdImplInfo__;
+    /**
+     * \brief implementation details for the Direct3D 11-based renderer
+     */
+    NK_EXTERN NkOMImplementationInfo const __gl_D3D11RdImplInfo__;
 #endif
 
     /**
      */
     NK_INTERNAL __NkInt_ClassImplEntry const gl_InstClsTable[] = {
+        { NKOM_CLSIDOF(NkINullRenderer),  &__gl_NullRdImplInfo__  },
 #if (defined NK_TARGET_WINDOWS)
-        { NKOM_CLSIDOF(NkIGdiRenderer), &__gl_GdiRdImplInfo__ },
+        { NKOM_CLSIDOF(NkIGdiRenderer),   &__gl_GdiRdImplInfo__   },
+        { NKOM_CLSIDOF(NkID3D11Renderer), &__gl_D3D11RdImplInfo__ },
 #endif
 
         { NULL }
@@ -223,7 +243,7 @@ NkSize NK_CALL NkRendererQueryAvailablePlatformApis(_Outptr_ NkRendererApi const
     /**
      * \brief list of available renderer APIs on the windows platform 
      */
-    NK_INTERNAL NkRendererApi const gl_AvailRdApis[] = { NkRdApi_Win32GDI };
+    NK_INTERNAL NkRendererApi const gl_AvailRdApis[] = { NkRdApi_Win32GDI, NkRdApi_Direct3D11, NkRdApi_Null, NkRdApi_Win32Soft };
 
     *resPtr = gl_AvailRdApis;
     return NK_ARRAYSIZE(gl_AvailRdApis);
@@ -236,8 +256,11 @@ NkRendererApi NK_CALL NkRendererQueryDefaultPlatformApi(NkVoid) {
 NkUuid const *NK_CALL NkRendererQueryCLSIDFromApi(_In_ NkRendererApi apiIdent) {
     switch (apiIdent) {
 #if (defined NK_TARGET_WINDOWS)
-        case NkRdApi_Win32GDI: return NKOM_CLSIDOF(NkIGdiRenderer);
+        case NkRdApi_Win32GDI:
+        case NkRdApi_Win32Soft:  return NKOM_CLSIDOF(NkIGdiRenderer);
+        case NkRdApi_Direct3D11: return NKOM_CLSIDOF(NkID3D11Renderer);
 #endif /* NK_TARGET_WINDOWS */
+        case NkRdApi_Null:       return NKOM_CLSIDOF(NkINullRenderer);
     }
 
     return NULL;
@@ -248,6 +271,59 @@ NkBoolean NK_CALL NkRendererCompareRectangles(_In_ NkRectF const *r1Ptr, _In_ Nk
     return r1Ptr->m_width == r2Ptr->m_width && r1Ptr->m_height == r2Ptr->m_height;
 }
 
+NkUint64 NK_CALL NkRendererCalculateArea(_In_ NkRectF const *rectPtr) {
+    /* Clamp first; converting a negative float to an unsigned type is undefined. */
+    return (NkUint64)NK_MAX(rectPtr->m_width, 0.f) * (NkUint64)NK_MAX(rectPtr->m_height, 0.f);
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkRendererPremultiplyBitmap(
+    _In_     NkDIBitmap const *dibPtr,
+    _In_opt_ NkRgbaColor const *colKey,
+    _Outptr_ NkUint32 **pxPtr
+) {
+    NK_ASSERT(dibPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(pxPtr != NULL, NkErr_OutptrParameter);
+
+    /* Query bitmap specification. */
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(dibPtr);
+    if (bmSpecs->m_bitsPerPx != 24 && bmSpecs->m_bitsPerPx != 32)
+        return NkErr_InvBitDepth;
+    NkUint32 const width    = (NkUint32)bmSpecs->m_bmpWidth;
+    NkUint32 const height   = (NkUint32)(bmSpecs->m_bmpHeight < 0 ? -bmSpecs->m_bmpHeight : bmSpecs->m_bmpHeight);
+    NkBoolean const isBtmUp = bmSpecs->m_bmpHeight > 0;
+    /* Without an alpha mask, the fourth byte of a 32-bit pixel carries no meaning. */
+    NkBoolean const hasAlpha = bmSpecs->m_bitsPerPx == 32 && bmSpecs->m_alphaMask != 0;
+
+    NkUint32 *resPx;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)width * height * sizeof *resPx, 0, NK_FALSE, (NkVoid **)&resPx);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    NkUint32 const keyPx = colKey == NULL ? 0 : (NkUint32)colKey->m_rVal << 16 | (NkUint32)colKey->m_gVal << 8 | (NkUint32)colKey->m_bVal;
+    NkByte const *dibPx  = NkDIBitmapGetPixels(dibPtr, NULL);
+    for (NkUint32 y = 0; y < height; y++) {
+        NkByte const *srcRow = dibPx + (NkSize)(isBtmUp ? height - 1 - y : y) * bmSpecs->m_bmpStride;
+        NkUint32     *dstRow = resPx + (NkSize)y * width;
+
+        if (bmSpecs->m_bitsPerPx == 24)
+            NkPixelConvert24To32(dstRow, srcRow, width, 0xFF);
+        else if (!hasAlpha)
+            NkPixelSetAlpha32(dstRow, srcRow, width, 0xFF);
+        else
+            memcpy(dstRow, srcRow, width * sizeof *dstRow);
+
+        /* Key out pixels before premultiplying so that they end up all-zero. */
+        if (colKey != NULL)
+            for (NkUint32 x = 0; x < width; x++)
+                if ((dstRow[x] & 0x00FFFFFF) == keyPx)
+                    dstRow[x] = 0;
+        NkPixelPremultiply32(dstRow, dstRow, width);
+    }
+
+    *pxPtr = resPx;
+    return NkErr_Ok;
+}
+
 
 /** \cond INTERNAL */
 /**
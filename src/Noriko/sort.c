@@ -21,10 +21,15 @@
 #define NK_NAMESPACE "nk::util"
 
 
+/* stdlib includes */
+#include <string.h>
+
 /* Noriko includes */
 #include <include/Noriko/def.h>
 #include <include/Noriko/sort.h>
 #include <include/Noriko/platform.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/job.h>
 
 
 /** \cond INTERNAL */
@@ -75,6 +80,524 @@ NK_INTERNAL NkSize __NkInt_QuicksortSplit(
 
     return i;
 }
+
+/**
+ * \def   NK_SORT_INSERTIONTHRESHOLD
+ * \brief number of elements below which \c NkQuicksortValues() switches to insertion
+ *        sort
+ */
+#define NK_SORT_INSERTIONTHRESHOLD ((NkSize)(16))
+
+/**
+ * \brief swaps two elements of the given size
+ * \param [in,out] lPtr pointer to the first element
+ * \param [in,out] rPtr pointer to the second element
+ * \param [in] elemSize size of an element, in bytes
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_SortSwapValues(
+    _Inout_ NkByte *restrict lPtr,
+    _Inout_ NkByte *restrict rPtr,
+    _In_    NkSize elemSize
+) {
+    NkByte tmpBuf[64];
+
+    for (NkSize currOff = 0; currOff < elemSize; currOff += sizeof tmpBuf) {
+        NkSize const chunkSize = NK_MIN(sizeof tmpBuf, elemSize - currOff);
+
+        memcpy(tmpBuf, lPtr + currOff, chunkSize);
+        memcpy(lPtr + currOff, rPtr + currOff, chunkSize);
+        memcpy(rPtr + currOff, tmpBuf, chunkSize);
+    }
+}
+
+/**
+ * \brief sorts a small range of values using insertion sort
+ * \param [in,out] elemArray pointer to the first element of the range
+ * \param [in] elemSize size of an element, in bytes
+ * \param [in] nElems number of elements in the range
+ * \param [in] fnPred predicate callback used for sorting
+ */
+NK_INTERNAL NkVoid __NkInt_InsertionSortValues(
+    _Inout_ NkByte *elemArray,
+    _In_    NkSize elemSize,
+    _In_    NkSize nElems,
+    _In_    NkInt32(NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+) {
+    for (NkSize i = 1; i < nElems; i++)
+        for (NkSize j = i; j > 0 && (*fnPred)(elemArray + (j - 1) * elemSize, elemArray + j * elemSize) > 0; j--)
+            __NkInt_SortSwapValues(elemArray + (j - 1) * elemSize, elemArray + j * elemSize, elemSize);
+}
+
+
+/**
+ * \def   NK_SORT_PARTIALINSERTIONLIMIT
+ * \brief maximum number of elements the partial insertion sort may move before it gives
+ *        up on a range
+ */
+#define NK_SORT_PARTIALINSERTIONLIMIT ((NkSize)(8))
+/**
+ * \def   NK_SORT_NINTHERTHRESHOLD
+ * \brief number of elements above which the pivot is chosen as the median of three
+ *        medians ("ninther") instead of the median of three elements
+ */
+#define NK_SORT_NINTHERTHRESHOLD ((NkSize)(128))
+
+/**
+ * \struct __NkInt_SortContext
+ * \brief  describes the array that is being sorted by the introsort implementation
+ * \note   The same implementation is used for arrays of pointers and arrays of values;
+ *         for the former, the predicate receives the pointers stored in the array rather
+ *         than pointers to the array's elements.
+ */
+NK_NATIVE typedef struct __NkInt_SortContext {
+    NkSize    m_elemSize;   /**< size of an element, in bytes */
+    NkBoolean m_isPtrArray; /**< whether the elements are pointers that are to be passed to the predicate */
+    NkInt32   (NK_CALL *mp_fnPred)(NkVoid const *, NkVoid const *); /**< comparison predicate */
+} __NkInt_SortContext;
+
+/**
+ * \brief  compares two elements of the array that is being sorted
+ * \param  [in] cxtPtr sorting context
+ * \param  [in] lPtr pointer to the left element
+ * \param  [in] rPtr pointer to the right element
+ * \return return value of the predicate
+ */
+NK_INTERNAL NK_INLINE NkInt32 __NkInt_SortCompare(
+    _In_ __NkInt_SortContext const *cxtPtr,
+    _In_ NkByte const *lPtr,
+    _In_ NkByte const *rPtr
+) {
+    return cxtPtr->m_isPtrArray
+        ? (*cxtPtr->mp_fnPred)(*(NkVoid const **)lPtr, *(NkVoid const **)rPtr)
+        : (*cxtPtr->mp_fnPred)(lPtr, rPtr)
+    ;
+}
+
+/**
+ * \brief swaps two elements of the array that is being sorted
+ * \param [in] cxtPtr sorting context
+ * \param [in,out] lPtr pointer to the first element
+ * \param [in,out] rPtr pointer to the second element
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_SortSwap(
+    _In_    __NkInt_SortContext const *cxtPtr,
+    _Inout_ NkByte *lPtr,
+    _Inout_ NkByte *rPtr
+) {
+    if (cxtPtr->m_isPtrArray) {
+        NkVoid *tmpPtr = *(NkVoid **)lPtr;
+
+        *(NkVoid **)lPtr = *(NkVoid **)rPtr;
+        *(NkVoid **)rPtr = tmpPtr;
+        return;
+    }
+
+    __NkInt_SortSwapValues(lPtr, rPtr, cxtPtr->m_elemSize);
+}
+
+/**
+ * \brief  sorts the given range using insertion sort, but gives up if too many elements
+ *         have to be moved
+ * \param  [in] cxtPtr sorting context
+ * \param  [in,out] basePtr pointer to the first element of the range
+ * \param  [in] nElems number of elements in the range
+ * \param  [in] maxMoves maximum number of elements that may be moved; \c SIZE_MAX for
+ *              no limit
+ * \return \c NK_TRUE if the range is sorted, \c NK_FALSE if the function gave up
+ */
+NK_INTERNAL NkBoolean __NkInt_SortInsertion(
+    _In_    __NkInt_SortContext const *cxtPtr,
+    _Inout_ NkByte *basePtr,
+    _In_    NkSize nElems,
+    _In_    NkSize maxMoves
+) {
+    NkSize const elemSize = cxtPtr->m_elemSize;
+
+    NkSize nMoves = 0;
+    for (NkSize i = 1; i < nElems; i++) {
+        NkSize j = i;
+
+        while (j > 0 && __NkInt_SortCompare(cxtPtr, basePtr + (j - 1) * elemSize, basePtr + j * elemSize) > 0) {
+            __NkInt_SortSwap(cxtPtr, basePtr + (j - 1) * elemSize, basePtr + j * elemSize);
+
+            --j;
+        }
+
+        if ((nMoves += i - j) > maxMoves)
+            return NK_FALSE;
+    }
+
+    return NK_TRUE;
+}
+
+/**
+ * \brief sorts the given range using heapsort
+ * \param [in] cxtPtr sorting context
+ * \param [in,out] basePtr pointer to the first element of the range
+ * \param [in] nElems number of elements in the range
+ * \note  This is the fallback for ranges on which quicksort performs badly; it
+ *        guarantees <tt>O(n log n)</tt>.
+ */
+NK_INTERNAL NkVoid __NkInt_SortHeap(
+    _In_    __NkInt_SortContext const *cxtPtr,
+    _Inout_ NkByte *basePtr,
+    _In_    NkSize nElems
+) {
+#define NK_SORT_ELEM(i) (basePtr + (i) * cxtPtr->m_elemSize)
+    for (NkSize i = nElems; i-- > 0;) {
+        /* i > nElems / 2 never has children, so sifting down those is a no-op. */
+        if (i >= nElems / 2)
+            continue;
+
+        for (NkSize currInd = i, childInd; (childInd = 2 * currInd + 1) < nElems; currInd = childInd) {
+            if (childInd + 1 < nElems && __NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(childInd), NK_SORT_ELEM(childInd + 1)) < 0)
+                ++childInd;
+            if (__NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(currInd), NK_SORT_ELEM(childInd)) >= 0)
+                break;
+
+            __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(currInd), NK_SORT_ELEM(childInd));
+        }
+    }
+
+    /* Repeatedly move the largest element to the end and restore the heap. */
+    for (NkSize heapSize = nElems; heapSize > 1;) {
+        __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(0), NK_SORT_ELEM(--heapSize));
+
+        for (NkSize currInd = 0, childInd; (childInd = 2 * currInd + 1) < heapSize; currInd = childInd) {
+            if (childInd + 1 < heapSize && __NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(childInd), NK_SORT_ELEM(childInd + 1)) < 0)
+                ++childInd;
+            if (__NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(currInd), NK_SORT_ELEM(childInd)) >= 0)
+                break;
+
+            __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(currInd), NK_SORT_ELEM(childInd));
+        }
+    }
+#undef NK_SORT_ELEM
+}
+
+/**
+ * \brief orders three elements so that the median ends up in the middle
+ * \param [in] cxtPtr sorting context
+ * \param [in,out] aPtr pointer to the first element
+ * \param [in,out] bPtr pointer to the second element
+ * \param [in,out] cPtr pointer to the third element
+ */
+NK_INTERNAL NK_INLINE NkVoid __NkInt_SortMedian3(
+    _In_    __NkInt_SortContext const *cxtPtr,
+    _Inout_ NkByte *aPtr,
+    _Inout_ NkByte *bPtr,
+    _Inout_ NkByte *cPtr
+) {
+    if (__NkInt_SortCompare(cxtPtr, aPtr, bPtr) > 0)
+        __NkInt_SortSwap(cxtPtr, aPtr, bPtr);
+    if (__NkInt_SortCompare(cxtPtr, bPtr, cPtr) > 0)
+        __NkInt_SortSwap(cxtPtr, bPtr, cPtr);
+    if (__NkInt_SortCompare(cxtPtr, aPtr, bPtr) > 0)
+        __NkInt_SortSwap(cxtPtr, aPtr, bPtr);
+}
+
+/**
+ * \brief sorts the given range using pattern-defeating introsort
+ * \param [in] cxtPtr sorting context
+ * \param [in,out] basePtr pointer to the first element of the range
+ * \param [in] nElems number of elements in the range
+ * \param [in] depthLimit number of unbalanced partitions that are tolerated before the
+ *             range is sorted using heapsort instead
+ *
+ * \par Remarks
+ *   The pivot is the median of three (or, for large ranges, the median of three medians)
+ *   elements. If partitioning did not have to move any element, the range is likely
+ *   already sorted, so a partial insertion sort is attempted on both partitions, which
+ *   finishes almost-sorted input in linear time. If a partition turns out highly
+ *   unbalanced, a few elements are swapped to break up the pattern that caused it and the
+ *   depth limit is decremented; once it reaches zero, heapsort takes over. Only the
+ *   smaller partition is sorted recursively.
+ */
+NK_INTERNAL NkVoid __NkInt_SortIntro(
+    _In_    __NkInt_SortContext const *cxtPtr,
+    _Inout_ NkByte *basePtr,
+    _In_    NkSize nElems,
+    _In_    NkUint32 depthLimit
+) {
+#define NK_SORT_ELEM(i) (basePtr + (i) * cxtPtr->m_elemSize)
+    while (nElems > NK_SORT_INSERTIONTHRESHOLD) {
+        if (depthLimit == 0) {
+            __NkInt_SortHeap(cxtPtr, basePtr, nElems);
+
+            return;
+        }
+
+        /* Choose the pivot and move it to the end of the range. */
+        NkSize const midInd  = nElems / 2;
+        NkSize const lastInd = nElems - 1;
+        if (nElems > NK_SORT_NINTHERTHRESHOLD) {
+            NkSize const eighthLen = nElems / 8;
+
+            __NkInt_SortMedian3(cxtPtr, NK_SORT_ELEM(0), NK_SORT_ELEM(eighthLen), NK_SORT_ELEM(2 * eighthLen));
+            __NkInt_SortMedian3(cxtPtr, NK_SORT_ELEM(midInd - eighthLen), NK_SORT_ELEM(midInd), NK_SORT_ELEM(midInd + eighthLen));
+            __NkInt_SortMedian3(cxtPtr, NK_SORT_ELEM(lastInd - 2 * eighthLen), NK_SORT_ELEM(lastInd - eighthLen), NK_SORT_ELEM(lastInd));
+            __NkInt_SortMedian3(cxtPtr, NK_SORT_ELEM(eighthLen), NK_SORT_ELEM(midInd), NK_SORT_ELEM(lastInd - eighthLen));
+        } else
+            __NkInt_SortMedian3(cxtPtr, NK_SORT_ELEM(0), NK_SORT_ELEM(midInd), NK_SORT_ELEM(lastInd));
+        __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(midInd), NK_SORT_ELEM(lastInd));
+
+        /*
+         * Partition the range so that no element left of the pivot is greater and no
+         * element right of it is smaller. Both scans stop at elements equal to the pivot
+         * so that ranges with many equal elements are still split evenly. The pivot
+         * itself stops the left scan.
+         */
+        NkSize    pivInd   = 0;
+        NkBoolean hasMoved = NK_FALSE;
+        for (NkSize j = lastInd - 1;;) {
+            while (__NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(pivInd), NK_SORT_ELEM(lastInd)) < 0)
+                ++pivInd;
+            while (j > pivInd && __NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(j), NK_SORT_ELEM(lastInd)) > 0)
+                --j;
+            if (pivInd >= j)
+                break;
+
+            __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(pivInd++), NK_SORT_ELEM(j--));
+            hasMoved = NK_TRUE;
+        }
+        if (pivInd != lastInd)
+            __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(pivInd), NK_SORT_ELEM(lastInd));
+
+        NkSize const nLeft  = pivInd;
+        NkSize const nRight = nElems - pivInd - 1;
+        NkByte *const rightPtr = NK_SORT_ELEM(pivInd + 1);
+
+        if (NK_MIN(nLeft, nRight) < nElems / 8) {
+            /*
+             * The partition is highly unbalanced. Swap some elements around to break up
+             * patterns that may cause this repeatedly.
+             */
+            --depthLimit;
+
+            if (nLeft >= NK_SORT_INSERTIONTHRESHOLD) {
+                __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(0), NK_SORT_ELEM(nLeft / 4));
+                __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(nLeft - 1), NK_SORT_ELEM(nLeft - nLeft / 4));
+            }
+            if (nRight >= NK_SORT_INSERTIONTHRESHOLD) {
+                __NkInt_SortSwap(cxtPtr, rightPtr, rightPtr + nRight / 4 * cxtPtr->m_elemSize);
+                __NkInt_SortSwap(
+                    cxtPtr,
+                    rightPtr + (nRight - 1) * cxtPtr->m_elemSize,
+                    rightPtr + (nRight - nRight / 4) * cxtPtr->m_elemSize
+                );
+            }
+        } else if (!hasMoved) {
+            /*
+             * The partition was balanced and nothing had to be moved, so the range is
+             * likely (almost) sorted already.
+             */
+            if (   __NkInt_SortInsertion(cxtPtr, basePtr, nLeft, NK_SORT_PARTIALINSERTIONLIMIT)
+                && __NkInt_SortInsertion(cxtPtr, rightPtr, nRight, NK_SORT_PARTIALINSERTIONLIMIT)
+            ) return;
+        }
+
+        /* Recurse into the smaller partition; continue with the larger one. */
+        if (nLeft < nRight) {
+            __NkInt_SortIntro(cxtPtr, basePtr, nLeft, depthLimit);
+
+            basePtr = rightPtr;
+            nElems  = nRight;
+        } else {
+            __NkInt_SortIntro(cxtPtr, rightPtr, nRight, depthLimit);
+
+            nElems = nLeft;
+        }
+    }
+
+    NK_IGNORE_RETURN_VALUE(__NkInt_SortInsertion(cxtPtr, basePtr, nElems, SIZE_MAX));
+#undef NK_SORT_ELEM
+}
+
+/**
+ * \brief  sorts the given range using introsort, handling already-sorted and
+ *         reverse-sorted input in linear time
+ * \param  [in] cxtPtr sorting context
+ * \param  [in,out] basePtr pointer to the first element of the range
+ * \param  [in] nElems number of elements in the range
+ * \return \c NkErr_Ok if the range was sorted, \c NkErr_NoOperation if it was already
+ *         sorted
+ */
+NK_INTERNAL NkErrorCode __NkInt_SortRun(
+    _In_    __NkInt_SortContext const *cxtPtr,
+    _Inout_ NkByte *basePtr,
+    _In_    NkSize nElems
+) {
+#define NK_SORT_ELEM(i) (basePtr + (i) * cxtPtr->m_elemSize)
+    /*
+     * Check whether the range is ascending or strictly descending. Frame-to-frame lists
+     * like depth-sorted sprites often are, so this is worth a linear scan.
+     */
+    NkSize i = 1;
+    if (__NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(0), NK_SORT_ELEM(1)) > 0) {
+        while (i < nElems && __NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(i - 1), NK_SORT_ELEM(i)) > 0)
+            ++i;
+
+        if (i == nElems) {
+            for (NkSize l = 0, r = nElems - 1; l < r; l++, r--)
+                __NkInt_SortSwap(cxtPtr, NK_SORT_ELEM(l), NK_SORT_ELEM(r));
+
+            return NkErr_Ok;
+        }
+    } else {
+        while (i < nElems && __NkInt_SortCompare(cxtPtr, NK_SORT_ELEM(i - 1), NK_SORT_ELEM(i)) <= 0)
+            ++i;
+
+        if (i == nElems)
+            return NkErr_NoOperation;
+    }
+
+    /* Sort the range; the depth limit is 2 * floor(log2(n)). */
+    NkUint32 depthLimit = 0;
+    for (NkSize n = nElems; n > 1; n >>= 1)
+        depthLimit += 2;
+
+    __NkInt_SortIntro(cxtPtr, basePtr, nElems, depthLimit);
+    return NkErr_Ok;
+#undef NK_SORT_ELEM
+}
+
+
+/**
+ * \def   NK_SORT_RADIXBITS
+ * \brief number of key bits processed per radix sort pass
+ */
+#define NK_SORT_RADIXBITS        ((NkUint32)(8))
+/**
+ * \def   NK_SORT_RADIXBUCKETS
+ * \brief number of buckets per radix sort pass
+ */
+#define NK_SORT_RADIXBUCKETS     ((NkSize)(1 << NK_SORT_RADIXBITS))
+/**
+ * \def   NK_SORT_RADIXPASSES
+ * \brief number of radix sort passes needed for a 64-bit key
+ */
+#define NK_SORT_RADIXPASSES      ((NkUint32)(64 / NK_SORT_RADIXBITS))
+/**
+ * \def   NK_SORT_RADIXMAXCHUNKS
+ * \brief maximum number of chunks a parallel radix sort splits its input into
+ */
+#define NK_SORT_RADIXMAXCHUNKS   ((NkUint32)(16))
+/**
+ * \def   NK_SORT_RADIXGETDIGIT(k, p)
+ * \brief extracts the digit of key \c k that is sorted by in pass \c p
+ */
+#define NK_SORT_RADIXGETDIGIT(k, p) ((NkSize)(((k) >> ((p) * NK_SORT_RADIXBITS)) & (NK_SORT_RADIXBUCKETS - 1)))
+
+/**
+ * \enum  __NkInt_RadixPhase
+ * \brief the kinds of work a radix sort chunk can do
+ */
+NK_NATIVE typedef enum __NkInt_RadixPhase {
+    __NkInt_RadixPhase_FullHistogram, /**< count the digits of all passes at once */
+    __NkInt_RadixPhase_Histogram,     /**< count the digits of the current pass */
+    __NkInt_RadixPhase_Scatter        /**< move the elements to their bucket for the current pass */
+} __NkInt_RadixPhase;
+
+/**
+ * \struct __NkInt_RadixChunk
+ * \brief  state of a contiguous part of the input of a radix sort
+ *
+ * In parallel mode, every chunk is processed by its own job. Since the chunks are in
+ * order and every chunk writes its elements to its own region of each bucket, the sort
+ * stays stable.
+ */
+NK_NATIVE typedef struct __NkInt_RadixChunk {
+    NkUint64 const     *mp_srcKeys;  /**< keys that are read in the current pass */
+    NkUint32 const     *mp_srcIdx;   /**< (optional) payloads that are read in the current pass */
+    NkUint64           *mp_dstKeys;  /**< keys that are written in the current pass */
+    NkUint32           *mp_dstIdx;   /**< (optional) payloads that are written in the current pass */
+    NkSize              m_sInd;      /**< first index of the chunk */
+    NkSize              m_eInd;      /**< one past the last index of the chunk */
+    NkUint32            m_passInd;   /**< index of the current pass */
+    __NkInt_RadixPhase  m_currPhase; /**< work to do when the chunk is run next */
+    /**
+     * \brief digit counts per pass; turned into write offsets before scattering
+     */
+    NkSize m_histArr[NK_SORT_RADIXPASSES][NK_SORT_RADIXBUCKETS];
+} __NkInt_RadixChunk;
+
+
+/**
+ * \brief runs the current phase of the given radix sort chunk
+ * \param [in,out] extraCxt pointer to the <tt>__NkInt_RadixChunk</tt> instance
+ * \note  This function is used as a job function in parallel mode.
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_SortRadixRunChunk(_Inout_opt_ NkVoid *extraCxt) {
+    __NkInt_RadixChunk *chunkPtr = (__NkInt_RadixChunk *)extraCxt;
+    NkUint32 const      passInd  = chunkPtr->m_passInd;
+
+    switch (chunkPtr->m_currPhase) {
+        case __NkInt_RadixPhase_FullHistogram:
+            memset(chunkPtr->m_histArr, 0, sizeof chunkPtr->m_histArr);
+
+            for (NkSize i = chunkPtr->m_sInd; i < chunkPtr->m_eInd; i++) {
+                NkUint64 const currKey = chunkPtr->mp_srcKeys[i];
+
+                for (NkUint32 j = 0; j < NK_SORT_RADIXPASSES; j++)
+                    ++chunkPtr->m_histArr[j][NK_SORT_RADIXGETDIGIT(currKey, j)];
+            }
+            break;
+        case __NkInt_RadixPhase_Histogram:
+            memset(chunkPtr->m_histArr[passInd], 0, sizeof chunkPtr->m_histArr[passInd]);
+
+            for (NkSize i = chunkPtr->m_sInd; i < chunkPtr->m_eInd; i++)
+                ++chunkPtr->m_histArr[passInd][NK_SORT_RADIXGETDIGIT(chunkPtr->mp_srcKeys[i], passInd)];
+            break;
+        case __NkInt_RadixPhase_Scatter: {
+            NkSize *offArr = chunkPtr->m_histArr[passInd];
+
+            if (chunkPtr->mp_srcIdx == NULL) {
+                for (NkSize i = chunkPtr->m_sInd; i < chunkPtr->m_eInd; i++) {
+                    NkUint64 const currKey = chunkPtr->mp_srcKeys[i];
+
+                    chunkPtr->mp_dstKeys[offArr[NK_SORT_RADIXGETDIGIT(currKey, passInd)]++] = currKey;
+                }
+
+                break;
+            }
+
+            for (NkSize i = chunkPtr->m_sInd; i < chunkPtr->m_eInd; i++) {
+                NkUint64 const currKey = chunkPtr->mp_srcKeys[i];
+                NkSize   const dstInd  = offArr[NK_SORT_RADIXGETDIGIT(currKey, passInd)]++;
+
+                chunkPtr->mp_dstKeys[dstInd] = currKey;
+                chunkPtr->mp_dstIdx[dstInd]  = chunkPtr->mp_srcIdx[i];
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * \brief runs the current phase of all given chunks and waits for them to finish
+ * \param [in,out] chunkArr array of chunks
+ * \param [in] nChunks number of elements in \c chunkArr
+ * \note  The first chunk is always run on the calling thread. If the remaining chunks
+ *        cannot be submitted to the job system, they are run on the calling thread, too.
+ */
+NK_INTERNAL NkVoid __NkInt_SortRadixRunPhase(_Inout_ __NkInt_RadixChunk *chunkArr, _In_ NkUint32 nChunks) {
+    NkJobDescription jobArr[NK_SORT_RADIXMAXCHUNKS];
+    NkJobCounter     jobCnt = { 0 };
+
+    for (NkUint32 i = 1; i < nChunks; i++)
+        jobArr[i - 1] = (NkJobDescription){ &__NkInt_SortRadixRunChunk, &chunkArr[i] };
+    NkErrorCode errCode = nChunks > 1 ? NkJobSubmit(jobArr, nChunks - 1, NULL, &jobCnt) : NkErr_Ok;
+
+    __NkInt_SortRadixRunChunk(&chunkArr[0]);
+    if (errCode != NkErr_Ok) {
+        for (NkUint32 i = 1; i < nChunks; i++)
+            __NkInt_SortRadixRunChunk(&chunkArr[i]);
+
+        return;
+    }
+    if (nChunks > 1)
+        NkJobWait(&jobCnt);
+}
 /** \endcond */
 
 
@@ -103,3 +626,248 @@ _Return_ok_ NkErrorCode NK_CALL NkQuicksortPointers(
 }
 
 
+_Return_ok_ NkErrorCode NK_CALL NkQuicksortValues(
+    _Inout_  NkVoid *elemArray,
+    _In_     NkSize elemSize,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32(NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+) {
+    NK_ASSERT(elemArray != NULL, NkErr_InParameter);
+    NK_ASSERT(elemSize > 0, NkErr_InParameter);
+    NK_ASSERT(fnPred != NULL, NkErr_CallbackParameter);
+
+    /* If the range is empty or just one element, do nothing. */
+    if (sInd >= eInd)
+        return NkErr_NoOperation;
+
+/** \cond */
+/**
+ * \def   NK_SORT_ELEM(i)
+ * \brief calculates the address of the i-th element of the current range
+ * \param i index of the element, relative to the start of the current range
+ */
+#define NK_SORT_ELEM(i) (basePtr + (i) * elemSize)
+/** \endcond */
+
+    NkByte *basePtr = (NkByte *)elemArray + sInd * elemSize;
+    NkSize  nElems  = eInd - sInd + 1;
+    while (nElems > NK_SORT_INSERTIONTHRESHOLD) {
+        /*
+         * Use the median of the first, middle, and last element as the pivot and move it
+         * to the end of the range.
+         */
+        NkSize const midInd  = nElems / 2;
+        NkSize const lastInd = nElems - 1;
+        if ((*fnPred)(NK_SORT_ELEM(0), NK_SORT_ELEM(midInd)) > 0)
+            __NkInt_SortSwapValues(NK_SORT_ELEM(0), NK_SORT_ELEM(midInd), elemSize);
+        if ((*fnPred)(NK_SORT_ELEM(midInd), NK_SORT_ELEM(lastInd)) > 0)
+            __NkInt_SortSwapValues(NK_SORT_ELEM(midInd), NK_SORT_ELEM(lastInd), elemSize);
+        if ((*fnPred)(NK_SORT_ELEM(0), NK_SORT_ELEM(midInd)) > 0)
+            __NkInt_SortSwapValues(NK_SORT_ELEM(0), NK_SORT_ELEM(midInd), elemSize);
+        __NkInt_SortSwapValues(NK_SORT_ELEM(midInd), NK_SORT_ELEM(lastInd), elemSize);
+
+        /*
+         * Partition the range so that no element left of the pivot is greater and no
+         * element right of it is smaller. Both scans stop at elements equal to the pivot
+         * so that ranges with many equal elements are still split evenly. The pivot
+         * itself stops the left scan.
+         */
+        NkSize pivInd = 0;
+        for (NkSize j = lastInd - 1;;) {
+            while ((*fnPred)(NK_SORT_ELEM(pivInd), NK_SORT_ELEM(lastInd)) < 0)
+                ++pivInd;
+            while (j > pivInd && (*fnPred)(NK_SORT_ELEM(j), NK_SORT_ELEM(lastInd)) > 0)
+                --j;
+            if (pivInd >= j)
+                break;
+
+            __NkInt_SortSwapValues(NK_SORT_ELEM(pivInd++), NK_SORT_ELEM(j--), elemSize);
+        }
+        if (pivInd != lastInd)
+            __NkInt_SortSwapValues(NK_SORT_ELEM(pivInd), NK_SORT_ELEM(lastInd), elemSize);
+
+        /* Recurse into the smaller partition; continue with the larger one. */
+        NkSize const nLeft  = pivInd;
+        NkSize const nRight = nElems - pivInd - 1;
+        if (nLeft < nRight) {
+            if (nLeft > 1)
+                NK_IGNORE_RETURN_VALUE(NkQuicksortValues(basePtr, elemSize, 0, nLeft - 1, fnPred));
+
+            basePtr = NK_SORT_ELEM(pivInd + 1);
+            nElems  = nRight;
+        } else {
+            if (nRight > 1)
+                NK_IGNORE_RETURN_VALUE(NkQuicksortValues(NK_SORT_ELEM(pivInd + 1), elemSize, 0, nRight - 1, fnPred));
+
+            nElems = nLeft;
+        }
+    }
+    __NkInt_InsertionSortValues(basePtr, elemSize, nElems, fnPred);
+
+#undef NK_SORT_ELEM
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkIntrosortPointers(
+    _Inout_  NkVoid **ptrArray,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32(NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+) {
+    NK_ASSERT(ptrArray != NULL, NkErr_InParameter);
+    NK_ASSERT(fnPred != NULL, NkErr_CallbackParameter);
+
+    /* If the range is empty or just one element, do nothing. */
+    if (sInd >= eInd)
+        return NkErr_NoOperation;
+
+    return __NkInt_SortRun(
+        &(__NkInt_SortContext const){
+            .m_elemSize   = sizeof *ptrArray,
+            .m_isPtrArray = NK_TRUE,
+            .mp_fnPred    = fnPred
+        },
+        (NkByte *)&ptrArray[sInd],
+        eInd - sInd + 1
+    );
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkIntrosortValues(
+    _Inout_  NkVoid *elemArray,
+    _In_     NkSize elemSize,
+    _In_opt_ NkSize sInd,
+    _In_opt_ NkSize eInd,
+    _In_     NkInt32(NK_CALL *fnPred)(NkVoid const *, NkVoid const *)
+) {
+    NK_ASSERT(elemArray != NULL, NkErr_InParameter);
+    NK_ASSERT(elemSize > 0, NkErr_InParameter);
+    NK_ASSERT(fnPred != NULL, NkErr_CallbackParameter);
+
+    /* If the range is empty or just one element, do nothing. */
+    if (sInd >= eInd)
+        return NkErr_NoOperation;
+
+    return __NkInt_SortRun(
+        &(__NkInt_SortContext const){
+            .m_elemSize   = elemSize,
+            .m_isPtrArray = NK_FALSE,
+            .mp_fnPred    = fnPred
+        },
+        (NkByte *)elemArray + sInd * elemSize,
+        eInd - sInd + 1
+    );
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkRadixsortKeys64(
+    _Inout_     NkUint64 *keyArray,
+    _Inout_opt_ NkUint32 *idxArray,
+    _In_        NkSize nElems,
+    _In_        NkBoolean isParallel
+) {
+    NK_ASSERT(keyArray != NULL, NkErr_InParameter);
+
+    /* If the range is empty or just one element, do nothing. */
+    if (nElems < 2)
+        return NkErr_NoOperation;
+
+    /* Determine the number of chunks. */
+    NkUint32 nChunks = 1;
+    if (isParallel && nElems >= NK_SORT_RADIXPARALLELTHRESHOLD)
+        nChunks = NK_MIN(NkJobGetWorkerCount() + 1, NK_SORT_RADIXMAXCHUNKS);
+
+    /* Allocate the chunk states and the scratch buffers in one go. */
+    NkSize const tmpIdxSize = idxArray != NULL ? sizeof *idxArray : 0;
+    if (nElems > (SIZE_MAX - nChunks * sizeof(__NkInt_RadixChunk)) / (sizeof *keyArray + tmpIdxSize))
+        return NkErr_UnsignedWrapAround;
+    __NkInt_RadixChunk *chunkArr;
+    NkErrorCode errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        nChunks * sizeof *chunkArr + nElems * (sizeof *keyArray + tmpIdxSize),
+        0,
+        NK_FALSE,
+        (NkVoid **)&chunkArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkUint64 *tmpKeys = (NkUint64 *)&chunkArr[nChunks];
+    NkUint32 *tmpIdx  = idxArray != NULL ? (NkUint32 *)&tmpKeys[nElems] : NULL;
+
+    /* Count the digits of all passes over the whole input. */
+    NkSize const chunkSize = (nElems + nChunks - 1) / nChunks;
+    for (NkUint32 i = 0; i < nChunks; i++) {
+        chunkArr[i].mp_srcKeys  = keyArray;
+        chunkArr[i].m_sInd      = NK_MIN(i * chunkSize, nElems);
+        chunkArr[i].m_eInd      = NK_MIN((i + 1) * chunkSize, nElems);
+        chunkArr[i].m_currPhase = __NkInt_RadixPhase_FullHistogram;
+    }
+    __NkInt_SortRadixRunPhase(chunkArr, nChunks);
+
+    /*
+     * Do the passes, skipping all passes in which all keys have the same digit. Render
+     * keys often leave whole bytes constant (e.g., unused layers), so this is common.
+     */
+    NkUint64 *srcKeys = keyArray, *dstKeys = tmpKeys;
+    NkUint32 *srcIdx  = idxArray, *dstIdx  = tmpIdx;
+    NkBoolean isInitialOrder = NK_TRUE;
+    for (NkUint32 j = 0; j < NK_SORT_RADIXPASSES; j++) {
+        NkSize digitCount = 0;
+        for (NkUint32 i = 0; i < nChunks; i++)
+            digitCount += chunkArr[i].m_histArr[j][NK_SORT_RADIXGETDIGIT(srcKeys[0], j)];
+        if (digitCount == nElems)
+            continue;
+
+        for (NkUint32 i = 0; i < nChunks; i++) {
+            chunkArr[i].mp_srcKeys = srcKeys;
+            chunkArr[i].mp_srcIdx  = srcIdx;
+            chunkArr[i].mp_dstKeys = dstKeys;
+            chunkArr[i].mp_dstIdx  = dstIdx;
+            chunkArr[i].m_passInd  = j;
+        }
+
+        /*
+         * The per-chunk counts of the full histogram are only valid as long as no pass
+         * reordered the elements. With only one chunk, this does not matter.
+         */
+        if (!isInitialOrder && nChunks > 1) {
+            for (NkUint32 i = 0; i < nChunks; i++)
+                chunkArr[i].m_currPhase = __NkInt_RadixPhase_Histogram;
+
+            __NkInt_SortRadixRunPhase(chunkArr, nChunks);
+        }
+
+        /* Turn the counts into write offsets, bucket by bucket, chunk by chunk. */
+        for (NkSize k = 0, currOff = 0; k < NK_SORT_RADIXBUCKETS; k++)
+            for (NkUint32 i = 0; i < nChunks; i++) {
+                NkSize const currCount = chunkArr[i].m_histArr[j][k];
+
+                chunkArr[i].m_histArr[j][k] = currOff;
+                currOff += currCount;
+            }
+
+        for (NkUint32 i = 0; i < nChunks; i++)
+            chunkArr[i].m_currPhase = __NkInt_RadixPhase_Scatter;
+        __NkInt_SortRadixRunPhase(chunkArr, nChunks);
+
+        NkUint64 *tmpKeysPtr = srcKeys;
+        NkUint32 *tmpIdxPtr  = srcIdx;
+        srcKeys = dstKeys;
+        srcIdx  = dstIdx;
+        dstKeys = tmpKeysPtr;
+        dstIdx  = tmpIdxPtr;
+        isInitialOrder = NK_FALSE;
+    }
+
+    /* If an odd number of passes was done, the result is in the scratch buffers. */
+    if (srcKeys != keyArray) {
+        memcpy(keyArray, srcKeys, nElems * sizeof *keyArray);
+
+        if (idxArray != NULL)
+            memcpy(idxArray, srcIdx, nElems * sizeof *idxArray);
+    }
+
+    NkGPFree(chunkArr);
+    return isInitialOrder ? NkErr_NoOperation : NkErr_Ok;
+}
+
+
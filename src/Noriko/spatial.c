@@ -0,0 +1,434 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  spatial.c
+ * \brief implements the uniform-grid spatial index
+ *
+ * Objects are stored in a single array and linked into a doubly-linked list per bucket,
+ * so inserting, moving and removing an object never allocates once the array is large
+ * enough. Since an object is only filed under the cell of its center, it can overlap
+ * cells around it; queries account for that by widening the query rectangle by the
+ * largest half-extents of any object that was ever inserted.
+ */
+#define NK_NAMESPACE "nk::spatial"
+
+
+/* stdlib includes */
+#include <math.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/spatial.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/log.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \brief largest cell coordinate (in both directions); positions further out are filed
+ *        under the outermost cells
+ */
+#define __NkInt_SpatialGrid_MaxCell ((NkInt32)(1 << 30))
+
+
+/**
+ * \struct __NkInt_SpatialObject
+ * \brief  represents an object inside the spatial grid
+ */
+NK_NATIVE typedef struct __NkInt_SpatialObject {
+    NkRectF   m_bounds;   /**< bounding rectangle */
+    NkUint64  m_userData; /**< user-defined value */
+    NkInt32   m_cellX;    /**< x-coordinate of the cell the object is filed under */
+    NkInt32   m_cellY;    /**< y-coordinate of the cell the object is filed under */
+    NkUint32  m_prevInd;  /**< previous object in the same bucket */
+    NkUint32  m_nextInd;  /**< next object in the same bucket, or next free object */
+    NkBoolean m_isLive;   /**< whether the object is in use */
+} __NkInt_SpatialObject;
+
+
+/**
+ * \struct NkSpatialGrid
+ * \brief  internal definition of the spatial grid
+ */
+struct NkSpatialGrid {
+    NkFloat                m_cellSize;  /**< edge length of a cell */
+    NkFloat                m_invCell;   /**< reciprocal of <tt>m_cellSize</tt> */
+    NkUint32               m_bucketMsk; /**< number of buckets minus one */
+    NkUint32              *mp_headArr;  /**< first object of every bucket */
+    __NkInt_SpatialObject *mp_objArr;   /**< object storage */
+    NkUint32               m_objCap;    /**< capacity of <tt>mp_objArr</tt> */
+    NkUint32               m_nUsed;     /**< number of elements of <tt>mp_objArr</tt> ever used */
+    NkUint32               m_nObjs;     /**< number of live objects */
+    NkUint32               m_freeHead;  /**< first free object */
+    NkFloat                m_maxHalfW;  /**< largest half-width of any object */
+    NkFloat                m_maxHalfH;  /**< largest half-height of any object */
+};
+
+
+/**
+ * \brief  calculates the cell coordinate of the given world coordinate
+ * \param  [in] gridPtr pointer to the spatial grid
+ * \param  [in] worldCoord world coordinate
+ * \return cell coordinate
+ */
+NK_INTERNAL NK_INLINE NkInt32 __NkInt_SpatialGrid_ToCell(_In_ NkSpatialGrid const *gridPtr, _In_ NkFloat worldCoord) {
+    NkFloat const cellCoord = floorf(worldCoord * gridPtr->m_invCell);
+
+    return (NkInt32)NK_CLAMP(cellCoord, -(NkFloat)__NkInt_SpatialGrid_MaxCell, (NkFloat)__NkInt_SpatialGrid_MaxCell);
+}
+
+/**
+ * \brief  calculates the bucket the given cell is hashed into
+ * \param  [in] gridPtr pointer to the spatial grid
+ * \param  [in] cellX x-coordinate of the cell
+ * \param  [in] cellY y-coordinate of the cell
+ * \return index of the bucket
+ */
+NK_INTERNAL NK_INLINE NkUint32 __NkInt_SpatialGrid_HashCell(
+    _In_ NkSpatialGrid const *gridPtr,
+    _In_ NkInt32 cellX,
+    _In_ NkInt32 cellY
+) {
+    NkUint32 const hashVal = (NkUint32)cellX * 0x9E3779B1u ^ (NkUint32)cellY * 0x85EBCA77u;
+
+    return (hashVal ^ hashVal >> 15) & gridPtr->m_bucketMsk;
+}
+
+/**
+ * \brief  checks whether two rectangles overlap
+ * \param  [in] rect1 first rectangle
+ * \param  [in] rect2 second rectangle
+ * \return \c NK_TRUE if the rectangles overlap, \c NK_FALSE if not
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_SpatialGrid_IsOverlap(_In_ NkRectF const *rect1, _In_ NkRectF const *rect2) {
+    return rect1->m_xCoord < rect2->m_xCoord + rect2->m_width
+        && rect2->m_xCoord < rect1->m_xCoord + rect1->m_width
+        && rect1->m_yCoord < rect2->m_yCoord + rect2->m_height
+        && rect2->m_yCoord < rect1->m_yCoord + rect1->m_height
+    ;
+}
+
+/**
+ * \brief links an object into the bucket of its cell
+ * \param [in, out] gridPtr pointer to the spatial grid
+ * \param [in] objInd index of the object
+ */
+NK_INTERNAL NkVoid __NkInt_SpatialGrid_Link(_Inout_ NkSpatialGrid *gridPtr, _In_ NkUint32 objInd) {
+    __NkInt_SpatialObject *objPtr    = &gridPtr->mp_objArr[objInd];
+    NkUint32 const         bucketInd = __NkInt_SpatialGrid_HashCell(gridPtr, objPtr->m_cellX, objPtr->m_cellY);
+
+    objPtr->m_prevInd = NK_SPATIAL_INVHANDLE;
+    objPtr->m_nextInd = gridPtr->mp_headArr[bucketInd];
+    if (objPtr->m_nextInd != NK_SPATIAL_INVHANDLE)
+        gridPtr->mp_objArr[objPtr->m_nextInd].m_prevInd = objInd;
+    gridPtr->mp_headArr[bucketInd] = objInd;
+}
+
+/**
+ * \brief unlinks an object from the bucket of its cell
+ * \param [in, out] gridPtr pointer to the spatial grid
+ * \param [in] objInd index of the object
+ */
+NK_INTERNAL NkVoid __NkInt_SpatialGrid_Unlink(_Inout_ NkSpatialGrid *gridPtr, _In_ NkUint32 objInd) {
+    __NkInt_SpatialObject *objPtr = &gridPtr->mp_objArr[objInd];
+
+    if (objPtr->m_prevInd != NK_SPATIAL_INVHANDLE)
+        gridPtr->mp_objArr[objPtr->m_prevInd].m_nextInd = objPtr->m_nextInd;
+    else
+        gridPtr->mp_headArr[__NkInt_SpatialGrid_HashCell(gridPtr, objPtr->m_cellX, objPtr->m_cellY)] = objPtr->m_nextInd;
+    if (objPtr->m_nextInd != NK_SPATIAL_INVHANDLE)
+        gridPtr->mp_objArr[objPtr->m_nextInd].m_prevInd = objPtr->m_prevInd;
+}
+
+/**
+ * \brief stores the bounding rectangle of an object and updates its cell
+ * \param [in, out] gridPtr pointer to the spatial grid
+ * \param [in, out] objPtr pointer to the object
+ * \param [in] boundsPtr new bounding rectangle
+ */
+NK_INTERNAL NkVoid __NkInt_SpatialGrid_SetBounds(
+    _Inout_ NkSpatialGrid *gridPtr,
+    _Inout_ __NkInt_SpatialObject *objPtr,
+    _In_    NkRectF const *boundsPtr
+) {
+    NkFloat const halfW = boundsPtr->m_width * .5f;
+    NkFloat const halfH = boundsPtr->m_height * .5f;
+
+    objPtr->m_bounds = *boundsPtr;
+    objPtr->m_cellX  = __NkInt_SpatialGrid_ToCell(gridPtr, boundsPtr->m_xCoord + halfW);
+    objPtr->m_cellY  = __NkInt_SpatialGrid_ToCell(gridPtr, boundsPtr->m_yCoord + halfH);
+
+    gridPtr->m_maxHalfW = NK_MAX(gridPtr->m_maxHalfW, halfW);
+    gridPtr->m_maxHalfH = NK_MAX(gridPtr->m_maxHalfH, halfH);
+}
+
+/**
+ * \brief  makes sure that at least one more object fits into the object array
+ * \param  [in, out] gridPtr pointer to the spatial grid
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_SpatialGrid_Reserve(_Inout_ NkSpatialGrid *gridPtr) {
+    if (gridPtr->m_freeHead != NK_SPATIAL_INVHANDLE || gridPtr->m_nUsed < gridPtr->m_objCap)
+        return NkErr_Ok;
+    if (gridPtr->m_objCap >= NK_SPATIAL_INVHANDLE / 2)
+        return NkErr_InvalidRange;
+
+    NkUint32 const newCap  = NK_MAX(gridPtr->m_objCap * 2, (NkUint32)64);
+    NkErrorCode    errCode = gridPtr->mp_objArr == NULL
+        ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *gridPtr->mp_objArr, 0, NK_FALSE, (NkVoid **)&gridPtr->mp_objArr)
+        : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *gridPtr->mp_objArr, (NkVoid **)&gridPtr->mp_objArr)
+    ;
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    gridPtr->m_objCap = newCap;
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkSpatialGridCreate(
+    _In_       NkSpatialGridSpecification const *gridSpec,
+    _Init_ptr_ NkSpatialGrid **gridPtr
+) {
+    NK_ASSERT(gridSpec != NULL && gridSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(gridSpec->m_cellSize > 0.f, NkErr_InParameter);
+    NK_ASSERT(gridSpec->m_nBuckets > 0 && (gridSpec->m_nBuckets & (gridSpec->m_nBuckets - 1)) == 0, NkErr_InParameter);
+    NK_ASSERT(gridPtr != NULL, NkErr_OutptrParameter);
+
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **gridPtr, 0, NK_TRUE, (NkVoid **)gridPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkSpatialGrid *actGrid = *gridPtr;
+
+    errCode = NkGPAlloc(
+        NK_MAKE_ALLOCATION_CONTEXT(),
+        gridSpec->m_nBuckets * sizeof *actGrid->mp_headArr,
+        0,
+        NK_FALSE,
+        (NkVoid **)&actGrid->mp_headArr
+    );
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+    if (gridSpec->m_initCap > 0) {
+        errCode = NkGPAlloc(
+            NK_MAKE_ALLOCATION_CONTEXT(),
+            gridSpec->m_initCap * sizeof *actGrid->mp_objArr,
+            0,
+            NK_FALSE,
+            (NkVoid **)&actGrid->mp_objArr
+        );
+        if (errCode != NkErr_Ok)
+            goto lbl_ONERROR;
+
+        actGrid->m_objCap = gridSpec->m_initCap;
+    }
+
+    actGrid->m_cellSize  = gridSpec->m_cellSize;
+    actGrid->m_invCell   = 1.f / gridSpec->m_cellSize;
+    actGrid->m_bucketMsk = gridSpec->m_nBuckets - 1;
+    NkSpatialGridClear(actGrid);
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    NkSpatialGridDestroy(gridPtr);
+
+    return errCode;
+}
+
+NkVoid NK_CALL NkSpatialGridDestroy(_Uninit_ptr_ NkSpatialGrid **gridPtr) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InOutParameter);
+
+    if (*gridPtr == NULL)
+        return;
+
+    NkGPFree((*gridPtr)->mp_objArr);
+    NkGPFree((*gridPtr)->mp_headArr);
+    NkGPFree(*gridPtr);
+    *gridPtr = NULL;
+}
+
+NkVoid NK_CALL NkSpatialGridClear(_Inout_ NkSpatialGrid *gridPtr) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InOutParameter);
+
+    /* NK_SPATIAL_INVHANDLE has all bits set, so the heads can be reset byte-wise. */
+    memset(gridPtr->mp_headArr, 0xFF, ((NkSize)gridPtr->m_bucketMsk + 1) * sizeof *gridPtr->mp_headArr);
+
+    gridPtr->m_nUsed    = 0;
+    gridPtr->m_nObjs    = 0;
+    gridPtr->m_freeHead = NK_SPATIAL_INVHANDLE;
+    gridPtr->m_maxHalfW = 0.f;
+    gridPtr->m_maxHalfH = 0.f;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkSpatialGridInsert(
+    _Inout_ NkSpatialGrid *gridPtr,
+    _In_    NkRectF const *boundsPtr,
+    _In_    NkUint64 userData,
+    _Out_   NkSpatialHandle *handlePtr
+) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(boundsPtr != NULL && boundsPtr->m_width >= 0.f && boundsPtr->m_height >= 0.f, NkErr_InParameter);
+    NK_ASSERT(handlePtr != NULL, NkErr_OutParameter);
+
+    NkErrorCode errCode = __NkInt_SpatialGrid_Reserve(gridPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* Reuse a removed object if there is one. */
+    NkUint32 objInd = gridPtr->m_freeHead;
+    if (objInd != NK_SPATIAL_INVHANDLE)
+        gridPtr->m_freeHead = gridPtr->mp_objArr[objInd].m_nextInd;
+    else
+        objInd = gridPtr->m_nUsed++;
+
+    __NkInt_SpatialObject *objPtr = &gridPtr->mp_objArr[objInd];
+    objPtr->m_userData = userData;
+    objPtr->m_isLive   = NK_TRUE;
+    __NkInt_SpatialGrid_SetBounds(gridPtr, objPtr, boundsPtr);
+    __NkInt_SpatialGrid_Link(gridPtr, objInd);
+
+    ++gridPtr->m_nObjs;
+    *handlePtr = (NkSpatialHandle)objInd;
+    return NkErr_Ok;
+}
+
+NkVoid NK_CALL NkSpatialGridMove(
+    _Inout_ NkSpatialGrid *gridPtr,
+    _In_    NkSpatialHandle objHandle,
+    _In_    NkRectF const *boundsPtr
+) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(objHandle < gridPtr->m_nUsed && gridPtr->mp_objArr[objHandle].m_isLive, NkErr_InParameter);
+    NK_ASSERT(boundsPtr != NULL && boundsPtr->m_width >= 0.f && boundsPtr->m_height >= 0.f, NkErr_InParameter);
+
+    __NkInt_SpatialObject *objPtr = &gridPtr->mp_objArr[objHandle];
+    NkInt32 const          oldX   = objPtr->m_cellX;
+    NkInt32 const          oldY   = objPtr->m_cellY;
+
+    __NkInt_SpatialGrid_SetBounds(gridPtr, objPtr, boundsPtr);
+    if (objPtr->m_cellX == oldX && objPtr->m_cellY == oldY)
+        return;
+
+    /* The object changed cells; the old cell is needed to find its bucket. */
+    NkInt32 const newX = objPtr->m_cellX;
+    NkInt32 const newY = objPtr->m_cellY;
+    objPtr->m_cellX = oldX;
+    objPtr->m_cellY = oldY;
+    __NkInt_SpatialGrid_Unlink(gridPtr, objHandle);
+
+    objPtr->m_cellX = newX;
+    objPtr->m_cellY = newY;
+    __NkInt_SpatialGrid_Link(gridPtr, objHandle);
+}
+
+NkVoid NK_CALL NkSpatialGridRemove(_Inout_ NkSpatialGrid *gridPtr, _In_ NkSpatialHandle objHandle) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(objHandle < gridPtr->m_nUsed && gridPtr->mp_objArr[objHandle].m_isLive, NkErr_InParameter);
+
+    __NkInt_SpatialGrid_Unlink(gridPtr, objHandle);
+
+    __NkInt_SpatialObject *objPtr = &gridPtr->mp_objArr[objHandle];
+    objPtr->m_isLive  = NK_FALSE;
+    objPtr->m_nextInd = gridPtr->m_freeHead;
+    gridPtr->m_freeHead = objHandle;
+    --gridPtr->m_nObjs;
+}
+
+NkUint64 NK_CALL NkSpatialGridQueryObject(
+    _In_      NkSpatialGrid const *gridPtr,
+    _In_      NkSpatialHandle objHandle,
+    _Out_opt_ NkRectF *boundsPtr
+) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(objHandle < gridPtr->m_nUsed && gridPtr->mp_objArr[objHandle].m_isLive, NkErr_InParameter);
+
+    __NkInt_SpatialObject const *objPtr = &gridPtr->mp_objArr[objHandle];
+    if (boundsPtr != NULL)
+        *boundsPtr = objPtr->m_bounds;
+    return objPtr->m_userData;
+}
+
+NkUint32 NK_CALL NkSpatialGridQuery(
+    _In_                  NkSpatialGrid const *gridPtr,
+    _In_                  NkRectF const *queryRect,
+    _O_array_opt_(maxRes) NkSpatialHandle *resArr,
+    _In_                  NkUint32 maxRes
+) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InParameter);
+    NK_ASSERT(queryRect != NULL, NkErr_InParameter);
+    NK_ASSERT(resArr != NULL || maxRes == 0, NkErr_OutParameter);
+
+    NkUint32 nFound = 0;
+    if (gridPtr->m_nObjs == 0)
+        return 0;
+
+    /*
+     * An object overlapping the query rectangle has its center at most its half-extents
+     * away from it, so only the cells of the widened rectangle have to be visited.
+     */
+    NkInt32 const minX = __NkInt_SpatialGrid_ToCell(gridPtr, queryRect->m_xCoord - gridPtr->m_maxHalfW);
+    NkInt32 const minY = __NkInt_SpatialGrid_ToCell(gridPtr, queryRect->m_yCoord - gridPtr->m_maxHalfH);
+    NkInt32 const maxX = __NkInt_SpatialGrid_ToCell(gridPtr, queryRect->m_xCoord + queryRect->m_width + gridPtr->m_maxHalfW);
+    NkInt32 const maxY = __NkInt_SpatialGrid_ToCell(gridPtr, queryRect->m_yCoord + queryRect->m_height + gridPtr->m_maxHalfH);
+
+    /*
+     * If the query covers more cells than there are objects, walking the cells costs more
+     * than simply testing every object.
+     */
+    NkUint64 const nCells = (NkUint64)((NkInt64)maxX - minX + 1) * (NkUint64)((NkInt64)maxY - minY + 1);
+    if (nCells > (NkUint64)gridPtr->m_nObjs || nCells > (NkUint64)gridPtr->m_bucketMsk + 1) {
+        for (NkUint32 i = 0; i < gridPtr->m_nUsed; i++) {
+            __NkInt_SpatialObject const *objPtr = &gridPtr->mp_objArr[i];
+
+            if (objPtr->m_isLive && __NkInt_SpatialGrid_IsOverlap(&objPtr->m_bounds, queryRect)) {
+                if (nFound < maxRes)
+                    resArr[nFound] = (NkSpatialHandle)i;
+
+                ++nFound;
+            }
+        }
+
+        return nFound;
+    }
+
+    for (NkInt32 y = minY; y <= maxY; y++)
+        for (NkInt32 x = minX; x <= maxX; x++) {
+            NkUint32 objInd = gridPtr->mp_headArr[__NkInt_SpatialGrid_HashCell(gridPtr, x, y)];
+
+            /* Other cells can share the bucket; skip their objects. */
+            for (; objInd != NK_SPATIAL_INVHANDLE; objInd = gridPtr->mp_objArr[objInd].m_nextInd) {
+                __NkInt_SpatialObject const *objPtr = &gridPtr->mp_objArr[objInd];
+
+                if (objPtr->m_cellX != x || objPtr->m_cellY != y || !__NkInt_SpatialGrid_IsOverlap(&objPtr->m_bounds, queryRect))
+                    continue;
+
+                if (nFound < maxRes)
+                    resArr[nFound] = (NkSpatialHandle)objInd;
+                ++nFound;
+            }
+        }
+
+    return nFound;
+}
+
+NkUint32 NK_CALL NkSpatialGridQueryCount(_In_ NkSpatialGrid const *gridPtr) {
+    NK_ASSERT(gridPtr != NULL, NkErr_InParameter);
+
+    return gridPtr->m_nObjs;
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -0,0 +1,365 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  tilecache.c
+ * \brief implements the tile cache, that is, an off-screen surface that holds a
+ *        pre-rendered copy of a static tile layer
+ */
+#define NK_NAMESPACE "nk::tilecache"
+
+
+/* stdlib includes */
+#include <math.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/tilecache.h>
+#include <include/Noriko/alloc.h>
+#include <include/Noriko/bmp.h>
+#include <include/Noriko/log.h>
+
+
+/**
+ * \struct NkTileCache
+ * \brief  internal definition of the tile cache
+ *
+ * Cell <tt>(x, y)</tt> of the surface always holds the world tile
+ * <tt>m_oriTile + (x, y)</tt>. Scrolling the camera thus moves the contents of the
+ * surface along with the dirty flags.
+ */
+struct NkTileCache {
+    NkTileCacheSpecification  m_cacheSpec;   /**< copy of the cache specification */
+    NkRendererResource       *mp_surfPtr;    /**< surface holding the pre-rendered tiles */
+    NkRendererResource       *mp_emptyTex;   /**< 1x1 texture in the empty color */
+    NkPoint2D                 m_oriTile;     /**< world tile that is stored in cell (0, 0) */
+    NkBoolean                 m_isValid;     /**< whether <tt>m_oriTile</tt> is valid */
+    NkSize                    m_nDirty;      /**< number of dirty cells */
+    NkByte                   *mp_dirtyArr;   /**< one dirty flag per cell, row-major */
+    NkByte                   *mp_tmpDirty;   /**< scratch buffer for shifting dirty flags */
+    NkRectF                  *mp_tileDst;    /**< scratch buffer for tile destinations */
+    NkRectF                  *mp_tileSrc;    /**< scratch buffer for tile atlas regions */
+    NkRectF                  *mp_emptyDst;   /**< scratch buffer for empty cell destinations */
+};
+
+
+/** \cond INTERNAL */
+/**
+ * \brief  retrieves the total number of cells in the cache
+ * \param  [in] cachePtr pointer to the tile cache
+ * \return number of cells
+ */
+NK_INTERNAL NK_INLINE NkSize __NkInt_TileCache_GetCellCount(_In_ NkTileCache const *cachePtr) {
+    return (NkSize)(cachePtr->m_cacheSpec.m_cacheExt.m_width * cachePtr->m_cacheSpec.m_cacheExt.m_height);
+}
+
+/**
+ * \brief shifts the dirty flags by the given number of cells, marking all cells that are
+ *        uncovered by the shift as dirty
+ * \param [in, out] cachePtr pointer to the tile cache
+ * \param [in] cellOff number of cells the origin of the cache moved by
+ */
+NK_INTERNAL NkVoid __NkInt_TileCache_ShiftDirtyFlags(_Inout_ NkTileCache *cachePtr, _In_ NkPoint2D cellOff) {
+    NkInt64 const extX = (NkInt64)cachePtr->m_cacheSpec.m_cacheExt.m_width;
+    NkInt64 const extY = (NkInt64)cachePtr->m_cacheSpec.m_cacheExt.m_height;
+
+    NkSize nDirty = 0;
+    for (NkInt64 y = 0; y < extY; y++)
+        for (NkInt64 x = 0; x < extX; x++) {
+            NkInt64 const oldX = x + cellOff.m_xCoord;
+            NkInt64 const oldY = y + cellOff.m_yCoord;
+
+            /* Cells that were not cached before are dirty. */
+            NkByte const isDirty = oldX < 0 || oldX >= extX || oldY < 0 || oldY >= extY
+                ? 1
+                : cachePtr->mp_dirtyArr[oldY * extX + oldX]
+            ;
+
+            cachePtr->mp_tmpDirty[y * extX + x] = isDirty;
+            nDirty += isDirty;
+        }
+
+    /* Swap buffers. */
+    NkByte *tmpPtr = cachePtr->mp_dirtyArr;
+    cachePtr->mp_dirtyArr = cachePtr->mp_tmpDirty;
+    cachePtr->mp_tmpDirty = tmpPtr;
+    cachePtr->m_nDirty    = nDirty;
+}
+
+/**
+ * \brief  redraws all dirty cells into the cache's surface
+ * \param  [in, out] cachePtr pointer to the tile cache
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The function changes the current render target to the cache's surface.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_TileCache_RedrawDirty(_Inout_ NkTileCache *cachePtr) {
+    NkIRenderer *rdRef   = cachePtr->m_cacheSpec.mp_rdRef;
+    NkErrorCode  errCode = rdRef->VT->SetRenderTarget(rdRef, cachePtr->mp_surfPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* Collect all dirty cells, split into those with a tile and empty ones. */
+    NkSize const   extX    = (NkSize)cachePtr->m_cacheSpec.m_cacheExt.m_width;
+    NkSize const   nCells  = __NkInt_TileCache_GetCellCount(cachePtr);
+    NkFloat const  tileW   = (NkFloat)cachePtr->m_cacheSpec.m_tileSize.m_width;
+    NkFloat const  tileH   = (NkFloat)cachePtr->m_cacheSpec.m_tileSize.m_height;
+    NkSize         nTiles  = 0;
+    NkSize         nEmpty  = 0;
+    for (NkSize i = 0; i < nCells; i++) {
+        if (!cachePtr->mp_dirtyArr[i])
+            continue;
+
+        NkSize const  cellX   = i % extX;
+        NkSize const  cellY   = i / extX;
+        NkRectF const dstRect = {
+            .m_xCoord = (NkFloat)cellX * tileW,
+            .m_yCoord = (NkFloat)cellY * tileH,
+            .m_width  = tileW,
+            .m_height = tileH
+        };
+
+        NkPoint2D const tilePos = {
+            cachePtr->m_oriTile.m_xCoord + (NkInt64)cellX,
+            cachePtr->m_oriTile.m_yCoord + (NkInt64)cellY
+        };
+        if ((*cachePtr->m_cacheSpec.mp_fetchFn)(cachePtr->m_cacheSpec.mp_extraCxt, tilePos, &cachePtr->mp_tileSrc[nTiles]))
+            cachePtr->mp_tileDst[nTiles++] = dstRect;
+        else
+            cachePtr->mp_emptyDst[nEmpty++] = dstRect;
+    }
+
+    /* Submit both batches. */
+    if (nTiles > 0) {
+        errCode = rdRef->VT->DrawTextureBatch(
+            rdRef,
+            cachePtr->m_cacheSpec.mp_tileAtlas,
+            nTiles,
+            cachePtr->mp_tileDst,
+            cachePtr->mp_tileSrc
+        );
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+    if (nEmpty > 0) {
+        errCode = rdRef->VT->DrawTextureBatch(rdRef, cachePtr->mp_emptyTex, nEmpty, cachePtr->mp_emptyDst, NULL);
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+
+    /* All cells are up-to-date now. */
+    memset(cachePtr->mp_dirtyArr, 0, nCells);
+    cachePtr->m_nDirty = 0;
+    return NkErr_Ok;
+}
+/** \endcond */
+
+
+_Return_ok_ NkErrorCode NK_CALL NkTileCacheCreate(
+    _In_       NkTileCacheSpecification const *cacheSpec,
+    _Init_ptr_ NkTileCache **cachePtr
+) {
+    NK_ASSERT(cacheSpec != NULL && cacheSpec->m_structSize > 0, NkErr_InParameter);
+    NK_ASSERT(cacheSpec->mp_rdRef != NULL && cacheSpec->mp_tileAtlas != NULL, NkErr_InParameter);
+    NK_ASSERT(cacheSpec->mp_fetchFn != NULL, NkErr_InParameter);
+    NK_ASSERT(cacheSpec->m_tileSize.m_width > 0 && cacheSpec->m_tileSize.m_height > 0, NkErr_InParameter);
+    NK_ASSERT(cacheSpec->m_cacheExt.m_width > 0 && cacheSpec->m_cacheExt.m_height > 0, NkErr_InParameter);
+    NK_ASSERT(cachePtr != NULL, NkErr_OutptrParameter);
+
+    /* Allocate memory for the cache. */
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof **cachePtr, 0, NK_TRUE, (NkVoid **)cachePtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    NkTileCache *actCache = *cachePtr;
+    NkIRenderer *rdRef    = cacheSpec->mp_rdRef;
+    actCache->m_cacheSpec = *cacheSpec;
+
+    /* Allocate the per-cell buffers. All cells start out dirty. */
+    NkSize const nCells = __NkInt_TileCache_GetCellCount(actCache);
+    if (   (errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nCells, 0, NK_FALSE, (NkVoid **)&actCache->mp_dirtyArr)) != NkErr_Ok
+        || (errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nCells, 0, NK_FALSE, (NkVoid **)&actCache->mp_tmpDirty)) != NkErr_Ok
+        || (errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nCells * sizeof(NkRectF), 0, NK_FALSE, (NkVoid **)&actCache->mp_tileDst)) != NkErr_Ok
+        || (errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nCells * sizeof(NkRectF), 0, NK_FALSE, (NkVoid **)&actCache->mp_tileSrc)) != NkErr_Ok
+        || (errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), nCells * sizeof(NkRectF), 0, NK_FALSE, (NkVoid **)&actCache->mp_emptyDst)) != NkErr_Ok
+    ) goto lbl_ONERROR;
+    NkTileCacheInvalidate(actCache);
+
+    /* Create the surface. */
+    errCode = rdRef->VT->CreateSurface(rdRef, (NkSize2D){
+        cacheSpec->m_cacheExt.m_width * cacheSpec->m_tileSize.m_width,
+        cacheSpec->m_cacheExt.m_height * cacheSpec->m_tileSize.m_height
+    }, &actCache->mp_surfPtr);
+    if (errCode != NkErr_Ok) {
+        NK_LOG_ERROR("Failed to create tile cache surface. Reason: %s (%i)", NkGetErrorCodeStr(errCode)->mp_dataPtr, (int)errCode);
+
+        goto lbl_ONERROR;
+    }
+
+    /*
+     * Create a single-pixel texture in the empty color. Empty cells are drawn by
+     * stretching it so that they can be submitted as a batch, too.
+     */
+    NkDIBitmap emptyBmp;
+    NkRgbaColor emptyCol = cacheSpec->m_emptyCol;
+    errCode = NkDIBitmapCreate(&(NkBitmapSpecification){
+        .m_structSize = sizeof(NkBitmapSpecification),
+        .m_bmpWidth   = 1,
+        .m_bmpHeight  = 1,
+        .m_bitsPerPx  = 24,
+        .m_bmpFlags   = NkBmpFlag_None
+    }, &emptyCol, &emptyBmp);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+    errCode = rdRef->VT->CreateTexture(rdRef, &emptyBmp, &actCache->mp_emptyTex);
+    NkDIBitmapDestroy(&emptyBmp);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONERROR;
+
+    /* Keep the renderer alive for as long as the cache exists. */
+    rdRef->VT->AddRef(rdRef);
+    return NkErr_Ok;
+
+lbl_ONERROR:
+    if (actCache->mp_surfPtr != NULL)
+        NK_IGNORE_RETURN_VALUE(rdRef->VT->DeleteResource(rdRef, &actCache->mp_surfPtr));
+    NkGPFree(actCache->mp_emptyDst);
+    NkGPFree(actCache->mp_tileSrc);
+    NkGPFree(actCache->mp_tileDst);
+    NkGPFree(actCache->mp_tmpDirty);
+    NkGPFree(actCache->mp_dirtyArr);
+    NkGPFree(actCache);
+
+    *cachePtr = NULL;
+    return errCode;
+}
+
+NkVoid NK_CALL NkTileCacheDestroy(_Uninit_ptr_ NkTileCache **cachePtr) {
+    NK_ASSERT(cachePtr != NULL, NkErr_InOutParameter);
+
+    if (*cachePtr == NULL)
+        return;
+    NkTileCache *actCache = *cachePtr;
+    NkIRenderer *rdRef    = actCache->m_cacheSpec.mp_rdRef;
+
+    /* Delete renderer resources. */
+    NK_IGNORE_RETURN_VALUE(rdRef->VT->DeleteResource(rdRef, &actCache->mp_emptyTex));
+    NK_IGNORE_RETURN_VALUE(rdRef->VT->DeleteResource(rdRef, &actCache->mp_surfPtr));
+    rdRef->VT->Release(rdRef);
+
+    /* Free memory. */
+    NkGPFree(actCache->mp_emptyDst);
+    NkGPFree(actCache->mp_tileSrc);
+    NkGPFree(actCache->mp_tileDst);
+    NkGPFree(actCache->mp_tmpDirty);
+    NkGPFree(actCache->mp_dirtyArr);
+    NkGPFree(actCache);
+
+    *cachePtr = NULL;
+}
+
+NkVoid NK_CALL NkTileCacheInvalidate(_Inout_ NkTileCache *cachePtr) {
+    NK_ASSERT(cachePtr != NULL, NkErr_InOutParameter);
+
+    cachePtr->m_nDirty = __NkInt_TileCache_GetCellCount(cachePtr);
+    memset(cachePtr->mp_dirtyArr, 1, cachePtr->m_nDirty);
+}
+
+NkVoid NK_CALL NkTileCacheMarkDirty(_Inout_ NkTileCache *cachePtr, _In_ NkPoint2D tilePos) {
+    NK_ASSERT(cachePtr != NULL, NkErr_InOutParameter);
+
+    /* Tiles outside of the cached area are fetched anyway once they become visible. */
+    NkInt64 const cellX = tilePos.m_xCoord - cachePtr->m_oriTile.m_xCoord;
+    NkInt64 const cellY = tilePos.m_yCoord - cachePtr->m_oriTile.m_yCoord;
+    if (   !cachePtr->m_isValid
+        || cellX < 0 || cellX >= (NkInt64)cachePtr->m_cacheSpec.m_cacheExt.m_width
+        || cellY < 0 || cellY >= (NkInt64)cachePtr->m_cacheSpec.m_cacheExt.m_height
+    ) return;
+
+    NkByte *flagPtr = &cachePtr->mp_dirtyArr[cellY * (NkInt64)cachePtr->m_cacheSpec.m_cacheExt.m_width + cellX];
+    cachePtr->m_nDirty += !*flagPtr;
+    *flagPtr = 1;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkTileCacheRender(
+    _Inout_ NkTileCache *cachePtr,
+    _In_    NkVec2F camPos,
+    _In_    NkRectF const *dstRect
+) {
+    NK_ASSERT(cachePtr != NULL, NkErr_InOutParameter);
+    NK_ASSERT(dstRect != NULL, NkErr_InParameter);
+
+    NkIRenderer  *rdRef   = cachePtr->m_cacheSpec.mp_rdRef;
+    NkSize2D const tileSz = cachePtr->m_cacheSpec.m_tileSize;
+    NkSize2D const extent = cachePtr->m_cacheSpec.m_cacheExt;
+
+    /* Calculate the tile that is now in the top-left corner. */
+    NkPoint2D const newOri = {
+        (NkInt64)floorf(camPos.m_xVal / (NkFloat)tileSz.m_width),
+        (NkInt64)floorf(camPos.m_yVal / (NkFloat)tileSz.m_height)
+    };
+    if (!cachePtr->m_isValid)
+        NkTileCacheInvalidate(cachePtr);
+    else if (newOri.m_xCoord != cachePtr->m_oriTile.m_xCoord || newOri.m_yCoord != cachePtr->m_oriTile.m_yCoord) {
+        NkPoint2D const cellOff = {
+            newOri.m_xCoord - cachePtr->m_oriTile.m_xCoord,
+            newOri.m_yCoord - cachePtr->m_oriTile.m_yCoord
+        };
+
+        if (   cellOff.m_xCoord <= -(NkInt64)extent.m_width  || cellOff.m_xCoord >= (NkInt64)extent.m_width
+            || cellOff.m_yCoord <= -(NkInt64)extent.m_height || cellOff.m_yCoord >= (NkInt64)extent.m_height
+        ) {
+            /* Nothing of the old contents is visible anymore. */
+            NkTileCacheInvalidate(cachePtr);
+        } else {
+            /* Move the still-visible tiles and only redraw the uncovered edges. */
+            NkErrorCode errCode = rdRef->VT->ScrollSurface(rdRef, cachePtr->mp_surfPtr, (NkPoint2D){
+                -cellOff.m_xCoord * (NkInt64)tileSz.m_width,
+                -cellOff.m_yCoord * (NkInt64)tileSz.m_height
+            });
+            if (errCode != NkErr_Ok)
+                NkTileCacheInvalidate(cachePtr);
+            else
+                __NkInt_TileCache_ShiftDirtyFlags(cachePtr, cellOff);
+        }
+    }
+    cachePtr->m_oriTile = newOri;
+    cachePtr->m_isValid = NK_TRUE;
+
+    /* Bring dirty cells up-to-date. */
+    if (cachePtr->m_nDirty > 0) {
+        NkErrorCode errCode = __NkInt_TileCache_RedrawDirty(cachePtr);
+
+        NK_IGNORE_RETURN_VALUE(rdRef->VT->SetRenderTarget(rdRef, NULL));
+        if (errCode != NkErr_Ok) {
+            /* Try again from scratch next frame. */
+            cachePtr->m_isValid = NK_FALSE;
+
+            return errCode;
+        }
+    }
+
+    /* Present the visible part of the cache, including the sub-tile offset. */
+    NkFloat const offX = camPos.m_xVal - (NkFloat)(newOri.m_xCoord * (NkInt64)tileSz.m_width);
+    NkFloat const offY = camPos.m_yVal - (NkFloat)(newOri.m_yCoord * (NkInt64)tileSz.m_height);
+    NkFloat const srcW = NK_MIN(dstRect->m_width, (NkFloat)(extent.m_width * tileSz.m_width) - offX);
+    NkFloat const srcH = NK_MIN(dstRect->m_height, (NkFloat)(extent.m_height * tileSz.m_height) - offY);
+    return rdRef->VT->DrawTexture(
+        rdRef,
+        &(NkRectF){ dstRect->m_xCoord, dstRect->m_yCoord, srcW, srcH },
+        cachePtr->mp_surfPtr,
+        &(NkRectF){ offX, offY, srcW, srcH }
+    );
+}
+
+
+#undef NK_NAMESPACE
+
+
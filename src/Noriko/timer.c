@@ -17,6 +17,18 @@
 #define NK_NAMESPACE "nk::timer"
 
 
+/* Read the time-stamp counter directly if the target is an x86 processor. */
+#if (defined _M_X64 || defined _M_IX86 || defined __x86_64__ || defined __i386__)
+    #if (defined _MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+        #include <cpuid.h>
+    #endif
+
+    #define NK_TI_USE_TSC
+#endif
+
 /* Noriko includes */
 #include <include/Noriko/timer.h>
 #include <include/Noriko/platform.h>
@@ -73,6 +85,19 @@ NK_NATIVE typedef struct __NkInt_TimingDeviceContext {
         NkUint64  m_timerFrequency; /**< frequency of the underlying native timing device */
         NkUint64  m_globalBias;     /**< overhead of the timing functions themselves */
     };
+
+    /**
+     * \brief state of the fast timestamp source (see <tt>NkTimerGetFastTicks()</tt>)
+     * \note  While \c m_isTscUsed is \c NK_FALSE, fast ticks are ticks of the native
+     *        timing device.
+     */
+    struct {
+        NkBoolean m_isTscUsed;     /**< whether fast ticks are read from the time-stamp counter */
+        NkUint64  m_fastFrequency; /**< calibrated frequency of the time-stamp counter */
+        NkUint64  m_fastBase;      /**< time-stamp counter value taken when calibrating */
+        NkUint64  m_ticksBase;     /**< native timestamp taken along with \c m_fastBase */
+        NkDouble  m_fastToTicks;   /**< ratio of the native timer frequency and \c m_fastFrequency */
+    };
 } __NkInt_TimingDeviceContext;
 /**
  * \brief actual instance of the global timer context
@@ -118,6 +143,70 @@ NK_INTERNAL NkUint64 __NkInt_Timer_GetOverhead(NkVoid) {
     return diffSum / gl_TimerBiasIterCount;
 }
 
+/**
+ * \brief  checks whether the time-stamp counter runs at a constant rate on all cores
+ * \return \c NK_TRUE if the processor reports an invariant TSC, \c NK_FALSE if not
+ * \note   Hypervisors often do not report the feature; the fallback is used then.
+ */
+NK_INTERNAL NkBoolean __NkInt_Timer_IsTscInvariant(NkVoid) {
+#if (defined NK_TI_USE_TSC) && (defined _MSC_VER)
+    int cpuInfo[4];
+
+    __cpuid(cpuInfo, (int)0x80000000);
+    if ((unsigned int)cpuInfo[0] < 0x80000007U)
+        return NK_FALSE;
+    __cpuid(cpuInfo, (int)0x80000007);
+
+    return (cpuInfo[3] >> 8 & 1) != 0;
+#elif (defined NK_TI_USE_TSC)
+    unsigned int eaxVal, ebxVal, ecxVal, edxVal;
+    if (!__get_cpuid(0x80000007U, &eaxVal, &ebxVal, &ecxVal, &edxVal))
+        return NK_FALSE;
+
+    return (edxVal >> 8 & 1) != 0;
+#else
+    return NK_FALSE;
+#endif
+}
+
+/**
+ * \brief calibrates the time-stamp counter against the native timing device
+ * \note  If the counter is not invariant, the fast timestamp source stays the native
+ *        timing device.
+ */
+NK_INTERNAL NkVoid __NkInt_Timer_CalibrateFastTicks(NkVoid) {
+#if (defined NK_TI_USE_TSC)
+    if (!__NkInt_Timer_IsTscInvariant()) {
+        NK_LOG_INFO("Time-stamp counter is not invariant; fast timestamps use the high-precision timer.");
+
+        return;
+    }
+
+    /*
+     * Count cycles over 20 ms. Both timers are read in the same order at the start and
+     * at the end, so the time the reads take cancels out.
+     */
+    NkUint64 const startTicks = __NkVirt_Timer_GetCurrentTicks();
+    NkUint64 const startTsc   = (NkUint64)__rdtsc();
+    NkUint64       endTicks;
+    do
+        endTicks = __NkVirt_Timer_GetCurrentTicks();
+    while (endTicks - startTicks < gl_tdContext.m_timerFrequency / 50);
+    NkUint64 const endTsc = (NkUint64)__rdtsc();
+
+    NkDouble const tscFreq = (NkDouble)(endTsc - startTsc) * (NkDouble)gl_tdContext.m_timerFrequency / (NkDouble)(endTicks - startTicks);
+    if (tscFreq < 1.)
+        return;
+
+    gl_tdContext.m_fastFrequency = (NkUint64)tscFreq;
+    gl_tdContext.m_fastBase      = startTsc;
+    gl_tdContext.m_ticksBase     = startTicks;
+    gl_tdContext.m_fastToTicks   = (NkDouble)gl_tdContext.m_timerFrequency / tscFreq;
+    gl_tdContext.m_isTscUsed     = NK_TRUE;
+    NK_LOG_INFO("Fast timestamps use the invariant time-stamp counter at %.3f MHz.", tscFreq / 1e+6);
+#endif
+}
+
 /**
  * \brief  initializes the static timing device context
  * \return \c NkErr_Ok on success, non-zero on failure
@@ -128,8 +217,11 @@ NK_INTERNAL NkUint64 __NkInt_Timer_GetOverhead(NkVoid) {
  *         exist.
  */
 NK_INTERNAL NkErrorCode __NkInt_Timer_InitializeStaticContext(NkVoid) {
-    /* Determine timing device overhead. */
-    gl_tdContext.m_globalBias = __NkInt_Timer_GetOverhead();
+    /* Determine timing device frequency and overhead. */
+    gl_tdContext.m_timerFrequency = __NkVirt_Timer_GetFrequency();
+    gl_tdContext.m_globalBias     = __NkInt_Timer_GetOverhead();
+
+    __NkInt_Timer_CalibrateFastTicks();
     return NkErr_Ok;
 }
 
@@ -277,6 +369,33 @@ NkUint64 NK_CALL NkTimerGetFrequency(NkVoid) {
 }
 
 
+NkUint64 NK_CALL NkTimerGetFastTicks(NkVoid) {
+#if (defined NK_TI_USE_TSC)
+    if (gl_tdContext.m_isTscUsed)
+        return (NkUint64)__rdtsc();
+#endif
+
+    return __NkVirt_Timer_GetCurrentTicks();
+}
+
+NkUint64 NK_CALL NkTimerGetFastFrequency(NkVoid) {
+    return gl_tdContext.m_isTscUsed ? gl_tdContext.m_fastFrequency : __NkVirt_Timer_GetFrequency();
+}
+
+NkDouble NK_CALL NkTimerFastTicksToTime(_In_ NkUint64 nTicks, _In_ NkTimerPrecision precId) {
+    return (NkDouble)nTicks * (NkDouble)precId / (NkDouble)NkTimerGetFastFrequency();
+}
+
+NkUint64 NK_CALL NkTimerFastTicksToTicks(_In_ NkUint64 fastTicks) {
+    if (!gl_tdContext.m_isTscUsed)
+        return fastTicks;
+
+    /* Timestamps may lie before the calibration, so the distance is signed. */
+    NkInt64 const fastDist = (NkInt64)(fastTicks - gl_tdContext.m_fastBase);
+    return gl_tdContext.m_ticksBase + (NkUint64)(NkInt64)((NkDouble)fastDist * gl_tdContext.m_fastToTicks);
+}
+
+
 /** \cond INTERNAL */
 /**
  * \brief info for the <em>timing device context</em> component 
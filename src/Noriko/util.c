@@ -22,8 +22,16 @@
 #include <stdarg.h>
 #include <string.h>
 
+/* Use SSE2 for bulk random number generation and UUID conversion if the target supports it. */
+#if (defined _M_X64 || defined _M_IX86 || defined __SSE2__)
+    #include <emmintrin.h>
+
+    #define NK_UTIL_USE_SSE2
+#endif
+
 /* Noriko includes */
 #include <include/Noriko/util.h>
+#include <include/Noriko/platform.h>
 #include <include/Noriko/log.h>
 #include <include/Noriko/timer.h>
 #include <include/Noriko/window.h>
@@ -53,6 +61,25 @@ NK_NATIVE typedef struct __NkInt_RandomNumberGeneratorContext {
  */
 NK_INTERNAL __NkInt_RandomNumberGeneratorContext gl_RandContext;
 
+/**
+ * \struct __NkInt_PRNGStream
+ * \brief  represents the random number stream of a single thread
+ *
+ * Every thread draws its numbers from its own streams so that generating random numbers
+ * never contends on a lock. The streams are taken from the global state when the thread
+ * first generates a number; the global state is then advanced by 2^128 numbers so that the
+ * streams of different threads never overlap.
+ */
+NK_NATIVE typedef struct __NkInt_PRNGStream {
+    NkUint64  m_stateArr[4];   /**< state used for single numbers */
+    NkUint64  m_laneArr[4][2]; /**< state of the two lanes used by <tt>NkPRNGFill()</tt>, word-interleaved */
+    NkBoolean m_isSeeded;      /**< whether the streams have been taken from the global state */
+} __NkInt_PRNGStream;
+/**
+ * \brief random number streams of the current thread
+ */
+NK_INTERNAL NK_THREADLOCAL __NkInt_PRNGStream gl_ThreadRand;
+
 /**
  * \struct __NkInt_Variant
  * \brief  provides the internal implementation of the variant type
@@ -134,38 +161,171 @@ NK_EXTERN NK_VIRTUAL _Return_ok_ NkErrorCode NK_CALL __NkVirt_PRNG_GenerateSeed(
 
 /**
  * \brief runs the \c Xoshiro256 algorithm to generate a pseudo-random number
+ * \param [in, out] stateArr state of the generator
  * \param [out] dstPtr pointer to an NkUint64 variable that will receive the generated
  *              random number
  * \see   https://de.wikipedia.org/wiki/Xorshift#Xoroshiro_und_Xoshiro
  * \todo  fix naming scheme of some internal functions (_ between module and fn name)
  */
-NK_INTERNAL NK_INLINE NkVoid __NkInt_PRNGXoshiro256(_Out_ NkUint64 *dstPtr) {
-    NK_INTERNAL NkUint64 *const s0 = (NkUint64 *const)&gl_RandContext.m_seedArr[0 * sizeof(NkUint64)];
-    NK_INTERNAL NkUint64 *const s1 = (NkUint64 *const)&gl_RandContext.m_seedArr[1 * sizeof(NkUint64)];
-    NK_INTERNAL NkUint64 *const s2 = (NkUint64 *const)&gl_RandContext.m_seedArr[2 * sizeof(NkUint64)];
-    NK_INTERNAL NkUint64 *const s3 = (NkUint64 *const)&gl_RandContext.m_seedArr[3 * sizeof(NkUint64)];
-
+NK_INTERNAL NK_INLINE NkVoid __NkInt_PRNGXoshiro256(_Inout_updates_(4) NkUint64 *stateArr, _Out_ NkUint64 *dstPtr) {
     /* Get next number in the sequence. */
-    *dstPtr = *s0 + *s3;
+    *dstPtr = stateArr[0] + stateArr[3];
 
     /* Update state. */
-    NkUint64 const t = *s1 << 17;
-    *s2 ^= *s0;
-    *s3 ^= *s1;
-    *s1 ^= *s2;
-    *s0 ^= *s3;
-    *s2 ^= t;
-    *s3 = *s3 << 45 | *s3 >> (64 - 45);
+    NkUint64 const t = stateArr[1] << 17;
+    stateArr[2] ^= stateArr[0];
+    stateArr[3] ^= stateArr[1];
+    stateArr[1] ^= stateArr[2];
+    stateArr[0] ^= stateArr[3];
+    stateArr[2] ^= t;
+    stateArr[3] = stateArr[3] << 45 | stateArr[3] >> (64 - 45);
+}
+
+/**
+ * \brief advances the given state by 2^128 numbers
+ * \param [in, out] stateArr state of the generator
+ * \note  This is the \c jump() function published alongside \c Xoshiro256.
+ */
+NK_INTERNAL NkVoid __NkInt_PRNGJump(_Inout_updates_(4) NkUint64 *stateArr) {
+    NK_INTERNAL NkUint64 const gl_c_JumpPoly[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+
+    NkUint64 jmpState[4] = { 0 };
+    NkUint64 dummyVal;
+    for (NkSize i = 0; i < NK_ARRAYSIZE(gl_c_JumpPoly); i++)
+        for (NkUint32 b = 0; b < 64; b++) {
+            if (gl_c_JumpPoly[i] & (NkUint64)1 << b)
+                for (NkSize j = 0; j < NK_ARRAYSIZE(jmpState); j++)
+                    jmpState[j] ^= stateArr[j];
+
+            __NkInt_PRNGXoshiro256(stateArr, &dummyVal);
+        }
+
+    memcpy(stateArr, jmpState, sizeof jmpState);
+}
+
+/**
+ * \brief takes a new set of streams for the current thread from the global state
+ * \param [out] strPtr pointer to the streams of the current thread
+ */
+NK_INTERNAL NkVoid __NkInt_PRNGSeedStream(_Out_ __NkInt_PRNGStream *strPtr) {
+    NkUint64 *globState = (NkUint64 *)gl_RandContext.m_seedArr;
+
+    NK_LOCK(gl_RandContext.m_mtxLock);
+    memcpy(strPtr->m_stateArr, globState, sizeof strPtr->m_stateArr);
+    __NkInt_PRNGJump(globState);
+    for (NkSize l = 0; l < NK_ARRAYSIZE(strPtr->m_laneArr[0]); l++) {
+        for (NkSize w = 0; w < NK_ARRAYSIZE(strPtr->m_laneArr); w++)
+            strPtr->m_laneArr[w][l] = globState[w];
+
+        __NkInt_PRNGJump(globState);
+    }
+    NK_UNLOCK(gl_RandContext.m_mtxLock);
+
+    strPtr->m_isSeeded = NK_TRUE;
+}
+
+/**
+ * \brief  retrieves the random number streams of the current thread
+ * \return pointer to the streams
+ * \note   The first call on every thread takes the lock of the global state once.
+ */
+NK_INTERNAL NK_INLINE __NkInt_PRNGStream *__NkInt_PRNGGetStream(NkVoid) {
+    __NkInt_PRNGStream *strPtr = &gl_ThreadRand;
+    if (!strPtr->m_isSeeded)
+        __NkInt_PRNGSeedStream(strPtr);
+
+    return strPtr;
+}
+
+#if (defined NK_UTIL_USE_SSE2)
+/**
+ * \brief  converts 16 hex digits to nibbles
+ * \param  [in] hexVec vector of 16 ASCII characters
+ * \param  [out] resPtr pointer to a variable that receives the nibble values
+ * \return \c NK_TRUE if all characters were hex digits, \c NK_FALSE otherwise
+ */
+NK_INTERNAL NK_INLINE NkBoolean __NkInt_UuidHexToNibbles_SSE2(_In_ __m128i hexVec, _Out_ __m128i *resPtr) {
+    /* Setting bit 5 maps upper-case letters to lower-case ones and leaves digits as they are. */
+    __m128i const lowVec   = _mm_or_si128(hexVec, _mm_set1_epi8(0x20));
+    __m128i const isDigit  = _mm_and_si128(_mm_cmpgt_epi8(hexVec, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(hexVec, _mm_set1_epi8('9' + 1)));
+    __m128i const isLetter = _mm_and_si128(_mm_cmpgt_epi8(lowVec, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lowVec, _mm_set1_epi8('f' + 1)));
+
+    *resPtr = _mm_or_si128(
+        _mm_and_si128(_mm_sub_epi8(hexVec, _mm_set1_epi8('0')), isDigit),
+        _mm_and_si128(_mm_sub_epi8(lowVec, _mm_set1_epi8('a' - 10)), isLetter)
+    );
+    return _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) == 0xFFFF;
 }
 
 /**
- * \brief carries out the generation of the random number, without locking
- * \param [out] dstPtr pointer to the memory that will receive the random bytes
+ * \brief  combines pairs of nibbles to bytes
+ * \param  [in] nibVec vector of 16 nibbles, high nibble first
+ * \return vector holding the 8 resulting bytes in the low byte of each 16-bit lane
  */
-NK_INTERNAL NK_INLINE NkVoid __NkInt_PRNGNextNoLock(_Out_ NkUint64 *dstPtr) {
-    __NkInt_PRNGXoshiro256(dstPtr);
+NK_INTERNAL NK_INLINE __m128i __NkInt_UuidNibblesToBytes_SSE2(_In_ __m128i nibVec) {
+    __m128i const hiPart = _mm_slli_epi16(_mm_and_si128(nibVec, _mm_set1_epi16(0x00FF)), 4);
+
+    return _mm_or_si128(hiPart, _mm_srli_epi16(nibVec, 8));
 }
 
+/**
+ * \brief  converts a UUID string in the 8-4-4-4-12 normal form
+ * \param  [in] uuidAsStr string representation of the UUID
+ * \param  [out] uuidPtr pointer to the UUID that receives the result
+ * \return \c NK_TRUE if the string was in normal form, \c NK_FALSE if the generic
+ *         conversion has to be used instead
+ */
+NK_INTERNAL NkBoolean __NkInt_UuidFromString_SSE2(_In_ char const *uuidAsStr, _Out_ NkUuid *uuidPtr) {
+    if (uuidAsStr[8] != '-' || uuidAsStr[13] != '-' || uuidAsStr[18] != '-' || uuidAsStr[23] != '-')
+        return NK_FALSE;
+
+    /* Remove the dashes so that the digits can be converted in two vectors. */
+    char hexBuf[32];
+    memcpy(&hexBuf[0],  &uuidAsStr[0],  8);
+    memcpy(&hexBuf[8],  &uuidAsStr[9],  4);
+    memcpy(&hexBuf[12], &uuidAsStr[14], 4);
+    memcpy(&hexBuf[16], &uuidAsStr[19], 4);
+    memcpy(&hexBuf[20], &uuidAsStr[24], 12);
+
+    __m128i loNibs, hiNibs;
+    if (   !__NkInt_UuidHexToNibbles_SSE2(_mm_loadu_si128((__m128i const *)&hexBuf[0]), &loNibs)
+        || !__NkInt_UuidHexToNibbles_SSE2(_mm_loadu_si128((__m128i const *)&hexBuf[16]), &hiNibs)
+    ) return NK_FALSE;
+
+    _mm_storeu_si128(
+        (__m128i *)uuidPtr,
+        _mm_packus_epi16(__NkInt_UuidNibblesToBytes_SSE2(loNibs), __NkInt_UuidNibblesToBytes_SSE2(hiNibs))
+    );
+    return NK_TRUE;
+}
+
+/**
+ * \brief converts the bytes of a UUID to 32 lower-case hex digits
+ * \param [in] uuidPtr pointer to the UUID
+ * \param [out] hexBuf buffer that receives the digits (not <tt>NUL</tt>-terminated)
+ */
+NK_INTERNAL NkVoid __NkInt_UuidToHex_SSE2(_In_ NkUuid const *uuidPtr, _Out_writes_(32) char *hexBuf) {
+    __m128i const byteVec = _mm_loadu_si128((__m128i const *)uuidPtr);
+    __m128i const nibMask = _mm_set1_epi8(0x0F);
+    __m128i const hiNibs  = _mm_and_si128(_mm_srli_epi16(byteVec, 4), nibMask);
+    __m128i const loNibs  = _mm_and_si128(byteVec, nibMask);
+
+    /* Interleave the nibbles so that the high nibble of every byte comes first. */
+    __m128i nibVecs[2] = { _mm_unpacklo_epi8(hiNibs, loNibs), _mm_unpackhi_epi8(hiNibs, loNibs) };
+    for (NkSize i = 0; i < NK_ARRAYSIZE(nibVecs); i++) {
+        /* '0' + n for digits, 'a' + n - 10 for letters */
+        __m128i const letterOff = _mm_and_si128(_mm_cmpgt_epi8(nibVecs[i], _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+
+        _mm_storeu_si128(
+            (__m128i *)&hexBuf[i * 16],
+            _mm_add_epi8(_mm_add_epi8(nibVecs[i], _mm_set1_epi8('0')), letterOff)
+        );
+    }
+}
+#endif
+
 /**
  * \brief   retrieves the size in bytes of the underlying type for the given variant type
  *          ID
@@ -280,7 +440,48 @@ _Return_ok_ NkErrorCode NK_CALL NkPRNGNext(_Out_ NkUint64 *outPtr) {
     NK_ASSERT(outPtr != NULL, NkErr_OutParameter);
 
     /* Get next random number. */
-    NK_SYNCHRONIZED(gl_RandContext.m_mtxLock, __NkInt_PRNGNextNoLock(outPtr));
+    __NkInt_PRNGXoshiro256(__NkInt_PRNGGetStream()->m_stateArr, outPtr);
+    return NkErr_Ok;
+}
+
+_Return_ok_ NkErrorCode NK_CALL NkPRNGFill(_Out_writes_(count) NkUint64 *bufPtr, _In_ NkSize count) {
+    NK_ASSERT(bufPtr != NULL || count == 0, NkErr_OutParameter);
+
+    __NkInt_PRNGStream *strPtr = __NkInt_PRNGGetStream();
+    NkSize i = 0;
+#if (defined NK_UTIL_USE_SSE2)
+    /*
+     * Run two independent generators side by side, one in each 64-bit half of the SSE2
+     * registers. The state stays in registers for the entire loop.
+     */
+    __m128i s0 = _mm_loadu_si128((__m128i const *)strPtr->m_laneArr[0]);
+    __m128i s1 = _mm_loadu_si128((__m128i const *)strPtr->m_laneArr[1]);
+    __m128i s2 = _mm_loadu_si128((__m128i const *)strPtr->m_laneArr[2]);
+    __m128i s3 = _mm_loadu_si128((__m128i const *)strPtr->m_laneArr[3]);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_si128((__m128i *)&bufPtr[i], _mm_add_epi64(s0, s3));
+
+        __m128i const t = _mm_slli_epi64(s1, 17);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi64(s3, 45), _mm_srli_epi64(s3, 64 - 45));
+    }
+    _mm_storeu_si128((__m128i *)strPtr->m_laneArr[0], s0);
+    _mm_storeu_si128((__m128i *)strPtr->m_laneArr[1], s1);
+    _mm_storeu_si128((__m128i *)strPtr->m_laneArr[2], s2);
+    _mm_storeu_si128((__m128i *)strPtr->m_laneArr[3], s3);
+#endif
+
+    /* Generate the rest (or everything, if SIMD is not available) one by one. */
+    NkUint64 stateArr[4];
+    memcpy(stateArr, strPtr->m_stateArr, sizeof stateArr);
+    for (; i < count; i++)
+        __NkInt_PRNGXoshiro256(stateArr, &bufPtr[i]);
+    memcpy(strPtr->m_stateArr, stateArr, sizeof stateArr);
+
     return NkErr_Ok;
 }
 
@@ -291,10 +492,9 @@ NkVoid NK_CALL NkUuidGenerate(_Out_ NkUuid *uuidPtr) {
     /* Cast UUID struct to internal representation. */
     __NkInt_Uuid *intUuid = (__NkInt_Uuid *)uuidPtr;
     /* Generate two random numbers. */
-    NK_SYNCHRONIZED(gl_RandContext.m_mtxLock, {
-        __NkInt_PRNGNextNoLock(&intUuid->m_asUi64[0]);
-        __NkInt_PRNGNextNoLock(&intUuid->m_asUi64[1]);
-    });
+    __NkInt_PRNGStream *strPtr = __NkInt_PRNGGetStream();
+    __NkInt_PRNGXoshiro256(strPtr->m_stateArr, &intUuid->m_asUi64[0]);
+    __NkInt_PRNGXoshiro256(strPtr->m_stateArr, &intUuid->m_asUi64[1]);
 
     /* Adjust version field. This implementation generates version 4 UUIDs. */
     intUuid->m_asByte[6] = 0b0100 << 4 | intUuid->m_asByte[6] & 0x0F;
@@ -309,16 +509,23 @@ NkBoolean NK_CALL NkUuidIsEqual(_In_ NkUuid const *fUuid, _In_ NkUuid const *sUu
         "Size and alignment requirement of type \"long long unsigned\" must be 8."
     );
 
-    return fUuid == sUuid || (NkBoolean)(
-           ((NkUint64 *)fUuid)[0] == ((NkUint64 *)sUuid)[0]
-        && ((NkUint64 *)fUuid)[1] == ((NkUint64 *)sUuid)[1]
-    );
+    /* Compare both halves at once so that the comparison does not branch. */
+    return (NkBoolean)(((
+          ((NkUint64 const *)fUuid)[0] ^ ((NkUint64 const *)sUuid)[0])
+        | (((NkUint64 const *)fUuid)[1] ^ ((NkUint64 const *)sUuid)[1])
+    ) == 0);
 }
 
 _Return_ok_ NkErrorCode NK_CALL NkUuidFromString(_I_bytes_(NK_UUIDLEN) char const *uuidAsStr, _Out_ NkUuid *uuidPtr) {
     NK_ASSERT(uuidAsStr != NULL, NkErr_InParameter);
     NK_ASSERT(uuidPtr != NULL, NkErr_OutParameter);
 
+#if (defined NK_UTIL_USE_SSE2)
+    /* Take the fast path for strings in normal form (which is virtually all of them). */
+    if (__NkInt_UuidFromString_SSE2(uuidAsStr, uuidPtr))
+        return NkErr_Ok;
+#endif
+
     NkInt32 i, j;
     for (i = 0, j = 0; j < 16 && *uuidAsStr ^ 0x00; i += 2, j++) {
         if (*uuidAsStr == '-')
@@ -354,6 +561,21 @@ char *NK_CALL NkUuidToString(_In_ NkUuid const *uuidPtr, _O_bytes_(NK_UUIDLEN) c
     NK_ASSERT(uuidPtr != NULL, NkErr_InParameter);
     NK_ASSERT(strBuf != NULL, NkErr_OutParameter);
 
+#if (defined NK_UTIL_USE_SSE2)
+    /* Convert all bytes at once, then insert the dashes of the 8-4-4-4-12 normal form. */
+    char hexBuf[32];
+    __NkInt_UuidToHex_SSE2(uuidPtr, hexBuf);
+
+    memcpy(&strBuf[0],  &hexBuf[0],  8);
+    memcpy(&strBuf[9],  &hexBuf[8],  4);
+    memcpy(&strBuf[14], &hexBuf[12], 4);
+    memcpy(&strBuf[19], &hexBuf[16], 4);
+    memcpy(&strBuf[24], &hexBuf[20], 12);
+    strBuf[8] = strBuf[13] = strBuf[18] = strBuf[23] = '-';
+    strBuf[36] = 0x00;
+
+    return strBuf;
+#else
     /* Save starting address for later return. */
     char *startBuf = strBuf;
 
@@ -368,6 +590,7 @@ char *NK_CALL NkUuidToString(_In_ NkUuid const *uuidPtr, _O_bytes_(NK_UUIDLEN) c
     *strBuf = 0x00;
 
     return startBuf;
+#endif
 }
 
 NkVoid NK_CALL NkUuidCopy(_In_ NkUuid const *srcPtr, _Out_ NkUuid *resPtr) {
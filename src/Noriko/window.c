@@ -130,7 +130,9 @@ NkStringView const *NK_CALL NkWindowGetFlagStr(_In_ NkWindowFlags wndFlag) {
         [NkWndFlag_AlwaysOnTop]    = NK_MAKE_STRING_VIEW(NK_ESC(NkWndFlag_AlwaysOnTop)),
         [NkWndFlag_MainWindow]     = NK_MAKE_STRING_VIEW(NK_ESC(NkWndFlag_MainWindow)),
         [NkWndFlag_DragResizable]  = NK_MAKE_STRING_VIEW(NK_ESC(NkWndFlag_DragResizable)),
-        [NkWndFlag_DragMovable]    = NK_MAKE_STRING_VIEW(NK_ESC(NkWndFlag_DragMovable))
+        [NkWndFlag_DragMovable]    = NK_MAKE_STRING_VIEW(NK_ESC(NkWndFlag_DragMovable)),
+        [NkWndFlag_RenderThread]   = NK_MAKE_STRING_VIEW(NK_ESC(NkWndFlag_RenderThread)),
+        [NkWndFlag_Mipmaps]        = NK_MAKE_STRING_VIEW(NK_ESC(NkWndFlag_Mipmaps))
     };
     /** \endcond */
 
@@ -174,7 +176,7 @@ NK_COMPONENT_DEFINE(Window) {
     .m_compUuid     = { 0x427e1403, 0x8a3f, 0x4c77, 0x983b7ce26bb2a4f5 },
     .mp_clsId       = NKOM_CLSIDOF(NkIWindow),
     .m_compIdent    = NK_MAKE_STRING_VIEW("window"),
-    .m_compFlags    = 0,
+    .m_compFlags    = NkCompFlag_MainThread,
     .m_isNkOM       = NK_TRUE,
 
     .mp_fnQueryInst = &__NkVirt_Window_QueryInstance,
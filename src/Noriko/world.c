@@ -29,14 +29,59 @@
 #include <include/Noriko/path.h>
 #include <include/Noriko/noriko.h>
 #include <include/Noriko/comp.h>
+#include <include/Noriko/tilecache.h>
+#include <include/Noriko/atlas.h>
+#include <include/Noriko/chunk.h>
+#include <include/Noriko/capture.h>
+#include <include/Noriko/spatial.h>
+#include <include/Noriko/ecs.h>
+#include <include/Noriko/anim.h>
+#include <include/Noriko/interp.h>
+#include <include/Noriko/pathfind.h>
 
 #include <include/Noriko/dstruct/string.h>
 
 #include <math.h>
+#include <string.h>
 /** \cond INTERNAL */
 /**
  */
 #define N(x, y) ((NkUint32)((((NkUint16)(x) & 0xFFFF) | (((NkUint16)(y) & 0xFFFF)) << 16)))
+/**
+ * \brief extents of the tile cache, in tiles (16 x 16 visible tiles plus one extra row
+ *        and column for the sub-tile camera offset)
+ */
+#define __NkInt_WorldLayer_TileCacheExt ((NkSize2D){ 17, 17 })
+/**
+ * \brief extents of a world chunk, in tiles
+ */
+#define __NkInt_WorldLayer_ChunkExt     ((NkSize2D){ 16, 16 })
+/**
+ * \brief edge length of a cell of the entity grid, in pixels (4 x 4 tiles)
+ */
+#define __NkInt_WorldLayer_EntCellSize  ((NkFloat)(4 * 32))
+/**
+ * \brief number of facing directions; also the number of rows of a character sheet
+ */
+#define __NkInt_WorldLayer_NumDirs      ((NkUint32)(4))
+
+
+/**
+ * \enum  __NkInt_MotionField
+ * \brief fields of the motion component; every field is stored in an array of its own
+ */
+NK_NATIVE typedef enum __NkInt_MotionField {
+    __NkInt_MotionFld_PosX,       /**< current x-coordinate (NkFloat) */
+    __NkInt_MotionFld_PosY,       /**< current y-coordinate (NkFloat) */
+    __NkInt_MotionFld_DstX,       /**< x-coordinate of the current move target (NkFloat) */
+    __NkInt_MotionFld_DstY,       /**< y-coordinate of the current move target (NkFloat) */
+    __NkInt_MotionFld_Speed,      /**< move speed, in pixels per second (NkFloat) */
+    __NkInt_MotionFld_IsMoving,   /**< whether the entity is moving towards its target (NkByte) */
+    __NkInt_MotionFld_Dir,        /**< facing direction, also the row of the sprite sheet (NkInt32) */
+    __NkInt_MotionFld_GridHandle, /**< handle of the entity in the entity grid (NkSpatialHandle) */
+
+    __NkInt_MotionFld_Count__     /**< *only used internally* */
+} __NkInt_MotionField;
 /** \endcond */
 
 
@@ -49,24 +94,33 @@ NK_NATIVE typedef struct __NkInt_WorldLayer {
     NkIWindow          *mp_rdTarget;     /**< cached reference to the render window */
     NkIRenderer        *mp_rdRef;        /**< cached reference to the window's renderer */
     NkIInput           *mp_ialRef;       /**< cached reference to the IAL */
-    NkRendererResource *mp_mainTexAtlas; /**< texture atlas for world, etc. */
-    NkRendererResource *mp_texAtlasMask; /**< texture atlas transparency mask */
-    NkRendererResource *mp_playerAtlas;
-    NkRendererResource *mp_plAtlasMask;
-
-    NkVec2F             m_prevPos;
-    NkVec2F             m_playerPos;
-    NkVec2F             m_targetPos;
-    NkBoolean           m_isMoving;
+    NkTextureAtlas     *mp_texAtlas;     /**< texture atlas for world, player, etc. */
+    NkSubTextureId      m_tileFirstId;   /**< sub-texture of the first world tile */
+    NkUint32            m_tileCols;      /**< number of tile columns in the world tile set */
+    NkUint32            m_tileRows;      /**< number of tile rows in the world tile set */
+    NkSubTextureId      m_plFirstId;     /**< sub-texture of the first player frame */
+    NkUint32            m_plCols;        /**< number of frame columns in the player sheet */
+    NkTileCache        *mp_tileCache;    /**< cached static tile layer */
+    NkChunkStreamer    *mp_chunkStr;     /**< streamer for the chunks around the player */
+    NkPathService      *mp_pathSvc;      /**< pathfinding on the streamed tiles */
+    NkSpatialGrid      *mp_entGrid;      /**< spatial index of all entities on the map */
+    NkEcsRegistry      *mp_ecsReg;       /**< state of all entities on the map */
+    NkEcsComponentType  m_motionType;    /**< type of the motion component */
+    NkEcsComponentType  m_animType;      /**< type of the animator component */
+    NkEcsComponentType  m_interpType;    /**< type of the interpolation component */
+    NkEcsEntity         m_plEntity;      /**< the player's entity */
+    NkAnimClip         *mp_walkClips[__NkInt_WorldLayer_NumDirs]; /**< player walk cycle per direction */
+    NkAnimClip         *mp_idleClips[__NkInt_WorldLayer_NumDirs]; /**< player idle frame per direction */
+
     NkVec2F             m_lvel;
     NkVec2F             m_vel;
-    NkUint64            m_lastAnimFrame;
-    NkVec2F             m_currAnimFrame;
-    NkInt32             m_dir;
     NkTimer             t;
-    NkFloat             m_moveSpeed;
     NkTimer             t2;
     int                 state;
+
+    NkBoolean           m_isBufInput;    /**< whether the IAL is in buffered mode */
+    NkUint32            m_heldKeys;      /**< movement keys currently held down (buffered mode) */
+    NkUint32            m_tickKeys;      /**< movement keys pressed during the current tick (buffered mode) */
 } __NkInt_WorldLayer;
 
 
@@ -161,10 +215,16 @@ NK_INTERNAL NkVoid __NkInt_WorldLayer_DeleteResources(_Inout_ __NkInt_WorldLayer
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
     /* Delete resources. */
-    self->mp_rdRef->VT->DeleteResource(self->mp_rdRef, &self->mp_mainTexAtlas);
-    self->mp_rdRef->VT->DeleteResource(self->mp_rdRef, &self->mp_texAtlasMask);
-    self->mp_rdRef->VT->DeleteResource(self->mp_rdRef, &self->mp_playerAtlas);
-    self->mp_rdRef->VT->DeleteResource(self->mp_rdRef, &self->mp_plAtlasMask);
+    NkEcsDestroy(&self->mp_ecsReg);
+    for (NkUint32 i = 0; i < __NkInt_WorldLayer_NumDirs; i++) {
+        NkAnimClipDestroy(&self->mp_walkClips[i]);
+        NkAnimClipDestroy(&self->mp_idleClips[i]);
+    }
+    NkSpatialGridDestroy(&self->mp_entGrid);
+    NkTileCacheDestroy(&self->mp_tileCache);
+    NkPathServiceDestroy(&self->mp_pathSvc);
+    NkChunkStreamerDestroy(&self->mp_chunkStr);
+    NkTextureAtlasDestroy(&self->mp_texAtlas);
 
     /* Release renderer, IAL, and window. */
     self->mp_ialRef->VT->Release(self->mp_ialRef);
@@ -178,86 +238,242 @@ NK_INTERNAL NkVoid __NkInt_WorldLayer_ActionScreenshot(_Inout_ __NkInt_WorldLaye
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
     NK_ASSERT(filePath != NULL && *filePath ^ '\0', NkErr_InParameter);
 
-    NkErrorCode errCode;
-    NkDIBitmap newScreenshot;
-
-    /* Grab the pixel data from the framebuffer. */
-    if ((errCode = self->mp_rdRef->VT->GrabFramebuffer(self->mp_rdRef, &newScreenshot)) != NkErr_Ok) {
-        /* Failed to copy pixels. */
+    /*
+     * Copy the framebuffer and let a worker write the file so that taking a screenshot
+     * does not cause a hitch. We use one filePath for now, can only save the latest
+     * screenshot.
+     * TODO: Generate random number or use timestamp for screenshot file names.
+     */
+    NkErrorCode const errCode = NkCaptureScreenshot(self->mp_rdRef, filePath);
+    if (errCode != NkErr_Ok) {
         NK_LOG_ERROR(
-            "Failed to grab current framebuffer. Reason: %s (%i)",
+            "Failed to take screenshot \"%s\". Reason: %s (%i)",
+            filePath,
             NkGetErrorCodeStr(errCode)->mp_dataPtr,
             (int)errCode
         );
 
-        NkDIBitmapDestroy(&newScreenshot);
         return;
     }
 
-    /*
-     * Save the bitmap to the file. We use one filePath for now, can only save the
-     * latest screenshot.
-     * TODO: Generate random number or use timestamp for screenshot file names.
-     */
-    if ((errCode = NkDIBitmapSave(&newScreenshot, filePath)) != NkErr_Ok)
-        /* Failed to write bitmap file to disk. */
-        NK_LOG_ERROR(
-            "Failed to write screenshot file to \"%s\". Reason: %s (%i)",
-            filePath,
-            NkGetErrorCodeStr(errCode)->mp_dataPtr,
-            (int)errCode
+    NK_LOG_INFO("Queued screenshot \"%s\" for writing.", filePath);
+}
+
+/**
+ */
+NK_INTERNAL NkBoolean NK_CALL __NkInt_WorldLayer_FetchTile(
+    _Inout_opt_ NkVoid *extraCxt,
+    _In_        NkPoint2D tilePos,
+    _Out_       NkRectF *srcRect
+) {
+    NK_ASSERT(extraCxt != NULL, NkErr_InOutParameter);
+
+    /* Tiles of chunks that are not loaded (yet) are left empty. */
+    __NkInt_WorldLayer *actWorldLy = (__NkInt_WorldLayer *)extraCxt;
+    NkUint32 t;
+    if (!NkChunkStreamerQueryTile(actWorldLy->mp_chunkStr, tilePos, &t))
+        return NK_FALSE;
+
+    /* Tiles outside of the tile set come from malformed maps and are left empty, too. */
+    NkUint32 const tileRow = t >> 16;
+    NkUint32 const tileCol = t & 0xFFFF;
+    if (tileRow >= actWorldLy->m_tileRows || tileCol >= actWorldLy->m_tileCols) {
+        NK_LOG_WARNING(
+            "Tile (%lli, %lli) refers to tile set entry (%u, %u) which does not exist.",
+            (long long)tilePos.m_xCoord,
+            (long long)tilePos.m_yCoord,
+            tileCol,
+            tileRow
         );
 
-    NK_LOG_INFO("Successfully wrote screenshot \"%s\".", filePath);
-    /* At last, delete bitmap. */
-    NkDIBitmapDestroy(&newScreenshot);
+        return NK_FALSE;
+    }
+
+    *srcRect = NkTextureAtlasQuerySubTexture(
+        actWorldLy->mp_texAtlas,
+        actWorldLy->m_tileFirstId + tileRow * actWorldLy->m_tileCols + tileCol
+    )->m_srcRect;
+    return NK_TRUE;
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_LoadChunk(
+    _Inout_opt_       NkVoid *extraCxt,
+    _In_              NkPoint2D chunkPos,
+    _In_              NkSize nTiles,
+    _O_array_(nTiles) NkUint32 *tileArr
+) {
+    NK_UNREFERENCED_PARAMETER(extraCxt);
+
+    /* Only the four test chunks exist for now. */
+    if (chunkPos.m_xCoord < 0 || chunkPos.m_xCoord > 1 || chunkPos.m_yCoord < 0 || chunkPos.m_yCoord > 1)
+        return NkErr_NoOperation;
+
+    NkUint32 const *c = chunkPos.m_xCoord == 0
+        ? (chunkPos.m_yCoord == 0 ? gl_TestMap1 : gl_TestMap3)
+        : (chunkPos.m_yCoord == 0 ? gl_TestMap2 : gl_TestMap4)
+    ;
+    memcpy(tileArr, c, NK_MIN(nTiles, NK_ARRAYSIZE(gl_TestMap1)) * sizeof *tileArr);
+    return NkErr_Ok;
+}
+
+/**
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_WorldLayer_OnChunkReady(_Inout_opt_ NkVoid *extraCxt, _In_ NkPoint2D chunkPos) {
+    NK_ASSERT(extraCxt != NULL, NkErr_InOutParameter);
+
+    __NkInt_WorldLayer *self = (__NkInt_WorldLayer *)extraCxt;
+    NkApplicationRequestRedraw();
+    /* Cached paths may have been computed while the chunk was still missing. */
+    NkPathServiceInvalidate(self->mp_pathSvc);
+
+    /* Redraw the tiles of the chunk if they are currently cached. */
+    NkSize2D const chExt = __NkInt_WorldLayer_ChunkExt;
+    for (NkInt64 y = 0; y < (NkInt64)chExt.m_height; y++)
+        for (NkInt64 x = 0; x < (NkInt64)chExt.m_width; x++)
+            NkTileCacheMarkDirty(self->mp_tileCache, (NkPoint2D){
+                chunkPos.m_xCoord * (NkInt64)chExt.m_width + x,
+                chunkPos.m_yCoord * (NkInt64)chExt.m_height + y
+            });
 }
 
 /**
+ * \brief  decides whether a tile of the test map blocks movement
+ * \param  [in, out] extraCxt unused
+ * \param  [in] tileVal value of the tile
+ * \return \c NK_TRUE if the tile is solid, \c NK_FALSE if not
+ * \note   The first row of the tile set is ground; the tiles in columns 5 to 8 of the
+ *         rows below form the pond and its shore.
  */
-NK_INTERNAL NkVec2F __NkInt_WorldLayer_GetAnimPos(__NkInt_WorldLayer *self) {
-    NkFloat x = 0, y = 0;
+NK_INTERNAL NkBoolean NK_CALL __NkInt_WorldLayer_IsSolidTile(_Inout_opt_ NkVoid *extraCxt, _In_ NkUint32 tileVal) {
+    NK_UNREFERENCED_PARAMETER(extraCxt);
 
-    //if (self->m_isMoving) {
-    //    // move 
-    //    if (self->m_vel.m_xVal == 0.f && self->m_vel.m_yVal == 1.f)
+    NkUint32 const tileX = tileVal & 0xFFFF;
+    NkUint32 const tileY = tileVal >> 16;
+    return tileY > 0 && tileX >= 5 && tileX <= 8;
+}
+
+/**
+ * \brief  retrieves the current position of the player
+ * \param  [in] self pointer to the world layer
+ * \return position of the player, in pixels
+ */
+NK_INTERNAL NkVec2F __NkInt_WorldLayer_GetPlayerPos(_In_ __NkInt_WorldLayer const *self) {
+    NkUint32 const compInd = NkEcsFindComponent(self->mp_ecsReg, self->m_plEntity, self->m_motionType);
 
-    //} else {
-    //    // always middle row
-    //    x = 1.f;
+    return (NkVec2F){
+        ((NkFloat *)NkEcsQueryField(self->mp_ecsReg, self->m_motionType, __NkInt_MotionFld_PosX))[compInd],
+        ((NkFloat *)NkEcsQueryField(self->mp_ecsReg, self->m_motionType, __NkInt_MotionFld_PosY))[compInd]
+    };
+}
 
-    //NK_LOG_DEBUG("v = { %g, %g }", self->m_vel.m_xVal, self->m_vel.m_yVal);
+/**
+ * \brief  moves all entities with a motion component towards their targets
+ * \param  [in, out] self pointer to the world layer
+ * \param  [in] updTime duration of the fixed step, in seconds
+ * \return \c NK_TRUE if any entity moved, \c NK_FALSE if not
+ *
+ * The first pass only works on the field arrays and does not branch per entity, so that
+ * the compiler can vectorize it. The second pass updates the entity grid for the
+ * entities that moved and stops the ones that reached their target.
+ */
+NK_INTERNAL NkBoolean __NkInt_WorldLayer_RunMovement(_Inout_ __NkInt_WorldLayer *self, _In_ NkFloat updTime) {
+    NkEcsRegistry *ecsReg = self->mp_ecsReg;
+    NkUint32 const nComps = NkEcsQueryCount(ecsReg, self->m_motionType);
+    if (nComps == 0)
+        return NK_FALSE;
+
+    NkFloat         *posXArr  = NkEcsQueryField(ecsReg, self->m_motionType, __NkInt_MotionFld_PosX);
+    NkFloat         *posYArr  = NkEcsQueryField(ecsReg, self->m_motionType, __NkInt_MotionFld_PosY);
+    NkFloat const   *dstXArr  = NkEcsQueryField(ecsReg, self->m_motionType, __NkInt_MotionFld_DstX);
+    NkFloat const   *dstYArr  = NkEcsQueryField(ecsReg, self->m_motionType, __NkInt_MotionFld_DstY);
+    NkFloat const   *speedArr = NkEcsQueryField(ecsReg, self->m_motionType, __NkInt_MotionFld_Speed);
+    NkByte          *movArr   = NkEcsQueryField(ecsReg, self->m_motionType, __NkInt_MotionFld_IsMoving);
+    NkSpatialHandle *hndArr   = NkEcsQueryField(ecsReg, self->m_motionType, __NkInt_MotionFld_GridHandle);
+
+    NkByte anyMoving = 0;
+    for (NkUint32 i = 0; i < nComps; i++) {
+        NkFloat const diffX = dstXArr[i] - posXArr[i];
+        NkFloat const diffY = dstYArr[i] - posYArr[i];
+        NkFloat const dist2 = diffX * diffX + diffY * diffY;
+        NkFloat const step  = speedArr[i] * updTime;
+        NkFloat const mag   = sqrtf(dist2);
+
+        /* Snap to the target if it is reached within this step; idle entities stay put. */
+        NkBoolean const isArrived = movArr[i] && (dist2 <= 0.001f || mag < step);
+        NkFloat const   scale     = movArr[i] ? step / NK_MAX(mag, 1e-6f) : 0.f;
+
+        posXArr[i] = isArrived ? dstXArr[i] : posXArr[i] + diffX * scale;
+        posYArr[i] = isArrived ? dstYArr[i] : posYArr[i] + diffY * scale;
+        anyMoving |= movArr[i];
+    }
+    if (anyMoving == 0)
+        return NK_FALSE;
 
-        x = 1.f;
-        y = (NkFloat)self->m_dir;
-        //if (self->m_vel.m_xVal == 0.f && self->m_vel.m_yVal == 1.f)
-        //    y = 0.f;
-        //else if (self->m_vel.m_xVal == 1.f && self->m_vel.m_yVal == 0.f)
-        //    y = 2.f;
-        //else if (self->m_vel.m_xVal == 0.f && self->m_vel.m_yVal == -1.f)
-        //    y = 3.f;
-        //else if (self->m_vel.m_xVal == -1.f && self->m_vel.m_yVal == 0.f)
-        //    y = 1.f;
-        //else if (self->m_vel.m_xVal == 0.f && self->m_vel.m_yVal == 0.f) {
-        //    if ()
-        //}
-    //}
+    for (NkUint32 i = 0; i < nComps; i++) {
+        if (movArr[i] == 0)
+            continue;
 
-    return (NkVec2F){ x, y };
+        if (hndArr[i] != NK_SPATIAL_INVHANDLE)
+            NkSpatialGridMove(self->mp_entGrid, hndArr[i], &(NkRectF){ posXArr[i], posYArr[i], 32.f, 32.f });
+        movArr[i] = posXArr[i] != dstXArr[i] || posYArr[i] != dstYArr[i];
+    }
+    return NK_TRUE;
 }
 
 /**
+ * \brief  creates the animation clips of the player
+ * \param  [in] texAtlas atlas the player sheet was packed into
+ * \param  [in] plFirstId sub-texture of the first frame of the player sheet
+ * \param  [in] plCols number of frame columns in the player sheet
+ * \param  [out] walkClips array that receives the walk cycle of every direction
+ * \param  [out] idleClips array that receives the idle frame of every direction
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   On failure, all clips that were created are destroyed again.
  */
-NK_INTERNAL NkVoid __NkInt_WorldLayer_UpdAnim(__NkInt_WorldLayer *wl) {
-    NK_INTERNAL NkFloat frame = 0.1f;
-    NK_INTERNAL NkInt32 maxFrame = 2;
-    NK_INTERNAL NkInt32 minFrame = 0;
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_WorldLayer_CreatePlayerClips(
+    _In_  NkTextureAtlas const *texAtlas,
+    _In_  NkSubTextureId plFirstId,
+    _In_  NkUint32 plCols,
+    _Out_ NkAnimClip **walkClips,
+    _Out_ NkAnimClip **idleClips
+) {
+    NkErrorCode errCode = NkErr_Ok;
+
+    /* Every row of the sheet is a direction; the middle column is the standing frame. */
+    NkUint32 const walkCols[] = { 0, 1, 2, 1 };
+    for (NkUint32 i = 0; i < __NkInt_WorldLayer_NumDirs; i++)
+        walkClips[i] = idleClips[i] = NULL;
+    for (NkUint32 i = 0; i < __NkInt_WorldLayer_NumDirs && errCode == NkErr_Ok; i++) {
+        NkRectF walkRects[NK_ARRAYSIZE(walkCols)];
+        for (NkUint32 j = 0; j < NK_ARRAYSIZE(walkCols); j++)
+            walkRects[j] = NkTextureAtlasQuerySubTexture(texAtlas, plFirstId + i * plCols + walkCols[j])->m_srcRect;
+
+        errCode = NkAnimClipCreate(&(NkAnimClipSpecification){
+            .m_structSize = sizeof(NkAnimClipSpecification),
+            .m_nFrames    = (NkUint32)NK_ARRAYSIZE(walkCols),
+            .mp_rectArr   = walkRects,
+            .m_frameDur   = 0.15f,
+            .m_isLooping  = NK_TRUE
+        }, &walkClips[i]);
+        if (errCode != NkErr_Ok)
+            break;
+        errCode = NkAnimClipCreate(&(NkAnimClipSpecification){
+            .m_structSize = sizeof(NkAnimClipSpecification),
+            .m_nFrames    = 1,
+            .mp_rectArr   = &walkRects[1],
+            .m_frameDur   = 1.f,
+            .m_isLooping  = NK_TRUE
+        }, &idleClips[i]);
+    }
 
-    /* Anim must update. */
-    //NkUint64 currTime = NkGetCurrentTime();
-    //if (((NkFloat)currTime - wl->m_lastAnimFrame) >= frame * (NkFloat)NkGetTimerFrequency()) {
-    //    switch ()
-    //}
+    if (errCode != NkErr_Ok)
+        for (NkUint32 i = 0; i < __NkInt_WorldLayer_NumDirs; i++) {
+            NkAnimClipDestroy(&walkClips[i]);
+            NkAnimClipDestroy(&idleClips[i]);
+        }
+    return errCode;
 }
 
 
@@ -312,6 +528,70 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_QueryInterface(
     return NkErr_InterfaceNotImpl;
 }
 
+/**
+ * \brief  maps a movement key to its bit in the key masks of the world layer
+ * \param  [in] keyCode key that is to be mapped
+ * \return bit of the key, or \c 0 if the key is not used for movement
+ */
+NK_INTERNAL NkUint32 __NkInt_WorldLayer_GetKeyBit(_In_ NkKeyboardKey keyCode) {
+    switch (keyCode) {
+        case NkKey_LShift: return 1 << 0;
+        case NkKey_AlnumW: return 1 << 1;
+        case NkKey_AlnumA: return 1 << 2;
+        case NkKey_AlnumS: return 1 << 3;
+        case NkKey_AlnumD: return 1 << 4;
+        default:           return 0;
+    }
+}
+
+/**
+ * \brief consumes the buffered key transitions that belong to the current fixed step
+ * \param [in,out] worldLy world layer instance
+ * \note  A key that was pressed during the step is treated as held for the entire step,
+ *        even if it was released again before the step ended.
+ */
+NK_INTERNAL NkVoid __NkInt_WorldLayer_PollInput(_Inout_ __NkInt_WorldLayer *worldLy) {
+    NkUint64 const stepTime = NkApplicationQueryFixedStepTime();
+    NkInputRecord  recArr[32];
+    NkSize         nRecs;
+
+    worldLy->m_tickKeys = 0;
+    do {
+        nRecs = worldLy->mp_ialRef->VT->ReadBufferedInput(worldLy->mp_ialRef, stepTime, recArr, NK_ARRAYSIZE(recArr));
+
+        for (NkSize i = 0; i < nRecs; i++) {
+            switch (recArr[i].m_recType) {
+                case NkInRec_KeyDown:
+                    worldLy->m_heldKeys |= __NkInt_WorldLayer_GetKeyBit(recArr[i].m_keyCode);
+                    worldLy->m_tickKeys |= __NkInt_WorldLayer_GetKeyBit(recArr[i].m_keyCode);
+
+                    break;
+                case NkInRec_KeyUp:
+                    worldLy->m_heldKeys &= ~__NkInt_WorldLayer_GetKeyBit(recArr[i].m_keyCode);
+
+                    break;
+                default:
+                    break;
+            }
+        }
+    } while (nRecs == NK_ARRAYSIZE(recArr));
+}
+
+/**
+ * \brief  checks whether the given movement key is down during the current fixed step
+ * \param  [in,out] worldLy world layer instance
+ * \param  [in] keyCode key that is to be checked
+ * \return \c NK_TRUE if the key is down, \c NK_FALSE if not
+ * \note   If the IAL could not be put into buffered mode, the current key state is
+ *         queried instead.
+ */
+NK_INTERNAL NkBoolean __NkInt_WorldLayer_IsKeyDown(_Inout_ __NkInt_WorldLayer *worldLy, _In_ NkKeyboardKey keyCode) {
+    if (!worldLy->m_isBufInput)
+        return worldLy->mp_ialRef->VT->IsKeyPressed(worldLy->mp_ialRef, keyCode);
+
+    return ((worldLy->m_heldKeys | worldLy->m_tickKeys) & __NkInt_WorldLayer_GetKeyBit(keyCode)) != 0;
+}
+
 /**
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnPush(
@@ -332,25 +612,178 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnPush(
     NkIWindow   *mainWnd = (NkIWindow *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIWindow));
     NkIRenderer *mainRd  = mainWnd->VT->GetRenderer(mainWnd);
 
-    /* Create main resources. */
-    NkDIBitmap mainTs, atlasTs;
-    NkRendererResource *mainTsRes = NULL;
+    /*
+     * Pack the tile set and the player sheet into a single atlas so that tiles and
+     * sprites are drawn from the same texture. The tile set is drawn unmasked.
+     */
+    NkDIBitmap mainTs, plTs;
+    NkTextureAtlas *texAtlas = NULL;
+    NkSubTextureId  tileFirstId, plFirstId;
     NkErrorCode errCode = NkDIBitmapLoad("../res/def/ts_main.bmp", &mainTs);
     if (errCode != NkErr_Ok)
         goto lbl_ONERROR;
-    if ((errCode = mainRd->VT->CreateTexture(mainRd, &mainTs, &mainTsRes)) != NkErr_Ok) {
+    if ((errCode = NkDIBitmapLoad("../res/def/ts_player.bmp", &plTs)) != NkErr_Ok) {
         NkDIBitmapDestroy(&mainTs);
 
         goto lbl_ONERROR;
     }
+    NkUint32 const tileCols = (NkUint32)NkDIBitmapGetSpecification(&mainTs)->m_bmpWidth / 32;
+    NkUint32 const tileRows = (NkUint32)NkDIBitmapGetSpecification(&mainTs)->m_bmpHeight / 32;
+    NkUint32 const plCols   = (NkUint32)NkDIBitmapGetSpecification(&plTs)->m_bmpWidth / 32;
+    errCode = NkTextureAtlasCreate(&(NkTextureAtlasSpecification){
+        .m_structSize = sizeof(NkTextureAtlasSpecification),
+        .mp_rdRef     = mainRd,
+        .m_pageDim    = (NkSize2D){ 4096, 4096 },
+        .m_padding    = 0,
+        .m_keyCol     = (NkRgbaColor)NK_MAKE_RGB(255, 0, 255)
+    }, &texAtlas);
+    if (    errCode != NkErr_Ok
+        || (errCode = NkTextureAtlasAddBitmap(texAtlas, &mainTs, (NkSize2D){ 32, 32 }, NULL, &tileFirstId)) != NkErr_Ok
+        || (errCode = NkTextureAtlasAddBitmap(texAtlas, &plTs, (NkSize2D){ 32, 32 }, &(NkRgbaColor)NK_MAKE_RGB(255, 0, 255), &plFirstId)) != NkErr_Ok
+        || (errCode = NkTextureAtlasBuild(texAtlas)) != NkErr_Ok
+    ) {
+        NkTextureAtlasDestroy(&texAtlas);
+        NkDIBitmapDestroy(&plTs);
+        NkDIBitmapDestroy(&mainTs);
+
+        goto lbl_ONERROR;
+    }
+    NkDIBitmapDestroy(&plTs);
     NkDIBitmapDestroy(&mainTs);
 
-    NkDIBitmapLoad("../res/def/ts_player.bmp", &atlasTs);
-    NkRendererResource *mainTsMask = NULL, *plAtlas = NULL, *plAtlasMask = NULL;
-    errCode = mainRd->VT->CreateTextureMask(mainRd, mainTsRes, (NkRgbaColor)NK_MAKE_RGB(255, 255, 255), &mainTsMask);
-    errCode = mainRd->VT->CreateTexture(mainRd, &atlasTs, &plAtlas);
-    errCode = mainRd->VT->CreateTextureMask(mainRd, plAtlas, (NkRgbaColor)NK_MAKE_RGB(255, 0, 255), &plAtlasMask);
-    NkDIBitmapDestroy(&atlasTs);
+    /* Create the cache for the static tile layer. */
+    NkTileCache *tileCache = NULL;
+    errCode = NkTileCacheCreate(&(NkTileCacheSpecification){
+        .m_structSize = sizeof(NkTileCacheSpecification),
+        .mp_rdRef     = mainRd,
+        .mp_tileAtlas = NkTextureAtlasQuerySubTexture(texAtlas, tileFirstId)->mp_texRef,
+        .m_tileSize   = (NkSize2D){ 32, 32 },
+        .m_cacheExt   = __NkInt_WorldLayer_TileCacheExt,
+        .m_emptyCol   = mainRd->VT->QuerySpecification(mainRd)->m_clearCol,
+        .mp_fetchFn   = &__NkInt_WorldLayer_FetchTile,
+        .mp_extraCxt  = (NkVoid *)actWorldLayer
+    }, &tileCache);
+    if (errCode != NkErr_Ok) {
+        NkTextureAtlasDestroy(&texAtlas);
+
+        goto lbl_ONERROR;
+    }
+
+    /*
+     * Create the chunk streamer. The asset database does not contain any chunks yet, so
+     * the test map is served by a custom loader.
+     */
+    NkChunkStreamer *chunkStr = NULL;
+    errCode = NkChunkStreamerCreate(&(NkChunkStreamerSpecification){
+        .m_structSize = sizeof(NkChunkStreamerSpecification),
+        .m_chunkExt   = __NkInt_WorldLayer_ChunkExt,
+        .m_resRadius  = 1,
+        .mp_fnLoad    = &__NkInt_WorldLayer_LoadChunk,
+        .mp_fnReady   = &__NkInt_WorldLayer_OnChunkReady,
+        .mp_fnSolid   = &__NkInt_WorldLayer_IsSolidTile,
+        .mp_extraCxt  = (NkVoid *)actWorldLayer
+    }, &chunkStr);
+    if (errCode != NkErr_Ok) {
+        NkTileCacheDestroy(&tileCache);
+        NkTextureAtlasDestroy(&texAtlas);
+
+        goto lbl_ONERROR;
+    }
+
+    /* Create the pathfinding service on top of the collision bits of the streamer. */
+    NkPathService *pathSvc = NULL;
+    errCode = NkPathServiceCreate(&(NkPathServiceSpecification){
+        .m_structSize  = sizeof(NkPathServiceSpecification),
+        .mp_chunkStr   = chunkStr,
+        .m_maxExt      = 128,
+        .m_nCacheSlots = 64
+    }, &pathSvc);
+    if (errCode != NkErr_Ok) {
+        NkChunkStreamerDestroy(&chunkStr);
+        NkTileCacheDestroy(&tileCache);
+        NkTextureAtlasDestroy(&texAtlas);
+
+        goto lbl_ONERROR;
+    }
+
+    /*
+     * Create the spatial index for culling the entities to the viewport and for
+     * neighbour queries. The user data of every object is its entity.
+     */
+    NkSpatialGrid  *entGrid = NULL;
+    NkSpatialHandle plHandle;
+    errCode = NkSpatialGridCreate(&(NkSpatialGridSpecification){
+        .m_structSize = sizeof(NkSpatialGridSpecification),
+        .m_cellSize   = __NkInt_WorldLayer_EntCellSize,
+        .m_nBuckets   = 4096,
+        .m_initCap    = 1024
+    }, &entGrid);
+    if (errCode != NkErr_Ok) {
+        NkPathServiceDestroy(&pathSvc);
+        NkChunkStreamerDestroy(&chunkStr);
+        NkTileCacheDestroy(&tileCache);
+        NkTextureAtlasDestroy(&texAtlas);
+
+        goto lbl_ONERROR;
+    }
+
+    /*
+     * Create the entity registry and the player entity. The components are stored
+     * field by field so that the movement and animation systems run over contiguous
+     * arrays.
+     */
+    NkEcsRegistry      *ecsReg = NULL;
+    NkEcsComponentType  motionType, animType, interpType;
+    NkEcsEntity         plEntity;
+    NkUint32            plInd, plAnimInd, plInterpInd;
+    NkAnimClip         *walkClips[__NkInt_WorldLayer_NumDirs], *idleClips[__NkInt_WorldLayer_NumDirs];
+    errCode = NkEcsCreate(&(NkEcsRegistrySpecification){
+        .m_structSize = sizeof(NkEcsRegistrySpecification),
+        .m_initCap    = 1024
+    }, &ecsReg);
+    if (    errCode != NkErr_Ok
+        || (errCode = NkEcsRegisterComponent(ecsReg, &(NkEcsComponentSpecification){
+                .m_structSize = sizeof(NkEcsComponentSpecification),
+                .m_nFields    = __NkInt_MotionFld_Count__,
+                .m_fieldSizes = {
+                    [__NkInt_MotionFld_PosX]       = sizeof(NkFloat),
+                    [__NkInt_MotionFld_PosY]       = sizeof(NkFloat),
+                    [__NkInt_MotionFld_DstX]       = sizeof(NkFloat),
+                    [__NkInt_MotionFld_DstY]       = sizeof(NkFloat),
+                    [__NkInt_MotionFld_Speed]      = sizeof(NkFloat),
+                    [__NkInt_MotionFld_IsMoving]   = sizeof(NkByte),
+                    [__NkInt_MotionFld_Dir]        = sizeof(NkInt32),
+                    [__NkInt_MotionFld_GridHandle] = sizeof(NkSpatialHandle)
+                }
+            }, &motionType)) != NkErr_Ok
+        || (errCode = NkAnimRegisterComponent(ecsReg, &animType)) != NkErr_Ok
+        || (errCode = NkInterpRegisterComponent(ecsReg, &interpType)) != NkErr_Ok
+        || (errCode = NkEcsCreateEntity(ecsReg, &plEntity)) != NkErr_Ok
+        || (errCode = NkEcsAddComponent(ecsReg, plEntity, motionType, &plInd)) != NkErr_Ok
+        || (errCode = NkEcsAddComponent(ecsReg, plEntity, animType, &plAnimInd)) != NkErr_Ok
+        || (errCode = NkEcsAddComponent(ecsReg, plEntity, interpType, &plInterpInd)) != NkErr_Ok
+        || (errCode = NkSpatialGridInsert(entGrid, &(NkRectF){ 11.f * 32.f, 9.f * 32.f, 32.f, 32.f }, (NkUint64)plEntity, &plHandle)) != NkErr_Ok
+        || (errCode = __NkInt_WorldLayer_CreatePlayerClips(texAtlas, plFirstId, plCols, walkClips, idleClips)) != NkErr_Ok
+    ) {
+        NkEcsDestroy(&ecsReg);
+        NkSpatialGridDestroy(&entGrid);
+        NkPathServiceDestroy(&pathSvc);
+        NkChunkStreamerDestroy(&chunkStr);
+        NkTileCacheDestroy(&tileCache);
+        NkTextureAtlasDestroy(&texAtlas);
+
+        goto lbl_ONERROR;
+    }
+    ((NkFloat *)NkEcsQueryField(ecsReg, motionType, __NkInt_MotionFld_PosX))[plInd]               = 11.f * 32.f;
+    ((NkFloat *)NkEcsQueryField(ecsReg, motionType, __NkInt_MotionFld_PosY))[plInd]               = 9.f * 32.f;
+    ((NkFloat *)NkEcsQueryField(ecsReg, motionType, __NkInt_MotionFld_DstX))[plInd]               = 11.f * 32.f;
+    ((NkFloat *)NkEcsQueryField(ecsReg, motionType, __NkInt_MotionFld_DstY))[plInd]               = 9.f * 32.f;
+    ((NkFloat *)NkEcsQueryField(ecsReg, motionType, __NkInt_MotionFld_Speed))[plInd]              = 3.f * 32.f;
+    ((NkSpatialHandle *)NkEcsQueryField(ecsReg, motionType, __NkInt_MotionFld_GridHandle))[plInd] = plHandle;
+    NkAnimPlay(ecsReg, animType, plAnimInd, idleClips[0], 1.f);
+    /* Place the player's render state on its starting position. */
+    NK_IGNORE_RETURN_VALUE(NkInterpCapture(ecsReg, interpType, motionType, __NkInt_MotionFld_PosX, __NkInt_MotionFld_PosY));
+    NkInterpUpdate(ecsReg, interpType, 1.f);
 
     /* Initialize instance. */
     *actWorldLayer = (__NkInt_WorldLayer){
@@ -359,21 +792,38 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnPush(
         .mp_rdTarget     = mainWnd,
         .mp_rdRef        = mainRd,
         .mp_ialRef       = (NkIInput *)NkApplicationQueryInstance(NKOM_CLSIDOF(NkIInput)),
-        .mp_mainTexAtlas = mainTsRes,
-        .mp_texAtlasMask = mainTsMask,
-        .mp_playerAtlas  = plAtlas,
-        .mp_plAtlasMask  = plAtlasMask,
-        .m_prevPos       = (NkVec2F){ 11.f * 32.f , 9.f * 32.f },
-        .m_playerPos     = (NkVec2F){ 11.f * 32.f , 9.f * 32.f },
-        .m_targetPos     = (NkVec2F){ 11.f * 32.f , 9.f * 32.f },
-        .m_isMoving      = NK_FALSE,
+        .mp_texAtlas     = texAtlas,
+        .m_tileFirstId   = tileFirstId,
+        .m_tileCols      = tileCols,
+        .m_tileRows      = tileRows,
+        .m_plFirstId     = plFirstId,
+        .m_plCols        = plCols,
+        .mp_tileCache    = tileCache,
+        .mp_chunkStr     = chunkStr,
+        .mp_pathSvc      = pathSvc,
+        .mp_entGrid      = entGrid,
+        .mp_ecsReg       = ecsReg,
+        .m_motionType    = motionType,
+        .m_animType      = animType,
+        .m_interpType    = interpType,
+        .m_plEntity      = plEntity,
         .m_vel           = (NkVec2F) { 0.f, 1.f },
         .m_lvel          = (NkVec2F) { 0.f, 1.f },
-        .m_moveSpeed     = 3.f * 32.f,
         .state           = 0 // idle
     };
+    memcpy(actWorldLayer->mp_walkClips, walkClips, sizeof walkClips);
+    memcpy(actWorldLayer->mp_idleClips, idleClips, sizeof idleClips);
     NkTimerCreate(NkTiType_Elapsed, NK_TRUE, &actWorldLayer->t);
     NkTimerCreate(NkTiType_Elapsed, NK_TRUE, &actWorldLayer->t2);
+    /*
+     * Use buffered input so that short key presses between two fixed steps are not lost.
+     * If that fails, fall back to polling the key state.
+     */
+    actWorldLayer->m_isBufInput = actWorldLayer->mp_ialRef->VT->SetBufferedMode(
+        actWorldLayer->mp_ialRef,
+        mainWnd->VT->QueryNativeWindowHandle(mainWnd),
+        NK_TRUE
+    ) == NkErr_Ok;
     /* All good. */
     return NkErr_Ok;
 
@@ -392,8 +842,12 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnPop(_Inout_ NkI
     /* Get internal structure of world layer. */
     __NkInt_WorldLayer *actWorldLayer = (__NkInt_WorldLayer *)self;
 
+    /* Stop buffering input. */
+    if (actWorldLayer->m_isBufInput)
+        NK_IGNORE_RETURN_VALUE(actWorldLayer->mp_ialRef->VT->SetBufferedMode(actWorldLayer->mp_ialRef, NULL, NK_FALSE));
+
     /* Destroy resources. */
-    //actWorldLayer->mp_rdRef->VT->DeleteResource(actWorldLayer->mp_rdRef, &actWorldLayer->mp_mainTexAtlas);
+    //NkTextureAtlasDestroy(&actWorldLayer->mp_texAtlas);
     /* Release components. */
     //actWorldLayer->mp_rdRef->VT->Release(actWorldLayer->mp_rdRef);
     //actWorldLayer->mp_rdTarget->VT->Release(actWorldLayer->mp_rdTarget);
@@ -416,10 +870,33 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnEvent(
         __NkInt_WorldLayer_ActionScreenshot((__NkInt_WorldLayer *)self, "latestScreenshot.bmp");
 
         /* Event was handled. */
+        return NkErr_Ok;
+    } else if (evPtr->m_evType == NkEv_KeyboardKeyDown && evPtr->m_kbEvent.m_vKeyCode == NkKey_F10) {
+        /* Toggle gameplay recording. */
+        if (NkCaptureIsRecording())
+            NkCaptureEndRecording();
+        else
+            NK_IGNORE_RETURN_VALUE(NkCaptureBeginRecording("recording_", 30));
+
         return NkErr_Ok;
     } else if (evPtr->m_evType == NkEv_KeyboardKeyDown && evPtr->m_kbEvent.m_vKeyCode == NkKey_F4) {
         NkApplicationExit(NkErr_Ok);
 
+        return NkErr_Ok;
+    } else if (evPtr->m_evType == NkEv_KeyboardKeyDown && evPtr->m_kbEvent.m_vKeyCode == NkKey_F9 && NkAllocIsTracking()) {
+        /* Print the top allocating call sites. */
+        NkAllocDumpReport(20);
+
+        return NkErr_Ok;
+    } else if (evPtr->m_evType == NkEv_KeyboardKeyDown && evPtr->m_kbEvent.m_vKeyCode == NkKey_F8) {
+        /* Print the timings of the profiler zones. */
+        NkProfileDumpReport();
+
+        return NkErr_Ok;
+    } else if (evPtr->m_evType == NkEv_KeyboardKeyDown && evPtr->m_kbEvent.m_vKeyCode == NkKey_F7) {
+        /* Capture the next frames for viewing in chrome://tracing or Perfetto. */
+        NK_IGNORE_RETURN_VALUE(NkProfileBeginCapture("latestCapture.json", 300));
+
         return NkErr_Ok;
     }
 
@@ -427,25 +904,62 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnEvent(
     return NkErr_NoOperation;
 }
 
+/**
+ */
+NK_INTERNAL NkEventCategory NK_CALL __NkInt_WorldLayer_QueryEventCategories(_Inout_ NkILayer *self) {
+    NK_UNREFERENCED_PARAMETER(self);
+
+    /* The world layer only handles hotkeys so far. */
+    return NkEvCat_Keyboard;
+}
+
 /**
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnUpdate(_Inout_ NkILayer *self, _In_ NkFloat updTime) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
+    NK_UNREFERENCED_PARAMETER(updTime);
+
+    /* Get internal structure of world layer. */
+    __NkInt_WorldLayer *actWorldLy = (__NkInt_WorldLayer *)self;
+
+    /* Keep the chunks around the player resident. */
+    NkVec2F const plPos = __NkInt_WorldLayer_GetPlayerPos(actWorldLy);
+    return NkChunkStreamerUpdate(
+        actWorldLy->mp_chunkStr,
+        NkChunkStreamerGetChunkPos(actWorldLy->mp_chunkStr, (NkPoint2D){
+            (NkInt64)floorf(plPos.m_xVal / 32.f),
+            (NkInt64)floorf(plPos.m_yVal / 32.f)
+        })
+    );
+}
+
+/**
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnFixedUpdate(_Inout_ NkILayer *self, _In_ NkFloat updTime) {
+    NK_ASSERT(self != NULL, NkErr_InOutParameter);
 
     /* Get internal structure of world layer. */
     __NkInt_WorldLayer *actWorldLy = (__NkInt_WorldLayer *)self;
 
+    /* Consume the input that happened during this step. */
+    if (actWorldLy->m_isBufInput)
+        __NkInt_WorldLayer_PollInput(actWorldLy);
+
+    /* Get the player's motion component. */
+    NkEcsRegistry *ecsReg   = actWorldLy->mp_ecsReg;
+    NkUint32 const plInd    = NkEcsFindComponent(ecsReg, actWorldLy->m_plEntity, actWorldLy->m_motionType);
+    NkByte        *isMovPtr = &((NkByte *)NkEcsQueryField(ecsReg, actWorldLy->m_motionType, __NkInt_MotionFld_IsMoving))[plInd];
+    NkInt32       *dirPtr   = &((NkInt32 *)NkEcsQueryField(ecsReg, actWorldLy->m_motionType, __NkInt_MotionFld_Dir))[plInd];
+
     /* Update move speed. */
-    if (actWorldLy->mp_ialRef->VT->IsKeyPressed(actWorldLy->mp_ialRef, NkKey_LShift))
-        actWorldLy->m_moveSpeed = 8.f * 32.f;
-    else
-        actWorldLy->m_moveSpeed = 4.f * 32.f;
+    ((NkFloat *)NkEcsQueryField(ecsReg, actWorldLy->m_motionType, __NkInt_MotionFld_Speed))[plInd] =
+        __NkInt_WorldLayer_IsKeyDown(actWorldLy, NkKey_LShift) ? 8.f * 32.f : 4.f * 32.f;
 
-    /* Update positions. */
-    if (actWorldLy->m_isMoving == NK_FALSE) {
+    /* Pick a new target if the player is idle. */
+    if (*isMovPtr == 0) {
         /* Get axis movement. */
-        NkFloat axisX = actWorldLy->mp_ialRef->VT->IsKeyPressed(actWorldLy->mp_ialRef, NkKey_AlnumA) ? -1.f : (actWorldLy->mp_ialRef->VT->IsKeyPressed(actWorldLy->mp_ialRef, NkKey_AlnumD) ? 1.f : 0.f);
-        NkFloat axisY = actWorldLy->mp_ialRef->VT->IsKeyPressed(actWorldLy->mp_ialRef, NkKey_AlnumW) ? -1.f : (actWorldLy->mp_ialRef->VT->IsKeyPressed(actWorldLy->mp_ialRef, NkKey_AlnumS) ? 1.f : 0.f);
+        NkFloat axisX = __NkInt_WorldLayer_IsKeyDown(actWorldLy, NkKey_AlnumA) ? -1.f : (__NkInt_WorldLayer_IsKeyDown(actWorldLy, NkKey_AlnumD) ? 1.f : 0.f);
+        NkFloat axisY = __NkInt_WorldLayer_IsKeyDown(actWorldLy, NkKey_AlnumW) ? -1.f : (__NkInt_WorldLayer_IsKeyDown(actWorldLy, NkKey_AlnumS) ? 1.f : 0.f);
         if (axisX != 0.f) axisY = 0.f;
 
         if (actWorldLy->m_vel.m_xVal != axisX || actWorldLy->m_vel.m_yVal != axisY) {
@@ -454,59 +968,50 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnUpdate(_Inout_
         if (actWorldLy->m_vel.m_xVal != 0.f || actWorldLy->m_vel.m_yVal != 0.f) {
             // Update dir.
             if (actWorldLy->m_vel.m_xVal == 1.f)
-                actWorldLy->m_dir = 2;
+                *dirPtr = 2;
             else if (actWorldLy->m_vel.m_xVal == -1.f)
-                actWorldLy->m_dir = 1;
+                *dirPtr = 1;
             else if (actWorldLy->m_vel.m_yVal == 1.f)
-                actWorldLy->m_dir = 0;
+                *dirPtr = 0;
             else if (actWorldLy->m_vel.m_yVal == -1.f)
-                actWorldLy->m_dir = 3;
-
-            actWorldLy->m_targetPos = (NkVec2F){
-                actWorldLy->m_playerPos.m_xVal + axisX * 32.f,
-                actWorldLy->m_playerPos.m_yVal + axisY * 32.f
-            };
-            /* Fix positions so they remain in the map. */
-            //actWorldLy->m_targetPos.m_xVal = NK_CLAMP(actWorldLy->m_targetPos.m_xVal, 0, 31 * 32);
-            //actWorldLy->m_targetPos.m_yVal = NK_CLAMP(actWorldLy->m_targetPos.m_yVal, 0, 31 * 32);
-
-            actWorldLy->m_isMoving = NK_TRUE;
-            NkTimerRestart(&actWorldLy->t);
+                *dirPtr = 3;
+
+            /* Only start moving if the tile in front of the player can be entered. */
+            NkVec2F const   plPos  = __NkInt_WorldLayer_GetPlayerPos(actWorldLy);
+            NkPoint2D const plTile = { (NkInt64)floorf(plPos.m_xVal / 32.f), (NkInt64)floorf(plPos.m_yVal / 32.f) };
+            if (NkChunkStreamerSweepTiles(actWorldLy->mp_chunkStr, plTile, (NkPoint2D){ (NkInt64)axisX, (NkInt64)axisY }, 1) == 1) {
+                ((NkFloat *)NkEcsQueryField(ecsReg, actWorldLy->m_motionType, __NkInt_MotionFld_DstX))[plInd] = plPos.m_xVal + axisX * 32.f;
+                ((NkFloat *)NkEcsQueryField(ecsReg, actWorldLy->m_motionType, __NkInt_MotionFld_DstY))[plInd] = plPos.m_yVal + axisY * 32.f;
+
+                *isMovPtr = 1;
+                NkTimerRestart(&actWorldLy->t);
+            }
         }
     }
 
-    if (actWorldLy->m_isMoving == NK_TRUE) {
-        NkVec2F diffVec = {
-            actWorldLy->m_targetPos.m_xVal - actWorldLy->m_playerPos.m_xVal,
-            actWorldLy->m_targetPos.m_yVal - actWorldLy->m_playerPos.m_yVal
-        };
-        NkFloat mag = sqrtf(diffVec.m_xVal * diffVec.m_xVal + diffVec.m_yVal * diffVec.m_yVal);
-        if ((diffVec.m_xVal * diffVec.m_xVal + diffVec.m_yVal * diffVec.m_yVal) > 0.001) {
-            if(mag < actWorldLy->m_moveSpeed * updTime || mag == 0.f)
-                goto lbl_HERE;
-
-            actWorldLy->m_prevPos = actWorldLy->m_playerPos;
-            actWorldLy->m_playerPos = (NkVec2F){
-                actWorldLy->m_playerPos.m_xVal + diffVec.m_xVal / mag * (actWorldLy->m_moveSpeed * updTime),
-                actWorldLy->m_playerPos.m_yVal + diffVec.m_yVal / mag * (actWorldLy->m_moveSpeed * updTime)
-            };
-
-            /* Fix positions so they remain in the map. */
-            //actWorldLy->m_playerPos.m_xVal = NK_CLAMP(actWorldLy->m_playerPos.m_xVal, 0, 31 * 32);
-            //actWorldLy->m_playerPos.m_yVal = NK_CLAMP(actWorldLy->m_playerPos.m_yVal, 0, 31 * 32);
-        } else {
-        lbl_HERE:
-            actWorldLy->m_playerPos = actWorldLy->m_targetPos;
-            actWorldLy->m_isMoving = NK_FALSE;
-
-            //NK_LOG_INFO("Move took %g ms", NkElapsedTimerGetAs(&actWorldLy->t, NkTiPrec_Milliseconds));
-            /* Fix positions so they remain in the map. */
-            //actWorldLy->m_playerPos.m_xVal = NK_CLAMP(actWorldLy->m_playerPos.m_xVal, 0, 31 * 32);
-            //actWorldLy->m_playerPos.m_yVal = NK_CLAMP(actWorldLy->m_playerPos.m_yVal, 0, 31 * 32);
-        }
-    }
+    /*
+     * Let the player walk while moving and stand still otherwise. This is decided before
+     * the movement pass so that the walk cycle keeps running from one tile to the next as
+     * long as a key is held.
+     */
+    NkAnimPlay(
+        ecsReg,
+        actWorldLy->m_animType,
+        NkEcsFindComponent(ecsReg, actWorldLy->m_plEntity, actWorldLy->m_animType),
+        *isMovPtr ? actWorldLy->mp_walkClips[*dirPtr] : actWorldLy->mp_idleClips[*dirPtr],
+        1.f
+    );
 
-    __NkInt_WorldLayer_UpdAnim(actWorldLy);
+    /*
+     * Move all entities and remember where they ended up for rendering. As rendering
+     * lags one step behind, frames must be drawn for as long as the previous and the
+     * current state differ, not just while entities move.
+     */
+    NK_IGNORE_RETURN_VALUE(__NkInt_WorldLayer_RunMovement(actWorldLy, updTime));
+    if (NkInterpCapture(ecsReg, actWorldLy->m_interpType, actWorldLy->m_motionType, __NkInt_MotionFld_PosX, __NkInt_MotionFld_PosY))
+        NkApplicationRequestRedraw();
+    /* Advance all animators at once. */
+    NkAnimUpdate(ecsReg, actWorldLy->m_animType, updTime);
     return NkErr_Ok;
 }
 
@@ -514,61 +1019,95 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnUpdate(_Inout_
  */
 NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnRender(_Inout_ NkILayer *self, _In_ NkFloat aheadBy) {
     NK_ASSERT(self != NULL, NkErr_InOutParameter);
-    NK_UNREFERENCED_PARAMETER(aheadBy);
 
     /* Get internal structure of world layer. */
     __NkInt_WorldLayer *actWorldLy = (__NkInt_WorldLayer *)self;
     /* Get viewport dimensions. */
     NkSize2D vpDim = actWorldLy->mp_rdTarget->VT->GetClientDimensions(actWorldLy->mp_rdTarget);
 
-    /* Interpolate player position. */
-    //NkVec2F actPlPos = (NkVec2F){
-    //    actWorldLy->m_playerPos.m_xVal * aheadBy + actWorldLy->m_prevPos.m_xVal * (1.f - aheadBy),
-    //    actWorldLy->m_playerPos.m_yVal * aheadBy + actWorldLy->m_prevPos.m_yVal * (1.f - aheadBy)
-    //};
-    NkVec2F actPlPos = (NkVec2F){
-        actWorldLy->m_playerPos.m_xVal,
-        actWorldLy->m_playerPos.m_yVal
+    /* Blend the render positions of all entities between the last two steps. */
+    NkInterpUpdate(actWorldLy->mp_ecsReg, actWorldLy->m_interpType, aheadBy);
+    NkVec2F const actPlPos = NkInterpGetPosition(
+        actWorldLy->mp_ecsReg,
+        actWorldLy->m_interpType,
+        NkEcsFindComponent(actWorldLy->mp_ecsReg, actWorldLy->m_plEntity, actWorldLy->m_interpType)
+    );
+
+    /*
+     * Draw the static tile layer. The cache only redraws the tiles that scrolled into
+     * view since the last frame.
+     */
+    NkErrorCode errCode = NkTileCacheRender(
+        actWorldLy->mp_tileCache,
+        (NkVec2F){ actPlPos.m_xVal - 8.f * 32.f, actPlPos.m_yVal - 8.f * 32.f },
+        &(NkRectF){
+            .m_xCoord = 0.f,
+            .m_yCoord = 0.f,
+            .m_width  = (NkFloat)NK_MIN(16 * 32, vpDim.m_width),
+            .m_height = (NkFloat)NK_MIN(16 * 32, vpDim.m_height)
+        }
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /*
+     * Draw the entities that are inside the viewport. The camera is centered on the
+     * player, so world coordinates are translated by the camera's top-left corner.
+     */
+    NkVec2F const camOri = { actPlPos.m_xVal - 8.f * 32.f, actPlPos.m_yVal - 8.f * 32.f };
+    NkRectF const vpRect = {
+        camOri.m_xVal,
+        camOri.m_yVal,
+        (NkFloat)NK_MIN(16 * 32, vpDim.m_width),
+        (NkFloat)NK_MIN(16 * 32, vpDim.m_height)
     };
+    NkUint32 const nVisible = NkSpatialGridQuery(actWorldLy->mp_entGrid, &vpRect, NULL, 0);
+    NkSpatialHandle *visArr;
+    NkRectF         *dstArr, *srcArr;
+    if (nVisible == 0)
+        return NkErr_Ok;
+    if (   (errCode = NkArenaAlloc(NkArenaGetFrameArena(), nVisible * sizeof *visArr, 0, (NkVoid **)&visArr)) != NkErr_Ok
+        || (errCode = NkArenaAlloc(NkArenaGetFrameArena(), nVisible * sizeof *dstArr, 0, (NkVoid **)&dstArr)) != NkErr_Ok
+        || (errCode = NkArenaAlloc(NkArenaGetFrameArena(), nVisible * sizeof *srcArr, 0, (NkVoid **)&srcArr)) != NkErr_Ok
+    ) return errCode;
+    NK_IGNORE_RETURN_VALUE(NkSpatialGridQuery(actWorldLy->mp_entGrid, &vpRect, visArr, nVisible));
 
-    int orix = -(int)actPlPos.m_xVal % 32 - 8 * 32;
-    int oriy = -(int)actPlPos.m_yVal % 32 - 8 * 32;
-    int xdim = NK_MIN(16 * 32, vpDim.m_width) - 8 * 32;
-    int ydim = NK_MIN(16 * 32, vpDim.m_height) - 8 * 32;
-
-    /* Draw world. */
-    for (int x = orix, tsx = (int)actPlPos.m_xVal / 32 * 32 - 8 * 32; x < xdim; x += 32, tsx += 32)
-        for (int y = oriy, tsy = (int)actPlPos.m_yVal / 32 * 32 - 8 * 32; y < ydim; y += 32, tsy += 32) {
-            /* Skip tiles that are out of range. */
-            if (tsx < 0 || tsx > 31 * 32 || tsy < 0 || tsy > 31 * 32)
-                continue;
-
-            /* Get chunk. */
-            int ix = tsx / 32 / 16;
-            int iy = tsy / 32 / 16;
-            NkUint32 *c = ix == 0 ? (iy == 0 ? gl_TestMap1 : gl_TestMap3) : (iy == 0 ? gl_TestMap2 : gl_TestMap4);
-                
-            /* Draw a tile. */
-            actWorldLy->mp_rdRef->VT->DrawTexture(
-                actWorldLy->mp_rdRef,
-                &(NkRectF){
-                    .m_xCoord = x + 8 * 32,
-                    .m_yCoord = y + 8 * 32,
-                    .m_width  = 32,
-                    .m_height = 32 
-                },
-                actWorldLy->mp_mainTexAtlas,
-                &(NkRectF){ 
-                    .m_xCoord = 32 * (c[16 * ((tsy / 32) % 16) + (tsx / 32) % 16] & 0xFFFF),
-                    .m_yCoord = 32 * (c[16 * ((tsy / 32) % 16) + (tsx / 32) % 16] >> 16),
-                    .m_width  = 32,
-                    .m_height = 32
-                }
-            );
+    /*
+     * Gather the current frame of every visible animated entity and submit them in one
+     * batch. All character frames were packed from the same sheet, so they share the
+     * texture of the first frame.
+     */
+    NkRectF const *animRects = NkEcsQueryField(actWorldLy->mp_ecsReg, actWorldLy->m_animType, NkAnimFld_SrcRect);
+    NkSize         nSprites  = 0;
+    for (NkUint32 i = 0; i < nVisible; i++) {
+        NkRectF           entRect;
+        NkEcsEntity const entId     = (NkEcsEntity)NkSpatialGridQueryObject(actWorldLy->mp_entGrid, visArr[i], &entRect);
+        NkUint32 const    animInd   = NkEcsFindComponent(actWorldLy->mp_ecsReg, entId, actWorldLy->m_animType);
+        NkUint32 const    interpInd = NkEcsFindComponent(actWorldLy->mp_ecsReg, entId, actWorldLy->m_interpType);
+        if (animInd == NK_ECS_NOINDEX)
+            continue;
+
+        /* The grid holds the simulated position; draw interpolated entities in between. */
+        if (interpInd != NK_ECS_NOINDEX) {
+            NkVec2F const rendPos = NkInterpGetPosition(actWorldLy->mp_ecsReg, actWorldLy->m_interpType, interpInd);
+
+            entRect.m_xCoord = rendPos.m_xVal;
+            entRect.m_yCoord = rendPos.m_yVal;
         }
 
-    NkVec2F charFrame = __NkInt_WorldLayer_GetAnimPos(actWorldLy);
-    actWorldLy->mp_rdRef->VT->DrawMaskedTexture(actWorldLy->mp_rdRef, &(NkRectF){ 8 * 32, 8 * 32, 32, 32 }, actWorldLy->mp_playerAtlas, (NkVec2F){ charFrame.m_xVal * 32.f, charFrame.m_yVal * 32.f }, actWorldLy->mp_plAtlasMask, (NkVec2F){ charFrame.m_xVal * 32.f, charFrame.m_yVal * 32.f });
+        dstArr[nSprites]   = (NkRectF){ entRect.m_xCoord - camOri.m_xVal, entRect.m_yCoord - camOri.m_yVal, entRect.m_width, entRect.m_height };
+        srcArr[nSprites++] = animRects[animInd];
+    }
+    NkSubTexture const *plFrame = NkTextureAtlasQuerySubTexture(actWorldLy->mp_texAtlas, actWorldLy->m_plFirstId);
+    errCode = actWorldLy->mp_rdRef->VT->DrawTextureBatch(
+        actWorldLy->mp_rdRef,
+        plFrame->mp_alphaRef != NULL ? plFrame->mp_alphaRef : plFrame->mp_texRef,
+        nSprites,
+        dstArr,
+        srcArr
+    );
+    if (errCode != NkErr_Ok)
+        return errCode;
 
     /* All good. */
     return NkErr_Ok;
@@ -581,19 +1120,21 @@ NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_WorldLayer_OnRender(_Inout_
 NK_INTERNAL __NkInt_WorldLayer gl_WorldLayer = {
     .NkILayer_Iface = {
         .VT = &(struct __NkILayer_VTable__){
-            .AddRef         = &__NkInt_WorldLayer_AddRef,
-            .Release        = &__NkInt_WorldLayer_Release,
-            .QueryInterface = &__NkInt_WorldLayer_QueryInterface,
-            .OnPush         = &__NkInt_WorldLayer_OnPush,
-            .OnPop          = &__NkInt_WorldLayer_OnPop,
-            .OnEvent        = &__NkInt_WorldLayer_OnEvent,
-            .OnUpdate       = &__NkInt_WorldLayer_OnUpdate,
-            .OnRender       = &__NkInt_WorldLayer_OnRender
+            .AddRef               = &__NkInt_WorldLayer_AddRef,
+            .Release              = &__NkInt_WorldLayer_Release,
+            .QueryInterface       = &__NkInt_WorldLayer_QueryInterface,
+            .OnPush               = &__NkInt_WorldLayer_OnPush,
+            .OnPop                = &__NkInt_WorldLayer_OnPop,
+            .OnEvent              = &__NkInt_WorldLayer_OnEvent,
+            .QueryEventCategories = &__NkInt_WorldLayer_QueryEventCategories,
+            .OnUpdate             = &__NkInt_WorldLayer_OnUpdate,
+            .OnFixedUpdate        = &__NkInt_WorldLayer_OnFixedUpdate,
+            .OnRender             = &__NkInt_WorldLayer_OnRender
         }
     },
     .mp_rdTarget     = NULL,
     .mp_rdRef        = NULL,
-    .mp_mainTexAtlas = NULL
+    .mp_texAtlas     = NULL
 };
 
 
@@ -623,7 +1164,7 @@ NK_COMPONENT_DEFINE(WorldLayer) {
     .m_compUuid     = { 0x6e6c7be8, 0xedf7, 0x494d, 0x8f61fb1abf5aa80b },
     .mp_clsId       = NULL,
     .m_compIdent    = NK_MAKE_STRING_VIEW("world layer"),
-    .m_compFlags    = 0,
+    .m_compFlags    = NkCompFlag_MainThread,
     .m_isNkOM       = NK_FALSE,
 
     .mp_fnQueryInst = NULL,
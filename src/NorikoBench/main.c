@@ -0,0 +1,699 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  main.c
+ * \brief entrypoint of Noriko's micro-benchmarks for the core data structures
+ *
+ * Every benchmark carries out a fixed number of operations per repetition. Before that,
+ * a few repetitions are run to warm up caches and allocator pools; their timings are
+ * discarded. The time of every measured repetition is divided by the number of
+ * operations, and the resulting per-operation times are reported as minimum, mean,
+ * percentiles and maximum. The percentiles are far less noisy than the mean and are what
+ * comparisons between builds should be based on.
+ *
+ * Work that is only needed to prepare a repetition (for example, filling the hash table
+ * that a lookup benchmark queries) is done in a setup callback that is not timed.
+ *
+ * The benchmark understands the following command-line options:
+ * \li <tt>-reps=n</tt>: number of measured repetitions (default: \c 31)
+ * \li <tt>-warmup=n</tt>: number of warm-up repetitions (default: \c 5)
+ * \li <tt>-filter=str</tt>: only run benchmarks whose name contains \c str
+ * \li <tt>-json=path</tt>: additionally write the results to a JSON file
+ */
+#define NK_NAMESPACE "nk::bench"
+
+
+/* stdlib includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/noriko.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \def   __NkInt_Bench_NumOps
+ * \brief number of operations carried out by every benchmark in a single repetition
+ */
+#define __NkInt_Bench_NumOps  ((NkSize)(4096))
+/**
+ * \def   __NkInt_Bench_MaxReps
+ * \brief maximum number of measured repetitions
+ */
+#define __NkInt_Bench_MaxReps ((NkSize)(1024))
+/**
+ * \def   __NkInt_Bench_KeyLen
+ * \brief size of a string key, in bytes (incl. <tt>NUL</tt>)
+ */
+#define __NkInt_Bench_KeyLen  ((NkSize)(20))
+
+
+/**
+ * \struct __NkInt_BenchCxt
+ * \brief  holds the input data shared by all benchmarks and the state of the current
+ *         repetition
+ * \note   The input data is generated once at startup so that every benchmark and every
+ *         repetition works on the same keys.
+ */
+NK_NATIVE typedef struct __NkInt_BenchCxt {
+    NkUint64      m_intKeys[__NkInt_Bench_NumOps];                       /**< random integer keys */
+    char          m_strKeys[__NkInt_Bench_NumOps][__NkInt_Bench_KeyLen]; /**< string keys derived from the integer keys */
+    NkUuid        m_uuidKeys[__NkInt_Bench_NumOps];                      /**< random UUID keys */
+    NkVoid       *mp_shufArr[__NkInt_Bench_NumOps];                      /**< pointers to \c m_intKeys, in random order */
+    NkVoid       *mp_ptrArr[__NkInt_Bench_NumOps];                       /**< scratch pointer array */
+    NkHashtable  *mp_htPtr;                                              /**< hash table of the current repetition */
+    NkVector     *mp_vecPtr;                                             /**< vector of the current repetition */
+    NkString      m_strObj;                                              /**< string of the current repetition */
+    NkUint64      m_sinkVal;                                             /**< accumulates results so that they are not optimized away */
+} __NkInt_BenchCxt;
+
+/**
+ * \typedef __NkInt_BenchFn
+ * \brief   callback of a benchmark
+ * \param   [in, out] cxtPtr benchmark context
+ * \param   [in] benchParam parameter of the benchmark, for example the key type
+ * \return  \c NkErr_Ok on success, non-zero on failure
+ */
+typedef NkErrorCode (NK_CALL *__NkInt_BenchFn)(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam);
+
+/**
+ * \struct __NkInt_Benchmark
+ * \brief  describes a single benchmark
+ */
+NK_NATIVE typedef struct __NkInt_Benchmark {
+    char const      *mp_nameStr;    /**< name of the benchmark */
+    NkInt64          m_benchParam;  /**< parameter passed to all callbacks */
+    __NkInt_BenchFn  mp_fnSetup;    /**< (optional) prepares a repetition; not timed */
+    __NkInt_BenchFn  mp_fnRun;      /**< carries out \c __NkInt_Bench_NumOps operations; timed */
+    __NkInt_BenchFn  mp_fnTeardown; /**< (optional) cleans up after a repetition; not timed */
+} __NkInt_Benchmark;
+
+/**
+ * \struct __NkInt_BenchResult
+ * \brief  holds the statistics of a single benchmark, in nanoseconds per operation
+ */
+NK_NATIVE typedef struct __NkInt_BenchResult {
+    NkDouble m_minNs;  /**< fastest repetition */
+    NkDouble m_meanNs; /**< arithmetic mean */
+    NkDouble m_p50Ns;  /**< median */
+    NkDouble m_p90Ns;  /**< 90th percentile */
+    NkDouble m_p99Ns;  /**< 99th percentile */
+    NkDouble m_maxNs;  /**< slowest repetition */
+} __NkInt_BenchResult;
+
+
+/**
+ * \brief compares two pointers to 64-bit integers by the integers they point to
+ */
+NK_INTERNAL NkInt32 NK_CALL __NkInt_Bench_CompareInts(_In_ NkVoid const *lhsPtr, _In_ NkVoid const *rhsPtr) {
+    NkUint64 const lhsVal = *(NkUint64 const *)lhsPtr;
+    NkUint64 const rhsVal = *(NkUint64 const *)rhsPtr;
+
+    return (NkInt32)(lhsVal > rhsVal) - (NkInt32)(lhsVal < rhsVal);
+}
+
+/**
+ * \brief compares two doubles, as required by <tt>qsort()</tt>
+ */
+NK_INTERNAL int __NkInt_Bench_CompareDoubles(_In_ void const *lhsPtr, _In_ void const *rhsPtr) {
+    NkDouble const lhsVal = *(NkDouble const *)lhsPtr;
+    NkDouble const rhsVal = *(NkDouble const *)rhsPtr;
+
+    return (lhsVal > rhsVal) - (lhsVal < rhsVal);
+}
+
+/**
+ * \brief  generates the input data of all benchmarks
+ * \param  [out] cxtPtr benchmark context
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Bench_GenerateInput(_Out_ __NkInt_BenchCxt *cxtPtr) {
+    NkErrorCode errCode;
+
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        if ((errCode = NkPRNGNext(&cxtPtr->m_intKeys[i])) != NkErr_Ok)
+            return errCode;
+        NkUuidGenerate(&cxtPtr->m_uuidKeys[i]);
+
+        snprintf(cxtPtr->m_strKeys[i], __NkInt_Bench_KeyLen, "key%016llx", (unsigned long long)cxtPtr->m_intKeys[i]);
+        cxtPtr->mp_shufArr[i] = &cxtPtr->m_intKeys[i];
+    }
+
+    /* Fisher-Yates shuffle, so that sorting does not start on sorted input. */
+    for (NkSize i = __NkInt_Bench_NumOps - 1; i > 0; i--) {
+        NkUint64 randVal;
+        if ((errCode = NkPRNGNext(&randVal)) != NkErr_Ok)
+            return errCode;
+
+        NkSize const j     = (NkSize)(randVal % (i + 1));
+        NkVoid      *tmpPtr = cxtPtr->mp_shufArr[i];
+        cxtPtr->mp_shufArr[i] = cxtPtr->mp_shufArr[j];
+        cxtPtr->mp_shufArr[j] = tmpPtr;
+    }
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  builds the hash table key of the i-th element for the given key type
+ */
+NK_INTERNAL NK_INLINE NkHashtableKey __NkInt_Bench_MakeKey(
+    _In_ __NkInt_BenchCxt *cxtPtr,
+    _In_ NkHashtableKeyType keyType,
+    _In_ NkSize i
+) {
+    switch (keyType) {
+        case NkHtKeyTy_String: return (NkHashtableKey){ .mp_strKey = cxtPtr->m_strKeys[i] };
+        case NkHtKeyTy_Uuid:   return (NkHashtableKey){ .mp_uuidKey = &cxtPtr->m_uuidKeys[i] };
+        default:               return (NkHashtableKey){ .m_uint64Key = cxtPtr->m_intKeys[i] };
+    }
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_HtCreate(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    return NkHashtableCreate(&(NkHashtableProperties const){
+        .m_structSize   = sizeof(NkHashtableProperties),
+        .m_initCap      = 16,
+        .m_keyType      = (NkHashtableKeyType)benchParam,
+        .m_minCap       = 16,
+        .m_maxCap       = UINT32_MAX - 2,
+        .mp_fnElemFree  = NULL,
+        .m_isConcurrent = NK_FALSE
+    }, &cxtPtr->mp_htPtr);
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_HtInsert(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkErrorCode const errCode = NkHashtableInsert(cxtPtr->mp_htPtr, &(NkHashtablePair const){
+            .m_keyVal    = __NkInt_Bench_MakeKey(cxtPtr, (NkHashtableKeyType)benchParam, i),
+            .mp_valuePtr = &cxtPtr->m_intKeys[i]
+        });
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_HtCreateFilled(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NkErrorCode errCode = __NkInt_Bench_HtCreate(cxtPtr, benchParam);
+
+    return errCode == NkErr_Ok ? __NkInt_Bench_HtInsert(cxtPtr, benchParam) : errCode;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_HtLookup(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkHashtableKey const keyVal = __NkInt_Bench_MakeKey(cxtPtr, (NkHashtableKeyType)benchParam, i);
+        NkVoid              *valPtr;
+
+        NkErrorCode const errCode = NkHashtableAt(cxtPtr->mp_htPtr, &keyVal, &valPtr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+        cxtPtr->m_sinkVal += *(NkUint64 *)valPtr;
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_HtErase(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkHashtableKey const keyVal = __NkInt_Bench_MakeKey(cxtPtr, (NkHashtableKeyType)benchParam, i);
+
+        NkErrorCode const errCode = NkHashtableErase(cxtPtr->mp_htPtr, &keyVal);
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_HtDestroy(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    NkHashtableDestroy(&cxtPtr->mp_htPtr);
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_VecCreate(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    return NkVectorCreate(&(NkVectorProperties const){
+        .m_structSize = sizeof(NkVectorProperties),
+        .m_initialCap = 8,
+        .m_minCap     = 8,
+        .m_maxCap     = SIZE_MAX - 1,
+        .m_growFactor = 1.5f
+    }, NULL, &cxtPtr->mp_vecPtr);
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_VecInsert(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkErrorCode const errCode = NkVectorInsert(cxtPtr->mp_vecPtr, cxtPtr->mp_shufArr[i], NK_VECTOR_END(cxtPtr->mp_vecPtr));
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_VecCreateFilled(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NkErrorCode errCode = __NkInt_Bench_VecCreate(cxtPtr, benchParam);
+
+    return errCode == NkErr_Ok ? __NkInt_Bench_VecInsert(cxtPtr, benchParam) : errCode;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_VecErase(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    /* Erase from the back; erasing from the front measures memmove() rather than the vector. */
+    for (NkSize i = __NkInt_Bench_NumOps; i > 0; i--) {
+        NkVoid *elemPtr;
+
+        NkErrorCode const errCode = NkVectorErase(cxtPtr->mp_vecPtr, i - 1, &elemPtr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_VecSort(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    NkVectorSort(cxtPtr->mp_vecPtr, 0, __NkInt_Bench_NumOps - 1, &__NkInt_Bench_CompareInts);
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_VecDestroy(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    NkVectorDestroy(&cxtPtr->mp_vecPtr);
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_PtrShuffle(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    memcpy(cxtPtr->mp_ptrArr, cxtPtr->mp_shufArr, sizeof cxtPtr->mp_ptrArr);
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_PtrQuicksort(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    NkErrorCode const errCode = NkQuicksortPointers(cxtPtr->mp_ptrArr, 0, __NkInt_Bench_NumOps - 1, &__NkInt_Bench_CompareInts);
+    return errCode == NkErr_NoOperation ? NkErr_Ok : errCode;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_PoolAllocFree(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkErrorCode const errCode = NkPoolAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkUint32)benchParam, 1, &cxtPtr->mp_ptrArr[i]);
+
+        if (errCode != NkErr_Ok) {
+            while (i > 0)
+                NkPoolFree(cxtPtr->mp_ptrArr[--i]);
+
+            return errCode;
+        }
+    }
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++)
+        NkPoolFree(cxtPtr->mp_ptrArr[i]);
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_GPAllocFree(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkErrorCode const errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)benchParam, 0, NK_FALSE, &cxtPtr->mp_ptrArr[i]);
+
+        if (errCode != NkErr_Ok) {
+            while (i > 0)
+                NkGPFree(cxtPtr->mp_ptrArr[--i]);
+
+            return errCode;
+        }
+    }
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++)
+        NkGPFree(cxtPtr->mp_ptrArr[i]);
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_StrCreate(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    return NkStringCreate(NULL, 0, &cxtPtr->m_strObj);
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_StrAppend(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkErrorCode const errCode = NkStringJoin(&cxtPtr->m_strObj, cxtPtr->m_strKeys[i], (NkUint32)benchParam);
+
+        if (errCode != NkErr_Ok)
+            return errCode;
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_StrDestroy(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    NkStringDestroy(&cxtPtr->m_strObj);
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_PRNGNext(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        NkUint64 randVal;
+
+        NkErrorCode const errCode = NkPRNGNext(&randVal);
+        if (errCode != NkErr_Ok)
+            return errCode;
+        cxtPtr->m_sinkVal += randVal;
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_UuidFormat(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        char uuidStr[NK_UUIDLEN];
+
+        cxtPtr->m_sinkVal += (NkUint64)NkUuidToString(&cxtPtr->m_uuidKeys[i], uuidStr)[i % 36];
+    }
+    return NkErr_Ok;
+}
+
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Bench_UuidRoundtrip(_Inout_ __NkInt_BenchCxt *cxtPtr, _In_ NkInt64 benchParam) {
+    NK_UNREFERENCED_PARAMETER(benchParam);
+
+    for (NkSize i = 0; i < __NkInt_Bench_NumOps; i++) {
+        char   uuidStr[NK_UUIDLEN];
+        NkUuid uuidVal;
+
+        NkErrorCode const errCode = NkUuidFromString(NkUuidToString(&cxtPtr->m_uuidKeys[i], uuidStr), &uuidVal);
+        if (errCode != NkErr_Ok)
+            return errCode;
+        cxtPtr->m_sinkVal += NkUuidIsEqual(&uuidVal, &cxtPtr->m_uuidKeys[i]);
+    }
+    return NkErr_Ok;
+}
+
+
+/**
+ * \brief list of all benchmarks, in the order they are run
+ */
+NK_INTERNAL __NkInt_Benchmark const gl_c_Benchmarks[] = {
+    { "htable/insert/int64",  NkHtKeyTy_Uint64, &__NkInt_Bench_HtCreate,        &__NkInt_Bench_HtInsert,      &__NkInt_Bench_HtDestroy  },
+    { "htable/insert/string", NkHtKeyTy_String, &__NkInt_Bench_HtCreate,        &__NkInt_Bench_HtInsert,      &__NkInt_Bench_HtDestroy  },
+    { "htable/insert/uuid",   NkHtKeyTy_Uuid,   &__NkInt_Bench_HtCreate,        &__NkInt_Bench_HtInsert,      &__NkInt_Bench_HtDestroy  },
+    { "htable/lookup/int64",  NkHtKeyTy_Uint64, &__NkInt_Bench_HtCreateFilled,  &__NkInt_Bench_HtLookup,      &__NkInt_Bench_HtDestroy  },
+    { "htable/lookup/string", NkHtKeyTy_String, &__NkInt_Bench_HtCreateFilled,  &__NkInt_Bench_HtLookup,      &__NkInt_Bench_HtDestroy  },
+    { "htable/lookup/uuid",   NkHtKeyTy_Uuid,   &__NkInt_Bench_HtCreateFilled,  &__NkInt_Bench_HtLookup,      &__NkInt_Bench_HtDestroy  },
+    { "htable/erase/int64",   NkHtKeyTy_Uint64, &__NkInt_Bench_HtCreateFilled,  &__NkInt_Bench_HtErase,       &__NkInt_Bench_HtDestroy  },
+    { "htable/erase/string",  NkHtKeyTy_String, &__NkInt_Bench_HtCreateFilled,  &__NkInt_Bench_HtErase,       &__NkInt_Bench_HtDestroy  },
+    { "htable/erase/uuid",    NkHtKeyTy_Uuid,   &__NkInt_Bench_HtCreateFilled,  &__NkInt_Bench_HtErase,       &__NkInt_Bench_HtDestroy  },
+    { "vector/insert",        0,                &__NkInt_Bench_VecCreate,       &__NkInt_Bench_VecInsert,     &__NkInt_Bench_VecDestroy },
+    { "vector/erase",         0,                &__NkInt_Bench_VecCreateFilled, &__NkInt_Bench_VecErase,      &__NkInt_Bench_VecDestroy },
+    { "vector/sort",          0,                &__NkInt_Bench_VecCreateFilled, &__NkInt_Bench_VecSort,       &__NkInt_Bench_VecDestroy },
+    { "sort/quicksort",       0,                &__NkInt_Bench_PtrShuffle,      &__NkInt_Bench_PtrQuicksort,  NULL                      },
+    { "alloc/pool/32",        32,               NULL,                           &__NkInt_Bench_PoolAllocFree, NULL                      },
+    { "alloc/pool/256",       256,              NULL,                           &__NkInt_Bench_PoolAllocFree, NULL                      },
+    { "alloc/gp/32",          32,               NULL,                           &__NkInt_Bench_GPAllocFree,   NULL                      },
+    { "alloc/gp/256",         256,              NULL,                           &__NkInt_Bench_GPAllocFree,   NULL                      },
+    { "string/append/8",      8,                &__NkInt_Bench_StrCreate,       &__NkInt_Bench_StrAppend,     &__NkInt_Bench_StrDestroy },
+    { "prng/next",            0,                NULL,                           &__NkInt_Bench_PRNGNext,      NULL                      },
+    { "uuid/format",          0,                NULL,                           &__NkInt_Bench_UuidFormat,    NULL                      },
+    { "uuid/roundtrip",       0,                NULL,                           &__NkInt_Bench_UuidRoundtrip, NULL                      }
+};
+
+
+/**
+ * \brief  runs a single repetition of a benchmark
+ * \param  [in] benchPtr benchmark
+ * \param  [in, out] cxtPtr benchmark context
+ * \param  [out] nTicks pointer to a variable that receives the duration of the timed
+ *               part, in timer ticks
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Bench_RunOnce(
+    _In_    __NkInt_Benchmark const *benchPtr,
+    _Inout_ __NkInt_BenchCxt *cxtPtr,
+    _Out_   NkUint64 *nTicks
+) {
+    NkErrorCode errCode = NkErr_Ok;
+    if (benchPtr->mp_fnSetup != NULL && (errCode = (*benchPtr->mp_fnSetup)(cxtPtr, benchPtr->m_benchParam)) != NkErr_Ok)
+        return errCode;
+
+    NkUint64 const startTime = NkTimerGetCurrentTicks();
+    errCode = (*benchPtr->mp_fnRun)(cxtPtr, benchPtr->m_benchParam);
+    *nTicks = NkTimerGetCurrentTicks() - startTime;
+
+    if (benchPtr->mp_fnTeardown != NULL)
+        NK_IGNORE_RETURN_VALUE((*benchPtr->mp_fnTeardown)(cxtPtr, benchPtr->m_benchParam));
+    return errCode;
+}
+
+/**
+ * \brief  runs a benchmark and computes its statistics
+ * \param  [in] benchPtr benchmark
+ * \param  [in, out] cxtPtr benchmark context
+ * \param  [in] nWarmup number of warm-up repetitions
+ * \param  [in] nReps number of measured repetitions
+ * \param  [out] resPtr pointer to a structure that receives the statistics
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   Percentiles use the nearest-rank method.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Bench_Run(
+    _In_    __NkInt_Benchmark const *benchPtr,
+    _Inout_ __NkInt_BenchCxt *cxtPtr,
+    _In_    NkSize nWarmup,
+    _In_    NkSize nReps,
+    _Out_   __NkInt_BenchResult *resPtr
+) {
+    NkDouble    sampleArr[__NkInt_Bench_MaxReps];
+    NkDouble    sumNs   = 0.;
+    NkDouble    nsPerOp = 1e9 / (NkDouble)NkTimerGetFrequency() / (NkDouble)__NkInt_Bench_NumOps;
+    NkErrorCode errCode;
+
+    for (NkSize i = 0; i < nWarmup + nReps; i++) {
+        NkUint64 nTicks;
+        if ((errCode = __NkInt_Bench_RunOnce(benchPtr, cxtPtr, &nTicks)) != NkErr_Ok)
+            return errCode;
+
+        if (i >= nWarmup) {
+            sampleArr[i - nWarmup] = (NkDouble)nTicks * nsPerOp;
+
+            sumNs += sampleArr[i - nWarmup];
+        }
+    }
+    qsort(sampleArr, nReps, sizeof *sampleArr, &__NkInt_Bench_CompareDoubles);
+
+#define __NkInt_Bench_Percentile(p) (sampleArr[NK_MIN(nReps - 1, (NkSize)(((p) * nReps + 99) / 100) - 1)])
+    *resPtr = (__NkInt_BenchResult){
+        .m_minNs  = sampleArr[0],
+        .m_meanNs = sumNs / (NkDouble)nReps,
+        .m_p50Ns  = __NkInt_Bench_Percentile(50),
+        .m_p90Ns  = __NkInt_Bench_Percentile(90),
+        .m_p99Ns  = __NkInt_Bench_Percentile(99),
+        .m_maxNs  = sampleArr[nReps - 1]
+    };
+#undef __NkInt_Bench_Percentile
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  reads a non-negative integer option from the command-line
+ * \param  [in] keyStr name of the option
+ * \param  [in] defVal value to use if the option was not given or is invalid
+ * \param  [in] maxVal largest accepted value
+ * \return value of the option
+ */
+NK_INTERNAL NkSize __NkInt_Bench_QueryCountOption(_In_z_ char const *keyStr, _In_ NkSize defVal, _In_ NkSize maxVal) {
+    NkVariant     optVar;
+    NkVariantType varTy;
+    NkDouble      optVal;
+    if (NkEnvGetValue(keyStr, &optVar) != NkErr_Ok)
+        return defVal;
+
+    NkVariantGet(&optVar, &varTy, &optVal);
+    if (varTy != NkVarTy_Double || optVal < 0. || optVal > (NkDouble)maxVal) {
+        NK_LOG_WARNING("Ignoring invalid value of option \"%s\"; must be an integer between 0 and %zu.", keyStr, maxVal);
+
+        return defVal;
+    }
+    return (NkSize)optVal;
+}
+
+/**
+ * \brief  runs all benchmarks selected on the command-line and reports their results
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Bench_RunAll(NkVoid) {
+    NkSize const nWarmup = __NkInt_Bench_QueryCountOption("warmup", 5, SIZE_MAX / 2);
+    NkSize const nReps   = NK_MAX(__NkInt_Bench_QueryCountOption("reps", 31, __NkInt_Bench_MaxReps), 1);
+
+    /* Read the optional name filter and JSON output path. */
+    NkVariant     optVar;
+    NkVariantType varTy;
+    NkStringView  filterStr = { NULL, 0 }, jsonPath = { NULL, 0 };
+    if (NkEnvGetValue("filter", &optVar) == NkErr_Ok) {
+        NkVariantGet(&optVar, &varTy, &filterStr);
+
+        if (varTy != NkVarTy_StringView)
+            filterStr = (NkStringView){ NULL, 0 };
+    }
+    if (NkEnvGetValue("json", &optVar) == NkErr_Ok) {
+        NkVariantGet(&optVar, &varTy, &jsonPath);
+
+        if (varTy != NkVarTy_StringView)
+            jsonPath = (NkStringView){ NULL, 0 };
+    }
+    char filterBuf[64] = { 0 }, pathBuf[1024] = { 0 };
+    if (filterStr.m_sizeInBytes >= sizeof filterBuf || jsonPath.m_sizeInBytes >= sizeof pathBuf)
+        return NkErr_InvalidRange;
+    if (filterStr.m_sizeInBytes > 0)
+        memcpy(filterBuf, filterStr.mp_dataPtr, filterStr.m_sizeInBytes);
+    if (jsonPath.m_sizeInBytes > 0)
+        memcpy(pathBuf, jsonPath.mp_dataPtr, jsonPath.m_sizeInBytes);
+
+    /* The context is too large for the stack. */
+    __NkInt_BenchCxt *cxtPtr;
+    NkErrorCode errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof *cxtPtr, 0, NK_TRUE, (NkVoid **)&cxtPtr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    if ((errCode = __NkInt_Bench_GenerateInput(cxtPtr)) != NkErr_Ok)
+        goto lbl_ONFIN;
+
+    FILE *jsonFile = NULL;
+    if (*pathBuf != '\0' && fopen_s(&jsonFile, pathBuf, "w") != 0) {
+        NK_LOG_ERROR("Could not open \"%s\" for writing.", pathBuf);
+
+        errCode = NkErr_OpenFile;
+        goto lbl_ONFIN;
+    }
+    if (jsonFile != NULL)
+        fprintf(jsonFile, "{\n  \"ops_per_rep\": %zu,\n  \"warmup\": %zu,\n  \"reps\": %zu,\n  \"benchmarks\": [", __NkInt_Bench_NumOps, nWarmup, nReps);
+
+    printf("%-24s %10s %10s %10s %10s %10s %10s\n", "benchmark (ns/op)", "min", "mean", "p50", "p90", "p99", "max");
+    NkBoolean isFirst = NK_TRUE;
+    for (NkSize i = 0; i < NK_ARRAYSIZE(gl_c_Benchmarks); i++) {
+        __NkInt_Benchmark const *benchPtr = &gl_c_Benchmarks[i];
+        if (*filterBuf != '\0' && strstr(benchPtr->mp_nameStr, filterBuf) == NULL)
+            continue;
+
+        __NkInt_BenchResult benchRes;
+        if ((errCode = __NkInt_Bench_Run(benchPtr, cxtPtr, nWarmup, nReps, &benchRes)) != NkErr_Ok) {
+            NK_LOG_ERROR("Benchmark \"%s\" failed: %s", benchPtr->mp_nameStr, NkGetErrorCodeStr(errCode)->mp_dataPtr);
+
+            break;
+        }
+
+        printf(
+            "%-24s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+            benchPtr->mp_nameStr,
+            benchRes.m_minNs,
+            benchRes.m_meanNs,
+            benchRes.m_p50Ns,
+            benchRes.m_p90Ns,
+            benchRes.m_p99Ns,
+            benchRes.m_maxNs
+        );
+        if (jsonFile != NULL)
+            fprintf(
+                jsonFile,
+                "%s\n    { \"name\": \"%s\", \"min_ns\": %.3f, \"mean_ns\": %.3f, \"p50_ns\": %.3f, "
+                "\"p90_ns\": %.3f, \"p99_ns\": %.3f, \"max_ns\": %.3f }",
+                isFirst ? "" : ",",
+                benchPtr->mp_nameStr,
+                benchRes.m_minNs,
+                benchRes.m_meanNs,
+                benchRes.m_p50Ns,
+                benchRes.m_p90Ns,
+                benchRes.m_p99Ns,
+                benchRes.m_maxNs
+            );
+        isFirst = NK_FALSE;
+    }
+    if (jsonFile != NULL) {
+        fprintf(jsonFile, "\n  ]\n}\n");
+
+        if (fclose(jsonFile) != 0 && errCode == NkErr_Ok)
+            errCode = NkErr_ErrorDuringDiskIO;
+    }
+
+    /* Print the sink so that the compiler cannot drop the work that produced it. */
+    NK_LOG_TRACE("Checksum: 0x%016llx", (unsigned long long)cxtPtr->m_sinkVal);
+
+lbl_ONFIN:
+    NkGPFree(cxtPtr);
+
+    return errCode;
+}
+/** \endcond */
+
+
+int main(int argc, char **argv, char **envp) {
+    /* Enable Visual Studio memory leak detector. */
+#if (defined _DEBUG)
+    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+    /*
+     * Run the engine in attached mode so that the asset manager does not open an asset
+     * database; the benchmarks only need the core services.
+     */
+    char **argArr = (char **)calloc((size_t)argc + 2, sizeof *argArr);
+    if (argArr == NULL)
+        return NkErr_MemoryAllocation;
+    for (int i = 0; i < argc; i++)
+        argArr[i] = argv[i];
+    argArr[argc] = "-attached";
+
+    /* Startup the engine component; the window stays hidden. */
+    NkErrorCode errCode = NkApplicationStartup(&(NkApplicationSpecification const){
+        .m_structSize      = sizeof(NkApplicationSpecification),
+        .m_enableDbgTools  = NK_FALSE,
+        .m_rendererApi     = NkRdApi_Win32GDI,
+        .m_isVSync         = NK_FALSE,
+        .m_fixedTickRate   = 0,
+        .m_targetFps       = 0,
+        .m_isOnDemand      = NK_FALSE,
+        .m_vpAlignment     = NkVpAlign_HCenter | NkVpAlign_VCenter,
+        .m_vpExtents       = { 16, 16 },
+        .m_dispTileSize    = { 32, 32 },
+        .m_allowedWndModes = NkWndMode_All,
+        .m_initialWndMode  = NkWndMode_Hidden,
+        .m_wndFlags        = 0,
+        .mp_nativeHandle   = NULL,
+        .m_wndTitle        = NK_MAKE_STRING_VIEW("Noriko Benchmarks"),
+        .m_argc            = argc + 1,
+        .mp_argv           = argArr,
+        .mp_envp           = envp,
+        .m_gameRootDir     = NK_MAKE_STRING_VIEW(NULL)
+    });
+    if (errCode != NkErr_Ok)
+        goto lbl_END;
+
+    /* Run the benchmarks. */
+    errCode = __NkInt_Bench_RunAll();
+
+lbl_END:
+    NK_IGNORE_RETURN_VALUE(NkApplicationShutdown());
+
+    free(argArr);
+    return errCode;
+}
+
+
+#undef NK_NAMESPACE
+
+
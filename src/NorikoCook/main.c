@@ -0,0 +1,755 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  main.c
+ * \brief entrypoint of Noriko's asset cooker
+ *
+ * The asset cooker reads the asset database and writes the data of all assets into a
+ * pack archive, converting it into the form the runtime uses so that no work is left to
+ * be done at load time. Texture atlases are converted into top-down 32-bit BGRA pixels,
+ * the format of the renderer's back-buffer; pixels of the key color are made fully
+ * transparent and the transparency mask is built in advance. All other assets are stored
+ * as-is, compressed.
+ *
+ * Cooking is incremental. Next to the archive, a manifest records a hash of the contents
+ * of every source file together with the options it was cooked with. When the cooker is
+ * run again, blobs whose hash did not change are copied over from the previous archive
+ * instead of being cooked again.
+ *
+ * The cooker understands the following command-line options:
+ * \li <tt>-db=path</tt>: asset database (default: \c assets.db)
+ * \li <tt>-out=path</tt>: archive to write (default: \c assets.pak)
+ * \li <tt>-root=path</tt>: directory asset paths are relative to (default: directory of
+ *     the asset database)
+ * \li <tt>-key=\#RRGGBB</tt>: key color of texture atlases (default: \c \#FF00FF)
+ * \li <tt>-premultiply</tt>: premultiply the color channels of textures with alpha
+ * \li <tt>-rebuild</tt>: ignore the manifest and cook all assets
+ */
+#define NK_NAMESPACE "nk::cook"
+
+
+/* stdlib includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Noriko includes */
+#include <include/Noriko/noriko.h>
+
+
+/** \cond INTERNAL */
+/**
+ * \def   __NkInt_Cook_ManifestMagic
+ * \brief magic number at the start of the manifest file ('NKCM')
+ */
+#define __NkInt_Cook_ManifestMagic ((NkUint32)(0x4d434b4e))
+/**
+ * \def   __NkInt_Cook_FormatVersion
+ * \brief version of the cooked data; bumping it invalidates all blobs of older archives
+ */
+#define __NkInt_Cook_FormatVersion ((NkUint32)(1))
+/**
+ * \def   __NkInt_Cook_MaxPath
+ * \brief maximum length of a path handled by the cooker, in bytes (incl. <tt>NUL</tt>)
+ */
+#define __NkInt_Cook_MaxPath       ((NkSize)(1024))
+
+
+/**
+ * \struct __NkInt_CookOptions
+ * \brief  holds the options the cooker was started with
+ */
+NK_NATIVE typedef struct __NkInt_CookOptions {
+    char      m_dbPath[__NkInt_Cook_MaxPath];   /**< path of the asset database */
+    char      m_outPath[__NkInt_Cook_MaxPath];  /**< path of the archive */
+    char      m_rootPath[__NkInt_Cook_MaxPath]; /**< directory asset paths are relative to */
+    NkUint32  m_keyColor;                       /**< key color as <tt>0x00RRGGBB</tt> */
+    NkBoolean m_isPremul;                       /**< whether textures are premultiplied */
+    NkBoolean m_isRebuild;                      /**< whether the manifest is ignored */
+} __NkInt_CookOptions;
+
+/**
+ * \struct __NkInt_CookAsset
+ * \brief  represents a single asset that is to be cooked
+ */
+NK_NATIVE typedef struct __NkInt_CookAsset {
+    NkUuid       m_assetUuid; /**< UUID of the asset */
+    NkAssetType  m_assetType; /**< type of the asset */
+    char        *mp_pathStr;  /**< path of the source file, relative to the root directory */
+} __NkInt_CookAsset;
+
+/**
+ * \struct __NkInt_CookAssetList
+ * \brief  receives the rows of the asset query
+ */
+NK_NATIVE typedef struct __NkInt_CookAssetList {
+    __NkInt_CookAsset *mp_assetArr; /**< assets */
+    NkSize             m_nAssets;   /**< number of valid elements in \c mp_assetArr */
+    NkSize             m_capacity;  /**< number of elements \c mp_assetArr can hold */
+} __NkInt_CookAssetList;
+
+/**
+ * \struct __NkInt_CookManifestHeader
+ * \brief  represents the header of the manifest file
+ */
+NK_NATIVE typedef struct __NkInt_CookManifestHeader {
+    NkUint32 m_magicNum;  /**< must be \c __NkInt_Cook_ManifestMagic */
+    NkUint32 m_formatVer; /**< must be \c __NkInt_Cook_FormatVersion */
+    NkUint64 m_nEntries;  /**< number of entries following the header */
+} __NkInt_CookManifestHeader;
+
+/**
+ * \struct __NkInt_CookManifestEntry
+ * \brief  represents an entry of the manifest
+ * \note   Entries are sorted by UUID so that they can be binary-searched.
+ */
+NK_NATIVE typedef struct __NkInt_CookManifestEntry {
+    NkUuid   m_assetUuid; /**< UUID of the asset */
+    NkUint64 m_srcHash;   /**< hash of the source file and the cooking options */
+} __NkInt_CookManifestEntry;
+
+
+/**
+ * \brief  compares two manifest entries by their UUIDs
+ * \return negative, zero or positive, as required by <tt>qsort()</tt>
+ */
+NK_INTERNAL int __NkInt_Cook_CompareEntries(_In_ void const *lhsPtr, _In_ void const *rhsPtr) {
+    return memcmp(lhsPtr, rhsPtr, sizeof(NkUuid));
+}
+
+/**
+ * \brief  calculates the 64-bit FNV-1a hash of a range of bytes
+ * \param  [in] bufPtr bytes to hash
+ * \param  [in] nBytes number of bytes
+ * \param  [in] seedVal hash of the previous range, or the FNV offset basis
+ * \return hash value
+ */
+NK_INTERNAL NkUint64 __NkInt_Cook_HashBytes(
+    _I_bytes_(nBytes) NkVoid const *bufPtr,
+    _In_              NkSize nBytes,
+    _In_              NkUint64 seedVal
+) {
+    NkByte const *bytePtr = (NkByte const *)bufPtr;
+
+    for (NkSize i = 0; i < nBytes; i++)
+        seedVal = (seedVal ^ bytePtr[i]) * UINT64_C(0x100000001b3);
+    return seedVal;
+}
+
+/**
+ * \brief  reads a string option from the command-line
+ * \param  [in] keyStr name of the option
+ * \param  [in] defStr value to use if the option was not given
+ * \param  [out] resBuf buffer that receives the value
+ * \return \c NkErr_Ok on success, \c NkErr_InvalidRange if the value is too long
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Cook_QueryPathOption(
+    _In_z_                          char const *keyStr,
+    _In_z_                          char const *defStr,
+    _O_bytes_(__NkInt_Cook_MaxPath) char *resBuf
+) {
+    NkVariant     optVar;
+    NkVariantType varTy = NkVarTy_None;
+    NkStringView  optVal;
+    if (NkEnvGetValue(keyStr, &optVar) == NkErr_Ok)
+        NkVariantGet(&optVar, &varTy, &optVal);
+    if (varTy != NkVarTy_StringView)
+        optVal = (NkStringView){ .mp_dataPtr = (char *)defStr, .m_sizeInBytes = strlen(defStr) };
+
+    if (optVal.m_sizeInBytes >= __NkInt_Cook_MaxPath)
+        return NkErr_InvalidRange;
+    memcpy(resBuf, optVal.mp_dataPtr, optVal.m_sizeInBytes);
+    resBuf[optVal.m_sizeInBytes] = '\0';
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  reads all options from the command-line
+ * \param  [out] optsPtr pointer to a structure that receives the options
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Cook_QueryOptions(_Out_ __NkInt_CookOptions *optsPtr) {
+    NkVariant optVar;
+
+    NkErrorCode errCode = __NkInt_Cook_QueryPathOption("db", "assets.db", optsPtr->m_dbPath);
+    if (errCode != NkErr_Ok || (errCode = __NkInt_Cook_QueryPathOption("out", "assets.pak", optsPtr->m_outPath)) != NkErr_Ok)
+        return errCode;
+
+    /* By default, asset paths are relative to the directory of the database. */
+    char const *sepPtr = strrchr(optsPtr->m_dbPath, '/');
+    char const *bsPtr  = strrchr(optsPtr->m_dbPath, '\\');
+    if (bsPtr != NULL && (sepPtr == NULL || bsPtr > sepPtr))
+        sepPtr = bsPtr;
+    if (NkEnvGetValue("root", &optVar) == NkErr_Ok || sepPtr == NULL)
+        errCode = __NkInt_Cook_QueryPathOption("root", ".", optsPtr->m_rootPath);
+    else {
+        memcpy(optsPtr->m_rootPath, optsPtr->m_dbPath, (NkSize)(sepPtr - optsPtr->m_dbPath));
+        optsPtr->m_rootPath[sepPtr - optsPtr->m_dbPath] = '\0';
+    }
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    /* Parse the key color, given as '#RRGGBB'. */
+    optsPtr->m_keyColor = 0x00FF00FF;
+    if (NkEnvGetValue("key", &optVar) == NkErr_Ok) {
+        NkVariantType varTy;
+        NkStringView  keyVal;
+        NkVariantGet(&optVar, &varTy, &keyVal);
+
+        char keyBuf[8] = { 0 };
+        if (varTy != NkVarTy_StringView || keyVal.m_sizeInBytes != 7 || *keyVal.mp_dataPtr != '#')
+            return NkErr_InParameter;
+        memcpy(keyBuf, keyVal.mp_dataPtr + 1, 6);
+
+        char *endPtr;
+        optsPtr->m_keyColor = (NkUint32)strtoul(keyBuf, &endPtr, 16);
+        if (*endPtr != '\0')
+            return NkErr_InParameter;
+    }
+
+    optsPtr->m_isPremul  = NkEnvGetValue("premultiply", &optVar) == NkErr_Ok;
+    optsPtr->m_isRebuild = NkEnvGetValue("rebuild", &optVar) == NkErr_Ok;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  reads an entire file into memory
+ * \param  [in] pathStr path of the file
+ * \param  [out] resPtr pointer to a variable that receives the contents of the file;
+ *               release the buffer with <tt>NkGPFree()</tt>
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The buffer of an empty file is \c NULL.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Cook_ReadFile(_In_z_ char const *pathStr, _Out_ NkBufferView *resPtr) {
+    *resPtr = (NkBufferView){ NULL, 0 };
+
+    FILE *fStream;
+    if (fopen_s(&fStream, pathStr, "rb") != 0)
+        return NkErr_OpenFile;
+
+    NkErrorCode errCode = NkErr_Ok;
+    _fseeki64(fStream, 0, SEEK_END);
+    NkInt64 const fileSize = _ftelli64(fStream);
+    _fseeki64(fStream, 0, SEEK_SET);
+    if (fileSize < 0) {
+        errCode = NkErr_ErrorDuringDiskIO;
+
+        goto lbl_ONFIN;
+    }
+    if (fileSize == 0)
+        goto lbl_ONFIN;
+
+    errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)fileSize, 0, NK_FALSE, (NkVoid **)&resPtr->mp_dataPtr);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONFIN;
+    if (fread_s(resPtr->mp_dataPtr, (NkSize)fileSize, 1, (NkSize)fileSize, fStream) != (NkSize)fileSize) {
+        NkGPFree(resPtr->mp_dataPtr);
+        resPtr->mp_dataPtr = NULL;
+
+        errCode = NkErr_ErrorDuringDiskIO;
+        goto lbl_ONFIN;
+    }
+    resPtr->m_sizeInBytes = (NkSize)fileSize;
+
+lbl_ONFIN:
+    fclose(fStream);
+
+    return errCode;
+}
+
+/**
+ * \brief  writes a buffer to a file, replacing the file if it exists
+ * \param  [in] pathStr path of the file
+ * \param  [in] bufPtr bytes to write
+ * \param  [in] nBytes number of bytes
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Cook_WriteFile(
+    _In_z_            char const *pathStr,
+    _I_bytes_(nBytes) NkVoid const *bufPtr,
+    _In_              NkSize nBytes
+) {
+    FILE *fStream;
+    if (fopen_s(&fStream, pathStr, "wb") != 0)
+        return NkErr_OpenFile;
+
+    NkSize const nWritten = fwrite(bufPtr, 1, nBytes, fStream);
+    return fclose(fStream) == 0 && nWritten == nBytes ? NkErr_Ok : NkErr_ErrorDuringDiskIO;
+}
+
+/**
+ * \brief collects the rows of the asset query
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode NK_CALL __NkInt_Cook_QueryAssetsIterFn(
+    _In_                 NkUint32 colCount,
+    _In_reads_(colCount) NkVariant const *colResArr,
+    _Inout_opt_          NkVoid *extraCxtPtr
+) {
+    NK_ASSERT(colCount == 3, NkErr_InParameter);
+    NK_ASSERT(colResArr != NULL, NkErr_InParameter);
+    NK_ASSERT(extraCxtPtr != NULL, NkErr_InOutParameter);
+
+    __NkInt_CookAssetList *listPtr = (__NkInt_CookAssetList *)extraCxtPtr;
+
+    NkVariantType uuidTy, typeTy, pathTy;
+    NkBufferView  uuidBuf;
+    NkInt64       typeVal;
+    NkStringView  pathStr;
+    NkVariantGet(&colResArr[0], &uuidTy, &uuidBuf);
+    NkVariantGet(&colResArr[1], &typeTy, &typeVal);
+    NkVariantGet(&colResArr[2], &pathTy, &pathStr);
+    if (uuidTy != NkVarTy_BufferView || uuidBuf.m_sizeInBytes != sizeof(NkUuid) || typeTy != NkVarTy_Int64) {
+        NK_LOG_WARNING("Skipping asset with malformed UUID or type.");
+
+        return NkErr_Ok;
+    }
+    /* Assets without a source file have nothing that could be cooked. */
+    if (pathTy != NkVarTy_StringView || pathStr.m_sizeInBytes == 0)
+        return NkErr_Ok;
+
+    /* Grow the list if necessary. */
+    NkErrorCode errCode;
+    if (listPtr->m_nAssets == listPtr->m_capacity) {
+        NkSize const newCap = NK_MAX(listPtr->m_capacity * 2, 64);
+
+        errCode = listPtr->mp_assetArr == NULL
+            ? NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *listPtr->mp_assetArr, 0, NK_FALSE, (NkVoid **)&listPtr->mp_assetArr)
+            : NkGPRealloc(NK_MAKE_ALLOCATION_CONTEXT(), newCap * sizeof *listPtr->mp_assetArr, (NkVoid **)&listPtr->mp_assetArr)
+        ;
+        if (errCode != NkErr_Ok)
+            return errCode;
+        listPtr->m_capacity = newCap;
+    }
+
+    /* Copy the row; the column values are only valid during this call. */
+    __NkInt_CookAsset *assetPtr = &listPtr->mp_assetArr[listPtr->m_nAssets];
+    errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), pathStr.m_sizeInBytes + 1, 0, NK_FALSE, (NkVoid **)&assetPtr->mp_pathStr);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    memcpy(&assetPtr->m_assetUuid, uuidBuf.mp_dataPtr, sizeof(NkUuid));
+    memcpy(assetPtr->mp_pathStr, pathStr.mp_dataPtr, pathStr.m_sizeInBytes);
+    assetPtr->mp_pathStr[pathStr.m_sizeInBytes] = '\0';
+    assetPtr->m_assetType = (NkAssetType)typeVal;
+
+    ++listPtr->m_nAssets;
+    return NkErr_Ok;
+}
+
+/**
+ * \brief  reads the manifest of the previous run
+ * \param  [in] pathStr path of the manifest
+ * \param  [out] entArr pointer to a variable that receives the entries, sorted by UUID;
+ *               release the array with <tt>NkGPFree()</tt>
+ * \param  [out] nEntries pointer to a variable that receives the number of entries
+ * \note   If the manifest does not exist or is not valid, no entries are returned and
+ *         all assets are cooked again.
+ */
+NK_INTERNAL NkVoid __NkInt_Cook_LoadManifest(
+    _In_z_   char const *pathStr,
+    _Outptr_ __NkInt_CookManifestEntry **entArr,
+    _Out_    NkSize *nEntries
+) {
+    *entArr   = NULL;
+    *nEntries = 0;
+
+    NkBufferView fileBuf;
+    if (__NkInt_Cook_ReadFile(pathStr, &fileBuf) != NkErr_Ok || fileBuf.mp_dataPtr == NULL)
+        return;
+
+    __NkInt_CookManifestHeader const *headPtr = (__NkInt_CookManifestHeader const *)fileBuf.mp_dataPtr;
+    if (fileBuf.m_sizeInBytes < sizeof *headPtr
+        || headPtr->m_magicNum != __NkInt_Cook_ManifestMagic
+        || headPtr->m_formatVer != __NkInt_Cook_FormatVersion
+        || headPtr->m_nEntries > (fileBuf.m_sizeInBytes - sizeof *headPtr) / sizeof **entArr
+    ) {
+        NK_LOG_WARNING("Manifest \"%s\" is not valid; cooking all assets.", pathStr);
+
+        NkGPFree(fileBuf.mp_dataPtr);
+        return;
+    }
+
+    /* Move the entries to the start of the buffer so that it can be used as the array. */
+    NkSize const nEnts = (NkSize)headPtr->m_nEntries;
+    memmove(fileBuf.mp_dataPtr, fileBuf.mp_dataPtr + sizeof *headPtr, nEnts * sizeof **entArr);
+
+    *entArr   = (__NkInt_CookManifestEntry *)fileBuf.mp_dataPtr;
+    *nEntries = nEnts;
+}
+
+/**
+ * \brief  writes the manifest of the current run
+ * \param  [in] pathStr path of the manifest
+ * \param  [in, out] entArr entries; they are sorted in place
+ * \param  [in] nEntries number of elements in \c entArr
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Cook_SaveManifest(
+    _In_z_  char const *pathStr,
+    _Inout_ __NkInt_CookManifestEntry *entArr,
+    _In_    NkSize nEntries
+) {
+    NkSize const entBytes = nEntries * sizeof *entArr;
+    NkByte      *fileBuf;
+    NkErrorCode  errCode  = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), sizeof(__NkInt_CookManifestHeader) + entBytes, 0, NK_FALSE, (NkVoid **)&fileBuf);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    if (nEntries > 0)
+        qsort(entArr, nEntries, sizeof *entArr, &__NkInt_Cook_CompareEntries);
+    *(__NkInt_CookManifestHeader *)fileBuf = (__NkInt_CookManifestHeader){
+        .m_magicNum  = __NkInt_Cook_ManifestMagic,
+        .m_formatVer = __NkInt_Cook_FormatVersion,
+        .m_nEntries  = (NkUint64)nEntries
+    };
+    if (entBytes > 0)
+        memcpy(fileBuf + sizeof(__NkInt_CookManifestHeader), entArr, entBytes);
+
+    errCode = __NkInt_Cook_WriteFile(pathStr, fileBuf, sizeof(__NkInt_CookManifestHeader) + entBytes);
+    NkGPFree(fileBuf);
+    return errCode;
+}
+
+/**
+ * \brief  converts a bitmap file into a cooked texture blob
+ * \param  [in] fileBuf contents of the bitmap file
+ * \param  [in] optsPtr cooking options
+ * \param  [out] resPtr pointer to a variable that receives the blob; release the buffer
+ *               with <tt>NkGPFree()</tt>
+ * \return \c NkErr_Ok on success, non-zero on failure
+ * \note   The layout of the blob is described by <tt>NkPackTextureHeader</tt>.
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Cook_CookTexture(
+    _In_  NkBufferView fileBuf,
+    _In_  __NkInt_CookOptions const *optsPtr,
+    _Out_ NkBufferView *resPtr
+) {
+    NkDIBitmap  bmpObj;
+    NkErrorCode errCode = NkDIBitmapLoadFromMemory(fileBuf, &bmpObj);
+    if (errCode != NkErr_Ok)
+        return errCode;
+
+    NkBitmapSpecification const *bmSpecs = NkDIBitmapGetSpecification(&bmpObj);
+    if (bmSpecs->m_bitsPerPx != 24 && bmSpecs->m_bitsPerPx != 32) {
+        errCode = NkErr_InvBitDepth;
+
+        goto lbl_ONFIN;
+    }
+    NkUint32 const  width   = (NkUint32)bmSpecs->m_bmpWidth;
+    NkUint32 const  height  = (NkUint32)(bmSpecs->m_bmpHeight < 0 ? -bmSpecs->m_bmpHeight : bmSpecs->m_bmpHeight);
+    NkUint32 const  pxWidth = bmSpecs->m_bitsPerPx >> 3;
+    NkBoolean const isBtmUp = bmSpecs->m_bmpHeight > 0;
+
+    /* Both arrays start at a multiple of the pack alignment. */
+    NkUint64 const alignMask = NK_PACK_ALIGNMENT - 1;
+    NkUint64 const pxOffset  = (sizeof(NkPackTextureHeader) + alignMask) & ~alignMask;
+    NkUint64 const maskOff   = (pxOffset + (NkUint64)width * height * 4 + alignMask) & ~alignMask;
+    NkUint64 const blobSize  = maskOff + (NkUint64)width * height;
+
+    NkByte *blobPtr;
+    errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)blobSize, 0, NK_TRUE, (NkVoid **)&blobPtr);
+    if (errCode != NkErr_Ok)
+        goto lbl_ONFIN;
+
+    /*
+     * Convert the pixels to top-down 32-bit BGRA and build the mask. The alpha channel is
+     * taken from the mask so that key-colored pixels are transparent without a separate
+     * mask pass at run-time.
+     */
+    NkBoolean     isMasked = NK_FALSE;
+    NkByte const *dibPx    = NkDIBitmapGetPixels(&bmpObj, NULL);
+    for (NkUint32 y = 0; y < height; y++) {
+        NkByte const *srcRow  = dibPx + (NkSize)(isBtmUp ? height - 1 - y : y) * bmSpecs->m_bmpStride;
+        NkByte       *dstRow  = blobPtr + pxOffset + (NkSize)y * width * 4;
+        NkByte       *maskRow = blobPtr + maskOff + (NkSize)y * width;
+
+        if (pxWidth == 3)
+            NkPixelConvert24To32(dstRow, srcRow, width, 0xFF);
+        else
+            NkPixelSetAlpha32(dstRow, srcRow, width, 0xFF);
+        NkPixelColorKeyMask32(maskRow, dstRow, width, optsPtr->m_keyColor);
+
+        for (NkUint32 x = 0; x < width; x++) {
+            dstRow[x * 4 + 3] = maskRow[x];
+
+            isMasked |= maskRow[x] == 0x00;
+        }
+        if (optsPtr->m_isPremul)
+            NkPixelPremultiply32(dstRow, dstRow, width);
+    }
+
+    /* Opaque textures do not need the mask. */
+    *(NkPackTextureHeader *)blobPtr = (NkPackTextureHeader){
+        .m_magicNum   = NK_PACK_TEXMAGIC,
+        .m_texFlags   = (isMasked ? NkPackTex_Masked : NkPackTex_None) | (optsPtr->m_isPremul ? NkPackTex_Premultiplied : NkPackTex_None),
+        .m_texWidth   = width,
+        .m_texHeight  = height,
+        .m_texStride  = width * 4,
+        .m_keyColor   = optsPtr->m_keyColor,
+        .m_pxOffset   = pxOffset,
+        .m_maskOffset = isMasked ? maskOff : 0
+    };
+    *resPtr = (NkBufferView){ blobPtr, (NkSize)(isMasked ? blobSize : maskOff) };
+
+lbl_ONFIN:
+    NkDIBitmapDestroy(&bmpObj);
+
+    return errCode;
+}
+
+/**
+ * \brief  cooks all assets and writes the archive and the manifest
+ * \param  [in] optsPtr cooking options
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Cook_Run(_In_ __NkInt_CookOptions const *optsPtr) {
+    char manPath[__NkInt_Cook_MaxPath];
+    char tmpPath[__NkInt_Cook_MaxPath];
+    char srcPath[__NkInt_Cook_MaxPath];
+    if (snprintf(manPath, sizeof manPath, "%s.manifest", optsPtr->m_outPath) >= (int)sizeof manPath
+        || snprintf(tmpPath, sizeof tmpPath, "%s.tmp", optsPtr->m_outPath) >= (int)sizeof tmpPath
+    ) return NkErr_InvalidRange;
+
+    __NkInt_CookAssetList      assetList = { NULL, 0, 0 };
+    __NkInt_CookManifestEntry *oldEnts   = NULL, *newEnts = NULL;
+    NkSize                     nOldEnts  = 0, nCooked = 0, nReused = 0;
+    NkPackArchive             *oldArch   = NULL;
+    NkPackWriter              *packWr    = NULL;
+    NkIDatabase               *dbConn    = NULL;
+
+    /* Collect the assets. */
+    NkErrorCode errCode = NkOMCreateInstance(NKOM_CLSIDOF(NkIDatabase), NULL, NKOM_IIDOF(NkIDatabase), NULL, (NkIBase **)&dbConn);
+    if (errCode != NkErr_Ok)
+        return errCode;
+    errCode = dbConn->VT->Open(dbConn, optsPtr->m_dbPath, NkDbMode_ReadOnly, NULL);
+    if (errCode == NkErr_Ok) {
+        errCode = dbConn->VT->ExecuteInline(dbConn, "SELECT uuid, type, path FROM assets;", &__NkInt_Cook_QueryAssetsIterFn, &assetList);
+
+        NK_IGNORE_RETURN_VALUE(dbConn->VT->Close(dbConn));
+    }
+    dbConn->VT->Release(dbConn);
+    if (errCode != NkErr_Ok) {
+        NK_LOG_ERROR("Could not read assets from database \"%s\".", optsPtr->m_dbPath);
+
+        goto lbl_ONFIN;
+    }
+    if (assetList.m_nAssets > 0) {
+        errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), assetList.m_nAssets * sizeof *newEnts, 0, NK_FALSE, (NkVoid **)&newEnts);
+        if (errCode != NkErr_Ok)
+            goto lbl_ONFIN;
+    }
+
+    /*
+     * Blobs can only be reused if both the manifest and the archive of the previous run
+     * are present.
+     */
+    if (!optsPtr->m_isRebuild) {
+        __NkInt_Cook_LoadManifest(manPath, &oldEnts, &nOldEnts);
+
+        if (nOldEnts > 0 && NkPackArchiveOpen(optsPtr->m_outPath, &oldArch) != NkErr_Ok)
+            nOldEnts = 0;
+    }
+    if ((errCode = NkPackWriterCreate(&packWr)) != NkErr_Ok)
+        goto lbl_ONFIN;
+
+    for (NkSize i = 0; i < assetList.m_nAssets; i++) {
+        __NkInt_CookAsset const *assetPtr = &assetList.mp_assetArr[i];
+        NkBoolean const          isTex    = assetPtr->m_assetType == NkAsTy_TextureAtlas;
+
+        if (snprintf(srcPath, sizeof srcPath, "%s/%s", optsPtr->m_rootPath, assetPtr->mp_pathStr) >= (int)sizeof srcPath) {
+            errCode = NkErr_InvalidRange;
+
+            goto lbl_ONFIN;
+        }
+        NkBufferView srcBuf;
+        if ((errCode = __NkInt_Cook_ReadFile(srcPath, &srcBuf)) != NkErr_Ok) {
+            NK_LOG_ERROR("Could not read source file \"%s\".", srcPath);
+
+            goto lbl_ONFIN;
+        }
+
+        /*
+         * The hash covers everything the blob depends on: the source file, and for
+         * textures, the options that affect the cooked pixels.
+         */
+        NkUint32 const optsArr[] = {
+            __NkInt_Cook_FormatVersion,
+            (NkUint32)assetPtr->m_assetType,
+            isTex ? optsPtr->m_keyColor : 0,
+            isTex ? (NkUint32)optsPtr->m_isPremul : 0
+        };
+        NkUint64 srcHash = __NkInt_Cook_HashBytes(srcBuf.mp_dataPtr, srcBuf.m_sizeInBytes, UINT64_C(0xcbf29ce484222325));
+        srcHash = __NkInt_Cook_HashBytes(optsArr, sizeof optsArr, srcHash);
+        newEnts[i] = (__NkInt_CookManifestEntry){ .m_assetUuid = assetPtr->m_assetUuid, .m_srcHash = srcHash };
+
+        /* If the asset did not change since the last run, copy the previous blob. */
+        __NkInt_CookManifestEntry const *oldEnt = nOldEnts > 0
+            ? bsearch(&assetPtr->m_assetUuid, oldEnts, nOldEnts, sizeof *oldEnts, &__NkInt_Cook_CompareEntries)
+            : NULL
+        ;
+        NkPackEntry const *archEnt = oldEnt != NULL && oldEnt->m_srcHash == srcHash
+            ? NkPackArchiveFindEntry(oldArch, &assetPtr->m_assetUuid)
+            : NULL
+        ;
+        if (archEnt != NULL) {
+            NkGPFree(srcBuf.mp_dataPtr);
+
+            NkBoolean const isCompr = (archEnt->m_entryFlags & NkPackEnt_Compressed) != 0;
+            if (!isCompr) {
+                errCode = NkPackWriterAddBlob(packWr, &assetPtr->m_assetUuid, NkPackArchiveMapBlob(oldArch, archEnt), NK_FALSE);
+            } else if ((errCode = NkGPAlloc(NK_MAKE_ALLOCATION_CONTEXT(), (NkSize)archEnt->m_rawSize, 0, NK_FALSE, (NkVoid **)&srcBuf.mp_dataPtr)) == NkErr_Ok) {
+                srcBuf.m_sizeInBytes = (NkSize)archEnt->m_rawSize;
+
+                if ((errCode = NkPackArchiveReadBlob(oldArch, archEnt, srcBuf.mp_dataPtr)) == NkErr_Ok)
+                    errCode = NkPackWriterAddBlob(packWr, &assetPtr->m_assetUuid, srcBuf, NK_TRUE);
+                NkGPFree(srcBuf.mp_dataPtr);
+            }
+            if (errCode != NkErr_Ok)
+                goto lbl_ONFIN;
+
+            ++nReused;
+            continue;
+        }
+
+        /*
+         * Cook the asset. Textures are stored uncompressed so that they can be uploaded
+         * straight from the memory-mapped archive.
+         */
+        if (isTex) {
+            NkBufferView texBuf;
+
+            errCode = __NkInt_Cook_CookTexture(srcBuf, optsPtr, &texBuf);
+            NkGPFree(srcBuf.mp_dataPtr);
+            if (errCode != NkErr_Ok) {
+                NK_LOG_ERROR("Could not cook texture \"%s\".", srcPath);
+
+                goto lbl_ONFIN;
+            }
+
+            errCode = NkPackWriterAddBlob(packWr, &assetPtr->m_assetUuid, texBuf, NK_FALSE);
+            NkGPFree(texBuf.mp_dataPtr);
+        } else {
+            errCode = NkPackWriterAddBlob(packWr, &assetPtr->m_assetUuid, srcBuf, NK_TRUE);
+
+            NkGPFree(srcBuf.mp_dataPtr);
+        }
+        if (errCode != NkErr_Ok)
+            goto lbl_ONFIN;
+
+        ++nCooked;
+    }
+
+    /*
+     * The previous archive is still mapped, so write the new one next to it and replace
+     * the old one once it has been closed.
+     */
+    if ((errCode = NkPackWriterSave(packWr, tmpPath)) != NkErr_Ok) {
+        NK_LOG_ERROR("Could not write archive \"%s\".", tmpPath);
+
+        goto lbl_ONFIN;
+    }
+    NkPackArchiveClose(&oldArch);
+    remove(optsPtr->m_outPath);
+    if (rename(tmpPath, optsPtr->m_outPath) != 0) {
+        NK_LOG_ERROR("Could not replace archive \"%s\".", optsPtr->m_outPath);
+
+        errCode = NkErr_ErrorDuringDiskIO;
+        goto lbl_ONFIN;
+    }
+
+    /* Only write the manifest once the archive it describes is in place. */
+    if ((errCode = __NkInt_Cook_SaveManifest(manPath, newEnts, assetList.m_nAssets)) != NkErr_Ok)
+        NK_LOG_ERROR("Could not write manifest \"%s\".", manPath);
+    else
+        NK_LOG_INFO(
+            "Cooked %zu asset(s), reused %zu unchanged asset(s); wrote \"%s\".",
+            nCooked,
+            nReused,
+            optsPtr->m_outPath
+        );
+
+lbl_ONFIN:
+    NkPackWriterDestroy(&packWr);
+    NkPackArchiveClose(&oldArch);
+    NkGPFree(oldEnts);
+    NkGPFree(newEnts);
+    for (NkSize i = 0; i < assetList.m_nAssets; i++)
+        NkGPFree(assetList.mp_assetArr[i].mp_pathStr);
+    NkGPFree(assetList.mp_assetArr);
+
+    return errCode;
+}
+/** \endcond */
+
+
+int main(int argc, char **argv, char **envp) {
+    /* Enable Visual Studio memory leak detector. */
+#if (defined _DEBUG)
+    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+    /*
+     * Run the engine in attached mode so that the asset manager does not open (or create)
+     * an asset database of its own. The cooker opens the database itself.
+     */
+    char **argArr = (char **)calloc((size_t)argc + 2, sizeof *argArr);
+    if (argArr == NULL)
+        return NkErr_MemoryAllocation;
+    for (int i = 0; i < argc; i++)
+        argArr[i] = argv[i];
+    argArr[argc] = "-attached";
+
+    /* Startup the engine component; the window stays hidden. */
+    NkErrorCode errCode = NkApplicationStartup(&(NkApplicationSpecification const){
+        .m_structSize      = sizeof(NkApplicationSpecification),
+        .m_enableDbgTools  = NK_FALSE,
+        .m_rendererApi     = NkRdApi_Win32GDI,
+        .m_isVSync         = NK_FALSE,
+        .m_fixedTickRate   = 0,
+        .m_targetFps       = 0,
+        .m_isOnDemand      = NK_FALSE,
+        .m_vpAlignment     = NkVpAlign_HCenter | NkVpAlign_VCenter,
+        .m_vpExtents       = { 16, 16 },
+        .m_dispTileSize    = { 32, 32 },
+        .m_allowedWndModes = NkWndMode_All,
+        .m_initialWndMode  = NkWndMode_Hidden,
+        .m_wndFlags        = 0,
+        .mp_nativeHandle   = NULL,
+        .m_wndTitle        = NK_MAKE_STRING_VIEW("Noriko Asset Cooker"),
+        .m_argc            = argc + 1,
+        .mp_argv           = argArr,
+        .mp_envp           = envp,
+        .m_gameRootDir     = NK_MAKE_STRING_VIEW(NULL)
+    });
+    if (errCode != NkErr_Ok)
+        goto lbl_END;
+
+    /* Cook the assets. */
+    __NkInt_CookOptions cookOpts;
+    if ((errCode = __NkInt_Cook_QueryOptions(&cookOpts)) != NkErr_Ok) {
+        NK_LOG_ERROR("Invalid command-line options; see the documentation of NorikoCook for usage.");
+
+        goto lbl_END;
+    }
+    errCode = __NkInt_Cook_Run(&cookOpts);
+
+lbl_END:
+    NK_IGNORE_RETURN_VALUE(NkApplicationShutdown());
+
+    free(argArr);
+    return errCode;
+}
+
+
+#undef NK_NAMESPACE
+
+
@@ -23,6 +23,8 @@
 
 /* stdlib includes */
 #include <algorithm>
+#include <iterator>
+#include <cstring>
 
 /* Qt includes */
 #include <QMessageBox>
@@ -31,6 +33,11 @@
 #include <QMetaMethod>
 #include <QtSystemDetection>
 #include <QProcess>
+#include <QSet>
+#include <QRegularExpression>
+#include <QHash>
+#include <QFileInfo>
+#include <QDir>
 
 /* NorikoEd includes */
 #include <include/NorikoEd/explorer.hpp>
@@ -39,7 +46,7 @@
 /* implementation of explorer item */
 namespace NkE {
     ExplorerItem::ExplorerItem(ExplorerItem::Type typeId, ExplorerItem *parPtr)
-        : mp_parentItem(parPtr), m_itemType(typeId)
+        : mp_parentItem(parPtr), m_itemType(typeId), m_rowIndex(0), m_isResolved(true), m_nextStaged(0)
     { }
 
 
@@ -54,6 +61,7 @@ namespace NkE {
         switch (m_itemType) {
             case ExplorerItem::Type::Session:
             case ExplorerItem::Type::Filter:
+            case ExplorerItem::Type::Asset:
                 return m_internalVal;
         }
 
@@ -65,16 +73,8 @@ namespace NkE {
     }
 
     NkInt32 ExplorerItem::getItemRow() const {
-        if (mp_parentItem == nullptr)
-            return 0;
-
-        auto const itemIter = std::find_if(mp_parentItem->m_childItems.cbegin(), mp_parentItem->m_childItems.cend(),
-            [&](std::unique_ptr<ExplorerItem> const &itemRef) {
-                return this == itemRef.get();
-            }
-        );
-
-        return static_cast<NkInt32>(std::distance(mp_parentItem->m_childItems.cbegin(), itemIter));
+        /* The row is kept up-to-date by the parent whenever its child list changes. */
+        return m_rowIndex;
     }
 
     ExplorerItem *ExplorerItem::getChildAt(int rowPos) const {
@@ -88,6 +88,22 @@ namespace NkE {
         return mp_parentItem;
     }
 
+    QString const &ExplorerItem::getSourcePath() const {
+        return m_srcPath;
+    }
+
+    QByteArray const &ExplorerItem::getAssetId() const {
+        return m_assetId;
+    }
+
+    bool ExplorerItem::isResolved() const {
+        return m_isResolved;
+    }
+
+    NkSize ExplorerItem::getStagedCount() const {
+        return (NkSize)m_stagedItems.size() - m_nextStaged;
+    }
+
 
     void ExplorerItem::setItemType(ExplorerItem::Type newType) {
         /* Only allow mutating the item type when the current type is the generic type. */
@@ -104,6 +120,7 @@ namespace NkE {
         switch (m_itemType) {
             case ExplorerItem::Type::Session:
             case ExplorerItem::Type::Filter:
+            case ExplorerItem::Type::Asset:
                 m_internalVal = newVal;
 
                 break;
@@ -116,21 +133,164 @@ namespace NkE {
         return true;
     }
 
+    void ExplorerItem::setSourcePath(QString const &srcPath) {
+        m_srcPath    = srcPath;
+        m_isResolved = m_itemType != ExplorerItem::Type::Filter;
+    }
+
+    void ExplorerItem::setResolved(ExplorerItemVector &&stagedItems) {
+        m_stagedItems = std::move(stagedItems);
+        m_nextStaged  = 0;
+        m_isResolved  = true;
+    }
+
+    void ExplorerItem::setAssetId(QByteArray const &assetId) {
+        m_assetId = assetId;
+    }
+
 
     void ExplorerItem::insertChildItem(NkInt32 where2Insert, std::unique_ptr<ExplorerItem> &&childItem) {
+        childItem->mp_parentItem = this;
         m_childItems.insert(m_childItems.cbegin() + where2Insert, std::move(childItem));
+
+        /* Only the rows after the insertion point shift; appending renumbers nothing. */
+        for (NkSize i = (NkSize)where2Insert; i < m_childItems.size(); i++)
+            m_childItems[i]->m_rowIndex = static_cast<NkInt32>(i);
     }
 
     void ExplorerItem::removeChildItem(NkInt32 where2Remove) {
         m_childItems.erase(m_childItems.cbegin() + where2Remove);
+
+        for (NkSize i = (NkSize)where2Remove; i < m_childItems.size(); i++)
+            m_childItems[i]->m_rowIndex = static_cast<NkInt32>(i);
+    }
+
+    void ExplorerItem::appendStagedItems(NkSize numOfItems) {
+        m_childItems.reserve(m_childItems.size() + numOfItems);
+
+        for (NkSize i = 0; i < numOfItems; i++) {
+            std::unique_ptr<ExplorerItem> &currItem = m_stagedItems[m_nextStaged++];
+
+            currItem->mp_parentItem = this;
+            currItem->m_rowIndex    = static_cast<NkInt32>(m_childItems.size());
+            m_childItems.push_back(std::move(currItem));
+        }
+
+        /* Release the staging area once everything has been handed over. */
+        if (m_nextStaged == m_stagedItems.size()) {
+            m_stagedItems.clear();
+            m_stagedItems.shrink_to_fit();
+
+            m_nextStaged = 0;
+        }
+    }
+
+    ExplorerItem *ExplorerItem::findChildFilter(QString const &srcPath) const {
+        /*
+         * Queried filters precede the assets and are ordered by path. Filters that were
+         * added by hand break that order, so fall back to a linear search on a miss.
+         */
+        auto const filtersEnd = std::partition_point(m_childItems.cbegin(), m_childItems.cend(),
+            [](std::unique_ptr<ExplorerItem> const &itemRef) {
+                return itemRef->m_itemType == ExplorerItem::Type::Filter;
+            }
+        );
+        auto const itemIter = std::lower_bound(m_childItems.cbegin(), filtersEnd, srcPath,
+            [](std::unique_ptr<ExplorerItem> const &itemRef, QString const &pathRef) {
+                return itemRef->m_srcPath < pathRef;
+            }
+        );
+        if (itemIter != filtersEnd && (*itemIter)->m_srcPath == srcPath)
+            return itemIter->get();
+
+        for (std::unique_ptr<ExplorerItem> const &itemRef : m_childItems)
+            if (itemRef->m_itemType == ExplorerItem::Type::Filter && itemRef->m_srcPath == srcPath)
+                return itemRef.get();
+        return nullptr;
     }
 } /* namespace NkE */
 
 
+/* implementation of the asset database query used by lazy explorer items */
+namespace NkE::priv {
+    /**
+     * \struct ExplorerQueryContext
+     * \brief  collects the direct children of a lazy item while its query is executed
+     */
+    struct ExplorerQueryContext {
+        NkSize                           m_prefixLen;   /**< length of the parent's path, in bytes */
+        QByteArray                       m_lastFilter;  /**< name of the filter created last */
+        ExplorerItem::ExplorerItemVector m_filterItems; /**< sub-directories of the parent */
+        ExplorerItem::ExplorerItemVector m_assetItems;  /**< assets directly below the parent */
+    };
+
+    /**
+     * \brief  is invoked for every asset below the path of a lazy item
+     * \param  [in] colCount number of columns (name, path, uuid)
+     * \param  [in] colResArr column values of the current row
+     * \param  [in,out] extraCxtPtr pointer to the \c ExplorerQueryContext instance
+     * \return \c NkErr_Ok
+     * \note   Rows are ordered by path, so all assets of a sub-directory are adjacent and
+     *         the sub-directory only needs to be compared against the previous one.
+     */
+    static NkErrorCode NK_CALL ExplorerQueryChildrenIterFn(
+        _In_                 NkUint32 colCount,
+        _In_reads_(colCount) NkVariant const *colResArr,
+        _Inout_opt_          NkVoid *extraCxtPtr
+    ) {
+        auto *cxtPtr = static_cast<ExplorerQueryContext *>(extraCxtPtr);
+        if (colCount < 2)
+            return NkErr_Ok;
+
+        NkVariantType nameTy, pathTy;
+        NkStringView  nameStr, pathStr;
+        NkVariantGet(&colResArr[0], &nameTy, (NkVoid *)&nameStr);
+        NkVariantGet(&colResArr[1], &pathTy, (NkVoid *)&pathStr);
+        if (nameTy != NkVarTy_StringView || pathTy != NkVarTy_StringView || pathStr.m_sizeInBytes < cxtPtr->m_prefixLen)
+            return NkErr_Ok;
+
+        /* Everything up to the next separator names a sub-directory. */
+        char const *relPath = pathStr.mp_dataPtr + cxtPtr->m_prefixLen;
+        NkSize const relLen = pathStr.m_sizeInBytes - cxtPtr->m_prefixLen;
+        char const *sepPtr  = static_cast<char const *>(memchr(relPath, '/', relLen));
+        if (sepPtr != nullptr) {
+            QByteArray const filterName(relPath, static_cast<qsizetype>(sepPtr - relPath));
+            if (filterName == cxtPtr->m_lastFilter)
+                return NkErr_Ok;
+
+            auto filterItem = std::make_unique<ExplorerItem>(ExplorerItem::Type::Filter);
+            filterItem->setItemData(0, QString::fromUtf8(filterName));
+            filterItem->setSourcePath(
+                QString::fromUtf8(pathStr.mp_dataPtr, static_cast<qsizetype>(sepPtr - pathStr.mp_dataPtr + 1))
+            );
+
+            cxtPtr->m_lastFilter = filterName;
+            cxtPtr->m_filterItems.push_back(std::move(filterItem));
+            return NkErr_Ok;
+        }
+
+        auto assetItem = std::make_unique<ExplorerItem>(ExplorerItem::Type::Asset);
+        assetItem->setItemData(0, QString::fromUtf8(nameStr.mp_dataPtr, static_cast<qsizetype>(nameStr.m_sizeInBytes)));
+        assetItem->setSourcePath(QString::fromUtf8(pathStr.mp_dataPtr, static_cast<qsizetype>(pathStr.m_sizeInBytes)));
+
+        if (colCount > 2) {
+            NkVariantType uuidTy;
+            NkBufferView  uuidBuf;
+            NkVariantGet(&colResArr[2], &uuidTy, (NkVoid *)&uuidBuf);
+            if (uuidTy == NkVarTy_BufferView)
+                assetItem->setAssetId(QByteArray(reinterpret_cast<char const *>(uuidBuf.mp_dataPtr), static_cast<qsizetype>(uuidBuf.m_sizeInBytes)));
+        }
+
+        cxtPtr->m_assetItems.push_back(std::move(assetItem));
+        return NkErr_Ok;
+    }
+}
+
+
 /* implementation of the explorer model */
 namespace NkE {
     ExplorerModel::ExplorerModel(QObject *parPtr)
-        : QAbstractItemModel(parPtr)
+        : QAbstractItemModel(parPtr), mp_assetDb(nullptr), mp_childrenStmt(nullptr), mp_thumbService(nullptr)
     {
         /* Create root item. */
         m_rootItem = std::make_unique<ExplorerItem>(ExplorerItem::Type::Generic, nullptr);
@@ -157,6 +317,120 @@ namespace NkE {
         m_rootItem->insertChildItem(0, std::move(a1));
     }
 
+    ExplorerModel::~ExplorerModel() {
+        if (mp_childrenStmt != nullptr)
+            mp_childrenStmt->VT->Release(mp_childrenStmt);
+        if (mp_assetDb != nullptr)
+            mp_assetDb->VT->Release(mp_assetDb);
+    }
+
+
+    void ExplorerModel::int_resolveItem(ExplorerItem *itemPtr) {
+        priv::ExplorerQueryContext queryCxt{};
+        QByteArray const srcPath = itemPtr->getSourcePath().toUtf8();
+        queryCxt.m_prefixLen = static_cast<NkSize>(srcPath.size());
+
+        if (mp_childrenStmt != nullptr) {
+            NkStringView const paramStr = { const_cast<char *>(srcPath.constData()), static_cast<NkSize>(srcPath.size()) };
+            NkVariant          paramVar;
+            NkVariantSet(&paramVar, NkVarTy_StringView, &paramStr);
+            mp_childrenStmt->VT->Bind(mp_childrenStmt, 1U, &paramVar);
+
+            NkErrorCode const errCode = mp_assetDb->VT->Execute(
+                mp_assetDb,
+                mp_childrenStmt,
+                &priv::ExplorerQueryChildrenIterFn,
+                static_cast<NkVoid *>(&queryCxt)
+            );
+            mp_childrenStmt->VT->Unbind(mp_childrenStmt, 1U);
+            if (errCode != NkErr_Ok)
+                NK_LOG_ERROR("Could not query the assets below \"%s\" (%i).", srcPath.constData(), errCode);
+        }
+
+        /* Show sub-directories first, like in the file explorer. */
+        queryCxt.m_filterItems.reserve(queryCxt.m_filterItems.size() + queryCxt.m_assetItems.size());
+        std::move(queryCxt.m_assetItems.begin(), queryCxt.m_assetItems.end(), std::back_inserter(queryCxt.m_filterItems));
+
+        itemPtr->setResolved(std::move(queryCxt.m_filterItems));
+    }
+
+
+    void ExplorerModel::setAssetDatabase(NkIDatabase *dbPtr, QString const &rootName) {
+        beginResetModel();
+
+        /* Drop the previous database and the items created from it. */
+        if (mp_childrenStmt != nullptr)
+            mp_childrenStmt->VT->Release(mp_childrenStmt);
+        if (mp_assetDb != nullptr)
+            mp_assetDb->VT->Release(mp_assetDb);
+        mp_childrenStmt = nullptr;
+        mp_assetDb      = dbPtr;
+        m_rootItem      = std::make_unique<ExplorerItem>(ExplorerItem::Type::Generic, nullptr);
+        m_thumbItems.clear();
+
+        if (mp_assetDb != nullptr) {
+            mp_assetDb->VT->AddRef(mp_assetDb);
+
+            /*
+             * A prefix of length zero matches every path, so the same statement serves
+             * the root of the database.
+             */
+            NkErrorCode const errCode = mp_assetDb->VT->CreateStatement(
+                mp_assetDb,
+                "SELECT name, path, uuid FROM assets WHERE substr(path, 1, length(?1)) = ?1 ORDER BY path",
+                &mp_childrenStmt
+            );
+            if (errCode != NkErr_Ok) {
+                NK_LOG_ERROR("Could not prepare the asset explorer query (%i).", errCode);
+
+                mp_childrenStmt = nullptr;
+            }
+
+            /* Only the top-level filter is created; everything else is fetched on expand. */
+            auto rootFilter = std::make_unique<ExplorerItem>(ExplorerItem::Type::Filter);
+            rootFilter->setItemData(0, rootName);
+            rootFilter->setSourcePath(QString{});
+            m_rootItem->insertChildItem(0, std::move(rootFilter));
+        }
+
+        endResetModel();
+    }
+
+    void ExplorerModel::setThumbnailService(ThumbnailService *servPtr) {
+        if (mp_thumbService != nullptr)
+            disconnect(mp_thumbService, nullptr, this, nullptr);
+        mp_thumbService = servPtr;
+        m_thumbItems.clear();
+
+        if (mp_thumbService != nullptr)
+            connect(mp_thumbService, &ThumbnailService::thumbnailReady, this, [this](QByteArray const &assetId) {
+                /* Items that were dropped in the meantime are not in the map anymore. */
+                ExplorerItem *itemPtr = m_thumbItems.take(assetId);
+                if (itemPtr == nullptr)
+                    return;
+
+                QModelIndex const itemIndex = createIndex(itemPtr->getItemRow(), 0, itemPtr);
+                emit dataChanged(itemIndex, itemIndex, { Qt::DecorationRole });
+            });
+    }
+
+    void ExplorerModel::revealPath(QString const &assetPath) {
+        /* The top-level filter of the asset database has an empty source path. */
+        ExplorerItem *currItem = m_rootItem->findChildFilter(QString{});
+
+        for (qsizetype sepPos = 0; currItem != nullptr; ) {
+            QModelIndex const currIndex = createIndex(currItem->getItemRow(), 0, currItem);
+            while (canFetchMore(currIndex))
+                fetchMore(currIndex);
+
+            /* Descend into the filter of the next directory on the path. */
+            if ((sepPos = assetPath.indexOf(QChar('/'), sepPos)) < 0)
+                break;
+
+            currItem = currItem->findChildFilter(assetPath.left(++sepPos));
+        }
+    }
+
 
     ExplorerItem *ExplorerModel::getItemPointer(QModelIndex const &modelIndex) const {
         if (modelIndex.isValid())
@@ -224,6 +498,48 @@ namespace NkE {
         return 1;
     }
 
+    bool ExplorerModel::hasChildren(const QModelIndex &parIndex) const {
+        if (parIndex.isValid() && parIndex.column() > 0)
+            return false;
+
+        ExplorerItem *itemPtr = getItemPointer(parIndex);
+        if (itemPtr == nullptr)
+            return false;
+
+        return !itemPtr->isResolved() || itemPtr->getChildCount() > 0 || itemPtr->getStagedCount() > 0;
+    }
+
+    bool ExplorerModel::canFetchMore(const QModelIndex &parIndex) const {
+        if (parIndex.isValid() && parIndex.column() > 0)
+            return false;
+
+        ExplorerItem *itemPtr = getItemPointer(parIndex);
+
+        return itemPtr != nullptr && (!itemPtr->isResolved() || itemPtr->getStagedCount() > 0);
+    }
+
+    void ExplorerModel::fetchMore(const QModelIndex &parIndex) {
+        ExplorerItem *itemPtr = getItemPointer(parIndex);
+        if (itemPtr == nullptr)
+            return;
+
+        if (!itemPtr->isResolved())
+            int_resolveItem(itemPtr);
+
+        /*
+         * Insert one batch per call. Views call this again as long as there is room for
+         * more rows, so large filters fill in while scrolling.
+         */
+        NkSize const numOfItems = std::min(itemPtr->getStagedCount(), static_cast<NkSize>(FetchBatchSize));
+        if (numOfItems == 0)
+            return;
+
+        int const firstRow = static_cast<int>(itemPtr->getChildCount());
+        beginInsertRows(parIndex, firstRow, firstRow + static_cast<int>(numOfItems) - 1);
+        itemPtr->appendStagedItems(numOfItems);
+        endInsertRows();
+    }
+
     QVariant ExplorerModel::data(QModelIndex const &modelIndex, int roleId) const {
         if (!modelIndex.isValid())
             return QVariant{};
@@ -242,6 +558,17 @@ namespace NkE {
                 switch (itemPtr->getItemType()) {
                     case ExplorerItem::Type::Session: return QIcon(":/icons/ico_session.png");
                     case ExplorerItem::Type::Filter: return QIcon(":/icons/ico_folderfilter.png");
+                    case ExplorerItem::Type::Asset:
+                        /* Bitmaps show a preview once the thumbnail service has created it. */
+                        if (mp_thumbService != nullptr && itemPtr->getSourcePath().endsWith(".bmp", Qt::CaseInsensitive)) {
+                            QPixmap const thumbPix = mp_thumbService->getThumbnail(itemPtr->getAssetId(), itemPtr->getSourcePath());
+                            if (!thumbPix.isNull())
+                                return thumbPix;
+
+                            m_thumbItems.insert(itemPtr->getAssetId(), itemPtr);
+                        }
+
+                        return QIcon(":/icons/ico_documentnew.png");
                 }
 
                 break;
@@ -280,7 +607,7 @@ namespace NkE {
         /* Get item index. */
         ExplorerItem *itemPtr = getItemPointer(parIndex);
         if (itemPtr == nullptr || numOfRows > 1)
-            false;
+            return false;
 
         /* Insert the rows. */
         beginInsertRows(parIndex, where2Insert, where2Insert + numOfRows - 1);
@@ -373,30 +700,308 @@ namespace NkE::priv {
             setRecursiveFilteringEnabled(true);
         }
 
+        /**
+         * \brief hides all rows until matches are added with <tt>addMatchedPaths()</tt>
+         * \note  While an indexed search is active, the filter expression is ignored.
+         */
+        void beginIndexedSearch() {
+            m_isIndexed = true;
+            m_matchedPaths.clear();
+
+            invalidateFilter();
+        }
+        /**
+         * \brief shows the items of the given assets and of the filters leading to them
+         * \param [in] assetPaths paths of the assets, as reported by the search index
+         */
+        void addMatchedPaths(QStringList const &assetPaths) {
+            for (QString const &currPath : assetPaths) {
+                m_matchedPaths.insert(currPath);
+
+                /*
+                 * Filters are identified by their path up to and including the separator.
+                 * The ancestors of a known filter are known as well, so stop there.
+                 */
+                qsizetype sepPos = currPath.lastIndexOf(QChar('/'));
+                while (sepPos >= 0) {
+                    QString const filterPath = currPath.left(sepPos + 1);
+                    if (m_matchedPaths.contains(filterPath))
+                        break;
+
+                    m_matchedPaths.insert(filterPath);
+                    sepPos = sepPos > 0 ? currPath.lastIndexOf(QChar('/'), sepPos - 1) : -1;
+                }
+            }
+            /* The top-level filter of the asset database has an empty path. */
+            if (!assetPaths.isEmpty())
+                m_matchedPaths.insert(QString{});
+
+            invalidateFilter();
+        }
+        /**
+         * \brief returns to filtering by the filter expression
+         */
+        void endIndexedSearch() {
+            if (!m_isIndexed)
+                return;
+
+            m_isIndexed = false;
+            m_matchedPaths.clear();
+
+            invalidateFilter();
+        }
+
     protected:
         /**
          * \brief reimplements \c QSortFilterProxyModel::filterAcceptsRow()
          * \see   https://doc.qt.io/qt-6/qsortfilterproxymodel.html#filterAcceptsRow
          */
         virtual bool filterAcceptsRow(int sourceRowNum, const QModelIndex &srcParentIndex) const override {
-            if (!srcParentIndex.isValid())
-                return false;
-
-            /* Get pointer to parent item. */
-            auto parPtr = static_cast<::NkE::ExplorerItem *>(srcParentIndex.internalPointer());
-            if (sourceRowNum >= parPtr->getChildCount())
+            /*
+             * Top-level items are tested like any other item; lazy filters have no children
+             * before they are expanded, so they cannot be shown through one of them.
+             */
+            QModelIndex currModelIndex = sourceModel()->index(sourceRowNum, 0, srcParentIndex);
+            if (!currModelIndex.isValid())
                 return false;
 
-            /* Get child index. */
-            QModelIndex currModelIndex = sourceModel()->index(sourceRowNum, 0, srcParentIndex);
             ::NkE::ExplorerItem *itemPtr = static_cast<::NkE::ExplorerItem *>(currModelIndex.internalPointer());
+            if (m_isIndexed)
+                return m_matchedPaths.contains(itemPtr->getSourcePath());
 
             return itemPtr->getItemData(0).toString().contains(filterRegularExpression());
         }
+
+    private:
+        bool          m_isIndexed = false; /**< whether the rows are filtered by search results */
+        QSet<QString> m_matchedPaths;      /**< source paths of the items that are shown */
     };
 }
 
 
+/* implementation of the explorer search index */
+namespace NkE::priv {
+    /**
+     * \brief  packs three consecutive characters into a trigram key
+     * \param  [in] chPtr pointer to the first of the three characters
+     * \return key of the trigram
+     */
+    static quint64 ExplorerMakeTrigram(QChar const *chPtr) {
+        return (quint64)chPtr[0].unicode() << 32 | (quint64)chPtr[1].unicode() << 16 | (quint64)chPtr[2].unicode();
+    }
+
+    /**
+     * \brief  is invoked for every asset while the search index is built
+     * \param  [in] colCount number of columns (name, path)
+     * \param  [in] colResArr column values of the current row
+     * \param  [in,out] extraCxtPtr pointer to a vector of (name, path) pairs
+     * \return \c NkErr_Ok
+     */
+    static NkErrorCode NK_CALL ExplorerIndexRowIterFn(
+        _In_                 NkUint32 colCount,
+        _In_reads_(colCount) NkVariant const *colResArr,
+        _Inout_opt_          NkVoid *extraCxtPtr
+    ) {
+        auto *rowVec = static_cast<std::vector<std::pair<QString, QString>> *>(extraCxtPtr);
+        if (colCount < 2)
+            return NkErr_Ok;
+
+        NkVariantType nameTy, pathTy;
+        NkStringView  nameStr, pathStr;
+        NkVariantGet(&colResArr[0], &nameTy, (NkVoid *)&nameStr);
+        NkVariantGet(&colResArr[1], &pathTy, (NkVoid *)&pathStr);
+        if (nameTy != NkVarTy_StringView || pathTy != NkVarTy_StringView)
+            return NkErr_Ok;
+
+        rowVec->emplace_back(
+            QString::fromUtf8(nameStr.mp_dataPtr, static_cast<qsizetype>(nameStr.m_sizeInBytes)),
+            QString::fromUtf8(pathStr.mp_dataPtr, static_cast<qsizetype>(pathStr.m_sizeInBytes))
+        );
+        return NkErr_Ok;
+    }
+}
+
+
+namespace NkE {
+    ExplorerSearchIndex::ExplorerSearchIndex(QObject *parPtr)
+        : QObject(parPtr), m_currBuild(0), m_currQuery(0)
+    {
+        /* One thread can build a new snapshot while the other answers queries. */
+        m_workerPool.setMaxThreadCount(2);
+    }
+
+    ExplorerSearchIndex::~ExplorerSearchIndex() {
+        /* Workers refer to the index, so let them finish before it goes away. */
+        ++m_currBuild;
+        ++m_currQuery;
+
+        m_workerPool.waitForDone();
+    }
+
+
+    void ExplorerSearchIndex::int_buildIndex(QString const &dbPath, quint64 buildId) {
+        /* Use a connection of our own so that the explorer model can keep using its own. */
+        std::vector<std::pair<QString, QString>> rowVec;
+        NkIDatabase *dbPtr   = nullptr;
+        NkErrorCode  errCode = NkOMCreateInstance(
+            NKOM_CLSIDOF(NkIDatabase),
+            NULL,
+            NKOM_IIDOF(NkIDatabase),
+            NULL,
+            (NkIBase **)&dbPtr
+        );
+        if (errCode == NkErr_Ok) {
+            errCode = dbPtr->VT->Open(dbPtr, dbPath.toUtf8().constData(), NkDbMode_ReadOnly, nullptr);
+            if (errCode == NkErr_Ok)
+                errCode = dbPtr->VT->ExecuteInline(
+                    dbPtr,
+                    "SELECT name, path FROM assets",
+                    &priv::ExplorerIndexRowIterFn,
+                    static_cast<NkVoid *>(&rowVec)
+                );
+
+            dbPtr->VT->Release(dbPtr);
+        }
+        if (errCode != NkErr_Ok) {
+            NK_LOG_ERROR("Could not read \"%s\" for the search index (%i).", dbPath.toUtf8().constData(), errCode);
+
+            return;
+        }
+
+        /* Index the name and the path of every asset. */
+        auto dataPtr = std::make_shared<IndexData>();
+        dataPtr->m_entryArr.reserve(rowVec.size());
+        for (auto &rowRef : rowVec) {
+            if (buildId != m_currBuild)
+                return;
+
+            quint32 const entryInd = static_cast<quint32>(dataPtr->m_entryArr.size());
+            IndexEntry   &entryRef = dataPtr->m_entryArr.emplace_back();
+            entryRef.m_rawText    = rowRef.first + QChar('\n') + rowRef.second;
+            entryRef.m_foldedText = entryRef.m_rawText.toCaseFolded();
+            entryRef.m_assetPath  = std::move(rowRef.second);
+
+            for (qsizetype i = 0; i + 2 < entryRef.m_foldedText.size(); i++) {
+                std::vector<quint32> &entryList = dataPtr->m_trigramMap[priv::ExplorerMakeTrigram(entryRef.m_foldedText.constData() + i)];
+
+                /* Trigrams can repeat within an entry; lists stay ascending and unique. */
+                if (entryList.empty() || entryList.back() != entryInd)
+                    entryList.push_back(entryInd);
+            }
+        }
+
+        /* Swap the snapshot in on the thread that owns the index. */
+        std::shared_ptr<IndexData const> readyPtr = std::move(dataPtr);
+        QMetaObject::invokeMethod(this, [this, readyPtr, buildId]() {
+                if (buildId != m_currBuild)
+                    return;
+
+                mp_indexData = readyPtr;
+                NK_LOG_INFO("Search index ready: %zu assets", readyPtr->m_entryArr.size());
+
+                emit indexReady();
+            },
+            Qt::QueuedConnection
+        );
+    }
+
+    void ExplorerSearchIndex::int_runQuery(std::shared_ptr<IndexData const> dataPtr, QString const &searchText, bool isCaseSensitive, bool isRegex, quint64 queryId) {
+        QRegularExpression regEx;
+        QString            foldedText;
+        if (isRegex) {
+            regEx = QRegularExpression(searchText, isCaseSensitive
+                ? QRegularExpression::NoPatternOption
+                : QRegularExpression::CaseInsensitiveOption
+            );
+            if (!regEx.isValid())
+                return;
+        } else
+            foldedText = searchText.toCaseFolded();
+
+        /*
+         * Every match contains all trigrams of the search text, so only the entries of the
+         * rarest trigram have to be tested. A missing trigram means there is no match.
+         */
+        std::vector<quint32> const *candList = nullptr;
+        if (!isRegex && foldedText.size() >= 3) {
+            for (qsizetype i = 0; i + 2 < foldedText.size(); i++) {
+                auto const listIter = dataPtr->m_trigramMap.find(priv::ExplorerMakeTrigram(foldedText.constData() + i));
+                if (listIter == dataPtr->m_trigramMap.cend())
+                    return;
+
+                if (candList == nullptr || listIter->second.size() < candList->size())
+                    candList = &listIter->second;
+            }
+        }
+
+        QStringList chunkList;
+        auto const flushChunk = [&]() {
+            if (chunkList.isEmpty())
+                return;
+
+            QMetaObject::invokeMethod(this, [this, queryId, assetPaths = std::move(chunkList)]() {
+                    if (queryId == m_currQuery)
+                        emit resultsReady(queryId, assetPaths);
+                },
+                Qt::QueuedConnection
+            );
+            chunkList = QStringList{};
+        };
+
+        NkSize const nCands = candList != nullptr ? candList->size() : dataPtr->m_entryArr.size();
+        for (NkSize i = 0; i < nCands; i++) {
+            /* Stop as soon as a newer query was started. */
+            if ((i & 1023) == 0 && queryId != m_currQuery)
+                return;
+
+            IndexEntry const &entryRef = dataPtr->m_entryArr[candList != nullptr ? (*candList)[i] : i];
+            bool const isMatch = isRegex
+                ? regEx.match(entryRef.m_rawText).hasMatch()
+                : isCaseSensitive
+                    ? entryRef.m_rawText.contains(searchText)
+                    : entryRef.m_foldedText.contains(foldedText)
+            ;
+            if (!isMatch)
+                continue;
+
+            chunkList.append(entryRef.m_assetPath);
+            if (chunkList.size() >= ResultChunkSize)
+                flushChunk();
+        }
+        flushChunk();
+    }
+
+
+    void ExplorerSearchIndex::rebuild(QString const &dbPath) {
+        quint64 const buildId = ++m_currBuild;
+
+        m_workerPool.start([this, dbPath, buildId]() {
+            int_buildIndex(dbPath, buildId);
+        });
+    }
+
+    bool ExplorerSearchIndex::isReady() const {
+        return mp_indexData != nullptr;
+    }
+
+    quint64 ExplorerSearchIndex::query(QString const &searchText, bool isCaseSensitive, bool isRegex) {
+        quint64 const queryId = ++m_currQuery;
+        if (mp_indexData == nullptr || searchText.isEmpty())
+            return queryId;
+
+        /* The worker keeps the snapshot alive even if a rebuild replaces it. */
+        m_workerPool.start([this, dataPtr = mp_indexData, searchText, isCaseSensitive, isRegex, queryId]() {
+            int_runQuery(dataPtr, searchText, isCaseSensitive, isRegex, queryId);
+        });
+        return queryId;
+    }
+
+    void ExplorerSearchIndex::cancel() {
+        ++m_currQuery;
+    }
+} /* namespace NkE */
+
+
 /* implementation of the explorer widget */
 namespace NkE {
     ExplorerWidget::ExplorerWidget(ExplorerModel *explModelPtr, QWidget *parPtr)
@@ -415,6 +1020,13 @@ namespace NkE {
         /* Setup dynamic widgets. */
         int_setupDynamicWidgets();
 
+        /* Setup the search index; it stays empty until an asset database is opened. */
+        mp_searchIndex  = new ExplorerSearchIndex(this);
+        mp_thumbService = nullptr;
+        m_currQuery     = 0;
+        connect(mp_searchIndex, &ExplorerSearchIndex::indexReady, this, &ExplorerWidget::on_searchIndex_ready);
+        connect(mp_searchIndex, &ExplorerSearchIndex::resultsReady, this, &ExplorerWidget::on_searchIndex_resultsReady);
+
         /* Connect slots triggered by actions directly. */
         connect(actCollapseAll, &QAction::triggered, this, &ExplorerWidget::on_actCollapseAll_triggered);
         connect(actExpandAll, &QAction::triggered, this, &ExplorerWidget::on_actExpandAll_triggered);
@@ -432,7 +1044,8 @@ namespace NkE {
         tvExplorer->itemDelegate()->deleteLater();
         tvExplorer->setItemDelegate(new priv::ExplorerItemDelegate(tvExplorer));
         tvExplorer->setModel(new priv::ExplorerFilterModel(explModelPtr, this));
-        tvExplorer->expandAll();
+        /* Expanding everything would query the entire asset database up front. */
+        tvExplorer->expandToDepth(0);
 
         createSession("NewSession1");
         NK_LOG_INFO("startup: project explorer");
@@ -464,6 +1077,29 @@ namespace NkE {
         return nullptr;
     }
 
+    ExplorerModel *ExplorerWidget::int_getSourceModel() const {
+        if (QSortFilterProxyModel *modelPtr = dynamic_cast<QSortFilterProxyModel *>(tvExplorer->model()))
+            return dynamic_cast<ExplorerModel *>(modelPtr->sourceModel());
+
+        return nullptr;
+    }
+
+    void ExplorerWidget::int_expandLoadedRecursively(QModelIndex const &rootIndex) {
+        QAbstractItemModel *modelPtr = tvExplorer->model();
+
+        int const currRowCount = modelPtr->rowCount(rootIndex);
+        for (int i = 0; i < currRowCount; i++) {
+            QModelIndex const currChildInd = modelPtr->index(i, 0, rootIndex);
+
+            /* Expanding a lazy filter would query its children. */
+            if (!modelPtr->hasChildren(currChildInd) || modelPtr->canFetchMore(currChildInd))
+                continue;
+
+            tvExplorer->expand(currChildInd);
+            int_expandLoadedRecursively(currChildInd);
+        }
+    }
+
     void ExplorerWidget::int_expandOrCollapseRecursively(QModelIndex const &rootIndex, bool isExpand) {
         if (!rootIndex.isValid() || !tvExplorer->model()->hasChildren())
             return;
@@ -485,6 +1121,43 @@ namespace NkE {
 
     }
 
+    void ExplorerWidget::openAssetDatabase(QString const &dbPath, QString const &rootName) {
+        ExplorerModel *explModel = int_getSourceModel();
+        if (explModel == nullptr)
+            return;
+
+        /* Open the connection the model queries its items with. */
+        NkIDatabase *dbPtr   = nullptr;
+        NkErrorCode  errCode = NkOMCreateInstance(
+            NKOM_CLSIDOF(NkIDatabase),
+            NULL,
+            NKOM_IIDOF(NkIDatabase),
+            NULL,
+            (NkIBase **)&dbPtr
+        );
+        if (errCode == NkErr_Ok && (errCode = dbPtr->VT->Open(dbPtr, dbPath.toUtf8().constData(), NkDbMode_ReadOnly, nullptr)) != NkErr_Ok)
+            dbPtr->VT->Release(dbPtr);
+        if (errCode != NkErr_Ok) {
+            NK_LOG_ERROR("Could not open asset database \"%s\" (%i).", dbPath.toUtf8().constData(), errCode);
+
+            return;
+        }
+
+        /* The model keeps a reference of its own. */
+        explModel->setAssetDatabase(dbPtr, rootName);
+        dbPtr->VT->Release(dbPtr);
+        tvExplorer->expandToDepth(0);
+
+        /* Replace the thumbnails of the previous database. */
+        QString const assetRoot = QFileInfo(dbPath).absolutePath();
+        explModel->setThumbnailService(nullptr);
+        delete mp_thumbService;
+        mp_thumbService = new ThumbnailService(assetRoot, QDir(assetRoot).filePath("thumbcache.db"), this);
+        explModel->setThumbnailService(mp_thumbService);
+
+        mp_searchIndex->rebuild(dbPath);
+    }
+
     
     void ExplorerWidget::on_actCollapseAll_triggered() {
         tvExplorer->collapseAll();
@@ -531,7 +1204,7 @@ namespace NkE {
         if (modelPtr != nullptr) {
             modelPtr->setFilterCaseSensitivity(isChecked ? Qt::CaseSensitive : Qt::CaseInsensitive);
 
-            tvExplorer->expandAll();
+            on_leSearch_textChanged(leSearch->text());
         }
     }
 
@@ -696,13 +1369,50 @@ namespace NkE {
 
         /* Update filter model. */
         priv::ExplorerFilterModel *modelPtr = dynamic_cast<priv::ExplorerFilterModel *>(tvExplorer->model());
+        if (modelPtr == nullptr)
+            return;
+
+        /*
+         * With an index, the query runs in the background and the view is filled as the
+         * results arrive. Without one, only the loaded items are filtered in place.
+         */
+        QString const searchText = actEnableRegex->isChecked() && updateRegEx ? newText : newText.trimmed();
+        if (mp_searchIndex->isReady() && !searchText.isEmpty()) {
+            modelPtr->beginIndexedSearch();
+
+            m_currQuery = mp_searchIndex->query(searchText, actCaseSensitivity->isChecked(), actEnableRegex->isChecked() && updateRegEx);
+            return;
+        }
+        mp_searchIndex->cancel();
+        modelPtr->endIndexedSearch();
+
         if (actEnableRegex->isChecked() && updateRegEx)
             modelPtr->setFilterRegularExpression(tmpRegEx);
         else
-            modelPtr->setFilterFixedString(newText.trimmed());
+            modelPtr->setFilterFixedString(searchText);
 
         /* Expand the view after the filtering has finished. */
-        tvExplorer->expandAll();
+        int_expandLoadedRecursively(QModelIndex());
+    }
+
+    void ExplorerWidget::on_searchIndex_ready() {
+        /* Answer a search that was typed while the index was being built. */
+        if (!leSearch->text().isEmpty())
+            on_leSearch_textChanged(leSearch->text());
+    }
+
+    void ExplorerWidget::on_searchIndex_resultsReady(quint64 queryId, QStringList const &assetPaths) {
+        priv::ExplorerFilterModel *modelPtr = dynamic_cast<priv::ExplorerFilterModel *>(tvExplorer->model());
+        ExplorerModel *explModel = int_getSourceModel();
+        if (queryId != m_currQuery || modelPtr == nullptr || explModel == nullptr)
+            return;
+
+        /* Load the items of the results, then show them along with their filters. */
+        for (QString const &currPath : assetPaths)
+            explModel->revealPath(currPath);
+        modelPtr->addMatchedPaths(assetPaths);
+
+        int_expandLoadedRecursively(QModelIndex());
     }
 } /* namespace NkE */
 
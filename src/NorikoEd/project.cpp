@@ -20,10 +20,15 @@
  */
 
 
+/* stdlib includes */
+#include <functional>
+
 /* Qt includes */
 #include <QMessageBox>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
+#include <QSaveFile>
+#include <QFileInfo>
 
 /* Noriko includes */
 #include <include/Noriko/log.h>
@@ -33,7 +38,8 @@
 
 namespace NkE {
     Project::Project(QString const &wkTitle, QString const &author, QString const &brDesc, QString const &dirRoot)
-        : m_workingTitle(wkTitle), m_authoringOrg(author), m_productDescription(brDesc), m_qualifiedPath(dirRoot)
+        : m_workingTitle(wkTitle), m_authoringOrg(author), m_productDescription(brDesc), m_qualifiedPath(dirRoot),
+        m_isRootModified(false)
     { }
 
     Project::Project(
@@ -43,7 +49,7 @@ namespace NkE {
         QString const &brDesc,
         QString const &dirRoot
     ) : UniversallyNamedItem(uuidStr), m_workingTitle(wkTitle), m_authoringOrg(author), m_productDescription(brDesc),
-        m_qualifiedPath(dirRoot)
+        m_qualifiedPath(dirRoot), m_isRootModified(false)
     { }
 
 
@@ -67,15 +73,264 @@ namespace NkE {
         writer.writeEndDocument();
         return true;
     }
+
+    QString Project::getStateDbPath() const {
+        return m_qualifiedPath + "/" + ProjectManager::ConvertWorkingTitle(m_workingTitle) + ".nkstate";
+    }
+
+
+    void Project::setAuthoringOrg(QString const &author) {
+        m_authoringOrg   = author;
+        m_isRootModified = true;
+    }
+
+    void Project::setProductDescription(QString const &brDesc) {
+        m_productDescription = brDesc;
+        m_isRootModified     = true;
+    }
+
+
+    bool Project::isModified() const {
+        return m_isRootModified || !m_changedIds.isEmpty() || !m_removedIds.isEmpty();
+    }
+
+    void Project::setItemState(ProjectItemState const &stateRef) {
+        m_itemMap.insert(stateRef.m_itemId, stateRef);
+
+        m_removedIds.remove(stateRef.m_itemId);
+        m_changedIds.insert(stateRef.m_itemId);
+    }
+
+    void Project::removeItemState(QByteArray const &itemId) {
+        if (!m_itemMap.remove(itemId))
+            return;
+
+        m_changedIds.remove(itemId);
+        m_removedIds.insert(itemId);
+    }
+
+    void Project::loadItemState(ProjectItemState &&stateRef) {
+        QByteArray const itemId = stateRef.m_itemId;
+
+        m_itemMap.insert(itemId, std::move(stateRef));
+    }
+
+
+    ProjectChangeSet Project::takeChanges() {
+        ProjectChangeSet changeSet{ m_isRootModified };
+
+        /* Copy the state, since the items may change again while the copy is written. */
+        changeSet.m_changedItems.reserve(m_changedIds.size());
+        for (QByteArray const &currId : m_changedIds)
+            changeSet.m_changedItems.append(m_itemMap.value(currId));
+        changeSet.m_removedIds = m_removedIds.values();
+
+        m_isRootModified = false;
+        m_changedIds.clear();
+        m_removedIds.clear();
+        return changeSet;
+    }
+
+    void Project::restoreChanges(ProjectChangeSet const &changeSet) {
+        m_isRootModified |= changeSet.m_isRootModified;
+
+        for (ProjectItemState const &currState : changeSet.m_changedItems)
+            if (m_itemMap.contains(currState.m_itemId))
+                m_changedIds.insert(currState.m_itemId);
+        for (QByteArray const &currId : changeSet.m_removedIds)
+            if (!m_itemMap.contains(currId))
+                m_removedIds.insert(currId);
+    }
 } /* namespace NkE */
 
 
+/* implementation of the state database helpers */
+namespace NkE::priv {
+    /**
+     * \brief schema of the project state database
+     */
+    static char const *const gl_c_StateDbSchema =
+        "CREATE TABLE IF NOT EXISTS items("
+            "uuid   BLOB NOT NULL, "
+            "parent BLOB, "
+            "type   INT  NOT NULL, "
+            "name   TEXT NOT NULL, "
+            "sort   INT  NOT NULL, "
+            "data   BLOB, "
+            "PRIMARY KEY (uuid)"
+        ")";
+
+    /**
+     * \brief binds a byte array to a statement parameter
+     * \param [in,out] stmtPtr statement the parameter belongs to
+     * \param [in] paramInd one-based index of the parameter
+     * \param [in] byteArr data that is to be bound; it is copied
+     */
+    static void ProjectBindBlob(NkISqlStatement *stmtPtr, NkUint32 paramInd, QByteArray const &byteArr) {
+        NkBufferView const blobBuf = {
+            reinterpret_cast<NkByte *>(const_cast<char *>(byteArr.constData())),
+            static_cast<NkSize>(byteArr.size())
+        };
+        NkVariant paramVar;
+        NkVariantSet(&paramVar, NkVarTy_BufferView, &blobBuf);
+
+        stmtPtr->VT->Bind(stmtPtr, paramInd, &paramVar);
+    }
+
+    /**
+     * \brief binds the columns of an item to the parameters of the store statement
+     * \param [in,out] stmtPtr store statement
+     * \param [in] stateRef state of the item
+     */
+    static void ProjectBindItem(NkISqlStatement *stmtPtr, ProjectItemState const &stateRef) {
+        QByteArray const nameStr = stateRef.m_itemName.toUtf8();
+        NkStringView const nameView = { const_cast<char *>(nameStr.constData()), static_cast<NkSize>(nameStr.size()) };
+        NkVariant paramVar;
+
+        ProjectBindBlob(stmtPtr, 1U, stateRef.m_itemId);
+        if (stateRef.m_parentId.isEmpty())
+            stmtPtr->VT->Unbind(stmtPtr, 2U);
+        else
+            ProjectBindBlob(stmtPtr, 2U, stateRef.m_parentId);
+        NkVariantSet(&paramVar, NkVarTy_Int64, static_cast<NkInt64>(stateRef.m_itemType));
+        stmtPtr->VT->Bind(stmtPtr, 3U, &paramVar);
+        NkVariantSet(&paramVar, NkVarTy_StringView, &nameView);
+        stmtPtr->VT->Bind(stmtPtr, 4U, &paramVar);
+        NkVariantSet(&paramVar, NkVarTy_Int64, static_cast<NkInt64>(stateRef.m_sortKey));
+        stmtPtr->VT->Bind(stmtPtr, 5U, &paramVar);
+        ProjectBindBlob(stmtPtr, 6U, stateRef.m_itemData);
+    }
+
+    /**
+     * \struct ProjectLoadContext
+     * \brief  receives the rows of the state database while a project is loaded
+     */
+    struct ProjectLoadContext {
+        Project                             *mp_projPtr;  /**< project that is being loaded */
+        qint64                               m_numTotal;  /**< number of rows */
+        qint64                               m_numDone;   /**< number of rows read so far */
+        std::function<void(qint64, qint64)>  m_progFn;    /**< reports the progress */
+    };
+
+    /**
+     * \brief  reads the number of rows of the items table
+     * \param  [in] colCount number of columns (count)
+     * \param  [in] colResArr column values of the current row
+     * \param  [in,out] extraCxtPtr pointer to the \c ProjectLoadContext instance
+     * \return \c NkErr_Ok
+     */
+    static NkErrorCode NK_CALL ProjectCountIterFn(
+        _In_                 NkUint32 colCount,
+        _In_reads_(colCount) NkVariant const *colResArr,
+        _Inout_opt_          NkVoid *extraCxtPtr
+    ) {
+        if (colCount < 1)
+            return NkErr_Ok;
+
+        NkVariantType countTy;
+        NkInt64       countVal = 0;
+        NkVariantGet(&colResArr[0], &countTy, (NkVoid *)&countVal);
+        static_cast<ProjectLoadContext *>(extraCxtPtr)->m_numTotal = countTy == NkVarTy_Int64 ? countVal : 0;
+        return NkErr_Ok;
+    }
+
+    /**
+     * \brief  reads a single item of the state database into the project
+     * \param  [in] colCount number of columns (uuid, parent, type, name, sort, data)
+     * \param  [in] colResArr column values of the current row
+     * \param  [in,out] extraCxtPtr pointer to the \c ProjectLoadContext instance
+     * \return \c NkErr_Ok
+     */
+    static NkErrorCode NK_CALL ProjectItemIterFn(
+        _In_                 NkUint32 colCount,
+        _In_reads_(colCount) NkVariant const *colResArr,
+        _Inout_opt_          NkVoid *extraCxtPtr
+    ) {
+        auto *cxtPtr = static_cast<ProjectLoadContext *>(extraCxtPtr);
+        if (colCount < 6)
+            return NkErr_Ok;
+
+        /* Empty and NULL columns leave the defaults in place. */
+        auto const getBlob = [&](NkUint32 colInd) {
+            NkVariantType colTy;
+            NkBufferView  colBuf;
+            NkVariantGet(&colResArr[colInd], &colTy, (NkVoid *)&colBuf);
+
+            return colTy == NkVarTy_BufferView
+                ? QByteArray(reinterpret_cast<char const *>(colBuf.mp_dataPtr), static_cast<qsizetype>(colBuf.m_sizeInBytes))
+                : QByteArray{};
+        };
+        auto const getInt = [&](NkUint32 colInd) {
+            NkVariantType colTy;
+            NkInt64       colVal = 0;
+            NkVariantGet(&colResArr[colInd], &colTy, (NkVoid *)&colVal);
+
+            return colTy == NkVarTy_Int64 ? static_cast<int>(colVal) : 0;
+        };
+        NkVariantType nameTy;
+        NkStringView  nameStr;
+        NkVariantGet(&colResArr[3], &nameTy, (NkVoid *)&nameStr);
+
+        cxtPtr->mp_projPtr->loadItemState(ProjectItemState{
+            getBlob(0),
+            getBlob(1),
+            getInt(2),
+            nameTy == NkVarTy_StringView
+                ? QString::fromUtf8(nameStr.mp_dataPtr, static_cast<qsizetype>(nameStr.m_sizeInBytes))
+                : QString{},
+            getInt(4),
+            getBlob(5)
+        });
+
+        /* Do not flood the GUI thread with progress events. */
+        if ((++cxtPtr->m_numDone & 1023) == 0)
+            cxtPtr->m_progFn(cxtPtr->m_numDone, cxtPtr->m_numTotal);
+        return NkErr_Ok;
+    }
+
+    /**
+     * \brief  opens the state database of a project, creating it if necessary
+     * \param  [in] dbPath path to the state database
+     * \param  [out] dbPtr pointer to a variable that receives the connection
+     * \return \c NkErr_Ok on success, non-zero on failure
+     */
+    static NkErrorCode ProjectOpenStateDb(QString const &dbPath, NkIDatabase **dbPtr) {
+        *dbPtr = nullptr;
+
+        NkErrorCode errCode = NkOMCreateInstance(NKOM_CLSIDOF(NkIDatabase), NULL, NKOM_IIDOF(NkIDatabase), NULL, (NkIBase **)dbPtr);
+        if (errCode != NkErr_Ok)
+            return errCode;
+
+        errCode = (*dbPtr)->VT->Open(
+            *dbPtr,
+            dbPath.toUtf8().constData(),
+            static_cast<NkDatabaseMode>(NkDbMode_ReadWrite | NkDbMode_Create),
+            nullptr
+        );
+        if (errCode == NkErr_Ok)
+            errCode = (*dbPtr)->VT->ExecuteInline(*dbPtr, gl_c_StateDbSchema, nullptr, nullptr);
+        if (errCode != NkErr_Ok) {
+            (*dbPtr)->VT->Release(*dbPtr);
+
+            *dbPtr = nullptr;
+        }
+        return errCode;
+    }
+}
+
+
 namespace NkE {
     ProjectManager::ProjectManager() {
+        /* A single thread keeps loads and saves of the same project in order. */
+        m_ioPool.setMaxThreadCount(1);
+
         NK_LOG_INFO("startup: project manager");
     }
 
     ProjectManager::~ProjectManager() {
+        /* Do not lose changes that are still being written. */
+        m_ioPool.waitForDone();
+
         NK_LOG_INFO("shutdown: project manager");
     }
 
@@ -134,9 +389,7 @@ namespace NkE {
     }
 
     bool ProjectManager::openProject(QString const &projFilePath) {
-        /* Open the file handle. */
-        QFile projFile(projFilePath);
-        if (!projFile.open(QIODeviceBase::Text | QIODeviceBase::ReadOnly)) {
+        if (!QFileInfo(projFilePath).isReadable()) {
             QMessageBox::critical(
                 nullptr,
                 "Error",
@@ -150,56 +403,68 @@ namespace NkE {
             return false;
         }
 
-        /* Parse the file as XML and read all the required parameters. */
-        QString uuidStr, wkTitle, author, brDesc, rootPath;
-        QXmlStreamReader xmlReader(&projFile);
-        while (!xmlReader.isEndDocument()) {
-            QString const currName = xmlReader.name().toString();
-
-            if (currName == "uuid")                uuidStr  = xmlReader.readElementText();
-            if (currName == "working_title")       wkTitle  = xmlReader.readElementText();
-            if (currName == "project_author")      author   = xmlReader.readElementText();
-            if (currName == "product_description") brDesc   = xmlReader.readElementText();
-            if (currName == "rootpath")            rootPath = xmlReader.readElementText();
-
-            xmlReader.readNext();
-        }
-        /* Check that the necessary parameters are valid. */
-        if (wkTitle.isEmpty() || rootPath.isEmpty()) {
-            QMessageBox::critical(
-                nullptr,
-                "Error",
-                QString("Could not open project file \"%1\". File is malformed.").arg(projFilePath),
-                QMessageBox::Ok
+        /* Read the project in the background; it is added on the GUI thread once it is complete. */
+        m_ioPool.start([this, projFilePath]() {
+            QString errMsg;
+            std::shared_ptr<Project> projPtr = int_LoadProject(projFilePath, errMsg);
+
+            QMetaObject::invokeMethod(this, [this, projFilePath, projPtr, errMsg]() {
+                    if (projPtr == nullptr) {
+                        QMessageBox::critical(nullptr, "Error", errMsg, QMessageBox::Ok);
+
+                        emit projectLoadFailed(projFilePath, errMsg);
+                        return;
+                    }
+
+                    m_projVec.append(std::move(*projPtr));
+                    NK_LOG_INFO("Opened project \"%s\" at %s.",
+                        m_projVec.last().getWorkingTitle().toStdString().c_str(),
+                        m_projVec.last().getQualifiedPath().toStdString().c_str()
+                    );
+                    emit projectLoaded(m_projVec.last().getWorkingTitle(), m_projVec.last().getQualifiedPath());
+                },
+                Qt::QueuedConnection
             );
+        });
+        return true;
+    }
 
+    bool ProjectManager::saveProject(qsizetype projIndex) {
+        if (projIndex < 0 || projIndex >= m_projVec.size())
             return false;
-        }
-
-        /* Create the project from the parsed parameters. */
-        try {
-            Project newProj{ uuidStr, wkTitle, author, brDesc, rootPath };
-
-            m_projVec.append(std::move(newProj));
-            NK_LOG_INFO("Opened project \"%s\" at %s.", wkTitle.toStdString().c_str(), rootPath.toStdString().c_str());
-        } catch (NkErrorCode errCode) {
-            NK_UNREFERENCED_PARAMETER(errCode);
 
-            QMessageBox::critical(
-                nullptr,
-                "Error",
-                QString(
-                    "Could not instantiate project instance from project file %1. Check whether the file and all the "
-                    "data fields are encoded properly."
-                ).arg(projFilePath),
-                QMessageBox::Ok
+        /*
+         * Take the changes right away so that the project can be edited while they are
+         * written. The worker only gets copies.
+         */
+        Project &projRef = m_projVec[projIndex];
+        if (!projRef.isModified())
+            return true;
+
+        ProjectChangeSet changeSet = projRef.takeChanges();
+        Project          projCopy{ projRef.uuidToString(), projRef.getWorkingTitle(), projRef.getAuthoringOrg(), projRef.getProductDescription(), projRef.getQualifiedPath() };
+        m_ioPool.start([this, projCopy, changeSet]() {
+            bool const isOk = ProjectManager::int_SaveChanges(projCopy, changeSet);
+
+            QMetaObject::invokeMethod(this, [this, projCopy, changeSet, isOk]() {
+                    if (!isOk)
+                        for (Project &currProj : m_projVec)
+                            if (NkUuidIsEqual(&currProj.getUuid(), &projCopy.getUuid()))
+                                currProj.restoreChanges(changeSet);
+
+                    emit projectSaved(projCopy.getWorkingTitle(), isOk);
+                },
+                Qt::QueuedConnection
             );
-            return false;
-        }
-        emit projectLoaded(wkTitle, rootPath);
+        });
         return true;
     }
 
+    void ProjectManager::saveAllProjects() {
+        for (qsizetype i = 0; i < m_projVec.size(); i++)
+            NK_IGNORE_RETURN_VALUE(saveProject(i));
+    }
+
 
     QString ProjectManager::ConvertWorkingTitle(QString const &wkTitle) {
         return wkTitle.trimmed().replace(" ", "_");
@@ -235,6 +500,149 @@ namespace NkE {
         /* Write the project file contents. */
         return projRef.writeRootXmlDocument(&projFile);
     }
+
+    std::unique_ptr<Project> ProjectManager::int_LoadProject(QString const &projFilePath, QString &errMsg) {
+        QFile projFile(projFilePath);
+        if (!projFile.open(QIODeviceBase::Text | QIODeviceBase::ReadOnly)) {
+            errMsg = QString(
+                "Could not open project file \"%1\".\n\nCheck if the file path is valid and file permissions."
+            ).arg(projFilePath);
+
+            return nullptr;
+        }
+
+        /* Parse the file as XML and read all the required parameters. */
+        QString uuidStr, wkTitle, author, brDesc, rootPath;
+        QXmlStreamReader xmlReader(&projFile);
+        while (!xmlReader.atEnd()) {
+            if (xmlReader.readNext() != QXmlStreamReader::StartElement)
+                continue;
+            QString const currName = xmlReader.name().toString();
+
+            if (currName == "uuid")                uuidStr  = xmlReader.readElementText();
+            if (currName == "working_title")       wkTitle  = xmlReader.readElementText();
+            if (currName == "project_author")      author   = xmlReader.readElementText();
+            if (currName == "product_description") brDesc   = xmlReader.readElementText();
+            if (currName == "rootpath")            rootPath = xmlReader.readElementText();
+        }
+        /* Check that the necessary parameters are valid. */
+        if (xmlReader.hasError() || wkTitle.isEmpty() || rootPath.isEmpty()) {
+            errMsg = QString("Could not open project file \"%1\". File is malformed.").arg(projFilePath);
+
+            return nullptr;
+        }
+
+        /* Create the project from the parsed parameters. */
+        std::unique_ptr<Project> projPtr;
+        try {
+            projPtr = std::make_unique<Project>(uuidStr, wkTitle, author, brDesc, rootPath);
+        } catch (NkErrorCode errCode) {
+            NK_UNREFERENCED_PARAMETER(errCode);
+
+            errMsg = QString(
+                "Could not instantiate project instance from project file %1. Check whether the file and all the "
+                "data fields are encoded properly."
+            ).arg(projFilePath);
+            return nullptr;
+        }
+
+        /* Projects that were never saved have no state database yet. */
+        if (!QFileInfo::exists(projPtr->getStateDbPath()))
+            return projPtr;
+
+        NkIDatabase *dbPtr;
+        NkErrorCode errCode = priv::ProjectOpenStateDb(projPtr->getStateDbPath(), &dbPtr);
+        if (errCode == NkErr_Ok) {
+            priv::ProjectLoadContext loadCxt{ projPtr.get(), 0, 0,
+                [this, projFilePath](qint64 numDone, qint64 numTotal) {
+                    QMetaObject::invokeMethod(this, [this, projFilePath, numDone, numTotal]() {
+                            emit projectLoadProgress(projFilePath, numDone, numTotal);
+                        },
+                        Qt::QueuedConnection
+                    );
+                }
+            };
+
+            errCode = dbPtr->VT->ExecuteInline(dbPtr, "SELECT COUNT(*) FROM items", &priv::ProjectCountIterFn, &loadCxt);
+            if (errCode == NkErr_Ok)
+                errCode = dbPtr->VT->ExecuteInline(
+                    dbPtr,
+                    "SELECT uuid, parent, type, name, sort, data FROM items",
+                    &priv::ProjectItemIterFn,
+                    &loadCxt
+                );
+            if (errCode == NkErr_Ok)
+                loadCxt.m_progFn(loadCxt.m_numDone, loadCxt.m_numTotal);
+
+            dbPtr->VT->Release(dbPtr);
+        }
+        if (errCode != NkErr_Ok) {
+            errMsg = QString("Could not read the item state of project \"%1\" (%2).").arg(wkTitle).arg(errCode);
+
+            return nullptr;
+        }
+        return projPtr;
+    }
+
+    bool ProjectManager::int_SaveChanges(Project const &projRef, ProjectChangeSet const &changeSet) {
+        /* Replace the project file atomically, and only if one of its properties changed. */
+        if (changeSet.m_isRootModified) {
+            QSaveFile projFile(
+                projRef.getQualifiedPath()
+                    + "/"
+                    + ProjectManager::ConvertWorkingTitle(projRef.getWorkingTitle())
+                    + ".nkproj"
+            );
+            if (!projFile.open(QIODeviceBase::Text | QIODeviceBase::WriteOnly) || !projRef.writeRootXmlDocument(&projFile) || !projFile.commit()) {
+                NK_LOG_ERROR("Could not write project file \"%s\".", projFile.fileName().toStdString().c_str());
+
+                return false;
+            }
+        }
+        if (changeSet.m_changedItems.isEmpty() && changeSet.m_removedIds.isEmpty())
+            return true;
+
+        /* Write the rows of the changed items in one transaction. */
+        NkIDatabase     *dbPtr;
+        NkISqlStatement *storeStmt  = nullptr;
+        NkISqlStatement *removeStmt = nullptr;
+        NkErrorCode errCode = priv::ProjectOpenStateDb(projRef.getStateDbPath(), &dbPtr);
+        if (errCode != NkErr_Ok) {
+            NK_LOG_ERROR("Could not open state database \"%s\" (%i).", projRef.getStateDbPath().toStdString().c_str(), errCode);
+
+            return false;
+        }
+        if ((errCode = dbPtr->VT->CreateStatement(dbPtr, "INSERT OR REPLACE INTO items (uuid, parent, type, name, sort, data) VALUES (?1, ?2, ?3, ?4, ?5, ?6)", &storeStmt)) != NkErr_Ok)
+            goto lbl_CLEANUP;
+        if ((errCode = dbPtr->VT->CreateStatement(dbPtr, "DELETE FROM items WHERE uuid = ?1", &removeStmt)) != NkErr_Ok)
+            goto lbl_CLEANUP;
+        if ((errCode = dbPtr->VT->BeginTransaction(dbPtr)) != NkErr_Ok)
+            goto lbl_CLEANUP;
+
+        for (ProjectItemState const &currState : changeSet.m_changedItems) {
+            priv::ProjectBindItem(storeStmt, currState);
+
+            if ((errCode = dbPtr->VT->Execute(dbPtr, storeStmt, nullptr, nullptr)) != NkErr_Ok)
+                break;
+        }
+        for (qsizetype i = 0; errCode == NkErr_Ok && i < changeSet.m_removedIds.size(); i++) {
+            priv::ProjectBindBlob(removeStmt, 1U, changeSet.m_removedIds[i]);
+
+            errCode = dbPtr->VT->Execute(dbPtr, removeStmt, nullptr, nullptr);
+        }
+        errCode = errCode == NkErr_Ok ? dbPtr->VT->Commit(dbPtr) : (NK_IGNORE_RETURN_VALUE(dbPtr->VT->Rollback(dbPtr)), errCode);
+
+    lbl_CLEANUP:
+        if (errCode != NkErr_Ok)
+            NK_LOG_ERROR("Could not save the item state of project \"%s\" (%i).", projRef.getWorkingTitle().toStdString().c_str(), errCode);
+
+        if (removeStmt != nullptr)
+            removeStmt->VT->Release(removeStmt);
+        if (storeStmt != nullptr)
+            storeStmt->VT->Release(storeStmt);
+        dbPtr->VT->Release(dbPtr);
+        return errCode == NkErr_Ok;
+    }
 } /* namespace NkE */
 
 
@@ -0,0 +1,276 @@
+/**********************************************************************
+ * Noriko - cross-platform 2-D role-playing game (RPG) game engine    *
+ *          for desktop and mobile console platforms                  *
+ *                                                                    *
+ * (c) 2024 TophUwO <tophuwo01@gmail.com>. All rights reserved.       *
+ *                                                                    *
+ * The source code is licensed under the Apache License 2.0. Refer    *
+ * to the LICENSE file in the root directory of this project. If this *
+ * file is not present, visit                                         *
+ *     https://www.apache.org/licenses/LICENSE-2.0                    *
+ **********************************************************************/
+
+/**
+ * \file  thumbnail.cpp
+ * \brief implements the public API for NorikoEd's thumbnail service
+ *
+ * The thumbnail service creates the small previews that views show for texture assets.
+ * Decoding and downscaling run on worker threads. Finished thumbnails are kept in memory
+ * and in a cache database next to the asset database, keyed by the UUID of the asset and
+ * a hash of the file contents, so that they survive restarts and are recreated when the
+ * file changes.
+ */
+
+
+/* stdlib includes */
+#include <climits>
+#include <algorithm>
+
+/* Qt includes */
+#include <QFile>
+#include <QDir>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QThread>
+
+/* NorikoEd includes */
+#include <include/NorikoEd/thumbnail.hpp>
+
+
+/* implementation of the cache database helpers */
+namespace NkE::priv {
+    /**
+     * \brief schema of the thumbnail cache database
+     */
+    static char const *const gl_c_ThumbCacheSchema =
+        "CREATE TABLE IF NOT EXISTS thumbnails("
+            "uuid BLOB NOT NULL, "
+            "hash BLOB NOT NULL, "
+            "data BLOB NOT NULL, "
+            "PRIMARY KEY (uuid)"
+        ")";
+
+    /**
+     * \brief  copies the encoded thumbnail of a cache hit
+     * \param  [in] colCount number of columns (data)
+     * \param  [in] colResArr column values of the current row
+     * \param  [in,out] extraCxtPtr pointer to the \c QByteArray that receives the data
+     * \return \c NkErr_Ok
+     */
+    static NkErrorCode NK_CALL ThumbnailLookupIterFn(
+        _In_                 NkUint32 colCount,
+        _In_reads_(colCount) NkVariant const *colResArr,
+        _Inout_opt_          NkVoid *extraCxtPtr
+    ) {
+        if (colCount < 1)
+            return NkErr_Ok;
+
+        NkVariantType dataTy;
+        NkBufferView  dataBuf;
+        NkVariantGet(&colResArr[0], &dataTy, (NkVoid *)&dataBuf);
+        if (dataTy == NkVarTy_BufferView)
+            *static_cast<QByteArray *>(extraCxtPtr) = QByteArray(
+                reinterpret_cast<char const *>(dataBuf.mp_dataPtr),
+                static_cast<qsizetype>(dataBuf.m_sizeInBytes)
+            );
+
+        return NkErr_Ok;
+    }
+
+    /**
+     * \brief binds a byte array to a statement parameter
+     * \param [in,out] stmtPtr statement the parameter belongs to
+     * \param [in] paramInd one-based index of the parameter
+     * \param [in] byteArr data that is to be bound; it is copied
+     */
+    static void ThumbnailBindBlob(NkISqlStatement *stmtPtr, NkUint32 paramInd, QByteArray const &byteArr) {
+        NkBufferView const blobBuf = {
+            reinterpret_cast<NkByte *>(const_cast<char *>(byteArr.constData())),
+            static_cast<NkSize>(byteArr.size())
+        };
+        NkVariant blobVar;
+        NkVariantSet(&blobVar, NkVarTy_BufferView, &blobBuf);
+
+        stmtPtr->VT->Bind(stmtPtr, paramInd, &blobVar);
+    }
+}
+
+
+/* implementation of the thumbnail service */
+namespace NkE {
+    ThumbnailService::ThumbnailService(QString const &assetRoot, QString const &cacheDbPath, QObject *parPtr)
+        : QObject(parPtr), m_assetRoot(assetRoot), m_memCache(16 * 1024), m_nextPrio(0), m_isStopping(false),
+        mp_cacheDb(nullptr), mp_lookupStmt(nullptr), mp_storeStmt(nullptr)
+    {
+        /* Leave one core to the GUI thread. */
+        m_workerPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+
+        /* Open the cache database; without it, thumbnails are only kept in memory. */
+        NkErrorCode errCode = NkOMCreateInstance(
+            NKOM_CLSIDOF(NkIDatabase),
+            NULL,
+            NKOM_IIDOF(NkIDatabase),
+            NULL,
+            (NkIBase **)&mp_cacheDb
+        );
+        if (errCode == NkErr_Ok)
+            errCode = mp_cacheDb->VT->Open(
+                mp_cacheDb,
+                cacheDbPath.toUtf8().constData(),
+                static_cast<NkDatabaseMode>(NkDbMode_ReadWrite | NkDbMode_Create),
+                nullptr
+            );
+        if (errCode == NkErr_Ok)
+            errCode = mp_cacheDb->VT->ExecuteInline(mp_cacheDb, priv::gl_c_ThumbCacheSchema, nullptr, nullptr);
+        if (errCode == NkErr_Ok)
+            errCode = mp_cacheDb->VT->CreateStatement(
+                mp_cacheDb,
+                "SELECT data FROM thumbnails WHERE uuid = ?1 AND hash = ?2",
+                &mp_lookupStmt
+            );
+        if (errCode == NkErr_Ok)
+            errCode = mp_cacheDb->VT->CreateStatement(
+                mp_cacheDb,
+                "INSERT OR REPLACE INTO thumbnails (uuid, hash, data) VALUES (?1, ?2, ?3)",
+                &mp_storeStmt
+            );
+        if (errCode != NkErr_Ok) {
+            NK_LOG_WARNING("Could not open thumbnail cache \"%s\" (%i).", cacheDbPath.toUtf8().constData(), errCode);
+
+            if (mp_lookupStmt != nullptr)
+                mp_lookupStmt->VT->Release(mp_lookupStmt);
+            if (mp_cacheDb != nullptr)
+                mp_cacheDb->VT->Release(mp_cacheDb);
+            mp_cacheDb    = nullptr;
+            mp_lookupStmt = nullptr;
+            mp_storeStmt  = nullptr;
+        }
+    }
+
+    ThumbnailService::~ThumbnailService() {
+        /* Drop queued requests and let the running ones finish. */
+        m_isStopping = true;
+        m_workerPool.clear();
+        m_workerPool.waitForDone();
+
+        if (mp_storeStmt != nullptr)
+            mp_storeStmt->VT->Release(mp_storeStmt);
+        if (mp_lookupStmt != nullptr)
+            mp_lookupStmt->VT->Release(mp_lookupStmt);
+        if (mp_cacheDb != nullptr)
+            mp_cacheDb->VT->Release(mp_cacheDb);
+    }
+
+
+    void ThumbnailService::int_createThumbnail(QByteArray const &assetId, QString const &filePath) {
+        if (m_isStopping)
+            return;
+
+        /* Hash the contents so that edited files get a new thumbnail. */
+        QFile assetFile(filePath);
+        QByteArray fileData;
+        if (assetFile.open(QIODevice::ReadOnly))
+            fileData = assetFile.readAll();
+        QByteArray const fileHash = QCryptographicHash::hash(fileData, QCryptographicHash::Sha1);
+
+        QImage     thumbImg;
+        QByteArray encodedData;
+        if (!fileData.isEmpty() && mp_cacheDb != nullptr) {
+            QMutexLocker dbLocker(&m_dbLock);
+
+            priv::ThumbnailBindBlob(mp_lookupStmt, 1U, assetId);
+            priv::ThumbnailBindBlob(mp_lookupStmt, 2U, fileHash);
+            NK_IGNORE_RETURN_VALUE(mp_cacheDb->VT->Execute(mp_cacheDb, mp_lookupStmt, &priv::ThumbnailLookupIterFn, &encodedData));
+            mp_lookupStmt->VT->Unbind(mp_lookupStmt, 1U);
+            mp_lookupStmt->VT->Unbind(mp_lookupStmt, 2U);
+        }
+        if (!encodedData.isEmpty())
+            thumbImg.loadFromData(encodedData, "PNG");
+
+        /* Decode and cache the thumbnail if it was not cached for this version of the file. */
+        if (thumbImg.isNull() && !fileData.isEmpty() && (thumbImg = int_decodeBitmap(fileData), !thumbImg.isNull()) && mp_cacheDb != nullptr) {
+            QBuffer encodedBuf(&encodedData);
+            encodedBuf.open(QIODevice::WriteOnly);
+            thumbImg.save(&encodedBuf, "PNG");
+
+            QMutexLocker dbLocker(&m_dbLock);
+            priv::ThumbnailBindBlob(mp_storeStmt, 1U, assetId);
+            priv::ThumbnailBindBlob(mp_storeStmt, 2U, fileHash);
+            priv::ThumbnailBindBlob(mp_storeStmt, 3U, encodedData);
+            NkErrorCode const errCode = mp_cacheDb->VT->Execute(mp_cacheDb, mp_storeStmt, nullptr, nullptr);
+            mp_storeStmt->VT->Unbind(mp_storeStmt, 1U);
+            mp_storeStmt->VT->Unbind(mp_storeStmt, 2U);
+            mp_storeStmt->VT->Unbind(mp_storeStmt, 3U);
+            if (errCode != NkErr_Ok)
+                NK_LOG_WARNING("Could not cache thumbnail of \"%s\" (%i).", filePath.toUtf8().constData(), errCode);
+        }
+
+        /* Pixmaps can only be created on the GUI thread. */
+        QMetaObject::invokeMethod(this, [this, assetId, thumbImg]() {
+                m_pendingSet.remove(assetId);
+
+                if (thumbImg.isNull()) {
+                    m_failedSet.insert(assetId);
+
+                    return;
+                }
+
+                m_memCache.insert(assetId, new QPixmap(QPixmap::fromImage(thumbImg)), std::max(1, thumbImg.width() * thumbImg.height() * 4 / 1024));
+                emit thumbnailReady(assetId);
+            },
+            Qt::QueuedConnection
+        );
+    }
+
+    QImage ThumbnailService::int_decodeBitmap(QByteArray const &fileData) {
+        /* The bitmap refers to the pixels in the file buffer, which outlives it here. */
+        NkDIBitmap bmpObj;
+        NkBufferView const fileBuf = {
+            reinterpret_cast<NkByte *>(const_cast<char *>(fileData.constData())),
+            static_cast<NkSize>(fileData.size())
+        };
+        if (NkDIBitmapLoadFromMemory(fileBuf, &bmpObj) != NkErr_Ok)
+            return QImage{};
+
+        /* Pixels are stored bottom-up, in BGR(A) order. */
+        NkBitmapSpecification const *bmpSpec = NkDIBitmapGetSpecification(&bmpObj);
+        QImage const srcImg(
+            NkDIBitmapGetPixels(&bmpObj, nullptr),
+            bmpSpec->m_bmpWidth,
+            bmpSpec->m_bmpHeight,
+            static_cast<qsizetype>(bmpSpec->m_bmpStride),
+            bmpSpec->m_bitsPerPx == 24
+                ? QImage::Format_BGR888
+                : bmpSpec->m_alphaMask != 0 ? QImage::Format_ARGB32 : QImage::Format_RGB32
+        );
+
+        /* Scaling produces a copy, so the bitmap can be released afterwards. */
+        QImage thumbImg = srcImg.scaled(ThumbnailSize, ThumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation).mirrored(false, true);
+        NkDIBitmapDestroy(&bmpObj);
+
+        return thumbImg;
+    }
+
+
+    QPixmap ThumbnailService::getThumbnail(QByteArray const &assetId, QString const &assetPath) {
+        if (QPixmap *thumbPtr = m_memCache.object(assetId))
+            return *thumbPtr;
+        if (m_pendingSet.contains(assetId) || m_failedSet.contains(assetId))
+            return QPixmap{};
+
+        /* Newer requests get a higher priority, so visible rows are served first. */
+        m_pendingSet.insert(assetId);
+        m_nextPrio = m_nextPrio == INT_MAX ? 0 : m_nextPrio + 1;
+
+        QString const filePath = QDir(m_assetRoot).filePath(assetPath);
+        m_workerPool.start([this, assetId, filePath]() {
+                int_createThumbnail(assetId, filePath);
+            },
+            m_nextPrio
+        );
+        return QPixmap{};
+    }
+} /* namespace NkE */
+
+
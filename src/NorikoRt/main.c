@@ -15,16 +15,505 @@
 /**
  * \file  main.c
  * \brief entrypoint of Noriko's runtime application
+ *
+ * Besides running the game normally, the runtime can record the input of a session and
+ * replay it deterministically. While recording, every record the IAL buffers is tagged
+ * with the index of the fixed step that consumes it. While replaying, the records are
+ * injected right before the very same steps, and the main loop runs exactly one fixed
+ * step per frame without pacing, so that the simulation is identical to the recorded
+ * session no matter how fast the machine is. The time every replayed frame took is
+ * reported as minimum, mean, percentiles and maximum.
+ *
+ * The runtime understands the following command-line options:
+ * \li <tt>-record=path</tt>: record the input of the session to \c path
+ * \li <tt>-replay=path</tt>: replay the input recorded in \c path and report frame
+ *     times
+ * \li <tt>-ticks=n</tt>: number of fixed steps to replay (default: the number of steps
+ *     that were recorded)
+ * \li <tt>-headless</tt>: render with the null renderer into a hidden window; combined
+ *     with \c -replay, this measures CPU-side frame cost only
+ * \li <tt>-renderer=gdi|d3d11|null</tt>: select the renderer API
  */
+#define NK_NAMESPACE "nk::rt"
 
 
 /* stdlib includes */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* Noriko includes */
 #include <include/Noriko/noriko.h>
 
 
+/** \cond INTERNAL */
+/**
+ * \def   __NkInt_Rt_ReplayMagic
+ * \brief magic number identifying a replay file (<tt>'NKRP'</tt>)
+ */
+#define __NkInt_Rt_ReplayMagic   ((NkUint32)(0x50524b4e))
+/**
+ * \def   __NkInt_Rt_ReplayVersion
+ * \brief current version of the replay file format
+ */
+#define __NkInt_Rt_ReplayVersion ((NkUint32)(1))
+/**
+ * \def   __NkInt_Rt_MaxPath
+ * \brief maximum length of a replay file path, in bytes (incl. <tt>NUL</tt>)
+ */
+#define __NkInt_Rt_MaxPath       ((NkSize)(1024))
+/**
+ * \def   __NkInt_Rt_MaxSteps
+ * \brief maximum number of fixed steps that can be replayed in one run
+ */
+#define __NkInt_Rt_MaxSteps      ((NkSize)(1 << 24))
+
+
+/**
+ * \struct __NkInt_RtReplayHeader
+ * \brief  represents the header of a replay file
+ */
+NK_NATIVE typedef struct __NkInt_RtReplayHeader {
+    NkUint32 m_magicNum; /**< magic number; must be \c __NkInt_Rt_ReplayMagic */
+    NkUint32 m_fileVer;  /**< file format version */
+    NkUint32 m_tickRate; /**< fixed tick rate the session was recorded with */
+    NkUint32 m_reserved; /**< reserved; must be \c 0 */
+    NkUint64 m_nSteps;   /**< number of fixed steps that were recorded */
+    NkUint64 m_nRecs;    /**< number of records following the header */
+} __NkInt_RtReplayHeader;
+
+/**
+ * \struct __NkInt_RtReplayRecord
+ * \brief  represents a single input record as it is stored in a replay file
+ * \note   Timestamps are not stored; a replayed record is stamped with the point in time
+ *         of the step that consumes it.
+ */
+NK_NATIVE typedef struct __NkInt_RtReplayRecord {
+    NkUint64 m_stepInd;      /**< index of the fixed step that consumes the record */
+    NkUint32 m_recType;      /**< record type (see <tt>NkInputRecordType</tt>) */
+    NkUint32 m_reserved;     /**< reserved; must be \c 0 */
+    NkInt64  m_recParams[2]; /**< key code, mouse button, or motion delta */
+} __NkInt_RtReplayRecord;
+
+/**
+ * \struct __NkInt_RtReplayEntry
+ * \brief  represents a record held in memory while recording or replaying
+ */
+NK_NATIVE typedef struct __NkInt_RtReplayEntry {
+    NkUint64      m_stepInd; /**< index of the step that consumes the record */
+    NkInputRecord m_inRec;   /**< the record itself */
+} __NkInt_RtReplayEntry;
+
+/**
+ * \struct __NkInt_RtReplayCxt
+ * \brief  holds the state of a recording or replay
+ */
+NK_NATIVE typedef struct __NkInt_RtReplayCxt {
+    NkIInput              *mp_ialRef;   /**< IAL records are read from or injected into */
+    __NkInt_RtReplayEntry *mp_entArr;   /**< records, ordered by step */
+    NkSize                 m_nEnts;     /**< number of records in \c mp_entArr */
+    NkSize                 m_entCap;    /**< capacity of \c mp_entArr, in records */
+    NkSize                 m_currEnt;   /**< first record not yet assigned (record) or injected (replay) */
+    NkUint64               m_nSteps;    /**< number of steps run so far (record) */
+    NkBoolean              m_hasFailed; /**< whether a record could not be stored */
+} __NkInt_RtReplayCxt;
+
+
+/**
+ * \brief compares two doubles, as required by <tt>qsort()</tt>
+ */
+NK_INTERNAL int __NkInt_Rt_CompareDoubles(_In_ void const *lhsPtr, _In_ void const *rhsPtr) {
+    NkDouble const lhsVal = *(NkDouble const *)lhsPtr;
+    NkDouble const rhsVal = *(NkDouble const *)rhsPtr;
+
+    return (lhsVal > rhsVal) - (lhsVal < rhsVal);
+}
+
+/**
+ * \brief  reads a string option from the command-line
+ * \param  [in] keyStr name of the option
+ * \param  [out] pathBuf buffer that receives the <tt>NUL</tt>-terminated value
+ * \return \c NK_TRUE if the option was given and fits into \c pathBuf, \c NK_FALSE
+ *         otherwise
+ */
+NK_INTERNAL NkBoolean __NkInt_Rt_QueryPathOption(_In_z_ char const *keyStr, _Out_ char *pathBuf) {
+    NkVariant     optVar;
+    NkVariantType varTy;
+    NkStringView  optVal;
+    if (NkEnvGetValue(keyStr, &optVar) != NkErr_Ok)
+        return NK_FALSE;
+
+    NkVariantGet(&optVar, &varTy, &optVal);
+    if (varTy != NkVarTy_StringView || optVal.m_sizeInBytes == 0 || optVal.m_sizeInBytes >= __NkInt_Rt_MaxPath) {
+        NK_LOG_WARNING("Ignoring invalid value of option \"%s\"; must be a path.", keyStr);
+
+        return NK_FALSE;
+    }
+    memcpy(pathBuf, optVal.mp_dataPtr, optVal.m_sizeInBytes);
+    pathBuf[optVal.m_sizeInBytes] = '\0';
+    return NK_TRUE;
+}
+
+/**
+ * \brief  reads a numeric option from the command-line
+ * \param  [in] keyStr name of the option
+ * \param  [in] defVal value to return if the option was not given or is invalid
+ * \param  [in] maxVal largest valid value
+ * \return value of the option
+ */
+NK_INTERNAL NkSize __NkInt_Rt_QueryCountOption(_In_z_ char const *keyStr, _In_ NkSize defVal, _In_ NkSize maxVal) {
+    NkVariant     optVar;
+    NkVariantType varTy;
+    NkDouble      optVal;
+    if (NkEnvGetValue(keyStr, &optVar) != NkErr_Ok)
+        return defVal;
+
+    NkVariantGet(&optVar, &varTy, &optVal);
+    if (varTy != NkVarTy_Double || optVal < 0. || optVal > (NkDouble)maxVal) {
+        NK_LOG_WARNING("Ignoring invalid value of option \"%s\"; must be an integer between 0 and %zu.", keyStr, maxVal);
+
+        return defVal;
+    }
+    return (NkSize)optVal;
+}
+
+
+/**
+ * \brief appends every record the IAL buffers to the recording
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_Rt_OnRecord(_In_ NkInputRecord const *recPtr, _Inout_opt_ NkVoid *cxtPtr) {
+    __NkInt_RtReplayCxt *replayCxt = (__NkInt_RtReplayCxt *)cxtPtr;
+
+    if (replayCxt->m_nEnts == replayCxt->m_entCap) {
+        NkSize const newCap = NK_MAX(replayCxt->m_entCap * 2, 256);
+
+        NkVoid *newArr = replayCxt->mp_entArr;
+        NkErrorCode const errCode = newArr == NULL
+            ? NkGPAlloc(NULL, newCap * sizeof *replayCxt->mp_entArr, 0, NK_FALSE, &newArr)
+            : NkGPRealloc(NULL, newCap * sizeof *replayCxt->mp_entArr, &newArr);
+        if (errCode != NkErr_Ok) {
+            if (!replayCxt->m_hasFailed)
+                NK_LOG_ERROR("Could not grow the recording; further input is dropped.");
+
+            replayCxt->m_hasFailed = NK_TRUE;
+            return;
+        }
+        replayCxt->mp_entArr = (__NkInt_RtReplayEntry *)newArr;
+        replayCxt->m_entCap  = newCap;
+    }
+
+    /*
+     * The step the record belongs to is not known until the main loop runs the step that
+     * simulates up to a point in time past the timestamp of the record.
+     */
+    replayCxt->mp_entArr[replayCxt->m_nEnts++] = (__NkInt_RtReplayEntry){
+        .m_stepInd = UINT64_MAX,
+        .m_inRec   = *recPtr
+    };
+}
+
+/**
+ * \brief tags all pending records with the step that consumes them
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_Rt_OnRecordStep(_In_ NkUint64 stepInd, _In_ NkUint64 stepTime, _Inout_opt_ NkVoid *cxtPtr) {
+    __NkInt_RtReplayCxt *replayCxt = (__NkInt_RtReplayCxt *)cxtPtr;
+
+    while (replayCxt->m_currEnt < replayCxt->m_nEnts && replayCxt->mp_entArr[replayCxt->m_currEnt].m_inRec.m_timestamp <= stepTime)
+        replayCxt->mp_entArr[replayCxt->m_currEnt++].m_stepInd = stepInd;
+    replayCxt->m_nSteps = stepInd + 1;
+}
+
+/**
+ * \brief injects all records of the step that is about to be run into the IAL
+ */
+NK_INTERNAL NkVoid NK_CALL __NkInt_Rt_OnReplayStep(_In_ NkUint64 stepInd, _In_ NkUint64 stepTime, _Inout_opt_ NkVoid *cxtPtr) {
+    __NkInt_RtReplayCxt *replayCxt = (__NkInt_RtReplayCxt *)cxtPtr;
+
+    while (replayCxt->m_currEnt < replayCxt->m_nEnts && replayCxt->mp_entArr[replayCxt->m_currEnt].m_stepInd <= stepInd) {
+        NkInputRecord inRec = replayCxt->mp_entArr[replayCxt->m_currEnt++].m_inRec;
+        inRec.m_timestamp   = stepTime;
+
+        NkErrorCode const errCode = replayCxt->mp_ialRef->VT->InjectRecord(replayCxt->mp_ialRef, &inRec);
+        if (errCode != NkErr_Ok && !replayCxt->m_hasFailed) {
+            NK_LOG_WARNING("Could not inject record into step %llu; the replay is no longer deterministic. Reason: %s",
+                (unsigned long long)stepInd,
+                NkGetErrorCodeStr(errCode)->mp_dataPtr
+            );
+
+            replayCxt->m_hasFailed = NK_TRUE;
+        }
+    }
+}
+
+
+/**
+ * \brief  writes a recording to a file
+ * \param  [in] replayCxt recording to write
+ * \param  [in] filePath path of the file to write
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Rt_SaveRecording(_In_ __NkInt_RtReplayCxt const *replayCxt, _In_z_ char const *filePath) {
+    FILE *filePtr;
+    if (fopen_s(&filePtr, filePath, "wb") != 0 || filePtr == NULL) {
+        NK_LOG_ERROR("Could not open \"%s\" for writing.", filePath);
+
+        return NkErr_OpenFile;
+    }
+
+    NkErrorCode errCode = NkErr_Ok;
+    __NkInt_RtReplayHeader const fileHdr = {
+        .m_magicNum = __NkInt_Rt_ReplayMagic,
+        .m_fileVer  = __NkInt_Rt_ReplayVersion,
+        .m_tickRate = NkApplicationQuerySpecification()->m_fixedTickRate,
+        .m_reserved = 0,
+        .m_nSteps   = replayCxt->m_nSteps,
+        .m_nRecs    = replayCxt->m_nEnts
+    };
+    if (fwrite(&fileHdr, sizeof fileHdr, 1, filePtr) != 1) {
+        errCode = NkErr_ErrorDuringDiskIO;
+
+        goto lbl_END;
+    }
+
+    for (NkSize i = 0; i < replayCxt->m_nEnts; i++) {
+        __NkInt_RtReplayEntry const *entPtr = &replayCxt->mp_entArr[i];
+
+        /*
+         * Records that arrived after the last step ran would have been consumed by the
+         * next step.
+         */
+        __NkInt_RtReplayRecord fileRec = {
+            .m_stepInd = NK_MIN(entPtr->m_stepInd, replayCxt->m_nSteps),
+            .m_recType = (NkUint32)entPtr->m_inRec.m_recType
+        };
+        switch (entPtr->m_inRec.m_recType) {
+            case NkInRec_KeyDown:
+            case NkInRec_KeyUp:
+                fileRec.m_recParams[0] = (NkInt64)entPtr->m_inRec.m_keyCode;
+                break;
+            case NkInRec_ButtonDown:
+            case NkInRec_ButtonUp:
+                fileRec.m_recParams[0] = (NkInt64)entPtr->m_inRec.m_mouseBtn;
+                break;
+            case NkInRec_MouseMoved:
+                fileRec.m_recParams[0] = entPtr->m_inRec.m_motDelta.m_xCoord;
+                fileRec.m_recParams[1] = entPtr->m_inRec.m_motDelta.m_yCoord;
+                break;
+        }
+
+        if (fwrite(&fileRec, sizeof fileRec, 1, filePtr) != 1) {
+            errCode = NkErr_ErrorDuringDiskIO;
+
+            goto lbl_END;
+        }
+    }
+
+lbl_END:
+    if (fclose(filePtr) != 0 && errCode == NkErr_Ok)
+        errCode = NkErr_ErrorDuringDiskIO;
+
+    if (errCode == NkErr_Ok)
+        NK_LOG_INFO("Recorded %llu records over %llu fixed steps to \"%s\".",
+            (unsigned long long)fileHdr.m_nRecs,
+            (unsigned long long)fileHdr.m_nSteps,
+            filePath
+        );
+    else
+        NK_LOG_ERROR("Could not write recording to \"%s\".", filePath);
+    return errCode;
+}
+
+/**
+ * \brief  loads a recording from a file
+ * \param  [in] filePath path of the file to read
+ * \param  [out] fileHdr receives the header of the file
+ * \param  [out] replayCxt receives the records
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Rt_LoadRecording(
+    _In_z_ char const             *filePath,
+    _Out_  __NkInt_RtReplayHeader *fileHdr,
+    _Out_  __NkInt_RtReplayCxt    *replayCxt
+) {
+    FILE *filePtr;
+    if (fopen_s(&filePtr, filePath, "rb") != 0 || filePtr == NULL) {
+        NK_LOG_ERROR("Could not open \"%s\" for reading.", filePath);
+
+        return NkErr_OpenFile;
+    }
+
+    NkErrorCode errCode = NkErr_Ok;
+    if (fread(fileHdr, sizeof *fileHdr, 1, filePtr) != 1) {
+        errCode = NkErr_CorruptedData;
+
+        goto lbl_END;
+    }
+    if (fileHdr->m_magicNum != __NkInt_Rt_ReplayMagic || fileHdr->m_fileVer != __NkInt_Rt_ReplayVersion) {
+        NK_LOG_ERROR("\"%s\" is not a replay file or was made by an incompatible version.", filePath);
+
+        errCode = NkErr_CorruptedData;
+        goto lbl_END;
+    }
+
+    if (fileHdr->m_nRecs > 0) {
+        if (fileHdr->m_nRecs > SIZE_MAX / sizeof *replayCxt->mp_entArr) {
+            errCode = NkErr_CorruptedData;
+
+            goto lbl_END;
+        }
+        errCode = NkGPAlloc(NULL, (NkSize)fileHdr->m_nRecs * sizeof *replayCxt->mp_entArr, 0, NK_FALSE, (NkVoid **)&replayCxt->mp_entArr);
+        if (errCode != NkErr_Ok)
+            goto lbl_END;
+        replayCxt->m_entCap = (NkSize)fileHdr->m_nRecs;
+    }
+
+    for (NkSize i = 0; i < (NkSize)fileHdr->m_nRecs; i++) {
+        __NkInt_RtReplayRecord fileRec;
+        if (fread(&fileRec, sizeof fileRec, 1, filePtr) != 1) {
+            errCode = NkErr_CorruptedData;
+
+            goto lbl_END;
+        }
+
+        /* Records must be ordered by step for the replay to inject them in one pass. */
+        if (i > 0 && fileRec.m_stepInd < replayCxt->mp_entArr[i - 1].m_stepInd) {
+            errCode = NkErr_CorruptedData;
+
+            goto lbl_END;
+        }
+
+        __NkInt_RtReplayEntry *entPtr = &replayCxt->mp_entArr[i];
+        *entPtr = (__NkInt_RtReplayEntry){
+            .m_stepInd = fileRec.m_stepInd,
+            .m_inRec   = { .m_recType = (NkInputRecordType)fileRec.m_recType }
+        };
+        switch (fileRec.m_recType) {
+            case NkInRec_KeyDown:
+            case NkInRec_KeyUp:
+                entPtr->m_inRec.m_keyCode = (NkKeyboardKey)fileRec.m_recParams[0];
+                break;
+            case NkInRec_ButtonDown:
+            case NkInRec_ButtonUp:
+                entPtr->m_inRec.m_mouseBtn = (NkMouseButton)fileRec.m_recParams[0];
+                break;
+            case NkInRec_MouseMoved:
+                entPtr->m_inRec.m_motDelta.m_xCoord = fileRec.m_recParams[0];
+                entPtr->m_inRec.m_motDelta.m_yCoord = fileRec.m_recParams[1];
+                break;
+            default:
+                errCode = NkErr_CorruptedData;
+
+                goto lbl_END;
+        }
+        replayCxt->m_nEnts = i + 1;
+    }
+
+lbl_END:
+    fclose(filePtr);
+
+    if (errCode == NkErr_CorruptedData)
+        NK_LOG_ERROR("Replay file \"%s\" is corrupted or truncated.", filePath);
+    return errCode;
+}
+
+
+/**
+ * \brief  runs the application while recording its input
+ * \param  [in] filePath path of the file to write the recording to
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Rt_RunRecord(_In_z_ char const *filePath) {
+    __NkInt_RtReplayCxt replayCxt = { .mp_ialRef = NkApplicationQueryInstance(NKOM_CLSIDOF(NkIInput)) };
+    if (replayCxt.mp_ialRef == NULL)
+        return NkErr_ComponentState;
+
+    replayCxt.mp_ialRef->VT->SetRecordHook(replayCxt.mp_ialRef, &__NkInt_Rt_OnRecord, &replayCxt);
+    NkApplicationSetStepCallback(&__NkInt_Rt_OnRecordStep, &replayCxt);
+    NkErrorCode errCode = NkApplicationRun();
+    NkApplicationSetStepCallback(NULL, NULL);
+    replayCxt.mp_ialRef->VT->SetRecordHook(replayCxt.mp_ialRef, NULL, NULL);
+
+    NkErrorCode const saveCode = __NkInt_Rt_SaveRecording(&replayCxt, filePath);
+    if (errCode == NkErr_Ok)
+        errCode = saveCode;
+
+    NkGPFree(replayCxt.mp_entArr);
+    replayCxt.mp_ialRef->VT->Release(replayCxt.mp_ialRef);
+    return errCode;
+}
+
+/**
+ * \brief  replays a recording and reports the frame times
+ * \param  [in] filePath path of the recording to replay
+ * \return \c NkErr_Ok on success, non-zero on failure
+ */
+NK_INTERNAL _Return_ok_ NkErrorCode __NkInt_Rt_RunReplay(_In_z_ char const *filePath) {
+    __NkInt_RtReplayHeader fileHdr;
+    __NkInt_RtReplayCxt    replayCxt = { NULL };
+    NkDouble              *frameTimes = NULL;
+
+    NkErrorCode errCode = __NkInt_Rt_LoadRecording(filePath, &fileHdr, &replayCxt);
+    if (errCode != NkErr_Ok)
+        goto lbl_END;
+
+    NkUint32 const tickRate = NkApplicationQuerySpecification()->m_fixedTickRate;
+    if (fileHdr.m_tickRate != tickRate)
+        NK_LOG_WARNING("\"%s\" was recorded at %u ticks per second, but the application runs at %u; the replay will diverge.",
+            filePath,
+            fileHdr.m_tickRate,
+            tickRate
+        );
+
+    NkSize const nSteps = __NkInt_Rt_QueryCountOption("ticks", (NkSize)NK_MIN(fileHdr.m_nSteps, __NkInt_Rt_MaxSteps), __NkInt_Rt_MaxSteps);
+    if (nSteps == 0) {
+        NK_LOG_WARNING("Nothing to replay.");
+
+        goto lbl_END;
+    }
+    errCode = NkGPAlloc(NULL, nSteps * sizeof *frameTimes, 0, NK_FALSE, (NkVoid **)&frameTimes);
+    if (errCode != NkErr_Ok)
+        goto lbl_END;
+
+    replayCxt.mp_ialRef = NkApplicationQueryInstance(NKOM_CLSIDOF(NkIInput));
+    if (replayCxt.mp_ialRef == NULL) {
+        errCode = NkErr_ComponentState;
+
+        goto lbl_END;
+    }
+    NkApplicationSetStepCallback(&__NkInt_Rt_OnReplayStep, &replayCxt);
+    errCode = NkApplicationRunSteps((NkUint32)nSteps, frameTimes);
+    NkApplicationSetStepCallback(NULL, NULL);
+    replayCxt.mp_ialRef->VT->Release(replayCxt.mp_ialRef);
+    if (errCode != NkErr_Ok)
+        goto lbl_END;
+
+    /* Report the frame times. */
+    NkDouble sumMs = 0.;
+    for (NkSize i = 0; i < nSteps; i++)
+        sumMs += frameTimes[i];
+    qsort(frameTimes, nSteps, sizeof *frameTimes, &__NkInt_Rt_CompareDoubles);
+
+#define __NkInt_Rt_Percentile(p) frameTimes[NK_MIN(nSteps - 1, (NkSize)(((p) * nSteps + 99) / 100) - 1)]
+    printf("replayed %zu fixed steps (%zu records) from \"%s\"\n", nSteps, replayCxt.m_currEnt, filePath);
+    printf("%10s %10s %10s %10s %10s %10s\n", "min", "mean", "p50", "p90", "p99", "max");
+    printf("%10.4f %10.4f %10.4f %10.4f %10.4f %10.4f (ms/frame)\n",
+        frameTimes[0],
+        sumMs / (NkDouble)nSteps,
+        __NkInt_Rt_Percentile(50),
+        __NkInt_Rt_Percentile(90),
+        __NkInt_Rt_Percentile(99),
+        frameTimes[nSteps - 1]
+    );
+#undef __NkInt_Rt_Percentile
+
+lbl_END:
+    NkGPFree(frameTimes);
+    NkGPFree(replayCxt.mp_entArr);
+    return errCode;
+}
+/** \endcond */
+
+
 int main(int argc, char **argv, char **envp) {
     /* Enable Visual Studio memory leak detector. */
 #if (defined _DEBUG)
@@ -37,6 +526,9 @@ int main(int argc, char **argv, char **envp) {
         .m_enableDbgTools  = NK_TRUE,
         .m_rendererApi     = NkRdApi_Win32GDI,
         .m_isVSync         = NK_FALSE,
+        .m_fixedTickRate   = 120,
+        .m_targetFps       = 0,
+        .m_isOnDemand      = NK_FALSE,
         .m_vpAlignment     = NkVpAlign_HCenter | NkVpAlign_VCenter,
         .m_vpExtents       = { 16, 16 },
         .m_dispTileSize    = { 32, 32 },
@@ -53,8 +545,14 @@ int main(int argc, char **argv, char **envp) {
     if (errCode != NkErr_Ok)
         goto lbl_END;
 
-    /* Start the main loop. */
-    errCode = NkApplicationRun();
+    /* Start the main loop, optionally recording or replaying input. */
+    char filePath[__NkInt_Rt_MaxPath];
+    if (__NkInt_Rt_QueryPathOption("replay", filePath))
+        errCode = __NkInt_Rt_RunReplay(filePath);
+    else if (__NkInt_Rt_QueryPathOption("record", filePath))
+        errCode = __NkInt_Rt_RunRecord(filePath);
+    else
+        errCode = NkApplicationRun();
 
 lbl_END:
     NK_IGNORE_RETURN_VALUE(NkApplicationShutdown());
@@ -62,3 +560,6 @@ lbl_END:
 }
 
 
+#undef NK_NAMESPACE
+
+